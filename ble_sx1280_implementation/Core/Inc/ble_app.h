@@ -78,8 +78,10 @@ typedef struct {
     /* 数据缓冲 */
     char text_buffer[256];
     bool text_pending;
+    bool text_sending;
     uint8_t rx_buffer[256];
     uint16_t rx_length;
+    bool notifications_paused;  // LoRaWAN桥队列将满，通知已禁用
     
     /* 统计信息 */
     uint32_t packets_sent;
@@ -8,6 +8,12 @@
 #include "ble_app.h"
 #include "stm32g0xx_hal.h"
 #include <stdio.h>
+#if defined( ADD_SMTC_BLE_BRIDGE )
+#include "ble_bridge.h"
+
+/* 转发通知的LoRaWAN栈 */
+#define APP_BRIDGE_STACK_ID 0
+#endif
 
 /* 状态名称字符串 */
 static const char* state_names[] = {
@@ -39,6 +45,10 @@ static bool app_scan_filter(uint8_t* addr, int8_t rssi, uint8_t* adv_data, uint8
 static void app_on_connected(ble_conn_context_t* ctx);
 static void app_on_disconnected(ble_conn_context_t* ctx, uint8_t reason);
 static void app_on_data_received(ble_conn_context_t* ctx, uint8_t* data, uint16_t len);
+static void app_on_notification(gatt_client_context_t* ctx, uint16_t handle, uint8_t* value, uint16_t len);
+static void app_on_discovered(gatt_client_context_t* ctx, ble_status_t status, bracelet_type_t type);
+static void app_on_text_written(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                                void* user);
 
 /* 全局应用上下文指针（用于回调） */
 static app_context_t* g_app_ctx = NULL;
@@ -106,6 +116,7 @@ ble_status_t ble_app_init(app_context_t* app, const app_config_t* config)
     if (status != BLE_STATUS_OK) {
         return status;
     }
+    ble_gatt_set_notify_callback(&app->gatt_client, app_on_notification);
     
     /* 初始状态 */
     app->state = APP_STATE_IDLE;
@@ -277,6 +288,20 @@ void ble_app_process(app_context_t* app)
     /* 处理Link Layer事件 */
     ble_ll_process_events(&app->ble_conn);
     
+    /* 处理异步GATT操作 */
+    ble_gatt_process(&app->gatt_client);
+    
+#if defined( ADD_SMTC_BLE_BRIDGE )
+    /* 存储转发队列有空间后恢复通知 */
+    if (app->notifications_paused && app->state == APP_STATE_CONNECTED &&
+        ble_bridge_is_accepting(APP_BRIDGE_STACK_ID)) {
+        if (ble_gatt_enable_notifications_async(&app->gatt_client, app->gatt_client.handles.rx_char_handle,
+                                                NULL, NULL) == BLE_STATUS_OK) {
+            app->notifications_paused = false;
+        }
+    }
+#endif
+    
     /* 处理应用状态 */
     app_handle_state(app);
 }
@@ -387,28 +412,17 @@ static void app_handle_state(app_context_t* app)
             break;
             
         case APP_STATE_SENDING:
-            /* 发送文本 */
-            if (app->text_pending) {
-                ble_status_t status = ble_gatt_write_text(&app->gatt_client, 
-                                                         app->text_buffer);
-                if (status == BLE_STATUS_OK) {
-                    app->packets_sent++;
-                    app->text_pending = false;
-                    
-                    if (app->on_text_sent) {
-                        app->on_text_sent();
+            /* 以写命令流发送文本，完成在app_on_text_written中处理 */
+            if (app->text_pending && !app->text_sending) {
+                app->text_sending = true;
+                ble_status_t status = ble_gatt_write_text_async(&app->gatt_client, app->text_buffer,
+                                                                app_on_text_written, app);
+                if (status != BLE_STATUS_OK) {
+                    app->text_sending = false;
+                    if (status != BLE_STATUS_BUSY) {
+                        printf("[APP] Send failed: %d\n", status);
+                        app_state_transition(app, APP_STATE_ERROR);
                     }
-                    
-                    /* 根据配置决定是否断开 */
-                    if (app->config.disconnect_after_send) {
-                        HAL_Delay(100);  // 短延时确保数据发送
-                        ble_app_disconnect(app);
-                    } else {
-                        app_state_transition(app, APP_STATE_CONNECTED);
-                    }
-                } else {
-                    printf("[APP] Send failed: %d\n", status);
-                    app_state_transition(app, APP_STATE_ERROR);
                 }
             }
             break;
@@ -467,22 +481,60 @@ static void app_on_connected(ble_conn_context_t* ctx)
     
     app_state_transition(g_app_ctx, APP_STATE_CONNECTED);
     
-    /* 发现手环服务 */
-    bracelet_type_t type;
-    if (ble_gatt_discover_bracelet(&g_app_ctx->gatt_client, &type) == BLE_STATUS_OK) {
-        printf("[APP] Detected bracelet type: %d\n", type);
-        g_app_ctx->config.bracelet_type = type;
+    /* 发现手环服务，同一手环重连时从句柄缓存立即完成 */
+    ble_gatt_discover_bracelet_async(&g_app_ctx->gatt_client, app_on_discovered);
+    
+    /* 应用回调 */
+    if (g_app_ctx->on_connected) {
+        g_app_ctx->on_connected();
     }
+}
+
+/**
+ * @brief 手环发现完成回调
+ */
+static void app_on_discovered(gatt_client_context_t* ctx, ble_status_t status, bracelet_type_t type)
+{
+    if (!g_app_ctx || status != BLE_STATUS_OK) return;
     
-    /* 启用通知（如果配置） */
+    printf("[APP] Detected bracelet type: %d\n", type);
+    g_app_ctx->config.bracelet_type = type;
+    
+    /* 启用通知（如果配置），与之后的写入一起排队 */
     if (g_app_ctx->config.enable_notifications) {
-        ble_gatt_enable_notifications(&g_app_ctx->gatt_client,
-                                     g_app_ctx->gatt_client.handles.rx_char_handle);
+        ble_gatt_enable_notifications_async(ctx, ctx->handles.rx_char_handle, NULL, NULL);
     }
+}
+
+/**
+ * @brief 文本发送完成回调
+ */
+static void app_on_text_written(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                                void* user)
+{
+    app_context_t* app = (app_context_t*)user;
     
-    /* 应用回调 */
-    if (g_app_ctx->on_connected) {
-        g_app_ctx->on_connected();
+    app->text_sending = false;
+    
+    if (status != BLE_STATUS_OK) {
+        printf("[APP] Send failed: %d\n", status);
+        app_state_transition(app, APP_STATE_ERROR);
+        return;
+    }
+    
+    app->packets_sent++;
+    app->text_pending = false;
+    
+    if (app->on_text_sent) {
+        app->on_text_sent();
+    }
+    
+    /* 根据配置决定是否断开 */
+    if (app->config.disconnect_after_send) {
+        HAL_Delay(100);  // 短延时确保数据发送
+        ble_app_disconnect(app);
+    } else {
+        app_state_transition(app, APP_STATE_CONNECTED);
     }
 }
 
@@ -495,6 +547,10 @@ static void app_on_disconnected(ble_conn_context_t* ctx, uint8_t reason)
     
     printf("[APP] Disconnected, reason: 0x%02X\n", reason);
     
+    /* 终止未完成的GATT操作，句柄缓存保留 */
+    ble_gatt_abort(&g_app_ctx->gatt_client, BLE_STATUS_NOT_CONNECTED);
+    g_app_ctx->notifications_paused = false;  // 重连时CCCD重新配置
+    
     if (g_app_ctx->state == APP_STATE_CONNECTED || 
         g_app_ctx->state == APP_STATE_SENDING) {
         g_app_ctx->connect_time_ms = HAL_GetTick() - g_app_ctx->connect_time_ms;
@@ -521,14 +577,33 @@ static void app_on_data_received(ble_conn_context_t* ctx, uint8_t* data, uint16_
 {
     if (!g_app_ctx) return;
     
-    /* 处理GATT数据 */
-    ble_gatt_handle_rx_data(&g_app_ctx->gatt_client, data, len);
-    
     g_app_ctx->packets_received++;
     
+    /* 处理GATT数据，通知值经app_on_notification返回 */
+    ble_gatt_handle_rx_data(&g_app_ctx->gatt_client, data, len);
+}
+
+/**
+ * @brief 通知/指示回调
+ */
+static void app_on_notification(gatt_client_context_t* ctx, uint16_t handle, uint8_t* value, uint16_t len)
+{
+    if (!g_app_ctx || handle != ctx->handles.rx_char_handle) return;
+    
+#if defined( ADD_SMTC_BLE_BRIDGE )
+    /* 转发到LoRaWAN桥，存储转发队列将满时禁用通知，由ble_app_process恢复 */
+    if (len <= UINT8_MAX && !g_app_ctx->notifications_paused &&
+        ble_bridge_add_record(APP_BRIDGE_STACK_ID, g_app_ctx->ble_conn.peer_addr, value, (uint8_t)len) ==
+            BLE_BRIDGE_RC_BUSY) {
+        if (ble_gatt_disable_notifications_async(ctx, handle, NULL, NULL) == BLE_STATUS_OK) {
+            g_app_ctx->notifications_paused = true;
+        }
+    }
+#endif
+    
     /* 保存接收的数据 */
-    if (len <= sizeof(g_app_ctx->rx_buffer)) {
-        memcpy(g_app_ctx->rx_buffer, data, len);
+    if (len < sizeof(g_app_ctx->rx_buffer)) {
+        memcpy(g_app_ctx->rx_buffer, value, len);
         g_app_ctx->rx_length = len;
         
         /* 尝试作为文本处理 */
@@ -50,10 +50,13 @@
 #define BLE_PDU_ADV_SCAN_IND       0x06  // 可扫描非定向广播 / Scannable undirected advertising
 #define BLE_PDU_DATA               0x02  // LL数据PDU / LL Data PDU
 #define BLE_PDU_CONTROL            0x03  // LL控制PDU / LL Control PDU
+#define BLE_PDU_CHSEL              0x20  // 广播PDU头ChSel位，支持信道选择算法#2 / Advertising PDU header ChSel bit,
+                                         // Channel Selection Algorithm #2 supported
 
 /* LL Control PDU Opcodes / LL控制PDU操作码 */
 #define LL_CONNECTION_UPDATE_REQ   0x00
 #define LL_CHANNEL_MAP_REQ        0x01
+#define LL_CHANNEL_MAP_IND        LL_CHANNEL_MAP_REQ
 #define LL_TERMINATE_IND          0x02
 #define LL_ENC_REQ                0x03
 #define LL_ENC_RSP                0x04
@@ -132,6 +135,7 @@ typedef enum {
     CONN_STATE_IDLE = 0,            // 空闲状态 / Idle state
     CONN_STATE_SCANNING,            // 扫描状态 / Scanning state
     CONN_STATE_INITIATING,          // 发起连接状态 / Initiating connection state
+    CONN_STATE_ADVERTISING,         // 广播状态 / Advertising state
     CONN_STATE_CONNECTION,          // 连接中状态 / Connecting state
     CONN_STATE_CONNECTED,           // 已连接状态 / Connected state
     CONN_STATE_DISCONNECTING,       // 断开连接中状态 / Disconnecting state
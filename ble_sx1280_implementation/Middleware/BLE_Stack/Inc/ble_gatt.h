@@ -66,18 +66,28 @@ typedef struct {
     uint16_t cccd_handle;       // CCCD句柄(用于启用通知) / CCCD handle (for enabling notifications)
 } gatt_bracelet_handles_t;
 
-/* GATT客户端上下文 / GATT Client Context */
-typedef struct {
-    ble_conn_context_t* ll_ctx;              // Link Layer上下文 / Link Layer context
-    uint16_t mtu;                            // 最大传输单元 / Maximum Transmission Unit
-    uint8_t pending_op;                      // 等待中的操作码 / Pending operation code
-    uint16_t pending_handle;                 // 等待中的句柄 / Pending handle
-    uint8_t response_buffer[ATT_MTU_MAX];    // 响应缓冲区 / Response buffer
-    uint16_t response_length;                // 响应长度 / Response length
-    bool response_received;                  // 响应接收标志 / Response received flag
-    bracelet_type_t bracelet_type;          // 手环类型 / Bracelet type
-    gatt_bracelet_handles_t handles;         // 手环句柄 / Bracelet handles
-} gatt_client_context_t;
+/* 异步请求参数 / Asynchronous Request Parameters */
+#ifndef GATT_REQ_QUEUE_SIZE
+#define GATT_REQ_QUEUE_SIZE                4     // 排队的ATT请求数 / Queued ATT requests
+#endif
+#ifndef GATT_HANDLE_CACHE_SIZE
+#define GATT_HANDLE_CACHE_SIZE             4     // 句柄缓存的对端数 / Peers in the handle cache
+#endif
+#define GATT_ATT_TIMEOUT_MS                1000  // ATT响应超时 / ATT response timeout
+
+/* 前向声明 / Forward Declaration */
+typedef struct gatt_client_context_s gatt_client_context_t;
+
+// 请求完成回调，data为响应PDU(含操作码) / Request completion callback, data is the response PDU (with opcode)
+typedef void (*gatt_complete_cb_t)(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                                   void* user);
+
+// 发现完成回调 / Discovery completion callback
+typedef void (*gatt_discover_cb_t)(gatt_client_context_t* ctx, ble_status_t status, bracelet_type_t type);
+
+// 通知/指示回调，value为属性值(不含ATT头) / Notification/indication callback, value is the attribute value (without
+// the ATT header)
+typedef void (*gatt_notify_cb_t)(gatt_client_context_t* ctx, uint16_t handle, uint8_t* value, uint16_t len);
 
 /* ATT请求/响应结构 / ATT Request/Response Structure */
 typedef struct {
@@ -95,12 +105,37 @@ typedef struct {
             uint16_t handle;            // 属性句柄 / Attribute handle
         } read;
         
+        // 读取长属性请求 / Read Blob Request
+        struct {
+            uint16_t handle;            // 属性句柄 / Attribute handle
+            uint16_t offset;            // 值偏移 / Value offset
+        } read_blob;
+        
+        // MTU交换请求 / Exchange MTU Request
+        struct {
+            uint16_t client_rx_mtu;     // 客户端接收MTU / Client receive MTU
+        } exchange_mtu;
+        
         // 写入请求 / Write Request
         struct {
             uint16_t handle;                        // 属性句柄 / Attribute handle
+            uint16_t length;                        // 属性值长度 / Attribute value length
             uint8_t value[ATT_MTU_MAX - 3];       // 属性值 / Attribute value
         } write;
         
+        // 准备写入请求 / Prepare Write Request
+        struct {
+            uint16_t handle;                        // 属性句柄 / Attribute handle
+            uint16_t offset;                        // 值偏移 / Value offset
+            uint16_t length;                        // 分片长度 / Part length
+            uint8_t value[ATT_MTU_MAX - 5];       // 分片值 / Part value
+        } prepare_write;
+        
+        // 执行写入请求 / Execute Write Request
+        struct {
+            uint8_t flags;              // 0x00取消，0x01写入 / 0x00 cancel, 0x01 write
+        } execute_write;
+        
         // 错误响应 / Error Response
         struct {
             uint8_t req_opcode;         // 请求操作码 / Request opcode
@@ -111,11 +146,62 @@ typedef struct {
         // 通知/指示 / Notification/Indication
         struct {
             uint16_t handle;                        // 属性句柄 / Attribute handle
+            uint16_t length;                        // 属性值长度 / Attribute value length
             uint8_t value[ATT_MTU_MAX - 3];       // 属性值 / Attribute value
         } notification;
     } params;
 } att_msg_t;
 
+/* 异步请求 / Asynchronous Request */
+typedef struct {
+    att_msg_t msg;                  // ATT请求 / ATT request
+    gatt_complete_cb_t cb;          // 完成回调 / Completion callback
+    void* user;                     // 回调用户参数 / Callback user argument
+} gatt_async_req_t;
+
+/* GATT客户端上下文 / GATT Client Context */
+struct gatt_client_context_s {
+    ble_conn_context_t* ll_ctx;              // Link Layer上下文 / Link Layer context
+    uint16_t mtu;                            // 最大传输单元 / Maximum Transmission Unit
+    bool mtu_exchanged;                      // 已交换MTU / MTU exchanged
+    uint8_t pending_op;                      // 等待中的操作码 / Pending operation code
+    uint16_t pending_handle;                 // 等待中的句柄 / Pending handle
+    uint8_t response_buffer[ATT_MTU_MAX];    // 响应缓冲区 / Response buffer
+    uint16_t response_length;                // 响应长度 / Response length
+    bool response_received;                  // 响应接收标志 / Response received flag
+    bracelet_type_t bracelet_type;          // 手环类型 / Bracelet type
+    gatt_bracelet_handles_t handles;         // 手环句柄 / Bracelet handles
+    
+    /* 异步请求队列，同一时刻只有队首在途 / Asynchronous request queue, only the head is in flight at a time */
+    gatt_async_req_t req_queue[GATT_REQ_QUEUE_SIZE];
+    uint8_t req_head;                        // 队首 / Queue head
+    uint8_t req_count;                       // 排队请求数 / Queued requests
+    bool req_inflight;                       // 队首已发送 / Queue head sent
+    uint32_t req_sent_time;                  // 队首发送时间(毫秒) / Queue head send time (milliseconds)
+    
+    /* 异步发现 / Asynchronous discovery */
+    gatt_discover_cb_t discover_cb;          // 发现完成回调 / Discovery completion callback
+    
+    /* 通知 / Notifications */
+    gatt_notify_cb_t notify_cb;              // 通知/指示回调 / Notification/indication callback
+    
+    /* 写命令流 / Write Command stream */
+    const uint8_t* stream_data;              // 待发送数据 / Data to send
+    uint16_t stream_length;                  // 数据长度 / Data length
+    uint16_t stream_offset;                  // 已发送长度 / Length sent
+    uint16_t stream_handle;                  // 目标句柄 / Target handle
+    gatt_complete_cb_t stream_cb;            // 流完成回调 / Stream completion callback
+    void* stream_user;                       // 回调用户参数 / Callback user argument
+    
+    /* 长属性读写(Read Blob/Prepare Write) / Long attribute read/write (Read Blob/Prepare Write) */
+    uint8_t* long_data;                      // 读缓冲区或写数据，NULL时空闲 / Read buffer or write data, idle when NULL
+    uint16_t long_length;                    // 缓冲区大小或写入长度 / Buffer size or write length
+    uint16_t long_offset;                    // 已读或已准备长度 / Length read or prepared
+    uint16_t long_handle;                    // 目标句柄 / Target handle
+    gatt_complete_cb_t long_cb;              // 完成回调 / Completion callback
+    void* long_user;                         // 回调用户参数 / Callback user argument
+};
+
 /* GATT API函数 / GATT API Functions */
 
 // 初始化GATT客户端 / Initialize GATT client
@@ -124,13 +210,17 @@ ble_status_t ble_gatt_init(gatt_client_context_t* ctx, ble_conn_context_t* ll_ct
 // 发现手环类型 / Discover bracelet type
 ble_status_t ble_gatt_discover_bracelet(gatt_client_context_t* ctx, bracelet_type_t* type);
 
+// 交换ATT MTU / Exchange the ATT MTU
+ble_status_t ble_gatt_exchange_mtu(gatt_client_context_t* ctx);
+
 // 发送文本消息到手环 / Send text message to bracelet
 ble_status_t ble_gatt_write_text(gatt_client_context_t* ctx, const char* text);
 
-// 写入数据到指定句柄 / Write data to specified handle
+// 写入数据到指定句柄，超过MTU时使用准备写入 / Write data to specified handle, Prepare Writes beyond the MTU
 ble_status_t ble_gatt_write_data(gatt_client_context_t* ctx, uint16_t handle, uint8_t* data, uint16_t len);
 
-// 从指定句柄读取数据 / Read data from specified handle
+// 从指定句柄读取数据，len输入缓冲区大小，长属性继续Read Blob / Read data from specified handle, len gives the buffer
+// size on input, long attributes continue with Read Blob
 ble_status_t ble_gatt_read_data(gatt_client_context_t* ctx, uint16_t handle, uint8_t* data, uint16_t* len);
 
 // 启用通知 / Enable notifications
@@ -139,6 +229,51 @@ ble_status_t ble_gatt_enable_notifications(gatt_client_context_t* ctx, uint16_t
 // 处理接收到的数据 / Handle received data
 void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t len);
 
+/* 异步GATT API，完成时回调，需在主循环中调用ble_gatt_process / Asynchronous GATT API, completes through callbacks,
+ * requires ble_gatt_process in the main loop */
+
+// 处理超时和写命令流(主循环调用) / Process timeouts and the Write Command stream (called from main loop)
+void ble_gatt_process(gatt_client_context_t* ctx);
+
+// 异步发现手环，句柄缓存命中时立即完成 / Discover the bracelet asynchronously, completes at once on a handle cache hit
+ble_status_t ble_gatt_discover_bracelet_async(gatt_client_context_t* ctx, gatt_discover_cb_t cb);
+
+// 异步读取 / Asynchronous read
+ble_status_t ble_gatt_read_async(gatt_client_context_t* ctx, uint16_t handle, gatt_complete_cb_t cb, void* user);
+
+// 异步写入(写请求) / Asynchronous write (Write Request)
+ble_status_t ble_gatt_write_async(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len,
+                                  gatt_complete_cb_t cb, void* user);
+
+// 异步读取长属性，回调data为buffer / Read a long attribute asynchronously, the callback data is the buffer
+ble_status_t ble_gatt_read_long_async(gatt_client_context_t* ctx, uint16_t handle, uint8_t* buffer, uint16_t size,
+                                      gatt_complete_cb_t cb, void* user);
+
+// 异步写入长属性，数据需保持到回调 / Write a long attribute asynchronously, the data must stay valid until the callback
+ble_status_t ble_gatt_write_long_async(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len,
+                                       gatt_complete_cb_t cb, void* user);
+
+// 异步启用通知 / Enable notifications asynchronously
+ble_status_t ble_gatt_enable_notifications_async(gatt_client_context_t* ctx, uint16_t char_handle,
+                                                 gatt_complete_cb_t cb, void* user);
+
+// 异步禁用通知 / Disable notifications asynchronously
+ble_status_t ble_gatt_disable_notifications_async(gatt_client_context_t* ctx, uint16_t char_handle,
+                                                  gatt_complete_cb_t cb, void* user);
+
+// 设置通知/指示回调 / Set the notification/indication callback
+void ble_gatt_set_notify_callback(gatt_client_context_t* ctx, gatt_notify_cb_t cb);
+
+// 写命令(无响应) / Write Command (no response)
+ble_status_t ble_gatt_write_cmd(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len);
+
+// 以写命令流发送文本，数据需保持到回调 / Stream text as Write Commands, the data must stay valid until the callback
+ble_status_t ble_gatt_write_text_async(gatt_client_context_t* ctx, const char* text, gatt_complete_cb_t cb,
+                                       void* user);
+
+// 断开时终止所有异步操作 / Abort all asynchronous operations on disconnection
+void ble_gatt_abort(gatt_client_context_t* ctx, ble_status_t status);
+
 /* 内部函数 / Internal Functions */
 
 // 发送ATT请求 / Send ATT request
@@ -153,6 +288,13 @@ void gatt_build_write_request(att_msg_t* msg, uint16_t handle, uint8_t* value, u
 // 构建读取请求 / Build read request
 void gatt_build_read_request(att_msg_t* msg, uint16_t handle);
 
+// 构建读取长属性请求 / Build Read Blob request
+void gatt_build_read_blob_request(att_msg_t* msg, uint16_t handle, uint16_t offset);
+
+// 构建准备写入请求 / Build Prepare Write request
+void gatt_build_prepare_write_request(att_msg_t* msg, uint16_t handle, uint16_t offset, const uint8_t* value,
+                                      uint16_t len);
+
 // 处理通知 / Process notification
 void gatt_process_notification(gatt_client_context_t* ctx, att_msg_t* msg);
 
@@ -161,6 +303,9 @@ void gatt_process_notification(gatt_client_context_t* ctx, att_msg_t* msg);
 // 获取手环句柄 / Get bracelet handles
 const gatt_bracelet_handles_t* gatt_get_bracelet_handles(bracelet_type_t type);
 
+// 按对端地址查询句柄缓存 / Look up the handle cache by peer address
+bool gatt_load_cached_handles(gatt_client_context_t* ctx);
+
 // 小米手环认证 / Xiaomi bracelet authentication
 ble_status_t gatt_authenticate_xiaomi(gatt_client_context_t* ctx);
 
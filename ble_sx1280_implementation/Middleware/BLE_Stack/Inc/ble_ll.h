@@ -22,6 +22,108 @@
 #include "sx128x_ble_defs.h"
 #include "sx128x.h"
 
+/* 连接事件定时参数 / Connection Event Timing Parameters */
+#ifndef BLE_LL_LPTIM_FREQ_HZ
+#define BLE_LL_LPTIM_FREQ_HZ              32000  // LPTIM1时钟(LSI) / LPTIM1 clock (LSI)
+#endif
+#ifndef BLE_LL_WAKEUP_US
+#define BLE_LL_WAKEUP_US                  1500   // 锚点前唤醒余量(TCXO启动和无线电配置) / Wake-up lead before the anchor
+                                                 // point (TCXO startup and radio setup)
+#endif
+#ifndef BLE_LL_LOCAL_SCA_PPM
+#define BLE_LL_LOCAL_SCA_PPM              50     // 本地睡眠时钟精度 / Local sleep clock accuracy
+#endif
+
+/* 多连接参数 / Multi-connection Parameters */
+#ifndef BLE_LL_MAX_CONNECTIONS
+#define BLE_LL_MAX_CONNECTIONS            8      // 共享一个SX1280和LPTIM1的连接上下文数 / Connection contexts sharing one
+                                                 // SX1280 and LPTIM1
+#endif
+
+/* 数据通道参数 / Data Channel Parameters */
+#ifndef BLE_LL_TX_QUEUE_SIZE
+#define BLE_LL_TX_QUEUE_SIZE              8      // 发送PDU环形缓冲区深度 / Transmit PDU ring depth
+#endif
+#ifndef BLE_LL_RX_QUEUE_SIZE
+#define BLE_LL_RX_QUEUE_SIZE              4      // 接收PDU环形缓冲区深度 / Receive PDU ring depth
+#endif
+#define BLE_LL_MIN_DATA_OCTETS            27     // 默认最大负载 / Default maximum payload
+#define BLE_LL_MAX_DATA_OCTETS            251    // 数据长度扩展后的最大负载 / Maximum payload with Data Length Extension
+#define LL_PDU_TIME_US(octets)            (((octets) + 14) * 8)  // 1M PHY上PDU空中时间 / PDU airtime on the 1M PHY
+#define LL_FEATURE_DATA_LENGTH_EXT        0x20   // 特性集第0字节位5 / Feature set byte 0 bit 5
+
+/* 信道管理参数 / Channel Management Parameters */
+#define BLE_LL_DATA_CHANNELS              37     // 数据信道数 / Number of data channels
+#ifndef BLE_LL_CHANNEL_MAP_INSTANT
+#define BLE_LL_CHANNEL_MAP_INSTANT        6      // 信道图更新生效前的事件数(不含从设备延迟) / Events before a channel map
+                                                 // update takes effect (slave latency excluded)
+#endif
+
+/* 扫描参数 / Scanner Parameters */
+#ifndef BLE_LL_SCAN_DEDUP_SIZE
+#define BLE_LL_SCAN_DEDUP_SIZE            32     // 重复报告过滤缓存条目数(2的幂) / Duplicate report cache entries
+                                                 // (power of two)
+#endif
+#define BLE_LL_SCAN_DEFAULT_WINDOW_US     30000  // 未指定扫描参数时的连续扫描窗口 / Continuous scan window when no scan
+                                                 // parameters are given
+
+/* 无线电操作超时 / Radio Operation Timeouts */
+#define LL_EVENT_TX_TIMEOUT_US            3000   // 最长PDU约2.1ms / Longest PDU is about 2.1 ms
+#define LL_EVENT_RX_TIMEOUT_US            2000   // 连接事件接收窗口 / Connection event receive window
+#define LL_PDU_TX_TIMEOUT_US              10000  // 单独PDU发送超时 / Standalone PDU transmit timeout
+#define LL_ADV_TX_TIMEOUT_US              1000   // 广播PDU最长约0.4ms / Longest advertising PDU is about 0.4 ms
+#define LL_ADV_RX_TIMEOUT_US              1000   // 广播后等待SCAN_REQ/CONNECT_REQ / Wait for SCAN_REQ/CONNECT_REQ
+                                                 // after an advertisement
+
+/* 经DIO1通知的无线电中断 / Radio interrupts signalled on DIO1 */
+#define LL_RADIO_IRQ_MASK  (SX128X_IRQ_TX_DONE | SX128X_IRQ_RX_DONE | SX128X_IRQ_CRC_ERROR | SX128X_IRQ_RX_TX_TIMEOUT)
+
+/* 无线电操作 / Radio Operation */
+typedef enum {
+    LL_RADIO_OP_IDLE = 0,   // 无进行中的操作 / No operation in progress
+    LL_RADIO_OP_PDU_TX,     // 单独PDU发送(CONNECT_REQ) / Standalone PDU transmission (CONNECT_REQ)
+    LL_RADIO_OP_EVENT_TX,   // 连接事件发送 / Connection event transmission
+    LL_RADIO_OP_EVENT_RX,   // 连接事件接收 / Connection event reception
+    LL_RADIO_OP_ADV_TX,     // 广播PDU发送 / Advertising PDU transmission
+    LL_RADIO_OP_ADV_RX,     // 广播后的请求接收 / Request reception after an advertisement
+    LL_RADIO_OP_ADV_RSP_TX  // SCAN_RSP发送 / SCAN_RSP transmission
+} ll_radio_op_t;
+
+/* 扫描过滤器回调 / Scan Filter Callback */
+typedef bool (*ble_scan_filter_cb)(uint8_t* addr, int8_t rssi, uint8_t* adv_data, uint8_t len);
+// 返回true表示设备符合过滤条件 / Return true if device matches filter criteria
+
+/* 重复报告过滤缓存条目 / Duplicate Report Cache Entry */
+typedef struct {
+    uint8_t addr[6];        // 广播者地址 / Advertiser address
+    uint8_t addr_type;      // 地址类型(TxAdd)，0xFF表示空 / Address type (TxAdd), 0xFF when empty
+    uint32_t digest;        // PDU类型和广播数据的摘要 / Digest of the PDU type and advertising data
+} ll_scan_dedup_entry_t;
+
+#if defined( ADD_BLE_LL )
+#include "radio_planner.h"
+
+/* 无线电规划器参数 / Radio Planner Parameters */
+#ifndef BLE_LL_RP_CONN_EVENT_DURATION_MS
+#define BLE_LL_RP_CONN_EVENT_DURATION_MS  5     // 连接事件占用无线电的时长 / Radio time reserved per connection event
+#endif
+#ifndef BLE_LL_RP_ADV_EVENT_DURATION_MS
+#define BLE_LL_RP_ADV_EVENT_DURATION_MS   5     // 三个信道的广播事件占用无线电的时长 / Radio time reserved per
+                                                // advertising event on the three channels
+#endif
+#ifndef BLE_LL_RP_SCHEDULE_MARGIN_US
+#define BLE_LL_RP_SCHEDULE_MARGIN_US      3000  // 锚点前的最小调度余量 / Minimum scheduling margin before an anchor point
+#endif
+
+/* 规划器任务状态 / Planner Task State */
+typedef enum {
+    LL_RP_TASK_IDLE = 0,    // 未入队 / Not enqueued
+    LL_RP_TASK_QUEUED,      // 已入队，等待无线电 / Enqueued, waiting for the radio
+    LL_RP_TASK_GRANTED,     // 规划器已分配无线电 / Radio granted by the planner
+    LL_RP_TASK_RELEASING    // 已释放，等待规划器回调 / Released, waiting for the planner callback
+} ll_rp_task_state_t;
+#endif
+
 /* 前向声明 / Forward Declaration */
 typedef struct ble_conn_context_s ble_conn_context_t;
 
@@ -39,7 +141,7 @@ struct ble_conn_context_s {
     /* 连接参数 / Connection Parameters */
     uint32_t access_address;        // 连接接入地址 / Connection access address
     uint32_t crc_init;              // CRC初始值 / CRC initial value
-    uint16_t conn_interval;         // 连接间隔(微秒) / Connection interval (microseconds)
+    uint32_t conn_interval;         // 连接间隔(微秒) / Connection interval (microseconds)
     uint16_t slave_latency;         // 从设备延迟 / Slave latency
     uint16_t supervision_timeout;   // 监督超时(毫秒) / Supervision timeout (milliseconds)
     
@@ -49,24 +151,51 @@ struct ble_conn_context_s {
     uint8_t last_unmapped_channel;  // 上次未映射的信道 / Last unmapped channel
     uint8_t num_used_channels;      // 使用的信道数量 / Number of used channels
     uint8_t current_channel;        // 当前信道 / Current channel
+    uint8_t channel_remap[BLE_LL_DATA_CHANNELS];  // 按升序排列的可用信道，信道图变化时重建 / Used channels in ascending
+                                                  // order, rebuilt when the channel map changes
+    bool csa2;                      // 使用信道选择算法#2 / Channel Selection Algorithm #2 in use
+    uint16_t channel_id;            // CSA#2信道标识(由接入地址导出) / CSA#2 channel identifier (from the access address)
+    bool channel_map_pending;       // 信道图更新等待生效时刻 / Channel map update waiting for its instant
+    uint16_t channel_map_instant;   // 信道图更新生效的事件计数 / Event counter at which the channel map update applies
+    uint8_t pending_channel_map[5]; // 待生效的信道图 / Channel map to apply
     
     /* 连接事件管理 / Connection Event Management */
     uint32_t event_counter;         // 事件计数器 / Event counter
     uint64_t anchor_point;          // 锚点(微秒时间戳) / Anchor point (microsecond timestamp)
     uint32_t window_widening;       // 窗口展宽(补偿时钟漂移) / Window widening (clock drift compensation)
+    uint8_t master_sca;             // 主设备睡眠时钟精度(0-7) / Master sleep clock accuracy (0-7)
+    uint64_t last_sync_anchor;      // 最后一次收到对端数据的锚点 / Last anchor point with a packet from the peer
+    uint64_t last_rx_timestamp;     // 最后一次收到对端数据的时间 / Last time a packet was received from the peer
+    uint32_t transmit_window_us;    // 从设备首次同步前的传输窗口 / Transmit window until the slave first synchronizes
+    volatile bool conn_event_due;   // 定时器唤醒，连接事件待执行 / Woken by the timer, connection event due
+    bool event_timer_armed;         // 连接事件定时器已启动 / Connection event timer armed
+    
+    /* 无线电中断状态机 / Radio Interrupt State Machine */
+    volatile bool radio_irq_pending;        // DIO1中断待处理 / DIO1 interrupt pending
+    volatile uint64_t radio_irq_timestamp;  // DIO1中断时间戳 / DIO1 interrupt timestamp
+    ll_radio_op_t radio_op;                 // 进行中的无线电操作 / Radio operation in progress
+    uint64_t radio_op_deadline;             // 操作超时时刻 / Operation deadline
     
     /* 序列号管理 / Sequence Number Management */
     uint8_t tx_seq_num;             // 发送序列号 / Transmit sequence number
     uint8_t rx_seq_num;             // 接收序列号 / Receive sequence number
     uint8_t next_expected_seq_num;  // 下一个期望的序列号 / Next expected sequence number
     
-    /* 数据缓冲 / Data Buffers */
-    uint8_t tx_buffer[255];         // 发送缓冲区 / Transmit buffer
-    uint16_t tx_length;             // 发送数据长度 / Transmit data length
-    bool tx_pending;                // 发送等待标志 / Transmit pending flag
-    uint8_t rx_buffer[255];         // 接收缓冲区 / Receive buffer
-    uint16_t rx_length;             // 接收数据长度 / Receive data length
-    bool rx_pending;                // 接收等待标志 / Receive pending flag
+    /* 数据缓冲(环形) / Data Buffers (rings) */
+    ble_data_pdu_t tx_queue[BLE_LL_TX_QUEUE_SIZE];  // 发送PDU队列，队首等待确认 / Transmit PDU queue, head awaits ack
+    uint8_t tx_head;                                // 发送队首 / Transmit queue head
+    uint8_t tx_count;                               // 发送队列PDU数 / PDUs in the transmit queue
+    bool tx_head_sent;                              // 队首已发送，等待确认 / Queue head sent, awaiting ack
+    ble_data_pdu_t rx_queue[BLE_LL_RX_QUEUE_SIZE];  // 接收PDU队列 / Receive PDU queue
+    uint8_t rx_head;                                // 接收队首 / Receive queue head
+    uint8_t rx_count;                               // 接收队列PDU数 / PDUs in the receive queue
+    uint8_t rx_sdu[4 + ATT_MTU_MAX];                // L2CAP重组缓冲区 / L2CAP reassembly buffer
+    uint16_t rx_sdu_length;                         // 已重组长度 / Reassembled length
+    
+    /* 数据长度扩展 / Data Length Extension */
+    uint8_t max_tx_octets;          // 生效的发送负载上限 / Effective maximum transmit payload
+    uint8_t max_rx_octets;          // 生效的接收负载上限 / Effective maximum receive payload
+    bool length_req_sent;           // 已发送LL_LENGTH_REQ / LL_LENGTH_REQ sent
     
     /* 错误统计 / Error Statistics */
     uint32_t consecutive_crc_errors; // 连续CRC错误次数 / Consecutive CRC errors
@@ -83,11 +212,54 @@ struct ble_conn_context_s {
     
     /* 性能优化 / Performance Optimization */
     uint8_t max_packets_per_event;  // 每个事件最大包数 / Maximum packets per event
-    bool more_data;                 // 更多数据标志(MD) / More data flag (MD)
+    bool more_data;                 // 对端更多数据标志(MD) / Peer more data flag (MD)
+    uint8_t event_packets;          // 本事件已交换的包数 / Packets exchanged in this event
+    uint64_t event_end;             // 本事件最晚结束时刻 / Latest end of this event
+    
+    /* 多连接调度(ble_ll_sched) / Multi-connection scheduling (ble_ll_sched) */
+    uint64_t sched_epoch;           // 锚点对齐的时间基准，0表示不对齐 / Time base the anchor points are aligned to, 0
+                                    // when not aligned
+    uint32_t sched_offset_us;       // 锚点相对时间基准的偏移 / Anchor point offset from the time base
+    uint32_t sched_event_us;        // 连接事件可用时长，0表示整个间隔 / Time available to a connection event, 0 for the
+                                    // whole interval
+    uint16_t win_offset;            // CONNECT_REQ的传输窗口偏移(1.25ms单位) / CONNECT_REQ transmit window offset (1.25 ms
+                                    // units)
     
     /* 调试信息 / Debug Information */
     int8_t last_rssi;               // 最后一次RSSI值 / Last RSSI value
     uint8_t last_status;            // 最后一次状态 / Last status
+    
+    /* 扫描 / Scanning */
+    ble_scan_filter_cb scan_filter;              // 广播报告回调 / Advertising report callback
+    bool scan_filter_duplicates;                 // 过滤重复报告 / Filter duplicate reports
+    uint8_t scan_channel;                        // 当前广播信道(37-39) / Current advertising channel (37-39)
+    uint32_t scan_interval_us;                   // 扫描间隔(微秒) / Scan interval (microseconds)
+    uint32_t scan_window_us;                     // 扫描窗口(微秒) / Scan window (microseconds)
+    uint64_t scan_window_start;                  // 当前扫描窗口起点 / Current scan window start
+    uint64_t scan_window_end;                    // 当前扫描窗口终点 / Current scan window end
+    uint32_t scan_reports;                       // 交给应用的报告数 / Reports passed to the application
+    uint32_t scan_duplicates;                    // 被缓存过滤的报告数 / Reports suppressed by the cache
+    ll_scan_dedup_entry_t scan_dedup[BLE_LL_SCAN_DEDUP_SIZE];  // 重复报告过滤缓存 / Duplicate report cache
+    
+    /* 广播(从设备角色) / Advertising (slave role) */
+    ble_adv_pdu_t adv_pdu;                       // 广播PDU / Advertising PDU
+    ble_adv_pdu_t scan_rsp_pdu;                  // 扫描响应PDU，长度6表示无 / Scan response PDU, none when its
+                                                 // length is 6
+    uint32_t adv_interval_us;                    // 广播间隔(微秒) / Advertising interval (microseconds)
+    uint64_t adv_event_start;                    // 下一个广播事件时刻 / Next advertising event time
+    uint8_t adv_channel;                         // 当前广播信道(37-39)，0表示事件之间 / Current advertising
+                                                 // channel (37-39), 0 between events
+    uint32_t adv_events;                         // 已完成的广播事件数 / Advertising events completed
+    uint32_t adv_scan_reqs;                      // 已响应的SCAN_REQ数 / SCAN_REQs answered
+
+#if defined( ADD_BLE_LL )
+    /* 无线电规划器 / Radio Planner */
+    radio_planner_t* rp;                         // 共享SX1280的LBM无线电规划器 / LBM radio planner sharing the SX1280
+    volatile ll_rp_task_state_t rp_conn_event;   // 连接事件任务状态 / Connection event task state
+    volatile ll_rp_task_state_t rp_scan;         // 扫描窗口任务状态 / Scan window task state
+    volatile ll_rp_task_state_t rp_adv;          // 广播事件任务状态 / Advertising event task state
+    uint32_t missed_conn_events;                 // 被LoRa任务占用的连接事件数 / Connection events lost to LoRa tasks
+#endif
 };
 
 /* 扫描参数 / Scan Parameters */
@@ -98,9 +270,16 @@ typedef struct {
     bool filter_duplicates;  // 是否过滤重复 / Filter duplicates
 } ble_scan_params_t;
 
-/* 扫描过滤器回调 / Scan Filter Callback */
-typedef bool (*ble_scan_filter_cb)(uint8_t* addr, int8_t rssi, uint8_t* adv_data, uint8_t len);
-// 返回true表示设备符合过滤条件 / Return true if device matches filter criteria
+/* 广播参数 / Advertising Parameters */
+typedef struct {
+    uint16_t adv_interval;         // 广播间隔(单位: 0.625ms, 32-16384) / Advertising interval (unit: 0.625ms, 32-16384)
+    bool connectable;              // 可连接(ADV_IND)，否则可扫描或不可连接 / Connectable (ADV_IND), else scannable or
+                                   // non-connectable
+    const uint8_t* adv_data;       // 广播数据 / Advertising data
+    uint8_t adv_data_len;          // 广播数据长度(0-31) / Advertising data length (0-31)
+    const uint8_t* scan_rsp_data;  // 扫描响应数据，可为NULL / Scan response data, may be NULL
+    uint8_t scan_rsp_len;          // 扫描响应数据长度(0-31) / Scan response data length (0-31)
+} ble_adv_params_t;
 
 /* Link Layer API函数 / Link Layer API Functions */
 
@@ -113,12 +292,26 @@ ble_status_t ble_ll_deinit(ble_conn_context_t* ctx);
 // 设置本地设备地址 / Set local device address
 ble_status_t ble_ll_set_address(ble_conn_context_t* ctx, uint8_t* addr);
 
+// 设置数据信道图，连接中由LL_CHANNEL_MAP_IND在生效时刻切换 / Set the data channel map, switched at the instant of an
+// LL_CHANNEL_MAP_IND while connected
+ble_status_t ble_ll_set_channel_map(ble_conn_context_t* ctx, const uint8_t* channel_map);
+
 // 开始扫描 / Start scanning
 ble_status_t ble_ll_start_scanning(ble_conn_context_t* ctx, ble_scan_params_t* params, ble_scan_filter_cb filter);
 
 // 停止扫描 / Stop scanning
 ble_status_t ble_ll_stop_scanning(ble_conn_context_t* ctx);
 
+// 结束当前扫描窗口，把无线电让给其他连接，无线电空闲后在下一个信道继续 / Close the current scan window to hand the
+// radio to another connection, scanning resumes on the next channel once the radio is free
+bool ble_ll_scan_yield(ble_conn_context_t* ctx);
+
+// 开始广播，收到CONNECT_REQ后以从设备角色连接 / Start advertising, a CONNECT_REQ connects in the slave role
+ble_status_t ble_ll_start_advertising(ble_conn_context_t* ctx, const ble_adv_params_t* params);
+
+// 停止广播 / Stop advertising
+ble_status_t ble_ll_stop_advertising(ble_conn_context_t* ctx);
+
 // 发起连接 / Initiate connection
 ble_status_t ble_ll_connect(ble_conn_context_t* ctx, uint8_t* peer_addr, ble_conn_params_t* params);
 
@@ -137,6 +330,12 @@ void ble_ll_radio_irq_handler(ble_conn_context_t* ctx);
 // 连接事件触发 / Connection event trigger
 void ble_ll_connection_event_trigger(ble_conn_context_t* ctx);
 
+#if defined( ADD_BLE_LL )
+// 挂接LBM无线电规划器，连接事件和扫描窗口作为规划器任务运行 / Attach the LBM radio planner, connection events and
+// scan windows then run as planner tasks
+ble_status_t ble_ll_attach_radio_planner(ble_conn_context_t* ctx, radio_planner_t* rp);
+#endif
+
 /* 内部函数 / Internal Functions */
 
 // 获取信道频率 / Get channel frequency
@@ -145,12 +344,6 @@ uint32_t ble_ll_get_frequency(uint8_t channel);
 // 计算下一个数据信道 / Calculate next data channel
 uint8_t ble_ll_calculate_next_channel(ble_conn_context_t* ctx);
 
-// 计算CRC / Calculate CRC
-uint32_t ble_ll_calculate_crc(uint8_t* data, uint16_t len, uint32_t crc_init);
-
-// 数据白化 / Data whitening
-void ble_ll_whiten_data(uint8_t* data, uint16_t len, uint8_t channel);
-
 // 生成接入地址 / Generate access address
 uint32_t ble_ll_generate_access_address(void);
 
@@ -203,7 +396,30 @@ ble_status_t ll_send_l2cap_frame(ble_conn_context_t* ctx, l2cap_frame_t* frame);
 // 验证接入地址 / Validate access address
 bool ll_validate_access_address(uint32_t aa);
 
+// 发送PDU入队 / Enqueue a transmit PDU
+ble_status_t ll_tx_enqueue(ble_conn_context_t* ctx, uint8_t llid, const uint8_t* payload, uint8_t len);
+
+// L2CAP SDU按生效负载上限分片入队 / Fragment an L2CAP SDU to the effective payload limit and enqueue it
+ble_status_t ll_tx_enqueue_sdu(ble_conn_context_t* ctx, uint16_t cid, const uint8_t* data, uint16_t len);
+
+// 对端确认后移除队首 / Remove the queue head once acknowledged by the peer
+void ll_tx_ack(ble_conn_context_t* ctx);
+
+// 启动无线电操作，完成由DIO1中断驱动 / Start a radio operation, completion driven by the DIO1 interrupt
+void ll_radio_start(ble_conn_context_t* ctx, ll_radio_op_t op, uint32_t timeout_us);
+
+// 读取并清除DIO1中断后的无线电中断状态 / Read and clear the radio interrupt status after a DIO1 interrupt
+uint16_t ll_radio_get_irq(ble_conn_context_t* ctx);
+
+#if defined( BLE_LL_SOFTWARE_CRC )
+/* CRC和白化由SX1280硬件完成，软件实现只用于测试 / CRC and whitening are done by the SX1280 hardware, the software
+ * versions are for tests only */
+
 // 计算CRC24 / Calculate CRC24
 uint32_t ble_ll_calculate_crc24(uint8_t* data, uint16_t len, uint32_t crc_init);
 
+// 数据白化 / Data whitening
+void ble_ll_whiten_data(uint8_t* data, uint16_t len, uint8_t channel);
+#endif
+
 #endif /* BLE_LL_H */
\ No newline at end of file
@@ -0,0 +1,71 @@
+/**
+ * @file    ble_ll_sched.h
+ * @brief   BLE多连接调度接口 / BLE Multi-connection Scheduler Interface
+ * @date    2024
+ *
+ * @details 一个SX1280作为主设备同时维持多个连接
+ *          One SX1280 keeps several connections as master at the same time
+ *
+ *          - 所有连接使用同一个连接间隔，间隔按连接数等分为时隙 / All connections use the same connection interval,
+ *            split into one slot per connection
+ *          - CONNECT_REQ的窗口偏移把每个连接的锚点放在自己的时隙 / The CONNECT_REQ window offset puts the anchor point
+ *            of every connection in its own slot
+ *          - 连接事件在下一个时隙的唤醒余量之前结束，未连接的时隙借给前一个连接 / A connection event ends before the
+ *            wake-up lead of the next slot, the slots of unconnected links are lent to the previous connection
+ *          - 扫描和发起连接使用连接事件之间的空隙 / Scanning and initiating use the gaps between connection events
+ *
+ * @note 不与无线电规划器(ADD_BLE_LL)同时使用 / Not used together with the radio planner (ADD_BLE_LL)
+ */
+
+#ifndef BLE_LL_SCHED_H
+#define BLE_LL_SCHED_H
+
+#include "ble_ll.h"
+
+/* 调度参数 / Scheduling Parameters */
+#ifndef BLE_LL_SCHED_MIN_SLOT_US
+#define BLE_LL_SCHED_MIN_SLOT_US          7500   // 最短时隙：唤醒余量加一次最长交换 / Shortest slot: wake-up lead
+                                                 // plus one longest exchange
+#endif
+#ifndef BLE_LL_SCHED_SCAN_GUARD_US
+#define BLE_LL_SCHED_SCAN_GUARD_US        2000   // 连接事件唤醒前停止扫描的余量(覆盖CONNECT_REQ) / Scanning stops this
+                                                 // long before a connection event wake-up (covers CONNECT_REQ)
+#endif
+
+/* 多连接调度器 / Multi-connection Scheduler */
+typedef struct {
+    ble_conn_context_t* links[BLE_LL_MAX_CONNECTIONS];  // 时隙i属于links[i] / Slot i belongs to links[i]
+    uint8_t link_count;                                 // 已登记的连接数 / Registered links
+    uint8_t max_links;                                  // 时隙数 / Number of slots
+    uint32_t interval_us;                               // 公共连接间隔(微秒) / Common connection interval
+                                                        // (microseconds)
+    uint32_t slot_us;                                   // 每个时隙的时长(微秒) / Slot duration (microseconds)
+    uint64_t epoch;                                     // 时隙0的时间基准 / Time base of slot 0
+    uint32_t yielded_scans;                             // 让给连接事件的扫描窗口数 / Scan windows yielded to
+                                                        // connection events
+} ble_ll_sched_t;
+
+/* 调度API函数 / Scheduler API Functions */
+
+// 初始化调度器，conn_interval为0时取max_links个最短时隙 / Initialize the scheduler, max_links shortest slots when
+// conn_interval is 0
+ble_status_t ble_ll_sched_init(ble_ll_sched_t* sched, uint8_t max_links, uint16_t conn_interval);
+
+// 登记连接上下文(ble_ll_init之后)，按登记顺序分配时隙 / Register a connection context (after ble_ll_init), slots
+// are given in registration order
+ble_status_t ble_ll_sched_add(ble_ll_sched_t* sched, ble_conn_context_t* ctx);
+
+// 在连接的时隙上发起连接，连接间隔由调度器决定 / Initiate a connection in the slot of the link, the connection
+// interval is set by the scheduler
+ble_status_t ble_ll_sched_connect(ble_ll_sched_t* sched, ble_conn_context_t* ctx, uint8_t* peer_addr,
+                                  ble_conn_params_t* params);
+
+// 处理所有连接的事件(主循环调用，替代ble_ll_process_events) / Process the events of all links (called from the main
+// loop, replaces ble_ll_process_events)
+void ble_ll_sched_process(ble_ll_sched_t* sched);
+
+// DIO1中断分发到占用无线电的连接(替代ble_ll_radio_irq_handler) / Route the DIO1 interrupt to the link using the
+// radio (replaces ble_ll_radio_irq_handler)
+void ble_ll_sched_radio_irq_handler(ble_ll_sched_t* sched);
+
+#endif /* BLE_LL_SCHED_H */
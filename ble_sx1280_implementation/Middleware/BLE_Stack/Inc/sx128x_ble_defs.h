@@ -56,7 +56,9 @@ typedef enum {
     SX128X_BLE_SCANNER = 0x00,            // 扫描器模式 / Scanner mode
     SX128X_BLE_ADVERTISER = 0x01,         // 广播器模式 / Advertiser mode
     SX128X_BLE_MASTER = 0x00,             // 主设备模式 / Master mode
-    SX128X_BLE_SLAVE = 0x01               // 从设备模式 / Slave mode
+    SX128X_BLE_SLAVE = 0x01,              // 从设备模式 / Slave mode
+    SX128X_BLE_PAYLOAD_MAX_37_BYTES = 0x20,   // 广播信道最大负载 / Advertising channel maximum payload
+    SX128X_BLE_PAYLOAD_MAX_255_BYTES = 0x80   // 数据长度扩展后的最大负载 / Maximum payload with Data Length Extension
 } sx128x_ble_con_state_t;
 
 /* BLE CRC类型 / BLE CRC Type */
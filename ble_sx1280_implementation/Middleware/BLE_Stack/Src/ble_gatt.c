@@ -12,6 +12,7 @@
  *          - 文本消息发送 / Text message sending
  *          - 通知接收处理 / Notification reception handling
  *          - 简化的服务发现 / Simplified service discovery
+ *          - 异步请求队列和按对端地址的句柄缓存 / Asynchronous request queue and per-peer handle cache
  */
 
 #include "ble_gatt.h"
@@ -44,6 +45,559 @@ static const gatt_bracelet_handles_t bracelet_handles[] = {
     }
 };
 
+/* 句柄缓存条目 / Handle Cache Entry */
+typedef struct {
+    uint8_t peer_addr[6];       // 对端地址 / Peer address
+    bracelet_type_t type;       // 已发现的手环类型 / Discovered bracelet type
+    uint16_t mtu;               // 上次协商的MTU，0为未知 / MTU negotiated last time, 0 when unknown
+    bool valid;                 // 有效标志 / Valid flag
+} gatt_handle_cache_entry_t;
+
+/* 句柄缓存，重连时跳过发现 / Handle cache, skips discovery on reconnection */
+static gatt_handle_cache_entry_t handle_cache[GATT_HANDLE_CACHE_SIZE];
+static uint8_t handle_cache_next;  // 下一个替换的条目 / Next entry to replace
+
+static ble_status_t gatt_async_enqueue(gatt_client_context_t* ctx, const att_msg_t* msg, gatt_complete_cb_t cb,
+                                       void* user);
+
+/**
+ * @brief 按对端地址查找缓存条目 / Find the cache entry of the peer address
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @return 缓存条目，未找到时为NULL / Cache entry, NULL when not found
+ */
+static gatt_handle_cache_entry_t* gatt_find_cache_entry(gatt_client_context_t* ctx)
+{
+    for (uint8_t i = 0; i < GATT_HANDLE_CACHE_SIZE; i++) {
+        if (handle_cache[i].valid && (memcmp(handle_cache[i].peer_addr, ctx->ll_ctx->peer_addr, 6) == 0)) {
+            return &handle_cache[i];
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief 设置手环类型并写入句柄缓存 / Set the bracelet type and store it in the handle cache
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param type 手环类型 / Bracelet type
+ */
+static void gatt_set_bracelet(gatt_client_context_t* ctx, bracelet_type_t type)
+{
+    gatt_handle_cache_entry_t* entry = gatt_find_cache_entry(ctx);
+    
+    ctx->bracelet_type = type;
+    ctx->handles = bracelet_handles[type];  // 加载对应的句柄配置 / Load corresponding handle configuration
+    
+    if (!entry) {
+        /* 轮流替换 / Round-robin replacement */
+        entry = &handle_cache[handle_cache_next];
+        handle_cache_next = (handle_cache_next + 1) % GATT_HANDLE_CACHE_SIZE;
+        memcpy(entry->peer_addr, ctx->ll_ctx->peer_addr, 6);
+        entry->valid = true;
+    }
+    entry->type = type;
+    
+    /* MTU交换排在发现之前，此时已完成 / The MTU exchange is queued before the discovery, it is complete by now */
+    entry->mtu = ctx->mtu_exchanged ? ctx->mtu : 0;
+}
+
+/**
+ * @brief 是否需要交换MTU / Whether the MTU exchange is needed
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @return true需要交换 / true when the exchange is needed
+ *
+ * @details 每个连接交换一次；上次停留在23字节的对端不再请求，省去一次往返
+ *          Exchanged once per connection; peers that stayed at 23 bytes last time are not asked again, saving a round
+ *          trip
+ */
+static bool gatt_mtu_exchange_needed(gatt_client_context_t* ctx)
+{
+    if (ctx->mtu_exchanged) {
+        return false;
+    }
+    
+    gatt_handle_cache_entry_t* entry = gatt_find_cache_entry(ctx);
+    
+    return !entry || (entry->mtu != ATT_MTU_DEFAULT);
+}
+
+/**
+ * @brief MTU交换结束，记录对端MTU / MTU exchange over, remember the peer MTU
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param status 交换状态 / Exchange status
+ *
+ * @details 错误响应表示对端不支持交换，记为23；超时或断开时下次重试
+ *          An error response means the peer does not support the exchange, remembered as 23; retried next time after
+ *          a timeout or a disconnection
+ */
+static void gatt_mtu_done(gatt_client_context_t* ctx, ble_status_t status)
+{
+    if ((status != BLE_STATUS_OK) && (status != BLE_STATUS_PROTOCOL_ERROR)) {
+        ctx->mtu_exchanged = false;
+        return;
+    }
+    
+    gatt_handle_cache_entry_t* entry = gatt_find_cache_entry(ctx);
+    if (entry) {
+        entry->mtu = ctx->mtu;
+    }
+}
+
+/**
+ * @brief 异步MTU交换完成 / Asynchronous MTU exchange complete
+ */
+static void gatt_exchange_mtu_cb(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                                 void* user)
+{
+    gatt_mtu_done(ctx, status);
+}
+
+/**
+ * @brief 排队MTU交换 / Queue the MTU exchange
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @return 操作状态 / Operation status
+ */
+static ble_status_t gatt_exchange_mtu_async(gatt_client_context_t* ctx)
+{
+    att_msg_t req;
+    
+    req.opcode = ATT_EXCHANGE_MTU_REQ;
+    req.params.exchange_mtu.client_rx_mtu = ATT_MTU_MAX;
+    
+    ble_status_t status = gatt_async_enqueue(ctx, &req, gatt_exchange_mtu_cb, NULL);
+    if (status == BLE_STATUS_OK) {
+        ctx->mtu_exchanged = true;
+    }
+    
+    return status;
+}
+
+/**
+ * @brief 由设备名称识别手环类型 / Identify the bracelet type from the device name
+ * @param name 设备名称(无结束符) / Device name (not terminated)
+ * @param len 名称长度 / Name length
+ * @return 手环类型 / Bracelet type
+ */
+static bracelet_type_t gatt_type_from_name(const uint8_t* name, uint16_t len)
+{
+    char name_str[ATT_MTU_MAX];
+    
+    if (len >= sizeof(name_str)) {
+        len = sizeof(name_str) - 1;
+    }
+    memcpy(name_str, name, len);
+    name_str[len] = '\0';
+    
+    if (strstr(name_str, "Mi Band") != NULL) {
+        return BRACELET_TYPE_XIAOMI;           // 检测到小米手环 / Xiaomi bracelet detected
+    } else if (strstr(name_str, "Nordic") != NULL) {
+        return BRACELET_TYPE_NORDIC_UART;      // 检测到Nordic UART设备 / Nordic UART device detected
+    }
+    return BRACELET_TYPE_CUSTOM;               // 未知设备，使用自定义配置 / Unknown device, use custom config
+}
+
+/**
+ * @brief 由主服务列表识别手环类型 / Identify the bracelet type from the primary service list
+ * @param rsp Read By Type响应(含操作码) / Read By Type response (with opcode)
+ * @param rsp_len 响应长度 / Response length
+ * @return 手环类型，未找到已知服务时为自定义 / Bracelet type, custom when no known service is found
+ */
+static bracelet_type_t gatt_type_from_services(const uint8_t* rsp, uint16_t rsp_len)
+{
+    const uint8_t* p = rsp + 1;  // 跳过opcode / Skip opcode
+    uint8_t len = *p++;          // 每个attribute数据的长度 / Length of each attribute data
+    
+    while ((len >= 4) && ((p - rsp) + 4 <= rsp_len)) {
+        uint16_t uuid = p[2] | (p[3] << 8);     // 服务UUID / Service UUID
+        
+        /* 检查已知服务UUID / Check known service UUIDs */
+        if (uuid == 0xFEE0) {  // 小米手环服务 / Xiaomi bracelet service
+            return BRACELET_TYPE_XIAOMI;
+        } else if (uuid == UUID_NORDIC_UART_SERVICE) {  // Nordic UART服务 / Nordic UART service
+            return BRACELET_TYPE_NORDIC_UART;
+        }
+        
+        p += len;  // 移动到下一个属性 / Move to next attribute
+    }
+    
+    return BRACELET_TYPE_CUSTOM;
+}
+
+/* 异步请求队列 / Asynchronous Request Queue */
+
+/**
+ * @brief 发送队首请求 / Send the queue head request
+ * @param ctx GATT客户端上下文 / GATT client context
+ *
+ * @details 同一时刻只有一个ATT请求在途；LL发送队列满时由ble_gatt_process重试
+ *          Only one ATT request is in flight at a time; retried by ble_gatt_process when the LL transmit queue is
+ *          full
+ */
+static void gatt_async_send_next(gatt_client_context_t* ctx)
+{
+    if (ctx->req_inflight || (ctx->req_count == 0)) {
+        return;
+    }
+    
+    if (gatt_send_att_request(ctx, &ctx->req_queue[ctx->req_head].msg) == BLE_STATUS_OK) {
+        ctx->req_inflight = true;
+        ctx->req_sent_time = HAL_GetTick();
+    }
+}
+
+/**
+ * @brief 请求入队 / Enqueue a request
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param msg ATT请求 / ATT request
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ */
+static ble_status_t gatt_async_enqueue(gatt_client_context_t* ctx, const att_msg_t* msg, gatt_complete_cb_t cb,
+                                       void* user)
+{
+    if (ctx->req_count >= GATT_REQ_QUEUE_SIZE) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    gatt_async_req_t* req = &ctx->req_queue[(ctx->req_head + ctx->req_count) % GATT_REQ_QUEUE_SIZE];
+    req->msg = *msg;
+    req->cb = cb;
+    req->user = user;
+    ctx->req_count++;
+    
+    gatt_async_send_next(ctx);
+    
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 完成在途请求并发送下一个 / Complete the in-flight request and send the next one
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param status 完成状态 / Completion status
+ * @param data 响应PDU / Response PDU
+ * @param len 响应长度 / Response length
+ */
+static void gatt_async_complete(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len)
+{
+    gatt_async_req_t* req = &ctx->req_queue[ctx->req_head];
+    gatt_complete_cb_t cb = req->cb;
+    void* user = req->user;
+    
+    /* 回调前出队，回调中可以继续入队 / Dequeued before the callback, which may enqueue more */
+    ctx->req_head = (ctx->req_head + 1) % GATT_REQ_QUEUE_SIZE;
+    ctx->req_count--;
+    ctx->req_inflight = false;
+    
+    if (cb) {
+        cb(ctx, status, data, len, user);
+    }
+    
+    gatt_async_send_next(ctx);
+}
+
+/**
+ * @brief 结束异步发现 / End the asynchronous discovery
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param status 发现状态 / Discovery status
+ * @param type 手环类型 / Bracelet type
+ */
+static void gatt_discover_done(gatt_client_context_t* ctx, ble_status_t status, bracelet_type_t type)
+{
+    gatt_discover_cb_t cb = ctx->discover_cb;
+    
+    if (status == BLE_STATUS_OK) {
+        gatt_set_bracelet(ctx, type);
+    }
+    
+    ctx->discover_cb = NULL;
+    if (cb) {
+        cb(ctx, status, type);
+    }
+}
+
+/**
+ * @brief 主服务读取完成 / Primary service read complete
+ */
+static void gatt_discover_services_cb(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                                      void* user)
+{
+    if (status != BLE_STATUS_OK) {
+        gatt_discover_done(ctx, status, BRACELET_TYPE_UNKNOWN);
+        return;
+    }
+    
+    gatt_discover_done(ctx, BLE_STATUS_OK, gatt_type_from_services(data, len));
+}
+
+/**
+ * @brief 设备名称读取完成 / Device name read complete
+ *
+ * @details 读取名称失败时通过服务UUID识别 / Falls back to the service UUIDs when reading the name fails
+ */
+static void gatt_discover_name_cb(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                                  void* user)
+{
+    if (status == BLE_STATUS_OK) {
+        gatt_discover_done(ctx, BLE_STATUS_OK, gatt_type_from_name(data + 1, len - 1));
+        return;
+    }
+    
+    /* 构建Read By Type请求查找主服务 / Build Read By Type request to find primary services */
+    att_msg_t req;
+    req.opcode = ATT_READ_BY_TYPE_REQ;
+    req.params.read_by_type.starting_handle = 0x0001;   // 从句柄1开始 / Start from handle 1
+    req.params.read_by_type.ending_handle = 0xFFFF;     // 到最大句柄 / To maximum handle
+    req.params.read_by_type.uuid16 = UUID_PRIMARY_SERVICE;  // 查找主服务UUID / Find primary service UUID
+    
+    status = gatt_async_enqueue(ctx, &req, gatt_discover_services_cb, NULL);
+    if (status != BLE_STATUS_OK) {
+        gatt_discover_done(ctx, status, BRACELET_TYPE_UNKNOWN);
+    }
+}
+
+/**
+ * @brief 继续写命令流 / Continue the Write Command stream
+ * @param ctx GATT客户端上下文 / GATT client context
+ *
+ * @details 之前排队的请求完成后才开始，保持写入顺序；LL发送队列满时下次继续
+ *          Starts only once the previously queued requests are complete, keeping the write order; resumes next time
+ *          when the LL transmit queue is full
+ */
+static void gatt_stream_continue(gatt_client_context_t* ctx)
+{
+    if (!ctx->stream_data || (ctx->req_count > 0)) {
+        return;
+    }
+    
+    while (ctx->stream_offset < ctx->stream_length) {
+        uint16_t chunk_len = ctx->stream_length - ctx->stream_offset;
+        if (chunk_len > ctx->mtu - 3) {
+            chunk_len = ctx->mtu - 3;  // 减去3字节的ATT头 / Subtract 3 bytes for ATT header
+        }
+        
+        if (ble_gatt_write_cmd(ctx, ctx->stream_handle, &ctx->stream_data[ctx->stream_offset], chunk_len) !=
+            BLE_STATUS_OK) {
+            return;
+        }
+        ctx->stream_offset += chunk_len;
+    }
+    
+    gatt_complete_cb_t cb = ctx->stream_cb;
+    ctx->stream_data = NULL;
+    if (cb) {
+        cb(ctx, BLE_STATUS_OK, NULL, 0, ctx->stream_user);
+    }
+}
+
+/**
+ * @brief 结束长属性读写 / End the long attribute read or write
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param status 完成状态 / Completion status
+ * @param data 读取的数据，写入时为NULL / Data read, NULL for a write
+ * @param len 读取长度 / Length read
+ */
+static void gatt_long_done(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len)
+{
+    gatt_complete_cb_t cb = ctx->long_cb;
+    
+    ctx->long_data = NULL;
+    if (cb) {
+        cb(ctx, status, data, len, ctx->long_user);
+    }
+}
+
+/**
+ * @brief 长属性读取的读取/Read Blob响应 / Read or Read Blob response of a long attribute read
+ *
+ * @details 响应填满MTU时值可能更长，从已读长度继续Read Blob
+ *          The value may be longer when the response fills the MTU, Read Blob continues from the length read
+ */
+static void gatt_long_read_cb(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                              void* user)
+{
+    if (status != BLE_STATUS_OK) {
+        /* 值恰好在分片边界结束 / The value ended exactly on a part boundary */
+        if ((status == BLE_STATUS_PROTOCOL_ERROR) && (ctx->long_offset > 0) && (len >= 5) &&
+            ((data[4] == ATT_ERROR_ATTRIBUTE_NOT_LONG) || (data[4] == ATT_ERROR_INVALID_OFFSET))) {
+            status = BLE_STATUS_OK;
+        }
+        gatt_long_done(ctx, status, ctx->long_data, ctx->long_offset);
+        return;
+    }
+    
+    uint16_t value_len = len - 1;  // 减去opcode / Subtract opcode
+    uint16_t copy_len = value_len;
+    if (copy_len > ctx->long_length - ctx->long_offset) {
+        copy_len = ctx->long_length - ctx->long_offset;  // 缓冲区已满 / Buffer full
+    }
+    memcpy(&ctx->long_data[ctx->long_offset], data + 1, copy_len);
+    ctx->long_offset += copy_len;
+    
+    if ((value_len == ctx->mtu - 1) && (ctx->long_offset < ctx->long_length)) {
+        att_msg_t req;
+        gatt_build_read_blob_request(&req, ctx->long_handle, ctx->long_offset);
+        status = gatt_async_enqueue(ctx, &req, gatt_long_read_cb, NULL);
+        if (status == BLE_STATUS_OK) {
+            return;
+        }
+    }
+    
+    gatt_long_done(ctx, status, ctx->long_data, ctx->long_offset);
+}
+
+static void gatt_long_write_cb(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                               void* user);
+
+/**
+ * @brief 排队下一个准备写入分片，全部准备后执行写入 / Queue the next Prepare Write part, Execute Write once all are
+ *        prepared
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @return 操作状态 / Operation status
+ */
+static ble_status_t gatt_long_write_next(gatt_client_context_t* ctx)
+{
+    att_msg_t req;
+    
+    if (ctx->long_offset < ctx->long_length) {
+        uint16_t part_len = ctx->long_length - ctx->long_offset;
+        if (part_len > ctx->mtu - 5) {
+            part_len = ctx->mtu - 5;  // 减去5字节的ATT头和偏移 / Subtract 5 bytes for ATT header and offset
+        }
+        gatt_build_prepare_write_request(&req, ctx->long_handle, ctx->long_offset,
+                                         &ctx->long_data[ctx->long_offset], part_len);
+    } else {
+        req.opcode = ATT_EXECUTE_WRITE_REQ;
+        req.params.execute_write.flags = 0x01;
+    }
+    
+    return gatt_async_enqueue(ctx, &req, gatt_long_write_cb, NULL);
+}
+
+/**
+ * @brief 长属性写入的准备/执行写入响应 / Prepare or Execute Write response of a long attribute write
+ *
+ * @details 对端回显每个分片，不一致或出错时取消对端已排队的分片
+ *          The peer echoes every part, the parts it queued are cancelled on a mismatch or an error
+ */
+static void gatt_long_write_cb(gatt_client_context_t* ctx, ble_status_t status, uint8_t* data, uint16_t len,
+                               void* user)
+{
+    if ((status == BLE_STATUS_OK) && (data[0] == ATT_EXECUTE_WRITE_RSP)) {
+        gatt_long_done(ctx, BLE_STATUS_OK, NULL, 0);
+        return;
+    }
+    
+    if (status == BLE_STATUS_OK) {
+        uint16_t part_len = (len >= 5) ? len - 5 : 0;
+        uint16_t offset = (len >= 5) ? (data[3] | (data[4] << 8)) : 0;
+        
+        if ((part_len == 0) || (offset != ctx->long_offset) || (part_len > ctx->long_length - ctx->long_offset) ||
+            (memcmp(&data[5], &ctx->long_data[ctx->long_offset], part_len) != 0)) {
+            status = BLE_STATUS_PROTOCOL_ERROR;
+        } else {
+            ctx->long_offset += part_len;
+            status = gatt_long_write_next(ctx);
+            if (status == BLE_STATUS_OK) {
+                return;
+            }
+        }
+    }
+    
+    if (status != BLE_STATUS_TIMEOUT) {
+        att_msg_t req;
+        req.opcode = ATT_EXECUTE_WRITE_REQ;
+        req.params.execute_write.flags = 0x00;  // 取消 / Cancel
+        gatt_async_enqueue(ctx, &req, NULL, NULL);
+    }
+    
+    gatt_long_done(ctx, status, NULL, 0);
+}
+
+/**
+ * @brief 阻塞写入长属性 / Write a long attribute, blocking
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param handle 目标句柄 / Target handle
+ * @param data 要写入的数据 / Data to write
+ * @param len 数据长度 / Data length
+ * @return 操作状态 / Operation status
+ */
+static ble_status_t gatt_write_long(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len)
+{
+    att_msg_t req;
+    ble_status_t status = BLE_STATUS_OK;
+    uint16_t offset = 0;
+    
+    while (offset < len) {
+        uint16_t part_len = len - offset;
+        if (part_len > ctx->mtu - 5) {
+            part_len = ctx->mtu - 5;  // 减去5字节的ATT头和偏移 / Subtract 5 bytes for ATT header and offset
+        }
+        
+        gatt_build_prepare_write_request(&req, handle, offset, &data[offset], part_len);
+        status = gatt_send_att_request(ctx, &req);
+        if (status == BLE_STATUS_OK) {
+            status = gatt_wait_att_response(ctx, ATT_PREPARE_WRITE_RSP, GATT_ATT_TIMEOUT_MS);
+        }
+        
+        /* 检查对端回显的分片 / Check the part echoed by the peer */
+        if ((status == BLE_STATUS_OK) && ((ctx->response_length != part_len + 5) ||
+                                          (memcmp(&ctx->response_buffer[5], &data[offset], part_len) != 0))) {
+            status = BLE_STATUS_PROTOCOL_ERROR;
+        }
+        if (status != BLE_STATUS_OK) {
+            break;
+        }
+        
+        offset += part_len;
+    }
+    
+    if (status == BLE_STATUS_TIMEOUT) {
+        return status;
+    }
+    
+    /* 全部准备后执行，否则取消对端已排队的分片 / Execute once all parts are prepared, otherwise cancel the parts
+     * queued by the peer */
+    req.opcode = ATT_EXECUTE_WRITE_REQ;
+    req.params.execute_write.flags = (status == BLE_STATUS_OK) ? 0x01 : 0x00;
+    
+    ble_status_t execute_status = gatt_send_att_request(ctx, &req);
+    if (execute_status == BLE_STATUS_OK) {
+        execute_status = gatt_wait_att_response(ctx, ATT_EXECUTE_WRITE_RSP, GATT_ATT_TIMEOUT_MS);
+    }
+    
+    return (status == BLE_STATUS_OK) ? execute_status : status;
+}
+
+/**
+ * @brief 异步写入CCCD / Write the CCCD asynchronously
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param char_handle 特征句柄 / Characteristic handle
+ * @param value CCCD值 / CCCD value
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ */
+static ble_status_t gatt_write_cccd_async(gatt_client_context_t* ctx, uint16_t char_handle, uint16_t value,
+                                          gatt_complete_cb_t cb, void* user)
+{
+    uint8_t cccd_value[2] = {value & 0xFF, value >> 8};
+    uint16_t cccd_handle;
+    
+    if (!ctx) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    /* 查找CCCD句柄（通常在特征句柄+1） / Find CCCD handle (usually at characteristic handle + 1) */
+    if (char_handle == ctx->handles.rx_char_handle) {
+        cccd_handle = ctx->handles.cccd_handle;
+    } else {
+        cccd_handle = char_handle + 1;
+    }
+    
+    return ble_gatt_write_async(ctx, cccd_handle, cccd_value, sizeof(cccd_value), cb, user);
+}
+
 /**
  * @brief 初始化GATT客户端 / Initialize GATT client
  * @param ctx GATT客户端上下文 / GATT client context
@@ -78,9 +632,22 @@ ble_status_t ble_gatt_init(gatt_client_context_t* ctx, ble_conn_context_t* ll_ct
  */
 ble_status_t ble_gatt_discover_bracelet(gatt_client_context_t* ctx, bracelet_type_t* type)
 {
-    att_msg_t req, rsp;
+    att_msg_t req;
     ble_status_t status;
     
+    if (ctx->req_count > 0) {
+        return BLE_STATUS_BUSY;  // 异步请求进行中 / Asynchronous requests in progress
+    }
+    
+    /* 连接后先协商MTU，失败时保持23 / Negotiate the MTU first after connection, stays 23 on failure */
+    ble_gatt_exchange_mtu(ctx);
+    
+    /* 同一对端已发现过时直接使用缓存 / Use the cache when this peer was discovered before */
+    if (gatt_load_cached_handles(ctx)) {
+        *type = ctx->bracelet_type;
+        return BLE_STATUS_OK;
+    }
+    
     /* 读取设备名称特征（通常在0x0003） / Read device name characteristic (usually at 0x0003) */
     gatt_build_read_request(&req, 0x0003);
     
@@ -89,21 +656,11 @@ ble_status_t ble_gatt_discover_bracelet(gatt_client_context_t* ctx, bracelet_typ
         return status;
     }
     
-    status = gatt_wait_att_response(ctx, ATT_READ_RSP, 1000);
+    status = gatt_wait_att_response(ctx, ATT_READ_RSP, GATT_ATT_TIMEOUT_MS);
     if (status == BLE_STATUS_OK) {
         /* 解析设备名称来识别手环类型 / Parse device name to identify bracelet type */
-        uint8_t* name = ctx->response_buffer + 1;  // 跳过opcode / Skip opcode
-        
-        if (strstr((char*)name, "Mi Band") != NULL) {
-            *type = BRACELET_TYPE_XIAOMI;           // 检测到小米手环 / Xiaomi bracelet detected
-        } else if (strstr((char*)name, "Nordic") != NULL) {
-            *type = BRACELET_TYPE_NORDIC_UART;      // 检测到Nordic UART设备 / Nordic UART device detected
-        } else {
-            *type = BRACELET_TYPE_CUSTOM;           // 未知设备，使用自定义配置 / Unknown device, use custom config
-        }
-        
-        ctx->bracelet_type = *type;
-        ctx->handles = bracelet_handles[*type];     // 加载对应的句柄配置 / Load corresponding handle configuration
+        *type = gatt_type_from_name(ctx->response_buffer + 1, ctx->response_length - 1);  // 跳过opcode / Skip opcode
+        gatt_set_bracelet(ctx, *type);
         
         return BLE_STATUS_OK;
     }
@@ -120,39 +677,15 @@ ble_status_t ble_gatt_discover_bracelet(gatt_client_context_t* ctx, bracelet_typ
         return status;
     }
     
-    status = gatt_wait_att_response(ctx, ATT_READ_BY_TYPE_RSP, 1000);
+    status = gatt_wait_att_response(ctx, ATT_READ_BY_TYPE_RSP, GATT_ATT_TIMEOUT_MS);
     if (status != BLE_STATUS_OK) {
         return status;
     }
     
-    /* 解析响应查找已知服务 / Parse response to find known services */
-    uint8_t* p = ctx->response_buffer + 1;  // 跳过opcode / Skip opcode
-    uint8_t len = *p++;  // 每个attribute数据的长度 / Length of each attribute data
-    
-    while (p - ctx->response_buffer < ctx->response_length) {
-        uint16_t handle = p[0] | (p[1] << 8);   // 属性句柄 / Attribute handle
-        uint16_t uuid = p[2] | (p[3] << 8);     // 服务UUID / Service UUID
-        
-        /* 检查已知服务UUID / Check known service UUIDs */
-        if (uuid == 0xFEE0) {  // 小米手环服务 / Xiaomi bracelet service
-            *type = BRACELET_TYPE_XIAOMI;
-            ctx->bracelet_type = *type;
-            ctx->handles = bracelet_handles[*type];
-            return BLE_STATUS_OK;
-        } else if (uuid == UUID_NORDIC_UART_SERVICE) {  // Nordic UART服务 / Nordic UART service
-            *type = BRACELET_TYPE_NORDIC_UART;
-            ctx->bracelet_type = *type;
-            ctx->handles = bracelet_handles[*type];
-            return BLE_STATUS_OK;
-        }
-        
-        p += len;  // 移动到下一个属性 / Move to next attribute
-    }
-    
-    /* 未找到已知服务，使用默认配置 / Known service not found, use default configuration */
-    *type = BRACELET_TYPE_CUSTOM;
-    ctx->bracelet_type = *type;
-    ctx->handles = bracelet_handles[*type];
+    /* 解析响应查找已知服务，未找到时使用默认配置 / Parse response to find known services, default configuration
+     * when not found */
+    *type = gatt_type_from_services(ctx->response_buffer, ctx->response_length);
+    gatt_set_bracelet(ctx, *type);
     
     return BLE_STATUS_OK;
 }
@@ -179,6 +712,11 @@ ble_status_t ble_gatt_write_text(gatt_client_context_t* ctx, const char* text)
     uint16_t text_len = strlen(text);
     uint16_t offset = 0;
     
+    /* 长文本先扩大MTU，对端拒绝时保持23 / Enlarge the MTU first for long text, stays 23 if the peer refuses */
+    if (text_len > ctx->mtu - 3) {
+        ble_gatt_exchange_mtu(ctx);
+    }
+    
     /* 分片发送长文本 / Fragment and send long text */
     while (offset < text_len) {
         uint16_t chunk_len = text_len - offset;
@@ -195,14 +733,52 @@ ble_status_t ble_gatt_write_text(gatt_client_context_t* ctx, const char* text)
         }
         
         offset += chunk_len;
-        
-        /* 短延时避免拥塞 / Short delay to avoid congestion */
-        HAL_Delay(20);  // 20ms延时 / 20ms delay
     }
     
     return BLE_STATUS_OK;
 }
 
+/**
+ * @brief 交换ATT MTU / Exchange the ATT MTU
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @return 操作状态 / Operation status
+ *
+ * @details 请求ATT_MTU_MAX，使一次写入在数据长度扩展后占一个LL PDU；已交换或对端上次停留在23时直接返回
+ *          Requests ATT_MTU_MAX so that one write fits one LL PDU after Data Length Extension; returns at once when
+ *          already exchanged or when the peer stayed at 23 last time
+ */
+ble_status_t ble_gatt_exchange_mtu(gatt_client_context_t* ctx)
+{
+    att_msg_t req;
+    ble_status_t status;
+    
+    if (!ctx) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->req_count > 0) {
+        return BLE_STATUS_BUSY;  // 异步请求进行中 / Asynchronous requests in progress
+    }
+    
+    if (!gatt_mtu_exchange_needed(ctx)) {
+        return BLE_STATUS_OK;
+    }
+    
+    /* 每个连接只交换一次 / Exchanged only once per connection */
+    ctx->mtu_exchanged = true;
+    
+    req.opcode = ATT_EXCHANGE_MTU_REQ;
+    req.params.exchange_mtu.client_rx_mtu = ATT_MTU_MAX;
+    
+    status = gatt_send_att_request(ctx, &req);
+    if (status == BLE_STATUS_OK) {
+        status = gatt_wait_att_response(ctx, ATT_EXCHANGE_MTU_RSP, 1000);  // 1秒超时 / 1 second timeout
+    }
+    gatt_mtu_done(ctx, status);
+    
+    return status;
+}
+
 /**
  * @brief 写入数据到指定句柄 / Write data to specified handle
  * @param ctx GATT客户端上下文 / GATT client context
@@ -210,6 +786,9 @@ ble_status_t ble_gatt_write_text(gatt_client_context_t* ctx, const char* text)
  * @param data 要写入的数据 / Data to write
  * @param len 数据长度 / Data length
  * @return 操作状态 / Operation status
+ *
+ * @details 超过一个写请求时以准备写入分片，执行写入一次提交
+ *          Beyond one Write Request the value goes as Prepare Write parts, committed at once by Execute Write
  */
 ble_status_t ble_gatt_write_data(gatt_client_context_t* ctx, 
                                  uint16_t handle,
@@ -219,8 +798,16 @@ ble_status_t ble_gatt_write_data(gatt_client_context_t* ctx,
     att_msg_t req;
     ble_status_t status;
     
-    if (!ctx || !data || len == 0 || len > ctx->mtu - 3) {
-        return BLE_STATUS_INVALID_PARAMS;  // 参数错误或数据太长 / Invalid params or data too long
+    if (!ctx || !data || len == 0) {
+        return BLE_STATUS_INVALID_PARAMS;  // 参数错误 / Invalid params
+    }
+    
+    if (ctx->req_count > 0) {
+        return BLE_STATUS_BUSY;  // 异步请求进行中 / Asynchronous requests in progress
+    }
+    
+    if (len > ctx->mtu - 3) {
+        return gatt_write_long(ctx, handle, data, len);
     }
     
     /* 构建写请求 / Build write request */
@@ -243,8 +830,12 @@ ble_status_t ble_gatt_write_data(gatt_client_context_t* ctx,
  * @param ctx GATT客户端上下文 / GATT client context
  * @param handle 要读取的句柄 / Handle to read from
  * @param data 读取数据的缓冲区 / Buffer for read data
- * @param len 返回的数据长度 / Returned data length
+ * @param len 输入缓冲区大小，返回数据长度 / Buffer size on input, returned data length
  * @return 操作状态 / Operation status
+ *
+ * @details 响应填满MTU时值可能更长，以Read Blob继续读取直到值结束或缓冲区满
+ *          The value may be longer when the response fills the MTU, reading goes on with Read Blob until the value
+ *          ends or the buffer is full
  */
 ble_status_t ble_gatt_read_data(gatt_client_context_t* ctx,
                                 uint16_t handle,
@@ -253,29 +844,56 @@ ble_status_t ble_gatt_read_data(gatt_client_context_t* ctx,
 {
     att_msg_t req;
     ble_status_t status;
+    uint16_t offset = 0;
     
     if (!ctx || !data || !len) {
         return BLE_STATUS_INVALID_PARAMS;
     }
     
-    /* 构建读请求 / Build read request */
-    gatt_build_read_request(&req, handle);
-    
-    /* 发送请求 / Send request */
-    status = gatt_send_att_request(ctx, &req);
-    if (status != BLE_STATUS_OK) {
-        return status;
+    if (ctx->req_count > 0) {
+        return BLE_STATUS_BUSY;  // 异步请求进行中 / Asynchronous requests in progress
     }
     
-    /* 等待响应 / Wait for response */
-    status = gatt_wait_att_response(ctx, ATT_READ_RSP, 1000);  // 1秒超时 / 1 second timeout
-    if (status != BLE_STATUS_OK) {
-        return status;
+    /* 构建读请求 / Build read request */
+    gatt_build_read_request(&req, handle);
+    
+    while (true) {
+        /* 发送请求 / Send request */
+        status = gatt_send_att_request(ctx, &req);
+        if (status != BLE_STATUS_OK) {
+            return status;
+        }
+        
+        /* 等待响应 / Wait for response */
+        status = gatt_wait_att_response(ctx, (offset == 0) ? ATT_READ_RSP : ATT_READ_BLOB_RSP,
+                                        1000);  // 1秒超时 / 1 second timeout
+        if (status != BLE_STATUS_OK) {
+            /* 值恰好在分片边界结束 / The value ended exactly on a part boundary */
+            if ((status == BLE_STATUS_PROTOCOL_ERROR) && (offset > 0) && (ctx->response_buffer[0] == ATT_ERROR_RSP) &&
+                ((ctx->response_buffer[4] == ATT_ERROR_ATTRIBUTE_NOT_LONG) ||
+                 (ctx->response_buffer[4] == ATT_ERROR_INVALID_OFFSET))) {
+                break;
+            }
+            return status;
+        }
+        
+        /* 复制数据 / Copy data */
+        uint16_t value_len = ctx->response_length - 1;  // 减去opcode / Subtract opcode
+        uint16_t copy_len = value_len;
+        if (copy_len > *len - offset) {
+            copy_len = *len - offset;  // 缓冲区已满 / Buffer full
+        }
+        memcpy(&data[offset], ctx->response_buffer + 1, copy_len);  // 跳过opcode复制数据 / Skip opcode and copy data
+        offset += copy_len;
+        
+        if ((value_len < ctx->mtu - 1) || (offset >= *len)) {
+            break;
+        }
+        
+        gatt_build_read_blob_request(&req, handle, offset);
     }
     
-    /* 复制数据 / Copy data */
-    *len = ctx->response_length - 1;  // 减去opcode / Subtract opcode
-    memcpy(data, ctx->response_buffer + 1, *len);  // 跳过opcode复制数据 / Skip opcode and copy data
+    *len = offset;
     
     return BLE_STATUS_OK;
 }
@@ -328,6 +946,9 @@ void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t
             ctx->response_buffer[0] = opcode;
             ctx->response_length = len;
             ctx->response_received = true;
+            if (ctx->req_inflight) {
+                gatt_async_complete(ctx, BLE_STATUS_PROTOCOL_ERROR, data, len);
+            }
             break;
             
         case ATT_EXCHANGE_MTU_RSP:
@@ -335,8 +956,15 @@ void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t
             ctx->mtu = data[1] | (data[2] << 8);   // 获取服务器支持的MTU / Get server supported MTU
             if (ctx->mtu > ATT_MTU_MAX) {
                 ctx->mtu = ATT_MTU_MAX;            // 限制在最大值 / Limit to maximum value
+            } else if (ctx->mtu < ATT_MTU_DEFAULT) {
+                ctx->mtu = ATT_MTU_DEFAULT;        // 不低于默认值 / Not below the default
             }
+            ctx->response_buffer[0] = opcode;
+            ctx->response_length = len;
             ctx->response_received = true;
+            if (ctx->req_inflight) {
+                gatt_async_complete(ctx, BLE_STATUS_OK, data, len);
+            }
             break;
             
         case ATT_READ_RSP:
@@ -344,10 +972,15 @@ void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t
         case ATT_READ_BY_TYPE_RSP:
         case ATT_READ_BY_GROUP_RSP:
         case ATT_WRITE_RSP:
+        case ATT_PREPARE_WRITE_RSP:
+        case ATT_EXECUTE_WRITE_RSP:
             /* 各种响应 / Various responses */
             memcpy(ctx->response_buffer, data, len);   // 保存响应数据 / Save response data
             ctx->response_length = len;                // 保存响应长度 / Save response length
             ctx->response_received = true;             // 设置接收标志 / Set received flag
+            if (ctx->req_inflight) {
+                gatt_async_complete(ctx, BLE_STATUS_OK, data, len);  // 完成异步请求 / Complete the async request
+            }
             break;
             
         case ATT_HANDLE_VALUE_NTF:
@@ -355,7 +988,11 @@ void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t
             {
                 att_msg_t msg;
                 msg.opcode = opcode;
+                if (len < 3 || len - 3 > sizeof(msg.params.notification.value)) {
+                    break;  // 长度无效 / Invalid length
+                }
                 msg.params.notification.handle = data[1] | (data[2] << 8);    // 提取句柄 / Extract handle
+                msg.params.notification.length = len - 3;                     // 属性值长度 / Attribute value length
                 memcpy(msg.params.notification.value, &data[3], len - 3);     // 复制通知数据 / Copy notification data
                 gatt_process_notification(ctx, &msg);                          // 处理通知 / Process notification
             }
@@ -371,7 +1008,11 @@ void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t
                 /* 处理指示 / Process indication */
                 att_msg_t msg;
                 msg.opcode = opcode;
+                if (len < 3 || len - 3 > sizeof(msg.params.notification.value)) {
+                    break;  // 长度无效 / Invalid length
+                }
                 msg.params.notification.handle = data[1] | (data[2] << 8);    // 提取句柄 / Extract handle
+                msg.params.notification.length = len - 3;                     // 属性值长度 / Attribute value length
                 memcpy(msg.params.notification.value, &data[3], len - 3);     // 复制指示数据 / Copy indication data
                 gatt_process_notification(ctx, &msg);                          // 处理指示 / Process indication
             }
@@ -383,6 +1024,375 @@ void ble_gatt_handle_rx_data(gatt_client_context_t* ctx, uint8_t* data, uint16_t
     }
 }
 
+/**
+ * @brief 处理异步GATT操作 / Process asynchronous GATT operations
+ * @param ctx GATT客户端上下文 / GATT client context
+ *
+ * @details 主循环中调用：请求超时、LL队列满时的重发和写命令流
+ *          Called from the main loop: request timeouts, resends after a full LL queue and the Write Command stream
+ */
+void ble_gatt_process(gatt_client_context_t* ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    
+    if (ctx->req_inflight && ((HAL_GetTick() - ctx->req_sent_time) > GATT_ATT_TIMEOUT_MS)) {
+        gatt_async_complete(ctx, BLE_STATUS_TIMEOUT, NULL, 0);
+    }
+    
+    gatt_async_send_next(ctx);
+    gatt_stream_continue(ctx);
+}
+
+/**
+ * @brief 异步发现手环 / Discover the bracelet asynchronously
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param cb 发现完成回调 / Discovery completion callback
+ * @return 操作状态 / Operation status
+ *
+ * @details 先排队MTU交换，之后的请求使用协商的MTU。同一对端地址已发现过时直接从缓存加载句柄并回调，重连后可立即写入
+ *          The MTU exchange is queued first, the following requests use the negotiated MTU. When this peer address
+ *          was discovered before the handles are loaded from the cache and the callback runs at once, so writes can
+ *          start right after reconnection
+ */
+ble_status_t ble_gatt_discover_bracelet_async(gatt_client_context_t* ctx, gatt_discover_cb_t cb)
+{
+    att_msg_t req;
+    
+    if (!ctx || !cb) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->discover_cb) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    /* 失败时保持23 / Stays 23 on failure */
+    if (gatt_mtu_exchange_needed(ctx)) {
+        gatt_exchange_mtu_async(ctx);
+    }
+    
+    if (gatt_load_cached_handles(ctx)) {
+        cb(ctx, BLE_STATUS_OK, ctx->bracelet_type);
+        return BLE_STATUS_OK;
+    }
+    
+    /* 读取设备名称特征（通常在0x0003） / Read device name characteristic (usually at 0x0003) */
+    gatt_build_read_request(&req, 0x0003);
+    
+    ctx->discover_cb = cb;
+    ble_status_t status = gatt_async_enqueue(ctx, &req, gatt_discover_name_cb, NULL);
+    if (status != BLE_STATUS_OK) {
+        ctx->discover_cb = NULL;
+    }
+    
+    return status;
+}
+
+/**
+ * @brief 异步读取 / Asynchronous read
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param handle 要读取的句柄 / Handle to read from
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ble_gatt_read_async(gatt_client_context_t* ctx, uint16_t handle, gatt_complete_cb_t cb, void* user)
+{
+    att_msg_t req;
+    
+    if (!ctx) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    gatt_build_read_request(&req, handle);
+    
+    return gatt_async_enqueue(ctx, &req, cb, user);
+}
+
+/**
+ * @brief 异步写入 / Asynchronous write
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param handle 目标句柄 / Target handle
+ * @param data 要写入的数据，入队时复制 / Data to write, copied when enqueued
+ * @param len 数据长度 / Data length
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ble_gatt_write_async(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len,
+                                  gatt_complete_cb_t cb, void* user)
+{
+    att_msg_t req;
+    
+    if (!ctx || !data || len == 0 || len > ctx->mtu - 3) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    gatt_build_write_request(&req, handle, (uint8_t*)data, len);
+    
+    return gatt_async_enqueue(ctx, &req, cb, user);
+}
+
+/**
+ * @brief 异步读取长属性 / Read a long attribute asynchronously
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param handle 要读取的句柄 / Handle to read from
+ * @param buffer 读取缓冲区，需保持有效直到回调 / Read buffer, must stay valid until the callback
+ * @param size 缓冲区大小 / Buffer size
+ * @param cb 完成回调，data为buffer，len为读取长度 / Completion callback, data is the buffer and len the length read
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ *
+ * @details 读取后以Read Blob继续，直到响应短于MTU或缓冲区满
+ *          The Read goes on with Read Blob until a response is shorter than the MTU or the buffer is full
+ */
+ble_status_t ble_gatt_read_long_async(gatt_client_context_t* ctx, uint16_t handle, uint8_t* buffer, uint16_t size,
+                                      gatt_complete_cb_t cb, void* user)
+{
+    att_msg_t req;
+    
+    if (!ctx || !buffer || size == 0) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->long_data) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    ctx->long_data = buffer;
+    ctx->long_length = size;
+    ctx->long_offset = 0;
+    ctx->long_handle = handle;
+    ctx->long_cb = cb;
+    ctx->long_user = user;
+    
+    gatt_build_read_request(&req, handle);
+    
+    ble_status_t status = gatt_async_enqueue(ctx, &req, gatt_long_read_cb, NULL);
+    if (status != BLE_STATUS_OK) {
+        ctx->long_data = NULL;
+    }
+    
+    return status;
+}
+
+/**
+ * @brief 异步写入长属性 / Write a long attribute asynchronously
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param handle 目标句柄 / Target handle
+ * @param data 要写入的数据，需保持有效直到回调 / Data to write, must stay valid until the callback
+ * @param len 数据长度 / Data length
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ *
+ * @details 一个写请求放得下时直接写入，否则以准备写入分片并由执行写入一次提交
+ *          A single Write Request is used when the value fits, otherwise Prepare Write parts committed at once by
+ *          Execute Write
+ */
+ble_status_t ble_gatt_write_long_async(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len,
+                                       gatt_complete_cb_t cb, void* user)
+{
+    if (!ctx || !data || len == 0) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (len <= ctx->mtu - 3) {
+        return ble_gatt_write_async(ctx, handle, data, len, cb, user);
+    }
+    
+    if (ctx->long_data) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    ctx->long_data = (uint8_t*)data;
+    ctx->long_length = len;
+    ctx->long_offset = 0;
+    ctx->long_handle = handle;
+    ctx->long_cb = cb;
+    ctx->long_user = user;
+    
+    ble_status_t status = gatt_long_write_next(ctx);
+    if (status != BLE_STATUS_OK) {
+        ctx->long_data = NULL;
+    }
+    
+    return status;
+}
+
+/**
+ * @brief 异步启用通知 / Enable notifications asynchronously
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param char_handle 要启用通知的特征句柄 / Characteristic handle to enable notifications for
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ble_gatt_enable_notifications_async(gatt_client_context_t* ctx, uint16_t char_handle,
+                                                 gatt_complete_cb_t cb, void* user)
+{
+    return gatt_write_cccd_async(ctx, char_handle, 0x0001, cb, user);
+}
+
+/**
+ * @brief 异步禁用通知 / Disable notifications asynchronously
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param char_handle 要禁用通知的特征句柄 / Characteristic handle to disable notifications for
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ble_gatt_disable_notifications_async(gatt_client_context_t* ctx, uint16_t char_handle,
+                                                  gatt_complete_cb_t cb, void* user)
+{
+    return gatt_write_cccd_async(ctx, char_handle, 0x0000, cb, user);
+}
+
+/**
+ * @brief 设置通知/指示回调 / Set the notification/indication callback
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param cb 通知回调，NULL时忽略通知 / Notification callback, notifications are ignored when NULL
+ */
+void ble_gatt_set_notify_callback(gatt_client_context_t* ctx, gatt_notify_cb_t cb)
+{
+    if (!ctx) {
+        return;
+    }
+    
+    ctx->notify_cb = cb;
+}
+
+/**
+ * @brief 写命令 / Write Command
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param handle 目标句柄 / Target handle
+ * @param data 要写入的数据 / Data to write
+ * @param len 数据长度 / Data length
+ * @return 操作状态，LL发送队列满时为BLE_STATUS_BUSY / Operation status, BLE_STATUS_BUSY when the LL transmit queue
+ *         is full
+ *
+ * @details 无需响应，多个写命令可以在同一连接事件中发送
+ *          No response needed, several Write Commands can go out in the same connection event
+ */
+ble_status_t ble_gatt_write_cmd(gatt_client_context_t* ctx, uint16_t handle, const uint8_t* data, uint16_t len)
+{
+    uint8_t pdu[ATT_MTU_MAX];
+    
+    if (!ctx || !data || len == 0 || len > ctx->mtu - 3) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    pdu[0] = ATT_WRITE_CMD;
+    pdu[1] = handle & 0xFF;         // 句柄低字节 / Handle low byte
+    pdu[2] = (handle >> 8) & 0xFF;  // 句柄高字节 / Handle high byte
+    memcpy(&pdu[3], data, len);
+    
+    return ble_ll_send_data(ctx->ll_ctx, pdu, len + 3);
+}
+
+/**
+ * @brief 以写命令流发送文本 / Stream text as Write Commands
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param text 要发送的文本，需保持有效直到回调 / Text to send, must stay valid until the callback
+ * @param cb 完成回调 / Completion callback
+ * @param user 回调用户参数 / Callback user argument
+ * @return 操作状态 / Operation status
+ *
+ * @details 长文本先排队MTU交换；分片由ble_gatt_process按LL发送队列空间推送
+ *          Long text queues an MTU exchange first; fragments are pushed by ble_gatt_process as LL transmit queue
+ *          space frees up
+ */
+ble_status_t ble_gatt_write_text_async(gatt_client_context_t* ctx, const char* text, gatt_complete_cb_t cb,
+                                       void* user)
+{
+    if (!ctx || !text) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->bracelet_type == BRACELET_TYPE_UNKNOWN) {
+        return BLE_STATUS_ERROR;  // 手环类型未知 / Bracelet type unknown
+    }
+    
+    if (ctx->stream_data) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    uint16_t text_len = strlen(text);
+    
+    /* 长文本先扩大MTU / Enlarge the MTU first for long text */
+    if (gatt_mtu_exchange_needed(ctx) && (text_len > ctx->mtu - 3)) {
+        gatt_exchange_mtu_async(ctx);
+    }
+    
+    ctx->stream_data = (const uint8_t*)text;
+    ctx->stream_length = text_len;
+    ctx->stream_offset = 0;
+    ctx->stream_handle = ctx->handles.tx_char_handle;  // 使用手环TX句柄 / Use bracelet TX handle
+    ctx->stream_cb = cb;
+    ctx->stream_user = user;
+    
+    gatt_stream_continue(ctx);
+    
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 终止所有异步操作 / Abort all asynchronous operations
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @param status 传给回调的状态 / Status passed to the callbacks
+ *
+ * @details 断开连接时调用，MTU恢复默认值；句柄缓存和对端MTU保留供重连使用
+ *          Called on disconnection, the MTU returns to the default; the handle cache and the peer MTU are kept for
+ *          reconnection
+ */
+void ble_gatt_abort(gatt_client_context_t* ctx, ble_status_t status)
+{
+    if (!ctx) {
+        return;
+    }
+    
+    gatt_discover_cb_t discover_cb = ctx->discover_cb;
+    ctx->discover_cb = NULL;
+    
+    while (ctx->req_count > 0) {
+        gatt_async_req_t* req = &ctx->req_queue[ctx->req_head];
+        gatt_complete_cb_t cb = req->cb;
+        void* user = req->user;
+        
+        ctx->req_head = (ctx->req_head + 1) % GATT_REQ_QUEUE_SIZE;
+        ctx->req_count--;
+        
+        /* 发现和长属性读写的内部步骤不回调，由discover_cb和long_cb统一通知 / Internal discovery and long
+         * attribute steps are not called back, discover_cb and long_cb report once */
+        if (cb && (cb != gatt_discover_name_cb) && (cb != gatt_discover_services_cb) && (cb != gatt_long_read_cb) &&
+            (cb != gatt_long_write_cb)) {
+            cb(ctx, status, NULL, 0, user);
+        }
+    }
+    ctx->req_inflight = false;
+    
+    if (ctx->stream_data) {
+        gatt_complete_cb_t cb = ctx->stream_cb;
+        ctx->stream_data = NULL;
+        if (cb) {
+            cb(ctx, status, NULL, 0, ctx->stream_user);
+        }
+    }
+    
+    if (ctx->long_data) {
+        gatt_long_done(ctx, status, NULL, 0);
+    }
+    
+    if (discover_cb) {
+        discover_cb(ctx, status, BRACELET_TYPE_UNKNOWN);
+    }
+    
+    ctx->mtu = ATT_MTU_DEFAULT;
+    ctx->mtu_exchanged = false;
+}
+
 /**
  * @brief 发送ATT请求 / Send ATT request
  * @param ctx GATT客户端上下文 / GATT client context
@@ -421,12 +1431,42 @@ ble_status_t gatt_send_att_request(gatt_client_context_t* ctx, att_msg_t* req)
             pdu[pdu_len++] = (req->params.read.handle >> 8) & 0xFF;     // 句柄高字节 / Handle high byte
             break;
             
+        case ATT_READ_BLOB_REQ:
+            /* 读取长属性请求 / Read Blob request */
+            pdu[pdu_len++] = req->params.read_blob.handle & 0xFF;           // 句柄低字节 / Handle low byte
+            pdu[pdu_len++] = (req->params.read_blob.handle >> 8) & 0xFF;    // 句柄高字节 / Handle high byte
+            pdu[pdu_len++] = req->params.read_blob.offset & 0xFF;           // 偏移低字节 / Offset low byte
+            pdu[pdu_len++] = (req->params.read_blob.offset >> 8) & 0xFF;    // 偏移高字节 / Offset high byte
+            break;
+            
         case ATT_WRITE_REQ:
             /* 写入请求 / Write request */
             pdu[pdu_len++] = req->params.write.handle & 0xFF;           // 句柄低字节 / Handle low byte
             pdu[pdu_len++] = (req->params.write.handle >> 8) & 0xFF;    // 句柄高字节 / Handle high byte
-            memcpy(&pdu[pdu_len], req->params.write.value, ctx->mtu - 3);  // 复制写入数据 / Copy write data
-            pdu_len += ctx->mtu - 3;
+            memcpy(&pdu[pdu_len], req->params.write.value, req->params.write.length);  // 复制写入数据 / Copy write data
+            pdu_len += req->params.write.length;
+            break;
+            
+        case ATT_PREPARE_WRITE_REQ:
+            /* 准备写入请求 / Prepare Write request */
+            pdu[pdu_len++] = req->params.prepare_write.handle & 0xFF;           // 句柄低字节 / Handle low byte
+            pdu[pdu_len++] = (req->params.prepare_write.handle >> 8) & 0xFF;    // 句柄高字节 / Handle high byte
+            pdu[pdu_len++] = req->params.prepare_write.offset & 0xFF;           // 偏移低字节 / Offset low byte
+            pdu[pdu_len++] = (req->params.prepare_write.offset >> 8) & 0xFF;    // 偏移高字节 / Offset high byte
+            memcpy(&pdu[pdu_len], req->params.prepare_write.value,
+                   req->params.prepare_write.length);  // 复制分片数据 / Copy part data
+            pdu_len += req->params.prepare_write.length;
+            break;
+            
+        case ATT_EXECUTE_WRITE_REQ:
+            /* 执行写入请求 / Execute Write request */
+            pdu[pdu_len++] = req->params.execute_write.flags;
+            break;
+            
+        case ATT_EXCHANGE_MTU_REQ:
+            /* MTU交换请求 / Exchange MTU request */
+            pdu[pdu_len++] = req->params.exchange_mtu.client_rx_mtu & 0xFF;         // MTU低字节 / MTU low byte
+            pdu[pdu_len++] = (req->params.exchange_mtu.client_rx_mtu >> 8) & 0xFF;  // MTU高字节 / MTU high byte
             break;
             
         default:
@@ -435,9 +1475,13 @@ ble_status_t gatt_send_att_request(gatt_client_context_t* ctx, att_msg_t* req)
     
     /* 保存待确认信息 / Save pending confirmation info */
     ctx->pending_op = req->opcode;
-    ctx->pending_handle = (req->opcode == ATT_WRITE_REQ) ? 
-                         req->params.write.handle :      // 写请求使用写句柄 / Write request uses write handle
-                         req->params.read.handle;        // 读请求使用读句柄 / Read request uses read handle
+    if (req->opcode == ATT_WRITE_REQ) {
+        ctx->pending_handle = req->params.write.handle;          // 写请求使用写句柄 / Write request uses write handle
+    } else if (req->opcode == ATT_PREPARE_WRITE_REQ) {
+        ctx->pending_handle = req->params.prepare_write.handle;  // 准备写入句柄 / Prepare Write handle
+    } else {
+        ctx->pending_handle = req->params.read.handle;           // 读请求使用读句柄 / Read request uses read handle
+    }
     
     /* 发送PDU / Send PDU */
     return ble_ll_send_data(ctx->ll_ctx, pdu, pdu_len);
@@ -494,6 +1538,7 @@ void gatt_build_write_request(att_msg_t* msg, uint16_t handle,
 {
     msg->opcode = ATT_WRITE_REQ;           // 设置写请求操作码 / Set write request opcode
     msg->params.write.handle = handle;     // 设置句柄 / Set handle
+    msg->params.write.length = len;        // 设置长度 / Set length
     memcpy(msg->params.write.value, value, len);  // 复制数据 / Copy data
 }
 
@@ -508,24 +1553,52 @@ void gatt_build_read_request(att_msg_t* msg, uint16_t handle)
     msg->params.read.handle = handle;  // 设置句柄 / Set handle
 }
 
+/**
+ * @brief 构建读取长属性请求 / Build Read Blob request
+ * @param msg ATT消息结构 / ATT message structure
+ * @param handle 要读取的句柄 / Handle to read from
+ * @param offset 值偏移 / Value offset
+ */
+void gatt_build_read_blob_request(att_msg_t* msg, uint16_t handle, uint16_t offset)
+{
+    msg->opcode = ATT_READ_BLOB_REQ;        // 设置读取长属性操作码 / Set Read Blob opcode
+    msg->params.read_blob.handle = handle;  // 设置句柄 / Set handle
+    msg->params.read_blob.offset = offset;  // 设置偏移 / Set offset
+}
+
+/**
+ * @brief 构建准备写入请求 / Build Prepare Write request
+ * @param msg ATT消息结构 / ATT message structure
+ * @param handle 目标句柄 / Target handle
+ * @param offset 值偏移 / Value offset
+ * @param value 分片数据 / Part data
+ * @param len 分片长度，不超过MTU-5 / Part length, up to MTU-5
+ */
+void gatt_build_prepare_write_request(att_msg_t* msg, uint16_t handle, uint16_t offset, const uint8_t* value,
+                                      uint16_t len)
+{
+    msg->opcode = ATT_PREPARE_WRITE_REQ;          // 设置准备写入操作码 / Set Prepare Write opcode
+    msg->params.prepare_write.handle = handle;    // 设置句柄 / Set handle
+    msg->params.prepare_write.offset = offset;    // 设置偏移 / Set offset
+    msg->params.prepare_write.length = len;       // 设置长度 / Set length
+    memcpy(msg->params.prepare_write.value, value, len);  // 复制数据 / Copy data
+}
+
 /**
  * @brief 处理通知 / Process notification
  * @param ctx GATT客户端上下文 / GATT client context
  * @param msg 通知消息 / Notification message
  * 
- * @details 处理从手环接收到的通知或指示
- *          Processes notifications or indications received from bracelet
+ * @details 将属性值交给通知回调。on_data_received已收到整个ATT PDU，不能再用属性值回调它
+ *          Hands the attribute value to the notification callback. on_data_received already got the whole ATT PDU,
+ *          it must not be called back with the attribute value
  */
 void gatt_process_notification(gatt_client_context_t* ctx, att_msg_t* msg)
 {
-    /* 检查是否是来自手环的文本通知 / Check if text notification from bracelet */
-    if (msg->params.notification.handle == ctx->handles.rx_char_handle) {
-        /* 通知应用层 / Notify application layer */
-        if (ctx->ll_ctx->on_data_received) {
-            ctx->ll_ctx->on_data_received(ctx->ll_ctx,          // 传递LL上下文 / Pass LL context
-                                        msg->params.notification.value,  // 通知数据 / Notification data
-                                        ctx->response_length - 3);       // 数据长度(减去头部) / Data length (minus header)
-        }
+    if (ctx->notify_cb) {
+        ctx->notify_cb(ctx, msg->params.notification.handle,      // 属性句柄 / Attribute handle
+                       msg->params.notification.value,            // 属性值 / Attribute value
+                       msg->params.notification.length);          // 属性值长度 / Attribute value length
     }
 }
 
@@ -543,6 +1616,28 @@ const gatt_bracelet_handles_t* gatt_get_bracelet_handles(bracelet_type_t type)
     return &bracelet_handles[type];  // 返回对应的句柄配置 / Return corresponding handle configuration
 }
 
+/**
+ * @brief 按对端地址查询句柄缓存 / Look up the handle cache by peer address
+ * @param ctx GATT客户端上下文 / GATT client context
+ * @return true命中并已加载句柄，false未命中 / true on a hit with the handles loaded, false on a miss
+ */
+bool gatt_load_cached_handles(gatt_client_context_t* ctx)
+{
+    gatt_handle_cache_entry_t* entry = gatt_find_cache_entry(ctx);
+    if (!entry) {
+        return false;
+    }
+    
+    const gatt_bracelet_handles_t* handles = gatt_get_bracelet_handles(entry->type);
+    if (!handles) {
+        return false;
+    }
+    ctx->bracelet_type = entry->type;
+    ctx->handles = *handles;
+    
+    return true;
+}
+
 /**
  * @brief 小米手环认证（如果需要） / Xiaomi bracelet authentication (if needed)
  * @param ctx GATT客户端上下文 / GATT client context
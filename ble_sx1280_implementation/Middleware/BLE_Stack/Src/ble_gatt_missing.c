@@ -155,6 +155,7 @@ ble_status_t gatt_authenticate_xiaomi_impl(gatt_client_context_t* ctx)
     HAL_Delay(100);  // 100ms延时 / 100ms delay
     
     /* 读取认证结果 / Read authentication result */
+    resp_len = sizeof(auth_response);
     status = ble_gatt_read_data(ctx, MI_AUTH_CHAR_HANDLE, 
                                auth_response, &resp_len);
     if (status != BLE_STATUS_OK) {
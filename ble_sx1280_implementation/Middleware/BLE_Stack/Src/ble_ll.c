@@ -18,6 +18,10 @@
 #include "stm32g0xx_hal.h"
 #include <stdlib.h>
 
+#if defined( ADD_BLE_LL )
+#include "smtc_modem_hal.h"
+#endif
+
 /* 外部定时器句柄（需要在main.c中定义） / External Timer Handles (must be defined in main.c) */
 extern TIM_HandleTypeDef htim2;     // 微秒定时器 / Microsecond timer (TIM2)
 extern LPTIM_HandleTypeDef hlptim1; // 连接事件定时器 / Connection event timer (LPTIM1)
@@ -25,22 +29,70 @@ extern LPTIM_HandleTypeDef hlptim1; // 连接事件定时器 / Connection event
 /* 私有变量 / Private Variables */
 static uint32_t g_us_counter_high = 0;  // 微秒计数器高32位 / Upper 32 bits of microsecond counter
 static uint8_t g_lfsr_state = 0x53;     // 随机数生成器状态 / LFSR random generator state
+static uint8_t g_ll_users = 0;          // 已初始化的连接上下文数 / Initialized connection contexts
+
+#if defined( ADD_BLE_LL )
+/* 规划器启动回调只收到规划器指针 / Planner launch callbacks only receive the planner pointer */
+static ble_conn_context_t* g_rp_ctx = NULL;
+static rp_radio_params_t g_rp_radio_params;  // 用户任务不使用 / Unused by user tasks
+#endif
 
-/* CRC函数在ble_ll_missing.c中实现，使用完整的查找表 / CRC function implemented in ble_ll_missing.c with complete lookup table */
-extern uint32_t ble_ll_calculate_crc24(uint8_t* data, uint16_t len, uint32_t crc_init);
+/* 私有函数声明 / Private Function Declarations */
+static void ll_arm_event_timer(ble_conn_context_t* ctx);
+static void ll_timer_unregister(ble_conn_context_t* ctx);
+#if defined( ADD_BLE_LL )
+static void ll_rp_release(ble_conn_context_t* ctx, volatile ll_rp_task_state_t* state, uint8_t hook_id);
+#endif
 
-/* 信道映射表 / Channel Frequency Mapping Table */
+/* 信道映射表，按信道索引 / Channel Frequency Mapping Table, by channel index */
 static const uint32_t channel_freq_table[40] = {
-    2402000000, 2404000000, 2406000000, 2408000000, 2410000000,  // 信道 0-4 / Channels 0-4
-    2412000000, 2414000000, 2416000000, 2418000000, 2420000000,  // 信道 5-9 / Channels 5-9
-    2422000000, 2424000000, 2426000000, 2428000000, 2430000000,  // 信道 10-14 / Channels 10-14
-    2432000000, 2434000000, 2436000000, 2438000000, 2440000000,  // 信道 15-19 / Channels 15-19
-    2442000000, 2444000000, 2446000000, 2448000000, 2450000000,  // 信道 20-24 / Channels 20-24
-    2452000000, 2454000000, 2456000000, 2458000000, 2460000000,  // 信道 25-29 / Channels 25-29
-    2462000000, 2464000000, 2466000000, 2468000000, 2470000000,  // 信道 30-34 / Channels 30-34
-    2472000000, 2474000000, 2476000000, 2478000000, 2480000000   // 信道 35-39 / Channels 35-39
+    2404000000, 2406000000, 2408000000, 2410000000, 2412000000,  // 信道 0-4 / Channels 0-4
+    2414000000, 2416000000, 2418000000, 2420000000, 2422000000,  // 信道 5-9 / Channels 5-9
+    2424000000, 2428000000, 2430000000, 2432000000, 2434000000,  // 信道 10-14 / Channels 10-14
+    2436000000, 2438000000, 2440000000, 2442000000, 2444000000,  // 信道 15-19 / Channels 15-19
+    2446000000, 2448000000, 2450000000, 2452000000, 2454000000,  // 信道 20-24 / Channels 20-24
+    2456000000, 2458000000, 2460000000, 2462000000, 2464000000,  // 信道 25-29 / Channels 25-29
+    2466000000, 2468000000, 2470000000, 2472000000, 2474000000,  // 信道 30-34 / Channels 30-34
+    2476000000, 2478000000, 2402000000, 2426000000, 2480000000   // 信道 35-39 / Channels 35-39
 };
 
+/**
+ * @brief 设置信道图并重建重映射表 / Set the channel map and rebuild the remapping table
+ * @param ctx 连接上下文 / Connection context
+ * @param channel_map 37位信道图 / 37-bit channel map
+ *
+ * @details 每个连接事件的信道选择只查表，不再遍历信道图
+ *          Channel selection in every connection event is then a table lookup instead of a channel map scan
+ */
+static void ll_set_channel_map(ble_conn_context_t* ctx, const uint8_t* channel_map)
+{
+    memcpy(ctx->channel_map, channel_map, 5);
+    ctx->channel_map[4] &= 0x1F;  // 信道37-39不是数据信道 / Channels 37-39 are not data channels
+    
+    ctx->num_used_channels = 0;
+    for (uint8_t channel = 0; channel < BLE_LL_DATA_CHANNELS; channel++) {
+        if (ctx->channel_map[channel >> 3] & (1 << (channel & 0x07))) {
+            ctx->channel_remap[ctx->num_used_channels++] = channel;
+        }
+    }
+}
+
+/**
+ * @brief 统计信道图中使用的数据信道数 / Count the data channels used by a channel map
+ * @param channel_map 37位信道图 / 37-bit channel map
+ * @return 使用的数据信道数 / Number of used data channels
+ */
+static uint8_t ll_count_used_channels(const uint8_t* channel_map)
+{
+    uint8_t used = 0;
+    for (uint8_t channel = 0; channel < BLE_LL_DATA_CHANNELS; channel++) {
+        if (channel_map[channel >> 3] & (1 << (channel & 0x07))) {
+            used++;
+        }
+    }
+    return used;
+}
+
 /**
  * @brief 初始化Link Layer / Initialize Link Layer
  * @param ctx 连接上下文 / Connection context
@@ -61,6 +113,8 @@ ble_status_t ble_ll_init(ble_conn_context_t* ctx, void* radio_context)
     ctx->conn_state = CONN_STATE_IDLE;
     ctx->role = BLE_ROLE_MASTER;       // 默认为主设备 / Default as master device
     ctx->max_packets_per_event = 4;    // 每个事件最多4个数据包 / Max 4 packets per event
+    ctx->max_tx_octets = BLE_LL_MIN_DATA_OCTETS;  // 协商前的默认负载上限 / Default payload limit before negotiation
+    ctx->max_rx_octets = BLE_LL_MIN_DATA_OCTETS;
     
     /* 生成随机本地地址 / Generate random local address */
     for (int i = 0; i < 6; i++) {
@@ -69,12 +123,12 @@ ble_status_t ble_ll_init(ble_conn_context_t* ctx, void* radio_context)
     ctx->local_addr[5] |= 0xC0;  // 设置为随机静态地址 / Set as random static address (MSB = 11xxxxxx)
     
     /* 初始化信道图（使用所有37个数据信道） / Initialize channel map (use all 37 data channels) */
-    memset(ctx->channel_map, 0xFF, 4);   // 前32个信道 / First 32 channels
-    ctx->channel_map[4] = 0x1F;          // 后5个信道 / Last 5 channels (bit 0-4)
-    ctx->num_used_channels = 37;         // 总共使用37个信道 / Total 37 channels used
+    static const uint8_t all_channels[5] = {0xFF, 0xFF, 0xFF, 0xFF, 0x1F};
+    ll_set_channel_map(ctx, all_channels);
     
     /* 初始化定时器 / Initialize timers */
     HAL_TIM_Base_Start(&htim2);  // 启动微秒定时器 / Start microsecond timer
+    g_ll_users++;
     
     return BLE_STATUS_OK;
 }
@@ -95,9 +149,12 @@ ble_status_t ble_ll_deinit(ble_conn_context_t* ctx)
         ble_ll_disconnect(ctx, 0x16);  // 远端用户终止连接 / Remote User Terminated Connection
     }
     
-    /* 停止定时器 / Stop timers */
-    HAL_TIM_Base_Stop(&htim2);         // 停止微秒定时器 / Stop microsecond timer
-    HAL_LPTIM_Counter_Stop(&hlptim1);  // 停止连接事件定时器 / Stop connection event timer
+    /* 最后一个上下文停止定时器 / The last context stops the timers */
+    ll_timer_unregister(ctx);
+    if ((g_ll_users > 0) && (--g_ll_users == 0)) {
+        HAL_TIM_Base_Stop(&htim2);         // 停止微秒定时器 / Stop microsecond timer
+        HAL_LPTIM_Counter_Stop(&hlptim1);  // 停止连接事件定时器 / Stop connection event timer
+    }
     
     return BLE_STATUS_OK;
 }
@@ -118,12 +175,107 @@ ble_status_t ble_ll_set_address(ble_conn_context_t* ctx, uint8_t* addr)
     return BLE_STATUS_OK;
 }
 
+/**
+ * @brief 配置接入地址和硬件CRC/白化 / Configure the access address and the hardware CRC/whitening
+ * @param ctx 连接上下文 / Connection context
+ * @param access_address 接入地址 / Access address
+ * @param crc_init CRC初始值 / CRC initial value
+ * @param con_state 最大负载配置 / Maximum payload configuration
+ *
+ * @details SX1280在发送时追加CRC24并白化，接收时校验CRC并去白化，PDU缓冲区只含头部和负载；白化种子随信道设置
+ *          The SX1280 appends the CRC24 and whitens on transmit, checks the CRC and de-whitens on receive, the PDU
+ *          buffer only holds header and payload; the whitening seed is set with the channel
+ */
+static void ll_radio_config_access(ble_conn_context_t* ctx, uint32_t access_address, uint32_t crc_init,
+                                   sx128x_ble_con_state_t con_state)
+{
+    sx128x_pkt_params_ble_t pkt_params = {
+        .con_state = con_state,
+        .crc_type = SX128X_BLE_CRC_3B,             // 3字节CRC / 3-byte CRC
+        .pkt_type = SX128X_BLE_PRBS_9,             // 使用PRBS9序列 / Use PRBS9 sequence
+        .dc_free = SX128X_BLE_WHITENING_ENABLE     // 启用数据白化 / Enable data whitening
+    };
+    sx128x_set_ble_pkt_params(ctx->radio_context, &pkt_params);
+    
+    /* 接入地址，小端字节序 / Access address, little-endian byte order */
+    uint8_t sync_word[4] = {
+        access_address & 0xFF, (access_address >> 8) & 0xFF,
+        (access_address >> 16) & 0xFF, (access_address >> 24) & 0xFF
+    };
+    sx128x_set_ble_sync_word(ctx->radio_context, sync_word);
+    
+    sx128x_set_ble_crc_seed(ctx->radio_context, crc_init & 0xFFFFFF);
+}
+
+/**
+ * @brief 配置SX1280使用广播信道的BLE参数 / Configure the SX1280 with the BLE settings of the advertising channels
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_radio_config_adv(ble_conn_context_t* ctx)
+{
+    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);    // 切换到待机模式 / Switch to standby mode
+    sx128x_set_pkt_type(ctx->radio_context, SX128X_PKT_TYPE_BLE); // 设置为BLE包类型 / Set BLE packet type
+    
+    /* 设置BLE PHY参数 / Set BLE PHY parameters */
+    sx128x_mod_params_ble_t mod_params = {
+        .br_bw = SX128X_BLE_BR_1_000_BW_1_2,      // 比特率1Mbps，带宽1.2MHz / Bit rate 1Mbps, bandwidth 1.2MHz
+        .mod_ind = SX128X_BLE_MOD_IND_0_50,        // 调制指数0.5 / Modulation index 0.5
+        .pulse_shape = SX128X_BLE_PULSE_SHAPE_OFF  // 无脉冲整形 / No pulse shaping
+    };
+    sx128x_set_ble_mod_params(ctx->radio_context, &mod_params);
+    
+    /* 广播接入地址和CRC初始值0x555555 / Advertising access address and CRC init value 0x555555 */
+    ll_radio_config_access(ctx, BLE_ACCESS_ADDRESS_ADV, BLE_CRC_INIT_ADV, SX128X_BLE_PAYLOAD_MAX_37_BYTES);
+}
+
+/**
+ * @brief 配置SX1280在当前广播信道上扫描 / Configure the SX1280 to scan on the current advertising channel
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_start_scan_rx(ble_conn_context_t* ctx)
+{
+    /* 配置SX1280为接收模式 / Configure SX1280 for receive mode */
+    ll_radio_config_adv(ctx);
+    
+    /* 在当前广播信道上扫描 / Scan on the current advertising channel */
+    sx128x_set_rf_freq(ctx->radio_context, ble_ll_get_frequency(ctx->scan_channel));
+    sx128x_set_gfsk_ble_whitening_seed(ctx->radio_context, ctx->scan_channel | 0x40);  // 信道白化种子 / Channel whitening seed
+    sx128x_set_dio_irq_params(ctx->radio_context, LL_RADIO_IRQ_MASK, LL_RADIO_IRQ_MASK, 0, 0);  // RX完成经DIO1通知 / RX done signalled on DIO1
+    ctx->radio_irq_pending = false;
+    sx128x_set_rx(ctx->radio_context);                               // 进入接收模式 / Enter receive mode
+}
+
+/**
+ * @brief 设置扫描窗口并从信道37开始 / Set the scan windows and start from channel 37
+ * @param ctx 连接上下文 / Connection context
+ * @param interval_us 扫描间隔(微秒) / Scan interval (microseconds)
+ * @param window_us 扫描窗口(微秒) / Scan window (microseconds)
+ */
+static void ll_scan_setup(ble_conn_context_t* ctx, uint32_t interval_us, uint32_t window_us)
+{
+    if ((window_us == 0) || (window_us > interval_us)) {
+        window_us = interval_us;  // 窗口不超过间隔 / The window never exceeds the interval
+    }
+    if (window_us == 0) {
+        interval_us = window_us = BLE_LL_SCAN_DEFAULT_WINDOW_US;
+    }
+    ctx->scan_interval_us = interval_us;
+    ctx->scan_window_us = window_us;
+    ctx->scan_window_start = ble_ll_get_timestamp_us();
+    ctx->scan_window_end = 0;
+    ctx->scan_channel = 37;
+}
+
 /**
  * @brief 开始扫描 / Start scanning
  * @param ctx 连接上下文 / Connection context
  * @param params 扫描参数 / Scan parameters
- * @param filter 扫描过滤器回调 / Scan filter callback
+ * @param filter 广播报告回调，可为NULL / Advertising report callback, may be NULL
  * @return 操作状态 / Operation status
+ *
+ * @details 被动扫描，扫描窗口按间隔定时开启并轮换信道37/38/39；开启重复过滤时，同一广播者的相同广播数据只报告一次
+ *          Passive scanning, scan windows open on every interval and rotate over channels 37/38/39; with duplicate
+ *          filtering, identical advertising data from the same advertiser is reported only once
  */
 ble_status_t ble_ll_start_scanning(ble_conn_context_t* ctx, 
                                    ble_scan_params_t* params,
@@ -137,61 +289,173 @@ ble_status_t ble_ll_start_scanning(ble_conn_context_t* ctx,
         return BLE_STATUS_BUSY;
     }
     
+    ctx->scan_filter = filter;
+    ctx->scan_filter_duplicates = params->filter_duplicates;
+    memset(ctx->scan_dedup, 0xFF, sizeof(ctx->scan_dedup));  // 清空重复报告缓存 / Clear the duplicate report cache
+    
+    /* 窗口在ble_ll_process_events中开启，接入规划器时由规划器分配 / Windows are opened in ble_ll_process_events,
+     * granted by the planner when one is attached */
+    ll_scan_setup(ctx, params->scan_interval * 625, params->scan_window * 625);  // 0.625ms单位 / 0.625 ms units
     ctx->conn_state = CONN_STATE_SCANNING;
     
-    /* 配置SX1280为接收模式 / Configure SX1280 for receive mode */
-    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);    // 切换到待机模式 / Switch to standby mode
-    sx128x_set_pkt_type(ctx->radio_context, SX128X_PKT_TYPE_BLE); // 设置为BLE包类型 / Set BLE packet type
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 停止扫描 / Stop scanning
+ * @param ctx 连接上下文 / Connection context
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ble_ll_stop_scanning(ble_conn_context_t* ctx)
+{
+    if (!ctx) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
     
-    /* 设置BLE PHY参数 / Set BLE PHY parameters */
-    sx128x_mod_params_ble_t mod_params = {
-        .br_bw = SX128X_BLE_BR_1_000_BW_1_2,      // 比特率1Mbps，带宽1.2MHz / Bit rate 1Mbps, bandwidth 1.2MHz
-        .mod_ind = SX128X_BLE_MOD_IND_0_50,        // 调制指数0.5 / Modulation index 0.5
-        .pulse_shape = SX128X_BLE_PULSE_SHAPE_OFF  // 无脉冲整形 / No pulse shaping
-    };
-    sx128x_set_ble_mod_params(ctx->radio_context, &mod_params);
+    if ((ctx->conn_state != CONN_STATE_SCANNING) && (ctx->conn_state != CONN_STATE_INITIATING)) {
+        return BLE_STATUS_ERROR;
+    }
     
-    /* 设置包参数 / Set packet parameters */
-    sx128x_pkt_params_ble_t pkt_params = {
-        .con_state = SX128X_BLE_SCANNER,           // 设置为扫描器模式 / Set as scanner mode
-        .crc_type = SX128X_BLE_CRC_3B,             // 3字节CRC / 3-byte CRC
-        .pkt_type = SX128X_BLE_PRBS_9,             // 使用PRBS9序列 / Use PRBS9 sequence
-        .dc_free = SX128X_BLE_WHITENING_ENABLE     // 启用数据白化 / Enable data whitening
-    };
-    sx128x_set_ble_pkt_params(ctx->radio_context, &pkt_params);
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        ctx->conn_state = CONN_STATE_IDLE;
+        if (ctx->rp_scan == LL_RP_TASK_GRANTED) {
+            sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+        }
+        if ((ctx->rp_scan == LL_RP_TASK_QUEUED) || (ctx->rp_scan == LL_RP_TASK_GRANTED)) {
+            ctx->rp_scan = LL_RP_TASK_RELEASING;
+            rp_task_abort(ctx->rp, RP_HOOK_ID_BLE_LL_SCAN);
+        }
+        return BLE_STATUS_OK;
+    }
+#endif
     
-    /* 设置广播接入地址 / Set advertising access address */
-    uint8_t sync_word[4] = {0xD6, 0xBE, 0x89, 0x8E};  // 0x8E89BED6小端字节序 / Little-endian byte order
-    sx128x_set_ble_sync_word(ctx->radio_context, sync_word);
+    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+    ctx->conn_state = CONN_STATE_IDLE;
+    
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 让出扫描窗口 / Yield the scan window
+ * @param ctx 连接上下文 / Connection context
+ * @return 关闭了打开的扫描窗口时返回true / true when an open scan window was closed
+ *
+ * @details 多个连接共享无线电时，在其他连接的连接事件前调用；窗口起点不变，无线电空闲后立即在下一个信道重新开启
+ *          Called ahead of the connection event of another connection when several connections share the radio;
+ *          the window start is kept, so the window reopens on the next channel as soon as the radio is free
+ */
+bool ble_ll_scan_yield(ble_conn_context_t* ctx)
+{
+    if (!ctx || ((ctx->conn_state != CONN_STATE_SCANNING) && (ctx->conn_state != CONN_STATE_INITIATING))) {
+        return false;
+    }
     
-    /* 设置CRC种子 / Set CRC seed */
-    sx128x_set_ble_crc_seed(ctx->radio_context, BLE_CRC_INIT_ADV);  // 广播CRC初始值0x555555 / Advertising CRC init value 0x555555
+    /* CONNECT_REQ发送中不打断 / Never interrupt a CONNECT_REQ transmission */
+    if ((ctx->radio_op != LL_RADIO_OP_IDLE) || (ctx->scan_window_end == 0)) {
+        return false;
+    }
     
-    /* 开始在广播信道37上扫描 / Start scanning on advertising channel 37 */
-    sx128x_set_rf_freq(ctx->radio_context, channel_freq_table[37]);  // 2402 MHz
-    sx128x_set_gfsk_ble_whitening_seed(ctx->radio_context, 37 | 0x40);    // 信道37的白化种子 / Whitening seed for channel 37
-    sx128x_set_rx(ctx->radio_context);                               // 进入接收模式 / Enter receive mode
+    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+    ctx->scan_channel = (ctx->scan_channel >= 39) ? 37 : ctx->scan_channel + 1;
+    ctx->scan_window_end = 0;
+    return true;
+}
+
+/**
+ * @brief 开始广播 / Start advertising
+ * @param ctx 连接上下文 / Connection context
+ * @param params 广播参数，数据被复制 / Advertising parameters, the data is copied
+ * @return 操作状态 / Operation status
+ *
+ * @details 每个广播事件在信道37/38/39上依次发送，可扫描时回复SCAN_REQ，可连接时收到CONNECT_REQ后以从设备角色进入
+ *          连接状态并调用on_connected；事件间隔加0-10ms随机延迟，期间无线电待机
+ *          Every advertising event transmits on channels 37/38/39 in turn, a SCAN_REQ is answered when scannable and
+ *          a CONNECT_REQ enters the connected state in the slave role and calls on_connected when connectable; events
+ *          are spaced by the interval plus a random 0-10 ms delay, with the radio in standby in between
+ */
+ble_status_t ble_ll_start_advertising(ble_conn_context_t* ctx, const ble_adv_params_t* params)
+{
+    if (!ctx || !params || (params->adv_interval < 32) || (params->adv_interval > 16384) ||
+        (params->adv_data_len > 31) || (params->scan_rsp_len > 31) ||
+        ((params->adv_data_len > 0) && !params->adv_data) || ((params->scan_rsp_len > 0) && !params->scan_rsp_data)) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->conn_state != CONN_STATE_IDLE) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    /* 广播PDU：广播者地址加广播数据 / Advertising PDU: advertiser address followed by the advertising data */
+    memset(&ctx->adv_pdu, 0, sizeof(ctx->adv_pdu));
+    if (params->connectable) {
+        ctx->adv_pdu.header.type = BLE_PDU_ADV_IND;
+    } else if (params->scan_rsp_len > 0) {
+        ctx->adv_pdu.header.type = BLE_PDU_ADV_SCAN_IND;
+    } else {
+        ctx->adv_pdu.header.type = BLE_PDU_ADV_NONCONN_IND;
+    }
+    ctx->adv_pdu.header.tx_add = 1;  // 随机静态地址 / Random static address
+    ctx->adv_pdu.header.length = 6 + params->adv_data_len;
+    memcpy(&ctx->adv_pdu.payload[0], ctx->local_addr, 6);
+    if (params->adv_data_len > 0) {
+        memcpy(&ctx->adv_pdu.payload[6], params->adv_data, params->adv_data_len);
+    }
+    if (params->connectable) {
+        ((uint8_t*)&ctx->adv_pdu)[0] |= BLE_PDU_CHSEL;  // 支持CSA#2 / CSA#2 supported
+    }
+    
+    /* 扫描响应PDU / Scan response PDU */
+    memset(&ctx->scan_rsp_pdu, 0, sizeof(ctx->scan_rsp_pdu));
+    ctx->scan_rsp_pdu.header.type = BLE_PDU_SCAN_RSP;
+    ctx->scan_rsp_pdu.header.tx_add = 1;
+    ctx->scan_rsp_pdu.header.length = 6 + params->scan_rsp_len;
+    memcpy(&ctx->scan_rsp_pdu.payload[0], ctx->local_addr, 6);
+    if (params->scan_rsp_len > 0) {
+        memcpy(&ctx->scan_rsp_pdu.payload[6], params->scan_rsp_data, params->scan_rsp_len);
+    }
+    
+    /* 事件在ble_ll_process_events中开始，接入规划器时由规划器分配 / Events are started in ble_ll_process_events,
+     * granted by the planner when one is attached */
+    ctx->adv_interval_us = (uint32_t)params->adv_interval * 625;  // 0.625ms单位 / 0.625 ms units
+    ctx->adv_event_start = ble_ll_get_timestamp_us();
+    ctx->adv_channel = 0;
+    ctx->conn_state = CONN_STATE_ADVERTISING;
     
     return BLE_STATUS_OK;
 }
 
 /**
- * @brief 停止扫描 / Stop scanning
+ * @brief 停止广播 / Stop advertising
  * @param ctx 连接上下文 / Connection context
  * @return 操作状态 / Operation status
  */
-ble_status_t ble_ll_stop_scanning(ble_conn_context_t* ctx)
+ble_status_t ble_ll_stop_advertising(ble_conn_context_t* ctx)
 {
     if (!ctx) {
         return BLE_STATUS_INVALID_PARAMS;
     }
     
-    if (ctx->conn_state != CONN_STATE_SCANNING) {
+    if (ctx->conn_state != CONN_STATE_ADVERTISING) {
         return BLE_STATUS_ERROR;
     }
     
-    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+    /* 丢弃进行中的广播事件 / Drop the advertising event in progress */
     ctx->conn_state = CONN_STATE_IDLE;
+    ctx->adv_channel = 0;
+    ctx->radio_op = LL_RADIO_OP_IDLE;
+    
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        if (ctx->rp_adv == LL_RP_TASK_GRANTED) {
+            sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+        }
+        ll_rp_release(ctx, &ctx->rp_adv, RP_HOOK_ID_BLE_LL_ADV);
+        return BLE_STATUS_OK;
+    }
+#endif
+    
+    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
     
     return BLE_STATUS_OK;
 }
@@ -217,6 +481,7 @@ ble_status_t ble_ll_connect(ble_conn_context_t* ctx,
     }
     
     /* 保存连接参数 / Save connection parameters */
+    ctx->role = BLE_ROLE_MASTER;
     memcpy(ctx->peer_addr, peer_addr, 6);
     ctx->conn_interval = params->conn_interval * 1250;  // 转换为微秒(1.25ms单位) / Convert to microseconds (1.25ms unit)
     ctx->slave_latency = params->slave_latency;
@@ -227,6 +492,11 @@ ble_status_t ble_ll_connect(ble_conn_context_t* ctx,
     ctx->crc_init = ble_ll_generate_crc_init() & 0xFFFFFF;       // 生成24位CRC初始值 / Generate 24-bit CRC init value
     ctx->hop_increment = 5 + (ble_ll_get_random() % 12);         // 跳频增量(5-16) / Hop increment (5-16)
     
+    /* 空闲时以连续扫描窗口寻找目标，扫描中沿用当前窗口 / From idle, continuous scan windows look for the target,
+     * while scanning the current windows are kept */
+    if (ctx->conn_state == CONN_STATE_IDLE) {
+        ll_scan_setup(ctx, BLE_LL_SCAN_DEFAULT_WINDOW_US, BLE_LL_SCAN_DEFAULT_WINDOW_US);
+    }
     ctx->conn_state = CONN_STATE_INITIATING;
     
     /* 准备发送CONNECT_REQ / Prepare to send CONNECT_REQ */
@@ -252,16 +522,14 @@ ble_status_t ble_ll_disconnect(ble_conn_context_t* ctx, uint8_t reason)
     }
     
     /* 发送LL_TERMINATE_IND / Send LL_TERMINATE_IND */
-    uint8_t terminate_pdu[3] = {
-        0x03,             // LLID: LL控制PDU / LLID: LL Control PDU
-        0x02,             // 长度 / Length
+    uint8_t terminate_ind[2] = {
         LL_TERMINATE_IND, // 终止指示 / Terminate indication
         reason            // 终止原因 / Termination reason
     };
     
-    ctx->tx_length = 4;
-    memcpy(ctx->tx_buffer, terminate_pdu, 4);
-    ctx->tx_pending = true;
+    if (ll_tx_enqueue(ctx, 0x03, terminate_ind, sizeof(terminate_ind)) != BLE_STATUS_OK) {
+        return BLE_STATUS_BUSY;
+    }
     
     /* 等待发送完成 / Wait for transmission to complete */
     // 实际发送在下一个连接事件中进行 / Actual transmission occurs in next connection event
@@ -277,10 +545,14 @@ ble_status_t ble_ll_disconnect(ble_conn_context_t* ctx, uint8_t reason)
  * @param data 要发送的数据 / Data to send
  * @param len 数据长度 / Data length
  * @return 操作状态 / Operation status
+ *
+ * @details 数据按生效的负载上限分片进入发送队列，队列满时返回BLE_STATUS_BUSY
+ *          The data is fragmented to the effective payload limit into the transmit queue, BLE_STATUS_BUSY when the
+ *          queue is full
  */
 ble_status_t ble_ll_send_data(ble_conn_context_t* ctx, uint8_t* data, uint16_t len)
 {
-    if (!ctx || !data || len == 0 || len > 251) {
+    if (!ctx || !data || len == 0 || len > ATT_MTU_MAX) {
         return BLE_STATUS_INVALID_PARAMS;
     }
     
@@ -288,302 +560,1731 @@ ble_status_t ble_ll_send_data(ble_conn_context_t* ctx, uint8_t* data, uint16_t l
         return BLE_STATUS_NOT_CONNECTED;
     }
     
-    if (ctx->tx_pending) {
+    return ll_tx_enqueue_sdu(ctx, L2CAP_CID_ATT, data, len);
+}
+
+/**
+ * @brief 发送PDU入队 / Enqueue a transmit PDU
+ * @param ctx 连接上下文 / Connection context
+ * @param llid 链路层标识 / Link Layer ID
+ * @param payload 负载 / Payload
+ * @param len 负载长度 / Payload length
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ll_tx_enqueue(ble_conn_context_t* ctx, uint8_t llid, const uint8_t* payload, uint8_t len)
+{
+    if (ctx->tx_count >= BLE_LL_TX_QUEUE_SIZE) {
         return BLE_STATUS_BUSY;
     }
     
-    /* 构造L2CAP数据PDU / Construct L2CAP data PDU */
-    ctx->tx_buffer[0] = 0x02;     // LLID: L2CAP数据 / LLID: L2CAP data
-    ctx->tx_buffer[1] = len + 4;  // 长度包括L2CAP头 / Length includes L2CAP header
-    
-    /* L2CAP头 / L2CAP header */
-    ctx->tx_buffer[2] = len & 0xFF;                    // L2CAP长度低字节 / L2CAP length low byte
-    ctx->tx_buffer[3] = (len >> 8) & 0xFF;             // L2CAP长度高字节 / L2CAP length high byte
-    ctx->tx_buffer[4] = L2CAP_CID_ATT & 0xFF;          // ATT通道ID低字节 / ATT channel ID low byte
-    ctx->tx_buffer[5] = (L2CAP_CID_ATT >> 8) & 0xFF;   // ATT通道ID高字节 / ATT channel ID high byte
-    
-    /* 复制数据 / Copy data */
-    memcpy(&ctx->tx_buffer[6], data, len);  // 从L2CAP头后开始复制 / Copy after L2CAP header
+    ble_data_pdu_t* pdu = &ctx->tx_queue[(ctx->tx_head + ctx->tx_count) % BLE_LL_TX_QUEUE_SIZE];
     
-    ctx->tx_length = len + 6;
-    ctx->tx_pending = true;
+    memset(pdu, 0, 2);  // SN/NESN/MD在发送时填写 / SN/NESN/MD filled in at transmit time
+    pdu->llid = llid;
+    pdu->length = len;
+    if (len > 0) {
+        memcpy(pdu->payload, payload, len);
+    }
+    ctx->tx_count++;
     
     return BLE_STATUS_OK;
 }
 
 /**
- * @brief 处理连接事件
+ * @brief L2CAP SDU分片入队 / Fragment an L2CAP SDU into the transmit queue
+ * @param ctx 连接上下文 / Connection context
+ * @param cid L2CAP通道ID / L2CAP channel ID
+ * @param data SDU数据 / SDU data
+ * @param len SDU数据长度 / SDU data length
+ * @return 操作状态 / Operation status
+ *
+ * @details 第一个分片LLID为开始(0x02)，其余为继续(0x01)；全部分片放得下时才入队
+ *          The first fragment has the start LLID (0x02), the others continuation (0x01); only enqueued when all
+ *          fragments fit
  */
-static void ll_handle_connection_event(ble_conn_context_t* ctx)
+ble_status_t ll_tx_enqueue_sdu(ble_conn_context_t* ctx, uint16_t cid, const uint8_t* data, uint16_t len)
 {
-    uint8_t channel;
-    uint32_t freq;
-    bool tx_success = false;
-    bool rx_success = false;
-    
-    /* 计算当前数据信道 */
-    channel = ble_ll_calculate_next_channel(ctx);
-    freq = channel_freq_table[channel];
-    
-    /* 配置无线电 */
-    sx128x_set_rf_freq(ctx->radio_context, freq);
-    sx128x_set_gfsk_ble_whitening_seed(ctx->radio_context, channel | 0x40);
+    uint16_t sdu_len = len + 4;
+    uint8_t frag_len = ctx->max_tx_octets;
+    uint16_t nb_frags = (sdu_len + frag_len - 1) / frag_len;
     
-    /* Master TX */
-    if (ctx->tx_pending || ctx->event_counter == 0) {
-        ble_data_pdu_t* tx_pdu = (ble_data_pdu_t*)ctx->tx_buffer;
-        
-        /* 设置PDU头 */
-        if (!ctx->tx_pending) {
-            /* 空PDU */
-            tx_pdu->llid = 0x01;  // LL Control PDU
-            tx_pdu->length = 0;
-        }
-        
-        tx_pdu->nesn = ctx->next_expected_seq_num;
-        tx_pdu->sn = ctx->tx_seq_num;
-        tx_pdu->md = ctx->more_data ? 1 : 0;
-        
-        /* 等待锚点 */
-        if (ctx->event_counter == 0) {
-            ble_ll_wait_until_us(ctx->anchor_point);
-        }
-        
-        /* 发送 */
-        sx128x_set_buffer_base_address(ctx->radio_context, 0x00, 0x80);
-        sx128x_write_buffer(ctx->radio_context, 0x00, 
-                          (uint8_t*)tx_pdu, tx_pdu->length + 2);
-        sx128x_set_tx(ctx->radio_context);
-        
-        /* 等待TX完成 */
-        uint32_t timeout = 1000;  // 1ms超时
-        while (timeout-- && 
-               !(sx128x_get_irq_status(ctx->radio_context) & SX128X_IRQ_TX_DONE)) {
-            ble_ll_delay_us(1);
-        }
-        
-        if (timeout > 0) {
-            tx_success = true;
-            sx128x_clear_irq_status(ctx->radio_context, SX128X_IRQ_TX_DONE);
-        }
+    if (nb_frags > (BLE_LL_TX_QUEUE_SIZE - ctx->tx_count)) {
+        return BLE_STATUS_BUSY;
     }
     
-    /* T_IFS延时 */
-    ble_ll_delay_us(BLE_T_IFS);
-    
-    /* Master RX */
-    sx128x_set_rx_with_timeout(ctx->radio_context, 2);  // 2ms超时
+    /* L2CAP头 / L2CAP header */
+    uint8_t l2cap_header[4] = {
+        len & 0xFF, (len >> 8) & 0xFF,  // L2CAP长度 / L2CAP length
+        cid & 0xFF, (cid >> 8) & 0xFF   // 通道ID / Channel ID
+    };
     
-    uint32_t rx_start = ble_ll_get_timestamp_us();
-    while ((ble_ll_get_timestamp_us() - rx_start) < 2000) {
-        if (sx128x_get_irq_status(ctx->radio_context) & SX128X_IRQ_RX_DONE) {
-            uint8_t rx_len;
-            sx128x_get_rx_buffer_status(ctx->radio_context, &rx_len, NULL);
-            sx128x_read_buffer(ctx->radio_context, 0x80, ctx->rx_buffer, rx_len);
-            
-            rx_success = true;
-            ctx->consecutive_crc_errors = 0;
-            
-            /* 处理接收的PDU */
-            ble_data_pdu_t* rx_pdu = (ble_data_pdu_t*)ctx->rx_buffer;
-            
-            /* 检查序列号 */
-            if (rx_pdu->sn == ctx->next_expected_seq_num) {
-                /* 新数据 */
-                ctx->next_expected_seq_num ^= 1;
-                
-                if (rx_pdu->length > 0) {
-                    /* 处理数据 */
-                    if (rx_pdu->llid == 0x02) {  // L2CAP数据
-                        if (ctx->on_data_received) {
-                            ctx->on_data_received(ctx, &rx_pdu->payload[4], 
-                                                rx_pdu->length - 4);
-                        }
-                    } else if (rx_pdu->llid == 0x03) {  // LL控制PDU
-                        /* 处理控制PDU */
-                        switch (rx_pdu->payload[0]) {
-                            case LL_TERMINATE_IND:
-                                ctx->conn_state = CONN_STATE_IDLE;
-                                if (ctx->on_disconnected) {
-                                    ctx->on_disconnected(ctx, rx_pdu->payload[1]);
-                                }
-                                return;
-                                
-                            case LL_VERSION_IND:
-                                /* 忽略版本信息 */
-                                break;
-                                
-                            case LL_FEATURE_REQ:
-                                /* 回复feature response */
-                                {
-                                    uint8_t feature_rsp[11];
-                                    feature_rsp[0] = 0x03;  // LLID = Control PDU
-                                    feature_rsp[1] = 9;     // Length
-                                    feature_rsp[2] = LL_FEATURE_RSP;
-                                    /* 支持的特性（简化：不支持任何扩展特性） */
-                                    memset(&feature_rsp[3], 0, 8);
-                                    
-                                    /* 保存到发送缓冲区 */
-                                    memcpy(ctx->tx_buffer, feature_rsp, 11);
-                                    ctx->tx_length = 11;
-                                    ctx->tx_pending = true;
-                                }
-                                break;
-                        }
-                    }
-                }
-            }
-            
-            /* 确认收到 / Acknowledge receipt */
-            if (rx_pdu->nesn != ctx->tx_seq_num) {
-                /* 对方确认了我们的数据 / Peer acknowledged our data */
-                ctx->tx_seq_num ^= 1;      // 翻转发送序列号 / Toggle transmit sequence number
-                ctx->tx_pending = false;   // 清除发送等待标志 / Clear transmit pending flag
-            }
-            
-            /* 检查MD位 / Check MD bit */
-            ctx->more_data = rx_pdu->md;  // 更新More Data标志 / Update More Data flag
-            
-            break;
+    uint16_t offset = 0;
+    while (offset < sdu_len) {
+        ble_data_pdu_t* pdu = &ctx->tx_queue[(ctx->tx_head + ctx->tx_count) % BLE_LL_TX_QUEUE_SIZE];
+        uint8_t chunk_len = (sdu_len - offset > frag_len) ? frag_len : (sdu_len - offset);
+        
+        memset(pdu, 0, 2);
+        pdu->llid = (offset == 0) ? 0x02 : 0x01;  // 开始或继续 / Start or continuation
+        pdu->length = chunk_len;
+        for (uint8_t i = 0; i < chunk_len; i++, offset++) {
+            pdu->payload[i] = (offset < 4) ? l2cap_header[offset] : data[offset - 4];
         }
+        ctx->tx_count++;
     }
     
-    if (!rx_success) {
-        ctx->consecutive_crc_errors++;
-        ctx->total_crc_errors++;
-    }
-    
-    /* 更新连接事件参数 / Update connection event parameters */
-    ctx->event_counter++;                      // 增加事件计数器 / Increment event counter
-    ctx->anchor_point += ctx->conn_interval;  // 计算下一个锚点 / Calculate next anchor point
-    
-    /* 检查连接超时 / Check connection timeout */
-    if (ctx->consecutive_crc_errors > 6) {
-        /* 连接丢失 / Connection lost */
-        ctx->conn_state = CONN_STATE_IDLE;
-        if (ctx->on_disconnected) {
-            ctx->on_disconnected(ctx, 0x08);  // 连接超时 / Connection Timeout
-        }
-    }
+    return BLE_STATUS_OK;
 }
 
 /**
- * @brief 处理事件（主循环调用） / Process events (called from main loop)
+ * @brief 移除已确认的队首 / Remove the acknowledged queue head
  * @param ctx 连接上下文 / Connection context
- * 
- * @details 该函数需要在主循环中不断调用，用于处理各种连接状态下的事件
- *          This function needs to be called continuously in main loop to process events in various connection states
  */
-void ble_ll_process_events(ble_conn_context_t* ctx)
+void ll_tx_ack(ble_conn_context_t* ctx)
 {
-    if (!ctx) return;
-    
-    switch (ctx->conn_state) {
-        case CONN_STATE_SCANNING:
-            /* 检查是否收到广播包 / Check if advertising packet received */
-            if (sx128x_get_irq_status(ctx->radio_context) & SX128X_IRQ_RX_DONE) {
-                uint8_t rx_len;
-                uint8_t rx_buffer[255];
-                
-                sx128x_get_rx_buffer_status(ctx->radio_context, &rx_len, NULL);
-                sx128x_read_buffer(ctx->radio_context, 0x80, rx_buffer, rx_len);
-                sx128x_clear_irq_status(ctx->radio_context, SX128X_IRQ_RX_DONE);
-                
-                /* 解析广播包 / Parse advertising packet */
-                ble_adv_pdu_t* adv = (ble_adv_pdu_t*)rx_buffer;
-                
-                /* 检查是否是目标设备 / Check if target device */
-                if (ctx->conn_state == CONN_STATE_INITIATING &&
-                    memcmp(&adv->payload[0], ctx->peer_addr, 6) == 0) {
-                    /* 发送连接请求 / Send connection request */
-                    ll_connect_req_t conn_req;
-                    
-                    /* 构建连接请求 / Build connection request */
-                    conn_req.header = BLE_PDU_CONNECT_REQ;
-                    conn_req.length = 34;                                     // 固定长度 / Fixed length
-                    memcpy(conn_req.init_addr, ctx->local_addr, 6);         // 发起方地址 / Initiator address
-                    memcpy(conn_req.adv_addr, ctx->peer_addr, 6);           // 广播方地址 / Advertiser address
-                    conn_req.access_address = ctx->access_address;          // 连接接入地址 / Connection access address
-                    conn_req.crc_init = ctx->crc_init & 0xFFFFFF;          // CRC初始值 / CRC init value
-                    conn_req.win_size = 2;                                   // 2.5ms窗口 / 2.5ms window
-                    conn_req.win_offset = 0;                                 // 窗口偏移 / Window offset
-                    conn_req.interval = ctx->conn_interval / 1250;          // 转换为1.25ms单位 / Convert to 1.25ms units
-                    conn_req.latency = ctx->slave_latency;                  // 从设备延迟 / Slave latency
-                    conn_req.timeout = ctx->supervision_timeout / 10;       // 转换为10ms单位 / Convert to 10ms units
-                    memcpy(conn_req.channel_map, ctx->channel_map, 5);      // 信道图 / Channel map
-                    conn_req.hop = ctx->hop_increment;                      // 跳频增量 / Hop increment
-                    conn_req.sca = 0;                                       // 睡眠时钟精度±50ppm / Sleep Clock Accuracy ±50ppm
-                    
-                    /* 发送连接请求 / Send connection request */
-                    if (ll_send_connect_request(ctx, &conn_req) == BLE_STATUS_OK) {
-                        /* 计算第一个锚点 / Calculate first anchor point */
-                        ctx->anchor_point = ble_ll_get_timestamp_us() + 1250;  // 1.25ms后 / 1.25ms later
-                        ctx->event_counter = 0;
-                        ctx->conn_state = CONN_STATE_CONNECTION;
-                        
-                        /* 切换到第一个数据信道 / Switch to first data channel */
-                        ctx->current_channel = ble_ll_calculate_next_channel(ctx);
-                    }
-                }
-                
-                /* 继续扫描 / Continue scanning */
-                sx128x_set_rx(ctx->radio_context);  // 重新进入接收模式 / Re-enter receive mode
-            }
-            break;
-            
-        case CONN_STATE_CONNECTED:
-            /* 检查是否到了连接事件时间 */
-            if (ble_ll_get_timestamp_us() >= ctx->anchor_point) {
-                ll_handle_connection_event(ctx);
-            }
-            break;
-            
-        default:
-            break;
+    if (ctx->tx_count == 0) {
+        return;
     }
+    ctx->tx_head = (ctx->tx_head + 1) % BLE_LL_TX_QUEUE_SIZE;
+    ctx->tx_count--;
 }
 
 /**
- * @brief 计算下一个数据信道
+ * @brief 重置数据通道 / Reset the data channel
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 新连接从空队列、序列号0和默认负载上限开始
+ *          A new connection starts with empty queues, sequence numbers 0 and the default payload limit
  */
-uint8_t ble_ll_calculate_next_channel(ble_conn_context_t* ctx)
+static void ll_reset_data_channel(ble_conn_context_t* ctx)
 {
-    uint8_t unmapped_channel;
-    uint8_t remapping_index;
-    uint8_t channel;
-    
-    /* 计算未映射信道 */
-    unmapped_channel = (ctx->last_unmapped_channel + ctx->hop_increment) % 37;
-    ctx->last_unmapped_channel = unmapped_channel;
-    
-    /* 检查信道是否可用 */
-    if (ctx->channel_map[unmapped_channel >> 3] & (1 << (unmapped_channel & 0x07))) {
-        return unmapped_channel;
-    }
-    
-    /* 重映射 */
-    remapping_index = unmapped_channel % ctx->num_used_channels;
-    
-    /* 找到第N个可用信道 */
-    uint8_t count = 0;
-    for (channel = 0; channel < 37; channel++) {
-        if (ctx->channel_map[channel >> 3] & (1 << (channel & 0x07))) {
-            if (count == remapping_index) {
-                return channel;
-            }
-            count++;
-        }
-    }
-    
-    return 0;  // 不应该到达
+    ctx->tx_head = 0;
+    ctx->tx_count = 0;
+    ctx->tx_head_sent = false;
+    ctx->rx_head = 0;
+    ctx->rx_count = 0;
+    ctx->rx_sdu_length = 0;
+    ctx->tx_seq_num = 0;
+    ctx->next_expected_seq_num = 0;
+    ctx->more_data = false;
+    ctx->max_tx_octets = BLE_LL_MIN_DATA_OCTETS;
+    ctx->max_rx_octets = BLE_LL_MIN_DATA_OCTETS;
+    ctx->length_req_sent = false;
 }
 
 /**
- * @brief 生成接入地址
+ * @brief 发送LL_LENGTH_REQ或LL_LENGTH_RSP / Send LL_LENGTH_REQ or LL_LENGTH_RSP
+ * @param ctx 连接上下文 / Connection context
+ * @param opcode LL_LENGTH_REQ或LL_LENGTH_RSP / LL_LENGTH_REQ or LL_LENGTH_RSP
+ * @return 操作状态 / Operation status
  */
-uint32_t ble_ll_generate_access_address(void)
+static ble_status_t ll_send_length_pdu(ble_conn_context_t* ctx, uint8_t opcode)
 {
-    uint32_t aa;
+    uint16_t max_time = LL_PDU_TIME_US(BLE_LL_MAX_DATA_OCTETS);
+    uint8_t length_pdu[9] = {
+        opcode,
+        BLE_LL_MAX_DATA_OCTETS, 0x00,          // MaxRxOctets
+        max_time & 0xFF, (max_time >> 8),      // MaxRxTime
+        BLE_LL_MAX_DATA_OCTETS, 0x00,          // MaxTxOctets
+        max_time & 0xFF, (max_time >> 8)       // MaxTxTime
+    };
+    
+    return ll_tx_enqueue(ctx, 0x03, length_pdu, sizeof(length_pdu));
+}
+
+/**
+ * @brief 按对端的LL_LENGTH_REQ/RSP更新负载上限 / Update the payload limits from the peer LL_LENGTH_REQ/RSP
+ * @param ctx 连接上下文 / Connection context
+ * @param pdu 接收的控制PDU / Received control PDU
+ */
+static void ll_update_data_length(ble_conn_context_t* ctx, ble_data_pdu_t* pdu)
+{
+    if (pdu->length < 9) {
+        return;
+    }
+    
+    uint16_t peer_max_rx = pdu->payload[1] | (pdu->payload[2] << 8);
+    uint16_t peer_max_tx = pdu->payload[5] | (pdu->payload[6] << 8);
+    
+    /* 生效值取双方较小值，不低于27 / The effective value is the smaller of both sides, at least 27 */
+    if (peer_max_rx > BLE_LL_MAX_DATA_OCTETS) peer_max_rx = BLE_LL_MAX_DATA_OCTETS;
+    if (peer_max_tx > BLE_LL_MAX_DATA_OCTETS) peer_max_tx = BLE_LL_MAX_DATA_OCTETS;
+    ctx->max_tx_octets = (peer_max_rx < BLE_LL_MIN_DATA_OCTETS) ? BLE_LL_MIN_DATA_OCTETS : peer_max_rx;
+    ctx->max_rx_octets = (peer_max_tx < BLE_LL_MIN_DATA_OCTETS) ? BLE_LL_MIN_DATA_OCTETS : peer_max_tx;
+}
+
+/**
+ * @brief 向上层交付接收队列 / Deliver the receive queue to the upper layer
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 在连接事件之外重组L2CAP分片并调用on_data_received，不占用T_IFS时间
+ *          Reassembles L2CAP fragments and calls on_data_received outside the connection event, off the T_IFS
+ *          budget
+ */
+static void ll_rx_deliver(ble_conn_context_t* ctx)
+{
+    while (ctx->rx_count > 0) {
+        ble_data_pdu_t* pdu = &ctx->rx_queue[ctx->rx_head];
+        
+        if (pdu->llid == 0x02) {
+            /* L2CAP开始分片 / L2CAP start fragment */
+            ctx->rx_sdu_length = 0;
+        } else if (ctx->rx_sdu_length == 0) {
+            /* 丢弃没有开始分片的继续分片 / Drop a continuation without a start fragment */
+            pdu->length = 0;
+        }
+        if ((ctx->rx_sdu_length + pdu->length) > sizeof(ctx->rx_sdu)) {
+            ctx->rx_sdu_length = 0;  // SDU过长，丢弃 / SDU too long, drop
+        } else {
+            memcpy(&ctx->rx_sdu[ctx->rx_sdu_length], pdu->payload, pdu->length);
+            ctx->rx_sdu_length += pdu->length;
+        }
+        
+        ctx->rx_head = (ctx->rx_head + 1) % BLE_LL_RX_QUEUE_SIZE;
+        ctx->rx_count--;
+        
+        /* SDU完整时交付 / Deliver once the SDU is complete */
+        if (ctx->rx_sdu_length >= 4) {
+            uint16_t l2cap_len = ctx->rx_sdu[0] | (ctx->rx_sdu[1] << 8);
+            uint16_t l2cap_cid = ctx->rx_sdu[2] | (ctx->rx_sdu[3] << 8);
+            
+            if (ctx->rx_sdu_length >= (l2cap_len + 4)) {
+                ctx->rx_sdu_length = 0;
+                if ((l2cap_cid == L2CAP_CID_ATT) && ctx->on_data_received) {
+                    ctx->on_data_received(ctx, &ctx->rx_sdu[4], l2cap_len);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 启动无线电操作 / Start a radio operation
+ * @param ctx 连接上下文 / Connection context
+ * @param op 无线电操作 / Radio operation
+ * @param timeout_us 操作超时(微秒) / Operation timeout (microseconds)
+ *
+ * @details 在发出TX/RX命令之前调用，配置DIO1中断并清除待处理标志，完成由ble_ll_process_events分发
+ *          Called before the TX/RX command is issued, routes the interrupts to DIO1 and clears the pending flag,
+ *          completion is dispatched by ble_ll_process_events
+ */
+void ll_radio_start(ble_conn_context_t* ctx, ll_radio_op_t op, uint32_t timeout_us)
+{
+    sx128x_set_dio_irq_params(ctx->radio_context, LL_RADIO_IRQ_MASK, LL_RADIO_IRQ_MASK, 0, 0);
+    
+    ctx->radio_irq_pending = false;
+    ctx->radio_op = op;
+    ctx->radio_op_deadline = ble_ll_get_timestamp_us() + timeout_us;
+}
+
+/**
+ * @brief 读取并清除无线电中断 / Read and clear the radio interrupts
+ * @param ctx 连接上下文 / Connection context
+ * @return 中断状态，无DIO1中断时为0 / Interrupt status, 0 without a DIO1 interrupt
+ *
+ * @details 只在DIO1中断后访问SPI / Only accesses the SPI after a DIO1 interrupt
+ */
+uint16_t ll_radio_get_irq(ble_conn_context_t* ctx)
+{
+    if (!ctx->radio_irq_pending) {
+        return 0;
+    }
+    ctx->radio_irq_pending = false;
+    
+    uint16_t irq = sx128x_get_irq_status(ctx->radio_context);
+    sx128x_clear_irq_status(ctx->radio_context, irq);
+    return irq;
+}
+
+/**
+ * @brief 对齐的锚点 / Aligned anchor point
+ * @param ctx 连接上下文 / Connection context
+ * @param after_us 最早时刻 / Earliest time
+ * @return 不早于after_us、与调度时隙对齐的第一个时刻；未对齐时返回after_us / First time not before after_us aligned
+ *         to the scheduling slot; after_us when not aligned
+ */
+static uint64_t ll_sched_next_anchor(ble_conn_context_t* ctx, uint64_t after_us)
+{
+    if ((ctx->sched_epoch == 0) || (ctx->conn_interval == 0)) {
+        return after_us;
+    }
+    
+    uint64_t base_us = ctx->sched_epoch + ctx->sched_offset_us;
+    if (after_us <= base_us) {
+        return base_us;
+    }
+    return base_us + (((after_us - base_us) + ctx->conn_interval - 1) / ctx->conn_interval) * ctx->conn_interval;
+}
+
+/**
+ * @brief 开始连接事件的接收阶段 / Start the receive phase of a connection event
+ * @param ctx 连接上下文 / Connection context
+ * @param timeout_us 接收窗口(微秒) / Receive window (microseconds)
+ */
+static void ll_conn_event_start_rx(ble_conn_context_t* ctx, uint32_t timeout_us)
+{
+    /* 超时余量等待无线电超时中断 / Timeout margin to wait for the radio timeout interrupt */
+    ll_radio_start(ctx, LL_RADIO_OP_EVENT_RX, timeout_us + 500);
+    sx128x_set_rx_with_timeout(ctx->radio_context, (timeout_us + 999) / 1000);
+}
+
+/**
+ * @brief 发送连接事件中的下一个PDU / Transmit the next PDU of a connection event
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_conn_event_tx(ble_conn_context_t* ctx)
+{
+    ble_data_pdu_t empty_pdu;
+    ble_data_pdu_t* tx_pdu;
+    
+    /* 队首未确认前重复发送，队列空时发送空PDU / The queue head is resent until acknowledged, an empty PDU when
+     * the queue is empty */
+    if (ctx->tx_count > 0) {
+        tx_pdu = &ctx->tx_queue[ctx->tx_head];
+        ctx->tx_head_sent = true;
+    } else {
+        tx_pdu = &empty_pdu;
+        memset(tx_pdu, 0, 2);
+        tx_pdu->llid = 0x01;  // 空PDU / Empty PDU
+        ctx->tx_head_sent = false;
+    }
+    
+    tx_pdu->nesn = ctx->next_expected_seq_num;
+    tx_pdu->sn = ctx->tx_seq_num;
+    tx_pdu->md = (ctx->tx_count > 1) ? 1 : 0;  // 队首之后还有数据 / More data behind the queue head
+    
+    /* 发送，完成时产生DIO1中断 / Transmit, DIO1 interrupt on completion */
+    sx128x_set_buffer_base_address(ctx->radio_context, 0x00, 0x80);
+    sx128x_write_buffer(ctx->radio_context, 0x00, 
+                      (uint8_t*)tx_pdu, tx_pdu->length + 2);
+    ll_radio_start(ctx, LL_RADIO_OP_EVENT_TX, LL_EVENT_TX_TIMEOUT_US);
+    sx128x_set_tx(ctx->radio_context);
+}
+
+/**
+ * @brief 开始连接事件 / Start a connection event
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 调用方已等待到锚点；发送完成、T_IFS后的接收和事件结束由DIO1中断驱动
+ *          The caller has waited for the anchor point; TX done, the receive after T_IFS and the event end are
+ *          driven by DIO1 interrupts
+ */
+static void ll_conn_event_start(ble_conn_context_t* ctx)
+{
+    uint8_t channel;
+    uint32_t freq;
+    
+    /* 计算当前数据信道 */
+    channel = ble_ll_calculate_next_channel(ctx);
+    ctx->current_channel = channel;
+    freq = channel_freq_table[channel];
+    
+    /* 配置无线电，共享无线电的其他连接或扫描改变了接入地址 / Configure the radio, another connection or a scan
+     * sharing the radio changed the access address */
+    if (ctx->sched_event_us != 0) {
+        ll_radio_config_access(ctx, ctx->access_address, ctx->crc_init, SX128X_BLE_PAYLOAD_MAX_255_BYTES);
+    }
+    sx128x_set_rf_freq(ctx->radio_context, freq);
+    sx128x_set_gfsk_ble_whitening_seed(ctx->radio_context, channel | 0x40);
+    
+    /* 第一个事件协商数据长度 / Negotiate the data length in the first event */
+    if (!ctx->length_req_sent && (ll_send_length_pdu(ctx, LL_LENGTH_REQ) == BLE_STATUS_OK)) {
+        ctx->length_req_sent = true;
+    }
+    
+    /* 事件在下一个锚点的唤醒余量之前结束 / The event ends before the wake-up lead of the next anchor point */
+    ctx->event_packets = 0;
+    ctx->event_end = ctx->anchor_point + ctx->conn_interval - BLE_LL_WAKEUP_US;
+    if ((ctx->sched_event_us != 0) && (ctx->sched_event_us < ctx->conn_interval)) {
+        /* 在下一个连接的唤醒余量之前结束 / End before the wake-up lead of the next connection */
+        ctx->event_end = ctx->anchor_point + ctx->sched_event_us - BLE_LL_WAKEUP_US;
+    }
+#if defined( ADD_BLE_LL )
+    if (ctx->rp && (ctx->event_end > (ctx->anchor_point + BLE_LL_RP_CONN_EVENT_DURATION_MS * 1000))) {
+        ctx->event_end = ctx->anchor_point + BLE_LL_RP_CONN_EVENT_DURATION_MS * 1000;
+    }
+#endif
+    
+    if (ctx->role == BLE_ROLE_SLAVE) {
+        /* 从设备先接收，窗口两侧按展宽加长，首次同步前覆盖整个传输窗口 / The slave receives first, the window is
+         * lengthened by the widening on both sides and covers the whole transmit window until the first sync */
+        ll_conn_event_start_rx(ctx, LL_EVENT_RX_TIMEOUT_US + 2 * ctx->window_widening + ctx->transmit_window_us);
+        return;
+    }
+    
+    /* 主设备在每个事件中先发送 / The master transmits first in every event */
+    ll_conn_event_tx(ctx);
+}
+
+/**
+ * @brief 是否在本事件中继续交换 / Whether to continue exchanging in this event
+ * @param ctx 连接上下文 / Connection context
+ * @return true继续，false结束事件 / true to continue, false to close the event
+ *
+ * @details 任一方MD置位且剩余时间足够一次最长交换时继续
+ *          Continues while either side has MD set and the remaining time fits one longest exchange
+ */
+static bool ll_conn_event_continue(ble_conn_context_t* ctx)
+{
+    if (ctx->conn_state != CONN_STATE_CONNECTED) {
+        return false;
+    }
+    if (++ctx->event_packets >= ctx->max_packets_per_event) {
+        return false;
+    }
+    if ((ctx->tx_count == 0) && !ctx->more_data) {
+        return false;
+    }
+    
+    uint32_t exchange_us = 2 * BLE_T_IFS + LL_PDU_TIME_US(ctx->max_tx_octets) + LL_PDU_TIME_US(ctx->max_rx_octets);
+    return (ble_ll_get_timestamp_us() + exchange_us) < ctx->event_end;
+}
+
+/**
+ * @brief 处理连接事件中接收的控制PDU / Process a control PDU received in a connection event
+ * @param ctx 连接上下文 / Connection context
+ * @param rx_pdu 接收的PDU / Received PDU
+ * @return true已接受，false需要对端重发(发送队列满) / true if accepted, false to have the peer resend it (transmit
+ *         queue full)
+ */
+static bool ll_conn_event_control(ble_conn_context_t* ctx, ble_data_pdu_t* rx_pdu)
+{
+    switch (rx_pdu->payload[0]) {
+        case LL_TERMINATE_IND:
+            ctx->conn_state = CONN_STATE_IDLE;
+            if (ctx->on_disconnected) {
+                ctx->on_disconnected(ctx, rx_pdu->payload[1]);
+            }
+            break;
+            
+        case LL_FEATURE_REQ:
+            /* 回复feature response，声明支持数据长度扩展 / Reply with the feature response, advertising Data
+             * Length Extension */
+            {
+                uint8_t feature_rsp[9] = { LL_FEATURE_RSP, LL_FEATURE_DATA_LENGTH_EXT, 0, 0, 0, 0, 0, 0, 0 };
+                
+                return ll_tx_enqueue(ctx, 0x03, feature_rsp, sizeof(feature_rsp)) == BLE_STATUS_OK;
+            }
+            
+        case LL_LENGTH_REQ:
+            if (ll_send_length_pdu(ctx, LL_LENGTH_RSP) != BLE_STATUS_OK) {
+                return false;
+            }
+            ll_update_data_length(ctx, rx_pdu);
+            break;
+            
+        case LL_LENGTH_RSP:
+            ll_update_data_length(ctx, rx_pdu);
+            break;
+            
+        case LL_CHANNEL_MAP_IND:
+            /* 新信道图在生效时刻由ble_ll_calculate_next_channel切换 / The new channel map is switched by
+             * ble_ll_calculate_next_channel at the instant. 长度错误或少于2个信道的信道图被忽略 / A map of a wrong
+             * length or with less than 2 used channels is ignored */
+            if ((rx_pdu->length < 8) || (ll_count_used_channels(&rx_pdu->payload[1]) < 2)) {
+                break;
+            }
+            memcpy(ctx->pending_channel_map, &rx_pdu->payload[1], 5);
+            ctx->channel_map_instant = rx_pdu->payload[6] | (rx_pdu->payload[7] << 8);
+            ctx->channel_map_pending = true;
+            break;
+            
+        case LL_VERSION_IND:
+        default:
+            /* 忽略 / Ignore */
+            break;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 处理连接事件中接收的PDU / Process the PDU received in a connection event
+ * @param ctx 连接上下文 / Connection context
+ * @return 接收的PDU长度(含头部) / Received PDU length (header included)
+ *
+ * @details 数据PDU直接读入接收队列，在事件之外交付；接收队列满时不确认，对端下次重发
+ *          Data PDUs are read straight into the receive queue and delivered outside the event; while the receive
+ *          queue is full they are not acknowledged and the peer resends them
+ */
+static uint8_t ll_conn_event_rx(ble_conn_context_t* ctx)
+{
+    ble_data_pdu_t overflow_pdu;
+    bool rx_queue_full = ctx->rx_count >= BLE_LL_RX_QUEUE_SIZE;
+    ble_data_pdu_t* rx_pdu = rx_queue_full ? &overflow_pdu :
+                             &ctx->rx_queue[(ctx->rx_head + ctx->rx_count) % BLE_LL_RX_QUEUE_SIZE];
+    uint8_t rx_len;
+    
+    sx128x_get_rx_buffer_status(ctx->radio_context, &rx_len, NULL);
+    if (rx_len > sizeof(ble_data_pdu_t)) {
+        rx_len = sizeof(ble_data_pdu_t);
+    }
+    sx128x_read_buffer(ctx->radio_context, 0x80, (uint8_t*)rx_pdu, rx_len);
+    
+    ctx->consecutive_crc_errors = 0;
+    
+    /* 检查序列号 / Check sequence number */
+    if (rx_pdu->sn == ctx->next_expected_seq_num) {
+        /* 新数据 / New data */
+        bool accepted = true;
+        
+        if (rx_pdu->length > 0) {
+            if (rx_pdu->llid == 0x03) {  // LL控制PDU / LL Control PDU
+                accepted = ll_conn_event_control(ctx, rx_pdu);
+            } else if (rx_queue_full) {
+                accepted = false;
+            } else {
+                ctx->rx_count++;  // L2CAP分片入队 / Queue the L2CAP fragment
+            }
+        }
+        if (accepted) {
+            ctx->next_expected_seq_num ^= 1;
+        }
+    }
+    
+    /* 确认收到 / Acknowledge receipt */
+    if (rx_pdu->nesn != ctx->tx_seq_num) {
+        /* 对方确认了我们的数据 / Peer acknowledged our data */
+        ctx->tx_seq_num ^= 1;      // 翻转发送序列号 / Toggle transmit sequence number
+        if (ctx->tx_head_sent) {
+            ctx->tx_head_sent = false;
+            ll_tx_ack(ctx);        // 移除已确认的队首 / Remove the acknowledged queue head
+        }
+    }
+    
+    /* 检查MD位 / Check MD bit */
+    ctx->more_data = rx_pdu->md;  // 更新More Data标志 / Update More Data flag
+    
+    return rx_len;
+}
+
+/**
+ * @brief 结束连接事件 / End a connection event
+ * @param ctx 连接上下文 / Connection context
+ * @param rx_success 是否收到对端数据 / Whether a packet was received from the peer
+ */
+static void ll_conn_event_finish(ble_conn_context_t* ctx, bool rx_success)
+{
+    /* 收到LL_TERMINATE_IND时连接已关闭 / The connection is already closed on LL_TERMINATE_IND */
+    if (ctx->conn_state == CONN_STATE_CONNECTED) {
+        if (!rx_success) {
+            ctx->consecutive_crc_errors++;
+            ctx->total_crc_errors++;
+        } else {
+            /* 重新同步，窗口展宽从此锚点计算 / Resynchronized, window widening counts from this anchor point */
+            ctx->last_sync_anchor = ctx->anchor_point;
+            ctx->last_rx_timestamp = ble_ll_get_timestamp_us();
+            ctx->transmit_window_us = 0;
+        }
+        
+        /* 更新连接事件参数 / Update connection event parameters */
+        ctx->event_counter++;                      // 增加事件计数器 / Increment event counter
+        ctx->anchor_point += ctx->conn_interval;  // 计算下一个锚点 / Calculate next anchor point
+        
+        /* 检查连接超时：按监督超时，未设置时按连续错误次数 / Check connection timeout: supervision timeout, or
+         * consecutive errors when not set */
+        bool link_lost;
+        if (ctx->supervision_timeout != 0) {
+            link_lost = (ble_ll_get_timestamp_us() - ctx->last_rx_timestamp) >
+                        ((uint64_t)ctx->supervision_timeout * 1000);
+        } else {
+            link_lost = ctx->consecutive_crc_errors > 6;
+        }
+        if (link_lost) {
+            /* 连接丢失 / Connection lost */
+            ctx->conn_state = CONN_STATE_IDLE;
+            if (ctx->on_disconnected) {
+                ctx->on_disconnected(ctx, 0x08);  // 连接超时 / Connection Timeout
+            }
+        }
+    }
+    
+    /* 释放无线电或为下一个事件启动定时器 / Release the radio or arm the timer for the next event */
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        ll_rp_release(ctx, &ctx->rp_conn_event, RP_HOOK_ID_BLE_LL_CONN_EVENT);
+        return;
+    }
+#endif
+    if (ctx->conn_state == CONN_STATE_CONNECTED) {
+        ll_arm_event_timer(ctx);
+    }
+}
+
+/**
+ * @brief 在当前广播信道上发送广播PDU / Transmit the advertising PDU on the current advertising channel
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_adv_tx(ble_conn_context_t* ctx)
+{
+    sx128x_set_rf_freq(ctx->radio_context, ble_ll_get_frequency(ctx->adv_channel));
+    sx128x_set_gfsk_ble_whitening_seed(ctx->radio_context, ctx->adv_channel | 0x40);  // 信道白化种子 / Channel whitening seed
+    sx128x_set_buffer_base_address(ctx->radio_context, 0x00, 0x80);
+    sx128x_write_buffer(ctx->radio_context, 0x00, (uint8_t*)&ctx->adv_pdu, ctx->adv_pdu.header.length + 2);
+    ll_radio_start(ctx, LL_RADIO_OP_ADV_TX, LL_ADV_TX_TIMEOUT_US);
+    sx128x_set_tx(ctx->radio_context);
+}
+
+/**
+ * @brief 开始广播事件 / Start an advertising event
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_adv_event_start(ble_conn_context_t* ctx)
+{
+    ll_radio_config_adv(ctx);
+    ctx->adv_channel = 37;
+    ll_adv_tx(ctx);
+}
+
+/**
+ * @brief 结束广播事件 / Close an advertising event
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 下一个事件在广播间隔加0-10ms随机延迟(advDelay)之后，避免与其他广播者持续碰撞
+ *          The next event follows after the advertising interval plus a random 0-10 ms delay (advDelay), so that
+ *          collisions with another advertiser do not repeat
+ */
+static void ll_adv_event_close(ble_conn_context_t* ctx)
+{
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    
+    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+    ctx->adv_channel = 0;
+    ctx->adv_events++;
+    ctx->adv_event_start += ctx->adv_interval_us + (uint32_t)(ble_ll_get_random() % 11) * 1000;
+    if (ctx->adv_event_start < now_us) {
+        ctx->adv_event_start = now_us;
+    }
+    
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        ll_rp_release(ctx, &ctx->rp_adv, RP_HOOK_ID_BLE_LL_ADV);
+    }
+#endif
+}
+
+/**
+ * @brief 在下一个广播信道上继续或结束事件 / Continue on the next advertising channel or close the event
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_adv_next_channel(ble_conn_context_t* ctx)
+{
+    if (ctx->adv_channel < 39) {
+        ctx->adv_channel++;
+        ll_adv_tx(ctx);
+    } else {
+        ll_adv_event_close(ctx);
+    }
+}
+
+/**
+ * @brief 以从设备角色接受CONNECT_REQ / Accept a CONNECT_REQ in the slave role
+ * @param ctx 连接上下文 / Connection context
+ * @param req 收到的CONNECT_REQ / Received CONNECT_REQ
+ * @param end_us CONNECT_REQ接收结束时刻 / End of the CONNECT_REQ reception
+ * @return 参数有效并已连接时返回true / true when the parameters are valid and the connection is created
+ */
+static bool ll_adv_connect(ble_conn_context_t* ctx, const ll_connect_req_t* req, uint64_t end_us)
+{
+    if ((req->interval < 6) || (req->interval > 3200) || (req->hop < 5) || (req->hop > 16) || (req->win_size == 0) ||
+        (req->timeout == 0)) {
+        return false;  // 无效的连接参数 / Invalid connection parameters
+    }
+    
+    ll_set_channel_map(ctx, req->channel_map);
+    if (ctx->num_used_channels < 2) {
+        return false;
+    }
+    
+    /* 从设备使用主设备选择的连接参数 / The slave uses the connection parameters chosen by the master */
+    ctx->role = BLE_ROLE_SLAVE;
+    memcpy(ctx->peer_addr, req->init_addr, 6);
+    ctx->peer_addr_type = (req->header & 0x40) ? BLE_ADDR_TYPE_RANDOM : BLE_ADDR_TYPE_PUBLIC;  // TxAdd
+    ctx->access_address = req->access_address;
+    ctx->crc_init = req->crc_init;
+    ctx->conn_interval = (uint32_t)req->interval * 1250;
+    ctx->slave_latency = req->latency;
+    ctx->supervision_timeout = req->timeout * 10;
+    ctx->hop_increment = req->hop;
+    ctx->master_sca = req->sca;
+    ctx->csa2 = (req->header & BLE_PDU_CHSEL) != 0;  // ADV_IND已声明支持 / Support announced in ADV_IND
+    
+    /* 第一个锚点在CONNECT_REQ结束1.25ms加窗口偏移后的传输窗口内 / The first anchor point lies in the transmit window
+     * starting 1.25 ms plus the window offset after the end of CONNECT_REQ */
+    ctx->win_offset = req->win_offset;
+    ctx->anchor_point = end_us + 1250 + (uint32_t)req->win_offset * 1250;
+    ctx->transmit_window_us = (uint32_t)req->win_size * 1250;
+    ctx->last_sync_anchor = ctx->anchor_point;
+    ctx->last_rx_timestamp = end_us;
+    ctx->event_counter = 0;
+    ll_reset_data_channel(ctx);
+    ctx->last_unmapped_channel = 0;
+    ctx->channel_map_pending = false;
+    ctx->channel_id = (ctx->access_address >> 16) ^ (ctx->access_address & 0xFFFF);
+    
+    /* 切换到连接的接入地址和CRC初始值 / Switch to the access address and CRC init of the connection */
+    sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+    ll_radio_config_access(ctx, ctx->access_address, ctx->crc_init, SX128X_BLE_PAYLOAD_MAX_255_BYTES);
+    ctx->adv_channel = 0;
+    
+    ctx->conn_state = CONN_STATE_CONNECTED;
+    if (ctx->on_connected) {
+        ctx->on_connected(ctx);
+    }
+    return true;
+}
+
+/**
+ * @brief 处理广播后收到的请求 / Process a request received after an advertisement
+ * @param ctx 连接上下文 / Connection context
+ * @param end_us 接收结束时刻 / End of the reception
+ *
+ * @details SCAN_REQ在T_IFS后回复SCAN_RSP；可连接广播收到CONNECT_REQ时结束广播；其他包继续下一个信道
+ *          A SCAN_REQ is answered with SCAN_RSP after T_IFS; a CONNECT_REQ to a connectable advertisement ends
+ *          advertising; any other packet moves on to the next channel
+ */
+static void ll_adv_rx(ble_conn_context_t* ctx, uint64_t end_us)
+{
+    ll_connect_req_t req;  // 最长的请求，SCAN_REQ只有两个地址 / The longest request, SCAN_REQ only has both addresses
+    uint8_t rx_len;
+    
+    sx128x_get_rx_buffer_status(ctx->radio_context, &rx_len, NULL);
+    if (rx_len > sizeof(req)) {
+        rx_len = sizeof(req);
+    }
+    sx128x_read_buffer(ctx->radio_context, 0x80, (uint8_t*)&req, rx_len);
+    
+    /* 两种请求的第二个地址都是广播者地址 / The second address of both requests is the advertiser address */
+    uint8_t type = req.header & 0x0F;
+    bool to_us = (rx_len >= 14) && (memcmp(req.adv_addr, ctx->local_addr, 6) == 0);
+    
+    if (to_us && (type == BLE_PDU_SCAN_REQ) && (req.length == 12) &&
+        (ctx->adv_pdu.header.type != BLE_PDU_ADV_NONCONN_IND)) {
+        sx128x_write_buffer(ctx->radio_context, 0x00, (uint8_t*)&ctx->scan_rsp_pdu,
+                            ctx->scan_rsp_pdu.header.length + 2);
+        ble_ll_wait_until_us(end_us + BLE_T_IFS);
+        ll_radio_start(ctx, LL_RADIO_OP_ADV_RSP_TX, LL_ADV_TX_TIMEOUT_US);
+        sx128x_set_tx(ctx->radio_context);
+        ctx->adv_scan_reqs++;
+        return;
+    }
+    
+    if (to_us && (type == BLE_PDU_CONNECT_REQ) && (req.length == 34) && (rx_len == sizeof(req)) &&
+        (ctx->adv_pdu.header.type == BLE_PDU_ADV_IND) && ll_adv_connect(ctx, &req, end_us)) {
+        return;
+    }
+    
+    ll_adv_next_channel(ctx);
+}
+
+/**
+ * @brief 分发无线电操作完成 / Dispatch radio operation completions
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 无线电操作的状态机：DIO1中断或操作超时时读取一次中断状态并推进
+ *          Radio operation state machine: reads the interrupt status once on a DIO1 interrupt or an operation
+ *          timeout and moves on
+ */
+static void ll_radio_process(ble_conn_context_t* ctx)
+{
+    if (ctx->radio_op == LL_RADIO_OP_IDLE) {
+        return;
+    }
+    
+    bool timed_out = ble_ll_get_timestamp_us() >= ctx->radio_op_deadline;
+    if (!ctx->radio_irq_pending && !timed_out) {
+        return;
+    }
+    
+    uint64_t irq_timestamp = ctx->radio_irq_timestamp;
+    uint16_t irq = ll_radio_get_irq(ctx);
+    ll_radio_op_t op = ctx->radio_op;
+    
+    ctx->radio_op = LL_RADIO_OP_IDLE;
+    
+    switch (op) {
+        case LL_RADIO_OP_PDU_TX:
+            if ((irq & SX128X_IRQ_TX_DONE) && (ctx->conn_state == CONN_STATE_CONNECTION)) {
+                /* 第一个锚点在CONNECT_REQ发送结束1.25ms加窗口偏移后的2.5ms传输窗口内，优先取调度时隙 / The first
+                 * anchor point lies in the 2.5 ms transmit window starting 1.25 ms plus the window offset after the
+                 * end of CONNECT_REQ, the scheduling slot is preferred */
+                uint64_t window_start = irq_timestamp + 1250 + (uint32_t)ctx->win_offset * 1250;
+                uint64_t aligned = ll_sched_next_anchor(ctx, window_start);
+                ctx->anchor_point = ((aligned - window_start) <= 1250) ? aligned : window_start;
+                ctx->last_sync_anchor = ctx->anchor_point;
+                ctx->last_rx_timestamp = ctx->anchor_point;
+                
+                /* 切换到连接的接入地址和CRC初始值 / Switch to the access address and CRC init of the connection */
+                ll_radio_config_access(ctx, ctx->access_address, ctx->crc_init, SX128X_BLE_PAYLOAD_MAX_255_BYTES);
+                
+                /* 主设备发送CONNECT_REQ后连接即建立 / The connection is created once the master has sent CONNECT_REQ */
+                ctx->conn_state = CONN_STATE_CONNECTED;
+                if (ctx->on_connected) {
+                    ctx->on_connected(ctx);
+                }
+            }
+            break;
+            
+        case LL_RADIO_OP_EVENT_TX:
+            if (ctx->role == BLE_ROLE_SLAVE) {
+                /* 从设备的回复结束一次交换，主设备在T_IFS后继续 / The slave reply ends an exchange, the master goes
+                 * on after T_IFS */
+                if (ll_conn_event_continue(ctx)) {
+                    ll_conn_event_start_rx(ctx, LL_EVENT_RX_TIMEOUT_US);
+                } else {
+                    ll_conn_event_finish(ctx, true);
+                }
+                break;
+            }
+            /* T_IFS从发送结束计算 / T_IFS counted from the end of the transmission */
+            if (irq & SX128X_IRQ_TX_DONE) {
+                ble_ll_wait_until_us(irq_timestamp + BLE_T_IFS);
+            }
+            ll_conn_event_start_rx(ctx, LL_EVENT_RX_TIMEOUT_US);
+            break;
+            
+        case LL_RADIO_OP_EVENT_RX:
+            if ((irq & SX128X_IRQ_RX_DONE) && !(irq & SX128X_IRQ_CRC_ERROR)) {
+                uint8_t rx_len = ll_conn_event_rx(ctx);
+                if (ctx->role == BLE_ROLE_SLAVE) {
+                    if (ctx->event_packets == 0) {
+                        /* 主设备的第一个包定义锚点：接收结束减去空中时间，前导码、接入地址和CRC共8字节 / The first
+                         * packet of the master defines the anchor point: end of reception minus the airtime,
+                         * preamble, access address and CRC add 8 bytes */
+                        ctx->anchor_point = irq_timestamp - (uint32_t)(rx_len + 8) * 8;
+                    }
+                    if (ctx->conn_state == CONN_STATE_IDLE) {
+                        ll_conn_event_finish(ctx, true);  // 收到LL_TERMINATE_IND / LL_TERMINATE_IND received
+                    } else {
+                        ble_ll_wait_until_us(irq_timestamp + BLE_T_IFS);
+                        ll_conn_event_tx(ctx);
+                    }
+                    break;
+                }
+                if (ll_conn_event_continue(ctx)) {
+                    /* MD链接：T_IFS后发送下一个PDU / MD chaining: transmit the next PDU after T_IFS */
+                    ble_ll_wait_until_us(irq_timestamp + BLE_T_IFS);
+                    ll_conn_event_tx(ctx);
+                } else {
+                    ll_conn_event_finish(ctx, true);
+                }
+            } else {
+                /* 本事件中已有成功交换时仍算同步 / Still synchronized if an earlier exchange of this event succeeded */
+                ll_conn_event_finish(ctx, ctx->event_packets > 0);
+            }
+            break;
+            
+        case LL_RADIO_OP_ADV_TX:
+            /* 不可连接且不可扫描的广播之后不接收 / No reception after a non-connectable, non-scannable
+             * advertisement */
+            if ((irq & SX128X_IRQ_TX_DONE) && (ctx->adv_pdu.header.type != BLE_PDU_ADV_NONCONN_IND)) {
+                /* 超时余量覆盖窗口末尾开始的CONNECT_REQ / The timeout margin covers a CONNECT_REQ starting at the end
+                 * of the window */
+                ll_radio_start(ctx, LL_RADIO_OP_ADV_RX, LL_ADV_RX_TIMEOUT_US + LL_PDU_TIME_US(34) + 500);
+                sx128x_set_rx_with_timeout(ctx->radio_context, LL_ADV_RX_TIMEOUT_US / 1000);
+            } else {
+                ll_adv_next_channel(ctx);
+            }
+            break;
+            
+        case LL_RADIO_OP_ADV_RX:
+            if ((irq & SX128X_IRQ_RX_DONE) && !(irq & SX128X_IRQ_CRC_ERROR)) {
+                ll_adv_rx(ctx, irq_timestamp);
+            } else {
+                ll_adv_next_channel(ctx);
+            }
+            break;
+            
+        case LL_RADIO_OP_ADV_RSP_TX:
+            ll_adv_next_channel(ctx);
+            break;
+            
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 跳过一个连接事件 / Skip a connection event
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 保持跳频序列和事件计数器与对端同步
+ *          Keeps the hop sequence and event counter in step with the peer
+ */
+static void ll_skip_connection_event(ble_conn_context_t* ctx)
+{
+    ctx->current_channel = ble_ll_calculate_next_channel(ctx);  // 消耗本事件的信道 / Consume this event's channel
+    ctx->event_counter++;
+    ctx->anchor_point += ctx->conn_interval;
+}
+
+/**
+ * @brief 从设备无数据时按slave_latency跳过事件 / A slave with nothing to send skips slave_latency events
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_apply_slave_latency(ble_conn_context_t* ctx)
+{
+    if ((ctx->role == BLE_ROLE_SLAVE) && (ctx->tx_count == 0) && (ctx->event_counter > 0)) {
+        for (uint16_t i = 0; i < ctx->slave_latency; i++) {
+            ll_skip_connection_event(ctx);
+        }
+    }
+}
+
+/* 睡眠时钟精度(ppm)，按SCA字段索引 / Sleep clock accuracy (ppm), indexed by the SCA field */
+static const uint16_t sca_ppm_table[8] = {500, 250, 150, 100, 75, 50, 30, 20};
+
+/**
+ * @brief 计算窗口展宽 / Compute the window widening
+ * @param ctx 连接上下文 / Connection context
+ * @return 窗口展宽(微秒) / Window widening (microseconds)
+ *
+ * @details 从设备按主从睡眠时钟精度之和和距最后同步锚点的时间展宽接收窗口，主设备无需展宽
+ *          The slave widens its receive window by the sum of both sleep clock accuracies times the time since the
+ *          last synchronized anchor point, the master needs no widening
+ */
+static uint32_t ll_compute_window_widening(ble_conn_context_t* ctx)
+{
+    if (ctx->role != BLE_ROLE_SLAVE) {
+        return 0;
+    }
+    
+    uint64_t elapsed_us = ctx->anchor_point - ctx->last_sync_anchor;
+    uint32_t sca_ppm = sca_ppm_table[ctx->master_sca & 0x07] + BLE_LL_LOCAL_SCA_PPM;
+    
+    return (uint32_t)(((elapsed_us * sca_ppm) + 999999) / 1000000) + 16;  // 向上取整加16us / Rounded up plus 16us
+}
+
+/* 连接事件定时器回调只收到定时器句柄，LPTIM1按最早的唤醒点在各连接间共享 / The connection event timer callback
+ * only receives the timer handle, LPTIM1 is shared by the connections on the earliest wake-up point */
+static ble_conn_context_t* g_timer_ctx[BLE_LL_MAX_CONNECTIONS];
+
+/**
+ * @brief 启动LPTIM1单次比较 / Start an LPTIM1 one-shot compare
+ * @param delay_us 延时(微秒) / Delay (microseconds)
+ *
+ * @note 超出16位计数范围时分段定时，在ble_ll_connection_event_trigger中重新装载
+ *       Beyond the 16-bit counter range the delay is split, reloaded in ble_ll_connection_event_trigger
+ */
+static void ll_start_event_timer(uint64_t delay_us)
+{
+    uint64_t ticks = (delay_us * BLE_LL_LPTIM_FREQ_HZ) / 1000000;
+    
+    if (ticks > 0xFFFE) {
+        ticks = 0xFFFE;
+    } else if (ticks < 2) {
+        ticks = 2;
+    }
+    
+    HAL_LPTIM_SetOnce_Stop_IT(&hlptim1);
+    HAL_LPTIM_SetOnce_Start_IT(&hlptim1, 0xFFFF, (uint32_t)ticks);
+}
+
+/**
+ * @brief 连接事件唤醒时刻 / Connection event wake-up time
+ * @param ctx 连接上下文 / Connection context
+ * @return 唤醒时刻(微秒) / Wake-up time (microseconds)
+ */
+static uint64_t ll_event_wakeup_us(ble_conn_context_t* ctx)
+{
+    return ctx->anchor_point - BLE_LL_WAKEUP_US - ctx->window_widening;
+}
+
+/**
+ * @brief 按最早的待唤醒连接重新装载LPTIM1 / Reload LPTIM1 for the earliest connection waiting for its wake-up
+ *
+ * @details 主循环和LPTIM1中断都会调用；被中断打断时最多多一次提前唤醒
+ *          Called from both the main loop and the LPTIM1 interrupt; being interrupted costs at most one early
+ *          wake-up
+ */
+static void ll_timer_reload(void)
+{
+    uint64_t earliest_us = UINT64_MAX;
+    
+    for (uint8_t i = 0; i < BLE_LL_MAX_CONNECTIONS; i++) {
+        ble_conn_context_t* ctx = g_timer_ctx[i];
+        if (ctx && ctx->event_timer_armed && !ctx->conn_event_due && (ll_event_wakeup_us(ctx) < earliest_us)) {
+            earliest_us = ll_event_wakeup_us(ctx);
+        }
+    }
+    
+    if (earliest_us == UINT64_MAX) {
+        HAL_LPTIM_SetOnce_Stop_IT(&hlptim1);
+        return;
+    }
+    
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    ll_start_event_timer((earliest_us > now_us) ? (earliest_us - now_us) : 0);
+}
+
+/**
+ * @brief 登记使用LPTIM1的连接 / Register a connection using LPTIM1
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_timer_register(ble_conn_context_t* ctx)
+{
+    int8_t free_slot = -1;
+    
+    for (uint8_t i = 0; i < BLE_LL_MAX_CONNECTIONS; i++) {
+        if (g_timer_ctx[i] == ctx) {
+            return;
+        }
+        if ((g_timer_ctx[i] == NULL) && (free_slot < 0)) {
+            free_slot = i;
+        }
+    }
+    if (free_slot >= 0) {
+        g_timer_ctx[free_slot] = ctx;
+    }
+}
+
+/**
+ * @brief 注销连接 / Unregister a connection
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_timer_unregister(ble_conn_context_t* ctx)
+{
+    for (uint8_t i = 0; i < BLE_LL_MAX_CONNECTIONS; i++) {
+        if (g_timer_ctx[i] == ctx) {
+            g_timer_ctx[i] = NULL;
+        }
+    }
+    ctx->event_timer_armed = false;
+    ctx->conn_event_due = false;
+    ll_timer_reload();
+}
+
+/**
+ * @brief 为下一个连接事件启动定时器 / Arm the timer for the next connection event
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 定时器在锚点前BLE_LL_WAKEUP_US加窗口展宽处唤醒，期间MCU可以睡眠
+ *          The timer wakes up BLE_LL_WAKEUP_US plus the window widening before the anchor point, the MCU can
+ *          sleep until then
+ */
+static void ll_arm_event_timer(ble_conn_context_t* ctx)
+{
+    ll_apply_slave_latency(ctx);
+    ctx->window_widening = ll_compute_window_widening(ctx);
+    ctx->event_timer_armed = true;
+    ll_timer_register(ctx);
+    
+    if (ll_event_wakeup_us(ctx) <= ble_ll_get_timestamp_us()) {
+        ctx->conn_event_due = true;
+        return;
+    }
+    ll_timer_reload();
+}
+
+/**
+ * @brief 停止连接事件定时器 / Stop the connection event timer
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_disarm_event_timer(ble_conn_context_t* ctx)
+{
+    ctx->event_timer_armed = false;
+    ctx->conn_event_due = false;
+    ll_timer_reload();
+}
+
+/**
+ * @brief 广播数据摘要(FNV-1a) / Advertising data digest (FNV-1a)
+ * @param hash 初始值 / Initial value
+ * @param data 数据 / Data
+ * @param len 数据长度 / Data length
+ * @return 摘要 / Digest
+ */
+static uint32_t ll_scan_digest(uint32_t hash, const uint8_t* data, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 查询并更新重复报告缓存 / Look up and update the duplicate report cache
+ * @param ctx 连接上下文 / Connection context
+ * @param adv 广播PDU / Advertising PDU
+ * @return 已报告过相同内容时返回true / true when the same content was already reported
+ *
+ * @details 按地址哈希直接映射，条目保存最近一次报告的数据摘要；广播数据变化或条目被其他地址替换后会再次报告
+ *          Direct-mapped on the address hash, an entry keeps the digest of the last reported data; a report is
+ *          passed again once the advertising data changes or the entry was taken by another address
+ */
+static bool ll_scan_is_duplicate(ble_conn_context_t* ctx, const ble_adv_pdu_t* adv)
+{
+    uint8_t type = adv->header.type;
+    uint32_t addr_hash = ll_scan_digest(2166136261u, adv->payload, 6);
+    uint32_t digest = ll_scan_digest(addr_hash ^ type, &adv->payload[6], adv->header.length - 6);
+    ll_scan_dedup_entry_t* entry = &ctx->scan_dedup[addr_hash & (BLE_LL_SCAN_DEDUP_SIZE - 1)];
+    
+    if ((entry->addr_type == adv->header.tx_add) && (entry->digest == digest) &&
+        (memcmp(entry->addr, adv->payload, 6) == 0)) {
+        return true;
+    }
+    
+    memcpy(entry->addr, adv->payload, 6);
+    entry->addr_type = adv->header.tx_add;
+    entry->digest = digest;
+    return false;
+}
+
+/**
+ * @brief 发送CONNECT_REQ / Send CONNECT_REQ
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_scan_connect(ble_conn_context_t* ctx)
+{
+    ll_connect_req_t conn_req;
+    
+    /* 构建连接请求 / Build connection request */
+    conn_req.header = BLE_PDU_CONNECT_REQ | (ctx->csa2 ? BLE_PDU_CHSEL : 0);  // 双方支持时用CSA#2 / CSA#2 when both
+                                                                              // sides support it
+    conn_req.length = 34;                                     // 固定长度 / Fixed length
+    memcpy(conn_req.init_addr, ctx->local_addr, 6);         // 发起方地址 / Initiator address
+    memcpy(conn_req.adv_addr, ctx->peer_addr, 6);           // 广播方地址 / Advertiser address
+    conn_req.access_address = ctx->access_address;          // 连接接入地址 / Connection access address
+    conn_req.crc_init = ctx->crc_init & 0xFFFFFF;          // CRC初始值 / CRC init value
+    conn_req.win_size = 2;                                   // 2.5ms窗口 / 2.5ms window
+    conn_req.win_offset = 0;                                 // 窗口偏移 / Window offset
+    if (ctx->sched_epoch != 0) {
+        /* 第一个锚点落在本连接的调度时隙 / Place the first anchor point in the scheduling slot of this connection */
+        uint64_t window_start = ble_ll_get_timestamp_us() + LL_PDU_TIME_US(34) + 1250;
+        conn_req.win_offset = (ll_sched_next_anchor(ctx, window_start) - window_start) / 1250;
+    }
+    ctx->win_offset = conn_req.win_offset;
+    conn_req.interval = ctx->conn_interval / 1250;          // 转换为1.25ms单位 / Convert to 1.25ms units
+    conn_req.latency = ctx->slave_latency;                  // 从设备延迟 / Slave latency
+    conn_req.timeout = ctx->supervision_timeout / 10;       // 转换为10ms单位 / Convert to 10ms units
+    memcpy(conn_req.channel_map, ctx->channel_map, 5);      // 信道图 / Channel map
+    conn_req.hop = ctx->hop_increment;                      // 跳频增量 / Hop increment
+    conn_req.sca = 0;                                       // 睡眠时钟精度±50ppm / Sleep Clock Accuracy ±50ppm
+    
+    /* 发送连接请求 / Send connection request */
+    if (ll_send_connect_request(ctx, &conn_req) == BLE_STATUS_OK) {
+        /* 计算第一个锚点 / Calculate first anchor point */
+        ctx->anchor_point = ble_ll_get_timestamp_us() + 1250;  // 1.25ms后 / 1.25ms later
+        ctx->last_sync_anchor = ctx->anchor_point;
+        ctx->last_rx_timestamp = ctx->anchor_point;
+        ctx->master_sca = conn_req.sca;
+        ctx->event_counter = 0;
+        ll_reset_data_channel(ctx);
+        ctx->conn_state = CONN_STATE_CONNECTION;
+        
+        /* 第一个连接事件从lastUnmappedChannel 0开始 / The first connection event starts from lastUnmappedChannel 0 */
+        ctx->last_unmapped_channel = 0;
+        ctx->channel_map_pending = false;
+        ctx->channel_id = (ctx->access_address >> 16) ^ (ctx->access_address & 0xFFFF);
+    }
+}
+
+/**
+ * @brief 处理扫描收到的广播包 / Process an advertising packet received while scanning
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 发起连接时对目标的可连接广播回复CONNECT_REQ；扫描时重复报告在回调前被缓存过滤
+ *          While initiating, a connectable advertisement from the target is answered with CONNECT_REQ; while
+ *          scanning, duplicate reports are filtered by the cache before the callback
+ */
+static void ll_scan_rx(ble_conn_context_t* ctx)
+{
+    ble_adv_pdu_t adv;
+    uint8_t rx_len;
+    
+    /* 广播信道负载最多37字节 / Advertising channel payloads are at most 37 bytes */
+    sx128x_get_rx_buffer_status(ctx->radio_context, &rx_len, NULL);
+    if (rx_len > sizeof(adv)) {
+        rx_len = sizeof(adv);
+    }
+    sx128x_read_buffer(ctx->radio_context, 0x80, (uint8_t*)&adv, rx_len);
+    
+    if ((rx_len < sizeof(ble_pdu_header_t) + 6) || (adv.header.length < 6) ||
+        (adv.header.length > rx_len - sizeof(ble_pdu_header_t))) {
+        return;  // 不含广播者地址 / No advertiser address
+    }
+    
+    if (ctx->conn_state == CONN_STATE_INITIATING) {
+        if (((adv.header.type == BLE_PDU_ADV_IND) || (adv.header.type == BLE_PDU_ADV_DIRECT_IND)) &&
+            (memcmp(&adv.payload[0], ctx->peer_addr, 6) == 0)) {
+            ctx->csa2 = (((uint8_t*)&adv)[0] & BLE_PDU_CHSEL) != 0;
+            ll_scan_connect(ctx);
+        }
+        return;
+    }
+    
+    if ((adv.header.type != BLE_PDU_ADV_IND) && (adv.header.type != BLE_PDU_ADV_NONCONN_IND) &&
+        (adv.header.type != BLE_PDU_ADV_SCAN_IND) && (adv.header.type != BLE_PDU_ADV_DIRECT_IND)) {
+        return;  // 被动扫描不处理请求和响应 / Passive scanning ignores requests and responses
+    }
+    
+    if (ctx->scan_filter_duplicates && ll_scan_is_duplicate(ctx, &adv)) {
+        ctx->scan_duplicates++;
+        return;
+    }
+    
+    if (ctx->scan_filter) {
+        sx128x_pkt_status_ble_t pkt_status;
+        sx128x_get_ble_pkt_status(ctx->radio_context, &pkt_status);
+        ctx->last_rssi = pkt_status.rssi_sync;
+        
+        ctx->scan_reports++;
+        ctx->scan_filter(&adv.payload[0], ctx->last_rssi, &adv.payload[6], adv.header.length - 6);
+    }
+}
+
+/**
+ * @brief 结束扫描窗口并切换到下一个广播信道 / End the scan window and move to the next advertising channel
+ * @param ctx 连接上下文 / Connection context
+ * @param now_us 当前时间 / Current time
+ */
+static void ll_scan_window_close(ble_conn_context_t* ctx, uint64_t now_us)
+{
+    ctx->scan_channel = (ctx->scan_channel >= 39) ? 37 : ctx->scan_channel + 1;
+    ctx->scan_window_start += ctx->scan_interval_us;
+    if (ctx->scan_window_start < now_us) {
+        ctx->scan_window_start = now_us;
+    }
+    ctx->scan_window_end = 0;
+}
+
+#if defined( ADD_BLE_LL )
+
+/**
+ * @brief 连接事件任务启动回调 / Connection event task launch callback
+ * @param rp 无线电规划器 / Radio planner
+ */
+static void ll_rp_conn_event_launch(void* rp)
+{
+    if (g_rp_ctx && (g_rp_ctx->rp_conn_event == LL_RP_TASK_QUEUED)) {
+        g_rp_ctx->rp_conn_event = LL_RP_TASK_GRANTED;  // 在ble_ll_process_events中执行 / Run in ble_ll_process_events
+    }
+}
+
+/**
+ * @brief 扫描窗口任务启动回调 / Scan window task launch callback
+ * @param rp 无线电规划器 / Radio planner
+ */
+static void ll_rp_scan_launch(void* rp)
+{
+    if (g_rp_ctx && (g_rp_ctx->rp_scan == LL_RP_TASK_QUEUED)) {
+        g_rp_ctx->rp_scan = LL_RP_TASK_GRANTED;
+    }
+}
+
+/**
+ * @brief 广播事件任务启动回调 / Advertising event task launch callback
+ * @param rp 无线电规划器 / Radio planner
+ */
+static void ll_rp_adv_launch(void* rp)
+{
+    if (g_rp_ctx && (g_rp_ctx->rp_adv == LL_RP_TASK_QUEUED)) {
+        g_rp_ctx->rp_adv = LL_RP_TASK_GRANTED;
+    }
+}
+
+/**
+ * @brief 连接事件任务结束回调 / Connection event task end callback
+ * @param context 连接上下文 / Connection context
+ *
+ * @details 任务仍处于入队或已分配状态说明被规划器中止，该连接事件丢失
+ *          A task still queued or granted was aborted by the planner, its connection event is lost
+ */
+static void ll_rp_conn_event_callback(void* context)
+{
+    ble_conn_context_t* ctx = (ble_conn_context_t*)context;
+    
+    if ((ctx->rp_conn_event == LL_RP_TASK_QUEUED) || (ctx->rp_conn_event == LL_RP_TASK_GRANTED)) {
+        ll_skip_connection_event(ctx);
+        ctx->missed_conn_events++;
+    }
+    ctx->rp_conn_event = LL_RP_TASK_IDLE;
+}
+
+/**
+ * @brief 扫描窗口任务结束回调 / Scan window task end callback
+ * @param context 连接上下文 / Connection context
+ */
+static void ll_rp_scan_callback(void* context)
+{
+    ble_conn_context_t* ctx = (ble_conn_context_t*)context;
+    
+    if ((ctx->rp_scan == LL_RP_TASK_QUEUED) || (ctx->rp_scan == LL_RP_TASK_GRANTED)) {
+        /* 窗口被中止，下一个扫描间隔重试 / Window aborted, retry at the next scan interval */
+        ctx->scan_window_start += ctx->scan_interval_us;
+    }
+    ctx->rp_scan = LL_RP_TASK_IDLE;
+}
+
+/**
+ * @brief 广播事件任务结束回调 / Advertising event task end callback
+ * @param context 连接上下文 / Connection context
+ */
+static void ll_rp_adv_callback(void* context)
+{
+    ble_conn_context_t* ctx = (ble_conn_context_t*)context;
+    
+    if ((ctx->rp_adv == LL_RP_TASK_QUEUED) || (ctx->rp_adv == LL_RP_TASK_GRANTED)) {
+        /* 事件被中止，无线电已交给LoRa任务，下一个广播间隔重试 / Event aborted, the radio now belongs to a LoRa
+         * task, retry at the next advertising interval */
+        if (ctx->adv_channel != 0) {
+            ctx->adv_channel = 0;
+            ctx->radio_op = LL_RADIO_OP_IDLE;
+        }
+        ctx->adv_event_start += ctx->adv_interval_us;
+    }
+    ctx->rp_adv = LL_RP_TASK_IDLE;
+}
+
+/**
+ * @brief 释放规划器任务 / Release a planner task
+ * @param ctx 连接上下文 / Connection context
+ * @param state 任务状态 / Task state
+ * @param hook_id 规划器钩子ID / Planner hook ID
+ */
+static void ll_rp_release(ble_conn_context_t* ctx, volatile ll_rp_task_state_t* state, uint8_t hook_id)
+{
+    if ((*state == LL_RP_TASK_QUEUED) || (*state == LL_RP_TASK_GRANTED)) {
+        *state = LL_RP_TASK_RELEASING;
+        rp_task_abort(ctx->rp, hook_id);
+    }
+}
+
+/**
+ * @brief 将下一个连接事件作为定时任务入队 / Enqueue the next connection event as a scheduled task
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 任务的开始时间为锚点，LoRa任务可以使用连接间隔之间的空隙
+ *          The task starts at the anchor point, LoRa tasks can use the gaps between connection intervals
+ */
+static void ll_rp_enqueue_connection_event(ble_conn_context_t* ctx)
+{
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    
+    ll_apply_slave_latency(ctx);
+    
+    /* 跳过来不及调度的连接事件 / Skip connection events too close to be scheduled */
+    while (ctx->anchor_point < (now_us + BLE_LL_RP_SCHEDULE_MARGIN_US)) {
+        ll_skip_connection_event(ctx);
+        ctx->missed_conn_events++;
+    }
+    ctx->window_widening = ll_compute_window_widening(ctx);
+    
+    /* 接收窗口起点从TIM2时基转换到规划器时基，向下取整保证提前启动 / Receive window start converted from the TIM2
+     * timebase to the planner one, rounded down to launch early */
+    rp_task_t task = {
+        .hook_id = RP_HOOK_ID_BLE_LL_CONN_EVENT,
+        .type = RP_TASK_TYPE_USER,
+        .state = RP_TASK_STATE_SCHEDULE,
+        .launch_task_callbacks = ll_rp_conn_event_launch,
+        .start_time_ms = smtc_modem_hal_get_time_in_ms() +
+                         (uint32_t)((ctx->anchor_point - ctx->window_widening - now_us) / 1000),
+        .duration_time_ms = BLE_LL_RP_CONN_EVENT_DURATION_MS
+    };
+    
+    ctx->rp_conn_event = LL_RP_TASK_QUEUED;
+    if (rp_task_enqueue(ctx->rp, &task, NULL, 0, &g_rp_radio_params) != RP_HOOK_STATUS_OK) {
+        ctx->rp_conn_event = LL_RP_TASK_IDLE;
+    }
+}
+
+/**
+ * @brief 处理规划器分配的连接事件 / Process the connection event granted by the planner
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_rp_process_connection_event(ble_conn_context_t* ctx)
+{
+    if ((ctx->rp_conn_event == LL_RP_TASK_GRANTED) && (ctx->radio_op == LL_RADIO_OP_IDLE)) {
+        /* 规划器提前启动任务，等待锚点(从设备提前窗口展宽)；事件结束时释放 / The planner launches the task early,
+         * wait for the anchor point (earlier by the window widening on a slave); released when the event ends */
+        ble_ll_wait_until_us(ctx->anchor_point - ctx->window_widening);
+        ll_conn_event_start(ctx);
+    }
+    
+    /* 释放后由结束回调置为空闲，再入队下一个事件 / The end callback sets the task idle after the release, then the
+     * next event is enqueued */
+    if ((ctx->rp_conn_event == LL_RP_TASK_IDLE) && (ctx->conn_state == CONN_STATE_CONNECTED)) {
+        ll_rp_enqueue_connection_event(ctx);
+    }
+}
+
+/**
+ * @brief 将下一个广播事件作为定时任务入队 / Enqueue the next advertising event as a scheduled task
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 广播事件可以推迟，来不及调度时顺延；与LoRa任务冲突时由规划器中止，在下一个间隔重试
+ *          Advertising events may be delayed, one too close to be scheduled is postponed; on a conflict with a LoRa
+ *          task the planner aborts it and it is retried at the next interval
+ */
+static void ll_rp_enqueue_adv_event(ble_conn_context_t* ctx)
+{
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    
+    if (ctx->adv_event_start < (now_us + BLE_LL_RP_SCHEDULE_MARGIN_US)) {
+        ctx->adv_event_start = now_us + BLE_LL_RP_SCHEDULE_MARGIN_US;
+    }
+    
+    rp_task_t task = {
+        .hook_id = RP_HOOK_ID_BLE_LL_ADV,
+        .type = RP_TASK_TYPE_USER,
+        .state = RP_TASK_STATE_SCHEDULE,
+        .launch_task_callbacks = ll_rp_adv_launch,
+        .start_time_ms = smtc_modem_hal_get_time_in_ms() + (uint32_t)((ctx->adv_event_start - now_us) / 1000),
+        .duration_time_ms = BLE_LL_RP_ADV_EVENT_DURATION_MS
+    };
+    
+    ctx->rp_adv = LL_RP_TASK_QUEUED;
+    if (rp_task_enqueue(ctx->rp, &task, NULL, 0, &g_rp_radio_params) != RP_HOOK_STATUS_OK) {
+        ctx->rp_adv = LL_RP_TASK_IDLE;
+        ctx->adv_event_start += ctx->adv_interval_us;
+    }
+}
+
+/**
+ * @brief 处理规划器分配的广播事件 / Process the advertising event granted by the planner
+ * @param ctx 连接上下文 / Connection context
+ */
+static void ll_rp_process_adv_event(ble_conn_context_t* ctx)
+{
+    if ((ctx->rp_adv == LL_RP_TASK_GRANTED) && (ctx->adv_channel == 0)) {
+        /* 等待事件时刻，三个信道发送完后释放 / Wait for the event time, released once the three channels are done */
+        ble_ll_wait_until_us(ctx->adv_event_start);
+        ll_adv_event_start(ctx);
+    }
+    
+    if (ctx->rp_adv == LL_RP_TASK_IDLE) {
+        ll_rp_enqueue_adv_event(ctx);
+    }
+}
+
+/**
+ * @brief 处理规划器分配的扫描窗口 / Process the scan window granted by the planner
+ * @param ctx 连接上下文 / Connection context
+ * @return 无线电处于扫描接收时返回true / true when the radio is scanning
+ */
+static bool ll_rp_process_scan_window(ble_conn_context_t* ctx)
+{
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    
+    if ((ctx->rp_scan == LL_RP_TASK_IDLE) && (now_us >= ctx->scan_window_start)) {
+        rp_task_t task = {
+            .hook_id = RP_HOOK_ID_BLE_LL_SCAN,
+            .type = RP_TASK_TYPE_USER,
+            .state = RP_TASK_STATE_ASAP,
+            .launch_task_callbacks = ll_rp_scan_launch,
+            .start_time_ms = smtc_modem_hal_get_time_in_ms(),
+            .duration_time_ms = (ctx->scan_window_us + 999) / 1000
+        };
+        
+        ctx->rp_scan = LL_RP_TASK_QUEUED;
+        ctx->scan_window_end = 0;
+        if (rp_task_enqueue(ctx->rp, &task, NULL, 0, &g_rp_radio_params) != RP_HOOK_STATUS_OK) {
+            ctx->rp_scan = LL_RP_TASK_IDLE;
+            ctx->scan_window_start += ctx->scan_interval_us;
+        }
+        return false;
+    }
+    
+    if (ctx->rp_scan != LL_RP_TASK_GRANTED) {
+        return false;
+    }
+    
+    if (ctx->scan_window_end == 0) {
+        /* 窗口开始 / Window start */
+        ctx->scan_window_end = now_us + ctx->scan_window_us;
+        ll_start_scan_rx(ctx);
+    } else if ((now_us >= ctx->scan_window_end) && (ctx->radio_op == LL_RADIO_OP_IDLE)) {
+        /* 窗口结束，释放无线电给LoRa任务 / Window end, release the radio to LoRa tasks */
+        sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+        ll_scan_window_close(ctx, now_us);
+        ll_rp_release(ctx, &ctx->rp_scan, RP_HOOK_ID_BLE_LL_SCAN);
+        return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 挂接LBM无线电规划器 / Attach the LBM radio planner
+ * @param ctx 连接上下文 / Connection context
+ * @param rp 与LoRa 2.4GHz协议栈共享的无线电规划器 / Radio planner shared with the LoRa 2.4 GHz stack
+ * @return 操作状态 / Operation status
+ *
+ * @details 挂接后SX1280只在规划器分配的连接事件、扫描窗口和广播事件内由BLE链路层驱动，LoRa任务填充其间的空隙
+ *          Once attached, the BLE link layer only drives the SX1280 within the connection events, scan windows and
+ *          advertising events granted by the planner, LoRa tasks fill the gaps in between
+ */
+ble_status_t ble_ll_attach_radio_planner(ble_conn_context_t* ctx, radio_planner_t* rp)
+{
+    if (!ctx || !rp) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->conn_state != CONN_STATE_IDLE) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    if ((rp_hook_init(rp, RP_HOOK_ID_BLE_LL_CONN_EVENT, ll_rp_conn_event_callback, ctx) != RP_HOOK_STATUS_OK) ||
+        (rp_hook_init(rp, RP_HOOK_ID_BLE_LL_SCAN, ll_rp_scan_callback, ctx) != RP_HOOK_STATUS_OK) ||
+        (rp_hook_init(rp, RP_HOOK_ID_BLE_LL_ADV, ll_rp_adv_callback, ctx) != RP_HOOK_STATUS_OK)) {
+        return BLE_STATUS_ERROR;
+    }
+    
+    ctx->rp = rp;
+    ctx->rp_conn_event = LL_RP_TASK_IDLE;
+    ctx->rp_scan = LL_RP_TASK_IDLE;
+    ctx->rp_adv = LL_RP_TASK_IDLE;
+    g_rp_ctx = ctx;
+    
+    return BLE_STATUS_OK;
+}
+#endif
+
+/**
+ * @brief 按间隔开启和结束扫描窗口 / Open and close the scan windows on every interval
+ * @param ctx 连接上下文 / Connection context
+ * @return 无线电处于扫描接收时返回true / true when the radio is scanning
+ *
+ * @details 窗口等于间隔时连续扫描，只在窗口边界切换信道；窗口之间无线电保持待机
+ *          With a window equal to the interval scanning is continuous and only switches channel at the window
+ *          boundary; the radio stays in standby between windows
+ */
+static bool ll_process_scan_window(ble_conn_context_t* ctx)
+{
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        return ll_rp_process_scan_window(ctx);
+    }
+#endif
+    
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    
+    /* CONNECT_REQ发送中不切换信道 / No channel switch while CONNECT_REQ is being sent */
+    if (ctx->radio_op != LL_RADIO_OP_IDLE) {
+        return false;
+    }
+    
+    if (ctx->scan_window_end == 0) {
+        if (now_us < ctx->scan_window_start) {
+            return false;
+        }
+        ctx->scan_window_end = now_us + ctx->scan_window_us;
+        ll_start_scan_rx(ctx);
+    } else if (now_us >= ctx->scan_window_end) {
+        bool continuous = ctx->scan_window_us >= ctx->scan_interval_us;
+        
+        ll_scan_window_close(ctx, now_us);
+        if (!continuous) {
+            sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);
+            return false;
+        }
+        ctx->scan_window_end = now_us + ctx->scan_window_us;
+        ll_start_scan_rx(ctx);
+    }
+    
+    return true;
+}
+
+/**
+ * @brief 处理事件（主循环调用） / Process events (called from main loop)
+ * @param ctx 连接上下文 / Connection context
+ * 
+ * @details 该函数需要在主循环中不断调用，用于处理各种连接状态下的事件
+ *          This function needs to be called continuously in main loop to process events in various connection states
+ */
+void ble_ll_process_events(ble_conn_context_t* ctx)
+{
+    if (!ctx) return;
+    
+    /* 分发DIO1中断完成的无线电操作 / Dispatch the radio operations completed by DIO1 interrupts */
+    ll_radio_process(ctx);
+    
+    /* 交付接收的数据 / Deliver the received data */
+    ll_rx_deliver(ctx);
+    
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        /* 离开扫描状态且CONNECT_REQ已发送时释放扫描窗口 / Release the scan window when leaving the scanning
+         * states once CONNECT_REQ is sent */
+        if ((ctx->conn_state != CONN_STATE_SCANNING) && (ctx->conn_state != CONN_STATE_INITIATING) &&
+            (ctx->radio_op != LL_RADIO_OP_PDU_TX)) {
+            ll_rp_release(ctx, &ctx->rp_scan, RP_HOOK_ID_BLE_LL_SCAN);
+        }
+        if (ctx->conn_state != CONN_STATE_CONNECTED) {
+            ll_rp_release(ctx, &ctx->rp_conn_event, RP_HOOK_ID_BLE_LL_CONN_EVENT);
+        }
+        if (ctx->conn_state != CONN_STATE_ADVERTISING) {
+            ll_rp_release(ctx, &ctx->rp_adv, RP_HOOK_ID_BLE_LL_ADV);
+        }
+    }
+#endif
+    
+    /* 离开连接状态时停止定时器 / Stop the timer when leaving the connected state */
+    if ((ctx->conn_state != CONN_STATE_CONNECTED) && ctx->event_timer_armed) {
+        ll_disarm_event_timer(ctx);
+    }
+    
+    switch (ctx->conn_state) {
+        case CONN_STATE_SCANNING:
+        case CONN_STATE_INITIATING:
+            /* 广播包只在扫描窗口内和DIO1中断后读取 / Advertising packets are only read within a scan window and after
+             * a DIO1 interrupt */
+            if (!ll_process_scan_window(ctx) || (ctx->radio_op != LL_RADIO_OP_IDLE) ||
+                !(ll_radio_get_irq(ctx) & SX128X_IRQ_RX_DONE)) {
+                break;
+            }
+            ll_scan_rx(ctx);
+            
+            /* 继续扫描，CONNECT_REQ发送中除外 / Continue scanning, unless CONNECT_REQ is being sent */
+            if (ctx->radio_op == LL_RADIO_OP_IDLE) {
+                sx128x_set_rx(ctx->radio_context);  // 重新进入接收模式 / Re-enter receive mode
+            }
+            break;
+            
+        case CONN_STATE_ADVERTISING:
+#if defined( ADD_BLE_LL )
+            if (ctx->rp) {
+                ll_rp_process_adv_event(ctx);
+                break;
+            }
+#endif
+            /* 广播事件之间无线电待机 / The radio stays in standby between advertising events */
+            if ((ctx->adv_channel == 0) && (ble_ll_get_timestamp_us() >= ctx->adv_event_start)) {
+                ll_adv_event_start(ctx);
+            }
+            break;
+            
+        case CONN_STATE_CONNECTED:
+#if defined( ADD_BLE_LL )
+            if (ctx->rp) {
+                ll_rp_process_connection_event(ctx);
+                break;
+            }
+#endif
+            /* 连接事件由LPTIM1在锚点前唤醒，事件结束时重新启动 / Connection events are woken up by LPTIM1 ahead of
+             * the anchor point, re-armed when the event ends */
+            if (ctx->radio_op != LL_RADIO_OP_IDLE) {
+                break;
+            }
+            if (!ctx->event_timer_armed) {
+                ll_arm_event_timer(ctx);
+            }
+            if (ctx->conn_event_due) {
+                ctx->conn_event_due = false;
+                ctx->event_timer_armed = false;
+                
+                /* 唤醒余量已覆盖主循环延迟，精确等待锚点 / The wake-up lead covers the main loop latency, wait for
+                 * the exact anchor point */
+                ble_ll_wait_until_us(ctx->anchor_point - ctx->window_widening);
+                ll_conn_event_start(ctx);
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 设置数据信道图 / Set the data channel map
+ * @param ctx 连接上下文 / Connection context
+ * @param channel_map 37位信道图，至少2个信道 / 37-bit channel map, at least 2 channels
+ * @return 操作状态 / Operation status
+ *
+ * @details 未连接时立即生效；主设备连接中发送LL_CHANNEL_MAP_IND，双方在同一事件计数切换
+ *          Applies at once when not connected; a connected master sends LL_CHANNEL_MAP_IND and both sides switch at
+ *          the same event counter
+ */
+ble_status_t ble_ll_set_channel_map(ble_conn_context_t* ctx, const uint8_t* channel_map)
+{
+    if (!ctx || !channel_map) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ll_count_used_channels(channel_map) < 2) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+    
+    if (ctx->conn_state != CONN_STATE_CONNECTED) {
+        ll_set_channel_map(ctx, channel_map);
+        return BLE_STATUS_OK;
+    }
+    
+    if ((ctx->role != BLE_ROLE_MASTER) || ctx->channel_map_pending) {
+        return BLE_STATUS_BUSY;
+    }
+    
+    uint16_t instant = ctx->event_counter + ctx->slave_latency + BLE_LL_CHANNEL_MAP_INSTANT;
+    uint8_t channel_map_ind[8] = {
+        LL_CHANNEL_MAP_IND,
+        channel_map[0], channel_map[1], channel_map[2], channel_map[3], channel_map[4] & 0x1F,
+        instant & 0xFF, instant >> 8
+    };
+    
+    if (ll_tx_enqueue(ctx, 0x03, channel_map_ind, sizeof(channel_map_ind)) != BLE_STATUS_OK) {
+        return BLE_STATUS_BUSY;
+    }
+    memcpy(ctx->pending_channel_map, &channel_map_ind[1], 5);
+    ctx->channel_map_instant = instant;
+    ctx->channel_map_pending = true;
+    
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 计算当前连接事件的数据信道 / Calculate the data channel of the current connection event
+ * @param ctx 连接上下文 / Connection context
+ * @return 数据信道索引 / Data channel index
+ *
+ * @details 每个连接事件调用一次；CSA#1按跳频增量推进，CSA#2由事件计数和信道标识导出，未使用的信道查重映射表
+ *          Called once per connection event; CSA#1 steps by the hop increment, CSA#2 derives from the event counter
+ *          and the channel identifier, unused channels are looked up in the remapping table
+ */
+uint8_t ble_ll_calculate_next_channel(ble_conn_context_t* ctx)
+{
+    uint16_t counter = (uint16_t)ctx->event_counter;
+    uint8_t unmapped_channel;
+    
+    /* 信道图在生效时刻切换 / The channel map switches at the instant */
+    if (ctx->channel_map_pending && (counter == ctx->channel_map_instant)) {
+        ll_set_channel_map(ctx, ctx->pending_channel_map);
+        ctx->channel_map_pending = false;
+    }
+    
+    if (!ctx->csa2) {
+        /* CSA#1 */
+        unmapped_channel = (ctx->last_unmapped_channel + ctx->hop_increment) % BLE_LL_DATA_CHANNELS;
+        ctx->last_unmapped_channel = unmapped_channel;
+        
+        if (ctx->channel_map[unmapped_channel >> 3] & (1 << (unmapped_channel & 0x07))) {
+            return unmapped_channel;
+        }
+        return ctx->channel_remap[unmapped_channel % ctx->num_used_channels];
+    }
+    
+    /* CSA#2：三轮置换和乘加 / CSA#2: three rounds of permutation and multiply-add */
+    uint16_t prn_e = counter ^ ctx->channel_id;
+    for (uint8_t round = 0; round < 3; round++) {
+        /* 每字节内位反转 / Bit reversal within each byte */
+        prn_e = ((prn_e & 0xAAAA) >> 1) | ((prn_e & 0x5555) << 1);
+        prn_e = ((prn_e & 0xCCCC) >> 2) | ((prn_e & 0x3333) << 2);
+        prn_e = ((prn_e & 0xF0F0) >> 4) | ((prn_e & 0x0F0F) << 4);
+        prn_e = (uint16_t)(17 * prn_e + ctx->channel_id);
+    }
+    prn_e ^= ctx->channel_id;
+    
+    unmapped_channel = prn_e % BLE_LL_DATA_CHANNELS;
+    if (ctx->channel_map[unmapped_channel >> 3] & (1 << (unmapped_channel & 0x07))) {
+        return unmapped_channel;
+    }
+    return ctx->channel_remap[((uint32_t)ctx->num_used_channels * prn_e) >> 16];
+}
+
+/**
+ * @brief 生成接入地址
+ */
+uint32_t ble_ll_generate_access_address(void)
+{
+    uint32_t aa;
     
     do {
         /* 生成随机地址 */
@@ -670,21 +2371,67 @@ void ble_ll_wait_until_us(uint64_t timestamp)
 }
 
 /**
- * @brief 无线电中断处理
+ * @brief 无线电中断处理 / Radio interrupt handler
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 在中断中设置标志，主循环中处理；中断中不访问SPI
+ *          Sets a flag in the interrupt, processed in the main loop; no SPI access in the interrupt
  */
 void ble_ll_radio_irq_handler(ble_conn_context_t* ctx)
 {
-    /* 在中断中设置标志，主循环中处理 */
-    // 实际处理在ble_ll_process_events中
+    if (!ctx) {
+        return;
+    }
+    
+#if defined( ADD_BLE_LL )
+    /* 规划器未把无线电分配给BLE时，中断属于LoRa任务 / While the planner has not granted the radio to BLE, the
+     * interrupt belongs to LoRa tasks */
+    if (ctx->rp && (ctx->rp_conn_event != LL_RP_TASK_GRANTED) && (ctx->rp_scan != LL_RP_TASK_GRANTED) &&
+        (ctx->rp_adv != LL_RP_TASK_GRANTED)) {
+        rp_radio_irq_callback(ctx->rp);
+        return;
+    }
+#endif
+    
+    ctx->radio_irq_timestamp = ble_ll_get_timestamp_us();
+    ctx->radio_irq_pending = true;
 }
 
 /**
- * @brief 连接事件触发（定时器中断调用）
+ * @brief 连接事件触发（定时器中断调用） / Connection event trigger (called from the timer interrupt)
+ * @param ctx 连接上下文 / Connection context
+ *
+ * @details 在中断中设置标志，主循环中处理；分段定时未到唤醒点时不置位，由LPTIM1重新装载
+ *          Sets a flag in the interrupt, processed in the main loop; a split delay not yet at the wake-up point
+ *          leaves it clear and LPTIM1 is reloaded
  */
 void ble_ll_connection_event_trigger(ble_conn_context_t* ctx)
 {
-    /* 在中断中设置标志，主循环中处理 */
-    // 实际处理在ble_ll_process_events中
+    if (!ctx || !ctx->event_timer_armed) {
+        return;
+    }
+    
+    uint64_t now_us = ble_ll_get_timestamp_us();
+    uint64_t wakeup_us = ll_event_wakeup_us(ctx);
+    
+    if ((wakeup_us > now_us) && ((wakeup_us - now_us) > (2000000 / BLE_LL_LPTIM_FREQ_HZ))) {
+        return;
+    }
+    ctx->conn_event_due = true;
+}
+
+/**
+ * @brief LPTIM比较匹配中断回调 / LPTIM compare match interrupt callback
+ */
+void HAL_LPTIM_CompareMatchCallback(LPTIM_HandleTypeDef *hlptim)
+{
+    if (hlptim->Instance == LPTIM1) {
+        HAL_LPTIM_SetOnce_Stop_IT(hlptim);
+        for (uint8_t i = 0; i < BLE_LL_MAX_CONNECTIONS; i++) {
+            ble_ll_connection_event_trigger(g_timer_ctx[i]);
+        }
+        ll_timer_reload();
+    }
 }
 
 /**
@@ -8,7 +8,7 @@
  *          This file implements functions referenced but not implemented in ble_ll.c
  *          
  *          主要包括 / Main contents:
- *          - CRC24计算(完整查找表) / CRC24 calculation (complete lookup table)
+ *          - CRC24和白化的软件参考实现(仅测试用) / Software reference CRC24 and whitening (tests only)
  *          - PDU发送和处理 / PDU sending and processing
  *          - 连接请求处理 / Connection request handling
  *          - 接入地址验证 / Access address validation
@@ -18,6 +18,11 @@
 #include "sx128x.h"
 #include "stm32g0xx_hal.h"
 
+#if defined( BLE_LL_SOFTWARE_CRC )
+/* 发送和接收由SX1280硬件计算CRC和白化，以下软件实现只用于主机端测试
+ * CRC and whitening are done by the SX1280 hardware on TX and RX, the software versions below only serve host side
+ * tests */
+
 /* 完整的CRC24查找表（BLE多项式: 0x100065B） / Complete CRC24 lookup table (BLE polynomial: 0x100065B) */
 static const uint32_t crc24_table[256] = {
     0x000000, 0x01B4C0, 0x036980, 0x02DD40, 0x06D300, 0x0767C0, 0x05BA80, 0x040E40,
@@ -76,6 +81,39 @@ uint32_t ble_ll_calculate_crc24(uint8_t* data, uint16_t len, uint32_t crc_init)
     return crc;
 }
 
+/**
+ * @brief BLE数据白化 / BLE data whitening
+ * @param data 要白化的数据(原地) / Data to whiten (in place)
+ * @param len 数据长度 / Data length
+ * @param channel 信道索引 / Channel index
+ *
+ * @details 多项式x^7+x^4+1，按位反转的寄存器以信道索引初始化；白化和去白化相同
+ *          Polynomial x^7+x^4+1, the bit-reversed register is seeded with the channel index; whitening and
+ *          de-whitening are the same operation
+ */
+void ble_ll_whiten_data(uint8_t* data, uint16_t len, uint8_t channel)
+{
+    uint8_t lfsr = 0x02;
+    
+    /* 信道索引按位反转 / Bit-reversed channel index */
+    for (uint8_t i = 0; i < 6; i++) {
+        if (channel & (1 << i)) {
+            lfsr |= 0x80 >> i;
+        }
+    }
+    
+    for (uint16_t i = 0; i < len; i++) {
+        for (uint8_t m = 0x01; m; m <<= 1) {
+            if (lfsr & 0x80) {
+                lfsr ^= 0x11;
+                data[i] ^= m;
+            }
+            lfsr <<= 1;
+        }
+    }
+}
+#endif
+
 /**
  * @brief 扫描特定设备 / Scan for specific device
  * @param ctx 连接上下文 / Connection context
@@ -87,15 +125,13 @@ bool ll_scan_for_device(ble_conn_context_t* ctx, uint8_t* target_addr)
     uint8_t rx_buffer[255];
     uint8_t rx_len;
     
-    /* 检查是否有接收到的数据 / Check if data received */
-    if (sx128x_get_irq_status(ctx->radio_context) & SX128X_IRQ_RX_DONE) {
+    /* 检查是否有接收到的数据，只在DIO1中断后读取状态 / Check if data received, the status is only read after a
+     * DIO1 interrupt */
+    if (ll_radio_get_irq(ctx) & SX128X_IRQ_RX_DONE) {
         /* 读取数据 / Read data */
         sx128x_get_rx_buffer_status(ctx->radio_context, &rx_len, NULL);
         sx128x_read_buffer(ctx->radio_context, 0x80, rx_buffer, rx_len);
         
-        /* 清除中断 / Clear interrupt */
-        sx128x_clear_irq_status(ctx->radio_context, SX128X_IRQ_RX_DONE);
-        
         /* 解析广播包 / Parse advertising packet */
         ble_adv_pdu_t* adv = (ble_adv_pdu_t*)rx_buffer;
         
@@ -134,6 +170,7 @@ bool ll_scan_for_device(ble_conn_context_t* ctx, uint8_t* target_addr)
         
         sx128x_set_rf_freq(ctx->radio_context, freq);
         sx128x_set_gfsk_ble_whitening_seed(ctx->radio_context, channel | 0x40);
+        sx128x_set_dio_irq_params(ctx->radio_context, LL_RADIO_IRQ_MASK, LL_RADIO_IRQ_MASK, 0, 0);
         sx128x_set_rx(ctx->radio_context);             // 重新进入接收模式 / Re-enter receive mode
     }
     
@@ -149,6 +186,10 @@ bool ll_scan_for_device(ble_conn_context_t* ctx, uint8_t* target_addr)
  */
 ble_status_t ll_send_pdu(ble_conn_context_t* ctx, void* pdu, uint16_t len)
 {
+    if (ctx->radio_op != LL_RADIO_OP_IDLE) {
+        return BLE_STATUS_BUSY;
+    }
+    
     /* 等待合适的时机发送 / Wait for appropriate time to send */
     sx128x_set_standby(ctx->radio_context, SX128X_STANDBY_RC);  // 切换到待机模式 / Switch to standby mode
     
@@ -156,21 +197,11 @@ ble_status_t ll_send_pdu(ble_conn_context_t* ctx, void* pdu, uint16_t len)
     sx128x_set_buffer_base_address(ctx->radio_context, 0x00, 0x80);  // 设置缓冲区基地址 / Set buffer base address
     sx128x_write_buffer(ctx->radio_context, 0x00, (uint8_t*)pdu, len);
     
-    /* 发送 / Transmit */
+    /* 发送，完成由DIO1中断在ble_ll_process_events中处理 / Transmit, completion handled from the DIO1 interrupt in
+     * ble_ll_process_events */
+    ll_radio_start(ctx, LL_RADIO_OP_PDU_TX, LL_PDU_TX_TIMEOUT_US);
     sx128x_set_tx(ctx->radio_context);
     
-    /* 等待发送完成 / Wait for transmission complete */
-    uint32_t timeout = 1000;  // 10ms超时 / 10ms timeout
-    while (timeout-- && !(sx128x_get_irq_status(ctx->radio_context) & SX128X_IRQ_TX_DONE)) {
-        ble_ll_delay_us(10);  // 延时10微秒 / Delay 10 microseconds
-    }
-    
-    if (timeout == 0) {
-        return BLE_STATUS_TIMEOUT;
-    }
-    
-    sx128x_clear_irq_status(ctx->radio_context, SX128X_IRQ_TX_DONE);
-    
     return BLE_STATUS_OK;
 }
 
@@ -182,19 +213,8 @@ ble_status_t ll_send_pdu(ble_conn_context_t* ctx, void* pdu, uint16_t len)
  */
 ble_status_t ll_send_connect_request(ble_conn_context_t* ctx, ll_connect_req_t* req)
 {
-    /* 计算CRC / Calculate CRC */
-    uint32_t crc = ble_ll_calculate_crc24((uint8_t*)req, sizeof(ll_connect_req_t) - 3, 
-                                          BLE_CRC_INIT_ADV);  // 使用广播CRC初始值 / Use advertising CRC init value
-    
-    /* 添加CRC到PDU / Add CRC to PDU */
-    uint8_t pdu_with_crc[sizeof(ll_connect_req_t) + 3];
-    memcpy(pdu_with_crc, req, sizeof(ll_connect_req_t));
-    pdu_with_crc[sizeof(ll_connect_req_t)] = crc & 0xFF;             // CRC低字节 / CRC low byte
-    pdu_with_crc[sizeof(ll_connect_req_t) + 1] = (crc >> 8) & 0xFF;  // CRC中字节 / CRC middle byte
-    pdu_with_crc[sizeof(ll_connect_req_t) + 2] = (crc >> 16) & 0xFF; // CRC高字节 / CRC high byte
-    
-    /* 发送PDU / Send PDU */
-    return ll_send_pdu(ctx, pdu_with_crc, sizeof(pdu_with_crc));
+    /* CRC由无线电按广播CRC初始值追加 / The radio appends the CRC with the advertising CRC init value */
+    return ll_send_pdu(ctx, req, sizeof(ll_connect_req_t));
 }
 
 /**
@@ -204,7 +224,7 @@ ble_status_t ll_send_connect_request(ble_conn_context_t* ctx, ll_connect_req_t*
  */
 bool ll_has_tx_data(ble_conn_context_t* ctx)
 {
-    return ctx->tx_pending;
+    return ctx->tx_count > 0;
 }
 
 /**
@@ -214,9 +234,9 @@ bool ll_has_tx_data(ble_conn_context_t* ctx)
  */
 void ll_prepare_tx_pdu(ble_conn_context_t* ctx, ble_data_pdu_t* pdu)
 {
-    if (ctx->tx_pending) {
-        /* 使用已准备的数据 / Use prepared data */
-        memcpy(pdu, ctx->tx_buffer, ctx->tx_length);
+    if (ctx->tx_count > 0) {
+        /* 使用发送队首 / Use the transmit queue head */
+        memcpy(pdu, &ctx->tx_queue[ctx->tx_head], ctx->tx_queue[ctx->tx_head].length + 2);
     } else {
         /* 准备空PDU / Prepare empty PDU */
         pdu->llid = 0x01;  /* LL控制PDU / LL Control PDU */
@@ -268,7 +288,7 @@ void ll_process_rx_pdu(ble_conn_context_t* ctx, ble_data_pdu_t* pdu)
     if (pdu->nesn != ctx->tx_seq_num) {
         /* 对方确认了我们的数据 / Peer acknowledged our data */
         ctx->tx_seq_num ^= 1;      // 翻转发送序列号 / Toggle transmit sequence number
-        ctx->tx_pending = false;   // 清除发送等待标志 / Clear pending flag
+        ll_tx_ack(ctx);            // 移除已确认的队首 / Remove the acknowledged queue head
     }
 }
 
@@ -302,15 +322,10 @@ void ll_process_control_pdu(ble_conn_context_t* ctx, uint8_t* data, uint8_t len)
             /* 回复Feature Response / Reply with Feature Response */
             {
                 uint8_t feature_rsp[9] = {
-                    0x03,  /* LLID = 控制PDU / LLID = Control PDU */
-                    0x09,  /* 长度 / Length */
                     LL_FEATURE_RSP,
-                    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 无特性 / No features */
+                    LL_FEATURE_DATA_LENGTH_EXT, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 数据长度扩展 / DLE */
                 };
-                ctx->tx_buffer[0] = feature_rsp[0];
-                memcpy(&ctx->tx_buffer[1], &feature_rsp[1], 9);
-                ctx->tx_length = 10;
-                ctx->tx_pending = true;
+                ll_tx_enqueue(ctx, 0x03, feature_rsp, sizeof(feature_rsp));
             }
             break;
             
@@ -321,15 +336,11 @@ void ll_process_control_pdu(ble_conn_context_t* ctx, uint8_t* data, uint8_t len)
         default:
             /* 未知的控制PDU，回复LL_UNKNOWN_RSP / Unknown control PDU, reply with LL_UNKNOWN_RSP */
             {
-                uint8_t unknown_rsp[3] = {
-                    0x03,  /* LLID = 控制PDU / LLID = Control PDU */
-                    0x02,  /* 长度 / Length */
+                uint8_t unknown_rsp[2] = {
                     LL_UNKNOWN_RSP,
                     opcode  // 未知的操作码 / Unknown opcode
                 };
-                memcpy(ctx->tx_buffer, unknown_rsp, 4);
-                ctx->tx_length = 4;
-                ctx->tx_pending = true;
+                ll_tx_enqueue(ctx, 0x03, unknown_rsp, sizeof(unknown_rsp));
             }
             break;
     }
@@ -347,12 +358,7 @@ ble_status_t ble_send_empty_pdu(ble_conn_context_t* ctx)
     }
     
     /* 构造空的LL数据PDU / Construct empty LL data PDU */
-    ctx->tx_buffer[0] = 0x01;  /* LLID = LL控制PDU(空) / LLID = LL Control PDU (empty) */
-    ctx->tx_buffer[1] = 0x00;  /* 长度 = 0 / Length = 0 */
-    ctx->tx_length = 2;
-    ctx->tx_pending = true;
-    
-    return BLE_STATUS_OK;
+    return ll_tx_enqueue(ctx, 0x01, NULL, 0);  /* LLID = 继续，长度0 / LLID = continuation, length 0 */
 }
 
 /**
@@ -367,27 +373,8 @@ ble_status_t ll_send_l2cap_frame(ble_conn_context_t* ctx, l2cap_frame_t* frame)
         return BLE_STATUS_NOT_CONNECTED;
     }
     
-    if (ctx->tx_pending) {
-        return BLE_STATUS_BUSY;
-    }
-    
-    /* 构造LL数据PDU / Construct LL data PDU */
-    ctx->tx_buffer[0] = 0x02;  /* LLID = L2CAP数据 / LLID = L2CAP data */
-    ctx->tx_buffer[1] = frame->header.length + 4;  /* LL长度 = L2CAP头 + 数据 / LL length = L2CAP header + data */
-    
-    /* 复制L2CAP头 / Copy L2CAP header */
-    ctx->tx_buffer[2] = frame->header.length & 0xFF;         // L2CAP长度低字节 / L2CAP length low byte
-    ctx->tx_buffer[3] = (frame->header.length >> 8) & 0xFF;  // L2CAP长度高字节 / L2CAP length high byte
-    ctx->tx_buffer[4] = frame->header.cid & 0xFF;            // 通道ID低字节 / Channel ID low byte
-    ctx->tx_buffer[5] = (frame->header.cid >> 8) & 0xFF;     // 通道ID高字节 / Channel ID high byte
-    
-    /* 复制L2CAP数据 / Copy L2CAP data */
-    memcpy(&ctx->tx_buffer[6], frame->payload, frame->header.length);
-    
-    ctx->tx_length = frame->header.length + 6;
-    ctx->tx_pending = true;
-    
-    return BLE_STATUS_OK;
+    /* 按生效负载上限分片 / Fragmented to the effective payload limit */
+    return ll_tx_enqueue_sdu(ctx, frame->header.cid, frame->payload, frame->header.length);
 }
 
 /**
@@ -478,9 +465,12 @@ bool ll_validate_access_address(uint32_t aa)
 uint32_t ble_ll_get_frequency(uint8_t channel)
 {
     if (channel <= 39) {
-        if (channel <= 36) {
-            /* 数据信道 0-36 / Data channels 0-36 */
-            return 2402000000 + (channel * 2000000);  // 2MHz间隔 / 2MHz spacing
+        if (channel <= 10) {
+            /* 数据信道 0-10位于2404-2424 MHz / Data channels 0-10 at 2404-2424 MHz */
+            return 2404000000 + (channel * 2000000);  // 2MHz间隔 / 2MHz spacing
+        } else if (channel <= 36) {
+            /* 数据信道 11-36位于2428-2478 MHz / Data channels 11-36 at 2428-2478 MHz */
+            return 2428000000 + ((channel - 11) * 2000000);
         } else {
             /* 广播信道 37-39 / Advertising channels 37-39 */
             switch (channel) {
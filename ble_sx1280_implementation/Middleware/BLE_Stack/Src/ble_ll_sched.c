@@ -0,0 +1,306 @@
+/**
+ * @file    ble_ll_sched.c
+ * @brief   BLE多连接调度实现 / BLE Multi-connection Scheduler Implementation
+ * @date    2024
+ *
+ * @details 主设备的锚点由自己决定，所有连接共用一个间隔时锚点之间没有漂移，时隙一旦对齐就不会重叠
+ *          The master chooses its own anchor points, with one interval shared by all connections the anchor points
+ *          do not drift apart, so slots never overlap once aligned
+ */
+
+#include "ble_ll_sched.h"
+
+/**
+ * @brief 连接是否占用自己的时隙 / Whether a link holds its own slot
+ * @param ctx 连接上下文 / Connection context
+ * @return 连接中或正在扫描/发起连接时返回true / true while connected, scanning or initiating
+ *
+ * @details 扫描或发起连接的时隙留给扫描，不借出 / The slot of a scanning or initiating link is kept for scanning and
+ *          not lent
+ */
+static bool sched_link_holds_slot(ble_conn_context_t* ctx)
+{
+    return ctx->conn_state != CONN_STATE_IDLE;
+}
+
+/**
+ * @brief 连接是否有连接事件 / Whether a link runs connection events
+ * @param ctx 连接上下文 / Connection context
+ * @return 已连接时返回true / true when connected
+ */
+static bool sched_link_connected(ble_conn_context_t* ctx)
+{
+    return (ctx->conn_state == CONN_STATE_CONNECTED) || (ctx->conn_state == CONN_STATE_DISCONNECTING);
+}
+
+/**
+ * @brief 查找连接的时隙 / Find the slot of a link
+ * @param sched 调度器 / Scheduler
+ * @param ctx 连接上下文 / Connection context
+ * @return 时隙序号，未登记时为-1 / Slot index, -1 when not registered
+ */
+static int8_t sched_find_slot(ble_ll_sched_t* sched, ble_conn_context_t* ctx)
+{
+    for (uint8_t i = 0; i < sched->link_count; i++) {
+        if (sched->links[i] == ctx) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 更新各连接事件的可用时长 / Update the time available to every connection event
+ * @param sched 调度器 / Scheduler
+ *
+ * @details 连接事件可以延续到后面连续的空闲时隙，最多到自己的下一个锚点；数据多的连接因此得到空闲的空中时间
+ *          A connection event may run on into the following free slots, at most up to its own next anchor point;
+ *          links with more data therefore get the idle airtime
+ */
+static void sched_update_event_time(ble_ll_sched_t* sched)
+{
+    for (uint8_t i = 0; i < sched->link_count; i++) {
+        uint8_t slots = 1;
+
+        while (slots < sched->max_links) {
+            uint8_t next = (i + slots) % sched->max_links;
+            if ((next < sched->link_count) && sched_link_holds_slot(sched->links[next])) {
+                break;
+            }
+            slots++;
+        }
+        sched->links[i]->sched_event_us = slots * sched->slot_us;
+    }
+}
+
+/**
+ * @brief 下一个连接事件是否临近 / Whether the next connection event is close
+ * @param sched 调度器 / Scheduler
+ * @return 有连接事件待执行或在扫描余量内唤醒时返回true / true when a connection event is due or wakes up within the
+ *         scan guard
+ */
+static bool sched_conn_event_near(ble_ll_sched_t* sched)
+{
+    uint64_t now_us = ble_ll_get_timestamp_us();
+
+    for (uint8_t i = 0; i < sched->link_count; i++) {
+        ble_conn_context_t* ctx = sched->links[i];
+        if (!sched_link_connected(ctx)) {
+            continue;
+        }
+        if (ctx->conn_event_due ||
+            ((ctx->anchor_point - BLE_LL_WAKEUP_US - ctx->window_widening) < (now_us + BLE_LL_SCHED_SCAN_GUARD_US))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 查找占用无线电的连接 / Find the link using the radio
+ * @param sched 调度器 / Scheduler
+ * @return 有进行中无线电操作的连接，没有时为NULL / Link with a radio operation in progress, NULL if none
+ */
+static ble_conn_context_t* sched_radio_owner(ble_ll_sched_t* sched)
+{
+    for (uint8_t i = 0; i < sched->link_count; i++) {
+        if (sched->links[i]->radio_op != LL_RADIO_OP_IDLE) {
+            return sched->links[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 初始化调度器 / Initialize the scheduler
+ * @param sched 调度器 / Scheduler
+ * @param max_links 时隙数(1-BLE_LL_MAX_CONNECTIONS) / Number of slots (1-BLE_LL_MAX_CONNECTIONS)
+ * @param conn_interval 期望的连接间隔(1.25ms单位)，0表示最短 / Requested connection interval (1.25 ms units), 0 for
+ *        the shortest
+ * @return 操作状态 / Operation status
+ *
+ * @details 间隔至少为max_links个最短时隙，按1.25ms取整，再等分为时隙
+ *          The interval is at least max_links shortest slots, rounded up to 1.25 ms, then split evenly into slots
+ */
+ble_status_t ble_ll_sched_init(ble_ll_sched_t* sched, uint8_t max_links, uint16_t conn_interval)
+{
+    if (!sched || (max_links == 0) || (max_links > BLE_LL_MAX_CONNECTIONS)) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+
+    memset(sched, 0, sizeof(ble_ll_sched_t));
+
+    uint32_t interval_us = (uint32_t)conn_interval * 1250;
+    if (interval_us < (uint32_t)max_links * BLE_LL_SCHED_MIN_SLOT_US) {
+        interval_us = (uint32_t)max_links * BLE_LL_SCHED_MIN_SLOT_US;
+    }
+    interval_us = ((interval_us + 1249) / 1250) * 1250;  // 连接间隔以1.25ms为单位 / 1.25 ms connection interval unit
+
+    sched->max_links = max_links;
+    sched->interval_us = interval_us;
+    sched->slot_us = interval_us / max_links;
+    sched->epoch = ble_ll_get_timestamp_us();
+
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 登记连接上下文 / Register a connection context
+ * @param sched 调度器 / Scheduler
+ * @param ctx 已初始化的连接上下文 / Initialized connection context
+ * @return 操作状态，时隙用完时为BLE_STATUS_NO_MEMORY / Operation status, BLE_STATUS_NO_MEMORY when all slots are
+ *         taken
+ */
+ble_status_t ble_ll_sched_add(ble_ll_sched_t* sched, ble_conn_context_t* ctx)
+{
+    if (!sched || !ctx) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+
+#if defined( ADD_BLE_LL )
+    if (ctx->rp) {
+        return BLE_STATUS_ERROR;  // 无线电由规划器分配 / The radio is granted by the planner
+    }
+#endif
+
+    if (sched_find_slot(sched, ctx) >= 0) {
+        return BLE_STATUS_OK;
+    }
+    if (sched->link_count >= sched->max_links) {
+        return BLE_STATUS_NO_MEMORY;
+    }
+
+    /* 共享无线电：每个连接事件重新配置接入地址 / Shared radio: every connection event reconfigures the access
+     * address */
+    ctx->sched_epoch = sched->epoch;
+    ctx->sched_offset_us = sched->link_count * sched->slot_us;
+    ctx->sched_event_us = sched->slot_us;
+
+    sched->links[sched->link_count++] = ctx;
+    return BLE_STATUS_OK;
+}
+
+/**
+ * @brief 在时隙上发起连接 / Initiate a connection in the slot
+ * @param sched 调度器 / Scheduler
+ * @param ctx 已登记的连接上下文 / Registered connection context
+ * @param peer_addr 对端设备地址 / Peer device address
+ * @param params 连接参数，连接间隔被调度器的间隔替换 / Connection parameters, the connection interval is replaced by
+ *        the scheduler interval
+ * @return 操作状态 / Operation status
+ */
+ble_status_t ble_ll_sched_connect(ble_ll_sched_t* sched, ble_conn_context_t* ctx, uint8_t* peer_addr,
+                                  ble_conn_params_t* params)
+{
+    if (!sched || !ctx || !params) {
+        return BLE_STATUS_INVALID_PARAMS;
+    }
+
+    if (sched_find_slot(sched, ctx) < 0) {
+        return BLE_STATUS_UNKNOWN_DEVICE;
+    }
+
+    ble_conn_params_t sched_params = *params;
+    sched_params.conn_interval = sched->interval_us / 1250;
+
+    return ble_ll_connect(ctx, peer_addr, &sched_params);
+}
+
+/**
+ * @brief 处理所有连接的事件 / Process the events of all links
+ * @param sched 调度器 / Scheduler
+ *
+ * @details 占用无线电的连接先处理，操作完成前其他连接不启动无线电；连接事件临近时让出扫描窗口，扫描最后处理
+ *          The link using the radio is processed first and no other link starts the radio before its operation
+ *          completes; scan windows are yielded when a connection event is close, scanning is processed last
+ */
+void ble_ll_sched_process(ble_ll_sched_t* sched)
+{
+    if (!sched) {
+        return;
+    }
+
+    sched_update_event_time(sched);
+
+    ble_conn_context_t* owner = sched_radio_owner(sched);
+    if (owner) {
+        ble_ll_process_events(owner);
+        if (owner->radio_op != LL_RADIO_OP_IDLE) {
+            return;
+        }
+    }
+
+    /* 连接事件 / Connection events */
+    for (uint8_t i = 0; i < sched->link_count; i++) {
+        ble_conn_context_t* ctx = sched->links[i];
+        if ((ctx == owner) || (ctx->conn_state == CONN_STATE_SCANNING) ||
+            (ctx->conn_state == CONN_STATE_INITIATING)) {
+            continue;
+        }
+
+        /* 连接事件开始前让出扫描窗口 / Yield the scan windows before a connection event starts */
+        if (sched_link_connected(ctx) && ctx->conn_event_due) {
+            for (uint8_t j = 0; j < sched->link_count; j++) {
+                if (ble_ll_scan_yield(sched->links[j])) {
+                    sched->yielded_scans++;
+                }
+            }
+        }
+
+        ble_ll_process_events(ctx);
+        if (ctx->radio_op != LL_RADIO_OP_IDLE) {
+            return;  // 连接事件进行中 / Connection event in progress
+        }
+    }
+
+    /* 扫描和发起连接使用连接事件之间的空隙 / Scanning and initiating use the gaps between connection events */
+    bool conn_event_near = sched_conn_event_near(sched);
+    for (uint8_t i = 0; i < sched->link_count; i++) {
+        ble_conn_context_t* ctx = sched->links[i];
+        if ((ctx == owner) || ((ctx->conn_state != CONN_STATE_SCANNING) &&
+                               (ctx->conn_state != CONN_STATE_INITIATING))) {
+            continue;
+        }
+
+        if (conn_event_near) {
+            if (ble_ll_scan_yield(ctx)) {
+                sched->yielded_scans++;
+            }
+            continue;
+        }
+
+        ble_ll_process_events(ctx);
+        if (ctx->radio_op != LL_RADIO_OP_IDLE) {
+            return;  // CONNECT_REQ发送中 / CONNECT_REQ being sent
+        }
+    }
+}
+
+/**
+ * @brief 分发DIO1中断 / Route the DIO1 interrupt
+ * @param sched 调度器 / Scheduler
+ *
+ * @details 中断属于有进行中无线电操作的连接，否则属于打开扫描窗口的连接
+ *          The interrupt belongs to the link with a radio operation in progress, otherwise to the link with an open
+ *          scan window
+ */
+void ble_ll_sched_radio_irq_handler(ble_ll_sched_t* sched)
+{
+    if (!sched) {
+        return;
+    }
+
+    ble_conn_context_t* target = sched_radio_owner(sched);
+
+    for (uint8_t i = 0; !target && (i < sched->link_count); i++) {
+        ble_conn_context_t* ctx = sched->links[i];
+        if (((ctx->conn_state == CONN_STATE_SCANNING) || (ctx->conn_state == CONN_STATE_INITIATING)) &&
+            (ctx->scan_window_end != 0)) {
+            target = ctx;
+        }
+    }
+
+    if (target) {
+        ble_ll_radio_irq_handler(target);
+    }
+}
@@ -203,11 +203,20 @@ COMMON_C_DEFS += \
 LBM_BUILD_OPTIONS += LBM_FUOTA=yes LBM_FUOTA_VERSION=$(FUOTA_VERSION)
 endif
 
+ifeq ($(ALLOW_LFU_HW_HASH),yes)
+COMMON_C_DEFS += \
+	-DUSE_LFU_HW_HASH
+LBM_BUILD_OPTIONS += LBM_LFU_HW_HASH=yes
+endif
+
 ifneq ($(LBM_NB_OF_STACK),1)
 COMMON_C_DEFS += \
 	-DMULTISTACK
 endif
 
+# The LBM engine and the application threads share the modem lock implemented in smtc_modem_hal.c
+LBM_BUILD_OPTIONS += LBM_THREAD_SAFE=yes
+
 LFS_C_DEFS += -DLFS_CONFIG=lfs_config.h
 LFS_C_DEFS += -DLFS_NO_MALLOC
 #LFS_C_DEFS += -DLFS_YES_TRACE 		# WARNING there are BIG printf strings that generate HardFaults
@@ -27,6 +27,9 @@ FUOTA_VERSION ?= 1
 # USE LBM Store and forward (take more RAM on STML4 and STMU5 project, due to read_modify_write feature)
 ALLOW_STORE_AND_FORWARD ?= no
 
+# USE the HASH peripheral for the LBM Large File Upload hash
+ALLOW_LFU_HW_HASH ?= no
+
 #TRACE
 LBM_TRACE ?= yes
 APP_TRACE ?= yes
@@ -23,6 +23,8 @@ BOARD_LDSCRIPT = mcu_drivers/core/STM32U5xx/STM32U575ZITXQ_FLASH.ld
 #-----------------------------------------------------------------------------
 BOARD_C_SOURCES = \
 	mcu_drivers/STM32U5xx_HAL_Driver/Src/stm32u5xx_hal_rng.c\
+	mcu_drivers/STM32U5xx_HAL_Driver/Src/stm32u5xx_hal_hash.c\
+	mcu_drivers/STM32U5xx_HAL_Driver/Src/stm32u5xx_hal_hash_ex.c\
 	mcu_drivers/STM32U5xx_HAL_Driver/Src/stm32u5xx_hal_lptim.c \
 	mcu_drivers/STM32U5xx_HAL_Driver/Src/stm32u5xx_hal_rtc.c \
 	mcu_drivers/STM32U5xx_HAL_Driver/Src/stm32u5xx_hal_rtc_ex.c \
@@ -52,6 +54,7 @@ BOARD_C_SOURCES = \
 	smtc_hal_u5/smtc_hal_mcu.c\
 	smtc_hal_u5/smtc_hal_rtc.c\
 	smtc_hal_u5/smtc_hal_rng.c\
+	smtc_hal_u5/smtc_hal_hash.c\
 	smtc_hal_u5/smtc_hal_spi.c\
 	smtc_hal_u5/smtc_hal_lp_timer.c\
 	smtc_hal_u5/smtc_hal_trace.c\
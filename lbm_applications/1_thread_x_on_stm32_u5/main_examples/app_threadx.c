@@ -66,33 +66,41 @@
 #define xstr( a ) str( a )
 #define str( a ) #a
 static void  assert_smtc_modem_rc_dbg( smtc_modem_return_code_t rc );
-#define ASSERT_SMTC_MODEM_RC( rc )                                                           \
-    do                                                                                       \
-    {                                                                                        \
-        if( tx_semaphore_get( &smtc_api_protect_semaphore, TX_WAIT_FOREVER ) == TX_SUCCESS ) \
-        {                                                                                    \
-            if( rc != SMTC_MODEM_RC_OK )                                                     \
-            {                                                                                \
-                assert_smtc_modem_rc_dbg( rc );                                              \
-            }                                                                                \
-        }                                                                                    \
-        tx_semaphore_put( &smtc_api_protect_semaphore );                                     \
-        tx_thread_wait_abort( &tx_lbm_thread ); \
+// The modem api call is evaluated once, under the modem lock shared with the LBM engine
+#define ASSERT_SMTC_MODEM_RC( rc )                              \
+    do                                                          \
+    {                                                           \
+        threadx_lock_modem( );                                  \
+        smtc_modem_return_code_t assert_rc = ( rc );            \
+        threadx_unlock_modem( );                                \
+        if( assert_rc != SMTC_MODEM_RC_OK )                     \
+        {                                                       \
+            assert_smtc_modem_rc_dbg( assert_rc );              \
+        }                                                       \
     } while( 0 )
 
 /* Private variables ---------------------------------------------------------*/
 
+// ThreadX ticks to the next timer expiration, set by the kernel before each low power entry
 static uint32_t sleep_tick_adjust;
-// LBM thread to perform LoRA TX/RX
+// true while the MCU is in the stop mode entered by app_threadx_low_power_enter
+static bool is_low_power_sleep = false;
+// LBM thread to run the modem engine and its services
 TX_THREAD    tx_lbm_thread;
+// Radio thread to process the radio and radio planner timer interrupts
+TX_THREAD    tx_radio_thread;
+// A semaphore released on each LBM interrupt
+TX_SEMAPHORE tx_radio_semaphore;
+// A binary semaphore latching the LBM engine wakeups, so that a wakeup given before the LBM thread waits is not lost
+TX_SEMAPHORE tx_lbm_wakeup_semaphore;
 // First Application thread example , send LoRA uplink on port 101 periodically
 TX_THREAD    tx_lorawan_tx_periodic_thread;
 // Second Application thread example, send LoRA uplink on port 106 when user pushed the nucleo blue button or every 2 minutes 
 TX_THREAD    tx_app_thread;
 // A semaphore on clicking user button
 TX_SEMAPHORE tx_app_semaphore;
-// A semaphore to protect lbm api
-TX_SEMAPHORE smtc_api_protect_semaphore;
+// A recursive mutex with priority inheritance to serialize the LBM engine and the lbm api calls
+TX_MUTEX     smtc_modem_mutex;
 // a semaphore to protect LBM transmission
 TX_SEMAPHORE smtc_protect_smtc_tx_semaphore;
 #define STACK_ID 0
@@ -105,6 +113,14 @@ TX_SEMAPHORE smtc_protect_smtc_tx_semaphore;
  */
 static void user_button_callback( void* context );
 
+/**
+ * @brief LBM engine wakeup callback
+ *
+ *  This callback is called by LBM each time a modem API call or a radio hook gives new work to the stack,
+ *  the LBM thread is released to run the engine without waiting for the end of its sleep.
+ */
+static void lbm_engine_wakeup_callback( void );
+
 static hal_gpio_irq_t nucleo_blue_button = {
     .pin      = EXTI_BUTTON,
     .context  = NULL,                  // context pass to the callback - not used in this example
@@ -145,6 +161,18 @@ uint32_t app_threadx_init( VOID* memory_ptr )
     {
         return TX_THREAD_ERROR;
     }
+    /* Allocate the stack for Radio Thread  */
+    if( tx_byte_allocate( byte_pool, ( VOID** ) &pointer, TX_RADIO_STACK_SIZE, TX_NO_WAIT ) != TX_SUCCESS )
+    {
+        return TX_POOL_ERROR;
+    }
+    /* Create Radio Thread.  */
+    if( tx_thread_create( &tx_radio_thread, "Radio Thread", thread_radio, 0, pointer, TX_RADIO_STACK_SIZE,
+                          TX_RADIO_THREAD_PRIO, TX_RADIO_THREAD_PREEMPTION_THRESHOLD, TX_RADIO_THREAD_TIME_SLICE,
+                          TX_RADIO_THREAD_AUTO_START ) != TX_SUCCESS )
+    {
+        return TX_THREAD_ERROR;
+    }
     /* Allocate the stack for tx periodic thread Thread  */
     if( tx_byte_allocate( byte_pool, ( VOID** ) &pointer, TX_LORAWAN_TX_PERIODIC_STACK_SIZE, TX_NO_WAIT ) !=
         TX_SUCCESS )
@@ -175,10 +203,18 @@ uint32_t app_threadx_init( VOID* memory_ptr )
     {
         return TX_SEMAPHORE_ERROR;
     }
-    if( tx_semaphore_create( &smtc_api_protect_semaphore, "Api_Smtc_Semaphore", 1 ) != TX_SUCCESS )
+    if( tx_semaphore_create( &tx_radio_semaphore, "Radio_Semaphore", 0 ) != TX_SUCCESS )
+    {
+        return TX_SEMAPHORE_ERROR;
+    }
+    if( tx_semaphore_create( &tx_lbm_wakeup_semaphore, "Lbm_Wakeup_Semaphore", 0 ) != TX_SUCCESS )
     {
         return TX_SEMAPHORE_ERROR;
     }
+    if( tx_mutex_create( &smtc_modem_mutex, "Smtc_Modem_Mutex", TX_INHERIT ) != TX_SUCCESS )
+    {
+        return TX_MUTEX_ERROR;
+    }
 
     if( tx_semaphore_create( &smtc_protect_smtc_tx_semaphore, "Tx_Smtc_Semaphore", 0 ) != TX_SUCCESS )
     {
@@ -205,6 +241,8 @@ void thread_lbm( ULONG thread_input )
     SMTC_HAL_TRACE_INFO( "launch thread_lbm \n" );
     // Init LBM , modem_event_callback is called by LBM for each asynchronous events
     smtc_modem_init( &modem_event_callback );
+    // lbm_engine_wakeup_callback is called by LBM when a modem API call adds work to the stack
+    smtc_modem_set_engine_wakeup_callback( &lbm_engine_wakeup_callback );
     // main loop for Lbm thread
     while( 1 )
     {
@@ -212,9 +250,21 @@ void thread_lbm( ULONG thread_input )
         // This function can be called as many times as desired before this maximum delay,
         // but it must be called at least once before the expiration of this maximum delay
         uint32_t delay_to_sleep_ms = smtc_modem_run_engine( );
-        UINT     old_priority;
-        tx_thread_priority_change( &tx_lbm_thread, TX_LBM_THREAD_PRIO, &old_priority );
-        tx_thread_sleep( MS_TO_TICK( delay_to_sleep_ms ) );
+        // the wait timeout is the ThreadX timer from which the kernel computes the stop mode duration, the wait ends
+        // earlier when lbm_engine_wakeup_callback was called, even while the engine was still running
+        tx_semaphore_get( &tx_lbm_wakeup_semaphore, MS_TO_TICK( delay_to_sleep_ms ) );
+    }
+}
+
+// Radio thread, above the LBM and application threads, to launch the radio tasks and read the radio status on time
+// whatever the work of the LBM thread. The LBM thread is released by lbm_engine_wakeup_callback when a radio task ends
+void thread_radio( ULONG thread_input )
+{
+    SMTC_HAL_TRACE_INFO( "launch thread_radio \n" );
+    while( 1 )
+    {
+        tx_semaphore_get( &tx_radio_semaphore, TX_WAIT_FOREVER );
+        smtc_modem_run_radio_planner( );
     }
 }
 
@@ -238,12 +288,10 @@ void thread_lorawan_tx_periodic( ULONG thread_input )
         // Command may generate work for the stack, so drop down to smtc_modem_run_engine().
         if( hw_modem_is_a_cmd_available( ) == true )
         {
-            if( tx_semaphore_get( &smtc_api_protect_semaphore, TX_WAIT_FOREVER ) == TX_SUCCESS )
-            {
-                hw_modem_process_cmd( );
-            }
-            tx_semaphore_put( &smtc_api_protect_semaphore );
-            tx_thread_wait_abort( &tx_lbm_thread );
+            threadx_lock_modem( );
+            hw_modem_process_cmd( );
+            threadx_unlock_modem( );
+            lbm_engine_wakeup_callback( );
         }
         if ( hw_modem_is_low_power_ok( ) == true )
         {
@@ -283,6 +331,14 @@ void thread_app( ULONG thread_input )
         SMTC_HAL_TRACE_INFO( "send_uplink_counter_on_port\n" );
         send_uplink_counter_on_port( 106 );
         #endif
+
+        // the whole status is read under one modem lock instead of one lock per getter
+        smtc_modem_status_snapshot_t snapshot = { 0 };
+        ASSERT_SMTC_MODEM_RC( smtc_modem_get_status_snapshot( STACK_ID, &snapshot ) );
+        SMTC_HAL_TRACE_INFO( "status 0x%lx, fcnt %lu, dr %u, charge %lu uAh, %u pending events\n",
+                             ( unsigned long ) snapshot.status_mask, ( unsigned long ) snapshot.uplink_fcnt,
+                             snapshot.next_datarate, ( unsigned long ) snapshot.charge_uah,
+                             snapshot.event_pending_count );
     }
 }
 /**
@@ -303,17 +359,23 @@ void mx_threadx_init( void )
 static uint32_t timestamp_before_to_sleep;
 void            app_threadx_low_power_enter( void )
 {
-    if( sleep_tick_adjust == 0 )
+    // the kernel only sets the duration up when a ThreadX timer is active: the value is consumed here so that an idle
+    // period without timer does not sleep for the duration of the previous one
+    const uint32_t sleep_tick = sleep_tick_adjust;
+    sleep_tick_adjust         = 0;
+    is_low_power_sleep        = false;
+    if( sleep_tick == 0 )
     {
         return;
     }
     hal_mcu_disable_irq( );
     // timestamp before to go to sleep
     timestamp_before_to_sleep = smtc_modem_hal_get_time_in_ms( );
+    is_low_power_sleep        = true;
     // this function de init the peripherals, clear and stop the systick,
     // configure the rtc wake up timer and enter in sleep mode 2
     // when an interrupt expire (rtc,radio,..) init clk,peripherals, stop wake up timer and restart
-    hal_mcu_set_sleep_for_ms( TICK_TO_MS( sleep_tick_adjust ) );
+    hal_mcu_set_sleep_for_ms( TICK_TO_MS( sleep_tick ) );
 }
 
 /**
@@ -333,10 +395,11 @@ void app_threadx_low_power_exit( void )
  */
 ULONG App_ThreadX_LowPower_Timer_Adjust( void )
 {
-    if( sleep_tick_adjust == 0 )
+    if( is_low_power_sleep == false )
     {
         return 0;
     }
+    is_low_power_sleep = false;
     uint32_t adjust_time;
    // SMTC_HAL_TRACE_PRINTF( "sleep during  :%d\n", smtc_modem_hal_get_time_in_ms( ) - timestamp_before_to_sleep);
     adjust_time = smtc_modem_hal_get_time_in_ms( ) - timestamp_before_to_sleep;
@@ -352,9 +415,25 @@ void App_ThreadX_LowPower_Timer_Setup( unsigned long count )
 // this function is called each time LBM stack manages an interupt (low power timer or radio interupts) 
 void threadx_user_lbm_irq( void )
 {
-    UINT old_priority;
-    tx_thread_priority_change( &tx_lbm_thread, VERYHIGH, &old_priority );
-    tx_thread_wait_abort( &tx_lbm_thread );
+    tx_semaphore_put( &tx_radio_semaphore );
+}
+
+// these functions are called by LBM through smtc_modem_hal_lock_modem / smtc_modem_hal_unlock_modem and by the
+// application threads around the modem api calls
+void threadx_lock_modem( void )
+{
+    tx_mutex_get( &smtc_modem_mutex, TX_WAIT_FOREVER );
+}
+
+void threadx_unlock_modem( void )
+{
+    tx_mutex_put( &smtc_modem_mutex );
+}
+
+static void lbm_engine_wakeup_callback( void )
+{
+    // several wakeups before the LBM thread waits again need a single engine run
+    tx_semaphore_ceiling_put( &tx_lbm_wakeup_semaphore, 1 );
 }
 
 #ifdef HW_MODEM_ENABLED
@@ -549,7 +628,9 @@ static void send_uplink_counter_on_port( uint8_t port )
     buff[2]         = ( uplink_counter >> 8 ) & 0xFF;
     buff[3]         = ( uplink_counter & 0xFF );
     smtc_modem_return_code_t rc ;
+    threadx_lock_modem( );
     rc = smtc_modem_request_uplink( STACK_ID, port, false, buff, 4 );
+    threadx_unlock_modem( );
     ASSERT_SMTC_MODEM_RC(rc);
     if (rc == SMTC_MODEM_RC_OK )
     {
@@ -44,7 +44,7 @@ extern "C" {
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
 #define USE_STATIC_ALLOCATION 1
-#define TX_APP_MEM_POOL_SIZE ( 8 * 1024 )
+#define TX_APP_MEM_POOL_SIZE ( 10 * 1024 )
 
 #define MS_TO_TICK( x ) x / 10 + 1
 #define TICK_TO_MS( x ) x * 10
@@ -52,10 +52,12 @@ extern "C" {
 
 
 #define TX_LBM_STACK_SIZE 2048
+#define TX_RADIO_STACK_SIZE 2048
 #define TX_LORAWAN_TX_PERIODIC_STACK_SIZE 2048
 #define TX_APP_STACK_SIZE 2048
 
 #define TX_LORAWAN_TX_PERIODIC_THREAD_PRIO 15
+#define TX_RADIO_THREAD_PRIO 5
 #define TX_LBM_THREAD_PRIO 10
 #define TX_APP_THREAD_PRIO 15
 
@@ -71,9 +73,18 @@ extern "C" {
 #define TX_APP_THREAD_AUTO_START TX_AUTO_START
 #endif
 
-#define VERYHIGH 2
 #ifndef TX_LBM_THREAD_PREEMPTION_THRESHOLD
-#define TX_LBM_THREAD_PREEMPTION_THRESHOLD VERYHIGH
+#define TX_LBM_THREAD_PREEMPTION_THRESHOLD TX_LBM_THREAD_PRIO
+#endif
+
+#ifndef TX_RADIO_THREAD_PREEMPTION_THRESHOLD
+#define TX_RADIO_THREAD_PREEMPTION_THRESHOLD TX_RADIO_THREAD_PRIO
+#endif
+#ifndef TX_RADIO_THREAD_TIME_SLICE
+#define TX_RADIO_THREAD_TIME_SLICE TX_NO_TIME_SLICE
+#endif
+#ifndef TX_RADIO_THREAD_AUTO_START
+#define TX_RADIO_THREAD_AUTO_START TX_AUTO_START
 #endif
 
 #ifndef TX_LORAWAN_TX_PERIODIC_THREAD_PREEMPTION_THRESHOLD
@@ -95,15 +106,19 @@ extern "C" {
 uint32_t                    app_threadx_init( VOID* memory_ptr );
 void                        mx_threadx_init( void );
 void                        thread_lbm( ULONG thread_input );
+void                        thread_radio( ULONG thread_input );
 void                        thread_lorawan_tx_periodic( ULONG thread_input );
 void                        thread_app( ULONG thread_input );
 void                        threadx_user_lbm_irq( void );
+void                        threadx_lock_modem( void );
+void                        threadx_unlock_modem( void );
 void                        threadx_lorawan_tx_periodic_irq( void );
 void                        threadx_callback_to_protect_smtc_tx( void );
 void                        threadx_callback_to_release_smtc_tx( void );
 void                        modem_event_callback( void );
 extern TX_EVENT_FLAGS_GROUP tx_lbm_isr_flag;
 extern TX_THREAD            tx_lbm_thread;
+extern TX_THREAD            tx_radio_thread;
 extern TX_THREAD            tx_app_thread;
 
 
@@ -50,7 +50,7 @@
 /*#define HAL_GFXMMU_MODULE_ENABLED */
 /*#define HAL_GPU2D_MODULE_ENABLED */
 /*#define HAL_GTZC_MODULE_ENABLED */
-/*#define HAL_HASH_MODULE_ENABLED */
+#define HAL_HASH_MODULE_ENABLED
 /*#define HAL_HRTIM_MODULE_ENABLED */
 /*#define HAL_IRDA_MODULE_ENABLED */
 #define HAL_IWDG_MODULE_ENABLED
@@ -39,6 +39,7 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
 
 #include "lr11xx_hal.h"
 #include "smtc_hal_gpio.h"
@@ -112,17 +113,13 @@ lr11xx_hal_status_t lr11xx_hal_write( const void* context, const uint8_t* comman
 
 #if defined( NRF52840_XXAA )
     hal_spi_in_out( RADIO_SPI_ID, command, command_length, NULL, 0 );
-    hal_spi_in_out( RADIO_SPI_ID, data, data_length, NULL, 0 );
 #else
     for( uint16_t i = 0; i < command_length; i++ )
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data[i] );
-    }
 #endif
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
     // Add crc byte at the end of the transaction
@@ -205,14 +202,7 @@ lr11xx_hal_status_t lr11xx_hal_read( const void* context, const uint8_t* command
 #endif
 #endif
 
-#if defined( NRF52840_XXAA )
-        hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
-#else
-        for( uint16_t i = 0; i < data_length; i++ )
-        {
-            data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-        }
-#endif
+        hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
         // read crc sent by lr11xx at the end of the transaction
@@ -248,14 +238,7 @@ lr11xx_hal_status_t lr11xx_hal_direct_read( const void* context, uint8_t* data,
     // Put NSS low to start spi transaction
     hal_gpio_set_value( RADIO_NSS, 0 );
 
-#if defined( NRF52840_XXAA )
-    hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
-#else
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-    }
-#endif
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
     // read crc sent by lr11xx by sending one more NOP
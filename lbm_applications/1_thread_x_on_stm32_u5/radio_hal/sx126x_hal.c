@@ -39,6 +39,7 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
 
 #include "sx126x_hal.h"
 
@@ -106,17 +107,13 @@ sx126x_hal_status_t sx126x_hal_write( const void* context, const uint8_t* comman
     hal_gpio_set_value( RADIO_NSS, 0 );
 #if defined( NRF52840_XXAA )
     hal_spi_in_out( RADIO_SPI_ID, command, command_length, NULL, 0 );
-    hal_spi_in_out( RADIO_SPI_ID, data, data_length, NULL, 0 );
 #else
     for( uint16_t i = 0; i < command_length; i++ )
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data[i] );
-    }
 #endif
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
 
@@ -143,17 +140,13 @@ sx126x_hal_status_t sx126x_hal_read( const void* context, const uint8_t* command
 
 #if defined( NRF52840_XXAA )
     hal_spi_in_out( RADIO_SPI_ID, command, command_length, NULL, 0 );
-    hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
 #else
     for( uint16_t i = 0; i < command_length; i++ )
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-    }
 #endif
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
 
@@ -0,0 +1,146 @@
+/*!
+ * \file      smtc_hal_hash.c
+ *
+ * \brief     Hash accelerator Hardware Abstraction Layer implementation
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "stm32u5xx_hal.h"
+#include "smtc_hal_hash.h"
+
+#include "smtc_hal_mcu.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define HAL_HASH_TIMEOUT_MS ( 100 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static HASH_HandleTypeDef hash_handle;
+
+// last buffer, fed to the peripheral with the digest computation
+static const uint8_t* hash_tail;
+static uint32_t       hash_tail_len;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void hal_hash_sha256_start( void )
+{
+    hash_handle.Init.DataType = HASH_DATATYPE_8B;
+    hash_handle.Init.KeySize  = 0;
+    hash_handle.Init.pKey     = NULL;
+
+    if( HAL_HASH_Init( &hash_handle ) != HAL_OK )
+    {
+        mcu_panic( "HASH INIT" );
+    }
+    hash_tail     = NULL;
+    hash_tail_len = 0;
+}
+
+void hal_hash_sha256_update( const uint8_t* data, uint32_t len )
+{
+    if( ( len & 3 ) != 0 )
+    {
+        // the peripheral only takes whole words before the last buffer
+        hash_tail     = data;
+        hash_tail_len = len;
+        return;
+    }
+    if( HAL_HASHEx_SHA256_Accmlt( &hash_handle, ( uint8_t* ) data, len ) != HAL_OK )
+    {
+        mcu_panic( "HASH UPDATE" );
+    }
+}
+
+void hal_hash_sha256_finish( uint8_t* digest )
+{
+    static uint8_t empty;
+
+    if( HAL_HASHEx_SHA256_Accmlt_End( &hash_handle, ( uint8_t* ) ( ( hash_tail != NULL ) ? hash_tail : &empty ),
+                                      hash_tail_len, digest, HAL_HASH_TIMEOUT_MS ) != HAL_OK )
+    {
+        mcu_panic( "HASH FINISH" );
+    }
+    HAL_HASH_DeInit( &hash_handle );
+}
+
+void HAL_HASH_MspInit( HASH_HandleTypeDef* hhash )
+{
+    // HASH Peripheral clock enable
+    __HAL_RCC_HASH_CLK_ENABLE( );
+}
+
+void HAL_HASH_MspDeInit( HASH_HandleTypeDef* hhash )
+{
+    __HAL_RCC_HASH_FORCE_RESET( );
+    __HAL_RCC_HASH_RELEASE_RESET( );
+
+    __HAL_RCC_HASH_CLK_DISABLE( );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
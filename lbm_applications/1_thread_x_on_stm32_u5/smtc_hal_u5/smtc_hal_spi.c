@@ -43,6 +43,8 @@
 #include "smtc_hal_spi.h"
 #include "stm32u5xx_hal.h"
 #include "stm32u5xx_ll_spi.h"
+#include "stm32u5xx_ll_dma.h"
+#include "stm32u5xx_ll_bus.h"
 #include "stm32u5xx_hal_rcc_ex.h"
 #include "stm32u5xx_hal_spi_ex.h"
 
@@ -59,6 +61,12 @@
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 
+/*!
+ * GPDMA1 channels used for the SPI1 buffer transfers, channel 1 is used by the uart rx
+ */
+#define SPI_DMA_RX_CHANNEL LL_DMA_CHANNEL_2
+#define SPI_DMA_TX_CHANNEL LL_DMA_CHANNEL_3
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -127,7 +135,7 @@ void hal_spi_init( const uint32_t id, const hal_gpio_pin_names_t mosi, const hal
     spi_periph[local_id].handle.Init.MasterSSIdleness        = SPI_MASTER_SS_IDLENESS_00CYCLE;
     spi_periph[local_id].handle.Init.MasterInterDataIdleness = SPI_MASTER_INTERDATA_IDLENESS_00CYCLE;
     spi_periph[local_id].handle.Init.MasterReceiverAutoSusp  = SPI_MASTER_RX_AUTOSUSP_DISABLE;
-    spi_periph[local_id].handle.Init.MasterKeepIOState       = SPI_MASTER_KEEP_IO_STATE_DISABLE;
+    spi_periph[local_id].handle.Init.MasterKeepIOState       = SPI_MASTER_KEEP_IO_STATE_ENABLE;
     spi_periph[local_id].handle.Init.IOSwap                  = SPI_IO_SWAP_DISABLE;
     spi_periph[local_id].handle.Init.ReadyMasterManagement   = SPI_RDY_MASTER_MANAGEMENT_INTERNALLY;
     spi_periph[local_id].handle.Init.ReadyPolarity           = SPI_RDY_POLARITY_HIGH;
@@ -184,6 +192,87 @@ uint16_t hal_spi_in_out( const uint32_t id, const uint16_t out_data )
     return LL_SPI_ReceiveData8( spi_periph[local_id].interface );
 }
 
+void hal_spi_transfer_dma( const uint32_t id, const uint8_t* tx_buffer, uint8_t* rx_buffer, const uint16_t length )
+{
+    assert_param( ( id > 0 ) && ( ( id - 1 ) < sizeof( spi_periph ) ) );
+    uint32_t local_id = id - 1;
+
+    // Short transfers are faster byte per byte than with the DMA setup
+    if( length < HAL_SPI_DMA_MIN_LENGTH )
+    {
+        for( uint16_t i = 0; i < length; i++ )
+        {
+            const uint8_t rx_data = hal_spi_in_out( id, ( tx_buffer != NULL ) ? tx_buffer[i] : 0x00 );
+            if( rx_buffer != NULL )
+            {
+                rx_buffer[i] = rx_data;
+            }
+        }
+        return;
+    }
+
+    SPI_TypeDef*  spi     = spi_periph[local_id].interface;
+    const uint8_t tx_none = 0x00;
+    uint8_t       rx_none;
+
+    // GPDMA1 clock may have been stopped by the uart de-init
+    LL_AHB1_GRP1_EnableClock( LL_AHB1_GRP1_PERIPH_GPDMA1 );
+
+    // Rx channel, without buffer the DMA keeps on receiving in the same dummy byte
+    LL_DMA_ConfigTransfer( GPDMA1, SPI_DMA_RX_CHANNEL,
+                           LL_DMA_SRC_FIXED | LL_DMA_SRC_DATAWIDTH_BYTE | LL_DMA_SRC_ALLOCATED_PORT0 |
+                               ( ( rx_buffer != NULL ) ? LL_DMA_DEST_INCREMENT : LL_DMA_DEST_FIXED ) |
+                               LL_DMA_DEST_DATAWIDTH_BYTE | LL_DMA_DEST_ALLOCATED_PORT1 );
+    LL_DMA_SetDataTransferDirection( GPDMA1, SPI_DMA_RX_CHANNEL, LL_DMA_DIRECTION_PERIPH_TO_MEMORY );
+    LL_DMA_SetBlkHWRequest( GPDMA1, SPI_DMA_RX_CHANNEL, LL_DMA_HWREQUEST_SINGLEBURST );
+    LL_DMA_SetPeriphRequest( GPDMA1, SPI_DMA_RX_CHANNEL, LL_GPDMA1_REQUEST_SPI1_RX );
+    LL_DMA_ConfigAddresses( GPDMA1, SPI_DMA_RX_CHANNEL, LL_SPI_DMA_GetRxRegAddr( spi ),
+                            ( rx_buffer != NULL ) ? ( uint32_t ) rx_buffer : ( uint32_t ) &rx_none );
+    LL_DMA_SetBlkDataLength( GPDMA1, SPI_DMA_RX_CHANNEL, length );
+
+    // Tx channel, without buffer the DMA keeps on sending the same dummy byte
+    LL_DMA_ConfigTransfer( GPDMA1, SPI_DMA_TX_CHANNEL,
+                           ( ( tx_buffer != NULL ) ? LL_DMA_SRC_INCREMENT : LL_DMA_SRC_FIXED ) |
+                               LL_DMA_SRC_DATAWIDTH_BYTE | LL_DMA_SRC_ALLOCATED_PORT1 | LL_DMA_DEST_FIXED |
+                               LL_DMA_DEST_DATAWIDTH_BYTE | LL_DMA_DEST_ALLOCATED_PORT0 );
+    LL_DMA_SetDataTransferDirection( GPDMA1, SPI_DMA_TX_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_PERIPH );
+    LL_DMA_SetBlkHWRequest( GPDMA1, SPI_DMA_TX_CHANNEL, LL_DMA_HWREQUEST_SINGLEBURST );
+    LL_DMA_SetPeriphRequest( GPDMA1, SPI_DMA_TX_CHANNEL, LL_GPDMA1_REQUEST_SPI1_TX );
+    LL_DMA_ConfigAddresses( GPDMA1, SPI_DMA_TX_CHANNEL,
+                            ( tx_buffer != NULL ) ? ( uint32_t ) tx_buffer : ( uint32_t ) &tx_none,
+                            LL_SPI_DMA_GetTxRegAddr( spi ) );
+    LL_DMA_SetBlkDataLength( GPDMA1, SPI_DMA_TX_CHANNEL, length );
+
+    // The transfer size and the dma requests can only be changed while the SPI is disabled (the master keeps its io
+    // state meanwhile)
+    LL_SPI_Disable( spi );
+    LL_SPI_SetTransferSize( spi, length );
+    LL_SPI_EnableDMAReq_RX( spi );
+    LL_DMA_EnableChannel( GPDMA1, SPI_DMA_RX_CHANNEL );
+    LL_DMA_EnableChannel( GPDMA1, SPI_DMA_TX_CHANNEL );
+    LL_SPI_EnableDMAReq_TX( spi );
+    LL_SPI_Enable( spi );
+    LL_SPI_StartMasterTransfer( spi );
+
+    while( LL_SPI_IsActiveFlag_EOT( spi ) == 0 )
+    {
+    };
+    while( LL_DMA_IsActiveFlag_TC( GPDMA1, SPI_DMA_RX_CHANNEL ) == 0 )
+    {
+    };
+    LL_DMA_ClearFlag_TC( GPDMA1, SPI_DMA_RX_CHANNEL );
+    LL_DMA_ClearFlag_TC( GPDMA1, SPI_DMA_TX_CHANNEL );
+
+    // Back to the endless transfer mode used by hal_spi_in_out
+    LL_SPI_ClearFlag_EOT( spi );
+    LL_SPI_ClearFlag_TXTF( spi );
+    LL_SPI_Disable( spi );
+    LL_SPI_DisableDMAReq_TX( spi );
+    LL_SPI_DisableDMAReq_RX( spi );
+    LL_SPI_SetTransferSize( spi, 0 );
+    LL_SPI_Enable( spi );
+}
+
 void HAL_SPI_MspInit( SPI_HandleTypeDef* spiHandle )
 {
     if( spiHandle->Instance == spi_periph[0].interface )
@@ -47,6 +47,7 @@
 #include "smtc_hal_lp_timer.h"
 #include "smtc_hal_mcu.h"
 #include "smtc_hal_rng.h"
+#include "smtc_hal_hash.h"
 #include "smtc_hal_rtc.h"
 #include "smtc_hal_trace.h"
 #include "smtc_hal_uart.h"
@@ -138,6 +139,16 @@ void smtc_modem_hal_user_lbm_irq(void)
 {
     threadx_user_lbm_irq();
 }
+
+void smtc_modem_hal_lock_modem(void)
+{
+    threadx_lock_modem();
+}
+
+void smtc_modem_hal_unlock_modem(void)
+{
+    threadx_unlock_modem();
+}
 /* ------------ Timer management ------------*/
 
 void smtc_modem_hal_start_timer(const uint32_t milliseconds, void (*callback)(void *context), void *context)
@@ -428,6 +439,12 @@ uint8_t smtc_modem_hal_get_fw_delete_status_for_fuota(uint32_t fw_to_delete_vers
         return 0;
     }
 }
+
+const uint8_t *smtc_modem_hal_get_fuota_area_mapped_address(void)
+{
+    // The internal flash is memory mapped
+    return (const uint8_t *)ADDR_FLASH_FUOTA;
+}
 #endif // USE_FUOTA
 
 /* ------------ Needed for Cloud  ------------*/
@@ -455,6 +472,25 @@ uint16_t smtc_modem_hal_flash_get_page_size()
     return hal_flash_get_page_size();
 }
 
+/* ------------ Needed for LFU hardware hash  ------------*/
+
+#if defined(USE_LFU_HW_HASH)
+void smtc_modem_hal_sha256_start(void)
+{
+    hal_hash_sha256_start();
+}
+
+void smtc_modem_hal_sha256_update(const uint8_t *data, uint32_t len)
+{
+    hal_hash_sha256_update(data, len);
+}
+
+void smtc_modem_hal_sha256_finish(uint8_t *digest)
+{
+    hal_hash_sha256_finish(digest);
+}
+#endif // USE_LFU_HW_HASH
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -75,7 +75,7 @@ COMMON_C_DEFS += \
 	-DUSE_LR11XX_CRC_OVER_SPI
 endif
 
-ifneq ($(CRYPTO),SOFT)
+ifeq ($(filter $(CRYPTO),SOFT SOFT_FAST MCU_HW),)
 COMMON_C_DEFS += \
 	-DUSE_LR11XX_CRYPTO
 endif
@@ -34,6 +34,9 @@ APP_TRACE ?= yes
 # LR11xx option to use crc
 USE_LR11XX_CRC_SPI ?= no
 
+# SX126x option to start the radio spi transfers on the busy falling edge through PPI
+RADIO_BUSY_PPI ?= no
+
 #-----------------------------------------------------------------------------
 # LBM options management
 #-----------------------------------------------------------------------------
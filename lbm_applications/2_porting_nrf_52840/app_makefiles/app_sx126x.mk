@@ -50,3 +50,8 @@ ifeq ($(TARGET_RADIO),sx1268)
 COMMON_C_DEFS += \
     -DSX1268
 endif
+
+ifeq ($(RADIO_BUSY_PPI),yes)
+COMMON_C_DEFS += \
+    -DUSE_RADIO_BUSY_PPI
+endif
@@ -112,18 +112,7 @@ lr11xx_hal_status_t lr11xx_hal_write( const void* context, const uint8_t* comman
 
     hal_spi_in_out( RADIO_SPI_ID, command, command_length, NULL, 0 );
     // data write to the radio could be more than 255 bytes but not more than 512 bytes
-    if( data_length > 255 )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data, 255, NULL, 0 );
-        hal_spi_in_out( RADIO_SPI_ID, &data[255], data_length - 255, NULL, 0 );
-    }
-    else
-    {
-        if( data_length > 0 )
-        {
-            hal_spi_in_out( RADIO_SPI_ID, data, data_length, NULL, 0 );
-        }
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
     // Add crc byte at the end of the transaction
@@ -180,15 +169,7 @@ lr11xx_hal_status_t lr11xx_hal_read( const void* context, const uint8_t* command
         hal_spi_in_out( RADIO_SPI_ID, 0, 0, NULL, 0 );
 #endif
         // data read from the radio could be more than 255 bytes but not more than 512 bytes
-        if( data_length > 255 )
-        {
-            hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, 255 );
-            hal_spi_in_out( RADIO_SPI_ID, 0, 0, &data[255], data_length - 255 );
-        }
-        else
-        {
-            hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
-        }
+        hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
         // read crc sent by lr11xx at the end of the transaction
@@ -221,15 +202,7 @@ lr11xx_hal_status_t lr11xx_hal_direct_read( const void* context, uint8_t* data,
     hal_gpio_set_value( RADIO_NSS, 0 );
 
     // data read from the radio could be more than 255 bytes but not more than 512 bytes
-    if( data_length > 255 )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, 255 );
-        hal_spi_in_out( RADIO_SPI_ID, 0, 0, &data[255], data_length - 255 );
-    }
-    else
-    {
-        hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
     // read crc sent by lr11xx by sending one more NOP
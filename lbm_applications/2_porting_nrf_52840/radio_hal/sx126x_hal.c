@@ -39,6 +39,7 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <string.h>   // memcpy
 
 #include "sx126x_hal.h"
 
@@ -57,6 +58,13 @@
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 
+#if defined( USE_RADIO_BUSY_PPI )
+/**
+ * @brief Longest radio transaction: ReadBuffer opcode, offset and NOP bytes followed by a 255 bytes payload
+ */
+#define SX126X_HAL_TRANSFER_MAX_LENGTH ( 3 + 255 )
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -76,15 +84,23 @@ typedef enum
 // This variable will hold the current sleep status of the radio
 static radio_sleep_mode_t radio_mode = RADIO_AWAKE;
 
+#if defined( USE_RADIO_BUSY_PPI )
+// Command and data of a transaction, sent in a single transfer started by the busy falling edge
+static uint8_t sx126x_hal_tx_buffer[SX126X_HAL_TRANSFER_MAX_LENGTH];
+static uint8_t sx126x_hal_rx_buffer[SX126X_HAL_TRANSFER_MAX_LENGTH];
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+#if !defined( USE_RADIO_BUSY_PPI )
 /**
  * @brief Wait until radio busy pin returns to 0
  */
 static void sx126x_hal_wait_on_busy( void );
+#endif
 
 /**
  * @brief Check if device is ready to receive spi transaction.
@@ -100,13 +116,36 @@ static void sx126x_hal_check_device_ready( void );
 sx126x_hal_status_t sx126x_hal_write( const void* context, const uint8_t* command, const uint16_t command_length,
                                       const uint8_t* data, const uint16_t data_length )
 {
+#if defined( USE_RADIO_BUSY_PPI )
+    if( ( command_length + data_length ) > SX126X_HAL_TRANSFER_MAX_LENGTH )
+    {
+        return SX126X_HAL_STATUS_ERROR;
+    }
+
+    sx126x_hal_check_device_ready( );
+
+    // The previous transfer may still wait for the busy falling edge in the tx buffer
+    hal_spi_wait_transfer_end( RADIO_SPI_ID );
+    memcpy( sx126x_hal_tx_buffer, command, command_length );
+    memcpy( &sx126x_hal_tx_buffer[command_length], data, data_length );
+
+    // The write is not waited for: it starts when the radio has processed the previous command, and the next
+    // read/write sleeps until its end
+    hal_spi_transfer_on_busy_low( RADIO_SPI_ID, sx126x_hal_tx_buffer, command_length + data_length, NULL, 0 );
+
+    // 0x84 - SX126x_SET_SLEEP opcode
+    if( command[0] == 0x84 )
+    {
+        radio_mode = RADIO_SLEEP;
+    }
+#else
     sx126x_hal_check_device_ready( );
 
     // Put NSS low to start spi transaction
     hal_gpio_set_value( RADIO_NSS, 0 );
 
     hal_spi_in_out( RADIO_SPI_ID, command, command_length, NULL, 0 );
-    hal_spi_in_out( RADIO_SPI_ID, data, data_length, NULL, 0 );
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
 
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
@@ -120,6 +159,7 @@ sx126x_hal_status_t sx126x_hal_write( const void* context, const uint8_t* comman
     {
         radio_mode = RADIO_SLEEP;
     }
+#endif
 
     return SX126X_HAL_STATUS_OK;
 }
@@ -127,6 +167,23 @@ sx126x_hal_status_t sx126x_hal_write( const void* context, const uint8_t* comman
 sx126x_hal_status_t sx126x_hal_read( const void* context, const uint8_t* command, const uint16_t command_length,
                                      uint8_t* data, const uint16_t data_length )
 {
+#if defined( USE_RADIO_BUSY_PPI )
+    if( ( command_length + data_length ) > SX126X_HAL_TRANSFER_MAX_LENGTH )
+    {
+        return SX126X_HAL_STATUS_ERROR;
+    }
+
+    sx126x_hal_check_device_ready( );
+
+    hal_spi_wait_transfer_end( RADIO_SPI_ID );
+    memcpy( sx126x_hal_tx_buffer, command, command_length );
+
+    // The MCU sleeps while the radio is busy and during the transfer
+    hal_spi_transfer_on_busy_low( RADIO_SPI_ID, sx126x_hal_tx_buffer, command_length, sx126x_hal_rx_buffer,
+                                  command_length + data_length );
+    hal_spi_wait_transfer_end( RADIO_SPI_ID );
+    memcpy( data, &sx126x_hal_rx_buffer[command_length], data_length );
+#else
     sx126x_hal_check_device_ready( );
 
     // Put NSS low to start spi transaction
@@ -135,16 +192,20 @@ sx126x_hal_status_t sx126x_hal_read( const void* context, const uint8_t* command
 
     if( data_length > 0 )
     {
-        hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
+        hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
     }
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
+#endif
 
     return SX126X_HAL_STATUS_OK;
 }
 
 sx126x_hal_status_t sx126x_hal_reset( const void* context )
 {
+#if defined( USE_RADIO_BUSY_PPI )
+    hal_spi_wait_transfer_end( RADIO_SPI_ID );
+#endif
     hal_gpio_set_value( RADIO_NRST, 0 );
     hal_mcu_wait_us( 5000 );
     hal_gpio_set_value( RADIO_NRST, 1 );
@@ -164,15 +225,28 @@ sx126x_hal_status_t sx126x_hal_wakeup( const void* context )
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+#if !defined( USE_RADIO_BUSY_PPI )
 static void sx126x_hal_wait_on_busy( void )
 {
     while( hal_gpio_get_value( RADIO_BUSY_PIN ) == 1 )
     {
     };
 }
+#endif
 
 static void sx126x_hal_check_device_ready( void )
 {
+#if defined( USE_RADIO_BUSY_PPI )
+    // Busy is waited for by the PPI, only a sleeping radio needs a NSS falling edge to wake up. The GetStatus command
+    // is ignored by the waking radio.
+    static uint8_t get_status[2] = { 0xC0, 0x00 };
+
+    if( radio_mode == RADIO_SLEEP )
+    {
+        hal_spi_transfer_dma( RADIO_SPI_ID, get_status, NULL, sizeof( get_status ) );
+        radio_mode = RADIO_AWAKE;
+    }
+#else
     if( radio_mode != RADIO_SLEEP )
     {
         sx126x_hal_wait_on_busy( );
@@ -185,4 +259,5 @@ static void sx126x_hal_check_device_ready( void )
         hal_gpio_set_value( RADIO_NSS, 1 );
         radio_mode = RADIO_AWAKE;
     }
+#endif
 }
\ No newline at end of file
@@ -105,7 +105,7 @@ sx128x_hal_status_t sx128x_hal_write( const void* context, const uint8_t* comman
     hal_gpio_set_value( RADIO_NSS, 0 );
 
     hal_spi_in_out( RADIO_SPI_ID, command, command_length, NULL, 0 );
-    hal_spi_in_out( RADIO_SPI_ID, data, data_length, NULL, 0 );
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
 
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
@@ -134,7 +134,7 @@ sx128x_hal_status_t sx128x_hal_read( const void* context, const uint8_t* command
 
     if( data_length > 0 )
     {
-        hal_spi_in_out( RADIO_SPI_ID, 0, 0, data, data_length );
+        hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
     }
 
     // Put NSS high as the spi transaction is finished
@@ -0,0 +1,158 @@
+/*!
+ * \file      smtc_hal_aes.c
+ *
+ * \brief     AES ECB peripheral Hardware Abstraction Layer implementation
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2025. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memcpy
+
+#include "nrf.h"
+#include "nrf_ecb.h"
+
+#include "smtc_hal_aes.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#define AES_BLOCK_SIZE 16
+
+/**
+ * @brief Number of attempts for one block: the ECB job is aborted when the radio CCM/AAR peripherals need the AES core
+ */
+#define AES_ECB_NB_ATTEMPTS 3
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief ECBDATAPTR memory layout expected by the peripheral
+ */
+typedef struct hal_aes_ecb_data_s
+{
+    uint8_t key[AES_BLOCK_SIZE];
+    uint8_t cleartext[AES_BLOCK_SIZE];
+    uint8_t ciphertext[AES_BLOCK_SIZE];
+} hal_aes_ecb_data_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+// Read by the peripheral EasyDMA: must be in RAM
+static hal_aes_ecb_data_t hal_aes_ecb_data;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Runs one ECB job on the block already copied in the cleartext field
+ *
+ * @return bool True if the ciphertext field holds the encrypted block
+ */
+static bool aes_ecb_run_block( void );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+bool hal_aes_ecb_encrypt( const uint8_t key[16], const uint8_t* input, uint8_t* output, uint16_t nb_blocks )
+{
+    bool status = true;
+
+    memcpy( hal_aes_ecb_data.key, key, AES_BLOCK_SIZE );
+    nrf_ecb_data_pointer_set( NRF_ECB, &hal_aes_ecb_data );
+
+    for( uint16_t i = 0; ( i < nb_blocks ) && ( status == true ); i++ )
+    {
+        memcpy( hal_aes_ecb_data.cleartext, &input[i * AES_BLOCK_SIZE], AES_BLOCK_SIZE );
+
+        status = aes_ecb_run_block( );
+
+        memcpy( &output[i * AES_BLOCK_SIZE], hal_aes_ecb_data.ciphertext, AES_BLOCK_SIZE );
+    }
+
+    // Do not leave the session key nor the keystream in the shared buffer
+    memset( &hal_aes_ecb_data, 0, sizeof( hal_aes_ecb_data ) );
+
+    return status;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static bool aes_ecb_run_block( void )
+{
+    for( uint8_t attempt = 0; attempt < AES_ECB_NB_ATTEMPTS; attempt++ )
+    {
+        nrf_ecb_event_clear( NRF_ECB, NRF_ECB_EVENT_ENDECB );
+        nrf_ecb_event_clear( NRF_ECB, NRF_ECB_EVENT_ERRORECB );
+        nrf_ecb_task_trigger( NRF_ECB, NRF_ECB_TASK_STARTECB );
+
+        // About 7 us per block at 16 MHz AES clock
+        while( ( nrf_ecb_event_check( NRF_ECB, NRF_ECB_EVENT_ENDECB ) == false ) &&
+               ( nrf_ecb_event_check( NRF_ECB, NRF_ECB_EVENT_ERRORECB ) == false ) )
+        {
+        }
+
+        if( nrf_ecb_event_check( NRF_ECB, NRF_ECB_EVENT_ENDECB ) == true )
+        {
+            nrf_ecb_event_clear( NRF_ECB, NRF_ECB_EVENT_ENDECB );
+            return true;
+        }
+    }
+
+    nrf_ecb_event_clear( NRF_ECB, NRF_ECB_EVENT_ERRORECB );
+    return false;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
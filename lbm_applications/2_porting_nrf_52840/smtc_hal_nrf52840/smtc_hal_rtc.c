@@ -44,6 +44,7 @@
 #include "nrf_drv_rtc.h"
 
 #include "smtc_hal_rtc.h"
+#include "smtc_hal_mcu.h"
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE MACROS-----------------------------------------------------------
@@ -51,6 +52,16 @@
 
 #define SMTC_RTC_MS_TO_TICKS( ms, freq ) ( ( ( ms ) * ( freq ) ) / 1000UL )
 
+/**
+ * @brief Minimum distance from the counter for a compare value to generate its event
+ */
+#define SMTC_RTC_MIN_CC_DELTA 2
+
+/**
+ * @brief The RTC counter is 24-bit wide
+ */
+#define SMTC_RTC_COUNTER_MASK 0x00FFFFFFUL
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -62,10 +73,12 @@
  */
 static nrf_drv_rtc_t      rtc1             = NRFX_RTC_INSTANCE( 1 );
 static uint32_t           rtc_wrap_counter = 0;
-static hal_lp_timer_irq_t lptim_tmr_irq[2] = { [NRFX_RTC_INT_COMPARE0].context  = NULL,
+static hal_lp_timer_irq_t lptim_tmr_irq[3] = { [NRFX_RTC_INT_COMPARE0].context  = NULL,
                                                [NRFX_RTC_INT_COMPARE0].callback = NULL,
                                                [NRFX_RTC_INT_COMPARE1].context  = NULL,
-                                               [NRFX_RTC_INT_COMPARE1].callback = NULL };
+                                               [NRFX_RTC_INT_COMPARE1].callback = NULL,
+                                               [NRFX_RTC_INT_COMPARE2].context  = NULL,
+                                               [NRFX_RTC_INT_COMPARE2].callback = NULL };
 
 /*
  * -----------------------------------------------------------------------------
@@ -78,6 +91,7 @@ static hal_lp_timer_irq_t lptim_tmr_irq[2] = { [NRFX_RTC_INT_COMPARE0].context
  */
 
 static void rtc_handler1( nrf_drv_rtc_int_type_t int_type );
+static uint64_t rtc_get_ticks( void );
 static void rtc_wakeup_handler( void* obj );
 
 static void lfclk_config( void );
@@ -95,34 +109,45 @@ void hal_rtc_init( void )
     rtc_config( );
 }
 
-// The RTC module features a 24-bit COUNTER,
+// The RTC module features a 24-bit COUNTER, extended with the overflow counter
 uint32_t hal_rtc_get_time_s( void )
 {
-    uint32_t tmp_rtc = nrf_drv_rtc_counter_get( &rtc1 );
-    uint64_t tmp     = ( ( uint64_t ) ( tmp_rtc ) + ( uint64_t ) ( ( 1ULL << 24 ) * ( uint64_t ) rtc_wrap_counter ) ) /
-                   NRFX_RTC_DEFAULT_CONFIG_FREQUENCY;
-    return ( uint32_t ) tmp;
+    return ( uint32_t ) ( rtc_get_ticks( ) / NRFX_RTC_DEFAULT_CONFIG_FREQUENCY );
 }
 
 uint32_t hal_rtc_get_time_ms( void )
 {
-    uint32_t tmp_rtc = nrf_drv_rtc_counter_get( &rtc1 );
-    uint64_t tmp =
-        ( ( ( uint64_t ) ( tmp_rtc ) + ( uint64_t ) ( ( 1ULL << 24 ) * ( uint64_t ) rtc_wrap_counter ) ) * 1000 ) /
-        NRFX_RTC_DEFAULT_CONFIG_FREQUENCY;
-    return ( uint32_t ) tmp;
+    return ( uint32_t ) ( ( rtc_get_ticks( ) * 1000 ) / NRFX_RTC_DEFAULT_CONFIG_FREQUENCY );
+}
+
+uint32_t hal_rtc_get_time_us( void )
+{
+    return ( uint32_t ) ( ( rtc_get_ticks( ) * 1000000 ) / NRFX_RTC_DEFAULT_CONFIG_FREQUENCY );
 }
 
 void hal_lp_timer_start( const uint32_t milliseconds, const hal_lp_timer_irq_t* tmr_irq )
 {
-    uint32_t tmp_rtc = nrf_drv_rtc_counter_get( &rtc1 );
-    // Setup RTC to fire during the next period
-    nrfx_err_t err_code =
-        nrfx_rtc_cc_set( &rtc1, NRFX_RTC_INT_COMPARE0,
-                         SMTC_RTC_MS_TO_TICKS( milliseconds, NRFX_RTC_DEFAULT_CONFIG_FREQUENCY ) + tmp_rtc, true );
-    APP_ERROR_CHECK( err_code );
+    uint32_t mask;
 
     lptim_tmr_irq[NRFX_RTC_INT_COMPARE0] = *tmr_irq;
+
+    hal_mcu_critical_section_begin( &mask );
+
+    // The expiry is the first RTC tick (30.5 us) at or after the millisecond of the time base that is milliseconds
+    // away, instead of a whole number of milliseconds counted from the current tick: the timer neither fires early
+    // nor accumulates the truncation of the current time.
+    const uint64_t now_ticks = rtc_get_ticks( );
+    const uint64_t expiry_ms = ( ( now_ticks * 1000 ) / NRFX_RTC_DEFAULT_CONFIG_FREQUENCY ) + milliseconds;
+    uint64_t       expiry_ticks = ( ( expiry_ms * NRFX_RTC_DEFAULT_CONFIG_FREQUENCY ) + 999 ) / 1000;
+
+    if( expiry_ticks < ( now_ticks + SMTC_RTC_MIN_CC_DELTA ) )
+    {
+        expiry_ticks = now_ticks + SMTC_RTC_MIN_CC_DELTA;
+    }
+    APP_ERROR_CHECK( nrfx_rtc_cc_set( &rtc1, NRFX_RTC_INT_COMPARE0, ( uint32_t ) expiry_ticks & SMTC_RTC_COUNTER_MASK,
+                                      true ) );
+
+    hal_mcu_critical_section_end( &mask );
 }
 
 void hal_lp_timer_stop( void )
@@ -130,6 +155,30 @@ void hal_lp_timer_stop( void )
     nrfx_rtc_cc_disable( &rtc1, NRFX_RTC_INT_COMPARE0 );
 }
 
+void hal_rtc_trigger_timer_start( const uint32_t delay_us, const hal_lp_timer_irq_t* tmr_irq )
+{
+    uint32_t mask;
+    uint32_t ticks = ( uint32_t ) ( ( ( ( uint64_t ) delay_us * NRFX_RTC_DEFAULT_CONFIG_FREQUENCY ) + 500000 ) /
+                                    1000000 );
+
+    if( ticks < SMTC_RTC_MIN_CC_DELTA )
+    {
+        ticks = SMTC_RTC_MIN_CC_DELTA;
+    }
+
+    lptim_tmr_irq[NRFX_RTC_INT_COMPARE2] = *tmr_irq;
+
+    hal_mcu_critical_section_begin( &mask );
+    APP_ERROR_CHECK( nrfx_rtc_cc_set( &rtc1, NRFX_RTC_INT_COMPARE2,
+                                      ( nrf_drv_rtc_counter_get( &rtc1 ) + ticks ) & SMTC_RTC_COUNTER_MASK, true ) );
+    hal_mcu_critical_section_end( &mask );
+}
+
+void hal_rtc_trigger_timer_stop( void )
+{
+    nrfx_rtc_cc_disable( &rtc1, NRFX_RTC_INT_COMPARE2 );
+}
+
 void hal_lp_timer_irq_enable( void )
 {
     NVIC_EnableIRQ( RTC1_IRQn );
@@ -145,12 +194,19 @@ void hal_lp_timer_irq_disable( void )
 
 void hal_rtc_wakeup_timer_set_ms( const int32_t milliseconds )
 {
-    uint32_t tmp_rtc = nrf_drv_rtc_counter_get( &rtc1 );
+    uint32_t mask;
+    uint32_t ticks = SMTC_RTC_MS_TO_TICKS( milliseconds, NRFX_RTC_DEFAULT_CONFIG_FREQUENCY );
+
+    if( ticks < SMTC_RTC_MIN_CC_DELTA )
+    {
+        ticks = SMTC_RTC_MIN_CC_DELTA;
+    }
+
     // Setup RTC to fire during the next period
-    nrfx_err_t err_code =
-        nrfx_rtc_cc_set( &rtc1, NRFX_RTC_INT_COMPARE1,
-                         SMTC_RTC_MS_TO_TICKS( milliseconds, NRFX_RTC_DEFAULT_CONFIG_FREQUENCY ) + tmp_rtc, true );
-    APP_ERROR_CHECK( err_code );
+    hal_mcu_critical_section_begin( &mask );
+    APP_ERROR_CHECK( nrfx_rtc_cc_set( &rtc1, NRFX_RTC_INT_COMPARE1,
+                                      ( nrf_drv_rtc_counter_get( &rtc1 ) + ticks ) & SMTC_RTC_COUNTER_MASK, true ) );
+    hal_mcu_critical_section_end( &mask );
 }
 
 /*
@@ -185,10 +241,12 @@ static void rtc_config( void )
     uint32_t err_code;
 
     // Initialize RTC instance
+    // Compare values are always set at least SMTC_RTC_MIN_CC_DELTA ticks ahead with the interrupts masked, the
+    // reliable mode latency check is not needed
     nrf_drv_rtc_config_t config = { .prescaler          = 0,
                                     .interrupt_priority = 6,
-                                    .tick_latency = ( ( ( 2000 ) * ( NRFX_RTC_DEFAULT_CONFIG_FREQUENCY ) ) / 1000000U ),
-                                    .reliable     = true };
+                                    .tick_latency       = 0,
+                                    .reliable           = false };
 
     err_code = nrfx_rtc_init( &rtc1, &config, rtc_handler1 );
     APP_ERROR_CHECK( err_code );
@@ -224,6 +282,34 @@ static void rtc_handler1( nrf_drv_rtc_int_type_t int_type )
             lptim_tmr_irq[int_type].callback( lptim_tmr_irq[int_type].context );
         }
     }
+    else if( int_type == NRFX_RTC_INT_COMPARE2 )
+    {
+        hal_rtc_trigger_timer_stop( );
+        if( lptim_tmr_irq[int_type].callback != NULL )
+        {
+            lptim_tmr_irq[int_type].callback( lptim_tmr_irq[int_type].context );
+        }
+    }
+}
+
+static uint64_t rtc_get_ticks( void )
+{
+    uint32_t mask;
+    uint32_t wrap_counter;
+    uint32_t counter;
+
+    hal_mcu_critical_section_begin( &mask );
+    wrap_counter = rtc_wrap_counter;
+    counter      = nrf_drv_rtc_counter_get( &rtc1 );
+    // An overflow not handled yet by the interrupt is accounted for, the counter is read again after the overflow
+    if( nrf_rtc_event_pending( rtc1.p_reg, NRF_RTC_EVENT_OVERFLOW ) != 0 )
+    {
+        wrap_counter++;
+        counter = nrf_drv_rtc_counter_get( &rtc1 );
+    }
+    hal_mcu_critical_section_end( &mask );
+
+    return ( ( uint64_t ) wrap_counter << 24 ) + counter;
 }
 
 static void rtc_wakeup_handler( void* obj )
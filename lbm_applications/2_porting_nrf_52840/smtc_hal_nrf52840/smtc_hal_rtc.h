@@ -101,9 +101,22 @@ uint32_t hal_rtc_get_time_s( void );
  */
 uint32_t hal_rtc_get_time_ms( void );
 
+/*!
+ * Returns the current RTC time in microseconds
+ *
+ * \remark Used by the radio planner microsecond timebase, resolution is one
+ * RTC tick (30.5 us)
+ *
+ * retval rtc_time_us Current RTC time in microseconds wraps every 71 minutes
+ */
+uint32_t hal_rtc_get_time_us( void );
+
 /*!
  * Starts the provided timer objet for the given time
  *
+ * \remark The timer expires on the first RTC tick (30.5 us) at or after the time base millisecond that is
+ *         milliseconds away
+ *
  * \param [in] milliseconds Number of milliseconds
  * \param [in] tmr_irq      Timer IRQ handling data ontext
  */
@@ -114,6 +127,22 @@ void hal_lp_timer_start( const uint32_t milliseconds, const hal_lp_timer_irq_t*
  */
 void hal_lp_timer_stop( void );
 
+/*!
+ * Starts the one shot radio trigger timer, on the RTC compare channel 2
+ *
+ * \remark The timer expires on the RTC tick (30.5 us) nearest to delay_us, the same ticks as the microsecond time
+ *         base, at least SMTC_RTC_MIN_CC_DELTA ticks away
+ *
+ * \param [in] delay_us Number of microseconds
+ * \param [in] tmr_irq  Timer IRQ handling data context
+ */
+void hal_rtc_trigger_timer_start( const uint32_t delay_us, const hal_lp_timer_irq_t* tmr_irq );
+
+/*!
+ * Stops the radio trigger timer
+ */
+void hal_rtc_trigger_timer_stop( void );
+
 /*!
  * Enables timer interrupts (HW timer only)
  */
@@ -39,14 +39,20 @@
 
 #include <stdbool.h>  // bool type
 #include <stdint.h>   // C99 types
+#include <string.h>   // memcpy
 
-#include "sdk_config.h"
-#include "nrf_drv_spi.h"
+#include "nrf.h"
 #include "nrf_gpio.h"
-#include "nrfx_log.h"
+#include "nrf_spim.h"
+#include "nrfx.h"
+#if defined( USE_RADIO_BUSY_PPI )
+#include "nrf_gpiote.h"
+#include "nrf_ppi.h"
+#endif
 
 #include "smtc_hal_spi.h"
 
+#include "modem_pinout.h"
 #include "smtc_hal_mcu.h"
 
 /*
@@ -54,25 +60,83 @@
  * --- PRIVATE MACROS-----------------------------------------------------------
  */
 
-#define SPI_INSTANCE 0 /**< SPI instance index. */
-
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 
+/**
+ * @brief SPIM instance driving the radio, the only one with a hardware chip select
+ */
+#define HAL_SPIM NRF_SPIM3
+
+/**
+ * @brief Size of the RAM copy of a tx buffer located in flash, EasyDMA only reads RAM
+ */
+#define HAL_SPI_FLASH_COPY_SIZE 32
+
+/**
+ * @brief nRF52840 anomaly 198 workaround register, dedicating RAM blocks to SPIM3 EasyDMA during a transfer
+ */
+#define HAL_SPIM3_RAM_BLOCK_REG ( *( ( volatile uint32_t* ) 0x40000E00 ) )
+
+#if defined( USE_RADIO_BUSY_PPI )
+/**
+ * @brief GPIOTE channel generating an event on the radio busy falling edge, kept out of reach of nrfx_gpiote which
+ * only allocates channels from 0 for high accuracy inputs and tasks
+ */
+#define HAL_SPI_BUSY_GPIOTE_CHANNEL 7
+
+/**
+ * @brief PPI channel starting the SPIM transfer on the radio busy falling edge
+ */
+#define HAL_SPI_BUSY_PPI_CHANNEL NRF_PPI_CHANNEL0
+
+/**
+ * @brief Radio chip select duration around a transfer in 64 MHz clock cycles (sx126x needs 32 ns)
+ */
+#define HAL_SPI_CSN_DURATION 4
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
-static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE( SPI_INSTANCE ); /**< SPI instance. */
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint32_t hal_spim3_ram_block_saved;
+static bool     hal_spi_transfer_pending = false;
 
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/**
+ * @brief Prepares the SPIM buffers of a transfer, the transfer is started by the START task
+ *
+ * @param [in]  tx_buffer Bytes to be sent (RAM), the over-read character is sent after tx_length bytes
+ * @param [in]  tx_length Number of bytes to be sent
+ * @param [out] rx_buffer Received bytes (RAM)
+ * @param [in]  rx_length Number of bytes to be received
+ */
+static void hal_spi_prepare( const uint8_t* tx_buffer, size_t tx_length, uint8_t* rx_buffer, size_t rx_length );
+
+/**
+ * @brief Sleeps until the END event of the current transfer
+ */
+static void hal_spi_wait_end( void );
+
+/**
+ * @brief Starts the prepared transfer and sleeps until its end
+ */
+static void hal_spi_transfer_blocking( const uint8_t* tx_buffer, size_t tx_length, uint8_t* rx_buffer,
+                                       size_t rx_length );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -80,37 +144,189 @@ static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE( SPI_INSTANCE ); /**< SPI
 
 void hal_spi_init( const uint32_t id )
 {
-    //   assert_param((id > 0) && ((id - 1) < sizeof(spi_periph)));
-    //   uint32_t local_id = id - 1;
-
-    nrf_drv_spi_config_t spi_config = NRF_DRV_SPI_DEFAULT_CONFIG;
-
-    spi_config.sck_pin      = SPI_SCK_PIN;
-    spi_config.mosi_pin     = SPI_MOSI_PIN;
-    spi_config.miso_pin     = SPI_MISO_PIN;
-    spi_config.ss_pin       = SPI_SS_PIN;
-    spi_config.irq_priority = SPI_DEFAULT_CONFIG_IRQ_PRIORITY;
-    spi_config.orc          = 0x00;
-    spi_config.frequency    = NRF_DRV_SPI_FREQ_8M;
-    spi_config.mode         = NRF_DRV_SPI_MODE_0;
-    spi_config.bit_order    = NRF_DRV_SPI_BIT_ORDER_MSB_FIRST;
-
-    nrf_drv_spi_init( &spi, &spi_config, NULL, NULL );
+    // Mode 0: SCK idles low
+    nrf_gpio_pin_clear( RADIO_SPI_SCLK );
+    nrf_gpio_cfg_output( RADIO_SPI_SCLK );
+    nrf_gpio_pin_clear( RADIO_SPI_MOSI );
+    nrf_gpio_cfg_output( RADIO_SPI_MOSI );
+    nrf_gpio_cfg_input( RADIO_SPI_MISO, NRF_GPIO_PIN_PULLDOWN );
+
+    nrf_spim_pins_set( HAL_SPIM, RADIO_SPI_SCLK, RADIO_SPI_MOSI, RADIO_SPI_MISO );
+    nrf_spim_frequency_set( HAL_SPIM, NRF_SPIM_FREQ_8M );
+    nrf_spim_configure( HAL_SPIM, NRF_SPIM_MODE_0, NRF_SPIM_BIT_ORDER_MSB_FIRST );
+    nrf_spim_orc_set( HAL_SPIM, 0x00 );
+
+#if defined( USE_RADIO_BUSY_PPI )
+    // The SPIM drives the radio NSS, asserted from the START task to the END event
+    nrf_spim_csn_configure( HAL_SPIM, RADIO_NSS, NRF_SPIM_CSN_POL_LOW, HAL_SPI_CSN_DURATION );
+
+    nrf_gpiote_event_configure( HAL_SPI_BUSY_GPIOTE_CHANNEL, RADIO_BUSY_PIN, NRF_GPIOTE_POLARITY_HITOLO );
+    nrf_gpiote_event_enable( HAL_SPI_BUSY_GPIOTE_CHANNEL );
+    nrf_ppi_channel_endpoint_setup(
+        HAL_SPI_BUSY_PPI_CHANNEL,
+        nrf_gpiote_event_addr_get( nrf_gpiote_in_event_get( HAL_SPI_BUSY_GPIOTE_CHANNEL ) ),
+        nrf_spim_task_address_get( HAL_SPIM, NRF_SPIM_TASK_START ) );
+#endif
+
+    // The END interrupt is only enabled in the SPIM: it stays pending in the NVIC and wakes the core up from WFE
+    nrf_spim_int_enable( HAL_SPIM, NRF_SPIM_INT_END_MASK );
+    NVIC_DisableIRQ( SPIM3_IRQn );
+    SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+
+    nrf_spim_enable( HAL_SPIM );
 }
 
 void hal_spi_de_init( const uint32_t id )
 {
-    nrf_drv_spi_uninit( &spi );
+    if( hal_spi_transfer_pending == true )
+    {
+        hal_spi_wait_end( );
+    }
+
+#if defined( USE_RADIO_BUSY_PPI )
+    nrf_ppi_channel_disable( HAL_SPI_BUSY_PPI_CHANNEL );
+    nrf_gpiote_event_disable( HAL_SPI_BUSY_GPIOTE_CHANNEL );
+#endif
+    nrf_spim_disable( HAL_SPIM );
 }
 
 void hal_spi_in_out( const uint32_t id, const uint8_t* out_data, uint8_t out_len, uint8_t* in_data, uint8_t in_len )
 {
-    APP_ERROR_CHECK( nrf_drv_spi_transfer( &spi, out_data, out_len, in_data, in_len ) );
+    hal_spi_transfer_blocking( out_data, out_len, in_data, in_len );
+}
+
+void hal_spi_transfer_dma( const uint32_t id, const uint8_t* tx_buffer, uint8_t* rx_buffer, const uint16_t length )
+{
+    hal_spi_transfer_blocking( tx_buffer, ( tx_buffer != NULL ) ? length : 0, rx_buffer,
+                               ( rx_buffer != NULL ) ? length : 0 );
 }
 
+#if defined( USE_RADIO_BUSY_PPI )
+void hal_spi_transfer_on_busy_low( const uint32_t id, const uint8_t* tx_buffer, const uint16_t tx_length,
+                                   uint8_t* rx_buffer, const uint16_t rx_length )
+{
+    if( hal_spi_transfer_pending == true )
+    {
+        hal_spi_wait_end( );
+    }
+
+    hal_spi_prepare( tx_buffer, tx_length, rx_buffer, rx_length );
+
+    nrf_gpiote_event_clear( nrf_gpiote_in_event_get( HAL_SPI_BUSY_GPIOTE_CHANNEL ) );
+    nrf_ppi_channel_enable( HAL_SPI_BUSY_PPI_CHANNEL );
+
+    if( nrf_gpio_pin_read( RADIO_BUSY_PIN ) == 0 )
+    {
+        // Busy is low and stays low: either its falling edge came after the event clear and the PPI started the
+        // transfer, or it came before and there is no edge to wait for. The GPIOTE event is latched a few cycles
+        // after the pin input register changes, it is read after that delay.
+        __NOP( );
+        __NOP( );
+        __NOP( );
+        __NOP( );
+        if( nrf_gpiote_event_is_set( nrf_gpiote_in_event_get( HAL_SPI_BUSY_GPIOTE_CHANNEL ) ) == false )
+        {
+            nrf_ppi_channel_disable( HAL_SPI_BUSY_PPI_CHANNEL );
+            nrf_spim_task_trigger( HAL_SPIM, NRF_SPIM_TASK_START );
+        }
+    }
+    hal_spi_transfer_pending = true;
+}
+
+void hal_spi_wait_transfer_end( const uint32_t id )
+{
+    if( hal_spi_transfer_pending == true )
+    {
+        hal_spi_wait_end( );
+    }
+}
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static void hal_spi_prepare( const uint8_t* tx_buffer, size_t tx_length, uint8_t* rx_buffer, size_t rx_length )
+{
+    nrf_spim_tx_buffer_set( HAL_SPIM, tx_buffer, tx_length );
+    nrf_spim_rx_buffer_set( HAL_SPIM, rx_buffer, rx_length );
+    nrf_spim_event_clear( HAL_SPIM, NRF_SPIM_EVENT_END );
+    NVIC_ClearPendingIRQ( SPIM3_IRQn );
+
+    // Anomaly 198: SPIM3 may send corrupted data when the CPU or another EasyDMA accesses the RAM block of the tx
+    // buffer, the blocks of the buffer are dedicated to SPIM3 until the END event
+    hal_spim3_ram_block_saved = HAL_SPIM3_RAM_BLOCK_REG;
+    if( tx_length > 0 )
+    {
+        const uint32_t end_address   = ( uint32_t ) tx_buffer + tx_length;
+        uint32_t       block_address = ( uint32_t ) tx_buffer & ~0x1FFFUL;
+        uint32_t       blocks        = 0;
+
+        if( block_address >= 0x20010000UL )
+        {
+            blocks = 1UL << 8;
+        }
+        else
+        {
+            do
+            {
+                blocks |= 1UL << ( ( block_address >> 13 ) & 0xFFFF );
+                block_address += 0x2000;
+            } while( ( block_address < end_address ) && ( block_address < 0x20012000UL ) );
+        }
+        HAL_SPIM3_RAM_BLOCK_REG = blocks;
+    }
+}
+
+static void hal_spi_wait_end( void )
+{
+    while( nrf_spim_event_check( HAL_SPIM, NRF_SPIM_EVENT_END ) == false )
+    {
+        __WFE( );
+    }
+    nrf_spim_event_clear( HAL_SPIM, NRF_SPIM_EVENT_END );
+    NVIC_ClearPendingIRQ( SPIM3_IRQn );
+
+#if defined( USE_RADIO_BUSY_PPI )
+    nrf_ppi_channel_disable( HAL_SPI_BUSY_PPI_CHANNEL );
+#endif
+    HAL_SPIM3_RAM_BLOCK_REG  = hal_spim3_ram_block_saved;
+    hal_spi_transfer_pending = false;
+}
+
+static void hal_spi_transfer_blocking( const uint8_t* tx_buffer, size_t tx_length, uint8_t* rx_buffer,
+                                       size_t rx_length )
+{
+    uint8_t copy[HAL_SPI_FLASH_COPY_SIZE];
+
+    if( hal_spi_transfer_pending == true )
+    {
+        hal_spi_wait_end( );
+    }
+
+    // EasyDMA cannot read flash: constant tx data is sent from a RAM copy, in chunks
+    while( ( tx_length > 0 ) && ( nrfx_is_in_ram( tx_buffer ) == false ) )
+    {
+        const size_t chunk_length    = ( tx_length > sizeof( copy ) ) ? sizeof( copy ) : tx_length;
+        const size_t rx_chunk_length = ( rx_length > chunk_length ) ? chunk_length : rx_length;
+
+        memcpy( copy, tx_buffer, chunk_length );
+        hal_spi_transfer_blocking( copy, chunk_length, rx_buffer, rx_chunk_length );
+        tx_buffer += chunk_length;
+        tx_length -= chunk_length;
+        rx_buffer = ( rx_buffer != NULL ) ? &rx_buffer[rx_chunk_length] : NULL;
+        rx_length -= rx_chunk_length;
+    }
+    if( ( tx_length == 0 ) && ( rx_length == 0 ) )
+    {
+        return;
+    }
+
+    hal_spi_prepare( tx_buffer, tx_length, rx_buffer, rx_length );
+    nrf_spim_task_trigger( HAL_SPIM, NRF_SPIM_TASK_START );
+    hal_spi_transfer_pending = true;
+    hal_spi_wait_end( );
+}
+
 /* --- EOF ------------------------------------------------------------------ */
@@ -90,6 +90,41 @@ void hal_spi_de_init( const uint32_t id );
  */
 void hal_spi_in_out( const uint32_t id, const uint8_t* out_data, uint8_t out_len, uint8_t* in_data, uint8_t in_len );
 
+/*!
+ * Sends tx_buffer and receives rx_buffer in a single EasyDMA transfer, the MCU sleeps until its end
+ *
+ * \param [IN]  id        SPI interface id [1:N]
+ * \param [IN]  tx_buffer Bytes to be sent, 0x00 bytes are sent if NULL
+ * \param [OUT] rx_buffer Received bytes, discarded if NULL
+ * \param [IN]  length    Number of bytes to be transferred
+ */
+void hal_spi_transfer_dma( const uint32_t id, const uint8_t* tx_buffer, uint8_t* rx_buffer, const uint16_t length );
+
+#if defined( USE_RADIO_BUSY_PPI )
+/*!
+ * Prepares a transfer started by the radio busy falling edge through PPI, without the CPU
+ *
+ * The radio NSS is driven by the SPIM hardware chip select, asserted for the whole transfer: a radio command and its
+ * data shall be sent in a single transfer. The transfer starts at once if busy is already low. The function returns
+ * without waiting for the transfer, the buffers shall stay valid until hal_spi_wait_transfer_end( ) returns.
+ *
+ * \param [IN]  id        SPI interface id [1:N]
+ * \param [IN]  tx_buffer Bytes to be sent (RAM), 0x00 bytes are sent after tx_length bytes
+ * \param [IN]  tx_length Number of bytes to be sent
+ * \param [OUT] rx_buffer Received bytes (RAM)
+ * \param [IN]  rx_length Number of bytes to be received
+ */
+void hal_spi_transfer_on_busy_low( const uint32_t id, const uint8_t* tx_buffer, const uint16_t tx_length,
+                                   uint8_t* rx_buffer, const uint16_t rx_length );
+
+/*!
+ * Sleeps until the end of the transfer prepared by hal_spi_transfer_on_busy_low( ), returns at once if none
+ *
+ * \param [IN] id SPI interface id [1:N]
+ */
+void hal_spi_wait_transfer_end( const uint32_t id );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,6 +43,7 @@
 #include "smtc_modem_hal.h"
 #include "smtc_hal_dbg_trace.h"
 
+#include "smtc_hal_aes.h"
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_lp_timer.h"
 #include "smtc_hal_mcu.h"
@@ -138,6 +139,11 @@ uint32_t smtc_modem_hal_get_time_in_ms( void )
     return hal_rtc_get_time_ms( );
 }
 
+uint32_t smtc_modem_hal_get_time_in_us( void )
+{
+    return hal_rtc_get_time_us( );
+}
+
 /* ------------ Timer management ------------*/
 
 void smtc_modem_hal_start_timer( const uint32_t milliseconds, void ( *callback )( void* context ), void* context )
@@ -150,6 +156,17 @@ void smtc_modem_hal_stop_timer( void )
     hal_lp_timer_stop( );
 }
 
+void smtc_modem_hal_start_radio_trigger_timer( const uint32_t delay_us, void ( *callback )( void* context ),
+                                               void* context )
+{
+    hal_rtc_trigger_timer_start( delay_us, &( hal_lp_timer_irq_t ) { .context = context, .callback = callback } );
+}
+
+void smtc_modem_hal_stop_radio_trigger_timer( void )
+{
+    hal_rtc_trigger_timer_stop( );
+}
+
 /* ------------ IRQ management ------------*/
 
 void smtc_modem_hal_disable_modem_irq( void )
@@ -310,6 +327,14 @@ uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint
     return hal_rng_get_random_in_range( val_1, val_2 );
 }
 
+/* ------------ Crypto management ------------*/
+
+bool smtc_modem_hal_crypto_aes_ecb_encrypt( const uint8_t key[16], const uint8_t* input, uint8_t* output,
+                                            uint16_t nb_blocks )
+{
+    return hal_aes_ecb_encrypt( key, input, output, nb_blocks );
+}
+
 /* ------------ Radio env management ------------*/
 
 void smtc_modem_hal_irq_config_radio_irq( void ( *callback )( void* context ), void* context )
@@ -428,6 +453,12 @@ uint8_t smtc_modem_hal_get_fw_delete_status_for_fuota( uint32_t fw_to_delete_ver
         return 0;
     }
 }
+
+const uint8_t* smtc_modem_hal_get_fuota_area_mapped_address( void )
+{
+    // The internal flash is memory mapped
+    return ( const uint8_t* ) ADDR_FLASH_FUOTA;
+}
 #endif  // USE_FUOTA
 
 /* ------------ Needed for Cloud  ------------*/
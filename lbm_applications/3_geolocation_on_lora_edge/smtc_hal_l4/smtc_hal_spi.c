@@ -43,6 +43,8 @@
 #include "smtc_hal_spi.h"
 #include "stm32l4xx_hal.h"
 #include "stm32l4xx_ll_spi.h"
+#include "stm32l4xx_ll_dma.h"
+#include "stm32l4xx_ll_bus.h"
 
 #include "modem_pinout.h"
 #include "smtc_hal_mcu.h"
@@ -98,6 +100,11 @@ static spi_t spi_periph[] = {
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/*!
+ * Configures the DMA1 channels mapped on SPI1: channel 2 for rx and channel 3 for tx
+ */
+static void spi_dma_init( void );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -131,6 +138,8 @@ void hal_spi_init( const uint32_t id, const hal_gpio_pin_names_t mosi, const hal
         mcu_panic( );
     }
     __HAL_SPI_ENABLE( &spi_periph[local_id].handle );
+
+    spi_dma_init( );
 }
 
 void hal_spi_de_init( const uint32_t id )
@@ -157,6 +166,61 @@ uint16_t hal_spi_in_out( const uint32_t id, const uint16_t out_data )
     return LL_SPI_ReceiveData8( spi_periph[local_id].interface );
 }
 
+void hal_spi_transfer_dma( const uint32_t id, const uint8_t* tx_buffer, uint8_t* rx_buffer, const uint16_t length )
+{
+    assert_param( ( id > 0 ) && ( ( id - 1 ) < sizeof( spi_periph ) ) );
+    uint32_t local_id = id - 1;
+
+    // Short transfers are faster byte per byte than with the DMA setup
+    if( length < HAL_SPI_DMA_MIN_LENGTH )
+    {
+        for( uint16_t i = 0; i < length; i++ )
+        {
+            const uint8_t rx_data = hal_spi_in_out( id, ( tx_buffer != NULL ) ? tx_buffer[i] : 0x00 );
+            if( rx_buffer != NULL )
+            {
+                rx_buffer[i] = rx_data;
+            }
+        }
+        return;
+    }
+
+    SPI_TypeDef*  spi     = spi_periph[local_id].interface;
+    const uint8_t tx_none = 0x00;
+    uint8_t       rx_none;
+
+    // Without buffer the DMA keeps on sending (or receiving in) the same dummy byte
+    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_CHANNEL_2,
+                             ( rx_buffer != NULL ) ? ( uint32_t ) rx_buffer : ( uint32_t ) &rx_none );
+    LL_DMA_SetMemoryIncMode( DMA1, LL_DMA_CHANNEL_2,
+                             ( rx_buffer != NULL ) ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT );
+    LL_DMA_SetDataLength( DMA1, LL_DMA_CHANNEL_2, length );
+
+    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_CHANNEL_3,
+                             ( tx_buffer != NULL ) ? ( uint32_t ) tx_buffer : ( uint32_t ) &tx_none );
+    LL_DMA_SetMemoryIncMode( DMA1, LL_DMA_CHANNEL_3,
+                             ( tx_buffer != NULL ) ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT );
+    LL_DMA_SetDataLength( DMA1, LL_DMA_CHANNEL_3, length );
+
+    // Rx shall be ready before the first byte is sent
+    LL_SPI_EnableDMAReq_RX( spi );
+    LL_DMA_EnableChannel( DMA1, LL_DMA_CHANNEL_2 );
+    LL_DMA_EnableChannel( DMA1, LL_DMA_CHANNEL_3 );
+    LL_SPI_EnableDMAReq_TX( spi );
+
+    // The last byte received ends the transfer on the bus
+    while( LL_DMA_IsActiveFlag_TC2( DMA1 ) == 0 )
+    {
+    };
+
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_3 );
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_2 );
+    LL_SPI_DisableDMAReq_TX( spi );
+    LL_SPI_DisableDMAReq_RX( spi );
+    LL_DMA_ClearFlag_GI2( DMA1 );
+    LL_DMA_ClearFlag_GI3( DMA1 );
+}
+
 void HAL_SPI_MspInit( SPI_HandleTypeDef* spiHandle )
 {
     if( spiHandle->Instance == spi_periph[0].interface )
@@ -207,4 +271,31 @@ void HAL_SPI_MspDeInit( SPI_HandleTypeDef* spiHandle )
         mcu_panic( );
     }
 }
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void spi_dma_init( void )
+{
+    LL_AHB1_GRP1_EnableClock( LL_AHB1_GRP1_PERIPH_DMA1 );
+
+    // Rx channel
+    LL_DMA_SetPeriphRequest( DMA1, LL_DMA_CHANNEL_2, LL_DMA_REQUEST_1 );
+    LL_DMA_ConfigTransfer( DMA1, LL_DMA_CHANNEL_2,
+                           LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_PRIORITY_HIGH | LL_DMA_MODE_NORMAL |
+                               LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE |
+                               LL_DMA_MDATAALIGN_BYTE );
+    LL_DMA_SetPeriphAddress( DMA1, LL_DMA_CHANNEL_2, LL_SPI_DMA_GetRegAddr( spi_periph[0].interface ) );
+
+    // Tx channel
+    LL_DMA_SetPeriphRequest( DMA1, LL_DMA_CHANNEL_3, LL_DMA_REQUEST_1 );
+    LL_DMA_ConfigTransfer( DMA1, LL_DMA_CHANNEL_3,
+                           LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_PRIORITY_MEDIUM | LL_DMA_MODE_NORMAL |
+                               LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE |
+                               LL_DMA_MDATAALIGN_BYTE );
+    LL_DMA_SetPeriphAddress( DMA1, LL_DMA_CHANNEL_3, LL_SPI_DMA_GetRegAddr( spi_periph[0].interface ) );
+}
+
 /* --- EOF ------------------------------------------------------------------ */
@@ -55,6 +55,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/*!
+ * Minimum length of a buffer transfer to use the DMA, shorter transfers are done byte per byte
+ */
+#define HAL_SPI_DMA_MIN_LENGTH 16
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -93,6 +98,16 @@ void hal_spi_de_init( const uint32_t id );
  */
 uint16_t hal_spi_in_out( const uint32_t id, const uint16_t out_data );
 
+/*!
+ * Sends tx_buffer and receives rx_buffer in a single transfer, using the DMA from HAL_SPI_DMA_MIN_LENGTH bytes
+ *
+ * \param [IN]  id        SPI interface id [1:N]
+ * \param [IN]  tx_buffer Bytes to be sent, 0x00 bytes are sent if NULL
+ * \param [OUT] rx_buffer Received bytes, discarded if NULL
+ * \param [IN]  length    Number of bytes to be transferred
+ */
+void hal_spi_transfer_dma( const uint32_t id, const uint8_t* tx_buffer, uint8_t* rx_buffer, const uint16_t length );
+
 #ifdef __cplusplus
 }
 #endif
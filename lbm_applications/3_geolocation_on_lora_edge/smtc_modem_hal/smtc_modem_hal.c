@@ -416,6 +416,12 @@ uint8_t smtc_modem_hal_get_fw_delete_status_for_fuota( uint32_t fw_to_delete_ver
         return 0;
     }
 }
+
+const uint8_t* smtc_modem_hal_get_fuota_area_mapped_address( void )
+{
+    // The internal flash is memory mapped
+    return ( const uint8_t* ) ADDR_FLASH_FUOTA;
+}
 #endif  // USE_FUOTA
 
 /* ------------ Needed for Cloud  ------------*/
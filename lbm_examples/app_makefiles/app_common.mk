@@ -81,6 +81,10 @@ ifeq ($(CRYPTO),LR11XX_WITH_CREDENTIALS)
 BUILD_TARGET := $(BUILD_TARGET)_lr11xx_crypto_with_cred
 BUILD_DIR := $(BUILD_DIR)_lr11xx_crypto_with_cred
 endif # LR11XX_WITH_CREDENTIALS
+ifeq ($(CRYPTO),SOFT_FAST)
+BUILD_TARGET := $(BUILD_TARGET)_soft_fast_crypto
+BUILD_DIR := $(BUILD_DIR)_soft_fast_crypto
+endif # SOFT_FAST
 ifeq ($(USE_LR11XX_CRC_SPI), yes)
 BUILD_TARGET := $(BUILD_TARGET)_crc_spi
 BUILD_DIR := $(BUILD_DIR)_crc_spi
@@ -194,6 +198,16 @@ endif
 
 endif
 
+ifeq ($(MODEM_APP),BENCHMARK)
+# Fixed modem configuration so that results can be compared between releases, the radio planner of the library is
+# used by the application and shall have the same hooks (no option adding hooks)
+LBM_BUILD_OPTIONS := LBM_STORE_AND_FORWARD=yes
+ifneq ($(BOARD),NUCLEO_L073)
+ALLOW_FUOTA=yes
+FUOTA_VERSION=2
+endif
+endif
+
 ifeq ($(APP_TRACE),yes)
 COMMON_C_DEFS += \
 	-DHAL_DBG_TRACE=1
@@ -232,11 +246,78 @@ COMMON_C_DEFS += \
 LBM_BUILD_OPTIONS += LBM_STORE_AND_FORWARD=yes
 endif
 
+ifeq ($(ALLOW_MAC_JOURNAL),yes)
+COMMON_C_DEFS += \
+	-DUSE_MAC_JOURNAL
+LBM_BUILD_OPTIONS += LBM_MAC_JOURNAL=yes
+endif
+
+ifeq ($(ALLOW_STREAM_SPILL),yes)
+COMMON_C_DEFS += \
+	-DUSE_STREAM_SPILL
+LBM_BUILD_OPTIONS += LBM_STREAM_SPILL=yes
+endif
+
+ifeq ($(ALLOW_CRC_MCU_HW),yes)
+COMMON_C_DEFS += \
+	-DUSE_CRC_MCU_HW
+LBM_BUILD_OPTIONS += LBM_CRC_MCU_HW=yes
+endif
+
+ifeq ($(ALLOW_RAL_STATIC),yes)
+COMMON_C_DEFS += \
+	-DRAL_STATIC_DRIVER
+LBM_BUILD_OPTIONS += LBM_RAL_STATIC=yes
+endif
+
+ifeq ($(ALLOW_TRACE_DEFERRED),yes)
+COMMON_C_DEFS += \
+	-DUSE_TRACE_DEFERRED
+LBM_BUILD_OPTIONS += LBM_TRACE_DEFERRED=yes
+endif
+
+ifeq ($(ALLOW_LOW_POWER_HINT),yes)
+COMMON_C_DEFS += \
+	-DUSE_LOW_POWER_HINT
+LBM_BUILD_OPTIONS += LBM_LOW_POWER_HINT=yes
+endif
+
+ifeq ($(ALLOW_RP_HW_TIMESTAMP),yes)
+COMMON_C_DEFS += \
+	-DUSE_RP_HW_TIMESTAMP
+LBM_BUILD_OPTIONS += LBM_RP_HW_TIMESTAMP=yes
+endif
+
 ifneq ($(LBM_NB_OF_STACK),1)
 COMMON_C_DEFS += \
 	-DMULTISTACK
 endif
 
+ifeq ($(RADIO_BUSY_IRQ_WAIT),yes)
+COMMON_C_DEFS += \
+	-DUSE_RADIO_BUSY_IRQ_WAIT
+endif
+
+ifeq ($(RADIO_PIPELINED_WRITE),yes)
+COMMON_C_DEFS += \
+	-DUSE_RADIO_PIPELINED_WRITE
+endif
+
+ifeq ($(RADIO_PA_EFFICIENCY),yes)
+COMMON_C_DEFS += \
+	-DUSE_RADIO_PA_EFFICIENCY
+endif
+
+ifeq ($(RADIO_TCXO_CALIBRATION),yes)
+COMMON_C_DEFS += \
+	-DUSE_RADIO_TCXO_CALIBRATION
+endif
+
+ifeq ($(HW_MODEM_SPI),yes)
+COMMON_C_DEFS += \
+	-DUSE_HW_MODEM_SPI
+endif
+
 ifeq ($(APP_DEBUG),yes)
 COMMON_C_DEFS += \
 	-DHW_DEBUG_PROBE=1
@@ -294,6 +375,11 @@ APP_C_SOURCES += \
 	main_examples/main_lctt_certif.c
 endif
 
+ifeq ($(MODEM_APP),BENCHMARK)
+APP_C_SOURCES += \
+	main_examples/main_benchmark.c
+endif
+
 ifeq ($(MODEM_APP),HW_MODEM)
 APP_C_SOURCES += \
 	hw_modem/main_hw_modem.c\
@@ -310,10 +396,39 @@ COMMON_C_INCLUDES += \
 	-Ihw_modem
 endif
 
-# For this specific example, a radio access is needed to mimic modem behavior, exceptionally include internal folder of lbm
-ifeq ($(MODEM_APP),PORTING_TESTS)
+# For these specific examples, a radio access is needed to mimic modem behavior, exceptionally include internal folder of lbm
+ifneq ($(filter $(MODEM_APP),PORTING_TESTS BENCHMARK),)
 MODEM_C_INCLUDES += \
 	-I$(LORA_BASICS_MODEM)/smtc_modem_core/smtc_ralf/src
+# Soft AES benchmark: the key schedule layout depends on the selected soft backend
+ifneq ($(filter $(CRYPTO),SOFT SOFT_FAST),)
+MODEM_C_INCLUDES += \
+	-I$(LORA_BASICS_MODEM)/smtc_modem_core/smtc_modem_crypto/soft_secure_element
+endif
+ifeq ($(CRYPTO),SOFT_FAST)
+COMMON_C_DEFS += \
+	-DSMTC_AES_FAST
+endif
+# Fragmentation decoder benchmark: needs the FUOTA v2 decoder of the modem library
+ifeq ($(ALLOW_FUOTA),yes)
+ifeq ($(FUOTA_VERSION),2)
+MODEM_C_INCLUDES += \
+	-I$(LORA_BASICS_MODEM)/smtc_modem_core/lorawan_packages/fragmented_data_block_transport/v2.0.0
+COMMON_C_DEFS += \
+	-DENABLE_TEST_FRAG_DECODER
+endif
+endif
+endif
+
+# Benchmark: radio planner, circularfs and version of the modem library
+ifeq ($(MODEM_APP),BENCHMARK)
+MODEM_C_INCLUDES += \
+	-I$(LORA_BASICS_MODEM)\
+	-I$(LORA_BASICS_MODEM)/smtc_modem_core/radio_planner/src\
+	-I$(LORA_BASICS_MODEM)/smtc_modem_core/modem_utilities\
+	-I$(LORA_BASICS_MODEM)/smtc_modem_core/logging
+COMMON_C_DEFS += \
+	-DNUMBER_OF_STACKS=$(LBM_NB_OF_STACK)
 endif
 
 #-----------------------------------------------------------------------------
@@ -99,7 +99,7 @@ COMMON_C_DEFS += \
 	-DUSE_LR11XX_CRC_OVER_SPI
 endif
 
-ifneq ($(CRYPTO),SOFT)
+ifeq ($(filter $(CRYPTO),SOFT SOFT_FAST),)
 COMMON_C_DEFS += \
 	-DUSE_LR11XX_CRYPTO
 endif
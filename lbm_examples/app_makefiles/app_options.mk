@@ -17,7 +17,7 @@ BOARD ?= NUCLEO_L476
 # Target radio
 TARGET_RADIO ?= nc
 
-# Application (PERIODICAL_UPLINK, HW_MODEM, PORTING_TESTS or LCTT_CERTIF)
+# Application (PERIODICAL_UPLINK, HW_MODEM, PORTING_TESTS, LCTT_CERTIF or BENCHMARK)
 # Default: PERIODICAL_UPLINK
 MODEM_APP ?= nc
 
@@ -32,6 +32,27 @@ FUOTA_VERSION ?= 1
 # USE LBM Store and forward (take more RAM on STM32L4, due to read_modify_write feature)
 ALLOW_STORE_AND_FORWARD ?= no
 
+# Keep DevNonce and the uplink frame counter in a journal on 4 flash pages (STM32L4 only)
+ALLOW_MAC_JOURNAL ?= no
+
+# Keep the stream records that do not fit in the RAM stream buffer on 16 flash pages (STM32L4 only)
+ALLOW_STREAM_SPILL ?= no
+
+# Compute the CRC-32 of the modem contexts with the CRC peripheral (STM32L4 only)
+ALLOW_CRC_MCU_HW ?= no
+
+# Call the radio driver directly instead of through the RAL function tables
+ALLOW_RAL_STATIC ?= no
+
+# Record the modem traces in RAM and send them by DMA before sleeping, to be decoded on the host (STM32L4 only)
+ALLOW_TRACE_DEFERRED ?= no
+
+# Select the MCU low power mode from the next modem wake-up budget and source (STM32L4 only)
+ALLOW_LOW_POWER_HINT ?= no
+
+# Timestamp the radio irqs from the edge captured by a TIM3 input capture on the radio DIO (STM32L4 only)
+ALLOW_RP_HW_TIMESTAMP ?= no
+
 #TRACE
 LBM_TRACE ?= yes
 APP_TRACE ?= yes
@@ -39,6 +60,21 @@ APP_TRACE ?= yes
 # LR11xx option to use crc
 USE_LR11XX_CRC_SPI ?= no
 
+# Sleep (WFI) until the radio busy line falling edge instead of polling it
+RADIO_BUSY_IRQ_WAIT ?= no
+
+# Skip the busy wait after sx126x/sx128x writes, the next command waits for it
+RADIO_PIPELINED_WRITE ?= no
+
+# Choose the sx1262 PA setting and the lr11xx PA path drawing the least current for each tx power
+RADIO_PA_EFFICIENCY ?= no
+
+# Measure the lr11xx tcxo startup time at the radio init instead of using the nominal board delay
+RADIO_TCXO_CALIBRATION ?= no
+
+# hw_modem host interface on an spi slave instead of the uart (NUCLEO_L476 only)
+HW_MODEM_SPI ?= no
+
 # Allow relay 
 ALLOW_RELAY_RX ?= no
 ALLOW_RELAY_TX ?= no
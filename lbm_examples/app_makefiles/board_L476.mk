@@ -43,7 +43,10 @@ BOARD_C_SOURCES = \
 	smtc_hal_l4/smtc_hal_mcu.c\
 	smtc_hal_l4/smtc_hal_rtc.c\
 	smtc_hal_l4/smtc_hal_rng.c\
+	smtc_hal_l4/smtc_hal_crc.c\
+	smtc_hal_l4/smtc_hal_irq_capture.c\
 	smtc_hal_l4/smtc_hal_spi.c\
+	smtc_hal_l4/smtc_hal_spi_slave.c\
 	smtc_hal_l4/smtc_hal_lp_timer.c\
 	smtc_hal_l4/smtc_hal_trace.c\
 	smtc_hal_l4/smtc_hal_uart.c\
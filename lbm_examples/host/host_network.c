@@ -0,0 +1,627 @@
+/*!
+ * \file      host_network.c
+ *
+ * \brief     Virtual channel, gateway and network server of the host network simulator
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stdlib.h>   // calloc
+#include <string.h>   // memcpy
+#include <math.h>     // log10, sqrt
+
+#include "host_network.h"
+#include "host_sim.h"
+#include "ral_virtual.h"
+#include "aes.h"
+#include "cmac.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*!
+ * \brief Log-distance path loss at 868 MHz: 128.95 dB at 1 km, exponent 2.32
+ */
+#define HOST_NETWORK_PATH_LOSS_1KM_DB 128.95
+#define HOST_NETWORK_PATH_LOSS_SLOPE_DB 23.2
+#define HOST_NETWORK_MIN_DISTANCE_M 10
+
+/*!
+ * \brief Noise floor in 125 kHz: -174 dBm/Hz + 51 dB + 6 dB of noise figure, and SNR saturation of the demodulator
+ */
+#define HOST_NETWORK_NOISE_FLOOR_DBM ( -117 )
+#define HOST_NETWORK_SNR_MAX_DB 10
+
+#define HOST_NETWORK_GW_TX_POWER_DBM 14
+#define HOST_NETWORK_CO_SF_CAPTURE_DB 6
+
+#define HOST_NETWORK_NET_ID 0x000013
+#define HOST_NETWORK_DEV_ADDR_BASE 0x26000000
+
+#define HOST_NETWORK_MTYPE_JOIN_REQUEST 0x00
+#define HOST_NETWORK_MTYPE_JOIN_ACCEPT 0x01
+#define HOST_NETWORK_MTYPE_UNCONF_UP 0x02
+#define HOST_NETWORK_MTYPE_UNCONF_DOWN 0x03
+#define HOST_NETWORK_MTYPE_CONF_UP 0x04
+
+#define HOST_NETWORK_JOIN_REQUEST_SIZE 23
+#define HOST_NETWORK_JOIN_ACCEPT_SIZE 33
+#define HOST_NETWORK_MIN_UPLINK_SIZE 12
+#define HOST_NETWORK_FCTRL_ADR 0x80
+#define HOST_NETWORK_CID_LINK_ADR 0x03
+
+/*!
+ * \brief Network ADR: uplinks in the SNR history, step of link margin per datarate or power index, EU868 bounds
+ */
+#define HOST_NETWORK_ADR_NB_UPLINKS 20
+#define HOST_NETWORK_ADR_STEP_DB 3
+#define HOST_NETWORK_ADR_MAX_DR 5
+#define HOST_NETWORK_ADR_MAX_TX_POWER_INDEX 7
+
+/*!
+ * \brief Gateway sensitivity in 125 kHz, SF7 to SF12
+ */
+static const int16_t host_network_sensitivity_dbm[HOST_NETWORK_NB_SF] = { -123, -126, -129, -132, -133, -136 };
+
+/*!
+ * \brief Demodulation floor in 125 kHz in tenths of dB, SF7 to SF12
+ */
+static const int16_t host_network_required_snr_ddb[HOST_NETWORK_NB_SF] = { -75, -100, -125, -150, -175, -200 };
+
+/*!
+ * \brief Signal to interference ratio a frame needs to survive an interferer, [frame SF][interferer SF]
+ */
+static const int8_t host_network_capture_db[HOST_NETWORK_NB_SF][HOST_NETWORK_NB_SF] = {
+    { HOST_NETWORK_CO_SF_CAPTURE_DB, -8, -9, -9, -9, -9 },
+    { -11, HOST_NETWORK_CO_SF_CAPTURE_DB, -11, -12, -13, -13 },
+    { -15, -13, HOST_NETWORK_CO_SF_CAPTURE_DB, -13, -14, -15 },
+    { -19, -18, -17, HOST_NETWORK_CO_SF_CAPTURE_DB, -17, -18 },
+    { -22, -22, -21, -20, HOST_NETWORK_CO_SF_CAPTURE_DB, -20 },
+    { -25, -25, -25, -24, -23, HOST_NETWORK_CO_SF_CAPTURE_DB },
+};
+
+/*!
+ * \brief Channels added by the join accept CFList
+ */
+static const uint32_t host_network_cflist_freq_in_hz[] = { 867100000, 867300000, 867500000, 867700000, 867900000 };
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*!
+ * \brief Frame on air, kept until no frame it overlaps can still be on air
+ */
+typedef struct host_network_frame_s
+{
+    uint32_t device_id;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t rf_freq_in_hz;
+    uint8_t  sf;
+    int16_t  rssi_in_dbm;
+} host_network_frame_t;
+
+/*!
+ * \brief Device as seen by the gateway and the network server
+ */
+typedef struct host_network_device_s
+{
+    uint32_t distance_in_m;
+    int16_t  path_loss_in_db;
+    bool     is_joined;
+    uint32_t dev_addr;
+    uint32_t join_nonce;
+    uint8_t  nwk_s_key[SMTC_MODEM_KEY_LENGTH];
+    uint32_t fcnt_down;
+    uint8_t  tx_power_index;  //!< Last power index requested by the ADR
+    int16_t  adr_max_snr_ddb;  //!< Best SNR of the history, in tenths of dB
+    uint8_t  adr_nb_uplinks;
+} host_network_device_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static host_network_config_t  host_network_config;
+static host_network_device_t* host_network_devices;
+static host_network_kpi_t     host_network_kpi;
+
+static host_network_frame_t* host_network_frames;
+static uint32_t              host_network_nb_frames;
+static uint32_t              host_network_max_nb_frames;
+static uint32_t              host_network_max_toa_us;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Record a frame starting on air, and forget the frames that cannot overlap a frame still on air
+ *
+ * \param [in] radio Virtual radio of the running device
+ * \param [in] frame Frame being sent
+ */
+static void host_network_on_tx_start( const ral_virtual_t* radio, const ral_virtual_frame_t* frame );
+
+/*!
+ * \brief Decide whether the gateway received a frame that ended, and hand it to the network server
+ *
+ * \param [in] radio Virtual radio of the running device
+ * \param [in] frame Sent frame
+ */
+static void host_network_on_tx_done( const ral_virtual_t* radio, const ral_virtual_frame_t* frame );
+
+/*!
+ * \brief Check the sensitivity and the interferers of a frame
+ *
+ * \param [in] frame Frame on air record
+ *
+ * \returns True if the gateway receives the frame
+ */
+static bool host_network_is_received( const host_network_frame_t* frame );
+
+/*!
+ * \brief Answer a join request received by the gateway with a join accept in RX1
+ *
+ * \param [in] radio       Virtual radio of the running device
+ * \param [in] payload     Join request
+ * \param [in] rssi_in_dbm RSSI of the join request, reused for the downlink
+ */
+static void host_network_on_join_request( const ral_virtual_t* radio, const uint8_t* payload, int16_t rssi_in_dbm );
+
+/*!
+ * \brief Run the network ADR on a data uplink received by the gateway, with a LinkADRReq in RX1 if needed
+ *
+ * \param [in] radio       Virtual radio of the running device
+ * \param [in] payload     Data uplink
+ * \param [in] sf          Spreading factor of the uplink
+ * \param [in] rssi_in_dbm RSSI of the uplink
+ */
+static void host_network_on_uplink( const ral_virtual_t* radio, const uint8_t* payload, uint8_t sf,
+                                    int16_t rssi_in_dbm );
+
+/*!
+ * \brief Push a downlink to the virtual radio of the running device, received in its next reception window
+ *
+ * \param [in] radio         Virtual radio of the running device
+ * \param [in] payload       Downlink
+ * \param [in] size          Downlink size
+ * \param [in] uplink_rssi   RSSI of the uplink, the link is symmetric
+ */
+static void host_network_push_downlink( const ral_virtual_t* radio, const uint8_t* payload, uint16_t size,
+                                        int16_t uplink_rssi );
+
+/*!
+ * \brief Compute a LoRaWAN MIC, the first 4 bytes of the AES-CMAC
+ *
+ * \param [in]  key    AES key
+ * \param [in]  prefix Block prepended to the data, NULL for none
+ * \param [in]  data   Data
+ * \param [in]  size   Data size
+ * \param [out] mic    MIC, in frame order
+ */
+static void host_network_compute_mic( const uint8_t key[SMTC_MODEM_KEY_LENGTH], const uint8_t* prefix,
+                                      const uint8_t* data, uint16_t size, uint8_t mic[4] );
+
+/*!
+ * \brief Get the SNR the gateway measures
+ *
+ * \param [in] rssi_in_dbm RSSI of the frame
+ *
+ * \returns SNR in tenths of dB
+ */
+static int16_t host_network_get_snr_ddb( int16_t rssi_in_dbm );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+bool host_network_init( const host_network_config_t* config, uint32_t nb_devices, uint32_t seed )
+{
+    // xorshift32 state shall not be 0
+    uint32_t random_state = ( seed != 0 ) ? seed : 1;
+
+    host_network_config = *config;
+    host_network_kpi    = ( host_network_kpi_t ){ 0 };
+    host_network_devices = calloc( nb_devices, sizeof( host_network_device_t ) );
+    // Each device has at most one frame on air, the others are kept while they can overlap a frame on air
+    host_network_max_nb_frames = 2 * nb_devices;
+    host_network_frames        = calloc( host_network_max_nb_frames, sizeof( host_network_frame_t ) );
+    if( ( host_network_devices == NULL ) || ( host_network_frames == NULL ) )
+    {
+        return false;
+    }
+
+    for( uint32_t i = 0; i < nb_devices; i++ )
+    {
+        host_network_device_t* device = &host_network_devices[i];
+
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+
+        // Uniform in the disk: the distance grows with the square root of a uniform draw
+        const double radius = host_network_config.radius_in_m * sqrt( ( double ) random_state / UINT32_MAX );
+
+        device->distance_in_m = ( radius > HOST_NETWORK_MIN_DISTANCE_M ) ? ( uint32_t ) radius
+                                                                         : HOST_NETWORK_MIN_DISTANCE_M;
+        device->path_loss_in_db =
+            ( int16_t ) ( HOST_NETWORK_PATH_LOSS_1KM_DB +
+                          ( HOST_NETWORK_PATH_LOSS_SLOPE_DB * log10( device->distance_in_m / 1000.0 ) ) );
+        device->dev_addr = HOST_NETWORK_DEV_ADDR_BASE + i;
+    }
+
+    host_sim_set_network_tx_start_callback( host_network_on_tx_start );
+    host_sim_set_network_callback( host_network_on_tx_done );
+    return true;
+}
+
+uint32_t host_network_get_device_distance_in_m( void )
+{
+    return host_network_devices[host_sim_get_device_id( )].distance_in_m;
+}
+
+void host_network_get_kpi( host_network_kpi_t* kpi )
+{
+    *kpi = host_network_kpi;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void host_network_on_tx_start( const ral_virtual_t* radio, const ral_virtual_frame_t* frame )
+{
+    const uint64_t now_us   = host_sim_get_time_in_us( );
+    uint32_t       nb_kept = 0;
+
+    if( frame->toa_in_us > host_network_max_toa_us )
+    {
+        host_network_max_toa_us = frame->toa_in_us;
+    }
+
+    // A frame ended before the start of the longest frame still on air overlaps none of them
+    for( uint32_t i = 0; i < host_network_nb_frames; i++ )
+    {
+        if( ( host_network_frames[i].end_us + host_network_max_toa_us ) >= now_us )
+        {
+            host_network_frames[nb_kept++] = host_network_frames[i];
+        }
+    }
+    host_network_nb_frames = nb_kept;
+
+    if( host_network_nb_frames == host_network_max_nb_frames )
+    {
+        // More frames in the window than planned, the oldest one is forgotten
+        memmove( &host_network_frames[0], &host_network_frames[1],
+                 ( host_network_nb_frames - 1 ) * sizeof( host_network_frame_t ) );
+        host_network_nb_frames--;
+    }
+
+    host_network_frames[host_network_nb_frames++] = ( host_network_frame_t ){
+        .device_id     = host_sim_get_device_id( ),
+        .start_us      = now_us,
+        .end_us        = now_us + frame->toa_in_us,
+        .rf_freq_in_hz = frame->rf_freq_in_hz,
+        .sf            = ( uint8_t ) frame->sf,
+        .rssi_in_dbm   = frame->output_pwr_in_dbm - host_network_devices[host_sim_get_device_id( )].path_loss_in_db,
+    };
+}
+
+static void host_network_on_tx_done( const ral_virtual_t* radio, const ral_virtual_frame_t* frame )
+{
+    const uint32_t              device_id = host_sim_get_device_id( );
+    const host_network_frame_t* record    = NULL;
+
+    if( ( frame->pkt_type != RAL_PKT_TYPE_LORA ) || ( frame->bw != RAL_LORA_BW_125_KHZ ) ||
+        ( frame->sf < HOST_NETWORK_SF_MIN ) || ( frame->size == 0 ) || ( frame->invert_iq_is_on == true ) )
+    {
+        // Only the uplinks of the LoRaWAN EU868 125 kHz channels are modelled
+        return;
+    }
+
+    // The last frame of the device is the one ending
+    for( uint32_t i = host_network_nb_frames; i > 0; i-- )
+    {
+        if( host_network_frames[i - 1].device_id == device_id )
+        {
+            record = &host_network_frames[i - 1];
+            break;
+        }
+    }
+    if( record == NULL )
+    {
+        return;
+    }
+
+    const uint8_t mtype    = frame->payload[0] >> 5;
+    const uint8_t sf_index = record->sf - HOST_NETWORK_SF_MIN;
+    const bool    is_data  = ( mtype == HOST_NETWORK_MTYPE_UNCONF_UP ) || ( mtype == HOST_NETWORK_MTYPE_CONF_UP );
+
+    if( is_data == true )
+    {
+        host_network_kpi.nb_uplinks++;
+        host_network_kpi.nb_uplinks_per_sf[sf_index]++;
+    }
+    else if( mtype == HOST_NETWORK_MTYPE_JOIN_REQUEST )
+    {
+        host_network_kpi.nb_join_requests++;
+    }
+
+    if( host_network_is_received( record ) == false )
+    {
+        return;
+    }
+
+    if( ( mtype == HOST_NETWORK_MTYPE_JOIN_REQUEST ) && ( frame->size == HOST_NETWORK_JOIN_REQUEST_SIZE ) )
+    {
+        host_network_on_join_request( radio, frame->payload, record->rssi_in_dbm );
+    }
+    else if( ( is_data == true ) && ( frame->size >= HOST_NETWORK_MIN_UPLINK_SIZE ) )
+    {
+        host_network_kpi.nb_uplinks_delivered++;
+        host_network_kpi.nb_uplinks_delivered_per_sf[sf_index]++;
+        host_network_on_uplink( radio, frame->payload, record->sf, record->rssi_in_dbm );
+    }
+}
+
+static bool host_network_is_received( const host_network_frame_t* frame )
+{
+    const uint8_t sf_index = frame->sf - HOST_NETWORK_SF_MIN;
+
+    if( frame->rssi_in_dbm < host_network_sensitivity_dbm[sf_index] )
+    {
+        host_network_kpi.nb_lost_below_sensitivity++;
+        return false;
+    }
+
+    for( uint32_t i = 0; i < host_network_nb_frames; i++ )
+    {
+        const host_network_frame_t* other = &host_network_frames[i];
+
+        if( ( other == frame ) || ( other->rf_freq_in_hz != frame->rf_freq_in_hz ) ||
+            ( other->start_us >= frame->end_us ) || ( other->end_us <= frame->start_us ) ||
+            ( other->sf < HOST_NETWORK_SF_MIN ) )
+        {
+            continue;
+        }
+
+        const int16_t sir_in_db = frame->rssi_in_dbm - other->rssi_in_dbm;
+
+        if( sir_in_db < host_network_capture_db[sf_index][other->sf - HOST_NETWORK_SF_MIN] )
+        {
+            host_network_kpi.nb_lost_collision++;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void host_network_on_join_request( const ral_virtual_t* radio, const uint8_t* payload, int16_t rssi_in_dbm )
+{
+    host_network_device_t* device = &host_network_devices[host_sim_get_device_id( )];
+    uint8_t                join_accept[HOST_NETWORK_JOIN_ACCEPT_SIZE];
+    uint8_t                encrypted[HOST_NETWORK_JOIN_ACCEPT_SIZE];
+    uint8_t                key_block[16] = { 0 };
+    uint8_t                index         = 0;
+    aes_context            aes_ctx;
+
+    device->join_nonce++;
+    device->fcnt_down       = 0;
+    device->tx_power_index  = 0;
+    device->adr_nb_uplinks  = 0;
+    device->adr_max_snr_ddb = INT16_MIN;
+
+    // MHDR | JoinNonce | NetID | DevAddr | DLSettings | RxDelay | CFList | MIC, LoRaWAN 1.0.x
+    join_accept[index++] = HOST_NETWORK_MTYPE_JOIN_ACCEPT << 5;
+    for( uint8_t i = 0; i < 3; i++ )
+    {
+        join_accept[index++] = ( uint8_t ) ( device->join_nonce >> ( 8 * i ) );
+    }
+    for( uint8_t i = 0; i < 3; i++ )
+    {
+        join_accept[index++] = ( uint8_t ) ( HOST_NETWORK_NET_ID >> ( 8 * i ) );
+    }
+    for( uint8_t i = 0; i < 4; i++ )
+    {
+        join_accept[index++] = ( uint8_t ) ( device->dev_addr >> ( 8 * i ) );
+    }
+    join_accept[index++] = 0x00;  // RX1 datarate offset 0, RX2 datarate 0
+    join_accept[index++] = 0x01;  // RX1 1 second after the uplink
+    for( uint8_t i = 0; i < ( sizeof( host_network_cflist_freq_in_hz ) / sizeof( uint32_t ) ); i++ )
+    {
+        const uint32_t freq = host_network_cflist_freq_in_hz[i] / 100;
+
+        join_accept[index++] = ( uint8_t ) freq;
+        join_accept[index++] = ( uint8_t ) ( freq >> 8 );
+        join_accept[index++] = ( uint8_t ) ( freq >> 16 );
+    }
+    join_accept[index++] = 0x00;  // CFList of frequencies
+    host_network_compute_mic( host_network_config.nwk_key, NULL, join_accept, index, &join_accept[index] );
+
+    // The device decrypts the join accept with an AES encryption
+    smtc_aes_set_key( host_network_config.nwk_key, SMTC_MODEM_KEY_LENGTH, &aes_ctx );
+    encrypted[0] = join_accept[0];
+    for( uint8_t i = 1; i < HOST_NETWORK_JOIN_ACCEPT_SIZE; i += 16 )
+    {
+        smtc_aes_decrypt( &join_accept[i], &encrypted[i], &aes_ctx );
+    }
+
+    // NwkSKey = aes128_encrypt( NwkKey, 0x01 | JoinNonce | NetID | DevNonce | pad16 )
+    key_block[0] = 0x01;
+    memcpy( &key_block[1], &join_accept[1], 6 );
+    memcpy( &key_block[7], &payload[17], 2 );
+    smtc_aes_encrypt( key_block, device->nwk_s_key, &aes_ctx );
+    device->is_joined = true;
+
+    host_network_kpi.nb_join_accepts++;
+    host_network_push_downlink( radio, encrypted, HOST_NETWORK_JOIN_ACCEPT_SIZE, rssi_in_dbm );
+}
+
+static void host_network_on_uplink( const ral_virtual_t* radio, const uint8_t* payload, uint8_t sf,
+                                    int16_t rssi_in_dbm )
+{
+    host_network_device_t* device   = &host_network_devices[host_sim_get_device_id( )];
+    const uint32_t         dev_addr = payload[1] | ( payload[2] << 8 ) | ( payload[3] << 16 ) |
+                              ( ( uint32_t ) payload[4] << 24 );
+    const int16_t snr_ddb = host_network_get_snr_ddb( rssi_in_dbm );
+
+    if( ( device->is_joined == false ) || ( dev_addr != device->dev_addr ) ||
+        ( ( payload[5] & HOST_NETWORK_FCTRL_ADR ) == 0 ) )
+    {
+        // Not a session of this network, or the device chooses its datarate
+        return;
+    }
+
+    if( snr_ddb > device->adr_max_snr_ddb )
+    {
+        device->adr_max_snr_ddb = snr_ddb;
+    }
+    if( ++device->adr_nb_uplinks < HOST_NETWORK_ADR_NB_UPLINKS )
+    {
+        return;
+    }
+
+    // Standard network ADR: each step of link margin raises the datarate, then lowers the power
+    const uint8_t sf_index  = sf - HOST_NETWORK_SF_MIN;
+    const int16_t margin_ddb = device->adr_max_snr_ddb - host_network_required_snr_ddb[sf_index] -
+                               ( host_network_config.adr_margin_in_db * 10 );
+    int16_t       nb_steps       = margin_ddb / ( HOST_NETWORK_ADR_STEP_DB * 10 );
+    uint8_t       dr             = HOST_NETWORK_ADR_MAX_DR - sf_index;
+    uint8_t       tx_power_index = device->tx_power_index;
+
+    device->adr_nb_uplinks  = 0;
+    device->adr_max_snr_ddb = INT16_MIN;
+
+    for( ; ( nb_steps > 0 ) && ( dr < HOST_NETWORK_ADR_MAX_DR ); nb_steps-- )
+    {
+        dr++;
+    }
+    for( ; ( nb_steps > 0 ) && ( tx_power_index < HOST_NETWORK_ADR_MAX_TX_POWER_INDEX ); nb_steps-- )
+    {
+        tx_power_index++;
+    }
+    for( ; ( nb_steps < 0 ) && ( tx_power_index > 0 ); nb_steps++ )
+    {
+        tx_power_index--;
+    }
+    if( ( dr == ( HOST_NETWORK_ADR_MAX_DR - sf_index ) ) && ( tx_power_index == device->tx_power_index ) )
+    {
+        return;
+    }
+    device->tx_power_index = tx_power_index;
+
+    // MHDR | DevAddr | FCtrl | FCnt | FOpts: LinkADRReq on channels 0 to 7, NbTrans 1 | MIC
+    uint8_t  downlink[17];
+    uint8_t  b0[16] = { 0x49, 0, 0, 0, 0, 0x01 };
+    uint16_t index  = 0;
+
+    downlink[index++] = HOST_NETWORK_MTYPE_UNCONF_DOWN << 5;
+    memcpy( &downlink[index], &payload[1], 4 );
+    index += 4;
+    downlink[index++] = HOST_NETWORK_FCTRL_ADR | 5;
+    downlink[index++] = ( uint8_t ) device->fcnt_down;
+    downlink[index++] = ( uint8_t ) ( device->fcnt_down >> 8 );
+    downlink[index++] = HOST_NETWORK_CID_LINK_ADR;
+    downlink[index++] = ( uint8_t ) ( ( dr << 4 ) | tx_power_index );
+    downlink[index++] = 0xFF;
+    downlink[index++] = 0x00;
+    downlink[index++] = 0x01;
+
+    // B0 = 0x49 | 0x00000000 | Dir | DevAddr | FCntDown | 0x00 | Len
+    memcpy( &b0[6], &payload[1], 4 );
+    for( uint8_t i = 0; i < 4; i++ )
+    {
+        b0[10 + i] = ( uint8_t ) ( device->fcnt_down >> ( 8 * i ) );
+    }
+    b0[15] = ( uint8_t ) index;
+    host_network_compute_mic( device->nwk_s_key, b0, downlink, index, &downlink[index] );
+    index += 4;
+    device->fcnt_down++;
+
+    host_network_kpi.nb_adr_requests++;
+    host_network_push_downlink( radio, downlink, index, rssi_in_dbm );
+}
+
+static void host_network_push_downlink( const ral_virtual_t* radio, const uint8_t* payload, uint16_t size,
+                                        int16_t uplink_rssi )
+{
+    const host_network_device_t* device = &host_network_devices[host_sim_get_device_id( )];
+    const int16_t rssi_in_dbm = HOST_NETWORK_GW_TX_POWER_DBM - device->path_loss_in_db;
+
+    ral_virtual_push_rx_frame( radio, RAL_PKT_TYPE_LORA, payload, size, rssi_in_dbm,
+                               host_network_get_snr_ddb( rssi_in_dbm ) / 10 );
+    host_sim_on_downlink_pushed( );
+}
+
+static void host_network_compute_mic( const uint8_t key[SMTC_MODEM_KEY_LENGTH], const uint8_t* prefix,
+                                      const uint8_t* data, uint16_t size, uint8_t mic[4] )
+{
+    AES_CMAC_CTX cmac_ctx;
+    uint8_t      digest[AES_CMAC_DIGEST_LENGTH];
+
+    AES_CMAC_Init( &cmac_ctx );
+    AES_CMAC_SetKey( &cmac_ctx, key );
+    if( prefix != NULL )
+    {
+        AES_CMAC_Update( &cmac_ctx, prefix, 16 );
+    }
+    AES_CMAC_Update( &cmac_ctx, data, size );
+    AES_CMAC_Final( digest, &cmac_ctx );
+    memcpy( mic, digest, 4 );
+}
+
+static int16_t host_network_get_snr_ddb( int16_t rssi_in_dbm )
+{
+    const int16_t snr_in_db = rssi_in_dbm - HOST_NETWORK_NOISE_FLOOR_DBM;
+
+    return ( ( snr_in_db < HOST_NETWORK_SNR_MAX_DB ) ? snr_in_db : HOST_NETWORK_SNR_MAX_DB ) * 10;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,146 @@
+/*!
+ * \file      host_network.h
+ *
+ * \brief     Virtual channel, gateway and network server of the host network simulator
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HOST_NETWORK_H
+#define HOST_NETWORK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_modem_api.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * \brief Spreading factors counted in the KPIs, SF7 to SF12
+ */
+#define HOST_NETWORK_SF_MIN 7
+#define HOST_NETWORK_NB_SF 6
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * \brief Network configuration
+ */
+typedef struct host_network_config_s
+{
+    uint32_t radius_in_m;       //!< Devices are spread uniformly in a disk of this radius around the gateway
+    uint8_t  adr_margin_in_db;  //!< Installation margin of the network ADR
+    uint8_t  nwk_key[SMTC_MODEM_KEY_LENGTH];  //!< Network key shared by all the devices
+} host_network_config_t;
+
+/*!
+ * \brief Fleet KPIs seen by the network, since \ref host_network_init
+ */
+typedef struct host_network_kpi_s
+{
+    uint32_t nb_join_requests;             //!< Join requests sent
+    uint32_t nb_join_accepts;              //!< Join requests received by the gateway, answered by a join accept
+    uint32_t nb_uplinks;                   //!< Data uplinks sent
+    uint32_t nb_uplinks_delivered;         //!< Data uplinks received by the gateway
+    uint32_t nb_lost_below_sensitivity;    //!< Frames received below the gateway sensitivity
+    uint32_t nb_lost_collision;            //!< Frames lost in a collision, not captured
+    uint32_t nb_adr_requests;              //!< LinkADRReq sent by the network ADR
+    uint32_t nb_uplinks_per_sf[HOST_NETWORK_NB_SF];            //!< Data uplinks sent per spreading factor
+    uint32_t nb_uplinks_delivered_per_sf[HOST_NETWORK_NB_SF];  //!< Data uplinks received per spreading factor
+} host_network_kpi_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief Place the devices around the gateway and attach the network to the simulated radios
+ *
+ * \remark The channel model:
+ * - log-distance path loss measured for LoRa at 868 MHz, without shadowing
+ * - frames below the gateway sensitivity of their spreading factor are lost
+ * - frames overlapping in time on the same frequency interfere: a frame survives each interferer if its signal to
+ *   interference ratio reaches the capture threshold, 6 dB for the same spreading factor and the rejection of the
+ *   other spreading factors otherwise
+ * - the gateway has no demodulator limit and receives while it transmits, the downlinks are not lost
+ * The network server answers the join requests (LoRaWAN 1.0.x join accept with a CFList of 5 channels) and runs the
+ * ADR of the network controlled devices: once 20 uplinks are received, the spreading factor then the power are
+ * lowered by steps of 3 dB of link margin above the installation margin, in a LinkADRReq sent in RX1.
+ *
+ * \param [in] config     Network configuration
+ * \param [in] nb_devices Number of simulated devices
+ * \param [in] seed       Seed of the device placement
+ *
+ * \returns True if the network is created
+ */
+bool host_network_init( const host_network_config_t* config, uint32_t nb_devices, uint32_t seed );
+
+/*!
+ * \brief Get the distance of the running device to the gateway
+ *
+ * \returns Distance in meters
+ */
+uint32_t host_network_get_device_distance_in_m( void );
+
+/*!
+ * \brief Get the fleet KPIs
+ *
+ * \param [out] kpi KPIs since \ref host_network_init
+ */
+void host_network_get_kpi( host_network_kpi_t* kpi );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HOST_NETWORK_H
+
+/* --- EOF ------------------------------------------------------------------ */
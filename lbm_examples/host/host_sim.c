@@ -0,0 +1,577 @@
+/*!
+ * \file      host_sim.c
+ *
+ * \brief     Simulated time, devices and interrupts of the host (Linux) port
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
+#include <stdio.h>    // FILE
+#include <stdlib.h>   // calloc
+#include <string.h>   // memset
+
+#include "smtc_modem_utilities.h"
+#include "host_sim.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct host_sim_timer_s
+{
+    bool     is_running;
+    uint64_t expiry_us;
+    void ( *callback )( void* context );
+    void* context;
+} host_sim_timer_t;
+
+/*!
+ * \brief Simulated device: the modem instance and the peripherals of its HAL
+ */
+typedef struct host_sim_device_s
+{
+    smtc_modem_instance_t* modem_instance;
+    uint64_t               wake_up_us;     //!< End of the sleep requested by the modem engine
+    uint64_t               next_event_us;  //!< First timer expiry or end of sleep
+    uint32_t               heap_index;     //!< Position in the event heap
+    host_sim_timer_t       timers[HOST_SIM_TIMER_NB];
+    void ( *radio_irq_callback )( void* context );
+    void*    radio_irq_context;
+    uint32_t random_state;
+    //! Flash pages, allocated on their first write so that thousands of devices fit in memory
+    uint8_t* nvm_pages[HOST_SIM_NVM_NB_AREAS][HOST_SIM_NVM_NB_PAGES_PER_AREA];
+} host_sim_device_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint64_t host_sim_time_us;
+
+static host_sim_device_t* host_sim_devices;
+static uint32_t           host_sim_nb_devices;
+static uint32_t*          host_sim_heap;  //!< Device ids, min-heap on the next event then on the id
+static host_sim_device_t* host_sim_device;  //!< Running device
+
+static host_sim_network_callback_t host_sim_network_callback;
+static host_sim_network_callback_t host_sim_network_tx_start_callback;
+static host_sim_network_stats_t    host_sim_network_stats;
+
+static FILE* host_sim_nvm_file;
+
+static bool host_sim_trace;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Check that an access is within a simulated flash area
+ *
+ * \param [in] area   Area index
+ * \param [in] offset Offset in the area
+ * \param [in] size   Number of bytes
+ *
+ * \returns True if the access is valid
+ */
+static bool host_sim_nvm_check_access( uint32_t area, uint32_t offset, uint32_t size );
+
+/*!
+ * \brief Get a flash page of the running device, allocated on its first write, or on its first read with a file
+ *
+ * \param [in] area     Area index
+ * \param [in] page     Page index in the area
+ * \param [in] allocate False to return NULL for a page never written, when the flash has no file
+ *
+ * \returns Page content, NULL if not allocated
+ */
+static uint8_t* host_sim_nvm_get_page( uint32_t area, uint32_t page, bool allocate );
+
+/*!
+ * \brief Get the offset of a flash page of the running device in the flash file
+ *
+ * \param [in] area Area index
+ * \param [in] page Page index in the area
+ *
+ * \returns Offset in bytes
+ */
+static long host_sim_nvm_get_file_offset( uint32_t area, uint32_t page );
+
+/*!
+ * \brief Get the first timer of a device
+ *
+ * \param [in] device Device
+ *
+ * \returns Running timer expiring first, NULL if none is running
+ */
+static host_sim_timer_t* host_sim_get_next_timer( host_sim_device_t* device );
+
+/*!
+ * \brief Update the next event of the running device and its place in the event heap
+ */
+static void host_sim_update_next_event( void );
+
+/*!
+ * \brief Tell whether a device runs before another one: first event, then lowest id
+ *
+ * \param [in] device_id_a First device
+ * \param [in] device_id_b Second device
+ *
+ * \returns True if device_id_a runs first
+ */
+static bool host_sim_heap_is_before( uint32_t device_id_a, uint32_t device_id_b );
+
+/*!
+ * \brief Swap two entries of the event heap
+ *
+ * \param [in] index_a First heap index
+ * \param [in] index_b Second heap index
+ */
+static void host_sim_heap_swap( uint32_t index_a, uint32_t index_b );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+bool host_sim_init( uint32_t seed, uint32_t nb_devices )
+{
+    const uint32_t instance_size = smtc_modem_instance_get_size( );
+
+    // Without modem instances in the build, a single device runs in the static state of the modem
+    if( ( nb_devices == 0 ) || ( ( instance_size == 0 ) && ( nb_devices > 1 ) ) )
+    {
+        return false;
+    }
+
+    host_sim_time_us       = 0;
+    host_sim_network_stats = ( host_sim_network_stats_t ){ 0 };
+    host_sim_devices       = calloc( nb_devices, sizeof( host_sim_device_t ) );
+    host_sim_heap          = calloc( nb_devices, sizeof( uint32_t ) );
+    if( ( host_sim_devices == NULL ) || ( host_sim_heap == NULL ) )
+    {
+        return false;
+    }
+    host_sim_nb_devices = nb_devices;
+
+    for( uint32_t i = 0; i < nb_devices; i++ )
+    {
+        host_sim_device_t* device = &host_sim_devices[i];
+
+        // xorshift32 state shall not be 0
+        device->random_state = ( ( seed + i ) != 0 ) ? ( seed + i ) : 1;
+        // All devices run at time 0, in the order of their ids
+        device->heap_index = i;
+        host_sim_heap[i]   = i;
+        if( instance_size != 0 )
+        {
+            device->modem_instance = malloc( instance_size );
+            if( device->modem_instance == NULL )
+            {
+                return false;
+            }
+            smtc_modem_instance_init( device->modem_instance );
+        }
+    }
+    host_sim_select_device( 0 );
+    return true;
+}
+
+uint32_t host_sim_get_nb_devices( void )
+{
+    return host_sim_nb_devices;
+}
+
+void host_sim_select_device( uint32_t device_id )
+{
+    host_sim_device = &host_sim_devices[device_id];
+    if( host_sim_device->modem_instance != NULL )
+    {
+        smtc_modem_instance_select( host_sim_device->modem_instance );
+    }
+}
+
+uint32_t host_sim_get_device_id( void )
+{
+    return ( uint32_t ) ( host_sim_device - host_sim_devices );
+}
+
+bool host_sim_nvm_open( const char* path )
+{
+    host_sim_nvm_file = fopen( path, "r+b" );
+    if( host_sim_nvm_file == NULL )
+    {
+        host_sim_nvm_file = fopen( path, "w+b" );
+    }
+    return host_sim_nvm_file != NULL;
+}
+
+bool host_sim_nvm_read( uint32_t area, uint32_t offset, uint8_t* buffer, uint32_t size )
+{
+    if( host_sim_nvm_check_access( area, offset, size ) == false )
+    {
+        return false;
+    }
+
+    while( size > 0 )
+    {
+        const uint32_t page    = offset / HOST_SIM_NVM_PAGE_SIZE;
+        const uint32_t in_page = offset % HOST_SIM_NVM_PAGE_SIZE;
+        const uint32_t room    = HOST_SIM_NVM_PAGE_SIZE - in_page;
+        const uint32_t length  = ( size < room ) ? size : room;
+        const uint8_t* content = host_sim_nvm_get_page( area, page, false );
+
+        if( content != NULL )
+        {
+            memcpy( buffer, &content[in_page], length );
+        }
+        else
+        {
+            memset( buffer, 0xFF, length );
+        }
+        buffer += length;
+        offset += length;
+        size -= length;
+    }
+    return true;
+}
+
+bool host_sim_nvm_write( uint32_t area, uint32_t offset, const uint8_t* buffer, uint32_t size )
+{
+    if( host_sim_nvm_check_access( area, offset, size ) == false )
+    {
+        return false;
+    }
+
+    while( size > 0 )
+    {
+        const uint32_t page    = offset / HOST_SIM_NVM_PAGE_SIZE;
+        const uint32_t in_page = offset % HOST_SIM_NVM_PAGE_SIZE;
+        const uint32_t room    = HOST_SIM_NVM_PAGE_SIZE - in_page;
+        const uint32_t length  = ( size < room ) ? size : room;
+        uint8_t*       content = host_sim_nvm_get_page( area, page, true );
+
+        if( content == NULL )
+        {
+            return false;
+        }
+        if( buffer != NULL )
+        {
+            memcpy( &content[in_page], buffer, length );
+            buffer += length;
+        }
+        else
+        {
+            memset( &content[in_page], 0xFF, length );
+        }
+
+        if( host_sim_nvm_file != NULL )
+        {
+            fseek( host_sim_nvm_file, host_sim_nvm_get_file_offset( area, page ) + ( long ) in_page, SEEK_SET );
+            fwrite( &content[in_page], 1, length, host_sim_nvm_file );
+        }
+        offset += length;
+        size -= length;
+    }
+
+    if( host_sim_nvm_file != NULL )
+    {
+        fflush( host_sim_nvm_file );
+    }
+    return true;
+}
+
+uint64_t host_sim_get_time_in_us( void )
+{
+    return host_sim_time_us;
+}
+
+void host_sim_advance_time_in_us( uint32_t delay_us )
+{
+    host_sim_time_us += delay_us;
+}
+
+void host_sim_sleep_for_ms( uint32_t milliseconds )
+{
+    host_sim_device->wake_up_us = host_sim_time_us + ( ( uint64_t ) milliseconds * 1000 );
+    host_sim_update_next_event( );
+
+    // The next device to run is the one with the first timer expiry or end of sleep, the lowest id on a tie
+    const uint32_t     device_id = host_sim_heap[0];
+    host_sim_device_t* device    = &host_sim_devices[device_id];
+    host_sim_timer_t*  timer     = host_sim_get_next_timer( device );
+
+    if( device->next_event_us > host_sim_time_us )
+    {
+        host_sim_time_us = device->next_event_us;
+    }
+    // The timer callbacks run in the modem instance of their device
+    host_sim_select_device( device_id );
+    if( ( timer != NULL ) && ( timer->expiry_us <= device->wake_up_us ) )
+    {
+        timer->is_running = false;
+        timer->callback( timer->context );
+        host_sim_update_next_event( );
+    }
+}
+
+void host_sim_timer_start( host_sim_timer_id_t id, uint64_t delay_us, void ( *callback )( void* context ),
+                           void* context )
+{
+    host_sim_timer_t* timer = &host_sim_device->timers[id];
+
+    timer->expiry_us  = host_sim_time_us + delay_us;
+    timer->callback   = callback;
+    timer->context    = context;
+    timer->is_running = true;
+    host_sim_update_next_event( );
+}
+
+void host_sim_timer_stop( host_sim_timer_id_t id )
+{
+    host_sim_device->timers[id].is_running = false;
+    host_sim_update_next_event( );
+}
+
+void host_sim_radio_irq_attach( void ( *callback )( void* context ), void* context )
+{
+    host_sim_device->radio_irq_callback = callback;
+    host_sim_device->radio_irq_context  = context;
+}
+
+void host_sim_radio_irq_trigger( void )
+{
+    if( host_sim_device->radio_irq_callback != NULL )
+    {
+        host_sim_device->radio_irq_callback( host_sim_device->radio_irq_context );
+    }
+}
+
+void host_sim_set_network_callback( host_sim_network_callback_t callback )
+{
+    host_sim_network_callback = callback;
+}
+
+void host_sim_set_network_tx_start_callback( host_sim_network_callback_t callback )
+{
+    host_sim_network_tx_start_callback = callback;
+}
+
+void host_sim_on_tx_start( const ral_virtual_t* radio, const ral_virtual_frame_t* frame )
+{
+    if( host_sim_network_tx_start_callback != NULL )
+    {
+        host_sim_network_tx_start_callback( radio, frame );
+    }
+}
+
+void host_sim_on_tx_done( const ral_virtual_t* radio, const ral_virtual_frame_t* frame )
+{
+    host_sim_network_stats.nb_uplinks++;
+    host_sim_network_stats.uplink_toa_us += frame->toa_in_us;
+
+    if( host_sim_network_callback != NULL )
+    {
+        host_sim_network_callback( radio, frame );
+    }
+}
+
+void host_sim_on_downlink_pushed( void )
+{
+    host_sim_network_stats.nb_downlinks++;
+}
+
+void host_sim_get_network_stats( host_sim_network_stats_t* stats )
+{
+    *stats = host_sim_network_stats;
+}
+
+uint32_t host_sim_get_random( void )
+{
+    uint32_t x = host_sim_device->random_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    host_sim_device->random_state = x;
+    return x;
+}
+
+void host_sim_set_trace( bool enable )
+{
+    host_sim_trace = enable;
+}
+
+bool host_sim_trace_is_enabled( void )
+{
+    return host_sim_trace;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static bool host_sim_nvm_check_access( uint32_t area, uint32_t offset, uint32_t size )
+{
+    return ( area < HOST_SIM_NVM_NB_AREAS ) && ( offset <= HOST_SIM_NVM_AREA_SIZE ) &&
+           ( size <= ( HOST_SIM_NVM_AREA_SIZE - offset ) );
+}
+
+static uint8_t* host_sim_nvm_get_page( uint32_t area, uint32_t page, bool allocate )
+{
+    uint8_t** content = &host_sim_device->nvm_pages[area][page];
+
+    // A page never written reads as erased flash, unless the file holds it
+    if( ( *content != NULL ) || ( ( allocate == false ) && ( host_sim_nvm_file == NULL ) ) )
+    {
+        return *content;
+    }
+
+    *content = malloc( HOST_SIM_NVM_PAGE_SIZE );
+    if( *content == NULL )
+    {
+        return NULL;
+    }
+    memset( *content, 0xFF, HOST_SIM_NVM_PAGE_SIZE );
+    if( host_sim_nvm_file != NULL )
+    {
+        // A short file leaves the end of the page erased
+        fseek( host_sim_nvm_file, host_sim_nvm_get_file_offset( area, page ), SEEK_SET );
+        if( fread( *content, 1, HOST_SIM_NVM_PAGE_SIZE, host_sim_nvm_file ) < HOST_SIM_NVM_PAGE_SIZE )
+        {
+            clearerr( host_sim_nvm_file );
+        }
+    }
+    return *content;
+}
+
+static long host_sim_nvm_get_file_offset( uint32_t area, uint32_t page )
+{
+    // The devices follow each other in the file
+    const uint64_t area_index = ( ( uint64_t ) host_sim_get_device_id( ) * HOST_SIM_NVM_NB_AREAS ) + area;
+
+    return ( long ) ( ( area_index * HOST_SIM_NVM_AREA_SIZE ) + ( ( uint64_t ) page * HOST_SIM_NVM_PAGE_SIZE ) );
+}
+
+static host_sim_timer_t* host_sim_get_next_timer( host_sim_device_t* device )
+{
+    host_sim_timer_t* next_timer = NULL;
+
+    for( int i = 0; i < HOST_SIM_TIMER_NB; i++ )
+    {
+        host_sim_timer_t* timer = &device->timers[i];
+
+        if( ( timer->is_running == true ) &&
+            ( ( next_timer == NULL ) || ( timer->expiry_us < next_timer->expiry_us ) ) )
+        {
+            next_timer = timer;
+        }
+    }
+    return next_timer;
+}
+
+static void host_sim_update_next_event( void )
+{
+    host_sim_device_t* device = host_sim_device;
+    host_sim_timer_t*  timer  = host_sim_get_next_timer( device );
+    uint32_t           index  = device->heap_index;
+
+    device->next_event_us =
+        ( ( timer != NULL ) && ( timer->expiry_us <= device->wake_up_us ) ) ? timer->expiry_us : device->wake_up_us;
+
+    // The event moves either way, sift up then down
+    while( ( index > 0 ) && host_sim_heap_is_before( host_sim_heap[index], host_sim_heap[( index - 1 ) / 2] ) )
+    {
+        host_sim_heap_swap( index, ( index - 1 ) / 2 );
+        index = ( index - 1 ) / 2;
+    }
+    while( true )
+    {
+        const uint32_t left  = ( 2 * index ) + 1;
+        const uint32_t right = left + 1;
+        uint32_t       first = index;
+
+        if( ( left < host_sim_nb_devices ) && host_sim_heap_is_before( host_sim_heap[left], host_sim_heap[first] ) )
+        {
+            first = left;
+        }
+        if( ( right < host_sim_nb_devices ) && host_sim_heap_is_before( host_sim_heap[right], host_sim_heap[first] ) )
+        {
+            first = right;
+        }
+        if( first == index )
+        {
+            break;
+        }
+        host_sim_heap_swap( index, first );
+        index = first;
+    }
+}
+
+static bool host_sim_heap_is_before( uint32_t device_id_a, uint32_t device_id_b )
+{
+    const uint64_t event_a_us = host_sim_devices[device_id_a].next_event_us;
+    const uint64_t event_b_us = host_sim_devices[device_id_b].next_event_us;
+
+    return ( event_a_us < event_b_us ) || ( ( event_a_us == event_b_us ) && ( device_id_a < device_id_b ) );
+}
+
+static void host_sim_heap_swap( uint32_t index_a, uint32_t index_b )
+{
+    const uint32_t device_id_a = host_sim_heap[index_a];
+
+    host_sim_heap[index_a]                              = host_sim_heap[index_b];
+    host_sim_heap[index_b]                              = device_id_a;
+    host_sim_devices[host_sim_heap[index_a]].heap_index = index_a;
+    host_sim_devices[host_sim_heap[index_b]].heap_index = index_b;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
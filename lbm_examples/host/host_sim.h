@@ -0,0 +1,309 @@
+/*!
+ * \file      host_sim.h
+ *
+ * \brief     Simulated time, devices and interrupts of the host (Linux) port
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "ral_virtual.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * \brief Simulated flash: one area per modem context type
+ */
+#define HOST_SIM_NVM_NB_AREAS 16
+#define HOST_SIM_NVM_PAGE_SIZE 2048
+#define HOST_SIM_NVM_NB_PAGES_PER_AREA 16
+#define HOST_SIM_NVM_AREA_SIZE ( HOST_SIM_NVM_PAGE_SIZE * HOST_SIM_NVM_NB_PAGES_PER_AREA )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * \brief Simulated timers
+ */
+typedef enum host_sim_timer_id_e
+{
+    HOST_SIM_TIMER_MODEM = 0,  //!< Timer of smtc_modem_hal_start_timer
+    HOST_SIM_TIMER_RADIO,      //!< End of the operation of the virtual radio
+    HOST_SIM_TIMER_NB,
+} host_sim_timer_id_t;
+
+/*!
+ * \brief Simulated network server, called with each frame sent by the virtual radio
+ */
+typedef void ( *host_sim_network_callback_t )( const ral_virtual_t* radio, const ral_virtual_frame_t* frame );
+
+/*!
+ * \brief Statistics of the simulated network
+ */
+typedef struct host_sim_network_stats_s
+{
+    uint32_t nb_uplinks;     //!< Frames sent by the virtual radio
+    uint32_t nb_downlinks;   //!< Frames pushed to the virtual radio
+    uint64_t uplink_toa_us;  //!< Sum of the time on air of the sent frames
+} host_sim_network_stats_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief Reset the simulated clock and network, and create the simulated devices
+ *
+ * \remark Each device has its own modem instance (smtc_modem_instance_select), timers, radio interrupt, flash and
+ * random numbers. The HAL and the virtual radio BSP work on the running device. Shall be called before smtc_modem_init.
+ *
+ * \param [in] seed       Seed of the random numbers given to the modems, a run is reproducible for a given seed
+ * \param [in] nb_devices Number of devices, more than 1 needs a modem built with LBM_MULTI_INSTANCE=yes
+ *
+ * \returns True if the devices are created, device 0 running
+ */
+bool host_sim_init( uint32_t seed, uint32_t nb_devices );
+
+/*!
+ * \brief Get the number of simulated devices
+ *
+ * \returns Number of devices
+ */
+uint32_t host_sim_get_nb_devices( void );
+
+/*!
+ * \brief Run a device: select its modem instance and peripherals
+ *
+ * \param [in] device_id Device index
+ */
+void host_sim_select_device( uint32_t device_id );
+
+/*!
+ * \brief Get the running device
+ *
+ * \returns Device index
+ */
+uint32_t host_sim_get_device_id( void );
+
+/*!
+ * \brief Back the simulated flash with a file, so that the modem contexts survive the process
+ *
+ * \remark Without file the simulated flash is erased at start up. Missing file content reads as erased flash. The
+ * flash of the devices follow each other in the file.
+ *
+ * \param [in] path File path, created if needed
+ *
+ * \returns True if the file is opened
+ */
+bool host_sim_nvm_open( const char* path );
+
+/*!
+ * \brief Read from the simulated flash of the running device
+ *
+ * \param [in]  area   Area index
+ * \param [in]  offset Offset in the area
+ * \param [out] buffer Read data
+ * \param [in]  size   Number of bytes
+ *
+ * \returns True if the access is within the area
+ */
+bool host_sim_nvm_read( uint32_t area, uint32_t offset, uint8_t* buffer, uint32_t size );
+
+/*!
+ * \brief Write to the simulated flash of the running device, and to its file if any
+ *
+ * \param [in] area   Area index
+ * \param [in] offset Offset in the area
+ * \param [in] buffer Data to write, NULL to erase to 0xFF
+ * \param [in] size   Number of bytes
+ *
+ * \returns True if the access is within the area
+ */
+bool host_sim_nvm_write( uint32_t area, uint32_t offset, const uint8_t* buffer, uint32_t size );
+
+/*!
+ * \brief Get the simulated time
+ *
+ * \remark The simulated time only moves forward in \ref host_sim_sleep_for_ms and \ref host_sim_advance_time_in_us,
+ * the time spent in the modem code is not accounted
+ *
+ * \returns Simulated time since \ref host_sim_init in microseconds
+ */
+uint64_t host_sim_get_time_in_us( void );
+
+/*!
+ * \brief Move the simulated time forward without processing the timers, for the busy-waits of the modem
+ *
+ * \param [in] delay_us Delay in microseconds
+ */
+void host_sim_advance_time_in_us( uint32_t delay_us );
+
+/*!
+ * \brief Sleep the running device in simulated time, and run the next device to wake up
+ *
+ * \remark Jumps to the first timer expiry or end of sleep among the devices, selects that device and runs its timer
+ * callback if a timer expired. Returns after at most one timer callback, like a MCU woken up by an interrupt, the
+ * modem engine of the selected device is run next. A single device sleeps until its first timer expiring in the
+ * given delay, or until the end of the delay.
+ *
+ * \param [in] milliseconds Maximum sleep duration of the running device
+ */
+void host_sim_sleep_for_ms( uint32_t milliseconds );
+
+/*!
+ * \brief Start a simulated timer of the running device, replacing the previous one of the same id
+ *
+ * \param [in] id       Timer id
+ * \param [in] delay_us Delay from now in microseconds
+ * \param [in] callback Callback called on expiry
+ * \param [in] context  Context passed to the callback
+ */
+void host_sim_timer_start( host_sim_timer_id_t id, uint64_t delay_us, void ( *callback )( void* context ),
+                           void* context );
+
+/*!
+ * \brief Stop a simulated timer of the running device
+ *
+ * \param [in] id Timer id
+ */
+void host_sim_timer_stop( host_sim_timer_id_t id );
+
+/*!
+ * \brief Attach the radio interrupt callback of the modem of the running device
+ *
+ * \param [in] callback Radio interrupt callback
+ * \param [in] context  Context passed to the callback
+ */
+void host_sim_radio_irq_attach( void ( *callback )( void* context ), void* context );
+
+/*!
+ * \brief Trigger the radio interrupt of the running device
+ */
+void host_sim_radio_irq_trigger( void );
+
+/*!
+ * \brief Set the simulated network server, called for each frame sent by the virtual radio
+ *
+ * \remark The callback can answer with \ref ral_virtual_push_rx_frame, the answer is received by the next reception
+ * window of the same packet type
+ *
+ * \param [in] callback Network callback, NULL to drop the frames
+ */
+void host_sim_set_network_callback( host_sim_network_callback_t callback );
+
+/*!
+ * \brief Set the callback telling the simulated network that a frame starts on air
+ *
+ * \remark With the start of each frame, the network knows all the frames a frame overlaps once it ends
+ *
+ * \param [in] callback Network callback, NULL to ignore the frame starts
+ */
+void host_sim_set_network_tx_start_callback( host_sim_network_callback_t callback );
+
+/*!
+ * \brief Tell the simulated network that a frame starts on air
+ *
+ * \param [in] radio Virtual radio
+ * \param [in] frame Frame being sent
+ */
+void host_sim_on_tx_start( const ral_virtual_t* radio, const ral_virtual_frame_t* frame );
+
+/*!
+ * \brief Hand a frame sent by the virtual radio to the simulated network
+ *
+ * \param [in] radio Virtual radio
+ * \param [in] frame Sent frame
+ */
+void host_sim_on_tx_done( const ral_virtual_t* radio, const ral_virtual_frame_t* frame );
+
+/*!
+ * \brief Count a frame pushed to the virtual radio by the simulated network
+ */
+void host_sim_on_downlink_pushed( void );
+
+/*!
+ * \brief Get the statistics of the simulated network
+ *
+ * \param [out] stats Statistics since \ref host_sim_init
+ */
+void host_sim_get_network_stats( host_sim_network_stats_t* stats );
+
+/*!
+ * \brief Draw a random number from the seeded generator of the running device
+ *
+ * \returns Random number
+ */
+uint32_t host_sim_get_random( void );
+
+/*!
+ * \brief Enable or disable the print of the modem traces
+ *
+ * \param [in] enable True to print the traces on stdout
+ */
+void host_sim_set_trace( bool enable );
+
+/*!
+ * \brief Tell whether the modem traces are printed
+ *
+ * \returns True if the traces are printed on stdout
+ */
+bool host_sim_trace_is_enabled( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // HOST_SIM_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,342 @@
+/*!
+ * \file      main_host_benchmark.c
+ *
+ * \brief     Host benchmark of the LoRaWAN MAC and radio planner on the virtual radio
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stdio.h>    // printf
+#include <stdlib.h>   // strtoul
+#include <string.h>   // strcmp
+#include <time.h>     // clock_gettime
+
+#include "smtc_modem_api.h"
+#include "smtc_modem_utilities.h"
+#include "smtc_modem_hal.h"
+#include "ral_virtual.h"
+#include "host_sim.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#define STACK_ID 0
+
+#define BENCH_DEFAULT_NB_UPLINKS 1000
+#define BENCH_DEFAULT_SEED 1
+#define BENCH_DEFAULT_NB_DEVICES 1
+#define BENCH_UPLINK_PORT 2
+#define BENCH_UPLINK_SIZE 12
+
+// A run stops if the uplinks are not all done within this simulated time
+#define BENCH_MAX_SIMULATED_TIME_S ( 30 * 24 * 3600 )
+
+static uint8_t bench_nwk_skey[SMTC_MODEM_KEY_LENGTH] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                                         0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+static uint8_t bench_app_skey[SMTC_MODEM_KEY_LENGTH] = { 0x3C, 0x4F, 0xCF, 0x09, 0x88, 0x15, 0xF7, 0xAB,
+                                                         0xA6, 0xD2, 0xAE, 0x28, 0x16, 0x15, 0x7E, 0x2B };
+
+// DevAddr of device 0, the next devices take the next addresses
+#define BENCH_DEV_ADDR 0x260B0001
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct bench_device_s
+{
+    uint32_t nb_uplinks_done;
+    uint32_t nb_uplinks_not_sent;
+    bool     is_running;
+} bench_device_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint32_t        bench_nb_uplinks_requested = BENCH_DEFAULT_NB_UPLINKS;
+static bench_device_t* bench_devices;
+static uint32_t        bench_nb_devices_running;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Modem event callback: connects with ABP on reset and requests the next uplink on each tx done
+ */
+static void bench_event_callback( void );
+
+/*!
+ * \brief Request the next uplink of a device, its payload carries the uplink counter
+ *
+ * \param [in] device Running device
+ */
+static void bench_request_uplink( bench_device_t* device );
+
+/*!
+ * \brief Stop a device once its uplinks are done or when its uplink request is rejected
+ *
+ * \param [in] device Running device
+ */
+static void bench_stop_device( bench_device_t* device );
+
+/*!
+ * \brief Get the wall clock time
+ *
+ * \returns Monotonic time in microseconds
+ */
+static uint64_t bench_get_wall_time_in_us( void );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+/*!
+ * \brief Send uplinks back to back through the whole modem (supervisor, LoRaWAN MAC, radio planner, RAL) on the
+ * virtual radio, in simulated time
+ *
+ * \remark Usage: host_benchmark [nb_uplinks] [seed] [-v] [-n nvm_file] [-d nb_devices]
+ * -v prints the modem traces, -n keeps the modem contexts in a file between runs, -d runs nb_devices modems in the
+ * process, each with its own modem instance, sending nb_uplinks uplinks.
+ * The run prints one line:
+ *   BENCH,mac_uplink,<nb uplinks>,<wall us per uplink>,<uplinks per wall second>,<simulated s>,<tx>,<rx timeouts>
+ * The simulated time only moves forward when the modems sleep: the wall time is the CPU cost of the modem code
+ * and a run is reproducible for a given seed.
+ */
+int main( int argc, char** argv )
+{
+    uint32_t    seed       = BENCH_DEFAULT_SEED;
+    uint32_t    nb_devices = BENCH_DEFAULT_NB_DEVICES;
+    const char* nvm_file   = NULL;
+    int         arg        = 0;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "-v" ) == 0 )
+        {
+            host_sim_set_trace( true );
+        }
+        else if( ( strcmp( argv[i], "-n" ) == 0 ) && ( ( i + 1 ) < argc ) )
+        {
+            nvm_file = argv[++i];
+        }
+        else if( ( strcmp( argv[i], "-d" ) == 0 ) && ( ( i + 1 ) < argc ) )
+        {
+            nb_devices = strtoul( argv[++i], NULL, 0 );
+        }
+        else if( arg++ == 0 )
+        {
+            bench_nb_uplinks_requested = strtoul( argv[i], NULL, 0 );
+        }
+        else
+        {
+            seed = strtoul( argv[i], NULL, 0 );
+        }
+    }
+
+    bench_devices = calloc( nb_devices, sizeof( bench_device_t ) );
+    if( ( bench_devices == NULL ) || ( host_sim_init( seed, nb_devices ) == false ) )
+    {
+        printf( "Cannot create %u devices, several devices need a modem built with LBM_MULTI_INSTANCE=yes\n",
+                nb_devices );
+        return EXIT_FAILURE;
+    }
+    if( ( nvm_file != NULL ) && ( host_sim_nvm_open( nvm_file ) == false ) )
+    {
+        printf( "Cannot open %s\n", nvm_file );
+        return EXIT_FAILURE;
+    }
+
+    const uint64_t start_wall_us = bench_get_wall_time_in_us( );
+
+    // The event callback is called at the first call to smtc_modem_run_engine because of the reset detection
+    for( uint32_t i = 0; i < nb_devices; i++ )
+    {
+        host_sim_select_device( i );
+        bench_devices[i].is_running = true;
+        smtc_modem_init( &bench_event_callback );
+    }
+    bench_nb_devices_running = nb_devices;
+    host_sim_select_device( 0 );
+
+    while( host_sim_get_time_in_us( ) < ( ( uint64_t ) BENCH_MAX_SIMULATED_TIME_S * 1000000 ) )
+    {
+        const uint32_t sleep_time_ms = smtc_modem_run_engine( );
+
+        // The events, last one included, are handled in smtc_modem_run_engine
+        if( bench_nb_devices_running == 0 )
+        {
+            break;
+        }
+        // Runs the engine of the next device to wake up
+        host_sim_sleep_for_ms( ( smtc_modem_is_irq_flag_pending( ) == false ) ? sleep_time_ms : 0 );
+    }
+
+    const uint64_t           wall_us             = bench_get_wall_time_in_us( ) - start_wall_us;
+    uint32_t                 nb_uplinks_done     = 0;
+    uint32_t                 nb_uplinks_not_sent = 0;
+    uint32_t                 nb_tx               = 0;
+    uint32_t                 nb_rx_timeout       = 0;
+    host_sim_network_stats_t stats;
+
+    for( uint32_t i = 0; i < nb_devices; i++ )
+    {
+        host_sim_select_device( i );
+
+        const ral_virtual_t* radio = ( const ral_virtual_t* ) smtc_modem_get_radio_context( );
+
+        nb_uplinks_done += bench_devices[i].nb_uplinks_done;
+        nb_uplinks_not_sent += bench_devices[i].nb_uplinks_not_sent;
+        nb_tx += radio->nb_tx;
+        nb_rx_timeout += radio->nb_rx_timeout;
+    }
+    host_sim_get_network_stats( &stats );
+
+    const uint64_t nb_uplinks         = ( nb_uplinks_done != 0 ) ? nb_uplinks_done : 1;
+    const uint64_t uplinks_per_second = ( wall_us != 0 ) ? ( ( uint64_t ) nb_uplinks_done * 1000000 / wall_us ) : 0;
+
+    printf( "BENCH,mac_uplink,%u,%llu,%llu,%llu,%u,%u\n", nb_uplinks_done,
+            ( unsigned long long ) ( wall_us / nb_uplinks ), ( unsigned long long ) uplinks_per_second,
+            ( unsigned long long ) ( host_sim_get_time_in_us( ) / 1000000 ), nb_tx, nb_rx_timeout );
+    printf( "Uplinks not sent: %u, time on air: %llu ms\n", nb_uplinks_not_sent,
+            ( unsigned long long ) ( stats.uplink_toa_us / 1000 ) );
+    if( nb_devices > 1 )
+    {
+        printf( "Devices: %u, modem instance: %u bytes\n", nb_devices, smtc_modem_instance_get_size( ) );
+    }
+
+    return ( nb_uplinks_done == ( bench_nb_uplinks_requested * nb_devices ) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void bench_event_callback( void )
+{
+    const uint32_t     device_id = host_sim_get_device_id( );
+    bench_device_t*    device    = &bench_devices[device_id];
+    smtc_modem_event_t current_event;
+    uint8_t            event_pending_count;
+
+    do
+    {
+        if( smtc_modem_get_event( &current_event, &event_pending_count ) != SMTC_MODEM_RC_OK )
+        {
+            return;
+        }
+
+        switch( current_event.event_type )
+        {
+        case SMTC_MODEM_EVENT_RESET:
+            smtc_modem_set_region( STACK_ID, SMTC_MODEM_REGION_EU_868 );
+            // The regional duty cycle would only stretch the simulated time
+            smtc_modem_debug_set_duty_cycle_state( false );
+            smtc_modem_debug_connect_with_abp( STACK_ID, BENCH_DEV_ADDR + device_id, bench_nwk_skey, bench_app_skey );
+            bench_request_uplink( device );
+            break;
+
+        case SMTC_MODEM_EVENT_TXDONE:
+            if( current_event.event_data.txdone.status == SMTC_MODEM_EVENT_TXDONE_NOT_SENT )
+            {
+                device->nb_uplinks_not_sent++;
+            }
+            else
+            {
+                device->nb_uplinks_done++;
+            }
+
+            if( device->nb_uplinks_done < bench_nb_uplinks_requested )
+            {
+                bench_request_uplink( device );
+            }
+            else
+            {
+                bench_stop_device( device );
+            }
+            break;
+
+        default:
+            break;
+        }
+    } while( event_pending_count > 0 );
+}
+
+static void bench_request_uplink( bench_device_t* device )
+{
+    uint8_t payload[BENCH_UPLINK_SIZE] = { 0 };
+
+    memcpy( payload, &device->nb_uplinks_done, sizeof( device->nb_uplinks_done ) );
+    if( smtc_modem_request_uplink( STACK_ID, BENCH_UPLINK_PORT, false, payload, sizeof( payload ) ) !=
+        SMTC_MODEM_RC_OK )
+    {
+        printf( "Device %u: uplink request rejected at %llu us\n", host_sim_get_device_id( ),
+                ( unsigned long long ) host_sim_get_time_in_us( ) );
+        bench_stop_device( device );
+    }
+}
+
+static void bench_stop_device( bench_device_t* device )
+{
+    if( device->is_running == true )
+    {
+        device->is_running = false;
+        bench_nb_devices_running--;
+    }
+}
+
+static uint64_t bench_get_wall_time_in_us( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( ( uint64_t ) now.tv_sec * 1000000 ) + ( ( uint64_t ) now.tv_nsec / 1000 );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,440 @@
+/*!
+ * \file      main_host_network_sim.c
+ *
+ * \brief     Fleet simulation of LoRa Basics Modem devices around one gateway, in simulated time
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stdio.h>    // printf
+#include <stdlib.h>   // strtoul
+#include <string.h>   // strcmp
+#include <time.h>     // clock_gettime
+
+#include "smtc_modem_api.h"
+#include "smtc_modem_utilities.h"
+#include "ral_virtual.h"
+#include "host_sim.h"
+#include "host_network.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#define STACK_ID 0
+
+#define SIM_DEFAULT_NB_DEVICES 100
+#define SIM_DEFAULT_DURATION_S ( 24 * 3600 )
+#define SIM_DEFAULT_PERIOD_S 600
+#define SIM_DEFAULT_SEED 1
+#define SIM_DEFAULT_RADIUS_M 5000
+#define SIM_DEFAULT_ADR_MARGIN_DB 10
+#define SIM_DEFAULT_PAYLOAD_SIZE 12
+#define SIM_UPLINK_PORT 2
+
+// The uplink period is drawn in +/- 1/SIM_PERIOD_JITTER_RATIO of the period, so that the devices do not stay in step
+#define SIM_PERIOD_JITTER_RATIO 10
+
+// DevEUI of device 0, the next devices take the next DevEUIs
+#define SIM_DEV_EUI 0x0016C001F0000000
+
+static const uint8_t sim_join_eui[SMTC_MODEM_EUI_LENGTH] = { 0x00, 0x16, 0xC0, 0x01, 0xFF, 0xFE, 0x00, 0x01 };
+static const uint8_t sim_nwk_key[SMTC_MODEM_KEY_LENGTH]  = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                                            0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct sim_device_s
+{
+    bool     is_joined;
+    uint64_t join_start_us;
+    uint64_t join_time_us;  //!< From the first join request to the joined event
+    uint32_t nb_uplinks_requested;
+    uint32_t nb_uplinks_rejected;
+} sim_device_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static sim_device_t*            sim_devices;
+static uint32_t                 sim_period_s       = SIM_DEFAULT_PERIOD_S;
+static uint8_t                  sim_payload_size   = SIM_DEFAULT_PAYLOAD_SIZE;
+static smtc_modem_adr_profile_t sim_adr_profile    = SMTC_MODEM_ADR_PROFILE_NETWORK_CONTROLLED;
+static uint32_t                 sim_nb_adr_refused = 0;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Modem event callback: joins after a random delay, then sends an uplink every period
+ */
+static void sim_event_callback( void );
+
+/*!
+ * \brief Start the alarm of the next join or uplink of the running device
+ *
+ * \param [in] period_s Mean delay in seconds, drawn in +/- 1/SIM_PERIOD_JITTER_RATIO
+ */
+static void sim_start_alarm( uint32_t period_s );
+
+/*!
+ * \brief Parse an ADR profile name
+ *
+ * \param [in]  name    network, long, low or link
+ * \param [out] profile ADR profile
+ *
+ * \returns True if the name is known
+ */
+static bool sim_parse_adr_profile( const char* name, smtc_modem_adr_profile_t* profile );
+
+/*!
+ * \brief Get the wall clock time
+ *
+ * \returns Monotonic time in microseconds
+ */
+static uint64_t sim_get_wall_time_in_us( void );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+/*!
+ * \brief Run a fleet of devices joining and sending periodic uplinks to one gateway, each device with its own modem
+ * instance, through the channel and network server of host_network.c
+ *
+ * \remark Usage: host_network_sim [-d nb_devices] [-t duration_s] [-p period_s] [-s seed] [-r radius_m]
+ *                [-a network|long|low|link] [-m adr_margin_db] [-l payload_size] [-v]
+ * The devices keep the regional duty cycle. The run prints the fleet KPIs:
+ *   SIM,<devices>,<simulated s>,<uplinks>,<delivered>,<delivery %>,<collisions>,<below sensitivity>,
+ *       <uAh per uplink>,<joined>,<mean join s>,<max join s>,<wall s>
+ * then the uplinks per spreading factor and the highest duty cycle used by a device.
+ */
+int main( int argc, char** argv )
+{
+    uint32_t              nb_devices = SIM_DEFAULT_NB_DEVICES;
+    uint32_t              duration_s = SIM_DEFAULT_DURATION_S;
+    uint32_t              seed       = SIM_DEFAULT_SEED;
+    host_network_config_t config     = {
+            .radius_in_m      = SIM_DEFAULT_RADIUS_M,
+            .adr_margin_in_db = SIM_DEFAULT_ADR_MARGIN_DB,
+    };
+
+    memcpy( config.nwk_key, sim_nwk_key, SMTC_MODEM_KEY_LENGTH );
+
+    for( int i = 1; i < argc; i++ )
+    {
+        const bool has_value = ( i + 1 ) < argc;
+
+        if( strcmp( argv[i], "-v" ) == 0 )
+        {
+            host_sim_set_trace( true );
+        }
+        else if( ( strcmp( argv[i], "-d" ) == 0 ) && ( has_value == true ) )
+        {
+            nb_devices = strtoul( argv[++i], NULL, 0 );
+        }
+        else if( ( strcmp( argv[i], "-t" ) == 0 ) && ( has_value == true ) )
+        {
+            duration_s = strtoul( argv[++i], NULL, 0 );
+        }
+        else if( ( strcmp( argv[i], "-p" ) == 0 ) && ( has_value == true ) )
+        {
+            sim_period_s = strtoul( argv[++i], NULL, 0 );
+        }
+        else if( ( strcmp( argv[i], "-s" ) == 0 ) && ( has_value == true ) )
+        {
+            seed = strtoul( argv[++i], NULL, 0 );
+        }
+        else if( ( strcmp( argv[i], "-r" ) == 0 ) && ( has_value == true ) )
+        {
+            config.radius_in_m = strtoul( argv[++i], NULL, 0 );
+        }
+        else if( ( strcmp( argv[i], "-a" ) == 0 ) && ( has_value == true ) &&
+                 ( sim_parse_adr_profile( argv[i + 1], &sim_adr_profile ) == true ) )
+        {
+            i++;
+        }
+        else if( ( strcmp( argv[i], "-m" ) == 0 ) && ( has_value == true ) )
+        {
+            config.adr_margin_in_db = ( uint8_t ) strtoul( argv[++i], NULL, 0 );
+        }
+        else if( ( strcmp( argv[i], "-l" ) == 0 ) && ( has_value == true ) )
+        {
+            sim_payload_size = ( uint8_t ) strtoul( argv[++i], NULL, 0 );
+        }
+        else
+        {
+            printf( "Usage: host_network_sim [-d nb_devices] [-t duration_s] [-p period_s] [-s seed] [-r radius_m]\n"
+                    "                        [-a network|long|low|link] [-m adr_margin_db] [-l payload_size] [-v]\n" );
+            return EXIT_FAILURE;
+        }
+    }
+    if( sim_period_s < 2 )
+    {
+        sim_period_s = 2;
+    }
+
+    sim_devices = calloc( nb_devices, sizeof( sim_device_t ) );
+    if( ( sim_devices == NULL ) || ( host_sim_init( seed, nb_devices ) == false ) ||
+        ( host_network_init( &config, nb_devices, seed ) == false ) )
+    {
+        printf( "Cannot create %u devices, several devices need a modem built with LBM_MULTI_INSTANCE=yes\n",
+                nb_devices );
+        return EXIT_FAILURE;
+    }
+
+    const uint64_t start_wall_us = sim_get_wall_time_in_us( );
+    const uint64_t end_us        = ( uint64_t ) duration_s * 1000000;
+
+    // The event callback is called at the first call to smtc_modem_run_engine because of the reset detection
+    for( uint32_t i = 0; i < nb_devices; i++ )
+    {
+        host_sim_select_device( i );
+        smtc_modem_init( &sim_event_callback );
+    }
+    host_sim_select_device( 0 );
+
+    while( host_sim_get_time_in_us( ) < end_us )
+    {
+        const uint32_t sleep_time_ms = smtc_modem_run_engine( );
+
+        // Runs the engine of the next device to wake up
+        host_sim_sleep_for_ms( ( smtc_modem_is_irq_flag_pending( ) == false ) ? sleep_time_ms : 0 );
+    }
+
+    const uint64_t     wall_us             = sim_get_wall_time_in_us( ) - start_wall_us;
+    const uint64_t     sim_us              = host_sim_get_time_in_us( );
+    uint64_t           charge_uah          = 0;
+    uint64_t           max_tx_time_us      = 0;
+    uint64_t           join_time_sum_us    = 0;
+    uint64_t           join_time_max_us    = 0;
+    uint32_t           nb_joined           = 0;
+    uint32_t           nb_uplinks_rejected = 0;
+    host_network_kpi_t kpi;
+
+    for( uint32_t i = 0; i < nb_devices; i++ )
+    {
+        uint32_t device_charge_uah = 0;
+
+        host_sim_select_device( i );
+
+        const ral_virtual_t* radio = ( const ral_virtual_t* ) smtc_modem_get_radio_context( );
+
+        smtc_modem_get_charge_uah( &device_charge_uah );
+        charge_uah += device_charge_uah;
+        if( radio->tx_time_in_us > max_tx_time_us )
+        {
+            max_tx_time_us = radio->tx_time_in_us;
+        }
+        if( sim_devices[i].is_joined == true )
+        {
+            nb_joined++;
+            join_time_sum_us += sim_devices[i].join_time_us;
+            if( sim_devices[i].join_time_us > join_time_max_us )
+            {
+                join_time_max_us = sim_devices[i].join_time_us;
+            }
+        }
+        nb_uplinks_rejected += sim_devices[i].nb_uplinks_rejected;
+    }
+    host_network_get_kpi( &kpi );
+
+    const uint32_t nb_uplinks = ( kpi.nb_uplinks != 0 ) ? kpi.nb_uplinks : 1;
+
+    printf( "SIM,%u,%llu,%u,%u,%.1f,%u,%u,%.2f,%u,%.1f,%.1f,%.1f\n", nb_devices,
+            ( unsigned long long ) ( sim_us / 1000000 ), kpi.nb_uplinks, kpi.nb_uplinks_delivered,
+            100.0 * kpi.nb_uplinks_delivered / nb_uplinks, kpi.nb_lost_collision, kpi.nb_lost_below_sensitivity,
+            ( double ) charge_uah / nb_uplinks, nb_joined,
+            ( nb_joined != 0 ) ? ( ( double ) join_time_sum_us / nb_joined / 1e6 ) : 0.0, join_time_max_us / 1e6,
+            wall_us / 1e6 );
+    for( uint8_t sf = 0; sf < HOST_NETWORK_NB_SF; sf++ )
+    {
+        if( kpi.nb_uplinks_per_sf[sf] != 0 )
+        {
+            printf( "SF%u: %u uplinks, %.1f%% delivered\n", sf + HOST_NETWORK_SF_MIN, kpi.nb_uplinks_per_sf[sf],
+                    100.0 * kpi.nb_uplinks_delivered_per_sf[sf] / kpi.nb_uplinks_per_sf[sf] );
+        }
+    }
+    printf( "Join requests: %u, join accepts: %u, LinkADRReq: %u, uplinks not requested: %u\n",
+            kpi.nb_join_requests, kpi.nb_join_accepts, kpi.nb_adr_requests, nb_uplinks_rejected );
+    printf( "Highest device duty cycle: %.3f%%\n", ( sim_us != 0 ) ? ( 100.0 * max_tx_time_us / sim_us ) : 0.0 );
+    if( sim_nb_adr_refused != 0 )
+    {
+        printf( "ADR profile refused by %u devices, is it built in the modem?\n", sim_nb_adr_refused );
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void sim_event_callback( void )
+{
+    sim_device_t*      device = &sim_devices[host_sim_get_device_id( )];
+    smtc_modem_event_t current_event;
+    uint8_t            event_pending_count;
+
+    do
+    {
+        if( smtc_modem_get_event( &current_event, &event_pending_count ) != SMTC_MODEM_RC_OK )
+        {
+            return;
+        }
+
+        switch( current_event.event_type )
+        {
+        case SMTC_MODEM_EVENT_RESET:
+        {
+            const uint64_t dev_eui = SIM_DEV_EUI + host_sim_get_device_id( );
+            uint8_t        dev_eui_bytes[SMTC_MODEM_EUI_LENGTH];
+
+            for( uint8_t i = 0; i < SMTC_MODEM_EUI_LENGTH; i++ )
+            {
+                dev_eui_bytes[i] = ( uint8_t ) ( dev_eui >> ( 8 * ( SMTC_MODEM_EUI_LENGTH - 1 - i ) ) );
+            }
+            smtc_modem_set_region( STACK_ID, SMTC_MODEM_REGION_EU_868 );
+            smtc_modem_set_deveui( STACK_ID, dev_eui_bytes );
+            smtc_modem_set_joineui( STACK_ID, sim_join_eui );
+            smtc_modem_set_nwkkey( STACK_ID, sim_nwk_key );
+            // The devices do not all power up at once
+            sim_start_alarm( sim_period_s );
+            break;
+        }
+
+        case SMTC_MODEM_EVENT_ALARM:
+            if( device->is_joined == false )
+            {
+                device->join_start_us = host_sim_get_time_in_us( );
+                smtc_modem_join_network( STACK_ID );
+            }
+            else
+            {
+                uint8_t payload[255] = { 0 };
+
+                memcpy( payload, &device->nb_uplinks_requested, sizeof( device->nb_uplinks_requested ) );
+                if( smtc_modem_request_uplink( STACK_ID, SIM_UPLINK_PORT, false, payload, sim_payload_size ) ==
+                    SMTC_MODEM_RC_OK )
+                {
+                    device->nb_uplinks_requested++;
+                }
+                else
+                {
+                    // Duty cycle or previous uplink still pending
+                    device->nb_uplinks_rejected++;
+                }
+                sim_start_alarm( sim_period_s );
+            }
+            break;
+
+        case SMTC_MODEM_EVENT_JOINED:
+            device->is_joined    = true;
+            device->join_time_us = host_sim_get_time_in_us( ) - device->join_start_us;
+            if( smtc_modem_adr_set_profile( STACK_ID, sim_adr_profile, NULL ) != SMTC_MODEM_RC_OK )
+            {
+                sim_nb_adr_refused++;
+            }
+            sim_start_alarm( sim_period_s );
+            break;
+
+        default:
+            break;
+        }
+    } while( event_pending_count > 0 );
+}
+
+static void sim_start_alarm( uint32_t period_s )
+{
+    const uint32_t jitter_s = period_s / SIM_PERIOD_JITTER_RATIO;
+    uint32_t       delay_s  = period_s - jitter_s;
+
+    if( jitter_s != 0 )
+    {
+        delay_s += host_sim_get_random( ) % ( ( 2 * jitter_s ) + 1 );
+    }
+    smtc_modem_alarm_start_timer( ( delay_s != 0 ) ? delay_s : 1 );
+}
+
+static bool sim_parse_adr_profile( const char* name, smtc_modem_adr_profile_t* profile )
+{
+    if( strcmp( name, "network" ) == 0 )
+    {
+        *profile = SMTC_MODEM_ADR_PROFILE_NETWORK_CONTROLLED;
+    }
+    else if( strcmp( name, "long" ) == 0 )
+    {
+        *profile = SMTC_MODEM_ADR_PROFILE_MOBILE_LONG_RANGE;
+    }
+    else if( strcmp( name, "low" ) == 0 )
+    {
+        *profile = SMTC_MODEM_ADR_PROFILE_MOBILE_LOW_POWER;
+    }
+    else if( strcmp( name, "link" ) == 0 )
+    {
+        *profile = SMTC_MODEM_ADR_PROFILE_LINK_QUALITY;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static uint64_t sim_get_wall_time_in_us( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( ( uint64_t ) now.tv_sec * 1000000 ) + ( ( uint64_t ) now.tv_nsec / 1000 );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
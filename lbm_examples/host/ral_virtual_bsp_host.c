@@ -0,0 +1,117 @@
+/*!
+ * \file      ral_virtual_bsp_host.c
+ *
+ * \brief     Implements the BSP (BoardSpecificPackage) HAL functions for the virtual radio on the host
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "ral_virtual.h"
+#include "ral_virtual_bsp.h"
+#include "host_sim.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief End of the operation of the virtual radio, raises the radio interrupt of the modem if needed
+ *
+ * \param [in] context Virtual radio context
+ */
+static void ral_virtual_bsp_on_irq_timer( void* context );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void ral_virtual_bsp_start_irq_timer( const void* context, uint32_t delay_in_us )
+{
+    host_sim_timer_start( HOST_SIM_TIMER_RADIO, delay_in_us, ral_virtual_bsp_on_irq_timer, ( void* ) context );
+}
+
+void ral_virtual_bsp_stop_irq_timer( const void* context )
+{
+    host_sim_timer_stop( HOST_SIM_TIMER_RADIO );
+}
+
+void ral_virtual_bsp_on_tx_start( const void* context, const ral_virtual_frame_t* frame )
+{
+    host_sim_on_tx_start( ( const ral_virtual_t* ) context, frame );
+}
+
+void ral_virtual_bsp_on_tx_done( const void* context, const ral_virtual_frame_t* frame )
+{
+    host_sim_on_tx_done( ( const ral_virtual_t* ) context, frame );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void ral_virtual_bsp_on_irq_timer( void* context )
+{
+    if( ral_virtual_on_irq_timer( context ) == true )
+    {
+        host_sim_radio_irq_trigger( );
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
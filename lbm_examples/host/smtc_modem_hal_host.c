@@ -0,0 +1,352 @@
+/*!
+ * \file      smtc_modem_hal_host.c
+ *
+ * \brief     Modem HAL of the host (Linux) port, running on the simulated time of host_sim
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stdio.h>    // printf
+#include <stdlib.h>   // exit
+#include <stdarg.h>   // variadic args
+#include <string.h>   // memcpy
+
+#include "smtc_modem_hal.h"
+#include "host_sim.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#ifndef MIN
+#define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint8_t crashlog_buff[CRASH_LOG_SIZE];
+static uint8_t crashlog_length;
+static bool    crashlog_available;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Stop on a context access out of the simulated flash
+ *
+ * \param [in] is_valid Result of the access
+ * \param [in] ctx_type Context type
+ */
+static void host_nvm_check( bool is_valid, const modem_context_type_t ctx_type );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+/* ------------ Reset management ------------*/
+
+void smtc_modem_hal_reset_mcu( void )
+{
+    // There is no way to restart the modem from scratch in the host process
+    printf( "Modem requested a MCU reset at %llu us\n", ( unsigned long long ) host_sim_get_time_in_us( ) );
+    exit( EXIT_FAILURE );
+}
+
+/* ------------ Watchdog management ------------*/
+
+void smtc_modem_hal_reload_wdog( void )
+{
+}
+
+/* ------------ Time management ------------*/
+
+// The modem busy-polls the time until the exact start of the radio tasks: each read moves the simulated time
+// forward by 1 us so that these waits end
+
+uint32_t smtc_modem_hal_get_time_in_s( void )
+{
+    host_sim_advance_time_in_us( 1 );
+    return ( uint32_t ) ( host_sim_get_time_in_us( ) / 1000000 );
+}
+
+uint32_t smtc_modem_hal_get_time_in_ms( void )
+{
+    host_sim_advance_time_in_us( 1 );
+    return ( uint32_t ) ( host_sim_get_time_in_us( ) / 1000 );
+}
+
+uint32_t smtc_modem_hal_get_time_in_us( void )
+{
+    host_sim_advance_time_in_us( 1 );
+    return ( uint32_t ) host_sim_get_time_in_us( );
+}
+
+void smtc_modem_hal_set_offset_to_test_wrapping( const uint32_t offset_to_test_wrapping )
+{
+    host_sim_advance_time_in_us( offset_to_test_wrapping );
+}
+
+/* ------------ Timer management ------------*/
+
+void smtc_modem_hal_start_timer( const uint32_t milliseconds, void ( *callback )( void* context ), void* context )
+{
+    host_sim_timer_start( HOST_SIM_TIMER_MODEM, ( uint64_t ) milliseconds * 1000, callback, context );
+}
+
+void smtc_modem_hal_stop_timer( void )
+{
+    host_sim_timer_stop( HOST_SIM_TIMER_MODEM );
+}
+
+/* ------------ IRQ management ------------*/
+
+void smtc_modem_hal_disable_modem_irq( void )
+{
+    // The simulated interrupts only run from host_sim_sleep_for_ms, never inside the modem code
+}
+
+void smtc_modem_hal_enable_modem_irq( void )
+{
+}
+
+/* ------------ Context saving management ------------*/
+
+void smtc_modem_hal_context_restore( const modem_context_type_t ctx_type, uint32_t offset, uint8_t* buffer,
+                                     const uint32_t size )
+{
+    host_nvm_check( host_sim_nvm_read( ctx_type, offset, buffer, size ), ctx_type );
+}
+
+void smtc_modem_hal_context_store( const modem_context_type_t ctx_type, uint32_t offset, const uint8_t* buffer,
+                                   const uint32_t size )
+{
+    host_nvm_check( host_sim_nvm_write( ctx_type, offset, buffer, size ), ctx_type );
+}
+
+void smtc_modem_hal_context_flash_pages_erase( const modem_context_type_t ctx_type, uint32_t offset, uint8_t nb_page )
+{
+    host_nvm_check( host_sim_nvm_write( ctx_type, offset, NULL, nb_page * HOST_SIM_NVM_PAGE_SIZE ), ctx_type );
+}
+
+/* ------------ crashlog management ------------*/
+
+void smtc_modem_hal_crashlog_store( const uint8_t* crash_string, uint8_t crash_string_length )
+{
+    crashlog_length = MIN( crash_string_length, CRASH_LOG_SIZE );
+    memcpy( crashlog_buff, crash_string, crashlog_length );
+    crashlog_available = true;
+}
+
+void smtc_modem_hal_crashlog_restore( uint8_t* crash_string, uint8_t* crash_string_length )
+{
+    *crash_string_length = crashlog_length;
+    memcpy( crash_string, crashlog_buff, crashlog_length );
+}
+
+void smtc_modem_hal_crashlog_set_status( bool available )
+{
+    crashlog_available = available;
+}
+
+bool smtc_modem_hal_crashlog_get_status( void )
+{
+    return crashlog_available;
+}
+
+/* ------------ assert management ------------*/
+
+void smtc_modem_hal_on_panic( uint8_t* func, uint32_t line, const char* fmt, ... )
+{
+    va_list args;
+
+    printf( "Modem panic: %s:%u ", func, line );
+    va_start( args, fmt );
+    vprintf( fmt, args );
+    va_end( args );
+    printf( "\n" );
+
+    smtc_modem_hal_reset_mcu( );
+}
+
+/* ------------ Random management ------------*/
+
+uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint32_t val_2 )
+{
+    const uint32_t min = MIN( val_1, val_2 );
+    const uint32_t max = ( val_1 > val_2 ) ? val_1 : val_2;
+    const uint64_t n   = ( uint64_t ) max - min + 1;
+
+    return min + ( uint32_t ) ( host_sim_get_random( ) % n );
+}
+
+/* ------------ Radio env management ------------*/
+
+void smtc_modem_hal_irq_config_radio_irq( void ( *callback )( void* context ), void* context )
+{
+    host_sim_radio_irq_attach( callback, context );
+}
+
+void smtc_modem_hal_start_radio_tcxo( void )
+{
+}
+
+void smtc_modem_hal_stop_radio_tcxo( void )
+{
+}
+
+uint32_t smtc_modem_hal_get_radio_tcxo_startup_delay_ms( void )
+{
+    return 0;
+}
+
+void smtc_modem_hal_set_ant_switch( bool is_tx_on )
+{
+}
+
+/* ------------ Environment management ------------*/
+
+uint8_t smtc_modem_hal_get_battery_level( void )
+{
+    // The end-device is connected to an external power source
+    return 0;
+}
+
+uint32_t smtc_modem_hal_get_sleep_current_ua( void )
+{
+    // The simulated device has no sleep current
+    return 0;
+}
+
+int8_t smtc_modem_hal_get_board_delay_ms( void )
+{
+    // The virtual radio has no latency
+    return 0;
+}
+
+/* ------------ Trace management ------------*/
+
+void smtc_modem_hal_print_trace( const char* fmt, ... )
+{
+    if( host_sim_trace_is_enabled( ) == true )
+    {
+        va_list args;
+        va_start( args, fmt );
+        vprintf( fmt, args );
+        va_end( args );
+    }
+}
+
+/* ------------ Needed for Cloud  ------------*/
+
+int8_t smtc_modem_hal_get_temperature( void )
+{
+    return 25;
+}
+
+uint16_t smtc_modem_hal_get_voltage_mv( void )
+{
+    return 3300;
+}
+
+/* ------------ Needed for Store and Forward, MAC journal and Stream spill  ------------*/
+
+uint16_t smtc_modem_hal_store_and_forward_get_number_of_pages( void )
+{
+    return HOST_SIM_NVM_NB_PAGES_PER_AREA;
+}
+
+uint16_t smtc_modem_hal_flash_get_page_size( void )
+{
+    return HOST_SIM_NVM_PAGE_SIZE;
+}
+
+uint16_t smtc_modem_hal_mac_journal_get_number_of_pages( void )
+{
+    return HOST_SIM_NVM_NB_PAGES_PER_AREA;
+}
+
+uint16_t smtc_modem_hal_stream_spill_get_number_of_pages( void )
+{
+    return HOST_SIM_NVM_NB_PAGES_PER_AREA;
+}
+
+/* ------------ For Real Time OS compatibility  ------------*/
+
+void smtc_modem_hal_user_lbm_irq( void )
+{
+    // Do nothing, the host port is single threaded
+}
+
+void smtc_modem_hal_lock_modem( void )
+{
+}
+
+void smtc_modem_hal_unlock_modem( void )
+{
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void host_nvm_check( bool is_valid, const modem_context_type_t ctx_type )
+{
+    if( is_valid == false )
+    {
+        printf( "Context %u access out of the simulated flash\n", ctx_type );
+        exit( EXIT_FAILURE );
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -41,6 +41,7 @@
 #include <stdbool.h>  // bool type
 
 #include "cmd_parser.h"
+#include "hw_modem.h"
 
 #include "smtc_modem_test_api.h"
 #include "smtc_modem_api.h"
@@ -80,6 +81,9 @@
 #endif
 
 #define MODEM_MAX_INFO_FIELD_SIZE 19
+
+// Spectral survey channels returned by one CMD_TST_SURVEY_GET, 4 bytes each after the count
+#define CMD_TST_SURVEY_GET_MAX_CHANNELS 60
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -279,6 +283,14 @@ static const uint8_t host_cmd_tab[CMD_MAX][HOST_CMD_TAB_IDX_COUNT] = {
     [CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF] = { 1, 0, 0 },
     [CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF] = { 1, 1, 1 },
     [CMD_MODEM_GET_CRASHLOG]                 = { 1, 0, 0 },
+    [CMD_GET_RP_TRACE]                       = { 1, 0, 0 },
+    [CMD_GET_PROFILE]                        = { 1, 1, 1 },
+    [CMD_GET_EVENTS]                         = { 1, 1, 1 },
+    [CMD_BATCH]                              = { 1, 2, 255 },
+    [CMD_SET_UART_BAUDRATE]                  = { 1, 4, 4 },
+    [CMD_STORE_AND_FORWARD_ADD_CHUNK]        = { 1, 4, 255 },
+    [CMD_GET_LATENCY]                        = { 1, 1, 1 },
+    [CMD_GET_STATUS_SNAPSHOT]                = { 1, 0, 0 },
 };
 
 /**
@@ -306,6 +318,10 @@ static const uint8_t host_cmd_test_tab[CMD_TST_MAX][HOST_CMD_TAB_IDX_COUNT] = {
     [CMD_TST_WATCHDOG]         = { 1, 0, 0 },    //
     [CMD_TST_RADIO_READ]       = { 1, 0, 255 },  //
     [CMD_TST_RADIO_WRITE]      = { 1, 0, 255 },  //
+    [CMD_TST_SURVEY]           = { 1, 16, 16 },  //
+    [CMD_TST_SURVEY_GET]       = { 1, 1, 1 },    //
+    [CMD_TST_PER]              = { 1, 11, 56 },  //
+    [CMD_TST_PER_GET]          = { 1, 1, 1 },    //
 };
 
 #if HAL_DBG_TRACE == HAL_FEATURE_ON
@@ -451,6 +467,14 @@ static const char* host_cmd_str[CMD_MAX] = {
     [CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF] = "CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF",
     [CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF] = "CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF",
     [CMD_MODEM_GET_CRASHLOG]                 = "CMD_GET_CRASHLOG",
+    [CMD_GET_RP_TRACE]                       = "CMD_GET_RP_TRACE",
+    [CMD_GET_PROFILE]                        = "CMD_GET_PROFILE",
+    [CMD_GET_EVENTS]                         = "CMD_GET_EVENTS",
+    [CMD_BATCH]                              = "CMD_BATCH",
+    [CMD_SET_UART_BAUDRATE]                  = "CMD_SET_UART_BAUDRATE",
+    [CMD_STORE_AND_FORWARD_ADD_CHUNK]        = "CMD_STORE_AND_FORWARD_ADD_CHUNK",
+    [CMD_GET_LATENCY]                        = "CMD_GET_LATENCY",
+    [CMD_GET_STATUS_SNAPSHOT]                = "CMD_GET_STATUS_SNAPSHOT",
 };
 #endif
 
@@ -479,6 +503,10 @@ static const char* host_cmd_test_str[CMD_TST_MAX] = {
     [CMD_TST_WATCHDOG]         = "WATCHDOG",
     [CMD_TST_RADIO_READ]       = "RADIO_READ",
     [CMD_TST_RADIO_WRITE]      = "RADIO_WRITE",
+    [CMD_TST_SURVEY]           = "SURVEY",
+    [CMD_TST_SURVEY_GET]       = "SURVEY_GET",
+    [CMD_TST_PER]              = "PER",
+    [CMD_TST_PER_GET]          = "PER_GET",
 };
 #endif
 
@@ -583,6 +611,23 @@ static cmd_length_valid_t cmd_test_parser_check_cmd_size( host_cmd_test_id_t tes
  * @return uint32_t The calculated CRC
  */
 uint32_t cmd_parser_crc( const uint8_t* buf, int len );
+
+/**
+ * @brief Serialize an event as returned by CMD_GET_EVENT
+ *
+ * @param [in]  event  Event to serialize
+ * @param [out] buffer Output buffer, at least 4 bytes
+ * @return uint8_t Number of bytes written
+ */
+static uint8_t cmd_parser_event_to_buffer( const smtc_modem_event_t* event, uint8_t* buffer );
+
+/**
+ * @brief Run the sub-commands of a CMD_BATCH frame
+ *
+ * @param [in]  cmd_input  Batch command, payload made of [cmd_code][length][payload] sub-commands
+ * @param [out] cmd_output Batch response, made of [return_code][length][payload] sub-responses
+ */
+static void cmd_parser_batch( const cmd_input_t* cmd_input, cmd_response_t* cmd_output );
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -623,115 +668,98 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
             break;
         }
 
-        // buffer[0]: event type
-        cmd_output->buffer[0] = events_lut[current_event.event_type];
+        cmd_output->length = cmd_parser_event_to_buffer( &current_event, cmd_output->buffer );
 
-        // buffer[1]: missed event
-        cmd_output->buffer[1] = current_event.missed_events;
+        // Handle event_pending_count
+        if( event_pending_count == 0 )
+        {
+            // de-assert hw_modem irq line to indicate host that all events have been retrieved
+            hal_gpio_set_value( HW_MODEM_EVENT_PIN, 0 );
+        }
+        break;
+    }
+    case CMD_GET_EVENTS:
+    {
+        // Per event: length of the CMD_GET_EVENT bytes, the CMD_GET_EVENT bytes, timestamp_ms (4 bytes), fcnt
+        // (4 bytes), downlink rssi, snr and fport, multi-byte fields are big endian. At most 15 events of 16 bytes
+        const uint8_t             max_events          = ( cmd_input->buffer[0] < 15 ) ? cmd_input->buffer[0] : 15;
+        uint8_t                   nb_events           = 0;
+        uint8_t                   event_pending_count = 0;
+        smtc_modem_event_record_t record;
 
-        // buffer[2-N]; event data, depend on event_type
-        switch( current_event.event_type )
+        cmd_output->return_code = CMD_RC_NO_EVENT;
+        cmd_output->length      = 0;
+        while( nb_events < max_events )
         {
-        case SMTC_MODEM_EVENT_RESET:
-            cmd_output->buffer[2] = ( uint8_t ) ( current_event.event_data.reset.count >> 8 );
-            cmd_output->buffer[3] = ( uint8_t ) ( current_event.event_data.reset.count );
-            cmd_output->length    = 4;
-            break;
-        case SMTC_MODEM_EVENT_TXDONE:
-            cmd_output->buffer[2] = current_event.event_data.txdone.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_LINK_CHECK:
-            cmd_output->buffer[2] = current_event.event_data.link_check.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
-            cmd_output->buffer[2] = current_event.event_data.class_b_ping_slot_info.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_CLASS_B_STATUS:
-            cmd_output->buffer[2] = current_event.event_data.class_b_status.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
-            cmd_output->buffer[2] = current_event.event_data.lorawan_mac_time.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
-            cmd_output->buffer[2] = current_event.event_data.fuota_status.successful;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
-            cmd_output->buffer[2] = current_event.event_data.new_multicast_class_c.group_id;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
-            cmd_output->buffer[2] = current_event.event_data.new_multicast_class_b.group_id;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
-            cmd_output->buffer[2] = current_event.event_data.fmp.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_UPLOAD_DONE:
-            cmd_output->buffer[2] = current_event.event_data.uploaddone.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_DM_SET_CONF:
-            cmd_output->buffer[2] = current_event.event_data.setconf.opcode;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_MUTE:
-            cmd_output->buffer[2] = current_event.event_data.mute.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_DOWNDATA:
-        case SMTC_MODEM_EVENT_ALCSYNC_TIME:
-        case SMTC_MODEM_EVENT_ALARM:
-        case SMTC_MODEM_EVENT_JOINED:
-        case SMTC_MODEM_EVENT_JOINFAIL:
-        case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
-        case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
-        case SMTC_MODEM_EVENT_STREAM_DONE:
-        case SMTC_MODEM_EVENT_GNSS_SCAN_DONE:
-        case SMTC_MODEM_EVENT_GNSS_TERMINATED:
-        case SMTC_MODEM_EVENT_GNSS_ALMANAC_DEMOD_UPDATE:
-        case SMTC_MODEM_EVENT_WIFI_SCAN_DONE:
-        case SMTC_MODEM_EVENT_WIFI_TERMINATED:
-            cmd_output->length = 2;
-            break;
+            uint8_t                    nb_read = 0;
+            const cmd_serial_rc_code_t rc =
+                rc_lut[smtc_modem_get_events( &record, 1, &nb_read, &event_pending_count )];
+            if( rc != CMD_RC_OK )
+            {
+                if( nb_events == 0 )
+                {
+                    cmd_output->return_code = rc;
+                }
+                break;
+            }
+            uint8_t* out   = &cmd_output->buffer[cmd_output->length];
+            uint8_t  index = 0;
 
-        case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
-        case SMTC_MODEM_EVENT_RELAY_TX_MODE:
-        case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
-            cmd_output->buffer[2] = current_event.event_data.relay_tx.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_RELAY_RX_RUNNING:
-            cmd_output->buffer[2] = current_event.event_data.relay_rx.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_TEST_MODE:
-            cmd_output->buffer[2] = current_event.event_data.test_mode_status.status;
-            cmd_output->length    = 3;
-            break;
-        case SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE:
-            cmd_output->buffer[2] = current_event.event_data.regional_duty_cycle.status;
-            cmd_output->length    = 3;
-            break;
-        default:
-            cmd_output->length = 0;
-            break;
+            out[0] = cmd_parser_event_to_buffer( &record.event, &out[1] );
+            index  = 1 + out[0];
+
+            out[index++] = ( record.timestamp_ms >> 24 ) & 0xff;
+            out[index++] = ( record.timestamp_ms >> 16 ) & 0xff;
+            out[index++] = ( record.timestamp_ms >> 8 ) & 0xff;
+            out[index++] = ( record.timestamp_ms & 0xff );
+            out[index++] = ( record.fcnt >> 24 ) & 0xff;
+            out[index++] = ( record.fcnt >> 16 ) & 0xff;
+            out[index++] = ( record.fcnt >> 8 ) & 0xff;
+            out[index++] = ( record.fcnt & 0xff );
+            out[index++] = record.dl_metadata.rssi;
+            out[index++] = record.dl_metadata.snr;
+            out[index++] = record.dl_metadata.fport;
+
+            cmd_output->return_code = CMD_RC_OK;
+            cmd_output->length += index;
+            nb_events++;
         }
 
-        // Handle event_pending_count
-        if( event_pending_count == 0 )
+        if( ( ( cmd_output->return_code == CMD_RC_OK ) || ( cmd_output->return_code == CMD_RC_NO_EVENT ) ) &&
+            ( event_pending_count == 0 ) )
         {
             // de-assert hw_modem irq line to indicate host that all events have been retrieved
             hal_gpio_set_value( HW_MODEM_EVENT_PIN, 0 );
         }
         break;
     }
+    case CMD_BATCH:
+    {
+        cmd_parser_batch( cmd_input, cmd_output );
+        break;
+    }
+    case CMD_SET_UART_BAUDRATE:
+    {
+#if defined( USE_HW_MODEM_SPI )
+        // the host interface is clocked by the host
+        cmd_output->return_code = CMD_RC_NOT_IMPLEMENTED;
+#else
+        const uint32_t baudrate = ( ( uint32_t ) cmd_input->buffer[0] << 24 ) |
+                                  ( ( uint32_t ) cmd_input->buffer[1] << 16 ) |
+                                  ( ( uint32_t ) cmd_input->buffer[2] << 8 ) | cmd_input->buffer[3];
+
+        if( ( baudrate != 115200 ) && ( baudrate != 230400 ) && ( baudrate != 460800 ) && ( baudrate != 921600 ) )
+        {
+            cmd_output->return_code = CMD_RC_INVALID;
+        }
+        else
+        {
+            // this response is still sent at the current baudrate
+            hw_modem_set_uart_baudrate_after_response( baudrate );
+        }
+#endif
+        break;
+    }
     case CMD_GET_DOWNLINK_DATA:
     {
         cmd_output->return_code = rc_lut[smtc_modem_get_downlink_data( &cmd_output->buffer[2], &cmd_output->buffer[1],
@@ -1797,6 +1825,51 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
         }
         break;
     }
+    case CMD_GET_STATUS_SNAPSHOT:
+    {
+        // status (4), region, class, uplink fcnt (4), next datarate, next tx power, nb_trans, next max payload,
+        // duty-cycle status (4), lost connection counter (2), charge in uAh (4), pending events, modem time in s (4),
+        // multi-byte fields are big endian
+        smtc_modem_status_snapshot_t snapshot;
+        cmd_output->return_code = rc_lut[smtc_modem_get_status_snapshot( STACK_ID, &snapshot )];
+        if( cmd_output->return_code == CMD_RC_OK )
+        {
+            uint8_t* out   = cmd_output->buffer;
+            uint8_t  index = 0;
+
+            out[index++] = ( snapshot.status_mask >> 24 ) & 0xff;
+            out[index++] = ( snapshot.status_mask >> 16 ) & 0xff;
+            out[index++] = ( snapshot.status_mask >> 8 ) & 0xff;
+            out[index++] = ( snapshot.status_mask & 0xff );
+            out[index++] = ( uint8_t ) snapshot.region;
+            out[index++] = ( uint8_t ) snapshot.lorawan_class;
+            out[index++] = ( snapshot.uplink_fcnt >> 24 ) & 0xff;
+            out[index++] = ( snapshot.uplink_fcnt >> 16 ) & 0xff;
+            out[index++] = ( snapshot.uplink_fcnt >> 8 ) & 0xff;
+            out[index++] = ( snapshot.uplink_fcnt & 0xff );
+            out[index++] = snapshot.next_datarate;
+            out[index++] = ( uint8_t ) snapshot.next_tx_power_dbm;
+            out[index++] = snapshot.nb_trans;
+            out[index++] = snapshot.next_tx_max_payload;
+            out[index++] = ( ( uint32_t ) snapshot.duty_cycle_status_ms >> 24 ) & 0xff;
+            out[index++] = ( ( uint32_t ) snapshot.duty_cycle_status_ms >> 16 ) & 0xff;
+            out[index++] = ( ( uint32_t ) snapshot.duty_cycle_status_ms >> 8 ) & 0xff;
+            out[index++] = ( ( uint32_t ) snapshot.duty_cycle_status_ms & 0xff );
+            out[index++] = ( snapshot.lost_connection_cnt >> 8 ) & 0xff;
+            out[index++] = ( snapshot.lost_connection_cnt & 0xff );
+            out[index++] = ( snapshot.charge_uah >> 24 ) & 0xff;
+            out[index++] = ( snapshot.charge_uah >> 16 ) & 0xff;
+            out[index++] = ( snapshot.charge_uah >> 8 ) & 0xff;
+            out[index++] = ( snapshot.charge_uah & 0xff );
+            out[index++] = snapshot.event_pending_count;
+            out[index++] = ( snapshot.timestamp_s >> 24 ) & 0xff;
+            out[index++] = ( snapshot.timestamp_s >> 16 ) & 0xff;
+            out[index++] = ( snapshot.timestamp_s >> 8 ) & 0xff;
+            out[index++] = ( snapshot.timestamp_s & 0xff );
+            cmd_output->length = index;
+        }
+        break;
+    }
     case CMD_GET_SUSPEND_RADIO_COMMUNICATIONS:
     {
         bool suspend;
@@ -1853,6 +1926,36 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
         cmd_output->return_code = CMD_RC_OK;
         break;
     }
+    case CMD_GET_RP_TRACE:
+    {
+        uint16_t trace_length = 0;
+
+        // lost events counter followed by as many 8-byte events as fit in the response
+        cmd_output->return_code =
+            rc_lut[smtc_modem_get_rp_trace_to_array( cmd_output->buffer, 4 + ( 31 * 8 ), &trace_length )];
+        cmd_output->length = ( uint8_t ) trace_length;
+        break;
+    }
+    case CMD_GET_PROFILE:
+    {
+        uint16_t profile_length = 0;
+
+        // 16 bytes per profiled section, the statistics are cleared after the read when the parameter is 1
+        cmd_output->return_code = rc_lut[smtc_modem_get_profile_to_array( cmd_output->buffer, 15 * 16, &profile_length,
+                                                                          ( cmd_input->buffer[0] == 1 ) )];
+        cmd_output->length      = ( uint8_t ) profile_length;
+        break;
+    }
+    case CMD_GET_LATENCY:
+    {
+        uint16_t latency_length = 0;
+
+        // 68 bytes per histogram, the histograms are cleared after the read when the parameter is 1
+        cmd_output->return_code = rc_lut[smtc_modem_get_latency_histograms_to_array(
+            cmd_output->buffer, 3 * 68, &latency_length, ( cmd_input->buffer[0] == 1 ) )];
+        cmd_output->length      = ( uint8_t ) latency_length;
+        break;
+    }
 #if defined( STM32L476xx )
     case CMD_STORE_AND_FORWARD_SET_STATE:
     {
@@ -1876,6 +1979,38 @@ cmd_parse_status_t parse_cmd( cmd_input_t* cmd_input, cmd_response_t* cmd_output
             STACK_ID, cmd_input->buffer[0], cmd_input->buffer[1], &cmd_input->buffer[2], cmd_input->length - 2 )];
         break;
     }
+    case CMD_STORE_AND_FORWARD_ADD_CHUNK:
+    {
+        // [fport][confirmed][record_length][data], the data is cut into records of record_length bytes (the last one
+        // may be shorter) written straight from the reception buffer. The response is the number of records written
+        const uint8_t record_length = cmd_input->buffer[2];
+        uint8_t       offset        = 3;
+        uint8_t       nb_records    = 0;
+
+        if( record_length == 0 )
+        {
+            cmd_output->return_code = CMD_RC_INVALID;
+            break;
+        }
+        while( offset < cmd_input->length )
+        {
+            const uint8_t length = ( ( cmd_input->length - offset ) < record_length )
+                                       ? ( uint8_t ) ( cmd_input->length - offset )
+                                       : record_length;
+
+            cmd_output->return_code = rc_lut[smtc_modem_store_and_forward_flash_add_data(
+                STACK_ID, cmd_input->buffer[0], cmd_input->buffer[1], &cmd_input->buffer[offset], length )];
+            if( cmd_output->return_code != CMD_RC_OK )
+            {
+                break;
+            }
+            offset += length;
+            nb_records++;
+        }
+        cmd_output->buffer[0] = nb_records;
+        cmd_output->length    = 1;
+        break;
+    }
     case CMD_STORE_AND_FORWARD_CLEAR_DATA:
     {
         cmd_output->return_code = rc_lut[smtc_modem_store_and_forward_flash_clear_data( STACK_ID )];
@@ -2699,6 +2834,145 @@ cmd_parse_status_t cmd_test_parser( cmd_tst_input_t* cmd_tst_input, cmd_tst_resp
         cmd_tst_output->length = 0;
         break;
     }
+    case CMD_TST_SURVEY:
+    {
+        // [first frequency (4)][frequency step (4)][nb channels (1)][dwell ms (2)][bw (4)][percentile (1)]
+        uint32_t freq = 0;
+        freq |= cmd_tst_input->buffer[0] << 24;
+        freq |= cmd_tst_input->buffer[1] << 16;
+        freq |= cmd_tst_input->buffer[2] << 8;
+        freq |= cmd_tst_input->buffer[3];
+
+        uint32_t step = 0;
+        step |= cmd_tst_input->buffer[4] << 24;
+        step |= cmd_tst_input->buffer[5] << 16;
+        step |= cmd_tst_input->buffer[6] << 8;
+        step |= cmd_tst_input->buffer[7];
+
+        uint8_t nb_channels = cmd_tst_input->buffer[8];
+
+        uint16_t dwell_ms = 0;
+        dwell_ms |= cmd_tst_input->buffer[9] << 8;
+        dwell_ms |= cmd_tst_input->buffer[10];
+
+        uint32_t bw = 0;
+        bw |= cmd_tst_input->buffer[11] << 24;
+        bw |= cmd_tst_input->buffer[12] << 16;
+        bw |= cmd_tst_input->buffer[13] << 8;
+        bw |= cmd_tst_input->buffer[14];
+
+        uint8_t percentile = cmd_tst_input->buffer[15];
+
+        if( ( nb_channels == 0 ) || ( nb_channels > SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS ) )
+        {
+            cmd_tst_output->return_code = CMD_RC_INVALID;
+            break;
+        }
+
+        uint32_t frequencies_hz[SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS];
+        for( uint8_t i = 0; i < nb_channels; i++ )
+        {
+            frequencies_hz[i] = freq + ( uint32_t ) i * step;
+        }
+        cmd_tst_output->return_code =
+            rc_lut[smtc_modem_test_survey_start( frequencies_hz, nb_channels, dwell_ms, bw, percentile )];
+        break;
+    }
+    case CMD_TST_SURVEY_GET:
+    {
+        // [nb channels (1)] then [rssi min][rssi avg][rssi max][rssi percentile] of each channel
+        smtc_modem_test_survey_result_t results[CMD_TST_SURVEY_GET_MAX_CHANNELS];
+        uint8_t                         nb_results = 0;
+
+        cmd_tst_output->return_code = rc_lut[smtc_modem_test_survey_get_results(
+            cmd_tst_input->buffer[0], results, CMD_TST_SURVEY_GET_MAX_CHANNELS, &nb_results )];
+        cmd_tst_output->length = 0;
+        if( cmd_tst_output->return_code == CMD_RC_OK )
+        {
+            cmd_tst_output->buffer[cmd_tst_output->length++] = nb_results;
+            for( uint8_t i = 0; i < nb_results; i++ )
+            {
+                cmd_tst_output->buffer[cmd_tst_output->length++] = results[i].rssi_min_dbm;
+                cmd_tst_output->buffer[cmd_tst_output->length++] = results[i].rssi_avg_dbm;
+                cmd_tst_output->buffer[cmd_tst_output->length++] = results[i].rssi_max_dbm;
+                cmd_tst_output->buffer[cmd_tst_output->length++] = results[i].rssi_percentile_dbm;
+            }
+        }
+        break;
+    }
+    case CMD_TST_PER:
+    {
+        // [transmitter (1)][frequency (4)][nb packets (2)][payload length (1)] then [sf][bw][tx power] per config
+        bool is_transmitter = cmd_tst_input->buffer[0] & 0x01;
+
+        uint32_t freq = 0;
+        freq |= cmd_tst_input->buffer[1] << 24;
+        freq |= cmd_tst_input->buffer[2] << 16;
+        freq |= cmd_tst_input->buffer[3] << 8;
+        freq |= cmd_tst_input->buffer[4];
+
+        uint16_t nb_packets = 0;
+        nb_packets |= cmd_tst_input->buffer[5] << 8;
+        nb_packets |= cmd_tst_input->buffer[6];
+
+        uint8_t payload_length = cmd_tst_input->buffer[7];
+
+        if( ( ( cmd_tst_input->length - 8 ) % 3 ) != 0 )
+        {
+            cmd_tst_output->return_code = CMD_RC_INVALID;
+            break;
+        }
+
+        smtc_modem_test_per_config_t configs[SMTC_MODEM_TEST_PER_MAX_CONFIGS];
+        uint8_t                      nb_configs = ( cmd_tst_input->length - 8 ) / 3;
+        for( uint8_t i = 0; i < nb_configs; i++ )
+        {
+            configs[i].sf           = ( ral_lora_sf_t ) cmd_tst_input->buffer[8 + 3 * i];
+            configs[i].bw           = ( ral_lora_bw_t ) cmd_tst_input->buffer[9 + 3 * i];
+            configs[i].tx_power_dbm = ( int8_t ) cmd_tst_input->buffer[10 + 3 * i];
+        }
+        cmd_tst_output->return_code = rc_lut[smtc_modem_test_per_start( is_transmitter, freq, configs, nb_configs,
+                                                                        nb_packets, payload_length )];
+        break;
+    }
+    case CMD_TST_PER_GET:
+    {
+        // [nb configs (1)] then per config [nb received (2)][rssi min, avg, max (2 each)][snr min, avg, max (1 each)]
+        // [goodput bps (4)], multi-byte fields are big endian
+        smtc_modem_test_per_result_t results[SMTC_MODEM_TEST_PER_MAX_CONFIGS];
+        uint8_t                      nb_results = 0;
+
+        cmd_tst_output->return_code = rc_lut[smtc_modem_test_per_get_results(
+            cmd_tst_input->buffer[0], results, SMTC_MODEM_TEST_PER_MAX_CONFIGS, &nb_results )];
+        cmd_tst_output->length = 0;
+        if( cmd_tst_output->return_code == CMD_RC_OK )
+        {
+            uint8_t* out   = cmd_tst_output->buffer;
+            uint8_t  index = 0;
+
+            out[index++] = nb_results;
+            for( uint8_t i = 0; i < nb_results; i++ )
+            {
+                out[index++] = ( results[i].nb_received >> 8 ) & 0xFF;
+                out[index++] = results[i].nb_received & 0xFF;
+                out[index++] = ( results[i].rssi_min_dbm >> 8 ) & 0xFF;
+                out[index++] = results[i].rssi_min_dbm & 0xFF;
+                out[index++] = ( results[i].rssi_avg_dbm >> 8 ) & 0xFF;
+                out[index++] = results[i].rssi_avg_dbm & 0xFF;
+                out[index++] = ( results[i].rssi_max_dbm >> 8 ) & 0xFF;
+                out[index++] = results[i].rssi_max_dbm & 0xFF;
+                out[index++] = results[i].snr_min_db;
+                out[index++] = results[i].snr_avg_db;
+                out[index++] = results[i].snr_max_db;
+                out[index++] = ( results[i].goodput_bps >> 24 ) & 0xFF;
+                out[index++] = ( results[i].goodput_bps >> 16 ) & 0xFF;
+                out[index++] = ( results[i].goodput_bps >> 8 ) & 0xFF;
+                out[index++] = results[i].goodput_bps & 0xFF;
+            }
+            cmd_tst_output->length = index;
+        }
+        break;
+    }
     default:
     {
         cmd_tst_output->return_code = CMD_RC_UNKNOWN;
@@ -2719,6 +2993,163 @@ cmd_parse_status_t cmd_test_parser( cmd_tst_input_t* cmd_tst_input, cmd_tst_resp
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static uint8_t cmd_parser_event_to_buffer( const smtc_modem_event_t* event, uint8_t* buffer )
+{
+    uint8_t length = 0;
+
+    // buffer[0]: event type
+    buffer[0] = events_lut[event->event_type];
+
+    // buffer[1]: missed event
+    buffer[1] = event->missed_events;
+
+    // buffer[2-N]; event data, depend on event_type
+    switch( event->event_type )
+    {
+    case SMTC_MODEM_EVENT_RESET:
+        buffer[2] = ( uint8_t ) ( event->event_data.reset.count >> 8 );
+        buffer[3] = ( uint8_t ) ( event->event_data.reset.count );
+        length    = 4;
+        break;
+    case SMTC_MODEM_EVENT_TXDONE:
+        buffer[2] = event->event_data.txdone.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_LINK_CHECK:
+        buffer[2] = event->event_data.link_check.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
+        buffer[2] = event->event_data.class_b_ping_slot_info.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_CLASS_B_STATUS:
+        buffer[2] = event->event_data.class_b_status.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
+        buffer[2] = event->event_data.lorawan_mac_time.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
+        buffer[2] = event->event_data.fuota_status.successful;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
+        buffer[2] = event->event_data.new_multicast_class_c.group_id;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
+        buffer[2] = event->event_data.new_multicast_class_b.group_id;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
+        buffer[2] = event->event_data.fmp.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_UPLOAD_DONE:
+        buffer[2] = event->event_data.uploaddone.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_DM_SET_CONF:
+        buffer[2] = event->event_data.setconf.opcode;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_MUTE:
+        buffer[2] = event->event_data.mute.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_DOWNDATA:
+    case SMTC_MODEM_EVENT_ALCSYNC_TIME:
+    case SMTC_MODEM_EVENT_ALARM:
+    case SMTC_MODEM_EVENT_JOINED:
+    case SMTC_MODEM_EVENT_JOINFAIL:
+    case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
+    case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
+    case SMTC_MODEM_EVENT_STREAM_DONE:
+    case SMTC_MODEM_EVENT_GNSS_SCAN_DONE:
+    case SMTC_MODEM_EVENT_GNSS_TERMINATED:
+    case SMTC_MODEM_EVENT_GNSS_ALMANAC_DEMOD_UPDATE:
+    case SMTC_MODEM_EVENT_WIFI_SCAN_DONE:
+    case SMTC_MODEM_EVENT_WIFI_TERMINATED:
+        length = 2;
+        break;
+
+    case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
+    case SMTC_MODEM_EVENT_RELAY_TX_MODE:
+    case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
+        buffer[2] = event->event_data.relay_tx.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_RELAY_RX_RUNNING:
+        buffer[2] = event->event_data.relay_rx.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_TEST_MODE:
+        buffer[2] = event->event_data.test_mode_status.status;
+        length    = 3;
+        break;
+    case SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE:
+        buffer[2] = event->event_data.regional_duty_cycle.status;
+        length    = 3;
+        break;
+    default:
+        length = 0;
+        break;
+    }
+    return length;
+}
+
+static void cmd_parser_batch( const cmd_input_t* cmd_input, cmd_response_t* cmd_output )
+{
+    // Sub-responses are built aside: a response that does not fit in the batch response is not written
+    static uint8_t batch_sub_response[255];
+    uint16_t       offset          = 0;
+    uint16_t       response_length = 0;
+
+    cmd_output->return_code = CMD_RC_OK;
+    while( offset < cmd_input->length )
+    {
+        if( ( ( offset + 2 ) > cmd_input->length ) ||
+            ( ( offset + 2 + cmd_input->buffer[offset + 1] ) > cmd_input->length ) ||
+            ( cmd_input->buffer[offset] == CMD_BATCH ) )
+        {
+            SMTC_HAL_TRACE_ERROR( "Malformed batch sub-command at %u\n", offset );
+            cmd_output->return_code = CMD_RC_FRAME_ERROR;
+            break;
+        }
+
+        cmd_input_t    sub_input;
+        cmd_response_t sub_output;
+        sub_input.cmd_code = ( host_cmd_id_t ) cmd_input->buffer[offset];
+        sub_input.length   = cmd_input->buffer[offset + 1];
+        sub_input.buffer   = &cmd_input->buffer[offset + 2];
+        sub_output.buffer  = batch_sub_response;
+        offset += 2 + sub_input.length;
+
+        parse_cmd( &sub_input, &sub_output );
+
+        if( ( response_length + 2 + sub_output.length ) > 255 )
+        {
+            // The sub-command ran but its response is lost, the host shall split the batch
+            cmd_output->return_code = CMD_RC_FRAME_ERROR;
+            break;
+        }
+        cmd_output->buffer[response_length]     = sub_output.return_code;
+        cmd_output->buffer[response_length + 1] = sub_output.length;
+        memcpy( &cmd_output->buffer[response_length + 2], batch_sub_response, sub_output.length );
+        response_length += 2 + sub_output.length;
+
+        // A provisioning sequence shall not go on after a failed step
+        if( sub_output.return_code != CMD_RC_OK )
+        {
+            cmd_output->return_code = sub_output.return_code;
+            break;
+        }
+    }
+    cmd_output->length = ( uint8_t ) response_length;
+}
+
 static cmd_length_valid_t cmd_parser_check_cmd_size( host_cmd_id_t cmd_id, uint8_t length )
 {
     // cmd len too small
@@ -205,6 +205,14 @@ typedef enum host_cmd_id_e
     CMD_GET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF = 0x96,
     CMD_SET_BYPASS_JOIN_DUTY_CYCLE_BACKOFF = 0x97,
     CMD_MODEM_GET_CRASHLOG                 = 0x98,
+    CMD_GET_RP_TRACE                       = 0x99,
+    CMD_GET_PROFILE                        = 0x9A,
+    CMD_GET_EVENTS                         = 0x9B,
+    CMD_BATCH                              = 0x9C,
+    CMD_SET_UART_BAUDRATE                  = 0x9D,
+    CMD_STORE_AND_FORWARD_ADD_CHUNK        = 0x9E,
+    CMD_GET_LATENCY                        = 0x9F,
+    CMD_GET_STATUS_SNAPSHOT                = 0xA0,
     CMD_MAX
 } host_cmd_id_t;
 
@@ -232,6 +240,10 @@ typedef enum host_cmd_test_id_e
     CMD_TST_WATCHDOG         = 0x10,
     CMD_TST_RADIO_READ       = 0x11,
     CMD_TST_RADIO_WRITE      = 0x12,
+    CMD_TST_SURVEY           = 0x13,
+    CMD_TST_SURVEY_GET       = 0x14,
+    CMD_TST_PER              = 0x15,
+    CMD_TST_PER_GET          = 0x16,
     CMD_TST_MAX
 } host_cmd_test_id_t;
 
@@ -46,7 +46,11 @@
 #include "cmd_parser.h"
 #include "modem_pinout.h"
 #include "smtc_modem_utilities.h"
+#if defined( USE_HW_MODEM_SPI )
+#include "smtc_hal_spi_slave.h"
+#else
 #include "smtc_hal_uart.h"
+#endif
 #include "smtc_hal_mcu.h"
 #include "smtc_hal_gpio.h"
 
@@ -83,6 +87,7 @@ static volatile bool      hw_cmd_available             = false;
 static volatile bool      is_hw_modem_ready_to_receive = true;
 static hal_gpio_irq_t     wakeup_line_irq              = { 0 };
 static hw_modem_lp_mode_t lp_mode                      = HW_MODEM_LP_ENABLE;
+static uint32_t           pending_uart_baudrate        = 0;
 
 /*
  * -----------------------------------------------------------------------------
@@ -90,7 +95,7 @@ static hw_modem_lp_mode_t lp_mode                      = HW_MODEM_LP_ENABLE;
  */
 
 /**
- * @brief prepare and start the reception of the command on a uart using a dma
+ * @brief prepare and start the reception of the command on the host interface using a dma
  * @param [none]
  * @return [none]
  */
@@ -103,6 +108,29 @@ void hw_modem_start_reception( void );
  */
 void wakeup_line_irq_handler( void* context );
 
+#if defined( USE_HW_MODEM_SPI )
+/**
+ * @brief function that will be called once the whole response has been handed to the spi
+ * @param [none]
+ * @return none
+ */
+void hw_modem_spi_tx_done_handler( void );
+#else
+/**
+ * @brief function that will be called each time the uart line goes idle during the reception of a command
+ * @param [in] rx_length  number of bytes received since the start of the reception
+ * @return none
+ */
+void hw_modem_uart_idle_handler( uint16_t rx_length );
+#endif
+
+/**
+ * @brief stop the reception and hand the received command over to the main loop
+ * @param [none]
+ * @return [none]
+ */
+void hw_modem_end_reception( void );
+
 /**
  * @brief function that will be called by the soft modem engine each time an async event is available
  * @param *context  unused context
@@ -146,10 +174,15 @@ void hw_modem_start_reception( void )
     // during the receive process the hw modem cannot accept an other cmd, prevent it
     is_hw_modem_ready_to_receive = false;
 
-    // receive on dma
-    hw_modem_uart_dma_start_rx( modem_received_buff, HW_MODEM_RX_BUFF_MAX_LENGTH );
+#if defined( USE_HW_MODEM_SPI )
+    // receive on dma the bytes clocked by the host, the COMMAND line rising edge ends the reception
+    hw_modem_spi_dma_start_rx( modem_received_buff, HW_MODEM_RX_BUFF_MAX_LENGTH );
+#else
+    // receive on dma, the idle line after a complete frame ends the reception without waiting for the COMMAND line
+    hw_modem_uart_dma_start_rx_to_idle( modem_received_buff, HW_MODEM_RX_BUFF_MAX_LENGTH, hw_modem_uart_idle_handler );
+#endif
 
-    // indicate to bridge or host that the modem is ready to receive on uart
+    // indicate to bridge or host that the modem is ready to receive
     hal_gpio_set_value( HW_MODEM_BUSY_PIN, 0 );
 }
 
@@ -207,19 +240,35 @@ void hw_modem_process_cmd( void )
         is_hw_modem_ready_to_receive = true;
         hw_cmd_available             = false;
 
+        for( int i = 0; i < response_length + 2; i++ )
+        {
+            crc = crc ^ modem_response_buff[i];
+        }
+        modem_response_buff[response_length + 2] = crc;
+
+#if defined( USE_HW_MODEM_SPI )
+        // load the response in the dma and indicate to the host with the busy pin that it can be clocked out, the
+        // spi stops in stop mode, no new command is accepted until the host has read the response
+        is_hw_modem_ready_to_receive = false;
+        lp_mode                      = HW_MODEM_LP_DISABLE;
+        hw_modem_spi_dma_start_tx( modem_response_buff, response_length + 3, hw_modem_spi_tx_done_handler );
+        hal_gpio_set_value( HW_MODEM_BUSY_PIN, 0 );
+#else
         // set busy pin to indicate to bridge or host that the hw_modem answer will be soon sent
         hal_gpio_set_value( HW_MODEM_BUSY_PIN, 1 );
 
         // wait to to bridge delay
         hal_mcu_wait_us( 1000 );
 
-        for( int i = 0; i < response_length + 2; i++ )
+        hw_modem_uart_tx( modem_response_buff, response_length + 3 );
+
+        // the response went out at the previous baudrate, the host switches once it has received it
+        if( pending_uart_baudrate != 0 )
         {
-            crc = crc ^ modem_response_buff[i];
+            hw_modem_uart_set_baudrate( pending_uart_baudrate );
+            pending_uart_baudrate = 0;
         }
-        modem_response_buff[response_length + 2] = crc;
-
-        hw_modem_uart_tx( modem_response_buff, response_length + 3 );
+#endif
     }
     else
     {
@@ -237,6 +286,11 @@ bool hw_modem_is_a_cmd_available( void )
     return hw_cmd_available;
 }
 
+bool hw_modem_is_receiving( void )
+{
+    return ( is_hw_modem_ready_to_receive == false ) && ( hw_cmd_available == false );
+}
+
 bool hw_modem_is_low_power_ok( void )
 {
     if( lp_mode == HW_MODEM_LP_ENABLE )
@@ -255,6 +309,11 @@ bool hw_modem_is_low_power_ok( void )
     }
 }
 
+void hw_modem_set_uart_baudrate_after_response( uint32_t baudrate )
+{
+    pending_uart_baudrate = baudrate;
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -264,7 +323,7 @@ void wakeup_line_irq_handler( void* context )
 {
     if( ( hal_gpio_get_value( HW_MODEM_COMMAND_PIN ) == 0 ) && ( is_hw_modem_ready_to_receive == true ) )
     {
-        // start receiving uart with dma
+        // start receiving with dma
         hw_modem_start_reception( );
 
         // force exit of stop mode
@@ -273,18 +332,52 @@ void wakeup_line_irq_handler( void* context )
         // TEMPORARY WORKAROUND to avoid issue for print in hw_modem_process_cmd function
         hal_mcu_wait_us( 2000 );
     }
-    if( ( hal_gpio_get_value( HW_MODEM_COMMAND_PIN ) == 1 ) && ( is_hw_modem_ready_to_receive == false ) )
+    if( ( hal_gpio_get_value( HW_MODEM_COMMAND_PIN ) == 1 ) && ( is_hw_modem_ready_to_receive == false ) &&
+        ( hw_cmd_available == false ) )
     {
-        // stop uart on dma reception
-        hw_modem_uart_dma_stop_rx( );
-
-        // inform that a command has arrived
-        hw_cmd_available = true;
+        // the frame was not completed by the idle line detection (truncated frame), hand it over as is
+        hw_modem_end_reception( );
+    }
+}
 
-        // force one more loop in main loop and then re-enable low power feature
-        lp_mode = HW_MODEM_LP_DISABLE_ONCE;
+#if !defined( USE_HW_MODEM_SPI )
+void hw_modem_uart_idle_handler( uint16_t rx_length )
+{
+    // [cmd][len][payload][crc]: the reception is over once the length byte and the whole frame are received
+    if( ( hw_cmd_available == false ) && ( rx_length >= 3 ) && ( rx_length >= ( modem_received_buff[1] + 3 ) ) )
+    {
+        hw_modem_end_reception( );
     }
 }
+#endif
+
+#if defined( USE_HW_MODEM_SPI )
+void hw_modem_spi_tx_done_handler( void )
+{
+    // the host has the whole response, the next command will lower the busy pin again
+    hal_gpio_set_value( HW_MODEM_BUSY_PIN, 1 );
+    is_hw_modem_ready_to_receive = true;
+    lp_mode                      = HW_MODEM_LP_DISABLE_ONCE;
+}
+#endif
+
+void hw_modem_end_reception( void )
+{
+#if defined( USE_HW_MODEM_SPI )
+    // stop spi on dma reception, the busy pin stays high until the response is ready to be clocked out
+    hw_modem_spi_dma_stop_rx( );
+    hal_gpio_set_value( HW_MODEM_BUSY_PIN, 1 );
+#else
+    // stop uart on dma reception
+    hw_modem_uart_dma_stop_rx( );
+#endif
+
+    // inform that a command has arrived
+    hw_cmd_available = true;
+
+    // force one more loop in main loop and then re-enable low power feature
+    lp_mode = HW_MODEM_LP_DISABLE_ONCE;
+}
 
 void hw_modem_event_handler( void )
 {
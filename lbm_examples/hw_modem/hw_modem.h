@@ -79,6 +79,13 @@ void hw_modem_process_cmd( void );
  */
 bool hw_modem_is_a_cmd_available( void );
 
+/**
+ * @brief Indicates if a command is being received on the host interface
+ *
+ * @return true if the reception of a command is ongoing, false otherwise
+ */
+bool hw_modem_is_receiving( void );
+
 /**
  * @brief Indicates if main application can go in low power
  *
@@ -86,6 +93,13 @@ bool hw_modem_is_a_cmd_available( void );
  */
 bool hw_modem_is_low_power_ok( void );
 
+/**
+ * @brief Change the uart baudrate once the response of the command being processed has been sent
+ *
+ * @param [in] baudrate Baudrate used from the next command on
+ */
+void hw_modem_set_uart_baudrate_after_response( uint32_t baudrate );
+
 #ifdef __cplusplus
 }
 #endif
@@ -135,7 +135,16 @@ void main_hw_modem( void )
             ( smtc_modem_is_irq_flag_pending( ) == false ) )
         {
             hal_watchdog_reload( );
+#if defined( USE_LOW_POWER_HINT )
+            smtc_modem_enter_low_power( MIN( sleep_time_ms, WATCHDOG_RELOAD_PERIOD_MS ) );
+#else
             hal_mcu_set_sleep_for_ms( MIN( sleep_time_ms, WATCHDOG_RELOAD_PERIOD_MS ) );
+#endif
+        }
+        else if( ( hw_modem_is_receiving( ) == true ) && ( smtc_modem_is_irq_flag_pending( ) == false ) )
+        {
+            // the dma fills the command buffer on its own, sleep until the idle line or the COMMAND line interrupt
+            hal_mcu_wait_for_interrupt( );
         }
         hal_watchdog_reload( );
         hal_mcu_enable_irq( );
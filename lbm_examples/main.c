@@ -92,6 +92,8 @@ int main( void )
     main_porting_tests( );
 #elif MAKEFILE_APP == LCTT_CERTIF
     main_lctt_certif( );
+#elif MAKEFILE_APP == BENCHMARK
+    main_benchmark( );
 #else
 #error "Unknown application" ## MAKEFILE_APP
 #endif
@@ -69,6 +69,7 @@ extern "C" {
 #define HW_MODEM 1
 #define PORTING_TESTS 2
 #define LCTT_CERTIF 3
+#define BENCHMARK 4
 
 /*
  * -----------------------------------------------------------------------------
@@ -79,6 +80,7 @@ void main_periodical_uplink( void );
 void main_hw_modem( void );
 void main_porting_tests( void );
 void main_lctt_certif( void );
+void main_benchmark( void );
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,664 @@
+/*!
+ * \file      main_benchmark.c
+ *
+ * \brief     main program for on-target performance benchmark example
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stdio.h>    // snprintf
+#include <string.h>
+
+#include "main.h"
+
+#include "smtc_modem_hal.h"
+#include "smtc_hal_dbg_trace.h"
+
+#include "smtc_hal_mcu.h"
+#include "smtc_hal_watchdog.h"
+#include "ral_lora_toa.h"
+#include "radio_planner.h"
+#include "circularfs.h"
+#include "lora_basics_modem_version.h"
+
+#if defined( SX128X )
+#include "ralf_sx128x.h"
+#include "sx128x.h"
+#elif defined( SX126X )
+#include "ralf_sx126x.h"
+#include "sx126x.h"
+#elif defined( LR11XX )
+#include "ralf_lr11xx.h"
+#include "lr11xx_regmem.h"
+#endif
+
+#if !defined( USE_LR11XX_CRYPTO )
+#include "aes.h"
+#include "cmac.h"
+#endif
+
+#if defined( ENABLE_TEST_FRAG_DECODER )
+#include "fragmentation_helper_v2.0.0.h"
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+// Number of runs of each benchmark, fixed so that results can be compared between releases and MCU families
+#define NB_LOOP_BENCH_AES_KEY 1000
+#define NB_LOOP_BENCH_AES_BLOCK 10000
+#define NB_LOOP_BENCH_CMAC 2000
+#define NB_LOOP_BENCH_FRAG_DECODER 2
+#define NB_LOOP_BENCH_LORA_TOA 20000
+#define NB_LOOP_BENCH_RP 1000
+#define NB_LOOP_BENCH_SPI 2000
+#define NB_LOOP_BENCH_CIRCULARFS 2000
+#define NB_LOOP_BENCH_CONTEXT_STORE 10
+
+#define SIZE_BENCH_CMAC 64  // LoRaWAN frame with a 48-byte payload and the B0 block
+#define SIZE_BENCH_SPI 255
+#define SIZE_BENCH_CIRCULARFS_OBJECT 32
+#define SIZE_BENCH_CIRCULARFS_SECTOR 512
+#define NB_BENCH_CIRCULARFS_SECTORS 4
+#define SIZE_BENCH_CONTEXT_STORE 64
+
+#define NB_FRAG_BENCH_DECODER 100
+#define SIZE_FRAG_BENCH_DECODER 242
+#define LOSS_PERIOD_BENCH_DECODER 10  // One uncoded fragment out of LOSS_PERIOD_BENCH_DECODER is lost
+
+// Start time of the tasks filling the radio planner, far enough not to be launched during the benchmark
+#define RP_BENCH_START_DELAY_MS 60000
+
+#if defined( SX128X )
+const ralf_t modem_radio = RALF_SX128X_INSTANTIATE( NULL );
+#elif defined( SX126X )
+const ralf_t modem_radio = RALF_SX126X_INSTANTIATE( NULL );
+#elif defined( LR11XX )
+const ralf_t modem_radio = RALF_LR11XX_INSTANTIATE( NULL );
+#else
+#error "Please select radio board.."
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+// Core clock of the CMSIS system, used to convert the measured times in cycles
+extern uint32_t SystemCoreClock;
+
+static uint8_t bench_nb_results = 0;
+
+static radio_planner_t   bench_rp;
+static rp_radio_params_t bench_rp_radio_params;
+
+static uint8_t bench_circularfs_storage[NB_BENCH_CIRCULARFS_SECTORS * SIZE_BENCH_CIRCULARFS_SECTOR];
+
+static struct circularfs_flash_partition bench_circularfs_flash;
+static struct circularfs                 bench_circularfs_fs;
+
+#if defined( ENABLE_TEST_FRAG_DECODER )
+// Decoded file followed by the room needed by the sparse decoder matrix
+static uint8_t frag_bench_storage[NB_FRAG_BENCH_DECODER * SIZE_FRAG_BENCH_DECODER +
+                                  NB_FRAG_BENCH_DECODER * ( ( ( NB_FRAG_BENCH_DECODER - 1 ) >> 3 ) + 1 )];
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+static void bench_report( const char* name, uint32_t nb_loops, uint32_t time_ms );
+
+#if !defined( USE_LR11XX_CRYPTO )
+static void bench_aes( void );
+static void bench_cmac( void );
+#endif
+#if defined( ENABLE_TEST_FRAG_DECODER )
+static void bench_frag_decoder( void );
+#endif
+#if !defined( SX128X )
+static void bench_lora_toa( void );
+#endif
+static void bench_rp_arbiter( void );
+static void bench_spi( void );
+static void bench_circularfs( void );
+static void bench_context_store( void );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+/**
+ * @brief Example to measure the performance of the modem hot paths on the target
+ *
+ * @remark
+ * Each benchmark runs a fixed amount of work and prints one line on the trace uart:
+ *   BENCH,<name>,<nb_loops>,<us_per_loop>,<cycles_per_loop>
+ * framed by a BENCH_START,<lbm version>,<core clock in Hz> line and a BENCH_END,<nb results> line. Cycles are
+ * derived from the measured time and the core clock.
+ *
+ * @warning The context store benchmark overwrites the LoRaWAN stack context of the device
+ */
+void main_benchmark( void )
+{
+    // Disable IRQ to avoid unwanted behaviour during init
+    hal_mcu_disable_irq( );
+
+    // Configure all the µC periph (clock, gpio, timer, ...)
+    hal_mcu_init( );
+
+    // Re-enable IRQ
+    hal_mcu_enable_irq( );
+
+    // Radio in standby for the SPI benchmark and the radio planner
+    ral_reset( &( modem_radio.ral ) );
+    ral_init( &( modem_radio.ral ) );
+
+    SMTC_HAL_TRACE_PRINTF( "\nBENCH_START,%u.%u.%u,%u\n", LORA_BASICS_MODEM_FW_VERSION_MAJOR,
+                           LORA_BASICS_MODEM_FW_VERSION_MINOR, LORA_BASICS_MODEM_FW_VERSION_PATCH, SystemCoreClock );
+
+#if !defined( USE_LR11XX_CRYPTO )
+    bench_aes( );
+    bench_cmac( );
+#endif
+#if defined( ENABLE_TEST_FRAG_DECODER )
+    bench_frag_decoder( );
+#endif
+#if !defined( SX128X )
+    bench_lora_toa( );
+#endif
+    bench_rp_arbiter( );
+    bench_spi( );
+    bench_circularfs( );
+    bench_context_store( );
+
+    SMTC_HAL_TRACE_PRINTF( "BENCH_END,%u\n", bench_nb_results );
+
+    ral_set_sleep( &( modem_radio.ral ), true );
+
+    while( 1 )
+    {
+        hal_watchdog_reload( );
+    }
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/**
+ * @brief Print the result of a benchmark
+ *
+ * @param [in] name     Benchmark name
+ * @param [in] nb_loops Number of runs
+ * @param [in] time_ms  Time taken by all runs
+ */
+static void bench_report( const char* name, uint32_t nb_loops, uint32_t time_ms )
+{
+    uint64_t ns_per_loop     = ( ( uint64_t ) time_ms * 1000000 ) / nb_loops;
+    uint32_t cycles_per_loop = ( uint32_t ) ( ( ns_per_loop * ( SystemCoreClock / 1000 ) ) / 1000000 );
+
+    SMTC_HAL_TRACE_PRINTF( "BENCH,%s,%u,%u.%03u,%u\n", name, nb_loops, ( uint32_t ) ( ns_per_loop / 1000 ),
+                           ( uint32_t ) ( ns_per_loop % 1000 ), cycles_per_loop );
+    bench_nb_results++;
+}
+
+#if !defined( USE_LR11XX_CRYPTO )
+/**
+ * @brief AES-128 key expansion and block encryption of the soft secure element
+ */
+static void bench_aes( void )
+{
+    static const uint8_t key[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                     0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+    aes_context          aes_ctx;
+    uint8_t              block[16] = { 0 };
+
+    memset( &aes_ctx, 0, sizeof( aes_ctx ) );
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_AES_KEY; i++ )
+    {
+        smtc_aes_set_key( key, 16, &aes_ctx );
+    }
+    bench_report( "aes_set_key", NB_LOOP_BENCH_AES_KEY, smtc_modem_hal_get_time_in_ms( ) - start_time_ms );
+
+    start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_AES_BLOCK; i++ )
+    {
+        smtc_aes_encrypt( block, block, &aes_ctx );
+    }
+    bench_report( "aes_encrypt_block", NB_LOOP_BENCH_AES_BLOCK, smtc_modem_hal_get_time_in_ms( ) - start_time_ms );
+}
+
+/**
+ * @brief AES-CMAC of a LoRaWAN frame, key schedule included as done by the soft secure element for each MIC
+ */
+static void bench_cmac( void )
+{
+    static const uint8_t key[16] = { 0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+                                     0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C };
+    AES_CMAC_CTX         cmac_ctx;
+    uint8_t              message[SIZE_BENCH_CMAC];
+    uint8_t              digest[AES_CMAC_DIGEST_LENGTH];
+
+    for( uint8_t i = 0; i < SIZE_BENCH_CMAC; i++ )
+    {
+        message[i] = i;
+    }
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_CMAC; i++ )
+    {
+        AES_CMAC_Init( &cmac_ctx );
+        AES_CMAC_SetKey( &cmac_ctx, key );
+        AES_CMAC_Update( &cmac_ctx, message, SIZE_BENCH_CMAC );
+        AES_CMAC_Final( digest, &cmac_ctx );
+        message[0] = digest[0];
+    }
+    bench_report( "cmac_64", NB_LOOP_BENCH_CMAC, smtc_modem_hal_get_time_in_ms( ) - start_time_ms );
+}
+#endif
+
+#if defined( ENABLE_TEST_FRAG_DECODER )
+static int8_t frag_bench_write( uint32_t addr, uint8_t* data, uint32_t size )
+{
+    if( ( addr + size ) > sizeof( frag_bench_storage ) )
+    {
+        return -1;
+    }
+    memcpy( &frag_bench_storage[addr], data, size );
+    return 0;
+}
+
+static int8_t frag_bench_read( uint32_t addr, uint8_t* data, uint32_t size )
+{
+    if( ( addr + size ) > sizeof( frag_bench_storage ) )
+    {
+        return -1;
+    }
+    memcpy( data, &frag_bench_storage[addr], size );
+    return 0;
+}
+
+/**
+ * @brief Content of the benchmark file
+ *
+ * @param [in] index Byte index in the file
+ *
+ * @return uint8_t Byte value
+ */
+static uint8_t frag_bench_file_byte( uint32_t index )
+{
+    return ( uint8_t ) ( ( index * 7 ) ^ ( index >> 8 ) );
+}
+
+/**
+ * @brief Coded fragment as sent by the fragmentation server, same parity matrix as the decoder
+ *
+ * @param [in]  n        Coded fragment number, starting at 1
+ * @param [out] fragment Coded fragment
+ */
+static void frag_bench_coded_fragment( uint16_t n, uint8_t* fragment )
+{
+    uint8_t  selected[( NB_FRAG_BENCH_DECODER >> 3 ) + 1] = { 0 };
+    uint16_t nb_coeff                                     = 0;
+    int32_t  x                                            = 1 + ( 1001 * n );
+    // NB_FRAG_BENCH_DECODER is not a power of two
+    int32_t m = NB_FRAG_BENCH_DECODER;
+
+    memset( fragment, 0, SIZE_FRAG_BENCH_DECODER );
+    while( nb_coeff < ( m >> 1 ) )
+    {
+        int32_t r = 1 << 16;
+        while( r >= m )
+        {
+            x = ( x >> 1 ) + ( ( ( x & 0x01 ) ^ ( ( x & 0x20 ) >> 5 ) ) << 22 );
+            r = x % m;
+        }
+        if( ( selected[r >> 3] & ( 1 << ( 7 - ( r % 8 ) ) ) ) == 0 )
+        {
+            selected[r >> 3] |= 1 << ( 7 - ( r % 8 ) );
+            nb_coeff++;
+            for( uint16_t i = 0; i < SIZE_FRAG_BENCH_DECODER; i++ )
+            {
+                fragment[i] ^= frag_bench_file_byte( ( uint32_t ) r * SIZE_FRAG_BENCH_DECODER + i );
+            }
+        }
+    }
+}
+
+/**
+ * @brief FUOTA v2 decoding of a NB_FRAG_BENCH_DECODER x SIZE_FRAG_BENCH_DECODER session losing one uncoded fragment
+ * out of LOSS_PERIOD_BENCH_DECODER
+ *
+ * @remark Only the time spent in the decoder is accounted, the file is decoded in RAM
+ */
+static void bench_frag_decoder( void )
+{
+    FragDecoderCallbacks_t callbacks = { .FragDecoderWrite = frag_bench_write, .FragDecoderRead = frag_bench_read };
+    uint8_t                fragment[SIZE_FRAG_BENCH_DECODER];
+    uint32_t               time_ms = 0;
+
+    if( FragDecoderGetMaxFileSize( ) < ( NB_FRAG_BENCH_DECODER * SIZE_FRAG_BENCH_DECODER ) )
+    {
+        SMTC_HAL_TRACE_PRINTF( "BENCH_SKIP,frag_decoder_session,FRAG_MAX_NB x FRAG_MAX_SIZE too small\n" );
+        return;
+    }
+
+    for( uint32_t loop = 0; loop < NB_LOOP_BENCH_FRAG_DECODER; loop++ )
+    {
+        int32_t  status  = FRAG_SESSION_ONGOING;
+        uint16_t counter = 0;
+
+        FragDecoderInit( NB_FRAG_BENCH_DECODER, SIZE_FRAG_BENCH_DECODER, &callbacks );
+        while( ( status == FRAG_SESSION_ONGOING ) && ( counter < ( 2 * NB_FRAG_BENCH_DECODER ) ) )
+        {
+            counter++;
+            if( counter <= NB_FRAG_BENCH_DECODER )
+            {
+                if( ( counter % LOSS_PERIOD_BENCH_DECODER ) == 0 )
+                {
+                    continue;
+                }
+                for( uint16_t i = 0; i < SIZE_FRAG_BENCH_DECODER; i++ )
+                {
+                    fragment[i] = frag_bench_file_byte( ( uint32_t ) ( counter - 1 ) * SIZE_FRAG_BENCH_DECODER + i );
+                }
+            }
+            else
+            {
+                frag_bench_coded_fragment( counter - NB_FRAG_BENCH_DECODER, fragment );
+            }
+
+            uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+            status                 = FragDecoderProcess( counter, fragment );
+            time_ms += smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+        }
+
+        if( status != FRAG_SESSION_FINISHED_SUCCESSFULLY )
+        {
+            SMTC_HAL_TRACE_PRINTF( "BENCH_SKIP,frag_decoder_session,session not decoded\n" );
+            return;
+        }
+    }
+    bench_report( "frag_decoder_session", NB_LOOP_BENCH_FRAG_DECODER, time_ms );
+}
+#endif
+
+#if !defined( SX128X )
+/**
+ * @brief LoRa time on air of the radio driver entry, cycling over the LoRaWAN datarates and payload lengths
+ */
+static void bench_lora_toa( void )
+{
+    ral_lora_mod_params_t mod_params = { .sf = RAL_LORA_SF7, .bw = RAL_LORA_BW_125_KHZ, .cr = RAL_LORA_CR_4_5 };
+    ral_lora_pkt_params_t pkt_params = {
+        .preamble_len_in_symb = 8,
+        .header_type          = RAL_LORA_PKT_EXPLICIT,
+        .pld_len_in_bytes     = 0,
+        .crc_is_on            = true,
+        .invert_iq_is_on      = false,
+    };
+    uint32_t sum_ms = 0;
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_LORA_TOA; i++ )
+    {
+        mod_params.sf               = ( ral_lora_sf_t ) ( RAL_LORA_SF7 + ( i % 6 ) );
+        mod_params.ldro             = ral_compute_lora_ldro( mod_params.sf, mod_params.bw );
+        pkt_params.pld_len_in_bytes = ( uint8_t ) ( ( i * 13 ) % 243 );
+        sum_ms += ral_get_lora_time_on_air_in_ms( &( modem_radio.ral ), &pkt_params, &mod_params );
+    }
+    uint32_t time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+
+    // The sum keeps the computation from being optimized out
+    if( sum_ms != 0 )
+    {
+        bench_report( "lora_toa", NB_LOOP_BENCH_LORA_TOA, time_ms );
+    }
+}
+#endif
+
+static void bench_rp_launch_callback( void* context )
+{
+    ( void ) context;
+}
+
+static void bench_rp_hook_callback( void* context )
+{
+    ( void ) context;
+}
+
+/**
+ * @brief Radio planner arbitration, one task enqueued and aborted while the other hooks hold scheduled tasks
+ *
+ * @remark The planner is built with the default options, hooks depend on the modem build options (RP_NB_HOOKS)
+ */
+static void bench_rp_arbiter( void )
+{
+    rp_task_t task = {
+        .type                       = RP_TASK_TYPE_TX_LORA,
+        .launch_task_callbacks      = bench_rp_launch_callback,
+        .schedule_task_low_priority = false,
+        .state                      = RP_TASK_STATE_SCHEDULE,
+        .duration_time_ms           = 100,
+    };
+    char name[24];
+
+    rp_init( &bench_rp, &modem_radio );
+    for( uint8_t id = 0; id < RP_NB_HOOKS; id++ )
+    {
+        rp_hook_init( &bench_rp, id, bench_rp_hook_callback, NULL );
+    }
+
+    // Measured with an empty planner, then with all the other hooks busy
+    for( uint8_t nb_busy_hooks = 0; nb_busy_hooks < RP_NB_HOOKS; nb_busy_hooks += ( RP_NB_HOOKS - 1 ) )
+    {
+        uint32_t now = smtc_modem_hal_get_time_in_ms( );
+
+        for( uint8_t id = 1; id <= nb_busy_hooks; id++ )
+        {
+            task.hook_id       = id;
+            task.start_time_ms = now + RP_BENCH_START_DELAY_MS + ( id * task.duration_time_ms );
+            rp_task_enqueue( &bench_rp, &task, NULL, 0, &bench_rp_radio_params );
+        }
+
+        task.hook_id           = 0;
+        uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+        for( uint32_t i = 0; i < NB_LOOP_BENCH_RP; i++ )
+        {
+            task.start_time_ms = start_time_ms + RP_BENCH_START_DELAY_MS - task.duration_time_ms;
+            rp_task_enqueue( &bench_rp, &task, NULL, 0, &bench_rp_radio_params );
+            rp_task_abort( &bench_rp, 0 );
+        }
+        uint32_t time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+
+        for( uint8_t id = 1; id <= nb_busy_hooks; id++ )
+        {
+            rp_task_abort( &bench_rp, id );
+        }
+        snprintf( name, sizeof( name ), "rp_enqueue_abort_%u", nb_busy_hooks + 1 );
+        bench_report( name, NB_LOOP_BENCH_RP, time_ms );
+    }
+    modem_timer_stop( &bench_rp.alarm_timer );
+}
+
+/**
+ * @brief Write and read of a 255-byte frame in the radio buffer
+ */
+static void bench_spi( void )
+{
+    uint8_t buffer[SIZE_BENCH_SPI];
+
+    for( uint16_t i = 0; i < SIZE_BENCH_SPI; i++ )
+    {
+        buffer[i] = ( uint8_t ) i;
+    }
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_SPI; i++ )
+    {
+#if defined( LR11XX )
+        lr11xx_regmem_write_buffer8( NULL, buffer, SIZE_BENCH_SPI );
+#elif defined( SX126X )
+        sx126x_write_buffer( NULL, 0, buffer, SIZE_BENCH_SPI );
+#elif defined( SX128X )
+        sx128x_write_buffer( NULL, 0, buffer, SIZE_BENCH_SPI );
+#endif
+    }
+    bench_report( "spi_write_255", NB_LOOP_BENCH_SPI, smtc_modem_hal_get_time_in_ms( ) - start_time_ms );
+
+    start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_SPI; i++ )
+    {
+#if defined( LR11XX )
+        lr11xx_regmem_read_buffer8( NULL, buffer, 0, SIZE_BENCH_SPI );
+#elif defined( SX126X )
+        sx126x_read_buffer( NULL, 0, buffer, SIZE_BENCH_SPI );
+#elif defined( SX128X )
+        sx128x_read_buffer( NULL, 0, buffer, SIZE_BENCH_SPI );
+#endif
+    }
+    bench_report( "spi_read_255", NB_LOOP_BENCH_SPI, smtc_modem_hal_get_time_in_ms( ) - start_time_ms );
+}
+
+static int32_t bench_circularfs_erase( struct circularfs_flash_partition* flash, uint32_t address )
+{
+    uint32_t sector_start = address - ( address % flash->sector_size );
+
+    memset( &bench_circularfs_storage[sector_start], 0xFF, flash->sector_size );
+    return 0;
+}
+
+static int32_t bench_circularfs_program( struct circularfs_flash_partition* flash, uint32_t address, const void* data,
+                                         uint32_t size )
+{
+    ( void ) flash;
+    // Flash programming only clears bits
+    for( uint32_t i = 0; i < size; i++ )
+    {
+        bench_circularfs_storage[address + i] &= ( ( const uint8_t* ) data )[i];
+    }
+    return size;
+}
+
+static int32_t bench_circularfs_read( struct circularfs_flash_partition* flash, uint32_t address, void* data,
+                                      uint32_t size )
+{
+    ( void ) flash;
+    memcpy( data, &bench_circularfs_storage[address], size );
+    return size;
+}
+
+/**
+ * @brief Append and fetch of an object in a circularfs partition emulated in RAM
+ *
+ * @remark The flash access time is measured by the context store benchmark, only the file system is measured here
+ */
+static void bench_circularfs( void )
+{
+    uint8_t object[SIZE_BENCH_CIRCULARFS_OBJECT] = { 0 };
+    int32_t size                                 = 0;
+
+    bench_circularfs_flash.sector_size   = SIZE_BENCH_CIRCULARFS_SECTOR;
+    bench_circularfs_flash.sector_offset = 0;
+    bench_circularfs_flash.sector_count  = NB_BENCH_CIRCULARFS_SECTORS;
+    bench_circularfs_flash.sector_erase  = bench_circularfs_erase;
+    bench_circularfs_flash.program       = bench_circularfs_program;
+    bench_circularfs_flash.read          = bench_circularfs_read;
+
+    if( ( circularfs_init( &bench_circularfs_fs, &bench_circularfs_flash, 1, SIZE_BENCH_CIRCULARFS_OBJECT ) != 0 ) ||
+        ( circularfs_format( &bench_circularfs_fs, false ) != 0 ) )
+    {
+        SMTC_HAL_TRACE_PRINTF( "BENCH_SKIP,circularfs,init failed\n" );
+        return;
+    }
+
+    uint32_t append_time_ms = 0;
+    uint32_t fetch_time_ms  = 0;
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_CIRCULARFS; i++ )
+    {
+        object[0] = ( uint8_t ) i;
+
+        uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+        circularfs_append( &bench_circularfs_fs, object, SIZE_BENCH_CIRCULARFS_OBJECT );
+        uint32_t middle_time_ms = smtc_modem_hal_get_time_in_ms( );
+        circularfs_fetch( &bench_circularfs_fs, object, &size );
+        uint32_t end_time_ms = smtc_modem_hal_get_time_in_ms( );
+
+        append_time_ms += middle_time_ms - start_time_ms;
+        fetch_time_ms += end_time_ms - middle_time_ms;
+    }
+    bench_report( "circularfs_append", NB_LOOP_BENCH_CIRCULARFS, append_time_ms );
+    bench_report( "circularfs_fetch", NB_LOOP_BENCH_CIRCULARFS, fetch_time_ms );
+}
+
+/**
+ * @brief Store of a LoRaWAN stack context in non volatile memory
+ *
+ * @warning The LoRaWAN stack context of the device is overwritten
+ */
+static void bench_context_store( void )
+{
+    uint8_t context[SIZE_BENCH_CONTEXT_STORE];
+
+    memset( context, 0xA5, sizeof( context ) );
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint32_t i = 0; i < NB_LOOP_BENCH_CONTEXT_STORE; i++ )
+    {
+        context[0] = ( uint8_t ) i;
+        smtc_modem_hal_context_store( CONTEXT_LORAWAN_STACK, 0, context, sizeof( context ) );
+    }
+    bench_report( "context_store_64", NB_LOOP_BENCH_CONTEXT_STORE, smtc_modem_hal_get_time_in_ms( ) - start_time_ms );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
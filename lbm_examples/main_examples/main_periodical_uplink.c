@@ -278,7 +278,11 @@ void main_periodical_uplink( void )
         if( ( user_button_is_press == false ) && ( smtc_modem_is_irq_flag_pending( ) == false ) )
         {
             hal_watchdog_reload( );
+#if defined( USE_LOW_POWER_HINT )
+            smtc_modem_enter_low_power( MIN( sleep_time_ms, WATCHDOG_RELOAD_PERIOD_MS ) );
+#else
             hal_mcu_set_sleep_for_ms( MIN( sleep_time_ms, WATCHDOG_RELOAD_PERIOD_MS ) );
+#endif
         }
         hal_watchdog_reload( );
         hal_mcu_enable_irq( );
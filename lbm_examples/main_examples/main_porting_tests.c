@@ -54,6 +54,8 @@
 #include "smtc_hal_mcu.h"
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_watchdog.h"
+#include "radio_utilities.h"
+#include "ral_lora_toa.h"
 
 #if defined( SX128X )
 #include "ralf_sx128x.h"
@@ -65,6 +67,14 @@
 #include "lr11xx_system.h"
 #endif
 
+#if !defined( USE_LR11XX_CRYPTO )
+#include "aes.h"
+#endif
+
+#if defined( ENABLE_TEST_FRAG_DECODER )
+#include "fragmentation_helper_v2.0.0.h"
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -78,6 +88,14 @@
 
 #define NB_LOOP_TEST_SPI 2
 #define NB_LOOP_TEST_CONFIG_RADIO 2
+#define NB_LOOP_TEST_TX_SETUP_LATENCY 50
+#define NB_LOOP_TEST_LORA_TOA 10
+#define NB_LOOP_TEST_AES_BLOCK 2000
+#define NB_LOOP_TEST_AES_KEY 200
+
+#define NB_FRAG_TEST_DECODER 100
+#define SIZE_FRAG_TEST_DECODER 242
+#define LOSS_PERIOD_TEST_DECODER 10  // One uncoded fragment out of LOSS_PERIOD_TEST_DECODER is lost
 
 #if defined( LR1110 )
 #define LR11XX_FW_VERSION 0x0401
@@ -182,6 +200,12 @@ static ralf_params_lora_t tx_lora_param = { .sync_word                       = S
                                             .pkt_params.crc_is_on            = true,
                                             .pkt_params.invert_iq_is_on      = false,
                                             .pkt_params.preamble_len_in_symb = 8 };
+#if defined( ENABLE_TEST_FRAG_DECODER )
+// Decoded file followed by the room needed by the sparse decoder matrix
+static uint8_t frag_test_storage[NB_FRAG_TEST_DECODER * SIZE_FRAG_TEST_DECODER +
+                                 NB_FRAG_TEST_DECODER * ( ( ( NB_FRAG_TEST_DECODER - 1 ) >> 3 ) + 1 )];
+#endif
+
 #if( ENABLE_TEST_FLASH != 0 )
 static const char* name_context_type[] = { "MODEM", "KEY_MODEM",      "LORAWAN_STACK",
                                            "FUOTA", "SECURE_ELEMENT", "STORE_AND_FORWARD" };
@@ -209,8 +233,18 @@ static bool porting_test_disable_enable_irq( void );
 static bool porting_test_random( void );
 static bool porting_test_config_rx_radio( void );
 static bool porting_test_config_tx_radio( void );
+static bool porting_test_tx_setup_latency( void );
+#if !defined( SX128X )
+static bool porting_test_lora_toa( void );
+#endif
 static bool porting_test_sleep_ms( void );
 static bool porting_test_timer_irq_low_power( void );
+#if !defined( USE_LR11XX_CRYPTO )
+static bool porting_test_aes_throughput( void );
+#endif
+#if defined( ENABLE_TEST_FRAG_DECODER )
+static bool porting_test_frag_decoder( void );
+#endif
 #if( ENABLE_TEST_FLASH != 0 )
 static bool test_context_store_restore( modem_context_type_t context_type );
 static bool porting_test_flash( void );
@@ -266,10 +300,24 @@ void main_porting_tests( void )
 
     porting_test_config_tx_radio( );
 
+    porting_test_tx_setup_latency( );
+
+#if !defined( SX128X )
+    porting_test_lora_toa( );
+#endif
+
     porting_test_sleep_ms( );
 
     porting_test_timer_irq_low_power( );
 
+#if !defined( USE_LR11XX_CRYPTO )
+    porting_test_aes_throughput( );
+#endif
+
+#if defined( ENABLE_TEST_FRAG_DECODER )
+    porting_test_frag_decoder( );
+#endif
+
 #else
 
     ret = porting_test_flash( );
@@ -1209,6 +1257,174 @@ static bool porting_test_config_tx_radio( void )
     return true;
 }
 
+/**
+ * @brief Benchmark tx radio setup latency
+ *
+ * @remark
+ * Test processing:
+ * - Init radio
+ * - Get start time
+ * - Configure tx radio NB_LOOP_TEST_TX_SETUP_LATENCY times, each setup ends with an irq status read so the radio is
+ *   ready to be sent SetTx (the busy wait of the last write is paid in both write modes)
+ * - Get stop time
+ * - Print the mean setup time and the mean time spent waiting on the radio busy line
+ *
+ * Build with RADIO_PIPELINED_WRITE=yes/no to compare the write modes
+ *
+ * @return bool True if test is successful
+ */
+static bool porting_test_tx_setup_latency( void )
+{
+#if defined( USE_RADIO_PIPELINED_WRITE )
+    SMTC_HAL_TRACE_MSG( "----------------------------------------\n porting_test_tx_setup_latency (PIPELINED) : " );
+#else
+    SMTC_HAL_TRACE_MSG( "----------------------------------------\n porting_test_tx_setup_latency : " );
+#endif
+
+    uint16_t  payload_size = 50;
+    uint8_t   payload[50]  = { 0 };
+    ral_irq_t irq_status;
+
+    // Reset, init and put it in sleep mode radio
+    bool ret = reset_init_radio( );
+    if( ret == false )
+        return ret;
+
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( true );
+    radio_utilities_reset_busy_wait_time( );
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint16_t i = 0; i < NB_LOOP_TEST_TX_SETUP_LATENCY; i++ )
+    {
+        if( ( ralf_setup_lora( &modem_radio, &tx_lora_param ) != RAL_STATUS_OK ) ||
+            ( ral_set_dio_irq_params( &( modem_radio.ral ), RAL_IRQ_TX_DONE ) != RAL_STATUS_OK ) ||
+            ( ral_set_pkt_payload( &( modem_radio.ral ), payload, payload_size ) != RAL_STATUS_OK ) ||
+            ( ral_get_irq_status( &( modem_radio.ral ), &irq_status ) != RAL_STATUS_OK ) )
+        {
+            smtc_modem_hal_set_ant_switch( false );
+            smtc_modem_hal_stop_radio_tcxo( );
+            PORTING_TEST_MSG_NOK( " tx radio setup failed \n" );
+            return false;
+        }
+    }
+    uint32_t setup_time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+    uint32_t busy_time_ms  = radio_utilities_get_busy_wait_time_ms( );
+
+    smtc_modem_hal_set_ant_switch( false );
+    smtc_modem_hal_stop_radio_tcxo( );
+    ral_set_sleep( &( modem_radio.ral ), true );
+
+    PORTING_TEST_MSG_OK( );
+    SMTC_HAL_TRACE_PRINTF( " Tx setup: %u us / busy wait: %u us \n",
+                           ( setup_time_ms * 1000 ) / NB_LOOP_TEST_TX_SETUP_LATENCY,
+                           ( busy_time_ms * 1000 ) / NB_LOOP_TEST_TX_SETUP_LATENCY );
+    return true;
+}
+
+#if !defined( SX128X )
+/**
+ * @brief Benchmark LoRa time on air computation
+ *
+ * @remark
+ * Test processing:
+ * - Known answer test of the radio driver formula and of the precomputed tables (SF7 and SF12 at 125 kHz)
+ * - Measure the time taken by NB_LOOP_TEST_LORA_TOA sweeps of the LoRaWAN datarates and payload lengths with the
+ *   radio driver entry (ral_get_lora_time_on_air_in_ms)
+ * - Measure the time taken by the same sweeps with the precomputed tables (ral_lora_toa_get_in_us)
+ * - Print the mean computation time of both
+ *
+ * Build with LBM_BUILD_OPTIONS="LBM_RAL_LORA_TOA_TABLE=yes" to route the radio driver entry to the tables
+ *
+ * @return bool True if test is successful
+ */
+static bool porting_test_lora_toa( void )
+{
+    static const ral_lora_bw_t bws[] = { RAL_LORA_BW_125_KHZ, RAL_LORA_BW_250_KHZ, RAL_LORA_BW_500_KHZ };
+    static const struct
+    {
+        ral_lora_sf_t sf;
+        uint32_t      toa_in_ms;
+    } known_answers[] = { { RAL_LORA_SF7, 103 }, { RAL_LORA_SF12, 2466 } };
+
+    ral_lora_mod_params_t mod_params = { .cr = RAL_LORA_CR_4_5 };
+    ral_lora_pkt_params_t pkt_params = {
+        .preamble_len_in_symb = 8,
+        .header_type          = RAL_LORA_PKT_EXPLICIT,
+        .pld_len_in_bytes     = 51,
+        .crc_is_on            = true,
+        .invert_iq_is_on      = false,
+    };
+    uint32_t toa_in_us = 0;
+    uint32_t sum_ms    = 0;
+    uint32_t nb_calls  = 0;
+
+    SMTC_HAL_TRACE_MSG( "----------------------------------------\n porting_test_lora_toa : " );
+
+    mod_params.bw = RAL_LORA_BW_125_KHZ;
+    for( uint8_t i = 0; i < ( sizeof( known_answers ) / sizeof( known_answers[0] ) ); i++ )
+    {
+        mod_params.sf   = known_answers[i].sf;
+        mod_params.ldro = ral_compute_lora_ldro( mod_params.sf, mod_params.bw );
+        if( ( ral_get_lora_time_on_air_in_ms( &( modem_radio.ral ), &pkt_params, &mod_params ) !=
+              known_answers[i].toa_in_ms ) ||
+            ( ral_lora_toa_get_in_us( &pkt_params, &mod_params, &toa_in_us ) == false ) ||
+            ( ral_lora_toa_convert_us_to_ms( toa_in_us ) != known_answers[i].toa_in_ms ) )
+        {
+            PORTING_TEST_MSG_NOK( " time on air known answer test failed (SF%u) \n", mod_params.sf );
+            return false;
+        }
+    }
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint16_t i = 0; i < NB_LOOP_TEST_LORA_TOA; i++ )
+    {
+        for( uint8_t bw = 0; bw < ( sizeof( bws ) / sizeof( bws[0] ) ); bw++ )
+        {
+            mod_params.bw = bws[bw];
+            for( mod_params.sf = RAL_LORA_SF7; mod_params.sf <= RAL_LORA_SF12; mod_params.sf++ )
+            {
+                mod_params.ldro = ral_compute_lora_ldro( mod_params.sf, mod_params.bw );
+                for( uint16_t len = 0; len <= 250; len += 10 )
+                {
+                    pkt_params.pld_len_in_bytes = len;
+                    sum_ms += ral_get_lora_time_on_air_in_ms( &( modem_radio.ral ), &pkt_params, &mod_params );
+                    nb_calls++;
+                }
+            }
+        }
+    }
+    uint32_t driver_time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+
+    start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint16_t i = 0; i < NB_LOOP_TEST_LORA_TOA; i++ )
+    {
+        for( uint8_t bw = 0; bw < ( sizeof( bws ) / sizeof( bws[0] ) ); bw++ )
+        {
+            mod_params.bw = bws[bw];
+            for( mod_params.sf = RAL_LORA_SF7; mod_params.sf <= RAL_LORA_SF12; mod_params.sf++ )
+            {
+                mod_params.ldro = ral_compute_lora_ldro( mod_params.sf, mod_params.bw );
+                for( uint16_t len = 0; len <= 250; len += 10 )
+                {
+                    pkt_params.pld_len_in_bytes = len;
+                    ral_lora_toa_get_in_us( &pkt_params, &mod_params, &toa_in_us );
+                    sum_ms -= ral_lora_toa_convert_us_to_ms( toa_in_us );
+                }
+            }
+        }
+    }
+    uint32_t table_time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+
+    PORTING_TEST_MSG_OK( );
+    // sum_ms is the accumulated difference of both computations, the lr11xx driver formula may round 1 ms lower
+    SMTC_HAL_TRACE_PRINTF( " Time on air: radio driver %u ns / tables %u ns (difference %d ms over %u calls) \n",
+                           ( driver_time_ms * 1000000 ) / nb_calls, ( table_time_ms * 1000000 ) / nb_calls,
+                           ( int32_t ) sum_ms, nb_calls );
+    return true;
+}
+#endif
+
 /**
  * @brief Test sleep time
  *
@@ -1328,6 +1544,217 @@ static bool porting_test_timer_irq_low_power( void )
     return true;
 }
 
+#if !defined( USE_LR11XX_CRYPTO )
+/**
+ * @brief Benchmark of the soft AES backend used by the soft secure element
+ *
+ * @remark
+ * Build once with CRYPTO=SOFT and once with CRYPTO=SOFT_FAST to compare both backends side by side on the target.
+ *
+ * Test processing:
+ * - Known answer test (FIPS-197 appendix C.1) to validate the backend
+ * - Measure the time taken by NB_LOOP_TEST_AES_KEY key expansions
+ * - Measure the time taken by NB_LOOP_TEST_AES_BLOCK block encryptions
+ *
+ * @return bool True if test is successful
+ */
+static bool porting_test_aes_throughput( void )
+{
+    static const uint8_t key[16]      = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                          0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
+    static const uint8_t plain[16]    = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                          0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+    static const uint8_t expected[16] = { 0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+                                          0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A };
+    aes_context          aes_ctx;
+    uint8_t              block[16];
+
+#if defined( SMTC_AES_FAST )
+    SMTC_HAL_TRACE_MSG( "----------------------------------------\n porting_test_aes_throughput (SOFT_FAST) : " );
+#else
+    SMTC_HAL_TRACE_MSG( "----------------------------------------\n porting_test_aes_throughput (SOFT) : " );
+#endif
+
+    memset( &aes_ctx, 0, sizeof( aes_ctx ) );
+    smtc_aes_set_key( key, 16, &aes_ctx );
+    smtc_aes_encrypt( plain, block, &aes_ctx );
+    if( memcmp( block, expected, sizeof( block ) ) != 0 )
+    {
+        PORTING_TEST_MSG_NOK( " AES known answer test failed \n" );
+        return false;
+    }
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint16_t i = 0; i < NB_LOOP_TEST_AES_KEY; i++ )
+    {
+        smtc_aes_set_key( key, 16, &aes_ctx );
+    }
+    uint32_t key_time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+
+    start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    for( uint16_t i = 0; i < NB_LOOP_TEST_AES_BLOCK; i++ )
+    {
+        smtc_aes_encrypt( block, block, &aes_ctx );
+    }
+    uint32_t block_time_ms = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+
+    PORTING_TEST_MSG_OK( );
+    SMTC_HAL_TRACE_PRINTF( " Key expansion: %u us / AES block: %u us \n",
+                           ( key_time_ms * 1000 ) / NB_LOOP_TEST_AES_KEY,
+                           ( block_time_ms * 1000 ) / NB_LOOP_TEST_AES_BLOCK );
+    return true;
+}
+#endif
+
+#if defined( ENABLE_TEST_FRAG_DECODER )
+static int8_t frag_test_write( uint32_t addr, uint8_t* data, uint32_t size )
+{
+    if( ( addr + size ) > sizeof( frag_test_storage ) )
+    {
+        return -1;
+    }
+    memcpy( &frag_test_storage[addr], data, size );
+    return 0;
+}
+
+static int8_t frag_test_read( uint32_t addr, uint8_t* data, uint32_t size )
+{
+    if( ( addr + size ) > sizeof( frag_test_storage ) )
+    {
+        return -1;
+    }
+    memcpy( data, &frag_test_storage[addr], size );
+    return 0;
+}
+
+/**
+ * @brief Content of the test file
+ *
+ * @param [in] index Byte index in the file
+ *
+ * @return uint8_t Byte value
+ */
+static uint8_t frag_test_file_byte( uint32_t index )
+{
+    return ( uint8_t ) ( ( index * 7 ) ^ ( index >> 8 ) );
+}
+
+/**
+ * @brief Coded fragment as sent by the fragmentation server, same parity matrix as the decoder
+ *
+ * @param [in]  n        Coded fragment number, starting at 1
+ * @param [out] fragment Coded fragment
+ */
+static void frag_test_coded_fragment( uint16_t n, uint8_t* fragment )
+{
+    uint8_t  selected[( NB_FRAG_TEST_DECODER >> 3 ) + 1] = { 0 };
+    uint16_t nb_coeff                                    = 0;
+    int32_t  x                                           = 1 + ( 1001 * n );
+    // NB_FRAG_TEST_DECODER is not a power of two
+    int32_t m = NB_FRAG_TEST_DECODER;
+
+    memset( fragment, 0, SIZE_FRAG_TEST_DECODER );
+    while( nb_coeff < ( m >> 1 ) )
+    {
+        int32_t r = 1 << 16;
+        while( r >= m )
+        {
+            x = ( x >> 1 ) + ( ( ( x & 0x01 ) ^ ( ( x & 0x20 ) >> 5 ) ) << 22 );
+            r = x % m;
+        }
+        if( ( selected[r >> 3] & ( 1 << ( 7 - ( r % 8 ) ) ) ) == 0 )
+        {
+            selected[r >> 3] |= 1 << ( 7 - ( r % 8 ) );
+            nb_coeff++;
+            for( uint16_t i = 0; i < SIZE_FRAG_TEST_DECODER; i++ )
+            {
+                fragment[i] ^= frag_test_file_byte( ( uint32_t ) r * SIZE_FRAG_TEST_DECODER + i );
+            }
+        }
+    }
+}
+
+/**
+ * @brief Benchmark of the FUOTA v2 fragmentation decoder
+ *
+ * @remark
+ * The file is decoded in RAM so that only the decoder computation is measured.
+ *
+ * Test processing:
+ * - Decode a NB_FRAG_TEST_DECODER x SIZE_FRAG_TEST_DECODER session losing one uncoded fragment out of
+ *   LOSS_PERIOD_TEST_DECODER, the coded fragments being received without loss
+ * - Measure the time spent in the decoder for the whole session and for the last fragment, which runs the final
+ *   back substitution
+ * - Check the decoded file
+ *
+ * @return bool True if test is successful
+ */
+static bool porting_test_frag_decoder( void )
+{
+    FragDecoderCallbacks_t callbacks = { .FragDecoderWrite = frag_test_write, .FragDecoderRead = frag_test_read };
+    uint8_t                fragment[SIZE_FRAG_TEST_DECODER];
+    int32_t                status        = FRAG_SESSION_ONGOING;
+    uint32_t               total_time_ms = 0;
+    uint32_t               last_time_ms  = 0;
+    uint16_t               counter       = 0;
+
+    SMTC_HAL_TRACE_MSG( "----------------------------------------\n porting_test_frag_decoder : " );
+
+    if( FragDecoderGetMaxFileSize( ) < ( NB_FRAG_TEST_DECODER * SIZE_FRAG_TEST_DECODER ) )
+    {
+        PORTING_TEST_MSG_WARN( " FRAG_MAX_NB x FRAG_MAX_SIZE too small for a %u x %u session \n", NB_FRAG_TEST_DECODER,
+                               SIZE_FRAG_TEST_DECODER );
+        return true;
+    }
+
+    FragDecoderInit( NB_FRAG_TEST_DECODER, SIZE_FRAG_TEST_DECODER, &callbacks );
+
+    while( ( status == FRAG_SESSION_ONGOING ) && ( counter < ( 2 * NB_FRAG_TEST_DECODER ) ) )
+    {
+        counter++;
+        if( counter <= NB_FRAG_TEST_DECODER )
+        {
+            if( ( counter % LOSS_PERIOD_TEST_DECODER ) == 0 )
+            {
+                continue;
+            }
+            for( uint16_t i = 0; i < SIZE_FRAG_TEST_DECODER; i++ )
+            {
+                fragment[i] = frag_test_file_byte( ( uint32_t ) ( counter - 1 ) * SIZE_FRAG_TEST_DECODER + i );
+            }
+        }
+        else
+        {
+            frag_test_coded_fragment( counter - NB_FRAG_TEST_DECODER, fragment );
+        }
+
+        uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+        status                 = FragDecoderProcess( counter, fragment );
+        last_time_ms           = smtc_modem_hal_get_time_in_ms( ) - start_time_ms;
+        total_time_ms += last_time_ms;
+    }
+
+    if( status != FRAG_SESSION_FINISHED_SUCCESSFULLY )
+    {
+        PORTING_TEST_MSG_NOK( " Session not decoded, status %d after %u fragments \n", status, counter );
+        return false;
+    }
+    for( uint32_t i = 0; i < ( NB_FRAG_TEST_DECODER * SIZE_FRAG_TEST_DECODER ); i++ )
+    {
+        if( frag_test_storage[i] != frag_test_file_byte( i ) )
+        {
+            PORTING_TEST_MSG_NOK( " Wrong decoded byte at %u \n", i );
+            return false;
+        }
+    }
+
+    PORTING_TEST_MSG_OK( );
+    SMTC_HAL_TRACE_PRINTF( " %u fragments lost, decoded after %u fragments: total %u ms / last fragment %u ms \n",
+                           FragDecoderGetStatus( ).FragNbLost, counter, total_time_ms, last_time_ms );
+    return true;
+}
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- FLASH PORTING TESTS -----------------------------------------------------
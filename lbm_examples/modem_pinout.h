@@ -110,6 +110,11 @@ extern "C" {
 #define HW_MODEM_BUSY_PIN       PC_8
 #define HW_MODEM_TX_LINE        PC_10
 #define HW_MODEM_RX_LINE        PC_11
+// SPI slave host interface (USE_HW_MODEM_SPI) in place of the uart, on SPI2
+#define HW_MODEM_SPI_NSS        PB_12
+#define HW_MODEM_SPI_SCLK       PB_13
+#define HW_MODEM_SPI_MISO       PB_14
+#define HW_MODEM_SPI_MOSI       PB_15
 /* clang-format on */
 
 /*
@@ -39,11 +39,13 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
 
 #include "lr11xx_hal.h"
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_spi.h"
 #include "smtc_hal_mcu.h"
+#include "radio_utilities.h"
 
 #include "modem_pinout.h"
 
@@ -113,10 +115,7 @@ lr11xx_hal_status_t lr11xx_hal_write( const void* context, const uint8_t* comman
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data[i] );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
     // Add crc byte at the end of the transaction
@@ -175,10 +174,7 @@ lr11xx_hal_status_t lr11xx_hal_read( const void* context, const uint8_t* command
         hal_spi_in_out( RADIO_SPI_ID, 0 );
 #endif
 
-        for( uint16_t i = 0; i < data_length; i++ )
-        {
-            data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-        }
+        hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
         // read crc sent by lr11xx at the end of the transaction
@@ -210,10 +206,7 @@ lr11xx_hal_status_t lr11xx_hal_direct_read( const void* context, uint8_t* data,
     // Put NSS low to start spi transaction
     hal_gpio_set_value( RADIO_NSS, 0 );
 
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
 
 #if defined( USE_LR11XX_CRC_OVER_SPI )
     // read crc sent by lr11xx by sending one more NOP
@@ -281,9 +274,7 @@ lr11xx_hal_status_t lr11xx_hal_abort_blocking_cmd( const void* context )
 
 void lr11xx_hal_wait_on_busy( void )
 {
-    while( hal_gpio_get_value( RADIO_BUSY_PIN ) == 1 )
-    {
-    };
+    radio_utilities_wait_on_busy( );
 }
 
 void lr11xx_hal_check_device_ready( void )
@@ -41,6 +41,10 @@
 #include <stdbool.h>  // bool type
 
 #include "radio_utilities.h"
+#include "smtc_hal_gpio.h"
+#include "smtc_hal_mcu.h"
+#include "smtc_hal_rtc.h"
+#include "modem_pinout.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -54,6 +58,13 @@
 #ifndef DEFAULT_TX_POWER_OFFSET_DB
 #define DEFAULT_TX_POWER_OFFSET_DB ( 0 )
 #endif
+
+/*!
+ * Maximum time to wait for the radio busy line, lr11xx keeps it high during the gnss and wifi scans
+ */
+#ifndef RADIO_BUSY_WAIT_TIMEOUT_MS
+#define RADIO_BUSY_WAIT_TIMEOUT_MS ( 10000 )
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -66,6 +77,10 @@
 
 static int8_t board_tx_pwr_offset_db = DEFAULT_TX_POWER_OFFSET_DB;
 
+static uint32_t radio_busy_wait_time_ms = 0;
+
+static uint32_t radio_tcxo_startup_delay_ms = 0;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -86,6 +101,63 @@ int8_t radio_utilities_get_tx_power_offset( void )
     return board_tx_pwr_offset_db;
 }
 
+void radio_utilities_wait_on_busy( void )
+{
+    if( hal_gpio_get_value( RADIO_BUSY_PIN ) == 0 )
+    {
+        return;
+    }
+
+    // The time base is read while the radio is busy anyway. A wait shorter than 1 ms counts for 0 or 1 ms depending
+    // on its start time, so the accumulated time stays right on average.
+    const uint32_t start_ms = hal_rtc_get_time_ms( );
+    uint32_t       now_ms   = start_ms;
+
+    while( hal_gpio_get_value( RADIO_BUSY_PIN ) == 1 )
+    {
+#if defined( USE_RADIO_BUSY_IRQ_WAIT )
+        uint32_t mask;
+
+        // A falling edge after the test keeps its interrupt pending, which wakes the core up at once
+        hal_mcu_critical_section_begin( &mask );
+        if( hal_gpio_get_value( RADIO_BUSY_PIN ) == 1 )
+        {
+            hal_mcu_wait_for_interrupt( );
+        }
+        hal_mcu_critical_section_end( &mask );
+#endif
+
+        now_ms = hal_rtc_get_time_ms( );
+        if( ( now_ms - start_ms ) >= RADIO_BUSY_WAIT_TIMEOUT_MS )
+        {
+            SMTC_HAL_TRACE_ERROR( "Radio busy wait timeout\n" );
+            break;
+        }
+    }
+
+    radio_busy_wait_time_ms += now_ms - start_ms;
+}
+
+uint32_t radio_utilities_get_busy_wait_time_ms( void )
+{
+    return radio_busy_wait_time_ms;
+}
+
+void radio_utilities_reset_busy_wait_time( void )
+{
+    radio_busy_wait_time_ms = 0;
+}
+
+void radio_utilities_set_tcxo_startup_delay_ms( uint32_t startup_delay_ms )
+{
+    radio_tcxo_startup_delay_ms = startup_delay_ms;
+}
+
+uint32_t radio_utilities_get_tcxo_startup_delay_ms( void )
+{
+    return radio_tcxo_startup_delay_ms;
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
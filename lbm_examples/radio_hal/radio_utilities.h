@@ -81,6 +81,38 @@ int8_t radio_utilities_get_tx_power_offset( void );
  */
 void radio_utilities_set_tx_power_offset( int8_t tx_pwr_offset_db );
 
+/**
+ * @brief Wait until the radio busy line returns to 0
+ *
+ * @remark With USE_RADIO_BUSY_IRQ_WAIT the MCU sleeps until the busy falling edge interrupt (or the next SysTick)
+ * instead of polling the line. The wait is given up after RADIO_BUSY_WAIT_TIMEOUT_MS.
+ */
+void radio_utilities_wait_on_busy( void );
+
+/**
+ * @brief Get the time spent waiting on the radio busy line since boot or the last reset of the counter
+ *
+ * @return Accumulated busy wait time in ms
+ */
+uint32_t radio_utilities_get_busy_wait_time_ms( void );
+
+/**
+ * @brief Reset the accumulated busy wait time
+ */
+void radio_utilities_reset_busy_wait_time( void );
+
+/**
+ * @brief Set the tcxo startup delay measured by the radio BSP
+ * @param [in] startup_delay_ms Measured delay in ms, 0 to use the nominal delay of the board
+ */
+void radio_utilities_set_tcxo_startup_delay_ms( uint32_t startup_delay_ms );
+
+/**
+ * @brief Get the tcxo startup delay measured by the radio BSP
+ * @return Measured delay in ms, 0 if no measure is available
+ */
+uint32_t radio_utilities_get_tcxo_startup_delay_ms( void );
+
 #ifdef __cplusplus
 }
 #endif
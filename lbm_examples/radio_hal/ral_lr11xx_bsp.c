@@ -46,6 +46,7 @@
 #include "radio_utilities.h"
 #include "smtc_modem_hal.h"
 #include "lr11xx_radio.h"
+#include "lr11xx_system.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -80,6 +81,35 @@
 
 #define LR11XX_PWR_VREG_VBAT_SWITCH 8
 
+#if defined( USE_RADIO_TCXO_CALIBRATION )
+// Time the tcxo is left off before each start of the measure, for a cold start
+#ifndef RADIO_TCXO_CALIB_OFF_TIME_US
+#define RADIO_TCXO_CALIB_OFF_TIME_US 2000
+#endif
+
+// Lowest operating temperature of the board in degree Celsius
+#ifndef RADIO_TCXO_CALIB_MIN_TEMPERATURE
+#define RADIO_TCXO_CALIB_MIN_TEMPERATURE -40
+#endif
+
+// Temperature drop over which the tcxo startup time is assumed to double
+#ifndef RADIO_TCXO_CALIB_DOUBLING_DEGREES
+#define RADIO_TCXO_CALIB_DOUBLING_DEGREES 60
+#endif
+
+// Margin in ms added to the measured startup time
+#ifndef RADIO_TCXO_CALIB_MARGIN_MS
+#define RADIO_TCXO_CALIB_MARGIN_MS 1
+#endif
+#endif
+
+#if defined( USE_RADIO_PA_EFFICIENCY )
+// Battery voltage of the tx consumption tables
+#ifndef LR11XX_TX_CONSUMPTION_VBAT_MV
+#define LR11XX_TX_CONSUMPTION_VBAT_MV 3300
+#endif
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -307,6 +337,43 @@ static const uint32_t ral_lr11xx_convert_tx_dbm_to_ua_reg_mode_dcdc_hf_vreg[] =
 void lr11xx_get_tx_cfg( lr11xx_pa_type_t pa_type, int8_t expected_output_pwr_in_dbm,
                         ral_lr11xx_bsp_tx_cfg_output_params_t* output_params );
 
+#if defined( USE_RADIO_TCXO_CALIBRATION ) && !defined( LR1121 )
+/**
+ * @brief Get the tcxo startup delay from its measure, with a margin for the coldest operating temperature
+ *
+ * @param [in] context Chip implementation context
+ * @param [in] supply_voltage Tcxo supply voltage
+ * @param [in] nominal_time_ms Nominal startup delay of the board
+ *
+ * @returns Startup delay in ms, at most nominal_time_ms
+ */
+static uint32_t lr11xx_tcxo_calibrate( const void* context, lr11xx_system_tcxo_supply_voltage_t supply_voltage,
+                                       uint32_t nominal_time_ms );
+
+/**
+ * @brief Check if the tcxo started from cold is ready within a timeout
+ *
+ * @param [in] context Chip implementation context
+ * @param [in] supply_voltage Tcxo supply voltage
+ * @param [in] time_in_tick Tcxo timeout in rtc step (30.52 us)
+ *
+ * @returns true if the radio reported no HF xosc start error
+ */
+static bool lr11xx_tcxo_starts_within( const void* context, lr11xx_system_tcxo_supply_voltage_t supply_voltage,
+                                       uint32_t time_in_tick );
+#endif
+
+#if defined( USE_RADIO_PA_EFFICIENCY )
+/**
+ * @brief Check if the LP PA draws less battery current than the HP PA for an output power both can reach
+ *
+ * @param [in] power Output power in dBm, in [ LR11XX_HP_MIN_OUTPUT_POWER , LR11XX_LP_MAX_OUTPUT_POWER ]
+ *
+ * @returns true if the LP PA is the most efficient one
+ */
+static bool lr11xx_lp_pa_is_more_efficient( int8_t power );
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -359,10 +426,18 @@ void ral_lr11xx_bsp_get_xosc_cfg( const void* context, ral_xosc_cfg_t* xosc_cfg,
                                   lr11xx_system_tcxo_supply_voltage_t* supply_voltage, uint32_t* startup_time_in_tick )
 {
 #if !defined( LR1121 )
+#if defined( USE_RADIO_TCXO_CALIBRATION )
+    // Measure again from the nominal value of the board
+    radio_utilities_set_tcxo_startup_delay_ms( 0 );
+#endif
     // Get startup value defined in modem_hal to avoid mis-alignment
     uint32_t startup_time_ms = smtc_modem_hal_get_radio_tcxo_startup_delay_ms( );
     *xosc_cfg                = RAL_XOSC_CFG_TCXO_RADIO_CTRL;
     *supply_voltage          = LR11XX_SYSTEM_TCXO_CTRL_1_8V;
+#if defined( USE_RADIO_TCXO_CALIBRATION )
+    startup_time_ms = lr11xx_tcxo_calibrate( context, *supply_voltage, startup_time_ms );
+    radio_utilities_set_tcxo_startup_delay_ms( startup_time_ms );
+#endif
     // tick is 30.52µs
     *startup_time_in_tick = lr11xx_radio_convert_time_in_ms_to_rtc_step( startup_time_ms );
 #endif  // !defined( LR1121 )
@@ -542,7 +617,12 @@ void lr11xx_get_tx_cfg( lr11xx_pa_type_t pa_type, int8_t expected_output_pwr_in_
         }
         output_params->chip_output_pwr_in_dbm_expected = power;
 
+#if defined( USE_RADIO_PA_EFFICIENCY )
+        if( ( power < LR11XX_HP_MIN_OUTPUT_POWER ) ||
+            ( ( power <= LR11XX_LP_MAX_OUTPUT_POWER ) && ( lr11xx_lp_pa_is_more_efficient( power ) == true ) ) )
+#else
         if( power <= LR11XX_LP_MAX_OUTPUT_POWER )
+#endif
         {
             output_params->pa_cfg.pa_sel        = LR11XX_RADIO_PA_SEL_LP;
             output_params->pa_cfg.pa_reg_supply = LR11XX_RADIO_PA_REG_SUPPLY_VREG;
@@ -582,6 +662,96 @@ void lr11xx_get_tx_cfg( lr11xx_pa_type_t pa_type, int8_t expected_output_pwr_in_
     }
 }
 
+#if defined( USE_RADIO_TCXO_CALIBRATION ) && !defined( LR1121 )
+static uint32_t lr11xx_tcxo_calibrate( const void* context, lr11xx_system_tcxo_supply_voltage_t supply_voltage,
+                                       uint32_t nominal_time_ms )
+{
+    // Shortest timeout without HF xosc start error, between a timeout too short and the nominal one
+    uint32_t too_short_in_tick = 0;
+    uint32_t time_in_tick      = lr11xx_radio_convert_time_in_ms_to_rtc_step( nominal_time_ms );
+
+    while( ( time_in_tick - too_short_in_tick ) > 1 )
+    {
+        uint32_t middle_in_tick = ( too_short_in_tick + time_in_tick ) / 2;
+
+        if( lr11xx_tcxo_starts_within( context, supply_voltage, middle_in_tick ) == true )
+        {
+            time_in_tick = middle_in_tick;
+        }
+        else
+        {
+            too_short_in_tick = middle_in_tick;
+        }
+    }
+    lr11xx_system_clear_errors( context );
+
+    // The startup time gets longer in the cold
+    int8_t temperature = smtc_modem_hal_get_temperature( );
+    if( temperature > RADIO_TCXO_CALIB_MIN_TEMPERATURE )
+    {
+        time_in_tick += ( time_in_tick * ( uint32_t ) ( temperature - RADIO_TCXO_CALIB_MIN_TEMPERATURE ) ) /
+                        RADIO_TCXO_CALIB_DOUBLING_DEGREES;
+    }
+
+    uint32_t time_ms = ( ( time_in_tick * 1000 ) + 32767 ) / 32768 + RADIO_TCXO_CALIB_MARGIN_MS;
+    SMTC_HAL_TRACE_INFO( "LR11XX tcxo startup delay %u ms at %d C\n", time_ms, temperature );
+    return ( time_ms < nominal_time_ms ) ? time_ms : nominal_time_ms;
+}
+
+static bool lr11xx_tcxo_starts_within( const void* context, lr11xx_system_tcxo_supply_voltage_t supply_voltage,
+                                       uint32_t time_in_tick )
+{
+    uint16_t errors = 0;
+
+    // The tcxo is not supplied in standby RC
+    if( lr11xx_system_set_standby( context, LR11XX_SYSTEM_STANDBY_CFG_RC ) != LR11XX_STATUS_OK )
+    {
+        return false;
+    }
+    hal_mcu_wait_us( RADIO_TCXO_CALIB_OFF_TIME_US );
+
+    // The radio waits for the timeout before checking the HF xosc
+    if( ( lr11xx_system_set_tcxo_mode( context, supply_voltage, time_in_tick ) != LR11XX_STATUS_OK ) ||
+        ( lr11xx_system_clear_errors( context ) != LR11XX_STATUS_OK ) ||
+        ( lr11xx_system_set_standby( context, LR11XX_SYSTEM_STANDBY_CFG_XOSC ) != LR11XX_STATUS_OK ) ||
+        ( lr11xx_system_get_errors( context, &errors ) != LR11XX_STATUS_OK ) )
+    {
+        return false;
+    }
+    return ( errors & LR11XX_SYSTEM_ERRORS_HF_XOSC_START_MASK ) == 0;
+}
+#endif
+
+#if defined( USE_RADIO_PA_EFFICIENCY )
+static bool lr11xx_lp_pa_is_more_efficient( int8_t power )
+{
+    lr11xx_system_reg_mode_t reg_mode;
+    uint32_t                 lp_ua;
+    uint32_t                 hp_ua;
+
+    ral_lr11xx_bsp_get_reg_mode( NULL, &reg_mode );
+    if( reg_mode == LR11XX_SYSTEM_REG_MODE_DCDC )
+    {
+        lp_ua = ral_lr11xx_convert_tx_dbm_to_ua_reg_mode_dcdc_lp_vreg[power + LR11XX_LP_CONVERT_TABLE_INDEX_OFFSET];
+        hp_ua = ral_lr11xx_convert_tx_dbm_to_ua_reg_mode_dcdc_hp_vbat[power + LR11XX_HP_CONVERT_TABLE_INDEX_OFFSET];
+
+        // The DC-DC converter supplying the LP PA draws a constant power from the battery: its current rises when the
+        // battery voltage drops, while the HP PA current drawn directly from VBAT stays the same
+        uint16_t vbat_mv = smtc_modem_hal_get_voltage_mv( );
+        if( vbat_mv != 0 )
+        {
+            lp_ua = ( lp_ua * LR11XX_TX_CONSUMPTION_VBAT_MV ) / vbat_mv;
+        }
+    }
+    else
+    {
+        lp_ua = ral_lr11xx_convert_tx_dbm_to_ua_reg_mode_ldo_lp_vreg[power + LR11XX_LP_CONVERT_TABLE_INDEX_OFFSET];
+        hp_ua = ral_lr11xx_convert_tx_dbm_to_ua_reg_mode_ldo_hp_vbat[power + LR11XX_HP_CONVERT_TABLE_INDEX_OFFSET];
+    }
+    return lp_ua <= hp_ua;
+}
+#endif
+
 ral_status_t ral_lr11xx_bsp_get_instantaneous_tx_power_consumption( const void *context,
                                                                     const ral_lr11xx_bsp_tx_cfg_output_params_t* tx_cfg,
                                                                     lr11xx_system_reg_mode_t radio_reg_mode,
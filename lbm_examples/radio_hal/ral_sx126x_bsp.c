@@ -221,11 +221,30 @@ static const uint32_t ral_sx126x_convert_tx_dbm_to_ua_reg_mode_ldo_hp[] = {
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
+#if defined( USE_RADIO_PA_EFFICIENCY ) && defined( SX1262 )
+typedef struct sx126x_pa_pwr_cfg_s
+{
+    int8_t  max_power;  // output power of the setting with the highest power parameter (22 dBm)
+    uint8_t pa_duty_cycle;
+    uint8_t hp_max;
+} sx126x_pa_pwr_cfg_t;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+#if defined( USE_RADIO_PA_EFFICIENCY ) && defined( SX1262 )
+// SX1262 optimal PA settings (datasheet), by increasing output power and consumption
+static const sx126x_pa_pwr_cfg_t sx126x_hp_pa_cfg_table[] = {
+    { .max_power = 14, .pa_duty_cycle = 0x02, .hp_max = 0x02 },
+    { .max_power = 17, .pa_duty_cycle = 0x02, .hp_max = 0x03 },
+    { .max_power = 20, .pa_duty_cycle = 0x03, .hp_max = 0x05 },
+    { .max_power = 22, .pa_duty_cycle = 0x04, .hp_max = 0x07 },
+};
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -269,11 +288,25 @@ void ral_sx126x_bsp_get_tx_cfg( const void* context, const ral_sx126x_bsp_tx_cfg
     {
         power = -9;
     }
-    output_params->pa_cfg.device_sel                 = 0x00;  // select SX1262/SX1268 device
+    output_params->pa_cfg.device_sel = 0x00;  // select SX1262/SX1268 device
+#if defined( USE_RADIO_PA_EFFICIENCY ) && defined( SX1262 )
+    // Smallest PA setting reaching the power, the power parameter backs off from its maximum output power: the
+    // 22 dBm setting backed off to 14 dBm draws about twice the current of the 14 dBm setting
+    uint8_t cfg = 0;
+    while( sx126x_hp_pa_cfg_table[cfg].max_power < power )
+    {
+        cfg++;
+    }
+    output_params->pa_cfg.hp_max        = sx126x_hp_pa_cfg_table[cfg].hp_max;
+    output_params->pa_cfg.pa_duty_cycle = sx126x_hp_pa_cfg_table[cfg].pa_duty_cycle;
+    output_params->chip_output_pwr_in_dbm_configured =
+        ( int8_t ) ( SX126X_HP_MAX_OUTPUT_POWER - ( sx126x_hp_pa_cfg_table[cfg].max_power - power ) );
+#else
     output_params->pa_cfg.hp_max                     = 0x07;  // to achieve 22dBm
     output_params->pa_cfg.pa_duty_cycle              = 0x04;
     output_params->chip_output_pwr_in_dbm_configured = ( int8_t ) power;
-    output_params->chip_output_pwr_in_dbm_expected   = ( int8_t ) power;
+#endif
+    output_params->chip_output_pwr_in_dbm_expected = ( int8_t ) power;
 #else
     // Clamp power if needed
     if( power > 15 )
@@ -39,12 +39,14 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
 
 #include "sx126x_hal.h"
 
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_spi.h"
 #include "smtc_hal_mcu.h"
+#include "radio_utilities.h"
 #include "modem_pinout.h"
 
 /*
@@ -108,22 +110,24 @@ sx126x_hal_status_t sx126x_hal_write( const void* context, const uint8_t* comman
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data[i] );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
 
     // 0x84 - SX126x_SET_SLEEP opcode. In sleep mode the radio dio is struck to 1 => do not test it
-    if( command[0] != 0x84 )
+    if( command[0] == 0x84 )
     {
-        sx126x_hal_check_device_ready( );
+        radio_mode = RADIO_SLEEP;
     }
+#if !defined( USE_RADIO_PIPELINED_WRITE )
     else
     {
-        radio_mode = RADIO_SLEEP;
+        sx126x_hal_check_device_ready( );
     }
+#else
+    // Pipelined write: the command is processed while the mcu goes on, the busy line is checked by the leading
+    // check_device_ready of the next read/write
+#endif
 
     return SX126X_HAL_STATUS_OK;
 }
@@ -139,16 +143,39 @@ sx126x_hal_status_t sx126x_hal_read( const void* context, const uint8_t* command
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
 
     return SX126X_HAL_STATUS_OK;
 }
 
+sx126x_hal_status_t sx126x_hal_write_batch( const void* context, const uint8_t* buffer, const uint16_t length )
+{
+    uint16_t index = 0;
+
+    // Records are [length][command][data], the driver never records the sleep command
+    while( index < length )
+    {
+        const uint8_t record_length = buffer[index];
+
+        // The previous command shall be processed before sending the next one
+        sx126x_hal_check_device_ready( );
+
+        hal_gpio_set_value( RADIO_NSS, 0 );
+        hal_spi_transfer_dma( RADIO_SPI_ID, &buffer[index + 1], NULL, record_length );
+        hal_gpio_set_value( RADIO_NSS, 1 );
+
+        index += 1 + record_length;
+    }
+
+#if !defined( USE_RADIO_PIPELINED_WRITE )
+    sx126x_hal_check_device_ready( );
+#endif
+
+    return SX126X_HAL_STATUS_OK;
+}
+
 sx126x_hal_status_t sx126x_hal_reset( const void* context )
 {
     hal_gpio_set_value( RADIO_NRST, 0 );
@@ -172,9 +199,7 @@ sx126x_hal_status_t sx126x_hal_wakeup( const void* context )
 
 static void sx126x_hal_wait_on_busy( void )
 {
-    while( hal_gpio_get_value( RADIO_BUSY_PIN ) == 1 )
-    {
-    };
+    radio_utilities_wait_on_busy( );
 }
 
 static void sx126x_hal_check_device_ready( void )
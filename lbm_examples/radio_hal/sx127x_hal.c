@@ -122,10 +122,7 @@ sx127x_hal_status_t sx127x_hal_write( const sx127x_t* radio, const uint16_t addr
     hal_gpio_set_value( RADIO_NSS, 0 );
 
     hal_spi_in_out( RADIO_SPI_ID, address | 0x80 );
-    for( uint16_t i = 0; i < data_len; i++ )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data[i] );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_len );
 
     hal_gpio_set_value( RADIO_NSS, 1 );
 
@@ -142,10 +139,7 @@ sx127x_hal_status_t sx127x_hal_read( const sx127x_t* radio, const uint16_t addre
     hal_gpio_set_value( RADIO_NSS, 0 );
 
     hal_spi_in_out( RADIO_SPI_ID, address & ( ~0x80 ) );
-    for( uint16_t i = 0; i < data_len; i++ )
-    {
-        data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_len );
 
     hal_gpio_set_value( RADIO_NSS, 1 );
 
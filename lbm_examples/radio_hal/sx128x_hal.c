@@ -39,12 +39,14 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
 
 #include "sx128x_hal.h"
 
 #include "smtc_hal_gpio.h"
 #include "smtc_hal_spi.h"
 #include "smtc_hal_mcu.h"
+#include "radio_utilities.h"
 #include "modem_pinout.h"
 
 /*
@@ -107,22 +109,24 @@ sx128x_hal_status_t sx128x_hal_write( const void* context, const uint8_t* comman
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        hal_spi_in_out( RADIO_SPI_ID, data[i] );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, data, NULL, data_length );
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
 
     // 0x84 - SX128X_SET_SLEEP opcode. In sleep mode the radio dio is struck to 1 => do not test it
-    if( command[0] != 0x84 )
+    if( command[0] == 0x84 )
     {
-        sx128x_hal_check_device_ready( );
+        radio_mode = RADIO_SLEEP;
     }
+#if !defined( USE_RADIO_PIPELINED_WRITE )
     else
     {
-        radio_mode = RADIO_SLEEP;
+        sx128x_hal_check_device_ready( );
     }
+#else
+    // Pipelined write: the command is processed while the mcu goes on, the busy line is checked by the leading
+    // check_device_ready of the next read/write
+#endif
 
     return SX128X_HAL_STATUS_OK;
 }
@@ -138,10 +142,7 @@ sx128x_hal_status_t sx128x_hal_read( const void* context, const uint8_t* command
     {
         hal_spi_in_out( RADIO_SPI_ID, command[i] );
     }
-    for( uint16_t i = 0; i < data_length; i++ )
-    {
-        data[i] = hal_spi_in_out( RADIO_SPI_ID, 0 );
-    }
+    hal_spi_transfer_dma( RADIO_SPI_ID, NULL, data, data_length );
     // Put NSS high as the spi transaction is finished
     hal_gpio_set_value( RADIO_NSS, 1 );
 
@@ -171,9 +172,7 @@ sx128x_hal_status_t sx128x_hal_wakeup( const void* context )
 
 static void sx128x_hal_wait_on_busy( void )
 {
-    while( hal_gpio_get_value( RADIO_BUSY_PIN ) == 1 )
-    {
-    }
+    radio_utilities_wait_on_busy( );
 }
 
 static void sx128x_hal_check_device_ready( void )
@@ -182,6 +182,18 @@ void __attribute__( ( optimize( "O0" ) ) ) hal_mcu_wait_us( const int32_t micros
     }
 }
 
+void hal_mcu_wait_for_interrupt( void )
+{
+    if( __get_IPSR( ) != 0 )
+    {
+        return;
+    }
+    // SysTick (1 ms) runs without interrupt, enable it for the time of the sleep
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+    __WFI( );
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+}
+
 void hal_mcu_set_sleep_for_ms( const int32_t milliseconds )
 {
     if( milliseconds <= 0 )
@@ -301,7 +313,12 @@ static void mcu_gpio_init( void )
 #endif
 
     hal_gpio_init_out( RADIO_NSS, 1 );
+#if defined( USE_RADIO_BUSY_IRQ_WAIT )
+    // No callback, the busy falling edge interrupt only wakes the core up
+    hal_gpio_init_in( RADIO_BUSY_PIN, BSP_GPIO_PULL_MODE_NONE, BSP_GPIO_IRQ_MODE_FALLING, NULL );
+#else
     hal_gpio_init_in( RADIO_BUSY_PIN, BSP_GPIO_PULL_MODE_NONE, BSP_GPIO_IRQ_MODE_OFF, NULL );
+#endif
     // Here init only the pin as an exti rising and the callback will be attached later
     hal_gpio_init_in( RADIO_DIOX, BSP_GPIO_PULL_MODE_DOWN, BSP_GPIO_IRQ_MODE_RISING, NULL );
     hal_gpio_init_out( RADIO_NRST, 1 );
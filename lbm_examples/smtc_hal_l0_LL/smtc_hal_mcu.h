@@ -129,6 +129,14 @@ void hal_mcu_reset( void );
  */
 void hal_mcu_wait_us( const int32_t microseconds );
 
+/*!
+ * Sleeps (WFI) until the next interrupt, the SysTick interrupt bounds the sleep to 1 ms
+ *
+ * \remark Returns at once in an interrupt handler, where the wake-up interrupts could not preempt
+ * \remark Can be called with interrupts masked: a pending interrupt wakes the core up without being served
+ */
+void hal_mcu_wait_for_interrupt( void );
+
 /*!
  * Sets the MCU in sleep mode for the given number of milliseconds.
  *
@@ -39,11 +39,13 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
 
 #include "smtc_hal_spi.h"
 #include "stm32l0xx_ll_spi.h"
 #include "stm32l0xx_ll_gpio.h"
 #include "stm32l0xx_ll_bus.h"
+#include "stm32l0xx_ll_dma.h"
 
 #include "modem_pinout.h"
 
@@ -72,6 +74,11 @@
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/*!
+ * Configures the DMA1 channel 3 mapped on SPI1 tx
+ */
+static void spi_dma_init( void );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -120,6 +127,8 @@ void hal_spi_init( const uint32_t id, const hal_gpio_pin_names_t mosi, const hal
 
     // Enable SPI
     LL_SPI_Enable( SPI1 );
+
+    spi_dma_init( );
 }
 
 void hal_spi_de_init( const uint32_t id )
@@ -157,4 +166,69 @@ uint16_t hal_spi_in_out( const uint32_t id, const uint16_t out_data )
     };
     return LL_SPI_ReceiveData8( SPI1 );
 }
+
+void hal_spi_transfer_dma( const uint32_t id, const uint8_t* tx_buffer, uint8_t* rx_buffer, const uint16_t length )
+{
+    // SPI1 rx request shares DMA1 channel 2 with the uart rx, only the transfers without reception use the DMA
+    if( ( length < HAL_SPI_DMA_MIN_LENGTH ) || ( rx_buffer != NULL ) )
+    {
+        for( uint16_t i = 0; i < length; i++ )
+        {
+            const uint8_t rx_data = hal_spi_in_out( id, ( tx_buffer != NULL ) ? tx_buffer[i] : 0x00 );
+            if( rx_buffer != NULL )
+            {
+                rx_buffer[i] = rx_data;
+            }
+        }
+        return;
+    }
+
+    const uint8_t tx_none = 0x00;
+
+    // Without buffer the DMA keeps on sending the same dummy byte
+    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_CHANNEL_3,
+                             ( tx_buffer != NULL ) ? ( uint32_t ) tx_buffer : ( uint32_t ) &tx_none );
+    LL_DMA_SetMemoryIncMode( DMA1, LL_DMA_CHANNEL_3,
+                             ( tx_buffer != NULL ) ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT );
+    LL_DMA_SetDataLength( DMA1, LL_DMA_CHANNEL_3, length );
+
+    LL_DMA_EnableChannel( DMA1, LL_DMA_CHANNEL_3 );
+    LL_SPI_EnableDMAReq_TX( SPI1 );
+
+    while( LL_DMA_IsActiveFlag_TC3( DMA1 ) == 0 )
+    {
+    };
+    // Wait for the last byte to be shifted out
+    while( LL_SPI_IsActiveFlag_TXE( SPI1 ) == 0 )
+    {
+    };
+    while( LL_SPI_IsActiveFlag_BSY( SPI1 ) != 0 )
+    {
+    };
+
+    LL_SPI_DisableDMAReq_TX( SPI1 );
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_3 );
+    LL_DMA_ClearFlag_GI3( DMA1 );
+
+    // Received bytes were not read: flush the rx buffer and the overrun flag
+    LL_SPI_ClearFlag_OVR( SPI1 );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void spi_dma_init( void )
+{
+    LL_AHB1_GRP1_EnableClock( LL_AHB1_GRP1_PERIPH_DMA1 );
+
+    LL_DMA_SetPeriphRequest( DMA1, LL_DMA_CHANNEL_3, LL_DMA_REQUEST_1 );
+    LL_DMA_ConfigTransfer( DMA1, LL_DMA_CHANNEL_3,
+                           LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_PRIORITY_MEDIUM | LL_DMA_MODE_NORMAL |
+                               LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE |
+                               LL_DMA_MDATAALIGN_BYTE );
+    LL_DMA_SetPeriphAddress( DMA1, LL_DMA_CHANNEL_3, LL_SPI_DMA_GetRegAddr( SPI1 ) );
+}
+
 /* --- EOF ------------------------------------------------------------------ */
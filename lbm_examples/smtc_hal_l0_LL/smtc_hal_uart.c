@@ -70,11 +70,19 @@
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+// kept across stop mode deinit/init cycles
+static uint32_t hw_modem_uart_baudrate = HW_MODEM_UART_DEFAULT_BAUDRATE;
+
+static uint16_t hw_modem_uart_rx_size = 0;
+static void ( *hw_modem_uart_rx_idle_callback )( uint16_t rx_length ) = NULL;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+static void hw_modem_uart_config( void );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -200,30 +208,27 @@ void hw_modem_uart_init( void )
     // Enable USART4 clock
     LL_APB1_GRP1_EnableClock( LL_APB1_GRP1_PERIPH_USART4 );
 
-    // USART4 Init
-    LL_USART_InitTypeDef usart_init = { 0 };
+    // Init USART4 interrupt, used by the idle line detection
+    NVIC_SetPriority( USART4_5_IRQn, 0 );
+    NVIC_EnableIRQ( USART4_5_IRQn );
 
-    usart_init.BaudRate            = 115200;
-    usart_init.DataWidth           = LL_USART_DATAWIDTH_8B;
-    usart_init.StopBits            = LL_USART_STOPBITS_1;
-    usart_init.Parity              = LL_USART_PARITY_NONE;
-    usart_init.TransferDirection   = LL_USART_DIRECTION_TX_RX;
-    usart_init.HardwareFlowControl = LL_USART_HWCONTROL_NONE;
-    usart_init.OverSampling        = LL_USART_OVERSAMPLING_16;
-    LL_USART_Init( USART4, &usart_init );
-    LL_USART_ConfigAsyncMode( USART4 );
-    LL_USART_Enable( USART4 );
+    hw_modem_uart_config( );
+}
 
-    // Polling USART initialisation
-    while( ( !( LL_USART_IsActiveFlag_TEACK( USART4 ) ) ) || ( !( LL_USART_IsActiveFlag_REACK( USART4 ) ) ) )
-    {
-    }
+void hw_modem_uart_set_baudrate( uint32_t baudrate )
+{
+    hw_modem_uart_baudrate = baudrate;
+
+    // USART4 has to be disabled to be reconfigured
+    LL_USART_Disable( USART4 );
+    hw_modem_uart_config( );
 }
 
 void hw_modem_uart_deinit( void )
 {
     // Disable USART4
     LL_USART_Disable( USART4 );
+    NVIC_DisableIRQ( USART4_5_IRQn );
 
     // Disable USART4 clock
     LL_APB1_GRP1_DisableClock( LL_APB1_GRP1_PERIPH_USART4 );
@@ -255,8 +260,21 @@ void hw_modem_uart_dma_start_rx( uint8_t* buff, uint16_t size )
     LL_USART_EnableDMAReq_RX( USART4 );
 }
 
+void hw_modem_uart_dma_start_rx_to_idle( uint8_t* buff, uint16_t size, void ( *idle_callback )( uint16_t rx_length ) )
+{
+    hw_modem_uart_rx_size          = size;
+    hw_modem_uart_rx_idle_callback = idle_callback;
+
+    hw_modem_uart_dma_start_rx( buff, size );
+
+    // The idle line is only detected after a received byte, a flag left by a previous reception is cleared
+    LL_USART_ClearFlag_IDLE( USART4 );
+    LL_USART_EnableIT_IDLE( USART4 );
+}
+
 void hw_modem_uart_dma_stop_rx( void )
 {
+    LL_USART_DisableIT_IDLE( USART4 );
     LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_2 );
 }
 
@@ -286,9 +304,43 @@ void hw_modem_uart_tx( uint8_t* buff, uint8_t len )
     {
     }
 }
+void USART4_5_IRQHandler( void )
+{
+    if( ( LL_USART_IsActiveFlag_IDLE( USART4 ) != 0 ) && ( LL_USART_IsEnabledIT_IDLE( USART4 ) != 0 ) )
+    {
+        LL_USART_ClearFlag_IDLE( USART4 );
+        if( hw_modem_uart_rx_idle_callback != NULL )
+        {
+            hw_modem_uart_rx_idle_callback( hw_modem_uart_rx_size - LL_DMA_GetDataLength( DMA1, LL_DMA_CHANNEL_2 ) );
+        }
+    }
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static void hw_modem_uart_config( void )
+{
+    // USART4 Init
+    LL_USART_InitTypeDef usart_init = { 0 };
+
+    usart_init.BaudRate            = hw_modem_uart_baudrate;
+    usart_init.DataWidth           = LL_USART_DATAWIDTH_8B;
+    usart_init.StopBits            = LL_USART_STOPBITS_1;
+    usart_init.Parity              = LL_USART_PARITY_NONE;
+    usart_init.TransferDirection   = LL_USART_DIRECTION_TX_RX;
+    usart_init.HardwareFlowControl = LL_USART_HWCONTROL_NONE;
+    usart_init.OverSampling        = LL_USART_OVERSAMPLING_16;
+    LL_USART_Init( USART4, &usart_init );
+    LL_USART_ConfigAsyncMode( USART4 );
+    LL_USART_Enable( USART4 );
+
+    // Polling USART initialisation
+    while( ( !( LL_USART_IsActiveFlag_TEACK( USART4 ) ) ) || ( !( LL_USART_IsActiveFlag_REACK( USART4 ) ) ) )
+    {
+    }
+}
+
 /* --- EOF ------------------------------------------------------------------ */
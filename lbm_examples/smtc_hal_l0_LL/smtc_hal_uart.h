@@ -56,6 +56,8 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+#define HW_MODEM_UART_DEFAULT_BAUDRATE 115200
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -72,7 +74,24 @@ void trace_uart_init( void );
 void hw_modem_uart_deinit( void );
 void trace_uart_deinit( void );
 
+/**
+ * @brief Reconfigure the hw modem uart baudrate, the new value is kept across deinit/init cycles
+ *
+ * @param [in] baudrate New baudrate
+ */
+void hw_modem_uart_set_baudrate( uint32_t baudrate );
+
 void hw_modem_uart_dma_start_rx( uint8_t* buff, uint16_t size );
+
+/**
+ * @brief Start a dma reception ended by the uart idle line detection
+ *
+ * @param [out] buff          Reception buffer
+ * @param [in]  size          Reception buffer size
+ * @param [in]  idle_callback Called in interrupt context each time the line goes idle after received bytes, with the
+ *                            number of bytes received since the start of the reception
+ */
+void hw_modem_uart_dma_start_rx_to_idle( uint8_t* buff, uint16_t size, void ( *idle_callback )( uint16_t rx_length ) );
 void hw_modem_uart_dma_stop_rx( void );
 
 void hw_modem_uart_tx( uint8_t* buff, uint8_t len );
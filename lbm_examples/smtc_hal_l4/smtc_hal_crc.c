@@ -0,0 +1,112 @@
+/*!
+ * \file      smtc_hal_crc.c
+ *
+ * \brief     CRC peripheral Hardware Abstraction Layer implementation
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "stm32l4xx_hal.h"
+#include "smtc_hal_crc.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+// Polynomial of the CRC-32, the peripheral works in the non reflected domain
+#define HAL_CRC32_POLYNOMIAL 0x04C11DB7
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+uint32_t hal_crc32_update( uint32_t crc, const uint8_t* buffer, uint32_t length )
+{
+    __HAL_RCC_CRC_CLK_ENABLE( );
+
+    // 32-bit polynomial, input bits reversed by byte and output bits reversed: the peripheral computes the reflected
+    // CRC, its internal register holds the bit reversed running value
+    CRC->POL  = HAL_CRC32_POLYNOMIAL;
+    CRC->CR   = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT;
+    CRC->INIT = __RBIT( crc );
+    CRC->CR |= CRC_CR_RESET;
+
+    // A word is processed from its most significant byte: the first byte of the buffer goes in the upper byte
+    for( ; length >= 4; length -= 4, buffer += 4 )
+    {
+        CRC->DR = ( ( uint32_t ) buffer[0] << 24 ) | ( ( uint32_t ) buffer[1] << 16 ) |
+                  ( ( uint32_t ) buffer[2] << 8 ) | buffer[3];
+    }
+    for( ; length > 0; length--, buffer++ )
+    {
+        *( __IO uint8_t* ) &CRC->DR = *buffer;
+    }
+    crc = CRC->DR;
+
+    __HAL_RCC_CRC_CLK_DISABLE( );
+
+    return crc;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -254,17 +254,8 @@ uint32_t hal_flash_write_buffer( uint32_t addr, const uint8_t* buffer, uint32_t
 
 void hal_flash_read_buffer( uint32_t addr, uint8_t* buffer, uint32_t size )
 {
-    uint32_t     FlashIndex = 0;
-    __IO uint8_t data8      = 0;
-
-    while( FlashIndex < size )
-    {
-        data8 = *( __IO uint32_t* ) ( addr + FlashIndex );
-
-        buffer[FlashIndex] = data8;
-
-        FlashIndex++;
-    }
+    // Flash is memory mapped, copy it directly instead of one access per byte
+    memcpy( buffer, ( const void* ) addr, size );
 }
 
 #if defined( USE_FLASH_READ_MODIFY_WRITE ) || defined( MULTISTACK )
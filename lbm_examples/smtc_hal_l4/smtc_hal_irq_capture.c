@@ -0,0 +1,134 @@
+/*!
+ * \file      smtc_hal_irq_capture.c
+ *
+ * \brief     Radio irq edge capture Hardware Abstraction Layer implementation
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "stm32l4xx_hal.h"
+#include "smtc_hal_irq_capture.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+// Radio DIO pin, TIM3_CH1 is its alternate function 2
+#define HAL_IRQ_CAPTURE_PIN 4
+#define HAL_IRQ_CAPTURE_AF 2
+
+// Resolution of the capture, the 16-bit counter wraps after 65536 ticks (524 ms)
+#define HAL_IRQ_CAPTURE_TICK_US 8
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void hal_irq_capture_init( void )
+{
+    // TIM3 runs from PCLK1, doubled when the APB1 prescaler is not 1
+    uint32_t timer_clock_hz = HAL_RCC_GetPCLK1Freq( );
+    if( ( RCC->CFGR & RCC_CFGR_PPRE1 ) != RCC_HCLK_DIV1 )
+    {
+        timer_clock_hz *= 2;
+    }
+
+    // The EXTI line is fed by the pin input whatever its mode, the pin is given to TIM3 without losing the irq
+    GPIOB->AFR[0] = ( GPIOB->AFR[0] & ~( 0xFUL << ( HAL_IRQ_CAPTURE_PIN * 4 ) ) ) |
+                    ( ( uint32_t ) HAL_IRQ_CAPTURE_AF << ( HAL_IRQ_CAPTURE_PIN * 4 ) );
+    GPIOB->MODER = ( GPIOB->MODER & ~( 0x3UL << ( HAL_IRQ_CAPTURE_PIN * 2 ) ) ) |
+                   ( 0x2UL << ( HAL_IRQ_CAPTURE_PIN * 2 ) );
+
+    __HAL_RCC_TIM3_CLK_ENABLE( );
+
+    // Free running counter, channel 1 captures the rising edges of TI1 without filter
+    TIM3->CR1   = 0;
+    TIM3->PSC   = ( timer_clock_hz / ( 1000000 / HAL_IRQ_CAPTURE_TICK_US ) ) - 1;
+    TIM3->ARR   = 0xFFFF;
+    TIM3->CCMR1 = TIM_CCMR1_CC1S_0;
+    TIM3->CCER  = TIM_CCER_CC1E;
+    TIM3->EGR   = TIM_EGR_UG;
+    TIM3->SR    = 0;
+    TIM3->CR1   = TIM_CR1_CEN;
+}
+
+bool hal_irq_capture_get_elapsed_us( uint32_t* elapsed_us )
+{
+    // Nothing is captured while the timer clock is stopped, in Stop mode
+    if( ( TIM3->SR & TIM_SR_CC1IF ) == 0 )
+    {
+        return false;
+    }
+
+    // Reading the capture clears CC1IF, the counter is read after so that the difference is never negative. The
+    // capture holds the last edge when several were captured.
+    uint16_t capture = ( uint16_t ) TIM3->CCR1;
+    uint16_t counter = ( uint16_t ) TIM3->CNT;
+    TIM3->SR         = ( uint32_t ) ~TIM_SR_CC1OF;
+
+    *elapsed_us = ( uint32_t ) ( uint16_t ) ( counter - capture ) * HAL_IRQ_CAPTURE_TICK_US;
+    return true;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -47,10 +47,14 @@
 #include "stm32l4xx_ll_utils.h"
 
 #include "smtc_hal_uart.h"
+#include "smtc_hal_spi_slave.h"
 #include "smtc_hal_rtc.h"
 #include "smtc_hal_spi.h"
 #include "smtc_hal_lp_timer.h"
 #include "smtc_hal_watchdog.h"
+#if defined( USE_TRACE_DEFERRED )
+#include "smtc_hal_trace.h"
+#endif
 
 #if( MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON )
 #include <stdarg.h>
@@ -145,8 +149,13 @@ void hal_mcu_init( void )
     trace_uart_init( );
 #endif
 #if defined( HW_MODEM_ENABLED )
+#if defined( USE_HW_MODEM_SPI )
+    // Initialize spi slave for hw commands
+    hw_modem_spi_init( );
+#else
     // Initialize Uart for hw commands
     hw_modem_uart_init( );
+#endif
 #endif
 
     // Initialize GPIOs
@@ -182,6 +191,16 @@ void __attribute__( ( optimize( "O0" ) ) ) hal_mcu_wait_us( const int32_t micros
     }
 }
 
+void hal_mcu_wait_for_interrupt( void )
+{
+    if( __get_IPSR( ) != 0 )
+    {
+        return;
+    }
+    // SysTick interrupt (1 ms HAL tick) is running outside of the low power sleep
+    __WFI( );
+}
+
 void hal_mcu_set_sleep_for_ms( const int32_t milliseconds )
 {
     if( milliseconds <= 0 )
@@ -189,12 +208,31 @@ void hal_mcu_set_sleep_for_ms( const int32_t milliseconds )
         return;
     }
 
+#if defined( USE_TRACE_DEFERRED )
+    // The trace uart is stopped in stop mode, the recorded traces are sent before
+    hal_trace_deferred_drain( );
+#endif
     hal_rtc_wakeup_timer_set_ms( milliseconds );
     sleep_handler( );
     // stop timer after sleep process
     hal_rtc_wakeup_timer_stop( );
 }
 
+void hal_mcu_set_light_sleep_for_ms( const int32_t milliseconds )
+{
+    if( milliseconds <= 0 )
+    {
+        return;
+    }
+
+    hal_rtc_wakeup_timer_set_ms( milliseconds );
+    // The trace uart and its DMA keep running, only the SysTick is stopped not to wake up every millisecond
+    HAL_SuspendTick( );
+    __WFI( );
+    HAL_ResumeTick( );
+    hal_rtc_wakeup_timer_stop( );
+}
+
 #ifdef USE_FULL_ASSERT
 /*
  * Function Name  : assert_failed
@@ -340,8 +378,13 @@ static void mcu_gpio_init( void )
     hal_gpio_init_in( RADIO_DIO_2, BSP_GPIO_PULL_MODE_DOWN, BSP_GPIO_IRQ_MODE_RISING, NULL );
     hal_gpio_init_in( RADIO_NRST, BSP_GPIO_PULL_MODE_NONE, BSP_GPIO_IRQ_MODE_OFF, NULL );
     hal_gpio_init_out( RADIO_ANTENNA_SWITCH, 0 );
+#else
+#if defined( USE_RADIO_BUSY_IRQ_WAIT )
+    // No callback, the busy falling edge interrupt only wakes the core up
+    hal_gpio_init_in( RADIO_BUSY_PIN, BSP_GPIO_PULL_MODE_NONE, BSP_GPIO_IRQ_MODE_FALLING, NULL );
 #else
     hal_gpio_init_in( RADIO_BUSY_PIN, BSP_GPIO_PULL_MODE_NONE, BSP_GPIO_IRQ_MODE_OFF, NULL );
+#endif
     // Here init only the pin as an exti rising and the callback will be attached later
     hal_gpio_init_in( RADIO_DIOX, BSP_GPIO_PULL_MODE_DOWN, BSP_GPIO_IRQ_MODE_RISING, NULL );
     hal_gpio_init_out( RADIO_NRST, 1 );
@@ -426,8 +469,12 @@ static void lpm_mcu_deinit( void )
     hal_spi_de_init( RADIO_SPI_ID );
 
 #if defined( HW_MODEM_ENABLED )
+#if defined( USE_HW_MODEM_SPI )
+    hw_modem_spi_deinit( );
+#else
     hw_modem_uart_deinit( );
 #endif
+#endif
 #if( MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON )
     trace_uart_deinit( );
 #endif
@@ -473,7 +520,11 @@ static void lpm_mcu_reinit( void )
     trace_uart_init( );
 #endif
 #if defined( HW_MODEM_ENABLED )
+#if defined( USE_HW_MODEM_SPI )
+    hw_modem_spi_init( );
+#else
     hw_modem_uart_init( );
+#endif
 #endif
 
     // Initialize SPI
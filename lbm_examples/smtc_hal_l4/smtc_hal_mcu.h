@@ -75,6 +75,14 @@ extern "C" {
  * Ends critical section
  */
 #define CRITICAL_SECTION_END( ) hal_mcu_critical_section_end( &mask )
+
+/*!
+ * Shortest sleep worth the stop mode, in us: below it the exit latency (PLL lock, clocks and peripherals re-init) and
+ * its energy are not paid back by the lower stop mode current
+ */
+#ifndef HAL_MCU_STOP_MODE_MIN_SLEEP_US
+#define HAL_MCU_STOP_MODE_MIN_SLEEP_US 3000
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC CONSTANTS --------------------------------------------------------
@@ -129,6 +137,14 @@ void hal_mcu_reset( void );
  */
 void hal_mcu_wait_us( const int32_t microseconds );
 
+/*!
+ * Sleeps (WFI) until the next interrupt, the SysTick interrupt bounds the sleep to 1 ms
+ *
+ * \remark Returns at once in an interrupt handler, where the wake-up interrupts could not preempt
+ * \remark Can be called with interrupts masked: a pending interrupt wakes the core up without being served
+ */
+void hal_mcu_wait_for_interrupt( void );
+
 /*!
  * Sets the MCU in sleep mode for the given number of milliseconds.
  *
@@ -136,6 +152,15 @@ void hal_mcu_wait_us( const int32_t microseconds );
  */
 void hal_mcu_set_sleep_for_ms( const int32_t milliseconds );
 
+/*!
+ * Sets the MCU in sleep mode (WFI, clocks and peripherals kept) for the given number of milliseconds
+ *
+ * \remark Wakes up within a few core cycles, to be used when an interrupt timestamped by its handler is expected
+ *
+ * \param[IN] milliseconds Number of milliseconds to stay in sleep mode
+ */
+void hal_mcu_set_light_sleep_for_ms( const int32_t milliseconds );
+
 /*!
  * Suspend low power process and avoid looping on it
  */
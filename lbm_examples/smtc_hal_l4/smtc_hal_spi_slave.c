@@ -0,0 +1,255 @@
+/*!
+ * \file      smtc_hal_spi_slave.c
+ *
+ * \brief     SPI slave Hardware Abstraction Layer implementation, hw modem host interface
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_hal_spi_slave.h"
+#include "stm32l4xx_hal.h"
+#include "stm32l4xx_ll_spi.h"
+#include "stm32l4xx_ll_dma.h"
+#include "stm32l4xx_ll_bus.h"
+#include "smtc_hal_gpio.h"
+
+#include "modem_pinout.h"
+#include "smtc_hal_mcu.h"
+
+#if defined( USE_HW_MODEM_SPI )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint16_t hw_modem_spi_rx_size = 0;
+static void ( *hw_modem_spi_tx_done_callback )( void ) = NULL;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * Resets SPI2 to flush its fifos and configures it as a slave with the hardware NSS input
+ */
+static void spi_slave_configure( void );
+
+/*!
+ * Configures the DMA1 channels mapped on SPI2: channel 4 for rx and channel 5 for tx
+ */
+static void spi_slave_dma_init( void );
+
+/*!
+ * Configures one pin of SPI2 in alternate function
+ */
+static void spi_slave_gpio_init( hal_gpio_pin_names_t pin );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void hw_modem_spi_init( void )
+{
+    LL_APB1_GRP1_EnableClock( LL_APB1_GRP1_PERIPH_SPI2 );
+
+    spi_slave_gpio_init( HW_MODEM_SPI_NSS );
+    spi_slave_gpio_init( HW_MODEM_SPI_SCLK );
+    spi_slave_gpio_init( HW_MODEM_SPI_MISO );
+    spi_slave_gpio_init( HW_MODEM_SPI_MOSI );
+
+    spi_slave_configure( );
+    spi_slave_dma_init( );
+}
+
+void hw_modem_spi_deinit( void )
+{
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_4 );
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_5 );
+    HAL_NVIC_DisableIRQ( DMA1_Channel5_IRQn );
+    LL_SPI_Disable( SPI2 );
+    LL_APB1_GRP1_DisableClock( LL_APB1_GRP1_PERIPH_SPI2 );
+
+    const hal_gpio_pin_names_t pins[] = { HW_MODEM_SPI_NSS, HW_MODEM_SPI_SCLK, HW_MODEM_SPI_MISO, HW_MODEM_SPI_MOSI };
+    for( uint8_t i = 0; i < sizeof( pins ) / sizeof( pins[0] ); i++ )
+    {
+        GPIO_TypeDef* gpio_port = ( GPIO_TypeDef* ) ( AHB2PERIPH_BASE + ( ( pins[i] & 0xF0 ) << 6 ) );
+        HAL_GPIO_DeInit( gpio_port, ( 1 << ( pins[i] & 0x0F ) ) );
+    }
+}
+
+void hw_modem_spi_dma_start_rx( uint8_t* buff, uint16_t size )
+{
+    // A response not read by the host is dropped with the fifos
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_5 );
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_4 );
+    spi_slave_configure( );
+
+    hw_modem_spi_rx_size = size;
+    LL_DMA_ClearFlag_GI4( DMA1 );
+    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_CHANNEL_4, ( uint32_t ) buff );
+    LL_DMA_SetDataLength( DMA1, LL_DMA_CHANNEL_4, size );
+    LL_DMA_EnableChannel( DMA1, LL_DMA_CHANNEL_4 );
+    LL_SPI_EnableDMAReq_RX( SPI2 );
+
+    LL_SPI_Enable( SPI2 );
+}
+
+uint16_t hw_modem_spi_dma_stop_rx( void )
+{
+    uint16_t rx_length = hw_modem_spi_rx_size - LL_DMA_GetDataLength( DMA1, LL_DMA_CHANNEL_4 );
+
+    LL_SPI_DisableDMAReq_RX( SPI2 );
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_4 );
+    LL_DMA_ClearFlag_GI4( DMA1 );
+
+    return rx_length;
+}
+
+void hw_modem_spi_dma_start_tx( const uint8_t* buff, uint16_t size, void ( *tx_done_callback )( void ) )
+{
+    LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_4 );
+    spi_slave_configure( );
+
+    hw_modem_spi_tx_done_callback = tx_done_callback;
+    LL_DMA_ClearFlag_GI5( DMA1 );
+    LL_DMA_SetMemoryAddress( DMA1, LL_DMA_CHANNEL_5, ( uint32_t ) buff );
+    LL_DMA_SetDataLength( DMA1, LL_DMA_CHANNEL_5, size );
+    LL_DMA_EnableIT_TC( DMA1, LL_DMA_CHANNEL_5 );
+    LL_DMA_EnableChannel( DMA1, LL_DMA_CHANNEL_5 );
+    LL_SPI_EnableDMAReq_TX( SPI2 );
+
+    // The dma fills the tx fifo before the host starts clocking
+    LL_SPI_Enable( SPI2 );
+}
+
+void DMA1_Channel5_IRQHandler( void )
+{
+    if( LL_DMA_IsActiveFlag_TC5( DMA1 ) != 0 )
+    {
+        LL_DMA_ClearFlag_GI5( DMA1 );
+        LL_DMA_DisableIT_TC( DMA1, LL_DMA_CHANNEL_5 );
+        LL_DMA_DisableChannel( DMA1, LL_DMA_CHANNEL_5 );
+        LL_SPI_DisableDMAReq_TX( SPI2 );
+        if( hw_modem_spi_tx_done_callback != NULL )
+        {
+            hw_modem_spi_tx_done_callback( );
+        }
+    }
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void spi_slave_configure( void )
+{
+    // Disabling the spi does not flush the tx fifo of a slave, only a reset does
+    LL_APB1_GRP1_ForceReset( LL_APB1_GRP1_PERIPH_SPI2 );
+    LL_APB1_GRP1_ReleaseReset( LL_APB1_GRP1_PERIPH_SPI2 );
+
+    // Same mode as the radio spi: mode 0, msb first, 8-bit
+    LL_SPI_SetTransferDirection( SPI2, LL_SPI_FULL_DUPLEX );
+    LL_SPI_SetMode( SPI2, LL_SPI_MODE_SLAVE );
+    LL_SPI_SetDataWidth( SPI2, LL_SPI_DATAWIDTH_8BIT );
+    LL_SPI_SetClockPolarity( SPI2, LL_SPI_POLARITY_LOW );
+    LL_SPI_SetClockPhase( SPI2, LL_SPI_PHASE_1EDGE );
+    LL_SPI_SetTransferBitOrder( SPI2, LL_SPI_MSB_FIRST );
+    LL_SPI_SetNSSMode( SPI2, LL_SPI_NSS_HARD_INPUT );
+    LL_SPI_SetRxFIFOThreshold( SPI2, LL_SPI_RX_FIFO_TH_QUARTER );
+}
+
+static void spi_slave_dma_init( void )
+{
+    LL_AHB1_GRP1_EnableClock( LL_AHB1_GRP1_PERIPH_DMA1 );
+
+    // Rx channel
+    LL_DMA_SetPeriphRequest( DMA1, LL_DMA_CHANNEL_4, LL_DMA_REQUEST_1 );
+    LL_DMA_ConfigTransfer( DMA1, LL_DMA_CHANNEL_4,
+                           LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_PRIORITY_HIGH | LL_DMA_MODE_NORMAL |
+                               LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE |
+                               LL_DMA_MDATAALIGN_BYTE );
+    LL_DMA_SetPeriphAddress( DMA1, LL_DMA_CHANNEL_4, LL_SPI_DMA_GetRegAddr( SPI2 ) );
+
+    // Tx channel
+    LL_DMA_SetPeriphRequest( DMA1, LL_DMA_CHANNEL_5, LL_DMA_REQUEST_1 );
+    LL_DMA_ConfigTransfer( DMA1, LL_DMA_CHANNEL_5,
+                           LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_PRIORITY_HIGH | LL_DMA_MODE_NORMAL |
+                               LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE |
+                               LL_DMA_MDATAALIGN_BYTE );
+    LL_DMA_SetPeriphAddress( DMA1, LL_DMA_CHANNEL_5, LL_SPI_DMA_GetRegAddr( SPI2 ) );
+
+    HAL_NVIC_SetPriority( DMA1_Channel5_IRQn, 0, 0 );
+    HAL_NVIC_EnableIRQ( DMA1_Channel5_IRQn );
+}
+
+static void spi_slave_gpio_init( hal_gpio_pin_names_t pin )
+{
+    GPIO_InitTypeDef gpio = {
+        .Mode      = GPIO_MODE_AF_PP,
+        .Pull      = GPIO_NOPULL,
+        .Speed     = GPIO_SPEED_FREQ_VERY_HIGH,
+        .Alternate = GPIO_AF5_SPI2,
+    };
+
+    hal_gpio_enable_clock( pin );
+    GPIO_TypeDef* gpio_port = ( GPIO_TypeDef* ) ( AHB2PERIPH_BASE + ( ( pin & 0xF0 ) << 6 ) );
+    gpio.Pin                = ( 1 << ( pin & 0x0F ) );
+    HAL_GPIO_Init( gpio_port, &gpio );
+}
+
+#endif  // USE_HW_MODEM_SPI
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,102 @@
+/*!
+ * \file      smtc_hal_spi_slave.h
+ *
+ * \brief     SPI slave Hardware Abstraction Layer definition, hw modem host interface
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __SMTC_HAL_SPI_SLAVE_H__
+#define __SMTC_HAL_SPI_SLAVE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+void hw_modem_spi_init( void );
+void hw_modem_spi_deinit( void );
+
+/**
+ * @brief Start a dma reception of the bytes clocked by the host, the transmit side is stopped
+ *
+ * @param [out] buff Reception buffer
+ * @param [in]  size Reception buffer size
+ */
+void hw_modem_spi_dma_start_rx( uint8_t* buff, uint16_t size );
+
+/**
+ * @brief Stop the dma reception
+ *
+ * @return uint16_t Number of bytes received since the start of the reception
+ */
+uint16_t hw_modem_spi_dma_stop_rx( void );
+
+/**
+ * @brief Load bytes in the dma to be clocked out by the host, the receive side is stopped
+ *
+ * @param [in] buff             Bytes to send, kept until the end of the transfer
+ * @param [in] size             Number of bytes
+ * @param [in] tx_done_callback Called in interrupt context once the last byte has been handed to the spi
+ */
+void hw_modem_spi_dma_start_tx( const uint8_t* buff, uint16_t size, void ( *tx_done_callback )( void ) );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_HAL_SPI_SLAVE_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -42,6 +42,9 @@
 
 #include "smtc_hal_trace.h"
 #include "smtc_hal_uart.h"
+#if defined( USE_TRACE_DEFERRED )
+#include "smtc_modem_dbg_trace_deferred.h"
+#endif
 
 #include <string.h>
 
@@ -92,6 +95,21 @@ void hal_trace_print( const char* fmt, va_list argp )
     }
 }
 
+#if defined( USE_TRACE_DEFERRED )
+void hal_trace_deferred_drain( void )
+{
+    const uint8_t* data;
+    uint16_t       size;
+
+    // The ring wraps around, its content is sent in at most two transfers plus the traces recorded meanwhile
+    while( ( size = smtc_modem_dbg_trace_deferred_get( &data ) ) > 0 )
+    {
+        trace_uart_tx_dma( data, size );
+        smtc_modem_dbg_trace_deferred_release( size );
+    }
+}
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
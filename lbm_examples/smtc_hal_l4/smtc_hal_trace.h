@@ -70,6 +70,13 @@ extern "C" {
 void hal_trace_print( const char* fmt, va_list argp );
 void hal_trace_print_var( const char* fmt, ... );
 
+#if defined( USE_TRACE_DEFERRED )
+/**
+ * @brief Send the modem traces recorded in RAM (LBM_TRACE_DEFERRED), called in idle time before sleeping
+ */
+void hal_trace_deferred_drain( void );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
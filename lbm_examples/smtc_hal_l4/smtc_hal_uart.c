@@ -68,10 +68,19 @@
  */
 
 static DMA_HandleTypeDef hdma_usart4_rx;
+#if defined( USE_TRACE_DEFERRED )
+static DMA_HandleTypeDef hdma_usart2_tx;
+#endif
 
 static UART_HandleTypeDef huart2;
 static UART_HandleTypeDef huart4;
 
+// kept across stop mode deinit/init cycles
+static uint32_t hw_modem_uart_baudrate = HW_MODEM_UART_DEFAULT_BAUDRATE;
+
+static uint16_t hw_modem_uart_rx_size = 0;
+static void ( *hw_modem_uart_rx_idle_callback )( uint16_t rx_length ) = NULL;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -89,7 +98,7 @@ void hw_modem_uart_init( void )
     HAL_NVIC_EnableIRQ( DMA2_Channel5_IRQn );
 
     huart4.Instance                    = UART4;
-    huart4.Init.BaudRate               = 115200;
+    huart4.Init.BaudRate               = hw_modem_uart_baudrate;
     huart4.Init.WordLength             = UART_WORDLENGTH_8B;
     huart4.Init.StopBits               = UART_STOPBITS_1;
     huart4.Init.Parity                 = UART_PARITY_NONE;
@@ -109,6 +118,17 @@ void hw_modem_uart_deinit( void )
     HAL_UART_DeInit( &huart4 );
 }
 
+void hw_modem_uart_set_baudrate( uint32_t baudrate )
+{
+    hw_modem_uart_baudrate = baudrate;
+
+    huart4.Init.BaudRate = baudrate;
+    if( HAL_UART_Init( &huart4 ) != HAL_OK )
+    {
+        mcu_panic( );
+    }
+}
+
 void trace_uart_init( void )
 {
     huart2.Instance                    = USART2;
@@ -139,8 +159,21 @@ void hw_modem_uart_dma_start_rx( uint8_t* buff, uint16_t size )
     HAL_UART_Receive_DMA( &huart4, buff, size );
 }
 
+void hw_modem_uart_dma_start_rx_to_idle( uint8_t* buff, uint16_t size, void ( *idle_callback )( uint16_t rx_length ) )
+{
+    hw_modem_uart_rx_size          = size;
+    hw_modem_uart_rx_idle_callback = idle_callback;
+
+    hw_modem_uart_dma_start_rx( buff, size );
+
+    // The idle line is only detected after a received byte, a flag left by a previous reception is cleared
+    __HAL_UART_CLEAR_IDLEFLAG( &huart4 );
+    __HAL_UART_ENABLE_IT( &huart4, UART_IT_IDLE );
+}
+
 void hw_modem_uart_dma_stop_rx( void )
 {
+    __HAL_UART_DISABLE_IT( &huart4, UART_IT_IDLE );
     HAL_UART_DMAStop( &huart4 );
 }
 
@@ -154,6 +187,21 @@ void trace_uart_tx( uint8_t* buff, uint8_t len )
     HAL_UART_Transmit( &huart2, ( uint8_t* ) buff, len, 0xffffff );
 }
 
+#if defined( USE_TRACE_DEFERRED )
+void trace_uart_tx_dma( const uint8_t* buff, uint16_t len )
+{
+    if( HAL_UART_Transmit_DMA( &huart2, ( uint8_t* ) buff, len ) != HAL_OK )
+    {
+        return;
+    }
+    // The core sleeps while the dma sends the bytes, the dma and uart interrupts wake it up
+    while( huart2.gState != HAL_UART_STATE_READY )
+    {
+        __WFI( );
+    }
+}
+#endif
+
 void HAL_UART_MspInit( UART_HandleTypeDef* huart )
 {
     GPIO_InitTypeDef GPIO_InitStruct;
@@ -190,6 +238,9 @@ void HAL_UART_MspInit( UART_HandleTypeDef* huart )
             mcu_panic( );
         }
         __HAL_LINKDMA( huart, hdmarx, hdma_usart4_rx );
+
+        HAL_NVIC_SetPriority( UART4_IRQn, 0, 0 );
+        HAL_NVIC_EnableIRQ( UART4_IRQn );
     }
     else if( huart->Instance == USART2 )
     {
@@ -209,6 +260,30 @@ void HAL_UART_MspInit( UART_HandleTypeDef* huart )
         gpio_port           = ( GPIO_TypeDef* ) ( AHB2PERIPH_BASE + ( ( DEBUG_UART_RX & 0xF0 ) << 6 ) );
         GPIO_InitStruct.Pin = ( 1 << ( DEBUG_UART_RX & 0x0F ) );
         HAL_GPIO_Init( gpio_port, &GPIO_InitStruct );
+
+#if defined( USE_TRACE_DEFERRED )
+        __HAL_RCC_DMA1_CLK_ENABLE( );
+        hdma_usart2_tx.Instance                 = DMA1_Channel7;
+        hdma_usart2_tx.Init.Request             = DMA_REQUEST_2;
+        hdma_usart2_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+        hdma_usart2_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+        hdma_usart2_tx.Init.MemInc              = DMA_MINC_ENABLE;
+        hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_usart2_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+        hdma_usart2_tx.Init.Mode                = DMA_NORMAL;
+        hdma_usart2_tx.Init.Priority            = DMA_PRIORITY_LOW;
+
+        if( HAL_DMA_Init( &hdma_usart2_tx ) != HAL_OK )
+        {
+            mcu_panic( );
+        }
+        __HAL_LINKDMA( huart, hdmatx, hdma_usart2_tx );
+
+        HAL_NVIC_SetPriority( DMA1_Channel7_IRQn, 0, 0 );
+        HAL_NVIC_EnableIRQ( DMA1_Channel7_IRQn );
+        HAL_NVIC_SetPriority( USART2_IRQn, 0, 0 );
+        HAL_NVIC_EnableIRQ( USART2_IRQn );
+#endif
     }
     else
     {
@@ -228,6 +303,7 @@ void HAL_UART_MspDeInit( UART_HandleTypeDef* huart )
         HAL_GPIO_DeInit( gpio_port, ( 1 << ( HW_MODEM_RX_LINE & 0x0F ) ) );
 
         HAL_DMA_DeInit( &hdma_usart4_rx );
+        HAL_NVIC_DisableIRQ( UART4_IRQn );
 
         __HAL_RCC_DMA2_CLK_DISABLE( );
     }
@@ -239,6 +315,12 @@ void HAL_UART_MspDeInit( UART_HandleTypeDef* huart )
         HAL_GPIO_DeInit( gpio_port, ( 1 << ( DEBUG_UART_TX & 0x0F ) ) );
         gpio_port = ( GPIO_TypeDef* ) ( AHB2PERIPH_BASE + ( ( DEBUG_UART_RX & 0xF0 ) << 6 ) );
         HAL_GPIO_DeInit( gpio_port, ( 1 << ( DEBUG_UART_RX & 0x0F ) ) );
+
+#if defined( USE_TRACE_DEFERRED )
+        HAL_DMA_DeInit( &hdma_usart2_tx );
+        HAL_NVIC_DisableIRQ( DMA1_Channel7_IRQn );
+        HAL_NVIC_DisableIRQ( USART2_IRQn );
+#endif
     }
 }
 
@@ -247,6 +329,34 @@ void DMA2_Channel5_IRQHandler( void )
     HAL_DMA_IRQHandler( &hdma_usart4_rx );
 }
 
+#if defined( USE_TRACE_DEFERRED )
+void DMA1_Channel7_IRQHandler( void )
+{
+    HAL_DMA_IRQHandler( &hdma_usart2_tx );
+}
+
+void USART2_IRQHandler( void )
+{
+    HAL_UART_IRQHandler( &huart2 );
+}
+#endif
+
+void UART4_IRQHandler( void )
+{
+    // The reception errors enabled by HAL_UART_Receive_DMA are only cleared, the DMA goes on with the next bytes
+    __HAL_UART_CLEAR_FLAG( &huart4, UART_CLEAR_PEF | UART_CLEAR_FEF | UART_CLEAR_NEF | UART_CLEAR_OREF );
+
+    if( ( __HAL_UART_GET_FLAG( &huart4, UART_FLAG_IDLE ) != RESET ) &&
+        ( __HAL_UART_GET_IT_SOURCE( &huart4, UART_IT_IDLE ) != RESET ) )
+    {
+        __HAL_UART_CLEAR_IDLEFLAG( &huart4 );
+        if( hw_modem_uart_rx_idle_callback != NULL )
+        {
+            hw_modem_uart_rx_idle_callback( hw_modem_uart_rx_size - __HAL_DMA_GET_COUNTER( huart4.hdmarx ) );
+        }
+    }
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
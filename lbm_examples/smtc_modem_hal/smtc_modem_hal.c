@@ -57,9 +57,12 @@
 #endif
 #if defined( STM32L476xx )
 #include "smtc_hal_flash.h"
+#include "smtc_hal_crc.h"
+#include "smtc_hal_irq_capture.h"
 #endif
 
 #include "modem_pinout.h"
+#include "radio_utilities.h"
 
 // for variadic args
 #include <stdio.h>
@@ -89,6 +92,12 @@
 #if defined( STM32L476xx )
 #define ADDR_FLASH_FUOTA ADDR_FLASH_PAGE_150
 #define ADDR_FLASH_STORE_AND_FORWARD ADDR_FLASH_PAGE_200
+#define ADDR_FLASH_MAC_JOURNAL ADDR_FLASH_PAGE_210
+#define MAC_JOURNAL_NB_PAGES 4
+#define ADDR_FLASH_STREAM_SPILL ADDR_FLASH_PAGE_214
+#define STREAM_SPILL_NB_PAGES 16
+#define ADDR_FLASH_LORAWAN_SESSION ADDR_FLASH_PAGE_250
+#define ADDR_FLASH_RELAY_FWD_TABLE ADDR_FLASH_PAGE_251
 #define ADDR_FLASH_SECURE_ELEMENT_CONTEXT ADDR_FLASH_PAGE_252
 #define ADDR_FLASH_MODEM_CONTEXT ADDR_FLASH_PAGE_253
 #define ADDR_FLASH_LORAWAN_CONTEXT ADDR_FLASH_PAGE_254
@@ -102,6 +111,8 @@
 #define ADDR_EEPROM_MODEM_KEY_CONTEXT_OFFSET 50
 #define ADDR_EEPROM_MODEM_CONTEXT_OFFSET 75
 #define ADDR_EEPROM_SECURE_ELEMENT_CONTEXT_OFFSET 100
+#define ADDR_EEPROM_LORAWAN_SESSION_OFFSET 1024
+#define ADDR_EEPROM_RELAY_FWD_TABLE_OFFSET 2048
 #endif
 
 /*
@@ -222,6 +233,12 @@ void smtc_modem_hal_context_restore( const modem_context_type_t ctx_type, uint32
     case CONTEXT_SECURE_ELEMENT:
         hal_eeprom_read_buffer( ADDR_EEPROM_SECURE_ELEMENT_CONTEXT_OFFSET, buffer, size );
         break;
+    case CONTEXT_RELAY_FWD_TABLE:
+        hal_eeprom_read_buffer( ADDR_EEPROM_RELAY_FWD_TABLE_OFFSET, buffer, size );
+        break;
+    case CONTEXT_LORAWAN_SESSION:
+        hal_eeprom_read_buffer( ADDR_EEPROM_LORAWAN_SESSION_OFFSET + offset, buffer, size );
+        break;
 #elif defined( STM32L476xx )
     case CONTEXT_MODEM:
         hal_flash_read_buffer( ADDR_FLASH_MODEM_CONTEXT, buffer, size );
@@ -241,6 +258,18 @@ void smtc_modem_hal_context_restore( const modem_context_type_t ctx_type, uint32
     case CONTEXT_STORE_AND_FORWARD:
         hal_flash_read_buffer( ADDR_FLASH_STORE_AND_FORWARD + offset, buffer, size );
         break;
+    case CONTEXT_MAC_JOURNAL:
+        hal_flash_read_buffer( ADDR_FLASH_MAC_JOURNAL + offset, buffer, size );
+        break;
+    case CONTEXT_STREAM_SPILL:
+        hal_flash_read_buffer( ADDR_FLASH_STREAM_SPILL + offset, buffer, size );
+        break;
+    case CONTEXT_RELAY_FWD_TABLE:
+        hal_flash_read_buffer( ADDR_FLASH_RELAY_FWD_TABLE, buffer, size );
+        break;
+    case CONTEXT_LORAWAN_SESSION:
+        hal_flash_read_buffer( ADDR_FLASH_LORAWAN_SESSION + offset, buffer, size );
+        break;
 #endif
     default:
         mcu_panic( );
@@ -274,6 +303,12 @@ void smtc_modem_hal_context_store( const modem_context_type_t ctx_type, uint32_t
     case CONTEXT_SECURE_ELEMENT:
         hal_eeprom_write_buffer( ADDR_EEPROM_SECURE_ELEMENT_CONTEXT_OFFSET, buffer, size );
         break;
+    case CONTEXT_RELAY_FWD_TABLE:
+        hal_eeprom_write_buffer( ADDR_EEPROM_RELAY_FWD_TABLE_OFFSET, buffer, size );
+        break;
+    case CONTEXT_LORAWAN_SESSION:
+        hal_eeprom_write_buffer( ADDR_EEPROM_LORAWAN_SESSION_OFFSET + offset, buffer, size );
+        break;
 #elif defined( STM32L476xx )
     case CONTEXT_MODEM:
         hal_flash_erase_page( ADDR_FLASH_MODEM_CONTEXT, 1 );
@@ -309,6 +344,24 @@ void smtc_modem_hal_context_store( const modem_context_type_t ctx_type, uint32_t
     case CONTEXT_STORE_AND_FORWARD:
         hal_flash_write_buffer( ADDR_FLASH_STORE_AND_FORWARD + offset, buffer, size );
         break;
+    case CONTEXT_MAC_JOURNAL:
+        hal_flash_write_buffer( ADDR_FLASH_MAC_JOURNAL + offset, buffer, size );
+        break;
+    case CONTEXT_STREAM_SPILL:
+        hal_flash_write_buffer( ADDR_FLASH_STREAM_SPILL + offset, buffer, size );
+        break;
+    case CONTEXT_RELAY_FWD_TABLE:
+        hal_flash_erase_page( ADDR_FLASH_RELAY_FWD_TABLE, 1 );
+        hal_flash_write_buffer( ADDR_FLASH_RELAY_FWD_TABLE, buffer, size );
+        break;
+    case CONTEXT_LORAWAN_SESSION:
+#if defined( MULTISTACK )
+        hal_flash_read_modify_write( ADDR_FLASH_LORAWAN_SESSION + offset, buffer, size );
+#else
+        hal_flash_erase_page( ADDR_FLASH_LORAWAN_SESSION, 1 );
+        hal_flash_write_buffer( ADDR_FLASH_LORAWAN_SESSION, buffer, size );
+#endif
+        break;
 #endif
     default:
         mcu_panic( );
@@ -324,6 +377,12 @@ void smtc_modem_hal_context_flash_pages_erase( const modem_context_type_t ctx_ty
     case CONTEXT_STORE_AND_FORWARD:
         hal_flash_erase_page( ADDR_FLASH_STORE_AND_FORWARD + offset, nb_page );
         break;
+    case CONTEXT_MAC_JOURNAL:
+        hal_flash_erase_page( ADDR_FLASH_MAC_JOURNAL + offset, nb_page );
+        break;
+    case CONTEXT_STREAM_SPILL:
+        hal_flash_erase_page( ADDR_FLASH_STREAM_SPILL + offset, nb_page );
+        break;
 #endif
     default:
         mcu_panic( );
@@ -383,6 +442,15 @@ uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint
     return hal_rng_get_random_in_range( val_1, val_2 );
 }
 
+/* ------------ CRC management ------------*/
+
+#if defined( USE_CRC_MCU_HW )
+uint32_t smtc_modem_hal_crc32_update( uint32_t crc, const uint8_t* buffer, uint32_t length )
+{
+    return hal_crc32_update( crc, buffer, length );
+}
+#endif  // USE_CRC_MCU_HW
+
 /* ------------ Radio env management ------------*/
 
 void smtc_modem_hal_irq_config_radio_irq( void ( *callback )( void* context ), void* context )
@@ -397,8 +465,23 @@ void smtc_modem_hal_irq_config_radio_irq( void ( *callback )( void* context ), v
     radio_dio_irq.context  = context;
 
     hal_gpio_irq_attach( &radio_dio_irq );
+#if defined( USE_RP_HW_TIMESTAMP ) && defined( STM32L476xx )
+    hal_irq_capture_init( );
+#endif
+#endif
+}
+
+#if defined( USE_RP_HW_TIMESTAMP )
+bool smtc_modem_hal_get_radio_irq_elapsed_us( uint32_t* elapsed_us )
+{
+#if defined( STM32L476xx ) && !defined( SX1272 ) && !defined( SX1276 )
+    return hal_irq_capture_get_elapsed_us( elapsed_us );
+#else
+    // no capture timer on the radio irq pin, the irqs are timestamped when serviced
+    return false;
 #endif
 }
+#endif
 
 void smtc_modem_hal_start_radio_tcxo( void )
 {
@@ -414,6 +497,14 @@ uint32_t smtc_modem_hal_get_radio_tcxo_startup_delay_ms( void )
 {
     // Tcxo is present on LR1110 and LR1120 evk boards, LR1121 ref board does not have tcxo but only 32MHz xtal
 #if defined( LR11XX ) && !defined( LR1121 )
+#if defined( USE_RADIO_TCXO_CALIBRATION )
+    // Delay measured at the radio init, also programmed in the radio
+    uint32_t startup_delay_ms = radio_utilities_get_tcxo_startup_delay_ms( );
+    if( startup_delay_ms != 0 )
+    {
+        return startup_delay_ms;
+    }
+#endif
     return 5;
 #else
     return 0;
@@ -439,6 +530,13 @@ uint8_t smtc_modem_hal_get_battery_level( void )
     return 255;
 }
 
+uint32_t smtc_modem_hal_get_sleep_current_ua( void )
+{
+    // Please implement according to used board
+    // Default: MCU in stop mode with the RTC running and the radio in sleep with its configuration retained
+    return 3;
+}
+
 int8_t smtc_modem_hal_get_board_delay_ms( void )
 {
 #if defined( LR1121 )
@@ -510,6 +608,12 @@ uint8_t smtc_modem_hal_get_fw_delete_status_for_fuota( uint32_t fw_to_delete_ver
         return 0;
     }
 }
+
+const uint8_t* smtc_modem_hal_get_fuota_area_mapped_address( void )
+{
+    // The internal flash is memory mapped
+    return ( const uint8_t* ) ADDR_FLASH_FUOTA;
+}
 #endif  // USE_FUOTA
 
 /* ------------ Needed for Cloud  ------------*/
@@ -532,9 +636,60 @@ uint16_t smtc_modem_hal_store_and_forward_get_number_of_pages( void )
     return 10;
 }
 
+#endif
+
+#if defined( USE_STORE_AND_FORWARD ) || defined( USE_MAC_JOURNAL ) || defined( USE_STREAM_SPILL )
 uint16_t smtc_modem_hal_flash_get_page_size( void )
 {
+#if defined( STM32L476xx )
     return hal_flash_get_page_size( );
+#else
+    return 0;
+#endif
+}
+#endif
+
+/* ------------ Needed for MAC journal  ------------*/
+#if defined( USE_MAC_JOURNAL )
+uint16_t smtc_modem_hal_mac_journal_get_number_of_pages( void )
+{
+#if defined( STM32L476xx )
+    return MAC_JOURNAL_NB_PAGES;
+#else
+    // EEPROM contexts are rewritten in place without wear concern, the journal is not used
+    return 0;
+#endif
+}
+#endif
+
+/* ------------ Needed for Stream spill  ------------*/
+#if defined( USE_STREAM_SPILL )
+uint16_t smtc_modem_hal_stream_spill_get_number_of_pages( void )
+{
+#if defined( STM32L476xx )
+    return STREAM_SPILL_NB_PAGES;
+#else
+    // no flash area reserved on stm32l0, the stream keeps its RAM buffer only
+    return 0;
+#endif
+}
+#endif
+
+/* ------------ Low power management  ------------*/
+#if defined( USE_LOW_POWER_HINT )
+void smtc_modem_hal_enter_low_power( uint32_t budget_us, smtc_modem_hal_wakeup_t wakeup )
+{
+    const int32_t sleep_ms = ( int32_t ) ( budget_us / 1000 );
+
+    // The stop mode exit latency would delay the timestamp of the radio interrupt, and is not worth a short sleep
+    if( ( wakeup == SMTC_MODEM_HAL_WAKEUP_RADIO_IRQ ) || ( budget_us < HAL_MCU_STOP_MODE_MIN_SLEEP_US ) )
+    {
+        hal_mcu_set_light_sleep_for_ms( sleep_ms );
+    }
+    else
+    {
+        hal_mcu_set_sleep_for_ms( sleep_ms );
+    }
 }
 #endif
 
@@ -73,6 +73,14 @@ ifeq ($(CRYPTO),LR11XX_WITH_CREDENTIALS)
 LBM_TARGET := $(LBM_TARGET)_lr11xx_crypto_with_cred
 LBM_BUILD_DIR := $(LBM_BUILD_DIR)_lr11xx_crypto_with_cred
 endif # LR11XX_WITH_CREDENTIALS
+ifeq ($(CRYPTO),SOFT_FAST)
+LBM_TARGET := $(LBM_TARGET)_soft_fast_crypto
+LBM_BUILD_DIR := $(LBM_BUILD_DIR)_soft_fast_crypto
+endif # SOFT_FAST
+ifeq ($(CRYPTO),MCU_HW)
+LBM_TARGET := $(LBM_TARGET)_mcu_hw_crypto
+LBM_BUILD_DIR := $(LBM_BUILD_DIR)_mcu_hw_crypto
+endif # MCU_HW
 
 ifeq ($(MODEM_TRACE), yes)
 LBM_TARGET := $(LBM_TARGET)_trace
@@ -87,6 +95,16 @@ ifeq ($(LBM_GEOLOCATION),yes)
 LBM_STORE_AND_FORWARD=yes
 endif
 
+ifeq ($(LBM_BLE_BRIDGE),yes)
+#BLE bridge batches are sent through the store and forward fifo
+LBM_STORE_AND_FORWARD=yes
+endif
+
+ifeq ($(LBM_RP_TIMED_TX),yes)
+#The trigger time of a timed transmission is computed with the microsecond timebase
+LBM_RP_US_TIMEBASE=yes
+endif
+
 #-----------------------------------------------------------------------------
 # Debug and optimization
 #-----------------------------------------------------------------------------
@@ -155,24 +173,324 @@ LBM_C_DEFS += \
 	-DPERF_TEST_ENABLED
 endif
 
+ifeq ($(CRYPTO),SOFT_FAST)
+LBM_C_DEFS += \
+	-DSMTC_AES_FAST
+endif
+
+ifeq ($(CRYPTO),MCU_HW)
+LBM_C_DEFS += \
+	-DSMTC_AES_MCU_HW
+endif
+
+ifeq ($(LBM_RP_US_TIMEBASE),yes)
+LBM_C_DEFS += \
+	-DADD_RP_US_TIMEBASE
+endif
+
+ifeq ($(LBM_RP_TRACE),yes)
+LBM_C_DEFS += \
+	-DADD_RP_TRACE
+endif
+
+ifeq ($(LBM_RP_WARM_STANDBY),yes)
+LBM_C_DEFS += \
+	-DADD_RP_WARM_STANDBY
+endif
+
+ifeq ($(LBM_RP_ADMISSION_CONTROL),yes)
+LBM_C_DEFS += \
+	-DADD_RP_ADMISSION_CONTROL
+endif
+
+ifeq ($(LBM_RP_IRQ_FAST_PATH),yes)
+LBM_C_DEFS += \
+	-DADD_RP_IRQ_FAST_PATH
+endif
+
+ifeq ($(LBM_RP_RX_CONTINUOUS),yes)
+LBM_C_DEFS += \
+	-DADD_RP_RX_CONTINUOUS
+endif
+
+ifeq ($(LBM_RP_TASK_CHAIN),yes)
+LBM_C_DEFS += \
+	-DADD_RP_TASK_CHAIN
+endif
+
+ifeq ($(LBM_RP_HW_TIMESTAMP),yes)
+LBM_C_DEFS += \
+	-DADD_RP_HW_TIMESTAMP
+endif
+
+ifeq ($(LBM_RP_TIMED_TX),yes)
+LBM_C_DEFS += \
+	-DADD_RP_TIMED_TX
+endif
+
+ifeq ($(LBM_RAL_BATCH),yes)
+LBM_C_DEFS += \
+	-DADD_RAL_BATCH
+endif
+
+ifeq ($(LBM_RAL_CFG_SHADOW),yes)
+LBM_C_DEFS += \
+	-DADD_RAL_CFG_SHADOW
+endif
+
+ifeq ($(LBM_RAL_CAL_IMG),yes)
+LBM_C_DEFS += \
+	-DADD_RAL_CAL_IMG
+endif
+
+ifeq ($(LBM_RAL_LORA_TOA_TABLE),yes)
+LBM_C_DEFS += \
+	-DADD_RAL_LORA_TOA_TABLE
+endif
+
+ifeq ($(LBM_RP_MULTI_RADIO),yes)
+LBM_C_DEFS += \
+	-DADD_RP_MULTI_RADIO
+endif
+
+ifeq ($(LBM_LR_FHSS_HOP_TABLE),yes)
+LBM_C_DEFS += \
+	-DADD_LR_FHSS_HOP_TABLE
+endif
+
+ifeq ($(LBM_BLE_LL),yes)
+LBM_C_DEFS += \
+	-DADD_BLE_LL
+endif
+
+ifeq ($(LBM_BLE_BRIDGE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_BLE_BRIDGE
+endif
+
+ifeq ($(LBM_FLRC_TRANSFER),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_FLRC_TRANSFER
+endif
+
+ifeq ($(LBM_PAYLOAD_COMPRESSION),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_PAYLOAD_COMPRESSION
+endif
+
+ifeq ($(LBM_TDMA_UPLINK),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_TDMA_UPLINK
+endif
+
+ifeq ($(LBM_CONTEXT_CACHE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_CONTEXT_CACHE
+endif
+
+ifeq ($(LBM_FAST_BOOT),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_FAST_BOOT
+endif
+
+ifeq ($(LBM_MAC_JOURNAL),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_MAC_JOURNAL
+endif
+
+ifeq ($(LBM_DTC_AIRTIME_CHANNEL),yes)
+LBM_C_DEFS += \
+	-DADD_DTC_AIRTIME_CHANNEL
+endif
+
+ifeq ($(LBM_LINK_ADR),yes)
+LBM_C_DEFS += \
+	-DADD_LINK_ADR
+endif
+
+ifeq ($(LBM_STACK_FAIRNESS),yes)
+LBM_C_DEFS += \
+	-DADD_STACK_FAIRNESS
+endif
+
+ifeq ($(LBM_RX_DRIFT),yes)
+LBM_C_DEFS += \
+	-DADD_RX_DRIFT
+endif
+
+ifeq ($(LBM_NWK_ANS_PIGGYBACK),yes)
+LBM_C_DEFS += \
+	-DADD_NWK_ANS_PIGGYBACK
+endif
+
+ifeq ($(LBM_FAST_JOIN),yes)
+LBM_C_DEFS += \
+	-DADD_FAST_JOIN
+endif
+
+ifeq ($(LBM_SESSION_RESUME),yes)
+LBM_C_DEFS += \
+	-DADD_SESSION_RESUME
+endif
+
+ifeq ($(LBM_REGION_SNAPSHOT),yes)
+LBM_C_DEFS += \
+	-DADD_REGION_SNAPSHOT
+endif
+
+ifeq ($(LBM_DL_DEDUP),yes)
+LBM_C_DEFS += \
+	-DADD_DL_DEDUP
+endif
+
+ifeq ($(LBM_RX_BOOST_POLICY),yes)
+LBM_C_DEFS += \
+	-DADD_RX_BOOST_POLICY
+endif
+
+ifeq ($(LBM_FSK_RX_PREAMBLE_TIMEOUT),yes)
+LBM_C_DEFS += \
+	-DADD_FSK_RX_PREAMBLE_TIMEOUT
+endif
+
+ifeq ($(LBM_CLASS_B_PLL_PING_SLOT),yes)
+LBM_C_DEFS += \
+	-DADD_CLASS_B_PLL_PING_SLOT
+endif
+
+ifeq ($(LBM_CLASS_B_SELECTIVE_PING_SLOT),yes)
+LBM_C_DEFS += \
+	-DADD_CLASS_B_SELECTIVE_PING_SLOT
+endif
+
+ifeq ($(LBM_CLASS_B_ADAPTIVE_BEACON),yes)
+LBM_C_DEFS += \
+	-DADD_CLASS_B_ADAPTIVE_BEACON
+endif
+
+ifeq ($(LBM_CLASS_B_FAST_ACQUISITION),yes)
+LBM_C_DEFS += \
+	-DADD_CLASS_B_FAST_ACQUISITION
+endif
+
+ifeq ($(LBM_CLASS_B_PING_SLOT_SCHEDULE),yes)
+LBM_C_DEFS += \
+	-DADD_CLASS_B_PING_SLOT_SCHEDULE
+endif
+
+ifeq ($(LBM_CLASS_C_LOW_POWER),yes)
+LBM_C_DEFS += \
+	-DADD_CLASS_C_LOW_POWER
+endif
+
+ifeq ($(LBM_PROFILE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_PROFILE
+endif
+
+ifeq ($(LBM_TRACE_DEFERRED),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_TRACE_DEFERRED
+endif
+
+ifeq ($(LBM_LOW_POWER_HINT),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_LOW_POWER_HINT
+endif
+
+ifeq ($(LBM_SERVICE_STATS),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_SERVICE_STATS
+endif
+
+ifeq ($(LBM_BATTERY_ESTIMATOR),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_BATTERY_ESTIMATOR
+endif
+
+ifeq ($(LBM_LATENCY_HISTOGRAM),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_LATENCY_HISTOGRAM
+endif
+
+ifeq ($(LBM_THREAD_SAFE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_THREAD_SAFE
+endif
+
+ifeq ($(LBM_REQUEST_QUEUE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_REQUEST_QUEUE
+endif
+
+ifeq ($(LBM_EVENT_QUEUE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_EVENT_QUEUE
+endif
+
+ifeq ($(LBM_RAM_POOL),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_RAM_POOL
+endif
+
+ifeq ($(LBM_MULTI_INSTANCE),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_MULTI_INSTANCE
+endif
+
+ifeq ($(LBM_CRC_MCU_HW),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_CRC_MCU_HW
+endif
+
+ifeq ($(LBM_RAL_STATIC),yes)
+LBM_C_DEFS += \
+	-DRAL_STATIC_DRIVER
+endif
+
 ifeq ($(LBM_STREAM),yes)
 LBM_C_DEFS += \
-    -DADD_SMTC_STREAM
+    -DADD_SMTC_STREAM \
+	-DNUMBER_OF_STREAMS=$(LBM_NB_OF_STREAM)
+ifeq ($(LBM_STREAM_SPILL),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_STREAM_SPILL
+endif
 endif
 
 ifeq ($(LBM_LFU),yes)
 LBM_C_DEFS += \
     -DADD_SMTC_LFU
+ifeq ($(LBM_LFU_HW_HASH),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_LFU_HW_HASH
+endif
 endif
 
 ifeq ($(LBM_DEVICE_MANAGEMENT),yes)
 LBM_C_DEFS += \
     -DADD_SMTC_CLOUD_DEVICE_MANAGEMENT
+ifeq ($(LBM_DM_DELTA),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_DM_DELTA
+endif
+ifeq ($(LBM_DM_PERF),yes)
+LBM_C_DEFS += \
+	-DADD_SMTC_DM_PERF
+endif
 endif
 
 ifeq ($(LBM_STORE_AND_FORWARD),yes)
 LBM_C_DEFS += \
     -DADD_SMTC_STORE_AND_FORWARD
+ifeq ($(LBM_STORE_AND_FORWARD_PRE_ERASE),yes)
+LBM_C_DEFS += \
+    -DADD_SMTC_STORE_AND_FORWARD_PRE_ERASE
+endif
+ifeq ($(LBM_STORE_AND_FORWARD_FEC),yes)
+LBM_C_DEFS += \
+    -DADD_SMTC_STORE_AND_FORWARD_FEC
+endif
 endif
 
 ifeq ($(LBM_FUOTA),yes)
@@ -194,13 +512,37 @@ LBM_C_DEFS += \
     LBM_C_DEFS += \
        	-DFRAG_MAX_REDUNDANCY=$(FUOTA_MAXIMUM_FRAG_REDUNDANCY)
     endif
+	ifeq ($(LBM_FUOTA_SPARSE_DECODER),yes)
+    LBM_C_DEFS += \
+        -DFRAG_DECODER_SPARSE
+	endif
+	ifeq ($(LBM_FUOTA_INCREMENTAL_DECODER),yes)
+    LBM_C_DEFS += \
+        -DFRAG_DECODER_INCREMENTAL
+	endif
+	ifeq ($(LBM_FUOTA_DEFERRED_DECODER),yes)
+    LBM_C_DEFS += \
+        -DFRAG_DECODER_DEFERRED
+	endif
+	ifeq ($(LBM_FUOTA_MAPPED_AREA),yes)
+    LBM_C_DEFS += \
+        -DFUOTA_MAPPED_AREA
+	endif
 	ifeq ($(LBM_FUOTA_ENABLE_FMP),yes)
     LBM_C_DEFS += \
         -DENABLE_FUOTA_FMP
+	ifeq ($(LBM_FUOTA_FMP_PATCH),yes)
+    LBM_C_DEFS += \
+        -DENABLE_FUOTA_FMP_PATCH
+	endif
 	endif
 	ifeq ($(LBM_FUOTA_ENABLE_MPA),yes)
     LBM_C_DEFS += \
         -DENABLE_FUOTA_MPA
+	ifeq ($(LBM_FUOTA_MPA_COALESCE),yes)
+    LBM_C_DEFS += \
+        -DENABLE_FUOTA_MPA_COALESCE
+	endif
 	endif
 else
     ifeq ($(LBM_ALC_SYNC),yes)
@@ -258,6 +600,9 @@ SMTC_MODEM_CORE_C_SOURCES += \
 	smtc_modem_core/modem_utilities/modem_event_utilities.c\
 	smtc_modem_core/modem_utilities/fifo_ctrl.c\
 	smtc_modem_core/modem_utilities/modem_core.c \
+	smtc_modem_core/modem_utilities/modem_crc.c\
+	smtc_modem_core/modem_utilities/modem_timer.c\
+	smtc_modem_core/modem_utilities/modem_async.c\
 	smtc_modem_core/modem_supervisor/modem_supervisor_light.c\
 	smtc_modem_core/modem_supervisor/modem_tx_protocol_manager.c\
 	smtc_modem_core/lorawan_packages/lorawan_certification/lorawan_certification.c\
@@ -297,6 +642,10 @@ ifeq ($(LBM_FUOTA),yes)
 	ifeq ($(LBM_FUOTA_ENABLE_FMP),yes)
 	SMTC_MODEM_CORE_C_SOURCES += \
 		smtc_modem_core/lorawan_packages/firmware_management_protocol/lorawan_fmp_package.c
+	ifeq ($(LBM_FUOTA_FMP_PATCH),yes)
+	SMTC_MODEM_CORE_C_SOURCES += \
+		smtc_modem_core/lorawan_packages/firmware_management_protocol/lorawan_fmp_patch.c
+	endif
 	endif
 
 	ifeq ($(LBM_FUOTA_ENABLE_MPA),yes)
@@ -359,6 +708,10 @@ endif
 ifeq ($(LBM_DEVICE_MANAGEMENT),yes)
 SMTC_MODEM_CORE_C_SOURCES += \
 	smtc_modem_core/modem_services/cloud_dm_package/cloud_dm_package.c
+ifeq ($(LBM_DM_PERF),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/modem_perf_counters.c
+endif
 endif
 
 ifeq ($(LBM_STORE_AND_FORWARD),yes)
@@ -367,6 +720,91 @@ SMTC_MODEM_CORE_C_SOURCES += \
 	smtc_modem_core/modem_services/store_and_forward/store_and_forward_flash.c
 endif
 
+ifeq ($(LBM_MAC_JOURNAL),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/mac_journal.c
+endif
+
+# circularfs is already built with store and forward
+ifeq ($(LBM_STREAM),yes)
+ifeq ($(LBM_STREAM_SPILL),yes)
+ifneq ($(LBM_STORE_AND_FORWARD),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/circularfs.c
+endif
+endif
+endif
+
+ifeq ($(LBM_PROFILE),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/logging/smtc_modem_dbg_profile.c
+endif
+
+ifeq ($(LBM_LATENCY_HISTOGRAM),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/logging/smtc_modem_dbg_latency.c
+endif
+
+ifeq ($(LBM_TRACE_DEFERRED),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/logging/smtc_modem_dbg_trace_deferred.c
+endif
+
+ifeq ($(LBM_BATTERY_ESTIMATOR),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/modem_battery_estimator.c
+endif
+
+ifeq ($(LBM_REQUEST_QUEUE),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/modem_request_queue.c
+endif
+
+ifeq ($(LBM_RAM_POOL),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/modem_ram_pool.c
+endif
+
+ifeq ($(LBM_MULTI_INSTANCE),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_utilities/modem_instance.c
+endif
+
+ifeq ($(LBM_BLE_BRIDGE),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_services/ble_bridge/ble_bridge.c
+endif
+
+ifeq ($(LBM_FLRC_TRANSFER),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_services/flrc_transfer/flrc_transfer.c
+endif
+
+ifeq ($(LBM_PAYLOAD_COMPRESSION),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_services/payload_compression/payload_compression.c
+endif
+
+ifeq ($(LBM_TDMA_UPLINK),yes)
+SMTC_MODEM_CORE_C_SOURCES += \
+	smtc_modem_core/modem_services/tdma_uplink/tdma_uplink.c
+endif
+
+ifeq ($(LBM_LINK_ADR),yes)
+LR1MAC_C_SOURCES += \
+	smtc_modem_core/lr1mac/src/services/smtc_link_adr.c
+endif
+
+ifeq ($(LBM_RX_DRIFT),yes)
+LR1MAC_C_SOURCES += \
+	smtc_modem_core/lr1mac/src/services/smtc_rx_drift.c
+endif
+
+ifeq ($(LBM_RX_BOOST_POLICY),yes)
+LR1MAC_C_SOURCES += \
+	smtc_modem_core/lr1mac/src/services/smtc_rx_boost.c
+endif
+
 ifeq ($(ALLOW_CSMA_BUILD),yes)
 ifeq ($(LBM_CSMA),yes)
 LR1MAC_C_SOURCES += \
@@ -377,6 +815,9 @@ endif
 SMTC_MODEM_CRYPTO_C_SOURCES += \
 	smtc_modem_core/smtc_modem_crypto/smtc_modem_crypto.c
 
+SMTC_RAL_C_SOURCES += \
+	smtc_modem_core/smtc_ral/src/ral_lora_toa.c
+
 RADIO_PLANNER_C_SOURCES += \
 	smtc_modem_core/radio_planner/src/radio_planner.c
 
@@ -481,6 +922,30 @@ LBM_C_INCLUDES += \
 	-Ismtc_modem_core/modem_services/store_and_forward
 endif
 
+ifeq ($(LBM_BLE_BRIDGE),yes)
+LBM_C_INCLUDES += \
+	-Ismtc_modem_core/modem_services \
+	-Ismtc_modem_core/modem_services/ble_bridge
+endif
+
+ifeq ($(LBM_FLRC_TRANSFER),yes)
+LBM_C_INCLUDES += \
+	-Ismtc_modem_core/modem_services \
+	-Ismtc_modem_core/modem_services/flrc_transfer
+endif
+
+ifeq ($(LBM_PAYLOAD_COMPRESSION),yes)
+LBM_C_INCLUDES += \
+	-Ismtc_modem_core/modem_services \
+	-Ismtc_modem_core/modem_services/payload_compression
+endif
+
+ifeq ($(LBM_TDMA_UPLINK),yes)
+LBM_C_INCLUDES += \
+	-Ismtc_modem_core/modem_services \
+	-Ismtc_modem_core/modem_services/tdma_uplink
+endif
+
 
 
 #-----------------------------------------------------------------------------
@@ -518,9 +983,10 @@ basic_modem_build: $(BUILD_ROOT)/$(LBM_TARGET).a
 
 
 #-----------------------------------------------------------------------------
-# list of C objects
+# list of C objects, a source added by several options (soft crypto of the radio and of LBM_FUOTA_VERSION=2) is
+# listed once so that the relocatable link of LBM_MULTI_INSTANCE does not see it twice
 
-OBJECTS = $(addprefix $(LBM_BUILD_DIR)/,$(notdir $(LBM_C_SOURCES:.c=.o)))
+OBJECTS = $(sort $(addprefix $(LBM_BUILD_DIR)/,$(notdir $(LBM_C_SOURCES:.c=.o))))
 vpath %.c $(sort $(dir $(LBM_C_SOURCES)))
 
 # list of ASM program objects
@@ -546,9 +1012,15 @@ ifeq ($(SIZE),yes)
 endif
 
 
+# LBM_MULTI_INSTANCE: the library is one relocatable object gathering the modem state, see makefiles/multi_instance.ld
 $(LBM_BUILD_DIR)/%.a: $(OBJECTS) Makefile | $(LBM_BUILD_DIR)
 	$(call build,'LIB',$@)
+ifeq ($(LBM_MULTI_INSTANCE),yes)
+	$(SILENT)$(CC) $(MCU_FLAGS) -r -nostdlib -Wl,-T,makefiles/multi_instance.ld $(OBJECTS) -o $(LBM_BUILD_DIR)/lbm_instances.o
+	$(SILENT)$(AR) rcs $@ $(LBM_BUILD_DIR)/lbm_instances.o
+else
 	$(SILENT)$(AR) rcs $@ $(OBJECTS)
+endif
 	$(SZ) -t $@
 
 $(BUILD_ROOT)/$(LBM_TARGET).a: $(LBM_BUILD_DIR)/$(LBM_TARGET).a
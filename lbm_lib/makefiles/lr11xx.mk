@@ -59,6 +59,20 @@ SMTC_MODEM_CRYPTO_C_SOURCES += \
 	smtc_modem_core/smtc_modem_crypto/soft_secure_element/soft_se.c
 endif # soft_crypto
 
+ifeq ($(CRYPTO),SOFT_FAST)
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes_fast.c\
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/cmac.c\
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/soft_se.c
+endif # soft_fast_crypto
+
+ifeq ($(CRYPTO),MCU_HW)
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes_mcu_hw.c\
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/cmac.c\
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/soft_se.c
+endif # mcu_hw_crypto
+
 ifeq ($(LBM_ALMANAC),yes)
 SMTC_MODEM_CORE_C_SOURCES += \
 	smtc_modem_core/modem_services/almanac_packages/almanac.c
@@ -97,6 +111,16 @@ LBM_C_INCLUDES += \
 	-Ismtc_modem_core/smtc_modem_crypto/soft_secure_element
 endif # soft_crypto
 
+ifeq ($(CRYPTO),SOFT_FAST)
+LBM_C_INCLUDES += \
+	-Ismtc_modem_core/smtc_modem_crypto/soft_secure_element
+endif # soft_fast_crypto
+
+ifeq ($(CRYPTO),MCU_HW)
+LBM_C_INCLUDES += \
+	-Ismtc_modem_core/smtc_modem_crypto/soft_secure_element
+endif # mcu_hw_crypto
+
 ifeq ($(LBM_ALMANAC),yes)
 LBM_C_INCLUDES += \
 	-Ismtc_modem_core/modem_services \
@@ -135,4 +159,8 @@ endif
 ifeq ($(LBM_GEOLOCATION),yes)
 LBM_C_DEFS += \
     -DADD_LBM_GEOLOCATION
+ifeq ($(LBM_GEOLOCATION_PIPELINE),yes)
+LBM_C_DEFS += \
+    -DADD_LBM_GEOLOCATION_PIPELINE
+endif
 endif
@@ -57,7 +57,10 @@ MODEM_DEEP_TRACE ?= no
 # If radio target is sx128x WW_2G4 is forced 
 REGION ?= ALL
 
-# Crypto management only for lr11xx targets (SOFT, LR11XX, LR11XX_WITH_CREDENTIALS )
+# Crypto management (SOFT, SOFT_FAST, MCU_HW, LR11XX, LR11XX_WITH_CREDENTIALS )
+# SOFT_FAST uses a 32-bit T-table AES faster on Cortex-M3/M4 cores (1.25 KB of extra tables in flash)
+# MCU_HW uses the MCU AES peripheral through smtc_modem_hal_crypto_aes_ecb_encrypt() (to be implemented by the application)
+# LR11XX and LR11XX_WITH_CREDENTIALS are only available for lr11xx targets
 CRYPTO ?= SOFT
 
 #-----------------------------------------------------------------------------
@@ -92,10 +95,22 @@ LBM_FUOTA_VERSION ?= 1
 FUOTA_MAXIMUM_NB_OF_FRAGMENTS ?= nc
 FUOTA_MAXIMUM_SIZE_OF_FRAGMENTS ?= nc
 FUOTA_MAXIMUM_FRAG_REDUNDANCY ?= nc
+# In case FUOTA v2 is allowed, store the decoder matrix in the FUOTA area to receive files with thousands of fragments
+LBM_FUOTA_SPARSE_DECODER ?= no
+# In case FUOTA v2 is allowed, recover the lost fragments as the coded fragments arrive instead of at the session end
+LBM_FUOTA_INCREMENTAL_DECODER ?= no
+# In case FUOTA v2 is allowed, decode the fragments in idle slices of the modem engine instead of in the downlink handler
+LBM_FUOTA_DEFERRED_DECODER ?= no
+# In case FUOTA v2 is allowed, compute the file integrity check on the memory mapped FUOTA area
+LBM_FUOTA_MAPPED_AREA ?= no
 # In case FUOTA is allowed, allow the use of Firmware Management Package
 LBM_FUOTA_ENABLE_FMP ?= yes
+# In case Firmware Management Package is allowed, check the running firmware version of delta images
+LBM_FUOTA_FMP_PATCH ?= no
 # In case FUOTA is allowed, llow the use of Multi-Package Access Package
 LBM_FUOTA_ENABLE_MPA ?= yes
+# In case Multi-Package Access is allowed, send the answers of the downlinks received within a few seconds together
+LBM_FUOTA_MPA_COALESCE ?= no
 
 #-----------------------------------------------------------------------------
 # LoRaCloud related options
@@ -107,9 +122,25 @@ LBM_ALMANAC ?= no
 # Stream feature
 LBM_STREAM ?= no
 
+# Stream spill: records that do not fit in the RAM stream buffer wait in flash (needs LBM_STREAM)
+LBM_STREAM_SPILL ?= no
+
+# Number of concurrent streams of each stack, scheduled by priority and weight (needs LBM_STREAM)
+LBM_NB_OF_STREAM ?= 1
+
 # Large File Upload feature
 LBM_LFU ?= no
 
+# Large File Upload hash computed by the MCU hash accelerator through the modem HAL (needs LBM_LFU)
+LBM_LFU_HW_HASH ?= no
+
+# Device management periodic reports only carry the fields that changed (needs LBM_DEVICE_MANAGEMENT)
+LBM_DM_DELTA ?= no
+
+# Device management performance field: duty-cycle, LBT, retransmission, RX window, planner, flash and latency
+# counters since the last report (needs LBM_DEVICE_MANAGEMENT)
+LBM_DM_PERF ?= no
+
 # Cloud Device Management feature
 LBM_DEVICE_MANAGEMENT ?= no
 
@@ -123,11 +154,199 @@ LBM_GEOLOCATION ?= no
 #Store and Forward Management feature
 LBM_STORE_AND_FORWARD ?= no
 
+# Store and Forward: erase the next flash page of the log in idle time instead of in the append changing page
+LBM_STORE_AND_FORWARD_PRE_ERASE ?= no
+
+# Store and Forward: protect blocks of stored data with parity uplinks instead of acknowledgments
+LBM_STORE_AND_FORWARD_FEC ?= no
+
 # Multistack
 NB_OF_STACK ?= 1
 
+# Radio planner microsecond timebase (smtc_modem_hal_get_time_in_us() shall be implemented by the application)
+LBM_RP_US_TIMEBASE ?= no
+
+# Radio planner event trace (drained with smtc_modem_get_rp_trace_to_array())
+LBM_RP_TRACE ?= no
+
+# Radio planner keeping the radio in standby between two tasks closer than its wake up cost
+LBM_RP_WARM_STANDBY ?= no
+
+# Radio planner admission control refusing at enqueue time the scheduled tasks that would lose the arbitration
+LBM_RP_ADMISSION_CONTROL ?= no
+
+# Radio planner reading the radio irq of the hooks given to rp_hook_set_irq_fast_path() in the interrupt context
+LBM_RP_IRQ_FAST_PATH ?= no
+
+# Radio planner continuous reception keeping the radio receiving after each packet of the class C and test mode tasks
+LBM_RP_RX_CONTINUOUS ?= no
+
+# Radio planner task chaining, a hook submits a sequence of tasks run back to back with rp_task_enqueue_chained()
+LBM_RP_TASK_CHAIN ?= no
+
+# Radio planner timestamps of the radio irqs taken from the edge captured in hardware by the HAL
+LBM_RP_HW_TIMESTAMP ?= no
+
+# Send the Tx command of the radio planner tasks from a hardware timer compare at their start time, the radio being
+# configured in advance (smtc_modem_hal_start_radio_trigger_timer() shall be implemented by the application, forces
+# LBM_RP_US_TIMEBASE)
+LBM_RP_TIMED_TX ?= no
+
+# Radio command batch sending the configuration of radio planner tasks in one burst (sx126x only,
+# sx126x_hal_write_batch() shall be implemented by the application)
+LBM_RAL_BATCH ?= no
+
+# Radio configuration shadow skipping the writes of an unchanged configuration (sx126x and lr11xx only)
+LBM_RAL_CFG_SHADOW ?= no
+
+# Image calibration of the band of each radio planner task frequency, done once per band change
+# (sx126x and lr11xx only, requires LBM_RAL_CFG_SHADOW)
+LBM_RAL_CAL_IMG ?= no
+
+# LoRa time on air computed from precomputed symbol tables instead of the radio driver formulas
+# (sx126x, sx127x and lr11xx, 125/250/500 kHz bandwidths)
+LBM_RAL_LORA_TOA_TABLE ?= no
+
+# Several radio planners, one per radio, running their tasks in parallel (rp_multi_radio_register())
+LBM_RP_MULTI_RADIO ?= no
+
+# Precompute the SX126x LR-FHSS hop sequence when the frame is built
+LBM_LR_FHSS_HOP_TABLE ?= no
+
+# Reserve radio planner hooks for the SX1280 BLE link layer
+LBM_BLE_LL ?= no
+
+# BLE to LoRaWAN bridge service (forces store and forward)
+LBM_BLE_BRIDGE ?= no
+
+# Device to device bulk transfer over FLRC (RADIO=sx128x only)
+LBM_FLRC_TRANSFER ?= no
+
+# Schema driven delta compression of the application uplinks of an FPort
+LBM_PAYLOAD_COMPRESSION ?= no
+
+# Application uplinks sent in a time slot of the GPS time given by the network time
+LBM_TDMA_UPLINK ?= no
+
+# Context cache: keep modem contexts in RAM and write them when the modem goes idle
+LBM_CONTEXT_CACHE ?= no
+
+# Fast boot: scan the store and forward and stream spill flash partitions when first used instead of at init
+LBM_FAST_BOOT ?= no
+
+# MAC journal: keep DevNonce and the uplink frame counter in a journal spread over several flash pages
+LBM_MAC_JOURNAL ?= no
+
+# Airtime aware channel selection (EU868/RU864): draw the uplink channel among the bands with
+# enough duty-cycle budget left for the frame
+LBM_DTC_AIRTIME_CHANNEL ?= no
+
+# Link quality ADR profile: the device picks its datarate from the SNR of the last downlinks
+LBM_LINK_ADR ?= no
+
+# Share the radio between stacks by weight, with airtime quotas (multistack)
+LBM_STACK_FAIRNESS ?= no
+
+# Narrow the RX1/RX2 windows from the measured arrival time of the downlinks
+LBM_RX_DRIFT ?= no
+
+# Send the answers to the network MAC commands in the FOpts of a ready application uplink instead of their own frame
+LBM_NWK_ANS_PIGGYBACK ?= no
+
+# US915/AU915: send the first join request on the sub-band of the last accepted join, kept in non volatile memory
+LBM_FAST_JOIN ?= no
+
+# OTAA: keep the session in non volatile memory and resume it after a reset instead of joining again
+LBM_SESSION_RESUME ?= no
+
+# Keep the channel state of the last regions in RAM and restore it when switching back to one of them
+LBM_REGION_SNAPSHOT ?= no
+
+# Drop the copies of recently accepted downlinks (DevAddr, FCnt and MIC) before the MIC verification
+LBM_DL_DEDUP ?= no
+
+# Receive the downlinks with the boosted gain only for the join accept and while the link margin is low (SX126x, LR11xx)
+LBM_RX_BOOST_POLICY ?= no
+
+# Stop the rx timer of the FSK downlink windows on the preamble, a window without sync word is closed by the planner
+LBM_FSK_RX_PREAMBLE_TIMEOUT ?= no
+
+# Class B: ping slots follow the beacon period measured by the beacon pll
+LBM_CLASS_B_PLL_PING_SLOT ?= no
+
+# Class B: multicast sessions listen one ping slot out of n, overlapping slots share one window
+LBM_CLASS_B_SELECTIVE_PING_SLOT ?= no
+
+# Class B: skip beacons while the beacon pll predicts their timing
+LBM_CLASS_B_ADAPTIVE_BEACON ?= no
+
+# Class B: first beacon window sized from the DeviceTimeAns accuracy, widened on each missed acquisition
+LBM_CLASS_B_FAST_ACQUISITION ?= no
+
+# Class B: ping slot hopping frequencies computed once per beacon period
+LBM_CLASS_B_PING_SLOT_SCHEDULE ?= no
+
+# Class C: duty-cycle the reception with a preamble agreed with the network
+LBM_CLASS_C_LOW_POWER ?= no
+
+# Geolocation: send GNSS scans and run Wi-Fi scans in the gaps of a scan group
+LBM_GEOLOCATION_PIPELINE ?= no
+
+# Profiling of the modem hot paths (min/avg/max execution time)
+LBM_PROFILE ?= no
+
+# Record the modem traces in a RAM ring, drained by the application and formatted on the host (needs MODEM_TRACE=yes)
+LBM_TRACE_DEFERRED ?= no
+
+# Add smtc_modem_enter_low_power, calling smtc_modem_hal_enter_low_power with the next modem wake-up budget and source
+LBM_LOW_POWER_HINT ?= no
+
+# Attribute the radio time and charge of each stack to the source (fport, join, MAC) of its uplinks
+LBM_SERVICE_STATS ?= no
+
+# Estimate the average current and the remaining battery life from the radio charge and the board sleep current
+LBM_BATTERY_ESTIMATOR ?= no
+
+# Record log2 histograms of the uplink, downlink and join latencies, read with smtc_modem_get_latency_histograms_to_array
+LBM_LATENCY_HISTOGRAM ?= no
+
+# Serialize the engine with the application threads through smtc_modem_hal_lock_modem / smtc_modem_hal_unlock_modem
+LBM_THREAD_SAFE ?= no
+
+# Queue uplink requests from interrupts or other threads, drained by smtc_modem_run_engine
+LBM_REQUEST_QUEUE ?= no
+
+# Keep every modem event in order with its data, read with smtc_modem_get_events
+LBM_EVENT_QUEUE ?= no
+
+# Take the large service buffers from a shared pool while the services are started
+LBM_RAM_POOL ?= no
+
+# Run several modems in one process (simulation), see smtc_modem_instance_select. GNU linker only
+LBM_MULTI_INSTANCE ?= no
+
+# Compute the CRC-32 of the contexts and flash records with the MCU CRC peripheral, through
+# smtc_modem_hal_crc32_update() (to be implemented by the application)
+LBM_CRC_MCU_HW ?= no
+
+# Call the radio driver of the build directly instead of through the ral_t / ralf_t function tables
+# (the application shall be built with RAL_STATIC_DRIVER too)
+LBM_RAL_STATIC ?= no
+
 # Relay Tx
 LBM_RELAY_TX_ENABLE ?= no
+# Relay Tx: learn the clock drift of the relay from its WOR ACKs and shorten the WOR preamble
+LBM_RELAY_TX_DRIFT_TRACKING ?= no
 
 # Relay Rx
-LBM_RELAY_RX_ENABLE ?= no
\ No newline at end of file
+LBM_RELAY_RX_ENABLE ?= no
+# Relay Rx: look the trusted devices up by DevAddr hash and keep them in non volatile memory
+LBM_RELAY_FWD_TABLE ?= no
+# Relay Rx: check all WOR channels in one radio task per CAD period
+LBM_RELAY_RX_CAD_SWEEP ?= no
+# Relay Rx: aggregate several forwarded uplinks in one relay uplink (needs network server support)
+LBM_RELAY_RX_FWD_BATCH ?= no
+# Relay Rx: check only the default channel once per second while no trusted device is expected
+LBM_RELAY_RX_ADAPTIVE_CAD ?= no
+# Relay Rx: precompute the WOR ACK encryption of every trusted device for its next WOR
+LBM_RELAY_RX_ACK_PRECOMPUTE ?= no
\ No newline at end of file
@@ -54,9 +54,33 @@ endif
 ifeq ($(LBM_RELAY_TX_ENABLE),yes)
 RELAY_C_DEFS += \
     -DADD_RELAY_TX
+ifeq ($(LBM_RELAY_TX_DRIFT_TRACKING),yes)
+RELAY_C_DEFS += \
+    -DADD_RELAY_TX_DRIFT_TRACKING
+endif
 endif
 ifeq ($(LBM_RELAY_RX_ENABLE),yes)
 RELAY_C_DEFS += \
     -DADD_RELAY_RX
+ifeq ($(LBM_RELAY_FWD_TABLE),yes)
+RELAY_C_DEFS += \
+    -DADD_RELAY_FWD_TABLE
+endif
+ifeq ($(LBM_RELAY_RX_CAD_SWEEP),yes)
+RELAY_C_DEFS += \
+    -DADD_RELAY_RX_CAD_SWEEP
+endif
+ifeq ($(LBM_RELAY_RX_FWD_BATCH),yes)
+RELAY_C_DEFS += \
+    -DADD_RELAY_RX_FWD_BATCH
+endif
+ifeq ($(LBM_RELAY_RX_ADAPTIVE_CAD),yes)
+RELAY_C_DEFS += \
+    -DADD_RELAY_RX_ADAPTIVE_CAD
+endif
+ifeq ($(LBM_RELAY_RX_ACK_PRECOMPUTE),yes)
+RELAY_C_DEFS += \
+    -DADD_RELAY_RX_ACK_PRECOMPUTE
+endif
 endif
 
@@ -33,8 +33,20 @@ SMTC_RAL_C_SOURCES += \
 SMTC_RALF_C_SOURCES += \
 	smtc_modem_core/smtc_ralf/src/ralf_sx126x.c
 
+ifeq ($(CRYPTO),SOFT_FAST)
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes_fast.c
+else
+ifeq ($(CRYPTO),MCU_HW)
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes_mcu_hw.c
+else
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes.c
+endif
+endif
+
 SMTC_MODEM_CRYPTO_C_SOURCES += \
-	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes.c\
 	smtc_modem_core/smtc_modem_crypto/soft_secure_element/cmac.c\
 	smtc_modem_core/smtc_modem_crypto/soft_secure_element/soft_se.c
 
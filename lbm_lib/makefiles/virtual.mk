@@ -0,0 +1,45 @@
+##############################################################################
+# Definitions for the simulated radio of host builds
+##############################################################################
+-include makefiles/options.mk
+
+TARGET = virtual
+
+# Allow modem options
+ALLOW_CSMA_BUILD = yes
+
+
+#-----------------------------------------------------------------------------
+# Radio specific sources
+#-----------------------------------------------------------------------------
+
+SMTC_RAL_C_SOURCES += \
+	smtc_modem_core/smtc_ral/src/ral_virtual.c
+
+SMTC_RALF_C_SOURCES += \
+	smtc_modem_core/smtc_ralf/src/ralf_virtual.c
+
+ifeq ($(CRYPTO),SOFT_FAST)
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes_fast.c
+else
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/aes.c
+endif
+
+SMTC_MODEM_CRYPTO_C_SOURCES += \
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/cmac.c\
+	smtc_modem_core/smtc_modem_crypto/soft_secure_element/soft_se.c
+
+#-----------------------------------------------------------------------------
+# Includes
+#-----------------------------------------------------------------------------
+LBM_C_INCLUDES =  \
+	-Ismtc_modem_core/smtc_modem_crypto/soft_secure_element
+
+
+#-----------------------------------------------------------------------------
+# Radio specific compilation flags
+#-----------------------------------------------------------------------------
+LBM_C_DEFS += \
+	-DVIRTUAL_RADIO
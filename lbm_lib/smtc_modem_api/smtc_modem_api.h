@@ -137,6 +137,7 @@ typedef enum smtc_modem_adr_profile_e
     SMTC_MODEM_ADR_PROFILE_MOBILE_LONG_RANGE  = 0x01,  //!< Long range distribution for mobile devices
     SMTC_MODEM_ADR_PROFILE_MOBILE_LOW_POWER   = 0x02,  //!< Low power distribution for mobile devices
     SMTC_MODEM_ADR_PROFILE_CUSTOM             = 0x03,  //!< User defined distribution
+    SMTC_MODEM_ADR_PROFILE_LINK_QUALITY       = 0x04,  //!< Device chosen datarate from the measured link margin
 } smtc_modem_adr_profile_t;
 
 /**
@@ -162,6 +163,9 @@ typedef struct smtc_modem_version_s
 
 /**
  * @brief Multicast group identifier
+ *
+ * Groups 4 to 7 exist when the library is built with LR1MAC_MC_NUMBER_OF_SESSION above 4 (soft secure element only),
+ * the remote multicast setup package only manages groups 0 to 3.
  */
 typedef enum smtc_modem_mc_grp_id_e
 {
@@ -169,6 +173,10 @@ typedef enum smtc_modem_mc_grp_id_e
     SMTC_MODEM_MC_GRP_1,
     SMTC_MODEM_MC_GRP_2,
     SMTC_MODEM_MC_GRP_3,
+    SMTC_MODEM_MC_GRP_4,
+    SMTC_MODEM_MC_GRP_5,
+    SMTC_MODEM_MC_GRP_6,
+    SMTC_MODEM_MC_GRP_7,
 } smtc_modem_mc_grp_id_t;
 
 /**
@@ -217,6 +225,14 @@ typedef enum smtc_modem_dl_window_e
     SMTC_MODEM_DL_WINDOW_RXB_MC_GRP3 = 0x0C,
     SMTC_MODEM_DL_WINDOW_RXBEACON    = 0x0D,
     SMTC_MODEM_DL_WINDOW_RXR         = 0x0E,
+    SMTC_MODEM_DL_WINDOW_RXC_MC_GRP4 = 0x0F,
+    SMTC_MODEM_DL_WINDOW_RXC_MC_GRP5 = 0x10,
+    SMTC_MODEM_DL_WINDOW_RXC_MC_GRP6 = 0x11,
+    SMTC_MODEM_DL_WINDOW_RXC_MC_GRP7 = 0x12,
+    SMTC_MODEM_DL_WINDOW_RXB_MC_GRP4 = 0x13,
+    SMTC_MODEM_DL_WINDOW_RXB_MC_GRP5 = 0x14,
+    SMTC_MODEM_DL_WINDOW_RXB_MC_GRP6 = 0x15,
+    SMTC_MODEM_DL_WINDOW_RXB_MC_GRP7 = 0x16,
 } smtc_modem_dl_window_t;
 
 /**
@@ -317,6 +333,8 @@ typedef enum smtc_modem_dm_field_e
     SMTC_MODEM_DM_FIELD_CHIP_EUI    = 0x13,  //!< ChipEUI
     SMTC_MODEM_DM_INFO_STREAMPAR    = 0x15,  //!< data stream parameters
     SMTC_MODEM_DM_FIELD_APP_STATUS  = 0x16,  //!< application-specific status
+    SMTC_MODEM_DM_FIELD_PERF        = 0x1C,  //!< performance counters since the last report (LBM_DM_PERF=yes only)
+    SMTC_MODEM_DM_FIELD_BATTERY     = 0x1D,  //!< battery life estimate (LBM_BATTERY_ESTIMATOR=yes only)
 } smtc_modem_dm_field_t;
 
 /**
@@ -430,6 +448,8 @@ typedef enum smtc_modem_event_test_mode_status_e
     SMTC_MODEM_EVENT_TEST_MODE_TX_DONE      = 2,
     SMTC_MODEM_EVENT_TEST_MODE_RX_DONE      = 3,
     SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED   = 4,
+    SMTC_MODEM_EVENT_TEST_MODE_SURVEY_DONE  = 5,
+    SMTC_MODEM_EVENT_TEST_MODE_PER_DONE     = 6,
 } smtc_modem_event_test_mode_status_t;
 /**
  * @brief Structure holding event-related data
@@ -512,6 +532,115 @@ typedef struct smtc_modem_event_s
     } event_data;
 } smtc_modem_event_t;
 
+/**
+ * @brief Event read from the event queue, with the data captured when it occurred
+ */
+typedef struct smtc_modem_event_record_s
+{
+    smtc_modem_event_t       event;         //!< missed_events: events dropped by the full queue before this one
+    uint32_t                 timestamp_ms;  //!< Modem time of the event
+    uint32_t                 fcnt;          //!< TXDONE: frame counter of the next uplink, 0 for other events
+    smtc_modem_dl_metadata_t dl_metadata;   //!< DOWNDATA: downlink metadata, zeroed for other events
+} smtc_modem_event_record_t;
+
+/**
+ * @brief Origin of the uplinks accounted in a @ref smtc_modem_service_stats_t entry
+ */
+typedef enum smtc_modem_service_stats_source_e
+{
+    SMTC_MODEM_SERVICE_STATS_SOURCE_FPORT = 0,  //!< Uplinks on fport, application or modem service
+    SMTC_MODEM_SERVICE_STATS_SOURCE_JOIN  = 1,  //!< Join requests
+    SMTC_MODEM_SERVICE_STATS_SOURCE_MAC   = 2,  //!< Frames without fport (link check, device time, ping slot info...)
+    SMTC_MODEM_SERVICE_STATS_SOURCE_OTHER = 3,  //!< Sources left out of the full table
+} smtc_modem_service_stats_source_t;
+
+/**
+ * @brief Radio time and charge of the uplinks of one source
+ */
+typedef struct smtc_modem_service_stats_s
+{
+    smtc_modem_service_stats_source_t source;
+    uint8_t                           fport;          //!< With SMTC_MODEM_SERVICE_STATS_SOURCE_FPORT, 0 otherwise
+    uint32_t                          uplink_count;   //!< Uplinks launched, retransmissions excluded
+    uint32_t                          tx_time_ms;     //!< Time on air, retransmissions and LBT included
+    uint32_t                          tx_charge_uas;  //!< Radio charge while transmitting in uA.s, saturates
+    uint32_t                          rx_time_ms;     //!< Time in receive windows
+    uint32_t                          rx_charge_uas;  //!< Radio charge while receiving in uA.s, saturates
+} smtc_modem_service_stats_t;
+
+/**
+ * @brief Battery life estimate returned by @ref smtc_modem_get_battery_estimate
+ */
+typedef struct smtc_modem_battery_estimate_s
+{
+    uint32_t average_current_ua;  //!< Projected average current of the device, radio and sleep currents
+    uint32_t radio_current_ua;    //!< Radio charge measured since the last charge reset over the observation time
+    uint32_t sleep_current_ua;    //!< Board sleep current given by smtc_modem_hal_get_sleep_current_ua()
+    uint32_t observation_s;       //!< Time since the modem init or the last charge reset
+    uint32_t remaining_life_h;    //!< Projected remaining battery life, 0xFFFFFFFF when it cannot be estimated
+} smtc_modem_battery_estimate_t;
+
+/**
+ * @brief Modem status read at once by @ref smtc_modem_get_status_snapshot
+ */
+typedef struct smtc_modem_status_snapshot_s
+{
+    smtc_modem_status_mask_t status_mask;           //!< Modem status, see @ref smtc_modem_status_mask_e
+    smtc_modem_region_t      region;                //!< LoRaWAN region
+    smtc_modem_class_t       lorawan_class;         //!< LoRaWAN class running, class A while not joined
+    uint32_t                 uplink_fcnt;           //!< Frame counter of the last uplink
+    uint8_t                  next_datarate;         //!< Datarate of the next uplink
+    int8_t                   next_tx_power_dbm;     //!< Transmit power of the next uplink
+    uint8_t                  nb_trans;              //!< Number of transmissions of each uplink
+    uint8_t                  next_tx_max_payload;   //!< Max payload of the next uplink, 0 when it cannot be sent
+    int32_t                  duty_cycle_status_ms;  //!< As returned by @ref smtc_modem_get_duty_cycle_status
+    uint16_t                 lost_connection_cnt;   //!< Uplinks since the last downlink
+    uint32_t                 charge_uah;            //!< Total charge counter of the modem
+    uint8_t                  event_pending_count;   //!< Events left to read with @ref smtc_modem_get_event
+    uint32_t                 timestamp_s;           //!< Modem time of the snapshot
+} smtc_modem_status_snapshot_t;
+
+/**
+ * @brief Fields of a @ref smtc_modem_config_t to apply, in the order they are applied
+ */
+enum smtc_modem_config_field_e
+{
+    SMTC_MODEM_CONFIG_REGION              = ( 1 << 0 ),  //!< smtc_modem_set_region, before the join only
+    SMTC_MODEM_CONFIG_ADR_PROFILE         = ( 1 << 1 ),  //!< smtc_modem_adr_set_profile, once joined
+    SMTC_MODEM_CONFIG_NB_TRANS            = ( 1 << 2 ),  //!< smtc_modem_set_nb_trans
+    SMTC_MODEM_CONFIG_ADR_ACK_LIMIT_DELAY = ( 1 << 3 ),  //!< smtc_modem_set_adr_ack_limit_delay
+    SMTC_MODEM_CONFIG_CLASS               = ( 1 << 4 ),  //!< smtc_modem_set_class, once joined
+    SMTC_MODEM_CONFIG_FPENDING_DRAIN      = ( 1 << 5 ),  //!< smtc_modem_set_fpending_drain
+};
+
+/**
+ * @brief Modem configuration applied at once by @ref smtc_modem_apply_config
+ */
+typedef struct smtc_modem_config_s
+{
+    uint16_t                 fields;                                              //!< Fields to apply
+    smtc_modem_region_t      region;                                              //!< LoRaWAN region
+    smtc_modem_adr_profile_t adr_profile;                                         //!< ADR profile
+    uint8_t                  adr_custom_data[SMTC_MODEM_CUSTOM_ADR_DATA_LENGTH];  //!< Custom profile distribution
+    uint8_t                  nb_trans;                                            //!< Transmissions of each uplink
+    uint8_t                  adr_ack_limit;                                       //!< ADR ack limit
+    uint8_t                  adr_ack_delay;                                       //!< ADR ack delay
+    smtc_modem_class_t       lorawan_class;                                       //!< LoRaWAN class
+    bool                     fpending_drain;                                      //!< Frame pending downlink drain
+} smtc_modem_config_t;
+
+/**
+ * @brief Callback writing the payload of an uplink requested with @ref smtc_modem_request_uplink_with_callback
+ *
+ * @param [in]  stack_id           Stack identifier
+ * @param [out] payload            Buffer to write the payload in
+ * @param [in]  max_payload_length Maximum payload length at the datarate of the uplink
+ * @param [in]  context            Context given with the request
+ * @return Payload length, the uplink is not sent if it is above \p max_payload_length
+ */
+typedef uint8_t ( *smtc_modem_uplink_fill_callback_t )( uint8_t stack_id, uint8_t* payload,
+                                                         uint8_t max_payload_length, void* context );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -591,7 +720,9 @@ smtc_modem_return_code_t smtc_modem_join_network( uint8_t stack_id );
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p fport is out of the [1:223] range or equal to the DM LoRaWAN FPort
+ * @retval SMTC_MODEM_RC_INVALID           \p fport is out of the [1:223] range or equal to the DM LoRaWAN FPort, or
+ *                                         the payload is not a record of the compression schema of \p fport
+ *                                         (LBM_PAYLOAD_COMPRESSION)
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_FAIL              Modem is not available (suspended, muted, or not joined)
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
@@ -599,6 +730,118 @@ smtc_modem_return_code_t smtc_modem_join_network( uint8_t stack_id );
 smtc_modem_return_code_t smtc_modem_request_uplink( uint8_t stack_id, uint8_t fport, bool confirmed,
                                                     const uint8_t* payload, uint8_t payload_length );
 
+/**
+ * @brief Get the modem uplink buffer to write a LoRaWAN payload in place
+ *
+ * @remark The payload written in the buffer is sent with @ref smtc_modem_commit_uplink_buffer, without being copied by
+ * the modem before the LoRaWAN frame is built. The modem reads the buffer until the frame is built (after LBT, CSMA or
+ * relay preprocessing), this function returns SMTC_MODEM_RC_BUSY meanwhile. The buffer is shared with
+ * @ref smtc_modem_request_uplink: as for a new uplink request, writing it replaces the payload of an uplink not
+ * started yet
+ *
+ * @param [in]  stack_id           Stack identifier
+ * @param [out] payload            Pointer on the uplink buffer
+ * @param [out] max_payload_length Size of the uplink buffer
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p payload or \p max_payload_length is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode or the buffer is still read by the modem
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_request_uplink_buffer( uint8_t stack_id, uint8_t** payload,
+                                                           uint8_t* max_payload_length );
+
+/**
+ * @brief Request a LoRaWAN uplink of the payload written in the buffer given by @ref smtc_modem_request_uplink_buffer
+ *
+ * @param [in] stack_id       Stack identifier
+ * @param [in] fport          LoRaWAN FPort on which the uplink is done
+ * @param [in] confirmed      Message type (true: confirmed, false: unconfirmed)
+ * @param [in] payload_length Number of bytes written in the uplink buffer
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p fport is out of the [1:223] range or equal to the DM LoRaWAN FPort, or
+ *                                         \p payload_length is too long
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode or the previous payload is still read
+ * @retval SMTC_MODEM_RC_FAIL              Modem is not available (suspended, muted, or not joined)
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_commit_uplink_buffer( uint8_t stack_id, uint8_t fport, bool confirmed,
+                                                          uint8_t payload_length );
+
+/**
+ * @brief Request a LoRaWAN uplink whose payload is written by a callback when the frame is built
+ *
+ * @remark The callback is called from the modem engine context once the duty cycle, LBT, CSMA and relay preprocessing
+ * let the uplink go, with the maximum payload length of the datarate chosen for the uplink. The data are sampled at
+ * transmission time and no payload is held by the modem meanwhile. The callback must not call the modem API. If the
+ * uplink is aborted before, the callback is not called and the request completes with the SMTC_MODEM_EVENT_TXDONE
+ * event as any uplink
+ *
+ * @param [in] stack_id      Stack identifier
+ * @param [in] fport         LoRaWAN FPort on which the uplink is done
+ * @param [in] confirmed     Message type (true: confirmed, false: unconfirmed)
+ * @param [in] fill_callback Callback writing the payload
+ * @param [in] context       Context given to \p fill_callback
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p fport is out of the [1:223] range or equal to the DM LoRaWAN FPort, or
+ *                                         \p fill_callback is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode or the uplink buffer is still read
+ * @retval SMTC_MODEM_RC_FAIL              Modem is not available (suspended, muted, or not joined)
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_request_uplink_with_callback( uint8_t stack_id, uint8_t fport, bool confirmed,
+                                                                  smtc_modem_uplink_fill_callback_t fill_callback,
+                                                                  void* context );
+
+/**
+ * @brief Queue a LoRaWAN uplink request, sent by the modem engine in queue order
+ *
+ * @remark Only available when the modem is built with LBM_REQUEST_QUEUE=yes. The payload is copied in the request
+ * queue and the function returns without touching the modem state, in bounded time: it can be called from an
+ * interrupt or a high priority thread without taking the modem lock (LBM_THREAD_SAFE=yes), as long as a single context
+ * queues requests. The engine wakeup callback (@ref smtc_modem_set_engine_wakeup_callback) is called from this
+ * context. The next call to @ref smtc_modem_run_engine hands the request to the stack once the previous uplink of the
+ * stack is launched. The request completes with the SMTC_MODEM_EVENT_TXDONE event, with the status
+ * SMTC_MODEM_EVENT_TXDONE_NOT_SENT when the modem rejects it (not joined, muted, suspended, forbidden \p fport...).
+ *
+ * @param [in] stack_id       Stack identifier
+ * @param [in] fport          LoRaWAN FPort on which the uplink is done
+ * @param [in] confirmed      Message type (true: confirmed, false: unconfirmed)
+ * @param [in] payload        Data to be sent
+ * @param [in] payload_length Number of bytes from payload to be sent, at most MODEM_REQUEST_QUEUE_MAX_PAYLOAD_LENGTH
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Request queued
+ * @retval SMTC_MODEM_RC_INVALID           \p payload is NULL or \p payload_length is too long
+ * @retval SMTC_MODEM_RC_BUSY              The request queue is full
+ * @retval SMTC_MODEM_RC_FAIL              The request queue is not built in the modem
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_queue_uplink( uint8_t stack_id, uint8_t fport, bool confirmed,
+                                                  const uint8_t* payload, uint8_t payload_length );
+
+/**
+ * @brief Queue an empty LoRaWAN uplink request, see @ref smtc_modem_queue_uplink
+ *
+ * @param [in] stack_id   Stack identifier
+ * @param [in] send_fport Add the FPort to the frame
+ * @param [in] fport      LoRaWAN FPort on which the uplink is done, used if \p send_fport is true
+ * @param [in] confirmed  Message type (true: confirmed, false: unconfirmed)
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Request queued
+ * @retval SMTC_MODEM_RC_BUSY              The request queue is full
+ * @retval SMTC_MODEM_RC_FAIL              The request queue is not built in the modem
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_queue_empty_uplink( uint8_t stack_id, bool send_fport, uint8_t fport,
+                                                        bool confirmed );
+
 /**
  * @brief Get the modem event
  *
@@ -616,6 +859,28 @@ smtc_modem_return_code_t smtc_modem_request_uplink( uint8_t stack_id, uint8_t fp
 
 smtc_modem_return_code_t smtc_modem_get_event( smtc_modem_event_t* event, uint8_t* event_pending_count );
 
+/**
+ * @brief Get several modem events at once, in the order they occurred
+ *
+ * @remark Only available when the modem is built with LBM_EVENT_QUEUE=yes. Unlike @ref smtc_modem_get_event, each
+ * occurrence of an event is kept with its own data, in a queue of MODEM_EVENT_QUEUE_NB_EVENTS events: when the queue
+ * is full the oldest event is dropped and counted in the missed_events field of the next event read. The events read
+ * are also cleared from @ref smtc_modem_get_event.
+ *
+ * @param [out] events              Array filled with the oldest events
+ * @param [in]  max_events          Number of elements of \p events
+ * @param [out] nb_events           Number of events written in \p events
+ * @param [out] event_pending_count Number of events left in the queue
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameters are NULL or \p max_events is 0
+ * @retval SMTC_MODEM_RC_NO_EVENT      No event available
+ * @retval SMTC_MODEM_RC_FAIL          The event queue is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_events( smtc_modem_event_record_t* events, uint8_t max_events,
+                                                uint8_t* nb_events, uint8_t* event_pending_count );
+
 /**
  * @brief Get all the data from a downlink
  *
@@ -817,6 +1082,47 @@ smtc_modem_return_code_t smtc_modem_derive_and_set_data_block_int_key(
  */
 smtc_modem_return_code_t smtc_modem_get_status( uint8_t stack_id, smtc_modem_status_mask_t* status_mask );
 
+/**
+ * @brief Get the status, the uplink parameters, the charge and the pending events of the modem in one call
+ *
+ * @remark The fields are read together, without the engine running in between when the application calls the modem
+ * api under its lock (RTOS ports with LBM_THREAD_SAFE=yes): one lock replaces the dozen calls of the individual
+ * getters. Unlike @ref smtc_modem_get_class and @ref smtc_modem_get_next_tx_max_payload, the snapshot does not fail
+ * while the modem is not joined
+ *
+ * @param [in]  stack_id Stack identifier
+ * @param [out] snapshot Modem status
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p snapshot is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_get_status_snapshot( uint8_t stack_id, smtc_modem_status_snapshot_t* snapshot );
+
+/**
+ * @brief Apply several configuration fields in one call
+ *
+ * @remark The fields selected in \p config are applied with their individual setters, in the order of
+ * @ref smtc_modem_config_field_e, and keep their conditions (the region before the join, the ADR profile and the
+ * class once joined). The first failing field stops the call, the fields applied before it are kept and returned in
+ * \p applied_fields
+ *
+ * @param [in]  stack_id       Stack identifier
+ * @param [in]  config         Configuration, only the fields selected by config->fields are read
+ * @param [out] applied_fields Fields applied, see @ref smtc_modem_config_field_e
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                All the selected fields are applied
+ * @retval SMTC_MODEM_RC_INVALID           Parameters are NULL, an unknown field is selected or a field is invalid
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL              A field cannot be applied in the current modem state
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_apply_config( uint8_t stack_id, const smtc_modem_config_t* config,
+                                                  uint16_t* applied_fields );
+
 /**
  * @brief Get the modem firmware version
  *
@@ -960,6 +1266,37 @@ smtc_modem_return_code_t smtc_modem_request_emergency_uplink( uint8_t stack_id,
 smtc_modem_return_code_t smtc_modem_request_empty_uplink( uint8_t stack_id, bool send_fport, uint8_t fport,
                                                           bool confirmed );
 
+/**
+ * @brief Enable/disable the frame pending downlink drain
+ *
+ * @remark When enabled, every class A downlink with the FPending bit set schedules an empty unconfirmed uplink as soon
+ * as the duty-cycle allows it, so the network server can send the next queued downlink without waiting for the next
+ * application uplink. The drain stops by itself when a poll uplink gets no downlink. Combine it with the
+ * SMTC_MODEM_ADR_PROFILE_LINK_QUALITY profile to poll at the fastest datarate the link supports.
+ *
+ * @param [in] stack_id  Stack identifier
+ * @param [in] enable    true to enable the drain, false to disable it (default)
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_set_fpending_drain( uint8_t stack_id, bool enable );
+
+/**
+ * @brief Get the frame pending downlink drain state
+ *
+ * @param [in]  stack_id  Stack identifier
+ * @param [out] enabled   true if the drain is enabled
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p enabled is NULL
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_get_fpending_drain( uint8_t stack_id, bool* enabled );
+
 /**
  * @brief Leave an already joined network or cancels on ongoing join process
  *
@@ -1070,6 +1407,56 @@ smtc_modem_return_code_t smtc_modem_get_next_tx_max_payload( uint8_t stack_id, u
  */
 smtc_modem_return_code_t smtc_modem_get_duty_cycle_status( uint8_t stack_id, int32_t* duty_cycle_status_ms );
 
+/**
+ * @brief Set the share of the radio time given to a stack when several stacks compete for the radio
+ *
+ * @remark Only available when the modem is built with LBM_STACK_FAIRNESS=yes. Between ready tasks of the same priority,
+ * the stack that used the least radio time for its weight goes first, in the modem supervisor and in the radio planner.
+ *
+ * @param [in] stack_id Stack identifier
+ * @param [in] weight   Relative share, from 1 (default) to 255
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p weight is 0
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ * @retval SMTC_MODEM_RC_FAIL              Stack fairness is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_set_stack_weight( uint8_t stack_id, uint8_t weight );
+
+/**
+ * @brief Limit the radio time a stack can use per hour
+ *
+ * @remark Only available when the modem is built with LBM_STACK_FAIRNESS=yes. Once the quota is used, the tasks of the
+ * stack wait for the next one hour window, except the ones allowed to bypass the duty-cycle. A new quota starts a new
+ * window.
+ *
+ * @param [in] stack_id Stack identifier
+ * @param [in] quota_ms Radio time (Tx and Rx) allowed per window in milliseconds, 0 to remove the quota
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ * @retval SMTC_MODEM_RC_FAIL              Stack fairness is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_set_stack_airtime_quota( uint8_t stack_id, uint32_t quota_ms );
+
+/**
+ * @brief Get the radio time used by a stack and the number of windows in which its quota held it back
+ *
+ * @param [in]  stack_id        Stack identifier
+ * @param [out] airtime_ms      Radio time (Tx and Rx) used since the modem init in milliseconds
+ * @param [out] quota_deferrals Number of quota windows in which the stack reached its quota
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p airtime_ms or \p quota_deferrals is NULL
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ * @retval SMTC_MODEM_RC_FAIL              Stack fairness is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_stack_airtime_stats( uint8_t stack_id, uint32_t* airtime_ms,
+                                                             uint32_t* quota_deferrals );
+
 /**
  * @brief Get Configured LoRaWAN network type to private or public
  *
@@ -1151,6 +1538,82 @@ smtc_modem_return_code_t smtc_modem_adr_set_profile(
  */
 smtc_modem_return_code_t smtc_modem_adr_get_profile( uint8_t stack_id, smtc_modem_adr_profile_t* adr_profile );
 
+/**
+ * @brief Set the link margin kept by the @ref SMTC_MODEM_ADR_PROFILE_LINK_QUALITY profile
+ *
+ * @remark Only available when the modem is built with LBM_LINK_ADR=yes. The profile keeps the worst SNR of the last
+ * downlinks and LinkCheckAns, and uses the fastest datarate whose demodulation floor stays \p margin_db below it. Each
+ * confirmed uplink left without acknowledgement steps the datarate down once until the next downlink.
+ *
+ * @param [in] stack_id        Stack identifier
+ * @param [in] margin_db       Margin in dB (0 to 30, 10 by default)
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p margin_db is out of range
+ * @retval SMTC_MODEM_RC_FAIL              The link quality profile is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_adr_set_link_margin( uint8_t stack_id, uint8_t margin_db );
+
+/**
+ * @brief Enable or disable the device transmit power control
+ *
+ * @remark Only available when the modem is built with LBM_LINK_ADR=yes. Applies to every ADR profile except
+ * @ref SMTC_MODEM_ADR_PROFILE_NETWORK_CONTROLLED, where the network sets the power with LinkADRReq. Each new uplink
+ * lowers the transmit power by 2 dB while the worst of the last downlink SNR and LinkCheckAns margins stays above the
+ * link margin (see @ref smtc_modem_adr_set_link_margin) at the uplink datarate, down to the lowest power of the region.
+ * The power is raised at once when the margin gets short, and by one step on each confirmed uplink left without
+ * acknowledgement, before any datarate step down. Disabled by default.
+ *
+ * @param [in] stack_id        Stack identifier
+ * @param [in] enable          true to enable the transmit power control
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_FAIL              The link quality profile is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_adr_set_tx_power_control( uint8_t stack_id, bool enable );
+
+/**
+ * @brief Set the delivery ratio the number of transmissions of the unconfirmed uplinks aims at
+ *
+ * @remark Only available when the modem is built with LBM_LINK_ADR=yes. Applies to every ADR profile except
+ * @ref SMTC_MODEM_ADR_PROFILE_NETWORK_CONTROLLED, where the network sets NbTrans with LinkADRReq. The confirmed uplinks
+ * and the LinkCheckReq (see @ref smtc_modem_trig_lorawan_mac_request) are the probes: the share left without answer
+ * over the last probes estimates the loss ratio q of a transmission, and each unconfirmed uplink is sent the lowest n
+ * times that gives 1 - q^n >= \p target_percent. The number of transmissions set with @ref smtc_modem_set_nb_trans or
+ * by the ADR profile is the upper bound, and is used until 4 probes are counted. Disabled by default.
+ *
+ * @param [in] stack_id        Stack identifier
+ * @param [in] target_percent  Delivery ratio in percent (1 to 99), 0 to disable the adaptation
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p target_percent is out of range
+ * @retval SMTC_MODEM_RC_FAIL              The link quality profile is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_adr_set_delivery_target( uint8_t stack_id, uint8_t target_percent );
+
+/**
+ * @brief Enable or disable the FSK bulk transfer of the services draining a backlog
+ *
+ * @remark Only available when the modem is built with LBM_LINK_ADR=yes. Applies to every ADR profile except
+ * @ref SMTC_MODEM_ADR_PROFILE_NETWORK_CONTROLLED. The uplinks of the store and forward services, of the LoRa Basics
+ * Modem file upload and of the stream are sent at the maximum EIRP with the FSK datarate of the region (DR7 in EU868)
+ * when the worst of the last 3 or more downlink SNR and LinkCheckAns margins is at least the link margin (see
+ * @ref smtc_modem_adr_set_link_margin) above the FSK floor, taken 12 dB SNR, and a channel allowing FSK is out of its
+ * duty cycle. Otherwise, and after any acknowledgement lost since the last downlink, they are sent with the datarate of
+ * the ADR profile. Disabled by default.
+ *
+ * @param [in] stack_id        Stack identifier
+ * @param [in] enable          true to enable the FSK bulk transfer
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_FAIL              The link quality profile is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_adr_set_bulk_transfer( uint8_t stack_id, bool enable );
+
 /**
  * @brief Set the number of transmissions in case of unconfirmed uplink
  *
@@ -1397,6 +1860,19 @@ smtc_modem_return_code_t smtc_modem_csma_get_parameters( uint8_t stack_id, uint8
  */
 smtc_modem_return_code_t smtc_modem_get_charge( uint32_t* charge_mah );
 
+/**
+ * @brief Get the total charge counter of the modem in uAh
+ *
+ * @remark The charge is accumulated on 64 bits in uA.ms, the returned value saturates at 0xFFFFFFFF uAh
+ *
+ * @param [out] charge_uah Accumulated charge in uAh
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameter \p charge_uah is NULL
+ */
+smtc_modem_return_code_t smtc_modem_get_charge_uah( uint32_t* charge_uah );
+
 /**
  * @brief Get the Radio Planner statistics in array
  *
@@ -1406,6 +1882,131 @@ smtc_modem_return_code_t smtc_modem_get_charge( uint32_t* charge_mah );
  */
 smtc_modem_return_code_t smtc_modem_get_rp_stats_to_array( uint8_t* stats_array, uint16_t* stats_array_length );
 
+/**
+ * @brief Drain the Radio Planner event trace in array
+ *
+ * @remark Only available when the modem is built with LBM_RP_TRACE=yes. Events are removed from the trace once read,
+ * the oldest first, and as many events as fit in \p trace_array_max_length are returned. All fields are big endian:
+ *  - lost_events (4 bytes): number of events dropped since startup because the trace was full
+ *  - then for each event (8 bytes): timestamp_us (4 bytes), event type (1 byte), hook id (1 byte), data (2 bytes)
+ *
+ * Event types and data are defined by rp_trace_event_type_t in radio_planner_trace.h
+ *
+ * @param [out] trace_array             Buffer to fill
+ * @param [in]  trace_array_max_length  Size of \p trace_array, at least 4 bytes
+ * @param [out] trace_array_length      Number of bytes written in \p trace_array
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameters are NULL or \p trace_array_max_length is too short
+ * @retval SMTC_MODEM_RC_FAIL          The trace is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_rp_trace_to_array( uint8_t* trace_array, uint16_t trace_array_max_length,
+                                                           uint16_t* trace_array_length );
+
+/**
+ * @brief Get the execution time statistics of the profiled hot paths in array
+ *
+ * @remark Only available when the modem is built with LBM_PROFILE=yes. One 16-byte entry per section, in the order
+ * of smtc_modem_dbg_profile_section_t (smtc_modem_dbg_profile.h), all fields are big endian:
+ *  - count (4 bytes), min_us (4 bytes), avg_us (4 bytes), max_us (4 bytes)
+ *
+ * @param [out] profile_array             Buffer to fill
+ * @param [in]  profile_array_max_length  Size of \p profile_array, at least 16 bytes per section
+ * @param [out] profile_array_length      Number of bytes written in \p profile_array
+ * @param [in]  reset                     Clear the statistics once read
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameters are NULL or \p profile_array_max_length is too short
+ * @retval SMTC_MODEM_RC_FAIL          The profiling is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_profile_to_array( uint8_t* profile_array, uint16_t profile_array_max_length,
+                                                          uint16_t* profile_array_length, bool reset );
+
+/**
+ * @brief Get the latency histograms of the uplinks, downlinks and joins in array
+ *
+ * @remark Only available when the modem is built with LBM_LATENCY_HISTOGRAM=yes. One 68-byte entry per histogram,
+ * in the order of smtc_modem_dbg_latency_t (smtc_modem_dbg_latency.h): uplink request to TXDONE event, end of
+ * reception to DOWNDATA event, join request to JOINED event. All fields are big endian:
+ *  - count (4 bytes), p50_ms (4 bytes), p99_ms (4 bytes), then 28 bucket counts (2 bytes each, saturated)
+ *
+ * Bucket 0 counts the durations below 1 ms, bucket k the durations in [2^(k-1), 2^k) ms and the last bucket the
+ * longer ones. The percentiles are the upper bound of the bucket holding them, 0xFFFFFFFF in the last bucket, other
+ * percentiles can be computed from the bucket counts.
+ *
+ * @param [out] latency_array             Buffer to fill
+ * @param [in]  latency_array_max_length  Size of \p latency_array, at least 68 bytes per histogram
+ * @param [out] latency_array_length      Number of bytes written in \p latency_array
+ * @param [in]  reset                     Clear the histograms once read
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameters are NULL or \p latency_array_max_length is too short
+ * @retval SMTC_MODEM_RC_FAIL          The latency histograms are not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_latency_histograms_to_array( uint8_t* latency_array,
+                                                                     uint16_t latency_array_max_length,
+                                                                     uint16_t* latency_array_length, bool reset );
+
+/**
+ * @brief Get the statistics of the airtime aware channel selection
+ *
+ * @remark Only available when the modem is built with LBM_DTC_AIRTIME_CHANNEL=yes. An uplink is counted when at least
+ * one duty-cycle free channel was left out because its band did not have enough budget left for the frame. Without
+ * the selection, such a frame could have been sent on that band and blocked it until the whole overdraw was paid back.
+ *
+ * @param [in]  stack_id            Stack identifier
+ * @param [out] rerouted_uplinks    Number of uplinks sent on a band chosen for its remaining budget
+ * @param [out] rerouted_toa_ms     Cumulated time on air of these uplinks in milliseconds
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameters are NULL
+ * @retval SMTC_MODEM_RC_FAIL          The airtime aware channel selection is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_dtc_channel_stats( uint8_t stack_id, uint32_t* rerouted_uplinks,
+                                                           uint32_t* rerouted_toa_ms );
+
+/**
+ * @brief Get the radio time and charge of a stack broken down by uplink source
+ *
+ * @remark Only available when the modem is built with LBM_SERVICE_STATS=yes. The radio time and charge of the stack
+ * (LoRaWAN transactions, LBT, CSMA, relay WOR) are attributed to the last uplink launched: its fport, the join or the
+ * frames without fport. The retransmissions and the network answers sent by the stack on its own are attributed to
+ * the uplink they follow. The modem services send on the fport they are configured with (device management, stream,
+ * store and forward, geolocation, LoRaWAN packages). Up to TPM_SERVICE_STATS_NB_SOURCES sources (default 8) are
+ * tracked per stack, the last entry gathers the sources that do not fit, with SMTC_MODEM_SERVICE_STATS_SOURCE_OTHER
+ *
+ * @param [in]  stack_id      Stack identifier
+ * @param [out] stats         Entries in the order the sources were first used
+ * @param [in]  stats_max_nb  Size of \p stats in entries
+ * @param [out] stats_nb      Number of entries written in \p stats
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           Parameters are NULL
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ * @retval SMTC_MODEM_RC_FAIL              The statistics are not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_service_stats( uint8_t stack_id, smtc_modem_service_stats_t* stats,
+                                                       uint8_t stats_max_nb, uint8_t* stats_nb );
+
+/**
+ * @brief Clear the per uplink source statistics of a stack
+ *
+ * @remark Only available when the modem is built with LBM_SERVICE_STATS=yes
+ *
+ * @param [in] stack_id Stack identifier
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ * @retval SMTC_MODEM_RC_FAIL              The statistics are not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_reset_service_stats( uint8_t stack_id );
+
 /**
  * @brief Reset the total charge counter of the modem
  *
@@ -1415,6 +2016,40 @@ smtc_modem_return_code_t smtc_modem_get_rp_stats_to_array( uint8_t* stats_array,
  */
 smtc_modem_return_code_t smtc_modem_reset_charge( void );
 
+/**
+ * @brief Set the capacity of the full battery used by the battery life estimation
+ *
+ * @remark Only available when the modem is built with LBM_BATTERY_ESTIMATOR=yes
+ *
+ * @param [in] capacity_mah Battery capacity in mAh, 0 when unknown (default)
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_FAIL          The estimator is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_set_battery_capacity( uint32_t capacity_mah );
+
+/**
+ * @brief Estimate the average current of the device and its remaining battery life
+ *
+ * @remark Only available when the modem is built with LBM_BATTERY_ESTIMATOR=yes. The radio current is the charge
+ * measured by the radio planner (transmissions, receive windows, beacons, ping slots, CAD, relay, LBT) spread over the
+ * time since the modem init or the last @ref smtc_modem_reset_charge, so it follows the configuration of the services
+ * and classes in use during that time. Call @ref smtc_modem_reset_charge after a configuration change to observe its
+ * impact alone, the estimate is meaningful once the observation spans a few periods of the slowest service. The sleep
+ * current of the board is added, the remaining charge is the battery capacity scaled by
+ * smtc_modem_hal_get_battery_level(). The remaining life is 0xFFFFFFFF when the capacity is not set, the device is on
+ * external power, the battery level is unknown or nothing was consumed
+ *
+ * @param [out] estimate Battery life estimate
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       Parameter \p estimate is NULL
+ * @retval SMTC_MODEM_RC_FAIL          The estimator is not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_get_battery_estimate( smtc_modem_battery_estimate_t* estimate );
+
 /*
  * -----------------------------------------------------------------------------
  * ----------- CLASS B/C MODEM FUNCTIONS ---------------------------------------
@@ -1449,6 +2084,39 @@ smtc_modem_return_code_t smtc_modem_get_class( uint8_t stack_id, smtc_modem_clas
  */
 smtc_modem_return_code_t smtc_modem_set_class( uint8_t stack_id, smtc_modem_class_t lorawan_class );
 
+/**
+ * @brief Set the preamble length of the duty-cycled class C reception
+ *
+ * Instead of listening continuously, the radio wakes up a few symbols at a time and sleeps for the rest of
+ * \p preamble_len_symb, so class C reception only costs a fraction of the RX current. The network server must send
+ * every class C downlink (unicast and multicast) with this preamble length, otherwise they are missed. Radios without
+ * hardware RX duty cycle keep listening continuously.
+ *
+ * @param [in] stack_id          Stack identifier
+ * @param [in] preamble_len_symb Preamble length in symbols agreed with the network, 0 for continuous reception
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL              Duty-cycled class C reception is not available
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_class_c_set_low_power_preamble( uint8_t stack_id, uint16_t preamble_len_symb );
+
+/**
+ * @brief Get the preamble length of the duty-cycled class C reception
+ *
+ * @param [in]  stack_id          Stack identifier
+ * @param [out] preamble_len_symb Preamble length in symbols, 0 for continuous reception
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p preamble_len_symb is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_class_c_get_low_power_preamble( uint8_t stack_id, uint16_t* preamble_len_symb );
+
 /**
  * @brief Set Class B Ping Slot Periodicity
  *
@@ -1490,7 +2158,7 @@ smtc_modem_return_code_t smtc_modem_class_b_get_ping_slot_periodicity(
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3]
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1]
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_FAIL              Error during crypto process or a running session already exists on this id
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
@@ -1509,7 +2177,8 @@ smtc_modem_return_code_t smtc_modem_multicast_set_grp_config( uint8_t stack_id,
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3] or \p mc_grp_addr is NULL
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1] or
+ *                                        \p mc_grp_addr is NULL
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
  */
@@ -1526,7 +2195,7 @@ smtc_modem_return_code_t smtc_modem_multicast_get_grp_config( uint8_t stack_id,
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3]
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1]
  *                              Frequency or Datarate are not in acceptable range (according to current regional params)
  *                              Frequency or Datarate are not compatible with an already running multicast session
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
@@ -1547,7 +2216,8 @@ smtc_modem_return_code_t smtc_modem_multicast_class_c_start_session( uint8_t sta
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3] or a parameter is NULL
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1] or
+ *                                        a parameter is NULL
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
  */
@@ -1564,7 +2234,7 @@ smtc_modem_return_code_t smtc_modem_multicast_class_c_get_session_status( uint8_
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3]
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1]
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
  */
@@ -1594,7 +2264,7 @@ smtc_modem_return_code_t smtc_modem_multicast_class_c_stop_all_sessions( uint8_t
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3]
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1]
  *                              Frequency or Datarate are not in acceptable range (according to current regional params)
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_FAIL              This session is already started or modem is not in class B
@@ -1617,7 +2287,8 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_start_session(
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3] or a parameter is NULL
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1] or
+ *                                        a parameter is NULL
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
  */
@@ -1633,7 +2304,7 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_get_session_status(
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
- * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:3]
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1]
  * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
  * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
  */
@@ -1652,6 +2323,52 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_session( uint8_t
  */
 smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_all_sessions( uint8_t stack_id );
 
+/**
+ * @brief Set the ratio of ping slots listened by a class B multicast session
+ *
+ * The session listens the ping slots whose number since the GPS epoch (beacon period number times the number of ping
+ * slots per beacon period plus the slot index) modulo \p listen_ratio equals its DevAddr modulo \p listen_ratio. The
+ * application server has to send in the same slots. After a frame with the FPending bit set all the ping slots of the
+ * session are listened until the next beacon. Overlapping ping slots of sessions on the same channel and datarate
+ * share one reception window.
+ *
+ * @remark Only available when the modem is built with LBM_CLASS_B_SELECTIVE_PING_SLOT=yes
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [in] mc_grp_id    Multicast group identifier
+ * @param [in] listen_ratio Listen one ping slot out of \p listen_ratio, 1 (default) to listen all of them
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1] or
+ *                                        \p listen_ratio is 0
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL              Selective ping slot listening is not available
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_multicast_class_b_set_listen_ratio( uint8_t                stack_id,
+                                                                        smtc_modem_mc_grp_id_t mc_grp_id,
+                                                                        uint8_t                listen_ratio );
+
+/**
+ * @brief Get the ratio of ping slots listened by a class B multicast session
+ *
+ * @param [in]  stack_id     Stack identifier
+ * @param [in]  mc_grp_id    Multicast group identifier
+ * @param [out] listen_ratio One ping slot out of \p listen_ratio is listened
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p mc_grp_id is not in the range [0:LR1MAC_MC_NUMBER_OF_SESSION-1] or
+ *                                        \p listen_ratio is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL              Selective ping slot listening is not available
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_multicast_class_b_get_listen_ratio( uint8_t                stack_id,
+                                                                        smtc_modem_mc_grp_id_t mc_grp_id,
+                                                                        uint8_t*               listen_ratio );
+
 /*
  * -----------------------------------------------------------------------------
  * ----------- LORAWAN PACKAGES FUNCTIONS --------------------------------------
@@ -1712,6 +2429,25 @@ smtc_modem_return_code_t smtc_modem_get_alcsync_time( uint8_t stack_id, uint32_t
  */
 smtc_modem_return_code_t smtc_modem_trigger_alcsync_request( uint8_t stack_id );
 
+/**
+ * @brief Set the time tolerance of the application on Application Layer Clock Synchronization (ALCSync) service
+ *
+ * @remark With a tolerance, the RTC drift is estimated from the successive time corrections. It is compensated in the
+ * time returned by @ref smtc_modem_get_alcsync_time, and the next time sync is requested when the error of this
+ * estimate may exceed the tolerance (between 1 hour and 14 days) instead of every periodicity set by the server. The
+ * periodicity requests of the server are then answered as not supported. Only available with ALCSync v2.0.0
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [in] tolerance_ms Time tolerance in millisecond, 0 to follow the periodicity set by the server (default)
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL              ALCSync v2.0.0 is not built
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_set_alcsync_tolerance( uint8_t stack_id, uint32_t tolerance_ms );
+
 /*
  * -----------------------------------------------------------------------------
  * ---------------- LORAWAN MAC REQUEST FUNCTIONS  -----------------------------
@@ -1856,6 +2592,123 @@ smtc_modem_return_code_t smtc_modem_stream_add_data( uint8_t stack_id, const uin
  */
 smtc_modem_return_code_t smtc_modem_stream_status( uint8_t stack_id, uint16_t* pending, uint16_t* free );
 
+/**
+ * @brief Let the stream redundancy ratio follow the uplink loss
+ *
+ * @remark When enabled, one stream fragment out of 8 is sent confirmed. The uplink loss is estimated from the
+ * acknowledgements and from the stream context requests of the server, and the redundancy ratio is tuned between \p
+ * min_redundancy_ratio_percent on a loss free link and \p max_redundancy_ratio_percent. The ratio given to @ref
+ * smtc_modem_stream_init is used until the first acknowledgement. A redundancy ratio sent by the server disables the
+ * automatic mode.
+ *
+ * @param [in] stack_id                      Stack identifier
+ * @param [in] enabled                       Enable the automatic redundancy ratio
+ * @param [in] min_redundancy_ratio_percent  Lowest redundancy ratio
+ * @param [in] max_redundancy_ratio_percent  Highest redundancy ratio
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_NOT_INIT          No stream session is running
+ * @retval SMTC_MODEM_RC_INVALID           \p min_redundancy_ratio_percent is greater than \p
+ *                                         max_redundancy_ratio_percent
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_stream_set_auto_redundancy( uint8_t stack_id, bool enabled,
+                                                                uint8_t min_redundancy_ratio_percent,
+                                                                uint8_t max_redundancy_ratio_percent );
+
+/**
+ * @brief Create and initialize one of the data streams of a stack
+ *
+ * @remark The modem is built with up to NUMBER_OF_STREAMS streams sharing the uplinks. The next fragment comes from
+ * the stream with pending data and the lowest \p priority value. Streams of the same priority share the airtime in
+ * proportion to their \p weight. Each stream is sent on its own FPort. Stream 0 is the one used by the other stream
+ * functions.
+ *
+ * @param [in] stack_id                  Stack identifier
+ * @param [in] stream_id                 Stream identifier, in range [0:NUMBER_OF_STREAMS-1]
+ * @param [in] f_port                    LoRaWAN FPort on which the stream is sent (0 forces the DM LoRaWAN FPort)
+ * @param [in] cipher_mode               Cipher mode
+ * @param [in] redundancy_ratio_percent  Stream redundancy ratio
+ * @param [in] priority                  Stream priority, 0 is the highest
+ * @param [in] weight                    Airtime share among the streams of the same priority, in range [1:255]
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p stream_id or \p weight is invalid, FPort is out of the [0:223] range or
+ *                                         is used by another stream
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_stream_multi_init( uint8_t stack_id, uint8_t stream_id, uint8_t f_port,
+                                                       smtc_modem_stream_cipher_mode_t cipher_mode,
+                                                       uint8_t redundancy_ratio_percent, uint8_t priority,
+                                                       uint8_t weight );
+
+/**
+ * @brief Add data to one of the data streams of a stack
+ *
+ * @remark Only stream 0 is initialized implicitly, as in @ref smtc_modem_stream_add_data
+ *
+ * @param [in] stack_id                     Stack identifier
+ * @param [in] stream_id                    Stream identifier
+ * @param [in] data                         Data to be added to the stream
+ * @param [in] len                          Number of bytes from data to be added to the stream
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_NOT_INIT          The stream is not initialized
+ * @retval SMTC_MODEM_RC_INVALID           \p stream_id is invalid, \p len is not in range [1-254] or \p data is NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode or the streaming buffer is full
+ * @retval SMTC_MODEM_RC_FAIL              Modem is not available (suspended, muted, or not joined)
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_stream_multi_add_data( uint8_t stack_id, uint8_t stream_id, const uint8_t* data,
+                                                           uint8_t len );
+
+/**
+ * @brief Return the status of one of the data streams of a stack
+ *
+ * @param [in]  stack_id                    Stack identifier
+ * @param [in]  stream_id                   Stream identifier
+ * @param [out] pending                     Length of pending data for transmission
+ * @param [out] free                        Length of free space in the buffer
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_NOT_INIT          The stream is not initialized
+ * @retval SMTC_MODEM_RC_INVALID           \p stream_id is invalid, \p pending or \p free are NULL
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_stream_multi_status( uint8_t stack_id, uint8_t stream_id, uint16_t* pending,
+                                                         uint16_t* free );
+
+/**
+ * @brief Let the redundancy ratio of one of the data streams of a stack follow the uplink loss
+ *
+ * @remark See @ref smtc_modem_stream_set_auto_redundancy
+ *
+ * @param [in] stack_id                      Stack identifier
+ * @param [in] stream_id                     Stream identifier
+ * @param [in] enabled                       Enable the automatic redundancy ratio
+ * @param [in] min_redundancy_ratio_percent  Lowest redundancy ratio
+ * @param [in] max_redundancy_ratio_percent  Highest redundancy ratio
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_NOT_INIT          The stream is not initialized
+ * @retval SMTC_MODEM_RC_INVALID           \p stream_id is invalid or \p min_redundancy_ratio_percent is greater
+ *                                         than \p max_redundancy_ratio_percent
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_stream_multi_set_auto_redundancy( uint8_t stack_id, uint8_t stream_id,
+                                                                      bool    enabled,
+                                                                      uint8_t min_redundancy_ratio_percent,
+                                                                      uint8_t max_redundancy_ratio_percent );
+
 /**
  * @brief Create and initialize a file upload session
  *
@@ -2073,6 +2926,45 @@ smtc_modem_return_code_t smtc_modem_dm_get_user_data( uint8_t stack_id,
  * */
 smtc_modem_return_code_t smtc_modem_dm_handle_alcsync( uint8_t stack_id, bool handle_alcsync );
 
+/**
+ * @brief Set the change needed to report a numeric field in the periodic Device Management (DM) frames
+ *
+ * @remark Only available if the modem is built with change driven DM reporting (LBM_DM_DELTA). A periodic DM frame
+ * only contains the fields that changed since they were last reported, and is skipped when none did. A numeric field
+ * is reported once its value moved by more than \p threshold, expressed in the unit of the field (see @ref
+ * SMTC_MODEM_DM_INFO_DEF, RSSI only for @ref SMTC_MODEM_DM_FIELD_SIGNAL). The other fields are reported on any change
+ *
+ * @param [in] stack_id                 Stack identifier
+ * @param [in] dm_field                 Numeric DM info field: charge, voltage, temperature, signal, up time or rx time
+ * @param [in] threshold                Change threshold
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       \p dm_field has no threshold
+ * @retval SMTC_MODEM_RC_BUSY          Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL          Change driven DM reporting is not built
+ */
+smtc_modem_return_code_t smtc_modem_dm_set_info_threshold( uint8_t stack_id, smtc_modem_dm_field_t dm_field,
+                                                           uint16_t threshold );
+
+/**
+ * @brief Set the number of DM intervals between two complete periodic Device Management (DM) frames
+ *
+ * @remark Only available if the modem is built with change driven DM reporting (LBM_DM_DELTA). Every \p
+ * nb_of_intervals intervals, all the fields set with @ref smtc_modem_dm_set_periodic_info_fields are reported whether
+ * they changed or not (default: 24)
+ *
+ * @param [in] stack_id                 Stack identifier
+ * @param [in] nb_of_intervals          Number of DM intervals, 1 reports all the fields at every interval
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       \p nb_of_intervals is 0
+ * @retval SMTC_MODEM_RC_BUSY          Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL          Change driven DM reporting is not built
+ */
+smtc_modem_return_code_t smtc_modem_dm_set_keepalive( uint8_t stack_id, uint8_t nb_of_intervals );
+
 /*
  * -----------------------------------------------------------------------------
  * ----------- MISCELLANEOUS MODEM FUNCTIONS -----------------------------------
@@ -2107,6 +2999,58 @@ smtc_modem_return_code_t smtc_modem_store_and_forward_set_state( uint8_t
 smtc_modem_return_code_t smtc_modem_store_and_forward_get_state( uint8_t                               stack_id,
                                                                  smtc_modem_store_and_forward_state_t* state );
 
+/**
+ * @brief Enable or disable the aggregation of the data stored by the store and forward service
+ *
+ * When enabled, the oldest stored data and the following ones are packed together as long as they fit in the next
+ * uplink payload, and sent on \p fport. The aggregated payload is a version byte (1) and the age in seconds of the
+ * first data at transmission, followed by the data. Each data is its FPort, the number of seconds elapsed since the
+ * previous data was stored, its length and its bytes. Ages and elapsed times are little endian base 128 varints (7 bits
+ * per byte, bit 7 set when another byte follows). The data of an aggregated uplink are acknowledged together. When
+ * only one data fits, it is sent unchanged on its own FPort.
+ *
+ * @remark Elapsed times use the modem time base: data stored before a reset are reported with a null elapsed time
+ *
+ * @param [in] stack_id Stack identifier
+ * @param [in] enabled  Aggregation state
+ * @param [in] fport    LoRaWAN FPort of the aggregated uplinks
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p fport is out of the [1:223] range or equal to the DM LoRaWAN FPort
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_store_and_forward_set_aggregation( uint8_t stack_id, bool enabled, uint8_t fport );
+
+/**
+ * @brief Enable or disable the forward error correction of the data sent by the store and forward service
+ *
+ * When enabled, the stored data are sent unconfirmed on \p fport in blocks of up to \p nb_data uplinks, followed by
+ * \p nb_parity parity uplinks. The network server rebuilds up to \p nb_parity lost uplinks of a block from the
+ * others, without downlink. A block is closed when full or when no more data is stored. The data of a block are
+ * deleted once its parity is sent. Data too long to fit with the FEC header are sent unchanged. The uplink layout
+ * is described in the store and forward README.
+ *
+ * @remark Requires the LBM_STORE_AND_FORWARD_FEC build option
+ *
+ * @param [in] stack_id   Stack identifier
+ * @param [in] enabled    FEC state
+ * @param [in] fport      LoRaWAN FPort of the FEC uplinks
+ * @param [in] nb_data    Maximum number of data uplinks in a block, from 1 to 64
+ * @param [in] nb_parity  Number of parity uplinks of a block, from 1 to 4
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p fport is out of the [1:223] range or equal to the DM LoRaWAN FPort, or
+ *                                         \p nb_data or \p nb_parity is out of range
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_FAIL              FEC not built in
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_store_and_forward_set_fec( uint8_t stack_id, bool enabled, uint8_t fport,
+                                                               uint8_t nb_data, uint8_t nb_parity );
+
 /**
  * @brief Add data to the store and forward service
  *
@@ -2142,8 +3086,8 @@ smtc_modem_return_code_t smtc_modem_store_and_forward_flash_clear_data( uint8_t
  * @brief Get the fifo capacity and the number of free slots before data loss by overwriting the slot already in use
  *
  * @param [in]  stack_id  Stack identifier
- * @param [out] capacity  Capacity of the fifo (number of slot)
- * @param [out] free_slot Number of free slots
+ * @param [out] capacity  Capacity of the fifo (number of slot, a slot holds a maximum-size entry)
+ * @param [out] free_slot Number of free slots, entries shorter than the maximum size use less than one slot
  *
  * @return Modem return code as defined in @ref smtc_modem_return_code_t
  * @retval SMTC_MODEM_RC_OK                Command executed without errors
@@ -121,6 +121,16 @@ typedef enum
     SMTC_MODEM_WIFI_PAYLOAD_MAC_RSSI = 0x01,  //!< Both MAC address and RSSI of detected Access Points are sent
 } smtc_modem_wifi_payload_format_t;
 
+/**
+ * @brief GNSS payload format
+ */
+typedef enum
+{
+    SMTC_MODEM_GNSS_PAYLOAD_NAV = 0x00,  //!< Each NAV message of a scan group is sent in its own uplink
+    SMTC_MODEM_GNSS_PAYLOAD_NAV_PACKED =
+        0x01,  //!< The NAV messages of a scan group are packed in as few uplinks as the current datarate allows
+} smtc_modem_gnss_payload_format_t;
+
 /**
  * @brief The configuration context in which a scan has been performed.
  */
@@ -309,6 +319,49 @@ smtc_modem_return_code_t smtc_modem_gnss_set_port( uint8_t stack_id, uint8_t por
  */
 void smtc_modem_gnss_scan_aggregate( uint8_t stack_id, bool aggregate );
 
+/**
+ * @brief Adapt the GNSS scans of a scan group to the current conditions instead of always running the number of
+ * scans of the selected mode
+ *
+ * When enabled:
+ * - a scan detecting less than 3 SVs ends the scan group, the next scan would face the same sky;
+ * - an assisted scan detecting at least GNSS_SCAN_ADAPTIVE_GOOD_NB_SVS SVs (default 8) ends the scan group, another
+ *   scan would not improve the position much;
+ * - when the almanac demodulation service reports that the almanac of one constellation is outdated and the other
+ *   one is up to date, assisted scans only use the up to date constellation;
+ * - the radio planner reserves the autonomous scan duration when the last assisted scan is older than
+ *   GNSS_SCAN_ADAPTIVE_ASSISTANCE_MAX_AGE_S (default 6 hours).
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [in] adaptive     Boolean to adapt or not
+ *
+ * By default it is set to false
+ */
+void smtc_modem_gnss_scan_adaptive( uint8_t stack_id, bool adaptive );
+
+/**
+ * @brief Refresh the GNSS assistance position from the positions sent back by the geolocation solver
+ *
+ * The positions received on the given port are kept as assistance position for the next GNSS scan when their accuracy
+ * is lower than max_accuracy_m, whatever the kind of scan they were computed from (GNSS or Wi-Fi). The downlink payload
+ * is | latitude (4) | longitude (4) | accuracy (2) |, big endian, latitude and longitude are signed in 1e-6 degree and
+ * the accuracy is in meters. These downlinks are still given to the application.
+ *
+ * The LoRa Cloud solver updates (DM_SOLV_UPDATE on the device management port) are always pushed to the LR11xx on
+ * the next GNSS scan.
+ *
+ * @param [in] stack_id         Stack identifier
+ * @param [in] port             Port of the position downlinks, 0 to disable
+ * @param [in] max_accuracy_m   Maximum accuracy of a position to be used, in meters
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK         Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID    Forbidden port
+ *
+ * By default it is disabled, with a maximum accuracy of GNSS_SCAN_SOLVER_POSITION_MAX_ACCURACY_M (default 10 km)
+ */
+smtc_modem_return_code_t smtc_modem_gnss_set_solver_port( uint8_t stack_id, uint8_t port, uint16_t max_accuracy_m );
+
 /**
  * @brief Select the send mode of the "scan & send" sequence, by default the scan groups are sent by direct LoRaWAN
  * uplinks but it can be replace by the store and forward service, or be bypassed (no send).
@@ -323,6 +376,22 @@ void smtc_modem_gnss_scan_aggregate( uint8_t stack_id, bool aggregate );
  */
 smtc_modem_return_code_t smtc_modem_gnss_send_mode( uint8_t stack_id, smtc_modem_geolocation_send_mode_t send_mode );
 
+/**
+ * @brief Set the format of the GNSS scan group uplinks: one NAV message per uplink, or NAV messages packed together
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [in] format       Payload format to be used
+ *
+ * With SMTC_MODEM_GNSS_PAYLOAD_NAV_PACKED, consecutive NAV messages of a scan group which fit in the maximum payload
+ * of the next uplink are sent together. A packed uplink starts with one metadata byte shared by all its NAV messages
+ * (last flag of its last NAV message, bit 6 set, scan group token), followed for each NAV message by its size in one
+ * byte and the NAV message itself. An uplink carrying a single NAV message keeps the SMTC_MODEM_GNSS_PAYLOAD_NAV
+ * format. The packing only applies to SMTC_MODEM_SEND_MODE_UPLINK.
+ *
+ * By default it is configured for using SMTC_MODEM_GNSS_PAYLOAD_NAV format
+ */
+void smtc_modem_gnss_set_payload_format( uint8_t stack_id, smtc_modem_gnss_payload_format_t format );
+
 /**
  * @brief Start the GNSS almanac demodulation service. This allows the internal almanac to be updated without any
  * connection to any cloud service.
@@ -450,6 +519,22 @@ smtc_modem_return_code_t smtc_modem_wifi_send_mode( uint8_t stack_id, smtc_modem
  */
 void smtc_modem_wifi_set_payload_format( uint8_t stack_id, smtc_modem_wifi_payload_format_t format );
 
+/**
+ * @brief Do not send the Wi-Fi scans which bring no significant change compared to the last scan sent
+ *
+ * @param [in] stack_id             Stack identifier
+ * @param [in] rssi_hysteresis_db   RSSI change in dB of a reported Access Point which makes a scan sent, 0 to disable
+ * @param [in] max_nb_skipped       Maximum number of consecutive scans not sent, the next one is always sent
+ *
+ * A scan is not sent when it has at least 3 fix Access Points, all of them heard in the last scan sent with a RSSI
+ * which has not changed by more than rssi_hysteresis_db. Access Points seen as mobile by the LR11xx are ignored.
+ * The SMTC_MODEM_EVENT_WIFI_SCAN_DONE event is still sent, followed by a SMTC_MODEM_EVENT_WIFI_TERMINATED event
+ * with no scan sent.
+ *
+ * By default the filter is disabled
+ */
+void smtc_modem_wifi_set_unchanged_scan_filter( uint8_t stack_id, uint8_t rssi_hysteresis_db, uint8_t max_nb_skipped );
+
 #ifdef __cplusplus
 }
 #endif
@@ -186,6 +186,36 @@ smtc_modem_return_code_t smtc_modem_relay_tx_enable( uint8_t
  */
 smtc_modem_return_code_t smtc_modem_relay_tx_disable( uint8_t stack_id );
 
+/**
+ * @brief Send uplinks through the relay without listening to the WOR ACK
+ *
+ * While the end-device is synchronised with a relay that accepts to forward, the next \p nb_uplink uplinks reuse the
+ * relay timing of the last WOR ACK and are sent without opening the WOR ACK reception window. The following WOR ACK is
+ * received again to keep the synchronisation. An uplink lost because the relay missed the WOR is not detected.
+ *
+ * @param[in]   stack_id    Stack identifier
+ * @param[in]   nb_uplink   Number of uplinks between two received WOR ACK (0, the default: always listen)
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_BUSY              Modem is currently in test mode
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_relay_tx_set_ack_free_uplinks( uint8_t stack_id, uint8_t nb_uplink );
+
+/**
+ * @brief Get the number of uplinks sent through the relay without listening to the WOR ACK
+ *
+ * @param[in]   stack_id    Stack identifier
+ * @param[out]  nb_uplink   Number of uplinks between two received WOR ACK
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK                Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID           \p nb_uplink is NULL
+ * @retval SMTC_MODEM_RC_INVALID_STACK_ID  Invalid \p stack_id
+ */
+smtc_modem_return_code_t smtc_modem_relay_tx_get_ack_free_uplinks( uint8_t stack_id, uint8_t* nb_uplink );
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,6 +60,28 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Maximum number of channels of a spectral survey, sizes the survey results kept by the modem
+ */
+#ifndef SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS
+#define SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS 64
+#endif
+
+/**
+ * @brief Maximum listening time of a spectral survey on each channel
+ */
+#define SMTC_MODEM_TEST_SURVEY_MAX_DWELL_MS 1000
+
+/**
+ * @brief Maximum number of radio configurations of a packet error rate test
+ */
+#define SMTC_MODEM_TEST_PER_MAX_CONFIGS 16
+
+/**
+ * @brief Header of the packets of a packet error rate test: "PE", configuration index, packet counter (2, big endian)
+ */
+#define SMTC_MODEM_TEST_PER_HEADER_SIZE 5
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -72,6 +94,43 @@ typedef enum smtc_modem_test_mode_sync_word_e
     SYNC_WORD_0x56 = 0x56,
 } smtc_modem_test_mode_sync_word_t;
 
+/**
+ * @brief RSSI statistics of a channel measured by a spectral survey, the RSSI are clamped to [-128, 0] dBm
+ */
+typedef struct smtc_modem_test_survey_result_s
+{
+    int8_t   rssi_min_dbm;         //!< Lowest RSSI
+    int8_t   rssi_avg_dbm;         //!< Average RSSI
+    int8_t   rssi_max_dbm;         //!< Highest RSSI
+    int8_t   rssi_percentile_dbm;  //!< RSSI not exceeded by the requested percentage of the samples
+    uint16_t nb_samples;           //!< Number of RSSI samples, 0 if the channel was not measured
+} smtc_modem_test_survey_result_t;
+
+/**
+ * @brief Radio configuration of a packet error rate test
+ */
+typedef struct smtc_modem_test_per_config_s
+{
+    ral_lora_sf_t sf;            //!< LoRa spreading factor
+    ral_lora_bw_t bw;            //!< LoRa bandwidth
+    int8_t        tx_power_dbm;  //!< Transmit power, used by the transmitter only
+} smtc_modem_test_per_config_t;
+
+/**
+ * @brief Statistics of a radio configuration of a packet error rate test, measured by the receiver
+ */
+typedef struct smtc_modem_test_per_result_s
+{
+    uint16_t nb_received;   //!< Packets received, the PER is 1 - nb_received / nb_packets
+    int16_t  rssi_min_dbm;  //!< Lowest packet RSSI
+    int16_t  rssi_avg_dbm;  //!< Average packet RSSI
+    int16_t  rssi_max_dbm;  //!< Highest packet RSSI
+    int8_t   snr_min_db;    //!< Lowest packet SNR
+    int8_t   snr_avg_db;    //!< Average packet SNR
+    int8_t   snr_max_db;    //!< Highest packet SNR
+    uint32_t goodput_bps;   //!< Payload bits received per second of the time given to the configuration
+} smtc_modem_test_per_result_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -256,6 +315,77 @@ smtc_modem_return_code_t smtc_modem_test_rssi_lbt( uint32_t frequency_hz, uint32
  */
 smtc_modem_return_code_t smtc_modem_test_get_rssi( int8_t* rssi );
 
+/**
+ * @brief Test mode spectral survey
+ * @remark Measure the instantaneous RSSI as fast as the radio allows on each channel in turn, the statistics are
+ * computed on the device and kept until the next survey. SMTC_MODEM_EVENT_TEST_MODE is raised with
+ * SMTC_MODEM_EVENT_TEST_MODE_SURVEY_DONE once every channel has been measured, or with
+ * SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED if the survey has been interrupted.
+ *
+ * @param [in] frequencies_hz  Channel frequencies in Hz, copied by the modem
+ * @param [in] nb_channels     Number of channels, from 1 to SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS
+ * @param [in] dwell_ms        Listening time on each channel, from 1 to SMTC_MODEM_TEST_SURVEY_MAX_DWELL_MS
+ * @param [in] bw_hz           Measurement bandwidth in Hz
+ * @param [in] percentile      Percentage of the samples reported by rssi_percentile_dbm, from 1 to 99
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_survey_start( const uint32_t* frequencies_hz, uint8_t nb_channels,
+                                                       uint16_t dwell_ms, uint32_t bw_hz, uint8_t percentile );
+
+/**
+ * @brief Get the spectral survey results (to be called when the survey is finished)
+ *
+ * @param [in]  first_channel  Index of the first channel to read in the list given to smtc_modem_test_survey_start
+ * @param [out] results        Statistics of the channels, in the order of the list
+ * @param [in]  max_results    Number of entries of results
+ * @param [out] nb_results     Number of channels read
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_BUSY     The survey is not finished
+ * @retval SMTC_MODEM_RC_INVALID  Not in test mode, or first_channel beyond the list
+ */
+smtc_modem_return_code_t smtc_modem_test_survey_get_results( uint8_t                          first_channel,
+                                                             smtc_modem_test_survey_result_t* results,
+                                                             uint8_t max_results, uint8_t* nb_results );
+
+/**
+ * @brief Test mode packet error rate, one device transmitting and one receiving the same sequence
+ * @remark For each configuration in turn, the transmitter sends nb_packets LoRa packets back to back on the radio
+ * planner timeline, each packet being followed by a 30 ms gap and each configuration by a 200 ms gap. The receiver,
+ * started first, waits for a packet of the first configuration then follows the same timeline, realigned on each
+ * received packet header: the first configuration should be the most robust one. Both devices raise
+ * SMTC_MODEM_EVENT_TEST_MODE with SMTC_MODEM_EVENT_TEST_MODE_PER_DONE at the end of the sequence, or with
+ * SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED if the test has been interrupted.
+ *
+ * @param [in] is_transmitter  True on the transmitting device, false on the receiving one
+ * @param [in] frequency_hz    Frequency in Hz
+ * @param [in] configs         Radio configurations, the same on both devices, copied by the modem
+ * @param [in] nb_configs      Number of configurations, from 1 to SMTC_MODEM_TEST_PER_MAX_CONFIGS
+ * @param [in] nb_packets      Packets per configuration, at least 1
+ * @param [in] payload_length  Packet length, from SMTC_MODEM_TEST_PER_HEADER_SIZE to 255, the same on both devices
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ */
+smtc_modem_return_code_t smtc_modem_test_per_start( bool is_transmitter, uint32_t frequency_hz,
+                                                    const smtc_modem_test_per_config_t* configs, uint8_t nb_configs,
+                                                    uint16_t nb_packets, uint8_t payload_length );
+
+/**
+ * @brief Get the packet error rate test results of the receiver (to be called when the test is finished)
+ *
+ * @param [in]  first_config  Index of the first configuration to read
+ * @param [out] results       Statistics of the configurations, in the order of the sequence
+ * @param [in]  max_results   Number of entries of results
+ * @param [out] nb_results    Number of configurations read
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_BUSY     The test is not finished
+ * @retval SMTC_MODEM_RC_INVALID  Not in test mode, not the receiver, or first_config beyond the sequence
+ */
+smtc_modem_return_code_t smtc_modem_test_per_get_results( uint8_t first_config, smtc_modem_test_per_result_t* results,
+                                                          uint8_t max_results, uint8_t* nb_results );
+
 /**
  * @brief Reset the Radio for test purpose
  * @remark
@@ -64,6 +64,11 @@ extern "C" {
  * --- PUBLIC TYPES ------------------------------------------------------------
  */
 
+/**
+ * @brief Modem instance, storage of smtc_modem_instance_get_size() bytes allocated by the application
+ */
+typedef struct smtc_modem_instance_s smtc_modem_instance_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -86,6 +91,17 @@ void smtc_modem_init( void ( *event_callback )( void ) );
  */
 uint32_t smtc_modem_run_engine( void );
 
+/**
+ * @brief Process the pending radio and radio planner timer interrupts, without running the modem services
+ * @remark For RTOS ports running the radio in a thread of higher priority than the thread calling
+ * smtc_modem_run_engine(): called each time smtc_modem_hal_user_lbm_irq() is raised, it reads the radio status,
+ * calls the task hook and launches the next radio task on time whatever the load of the engine thread. When a hook
+ * completes, the engine is notified through the callback set by smtc_modem_set_engine_wakeup_callback(). Calling
+ * smtc_modem_run_engine() alone remains valid. The modem shall be built with LBM_THREAD_SAFE=yes when both functions
+ * are called from different threads: the modem lock serializing them is not taken otherwise
+ */
+void smtc_modem_run_radio_planner( void );
+
 /**
  * @brief Check if some modem irq flags are pending
  *
@@ -93,6 +109,37 @@ uint32_t smtc_modem_run_engine( void );
  */
 bool smtc_modem_is_irq_flag_pending( void );
 
+/**
+ * @brief Set the callback notifying that smtc_modem_run_engine() has to be called before the delay it last returned
+ * @remark The callback is called when a modem task is added or updated, when a stack is resumed and when a radio
+ * planner callback completes outside of smtc_modem_run_engine(). It is called from the context of the caller of the
+ * modem API (never under interrupt, never from smtc_modem_run_engine()), an RTOS implementation can release the
+ * thread that manages the LBM stack from it instead of waking up periodically. Radio and timer interrupts are still
+ * notified by smtc_modem_hal_user_lbm_irq(). To be set after smtc_modem_init()
+ *
+ * @param [in] wakeup_callback User wakeup callback, NULL to disable the notification
+ */
+void smtc_modem_set_engine_wakeup_callback( void ( *wakeup_callback )( void ) );
+
+/**
+ * @brief Put the MCU in low power until the next modem wake-up, through smtc_modem_hal_enter_low_power()
+ * @remark Only available when the modem is built with LBM_LOW_POWER_HINT=yes. To be called in place of the MCU sleep
+ * of the main loop, with the interrupts masked and once smtc_modem_is_irq_flag_pending() returned false. The budget
+ * given to the HAL is the earliest of \p sleep_time_ms and of the modem timers, the radio planner alarm included, and
+ * the radio interrupt is announced while a radio task is running
+ *
+ * @param [in] sleep_time_ms Delay returned by smtc_modem_run_engine(), possibly reduced by the application
+ */
+void smtc_modem_enter_low_power( uint32_t sleep_time_ms );
+
+/**
+ * @brief Write the modem contexts kept in RAM in non volatile memory
+ * @remark With LBM_CONTEXT_CACHE=yes, context stores are delayed until the engine goes idle. This function shall be
+ * called on a power fail warning and before a power down or a deep sleep losing RAM content. It does nothing when the
+ * cache is disabled
+ */
+void smtc_modem_context_flush( void );
+
 /**
  * @brief Set optional user radio context that can be retrieved in radio drivers hal calls
  *
@@ -107,6 +154,48 @@ void smtc_modem_set_radio_context( const void* radio_ctx );
  */
 const void* smtc_modem_get_radio_context( void );
 
+/**
+ * @brief Get the size of a modem instance
+ * @remark Only available when the modem is built with LBM_MULTI_INSTANCE=yes. An instance holds the whole modem
+ * state: supervisor, LoRaWAN stacks, radio planner, services, secure element keys and radio driver
+ *
+ * @returns Size in bytes, 0 when the instances are not built in the modem
+ */
+uint32_t smtc_modem_instance_get_size( void );
+
+/**
+ * @brief Initialize a modem instance with the state of the modem at power up
+ * @remark The first call to @ref smtc_modem_instance_init or @ref smtc_modem_instance_select shall be done before
+ * @ref smtc_modem_init, while the modem is still in its power up state
+ *
+ * @param [out] instance Instance storage of @ref smtc_modem_instance_get_size bytes
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       \p instance is NULL
+ * @retval SMTC_MODEM_RC_FAIL          The instances are not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_instance_init( smtc_modem_instance_t* instance );
+
+/**
+ * @brief Select the modem instance the next modem calls apply to
+ * @remark Several modems run in one process, for instance to simulate many devices: each modem is initialized by
+ * @ref smtc_modem_init once selected, then the application selects the instance of a device before calling the modem
+ * API or the modem engine for it, and before calling the radio and timer callbacks of its HAL. The state of the
+ * previous instance is saved in its storage and the selected one is copied in the modem, so that a switch costs two
+ * copies of the instance size. It shall not be called from the modem callbacks. The modem is not reentrant: the
+ * instances of a process run one at a time, parallel simulations run in separate processes. The HAL is shared by the
+ * instances, it tells the devices apart with the running instance.
+ *
+ * @param [in] instance Instance initialized with @ref smtc_modem_instance_init
+ *
+ * @return Modem return code as defined in @ref smtc_modem_return_code_t
+ * @retval SMTC_MODEM_RC_OK            Command executed without errors
+ * @retval SMTC_MODEM_RC_INVALID       \p instance is NULL
+ * @retval SMTC_MODEM_RC_FAIL          The instances are not built in the modem
+ */
+smtc_modem_return_code_t smtc_modem_instance_select( smtc_modem_instance_t* instance );
+
 #ifdef __cplusplus
 }
 #endif
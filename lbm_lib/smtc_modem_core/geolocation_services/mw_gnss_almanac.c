@@ -278,9 +278,8 @@ static mw_gnss_almanac_update_status_t mw_gnss_almanac_update_status;
 /**
  * @brief Service callbacks
  */
-static void    mw_gnss_almanac_service_on_launch( void* context_callback );
-static void    mw_gnss_almanac_service_on_update( void* context_callback );
-static uint8_t mw_gnss_almanac_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
+static void mw_gnss_almanac_service_on_launch( void* context_callback );
+static void mw_gnss_almanac_service_on_update( void* context_callback );
 
 /**
  * @brief Program the next task (supervisor or radio planner)
@@ -372,7 +371,7 @@ void mw_gnss_almanac_services_init( uint8_t* service_id, uint8_t task_id,
     mw_gnss_almanac_task_obj.stack_id    = CURRENT_STACK;
     mw_gnss_almanac_task_obj.rp_hook_id  = RP_HOOK_ID_DIRECT_RP_ACCESS_GNSS_ALMANAC;
     mw_gnss_almanac_task_obj.initialized = true;
-    *downlink_callback                   = mw_gnss_almanac_service_downlink_handler;
+    *downlink_callback                   = NULL;
     *on_launch_callback                  = mw_gnss_almanac_service_on_launch;
     *on_update_callback                  = mw_gnss_almanac_service_on_update;
     *context_callback                    = ( void* ) service_id;
@@ -426,6 +425,23 @@ smtc_modem_return_code_t mw_gnss_almanac_get_event_almanac_update(
     return SMTC_MODEM_RC_OK;
 }
 
+bool mw_gnss_almanac_is_outdated( smtc_modem_gnss_constellation_t constellation )
+{
+    switch( constellation )
+    {
+    case SMTC_MODEM_GNSS_CONSTELLATION_GPS:
+        return ( mw_gnss_almanac_update_status.status_gps == SMTC_MODEM_GNSS_ALMANAC_UPDATE_STATUS_NOT_COMPLETED ) &&
+               ( mw_gnss_almanac_update_status.remaining_sv_to_be_updated_gps >
+                 ALMANAC_UPDATE_NB_SV_TO_BE_UPDATED_THRESHOLD );
+    case SMTC_MODEM_GNSS_CONSTELLATION_BEIDOU:
+        return ( mw_gnss_almanac_update_status.status_beidou == SMTC_MODEM_GNSS_ALMANAC_UPDATE_STATUS_NOT_COMPLETED ) &&
+               ( mw_gnss_almanac_update_status.remaining_sv_to_be_updated_beidou >
+                 ALMANAC_UPDATE_NB_SV_TO_BE_UPDATED_THRESHOLD );
+    default:
+        return false;
+    }
+}
+
 smtc_modem_return_code_t mw_gnss_almanac_set_constellations( smtc_modem_gnss_constellation_t constellations )
 {
     switch( constellations )
@@ -484,13 +500,6 @@ static void mw_gnss_almanac_service_on_update( void* context_callback )
     IS_SERVICE_INITIALIZED( );
 }
 
-static uint8_t mw_gnss_almanac_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
-{
-    GNSS_ALMANAC_TRACE_PRINTF_DEBUG( "mw_gnss_almanac_service_downlink_handler\n" );
-
-    return MODEM_DOWNLINK_UNCONSUMED;
-}
-
 static void mw_gnss_almanac_next( void )
 {
     if( mw_gnss_almanac_next_update.type == ALMANAC_TASK_TYPE_READ_STATUS )
@@ -804,6 +813,10 @@ static mw_return_code_t gnss_almanac_task_done( void )
     /* Get detected SVs (for info) */
     MW_RETURN_ON_FAILURE( lr11xx_gnss_get_nb_detected_satellites( modem_get_radio_ctx( ), &nb_detected_svs ) ==
                           LR11XX_STATUS_OK );
+    if( nb_detected_svs > ( 2 * GNSS_NB_SVS_PER_CONSTELLATION_MAX ) )
+    {
+        nb_detected_svs = 2 * GNSS_NB_SVS_PER_CONSTELLATION_MAX;
+    }
     if( nb_detected_svs > 0 )
     {
         MW_RETURN_ON_FAILURE( lr11xx_gnss_get_detected_satellites( modem_get_radio_ctx( ), nb_detected_svs,
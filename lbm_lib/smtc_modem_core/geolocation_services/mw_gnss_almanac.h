@@ -113,6 +113,15 @@ smtc_modem_return_code_t mw_gnss_almanac_get_event_almanac_update(
  */
 smtc_modem_return_code_t mw_gnss_almanac_set_constellations( smtc_modem_gnss_constellation_t constellations );
 
+/**
+ * @brief Indicate if the last almanac status read for a constellation has more SVs to be updated than tolerated
+ *
+ * @param [in] constellation Constellation to check (GPS or BEIDOU)
+ *
+ * @return true if the almanac of the constellation is outdated, false if it is up to date or its status is unknown
+ */
+bool mw_gnss_almanac_is_outdated( smtc_modem_gnss_constellation_t constellation );
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,10 @@
 #include "mw_gnss_defs.h"
 #include "mw_gnss_scan.h"
 #include "mw_gnss_send.h"
+#include "mw_gnss_almanac.h"
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+#include "mw_wifi_scan.h"
+#endif
 #include "geolocation_bsp.h"
 #include "mw_common.h"
 #include "gnss_helpers.h"
@@ -60,6 +64,15 @@
 #include "lr11xx_system.h"
 #include "lr11xx_gnss.h"
 
+#include "lorawan_api.h"
+#include "device_management_defs.h"
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+#include "cloud_dm_package.h"
+#endif
+#if defined( ADD_SMTC_ALC_SYNC )
+#include "lorawan_alcsync.h"
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE MACROS-----------------------------------------------------------
@@ -124,6 +137,72 @@
  */
 #define GNSS_SCAN_DURATION_AUTONOMOUS_S ( 80 )
 
+/**
+ * @brief Adaptive policy: minimum number of detected SVs for an assisted scan to complete the NAV group on its own
+ */
+#ifndef GNSS_SCAN_ADAPTIVE_GOOD_NB_SVS
+#define GNSS_SCAN_ADAPTIVE_GOOD_NB_SVS ( 8 )
+#endif
+
+/**
+ * @brief Adaptive policy: age of the last assisted scan after which the next scan is expected to be autonomous
+ */
+#ifndef GNSS_SCAN_ADAPTIVE_ASSISTANCE_MAX_AGE_S
+#define GNSS_SCAN_ADAPTIVE_ASSISTANCE_MAX_AGE_S ( 6 * 60 * 60 ) /* 6 hours */
+#endif
+
+/**
+ * @brief Time assistance: accuracy of the network time sources when just received, in milliseconds
+ *
+ * The accuracy given to the LR11xx is the source accuracy, plus the crystal drift since the time was received, plus
+ * the rounding to the second expected by lr11xx_gnss_set_time().
+ */
+#ifndef GNSS_SCAN_TIME_ACCURACY_BEACON_MS
+#define GNSS_SCAN_TIME_ACCURACY_BEACON_MS ( 2 )
+#endif
+#ifndef GNSS_SCAN_TIME_ACCURACY_DEVICE_TIME_MS
+#define GNSS_SCAN_TIME_ACCURACY_DEVICE_TIME_MS ( 20 )
+#endif
+#ifndef GNSS_SCAN_TIME_ACCURACY_ALC_SYNC_MS
+#define GNSS_SCAN_TIME_ACCURACY_ALC_SYNC_MS ( 1000 )
+#endif
+
+/**
+ * @brief Size of a position downlink of the geolocation solver, all fields big endian:
+ * | latitude (4, signed, 1e-6 degree) | longitude (4, signed, 1e-6 degree) | accuracy (2, meters) |
+ */
+#define GNSS_SCAN_SOLVER_POSITION_SIZE ( 10 )
+
+/**
+ * @brief Default maximum accuracy of a solver position to be used as assistance position, in meters
+ */
+#ifndef GNSS_SCAN_SOLVER_POSITION_MAX_ACCURACY_M
+#define GNSS_SCAN_SOLVER_POSITION_MAX_ACCURACY_M ( 10000 )
+#endif
+
+/**
+ * @brief Maximum size of a LoRa Cloud solver update (DM_SOLV_UPDATE) kept until the next scan
+ */
+#define GNSS_SCAN_SOLVER_MSG_MAX_SIZE ( 64 )
+
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+/**
+ * @brief Minimum gap between two scans of a NAV group to send the valid scans already done, in seconds
+ *
+ * It leaves room for one uplink and its RX windows before the next scan is granted the radio.
+ */
+#ifndef GNSS_SCAN_PIPELINE_MIN_GAP_S
+#define GNSS_SCAN_PIPELINE_MIN_GAP_S ( 5 )
+#endif
+
+/**
+ * @brief Minimum gap between two scans of an aggregated NAV group to run a Wi-Fi scan in between, in seconds
+ */
+#ifndef GNSS_SCAN_PIPELINE_WIFI_MIN_GAP_S
+#define GNSS_SCAN_PIPELINE_WIFI_MIN_GAP_S ( 10 )
+#endif
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -152,6 +231,7 @@ typedef struct mw_gnss_task_s
     /* current configuration */
     lr11xx_gnss_constellation_mask_t constellations_mask;
     bool                             scan_aggregate;
+    bool                             scan_adaptive;
     /* current gnss status */
     uint8_t                          current_token;
     smtc_modem_gnss_mode_t           current_mode_index;
@@ -160,6 +240,17 @@ typedef struct mw_gnss_task_s
     lr11xx_gnss_scan_mode_launched_t last_scan_mode;
     bool                             pending_evt_scan_done;
     bool                             last_navgroup_valid;
+    uint32_t                         last_assisted_scan_time_s;
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+    uint8_t nb_scans_pipelined;  //!< Number of valid scans of the NAV group already handed to the send service
+#endif
+    /* assistance position refresh from the solver downlinks, applied on next scan */
+    uint8_t                                  solver_port;
+    uint16_t                                 solver_max_accuracy_m;
+    bool                                     pending_assistance_position;
+    lr11xx_gnss_solver_assistance_position_t assistance_position;
+    uint8_t                                  solver_msg[GNSS_SCAN_SOLVER_MSG_MAX_SIZE];
+    uint8_t                                  solver_msg_size;
 } mw_gnss_task_t;
 
 /*
@@ -193,8 +284,12 @@ static gnss_mw_mode_desc_t modes[__SMTC_MODEM_GNSS_MODE__SIZE] = {
 /**
  * @brief Service callbacks
  */
-static void    mw_gnss_scan_service_on_launch( void* context_callback );
-static void    mw_gnss_scan_service_on_update( void* context_callback );
+static void mw_gnss_scan_service_on_launch( void* context_callback );
+static void mw_gnss_scan_service_on_update( void* context_callback );
+
+/**
+ * @brief Downlink handler of the service, keeping the solver positions and updates for the next scan
+ */
 static uint8_t mw_gnss_scan_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
 
 /**
@@ -217,6 +312,53 @@ static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete );
  */
 static void gnss_scan_next( uint32_t delay_s );
 
+/**
+ * @brief Give the LR11xx the most accurate network time known by the modem, if better than its own time
+ *
+ * With a known time, the LR11xx can run an assisted scan instead of an autonomous scan with time demodulation.
+ */
+static void gnss_scan_set_time_assistance( void );
+
+/**
+ * @brief Give the LR11xx the assistance position and the solver update received since the previous scan
+ */
+static void gnss_scan_set_position_assistance( void );
+
+/**
+ * @brief Read a big endian 32 bits field of a downlink
+ */
+static uint32_t gnss_scan_read_u32_be( const uint8_t* buffer );
+
+/**
+ * @brief Keep a time source if it is more accurate than the best one found so far
+ *
+ * @param [in]     gps_time_s        GPS time of the source, in seconds
+ * @param [in]     fractional_ms     Fractional part of the GPS time, in milliseconds
+ * @param [in]     accuracy_ms       Accuracy of the source, drift included, in milliseconds
+ * @param [in,out] best_gps_time_s   GPS time rounded to the second of the best source
+ * @param [in,out] best_accuracy_ms  Accuracy of the best source, rounding included
+ */
+static void gnss_scan_keep_best_time( uint32_t gps_time_s, uint32_t fractional_ms, uint32_t accuracy_ms,
+                                      uint32_t* best_gps_time_s, uint32_t* best_accuracy_ms );
+
+/**
+ * @brief Expected duration of the next scan, in seconds
+ */
+static uint32_t gnss_scan_duration_s( void );
+
+/**
+ * @brief Constellations to be used by the next scan
+ */
+static lr11xx_gnss_constellation_mask_t gnss_scan_constellations( void );
+
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+/**
+ * @brief Use the gap before the next scan of the NAV group to send the valid scans already done and, for aggregated
+ * NAV groups, to run a Wi-Fi scan
+ */
+static void gnss_scan_pipeline( uint32_t gap_s );
+#endif
+
 /**
  * @brief Send an event to user to notify for progress
  */
@@ -275,7 +417,8 @@ void mw_gnss_scan_services_init( uint8_t* service_id, uint8_t task_id,
                   modem_get_rp( ) );
 
     /* Configuration */
-    mw_gnss_task_obj.constellations_mask = LR11XX_GNSS_GPS_MASK | LR11XX_GNSS_BEIDOU_MASK;
+    mw_gnss_task_obj.constellations_mask   = LR11XX_GNSS_GPS_MASK | LR11XX_GNSS_BEIDOU_MASK;
+    mw_gnss_task_obj.solver_max_accuracy_m = GNSS_SCAN_SOLVER_POSITION_MAX_ACCURACY_M;
 
     /* Scan context */
     mw_gnss_task_obj.current_token =
@@ -308,6 +451,10 @@ smtc_modem_return_code_t mw_gnss_scan_add_task( smtc_modem_gnss_mode_t mode, uin
     /* Clear pending events */
     mw_gnss_task_obj.pending_evt_scan_done = false;
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+    mw_gnss_task_obj.nb_scans_pipelined = 0;
+#endif
+
     /* Increment NAV group token if needed */
     if( ( mw_gnss_task_obj.last_navgroup_valid == true ) && ( mw_gnss_task_obj.scan_aggregate == false ) )
     {
@@ -351,6 +498,21 @@ void mw_gnss_scan_aggregate( bool aggregate )
     }
 }
 
+void mw_gnss_scan_adaptive( bool adaptive )
+{
+    SMTC_MODEM_HAL_TRACE_PRINTF( "mw_gnss_scan_adaptive(%d)\n", adaptive );
+
+    mw_gnss_task_obj.scan_adaptive = adaptive;
+}
+
+void mw_gnss_set_solver_port( uint8_t port, uint16_t max_accuracy_m )
+{
+    SMTC_MODEM_HAL_TRACE_PRINTF( "mw_gnss_set_solver_port(%d, %u m)\n", port, max_accuracy_m );
+
+    mw_gnss_task_obj.solver_port           = port;
+    mw_gnss_task_obj.solver_max_accuracy_m = max_accuracy_m;
+}
+
 smtc_modem_return_code_t mw_gnss_get_event_data_scan_done( smtc_modem_gnss_event_data_scan_done_t* data )
 {
     if( data == NULL )
@@ -448,10 +610,7 @@ static void mw_gnss_scan_service_on_launch( void* context_callback )
     rp_task.hook_id          = mw_gnss_task_obj.rp_hook_id;
     rp_task.state            = RP_TASK_STATE_ASAP;
     rp_task.start_time_ms    = time_ms;
-    rp_task.duration_time_ms = ( ( mw_gnss_task_obj.last_scan_mode == LR11XX_GNSS_LAST_SCAN_MODE_ASSISTED )
-                                     ? GNSS_SCAN_DURATION_ASSISTED_S
-                                     : GNSS_SCAN_DURATION_AUTONOMOUS_S ) *
-                               1000;
+    rp_task.duration_time_ms = gnss_scan_duration_s( ) * 1000;
     rp_task.type                           = RP_TASK_TYPE_GNSS_SNIFF;
     rp_task.launch_task_callbacks          = gnss_rp_task_launch;
     rp_radio_params_t fake_rp_radio_params = { 0 };
@@ -467,18 +626,73 @@ static void mw_gnss_scan_service_on_launch( void* context_callback )
     }
 }
 
-static void mw_gnss_scan_service_on_update( void* context_callback )
+static uint8_t mw_gnss_scan_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
 {
-    GNSS_SCAN_TRACE_PRINTF_DEBUG( "mw_gnss_scan_service_on_update\n" );
+    if( ( mw_gnss_task_obj.initialized == false ) || ( rx_down_data->stack_id != mw_gnss_task_obj.stack_id ) ||
+        ( rx_down_data->rx_metadata.rx_window == RECEIVE_NONE ) ||
+        ( rx_down_data->rx_metadata.rx_fport_present == false ) )
+    {
+        return MODEM_DOWNLINK_UNCONSUMED;
+    }
 
-    IS_SERVICE_INITIALIZED( );
+    uint8_t dm_port;
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+    dm_port = cloud_dm_get_dm_port( mw_gnss_task_obj.stack_id );
+#else
+    dm_port = DM_PORT;
+#endif
+
+    /* LoRa Cloud solver update (assistance position, xtal update...), the up_count/up_delay header is handled by the
+     * cloud device management service */
+    if( ( rx_down_data->rx_metadata.rx_fport == dm_port ) &&
+        ( rx_down_data->rx_payload_size > DM_DOWNLINK_HEADER_LENGTH ) &&
+        ( ( dm_opcode_t ) rx_down_data->rx_payload[2] == DM_SOLV_UPDATE ) )
+    {
+        uint8_t solver_msg_size = rx_down_data->rx_payload_size - DM_DOWNLINK_HEADER_LENGTH;
+        if( solver_msg_size > GNSS_SCAN_SOLVER_MSG_MAX_SIZE )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "GNSS solver update too long (%d bytes)\n", solver_msg_size );
+            return MODEM_DOWNLINK_UNCONSUMED;
+        }
+        memcpy( mw_gnss_task_obj.solver_msg, &rx_down_data->rx_payload[DM_DOWNLINK_HEADER_LENGTH], solver_msg_size );
+        mw_gnss_task_obj.solver_msg_size = solver_msg_size;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "GNSS solver update received, pushed on next scan\n" );
+        return MODEM_DOWNLINK_CONSUMED;
+    }
+
+    /* Position computed by the geolocation solver from any kind of scan (GNSS, Wi-Fi) */
+    if( ( mw_gnss_task_obj.solver_port != 0 ) &&
+        ( rx_down_data->rx_metadata.rx_fport == mw_gnss_task_obj.solver_port ) &&
+        ( rx_down_data->rx_payload_size == GNSS_SCAN_SOLVER_POSITION_SIZE ) )
+    {
+        int32_t  latitude   = ( int32_t ) gnss_scan_read_u32_be( &rx_down_data->rx_payload[0] );
+        int32_t  longitude  = ( int32_t ) gnss_scan_read_u32_be( &rx_down_data->rx_payload[4] );
+        uint16_t accuracy_m = ( uint16_t ) ( ( rx_down_data->rx_payload[8] << 8 ) | rx_down_data->rx_payload[9] );
+
+        if( ( accuracy_m > mw_gnss_task_obj.solver_max_accuracy_m ) || ( latitude < -90000000 ) ||
+            ( latitude > 90000000 ) || ( longitude < -180000000 ) || ( longitude > 180000000 ) )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "Solver position discarded (accuracy %u m)\n", accuracy_m );
+        }
+        else
+        {
+            mw_gnss_task_obj.assistance_position.latitude  = ( float ) latitude / 1000000.0f;
+            mw_gnss_task_obj.assistance_position.longitude = ( float ) longitude / 1000000.0f;
+            mw_gnss_task_obj.pending_assistance_position   = true;
+            smtc_gnss_trace_print_position( "Solver position", &mw_gnss_task_obj.assistance_position );
+        }
+        /* The application gets the position as well */
+        return MODEM_DOWNLINK_UNCONSUMED;
+    }
+
+    return MODEM_DOWNLINK_UNCONSUMED;
 }
 
-static uint8_t mw_gnss_scan_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
+static void mw_gnss_scan_service_on_update( void* context_callback )
 {
-    GNSS_SCAN_TRACE_PRINTF_DEBUG( "mw_gnss_scan_service_downlink_handler\n" );
+    GNSS_SCAN_TRACE_PRINTF_DEBUG( "mw_gnss_scan_service_on_update\n" );
 
-    return MODEM_DOWNLINK_UNCONSUMED;
+    IS_SERVICE_INITIALIZED( );
 }
 
 static void gnss_scan_next( uint32_t delay_s )
@@ -492,10 +706,7 @@ static void gnss_scan_next( uint32_t delay_s )
     rp_task.hook_id          = mw_gnss_task_obj.rp_hook_id;
     rp_task.state            = RP_TASK_STATE_ASAP;
     rp_task.start_time_ms    = time_ms + delay_ms;
-    rp_task.duration_time_ms = ( ( mw_gnss_task_obj.last_scan_mode == LR11XX_GNSS_LAST_SCAN_MODE_ASSISTED )
-                                     ? GNSS_SCAN_DURATION_ASSISTED_S
-                                     : GNSS_SCAN_DURATION_AUTONOMOUS_S ) *
-                               1000;
+    rp_task.duration_time_ms = gnss_scan_duration_s( ) * 1000;
     rp_task.type                           = RP_TASK_TYPE_GNSS_SNIFF;
     rp_task.launch_task_callbacks          = gnss_rp_task_launch;
     rp_radio_params_t fake_rp_radio_params = { 0 };
@@ -639,8 +850,7 @@ static void gnss_rp_task_launch( void* context )
         return;
     }
 
-    lr11xx_status =
-        lr11xx_gnss_set_constellations_to_use( modem_get_radio_ctx( ), mw_gnss_task_obj.constellations_mask );
+    lr11xx_status = lr11xx_gnss_set_constellations_to_use( modem_get_radio_ctx( ), gnss_scan_constellations( ) );
     if( lr11xx_status != LR11XX_STATUS_OK )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "gnss_rp_task_launch: Failed to set constellations\n" );
@@ -680,6 +890,9 @@ static void gnss_rp_task_launch( void* context )
         return;
     }
 
+    gnss_scan_set_time_assistance( );
+    gnss_scan_set_position_assistance( );
+
     /* Start scan */
     uint8_t scan_parameters = LR11XX_GNSS_RESULTS_DOPPLER_ENABLE_MASK | LR11XX_GNSS_RESULTS_DOPPLER_MASK |
                               LR11XX_GNSS_RESULTS_DEMODULATE_TIME_MASK;
@@ -694,6 +907,131 @@ static void gnss_rp_task_launch( void* context )
     }
 }
 
+static void gnss_scan_set_time_assistance( void )
+{
+    uint8_t  stack_id         = mw_gnss_task_obj.stack_id;
+    uint32_t now_ms           = smtc_modem_hal_get_time_in_ms( );
+    uint32_t crystal_ppm      = lorawan_api_get_crystal_error( stack_id );
+    uint32_t best_gps_time_s  = 0;
+    uint32_t best_accuracy_ms = UINT32_MAX;
+    uint32_t gps_time_s;
+    uint32_t fractional_ms;
+
+    /* LoRaWAN DeviceTimeAns */
+    uint32_t device_time_ans_s = lorawan_api_get_timestamp_last_device_time_ans_s( stack_id );
+    if( ( device_time_ans_s != 0 ) &&
+        ( lorawan_api_convert_rtc_to_gps_epoch_time( now_ms, &gps_time_s, &fractional_ms, stack_id ) == true ) )
+    {
+        uint32_t age_s = ( now_ms / 1000 ) - device_time_ans_s;
+        gnss_scan_keep_best_time( gps_time_s, fractional_ms,
+                                  GNSS_SCAN_TIME_ACCURACY_DEVICE_TIME_MS + ( ( age_s * crystal_ppm ) / 1000 ),
+                                  &best_gps_time_s, &best_accuracy_ms );
+    }
+
+#if defined( ADD_SMTC_ALC_SYNC )
+    /* Application layer clock synchronization, 1 second resolution */
+    uint32_t correction_age_s;
+    if( ( lorawan_alcsync_get_gps_time_second( stack_id, &gps_time_s ) == ALC_SYNC_OK ) &&
+        ( lorawan_alcsync_get_correction_age_s( stack_id, &correction_age_s ) == ALC_SYNC_OK ) )
+    {
+        gnss_scan_keep_best_time( gps_time_s, 0,
+                                  GNSS_SCAN_TIME_ACCURACY_ALC_SYNC_MS + ( ( correction_age_s * crystal_ppm ) / 1000 ),
+                                  &best_gps_time_s, &best_accuracy_ms );
+    }
+#endif
+
+#if defined( ADD_CLASS_B )
+    /* Class B beacon, sent at the exact GPS second it carries */
+    uint32_t beacon_age_ms;
+    if( lorawan_api_beacon_get_gps_time( now_ms, &gps_time_s, &fractional_ms, &beacon_age_ms, stack_id ) == true )
+    {
+        gnss_scan_keep_best_time(
+            gps_time_s, fractional_ms,
+            GNSS_SCAN_TIME_ACCURACY_BEACON_MS + ( uint32_t ) ( ( ( uint64_t ) beacon_age_ms * crystal_ppm ) / 1000000 ),
+            &best_gps_time_s, &best_accuracy_ms );
+    }
+#endif
+
+    if( best_accuracy_ms > UINT16_MAX )
+    {
+        GNSS_SCAN_TRACE_PRINTF_DEBUG( "No network time accurate enough for GNSS time assistance\n" );
+        return;
+    }
+
+    /* Do not overwrite a more accurate time kept by the LR11xx, from a previous time demodulation for instance */
+    lr11xx_gnss_time_t lr11xx_time;
+    if( ( lr11xx_gnss_read_time( modem_get_radio_ctx( ), &lr11xx_time ) == LR11XX_STATUS_OK ) &&
+        ( lr11xx_time.error_code == LR11XX_GNSS_READ_TIME_STATUS_NO_ERROR ) &&
+        ( ( lr11xx_time.time_accuracy / 1000 ) <= best_accuracy_ms ) )
+    {
+        GNSS_SCAN_TRACE_PRINTF_DEBUG( "LR11xx time accuracy %u ms better than network time accuracy %u ms\n",
+                                      lr11xx_time.time_accuracy / 1000, best_accuracy_ms );
+        return;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "GNSS time assistance: %u s, accuracy %u ms\n", best_gps_time_s, best_accuracy_ms );
+    if( lr11xx_gnss_set_time( modem_get_radio_ctx( ), best_gps_time_s, ( uint16_t ) best_accuracy_ms ) !=
+        LR11XX_STATUS_OK )
+    {
+        /* Not blocking, the LR11xx falls back on time demodulation */
+        SMTC_MODEM_HAL_TRACE_WARNING( "gnss_rp_task_launch: Failed to set time assistance\n" );
+    }
+}
+
+static void gnss_scan_set_position_assistance( void )
+{
+    if( mw_gnss_task_obj.solver_msg_size > 0 )
+    {
+        if( lr11xx_gnss_push_solver_msg( modem_get_radio_ctx( ), mw_gnss_task_obj.solver_msg,
+                                         mw_gnss_task_obj.solver_msg_size ) != LR11XX_STATUS_OK )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "gnss_rp_task_launch: Failed to push solver update\n" );
+        }
+        mw_gnss_task_obj.solver_msg_size = 0;
+    }
+
+    if( mw_gnss_task_obj.pending_assistance_position == true )
+    {
+        if( lr11xx_gnss_set_assistance_position( modem_get_radio_ctx( ), &mw_gnss_task_obj.assistance_position ) !=
+            LR11XX_STATUS_OK )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "gnss_rp_task_launch: Failed to set assistance position\n" );
+        }
+        else
+        {
+            smtc_gnss_trace_print_position( "Assistance position set", &mw_gnss_task_obj.assistance_position );
+        }
+        mw_gnss_task_obj.pending_assistance_position = false;
+    }
+}
+
+static uint32_t gnss_scan_read_u32_be( const uint8_t* buffer )
+{
+    return ( ( uint32_t ) buffer[0] << 24 ) | ( ( uint32_t ) buffer[1] << 16 ) | ( ( uint32_t ) buffer[2] << 8 ) |
+           buffer[3];
+}
+
+static void gnss_scan_keep_best_time( uint32_t gps_time_s, uint32_t fractional_ms, uint32_t accuracy_ms,
+                                      uint32_t* best_gps_time_s, uint32_t* best_accuracy_ms )
+{
+    /* The LR11xx only takes whole seconds: round to the nearest one and account for the offset in the accuracy */
+    if( fractional_ms >= 500 )
+    {
+        gps_time_s += 1;
+        accuracy_ms += 1000 - fractional_ms;
+    }
+    else
+    {
+        accuracy_ms += fractional_ms;
+    }
+
+    if( accuracy_ms < *best_accuracy_ms )
+    {
+        *best_gps_time_s  = gps_time_s;
+        *best_accuracy_ms = accuracy_ms;
+    }
+}
+
 static void gnss_rp_task_done( void* status )
 {
     uint32_t    tcurrent_ms;
@@ -745,6 +1083,9 @@ static void gnss_rp_task_done( void* status )
         if( ( mw_status == MW_RC_OK ) && ( scan_done == false ) )
         {
             gnss_scan_next( modes[mw_gnss_task_obj.current_mode_index].scan_group_delay );
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+            gnss_scan_pipeline( modes[mw_gnss_task_obj.current_mode_index].scan_group_delay );
+#endif
         }
         else
         {
@@ -767,6 +1108,42 @@ static void gnss_rp_task_done( void* status )
     }
 }
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+static void gnss_scan_pipeline( uint32_t gap_s )
+{
+    if( gap_s < GNSS_SCAN_PIPELINE_MIN_GAP_S )
+    {
+        return;
+    }
+
+    if( mw_gnss_task_obj.nb_scans_pipelined < navgroup.nb_scans_valid )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "GNSS pipeline: send %u scan(s) before next scan\n",
+                                     navgroup.nb_scans_valid - mw_gnss_task_obj.nb_scans_pipelined );
+
+        navgroup.token = mw_gnss_task_obj.current_token;
+
+        /* A scan sent before the NAV group ends is never flagged as the last one, the metadata of the last valid scan
+         * is set again by terminate_navgroup() if it has not been sent yet */
+        for( uint8_t i = mw_gnss_task_obj.nb_scans_pipelined; i < navgroup.nb_scans_valid; i++ )
+        {
+            navgroup.scans[i].results_buffer[0] = navgroup.token & 0x1F;
+        }
+        mw_gnss_task_obj.nb_scans_pipelined = navgroup.nb_scans_valid;
+
+        mw_gnss_send_add_pipelined_scans( &navgroup );
+    }
+
+    /* The Wi-Fi results are reported and sent with their own SCAN_DONE and TERMINATED events */
+    if( ( mw_gnss_task_obj.scan_aggregate == true ) && ( gap_s >= GNSS_SCAN_PIPELINE_WIFI_MIN_GAP_S ) &&
+        ( mw_wifi_scan_is_busy( ) == false ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "GNSS pipeline: Wi-Fi scan before next scan\n" );
+        mw_wifi_scan_add_task( 0 );
+    }
+}
+#endif
+
 static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete )
 {
     lr11xx_gnss_time_t                               gps_time;
@@ -806,6 +1183,10 @@ static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete )
     GNSS_SCAN_TRACE_PRINTF_DEBUG( "Last GNSS scan mode launched: %s\n",
                                   smtc_gnss_scan_mode_launched_enum2str( mw_gnss_task_obj.last_scan_mode ) );
     navgroup.scans[scan_index].scan_mode_launched = mw_gnss_task_obj.last_scan_mode;
+    if( mw_gnss_task_obj.last_scan_mode == LR11XX_GNSS_LAST_SCAN_MODE_ASSISTED )
+    {
+        mw_gnss_task_obj.last_assisted_scan_time_s = smtc_modem_hal_get_time_in_s( );
+    }
 
     /* Get current almanac CRC */
     MW_RETURN_ON_FAILURE( lr11xx_gnss_get_context_status( modem_get_radio_ctx( ), context_status_bytestream ) ==
@@ -817,6 +1198,7 @@ static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete )
     /* Get results */
     MW_RETURN_ON_FAILURE( lr11xx_gnss_get_result_size( modem_get_radio_ctx( ), &scan_result_size ) ==
                           LR11XX_STATUS_OK );
+    MW_RETURN_ON_FAILURE( scan_result_size <= sizeof( navgroup.scans[scan_index].results_buffer ) );
     MW_RETURN_ON_FAILURE( lr11xx_gnss_read_results( modem_get_radio_ctx( ), navgroup.scans[scan_index].results_buffer,
                                                     scan_result_size ) == LR11XX_STATUS_OK );
     GNSS_SCAN_TRACE_ARRAY_DEBUG( "NAV3", navgroup.scans[scan_index].results_buffer, scan_result_size );
@@ -828,6 +1210,10 @@ static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete )
     MW_RETURN_ON_FAILURE(
         lr11xx_gnss_get_nb_detected_satellites( modem_get_radio_ctx( ), &navgroup.scans[scan_index].nb_detected_svs ) ==
         LR11XX_STATUS_OK );
+    if( navgroup.scans[scan_index].nb_detected_svs > ( 2 * GNSS_NB_SVS_PER_CONSTELLATION_MAX ) )
+    {
+        navgroup.scans[scan_index].nb_detected_svs = 2 * GNSS_NB_SVS_PER_CONSTELLATION_MAX;
+    }
 
     /* Get details about all detected SVs (even if not given in NAV) */
     if( navgroup.scans[scan_index].nb_detected_svs > 0 )
@@ -914,6 +1300,26 @@ static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete )
         *navgroup_complete = false;
     }
 
+    /* Adaptive policy: a scan which could not detect enough SVs is doomed to be repeated in the same conditions, and
+     * a good assisted scan does not need another one */
+    if( ( mw_gnss_task_obj.scan_adaptive == true ) && ( *navgroup_complete == false ) )
+    {
+        if( navgroup.scans[scan_index].nb_detected_svs < 3 )
+        {
+            SMTC_MODEM_HAL_TRACE_INFO( "GNSS adaptive: %u SVs detected, stop NAV group\n",
+                                       navgroup.scans[scan_index].nb_detected_svs );
+            *navgroup_complete = true;
+        }
+        else if( ( navgroup.scans[scan_index].scan_mode_launched == LR11XX_GNSS_LAST_SCAN_MODE_ASSISTED ) &&
+                 ( navgroup.scans[scan_index].nb_detected_svs >= GNSS_SCAN_ADAPTIVE_GOOD_NB_SVS ) &&
+                 ( navgroup.nb_scans_valid > 0 ) )
+        {
+            SMTC_MODEM_HAL_TRACE_INFO( "GNSS adaptive: %u SVs detected, NAV group complete\n",
+                                       navgroup.scans[scan_index].nb_detected_svs );
+            *navgroup_complete = true;
+        }
+    }
+
     /* Sanity check */
     if( navgroup.nb_scans_valid > GNSS_NAVGROUP_SIZE_MAX )
     {
@@ -924,6 +1330,47 @@ static mw_return_code_t gnss_scan_task_done( bool* navgroup_complete )
     return MW_RC_OK;
 }
 
+static uint32_t gnss_scan_duration_s( void )
+{
+    bool assisted = ( mw_gnss_task_obj.last_scan_mode == LR11XX_GNSS_LAST_SCAN_MODE_ASSISTED );
+
+    /* The assistance position of a device which moved since the last assisted scan is likely to be wrong */
+    if( ( mw_gnss_task_obj.scan_adaptive == true ) && ( assisted == true ) &&
+        ( ( smtc_modem_hal_get_time_in_s( ) - mw_gnss_task_obj.last_assisted_scan_time_s ) >
+          GNSS_SCAN_ADAPTIVE_ASSISTANCE_MAX_AGE_S ) )
+    {
+        assisted = false;
+    }
+
+    return ( assisted == true ) ? GNSS_SCAN_DURATION_ASSISTED_S : GNSS_SCAN_DURATION_AUTONOMOUS_S;
+}
+
+static lr11xx_gnss_constellation_mask_t gnss_scan_constellations( void )
+{
+    lr11xx_gnss_constellation_mask_t constellations_mask = mw_gnss_task_obj.constellations_mask;
+
+    /* An assisted scan searches the SVs predicted by the almanac, skip a constellation with an outdated almanac as
+     * long as the other one is up to date */
+    if( ( mw_gnss_task_obj.scan_adaptive == true ) &&
+        ( mw_gnss_task_obj.last_scan_mode == LR11XX_GNSS_LAST_SCAN_MODE_ASSISTED ) &&
+        ( constellations_mask == ( LR11XX_GNSS_GPS_MASK | LR11XX_GNSS_BEIDOU_MASK ) ) )
+    {
+        bool gps_outdated    = mw_gnss_almanac_is_outdated( SMTC_MODEM_GNSS_CONSTELLATION_GPS );
+        bool beidou_outdated = mw_gnss_almanac_is_outdated( SMTC_MODEM_GNSS_CONSTELLATION_BEIDOU );
+
+        if( ( gps_outdated == false ) && ( beidou_outdated == true ) )
+        {
+            constellations_mask = LR11XX_GNSS_GPS_MASK;
+        }
+        else if( ( gps_outdated == true ) && ( beidou_outdated == false ) )
+        {
+            constellations_mask = LR11XX_GNSS_BEIDOU_MASK;
+        }
+    }
+
+    return constellations_mask;
+}
+
 static void send_event( smtc_modem_event_type_t event )
 {
     if( event == SMTC_MODEM_EVENT_GNSS_SCAN_DONE )
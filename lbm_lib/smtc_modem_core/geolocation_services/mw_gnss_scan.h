@@ -124,6 +124,20 @@ smtc_modem_return_code_t mw_gnss_get_event_data_scan_done( smtc_modem_gnss_event
  */
 void mw_gnss_scan_aggregate( bool aggregate );
 
+/**
+ * @brief Adapt the scans of a NAV group to the almanac status, the last assisted scan and the detected SVs (optional)
+ * @param [in] adaptive Boolean to adapt or not
+ */
+void mw_gnss_scan_adaptive( bool adaptive );
+
+/**
+ * @brief Set the port of the geolocation solver position downlinks refreshing the assistance position (optional)
+ *
+ * @param [in] port             Port of the position downlinks, 0 to disable
+ * @param [in] max_accuracy_m   Maximum accuracy of a position to be used as assistance position, in meters
+ */
+void mw_gnss_set_solver_port( uint8_t port, uint16_t max_accuracy_m );
+
 /**
  * @brief Set the GNSS constellations to be used for scanning for all subsequent scans (optional)
  *
@@ -123,6 +123,17 @@
  */
 #define GNSS_DEFAULT_UPLINK_PORT ( 192 )
 
+/**
+ * @brief Bit set in the metadata byte of an uplink carrying several NAV messages
+ */
+#define GNSS_PACKED_METADATA_FLAG ( 0x40 )
+
+/**
+ * @brief Size of the buffer holding an uplink of packed NAV messages: shared metadata, then size and NAV message
+ */
+#define GNSS_PACKED_BUFFER_SIZE \
+    ( GNSS_SCAN_METADATA_SIZE + GNSS_NAVGROUP_SIZE_MAX * ( 1 + GNSS_RESULT_SIZE_MAX - GNSS_SCAN_METADATA_SIZE ) )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -140,9 +151,16 @@ typedef struct mw_gnss_send_s
     bool    is_busy;
     bool    pending_evt_terminated;
     /* NAV related fields */
-    const navgroup_t*                  nav_group;      //!< GNSS NAV Group to be sent over the air
-    uint8_t                            nb_scans_sent;  //!< Number of scans (NAV message) already sent
-    smtc_modem_geolocation_send_mode_t send_mode;      //!< Send mode to be used: uplink, store&fwd, bypass
+    const navgroup_t*                  nav_group;       //!< GNSS NAV Group to be sent over the air
+    uint8_t                            nb_scans_sent;   //!< Number of scans (NAV message) already sent
+    smtc_modem_geolocation_send_mode_t send_mode;       //!< Send mode to be used: uplink, store&fwd, bypass
+    smtc_modem_gnss_payload_format_t   payload_format;  //!< Selected payload format (NAV or packed NAV)
+    uint8_t                            nb_scans_in_tx;  //!< Number of scans carried by the current uplink
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+    bool navgroup_open;  //!< Scans are being sent while the NAV group is still in progress
+    bool task_pending;   //!< A send task is programmed in the supervisor
+    bool send_failed;    //!< A scan of the NAV group could not be sent, stop the send sequence
+#endif
 } mw_gnss_send_t;
 
 /*
@@ -155,6 +173,11 @@ typedef struct mw_gnss_send_s
  */
 static mw_gnss_send_t mw_gnss_send_obj = { 0 };
 
+/**
+ * @brief Buffer holding an uplink of packed NAV messages
+ */
+static uint8_t packed_tx_buffer[GNSS_PACKED_BUFFER_SIZE];
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -163,9 +186,8 @@ static mw_gnss_send_t mw_gnss_send_obj = { 0 };
 /**
  * @brief Service callbacks
  */
-static void    mw_gnss_send_service_on_launch( void* context_callback );
-static void    mw_gnss_send_service_on_update( void* context_callback );
-static uint8_t mw_gnss_send_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
+static void mw_gnss_send_service_on_launch( void* context_callback );
+static void mw_gnss_send_service_on_update( void* context_callback );
 
 /**
  * @brief Program the supervisor task for sending the next GNSS scan result.
@@ -204,16 +226,17 @@ void mw_gnss_send_services_init( uint8_t* service_id, uint8_t task_id,
     mw_gnss_send_obj.task_id     = task_id;
     mw_gnss_send_obj.stack_id    = CURRENT_STACK;
     mw_gnss_send_obj.initialized = true;
-    *downlink_callback           = mw_gnss_send_service_downlink_handler;
+    *downlink_callback           = NULL;
     *on_launch_callback          = mw_gnss_send_service_on_launch;
     *on_update_callback          = mw_gnss_send_service_on_update;
     *context_callback            = ( void* ) modem_supervisor_get_task( );
 
-    mw_gnss_send_obj.nav_group     = NULL;
-    mw_gnss_send_obj.nb_scans_sent = 0;
-    mw_gnss_send_obj.fport         = GNSS_DEFAULT_UPLINK_PORT;
-    mw_gnss_send_obj.is_busy       = false;
-    mw_gnss_send_obj.send_mode     = SMTC_MODEM_SEND_MODE_UPLINK;
+    mw_gnss_send_obj.nav_group      = NULL;
+    mw_gnss_send_obj.nb_scans_sent  = 0;
+    mw_gnss_send_obj.fport          = GNSS_DEFAULT_UPLINK_PORT;
+    mw_gnss_send_obj.is_busy        = false;
+    mw_gnss_send_obj.send_mode      = SMTC_MODEM_SEND_MODE_UPLINK;
+    mw_gnss_send_obj.payload_format = SMTC_MODEM_GNSS_PAYLOAD_NAV;
 }
 
 void mw_gnss_send_add_task( const navgroup_t* nav_group )
@@ -222,6 +245,27 @@ void mw_gnss_send_add_task( const navgroup_t* nav_group )
 
     IS_SERVICE_INITIALIZED( );
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+    if( mw_gnss_send_obj.navgroup_open == true )
+    {
+        /* Part of the NAV group has been sent while it was in progress, only the remaining scans are sent */
+        mw_gnss_send_obj.navgroup_open = false;
+        if( mw_gnss_send_obj.task_pending == false )
+        {
+            if( ( mw_gnss_send_obj.send_failed == true ) ||
+                ( mw_gnss_send_obj.nb_scans_sent == nav_group->nb_scans_valid ) )
+            {
+                send_event( SMTC_MODEM_EVENT_GNSS_TERMINATED );
+            }
+            else
+            {
+                mw_gnss_send_next( );
+            }
+        }
+        return;
+    }
+#endif
+
     /* Clear pending events */
     mw_gnss_send_obj.pending_evt_terminated = false;
 
@@ -241,6 +285,35 @@ void mw_gnss_send_add_task( const navgroup_t* nav_group )
     }
 }
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+void mw_gnss_send_add_pipelined_scans( const navgroup_t* nav_group )
+{
+    GNSS_SEND_TRACE_PRINTF_DEBUG( "mw_gnss_send_add_pipelined_scans\n" );
+
+    IS_SERVICE_INITIALIZED( );
+
+    if( mw_gnss_send_obj.send_mode == SMTC_MODEM_SEND_MODE_BYPASS )
+    {
+        return;
+    }
+
+    if( mw_gnss_send_obj.navgroup_open == false )
+    {
+        /* First scans of this NAV group */
+        mw_gnss_send_obj.pending_evt_terminated = false;
+        mw_gnss_send_obj.nav_group              = nav_group;
+        mw_gnss_send_obj.nb_scans_sent          = 0;
+        mw_gnss_send_obj.send_failed            = false;
+        mw_gnss_send_obj.navgroup_open          = true;
+    }
+
+    if( ( mw_gnss_send_obj.task_pending == false ) && ( mw_gnss_send_obj.send_failed == false ) )
+    {
+        mw_gnss_send_next( );
+    }
+}
+#endif
+
 bool mw_gnss_send_is_busy( )
 {
     return mw_gnss_send_obj.is_busy;
@@ -287,6 +360,11 @@ smtc_modem_return_code_t mw_gnss_set_send_mode( smtc_modem_geolocation_send_mode
     return SMTC_MODEM_RC_OK;
 }
 
+void mw_gnss_set_payload_format( smtc_modem_gnss_payload_format_t format )
+{
+    mw_gnss_send_obj.payload_format = format;
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -362,9 +440,29 @@ static void mw_gnss_send_service_on_update( void* context_callback )
     /* Update context if the call to the lorawan stack send succeeded */
     if( task_manager->modem_task[mw_gnss_send_obj.task_id].task_context == true )
     {
-        mw_gnss_send_obj.nb_scans_sent += 1;
+        mw_gnss_send_obj.nb_scans_sent += mw_gnss_send_obj.nb_scans_in_tx;
+    }
+
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+    mw_gnss_send_obj.task_pending = false;
+    if( task_manager->modem_task[mw_gnss_send_obj.task_id].task_context == false )
+    {
+        mw_gnss_send_obj.send_failed = true;
     }
 
+    if( mw_gnss_send_obj.navgroup_open == true )
+    {
+        /* The NAV group is still in progress, the end of the send sequence is handled by mw_gnss_send_add_task() */
+        if( ( mw_gnss_send_obj.send_failed == false ) &&
+            ( mw_gnss_send_obj.nb_scans_sent < mw_gnss_send_obj.nav_group->nb_scans_valid ) )
+        {
+            mw_gnss_send_next( );
+        }
+        mw_gnss_send_obj.is_busy = false;
+        return;
+    }
+#endif
+
     if( ( task_manager->modem_task[mw_gnss_send_obj.task_id].task_context == false ) ||
         ( mw_gnss_send_obj.nb_scans_sent == mw_gnss_send_obj.nav_group->nb_scans_valid ) )
     {
@@ -379,13 +477,6 @@ static void mw_gnss_send_service_on_update( void* context_callback )
     mw_gnss_send_obj.is_busy = false;
 }
 
-static uint8_t mw_gnss_send_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
-{
-    GNSS_SEND_TRACE_PRINTF_DEBUG( "mw_gnss_send_service_downlink_handler\n" );
-
-    return MODEM_DOWNLINK_UNCONSUMED;
-}
-
 static void mw_gnss_send_next( void )
 {
     GNSS_SEND_TRACE_PRINTF_DEBUG( "mw_gnss_send_next\n" );
@@ -404,6 +495,9 @@ static void mw_gnss_send_next( void )
     }
     task.time_to_execute_s = smtc_modem_hal_get_time_in_s( );
     modem_supervisor_add_task( &task );
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+    mw_gnss_send_obj.task_pending = true;
+#endif
 }
 
 static void send_event( smtc_modem_event_type_t event )
@@ -427,12 +521,48 @@ static void trace_print_event_data_terminated( const smtc_modem_gnss_event_data_
 
 static void prepare_tx_buffer( uint8_t** tx_buffer, uint8_t* tx_buffer_size, uint8_t* port )
 {
-    uint8_t src_idx = mw_gnss_send_obj.nb_scans_sent;
+    const navgroup_t* nav_group = mw_gnss_send_obj.nav_group;
+    uint8_t           src_idx   = mw_gnss_send_obj.nb_scans_sent;
 
     /* Prepare buffer for TX */
-    *tx_buffer      = ( uint8_t* ) mw_gnss_send_obj.nav_group->scans[src_idx].results_buffer;
-    *tx_buffer_size = mw_gnss_send_obj.nav_group->scans[src_idx].results_size;
-    *port           = mw_gnss_send_obj.fport;
+    *tx_buffer                      = ( uint8_t* ) nav_group->scans[src_idx].results_buffer;
+    *tx_buffer_size                 = nav_group->scans[src_idx].results_size;
+    *port                           = mw_gnss_send_obj.fport;
+    mw_gnss_send_obj.nb_scans_in_tx = 1;
+
+    if( ( mw_gnss_send_obj.payload_format != SMTC_MODEM_GNSS_PAYLOAD_NAV_PACKED ) ||
+        ( mw_gnss_send_obj.send_mode != SMTC_MODEM_SEND_MODE_UPLINK ) )
+    {
+        return;
+    }
+
+    /* Pack the following NAV messages as long as they fit in the next uplink, the metadata byte is shared */
+    uint32_t max_size    = lorawan_api_next_max_payload_length_get( mw_gnss_send_obj.stack_id );
+    uint8_t  packed_size = GNSS_SCAN_METADATA_SIZE;
+    uint8_t  nb_packed   = 0;
+    while( ( src_idx + nb_packed ) < nav_group->nb_scans_valid )
+    {
+        const scan_result_t* scan     = &nav_group->scans[src_idx + nb_packed];
+        uint8_t              nav_size = scan->results_size - GNSS_SCAN_METADATA_SIZE;
+
+        if( ( uint32_t )( packed_size + 1 + nav_size ) > max_size )
+        {
+            break;
+        }
+        packed_tx_buffer[packed_size] = nav_size;
+        memcpy( &packed_tx_buffer[packed_size + 1], &scan->results_buffer[GNSS_SCAN_METADATA_SIZE], nav_size );
+        packed_tx_buffer[0] = scan->results_buffer[0] | GNSS_PACKED_METADATA_FLAG;
+        packed_size += 1 + nav_size;
+        nb_packed += 1;
+    }
+
+    /* A single NAV message keeps its own format */
+    if( nb_packed > 1 )
+    {
+        *tx_buffer                      = packed_tx_buffer;
+        *tx_buffer_size                 = packed_size;
+        mw_gnss_send_obj.nb_scans_in_tx = nb_packed;
+    }
 }
 
 /* --- EOF ------------------------------------------------------------------ */
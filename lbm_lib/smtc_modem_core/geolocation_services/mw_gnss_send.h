@@ -98,6 +98,19 @@ void mw_gnss_send_services_init( uint8_t* service_id, uint8_t task_id,
  */
 void mw_gnss_send_add_task( const navgroup_t* nav_group );
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+/**
+ * @brief Send the valid scans of a NAV group which is still in progress
+ *
+ * The scans given to this function are sent in the gap before the next scan of the NAV group. The remaining scans
+ * and the SMTC_MODEM_EVENT_GNSS_TERMINATED event are handled by @ref mw_gnss_send_add_task once the NAV group is
+ * complete.
+ *
+ * @param [in] nav_group    The NAV group in progress, its first nb_scans_valid scans are ready to be sent
+ */
+void mw_gnss_send_add_pipelined_scans( const navgroup_t* nav_group );
+#endif
+
 /**
  * @brief Indicates if a send sequence has started.
  */
@@ -135,6 +148,15 @@ void mw_gnss_set_port( uint8_t port );
  */
 smtc_modem_return_code_t mw_gnss_set_send_mode( smtc_modem_geolocation_send_mode_t send_mode );
 
+/**
+ * @brief Set the format of the payload to be sent: one NAV message per uplink or NAV messages packed together
+ *
+ * @param [in] format Payload format to be used
+ *
+ * By default it is configured for using SMTC_MODEM_GNSS_PAYLOAD_NAV format
+ */
+void mw_gnss_set_payload_format( smtc_modem_gnss_payload_format_t format );
+
 #ifdef __cplusplus
 }
 #endif
@@ -110,6 +110,11 @@
  * --- PRIVATE CONSTANTS -------------------------------------------------------
  */
 
+/**
+ * @brief Number of passes of a scan sequence: WIFI_FIRST_PASS_CHANNELS first, then the other channels
+ */
+#define WIFI_SCAN_NB_PASSES ( 2 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -125,6 +130,7 @@ typedef struct mw_wifi_task_s
     uint8_t  rp_hook_id;
     bool     initialized;
     bool     scan_sequence_started;
+    uint8_t  scan_pass;  //!< Current pass of the scan sequence, WIFI_SCAN_NB_PASSES when no pass is left
     uint32_t scan_start_time;
     uint32_t scan_end_time;
     bool     pending_evt_scan_done;
@@ -162,9 +168,13 @@ wifi_settings_t wifi_settings = { .channels            = 0x3FFF, /* all channels
 /**
  * @brief Service callbacks
  */
-static void    mw_wifi_scan_service_on_launch( void* context_callback );
-static void    mw_wifi_scan_service_on_update( void* context_callback );
-static uint8_t mw_wifi_scan_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
+static void mw_wifi_scan_service_on_launch( void* context_callback );
+static void mw_wifi_scan_service_on_update( void* context_callback );
+
+/**
+ * @brief Enqueue the radio planner task for the current scan pass
+ */
+static void wifi_rp_task_enqueue( void );
 
 /**
  * @brief Callback called by the radio planner when radio access is granted to the service
@@ -181,6 +191,30 @@ static void wifi_rp_task_done( void* status );
  */
 static void wifi_scan_task_done( void );
 
+/**
+ * @brief Get the channels scanned during a pass of the scan sequence
+ */
+static lr11xx_wifi_channel_mask_t wifi_scan_get_pass_channels( uint8_t pass );
+
+/**
+ * @brief Get the first pass, starting from the given one, with channels to scan
+ *
+ * @return The pass index, WIFI_SCAN_NB_PASSES if no pass is left
+ */
+static uint8_t wifi_scan_find_pass( uint8_t pass );
+
+/**
+ * @brief Check if enough strong fixed access points have been found to stop the scan sequence
+ */
+static bool wifi_scan_is_enough_results( void );
+
+/**
+ * @brief Start the next pass of the scan sequence, if any is left and the results are not full
+ *
+ * @return true if a pass has been scheduled
+ */
+static bool wifi_scan_start_next_pass( void );
+
 /**
  * @brief Send an event to user to notify for progress
  */
@@ -215,7 +249,7 @@ void mw_wifi_scan_services_init( uint8_t* service_id, uint8_t task_id,
     mw_wifi_task_obj.stack_id    = CURRENT_STACK;
     mw_wifi_task_obj.rp_hook_id  = RP_HOOK_ID_DIRECT_RP_ACCESS_WIFI;
     mw_wifi_task_obj.initialized = true;
-    *downlink_callback           = mw_wifi_scan_service_downlink_handler;
+    *downlink_callback           = NULL;
     *on_launch_callback          = mw_wifi_scan_service_on_launch;
     *on_update_callback          = mw_wifi_scan_service_on_update;
     *context_callback            = ( void* ) service_id;
@@ -267,6 +301,18 @@ smtc_modem_return_code_t mw_wifi_scan_remove_task( void )
     return SMTC_MODEM_RC_OK;
 }
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+bool mw_wifi_scan_is_busy( void )
+{
+    stask_manager* task_manager = modem_supervisor_get_task( );
+
+    /* A scan is programmed, running, or its results are still being sent */
+    return ( mw_wifi_task_obj.scan_sequence_started == true ) ||
+           ( task_manager->modem_task[mw_wifi_task_obj.task_id].priority != TASK_FINISH ) ||
+           ( mw_wifi_send_is_busy( ) == true );
+}
+#endif
+
 smtc_modem_return_code_t mw_wifi_get_event_data_scan_done( smtc_modem_wifi_event_data_scan_done_t* data )
 {
     if( data == NULL )
@@ -304,7 +350,16 @@ static void mw_wifi_scan_service_on_launch( void* context_callback )
 
     mw_wifi_task_obj.scan_start_time = 0;
     mw_wifi_task_obj.scan_end_time   = 0;
+    mw_wifi_task_obj.scan_pass       = wifi_scan_find_pass( 0 );
 
+    /* Reset previous results */
+    memset( &wifi_results, 0, sizeof wifi_results );
+
+    wifi_rp_task_enqueue( );
+}
+
+static void wifi_rp_task_enqueue( void )
+{
     rp_task_t rp_task                      = { 0 };
     rp_task.hook_id                        = mw_wifi_task_obj.rp_hook_id;
     rp_task.state                          = RP_TASK_STATE_ASAP;
@@ -320,7 +375,8 @@ static void mw_wifi_scan_service_on_launch( void* context_callback )
     }
     else
     {
-        SMTC_MODEM_HAL_TRACE_PRINTF( "Enqueued RP task for Wi-Fi scan (hook_id #%d)\n", rp_task.hook_id );
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Enqueued RP task for Wi-Fi scan pass %u (hook_id #%d)\n",
+                                     mw_wifi_task_obj.scan_pass, rp_task.hook_id );
     }
 }
 
@@ -331,13 +387,6 @@ static void mw_wifi_scan_service_on_update( void* context_callback )
     IS_SERVICE_INITIALIZED( );
 }
 
-static uint8_t mw_wifi_scan_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
-{
-    WIFI_SCAN_TRACE_PRINTF_DEBUG( "mw_wifi_scan_service_downlink_handler\n" );
-
-    return MODEM_DOWNLINK_UNCONSUMED;
-}
-
 static void trace_print_scan_results( const wifi_scan_all_result_t* results )
 {
     if( results != NULL )
@@ -386,9 +435,6 @@ static void wifi_rp_task_launch( void* context )
     mw_wifi_task_obj.scan_start_time = smtc_modem_hal_get_time_in_ms( );
     SMTC_MODEM_HAL_TRACE_INFO( "Wi-Fi task launch at %u\n", mw_wifi_task_obj.scan_start_time );
 
-    /* Reset previous results */
-    memset( &wifi_results, 0, sizeof wifi_results );
-
     if( mw_radio_configure_for_scan( modem_get_radio_ctx( ) ) == false )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "wifi_rp_task_launch: mw_radio_configure_for_scan() failed\n" );
@@ -396,8 +442,11 @@ static void wifi_rp_task_launch( void* context )
         return;
     }
 
-    /* Set Wi-Fi scan settings */
-    smtc_wifi_settings_init( &wifi_settings );
+    /* Set Wi-Fi scan settings, the pass only looks for the results still missing */
+    wifi_settings_t pass_settings = wifi_settings;
+    pass_settings.channels        = wifi_scan_get_pass_channels( mw_wifi_task_obj.scan_pass );
+    pass_settings.max_results     = wifi_settings.max_results - wifi_results.nbr_results;
+    smtc_wifi_settings_init( &pass_settings );
 
     /* Start Wi-Fi scan */
     if( smtc_wifi_start_scan( modem_get_radio_ctx( ) ) != MW_RC_OK )
@@ -435,7 +484,14 @@ static void wifi_rp_task_done( void* status )
     }
     else if( rp_status == RP_STATUS_WIFI_SCAN_DONE )
     {
-        wifi_results.scan_duration_ms = mw_wifi_task_obj.scan_end_time - mw_wifi_task_obj.scan_start_time;
+        wifi_results.scan_duration_ms += mw_wifi_task_obj.scan_end_time - mw_wifi_task_obj.scan_start_time;
+
+        /* Get the results of this pass, and stop there if they are enough for a fix */
+        smtc_wifi_get_results( modem_get_radio_ctx( ), &wifi_results );
+        if( ( wifi_scan_is_enough_results( ) == false ) && ( wifi_scan_start_next_pass( ) == true ) )
+        {
+            return;
+        }
 
         /* Get results */
         wifi_scan_task_done( );
@@ -462,10 +518,7 @@ static void wifi_rp_task_done( void* status )
 
 static void wifi_scan_task_done( void )
 {
-    /* Wi-Fi scan completed, get and display the results */
-    smtc_wifi_get_results( modem_get_radio_ctx( ), &wifi_results );
-
-    /* Get scan power consumption */
+    /* Wi-Fi scan completed, get scan power consumption of all the passes */
     smtc_wifi_get_power_consumption( modem_get_radio_ctx( ), &wifi_results.power_consumption_nah );
 
     /* Sort results */
@@ -546,6 +599,56 @@ static void smtc_wifi_sort_results( wifi_scan_all_result_t* wifi_results )
     }
 }
 
+static lr11xx_wifi_channel_mask_t wifi_scan_get_pass_channels( uint8_t pass )
+{
+    if( pass == 0 )
+    {
+        return wifi_settings.channels & WIFI_FIRST_PASS_CHANNELS;
+    }
+    return wifi_settings.channels & ( lr11xx_wifi_channel_mask_t ) ~WIFI_FIRST_PASS_CHANNELS;
+}
+
+static uint8_t wifi_scan_find_pass( uint8_t pass )
+{
+    while( ( pass < WIFI_SCAN_NB_PASSES ) && ( wifi_scan_get_pass_channels( pass ) == 0 ) )
+    {
+        pass++;
+    }
+    return pass;
+}
+
+static bool wifi_scan_is_enough_results( void )
+{
+    uint8_t nb_strong_aps = 0;
+
+    for( uint8_t index = 0; index < wifi_results.nbr_results; index++ )
+    {
+        if( ( wifi_results.results[index].origin == LR11XX_WIFI_ORIGIN_BEACON_FIX_AP ) &&
+            ( wifi_results.results[index].rssi >= WIFI_STRONG_AP_RSSI_MIN ) )
+        {
+            nb_strong_aps++;
+        }
+    }
+    return ( nb_strong_aps >= WIFI_MAX_RESULTS_TO_SEND );
+}
+
+static bool wifi_scan_start_next_pass( void )
+{
+    if( wifi_results.nbr_results >= wifi_settings.max_results )
+    {
+        return false;
+    }
+
+    mw_wifi_task_obj.scan_pass = wifi_scan_find_pass( mw_wifi_task_obj.scan_pass + 1 );
+    if( mw_wifi_task_obj.scan_pass >= WIFI_SCAN_NB_PASSES )
+    {
+        return false;
+    }
+
+    wifi_rp_task_enqueue( );
+    return true;
+}
+
 static void send_event( smtc_modem_event_type_t event )
 {
     if( event == SMTC_MODEM_EVENT_WIFI_SCAN_DONE )
@@ -104,6 +104,13 @@ smtc_modem_return_code_t mw_wifi_scan_add_task( uint32_t start_delay_s );
  */
 smtc_modem_return_code_t mw_wifi_scan_remove_task( void );
 
+#if defined( ADD_LBM_GEOLOCATION_PIPELINE )
+/**
+ * @brief Indicates if a Wi-Fi scan is programmed, running or having its results sent
+ */
+bool mw_wifi_scan_is_busy( void );
+#endif
+
 /**
  * @brief Retrieve the data associated with the SMTC_MODEM_EVENT_WIFI_SCAN_DONE event
  *
@@ -39,6 +39,7 @@
 
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <stdlib.h>   // abs
 
 #include "mw_wifi_send.h"
 
@@ -153,8 +154,21 @@ typedef struct mw_wifi_send_s
     uint8_t                            nb_scans_sent;   //!< Number of scans already sent
     smtc_modem_geolocation_send_mode_t send_mode;       //!< Send mode to be used: uplink, store&fwd, bypass
     smtc_modem_wifi_payload_format_t   payload_format;  //!< Selected payload format (MAC or MAC+RSSI)
+    /* Unchanged scan filter */
+    uint8_t filter_rssi_hysteresis_db;  //!< RSSI change of a reported Access Point to send a scan, 0 to disable
+    uint8_t filter_max_nb_skipped;      //!< Maximum number of consecutive unchanged scans not sent
+    uint8_t nb_scans_skipped;           //!< Number of consecutive unchanged scans not sent
 } mw_wifi_send_t;
 
+/**
+ * @brief Access Point reported in the last scan sent
+ */
+typedef struct mw_wifi_reported_ap_s
+{
+    lr11xx_wifi_mac_address_t mac_address;
+    int8_t                    rssi;
+} mw_wifi_reported_ap_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -175,6 +189,16 @@ static uint8_t wifi_result_buffer[WIFI_TAG_SIZE + ( ( WIFI_AP_RSSI_SIZE + WIFI_A
  */
 static uint8_t wifi_result_buffer_size = 0;
 
+/*!
+ * @brief Access Points of the last scan sent, to detect the scans which bring no significant change
+ */
+static mw_wifi_reported_ap_t reported_aps[WIFI_MAX_RESULTS];
+
+/*!
+ * @brief Number of Access Points in reported_aps
+ */
+static uint8_t nb_reported_aps = 0;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -183,9 +207,8 @@ static uint8_t wifi_result_buffer_size = 0;
 /**
  * @brief Service callbacks
  */
-static void    mw_wifi_send_service_on_launch( void* context_callback );
-static void    mw_wifi_send_service_on_update( void* context_callback );
-static uint8_t mw_wifi_send_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
+static void mw_wifi_send_service_on_launch( void* context_callback );
+static void mw_wifi_send_service_on_update( void* context_callback );
 
 /**
  * @brief Send an event to the user application to notify for sequence progress.
@@ -197,6 +220,16 @@ static void send_event( smtc_modem_event_type_t event );
  */
 static void trace_print_event_data_terminated( const smtc_modem_wifi_event_data_terminated_t* data );
 
+/**
+ * @brief Check if a scan brings no significant change compared to the last scan sent
+ */
+static bool is_scan_unchanged( const wifi_scan_all_result_t* wifi_results );
+
+/**
+ * @brief Save the Access Points of the scan which has just been sent
+ */
+static void save_reported_aps( const wifi_scan_all_result_t* wifi_results );
+
 /**
  * @brief Prepare the buffer for data to be sent
  */
@@ -219,7 +252,7 @@ void mw_wifi_send_services_init( uint8_t* service_id, uint8_t task_id,
     mw_wifi_send_obj.task_id     = task_id;
     mw_wifi_send_obj.stack_id    = CURRENT_STACK;
     mw_wifi_send_obj.initialized = true;
-    *downlink_callback           = mw_wifi_send_service_downlink_handler;
+    *downlink_callback           = NULL;
     *on_launch_callback          = mw_wifi_send_service_on_launch;
     *on_update_callback          = mw_wifi_send_service_on_update;
     *context_callback            = ( void* ) modem_supervisor_get_task( );
@@ -230,6 +263,11 @@ void mw_wifi_send_services_init( uint8_t* service_id, uint8_t task_id,
     mw_wifi_send_obj.is_busy        = false;
     mw_wifi_send_obj.send_mode      = SMTC_MODEM_SEND_MODE_UPLINK;
     mw_wifi_send_obj.payload_format = SMTC_MODEM_WIFI_PAYLOAD_MAC;
+
+    mw_wifi_send_obj.filter_rssi_hysteresis_db = 0;
+    mw_wifi_send_obj.filter_max_nb_skipped     = 0;
+    mw_wifi_send_obj.nb_scans_skipped          = 0;
+    nb_reported_aps                            = 0;
 }
 
 void mw_wifi_send_add_task( const wifi_scan_all_result_t* wifi_results )
@@ -251,6 +289,13 @@ void mw_wifi_send_add_task( const wifi_scan_all_result_t* wifi_results )
         SMTC_MODEM_HAL_TRACE_PRINTF( "mw_wifi_send_add_task: no scan to be sent\n" );
         send_event( SMTC_MODEM_EVENT_WIFI_TERMINATED );
     }
+    else if( is_scan_unchanged( wifi_results ) == true )
+    {
+        mw_wifi_send_obj.nb_scans_skipped += 1;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "mw_wifi_send_add_task: no significant change, scan not sent (%u/%u)\n",
+                                     mw_wifi_send_obj.nb_scans_skipped, mw_wifi_send_obj.filter_max_nb_skipped );
+        send_event( SMTC_MODEM_EVENT_WIFI_TERMINATED );
+    }
     else
     {
         /* Prepare the task */
@@ -322,6 +367,14 @@ void mw_wifi_set_payload_format( smtc_modem_wifi_payload_format_t format )
     mw_wifi_send_obj.payload_format = format;
 }
 
+void mw_wifi_set_unchanged_scan_filter( uint8_t rssi_hysteresis_db, uint8_t max_nb_skipped )
+{
+    mw_wifi_send_obj.filter_rssi_hysteresis_db = rssi_hysteresis_db;
+    mw_wifi_send_obj.filter_max_nb_skipped     = max_nb_skipped;
+    mw_wifi_send_obj.nb_scans_skipped          = 0;
+    nb_reported_aps                            = 0;
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -393,6 +446,8 @@ static void mw_wifi_send_service_on_update( void* context_callback )
     if( task_manager->modem_task[mw_wifi_send_obj.task_id].task_context == true )
     {
         mw_wifi_send_obj.nb_scans_sent += 1;
+        mw_wifi_send_obj.nb_scans_skipped = 0;
+        save_reported_aps( mw_wifi_send_obj.wifi_results );
     }
 
     send_event( SMTC_MODEM_EVENT_WIFI_TERMINATED );
@@ -400,13 +455,6 @@ static void mw_wifi_send_service_on_update( void* context_callback )
     mw_wifi_send_obj.is_busy = false;
 }
 
-static uint8_t mw_wifi_send_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
-{
-    WIFI_SEND_TRACE_PRINTF_DEBUG( "mw_wifi_send_service_downlink_handler\n" );
-
-    return MODEM_DOWNLINK_UNCONSUMED;
-}
-
 static void send_event( smtc_modem_event_type_t event )
 {
     if( event == SMTC_MODEM_EVENT_WIFI_TERMINATED )
@@ -448,4 +496,57 @@ static void prepare_tx_buffer( void )
     }
 }
 
+static bool is_scan_unchanged( const wifi_scan_all_result_t* wifi_results )
+{
+    uint8_t nb_unchanged_aps = 0;
+
+    if( ( mw_wifi_send_obj.filter_rssi_hysteresis_db == 0 ) || ( nb_reported_aps == 0 ) ||
+        ( mw_wifi_send_obj.nb_scans_skipped >= mw_wifi_send_obj.filter_max_nb_skipped ) )
+    {
+        return false;
+    }
+
+    for( uint8_t i = 0; i < wifi_results->nbr_results; i++ )
+    {
+        const wifi_scan_single_result_t* ap = &wifi_results->results[i];
+        uint8_t                          j;
+
+        /* Mobile Access Points come and go (phones, vehicles) without the device moving */
+        if( ap->origin == LR11XX_WIFI_ORIGIN_BEACON_MOBILE_AP )
+        {
+            continue;
+        }
+
+        for( j = 0; j < nb_reported_aps; j++ )
+        {
+            if( memcmp( ap->mac_address, reported_aps[j].mac_address, WIFI_AP_ADDRESS_SIZE ) == 0 )
+            {
+                break;
+            }
+        }
+
+        /* A new Access Point, or a reported one heard much stronger or weaker, is a significant change */
+        if( ( j == nb_reported_aps ) ||
+            ( abs( ap->rssi - reported_aps[j].rssi ) > mw_wifi_send_obj.filter_rssi_hysteresis_db ) )
+        {
+            return false;
+        }
+        nb_unchanged_aps += 1;
+    }
+
+    return ( nb_unchanged_aps >= WIFI_SCAN_NB_AP_MIN );
+}
+
+static void save_reported_aps( const wifi_scan_all_result_t* wifi_results )
+{
+    nb_reported_aps = 0;
+    for( uint8_t i = 0; i < wifi_results->nbr_results; i++ )
+    {
+        memcpy( reported_aps[nb_reported_aps].mac_address, wifi_results->results[i].mac_address,
+                WIFI_AP_ADDRESS_SIZE );
+        reported_aps[nb_reported_aps].rssi = wifi_results->results[i].rssi;
+        nb_reported_aps += 1;
+    }
+}
+
 /* --- EOF ------------------------------------------------------------------ */
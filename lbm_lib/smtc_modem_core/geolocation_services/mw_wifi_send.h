@@ -138,6 +138,16 @@ smtc_modem_return_code_t mw_wifi_set_send_mode( smtc_modem_geolocation_send_mode
  */
 void mw_wifi_set_payload_format( smtc_modem_wifi_payload_format_t format );
 
+/**
+ * @brief Do not send the scans which bring no significant change compared to the last scan sent
+ *
+ * @param [in] rssi_hysteresis_db   RSSI change of a reported Access Point which makes a scan sent, 0 to disable
+ * @param [in] max_nb_skipped       Maximum number of consecutive scans not sent
+ *
+ * By default the filter is disabled
+ */
+void mw_wifi_set_unchanged_scan_filter( uint8_t rssi_hysteresis_db, uint8_t max_nb_skipped );
+
 #ifdef __cplusplus
 }
 #endif
@@ -72,13 +72,17 @@ static wifi_settings_t settings = { 0 };
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
-static lr11xx_wifi_basic_complete_result_t wifi_results_mac_addr[WIFI_MAX_RESULTS];
-
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/*!
+ * @brief Check if an access point is already part of the results
+ */
+static bool is_mac_address_in_results( const wifi_scan_all_result_t* wifi_results,
+                                       const lr11xx_wifi_mac_address_t mac_address );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -124,43 +128,55 @@ void smtc_wifi_scan_ended( void )
 
 mw_return_code_t smtc_wifi_get_results( const void* radio_context, wifi_scan_all_result_t* wifi_results )
 {
-    uint8_t nb_results;
-    uint8_t max_nb_results;
-
-    memset( wifi_results_mac_addr, 0, sizeof wifi_results_mac_addr );
+    lr11xx_wifi_basic_complete_result_t wifi_results_mac_addr[WIFI_READ_RESULTS_BATCH_SIZE];
+    uint8_t                             nb_results;
 
     MW_RETURN_ON_FAILURE( lr11xx_wifi_get_nb_results( radio_context, &nb_results ) == LR11XX_STATUS_OK );
 
-    /* check if the array is big enough to hold all results */
-    max_nb_results = sizeof( wifi_results_mac_addr ) / sizeof( wifi_results_mac_addr[0] );
-    if( nb_results > max_nb_results )
+    /* read the results by batches, until the array is full */
+    for( uint8_t start_index = 0; ( start_index < nb_results ) && ( wifi_results->nbr_results < WIFI_MAX_RESULTS );
+         start_index += WIFI_READ_RESULTS_BATCH_SIZE )
     {
-        SMTC_MODEM_HAL_TRACE_ERROR( "Wi-Fi scan result size exceeds %u (%u)\n", max_nb_results, nb_results );
-        return MW_RC_FAILED;
+        uint8_t batch_size = nb_results - start_index;
+
+        if( batch_size > WIFI_READ_RESULTS_BATCH_SIZE )
+        {
+            batch_size = WIFI_READ_RESULTS_BATCH_SIZE;
+        }
+
+        MW_RETURN_ON_FAILURE( lr11xx_wifi_read_basic_complete_results( radio_context, start_index, batch_size,
+                                                                       wifi_results_mac_addr ) == LR11XX_STATUS_OK );
+
+        /* add scan to results */
+        for( uint8_t index = 0; ( index < batch_size ) && ( wifi_results->nbr_results < WIFI_MAX_RESULTS ); index++ )
+        {
+            const lr11xx_wifi_basic_complete_result_t* local_basic_result = &wifi_results_mac_addr[index];
+            wifi_scan_single_result_t* result = &wifi_results->results[wifi_results->nbr_results];
+            lr11xx_wifi_channel_t      channel;
+            bool                       rssi_validity;
+            lr11xx_wifi_mac_origin_t   mac_origin_estimation;
+
+            if( is_mac_address_in_results( wifi_results, local_basic_result->mac_address ) == true )
+            {
+                continue;
+            }
+
+            lr11xx_wifi_parse_channel_info( local_basic_result->channel_info_byte, &channel, &rssi_validity,
+                                            &mac_origin_estimation );
+
+            result->channel = channel;
+            result->origin  = mac_origin_estimation;
+            result->type =
+                lr11xx_wifi_extract_signal_type_from_data_rate_info( local_basic_result->data_rate_info_byte );
+            memcpy( result->mac_address, local_basic_result->mac_address, LR11XX_WIFI_MAC_ADDRESS_LENGTH );
+            result->rssi = local_basic_result->rssi;
+            wifi_results->nbr_results++;
+        }
     }
 
-    MW_RETURN_ON_FAILURE( lr11xx_wifi_read_basic_complete_results( radio_context, 0, nb_results,
-                                                                   wifi_results_mac_addr ) == LR11XX_STATUS_OK );
-
-    /* add scan to results */
-    for( uint8_t index = 0; index < nb_results; index++ )
+    if( nb_results > 0 )
     {
-        const lr11xx_wifi_basic_complete_result_t* local_basic_result = &wifi_results_mac_addr[index];
-        lr11xx_wifi_channel_t                      channel;
-        bool                                       rssi_validity;
-        lr11xx_wifi_mac_origin_t                   mac_origin_estimation;
-
-        lr11xx_wifi_parse_channel_info( local_basic_result->channel_info_byte, &channel, &rssi_validity,
-                                        &mac_origin_estimation );
-
-        wifi_results->results[index].channel = channel;
-        wifi_results->results[index].origin  = mac_origin_estimation;
-        wifi_results->results[index].type =
-            lr11xx_wifi_extract_signal_type_from_data_rate_info( local_basic_result->data_rate_info_byte );
-        memcpy( wifi_results->results[index].mac_address, local_basic_result->mac_address,
-                LR11XX_WIFI_MAC_ADDRESS_LENGTH );
-        wifi_results->results[index].rssi = local_basic_result->rssi;
-        wifi_results->nbr_results++;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Wi-Fi scan: %u results read, %u held\n", nb_results, wifi_results->nbr_results );
     }
 
     return MW_RC_OK;
@@ -187,4 +203,17 @@ mw_return_code_t smtc_wifi_get_power_consumption( const void* radio_context, uin
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static bool is_mac_address_in_results( const wifi_scan_all_result_t* wifi_results,
+                                       const lr11xx_wifi_mac_address_t mac_address )
+{
+    for( uint8_t index = 0; index < wifi_results->nbr_results; index++ )
+    {
+        if( memcmp( wifi_results->results[index].mac_address, mac_address, LR11XX_WIFI_MAC_ADDRESS_LENGTH ) == 0 )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /* --- EOF ------------------------------------------------------------------ */
@@ -90,8 +90,11 @@ mw_return_code_t smtc_wifi_start_scan( const void* radio_context );
 /*!
  * @brief Fetch the results obtained during previous Wi-Fi scan
  *
+ * The results are appended to the ones already held in result, so that a scan split on several channel sets can be
+ * gathered pass after pass. Access points already held are skipped, and results are dropped once result is full.
+ *
  * @param [in] radio_context Chip implementation context
- * @param [out] result Scan results \ref wifi_scan_all_result_t
+ * @param [in,out] result Scan results \ref wifi_scan_all_result_t
  *
  * @return Geolocation service return code as defined in @ref mw_return_code_t
  * @retval MW_RC_OK         Command executed without errors
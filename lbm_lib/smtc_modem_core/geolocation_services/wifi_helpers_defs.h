@@ -81,6 +81,22 @@ extern "C" {
  */
 #define WIFI_AP_ADDRESS_SIZE ( 6 )
 
+/*!
+ * @brief The number of results read from the radio in a single command
+ */
+#define WIFI_READ_RESULTS_BATCH_SIZE ( 4 )
+
+/*!
+ * @brief The channels scanned first, where most access points are deployed
+ */
+#define WIFI_FIRST_PASS_CHANNELS \
+    ( LR11XX_WIFI_CHANNEL_1_MASK | LR11XX_WIFI_CHANNEL_6_MASK | LR11XX_WIFI_CHANNEL_11_MASK )
+
+/*!
+ * @brief The minimal RSSI of a fixed access point for it to count toward the early stop of a scan, in dBm
+ */
+#define WIFI_STRONG_AP_RSSI_MIN ( -85 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -0,0 +1,229 @@
+/*!
+ * \file      smtc_modem_dbg_latency.c
+ *
+ * \brief     Latency histograms of the uplinks, downlinks and joins
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // for memset
+
+#include "smtc_modem_dbg_latency.h"
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct latency_histogram_s
+{
+    uint32_t count;
+    uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS];
+    uint32_t start_ms[NUMBER_OF_STACKS];
+    bool     started[NUMBER_OF_STACKS];
+} latency_histogram_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static latency_histogram_t latency_histograms[SMTC_LATENCY_NB_HISTOGRAMS];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * Index of the bucket of a duration: 0 below 1 ms, otherwise the bit length of the duration
+ */
+static uint8_t latency_get_bucket( uint32_t duration_ms );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_modem_dbg_latency_init( void )
+{
+    for( uint8_t i = 0; i < SMTC_LATENCY_NB_HISTOGRAMS; i++ )
+    {
+        latency_histograms[i].count = 0;
+        memset( latency_histograms[i].buckets, 0, sizeof( latency_histograms[i].buckets ) );
+    }
+}
+
+void smtc_modem_dbg_latency_start( smtc_modem_dbg_latency_t latency, uint8_t stack_id )
+{
+    if( ( latency >= SMTC_LATENCY_NB_HISTOGRAMS ) || ( stack_id >= NUMBER_OF_STACKS ) )
+    {
+        return;
+    }
+    latency_histograms[latency].start_ms[stack_id] = smtc_modem_hal_get_time_in_ms( );
+    latency_histograms[latency].started[stack_id]  = true;
+}
+
+void smtc_modem_dbg_latency_stop( smtc_modem_dbg_latency_t latency, uint8_t stack_id )
+{
+    if( ( latency >= SMTC_LATENCY_NB_HISTOGRAMS ) || ( stack_id >= NUMBER_OF_STACKS ) ||
+        ( latency_histograms[latency].started[stack_id] == false ) )
+    {
+        return;
+    }
+    latency_histograms[latency].started[stack_id] = false;
+
+    // Unsigned difference handles the wrap of the modem time
+    smtc_modem_dbg_latency_add( latency,
+                                smtc_modem_hal_get_time_in_ms( ) - latency_histograms[latency].start_ms[stack_id] );
+}
+
+void smtc_modem_dbg_latency_cancel( smtc_modem_dbg_latency_t latency, uint8_t stack_id )
+{
+    if( ( latency >= SMTC_LATENCY_NB_HISTOGRAMS ) || ( stack_id >= NUMBER_OF_STACKS ) )
+    {
+        return;
+    }
+    latency_histograms[latency].started[stack_id] = false;
+}
+
+void smtc_modem_dbg_latency_add( smtc_modem_dbg_latency_t latency, uint32_t duration_ms )
+{
+    if( latency >= SMTC_LATENCY_NB_HISTOGRAMS )
+    {
+        return;
+    }
+    latency_histogram_t* histogram = &latency_histograms[latency];
+
+    // Saturate rather than wrap so that a long run never makes the histogram lie
+    if( histogram->count == UINT32_MAX )
+    {
+        return;
+    }
+    histogram->count++;
+    histogram->buckets[latency_get_bucket( duration_ms )]++;
+}
+
+uint32_t smtc_modem_dbg_latency_get_histogram( smtc_modem_dbg_latency_t latency,
+                                               uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS] )
+{
+    if( latency >= SMTC_LATENCY_NB_HISTOGRAMS )
+    {
+        memset( buckets, 0, SMTC_MODEM_DBG_LATENCY_NB_BUCKETS * sizeof( uint32_t ) );
+        return 0;
+    }
+    memcpy( buckets, latency_histograms[latency].buckets, sizeof( latency_histograms[latency].buckets ) );
+    return latency_histograms[latency].count;
+}
+
+uint32_t smtc_modem_dbg_latency_get_percentile_ms( smtc_modem_dbg_latency_t latency, uint8_t percent )
+{
+    if( latency >= SMTC_LATENCY_NB_HISTOGRAMS )
+    {
+        return 0;
+    }
+
+    uint8_t bucket = smtc_modem_dbg_latency_get_bucket_percentile( latency_histograms[latency].buckets, percent );
+    if( bucket >= SMTC_MODEM_DBG_LATENCY_NB_BUCKETS )
+    {
+        return 0;
+    }
+    if( bucket == ( SMTC_MODEM_DBG_LATENCY_NB_BUCKETS - 1 ) )
+    {
+        return SMTC_MODEM_DBG_LATENCY_OVERFLOW_MS;
+    }
+    return ( uint32_t ) 1 << bucket;
+}
+
+uint8_t smtc_modem_dbg_latency_get_bucket_percentile( const uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS],
+                                                      uint8_t        percent )
+{
+    uint64_t count = 0;
+
+    for( uint8_t bucket = 0; bucket < SMTC_MODEM_DBG_LATENCY_NB_BUCKETS; bucket++ )
+    {
+        count += buckets[bucket];
+    }
+    if( ( count == 0 ) || ( percent == 0 ) )
+    {
+        return SMTC_MODEM_DBG_LATENCY_NB_BUCKETS;
+    }
+
+    // Rank of the percentile, rounded up so that p100 is the largest recorded duration
+    uint8_t  clamped    = ( percent > 100 ) ? 100 : percent;
+    uint64_t rank       = ( count * clamped + 99 ) / 100;
+    uint64_t cumulative = 0;
+
+    for( uint8_t bucket = 0; bucket < ( SMTC_MODEM_DBG_LATENCY_NB_BUCKETS - 1 ); bucket++ )
+    {
+        cumulative += buckets[bucket];
+        if( cumulative >= rank )
+        {
+            return bucket;
+        }
+    }
+    return SMTC_MODEM_DBG_LATENCY_NB_BUCKETS - 1;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint8_t latency_get_bucket( uint32_t duration_ms )
+{
+    uint8_t bucket = 0;
+
+    while( ( duration_ms != 0 ) && ( bucket < ( SMTC_MODEM_DBG_LATENCY_NB_BUCKETS - 1 ) ) )
+    {
+        duration_ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,166 @@
+/*!
+ * \file      smtc_modem_dbg_latency.h
+ *
+ * \brief     Latency histograms of the uplinks, downlinks and joins
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SMTC_MODEM_DBG_LATENCY_H
+#define SMTC_MODEM_DBG_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*!
+ * Start, stop or cancel a latency measure of a stack, or record a duration measured by the caller. A STOP without a
+ * pending START is ignored, a second START restarts the measure. All expand to nothing when the modem is built
+ * without LBM_LATENCY_HISTOGRAM.
+ */
+#if defined( ADD_SMTC_LATENCY_HISTOGRAM )
+#define SMTC_MODEM_HAL_LATENCY_START( latency, stack_id ) smtc_modem_dbg_latency_start( latency, stack_id )
+#define SMTC_MODEM_HAL_LATENCY_STOP( latency, stack_id ) smtc_modem_dbg_latency_stop( latency, stack_id )
+#define SMTC_MODEM_HAL_LATENCY_CANCEL( latency, stack_id ) smtc_modem_dbg_latency_cancel( latency, stack_id )
+#define SMTC_MODEM_HAL_LATENCY_ADD( latency, duration_ms ) smtc_modem_dbg_latency_add( latency, duration_ms )
+#else
+#define SMTC_MODEM_HAL_LATENCY_START( latency, stack_id )
+#define SMTC_MODEM_HAL_LATENCY_STOP( latency, stack_id )
+#define SMTC_MODEM_HAL_LATENCY_CANCEL( latency, stack_id )
+#define SMTC_MODEM_HAL_LATENCY_ADD( latency, duration_ms )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * Number of buckets of a histogram. Bucket 0 counts the durations below 1 ms, bucket k the durations in
+ * [2^(k-1), 2^k) ms and the last bucket all the durations from 2^(NB_BUCKETS - 2) ms (about 18 hours)
+ */
+#define SMTC_MODEM_DBG_LATENCY_NB_BUCKETS 28
+
+/*!
+ * Percentile value returned when the percentile falls in the last, open, bucket
+ */
+#define SMTC_MODEM_DBG_LATENCY_OVERFLOW_MS UINT32_MAX
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * Measured latencies, the value is the index of the histogram in the exported table
+ */
+typedef enum smtc_modem_dbg_latency_e
+{
+    SMTC_LATENCY_UPLINK = 0,  // smtc_modem_request_uplink() to its SMTC_MODEM_EVENT_TXDONE
+    SMTC_LATENCY_DOWNLINK,    // end of the reception to its SMTC_MODEM_EVENT_DOWNDATA
+    SMTC_LATENCY_JOIN,        // smtc_modem_join_network() to SMTC_MODEM_EVENT_JOINED
+    SMTC_LATENCY_NB_HISTOGRAMS
+} smtc_modem_dbg_latency_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * Clear all the histograms, the pending measures are kept
+ */
+void smtc_modem_dbg_latency_init( void );
+
+/*!
+ * Start a measure, use SMTC_MODEM_HAL_LATENCY_START instead of calling it
+ */
+void smtc_modem_dbg_latency_start( smtc_modem_dbg_latency_t latency, uint8_t stack_id );
+
+/*!
+ * End a measure and record it, use SMTC_MODEM_HAL_LATENCY_STOP instead of calling it
+ */
+void smtc_modem_dbg_latency_stop( smtc_modem_dbg_latency_t latency, uint8_t stack_id );
+
+/*!
+ * Drop a pending measure, use SMTC_MODEM_HAL_LATENCY_CANCEL instead of calling it
+ */
+void smtc_modem_dbg_latency_cancel( smtc_modem_dbg_latency_t latency, uint8_t stack_id );
+
+/*!
+ * Record a duration, use SMTC_MODEM_HAL_LATENCY_ADD instead of calling it
+ */
+void smtc_modem_dbg_latency_add( smtc_modem_dbg_latency_t latency, uint32_t duration_ms );
+
+/*!
+ * Get the bucket counts of a histogram, all 0 if nothing has been recorded
+ *
+ * @return uint32_t Number of recorded durations
+ */
+uint32_t smtc_modem_dbg_latency_get_histogram( smtc_modem_dbg_latency_t latency,
+                                               uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS] );
+
+/*!
+ * Get a percentile of a histogram, as the upper bound in ms of the bucket holding it
+ *
+ * @param [in] latency  Histogram
+ * @param [in] percent  Percentile, from 1 to 100
+ * @return uint32_t 0 if nothing has been recorded, SMTC_MODEM_DBG_LATENCY_OVERFLOW_MS if in the last bucket
+ */
+uint32_t smtc_modem_dbg_latency_get_percentile_ms( smtc_modem_dbg_latency_t latency, uint8_t percent );
+
+/*!
+ * Get the bucket holding a percentile of bucket counts, for example the difference of two reads of a histogram
+ *
+ * @param [in] buckets  Bucket counts
+ * @param [in] percent  Percentile, from 1 to 100
+ * @return uint8_t Bucket index, SMTC_MODEM_DBG_LATENCY_NB_BUCKETS if all the counts are 0
+ */
+uint8_t smtc_modem_dbg_latency_get_bucket_percentile( const uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS],
+                                                      uint8_t        percent );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SMTC_MODEM_DBG_LATENCY_H
+
+/* --- EOF ------------------------------------------------------------------ */
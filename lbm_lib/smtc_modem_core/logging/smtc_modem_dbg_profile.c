@@ -0,0 +1,209 @@
+/*!
+ * \file      smtc_modem_dbg_profile.c
+ *
+ * \brief     Hot path execution time profiling
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // for memset
+
+#include "smtc_modem_dbg_profile.h"
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*!
+ * Core clock in MHz. When defined the Cortex-M DWT cycle counter is used as time source (Cortex-M3 and above),
+ * otherwise the modem hal time is used
+ */
+#if defined( MODEM_DBG_PROFILE_DWT_CPU_MHZ )
+#define PROFILE_DEMCR ( *( volatile uint32_t* ) 0xE000EDFCUL )
+#define PROFILE_DWT_CTRL ( *( volatile uint32_t* ) 0xE0001000UL )
+#define PROFILE_DWT_CYCCNT ( *( volatile uint32_t* ) 0xE0001004UL )
+#define PROFILE_DEMCR_TRCENA ( 1UL << 24 )
+#define PROFILE_DWT_CTRL_CYCCNTENA ( 1UL << 0 )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct profile_section_s
+{
+    uint32_t start_ticks;
+    uint32_t count;
+    uint32_t min_ticks;
+    uint32_t max_ticks;
+    uint64_t total_ticks;
+    uint8_t  depth;
+} profile_section_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static profile_section_t profile_sections[SMTC_PROFILE_NB_SECTIONS];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * Current time in ticks of the profiling time source
+ */
+static inline uint32_t profile_get_ticks( void );
+
+/*!
+ * Convert a duration from ticks to us
+ */
+static inline uint32_t profile_ticks_to_us( uint64_t ticks );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_modem_dbg_profile_init( void )
+{
+    memset( profile_sections, 0, sizeof( profile_sections ) );
+#if defined( MODEM_DBG_PROFILE_DWT_CPU_MHZ )
+    PROFILE_DEMCR |= PROFILE_DEMCR_TRCENA;
+    PROFILE_DWT_CYCCNT = 0;
+    PROFILE_DWT_CTRL |= PROFILE_DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+void smtc_modem_dbg_profile_begin( smtc_modem_dbg_profile_section_t section )
+{
+    if( section >= SMTC_PROFILE_NB_SECTIONS )
+    {
+        return;
+    }
+    profile_section_t* profile = &profile_sections[section];
+
+    if( profile->depth++ == 0 )
+    {
+        profile->start_ticks = profile_get_ticks( );
+    }
+}
+
+void smtc_modem_dbg_profile_end( smtc_modem_dbg_profile_section_t section )
+{
+    uint32_t end_ticks = profile_get_ticks( );
+
+    if( section >= SMTC_PROFILE_NB_SECTIONS )
+    {
+        return;
+    }
+    profile_section_t* profile = &profile_sections[section];
+
+    // Unbalanced END, or END of a nested section: nothing to record
+    if( ( profile->depth == 0 ) || ( --profile->depth != 0 ) )
+    {
+        return;
+    }
+
+    // Unsigned difference handles the wrap of the time source
+    uint32_t duration_ticks = end_ticks - profile->start_ticks;
+
+    if( ( profile->count == 0 ) || ( duration_ticks < profile->min_ticks ) )
+    {
+        profile->min_ticks = duration_ticks;
+    }
+    if( duration_ticks > profile->max_ticks )
+    {
+        profile->max_ticks = duration_ticks;
+    }
+    profile->total_ticks += duration_ticks;
+    profile->count++;
+}
+
+void smtc_modem_dbg_profile_get_stats( smtc_modem_dbg_profile_section_t section,
+                                       smtc_modem_dbg_profile_stats_t*  stats )
+{
+    memset( stats, 0, sizeof( smtc_modem_dbg_profile_stats_t ) );
+
+    if( ( section >= SMTC_PROFILE_NB_SECTIONS ) || ( profile_sections[section].count == 0 ) )
+    {
+        return;
+    }
+    const profile_section_t* profile = &profile_sections[section];
+
+    stats->count  = profile->count;
+    stats->min_us = profile_ticks_to_us( profile->min_ticks );
+    stats->avg_us = profile_ticks_to_us( profile->total_ticks / profile->count );
+    stats->max_us = profile_ticks_to_us( profile->max_ticks );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static inline uint32_t profile_get_ticks( void )
+{
+#if defined( MODEM_DBG_PROFILE_DWT_CPU_MHZ )
+    return PROFILE_DWT_CYCCNT;
+#elif defined( ADD_RP_US_TIMEBASE )
+    return smtc_modem_hal_get_time_in_us( );
+#else
+    // Without the microsecond timebase the resolution is the millisecond
+    return smtc_modem_hal_get_time_in_ms( ) * 1000;
+#endif
+}
+
+static inline uint32_t profile_ticks_to_us( uint64_t ticks )
+{
+#if defined( MODEM_DBG_PROFILE_DWT_CPU_MHZ )
+    return ( uint32_t ) ( ticks / MODEM_DBG_PROFILE_DWT_CPU_MHZ );
+#else
+    return ( uint32_t ) ticks;
+#endif
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,136 @@
+/*!
+ * \file      smtc_modem_dbg_profile.h
+ *
+ * \brief     Hot path execution time profiling
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SMTC_MODEM_DBG_PROFILE_H
+#define SMTC_MODEM_DBG_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*!
+ * Open and close a profiled section. A section is measured from its outermost BEGIN to the matching END, nested or
+ * re-entrant calls of the same section are ignored. Both expand to nothing when the modem is built without
+ * LBM_PROFILE, every BEGIN shall be matched by an END on all paths.
+ */
+#if defined( ADD_SMTC_PROFILE )
+#define SMTC_MODEM_HAL_PROFILE_BEGIN( section ) smtc_modem_dbg_profile_begin( section )
+#define SMTC_MODEM_HAL_PROFILE_END( section ) smtc_modem_dbg_profile_end( section )
+#else
+#define SMTC_MODEM_HAL_PROFILE_BEGIN( section )
+#define SMTC_MODEM_HAL_PROFILE_END( section )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * Profiled sections, the value is the index of the section in the exported table
+ */
+typedef enum smtc_modem_dbg_profile_section_e
+{
+    SMTC_PROFILE_RP_ARBITER = 0,      // radio planner task arbitration
+    SMTC_PROFILE_RP_IRQ_STATUS,       // radio irq status read and clear by the radio planner
+    SMTC_PROFILE_MAC_RADIO_CALLBACK,  // lorawan stack handling of its tx done / rx done / timeout
+    SMTC_PROFILE_CRYPTO_UPLINK,       // uplink payload encryption and mic
+    SMTC_PROFILE_CRYPTO_DOWNLINK,     // downlink mic check
+    SMTC_PROFILE_CONTEXT_STORE,       // lorawan context write in nvm
+    SMTC_PROFILE_SUPERVISOR_ENGINE,   // one run of the modem supervisor
+    SMTC_PROFILE_MODEM_INIT,          // smtc_modem_init, from boot to ready
+    SMTC_PROFILE_NB_SECTIONS
+} smtc_modem_dbg_profile_section_t;
+
+/*!
+ * Statistics of a section, durations in us
+ */
+typedef struct smtc_modem_dbg_profile_stats_s
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+} smtc_modem_dbg_profile_stats_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * Clear the statistics of all sections and start the cycle counter when it is used
+ */
+void smtc_modem_dbg_profile_init( void );
+
+/*!
+ * Start a measure of a section, use SMTC_MODEM_HAL_PROFILE_BEGIN instead of calling it
+ */
+void smtc_modem_dbg_profile_begin( smtc_modem_dbg_profile_section_t section );
+
+/*!
+ * End a measure of a section, use SMTC_MODEM_HAL_PROFILE_END instead of calling it
+ */
+void smtc_modem_dbg_profile_end( smtc_modem_dbg_profile_section_t section );
+
+/*!
+ * Get the statistics of a section, all fields are 0 if the section has never been measured
+ */
+void smtc_modem_dbg_profile_get_stats( smtc_modem_dbg_profile_section_t section,
+                                       smtc_modem_dbg_profile_stats_t*  stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SMTC_MODEM_DBG_PROFILE_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Decode the deferred binary traces of LoRa Basics Modem (LBM_TRACE_DEFERRED=yes)
+
+The format strings are read from the firmware ELF file, the records are read from a file or from the standard input,
+for example a capture of the trace uart:
+
+    smtc_modem_dbg_trace_decode.py firmware.elf trace_capture.bin
+
+The record layout is described in smtc_modem_dbg_trace_deferred.h.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+TRACE_SYNC = 0xA5
+TRACE_HEADER_SIZE = 6
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaAn%])")
+
+
+class ElfImage:
+    """Memory image of the allocated sections of an ELF file, to read the format strings at their address"""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf_file:
+            self.data = elf_file.read()
+        if self.data[0:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+        is_64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if is_64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x3A)
+            section_format = endian + "IIQQQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x2E)
+            section_format = endian + "IIIIII"
+        self.sections = []
+        for index in range(shnum):
+            _, sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack_from(
+                section_format, self.data, shoff + index * shentsize
+            )
+            if (sh_flags & SHF_ALLOC) and sh_type != SHT_NOBITS and sh_size > 0:
+                self.sections.append((sh_addr, sh_offset, sh_size))
+
+    def get_string(self, address):
+        for sh_addr, sh_offset, sh_size in self.sections:
+            # The address is recorded on 32 bits
+            if (sh_addr & 0xFFFFFFFF) <= address < (sh_addr & 0xFFFFFFFF) + sh_size:
+                start = sh_offset + address - (sh_addr & 0xFFFFFFFF)
+                end = self.data.find(b"\0", start, sh_offset + sh_size)
+                if end < 0:
+                    return None
+                return self.data[start:end].decode("utf-8", errors="replace")
+        return None
+
+
+def format_trace(fmt, args):
+    """Format a trace as printf would, from the raw arguments of the record"""
+    output = []
+    position = 0
+    offset = 0
+
+    def take(size):
+        nonlocal offset
+        if offset + size > len(args):
+            offset = len(args)
+            return None
+        value = int.from_bytes(args[offset : offset + size], "little")
+        offset += size
+        return value
+
+    for match in CONVERSION.finditer(fmt):
+        output.append(fmt[position : match.start()])
+        position = match.end()
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == "%":
+            output.append("%")
+            continue
+        if width == "*":
+            value = take(4)
+            width = str(value if value is not None and value < 0x80000000 else 0)
+        if precision == "*":
+            value = take(4)
+            precision = str(value if value is not None and value < 0x80000000 else 0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+
+        if conversion == "s":
+            end = args.find(b"\0", offset)
+            end = len(args) if end < 0 else end
+            value = args[offset:end].decode("utf-8", errors="replace")
+            offset = end + 1
+            output.append((spec + "s") % value)
+        elif conversion in "fFeEgGaA":
+            value = take(8)
+            if value is None:
+                output.append("?")
+                continue
+            value = struct.unpack("<d", struct.pack("<Q", value))[0]
+            output.append((spec + ("f" if conversion in "aA" else conversion)) % value)
+        elif conversion == "n":
+            continue
+        else:
+            size = 8 if length in ("ll", "j") else 4
+            value = take(size)
+            if value is None:
+                output.append("?")
+                continue
+            if length == "hh":
+                value &= 0xFF
+            elif length == "h":
+                value &= 0xFFFF
+            if conversion in "di":
+                bits = {"hh": 8, "h": 16}.get(length, size * 8)
+                if value >= 1 << (bits - 1):
+                    value -= 1 << bits
+                output.append((spec + "d") % value)
+            elif conversion == "u":
+                output.append((spec + "d") % value)
+            elif conversion == "c":
+                output.append((spec + "c") % chr(value & 0xFF))
+            elif conversion == "p":
+                output.append("0x%08x" % value)
+            else:
+                output.append((spec + conversion) % value)
+
+    output.append(fmt[position:])
+    return "".join(output)
+
+
+def decode(elf, stream, output):
+    buffer = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buffer += chunk
+        while len(buffer) >= TRACE_HEADER_SIZE:
+            if buffer[0] != TRACE_SYNC or buffer[1] < TRACE_HEADER_SIZE:
+                buffer = buffer[1:]
+                continue
+            size = buffer[1]
+            if len(buffer) < size:
+                break
+            address = int.from_bytes(buffer[2:6], "little")
+            args = buffer[TRACE_HEADER_SIZE:size]
+            if address == 0:
+                output.write("\n[%d traces dropped]\n" % int.from_bytes(args[0:4], "little"))
+            else:
+                fmt = elf.get_string(address)
+                if fmt is None:
+                    # Not a record, resynchronize on the next sync byte
+                    buffer = buffer[1:]
+                    continue
+                output.write(format_trace(fmt, args))
+            buffer = buffer[size:]
+        output.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the deferred binary traces of LoRa Basics Modem")
+    parser.add_argument("elf", help="firmware ELF file")
+    parser.add_argument("input", nargs="?", help="binary trace capture, standard input if not given")
+    arguments = parser.parse_args()
+
+    elf = ElfImage(arguments.elf)
+    if arguments.input is None:
+        decode(elf, sys.stdin.buffer, sys.stdout)
+    else:
+        with open(arguments.input, "rb") as stream:
+            decode(elf, stream, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
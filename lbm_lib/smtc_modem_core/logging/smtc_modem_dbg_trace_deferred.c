@@ -0,0 +1,323 @@
+/*!
+ * \file      smtc_modem_dbg_trace_deferred.c
+ *
+ * \brief     Deferred binary trace: the traces are recorded in a RAM ring and formatted on the host
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stdarg.h>   // for va_list
+#include <string.h>   // for memcpy
+
+#include "smtc_modem_dbg_trace_deferred.h"
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#if( SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE < ( 2 * SMTC_MODEM_DBG_TRACE_DEFERRED_RECORD_MAX_SIZE ) ) || \
+    ( SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE > 32768 )
+#error "SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE shall be in [510, 32768]"
+#endif
+
+// Size of the record telling the number of dropped traces
+#define TRACE_DROPPED_RECORD_SIZE ( SMTC_MODEM_DBG_TRACE_DEFERRED_HEADER_SIZE + 4 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint8_t  trace_ring[SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE];
+static uint16_t trace_ring_head;  // next byte written
+static uint16_t trace_ring_tail;  // next byte sent, the ring is empty when head == tail
+static uint32_t trace_dropped;
+static uint32_t trace_dropped_reported;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * Build a record from the format string and its arguments, the arguments not fitting in the record are not recorded
+ *
+ * \return Size of the record
+ */
+static uint8_t trace_record_build( uint8_t* record, const char* fmt, va_list args );
+
+/*!
+ * Append a little endian value of size bytes to a record
+ *
+ * \return New size of the record, unchanged if the value does not fit
+ */
+static uint8_t trace_record_put( uint8_t* record, uint8_t record_size, uint64_t value, uint8_t size );
+
+/*!
+ * Number of bytes that can be written in the ring, one byte is kept free to tell a full ring from an empty one
+ */
+static uint16_t trace_ring_get_free( void );
+
+/*!
+ * Write bytes in the ring, the caller checks the free space
+ */
+static void trace_ring_write( const uint8_t* data, uint8_t size );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_modem_dbg_trace_deferred_print( const char* fmt, ... )
+{
+    uint8_t record[SMTC_MODEM_DBG_TRACE_DEFERRED_RECORD_MAX_SIZE];
+    va_list args;
+
+    va_start( args, fmt );
+    const uint8_t record_size = trace_record_build( record, fmt, args );
+    va_end( args );
+
+    smtc_modem_hal_disable_modem_irq( );
+    uint16_t needed_size = record_size;
+    if( trace_dropped != trace_dropped_reported )
+    {
+        needed_size += TRACE_DROPPED_RECORD_SIZE;
+    }
+    if( trace_ring_get_free( ) >= needed_size )
+    {
+        if( trace_dropped != trace_dropped_reported )
+        {
+            uint8_t dropped_record[TRACE_DROPPED_RECORD_SIZE] = { SMTC_MODEM_DBG_TRACE_DEFERRED_SYNC,
+                                                                  TRACE_DROPPED_RECORD_SIZE };
+            trace_record_put( dropped_record, SMTC_MODEM_DBG_TRACE_DEFERRED_HEADER_SIZE,
+                              trace_dropped - trace_dropped_reported, 4 );
+            trace_ring_write( dropped_record, TRACE_DROPPED_RECORD_SIZE );
+            trace_dropped_reported = trace_dropped;
+        }
+        trace_ring_write( record, record_size );
+    }
+    else
+    {
+        trace_dropped++;
+    }
+    smtc_modem_hal_enable_modem_irq( );
+}
+
+uint16_t smtc_modem_dbg_trace_deferred_get( const uint8_t** data )
+{
+    smtc_modem_hal_disable_modem_irq( );
+    const uint16_t head = trace_ring_head;
+    smtc_modem_hal_enable_modem_irq( );
+
+    *data = &trace_ring[trace_ring_tail];
+    if( head >= trace_ring_tail )
+    {
+        return head - trace_ring_tail;
+    }
+    return SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE - trace_ring_tail;
+}
+
+void smtc_modem_dbg_trace_deferred_release( uint16_t size )
+{
+    smtc_modem_hal_disable_modem_irq( );
+    trace_ring_tail = ( trace_ring_tail + size ) % SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE;
+    smtc_modem_hal_enable_modem_irq( );
+}
+
+uint32_t smtc_modem_dbg_trace_deferred_get_dropped( void )
+{
+    return trace_dropped;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint8_t trace_record_build( uint8_t* record, const char* fmt, va_list args )
+{
+    const uint32_t fmt_address = ( uint32_t ) ( uintptr_t ) fmt;
+    uint8_t        size        = 2;
+
+    record[0] = SMTC_MODEM_DBG_TRACE_DEFERRED_SYNC;
+    size      = trace_record_put( record, size, fmt_address, 4 );
+
+    while( *fmt != '\0' )
+    {
+        if( *fmt++ != '%' )
+        {
+            continue;
+        }
+
+        // Skip the flags, width, precision and length modifiers up to the conversion specifier
+        uint8_t nb_long = 0;
+        bool    done    = false;
+        while( ( *fmt != '\0' ) && ( done == false ) )
+        {
+            done = true;
+            switch( *fmt++ )
+            {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c':
+                if( nb_long >= 2 )
+                {
+                    size = trace_record_put( record, size, va_arg( args, unsigned long long ), 8 );
+                }
+                else if( nb_long == 1 )
+                {
+                    size = trace_record_put( record, size, va_arg( args, unsigned long ), 4 );
+                }
+                else
+                {
+                    size = trace_record_put( record, size, va_arg( args, unsigned int ), 4 );
+                }
+                break;
+            case 'p':
+                size = trace_record_put( record, size, ( uintptr_t ) va_arg( args, void* ), 4 );
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                const double value = va_arg( args, double );
+                uint64_t     bits;
+                memcpy( &bits, &value, sizeof( bits ) );
+                size = trace_record_put( record, size, bits, 8 );
+                break;
+            }
+            case 's':
+            {
+                // The characters are copied, the string may not be in the firmware image
+                const char* string = va_arg( args, const char* );
+                if( string == NULL )
+                {
+                    string = "";
+                }
+                while( ( *string != '\0' ) && ( size < ( SMTC_MODEM_DBG_TRACE_DEFERRED_RECORD_MAX_SIZE - 1 ) ) )
+                {
+                    record[size++] = ( uint8_t ) *string++;
+                }
+                if( size < SMTC_MODEM_DBG_TRACE_DEFERRED_RECORD_MAX_SIZE )
+                {
+                    record[size++] = 0;
+                }
+                break;
+            }
+            case 'n':
+                ( void ) va_arg( args, void* );
+                break;
+            case '*':
+                size = trace_record_put( record, size, va_arg( args, unsigned int ), 4 );
+                done = false;
+                break;
+            case 'l':
+                nb_long++;
+                done = false;
+                break;
+            case 'j':
+                nb_long = 2;
+                done    = false;
+                break;
+            case 'z':
+            case 't':
+                nb_long = 1;
+                done    = false;
+                break;
+            case '%':
+                break;
+            default:
+                // flags, width, precision, 'h' and 'L'
+                done = false;
+                break;
+            }
+        }
+    }
+
+    record[1] = size;
+    return size;
+}
+
+static uint8_t trace_record_put( uint8_t* record, uint8_t record_size, uint64_t value, uint8_t size )
+{
+    if( ( record_size + size ) > SMTC_MODEM_DBG_TRACE_DEFERRED_RECORD_MAX_SIZE )
+    {
+        return record_size;
+    }
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        record[record_size++] = ( uint8_t ) ( value >> ( 8 * i ) );
+    }
+    return record_size;
+}
+
+static uint16_t trace_ring_get_free( void )
+{
+    return ( trace_ring_tail + SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE - trace_ring_head - 1 ) %
+           SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE;
+}
+
+static void trace_ring_write( const uint8_t* data, uint8_t size )
+{
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        trace_ring[trace_ring_head] = data[i];
+        trace_ring_head             = ( trace_ring_head + 1 ) % SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,121 @@
+/*!
+ * \file      smtc_modem_dbg_trace_deferred.h
+ *
+ * \brief     Deferred binary trace: the traces are recorded in a RAM ring and formatted on the host
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SMTC_MODEM_DBG_TRACE_DEFERRED_H
+#define SMTC_MODEM_DBG_TRACE_DEFERRED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * Size of the RAM ring in bytes, the traces recorded while it is full are dropped and counted
+ */
+#ifndef SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE
+#define SMTC_MODEM_DBG_TRACE_DEFERRED_BUFFER_SIZE 2048
+#endif
+
+/*!
+ * Record layout, all fields little endian:
+ * | sync 0xA5 (1) | record size (1) | format string address (4) | arguments |
+ *
+ * The format string address is decoded on the host with the string table of the firmware ELF file. The arguments are
+ * recorded in the order of the format string: 4 bytes for the integers, pointers and characters, 8 bytes for the long
+ * long integers and the floating point values, the characters of the strings with their terminating 0. A record with a
+ * format string address of 0 tells the number of dropped traces in a 4 bytes argument.
+ */
+#define SMTC_MODEM_DBG_TRACE_DEFERRED_SYNC 0xA5
+#define SMTC_MODEM_DBG_TRACE_DEFERRED_HEADER_SIZE 6
+#define SMTC_MODEM_DBG_TRACE_DEFERRED_RECORD_MAX_SIZE 255
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * Record a trace, used by SMTC_MODEM_HAL_TRACE_PRINTF when the modem is built with LBM_TRACE_DEFERRED. Only the
+ * conversion specifiers of the format string are parsed, the trace is formatted on the host.
+ */
+void smtc_modem_dbg_trace_deferred_print( const char* fmt, ... );
+
+/*!
+ * Get the oldest recorded bytes to send them, typically by a dma transfer in idle time
+ *
+ * \param [out] data Oldest recorded bytes, valid until they are released
+ * \return Number of contiguous bytes available at data, 0 if the ring is empty
+ */
+uint16_t smtc_modem_dbg_trace_deferred_get( const uint8_t** data );
+
+/*!
+ * Release the bytes returned by smtc_modem_dbg_trace_deferred_get once they are sent
+ *
+ * \param [in] size Number of sent bytes, at most the value returned by smtc_modem_dbg_trace_deferred_get
+ */
+void smtc_modem_dbg_trace_deferred_release( uint16_t size );
+
+/*!
+ * Number of traces dropped since the start because the ring was full
+ */
+uint32_t smtc_modem_dbg_trace_deferred_get_dropped( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SMTC_MODEM_DBG_TRACE_DEFERRED_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -46,6 +46,9 @@ extern "C" {
 #include <stdbool.h>  // bool type
 
 #include "smtc_modem_hal.h"
+#if defined( ADD_SMTC_TRACE_DEFERRED )
+#include "smtc_modem_dbg_trace_deferred.h"
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -104,7 +107,12 @@ extern "C" {
 
 #if ( MODEM_HAL_DBG_TRACE )
 
+    #if defined( ADD_SMTC_TRACE_DEFERRED )
+    // Recorded in a RAM ring, formatted on the host (LBM_TRACE_DEFERRED)
+    #define SMTC_MODEM_HAL_TRACE_PRINTF( ... )  smtc_modem_dbg_trace_deferred_print (  __VA_ARGS__ )
+    #else
     #define SMTC_MODEM_HAL_TRACE_PRINTF( ... )  smtc_modem_hal_print_trace (  __VA_ARGS__ )
+    #endif
 
     #define SMTC_MODEM_HAL_TRACE_MSG( msg )                                                         \
     do                                                                                              \
@@ -132,6 +132,17 @@ void lorawan_api_init( radio_planner_t* rp, uint8_t stack_id,
     smtc_beacon_sniff_init( &lr1_beacon_obj[stack_id], &ping_slot_obj[stack_id], &lr1_mac_obj[stack_id], rp,
                             RP_HOOK_ID_CLASS_B_BEACON + stack_id, lr1mac_downlink_callback );
 #endif
+
+#if defined( ADD_STACK_FAIRNESS )
+    rp_hook_set_stack_id( rp, RP_HOOK_ID_LR1MAC_STACK + stack_id, stack_id );
+#if defined( ADD_CLASS_C )
+    rp_hook_set_stack_id( rp, RP_HOOK_ID_CLASS_C + stack_id, stack_id );
+#endif
+#if defined( ADD_CLASS_B )
+    rp_hook_set_stack_id( rp, RP_HOOK_ID_CLASS_B_PING_SLOT + stack_id, stack_id );
+    rp_hook_set_stack_id( rp, RP_HOOK_ID_CLASS_B_BEACON + stack_id, stack_id );
+#endif
+#endif
 }
 
 smtc_real_region_types_t lorawan_api_get_region( uint8_t stack_id )
@@ -231,6 +242,14 @@ void lorawan_api_join_status_clear( uint8_t stack_id )
     lr1mac_core_join_status_clear( &lr1_mac_obj[stack_id] );
 }
 
+#if defined( ADD_SESSION_RESUME )
+status_lorawan_t lorawan_api_session_resume( uint8_t stack_id )
+{
+    PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
+    return lr1mac_core_session_resume( &lr1_mac_obj[stack_id] );
+}
+#endif
+
 status_lorawan_t lorawan_api_dr_strategy_set( dr_strategy_t dr_strategy, uint8_t stack_id )
 {
     PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
@@ -486,6 +505,27 @@ void lorawan_api_class_c_stop( uint8_t stack_id )
 }
 #endif
 
+bool lorawan_api_class_c_set_low_power( uint16_t preamble_len_symb, uint8_t stack_id )
+{
+    PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
+#if defined( ADD_CLASS_C ) && defined( ADD_CLASS_C_LOW_POWER )
+    lr1mac_class_c_set_low_power( &class_c_obj[stack_id], preamble_len_symb );
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint16_t lorawan_api_class_c_get_low_power( uint8_t stack_id )
+{
+    PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
+#if defined( ADD_CLASS_C ) && defined( ADD_CLASS_C_LOW_POWER )
+    return lr1mac_class_c_get_low_power( &class_c_obj[stack_id] );
+#else
+    return 0;
+#endif
+}
+
 lorawan_multicast_rc_t lorawan_api_multicast_set_group_session_keys( uint8_t       mc_group_id,
                                                                      const uint8_t mc_ntw_skey[LORAWAN_KEY_SIZE],
                                                                      const uint8_t mc_app_skey[LORAWAN_KEY_SIZE],
@@ -665,6 +705,30 @@ lorawan_multicast_rc_t lorawan_api_multicast_b_stop_all_sessions( uint8_t stack_
 #endif
 }
 
+lorawan_multicast_rc_t lorawan_api_multicast_b_set_listen_ratio( uint8_t mc_group_id, uint8_t listen_ratio,
+                                                                 uint8_t stack_id )
+{
+    PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
+#if defined( SMTC_MULTICAST ) && defined( ADD_CLASS_B ) && defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+    return ( lorawan_multicast_rc_t ) smtc_ping_slot_multicast_b_set_listen_ratio( &ping_slot_obj[stack_id],
+                                                                                   mc_group_id, listen_ratio );
+#else
+    return LORAWAN_MC_RC_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+lorawan_multicast_rc_t lorawan_api_multicast_b_get_listen_ratio( uint8_t mc_group_id, uint8_t* listen_ratio,
+                                                                 uint8_t stack_id )
+{
+    PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
+#if defined( SMTC_MULTICAST ) && defined( ADD_CLASS_B ) && defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+    return ( lorawan_multicast_rc_t ) smtc_ping_slot_multicast_b_get_listen_ratio( &ping_slot_obj[stack_id],
+                                                                                   mc_group_id, listen_ratio );
+#else
+    return LORAWAN_MC_RC_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
 void lorawan_api_set_no_rx_packet_threshold( uint16_t no_rx_packet_reset_threshold, uint8_t stack_id )
 {
     PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
@@ -880,6 +944,14 @@ void lorawan_api_beacon_get_statistics( smtc_beacon_statistics_t* beacon_statist
     PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
     smtc_beacon_sniff_get_statistics( &lr1_beacon_obj[stack_id], beacon_statistics );
 }
+
+bool lorawan_api_beacon_get_gps_time( uint32_t rtc_ms, uint32_t* seconds_since_epoch, uint32_t* fractional_second,
+                                      uint32_t* age_ms, uint8_t stack_id )
+{
+    PANIC_IF_STACK_ID_TOO_HIGH( stack_id );
+    return smtc_beacon_sniff_get_gps_time( &lr1_beacon_obj[stack_id], rtc_ms, seconds_since_epoch, fractional_second,
+                                           age_ms );
+}
 #endif
 
 status_lorawan_t lorawan_api_get_ping_slot_info_req_status( uint8_t stack_id )
@@ -936,6 +1008,46 @@ bool lorawan_api_get_current_enabled_frequencies_list( uint8_t* number_of_freq,
     return smtc_real_get_current_enabled_frequency_list( lr1_mac_obj[stack_id].real, number_of_freq, freq_list,
                                                          max_size );
 }
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+void lorawan_api_get_dtc_channel_stats( uint32_t* rerouted_uplinks, uint32_t* rerouted_toa_ms, uint8_t stack_id )
+{
+    smtc_real_get_dtc_channel_stats( lr1_mac_obj[stack_id].real, rerouted_uplinks, rerouted_toa_ms );
+}
+#endif
+#if defined( ADD_LINK_ADR )
+status_lorawan_t lorawan_api_set_link_adr_margin( uint8_t margin_db, uint8_t stack_id )
+{
+    return ( smtc_link_adr_set_margin( &lr1_mac_obj[stack_id].link_adr, margin_db ) == true ) ? OKLORAWAN
+                                                                                              : ERRORLORAWAN;
+}
+void lorawan_api_set_link_adr_power_control( bool enable, uint8_t stack_id )
+{
+    smtc_link_adr_set_power_control( &lr1_mac_obj[stack_id].link_adr, enable );
+    if( lr1_mac_obj[stack_id].adr_mode_select != STATIC_ADR_MODE )
+    {
+        // Back to the maximum EIRP until the next uplink applies the power control again
+        lr1_mac_obj[stack_id].tx_power = lr1_mac_obj[stack_id].max_erp_dbm;
+    }
+}
+status_lorawan_t lorawan_api_set_link_adr_delivery_target( uint8_t target_percent, uint8_t stack_id )
+{
+    return ( smtc_link_adr_set_delivery_target( &lr1_mac_obj[stack_id].link_adr, target_percent ) == true )
+               ? OKLORAWAN
+               : ERRORLORAWAN;
+}
+void lorawan_api_set_link_adr_bulk( bool enable, uint8_t stack_id )
+{
+    smtc_link_adr_set_bulk( &lr1_mac_obj[stack_id].link_adr, enable );
+}
+bool lorawan_api_bulk_datarate_set( uint8_t size_in, uint8_t stack_id )
+{
+    return lr1mac_core_bulk_datarate_set( &lr1_mac_obj[stack_id], size_in );
+}
+void lorawan_api_bulk_datarate_restore( uint8_t stack_id )
+{
+    lr1mac_core_bulk_datarate_restore( &lr1_mac_obj[stack_id] );
+}
+#endif
 void lorawan_api_tx_ack_bit_set( uint8_t stack_id, bool enable )
 {
     lr1_stack_mac_tx_ack_bit_set( &lr1_mac_obj[stack_id], enable );
@@ -984,6 +1096,12 @@ void lorawan_api_set_time_of_nwk_ans( uint8_t stack_id, uint32_t target_time )
 {
     lr1mac_core_set_time_of_nwk_ans( &lr1_mac_obj[stack_id], target_time );
 }
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+status_lorawan_t lorawan_api_nwk_ans_piggyback( uint8_t stack_id, uint8_t size_in )
+{
+    return lr1mac_core_nwk_ans_piggyback( &lr1_mac_obj[stack_id], size_in );
+}
+#endif
 void lorawan_api_set_next_tx_at_time( uint8_t stack_id, bool is_send_at_time )
 {
     lr1mac_core_set_next_tx_at_time( &lr1_mac_obj[stack_id], is_send_at_time );
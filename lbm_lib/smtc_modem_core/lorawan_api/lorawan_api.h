@@ -192,6 +192,16 @@ join_status_t lorawan_api_isjoined( uint8_t stack_id );
  */
 void lorawan_api_join_status_clear( uint8_t stack_id );
 
+#if defined( ADD_SESSION_RESUME )
+/**
+ * @brief Resume the OTAA session stored before a reset, no join request is sent
+ *
+ * @param [in] stack_id Stack identifier
+ * @return status_lorawan_t OKLORAWAN if the device is joined with the stored session
+ */
+status_lorawan_t lorawan_api_session_resume( uint8_t stack_id );
+#endif
+
 /**
  * @brief Set datarate strategy
  * @remark The current implementation support 4 different dataRate Strategy :
@@ -461,6 +471,23 @@ bool lorawan_api_class_c_is_running( uint8_t stack_id );
  */
 void lorawan_api_class_c_stop( uint8_t stack_id );
 
+/**
+ * @brief Set the preamble length of the duty-cycled class C reception
+ *
+ * @param [in] preamble_len_symb Preamble length in symbols agreed with the network, 0 for continuous reception
+ * @param [in] stack_id          Stack identifier
+ * @return true if duty-cycled class C reception is available
+ */
+bool lorawan_api_class_c_set_low_power( uint16_t preamble_len_symb, uint8_t stack_id );
+
+/**
+ * @brief Get the preamble length of the duty-cycled class C reception
+ *
+ * @param [in] stack_id Stack identifier
+ * @return uint16_t Preamble length in symbols, 0 for continuous reception
+ */
+uint16_t lorawan_api_class_c_get_low_power( uint8_t stack_id );
+
 /**
  * @brief Configure a multicast group session keys
  *
@@ -623,6 +650,26 @@ lorawan_multicast_rc_t lorawan_api_multicast_b_stop_session( uint8_t mc_group_id
  */
 lorawan_multicast_rc_t lorawan_api_multicast_b_stop_all_sessions( uint8_t stack_id );
 
+/**
+ * @brief Set the ratio of ping slots listened by a class B multicast session
+ *
+ * @param [in] mc_group_id  The multicast group id
+ * @param [in] listen_ratio Listen one ping slot out of listen_ratio, 1 to listen all of them
+ * @return lorawan_multicast_rc_t
+ */
+lorawan_multicast_rc_t lorawan_api_multicast_b_set_listen_ratio( uint8_t mc_group_id, uint8_t listen_ratio,
+                                                                 uint8_t stack_id );
+
+/**
+ * @brief Get the ratio of ping slots listened by a class B multicast session
+ *
+ * @param [in]  mc_group_id  The multicast group id
+ * @param [out] listen_ratio One ping slot out of listen_ratio is listened
+ * @return lorawan_multicast_rc_t
+ */
+lorawan_multicast_rc_t lorawan_api_multicast_b_get_listen_ratio( uint8_t mc_group_id, uint8_t* listen_ratio,
+                                                                 uint8_t stack_id );
+
 /**
  * @brief set the ack bit for uplink
  *
@@ -919,6 +966,19 @@ void lorawan_api_beacon_sniff_stop( uint8_t stack_id );
  * @param [out] beacon_statistics The beacon statistics
  */
 void lorawan_api_beacon_get_statistics( smtc_beacon_statistics_t* beacon_statistics, uint8_t stack_id );
+
+/**
+ * @brief Get the GPS time from the last valid received beacon
+ *
+ * @param [in]  rtc_ms               Local rtc time to convert in ms
+ * @param [out] seconds_since_epoch  GPS time in seconds
+ * @param [out] fractional_second    Fractional part in ms
+ * @param [out] age_ms               Time elapsed since the beacon in ms
+ * @param [in]  stack_id             The stack ID requested
+ * @return bool                      false if the beacon is not locked
+ */
+bool lorawan_api_beacon_get_gps_time( uint32_t rtc_ms, uint32_t* seconds_since_epoch, uint32_t* fractional_second,
+                                      uint32_t* age_ms, uint8_t stack_id );
 #endif  // ADD_CLASS_B
 
 /**
@@ -997,6 +1057,69 @@ void lorawan_api_get_adr_ack_limit_delay( uint8_t* adr_ack_limit, uint8_t* adr_a
 bool lorawan_api_get_current_enabled_frequencies_list( uint8_t* number_of_freq, uint32_t* freq_list, uint8_t max_size,
                                                        uint8_t stack_id );
 
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+/**
+ * @brief Get the airtime aware channel selection statistics
+ *
+ * @param [out] rerouted_uplinks    Number of uplinks that left out a band without enough duty cycle budget
+ * @param [out] rerouted_toa_ms     Cumulated time on air of these uplinks in milliseconds
+ * @param [in]  stack_id            The stack ID requested
+ */
+void lorawan_api_get_dtc_channel_stats( uint32_t* rerouted_uplinks, uint32_t* rerouted_toa_ms, uint8_t stack_id );
+#endif
+
+#if defined( ADD_LINK_ADR )
+/**
+ * @brief Set the link margin kept by LINK_QUALITY_DR_DISTRIBUTION
+ *
+ * @param [in] margin_db    Margin in dB
+ * @param [in] stack_id     The stack ID requested
+ * @return status_lorawan_t ERRORLORAWAN if the margin is out of range
+ */
+status_lorawan_t lorawan_api_set_link_adr_margin( uint8_t margin_db, uint8_t stack_id );
+
+/**
+ * @brief Enable or disable the device transmit power control of the modes where the network does not set the power
+ *
+ * @param [in] enable       true to lower the transmit power while the link margin allows it
+ * @param [in] stack_id     The stack ID requested
+ */
+void lorawan_api_set_link_adr_power_control( bool enable, uint8_t stack_id );
+
+/**
+ * @brief Set the delivery ratio the number of transmissions of the unconfirmed uplinks aims at
+ *
+ * @param [in] target_percent   Delivery ratio in percent, 0 to disable the adaptation
+ * @param [in] stack_id         The stack ID requested
+ * @return status_lorawan_t     ERRORLORAWAN if the ratio is out of range
+ */
+status_lorawan_t lorawan_api_set_link_adr_delivery_target( uint8_t target_percent, uint8_t stack_id );
+
+/**
+ * @brief Enable or disable the FSK datarate for the uplinks of the services draining a backlog
+ *
+ * @param [in] enable       true to send the bulk uplinks with FSK while the link margin allows it
+ * @param [in] stack_id     The stack ID requested
+ */
+void lorawan_api_set_link_adr_bulk( bool enable, uint8_t stack_id );
+
+/**
+ * @brief Move the next uplink to the FSK datarate of the bulk mode if the link allows it
+ *
+ * @param [in] size_in      Application payload size of the next uplink
+ * @param [in] stack_id     The stack ID requested
+ * @return bool             true if the datarate was changed
+ */
+bool lorawan_api_bulk_datarate_set( uint8_t size_in, uint8_t stack_id );
+
+/**
+ * @brief Go back to the datarate of the ADR profile if the bulk uplink is not sent
+ *
+ * @param [in] stack_id     The stack ID requested
+ */
+void lorawan_api_bulk_datarate_restore( uint8_t stack_id );
+#endif
+
 /**
  * @brief Check if a frequency is valid according to current stack parameters
  *
@@ -1056,6 +1179,17 @@ uint32_t lorawan_api_get_time_of_nwk_ans( uint8_t stack_id );
  */
 void lorawan_api_set_time_of_nwk_ans( uint8_t stack_id, uint32_t target_time );
 
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+/**
+ * @brief Send the MAC answers waiting in the stack in the FOpts of the next uplink instead of a stand-alone frame
+ *
+ * @param [in] stack_id Stack identifier
+ * @param [in] size_in  Application payload size of the next uplink
+ * @return status_lorawan_t OKLORAWAN if the stack went back to idle with the answers in FOpts
+ */
+status_lorawan_t lorawan_api_nwk_ans_piggyback( uint8_t stack_id, uint8_t size_in );
+#endif
+
 /**
  * @brief update the next transmission to start at time or asap;
  *
@@ -102,13 +102,6 @@ static void lorawan_cid_request_management_on_launch( void* context_callback );
  */
 static void lorawan_cid_request_management_on_update( void* context_callback );
 
-/**
- * @brief Callback to handle the downlink received by the LoRaWAN layer
- *
- * @param rx_down_data
- */
-static uint8_t lorawan_cid_request_management_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
-
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -118,7 +111,7 @@ void lorawan_cid_request_management_init( uint8_t* service_id, uint8_t task_id,
                                           void ( **on_launch_callback )( void* ),
                                           void ( **on_update_callback )( void* ), void** context_callback )
 {
-    *downlink_callback  = lorawan_cid_request_management_downlink_handler;
+    *downlink_callback  = NULL;
     *on_launch_callback = lorawan_cid_request_management_on_launch;
     *on_update_callback = lorawan_cid_request_management_on_update;
     *context_callback   = ( void* ) modem_supervisor_get_task( );
@@ -219,9 +212,4 @@ static void lorawan_cid_request_management_on_update( void* context )
     }
 }
 
-static uint8_t lorawan_cid_request_management_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
-{
-    return MODEM_DOWNLINK_UNCONSUMED;
-}
-
 /* --- EOF ------------------------------------------------------------------ */
@@ -80,6 +80,12 @@
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+static struct
+{
+    bool is_fpending_drain_enabled[NUMBER_OF_STACKS];  // Poll again at once when a class A downlink sets FPending
+    bool is_fpending_poll_requested[NUMBER_OF_STACKS];
+} lorawan_dwn_ack_management_ctx;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -119,6 +125,12 @@ void lorawan_dwn_ack_management_init( uint8_t* service_id, uint8_t task_id,
     *on_launch_callback = lorawan_dwn_ack_management_on_launch;
     *on_update_callback = lorawan_dwn_ack_management_on_update;
     *context_callback   = ( void* ) modem_supervisor_get_task( );
+
+    for( uint8_t i = 0; i < NUMBER_OF_STACKS; i++ )
+    {
+        lorawan_dwn_ack_management_ctx.is_fpending_drain_enabled[i]  = false;
+        lorawan_dwn_ack_management_ctx.is_fpending_poll_requested[i] = false;
+    }
 }
 
 void lorawan_dwn_ack_add_task( uint8_t stack_id, uint32_t time_to_execute )
@@ -138,9 +150,26 @@ void lorawan_dwn_ack_add_task( uint8_t stack_id, uint32_t time_to_execute )
 void lorawan_dwn_ack_remove_task( uint8_t stack_id )
 {
     IS_VALID_STACK_ID( stack_id );
+    lorawan_dwn_ack_management_ctx.is_fpending_poll_requested[stack_id] = false;
     modem_supervisor_remove_task( RETRIEVE_DL_TASK + ( NUMBER_OF_TASKS * stack_id ) );
 }
 
+void lorawan_dwn_ack_set_fpending_drain( uint8_t stack_id, bool enable )
+{
+    IS_VALID_STACK_ID( stack_id );
+    lorawan_dwn_ack_management_ctx.is_fpending_drain_enabled[stack_id] = enable;
+    if( enable == false )
+    {
+        lorawan_dwn_ack_management_ctx.is_fpending_poll_requested[stack_id] = false;
+    }
+}
+
+bool lorawan_dwn_ack_get_fpending_drain( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    return lorawan_dwn_ack_management_ctx.is_fpending_drain_enabled[stack_id];
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -148,15 +177,29 @@ void lorawan_dwn_ack_remove_task( uint8_t stack_id )
 
 static void lorawan_dwn_ack_management_on_launch( void* context )
 {
+    uint8_t stack_id      = STACK_ID_CURRENT_TASK;
+    bool    is_poll_asked = lorawan_dwn_ack_management_ctx.is_fpending_poll_requested[stack_id];
+
+    lorawan_dwn_ack_management_ctx.is_fpending_poll_requested[stack_id] = false;
+
     if( ( smtc_modem_hal_get_time_in_s( ) <= ( CURRENT_TASK_TIME + 2 ) ) &&
-        ( lorawan_api_tx_ack_bit_get( STACK_ID_CURRENT_TASK ) ) )
+        ( lorawan_api_tx_ack_bit_get( stack_id ) ) )
     {
         tx_protocol_manager_request( TX_PROTOCOL_TRANSMIT_LORA, 1, false, NULL, 0, UNCONF_DATA_UP,
-                                     smtc_modem_hal_get_time_in_ms( ), STACK_ID_CURRENT_TASK );
+                                     smtc_modem_hal_get_time_in_ms( ), stack_id );
     }
     else
     {
-        lorawan_api_tx_ack_bit_set( STACK_ID_CURRENT_TASK, false );
+        lorawan_api_tx_ack_bit_set( stack_id, false );
+
+        // The network holds more downlinks: an empty uplink opens the next receive windows, the task is only run
+        // once the duty-cycle allows it
+        if( is_poll_asked == true )
+        {
+            SMTC_MODEM_HAL_TRACE_PRINTF( "FPending set, poll the next downlink on stack %d\n", stack_id );
+            tx_protocol_manager_request( TX_PROTOCOL_TRANSMIT_LORA, 1, false, NULL, 0, UNCONF_DATA_UP,
+                                         smtc_modem_hal_get_time_in_ms( ), stack_id );
+        }
     }
 }
 
@@ -177,6 +220,16 @@ static uint8_t lorawan_dwn_ack_management_downlink_handler( lr1_stack_mac_down_d
 
         lorawan_dwn_ack_add_task( rx_down_data->stack_id, smtc_modem_hal_get_time_in_s( ) );
     }
+
+    if( ( lorawan_dwn_ack_management_ctx.is_fpending_drain_enabled[rx_down_data->stack_id] == true ) &&
+        ( ( rx_down_data->rx_metadata.rx_window == RECEIVE_ON_RX1 ) ||
+          ( rx_down_data->rx_metadata.rx_window == RECEIVE_ON_RX2 ) ) &&
+        ( rx_down_data->rx_metadata.rx_fpending_bit == true ) )
+    {
+        // Without a downlink on the poll, FPending is not seen again and the drain stops by itself
+        lorawan_dwn_ack_management_ctx.is_fpending_poll_requested[rx_down_data->stack_id] = true;
+        lorawan_dwn_ack_add_task( rx_down_data->stack_id, smtc_modem_hal_get_time_in_s( ) );
+    }
     return MODEM_DOWNLINK_UNCONSUMED;
 }
 
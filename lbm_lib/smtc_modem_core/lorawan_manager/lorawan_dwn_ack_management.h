@@ -98,6 +98,25 @@ void lorawan_dwn_ack_add_task( uint8_t stack_id, uint32_t time_to_execute );
  */
 void lorawan_dwn_ack_remove_task( uint8_t stack_id );
 
+/**
+ * @brief Enable the fast drain of the downlinks announced by FPending
+ *
+ * @remark When a downlink received in RX1 or RX2 has FPending set, an empty unconfirmed uplink is sent as soon as the
+ * duty-cycle allows it to open the next receive windows
+ *
+ * @param stack_id
+ * @param enable
+ */
+void lorawan_dwn_ack_set_fpending_drain( uint8_t stack_id, bool enable );
+
+/**
+ * @brief Get the fast drain configuration
+ *
+ * @param stack_id
+ * @return true if the downlinks announced by FPending are polled at once
+ */
+bool lorawan_dwn_ack_get_fpending_drain( uint8_t stack_id );
+
 /**
  * @brief Init a new LoRaWAN tx_ack_class_c_or_b services object
  *
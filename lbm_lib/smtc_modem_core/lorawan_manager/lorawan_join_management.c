@@ -47,6 +47,7 @@
 #include "lorawan_api.h"
 #include "modem_core.h"
 #include "modem_event_utilities.h"
+#include "smtc_modem_dbg_latency.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -99,13 +100,6 @@ static void lorawan_join_management_service_on_launch( void* service_id );
  */
 static void lorawan_join_management_service_on_update( void* service_id );
 
-/**
- * @brief Callback to handle the downlink received by the LoRaWAN layer
- *
- * @param rx_down_data
- */
-static uint8_t lorawan_join_management_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
-
 /**
  * @brief Enqueue a new join
  *
@@ -122,7 +116,7 @@ void lorawan_join_management_services_init( uint8_t* service_id, uint8_t task_id
                                             void ( **on_launch_callback )( void* ),
                                             void ( **on_update_callback )( void* ), void** context_callback )
 {
-    *downlink_callback  = lorawan_join_management_service_downlink_handler;
+    *downlink_callback  = NULL;
     *on_launch_callback = lorawan_join_management_service_on_launch;
     *on_update_callback = lorawan_join_management_service_on_update;
     *context_callback   = ( void* ) modem_supervisor_get_task( );
@@ -137,12 +131,14 @@ void lorawan_join_add_task( uint8_t stack_id )
         return;
     }
     lorawan_join_internal_add_task( stack_id, smtc_modem_hal_get_time_in_s( ) );
+    SMTC_MODEM_HAL_LATENCY_START( SMTC_LATENCY_JOIN, stack_id );
 }
 
 void lorawan_join_remove_task( uint8_t stack_id )
 {
     IS_VALID_STACK_ID( stack_id );
     modem_supervisor_remove_task( JOIN_TASK + ( NUMBER_OF_TASKS * stack_id ) );
+    SMTC_MODEM_HAL_LATENCY_CANCEL( SMTC_LATENCY_JOIN, stack_id );
 }
 
 /*
@@ -180,6 +176,7 @@ static void lorawan_join_management_service_on_update( void* context )
 
     if( lorawan_api_isjoined( STACK_ID_CURRENT_TASK ) == JOINED )
     {
+        SMTC_MODEM_HAL_LATENCY_STOP( SMTC_LATENCY_JOIN, STACK_ID_CURRENT_TASK );
         increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_JOINED, 0, STACK_ID_CURRENT_TASK );
     }
     else
@@ -203,11 +200,6 @@ static void lorawan_join_management_service_on_update( void* context )
     modem_store_modem_context( );
 }
 
-static uint8_t lorawan_join_management_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
-{
-    return MODEM_DOWNLINK_UNCONSUMED;
-}
-
 static void lorawan_join_internal_add_task( uint8_t stack_id, uint32_t current_time_s )
 {
     smodem_task task_join = { 0 };
@@ -49,6 +49,11 @@
 #include "modem_event_utilities.h"
 #include "smtc_duty_cycle.h"
 #include "modem_tx_protocol_manager.h"
+#include "smtc_modem_dbg_latency.h"
+
+#if defined( ADD_SMTC_TDMA_UPLINK )
+#include "tdma_uplink.h"
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -91,7 +96,10 @@ typedef struct lorawan_send_management_s
     uint8_t fport;
     bool    fport_present;
     bool    packet_type;
+    bool    payload_in_place;
 
+    smtc_modem_uplink_fill_callback_t fill_callback;
+    void*                             fill_context;
 } lorawan_send_management_t;
 
 static lorawan_send_management_t lorawan_send_management_obj[NUMBER_OF_STACKS];
@@ -157,7 +165,15 @@ void lorawan_send_add_task( uint8_t stack_id, uint8_t f_port, bool send_fport, b
     {
         task_send.priority = TASK_MEDIUM_HIGH_PRIORITY;
     }
-    if( payload != NULL )
+    lorawan_send_management_obj[stack_id].payload_in_place = false;
+    lorawan_send_management_obj[stack_id].fill_callback    = NULL;
+    if( payload == lorawan_send_management_obj[stack_id].payload )
+    {
+        // Payload already written in place by the application, the tpm reads it from there
+        lorawan_send_management_obj[stack_id].payload_length   = payload_length;
+        lorawan_send_management_obj[stack_id].payload_in_place = true;
+    }
+    else if( payload != NULL )
     {
         lorawan_send_management_obj[stack_id].payload_length = payload_length;
         memcpy( lorawan_send_management_obj[stack_id].payload, payload, payload_length );
@@ -176,12 +192,41 @@ void lorawan_send_add_task( uint8_t stack_id, uint8_t f_port, bool send_fport, b
     task_send.id                = SEND_TASK + ( NUMBER_OF_TASKS * stack_id );
 
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_supervisor_add_task( &task_send ) == TASK_VALID );
+    SMTC_MODEM_HAL_LATENCY_START( SMTC_LATENCY_UPLINK, stack_id );
+}
+
+uint8_t* lorawan_send_get_payload_buffer( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    return lorawan_send_management_obj[stack_id].payload;
+}
+
+void lorawan_send_set_fill_callback( uint8_t stack_id, smtc_modem_uplink_fill_callback_t fill_callback,
+                                     void* context )
+{
+    IS_VALID_STACK_ID( stack_id );
+    lorawan_send_management_obj[stack_id].fill_callback = fill_callback;
+    lorawan_send_management_obj[stack_id].fill_context  = context;
+}
+
+bool lorawan_send_payload_buffer_is_in_use( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    return tx_protocol_manager_is_data_in_use( lorawan_send_management_obj[stack_id].payload );
+}
+
+bool lorawan_send_task_is_pending( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    return ( modem_supervisor_get_task( ) )->modem_task[SEND_TASK + ( NUMBER_OF_TASKS * stack_id )].priority !=
+           TASK_FINISH;
 }
 
 void lorawan_send_remove_task( uint8_t stack_id )
 {
     IS_VALID_STACK_ID( stack_id );
     modem_supervisor_remove_task( SEND_TASK + ( NUMBER_OF_TASKS * stack_id ) );
+    SMTC_MODEM_HAL_LATENCY_CANCEL( SMTC_LATENCY_UPLINK, stack_id );
 }
 
 /*
@@ -195,13 +240,46 @@ static void lorawan_send_management_service_on_launch( void* context )
     stask_manager*   task_manager                                         = ( stask_manager* ) context;
     lorawan_send_management_obj[STACK_ID_CURRENT_TASK].rx_ack_bit_context = 0;
 
-    send_status = tx_protocol_manager_request(
-        TX_PROTOCOL_TRANSMIT_LORA, lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport,
-        lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport_present,
-        lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload,
-        lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload_length,
-        ( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].packet_type == true ) ? CONF_DATA_UP : UNCONF_DATA_UP,
-        smtc_modem_hal_get_time_in_ms( ), STACK_ID_CURRENT_TASK );
+    tx_protocol_manager_tx_type_t request_type   = TX_PROTOCOL_TRANSMIT_LORA;
+    uint32_t                      target_time_ms = smtc_modem_hal_get_time_in_ms( );
+#if defined( ADD_SMTC_TDMA_UPLINK )
+    // In a slotted deployment the uplink waits for the slot of the device
+    if( tdma_uplink_get_next_slot( STACK_ID_CURRENT_TASK, &target_time_ms ) == true )
+    {
+        request_type = TX_PROTOCOL_TRANSMIT_LORA_AT_TIME;
+    }
+#endif
+
+    if( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fill_callback != NULL )
+    {
+        send_status = tx_protocol_manager_request_fill(
+            request_type, lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport_present,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fill_callback,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fill_context,
+            ( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].packet_type == true ) ? CONF_DATA_UP : UNCONF_DATA_UP,
+            target_time_ms, STACK_ID_CURRENT_TASK );
+    }
+    else if( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload_in_place == true )
+    {
+        send_status = tx_protocol_manager_request_no_copy(
+            request_type, lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport_present,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload_length,
+            ( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].packet_type == true ) ? CONF_DATA_UP : UNCONF_DATA_UP,
+            target_time_ms, STACK_ID_CURRENT_TASK );
+    }
+    else
+    {
+        send_status = tx_protocol_manager_request(
+            request_type, lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].fport_present,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload,
+            lorawan_send_management_obj[STACK_ID_CURRENT_TASK].payload_length,
+            ( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].packet_type == true ) ? CONF_DATA_UP : UNCONF_DATA_UP,
+            target_time_ms, STACK_ID_CURRENT_TASK );
+    }
 
     if( send_status == OKLORAWAN )
     {
@@ -228,22 +306,28 @@ static void lorawan_send_management_service_on_update( void* context )
 
     if( task_manager->modem_task[VIRTUAL_TASK_ID].task_enabled == true )
     {
+        // Before the event, the application may request the next uplink from its event callback
+        SMTC_MODEM_HAL_LATENCY_STOP( SMTC_LATENCY_UPLINK, STACK_ID_CURRENT_TASK );
         if( ( task_manager->modem_task[VIRTUAL_TASK_ID].task_context == true ) &&
             ( tx_protocol_manager_tx_is_aborted( ) == false ) )
         {
             if( lorawan_send_management_obj[STACK_ID_CURRENT_TASK].rx_ack_bit_context == 1 )
             {
-                increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_SUCCESS_WITH_ACK,
-                                                  STACK_ID_CURRENT_TASK );
+                increment_asynchronous_msgnumber_with_data( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_SUCCESS_WITH_ACK,
+                                                            STACK_ID_CURRENT_TASK,
+                                                            lorawan_api_fcnt_up_get( STACK_ID_CURRENT_TASK ), NULL );
             }
             else
             {
-                increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_SUCCESS, STACK_ID_CURRENT_TASK );
+                increment_asynchronous_msgnumber_with_data( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_SUCCESS,
+                                                            STACK_ID_CURRENT_TASK,
+                                                            lorawan_api_fcnt_up_get( STACK_ID_CURRENT_TASK ), NULL );
             }
         }
         else
         {
-            increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_FAILED, STACK_ID_CURRENT_TASK );
+            increment_asynchronous_msgnumber_with_data( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_FAILED, STACK_ID_CURRENT_TASK,
+                                                        lorawan_api_fcnt_up_get( STACK_ID_CURRENT_TASK ), NULL );
         }
     }
 }
@@ -46,6 +46,7 @@ extern "C" {
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
 #include "lr1_stack_mac_layer.h"
+#include "smtc_modem_api.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -75,6 +76,42 @@ extern "C" {
 void lorawan_send_add_task( uint8_t stack_id, uint8_t f_port, bool send_fport, bool confirmed, const uint8_t* payload,
                             uint8_t payload_length, bool emergency, uint32_t delay_s );
 
+/**
+ * @brief Get the payload buffer of the send task, an application payload written there and given back to
+ * lorawan_send_add_task is sent without any intermediate copy
+ *
+ * @param stack_id
+ * @return uint8_t* buffer of SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH bytes
+ */
+uint8_t* lorawan_send_get_payload_buffer( uint8_t stack_id );
+
+/**
+ * @brief Let the send task added last write its payload with a callback when the frame is built, instead of sending
+ * the payload given to lorawan_send_add_task
+ *
+ * @param stack_id
+ * @param fill_callback
+ * @param context
+ */
+void lorawan_send_set_fill_callback( uint8_t stack_id, smtc_modem_uplink_fill_callback_t fill_callback,
+                                     void* context );
+
+/**
+ * @brief Indicate if the payload buffer is still read by the tx protocol manager and can't be written
+ *
+ * @param stack_id
+ * @return true if the payload buffer is in use
+ */
+bool lorawan_send_payload_buffer_is_in_use( uint8_t stack_id );
+
+/**
+ * @brief Indicate if a send task is scheduled and not yet launched, a new one would replace it
+ *
+ * @param stack_id
+ * @return true if a send task is pending
+ */
+bool lorawan_send_task_is_pending( uint8_t stack_id );
+
 /**
  * @brief Remove a task send
  *
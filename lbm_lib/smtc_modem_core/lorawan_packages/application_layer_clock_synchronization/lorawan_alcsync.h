@@ -149,6 +149,28 @@ alc_sync_ret_t lorawan_alcsync_request_sync( uint8_t stack_id, bool ans_required
  */
 alc_sync_ret_t lorawan_alcsync_get_gps_time_second( uint8_t stack_id, uint32_t* gps_time_s );
 
+/**
+ * @brief Get the time elapsed since the last time correction
+ *
+ * @param [in]  stack_id     Stack identifier
+ * @param [out] age_s        Time elapsed in seconds
+ * @return alc_sync_ret_t    ALC_SYNC_FAIL if the time was never synchronized
+ */
+alc_sync_ret_t lorawan_alcsync_get_correction_age_s( uint8_t stack_id, uint32_t* age_s );
+
+/**
+ * @brief Set the application time tolerance
+ *
+ * @remark With a tolerance, the RTC drift estimated from the successive corrections is compensated in the GPS time,
+ *         and the next time sync is requested when the error of this estimate may exceed the tolerance instead of
+ *         every periodicity set by the server. Only supported by ALCSync v2.0.0
+ *
+ * @param [in] stack_id       Stack identifier
+ * @param [in] tolerance_ms   Time tolerance in millisecond, 0 to follow the periodicity set by the server
+ * @return alc_sync_ret_t
+ */
+alc_sync_ret_t lorawan_alcsync_set_tolerance( uint8_t stack_id, uint32_t tolerance_ms );
+
 /**
  * @brief Get the package information
  *
@@ -681,6 +681,28 @@ alc_sync_ret_t lorawan_alcsync_get_gps_time_second( uint8_t stack_id, uint32_t*
     return ALC_SYNC_OK;
 }
 
+alc_sync_ret_t lorawan_alcsync_set_tolerance( uint8_t stack_id, uint32_t tolerance_ms )
+{
+    SMTC_MODEM_HAL_TRACE_ERROR( "ALCSync time tolerance needs ALCSync v2.0.0\n" );
+    return ALC_SYNC_FAIL;
+}
+
+alc_sync_ret_t lorawan_alcsync_get_correction_age_s( uint8_t stack_id, uint32_t* age_s )
+{
+    IS_VALID_STACK_ID( stack_id );
+
+    uint8_t                service_id;
+    lorawan_alcsync_ctx_t* ctx = alc_sync_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->time_correction_s == 0 ) )
+    {
+        return ALC_SYNC_FAIL;
+    }
+
+    *age_s = smtc_modem_hal_get_time_in_s( ) - ctx->timestamp_last_correction_s;
+    return ALC_SYNC_OK;
+}
+
 void lorawan_alcsync_service_get_id( uint8_t* pkt_id, uint8_t* pkt_version, uint8_t* pkt_port )
 
 {
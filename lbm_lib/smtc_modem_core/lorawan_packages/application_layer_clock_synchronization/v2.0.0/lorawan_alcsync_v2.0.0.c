@@ -134,6 +134,13 @@ static const char alc_sync_bad_size_str[] = "ALC Sync payload bad size";
 #define APP_TIME_ANS_TOKEN_BYTE ( 4 )
 
 #define ALC_SYNC_DELAY_BEFORE_SEND_S ( 5 )
+
+// RTC drift model, used when the application sets a time tolerance
+#define ALC_SYNC_DRIFT_MIN_ELAPSED_S ( 3600UL )       // shortest history giving a drift estimate
+#define ALC_SYNC_DRIFT_MAX_PPB ( 500000L )            // estimate above 500 ppm restarts the model
+#define ALC_SYNC_DRIFT_STABILITY_PPB ( 2000UL )       // drift variation not captured by the model (temperature)
+#define ALC_SYNC_DRIFT_MIN_PERIOD_S ( 3600UL )        // 1 hour
+#define ALC_SYNC_DRIFT_MAX_PERIOD_S ( 14UL * 86400 )  // 14 days
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -189,6 +196,12 @@ typedef struct lorawan_alcsync_s
     bool     event_time_sync;
     bool     use_cloud_dm;
     uint8_t  fport;
+    uint32_t tolerance_ms;          //!< application time tolerance, 0 to sync every periodicity_s
+    bool     drift_anchored;        //!< true once the drift model has a reference correction
+    uint32_t drift_anchor_s;        //!< RTC time of the reference correction
+    int32_t  drift_correction_s;    //!< corrections received since drift_anchor_s
+    int32_t  drift_ppb;             //!< estimated RTC drift, positive when the RTC is slow
+    int32_t  drift_compensation_s;  //!< drift compensation included in the last AppTimeReq
 } lorawan_alcsync_ctx_t;
 
 typedef struct lorawan_alcsync_service_ctx_s
@@ -326,6 +339,34 @@ static uint32_t alcsync_build_ans_payload( uint8_t idx );
  */
 static bool is_received_on_multicast_window( receive_win_t rx_window );
 
+/**
+ * @brief Get the drift compensation to add to the corrected time
+ *
+ * @param [in] ctx   ALCSYNC context
+ * @param [in] rtc_s RTC time in second
+ * @return int32_t Compensation in second, 0 if no tolerance is set
+ */
+static int32_t alc_sync_get_drift_compensation_s( lorawan_alcsync_ctx_t* ctx, uint32_t rtc_s );
+
+/**
+ * @brief Update the drift model with a received time correction
+ *
+ * @param [in] ctx          ALCSYNC context
+ * @param [in] correction_s Time correction received in AppTimeAns
+ * @param [in] rtc_s        RTC time of the reception
+ */
+static void alc_sync_update_drift( lorawan_alcsync_ctx_t* ctx, int32_t correction_s, uint32_t rtc_s );
+
+/**
+ * @brief Get the time between two AppTimeReq
+ *
+ * @remark When a tolerance is set, the next request is sent when the error of the drift model may exceed it
+ *
+ * @param [in] ctx ALCSYNC context
+ * @return uint32_t Period in second
+ */
+static uint32_t alc_sync_get_period_s( lorawan_alcsync_ctx_t* ctx );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -416,7 +457,7 @@ void lorawan_alcsync_service_on_update( void* service_id )
     {
         if( ( lorawan_alcsync_ctx[idx].nb_transmission > 0 ) ||
             ( ( int32_t ) ( smtc_modem_hal_get_time_in_s( ) - timestamp_launch[idx] -
-                            lorawan_alcsync_ctx[idx].periodicity_s + 30 ) >= 0 ) )  // +30 because period +/-30s
+                            alc_sync_get_period_s( &lorawan_alcsync_ctx[idx] ) + 30 ) >= 0 ) )  // period +/-30s
         {
             lorawan_alcsync_ctx[idx].req_status |= ( 1 << ALC_SYNC_APP_TIME_REQ );
         }
@@ -430,7 +471,7 @@ void lorawan_alcsync_service_on_update( void* service_id )
         {
             // Follow the normal periodicity to relaunch the service
             task_alc_sync.time_to_execute_s =
-                timestamp_launch[idx] + lorawan_alcsync_ctx[idx].periodicity_s +
+                timestamp_launch[idx] + alc_sync_get_period_s( &lorawan_alcsync_ctx[idx] ) +
                 alcsync_get_signed_random_nb_in_range( ( -25 - ALC_SYNC_DELAY_BEFORE_SEND_S ),
                                                        ( 25 - ALC_SYNC_DELAY_BEFORE_SEND_S ) );
         }
@@ -677,7 +718,40 @@ alc_sync_ret_t lorawan_alcsync_get_gps_time_second( uint8_t stack_id, uint32_t*
         return ALC_SYNC_FAIL;
     }
 
-    *gps_time_s = smtc_modem_hal_get_time_in_s( ) + ctx->time_correction_s;
+    uint32_t rtc_s = smtc_modem_hal_get_time_in_s( );
+    *gps_time_s    = rtc_s + ctx->time_correction_s + alc_sync_get_drift_compensation_s( ctx, rtc_s );
+    return ALC_SYNC_OK;
+}
+
+alc_sync_ret_t lorawan_alcsync_get_correction_age_s( uint8_t stack_id, uint32_t* age_s )
+{
+    IS_VALID_STACK_ID( stack_id );
+
+    uint8_t                service_id;
+    lorawan_alcsync_ctx_t* ctx = alc_sync_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->time_correction_s == 0 ) )
+    {
+        return ALC_SYNC_FAIL;
+    }
+
+    *age_s = smtc_modem_hal_get_time_in_s( ) - ctx->timestamp_last_correction_s;
+    return ALC_SYNC_OK;
+}
+
+alc_sync_ret_t lorawan_alcsync_set_tolerance( uint8_t stack_id, uint32_t tolerance_ms )
+{
+    IS_VALID_STACK_ID( stack_id );
+
+    uint8_t                service_id;
+    lorawan_alcsync_ctx_t* ctx = alc_sync_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx == NULL )
+    {
+        return ALC_SYNC_FAIL;
+    }
+
+    ctx->tolerance_ms = tolerance_ms;
     return ALC_SYNC_OK;
 }
 
@@ -744,6 +818,7 @@ static alc_sync_ret_t alc_sync_parser( lorawan_alcsync_ctx_t* ctx, uint8_t* alc_
         case ALC_SYNC_APP_TIME_ANS:
             if( ( alc_sync_rx_buffer_index + ALC_SYNC_APP_TIME_ANS_SIZE ) <= alc_sync_rx_buffer_length )
             {
+                int32_t previous_time_correction_s = ctx->time_correction_s;
                 if( alc_sync_decode_app_time_ans( ctx, &alc_sync_rx_buffer[alc_sync_rx_buffer_index + 1] ) ==
                     ALC_SYNC_OK )
                 {
@@ -753,6 +828,8 @@ static alc_sync_ret_t alc_sync_parser( lorawan_alcsync_ctx_t* ctx, uint8_t* alc_
 
                     // Timestamp the last received data
                     ctx->timestamp_last_correction_s = timestamp_ms / 1000;
+                    alc_sync_update_drift( ctx, ctx->time_correction_s - previous_time_correction_s,
+                                           ctx->timestamp_last_correction_s );
 
                     ctx->event_time_sync = true;
 
@@ -882,7 +959,9 @@ static alc_sync_ret_t alc_sync_decode_app_time_ans( lorawan_alcsync_ctx_t* ctx,
             ctx->req_status |= ( 1 << ALC_SYNC_APP_TIME_REQ );
         }
 
-        ctx->time_correction_s += tmp_time_correction_s;
+        // The device time of the request included the drift compensation, it is now part of the correction
+        ctx->time_correction_s += tmp_time_correction_s + ctx->drift_compensation_s;
+        ctx->drift_compensation_s = 0;
 
         return ALC_SYNC_OK;
     }
@@ -936,8 +1015,11 @@ static uint32_t alcsync_build_ans_payload( uint8_t idx )
     if( ( ( lorawan_alcsync_ctx[idx].req_status >> ALC_SYNC_DEVICE_APP_TIME_PERIODICITY_REQ ) & 0x1 ) == 1 )
     {
         timestamp_launch[idx] = time_tmp;
+        // With a tolerance, the requests follow the drift model instead of the periodicity set by the server
         alc_sync_construct_app_time_periodicity_answer(
-            &lorawan_alcsync_ctx[idx], false, timestamp_launch[idx] + lorawan_alcsync_ctx[idx].time_correction_s );
+            &lorawan_alcsync_ctx[idx], ( lorawan_alcsync_ctx[idx].tolerance_ms != 0 ) ? true : false,
+            timestamp_launch[idx] + lorawan_alcsync_ctx[idx].time_correction_s +
+                alc_sync_get_drift_compensation_s( &lorawan_alcsync_ctx[idx], timestamp_launch[idx] ) );
     }
 
     if( ( ( lorawan_alcsync_ctx[idx].req_status >> ALC_SYNC_APP_TIME_REQ ) & 0x1 ) == 1 )
@@ -947,8 +1029,11 @@ static uint32_t alcsync_build_ans_payload( uint8_t idx )
         {
             lorawan_alcsync_ctx[idx].ans_required = false;
         }
+        lorawan_alcsync_ctx[idx].drift_compensation_s =
+            alc_sync_get_drift_compensation_s( &lorawan_alcsync_ctx[idx], timestamp_launch[idx] );
         alc_sync_construct_app_time_request( &lorawan_alcsync_ctx[idx],
-                                             timestamp_launch[idx] + lorawan_alcsync_ctx[idx].time_correction_s,
+                                             timestamp_launch[idx] + lorawan_alcsync_ctx[idx].time_correction_s +
+                                                 lorawan_alcsync_ctx[idx].drift_compensation_s,
                                              lorawan_alcsync_ctx[idx].ans_required );
     }
     return time_tmp;
@@ -966,4 +1051,77 @@ static bool is_received_on_multicast_window( receive_win_t rx_window )
     return false;
 }
 
+static int32_t alc_sync_get_drift_compensation_s( lorawan_alcsync_ctx_t* ctx, uint32_t rtc_s )
+{
+    if( ( ctx->tolerance_ms == 0 ) || ( ctx->drift_ppb == 0 ) )
+    {
+        return 0;
+    }
+
+    int64_t elapsed_s = ( int32_t ) ( rtc_s - ctx->timestamp_last_correction_s );
+    int64_t drift_ms  = ( ( int64_t ) ctx->drift_ppb * elapsed_s ) / 1000000;
+
+    // Round to the nearest second
+    return ( int32_t ) ( ( drift_ms >= 0 ) ? ( ( drift_ms + 500 ) / 1000 ) : ( ( drift_ms - 500 ) / 1000 ) );
+}
+
+static void alc_sync_update_drift( lorawan_alcsync_ctx_t* ctx, int32_t correction_s, uint32_t rtc_s )
+{
+    if( ctx->drift_anchored == false )
+    {
+        // First correction (or after a restart of the model): only the offset is known
+        ctx->drift_anchored     = true;
+        ctx->drift_anchor_s     = rtc_s;
+        ctx->drift_correction_s = 0;
+        ctx->drift_ppb          = 0;
+        return;
+    }
+
+    ctx->drift_correction_s += correction_s;
+
+    uint32_t elapsed_s = rtc_s - ctx->drift_anchor_s;
+    if( elapsed_s < ALC_SYNC_DRIFT_MIN_ELAPSED_S )
+    {
+        return;
+    }
+
+    // The mean drift since the anchor, the 1 s resolution of the corrections fades as the history grows
+    int64_t drift_ppb = ( ( int64_t ) ctx->drift_correction_s * 1000000000 ) / elapsed_s;
+    if( ( drift_ppb > ALC_SYNC_DRIFT_MAX_PPB ) || ( drift_ppb < -ALC_SYNC_DRIFT_MAX_PPB ) )
+    {
+        // Not a drift: time jump or wrong correction, restart the model from this correction
+        SMTC_MODEM_HAL_TRACE_WARNING( "ALC Sync drift out of range, restart model\n" );
+        ctx->drift_anchor_s     = rtc_s;
+        ctx->drift_correction_s = 0;
+        ctx->drift_ppb          = 0;
+        return;
+    }
+    ctx->drift_ppb = ( int32_t ) drift_ppb;
+    SMTC_MODEM_HAL_TRACE_PRINTF( "ALC Sync RTC drift %d ppb over %u s\n", ctx->drift_ppb, elapsed_s );
+}
+
+static uint32_t alc_sync_get_period_s( lorawan_alcsync_ctx_t* ctx )
+{
+    if( ( ctx->tolerance_ms == 0 ) || ( ctx->drift_anchored == false ) ||
+        ( ( uint32_t ) ( ctx->timestamp_last_correction_s - ctx->drift_anchor_s ) < ALC_SYNC_DRIFT_MIN_ELAPSED_S ) )
+    {
+        return ctx->periodicity_s;
+    }
+
+    // Uncertainty of the estimate: 1 s over the history plus the drift variation the model can't follow
+    uint32_t uncertainty_ppb =
+        ( 1000000000UL / ( ctx->timestamp_last_correction_s - ctx->drift_anchor_s ) ) + ALC_SYNC_DRIFT_STABILITY_PPB;
+    uint64_t period_s = ( ( uint64_t ) ctx->tolerance_ms * 1000000 ) / uncertainty_ppb;
+
+    if( period_s < ALC_SYNC_DRIFT_MIN_PERIOD_S )
+    {
+        period_s = ALC_SYNC_DRIFT_MIN_PERIOD_S;
+    }
+    else if( period_s > ALC_SYNC_DRIFT_MAX_PERIOD_S )
+    {
+        period_s = ALC_SYNC_DRIFT_MAX_PERIOD_S;
+    }
+    return ( uint32_t ) period_s;
+}
+
 /* --- EOF ------------------------------------------------------------------ */
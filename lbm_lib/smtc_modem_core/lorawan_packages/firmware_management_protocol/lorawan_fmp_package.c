@@ -54,6 +54,9 @@
 #include "smtc_modem_api.h"
 #include "modem_tx_protocol_manager.h"
 #include "lorawan_cid_request_management.h"
+#if defined( ENABLE_FUOTA_FMP_PATCH )
+#include "lorawan_fmp_patch.h"
+#endif  // ENABLE_FUOTA_FMP_PATCH
 
 /*
  * -----------------------------------------------------------------------------
@@ -137,6 +140,7 @@
 #define FMP_DEV_DELETE_IMAGE_ANS_SIZE ( 2 )
 
 #define FMP_SIZE_ANS_MAX FMP_DEV_VERSION_ANS_SIZE
+#define INCOMPATIBLE_FIRMWARE_UPGRADE_IMAGE ( 2 )
 #define VALID_FIRMWARE_UPGRADE_IMAGE ( 3 )
 /*
  * -----------------------------------------------------------------------------
@@ -243,6 +247,14 @@ static fmp_status_t fmp_package_parser( lorawan_fmp_package_ctx_t* ctx, uint8_t*
 
 static bool get_gps_time( uint32_t* gps_time_s, uint8_t stack_id );
 
+/**
+ * @brief Get the status of the firmware upgrade image, checking the base version of a delta image
+ *
+ * @param [out] next_fw_version The firmware version once the image is installed, set if the image is valid
+ * @return uint8_t fw status field as defined in fmp Alliance package TS006-1.0.0
+ */
+static uint8_t fmp_get_upgrade_image_status( uint32_t* next_fw_version );
+
 #if defined( FUOTA_BUILT_IN_TEST )
 static bool fmp_test( void );
 #endif
@@ -270,6 +282,8 @@ void lorawan_fmp_package_services_init( uint8_t* service_id, uint8_t task_id,
     *on_update_callback = lorawan_fmp_package_service_on_update;
     *context_callback   = ( void* ) ctx;
 
+    modem_set_downlink_service_port( lorawan_fmp_package_service_downlink_handler, FMP_PORT );
+
     ctx->task_id  = task_id;
     ctx->stack_id = CURRENT_STACK;
     ctx->enabled  = true;
@@ -721,7 +735,8 @@ static fmp_status_t fmp_package_parser( lorawan_fmp_package_ctx_t* ctx, uint8_t*
             IS_VALID_PKG_CMD( FMP_DEV_UPGRADE_IMAGE_REQ_SIZE );
             fmp_package_rx_buffer_index += FMP_DEV_UPGRADE_IMAGE_REQ_SIZE;
 
-            uint8_t tmp_fw_status = smtc_modem_hal_get_fw_status_available_for_fuota( );
+            uint32_t next_fw_verion = 0;
+            uint8_t  tmp_fw_status  = fmp_get_upgrade_image_status( &next_fw_verion );
 
             if( ( ans_index + FMP_DEV_UPGRADE_IMAGE_ANS_SIZE ) <= max_payload_size )
             {
@@ -730,7 +745,6 @@ static fmp_status_t fmp_package_parser( lorawan_fmp_package_ctx_t* ctx, uint8_t*
 
                 if( tmp_fw_status == VALID_FIRMWARE_UPGRADE_IMAGE )
                 {
-                    uint32_t next_fw_verion              = smtc_modem_hal_get_next_fw_version_for_fuota( );
                     ctx->fmp_tx_payload_ans[ans_index++] = next_fw_verion & 0xFF;
                     ctx->fmp_tx_payload_ans[ans_index++] = ( next_fw_verion >> 8 ) & 0xFF;
                     ctx->fmp_tx_payload_ans[ans_index++] = ( next_fw_verion >> 16 ) & 0xFF;
@@ -792,6 +806,36 @@ static bool get_gps_time( uint32_t* gps_time_s, uint8_t stack_id )
     }
 }
 
+static uint8_t fmp_get_upgrade_image_status( uint32_t* next_fw_version )
+{
+    uint8_t fw_status = smtc_modem_hal_get_fw_status_available_for_fuota( );
+
+    if( fw_status != VALID_FIRMWARE_UPGRADE_IMAGE )
+    {
+        return fw_status;
+    }
+    *next_fw_version = smtc_modem_hal_get_next_fw_version_for_fuota( );
+
+#if defined( ENABLE_FUOTA_FMP_PATCH )
+    uint8_t                    header_buffer[LORAWAN_FMP_PATCH_HEADER_SIZE];
+    lorawan_fmp_patch_header_t header;
+
+    smtc_modem_hal_context_restore( CONTEXT_FUOTA, 0, header_buffer, LORAWAN_FMP_PATCH_HEADER_SIZE );
+    if( lorawan_fmp_patch_get_header( header_buffer, &header ) == LORAWAN_FMP_PATCH_OK )
+    {
+        // A delta image only rebuilds the next firmware from the one it was computed against
+        if( header.base_fw_version != smtc_modem_hal_get_fw_version_for_fuota( ) )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "fmp delta image for fw 0x%08x, running 0x%08x\n", header.base_fw_version,
+                                          smtc_modem_hal_get_fw_version_for_fuota( ) );
+            return INCOMPATIBLE_FIRMWARE_UPGRADE_IMAGE;
+        }
+        *next_fw_version = header.next_fw_version;
+    }
+#endif  // ENABLE_FUOTA_FMP_PATCH
+    return fw_status;
+}
+
 #if defined( FUOTA_BUILT_IN_TEST )
 /* add static fonction for tests purpose */
 static bool fmp_test( void )
@@ -0,0 +1,241 @@
+/*
+ * @file      lorawan_fmp_patch.c
+ *
+ * @brief     Delta firmware upgrade images for the Firmware Management Protocol
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "lorawan_fmp_patch.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#ifndef MIN
+#define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#define LORAWAN_FMP_PATCH_MIN_BUFFER_SIZE 16
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Decode a little endian 32 bits field
+ */
+static uint32_t patch_get_u32( const uint8_t* buffer );
+
+/**
+ * @brief Read a command field of the patch, moving the read offset forward
+ */
+static lorawan_fmp_patch_status_t patch_read( const lorawan_fmp_patch_io_t* io, uint32_t* patch_offset,
+                                              uint32_t patch_size, uint8_t* data, uint32_t size );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+lorawan_fmp_patch_status_t lorawan_fmp_patch_get_header( const uint8_t* buffer, lorawan_fmp_patch_header_t* header )
+{
+    if( patch_get_u32( &buffer[0] ) != LORAWAN_FMP_PATCH_MAGIC )
+    {
+        return LORAWAN_FMP_PATCH_NOT_A_PATCH;
+    }
+    header->base_fw_version = patch_get_u32( &buffer[4] );
+    header->next_fw_version = patch_get_u32( &buffer[8] );
+    header->size            = patch_get_u32( &buffer[12] );
+    return LORAWAN_FMP_PATCH_OK;
+}
+
+lorawan_fmp_patch_status_t lorawan_fmp_patch_apply( const lorawan_fmp_patch_io_t* io, uint32_t patch_size,
+                                                    uint8_t* buffer, uint16_t buffer_size )
+{
+    lorawan_fmp_patch_header_t header;
+    lorawan_fmp_patch_status_t status;
+    uint32_t                   patch_offset = 0;
+    uint32_t                   next_offset  = 0;
+
+    if( buffer_size < LORAWAN_FMP_PATCH_MIN_BUFFER_SIZE )
+    {
+        return LORAWAN_FMP_PATCH_IO_ERROR;
+    }
+
+    status = patch_read( io, &patch_offset, patch_size, buffer, LORAWAN_FMP_PATCH_HEADER_SIZE );
+    if( status != LORAWAN_FMP_PATCH_OK )
+    {
+        return status;
+    }
+    if( lorawan_fmp_patch_get_header( buffer, &header ) != LORAWAN_FMP_PATCH_OK )
+    {
+        return LORAWAN_FMP_PATCH_NOT_A_PATCH;
+    }
+
+    while( patch_offset < patch_size )
+    {
+        uint8_t  cmd[9];
+        uint32_t base_offset = 0;
+        uint32_t length;
+
+        status = patch_read( io, &patch_offset, patch_size, cmd, 1 );
+        if( status != LORAWAN_FMP_PATCH_OK )
+        {
+            return status;
+        }
+
+        switch( cmd[0] )
+        {
+        case LORAWAN_FMP_PATCH_CMD_COPY:
+            status      = patch_read( io, &patch_offset, patch_size, &cmd[1], 8 );
+            base_offset = patch_get_u32( &cmd[1] );
+            length      = patch_get_u32( &cmd[5] );
+            break;
+        case LORAWAN_FMP_PATCH_CMD_INSERT:
+            status = patch_read( io, &patch_offset, patch_size, &cmd[1], 2 );
+            length = cmd[1] | ( ( uint32_t ) cmd[2] << 8 );
+            break;
+        case LORAWAN_FMP_PATCH_CMD_ADD:
+            status      = patch_read( io, &patch_offset, patch_size, &cmd[1], 6 );
+            base_offset = patch_get_u32( &cmd[1] );
+            length      = cmd[5] | ( ( uint32_t ) cmd[6] << 8 );
+            break;
+        default:
+            return LORAWAN_FMP_PATCH_CORRUPTED;
+        }
+        if( status != LORAWAN_FMP_PATCH_OK )
+        {
+            return status;
+        }
+        if( length > ( header.size - next_offset ) )
+        {
+            return LORAWAN_FMP_PATCH_CORRUPTED;
+        }
+
+        // ADD needs the running firmware and the patch data side by side
+        uint16_t chunk_max = ( cmd[0] == LORAWAN_FMP_PATCH_CMD_ADD ) ? ( buffer_size / 2 ) : buffer_size;
+
+        while( length > 0 )
+        {
+            uint16_t chunk = MIN( length, chunk_max );
+
+            if( cmd[0] == LORAWAN_FMP_PATCH_CMD_INSERT )
+            {
+                status = patch_read( io, &patch_offset, patch_size, buffer, chunk );
+                if( status != LORAWAN_FMP_PATCH_OK )
+                {
+                    return status;
+                }
+            }
+            else
+            {
+                if( io->read_base( io->context, base_offset, buffer, chunk ) != 0 )
+                {
+                    return LORAWAN_FMP_PATCH_IO_ERROR;
+                }
+                if( cmd[0] == LORAWAN_FMP_PATCH_CMD_ADD )
+                {
+                    status = patch_read( io, &patch_offset, patch_size, &buffer[chunk_max], chunk );
+                    if( status != LORAWAN_FMP_PATCH_OK )
+                    {
+                        return status;
+                    }
+                    for( uint16_t i = 0; i < chunk; i++ )
+                    {
+                        buffer[i] += buffer[chunk_max + i];
+                    }
+                }
+                base_offset += chunk;
+            }
+
+            if( io->write_next( io->context, next_offset, buffer, chunk ) != 0 )
+            {
+                return LORAWAN_FMP_PATCH_IO_ERROR;
+            }
+            next_offset += chunk;
+            length -= chunk;
+        }
+    }
+
+    return ( next_offset == header.size ) ? LORAWAN_FMP_PATCH_OK : LORAWAN_FMP_PATCH_CORRUPTED;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint32_t patch_get_u32( const uint8_t* buffer )
+{
+    return ( uint32_t ) buffer[0] | ( ( uint32_t ) buffer[1] << 8 ) | ( ( uint32_t ) buffer[2] << 16 ) |
+           ( ( uint32_t ) buffer[3] << 24 );
+}
+
+static lorawan_fmp_patch_status_t patch_read( const lorawan_fmp_patch_io_t* io, uint32_t* patch_offset,
+                                              uint32_t patch_size, uint8_t* data, uint32_t size )
+{
+    if( size > ( patch_size - *patch_offset ) )
+    {
+        return LORAWAN_FMP_PATCH_CORRUPTED;
+    }
+    if( io->read_patch( io->context, *patch_offset, data, size ) != 0 )
+    {
+        return LORAWAN_FMP_PATCH_IO_ERROR;
+    }
+    *patch_offset += size;
+    return LORAWAN_FMP_PATCH_OK;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,145 @@
+/**
+ * @file      lorawan_fmp_patch.h
+ *
+ * @brief     Delta firmware upgrade images for the Firmware Management Protocol
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LORAWAN_FMP_PATCH_H
+#define LORAWAN_FMP_PATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief Delta image layout, all fields little endian
+ *
+ * | Header                                                                  | Commands ... |
+ * | magic "LBMP" (4) | base fw version (4) | next fw version (4) | size (4) |              |
+ *
+ * The commands rebuild the next firmware sequentially, until size bytes are written:
+ * - COPY   | 0x01 | base offset (4) | length (4) |                  copy length bytes of the running firmware
+ * - INSERT | 0x02 | length (2)      | data (length) |               write the data
+ * - ADD    | 0x03 | base offset (4) | length (2) | data (length) | write the running firmware bytes plus the data
+ */
+#define LORAWAN_FMP_PATCH_MAGIC 0x504D424C
+#define LORAWAN_FMP_PATCH_HEADER_SIZE 16
+
+#define LORAWAN_FMP_PATCH_CMD_COPY 0x01
+#define LORAWAN_FMP_PATCH_CMD_INSERT 0x02
+#define LORAWAN_FMP_PATCH_CMD_ADD 0x03
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+typedef enum lorawan_fmp_patch_status_e
+{
+    LORAWAN_FMP_PATCH_OK,           //!< Patch header valid or patch applied
+    LORAWAN_FMP_PATCH_NOT_A_PATCH,  //!< The image is a full firmware image
+    LORAWAN_FMP_PATCH_CORRUPTED,    //!< Unknown command, or commands not rebuilding the announced size
+    LORAWAN_FMP_PATCH_IO_ERROR,     //!< A read or write callback failed
+} lorawan_fmp_patch_status_t;
+
+typedef struct lorawan_fmp_patch_header_s
+{
+    uint32_t base_fw_version;  //!< Firmware version the patch applies to, as returned in DevVersionAns
+    uint32_t next_fw_version;  //!< Firmware version once the patch is applied, as returned in DevUpgradeImageAns
+    uint32_t size;             //!< Size of the rebuilt firmware in bytes
+} lorawan_fmp_patch_header_t;
+
+/**
+ * @brief Storage accesses used to apply a patch, each returning 0 on success
+ *
+ * The rebuilt firmware is written sequentially from offset 0 and shall not overlap the running firmware.
+ */
+typedef struct lorawan_fmp_patch_io_s
+{
+    void* context;  //!< Passed back to the callbacks
+    int8_t ( *read_base )( void* context, uint32_t offset, uint8_t* data, uint32_t size );     //!< Running firmware
+    int8_t ( *read_patch )( void* context, uint32_t offset, uint8_t* data, uint32_t size );    //!< Patch, header incl.
+    int8_t ( *write_next )( void* context, uint32_t offset, const uint8_t* data, uint32_t size );  //!< New firmware
+} lorawan_fmp_patch_io_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Decode the header of a firmware upgrade image
+ *
+ * @param [in]  buffer  The first LORAWAN_FMP_PATCH_HEADER_SIZE bytes of the image
+ * @param [out] header  The decoded header
+ * @return lorawan_fmp_patch_status_t LORAWAN_FMP_PATCH_OK for a delta image, LORAWAN_FMP_PATCH_NOT_A_PATCH otherwise
+ */
+lorawan_fmp_patch_status_t lorawan_fmp_patch_get_header( const uint8_t* buffer, lorawan_fmp_patch_header_t* header );
+
+/**
+ * @brief Rebuild the next firmware from the running firmware and a delta image
+ *
+ * This file only depends on the C library so that it can be built in a bootloader as well as in the application.
+ *
+ * @param [in] io           Storage accesses
+ * @param [in] patch_size   Size of the delta image, header included
+ * @param [in] buffer       Work buffer, at least 16 bytes, the larger the fewer storage accesses
+ * @param [in] buffer_size  Size of the work buffer
+ * @return lorawan_fmp_patch_status_t
+ */
+lorawan_fmp_patch_status_t lorawan_fmp_patch_apply( const lorawan_fmp_patch_io_t* io, uint32_t patch_size,
+                                                    uint8_t* buffer, uint16_t buffer_size );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LORAWAN_FMP_PATCH_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -187,6 +187,17 @@ bool lorawan_fragmentation_package_service_mpa_injector( uint8_t stack_id, uint8
  */
 void lorawan_fragmentation_package_get_file_size( uint8_t stack_id, uint32_t* file_size );
 
+#if defined( FRAG_DECODER_DEFERRED )
+/**
+ * @brief Run the decoding of the queued fragments and the back substitution for at most
+ * FRAGMENTATION_DEFERRED_SLICE_MS, if no supervisor or radio task is close (FUOTA v2 only)
+ *
+ * @param [in] sleep_time_ms Time until the next engine run
+ * @return uint32_t Time until the next engine run, 0 once a slice is run so that the next one follows a new engine run
+ */
+uint32_t lorawan_fragmentation_package_decode_on_idle( uint32_t sleep_time_ms );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
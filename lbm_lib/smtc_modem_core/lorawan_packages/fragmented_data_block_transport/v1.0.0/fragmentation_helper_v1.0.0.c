@@ -33,7 +33,7 @@
  */
 #include <stddef.h>
 #include <stdbool.h>
-#include <string.h>  // for memset
+#include <string.h>  // for memset, memcpy
 #include "fragmentation_helper_v1.0.0.h"
 
 #define DBG_TRACE 0
@@ -71,6 +71,9 @@ typedef struct
 
     uint8_t S[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
 
+    uint32_t ParityModulus;     // Modulus of the PRBS23 draws: FragNb, FragNb + 1 when FragNb is a power of two
+    uint32_t ParityReciprocal;  // floor( ( 2^32 - 1 ) / ParityModulus ), replaces the division of every draw
+
     FragDecoderStatus_t Status;
 } FragDecoder_t;
 
@@ -151,6 +154,15 @@ static void XorParityLine( uint8_t* line1, uint8_t* line2, int32_t size );
  */
 static int32_t FragPrbs23( int32_t value );
 
+/*!
+ * \brief Reduces a PRBS23 value modulo FragDecoder.ParityModulus
+ *
+ * \param [IN] value PRBS23 value
+ *
+ * \retval r         value % FragDecoder.ParityModulus
+ */
+static int32_t FragParityReduce( int32_t value );
+
 /*!
  * \brief Gets and fills the parity matrix
  *
@@ -252,6 +264,9 @@ void FragDecoderInit( uint16_t fragNb, uint8_t fragSize, FragDecoderCallbacks_t*
     FragDecoder.Status.FragNbLost   = 0;
     FragDecoder.Status.FragNbLastRx = 0;
     FragDecoder.Status.MissingFrag  = fragNb;
+
+    FragDecoder.ParityModulus    = ( IsPowerOfTwo( fragNb ) != false ) ? ( uint32_t ) fragNb + 1 : fragNb;
+    FragDecoder.ParityReciprocal = ( FragDecoder.ParityModulus > 0 ) ? 0xFFFFFFFF / FragDecoder.ParityModulus : 0;
 }
 
 uint32_t FragDecoderGetMaxFileSize( void )
@@ -266,7 +281,11 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
     int32_t  noInfo        = 0;
 
     uint8_t matrixRow[( FRAG_MAX_NB >> 3 ) + 1];
-    uint8_t matrixDataTemp[FRAG_MAX_SIZE];
+    // Word aligned row buffers for XorDataLine, the received fragment is copied once in fragData
+    uint32_t matrixDataTempWords[( FRAG_MAX_SIZE + 3 ) >> 2];
+    uint32_t fragDataWords[( FRAG_MAX_SIZE + 3 ) >> 2];
+    uint8_t* matrixDataTemp = ( uint8_t* ) matrixDataTempWords;
+    uint8_t* fragData       = ( uint8_t* ) fragDataWords;
     uint8_t dataTempVector[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
     uint8_t dataTempVector2[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
 
@@ -309,6 +328,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
             FragDecoder.Status.MatrixError = 1;
             return FRAG_SESSION_FAILED;
         }
+        memcpy( fragData, rawData, FragDecoder.FragSize );
         // At this point we receive encoded frames and the number of loosing frames
         // is well known: FragDecoder.FragNbLost - 1;
 
@@ -329,7 +349,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 
                     GetRow( matrixDataTemp, i, FragDecoder.FragSize );
 
-                    XorDataLine( rawData, matrixDataTemp, FragDecoder.FragSize );
+                    XorDataLine( fragData, matrixDataTemp, FragDecoder.FragSize );
                 }
                 else
                 {
@@ -361,7 +381,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 
                 GetRow( matrixDataTemp, li, FragDecoder.FragSize );
 
-                XorDataLine( rawData, matrixDataTemp, FragDecoder.FragSize );
+                XorDataLine( fragData, matrixDataTemp, FragDecoder.FragSize );
                 if( BitArrayIsAllZeros( dataTempVector, FragDecoder.Status.FragNbLost ) )
                 {
                     noInfo = 1;
@@ -375,7 +395,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
                 FragPushLineToBinaryMatrix( dataTempVector, firstOneInRow, FragDecoder.Status.FragNbLost );
                 li = FragFindMissingIndex( firstOneInRow );
 
-                SetRow( rawData, li, FragDecoder.FragSize );
+                SetRow( fragData, li, FragDecoder.FragSize );
 
                 SetParity( firstOneInRow, FragDecoder.S, 1 );
                 FragDecoder.M2BLine++;
@@ -404,8 +424,8 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 
                                 lj = FragFindMissingIndex( j );
 
-                                GetRow( rawData, lj, FragDecoder.FragSize );
-                                XorDataLine( matrixDataTemp, rawData, FragDecoder.FragSize );
+                                GetRow( fragData, lj, FragDecoder.FragSize );
+                                XorDataLine( matrixDataTemp, fragData, FragDecoder.FragSize );
                             }
                         }
 
@@ -483,7 +503,21 @@ static bool IsPowerOfTwo( uint32_t x )
 
 static void XorDataLine( uint8_t* line1, uint8_t* line2, int32_t size )
 {
-    for( int32_t i = 0; i < size; i++ )
+    int32_t i = 0;
+
+    // Word wide XOR when both lines have the same alignment, cores without unaligned accesses included
+    if( ( ( ( uintptr_t ) line1 ^ ( uintptr_t ) line2 ) & 0x03 ) == 0 )
+    {
+        for( ; ( i < size ) && ( ( ( uintptr_t ) &line1[i] & 0x03 ) != 0 ); i++ )
+        {
+            line1[i] = line1[i] ^ line2[i];
+        }
+        for( ; i <= ( size - 4 ); i += 4 )
+        {
+            *( ( uint32_t* ) &line1[i] ) ^= *( ( uint32_t* ) &line2[i] );
+        }
+    }
+    for( ; i < size; i++ )
     {
         line1[i] = line1[i] ^ line2[i];
     }
@@ -491,9 +525,12 @@ static void XorDataLine( uint8_t* line1, uint8_t* line2, int32_t size )
 
 static void XorParityLine( uint8_t* line1, uint8_t* line2, int32_t size )
 {
-    for( int32_t i = 0; i < size; i++ )
+    // Bits are packed MSB first, whole bytes are XORed at once and the bits after size are kept
+    XorDataLine( line1, line2, size >> 3 );
+    if( ( size % 8 ) != 0 )
     {
-        SetParity( i, line1, ( GetParity( i, line1 ) ^ GetParity( i, line2 ) ) );
+        uint8_t mask = 0xFF << ( 8 - ( size % 8 ) );
+        line1[size >> 3] ^= line2[size >> 3] & mask;
     }
 }
 
@@ -504,22 +541,27 @@ static int32_t FragPrbs23( int32_t value )
     return ( value >> 1 ) + ( ( b0 ^ b1 ) << 22 );
 }
 
+static int32_t FragParityReduce( int32_t value )
+{
+    // Barrett reduction: the quotient estimate is at most one below the exact quotient for any 32-bit value, which
+    // avoids a software division per draw on cores without divider
+    uint32_t quotient = ( uint32_t ) ( ( ( uint64_t ) value * FragDecoder.ParityReciprocal ) >> 32 );
+    uint32_t r        = ( uint32_t ) value - quotient * FragDecoder.ParityModulus;
+
+    if( r >= FragDecoder.ParityModulus )
+    {
+        r -= FragDecoder.ParityModulus;
+    }
+    return ( int32_t ) r;
+}
+
 static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t* matrixRow )
 {
-    int32_t mTemp;
     int32_t x;
     int32_t nbCoeff = 0;
     int32_t r;
 
-    if( IsPowerOfTwo( m ) != false )
-    {
-        mTemp = 1;
-    }
-    else
-    {
-        mTemp = 0;
-    }
-
+    // The modulus m + 1 used when m is a power of two is computed once by FragDecoderInit
     x = 1 + ( 1001 * n );
     for( int32_t i = 0; i < ( ( m >> 3 ) + 1 ); i++ )
     {
@@ -531,7 +573,7 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t* matrixRow )
         while( r >= m )
         {
             x = FragPrbs23( x );
-            r = x % ( m + mTemp );
+            r = FragParityReduce( x );
         }
         SetParity( r, matrixRow, 1 );
         nbCoeff += 1;
@@ -540,7 +582,14 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t* matrixRow )
 
 static uint16_t BitArrayFindFirstOne( uint8_t* bitArray, uint16_t size )
 {
-    for( uint16_t i = 0; i < size; i++ )
+    uint16_t i = 0;
+
+    // Skip the null bytes
+    while( ( ( i + 8 ) <= size ) && ( bitArray[i >> 3] == 0 ) )
+    {
+        i += 8;
+    }
+    for( ; i < size; i++ )
     {
         if( GetParity( i, bitArray ) == 1 )
         {
@@ -552,7 +601,16 @@ static uint16_t BitArrayFindFirstOne( uint8_t* bitArray, uint16_t size )
 
 static uint8_t BitArrayIsAllZeros( uint8_t* bitArray, uint16_t size )
 {
-    for( uint16_t i = 0; i < size; i++ )
+    uint16_t i = 0;
+
+    for( ; ( i + 8 ) <= size; i += 8 )
+    {
+        if( bitArray[i >> 3] != 0 )
+        {
+            return 0;
+        }
+    }
+    for( ; i < size; i++ )
     {
         if( GetParity( i, bitArray ) == 1 )
         {
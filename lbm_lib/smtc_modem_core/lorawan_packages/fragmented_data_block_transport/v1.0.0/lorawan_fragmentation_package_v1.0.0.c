@@ -273,6 +273,8 @@ void lorawan_fragmentation_package_services_init( uint8_t* service_id, uint8_t t
     *on_update_callback = lorawan_fragmentation_package_service_on_update;
     *context_callback   = ( void* ) service_id;
 
+    modem_set_downlink_service_port( lorawan_fragmentation_package_service_downlink_handler, FRAGMENTATION_PORT );
+
     ctx->task_id  = task_id;
     ctx->stack_id = CURRENT_STACK;
     ctx->enabled  = true;
@@ -33,7 +33,7 @@
  */
 #include <stddef.h>
 #include <stdbool.h>
-#include <string.h>  // for memset
+#include <string.h>  // for memset, memcpy
 #include "fragmentation_helper_v2.0.0.h"
 
 #define DBG_TRACE 0
@@ -66,11 +66,22 @@ typedef struct
     uint8_t  FragSize;
 
     uint32_t M2BLine;
+#if defined( FRAG_DECODER_SPARSE )
+    uint16_t MissingFrags[FRAG_MAX_REDUNDANCY];  // Index of the lost fragments, sorted
+    uint16_t M2BSlot[FRAG_MAX_REDUNDANCY];       // Storage slot of each pushed matrix row
+#else
     uint8_t  MatrixM2B[( ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 ) * FRAG_MAX_REDUNDANCY];
     uint16_t FragNbMissingIndex[FRAG_MAX_NB];
+#endif
 
     uint8_t S[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
 
+    uint32_t ParityModulus;     // Modulus of the PRBS23 draws: FragNb, FragNb + 1 when FragNb is a power of two
+    uint32_t ParityReciprocal;  // floor( ( 2^32 - 1 ) / ParityModulus ), replaces the division of every draw
+#if defined( FRAG_DECODER_DEFERRED )
+    int32_t SolveRow;  // Next row of the back substitution, -1 if none is pending
+#endif
+
     FragDecoderStatus_t Status;
 } FragDecoder_t;
 
@@ -151,6 +162,15 @@ static void XorParityLine( uint8_t* line1, uint8_t* line2, int32_t size );
  */
 static int32_t FragPrbs23( int32_t value );
 
+/*!
+ * \brief Reduces a PRBS23 value modulo FragDecoder.ParityModulus
+ *
+ * \param [IN] value PRBS23 value
+ *
+ * \retval r         value % FragDecoder.ParityModulus
+ */
+static int32_t FragParityReduce( int32_t value );
+
 /*!
  * \brief Gets and fills the parity matrix
  *
@@ -195,6 +215,15 @@ static void FragFindMissingFrags( uint16_t counter );
  */
 static uint16_t FragFindMissingIndex( uint16_t x );
 
+/*!
+ * \brief Gets the rank of a fragment among the missing fragments
+ *
+ * \param [IN] index Fragment index
+ *
+ * \retval rank      0 if the fragment was received, x + 1 for the x th missing frag
+ */
+static uint16_t FragGetMissingRank( uint16_t index );
+
 /*!
  * \brief Extacts a row from the binary matrix and expands it to a bitArray
  *
@@ -213,6 +242,29 @@ static void FragExtractLineFromBinaryMatrix( uint8_t* bitArray, uint16_t rowInde
  */
 static void FragPushLineToBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow );
 
+#if !defined( FRAG_DECODER_INCREMENTAL )
+/*!
+ * \brief Solves a row of the back substitution, the rows below it being already solved
+ *
+ * \param [IN] row       Matrix row index
+ * \param [IN] rowData   Work buffer of FRAG_MAX_SIZE bytes, word aligned
+ * \param [IN] fragData  Work buffer of FRAG_MAX_SIZE bytes, word aligned
+ * \param [IN] matrixRow Work buffer of ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 bytes
+ */
+static void FragSolveRow( int32_t row, uint8_t* rowData, uint8_t* fragData, uint8_t* matrixRow );
+#endif
+
+#if defined( FRAG_DECODER_INCREMENTAL )
+/*!
+ * \brief Overwrites a row already pushed to the matrix
+ *
+ * \param [IN] bitArray  Pointer to the bit array
+ * \param [IN] rowIndex  Matrix row index
+ * \param [IN] bitsInRow Number of bits in one row
+ */
+static void FragUpdateLineInBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow );
+#endif  // FRAG_DECODER_INCREMENTAL
+
 /*
  *=============================================================================
  * Fragmentation decoder algorithm
@@ -232,11 +284,13 @@ void FragDecoderInit( uint16_t fragNb, uint8_t fragSize, FragDecoderCallbacks_t*
     FragDecoder.Status.FragNbLost   = 0;
     FragDecoder.M2BLine             = 0;
 
+#if !defined( FRAG_DECODER_SPARSE )
     // Initialize missing fragments index array
     for( uint16_t i = 0; i < FRAG_MAX_NB; i++ )
     {
         FragDecoder.FragNbMissingIndex[i] = 1;
     }
+#endif
 
     // Initialize parity matrix
     for( uint32_t i = 0; i < ( ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 ); i++ )
@@ -244,14 +298,22 @@ void FragDecoderInit( uint16_t fragNb, uint8_t fragSize, FragDecoderCallbacks_t*
         FragDecoder.S[i] = 0;
     }
 
+#if !defined( FRAG_DECODER_SPARSE )
     for( uint32_t i = 0; i < ( ( ( FRAG_MAX_REDUNDANCY >> 3 ) + 1 ) * FRAG_MAX_REDUNDANCY ); i++ )
     {
         FragDecoder.MatrixM2B[i] = 0xFF;
     }
+#endif
 
     FragDecoder.Status.FragNbLost   = 0;
     FragDecoder.Status.FragNbLastRx = 0;
     FragDecoder.Status.MissingFrag  = fragNb;
+
+    FragDecoder.ParityModulus    = ( IsPowerOfTwo( fragNb ) != false ) ? ( uint32_t ) fragNb + 1 : fragNb;
+    FragDecoder.ParityReciprocal = ( FragDecoder.ParityModulus > 0 ) ? 0xFFFFFFFF / FragDecoder.ParityModulus : 0;
+#if defined( FRAG_DECODER_DEFERRED )
+    FragDecoder.SolveRow = -1;
+#endif
 }
 
 uint32_t FragDecoderGetMaxFileSize( void )
@@ -259,14 +321,29 @@ uint32_t FragDecoderGetMaxFileSize( void )
     return FRAG_MAX_NB * FRAG_MAX_SIZE;
 }
 
+uint32_t FragDecoderGetMaxStorageSize( void )
+{
+#if defined( FRAG_DECODER_SPARSE )
+    return FragDecoderGetMaxFileSize( ) + FRAG_MAX_REDUNDANCY * ( ( ( FRAG_MAX_REDUNDANCY - 1 ) >> 3 ) + 1 );
+#else
+    return FragDecoderGetMaxFileSize( );
+#endif
+}
+
 int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 {
     uint16_t firstOneInRow = 0;
     int32_t  first         = 0;
-    int32_t  noInfo        = 0;
+#if !defined( FRAG_DECODER_INCREMENTAL )
+    int32_t noInfo = 0;
+#endif
 
     uint8_t matrixRow[( FRAG_MAX_NB >> 3 ) + 1];
-    uint8_t matrixDataTemp[FRAG_MAX_SIZE];
+    // Word aligned row buffers for XorDataLine, the received fragment is copied once in fragData
+    uint32_t matrixDataTempWords[( FRAG_MAX_SIZE + 3 ) >> 2];
+    uint32_t fragDataWords[( FRAG_MAX_SIZE + 3 ) >> 2];
+    uint8_t* matrixDataTemp = ( uint8_t* ) matrixDataTempWords;
+    uint8_t* fragData       = ( uint8_t* ) fragDataWords;
     uint8_t dataTempVector[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
     uint8_t dataTempVector2[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
 
@@ -290,7 +367,9 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 
         SetRow( rawData, fragCounter - 1, FragDecoder.FragSize );
 
+#if !defined( FRAG_DECODER_SPARSE )
         FragDecoder.FragNbMissingIndex[fragCounter - 1] = 0;
+#endif
 
         // Update the FragDecoder.FragNbMissingIndex with the loosing frame
         FragFindMissingFrags( fragCounter );
@@ -309,6 +388,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
             FragDecoder.Status.MatrixError = 1;
             return FRAG_SESSION_FAILED;
         }
+        memcpy( fragData, rawData, FragDecoder.FragSize );
         // At this point we receive encoded frames and the number of loosing frames
         // is well known: FragDecoder.FragNbLost - 1;
 
@@ -322,19 +402,20 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
         {
             if( GetParity( i, matrixRow ) == 1 )
             {
-                if( FragDecoder.FragNbMissingIndex[i] == 0 )
+                uint16_t missingRank = FragGetMissingRank( i );
+                if( missingRank == 0 )
                 {
                     // XOR with already receive frag
                     SetParity( i, matrixRow, 0 );
 
                     GetRow( matrixDataTemp, i, FragDecoder.FragSize );
 
-                    XorDataLine( rawData, matrixDataTemp, FragDecoder.FragSize );
+                    XorDataLine( fragData, matrixDataTemp, FragDecoder.FragSize );
                 }
                 else
                 {
                     // Fill the "little" boolean matrix m2b
-                    SetParity( FragDecoder.FragNbMissingIndex[i] - 1, dataTempVector, 1 );
+                    SetParity( missingRank - 1, dataTempVector, 1 );
                     if( first == 0 )
                     {
                         first = 1;
@@ -345,10 +426,66 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 
         firstOneInRow = BitArrayFindFirstOne( dataTempVector, FragDecoder.Status.FragNbLost );
 
+#if defined( FRAG_DECODER_INCREMENTAL )
+        if( first > 0 )
+        {
+            uint16_t lost = FragDecoder.Status.FragNbLost;
+            int32_t  li;
+
+            // The stored rows are fully reduced: each one only holds its own pivot among the pivot columns
+            for( uint16_t j = 0; j < lost; j++ )
+            {
+                if( ( GetParity( j, dataTempVector ) == 1 ) && ( GetParity( j, FragDecoder.S ) == 1 ) )
+                {
+                    FragExtractLineFromBinaryMatrix( dataTempVector2, j, lost );
+                    XorParityLine( dataTempVector, dataTempVector2, lost );
+
+                    GetRow( matrixDataTemp, FragFindMissingIndex( j ), FragDecoder.FragSize );
+                    XorDataLine( fragData, matrixDataTemp, FragDecoder.FragSize );
+                }
+            }
+
+            if( BitArrayIsAllZeros( dataTempVector, lost ) == 0 )
+            {
+                firstOneInRow = BitArrayFindFirstOne( dataTempVector, lost );
+
+                // Remove the new pivot from the rows above so that they stay fully reduced
+                for( uint16_t i = 0; i < firstOneInRow; i++ )
+                {
+                    if( GetParity( i, FragDecoder.S ) == 0 )
+                    {
+                        continue;
+                    }
+                    FragExtractLineFromBinaryMatrix( dataTempVector2, i, lost );
+                    if( GetParity( firstOneInRow, dataTempVector2 ) == 1 )
+                    {
+                        XorParityLine( dataTempVector2, dataTempVector, lost );
+                        FragUpdateLineInBinaryMatrix( dataTempVector2, i, lost );
+
+                        li = FragFindMissingIndex( i );
+                        GetRow( matrixDataTemp, li, FragDecoder.FragSize );
+                        XorDataLine( matrixDataTemp, fragData, FragDecoder.FragSize );
+                        SetRow( matrixDataTemp, li, FragDecoder.FragSize );
+                    }
+                }
+
+                FragPushLineToBinaryMatrix( dataTempVector, firstOneInRow, lost );
+                SetRow( fragData, FragFindMissingIndex( firstOneInRow ), FragDecoder.FragSize );
+                SetParity( firstOneInRow, FragDecoder.S, 1 );
+                FragDecoder.M2BLine++;
+            }
+
+            FragDecoder.Status.MissingFrag = lost - FragDecoder.M2BLine;
+            if( FragDecoder.M2BLine == lost )
+            {
+                // Every row is reduced to its pivot: the lost fragments are already written in the file
+                return FRAG_SESSION_FINISHED_SUCCESSFULLY;
+            }
+        }
+#else
         if( first > 0 )
         {
             int32_t li;
-            int32_t lj;
 
             // Manage a new line in MatrixM2B
             while( GetParity( firstOneInRow, FragDecoder.S ) == 1 )
@@ -361,7 +498,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
 
                 GetRow( matrixDataTemp, li, FragDecoder.FragSize );
 
-                XorDataLine( rawData, matrixDataTemp, FragDecoder.FragSize );
+                XorDataLine( fragData, matrixDataTemp, FragDecoder.FragSize );
                 if( BitArrayIsAllZeros( dataTempVector, FragDecoder.Status.FragNbLost ) )
                 {
                     noInfo = 1;
@@ -375,7 +512,7 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
                 FragPushLineToBinaryMatrix( dataTempVector, firstOneInRow, FragDecoder.Status.FragNbLost );
                 li = FragFindMissingIndex( firstOneInRow );
 
-                SetRow( rawData, li, FragDecoder.FragSize );
+                SetRow( fragData, li, FragDecoder.FragSize );
 
                 SetParity( firstOneInRow, FragDecoder.S, 1 );
                 FragDecoder.M2BLine++;
@@ -386,32 +523,17 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
                 // Then last step diagonalized
                 if( FragDecoder.Status.FragNbLost > 1 )
                 {
-                    int32_t i, j;
-
-                    for( i = ( FragDecoder.Status.FragNbLost - 2 ); i >= 0; i-- )
+#if defined( FRAG_DECODER_DEFERRED )
+                    // The caller runs the back substitution with FragDecoderSolve
+                    FragDecoder.SolveRow = FragDecoder.Status.FragNbLost - 2;
+                    return FRAG_SESSION_SOLVING;
+#else
+                    for( int32_t i = ( FragDecoder.Status.FragNbLost - 2 ); i >= 0; i-- )
                     {
-                        li = FragFindMissingIndex( i );
-
-                        GetRow( matrixDataTemp, li, FragDecoder.FragSize );
-
-                        for( j = ( FragDecoder.Status.FragNbLost - 1 ); j > i; j-- )
-                        {
-                            FragExtractLineFromBinaryMatrix( dataTempVector2, i, FragDecoder.Status.FragNbLost );
-                            FragExtractLineFromBinaryMatrix( dataTempVector, j, FragDecoder.Status.FragNbLost );
-                            if( GetParity( j, dataTempVector2 ) == 1 )
-                            {
-                                XorParityLine( dataTempVector2, dataTempVector, FragDecoder.Status.FragNbLost );
-
-                                lj = FragFindMissingIndex( j );
-
-                                GetRow( rawData, lj, FragDecoder.FragSize );
-                                XorDataLine( matrixDataTemp, rawData, FragDecoder.FragSize );
-                            }
-                        }
-
-                        SetRow( matrixDataTemp, li, FragDecoder.FragSize );
+                        FragSolveRow( i, matrixDataTemp, fragData, dataTempVector2 );
                     }
                     return FRAG_SESSION_FINISHED_SUCCESSFULLY;
+#endif
                 }
                 else
                 {
@@ -420,10 +542,39 @@ int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData )
                 }
             }
         }
+#endif  // FRAG_DECODER_INCREMENTAL
     }
     return FRAG_SESSION_ONGOING;
 }
 
+#if defined( FRAG_DECODER_DEFERRED )
+int32_t FragDecoderSolve( uint16_t nbRows )
+{
+#if defined( FRAG_DECODER_INCREMENTAL )
+    // The matrix is kept fully reduced, there is never a back substitution to run
+    ( void ) nbRows;
+    return FRAG_SESSION_ONGOING;
+#else
+    uint32_t rowDataWords[( FRAG_MAX_SIZE + 3 ) >> 2];
+    uint32_t fragDataWords[( FRAG_MAX_SIZE + 3 ) >> 2];
+    uint8_t  matrixRow[( FRAG_MAX_REDUNDANCY >> 3 ) + 1];
+
+    if( FragDecoder.SolveRow < 0 )
+    {
+        return FRAG_SESSION_ONGOING;
+    }
+
+    for( ; ( nbRows > 0 ) && ( FragDecoder.SolveRow >= 0 ); nbRows-- )
+    {
+        FragSolveRow( FragDecoder.SolveRow, ( uint8_t* ) rowDataWords, ( uint8_t* ) fragDataWords, matrixRow );
+        FragDecoder.SolveRow--;
+    }
+
+    return ( FragDecoder.SolveRow >= 0 ) ? FRAG_SESSION_SOLVING : FRAG_SESSION_FINISHED_SUCCESSFULLY;
+#endif
+}
+#endif
+
 FragDecoderStatus_t FragDecoderGetStatus( void )
 {
     return FragDecoder.Status;
@@ -483,7 +634,21 @@ static bool IsPowerOfTwo( uint32_t x )
 
 static void XorDataLine( uint8_t* line1, uint8_t* line2, int32_t size )
 {
-    for( int32_t i = 0; i < size; i++ )
+    int32_t i = 0;
+
+    // Word wide XOR when both lines have the same alignment, cores without unaligned accesses included
+    if( ( ( ( uintptr_t ) line1 ^ ( uintptr_t ) line2 ) & 0x03 ) == 0 )
+    {
+        for( ; ( i < size ) && ( ( ( uintptr_t ) &line1[i] & 0x03 ) != 0 ); i++ )
+        {
+            line1[i] = line1[i] ^ line2[i];
+        }
+        for( ; i <= ( size - 4 ); i += 4 )
+        {
+            *( ( uint32_t* ) &line1[i] ) ^= *( ( uint32_t* ) &line2[i] );
+        }
+    }
+    for( ; i < size; i++ )
     {
         line1[i] = line1[i] ^ line2[i];
     }
@@ -491,9 +656,12 @@ static void XorDataLine( uint8_t* line1, uint8_t* line2, int32_t size )
 
 static void XorParityLine( uint8_t* line1, uint8_t* line2, int32_t size )
 {
-    for( int32_t i = 0; i < size; i++ )
+    // Bits are packed MSB first, whole bytes are XORed at once and the bits after size are kept
+    XorDataLine( line1, line2, size >> 3 );
+    if( ( size % 8 ) != 0 )
     {
-        SetParity( i, line1, ( GetParity( i, line1 ) ^ GetParity( i, line2 ) ) );
+        uint8_t mask = 0xFF << ( 8 - ( size % 8 ) );
+        line1[size >> 3] ^= line2[size >> 3] & mask;
     }
 }
 
@@ -504,22 +672,27 @@ static int32_t FragPrbs23( int32_t value )
     return ( value >> 1 ) + ( ( b0 ^ b1 ) << 22 );
 }
 
+static int32_t FragParityReduce( int32_t value )
+{
+    // Barrett reduction: the quotient estimate is at most one below the exact quotient for any 32-bit value, which
+    // avoids a software division per draw on cores without divider
+    uint32_t quotient = ( uint32_t ) ( ( ( uint64_t ) value * FragDecoder.ParityReciprocal ) >> 32 );
+    uint32_t r        = ( uint32_t ) value - quotient * FragDecoder.ParityModulus;
+
+    if( r >= FragDecoder.ParityModulus )
+    {
+        r -= FragDecoder.ParityModulus;
+    }
+    return ( int32_t ) r;
+}
+
 static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t* matrixRow )
 {
-    int32_t mTemp;
     int32_t x;
     int32_t nbCoeff = 0;
     int32_t r;
 
-    if( IsPowerOfTwo( m ) != false )
-    {
-        mTemp = 1;
-    }
-    else
-    {
-        mTemp = 0;
-    }
-
+    // The modulus m + 1 used when m is a power of two is computed once by FragDecoderInit
     x = 1 + ( 1001 * n );
     for( int32_t i = 0; i < ( ( m >> 3 ) + 1 ); i++ )
     {
@@ -531,7 +704,7 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t* matrixRow )
         while( r >= m )
         {
             x = FragPrbs23( x );
-            r = x % ( m + mTemp );
+            r = FragParityReduce( x );
         }
         if( GetParity( r, matrixRow ) == 0 )
         {
@@ -543,7 +716,14 @@ static void FragGetParityMatrixRow( int32_t n, int32_t m, uint8_t* matrixRow )
 
 static uint16_t BitArrayFindFirstOne( uint8_t* bitArray, uint16_t size )
 {
-    for( uint16_t i = 0; i < size; i++ )
+    uint16_t i = 0;
+
+    // Skip the null bytes
+    while( ( ( i + 8 ) <= size ) && ( bitArray[i >> 3] == 0 ) )
+    {
+        i += 8;
+    }
+    for( ; i < size; i++ )
     {
         if( GetParity( i, bitArray ) == 1 )
         {
@@ -555,7 +735,16 @@ static uint16_t BitArrayFindFirstOne( uint8_t* bitArray, uint16_t size )
 
 static uint8_t BitArrayIsAllZeros( uint8_t* bitArray, uint16_t size )
 {
-    for( uint16_t i = 0; i < size; i++ )
+    uint16_t i = 0;
+
+    for( ; ( i + 8 ) <= size; i += 8 )
+    {
+        if( bitArray[i >> 3] != 0 )
+        {
+            return 0;
+        }
+    }
+    for( ; i < size; i++ )
     {
         if( GetParity( i, bitArray ) == 1 )
         {
@@ -579,7 +768,15 @@ static void FragFindMissingFrags( uint16_t counter )
         if( i < FragDecoder.FragNb )
         {
             FragDecoder.Status.FragNbLost++;
+#if defined( FRAG_DECODER_SPARSE )
+            // Above FRAG_MAX_REDUNDANCY the session fails with the first coded fragment
+            if( FragDecoder.Status.FragNbLost <= FRAG_MAX_REDUNDANCY )
+            {
+                FragDecoder.MissingFrags[FragDecoder.Status.FragNbLost - 1] = i;
+            }
+#else
             FragDecoder.FragNbMissingIndex[i] = FragDecoder.Status.FragNbLost;
+#endif
         }
     }
     if( i < FragDecoder.FragNb )
@@ -605,6 +802,9 @@ static void FragFindMissingFrags( uint16_t counter )
  */
 static uint16_t FragFindMissingIndex( uint16_t x )
 {
+#if defined( FRAG_DECODER_SPARSE )
+    return FragDecoder.MissingFrags[x];
+#else
     for( uint16_t i = 0; i < FragDecoder.FragNb; i++ )
     {
         if( FragDecoder.FragNbMissingIndex[i] == ( x + 1 ) )
@@ -613,8 +813,87 @@ static uint16_t FragFindMissingIndex( uint16_t x )
         }
     }
     return 0;
+#endif
 }
 
+static uint16_t FragGetMissingRank( uint16_t index )
+{
+#if defined( FRAG_DECODER_SPARSE )
+    // Binary search, the lost fragments are found in increasing order
+    uint16_t low  = 0;
+    uint16_t high = FragDecoder.Status.FragNbLost;
+
+    while( low < high )
+    {
+        uint16_t mid = low + ( ( high - low ) >> 1 );
+        if( FragDecoder.MissingFrags[mid] == index )
+        {
+            return mid + 1;
+        }
+        if( FragDecoder.MissingFrags[mid] < index )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return 0;
+#else
+    return FragDecoder.FragNbMissingIndex[index];
+#endif
+}
+
+#if defined( FRAG_DECODER_SPARSE )
+/*!
+ * \brief Gets the storage address of a matrix slot
+ *
+ * \param [IN] slot      Matrix slot
+ * \param [IN] bitsInRow Number of bits in one row
+ *
+ * \retval addr          Address given to the callbacks
+ */
+static uint32_t FragGetMatrixSlotAddr( uint16_t slot, uint16_t bitsInRow )
+{
+    return FragDecoderGetMaxFileSize( ) + ( uint32_t ) slot * ( ( ( bitsInRow - 1 ) >> 3 ) + 1 );
+}
+
+static void FragExtractLineFromBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow )
+{
+    if( ( FragDecoder.Callbacks != NULL ) && ( FragDecoder.Callbacks->FragDecoderRead != NULL ) )
+    {
+        FragDecoder.Callbacks->FragDecoderRead( FragGetMatrixSlotAddr( FragDecoder.M2BSlot[rowIndex], bitsInRow ),
+                                                bitArray, ( ( bitsInRow - 1 ) >> 3 ) + 1 );
+    }
+    for( uint16_t i = 0; i < rowIndex; i++ )
+    {
+        SetParity( i, bitArray, 0 );
+    }
+}
+
+static void FragPushLineToBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow )
+{
+    // Rows are appended in push order so that the storage is written sequentially
+    FragDecoder.M2BSlot[rowIndex] = FragDecoder.M2BLine;
+    if( ( FragDecoder.Callbacks != NULL ) && ( FragDecoder.Callbacks->FragDecoderWrite != NULL ) )
+    {
+        FragDecoder.Callbacks->FragDecoderWrite( FragGetMatrixSlotAddr( FragDecoder.M2BLine, bitsInRow ), bitArray,
+                                                 ( ( bitsInRow - 1 ) >> 3 ) + 1 );
+    }
+}
+
+#if defined( FRAG_DECODER_INCREMENTAL )
+static void FragUpdateLineInBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow )
+{
+    if( ( FragDecoder.Callbacks != NULL ) && ( FragDecoder.Callbacks->FragDecoderWrite != NULL ) )
+    {
+        FragDecoder.Callbacks->FragDecoderWrite( FragGetMatrixSlotAddr( FragDecoder.M2BSlot[rowIndex], bitsInRow ),
+                                                 bitArray, ( ( bitsInRow - 1 ) >> 3 ) + 1 );
+    }
+}
+#endif  // FRAG_DECODER_INCREMENTAL
+#else
 /*!
  * \brief Extacts a row from the binary matrix and expands it to a bitArray
  *
@@ -676,6 +955,13 @@ static void FragPushLineToBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, ui
             FragDecoder.MatrixM2B[findByte] =
                 FragDecoder.MatrixM2B[findByte] & ( 0xFF - ( 1 << ( 7 - findBitInByte ) ) );
         }
+#if defined( FRAG_DECODER_INCREMENTAL )
+        else
+        {
+            // Only needed when a row is updated, the matrix is initialized with ones
+            FragDecoder.MatrixM2B[findByte] = FragDecoder.MatrixM2B[findByte] | ( 1 << ( 7 - findBitInByte ) );
+        }
+#endif  // FRAG_DECODER_INCREMENTAL
         findBitInByte++;
         if( findBitInByte == 8 )
         {
@@ -684,3 +970,33 @@ static void FragPushLineToBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, ui
         }
     }
 }
+
+#if defined( FRAG_DECODER_INCREMENTAL )
+static void FragUpdateLineInBinaryMatrix( uint8_t* bitArray, uint16_t rowIndex, uint16_t bitsInRow )
+{
+    FragPushLineToBinaryMatrix( bitArray, rowIndex, bitsInRow );
+}
+#endif  // FRAG_DECODER_INCREMENTAL
+#endif  // FRAG_DECODER_SPARSE
+
+#if !defined( FRAG_DECODER_INCREMENTAL )
+static void FragSolveRow( int32_t row, uint8_t* rowData, uint8_t* fragData, uint8_t* matrixRow )
+{
+    int32_t li = FragFindMissingIndex( row );
+
+    GetRow( rowData, li, FragDecoder.FragSize );
+
+    // Rows below row are already solved, only the bits of row select them
+    FragExtractLineFromBinaryMatrix( matrixRow, row, FragDecoder.Status.FragNbLost );
+    for( int32_t j = ( FragDecoder.Status.FragNbLost - 1 ); j > row; j-- )
+    {
+        if( GetParity( j, matrixRow ) == 1 )
+        {
+            GetRow( fragData, FragFindMissingIndex( j ), FragDecoder.FragSize );
+            XorDataLine( rowData, fragData, FragDecoder.FragSize );
+        }
+    }
+
+    SetRow( rowData, li, FragDecoder.FragSize );
+}
+#endif  // !FRAG_DECODER_INCREMENTAL
@@ -72,10 +72,48 @@ extern "C" {
 #define FRAG_MAX_REDUNDANCY FRAG_MAX_NB
 #endif
 
+/*!
+ * Sparse decoder variant, enabled by defining FRAG_DECODER_SPARSE
+ *
+ * The lost fragments are kept as a sorted list instead of one entry per fragment and the rows of the binary
+ * elimination matrix are stored after the file through the \ref FragDecoderWrite and \ref FragDecoderRead callbacks,
+ * only the rows being eliminated are kept in RAM. With N = FRAG_MAX_NB and R = FRAG_MAX_REDUNDANCY:
+ *
+ *  - RAM:        about N / 8 + 4 * R + 3 * R / 8 + FRAG_MAX_SIZE bytes instead of 2 * N + R * R / 8 bytes
+ *  - Storage:    \ref FragDecoderGetMaxStorageSize bytes, the file followed by up to R rows of R / 8 bytes
+ *  - Per coded fragment: one parity row generation in O( N ), up to N / 2 file row reads, up to L matrix row reads
+ *    and one matrix row write, L being the number of lost fragments
+ *  - Last coded fragment: L matrix row reads and up to L * L / 2 file row reads for the back substitution
+ */
+
+/*!
+ * Incremental decoder variant, enabled by defining FRAG_DECODER_INCREMENTAL
+ *
+ * Each coded fragment is reduced against all the stored rows and its pivot is removed from them, so that the matrix
+ * stays fully reduced and a lost fragment is written in the file as soon as its row only holds its pivot. The last
+ * needed coded fragment completes the session without back substitution. With L the number of lost fragments:
+ *
+ *  - Per coded fragment: one parity row generation in O( N ), up to N / 2 file row reads, up to L matrix row reads
+ *    and up to L file row reads for the reduction, up to L matrix row reads, L matrix row writes, L file row reads
+ *    and L file row writes to remove the new pivot
+ *  - Last coded fragment: same bound, there is no final burst
+ *
+ * The work is spread over the session instead of being done at its end, at the cost of more file row writes in total.
+ */
+
+/*!
+ * Deferred back substitution, enabled by defining FRAG_DECODER_DEFERRED
+ *
+ * The last needed coded fragment does not run the back substitution: ef FragDecoderProcess returns
+ * FRAG_SESSION_SOLVING and the caller runs it a few rows at a time with ef FragDecoderSolve, one row costing up to
+ * L file row reads and one file row write. Without effect with FRAG_DECODER_INCREMENTAL, which has no final burst.
+ */
+
 #define FRAG_SESSION_FAILED ( int32_t ) 1
 #define FRAG_SESSION_FINISHED_SUCCESSFULLY ( int32_t ) 0
 #define FRAG_SESSION_NOT_STARTED ( int32_t ) - 2
 #define FRAG_SESSION_ONGOING ( int32_t ) - 1
+#define FRAG_SESSION_SOLVING ( int32_t ) - 3
 
 typedef struct sFragDecoderStatus
 {
@@ -140,6 +178,16 @@ void FragDecoderInit( uint16_t fragNb, uint8_t fragSize, uint8_t* file, uint32_t
  * \retval size FileSize
  */
 uint32_t FragDecoderGetMaxFileSize( void );
+
+/*!
+ * \brief Gets the size of the storage accessed through the callbacks
+ *
+ * \remark Equal to \ref FragDecoderGetMaxFileSize unless FRAG_DECODER_SPARSE is defined, the elimination matrix is
+ *         then stored after the file
+ *
+ * \retval size Storage size
+ */
+uint32_t FragDecoderGetMaxStorageSize( void );
 #endif
 
 /*!
@@ -150,11 +198,25 @@ uint32_t FragDecoderGetMaxFileSize( void );
  * \param [IN] rawData     Pointer to the fragment to be processed (length = FragDecoder.FragSize)
  *
  * \retval status          Process status. [FRAG_SESSION_ONGOING,
- *                                          FRAG_SESSION_FINISHED or
+ *                                          FRAG_SESSION_FINISHED,
+ *                                          FRAG_SESSION_SOLVING or
  *                                          FragDecoder.Status.FragNbLost]
  */
 int32_t FragDecoderProcess( uint16_t fragCounter, uint8_t* rawData );
 
+#if defined( FRAG_DECODER_DEFERRED )
+/*!
+ * \brief Runs the back substitution left by \ref FragDecoderProcess returning FRAG_SESSION_SOLVING
+ *
+ * \param [IN] nbRows     Maximum number of rows to solve, the last row solved completes the file
+ *
+ * \retval status         Process status. [FRAG_SESSION_SOLVING while rows are left,
+ *                                          FRAG_SESSION_FINISHED_SUCCESSFULLY once the file is rebuilt,
+ *                                          FRAG_SESSION_ONGOING if no back substitution is pending]
+ */
+int32_t FragDecoderSolve( uint16_t nbRows );
+#endif
+
 /*!
  * \brief Gets the current fragmentation status
  *
@@ -77,6 +77,63 @@
 
 #define NUMBER_OF_FRAGMENTED_PACKAGE_OBJ 1
 
+/**
+ * @brief Size of the RAM window staging the fragment writes
+ *
+ * @remark Shall divide the flash page size and the FUOTA area shall start on a page boundary, so that every staged
+ * window is written in a single page program
+ */
+#ifndef FRAGMENTATION_STAGING_WINDOW_SIZE
+#define FRAGMENTATION_STAGING_WINDOW_SIZE 2048
+#endif
+
+/**
+ * @brief Number of staging windows, the sparse decoder stores its elimination matrix after the file in a second one
+ */
+#if defined( FRAG_DECODER_SPARSE )
+#define FRAGMENTATION_STAGING_WINDOW_NB 2
+#else
+#define FRAGMENTATION_STAGING_WINDOW_NB 1
+#endif
+
+/**
+ * @brief Staging window offset when no window is loaded
+ */
+#define FRAGMENTATION_STAGING_NO_WINDOW 0xFFFFFFFF
+
+/**
+ * @brief Chunk size used to read back the file for the data block integrity check
+ */
+#define FRAGMENTATION_INTEGRITY_READ_CHUNK_SIZE 64
+
+#if defined( FRAG_DECODER_DEFERRED )
+/**
+ * @brief Number of fragments waiting for the decoder, the oldest one is decoded in the downlink handler when full
+ */
+#ifndef FRAGMENTATION_DEFERRED_QUEUE_LENGTH
+#define FRAGMENTATION_DEFERRED_QUEUE_LENGTH 4
+#endif
+
+/**
+ * @brief Maximum decoding time by engine run, a fragment or a back substitution row is never split
+ */
+#ifndef FRAGMENTATION_DEFERRED_SLICE_MS
+#define FRAGMENTATION_DEFERRED_SLICE_MS 10
+#endif
+
+/**
+ * @brief Minimum time until the next supervisor or radio task to start a decoding slice
+ */
+#ifndef FRAGMENTATION_DEFERRED_IDLE_MS
+#define FRAGMENTATION_DEFERRED_IDLE_MS 50
+#endif
+
+/**
+ * @brief Session index when no back substitution is pending
+ */
+#define FRAGMENTATION_DEFERRED_NO_SESSION 0xFF
+#endif  // FRAG_DECODER_DEFERRED
+
 /**
  * @brief Compute current LoRaWAN Stack from the supervisor task_id
  *
@@ -212,21 +269,64 @@ typedef struct frag_session_data_s
     int32_t               frag_decoder_process_status;
 } frag_session_data_t;
 
+typedef struct frag_staging_s
+{
+    uint32_t window;       // FUOTA offset of the loaded window, FRAGMENTATION_STAGING_NO_WINDOW if none
+    uint32_t dirty_start;  // First byte of the window not written in flash yet
+    uint32_t dirty_end;    // Byte after the last one not written in flash yet, equal to dirty_start if clean
+    uint8_t  buffer[FRAGMENTATION_STAGING_WINDOW_SIZE];
+} frag_staging_t;
+
+#if defined( FRAG_DECODER_DEFERRED )
+typedef struct frag_deferred_fragment_s
+{
+    uint8_t  stack_id;
+    uint8_t  frag_index;
+    uint16_t frag_counter;
+    uint8_t  data[FRAG_MAX_SIZE];
+} frag_deferred_fragment_t;
+
+typedef struct frag_deferred_s
+{
+    frag_deferred_fragment_t fifo[FRAGMENTATION_DEFERRED_QUEUE_LENGTH];
+    uint8_t                  first;             // Oldest queued fragment
+    uint8_t                  count;             // Number of queued fragments
+    uint8_t                  solving_index;     // Session of the pending back substitution
+    uint8_t                  solving_stack_id;  // Stack of the pending back substitution
+} frag_deferred_t;
+#endif  // FRAG_DECODER_DEFERRED
+
 typedef struct lr1_frag_pkg_s
 {
     uint8_t                nb_transmit_ans;
     frag_session_data_t    frag_session_data[FRAGMENTATION_MAX_NB_SESSIONS];
     FragDecoderCallbacks_t frag_decoder_callback;
+    frag_staging_t         frag_staging[FRAGMENTATION_STAGING_WINDOW_NB];
+#if defined( FRAG_DECODER_DEFERRED )
+    frag_deferred_t        frag_deferred;
+#endif
 } lr1_frag_pkg_t;
 
 static lr1_frag_pkg_t lr1_frag_pkg_ctx;
 #define nb_transmit_ans lr1_frag_pkg_ctx.nb_transmit_ans
 #define frag_session_data lr1_frag_pkg_ctx.frag_session_data
 #define frag_decoder_callback lr1_frag_pkg_ctx.frag_decoder_callback
+#define frag_staging lr1_frag_pkg_ctx.frag_staging
+#define frag_deferred lr1_frag_pkg_ctx.frag_deferred
 
 static int8_t  frag_decoder_write( uint32_t addr, uint8_t* data, uint32_t size );
 static int8_t  frag_decoder_read( uint32_t addr, uint8_t* data, uint32_t size );
+static void    frag_staging_flush( void );
+static void    frag_staging_reset( void );
 static uint8_t compute_data_block_integrity_ckeck( uint8_t frag_index, uint8_t stack_id );
+static uint8_t frag_session_update( lorawan_fragmentation_package_ctx_t* ctx, uint8_t frag_index,
+                                    int32_t process_status, uint8_t ans_index, uint8_t max_payload_size );
+#if defined( FRAG_DECODER_DEFERRED )
+static void frag_deferred_reset( void );
+static void frag_deferred_push( uint8_t stack_id, uint8_t frag_index, uint16_t frag_counter, const uint8_t* data,
+                                uint8_t size );
+static bool frag_deferred_step( void );
+#endif
 
 /* -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -297,6 +397,8 @@ void lorawan_fragmentation_package_services_init( uint8_t* service_id, uint8_t t
     *on_update_callback = lorawan_fragmentation_package_service_on_update;
     *context_callback   = ( void* ) service_id;
 
+    modem_set_downlink_service_port( lorawan_fragmentation_package_service_downlink_handler, FRAGMENTATION_PORT );
+
     ctx->task_id                       = task_id;
     ctx->stack_id                      = CURRENT_STACK;
     ctx->enabled                       = true;
@@ -304,6 +406,10 @@ void lorawan_fragmentation_package_services_init( uint8_t* service_id, uint8_t t
 
     frag_decoder_callback.FragDecoderWrite = frag_decoder_write;
     frag_decoder_callback.FragDecoderRead  = frag_decoder_read;
+    frag_staging_reset( );
+#if defined( FRAG_DECODER_DEFERRED )
+    frag_deferred_reset( );
+#endif
     for( int i = 0; i < FRAGMENTATION_MAX_NB_SESSIONS; i++ )
     {
         frag_session_data[i].frag_group_data.session_cnt_prev = -1;
@@ -471,6 +577,31 @@ void lorawan_fragmentation_package_get_file_size( uint8_t stack_id, uint32_t* fi
 
     *file_size = ctx->file_done_size;
 }
+
+#if defined( FRAG_DECODER_DEFERRED )
+uint32_t lorawan_fragmentation_package_decode_on_idle( uint32_t sleep_time_ms )
+{
+    if( ( frag_deferred.count == 0 ) && ( frag_deferred.solving_index == FRAGMENTATION_DEFERRED_NO_SESSION ) )
+    {
+        return sleep_time_ms;
+    }
+
+    // Decoding must not delay a MAC task: it waits for a gap in the supervisor and radio planner timelines
+    if( ( sleep_time_ms < FRAGMENTATION_DEFERRED_IDLE_MS ) ||
+        ( rp_get_next_task_delay_ms( modem_get_rp( ) ) < FRAGMENTATION_DEFERRED_IDLE_MS ) )
+    {
+        return sleep_time_ms;
+    }
+
+    // A fragment or a row is the smallest unit of work, the slice stops at the first one ending after the budget
+    uint32_t start_ms = smtc_modem_hal_get_time_in_ms( );
+    while( ( frag_deferred_step( ) == true ) &&
+           ( ( int32_t ) ( smtc_modem_hal_get_time_in_ms( ) - start_ms ) < FRAGMENTATION_DEFERRED_SLICE_MS ) )
+    {
+    }
+    return 0;
+}
+#endif  // FRAG_DECODER_DEFERRED
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -727,6 +858,11 @@ static frag_status_t fragmentation_package_parser( lorawan_fragmentation_package
                 memcpy( &frag_session_data[frag_session_data_tmp.frag_group_data.frag_session.frag_index],
                         &frag_session_data_tmp, sizeof( frag_session_data_t ) );
 
+                frag_staging_reset( );
+#if defined( FRAG_DECODER_DEFERRED )
+                // The queued fragments and the pending back substitution belong to the previous decoder session
+                frag_deferred_reset( );
+#endif
                 FragDecoderInit( frag_session_data_tmp.frag_group_data.frag_nb,
                                  frag_session_data_tmp.frag_group_data.frag_size, &frag_decoder_callback );
             }
@@ -857,54 +993,18 @@ static frag_status_t fragmentation_package_parser( lorawan_fragmentation_package
                 {
                     SMTC_MODEM_HAL_TRACE_ARRAY( "FUOTA FRAG = ", fragmentation_package_rx_buffer,
                                                 fragmentation_package_rx_buffer_length );
-                    frag_session_data[frag_index].frag_decoder_process_status = FragDecoderProcess(
+#if defined( FRAG_DECODER_DEFERRED )
+                    // Decoded by lorawan_fragmentation_package_decode_on_idle, out of the MAC timeline
+                    frag_deferred_push( stack_id, frag_index, frag_counter,
+                                        &fragmentation_package_rx_buffer[fragmentation_package_rx_buffer_index + 3],
+                                        frag_session_data[frag_index].frag_group_data.frag_size );
+                    // A full queue is drained in place, which may have ended the session with an answer
+                    ans_index = ctx->fragmentation_tx_payload_ans_size;
+#else
+                    int32_t process_status = FragDecoderProcess(
                         frag_counter, &fragmentation_package_rx_buffer[fragmentation_package_rx_buffer_index + 3] );
-                    frag_session_data[frag_index].frag_decoder_status = FragDecoderGetStatus( );
-                    SMTC_MODEM_HAL_TRACE_PRINTF(
-                        "\nFuota session info : \nCurrent fragment index = %d,\nCurrent fragment counter = %d,\nNumber "
-                        "of missed packets = %d,\n",
-                        frag_index, frag_session_data[frag_index].frag_decoder_status.FragNbRx,
-                        frag_session_data[frag_index].frag_decoder_status.FragNbLost );
-                }
-                if( frag_session_data[frag_index].frag_decoder_process_status >= FRAG_SESSION_FINISHED_SUCCESSFULLY )
-                {
-                    if( frag_session_data[frag_index].frag_decoder_process_status ==
-                        FRAG_SESSION_FINISHED_SUCCESSFULLY )
-                    {
-                        if( frag_session_data[frag_index].frag_group_data.control.ack_reception == 1 )
-                        {
-                            if( ( ans_index + FRAGMENTATION_DATA_BLOCK_RECEIVED_REQ_SIZE ) <= max_payload_size )
-                            {
-                                uint8_t status_tmp =
-                                    ( frag_index & 0x3 ) +
-                                    ( ( compute_data_block_integrity_ckeck( frag_index, ctx->stack_id ) << 2 ) & 0x4 );
-                                ctx->fragmentation_tx_payload_ans[ans_index++] = FRAGMENTATION_DATA_BLOCK_RECEIVED_REQ;
-                                ctx->fragmentation_tx_payload_ans[ans_index++] = status_tmp;
-                                nb_transmit_ans                                = 3;
-
-                                ctx->frag_index_data_block_rcv_req = frag_index;
-
-                                // Fetch the co-efficient value required to calculate delay of that respective session.
-                                ctx->fragmentation_ans_delay_s =
-                                    1 << ( frag_session_data[frag_index].frag_group_data.control.block_ack_delay + 4 );
-                            }
-                        }
-                        SMTC_MODEM_HAL_TRACE_PRINTF( " FILE RECONSTRUCTS SUCCESSFULLY !\n" );
-                    }
-                    else  // FRAG_SESSION_FAILED
-                    {
-                        SMTC_MODEM_HAL_TRACE_PRINTF( " FUOTA SESSION FAILED !\n" );
-                    }
-                    uint8_t status = ( frag_session_data[frag_index].frag_decoder_process_status < 255 )
-                                         ? frag_session_data[frag_index].frag_decoder_process_status
-                                         : 255;
-                    if( status == FRAG_SESSION_FINISHED_SUCCESSFULLY )
-                    {
-                        ctx->file_done_size = frag_session_data[frag_index].frag_group_data.frag_nb *
-                                                  frag_session_data[frag_index].frag_group_data.frag_size -
-                                              frag_session_data[frag_index].frag_group_data.padding;
-                    }
-                    increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE, status, stack_id );
+                    ans_index = frag_session_update( ctx, frag_index, process_status, ans_index, max_payload_size );
+#endif
                 }
             }
             // A message MAY carry more than one command, except for the DataFragment command,
@@ -948,15 +1048,278 @@ static frag_status_t fragmentation_package_parser( lorawan_fragmentation_package
     return FRAG_STATUS_OK;
 }
 
+/**
+ * @brief Store the status returned by the decoder for a session, and end the session once the file is rebuilt or lost
+ *
+ * @param [in] ctx              Service context of the stack that received the session
+ * @param [in] frag_index       Session index
+ * @param [in] process_status   Status returned by the decoder
+ * @param [in] ans_index        Next free byte of the answer payload
+ * @param [in] max_payload_size Maximum answer payload size
+ * @return uint8_t the next free byte of the answer payload
+ */
+static uint8_t frag_session_update( lorawan_fragmentation_package_ctx_t* ctx, uint8_t frag_index,
+                                    int32_t process_status, uint8_t ans_index, uint8_t max_payload_size )
+{
+    frag_session_data[frag_index].frag_decoder_process_status = process_status;
+    frag_session_data[frag_index].frag_decoder_status         = FragDecoderGetStatus( );
+    SMTC_MODEM_HAL_TRACE_PRINTF(
+        "\nFuota session info : \nCurrent fragment index = %d,\nCurrent fragment counter = %d,\nNumber "
+        "of missed packets = %d,\n",
+        frag_index, frag_session_data[frag_index].frag_decoder_status.FragNbRx,
+        frag_session_data[frag_index].frag_decoder_status.FragNbLost );
+
+    if( process_status < FRAG_SESSION_FINISHED_SUCCESSFULLY )
+    {
+        return ans_index;
+    }
+
+    // The application reads the file from the FUOTA area once the session is done
+    frag_staging_flush( );
+    if( process_status == FRAG_SESSION_FINISHED_SUCCESSFULLY )
+    {
+        if( frag_session_data[frag_index].frag_group_data.control.ack_reception == 1 )
+        {
+            if( ( ans_index + FRAGMENTATION_DATA_BLOCK_RECEIVED_REQ_SIZE ) <= max_payload_size )
+            {
+                uint8_t status_tmp = ( frag_index & 0x3 ) +
+                                     ( ( compute_data_block_integrity_ckeck( frag_index, ctx->stack_id ) << 2 ) & 0x4 );
+                ctx->fragmentation_tx_payload_ans[ans_index++] = FRAGMENTATION_DATA_BLOCK_RECEIVED_REQ;
+                ctx->fragmentation_tx_payload_ans[ans_index++] = status_tmp;
+                nb_transmit_ans                                = 3;
+
+                ctx->frag_index_data_block_rcv_req = frag_index;
+
+                // Fetch the co-efficient value required to calculate delay of that respective session.
+                ctx->fragmentation_ans_delay_s =
+                    1 << ( frag_session_data[frag_index].frag_group_data.control.block_ack_delay + 4 );
+            }
+        }
+        SMTC_MODEM_HAL_TRACE_PRINTF( " FILE RECONSTRUCTS SUCCESSFULLY !\n" );
+    }
+    else  // FRAG_SESSION_FAILED
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( " FUOTA SESSION FAILED !\n" );
+    }
+    uint8_t status = ( process_status < 255 ) ? process_status : 255;
+    if( status == FRAG_SESSION_FINISHED_SUCCESSFULLY )
+    {
+        ctx->file_done_size = frag_session_data[frag_index].frag_group_data.frag_nb *
+                                  frag_session_data[frag_index].frag_group_data.frag_size -
+                              frag_session_data[frag_index].frag_group_data.padding;
+    }
+    increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE, status, ctx->stack_id );
+    return ans_index;
+}
+
+#if defined( FRAG_DECODER_DEFERRED )
+static void frag_deferred_reset( void )
+{
+    frag_deferred.first            = 0;
+    frag_deferred.count            = 0;
+    frag_deferred.solving_index    = FRAGMENTATION_DEFERRED_NO_SESSION;
+    frag_deferred.solving_stack_id = 0;
+}
+
+static void frag_deferred_push( uint8_t stack_id, uint8_t frag_index, uint16_t frag_counter, const uint8_t* data,
+                                uint8_t size )
+{
+    // The idle slices did not keep up: the oldest work is done now rather than losing a fragment
+    while( frag_deferred.count == FRAGMENTATION_DEFERRED_QUEUE_LENGTH )
+    {
+        frag_deferred_step( );
+    }
+
+    frag_deferred_fragment_t* fragment =
+        &frag_deferred.fifo[( frag_deferred.first + frag_deferred.count ) % FRAGMENTATION_DEFERRED_QUEUE_LENGTH];
+    fragment->stack_id     = stack_id;
+    fragment->frag_index   = frag_index;
+    fragment->frag_counter = frag_counter;
+    memcpy( fragment->data, data, size );
+    frag_deferred.count++;
+}
+
+/**
+ * @brief Run one row of the pending back substitution, or else decode the oldest queued fragment
+ *
+ * @return true if some work was done
+ */
+static bool frag_deferred_step( void )
+{
+    uint8_t stack_id;
+    uint8_t frag_index;
+    int32_t process_status;
+
+    if( frag_deferred.solving_index != FRAGMENTATION_DEFERRED_NO_SESSION )
+    {
+        stack_id       = frag_deferred.solving_stack_id;
+        frag_index     = frag_deferred.solving_index;
+        process_status = FragDecoderSolve( 1 );
+    }
+    else if( frag_deferred.count > 0 )
+    {
+        frag_deferred_fragment_t* fragment = &frag_deferred.fifo[frag_deferred.first];
+        frag_deferred.first = ( frag_deferred.first + 1 ) % FRAGMENTATION_DEFERRED_QUEUE_LENGTH;
+        frag_deferred.count--;
+
+        stack_id   = fragment->stack_id;
+        frag_index = fragment->frag_index;
+        if( ( frag_session_data[frag_index].frag_group_data.is_active == false ) ||
+            ( frag_session_data[frag_index].frag_decoder_process_status != FRAG_SESSION_ONGOING ) )
+        {
+            // Session deleted or file already rebuilt since the fragment was queued
+            return true;
+        }
+        // The slot is not reused before the next push, which cannot happen while the fragment is decoded
+        process_status = FragDecoderProcess( fragment->frag_counter, fragment->data );
+    }
+    else
+    {
+        return false;
+    }
+
+    frag_deferred.solving_index =
+        ( process_status == FRAG_SESSION_SOLVING ) ? frag_index : FRAGMENTATION_DEFERRED_NO_SESSION;
+    frag_deferred.solving_stack_id = stack_id;
+
+    uint8_t                              service_id;
+    lorawan_fragmentation_package_ctx_t* ctx =
+        lorawan_fragmentation_package_get_ctx_from_stack_id( stack_id, &service_id );
+    if( ctx == NULL )
+    {
+        return true;
+    }
+
+    // Same answer handling as a downlink parsing, an answer still waiting for its uplink is kept
+    if( ( nb_transmit_ans <= 1 ) && ( ctx->is_pending_task == false ) )
+    {
+        ctx->fragmentation_tx_payload_ans_size = 0;
+        ctx->fragmentation_ans_delay_s         = 0;
+    }
+    uint8_t max_payload_size = MIN( lorawan_api_next_max_payload_length_get( stack_id ), FRAG_SIZE_ANS_MAX );
+    uint8_t ans_index        = frag_session_update( ctx, frag_index, process_status,
+                                                    ctx->fragmentation_tx_payload_ans_size, max_payload_size );
+    if( ans_index > ctx->fragmentation_tx_payload_ans_size )
+    {
+        ctx->fragmentation_tx_payload_ans_size = ans_index;
+        lorawan_fragmentation_add_task( service_id );
+    }
+    return true;
+}
+#endif  // FRAG_DECODER_DEFERRED
+
+static void frag_staging_reset( void )
+{
+    for( uint8_t i = 0; i < FRAGMENTATION_STAGING_WINDOW_NB; i++ )
+    {
+        frag_staging[i].window      = FRAGMENTATION_STAGING_NO_WINDOW;
+        frag_staging[i].dirty_start = 0;
+        frag_staging[i].dirty_end   = 0;
+    }
+}
+
+static void frag_staging_flush_window( frag_staging_t* staging )
+{
+    if( staging->dirty_end > staging->dirty_start )
+    {
+        smtc_modem_hal_context_store( CONTEXT_FUOTA, staging->window + staging->dirty_start,
+                                      &staging->buffer[staging->dirty_start],
+                                      staging->dirty_end - staging->dirty_start );
+    }
+    staging->dirty_start = 0;
+    staging->dirty_end   = 0;
+}
+
+static void frag_staging_flush( void )
+{
+    for( uint8_t i = 0; i < FRAGMENTATION_STAGING_WINDOW_NB; i++ )
+    {
+        frag_staging_flush_window( &frag_staging[i] );
+    }
+}
+
+static frag_staging_t* frag_staging_get( uint32_t window )
+{
+#if( FRAGMENTATION_STAGING_WINDOW_NB > 1 )
+    // Each window maps to a single staging buffer, the one overlapping the end of the file goes with the matrix
+    if( ( window + FRAGMENTATION_STAGING_WINDOW_SIZE ) > FragDecoderGetMaxFileSize( ) )
+    {
+        return &frag_staging[1];
+    }
+#endif
+    return &frag_staging[0];
+}
+
+static void frag_staging_load( frag_staging_t* staging, uint32_t window )
+{
+    frag_staging_flush_window( staging );
+
+    // The last window of the FUOTA area may be shorter than the staging buffer
+    uint32_t size = MIN( FRAGMENTATION_STAGING_WINDOW_SIZE, FragDecoderGetMaxStorageSize( ) - window );
+    smtc_modem_hal_context_restore( CONTEXT_FUOTA, window, staging->buffer, size );
+    staging->window = window;
+}
+
 static int8_t frag_decoder_write( uint32_t addr, uint8_t* data, uint32_t size )
 {
-    smtc_modem_hal_context_store( CONTEXT_FUOTA, addr, data, size );
+    // Rows are staged in RAM and programmed one window at a time instead of once per fragment
+    while( size > 0 )
+    {
+        uint32_t        window  = addr - ( addr % FRAGMENTATION_STAGING_WINDOW_SIZE );
+        uint32_t        offset  = addr - window;
+        uint32_t        length  = MIN( size, FRAGMENTATION_STAGING_WINDOW_SIZE - offset );
+        frag_staging_t* staging = frag_staging_get( window );
+
+        if( window != staging->window )
+        {
+            frag_staging_load( staging, window );
+        }
+        memcpy( &staging->buffer[offset], data, length );
+
+        if( staging->dirty_end == staging->dirty_start )
+        {
+            staging->dirty_start = offset;
+            staging->dirty_end   = offset + length;
+        }
+        else
+        {
+            staging->dirty_start = MIN( staging->dirty_start, offset );
+            if( ( offset + length ) > staging->dirty_end )
+            {
+                staging->dirty_end = offset + length;
+            }
+        }
+
+        addr += length;
+        data += length;
+        size -= length;
+    }
     return 0;
 }
 
 static int8_t frag_decoder_read( uint32_t addr, uint8_t* data, uint32_t size )
 {
-    smtc_modem_hal_context_restore( CONTEXT_FUOTA, addr, data, size );
+    while( size > 0 )
+    {
+        uint32_t        window  = addr - ( addr % FRAGMENTATION_STAGING_WINDOW_SIZE );
+        uint32_t        offset  = addr - window;
+        uint32_t        length  = MIN( size, FRAGMENTATION_STAGING_WINDOW_SIZE - offset );
+        frag_staging_t* staging = frag_staging_get( window );
+
+        // The loaded window holds the whole window content, written or not
+        if( window == staging->window )
+        {
+            memcpy( data, &staging->buffer[offset], length );
+        }
+        else
+        {
+            smtc_modem_hal_context_restore( CONTEXT_FUOTA, addr, data, length );
+        }
+
+        addr += length;
+        data += length;
+        size -= length;
+    }
     return 0;
 }
 
@@ -1013,16 +1376,27 @@ static uint8_t compute_data_block_integrity_ckeck( uint8_t frag_index, uint8_t s
     // Compute received data block MIC
     AES_CMAC_CTX aes_cmac_ctx;
     uint8_t      cmac[16];
-    uint8_t      d = 0;
+    uint8_t      chunk[FRAGMENTATION_INTEGRITY_READ_CHUNK_SIZE];
 
     AES_CMAC_Init( &aes_cmac_ctx );
     AES_CMAC_SetKey( &aes_cmac_ctx, key );
     AES_CMAC_Update( &aes_cmac_ctx, b0, 16 );
 
-    for( uint32_t i = 0; i < size; i++ )
+#if defined( FUOTA_MAPPED_AREA )
+    // The FUOTA area is readable in place, the staged rows only have to reach it first
+    const uint8_t* mapped_file = smtc_modem_hal_get_fuota_area_mapped_address( );
+    if( mapped_file != NULL )
+    {
+        frag_staging_flush( );
+        AES_CMAC_Update( &aes_cmac_ctx, mapped_file, size );
+        size = 0;
+    }
+#endif  // FUOTA_MAPPED_AREA
+    for( uint32_t i = 0; i < size; i += sizeof( chunk ) )
     {
-        frag_decoder_read( i, &d, 1 );
-        AES_CMAC_Update( &aes_cmac_ctx, &d, 1 );
+        uint32_t length = MIN( sizeof( chunk ), size - i );
+        frag_decoder_read( i, chunk, length );
+        AES_CMAC_Update( &aes_cmac_ctx, chunk, length );
     }
     AES_CMAC_Final( cmac, &aes_cmac_ctx );
     uint32_t computed_mic = ( uint32_t ) ( ( uint32_t ) cmac[3] << 24 | ( uint32_t ) cmac[2] << 16 |
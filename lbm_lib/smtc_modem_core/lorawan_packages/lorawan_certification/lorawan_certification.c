@@ -572,6 +572,7 @@ static lorawan_certification_requested_tx_type_t lorawan_certification_parser(
         if( rx_buffer_length == LORAWAN_CERTIFICATION_DUT_RESET_REQ_SIZE )
         {
             SMTC_MODEM_HAL_TRACE_PRINTF( "Certif mcu reset\n" );
+            modem_context_flush( );
             smtc_modem_hal_reset_mcu( );
         }
         else
@@ -917,6 +918,7 @@ static lorawan_certification_requested_tx_type_t lorawan_certification_parser(
         {
             lorawan_certification->enabled = false;
             lorawan_api_modem_certification_set( false, lorawan_certification->stack_id );
+            modem_context_flush( );
             smtc_modem_hal_reset_mcu( );
         }
         else
@@ -142,6 +142,15 @@
 #define MPA_FRAG_HDR_SIZE ( 2 )     // CommandID + BaseByte
 #define MPA_TOKEN_SIZE ( 1 )
 
+#if defined( ENABLE_FUOTA_MPA_COALESCE )
+/**
+ * @brief Time the answers wait for the answers of the next downlinks to share the same uplink
+ */
+#ifndef MPA_ANS_COALESCE_WINDOW_S
+#define MPA_ANS_COALESCE_WINDOW_S ( 5 )
+#endif
+#endif  // ENABLE_FUOTA_MPA_COALESCE
+
 static const uint8_t mpa_req_cmd_size[3] = { MPA_PKG_VERSION_REQ_SIZE, MPA_DEV_PACKAGE_REQ_SIZE,
                                              MPA_MULTI_PACK_BUFFER_REQ_SIZE };
 /*
@@ -203,6 +212,9 @@ typedef struct lorawan_mpa_package_s
     uint8_t                            start_byte_pending;
     uint8_t                            stop_byte_pending;
     uint8_t                            nb_cmd_parsed;
+#if defined( ENABLE_FUOTA_MPA_COALESCE )
+    uint32_t ans_deadline_s;  //!< RTC time the coalesced answers are sent
+#endif
 } lorawan_mpa_package_ctx_t;
 
 /* -----------------------------------------------------------------------------
@@ -355,6 +367,8 @@ void lorawan_mpa_package_services_init( uint8_t* service_id, uint8_t task_id,
     *on_update_callback = lorawan_mpa_package_service_on_update;
     *context_callback   = ( void* ) ctx;
 
+    modem_set_downlink_service_port( lorawan_mpa_package_service_downlink_handler, MPA_PORT );
+
     ctx->task_id   = task_id;
     ctx->stack_id  = CURRENT_STACK;
     ctx->enabled   = true;
@@ -486,13 +500,28 @@ uint8_t lorawan_mpa_package_service_downlink_handler( lr1_stack_mac_down_data_t*
                                      MPA_PORT );
         uint8_t      event_status;
         bool         increment_event;
-        mpa_status_t mpa_status = mpa_package_parser(
+        bool         ans_pending = ( ( ctx->mpa_task_ctx_mask & ANS_CMD_TASK_MASK ) == ANS_CMD_TASK_MASK );
+        mpa_status_t mpa_status  = mpa_package_parser(
             ctx, rx_down_data->rx_payload, rx_down_data->rx_payload_size, rx_down_data->rx_metadata.rx_window, stack_id,
             rx_down_data->rx_metadata.timestamp_ms, &event_status, &increment_event );
         // check if answer have to been transmit
         if( ( mpa_status == MPA_STATUS_OK ) && ( ctx->mpa_task_ctx_mask != EMPTY_TASK_MASK ) )
         {
-            mpa_add_task( ctx, smtc_modem_hal_get_time_in_s( ) );
+            uint32_t rtc_target_s = smtc_modem_hal_get_time_in_s( );
+#if defined( ENABLE_FUOTA_MPA_COALESCE )
+            // Give the next downlinks a chance to add their answers, the window is opened by the first one only
+            if( ctx->mpa_multi_pack_buffer_req_status == MPA_MULTI_PACK_BUFFER_REQ_NOT_RCV )
+            {
+                if( ans_pending == false )
+                {
+                    ctx->ans_deadline_s = rtc_target_s + MPA_ANS_COALESCE_WINDOW_S;
+                }
+                rtc_target_s = ctx->ans_deadline_s;
+            }
+#else
+            ( void ) ans_pending;
+#endif
+            mpa_add_task( ctx, rtc_target_s );
         }
 
         return MODEM_DOWNLINK_CONSUMED;
@@ -561,12 +590,29 @@ static mpa_status_t mpa_package_parser( lorawan_mpa_package_ctx_t* ctx, uint8_t*
 
     ctx->nb_cmd_parsed = 0;
 
+#if defined( ENABLE_FUOTA_MPA_COALESCE )
+    // Answers not sent yet are kept, the new ones are appended to leave in the same uplink
+    if( ( ( ctx->mpa_task_ctx_mask & ANS_CMD_TASK_MASK ) == ANS_CMD_TASK_MASK ) &&
+        ( mpa_multi_pack_buffer_req_status_bkp == MPA_MULTI_PACK_BUFFER_REQ_NOT_RCV ) &&
+        ( ctx->mpa_tx_payload_ans_size_cpy == ctx->mpa_tx_payload_ans_size ) )
+    {
+        ans_index = ctx->mpa_tx_payload_ans_size;
+    }
+#endif
+
     while( ( mpa_package_rx_buffer_length - MPA_TOKEN_SIZE ) > mpa_package_rx_buffer_index )
     {
         if( ( mpa_package_rx_buffer[mpa_package_rx_buffer_index] & 0x80 ) == 0x0 )
         {
             // case first byte is cmd_id and pkt_id = 0 or multiple cmd_id below the same pkt_id
             pkg_id_tmp = pkg_id_tmp_previous;
+#if defined( ENABLE_FUOTA_MPA_COALESCE )
+            if( ( mpa_package_rx_buffer_index == 0 ) && ( ans_index > 0 ) )
+            {
+                // The appended answers may follow the answers of another package, add the implicit package ID
+                ctx->mpa_tx_payload_ans[ans_index++] = pkg_id_tmp | 0x80;
+            }
+#endif
         }
         else
         {
@@ -163,7 +163,12 @@ static const uint8_t multicast_setup_req_cmd_size[6] = { REMOTE_MULTICAST_SETUP_
                                                          REMOTE_MULTICAST_SETUP_MC_GROUP_CLASS_C_SESSION_REQ_SIZE,
                                                          REMOTE_MULTICAST_SETUP_MC_GROUP_CLASS_B_SESSION_REQ_SIZE };
 
+// McGroupIDHeader is 2 bits wide, groups above #3 are only managed by the application
+#if ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
+#define NB_MULTICAST_GROUPS ( 4 )
+#else
 #define NB_MULTICAST_GROUPS ( LR1MAC_MC_NUMBER_OF_SESSION )
+#endif
 
 typedef enum
 {
@@ -349,6 +354,9 @@ void lorawan_remote_multicast_setup_package_services_init(
     *on_update_callback = lorawan_remote_multicast_setup_package_service_on_update;
     *context_callback   = ( void* ) ctx;
 
+    modem_set_downlink_service_port( lorawan_remote_multicast_setup_package_service_downlink_handler,
+                                     REMOTE_MULTICAST_SETUP_PORT );
+
     ctx->task_id           = task_id;
     ctx->stack_id          = CURRENT_STACK;
     ctx->enabled           = true;
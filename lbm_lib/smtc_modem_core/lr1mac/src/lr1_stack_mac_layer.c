@@ -42,6 +42,8 @@
 #include "lr1_stack_mac_layer.h"
 
 #include "smtc_modem_hal_dbg_trace.h"
+#include "smtc_modem_dbg_profile.h"
+#include "modem_perf_counters.h"
 #include "smtc_real.h"
 #include "lr1mac_utilities.h"
 #include "radio_planner.h"
@@ -71,6 +73,15 @@
  */
 #define real_const lr1_mac->real->real_const
 
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+/**
+ * @brief Time allowed in addition to the sync word reception after the preamble detection of a FSK window
+ */
+#ifndef LR1MAC_FSK_RX_SYNC_TIMEOUT_MARGIN_MS
+#define LR1MAC_FSK_RX_SYNC_TIMEOUT_MARGIN_MS ( 2 )
+#endif
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -112,6 +123,14 @@ static status_lorawan_t device_time_ans_parser( lr1_stack_mac_t* lr1_mac );
 static void             beacon_freq_req_parser( lr1_stack_mac_t* lr1_mac );
 static void             ping_slot_channel_req_parser( lr1_stack_mac_t* lr1_mac );
 static status_lorawan_t ping_slot_info_ans_parser( lr1_stack_mac_t* lr1_mac );
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+static uint32_t lr1_stack_mac_fsk_sync_time_ms( const ralf_params_gfsk_t* gfsk );
+#endif
+#if defined( ADD_RX_DRIFT )
+static void lr1_stack_mac_rx_drift_measure( lr1_stack_mac_t* lr1_mac, uint8_t hook_id, uint32_t rx_done_ms );
+static void lr1_stack_mac_rx_drift_narrow_window( lr1_stack_mac_t* lr1_mac, const rx_win_type_t type,
+                                                  uint32_t delay_ms );
+#endif
 
 /*
  *-----------------------------------------------------------------------------------
@@ -130,6 +149,7 @@ void lr1_stack_mac_init( lr1_stack_mac_t* lr1_mac, lr1mac_activation_mode_t acti
     lr1_mac->is_lorawan_modem_certification_enabled   = false;
     lr1_mac->isr_tx_done_radio_timestamp              = 0;
     lr1_mac->dev_nonce                                = 0;
+    lr1_mac->nvm_context_save_pending                 = false;
     lr1_mac->adr_mode_select                          = STATIC_ADR_MODE;
     lr1_mac->adr_mode_select_tmp                      = STATIC_ADR_MODE;
     lr1_mac->current_win                              = RX1;
@@ -140,6 +160,14 @@ void lr1_stack_mac_init( lr1_stack_mac_t* lr1_mac, lr1mac_activation_mode_t acti
     lr1_mac->timestamp_tx_done_device_time_req_ms_tmp = 0;
     memset( lr1_mac->fine_tune_board_setting_delay_ms, 0, sizeof( lr1_mac->fine_tune_board_setting_delay_ms ) );
     memset( lr1_mac->join_nonce, 0xFF, sizeof( lr1_mac->join_nonce ) );
+#if defined( ADD_LINK_ADR )
+    smtc_link_adr_init( &lr1_mac->link_adr );
+    lr1_mac->bulk_dr_in_use = false;
+#endif
+#if defined( ADD_RX_DRIFT )
+    lr1_mac->rx_drift_offset_valid = false;
+    lr1_mac->rx_drift_saved_ms     = 0;
+#endif
 
     lr1_stack_mac_session_init( lr1_mac );
 }
@@ -157,6 +185,7 @@ void lr1_stack_mac_session_init( lr1_stack_mac_t* lr1_mac )
     lr1_mac->tx_fopts_length                     = 0;
     lr1_mac->tx_fopts_lengthsticky               = 0;
     lr1_mac->nwk_ans_size                        = 0;
+    lr1_mac->nwk_payload                         = NULL;
     lr1_mac->nwk_payload_size                    = 0;
     lr1_mac->nwk_payload_index                   = 0;
     lr1_mac->max_duty_cycle_index                = 0;
@@ -170,6 +199,15 @@ void lr1_stack_mac_session_init( lr1_stack_mac_t* lr1_mac )
     lr1_mac->link_check_gw_cnt                   = 0;
     lr1_mac->rx_down_data.rx_metadata.tx_ack_bit = 0;
     lr1_mac->tx_class_b_bit                      = 0;
+#if defined( ADD_LINK_ADR )
+    smtc_link_adr_reset( &lr1_mac->link_adr );
+#endif
+#if defined( ADD_RX_DRIFT )
+    smtc_rx_drift_reset( &lr1_mac->rx_drift );
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+    smtc_rx_boost_reset( &lr1_mac->rx_boost );
+#endif
 }
 
 void lr1_stack_mac_region_init( lr1_stack_mac_t* lr1_mac, smtc_real_region_types_t region_type )
@@ -224,6 +262,7 @@ void lr1_stack_mac_tx_frame_build( lr1_stack_mac_t* lr1_mac )
 
 void lr1_stack_mac_tx_frame_encrypt( lr1_stack_mac_t* lr1_mac )
 {
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_CRYPTO_UPLINK );
     uint8_t tx_fopts_length = 0;
     if( lr1_mac->tx_fport != PORTNWK )
     {
@@ -236,22 +275,16 @@ void lr1_stack_mac_tx_frame_encrypt( lr1_stack_mac_t* lr1_mac )
         enc_key = SMTC_SE_NWK_S_ENC_KEY;
     }
 #endif
-    if( smtc_modem_crypto_payload_encrypt(
-            &lr1_mac->tx_payload[FHDROFFSET + lr1_mac->tx_fport_present + tx_fopts_length], lr1_mac->app_payload_size,
-            enc_key, lr1_mac->dev_addr, UP_LINK, lr1_mac->fcnt_up,
-            &lr1_mac->tx_payload[FHDROFFSET + lr1_mac->tx_fport_present + tx_fopts_length],
+    // Payload encryption and mic in one secure element access
+    if( smtc_modem_crypto_payload_encrypt_and_add_mic(
+            &lr1_mac->tx_payload[0], lr1_mac->tx_payload_size, FHDROFFSET + lr1_mac->tx_fport_present + tx_fopts_length,
+            lr1_mac->app_payload_size, enc_key, SMTC_SE_NWK_S_ENC_KEY, lr1_mac->dev_addr, UP_LINK, lr1_mac->fcnt_up,
             lr1_mac->stack_id ) != SMTC_MODEM_CRYPTO_RC_SUCCESS )
     {
-        SMTC_MODEM_HAL_PANIC( "Crypto error during payload encryption\n" );
-    }
-
-    if( smtc_modem_crypto_compute_and_add_mic( &lr1_mac->tx_payload[0], lr1_mac->tx_payload_size, SMTC_SE_NWK_S_ENC_KEY,
-                                               lr1_mac->dev_addr, UP_LINK, lr1_mac->fcnt_up,
-                                               lr1_mac->stack_id ) != SMTC_MODEM_CRYPTO_RC_SUCCESS )
-    {
-        SMTC_MODEM_HAL_PANIC( "Crypto error during mic computation\n" );
+        SMTC_MODEM_HAL_PANIC( "Crypto error during payload encryption and mic computation\n" );
     }
     lr1_mac->tx_payload_size = lr1_mac->tx_payload_size + 4;
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_CRYPTO_UPLINK );
 }
 
 void lr1_stack_mac_tx_lora_launch_callback_for_rp( void* rp_void )
@@ -263,16 +296,18 @@ void lr1_stack_mac_tx_lora_launch_callback_for_rp( void* rp_void )
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_TX_DONE ) == RAL_STATUS_OK );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE(
         ral_set_pkt_payload( &( rp->radio->ral ), rp->payload[id], rp->payload_buffer_size[id] ) == RAL_STATUS_OK );
+#if defined( ADD_RP_TIMED_TX )
+    // The radio is ready, the Tx command is sent by the radio trigger timer at the exact expected time
+    rp_task_start_tx_at_start_time( rp, id );
+#else
     // Wait the exact expected time (ie target - tcxo startup delay)
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
-    {
-        // Do nothing
-    }
+    rp_task_wait_start_time( rp, id );
     // At this time only tcxo startup delay is remaining
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( true );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_tx( &( rp->radio->ral ) ) == RAL_STATUS_OK );
     rp_stats_set_tx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+#endif
 }
 
 void lr1_stack_mac_tx_gfsk_launch_callback_for_rp( void* rp_void )
@@ -284,15 +319,18 @@ void lr1_stack_mac_tx_gfsk_launch_callback_for_rp( void* rp_void )
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_TX_DONE ) == RAL_STATUS_OK );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE(
         ral_set_pkt_payload( &( rp->radio->ral ), rp->payload[id], rp->payload_buffer_size[id] ) == RAL_STATUS_OK );
+#if defined( ADD_RP_TIMED_TX )
+    // The radio is ready, the Tx command is sent by the radio trigger timer at the exact expected time
+    rp_task_start_tx_at_start_time( rp, id );
+#else
     // Wait the exact expected time (ie target - tcxo startup delay)
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
-    {
-    }
+    rp_task_wait_start_time( rp, id );
     // At this time only tcxo startup delay is remaining
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( true );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_tx( &( rp->radio->ral ) ) == RAL_STATUS_OK );
     rp_stats_set_tx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+#endif
 }
 
 void lr1_stack_mac_tx_lr_fhss_launch_callback_for_rp( void* rp_void )
@@ -313,16 +351,18 @@ void lr1_stack_mac_tx_lr_fhss_launch_callback_for_rp( void* rp_void )
                                  ( ral_lr_fhss_memory_state_t ) rp->radio_params[id].lr_fhss_state,
                                  rp->radio_params[id].tx.lr_fhss.hop_sequence_id, rp->payload[id],
                                  rp->payload_buffer_size[id] ) == RAL_STATUS_OK );
+#if defined( ADD_RP_TIMED_TX )
+    // The radio is ready, the Tx command is sent by the radio trigger timer at the exact expected time
+    rp_task_start_tx_at_start_time( rp, id );
+#else
     // Wait the exact expected time (ie target - tcxo startup delay)
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
-    {
-        // Do nothing
-    }
+    rp_task_wait_start_time( rp, id );
     // At this time only tcxo startup delay is remaining
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( true );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_tx( &( rp->radio->ral ) ) == RAL_STATUS_OK );
     rp_stats_set_tx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+#endif
 }
 
 void lr1_stack_mac_rx_lora_launch_callback_for_rp( void* rp_void )
@@ -331,13 +371,14 @@ void lr1_stack_mac_rx_lora_launch_callback_for_rp( void* rp_void )
     uint8_t          id = rp->radio_task_id;
 
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_lora( rp->radio, &rp->radio_params[id].rx.lora ) == RAL_STATUS_OK );
+#if defined( ADD_RX_BOOST_POLICY )
+    lr1_stack_mac_rx_boost_apply( rp );
+#endif
     SMTC_MODEM_HAL_PANIC_ON_FAILURE(
         ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_HDR_ERROR |
                                                          RAL_IRQ_RX_CRC_ERROR ) == RAL_STATUS_OK );
     // Wait the exact expected time (ie target - tcxo startup delay)
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
-    {
-    }
+    rp_task_wait_start_time( rp, id );
     // At this time only tcxo startup delay is remaining
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( false );
@@ -352,18 +393,37 @@ void lr1_stack_mac_rx_gfsk_launch_callback_for_rp( void* rp_void )
     uint8_t          id = rp->radio_task_id;
 
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_gfsk( rp->radio, &rp->radio_params[id].rx.gfsk ) == RAL_STATUS_OK );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
-        ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_CRC_ERROR ) ==
-        RAL_STATUS_OK );
-    // Wait the exact expected time (ie target - tcxo startup delay)
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
+#if defined( ADD_RX_BOOST_POLICY )
+    lr1_stack_mac_rx_boost_apply( rp );
+#endif
+    ral_irq_t rx_irq     = RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_CRC_ERROR;
+    uint32_t  timeout_ms = rp->radio_params[id].rx.timeout_in_ms;
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    if( rp->radio_params[id].rx.sync_timeout_in_ms != 0 )
     {
+        if( ral_stop_timer_on_preamble( &( rp->radio->ral ), true ) == RAL_STATUS_OK )
+        {
+            // The window only has to last until the preamble detection, the radio planner closes it if the sync word
+            // does not follow
+            uint32_t sync_time_ms = lr1_stack_mac_fsk_sync_time_ms( &rp->radio_params[id].rx.gfsk );
+
+            rx_irq |= RAL_IRQ_RX_PREAMBLE_DETECTED | RAL_IRQ_RX_HDR_OK;
+            timeout_ms = ( timeout_ms > ( MIN_RX_WINDOW_DURATION_MS + sync_time_ms ) ) ? ( timeout_ms - sync_time_ms )
+                                                                                       : MIN_RX_WINDOW_DURATION_MS;
+        }
+        else
+        {
+            rp->radio_params[id].rx.sync_timeout_in_ms = 0;
+        }
     }
+#endif
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_dio_irq_params( &( rp->radio->ral ), rx_irq ) == RAL_STATUS_OK );
+    // Wait the exact expected time (ie target - tcxo startup delay)
+    rp_task_wait_start_time( rp, id );
     // At this time only tcxo startup delay is remaining
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( false );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rx( &( rp->radio->ral ), rp->radio_params[id].rx.timeout_in_ms ) ==
-                                     RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rx( &( rp->radio->ral ), timeout_ms ) == RAL_STATUS_OK );
     rp_stats_set_rx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
 }
 
@@ -609,12 +669,20 @@ void lr1_stack_mac_rx_radio_start( lr1_stack_mac_t* lr1_mac, const rx_win_type_t
         radio_params.pkt_type         = RAL_PKT_TYPE_GFSK;
         radio_params.rx.gfsk          = gfsk_param;
         radio_params.rx.timeout_in_ms = lr1_mac->rx_timeout_symb_in_ms;
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+        radio_params.rx.sync_timeout_in_ms =
+            lr1_stack_mac_fsk_sync_time_ms( &gfsk_param ) + LR1MAC_FSK_RX_SYNC_TIMEOUT_MARGIN_MS;
+#endif
     }
     else
     {
         SMTC_MODEM_HAL_PANIC( "MODULATION NOT SUPPORTED\n" );
     }
 
+#if defined( ADD_RX_BOOST_POLICY )
+    radio_params.rx.rx_boosted = lr1_stack_mac_rx_boost_is_needed( lr1_mac );
+#endif
+
     uint8_t my_hook_id;
     if( rp_hook_get_id( lr1_mac->rp, lr1_mac, &my_hook_id ) != RP_HOOK_STATUS_OK )
     {
@@ -661,6 +729,7 @@ void lr1_stack_mac_rx_radio_start( lr1_stack_mac_t* lr1_mac, const rx_win_type_t
 
 void lr1_stack_mac_rp_callback( lr1_stack_mac_t* lr1_mac )
 {
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_MAC_RADIO_CALLBACK );
     uint32_t tcurrent_ms;
     uint8_t  my_hook_id;
     rp_hook_get_id( lr1_mac->rp, lr1_mac, &my_hook_id );
@@ -695,6 +764,9 @@ void lr1_stack_mac_rp_callback( lr1_stack_mac_t* lr1_mac )
         }
 
         lr1_mac->rx_down_data.rx_payload_size = ( uint8_t ) lr1_mac->rp->rx_payload_size[my_hook_id];
+#if defined( ADD_RX_DRIFT )
+        lr1_stack_mac_rx_drift_measure( lr1_mac, my_hook_id, tcurrent_ms );
+#endif
 
         SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG(
             "payload size receive = %u, snr = %d , rssi = %d\n", lr1_mac->rx_down_data.rx_payload_size,
@@ -714,6 +786,9 @@ void lr1_stack_mac_rp_callback( lr1_stack_mac_t* lr1_mac )
 
     case RP_STATUS_RX_TIMEOUT:
     {
+#if defined( ADD_RX_DRIFT )
+        rp_stats_add_rx_window_saving( &lr1_mac->rp->stats, my_hook_id, lr1_mac->rx_drift_saved_ms );
+#endif
 #ifndef BSP_LR1MAC_DISABLE_FINE_TUNE
         uint32_t rx_timestamp_calibration = tcurrent_ms;
         uint32_t rx_delay_ms              = 0;
@@ -793,6 +868,7 @@ void lr1_stack_mac_rp_callback( lr1_stack_mac_t* lr1_mac )
     {
         lr1_mac->radio_process_state = RADIOSTATE_ABORTED_BY_RP;
     }
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_MAC_RADIO_CALLBACK );
 }
 
 bool lr1_stack_mac_rx_timer_configure( lr1_stack_mac_t* lr1_mac, const rx_win_type_t type )
@@ -863,13 +939,16 @@ bool lr1_stack_mac_rx_timer_configure( lr1_stack_mac_t* lr1_mac, const rx_win_ty
         }
         smtc_real_get_rx_window_parameters( lr1_mac->real, lr1_mac->rx_data_rate, delay_ms, &lr1_mac->rx_window_symb,
                                             &lr1_mac->rx_timeout_symb_in_ms, &lr1_mac->rx_timeout_ms, 0,
-                                            crystal_error );
+                                            crystal_error, MIN_RX_WINDOW_DURATION_MS );
 
 #else
 
         smtc_real_get_rx_window_parameters( lr1_mac->real, lr1_mac->rx_data_rate, delay_ms, &lr1_mac->rx_window_symb,
                                             &lr1_mac->rx_timeout_symb_in_ms, &lr1_mac->rx_timeout_ms, 0,
-                                            lr1_mac->crystal_error );
+                                            lr1_mac->crystal_error, MIN_RX_WINDOW_DURATION_MS );
+#endif
+#if defined( ADD_RX_DRIFT )
+        lr1_stack_mac_rx_drift_narrow_window( lr1_mac, type, delay_ms );
 #endif
         smtc_real_get_rx_start_time_offset_ms( lr1_mac->real, lr1_mac->rx_data_rate, board_delay_ms,
                                                lr1_mac->rx_window_symb, &lr1_mac->rx_offset_ms );
@@ -955,6 +1034,18 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
             lr1_mac->rx_down_data.rx_payload, lr1_mac->rx_down_data.rx_payload_size, &( lr1_mac->rx_fopts_length ),
             &fcnt_dwn_tmp, lr1_mac->dev_addr, &( lr1_mac->rx_down_data.rx_metadata.rx_fport ),
             &( lr1_mac->rx_down_data.rx_metadata.rx_fport_present ), &( lr1_mac->rx_fctrl ), lr1_mac->rx_fopts );
+#if defined( ADD_DL_DEDUP )
+        // Drop the copies of an accepted frame before any crypto
+        if( status == OKLORAWAN )
+        {
+            memcpy( ( uint8_t* ) &mic_in,
+                    &lr1_mac->rx_down_data.rx_payload[lr1_mac->rx_down_data.rx_payload_size - MICSIZE], MICSIZE );
+            if( lr1mac_dl_dedup_is_duplicate( lr1_mac->dev_addr, fcnt_dwn_tmp, mic_in ) == true )
+            {
+                status = ERRORLORAWAN;
+            }
+        }
+#endif
         if( status == OKLORAWAN )
         {
             status = lr1mac_fcnt_dwn_accept( fcnt_dwn_tmp, &fcnt_dwn_stack_tmp );
@@ -965,16 +1056,25 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
             memcpy( ( uint8_t* ) &mic_in, &lr1_mac->rx_down_data.rx_payload[lr1_mac->rx_down_data.rx_payload_size],
                     MICSIZE );
 
-            if( smtc_modem_crypto_verify_mic( &lr1_mac->rx_down_data.rx_payload[0],
-                                              lr1_mac->rx_down_data.rx_payload_size, SMTC_SE_NWK_S_ENC_KEY,
-                                              lr1_mac->dev_addr, 1, fcnt_dwn_stack_tmp, mic_in,
-                                              lr1_mac->stack_id ) != SMTC_MODEM_CRYPTO_RC_SUCCESS )
+            // Streamed check: the MIC is computed in place on the received frame, no copy behind the B0 block
+            SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_CRYPTO_DOWNLINK );
+            if( ( smtc_modem_crypto_verify_mic_start( lr1_mac->rx_down_data.rx_payload_size, SMTC_SE_NWK_S_ENC_KEY,
+                                                      lr1_mac->dev_addr, 1, fcnt_dwn_stack_tmp,
+                                                      lr1_mac->stack_id ) != SMTC_MODEM_CRYPTO_RC_SUCCESS ) ||
+                ( smtc_modem_crypto_verify_mic_update( &lr1_mac->rx_down_data.rx_payload[0],
+                                                       lr1_mac->rx_down_data.rx_payload_size ) !=
+                  SMTC_MODEM_CRYPTO_RC_SUCCESS ) ||
+                ( smtc_modem_crypto_verify_mic_final( mic_in ) != SMTC_MODEM_CRYPTO_RC_SUCCESS ) )
             {
                 status = ERRORLORAWAN;
             }
+            SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_CRYPTO_DOWNLINK );
         }
         if( status == OKLORAWAN )
         {
+#if defined( ADD_DL_DEDUP )
+            lr1mac_dl_dedup_add( lr1_mac->dev_addr, fcnt_dwn_tmp, mic_in );
+#endif
             // reset retransmission counter if received on RX1 or RX2
             lr1_mac->nb_trans_cpt = 1;
 
@@ -1039,7 +1139,7 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
                         if( smtc_modem_crypto_payload_decrypt( &lr1_mac->rx_down_data.rx_payload[FHDROFFSET + 1],
                                                                lr1_mac->rx_down_data.rx_payload_size,
                                                                SMTC_SE_NWK_S_ENC_KEY, lr1_mac->dev_addr, 1,
-                                                               fcnt_dwn_stack_tmp, &lr1_mac->nwk_payload[0],
+                                                               fcnt_dwn_stack_tmp, &lr1_mac->rx_down_data.rx_payload[0],
                                                                lr1_mac->stack_id ) != SMTC_MODEM_CRYPTO_RC_SUCCESS )
                         {
                             SMTC_MODEM_HAL_PANIC( "Crypto error during payload decryption\n" );
@@ -1050,9 +1150,10 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
                         }
                         else
                         {
+                            // MAC commands are parsed straight from the payload decrypted in place
+                            lr1_mac->nwk_payload      = lr1_mac->rx_down_data.rx_payload;
                             lr1_mac->nwk_payload_size = lr1_mac->rx_down_data.rx_payload_size;
-                            memcpy( lr1_mac->rx_down_data.rx_payload, lr1_mac->nwk_payload, lr1_mac->nwk_payload_size );
-                            rx_packet_type = NWKRXPACKET;
+                            rx_packet_type            = NWKRXPACKET;
                         }
                     }
                     else
@@ -1077,7 +1178,7 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
 
                     if( lr1_mac->rx_fopts_length != 0 )
                     {
-                        memcpy( lr1_mac->nwk_payload, lr1_mac->rx_fopts, lr1_mac->rx_fopts_length );
+                        lr1_mac->nwk_payload      = lr1_mac->rx_fopts;
                         lr1_mac->nwk_payload_size = lr1_mac->rx_fopts_length;
                         rx_packet_type            = USERRX_FOPTSPACKET;
                     }
@@ -1094,7 +1195,7 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
                 // => notify the upper layer that the stack have received a payload : ack_bit is set to 1
                 if( lr1_mac->rx_fopts_length != 0 )
                 {
-                    memcpy( lr1_mac->nwk_payload, lr1_mac->rx_fopts, lr1_mac->rx_fopts_length );
+                    lr1_mac->nwk_payload      = lr1_mac->rx_fopts;
                     lr1_mac->nwk_payload_size = lr1_mac->rx_fopts_length;
                     rx_packet_type            = USERRX_FOPTSPACKET;
                 }
@@ -1119,6 +1220,27 @@ rx_packet_type_t lr1_stack_mac_rx_frame_decode( lr1_stack_mac_t* lr1_mac )
         lr1_mac->tx_fopts_current_length             = 0;  // reset the fopts of the sticky set in payload
         lr1_mac->tx_fopts_lengthsticky = 0;  // reset the fopts of the sticky cmd received on a valid frame
                                              // if received on RX1 or RX2
+
+#if defined( ADD_LINK_ADR )
+        if( smtc_real_get_modulation_type_from_datarate( lr1_mac->real, lr1_mac->rx_data_rate ) == LORA )
+        {
+            uint8_t            rx_sf;
+            lr1mac_bandwidth_t rx_bw;
+            smtc_real_lora_dr_to_sf_bw( lr1_mac->real, lr1_mac->rx_data_rate, &rx_sf, &rx_bw );
+            smtc_link_adr_add_downlink( &lr1_mac->link_adr, ( int8_t ) lr1_mac->rx_down_data.rx_metadata.rx_snr,
+                                        rx_bw );
+        }
+#endif
+#if defined( ADD_RX_DRIFT )
+        if( lr1_mac->rx_drift_offset_valid == true )
+        {
+            smtc_rx_drift_add_downlink( &lr1_mac->rx_drift, lr1_mac->rx_drift_offset_ms );
+            lr1_mac->rx_drift_offset_valid = false;
+        }
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+        lr1_stack_mac_rx_boost_add_downlink( lr1_mac, lr1_mac->rx_data_rate );
+#endif
     }
 
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " rx_packet_type = %d\n", rx_packet_type );
@@ -1197,6 +1319,36 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
         lr1_mac->join_status = NOT_JOINED;
     }
 
+#if defined( ADD_LINK_ADR )
+    if( ( lr1_mac->join_status == JOINED ) && ( lr1_mac->tx_mtype == CONF_DATA_UP ) )
+    {
+        smtc_link_adr_add_probe( &lr1_mac->link_adr, lr1_mac->rx_down_data.rx_metadata.rx_ack_bit );
+        if( lr1_mac->rx_down_data.rx_metadata.rx_ack_bit == false )
+        {
+            smtc_link_adr_missed_ack( &lr1_mac->link_adr );
+        }
+    }
+    else if( lr1_mac->link_check_user_req == USER_MAC_REQ_SENT )
+    {
+        // Still sent and not acked, the LinkCheckAns was not received
+        smtc_link_adr_add_probe( &lr1_mac->link_adr, false );
+    }
+#endif
+#if defined( ADD_RX_DRIFT )
+    if( ( lr1_mac->tx_mtype == CONF_DATA_UP ) && ( lr1_mac->rx_down_data.rx_metadata.rx_ack_bit == false ) )
+    {
+        // The windows may have been too narrow to catch the acknowledgement
+        smtc_rx_drift_reset( &lr1_mac->rx_drift );
+    }
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+    if( ( lr1_mac->tx_mtype == CONF_DATA_UP ) && ( lr1_mac->rx_down_data.rx_metadata.rx_ack_bit == false ) )
+    {
+        // The acknowledgement may have been below the sensitivity of the power saving gain
+        smtc_rx_boost_missed_downlink( &lr1_mac->rx_boost );
+    }
+#endif
+
     if( lr1_mac->adr_ack_cnt >= lr1_mac->adr_ack_limit )
     {
         lr1_mac->adr_ack_req = 1;
@@ -1206,6 +1358,7 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
         lr1_mac->adr_ack_req = 0;
     }
 
+    MODEM_PERF_COUNTER_ADD( MODEM_PERF_UPLINK_NB, 1 );
     if( lr1_mac->nb_trans_cpt <= 1 )
     {
         // could also be set to 1 if receive valid ans
@@ -1217,6 +1370,7 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
     {
         lr1_mac->type_of_ans_to_send = USRFRAME_TORETRANSMIT;
         lr1_mac->nb_trans_cpt--;
+        MODEM_PERF_COUNTER_ADD( MODEM_PERF_RETRANSMISSION_NB, 1 );
     }
 
     if( lr1_mac->adr_ack_cnt >= lr1_mac->adr_ack_limit + lr1_mac->adr_ack_delay )
@@ -1239,6 +1393,15 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
                                     &lr1_mac->tx_power, &lr1_mac->nb_trans );
             lr1_mac->adr_ack_cnt = lr1_mac->adr_ack_limit;
         }
+
+#if defined( ADD_LINK_ADR )
+        if( lr1_mac->adr_mode_select == LINK_QUALITY_DR_DISTRIBUTION )
+        {
+            // No downlink at all for adr_ack_limit + adr_ack_delay uplinks, step down as for a lost acknowledgement
+            smtc_link_adr_missed_ack( &lr1_mac->link_adr );
+            lr1_mac->adr_ack_cnt = lr1_mac->adr_ack_limit;
+        }
+#endif
     }
 
     if( ( lr1_mac->adr_ack_cnt >= lr1_mac->no_rx_packet_reset_threshold ) &&
@@ -1267,6 +1430,14 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
     {
         if( lr1_mac->type_of_ans_to_send != USRFRAME_TORETRANSMIT )
         {
+#if defined( ADD_LINK_ADR )
+            if( lr1_mac->adr_mode_select == LINK_QUALITY_DR_DISTRIBUTION )
+            {
+                lr1_mac->tx_data_rate_adr = smtc_link_adr_get_datarate( &lr1_mac->link_adr, lr1_mac->real );
+            }
+            // The bulk datarate only lasted for the transmissions of the previous uplink
+            lr1_mac->bulk_dr_in_use = false;
+#endif
             status_lorawan_t status =
                 smtc_real_get_next_tx_dr( lr1_mac->real, lr1_mac->join_status, &lr1_mac->adr_mode_select,
                                           &lr1_mac->tx_data_rate, lr1_mac->tx_data_rate_adr, &lr1_mac->adr_enable );
@@ -1275,6 +1446,18 @@ void lr1_stack_mac_update( lr1_stack_mac_t* lr1_mac )
             {
                 SMTC_MODEM_HAL_PANIC( " Data Rate incompatible with channel mask\n" );
             }
+#if defined( ADD_LINK_ADR )
+            // The network sets the transmit power with LinkADRReq in STATIC_ADR_MODE, the device in the other modes
+            if( ( lr1_mac->adr_mode_select != STATIC_ADR_MODE ) &&
+                ( lr1_mac->link_adr.power_control_enabled == true ) )
+            {
+                int8_t min_power = smtc_real_get_min_tx_power( lr1_mac->real, lr1_mac->max_erp_dbm );
+                lr1_mac->tx_power =
+                    lr1_mac->max_erp_dbm - smtc_link_adr_update_power_reduction(
+                                               &lr1_mac->link_adr, lr1_mac->real, lr1_mac->tx_data_rate,
+                                               ( uint8_t ) ( lr1_mac->max_erp_dbm - min_power ) );
+            }
+#endif
         }
     }
     switch( lr1_mac->type_of_ans_to_send )
@@ -1703,6 +1886,38 @@ bool lr1_stack_mac_tx_ack_bit_get( lr1_stack_mac_t* lr1_mac )
 {
     return lr1_mac->rx_down_data.rx_metadata.tx_ack_bit;
 }
+
+#if defined( ADD_RX_BOOST_POLICY )
+bool lr1_stack_mac_rx_boost_is_needed( const lr1_stack_mac_t* lr1_mac )
+{
+    // A missed join accept costs a new join request, the join accept window is always boosted
+    if( lr1_mac->join_status != JOINED )
+    {
+        return true;
+    }
+    return smtc_rx_boost_is_needed( &lr1_mac->rx_boost );
+}
+
+void lr1_stack_mac_rx_boost_add_downlink( lr1_stack_mac_t* lr1_mac, uint8_t rx_datarate )
+{
+    if( smtc_real_get_modulation_type_from_datarate( lr1_mac->real, rx_datarate ) == LORA )
+    {
+        uint8_t            rx_sf;
+        lr1mac_bandwidth_t rx_bw;
+        smtc_real_lora_dr_to_sf_bw( lr1_mac->real, rx_datarate, &rx_sf, &rx_bw );
+        smtc_rx_boost_add_downlink( &lr1_mac->rx_boost, lr1_mac->rx_down_data.rx_metadata.rx_snr, rx_sf );
+    }
+}
+
+void lr1_stack_mac_rx_boost_apply( void* rp_void )
+{
+    radio_planner_t* rp = ( radio_planner_t* ) rp_void;
+
+    // The gain is not kept in the radio retention memory, it is set after the radio setup of every task. Radios
+    // without boosted gain return RAL_STATUS_UNSUPPORTED_FEATURE and keep their single gain
+    ral_cfg_rx_boosted( &( rp->radio->ral ), rp->radio_params[rp->radio_task_id].rx.rx_boosted );
+}
+#endif
 /*
  *-----------------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITIONS ------------------------------------------------
@@ -1736,6 +1951,74 @@ static status_lorawan_t lr1_stack_mac_downlink_check_under_it( lr1_stack_mac_t*
     return OKLORAWAN;
 }
 
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+static uint32_t lr1_stack_mac_fsk_sync_time_ms( const ralf_params_gfsk_t* gfsk )
+{
+    // Bits from the preamble detection (RAL_GFSK_PREAMBLE_DETECTOR_MIN_<8 x n>BITS) to the end of the sync word
+    uint32_t nb_bits = gfsk->pkt_params.preamble_len_in_bits + gfsk->pkt_params.sync_word_len_in_bits -
+                       ( 8 * ( uint32_t ) gfsk->pkt_params.preamble_detector );
+
+    return ( ( nb_bits * 1000 ) + gfsk->mod_params.br_in_bps - 1 ) / gfsk->mod_params.br_in_bps;
+}
+#endif
+
+#if defined( ADD_RX_DRIFT )
+static void lr1_stack_mac_rx_drift_measure( lr1_stack_mac_t* lr1_mac, uint8_t hook_id, uint32_t rx_done_ms )
+{
+    lr1_mac->rx_drift_offset_valid = false;
+
+    if( ( ( lr1_mac->current_win != RX1 ) && ( lr1_mac->current_win != RX2 ) ) ||
+        ( lr1_mac->rp->radio_params[hook_id].pkt_type != RAL_PKT_TYPE_LORA ) )
+    {
+        return;
+    }
+
+    // The downlink started one time on air before its Rx done, both Tx done and Rx done carry the same irq latency
+    ral_lora_pkt_params_t pkt_params = lr1_mac->rp->radio_params[hook_id].rx.lora.pkt_params;
+    pkt_params.pld_len_in_bytes      = ( uint8_t ) lr1_mac->rp->rx_payload_size[hook_id];
+    uint32_t toa_ms = ral_get_lora_time_on_air_in_ms( &lr1_mac->rp->radio->ral, &pkt_params,
+                                                      &lr1_mac->rp->radio_params[hook_id].rx.lora.mod_params );
+    uint32_t rx_delay_ms = ( lr1_mac->rx1_delay_s + ( ( lr1_mac->current_win == RX2 ) ? 1 : 0 ) ) * 1000;
+
+    lr1_mac->rx_drift_offset_ms =
+        ( int32_t ) ( rx_done_ms - toa_ms - ( lr1_mac->isr_tx_done_radio_timestamp + rx_delay_ms ) );
+    lr1_mac->rx_drift_offset_valid = true;
+
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "%s arrival offset %d ms\n", smtc_name_rx_windows[lr1_mac->current_win],
+                                       lr1_mac->rx_drift_offset_ms );
+}
+
+static void lr1_stack_mac_rx_drift_narrow_window( lr1_stack_mac_t* lr1_mac, const rx_win_type_t type,
+                                                  uint32_t delay_ms )
+{
+    int32_t margin_ms = smtc_rx_drift_get_margin_ms( &lr1_mac->rx_drift );
+
+    lr1_mac->rx_drift_offset_valid = false;
+    lr1_mac->rx_drift_saved_ms     = 0;
+
+    if( ( ( type != RX1 ) && ( type != RX2 ) ) || ( margin_ms == SMTC_RX_DRIFT_NO_MARGIN ) ||
+        ( smtc_real_get_modulation_type_from_datarate( lr1_mac->real, lr1_mac->rx_data_rate ) != LORA ) )
+    {
+        return;
+    }
+
+    // The radio needs MIN_RX_WINDOW_SYMB symbols of preamble, the measured margin is kept on both sides of them
+    uint32_t min_rx_window_ms =
+        ( ( MIN_RX_WINDOW_SYMB * smtc_real_get_symbol_duration_us( lr1_mac->real, lr1_mac->rx_data_rate ) ) / 1000 ) +
+        ( 2 * ( uint32_t ) margin_ms );
+    if( min_rx_window_ms >= MIN_RX_WINDOW_DURATION_MS )
+    {
+        return;
+    }
+
+    uint32_t full_rx_timeout_symb_in_ms = lr1_mac->rx_timeout_symb_in_ms;
+    smtc_real_get_rx_window_parameters( lr1_mac->real, lr1_mac->rx_data_rate, delay_ms, &lr1_mac->rx_window_symb,
+                                        &lr1_mac->rx_timeout_symb_in_ms, &lr1_mac->rx_timeout_ms, 0,
+                                        lr1_mac->crystal_error, min_rx_window_ms );
+    lr1_mac->rx_drift_saved_ms = full_rx_timeout_symb_in_ms - lr1_mac->rx_timeout_symb_in_ms;
+}
+#endif
+
 static void mac_header_set( lr1_stack_mac_t* lr1_mac )
 {
     lr1_mac->tx_payload[0] = ( ( lr1_mac->tx_mtype & 0x7 ) << 5 ) + ( lr1_mac->tx_major_bits & 0x3 );
@@ -1788,6 +2071,21 @@ static void link_check_parser( lr1_stack_mac_t* lr1_mac )
 
             lr1_mac->link_check_margin = lr1_mac->nwk_payload[lr1_mac->nwk_payload_index + 1];
             lr1_mac->link_check_gw_cnt = lr1_mac->nwk_payload[lr1_mac->nwk_payload_index + 2];
+
+#if defined( ADD_LINK_ADR )
+            if( smtc_real_get_modulation_type_from_datarate( lr1_mac->real, lr1_mac->tx_data_rate ) == LORA )
+            {
+                uint8_t            tx_sf;
+                lr1mac_bandwidth_t tx_bw;
+                smtc_real_lora_dr_to_sf_bw( lr1_mac->real, lr1_mac->tx_data_rate, &tx_sf, &tx_bw );
+                smtc_link_adr_add_link_check( &lr1_mac->link_adr, lr1_mac->link_check_margin, tx_sf, tx_bw );
+            }
+            if( lr1_mac->tx_mtype != CONF_DATA_UP )
+            {
+                // The acknowledgement already counts the probe of a confirmed uplink
+                smtc_link_adr_add_probe( &lr1_mac->link_adr, true );
+            }
+#endif
         }
     }
     lr1_mac->nwk_payload_index += LINK_CHECK_ANS_SIZE;
@@ -44,6 +44,15 @@ extern "C" {
 #include "lr1mac_defs.h"
 #include "smtc_real_defs.h"
 #include "radio_planner.h"
+#if defined( ADD_LINK_ADR )
+#include "smtc_link_adr.h"
+#endif
+#if defined( ADD_RX_DRIFT )
+#include "smtc_rx_drift.h"
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+#include "smtc_rx_boost.h"
+#endif
 
 
 /*
@@ -150,11 +159,21 @@ typedef struct lr1_stack_mac_s
     // LoRaWan Mac Data for join
     uint16_t dev_nonce;
     uint8_t  join_nonce[6];  // Join_nonce + NetId
+    bool     nvm_context_save_pending;  // context store not written yet in non volatile memory
+#if defined( ADD_SESSION_RESUME )
+    uint32_t session_fcnt_up;           // First uplink frame counter not reserved by the stored session
+    uint32_t session_fcnt_dwn;          // Downlink frame counter of the stored session
+    uint32_t session_key_check;         // MIC of the EUIs with the network session key
+    uint32_t session_crc;               // crc of the stored session, 0 if no session is stored
+    bool     session_save_pending;      // session store not written yet in non volatile memory
+#endif
     uint8_t  cf_list[16];
 
     // LoRaWan Mac Data for nwk Ans
-    uint8_t nwk_payload[NWK_MAC_PAYLOAD_MAX_SIZE];  //@note resize this buffer
-    uint8_t nwk_payload_size;
+    // View on the received MAC commands: the port 0 payload decrypted in place in rx_down_data.rx_payload or the
+    // FOpts field, only valid until the next reception
+    const uint8_t* nwk_payload;
+    uint8_t        nwk_payload_size;
 
     uint8_t nwk_ans[DEVICE_MAC_PAYLOAD_MAX_SIZE];  //@note reuse user payload data or at least
                                                    // reduce size or use opt byte
@@ -179,6 +198,9 @@ typedef struct lr1_stack_mac_s
     uint32_t next_time_to_join_seconds;
     uint32_t retry_join_cpt;
     uint32_t first_join_timestamp;
+#if defined( ADD_FAST_JOIN )
+    uint8_t fast_join_channel;  // Channel of the last accepted join, SMTC_REAL_NO_JOIN_CHANNEL if unknown
+#endif
 
     uint32_t      tx_frequency;
     uint32_t      rx1_frequency;
@@ -203,6 +225,9 @@ typedef struct lr1_stack_mac_s
     lr1mac_states_t      lr1mac_state;
     uint32_t             rtc_target_timer_ms;
     bool                 send_at_time;
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+    bool nwk_ans_pending;  //!< The frame waiting in LWPSTATE_TX_WAIT only carries MAC answers (nwk_ans)
+#endif
     bool                 available_link_adr;
     bool                 is_join_duty_cycle_backoff_bypass_enabled;
     uint8_t              is_lorawan_modem_certification_enabled;
@@ -237,6 +262,22 @@ typedef struct lr1_stack_mac_s
     uint8_t                   stack_id;
 
     uint8_t no_rx_windows;  // Disable LoRaWAN Rx Windows after a Tx
+
+#if defined( ADD_LINK_ADR )
+    smtc_link_adr_t link_adr;             // Link measurements used by LINK_QUALITY_DR_DISTRIBUTION
+    bool            bulk_dr_in_use;       // The next uplink was moved to the FSK datarate of the bulk mode
+    uint8_t         bulk_fallback_dr;     // Datarate restored if the bulk uplink is not sent
+    int8_t          bulk_fallback_power;  // Transmit power restored if the bulk uplink is not sent
+#endif
+#if defined( ADD_RX_DRIFT )
+    smtc_rx_drift_t rx_drift;               // Arrival offsets of the last RX1/RX2 downlinks
+    int32_t         rx_drift_offset_ms;     // Arrival offset of the downlink being decoded
+    bool            rx_drift_offset_valid;  // rx_drift_offset_ms was measured in the current window
+    uint32_t        rx_drift_saved_ms;      // Listen time removed from the current window
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+    smtc_rx_boost_t rx_boost;  // Margins of the last downlinks, choose the receiver gain
+#endif
 } lr1_stack_mac_t;
 
 /*
@@ -440,6 +481,33 @@ void lr1_stack_mac_rx_gfsk_launch_callback_for_rp( void* rp_void );
 void lr1_stack_mac_tx_ack_bit_set( lr1_stack_mac_t* lr1_mac, bool enable );
 bool lr1_stack_mac_tx_ack_bit_get( lr1_stack_mac_t* lr1_mac );
 
+#if defined( ADD_RX_BOOST_POLICY )
+/**
+ * @brief Check if the next downlink window of the stack (class A, B or C) shall use the boosted receiver gain
+ *
+ * @remark The join accept window is always boosted, the other ones only while the link margin is low
+ *
+ * @param [in] lr1_mac
+ * @return true for the boosted gain, false for the power saving gain
+ */
+bool lr1_stack_mac_rx_boost_is_needed( const lr1_stack_mac_t* lr1_mac );
+
+/**
+ * @brief Add the margin of the valid downlink in rx_down_data to the receiver gain policy
+ *
+ * @param [in] lr1_mac
+ * @param [in] rx_datarate  Datarate of the downlink, FSK downlinks are ignored
+ */
+void lr1_stack_mac_rx_boost_add_downlink( lr1_stack_mac_t* lr1_mac, uint8_t rx_datarate );
+
+/**
+ * @brief Apply the receiver gain of the task being launched, after the radio setup of its launch callback
+ *
+ * @param [in] rp_void  Radio planner
+ */
+void lr1_stack_mac_rx_boost_apply( void* rp_void );
+#endif
+
 
 
 
@@ -130,6 +130,24 @@ static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t times
  */
 static void update_beacon_state( smtc_lr1_beacon_t* lr1_beacon_obj );
 
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+/**
+ * @brief give the beacon period measured by the pll to the ping slots once the pll is locked
+ *
+ * @param [in,out] lr1_beacon_obj Beacon object
+ */
+static void update_ping_slot_pll( smtc_lr1_beacon_t* lr1_beacon_obj );
+#endif
+
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+/**
+ * @brief compute the number of beacons to skip after a listened beacon and stop skipping on a temperature change
+ *
+ * @param [in,out] lr1_beacon_obj Beacon object
+ */
+static void update_beacon_skip( smtc_lr1_beacon_t* lr1_beacon_obj );
+#endif
+
 /**
  * @brief beacon print for debug
  *
@@ -145,6 +163,17 @@ static void beacon_debug_print( smtc_lr1_beacon_t* lr1_beacon_obj );
  */
 static void update_beacon_rx_nb_symb( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t target_time );
 
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+/**
+ * @brief compute the length in symbols of the rx window of a beacon acquisition from the network time accuracy
+ *
+ * @param [in,out] lr1_beacon_obj Beacon object
+ * @param [in] target_time target time of the beacon
+ * @return the length in symbols of the rx window
+ */
+static uint16_t get_beacon_acquisition_rx_nb_symb( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t target_time );
+#endif
+
 /**
  * @brief compute the time of the next beacon
  *
@@ -267,6 +296,9 @@ void smtc_beacon_sniff_stop( smtc_lr1_beacon_t* lr1_beacon_obj )
         return;
     }
     lr1_beacon_obj->started = false;
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+    lr1_beacon_obj->beacon_acquisition_nb = 0;
+#endif
     rp_task_abort( lr1_beacon_obj->rp, lr1_beacon_obj->beacon_sniff_id_rp );  // no need to check return code because in
                                                                               // case of error panic inside the function
 
@@ -307,7 +339,11 @@ smtc_class_b_beacon_t smtc_beacon_sniff_start( smtc_lr1_beacon_t* lr1_beacon_obj
     pll_phase_temp += rtc;
     pll_phase_temp -= fractional_second;
     lr1_beacon_obj->dpll_phase             = pll_phase_temp;
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+    lr1_beacon_obj->beacon_open_rx_nb_symb = get_beacon_acquisition_rx_nb_symb( lr1_beacon_obj, pll_phase_temp );
+#else
     lr1_beacon_obj->beacon_open_rx_nb_symb = MAX_BEACON_WINDOW_SYMB( );
+#endif
     lr1_beacon_obj->started                = true;
     lr1mac_core_convert_rtc_to_gps_epoch_time( lr1_beacon_obj->lr1_mac, pll_phase_temp, &seconds_since_epoch,
                                                &fractional_second );
@@ -395,9 +431,7 @@ void smtc_beacon_sniff_launch_callback_for_rp( void* rp_void )
         ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_HDR_ERROR |
                                                          RAL_IRQ_RX_CRC_ERROR ) == RAL_STATUS_OK );
     // Wait the exact time
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
-    {
-    }
+    rp_task_wait_start_time( rp, id );
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( false );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rx( &( rp->radio->ral ), rp->radio_params[id].rx.timeout_in_ms ) ==
@@ -434,6 +468,12 @@ void smtc_beacon_sniff_rp_callback( smtc_lr1_beacon_t* lr1_beacon_obj )
     update_beacon_state( lr1_beacon_obj );
 
     compute_beacon_metadata( lr1_beacon_obj, timestamp, beacon_epoch_time );
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+    update_ping_slot_pll( lr1_beacon_obj );
+#endif
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+    update_beacon_skip( lr1_beacon_obj );
+#endif
     update_beacon_rx_nb_symb( lr1_beacon_obj, DPLL_PHASE_MS( ) );
     beacon_debug_print( lr1_beacon_obj );
 
@@ -453,6 +493,12 @@ void smtc_beacon_sniff_rp_callback( smtc_lr1_beacon_t* lr1_beacon_obj )
         SMTC_MODEM_HAL_TRACE_PRINTF( "beacon stop ping slot\n" );
         smtc_ping_slot_stop( lr1_beacon_obj->ping_slot_obj );
     }
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+    if( lr1_beacon_obj->beacon_statistics.beacon_state == BEACON_LOCK )
+    {
+        lr1_beacon_obj->beacon_acquisition_nb = 0;
+    }
+#endif
     lr1_beacon_obj->beacon_epoch_time += BEACON_PERIOD_S;
 
     if( lr1_beacon_obj->beacon_statistics.beacon_state == BEACON_UNLOCK )
@@ -471,6 +517,26 @@ void smtc_beacon_sniff_get_statistics( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_b
     memcpy( beacon_statistics, &lr1_beacon_obj->beacon_statistics, sizeof( smtc_beacon_statistics_t ) );
 }
 
+bool smtc_beacon_sniff_get_gps_time( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t rtc_ms, uint32_t* seconds_since_epoch,
+                                     uint32_t* fractional_second, uint32_t* age_ms )
+{
+    if( ( lr1_beacon_obj->started == false ) ||
+        ( lr1_beacon_obj->beacon_statistics.beacon_state != BEACON_LOCK ) ||
+        ( lr1_beacon_obj->beacon_statistics.nb_beacon_received == 0 ) )
+    {
+        return false;
+    }
+
+    // The timestamp is taken at the end of the beacon, the beacon starts at its epoch time
+    uint32_t elapsed_ms =
+        rtc_ms - ( lr1_beacon_obj->beacon_statistics.last_beacon_received_timestamp - lr1_beacon_obj->beacon_toa );
+
+    *seconds_since_epoch = lr1_beacon_obj->rx_beacon_epoch_time + ( elapsed_ms / 1000 );
+    *fractional_second   = elapsed_ms % 1000;
+    *age_ms              = elapsed_ms;
+    return true;
+}
+
 uint32_t smtc_decode_beacon_epoch_time( uint8_t* beacon_payload, uint8_t beacon_sf )
 {
     // the format of the beacon payload is different according to the beacon sf. The following formula is a way to
@@ -582,6 +648,13 @@ static uint8_t get_beacon_length( uint8_t beacon_sf )
 }
 static rp_task_types_t get_beacon_rp_task_type( smtc_lr1_beacon_t* lr1_beacon_obj )
 {
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+    if( ( lr1_beacon_obj->beacon_skip_nb > 0 ) &&
+        ( lr1_beacon_obj->beacon_statistics.beacon_state == BEACON_LOCK ) )
+    {
+        return RP_TASK_TYPE_NONE;
+    }
+#endif
     if( ( ( ( lr1_beacon_obj->beacon_statistics.nb_beacon_missed +
               lr1_beacon_obj->beacon_statistics.nb_beacon_received ) %
             ( lr1_beacon_obj->listen_beacon_rate - lr1_beacon_obj->lr1_mac->stack_id ) ) == 0 ) ||
@@ -631,6 +704,7 @@ static void compute_beacon_metadata( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t
         }
 
         lr1_beacon_obj->beacon_statistics.last_beacon_received_timestamp = timestamp;
+        lr1_beacon_obj->rx_beacon_epoch_time                             = beacon_epoch_time;
         lr1_beacon_obj->ping_slot_obj->last_valid_rx_beacon_ms           = timestamp;
         lr1_beacon_obj->beacon_statistics.nb_beacon_received++;
         lr1_beacon_obj->beacon_statistics.last_beacon_received_consecutively++;
@@ -643,7 +717,15 @@ static void compute_beacon_metadata( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t
         lr1_beacon_obj->lr1_mac->rx_down_data.rx_metadata.rx_snr  = 0;
         lr1_beacon_obj->lr1_mac->rx_down_data.rx_metadata.rx_rssi = 0;
         lr1_beacon_obj->beacon_statistics.nb_beacon_missed++;
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+        // A skipped beacon does not break the run of received beacons the skipping relies on
+        if( lr1_beacon_obj->rp->tasks[lr1_beacon_obj->beacon_sniff_id_rp].type != RP_TASK_TYPE_NONE )
+        {
+            lr1_beacon_obj->beacon_statistics.last_beacon_received_consecutively = 0;
+        }
+#else
         lr1_beacon_obj->beacon_statistics.last_beacon_received_consecutively = 0;
+#endif
         lr1_beacon_obj->beacon_statistics.last_beacon_lost_consecutively++;
         if( lr1_beacon_obj->rp->tasks[lr1_beacon_obj->beacon_sniff_id_rp].type != RP_TASK_TYPE_NONE )
         {
@@ -696,8 +778,10 @@ static void update_beacon_pll( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t times
 }
 static void update_beacon_state( smtc_lr1_beacon_t* lr1_beacon_obj )
 {
+    // a missed acquisition keeps the beacon unlocked whatever its window size
     if( ( lr1_beacon_obj->is_valid_beacon == false ) &&
-        ( ( lr1_beacon_obj->beacon_open_rx_nb_symb >= MAX_BEACON_WINDOW_SYMB( ) ) ||
+        ( ( lr1_beacon_obj->beacon_statistics.beacon_state == BEACON_UNLOCK ) ||
+          ( lr1_beacon_obj->beacon_open_rx_nb_symb >= MAX_BEACON_WINDOW_SYMB( ) ) ||
           ( lr1_beacon_obj->beacon_statistics.last_beacon_lost_consecutively > NB_OF_BEACON_BEFORE_DELOCK ) ) )
     {
         // Reach this point if no received beacon for a long period
@@ -717,6 +801,85 @@ static void update_beacon_state( smtc_lr1_beacon_t* lr1_beacon_obj )
         lr1_beacon_obj->beacon_statistics.beacon_state = BEACON_LOCK;
     }
 }
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+static void update_ping_slot_pll( smtc_lr1_beacon_t* lr1_beacon_obj )
+{
+    smtc_ping_slot_t* ping_slot_obj = lr1_beacon_obj->ping_slot_obj;
+
+    if( lr1_beacon_obj->beacon_statistics.beacon_state == BEACON_UNLOCK )
+    {
+        ping_slot_obj->beacon_pll_locked = false;
+        return;
+    }
+    if( lr1_beacon_obj->is_valid_beacon == true )
+    {
+        // A missed beacon keeps the last estimate, the period does not change with one beacon
+        ping_slot_obj->beacon_pll_locked =
+            ( lr1_beacon_obj->beacon_statistics.last_beacon_received_consecutively >= BEACON_PLL_LOCK_NB_BEACON ) &&
+            ( ABS( lr1_beacon_obj->dpll_error ) <= BEACON_PLL_LOCK_ERROR_MS );
+        // Same period as the pll phase update
+        ping_slot_obj->beacon_pll_period_ms =
+            lr1_beacon_obj->dpll_frequency + ( ( ABS( lr1_beacon_obj->dpll_error ) > 10 )
+                                                   ? ( 10 * SIGN( lr1_beacon_obj->dpll_error ) )
+                                                   : lr1_beacon_obj->dpll_error );
+    }
+}
+#endif
+
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+static void update_beacon_skip( smtc_lr1_beacon_t* lr1_beacon_obj )
+{
+    if( lr1_beacon_obj->beacon_statistics.beacon_state == BEACON_UNLOCK )
+    {
+        lr1_beacon_obj->beacon_skip_nb = 0;
+        return;
+    }
+
+    if( lr1_beacon_obj->rp->tasks[lr1_beacon_obj->beacon_sniff_id_rp].type == RP_TASK_TYPE_NONE )
+    {
+        if( lr1_beacon_obj->beacon_skip_nb > 0 )
+        {
+            lr1_beacon_obj->beacon_skip_nb--;
+            // The crystal frequency moves with the temperature, the pll period no longer predicts the beacon
+            int8_t temperature = smtc_modem_hal_get_temperature( );
+            if( ABS( temperature - lr1_beacon_obj->beacon_skip_temperature ) > BEACON_SKIP_TEMPERATURE_DELTA )
+            {
+                SMTC_MODEM_HAL_TRACE_PRINTF( "temperature %d C, listen next beacon\n", temperature );
+                lr1_beacon_obj->beacon_skip_nb = 0;
+            }
+        }
+        return;
+    }
+
+    lr1_beacon_obj->beacon_skip_nb = 0;
+    if( ( lr1_beacon_obj->is_valid_beacon == false ) ||
+        ( lr1_beacon_obj->beacon_statistics.last_beacon_received_consecutively < BEACON_PLL_LOCK_NB_BEACON ) ||
+        ( ABS( lr1_beacon_obj->dpll_error ) > BEACON_PLL_LOCK_ERROR_MS ) ||
+        ( ABS( lr1_beacon_obj->dpll_error ) >= BEACON_SKIP_MAX_ERROR_MS ) )
+    {
+        return;
+    }
+
+    // Drift rate the ping slot windows are sized with
+    uint32_t error_ppm = lr1_beacon_obj->lr1_mac->crystal_error;
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+    if( lr1_beacon_obj->ping_slot_obj->beacon_pll_locked == true )
+    {
+        error_ppm = MIN( error_ppm, PING_SLOT_PLL_RESIDUAL_PPM );
+    }
+#endif
+    // Timing error at the next listened beacon: the phase error plus the drift over the periods up to it
+    const uint32_t drift_per_period_us = BEACON_PERIOD_S * MAX( error_ppm, 1 );
+    const uint32_t budget_us = ( BEACON_SKIP_MAX_ERROR_MS - ABS( lr1_beacon_obj->dpll_error ) ) * 1000UL;
+    const uint32_t nb_period = budget_us / drift_per_period_us;
+
+    lr1_beacon_obj->beacon_skip_nb =
+        ( uint8_t ) MIN( ( nb_period > 0 ) ? ( nb_period - 1 ) : 0, BEACON_SKIP_MAX_NB );
+    lr1_beacon_obj->beacon_skip_temperature = smtc_modem_hal_get_temperature( );
+    SMTC_MODEM_HAL_TRACE_PRINTF( "skip %u beacons\n", lr1_beacon_obj->beacon_skip_nb );
+}
+#endif
+
 static void beacon_debug_print( smtc_lr1_beacon_t* lr1_beacon_obj )
 {
     if( lr1_beacon_obj->is_valid_beacon == true )
@@ -756,7 +919,7 @@ static void update_beacon_rx_nb_symb( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_
             lr1_beacon_obj->lr1_mac->real, BEACON_DATA_RATE( ),
             ( target_time - lr1_beacon_obj->beacon_statistics.last_beacon_received_timestamp ),
             &lr1_beacon_obj->beacon_open_rx_nb_symb, &rx_timeout_symb_in_ms_tmp, &rx_timeout_symb_locked_in_ms_tmp, 0,
-            lr1_beacon_obj->lr1_mac->crystal_error );
+            lr1_beacon_obj->lr1_mac->crystal_error, MIN_RX_WINDOW_DURATION_MS );
         // in case of beacon has not been YET received 4 times consecutively it enlarge the rx windows.
         if( lr1_beacon_obj->beacon_statistics.last_beacon_lost_consecutively == 0 )
         {
@@ -768,6 +931,28 @@ static void update_beacon_rx_nb_symb( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_
         }
     }
 }
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+static uint16_t get_beacon_acquisition_rx_nb_symb( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t target_time )
+{
+    // the network time is known at the end of the DeviceTimeReq uplink, the drift is counted from there
+    const uint32_t delay_s = ( target_time - lr1_beacon_obj->lr1_mac->timestamp_tx_done_device_time_req_ms ) / 1000;
+    uint32_t       window_ms =
+        2 * ( BEACON_ACQUISITION_TIME_ERROR_MS + ( ( delay_s * lr1_beacon_obj->lr1_mac->crystal_error ) / 1000 ) );
+
+    for( uint8_t i = 0; ( i < lr1_beacon_obj->beacon_acquisition_nb ) && ( window_ms < MAX_BEACON_WINDOW_MS ); i++ )
+    {
+        window_ms *= 4;
+    }
+    window_ms = MIN( window_ms, MAX_BEACON_WINDOW_MS );
+    if( lr1_beacon_obj->beacon_acquisition_nb < UINT8_MAX )
+    {
+        lr1_beacon_obj->beacon_acquisition_nb++;
+    }
+    SMTC_MODEM_HAL_TRACE_PRINTF( "beacon acquisition window %u ms\n", window_ms );
+    return TIME_MS_TO_BEACON_SYMB( window_ms );
+}
+#endif
+
 static uint32_t compute_start_time( smtc_lr1_beacon_t* lr1_beacon_obj )
 {
     int8_t  board_delay_ms = smtc_modem_hal_get_radio_tcxo_startup_delay_ms( ) + smtc_modem_hal_get_board_delay_ms( );
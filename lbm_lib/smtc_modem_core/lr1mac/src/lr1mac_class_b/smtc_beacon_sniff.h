@@ -114,6 +114,46 @@ extern "C" {
  */
 #define BEACON_PLL_PHASE_GAIN_MUL ( 7 )
 #define BEACON_PLL_PHASE_GAIN_DIV ( 8 )
+#if defined( ADD_CLASS_B_PLL_PING_SLOT ) || defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+/**
+ * @brief the digital pll is considered locked once BEACON_PLL_LOCK_NB_BEACON beacons have been received consecutively
+ * and the filtered phase error is below BEACON_PLL_LOCK_ERROR_MS, the ping slots then use the beacon period it measures
+ * and beacons can be skipped
+ */
+#ifndef BEACON_PLL_LOCK_NB_BEACON
+#define BEACON_PLL_LOCK_NB_BEACON ( 4 )
+#endif
+#ifndef BEACON_PLL_LOCK_ERROR_MS
+#define BEACON_PLL_LOCK_ERROR_MS ( 2 )
+#endif
+#endif
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+/**
+ * @brief once the digital pll is locked, the beacons are skipped while the timing error predicted at the next listened
+ * beacon (phase error plus the drift used to size the ping slot windows) stays below BEACON_SKIP_MAX_ERROR_MS, with at
+ * most BEACON_SKIP_MAX_NB beacons skipped in a row. A temperature change of more than BEACON_SKIP_TEMPERATURE_DELTA
+ * celsius since the last listened beacon ends the skipping
+ */
+#ifndef BEACON_SKIP_MAX_ERROR_MS
+#define BEACON_SKIP_MAX_ERROR_MS ( 10 )
+#endif
+#ifndef BEACON_SKIP_MAX_NB
+#define BEACON_SKIP_MAX_NB ( 7 )
+#endif
+#ifndef BEACON_SKIP_TEMPERATURE_DELTA
+#define BEACON_SKIP_TEMPERATURE_DELTA ( 5 )
+#endif
+#endif
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+/**
+ * @brief the first beacon window is sized from the network time accuracy: BEACON_ACQUISITION_TIME_ERROR_MS
+ * (DeviceTimeAns resolution and network timestamp error) plus the crystal drift since the DeviceTimeAns, on each side of
+ * the expected beacon time. Each missed acquisition multiplies the window by 4 up to MAX_BEACON_WINDOW_MS
+ */
+#ifndef BEACON_ACQUISITION_TIME_ERROR_MS
+#define BEACON_ACQUISITION_TIME_ERROR_MS ( 20 )
+#endif
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -185,6 +225,7 @@ typedef struct smtc_lr1_beacon_s
     uint8_t beacon_buffer_length;        //!< the beacon payload length in bytes
 
     uint32_t beacon_epoch_time;        //!< the epoch time inside the last valid beacon
+    uint32_t rx_beacon_epoch_time;     //!< the epoch time decoded from the last valid received beacon
     uint16_t beacon_open_rx_nb_symb;   //!< the duration in symbol of the rx time out of the next beacon reception
     uint32_t beacon_toa;               //!< the beacon toa
     int32_t  dpll_error_wo_filtering;  //!< the internal digital pll phase error without filtering
@@ -194,6 +235,13 @@ typedef struct smtc_lr1_beacon_s
     uint32_t dpll_phase;         //!< the digital pll phase with a 0.1ms resolution
     uint8_t  listen_beacon_rate;  //!< default value : DEFAULT_LISTEN_BEACON_RATE, referred to the explanation of this
                                   //!< default value to understood this parameter
+#if defined( ADD_CLASS_B_ADAPTIVE_BEACON )
+    uint8_t beacon_skip_nb;           //!< number of beacons still to skip before the next beacon reception
+    int8_t  beacon_skip_temperature;  //!< temperature in celsius at the last listened beacon
+#endif
+#if defined( ADD_CLASS_B_FAST_ACQUISITION )
+    uint8_t beacon_acquisition_nb;  //!< number of beacon acquisitions missed since the acquisition started
+#endif
 
     void ( *push_callback )(
         lr1_stack_mac_down_data_t* );  //!< this call back is used to push a valid beacon payload to the upper layer,
@@ -273,6 +321,21 @@ void smtc_beacon_sniff_rp_callback( smtc_lr1_beacon_t* lr1_beacon_obj );
  */
 void smtc_beacon_sniff_get_statistics( smtc_lr1_beacon_t* lr1_beacon_obj, smtc_beacon_statistics_t* beacon_statistics );
 
+/**
+ * @brief Get the GPS time from the last valid received beacon
+ *
+ * @remark A beacon is sent at the exact GPS second it carries, the time only drifts with the local rtc since then
+ *
+ * @param [in]  lr1_beacon_obj       Beacon object
+ * @param [in]  rtc_ms               Local rtc time to convert in ms
+ * @param [out] seconds_since_epoch  GPS time in seconds
+ * @param [out] fractional_second    Fractional part in ms
+ * @param [out] age_ms               Time elapsed since the beacon in ms
+ * @return bool                      false if the beacon is not locked
+ */
+bool smtc_beacon_sniff_get_gps_time( smtc_lr1_beacon_t* lr1_beacon_obj, uint32_t rtc_ms, uint32_t* seconds_since_epoch,
+                                     uint32_t* fractional_second, uint32_t* age_ms );
+
 /**
  * @brief Decode the epoch time field in beacon payload
  * @remark the beacon payload format is dependant of the spreading factor
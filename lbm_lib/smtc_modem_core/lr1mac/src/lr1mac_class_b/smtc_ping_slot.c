@@ -41,6 +41,7 @@
 
 #include "smtc_modem_hal_dbg_trace.h"
 #include "smtc_ping_slot.h"
+#include "smtc_beacon_sniff.h"
 #include "radio_planner.h"
 #include "lr1mac_defs.h"
 #include "lr1mac_utilities.h"
@@ -135,6 +136,30 @@ static void smtc_ping_slot_search_closest_ping_offset_time( smtc_ping_slot_t* pi
  */
 static uint32_t smtc_ping_slot_compute_downlink_toa( lr1_stack_mac_t* lr1_mac, uint8_t datarate, uint8_t payload_size );
 
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+/**
+ * @brief Check if the listen ratio of a session leaves its next ping slot out
+ *
+ * @param ping_slot_obj
+ * @param session       // Rx session (unicast, multicast0, ...)
+ * @return true if the slot is not listened
+ */
+static bool smtc_ping_slot_is_skipped( smtc_ping_slot_t* ping_slot_obj, rx_session_type_t session );
+
+/**
+ * @brief Share the window of the current ping slot with the overlapping slots of the sessions on the same channel
+ *
+ * @remark The current session becomes the one with the first slot, its rx_window_symb is extended up to the window of
+ *         the last slot
+ *
+ * @param ping_slot_obj
+ * @param freq          // Frequency of the current ping slot
+ * @param timestamp_rtc
+ * @return uint32_t     // Time from the first to the last merged slot in ms
+ */
+static uint32_t smtc_ping_slot_merge_sessions( smtc_ping_slot_t* ping_slot_obj, uint32_t freq, uint32_t timestamp_rtc );
+#endif
+
 /**
  * @brief Configure the radio at time to open the ping slot
  *
@@ -176,6 +201,13 @@ void smtc_ping_slot_init( smtc_ping_slot_t* ping_slot_obj, lr1_stack_mac_t* lr1_
 
     ping_slot_obj->rx_session_param[RX_SESSION_UNICAST] = &ping_slot_obj->rx_session_param_unicast;
 
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+    for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
+    {
+        ping_slot_obj->listen_ratio[i] = 1;
+    }
+#endif
+
 #if defined( SMTC_MULTICAST )
     if( multicast_rx_sessions != NULL )
     {
@@ -211,6 +243,10 @@ void smtc_ping_slot_init_after_beacon( smtc_ping_slot_t* ping_slot_obj, uint32_t
     ping_slot_obj->next_beacon_timestamp = next_beacon_timestamp;
     ping_slot_obj->beacon_reserved_ms    = beacon_reserved_ms;
     ping_slot_obj->beacon_guard_ms       = beacon_guard_ms;
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+    ping_slot_obj->beacon_period_index = beacon_epoch_time / BEACON_PERIOD_S;
+    memset( ping_slot_obj->listen_all, 0, sizeof( ping_slot_obj->listen_all ) );
+#endif
 
     ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->dev_addr = ping_slot_obj->lr1_mac->dev_addr;
 
@@ -238,6 +274,12 @@ void smtc_ping_slot_init_after_beacon( smtc_ping_slot_t* ping_slot_obj, uint32_t
                                                    ping_slot_obj->rx_session_param[i]->dev_addr,
                                                    ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_period,
                                                    ping_slot_obj->lr1_mac->stack_id );
+#if defined( ADD_CLASS_B_PING_SLOT_SCHEDULE )
+            // The hopping frequency only changes with the beacon period, all slots of the period share it
+            ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_slot_freq_hz =
+                smtc_real_get_ping_slot_frequency( ping_slot_obj->lr1_mac->real, beacon_epoch_time,
+                                                   ping_slot_obj->rx_session_param[i]->dev_addr );
+#endif
         }
     }
 }
@@ -261,8 +303,10 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
     }
 
     uint32_t          timestamp_rtc;
+#if !defined( ADD_CLASS_B_PING_SLOT_SCHEDULE )
     uint32_t          ping_slot_seconds_since_epoch;
     uint32_t          ping_slot_fractional_second;
+#endif
     uint32_t          ping_slot_freq;
     uint8_t           ping_slot_dr;
     modulation_type_t modulation_type;
@@ -271,17 +315,31 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
     uint32_t          rx_timeout_symb_locked_in_ms_tmp;
     rp_task_t         rp_task = { 0 };
     int32_t           rx_offset_ms_tmp;
-    rp_hook_status_t  rp_status;
+    rp_hook_status_t  rp_status = RP_HOOK_STATUS_OK;
 
     do
     {
         timestamp_rtc = smtc_modem_hal_get_time_in_ms( );
+#if defined( ADD_RP_ADMISSION_CONTROL )
+        if( rp_status == RP_TASK_STATUS_SCHEDULE_TASK_IN_CONFLICT )
+        {
+            // The slot is taken by a task of higher priority, look for the next one instead of being aborted later
+            timestamp_rtc = RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time;
+        }
+#endif
         smtc_ping_slot_compute_next_ping_offset_time( ping_slot_obj, timestamp_rtc );
         if( ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->enabled == true )
         {
             // copy context from LR1MAC class A for the unicast session
             ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->dev_addr = ping_slot_obj->lr1_mac->dev_addr;
 
+#if defined( ADD_CLASS_B_PING_SLOT_SCHEDULE )
+            // If the frequency is not 0, the network changed it
+            ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->rx_frequency =
+                ( ping_slot_obj->lr1_mac->ping_slot_freq_hz != 0 )
+                    ? ping_slot_obj->lr1_mac->ping_slot_freq_hz
+                    : ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->ping_slot_parameters.ping_slot_freq_hz;
+#else
             lr1mac_core_convert_rtc_to_gps_epoch_time(
                 ping_slot_obj->lr1_mac,
                 ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->ping_slot_parameters.ping_offset_time,
@@ -294,6 +352,7 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
                     : smtc_real_get_ping_slot_frequency(
                           ping_slot_obj->lr1_mac->real, ping_slot_seconds_since_epoch,
                           ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->dev_addr );
+#endif
 
             ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->rx_data_rate = ping_slot_obj->lr1_mac->ping_slot_dr;
 
@@ -320,6 +379,11 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
 
         ping_slot_obj->enabled = true;
 
+#if defined( ADD_CLASS_B_PING_SLOT_SCHEDULE )
+        ping_slot_freq = ( RX_SESSION_PARAM_CURRENT->rx_frequency != 0 )
+                             ? RX_SESSION_PARAM_CURRENT->rx_frequency
+                             : RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_slot_freq_hz;
+#else
         lr1mac_core_convert_rtc_to_gps_epoch_time( ping_slot_obj->lr1_mac,
                                                    RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time,
                                                    &ping_slot_seconds_since_epoch, &ping_slot_fractional_second );
@@ -329,17 +393,41 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
                 ? RX_SESSION_PARAM_CURRENT->rx_frequency
                 : smtc_real_get_ping_slot_frequency( ping_slot_obj->lr1_mac->real, ping_slot_seconds_since_epoch,
                                                      RX_SESSION_PARAM_CURRENT->dev_addr );
+#endif
 
         ping_slot_dr = RX_SESSION_PARAM_CURRENT->rx_data_rate;
 
         modulation_type = smtc_real_get_modulation_type_from_datarate( ping_slot_obj->lr1_mac->real, ping_slot_dr );
 
+        const uint32_t rx_delay_ms =
+            RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time - ping_slot_obj->last_valid_rx_beacon_ms;
+        uint32_t crystal_error = ping_slot_obj->lr1_mac->crystal_error;
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+        int32_t pll_offset_ms = 0;
+        if( ping_slot_obj->beacon_pll_locked == true )
+        {
+            // The slot is moved by the clock drift measured by the beacon pll since the beacon, the window only covers
+            // the error of the measurement
+            pll_offset_ms = ( int32_t ) ( ( ( int64_t ) rx_delay_ms *
+                                            ( ( int32_t ) ping_slot_obj->beacon_pll_period_ms -
+                                              ( int32_t ) BEACON_PERIOD_MS ) ) /
+                                          ( int32_t ) BEACON_PERIOD_MS );
+            crystal_error = MIN( crystal_error, PING_SLOT_PLL_RESIDUAL_PPM );
+        }
+#endif
+
         smtc_real_get_rx_window_parameters( ping_slot_obj->lr1_mac->real, RX_SESSION_PARAM_CURRENT->rx_data_rate,
-                                            ( RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time -
-                                              ping_slot_obj->last_valid_rx_beacon_ms ),
-                                            &RX_SESSION_PARAM_CURRENT->rx_window_symb, &rx_timeout_symb_in_ms_tmp,
-                                            &rx_timeout_symb_locked_in_ms_tmp, RX_BEACON_TIMESTAMP_ERROR,
-                                            ping_slot_obj->lr1_mac->crystal_error );
+                                            rx_delay_ms, &RX_SESSION_PARAM_CURRENT->rx_window_symb,
+                                            &rx_timeout_symb_in_ms_tmp, &rx_timeout_symb_locked_in_ms_tmp,
+                                            RX_BEACON_TIMESTAMP_ERROR, crystal_error, MIN_RX_WINDOW_DURATION_MS );
+
+        // The window is placed around the preamble of the first slot whatever the length of the merged window
+        const uint16_t offset_window_symb = RX_SESSION_PARAM_CURRENT->rx_window_symb;
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+        const uint32_t merged_ms = smtc_ping_slot_merge_sessions( ping_slot_obj, ping_slot_freq, timestamp_rtc );
+        rx_timeout_symb_in_ms_tmp += merged_ms;
+        rx_timeout_symb_locked_in_ms_tmp += merged_ms;
+#endif
 
         if( modulation_type == LORA )
         {
@@ -414,17 +502,36 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
         rp_task.hook_id                    = ping_slot_obj->ping_slot_id4rp;
         rp_task.state                      = RP_TASK_STATE_SCHEDULE;
         rp_task.schedule_task_low_priority = true;
+#if defined( ADD_RP_ADMISSION_CONTROL )
+        rp_task.admission_check = true;
+#endif
         int8_t board_delay_ms =
             smtc_modem_hal_get_radio_tcxo_startup_delay_ms( ) + smtc_modem_hal_get_board_delay_ms( );
+#if defined( ADD_RP_US_TIMEBASE )
+        int32_t rx_offset_us_tmp;
+        smtc_real_get_rx_start_time_offset_us( ping_slot_obj->lr1_mac->real, RX_SESSION_PARAM_CURRENT->rx_data_rate,
+                                               board_delay_ms, offset_window_symb, &rx_offset_us_tmp );
+        // Keep the sub-millisecond part of the offset instead of truncating it
+        rx_offset_ms_tmp =
+            ( rx_offset_us_tmp >= 0 ) ? ( rx_offset_us_tmp / 1000 ) : -( ( 999 - rx_offset_us_tmp ) / 1000 );
+        rp_task.start_time_us = ( uint16_t ) ( rx_offset_us_tmp - ( rx_offset_ms_tmp * 1000 ) );
+#else
         smtc_real_get_rx_start_time_offset_ms( ping_slot_obj->lr1_mac->real, RX_SESSION_PARAM_CURRENT->rx_data_rate,
-                                               board_delay_ms, RX_SESSION_PARAM_CURRENT->rx_window_symb,
-                                               &rx_offset_ms_tmp );
+                                               board_delay_ms, offset_window_symb, &rx_offset_ms_tmp );
+#endif
         rp_task.start_time_ms = RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time + rx_offset_ms_tmp +
                                 ( RX_BEACON_TIMESTAMP_ERROR >> 1 );
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+        rp_task.start_time_ms += pll_offset_ms;
+#endif
 
         rp_task.duration_time_ms = smtc_ping_slot_get_duration_timeout_ms(
             ping_slot_obj, RX_SESSION_PARAM_CURRENT->rx_window_symb, RX_SESSION_PARAM_CURRENT->rx_data_rate );
 
+#if defined( ADD_RX_BOOST_POLICY )
+        rp_radio_params.rx.rx_boosted = lr1_stack_mac_rx_boost_is_needed( ping_slot_obj->lr1_mac );
+#endif
+
         if( rp_radio_params.pkt_type == RAL_PKT_TYPE_LORA )
         {
             rp_task.type                  = RP_TASK_TYPE_RX_LORA;
@@ -436,7 +543,11 @@ void smtc_ping_slot_start( smtc_ping_slot_t* ping_slot_obj )
             rp_task.launch_task_callbacks = lr1_stack_mac_rx_gfsk_launch_callback_for_rp;
         }
         rp_status = rp_task_enqueue( ping_slot_obj->rp, &rp_task, RX_DOWN_DATA.rx_payload, 255, &rp_radio_params );
-    } while( rp_status == RP_TASK_STATUS_SCHEDULE_TASK_IN_PAST );
+    } while( ( rp_status == RP_TASK_STATUS_SCHEDULE_TASK_IN_PAST )
+#if defined( ADD_RP_ADMISSION_CONTROL )
+             || ( rp_status == RP_TASK_STATUS_SCHEDULE_TASK_IN_CONFLICT )
+#endif
+    );
     if( rp_status != RP_HOOK_STATUS_OK )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "ping_slot_obj START ERROR \n" );
@@ -568,7 +679,8 @@ void smtc_ping_slot_mac_rp_callback( smtc_ping_slot_t* ping_slot_obj )
 
                 RX_DOWN_DATA.rx_metadata.rx_datarate     = RX_SESSION_PARAM_CURRENT->rx_data_rate;
                 RX_DOWN_DATA.rx_metadata.rx_frequency_hz = RX_SESSION_PARAM_CURRENT->rx_frequency;
-                RX_DOWN_DATA.rx_metadata.rx_window       = RECEIVE_ON_RXB + ( uint8_t ) ping_slot_obj->rx_session_index;
+                RX_DOWN_DATA.rx_metadata.rx_window       =
+                    lr1mac_rx_session_window( RECEIVE_ON_RXB, ping_slot_obj->rx_session_index );
 
                 ping_slot_obj->push_callback( ping_slot_obj->push_context );
             }
@@ -730,6 +842,42 @@ smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_get_session_status( smtc_p
 
     return SMTC_MC_RC_OK;
 }
+
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_set_listen_ratio( smtc_ping_slot_t* ping_slot_obj,
+                                                                        uint8_t mc_group_id, uint8_t listen_ratio )
+{
+    // Check if multicast group id is in acceptable range
+    if( mc_group_id > ( LR1MAC_MC_NUMBER_OF_SESSION - 1 ) )
+    {
+        return SMTC_MC_RC_ERROR_BAD_ID;
+    }
+
+    if( listen_ratio == 0 )
+    {
+        return SMTC_MC_RC_ERROR_PARAM;
+    }
+
+    // Applied from the next ping slot of the session
+    ping_slot_obj->listen_ratio[mc_group_id + 1] = listen_ratio;
+
+    return SMTC_MC_RC_OK;
+}
+
+smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_get_listen_ratio( smtc_ping_slot_t* ping_slot_obj,
+                                                                        uint8_t mc_group_id, uint8_t* listen_ratio )
+{
+    // Check if multicast group id is in acceptable range
+    if( mc_group_id > ( LR1MAC_MC_NUMBER_OF_SESSION - 1 ) )
+    {
+        return SMTC_MC_RC_ERROR_BAD_ID;
+    }
+
+    *listen_ratio = ping_slot_obj->listen_ratio[mc_group_id + 1];
+
+    return SMTC_MC_RC_OK;
+}
+#endif
 #endif
 
 /*
@@ -757,6 +905,19 @@ static int smtc_ping_slot_mac_downlink_check( smtc_ping_slot_t* ping_slot_obj )
         uint32_t dev_addr_tmp = RX_DOWN_DATA.rx_payload[1] + ( RX_DOWN_DATA.rx_payload[2] << 8 ) +
                                 ( RX_DOWN_DATA.rx_payload[3] << 16 ) + ( RX_DOWN_DATA.rx_payload[4] << 24 );
 
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+        // The window may be shared with the slots of other sessions, the DevAddr tells which one was received
+        for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
+        {
+            if( ( ( ( ping_slot_obj->merged_sessions >> i ) & 0x01 ) != 0 ) &&
+                ( RX_SESSION_PARAM[i]->dev_addr == dev_addr_tmp ) )
+            {
+                ping_slot_obj->rx_session_index = i;
+                break;
+            }
+        }
+#endif
+
         if( RX_SESSION_PARAM_CURRENT->dev_addr != dev_addr_tmp )
         {
             status += ERRORLORAWAN;
@@ -794,6 +955,16 @@ static void smtc_ping_slot_compute_next_ping_offset_time( smtc_ping_slot_t* ping
                 ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time +=
                     ( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_period * 30 );
             }
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+            // Step over the slots left out by the listen ratio of the session
+            while( ( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_number > 0 ) &&
+                   ( smtc_ping_slot_is_skipped( ping_slot_obj, i ) == true ) )
+            {
+                ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_number--;
+                ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_offset_time +=
+                    ( ping_slot_obj->rx_session_param[i]->ping_slot_parameters.ping_period * 30 );
+            }
+#endif
         }
     }
 }
@@ -1005,6 +1176,18 @@ static rx_packet_type_t smtc_ping_slot_mac_rx_frame_decode( smtc_ping_slot_t* pi
         RX_SESSION_PARAM_CURRENT->dev_addr, &( RX_DOWN_DATA.rx_metadata.rx_fport ),
         &( RX_DOWN_DATA.rx_metadata.rx_fport_present ), &( ping_slot_obj->rx_fctrl ), ping_slot_obj->rx_fopts );
 
+#if defined( ADD_DL_DEDUP )
+    // Drop the copies of an accepted frame before any crypto
+    if( status == OKLORAWAN )
+    {
+        memcpy( ( uint8_t* ) &mic_in, &RX_DOWN_DATA.rx_payload[RX_DOWN_DATA.rx_payload_size - MICSIZE], MICSIZE );
+        if( lr1mac_dl_dedup_is_duplicate( RX_SESSION_PARAM_CURRENT->dev_addr, fcnt_dwn_tmp, mic_in ) == true )
+        {
+            status = ERRORLORAWAN;
+        }
+    }
+#endif
+
     if( status == OKLORAWAN )
     {
         status = lr1mac_fcnt_dwn_accept( fcnt_dwn_tmp, &fcnt_dwn_stack_tmp );
@@ -1034,6 +1217,12 @@ static rx_packet_type_t smtc_ping_slot_mac_rx_frame_decode( smtc_ping_slot_t* pi
     }
     if( status == OKLORAWAN )
     {
+#if defined( ADD_DL_DEDUP )
+        lr1mac_dl_dedup_add( RX_SESSION_PARAM_CURRENT->dev_addr, fcnt_dwn_tmp, mic_in );
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+        lr1_stack_mac_rx_boost_add_downlink( ping_slot_obj->lr1_mac, RX_SESSION_PARAM_CURRENT->rx_data_rate );
+#endif
         RX_SESSION_PARAM_CURRENT->fcnt_dwn = fcnt_dwn_stack_tmp;
         SMTC_MODEM_HAL_TRACE_WARNING_DEBUG( " fcnt_tmp = %u\n ", RX_SESSION_PARAM_CURRENT->fcnt_dwn );
         ping_slot_obj->lr1_mac->fcnt_dwn = ping_slot_obj->rx_session_param[RX_SESSION_UNICAST]->fcnt_dwn;
@@ -1059,6 +1248,10 @@ static rx_packet_type_t smtc_ping_slot_mac_rx_frame_decode( smtc_ping_slot_t* pi
             if( RX_DOWN_DATA.rx_metadata.rx_fpending_bit == true )
             {
                 RX_SESSION_PARAM_CURRENT->fpending_bit = MULTICAST_FPENDING;
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+                // More data is coming, listen all the slots of the session until the next beacon
+                ping_slot_obj->listen_all[ping_slot_obj->rx_session_index] = true;
+#endif
             }
             else
             {
@@ -1192,18 +1385,117 @@ static uint32_t smtc_ping_slot_compute_downlink_toa( lr1_stack_mac_t* lr1_mac, u
     return toa;
 }
 
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+static bool smtc_ping_slot_is_skipped( smtc_ping_slot_t* ping_slot_obj, rx_session_type_t session )
+{
+    const uint8_t listen_ratio = ping_slot_obj->listen_ratio[session];
+
+    if( ( listen_ratio <= 1 ) || ( ping_slot_obj->listen_all[session] == true ) )
+    {
+        return false;
+    }
+
+    // Slots are numbered from the GPS epoch so that the server can find the listened ones from the beacon time
+    const uint16_t ping_nb = 1 << ( 7 - RX_SESSION_PARAM[session]->ping_slot_periodicity );
+    const uint32_t slot    = ( ping_slot_obj->beacon_period_index * ping_nb ) +
+                          ( ping_nb - RX_SESSION_PARAM[session]->ping_slot_parameters.ping_number );
+
+    return ( slot % listen_ratio ) != ( RX_SESSION_PARAM[session]->dev_addr % listen_ratio );
+}
+
+static uint32_t smtc_ping_slot_merge_sessions( smtc_ping_slot_t* ping_slot_obj, uint32_t freq, uint32_t timestamp_rtc )
+{
+    const rx_session_type_t current        = ping_slot_obj->rx_session_index;
+    const uint8_t           dr             = RX_SESSION_PARAM_CURRENT->rx_data_rate;
+    const uint16_t          window_symb    = RX_SESSION_PARAM_CURRENT->rx_window_symb;
+    const uint32_t          window_ms      = smtc_ping_slot_get_duration_timeout_ms( ping_slot_obj, window_symb, dr );
+    const uint32_t          symb_us        = smtc_real_get_symbol_duration_us( ping_slot_obj->lr1_mac->real, dr );
+    const uint32_t          guard_start_ms = ping_slot_obj->next_beacon_timestamp - ping_slot_obj->beacon_guard_ms;
+    uint32_t                first_ms       = RX_SESSION_PARAM_CURRENT->ping_slot_parameters.ping_offset_time;
+    uint32_t                last_ms        = first_ms;
+
+    ping_slot_obj->merged_sessions = 1 << current;
+
+    for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_CLASS_B_SESSION; i++ )
+    {
+        if( ( i == current ) || ( RX_SESSION_PARAM[i]->enabled == false ) || ( RX_SESSION_PARAM[i]->rx_data_rate != dr ) )
+        {
+            continue;
+        }
+
+        // The slot must be in future, before the beacon guard and overlap the shared window
+        const uint32_t offset_ms = RX_SESSION_PARAM[i]->ping_slot_parameters.ping_offset_time;
+        if( ( ( int32_t ) ( offset_ms - timestamp_rtc ) <= 0 ) || ( ( int32_t ) ( offset_ms - guard_start_ms ) >= 0 ) ||
+            ( ( int32_t ) ( offset_ms + window_ms - first_ms ) < 0 ) ||
+            ( ( int32_t ) ( offset_ms - ( last_ms + window_ms ) ) > 0 ) )
+        {
+            continue;
+        }
+
+        uint32_t session_freq = RX_SESSION_PARAM[i]->rx_frequency;
+        if( session_freq == 0 )
+        {
+#if defined( ADD_CLASS_B_PING_SLOT_SCHEDULE )
+            session_freq = RX_SESSION_PARAM[i]->ping_slot_parameters.ping_slot_freq_hz;
+#else
+            uint32_t seconds_since_epoch;
+            uint32_t fractional_second;
+            lr1mac_core_convert_rtc_to_gps_epoch_time( ping_slot_obj->lr1_mac, offset_ms, &seconds_since_epoch,
+                                                       &fractional_second );
+            session_freq = smtc_real_get_ping_slot_frequency( ping_slot_obj->lr1_mac->real, seconds_since_epoch,
+                                                              RX_SESSION_PARAM[i]->dev_addr );
+#endif
+        }
+        if( session_freq != freq )
+        {
+            continue;
+        }
+
+        const bool     is_first    = ( int32_t ) ( offset_ms - first_ms ) < 0;
+        const uint32_t new_first   = ( is_first == true ) ? offset_ms : first_ms;
+        const uint32_t new_last    = ( ( int32_t ) ( offset_ms - last_ms ) > 0 ) ? offset_ms : last_ms;
+        const uint32_t merged_symb = ( ( ( new_last - new_first ) * 1000 ) + symb_us - 1 ) / symb_us;
+        if( ( window_symb + merged_symb ) > PING_SLOT_MERGE_MAX_WINDOW_SYMB )
+        {
+            continue;
+        }
+
+        first_ms = new_first;
+        last_ms  = new_last;
+        ping_slot_obj->merged_sessions |= 1 << i;
+        if( is_first == true )
+        {
+            ping_slot_obj->rx_session_index = i;
+        }
+    }
+
+    if( last_ms != first_ms )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "Ping slot sessions 0x%x share one window of %u ms\n",
+                                           ping_slot_obj->merged_sessions, last_ms - first_ms + window_ms );
+    }
+
+    // The window opens for the first slot and lasts until the end of the window of the last one
+    RX_SESSION_PARAM_CURRENT->rx_window_symb =
+        window_symb + ( ( ( ( last_ms - first_ms ) * 1000 ) + symb_us - 1 ) / symb_us );
+
+    return last_ms - first_ms;
+}
+#endif
+
 static void ping_slot_mac_rx_lora_launch_callback_for_rp( void* rp_void )
 {
     radio_planner_t* rp = ( radio_planner_t* ) rp_void;
     uint8_t          id = rp->radio_task_id;
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_lora( rp->radio, &rp->radio_params[id].rx.lora ) == RAL_STATUS_OK );
+#if defined( ADD_RX_BOOST_POLICY )
+    lr1_stack_mac_rx_boost_apply( rp );
+#endif
     SMTC_MODEM_HAL_PANIC_ON_FAILURE(
         ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_HDR_ERROR |
                                                          RAL_IRQ_RX_CRC_ERROR ) == RAL_STATUS_OK );
     // Wait the exact time
-    while( ( int32_t ) ( rp->tasks[id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
-    {
-    }
+    rp_task_wait_start_time( rp, id );
     smtc_modem_hal_start_radio_tcxo( );
     smtc_modem_hal_set_ant_switch( false );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rx( &( rp->radio->ral ), rp->radio_params[id].rx.timeout_in_ms ) ==
@@ -61,6 +61,16 @@ extern "C" {
 #define MIN_PING_SLOT_WINDOW_SYMB 6
 #define MAX_PING_SLOT_WINDOW_MS 500
 #define RX_BEACON_TIMESTAMP_ERROR 0
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+#ifndef PING_SLOT_PLL_RESIDUAL_PPM
+#define PING_SLOT_PLL_RESIDUAL_PPM 5  // Error of the beacon period measured by the pll (1 ms step over 128 s)
+#endif
+#endif
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+#ifndef PING_SLOT_MERGE_MAX_WINDOW_SYMB
+#define PING_SLOT_MERGE_MAX_WINDOW_SYMB 255  // Longest window shared by overlapping slots (radio symbol timeout)
+#endif
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -133,6 +143,16 @@ typedef struct smtc_ping_slot_s
     uint8_t  rx_fopts_length;
     uint32_t last_valid_rx_beacon_ms;
     uint32_t last_valid_rx_ping_slot_toa;
+#if defined( ADD_CLASS_B_PLL_PING_SLOT )
+    bool     beacon_pll_locked;     // Beacon pll is locked, the slots follow its period
+    uint32_t beacon_pll_period_ms;  // Beacon period measured by the pll with the local clock
+#endif
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+    uint8_t  listen_ratio[LR1MAC_NUMBER_OF_CLASS_B_SESSION];  // Listen one slot out of n, 1 to listen all the slots
+    bool     listen_all[LR1MAC_NUMBER_OF_CLASS_B_SESSION];    // Pending data, all the slots until the next beacon
+    uint32_t beacon_period_index;                             // Number of beacon periods since the GPS epoch
+    uint8_t  merged_sessions;  // Bitmask of the sessions sharing the window of the current slot
+#endif
 
     uint32_t last_toa;  // Last downlink Time On Air
 
@@ -268,6 +288,34 @@ smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_get_session_status( smtc_p
                                                                           uint8_t mc_group_id, bool* is_session_started,
                                                                           bool* waiting_beacon_to_start, uint32_t* freq,
                                                                           uint8_t* dr, uint8_t* ping_slot_periodicity );
+
+#if defined( ADD_CLASS_B_SELECTIVE_PING_SLOT )
+/**
+ * @brief Set the listen ratio of a ping slot multicast session
+ *
+ * @remark The session listens the slots whose number since the GPS epoch modulo listen_ratio equals its DevAddr modulo
+ *         listen_ratio, the server sends in the same slots. All the slots are listened until the next beacon after a
+ *         frame with the FPending bit set
+ *
+ * @param [in,out] ping_slot_obj    // Ping slot object
+ * @param [in] mc_group_id          // multicast group ID
+ * @param [in] listen_ratio         // Listen one slot out of listen_ratio, 1 to listen all the slots
+ * @return smtc_multicast_config_rc_t
+ */
+smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_set_listen_ratio( smtc_ping_slot_t* ping_slot_obj,
+                                                                        uint8_t mc_group_id, uint8_t listen_ratio );
+
+/**
+ * @brief Get the listen ratio of a ping slot multicast session
+ *
+ * @param [in] ping_slot_obj        // Ping slot object
+ * @param [in] mc_group_id          // multicast group ID
+ * @param [out] listen_ratio        // Listen one slot out of listen_ratio
+ * @return smtc_multicast_config_rc_t
+ */
+smtc_multicast_config_rc_t smtc_ping_slot_multicast_b_get_listen_ratio( smtc_ping_slot_t* ping_slot_obj,
+                                                                        uint8_t mc_group_id, uint8_t* listen_ratio );
+#endif
 #endif  // SMTC_MULTICAST
 /*
  * -----------------------------------------------------------------------------
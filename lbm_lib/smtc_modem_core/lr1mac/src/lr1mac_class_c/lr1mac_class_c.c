@@ -87,10 +87,15 @@
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
-static rx_packet_type_t lr1mac_class_c_mac_rx_frame_decode( lr1mac_class_c_t* class_c_obj );
-static void             lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj );
-static int              lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c_obj );
-static void             lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj );
+static rx_packet_type_t  lr1mac_class_c_mac_rx_frame_decode( lr1mac_class_c_t* class_c_obj );
+static void              lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj );
+static int               lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c_obj );
+static void              lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj );
+static void              lr1mac_class_c_update_lookup( lr1mac_class_c_t* class_c_obj );
+static rx_session_type_t lr1mac_class_c_lookup_rx_session( lr1mac_class_c_t* class_c_obj, uint32_t dev_addr );
+#if defined( ADD_CLASS_C_LOW_POWER )
+static void lr1mac_class_c_low_power_launch_callback_for_rp( void* rp_void );
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -174,6 +179,24 @@ bool lr1mac_class_c_is_running( lr1mac_class_c_t* class_c_obj )
     return class_c_obj->started;
 }
 
+#if defined( ADD_CLASS_C_LOW_POWER )
+void lr1mac_class_c_set_low_power( lr1mac_class_c_t* class_c_obj, uint16_t preamble_len_symb )
+{
+    class_c_obj->low_power_preamble_symb = preamble_len_symb;
+
+    if( class_c_obj->started == true )
+    {
+        // Abort current reception (will be automatically restarted with the new preamble in rp abort callback)
+        rp_task_abort( class_c_obj->rp, class_c_obj->class_c_id4rp );
+    }
+}
+
+uint16_t lr1mac_class_c_get_low_power( lr1mac_class_c_t* class_c_obj )
+{
+    return class_c_obj->low_power_preamble_symb;
+}
+#endif
+
 void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
 {
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "class_c_obj START (%d)\n", class_c_obj->started );
@@ -206,6 +229,7 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
     {
         SMTC_MODEM_HAL_PANIC( "no RxC session enabled\n" );
     }
+    lr1mac_class_c_update_lookup( class_c_obj );
 
     rp_radio_params_t rp_radio_params = { 0 };
     rp_radio_params.rx.timeout_in_ms  = 120000;
@@ -242,6 +266,26 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
         lora_param.mod_params.bw   = ( ral_lora_bw_t ) bw;
         lora_param.mod_params.ldro = ral_compute_lora_ldro( lora_param.mod_params.sf, lora_param.mod_params.bw );
 
+#if defined( ADD_CLASS_C_LOW_POWER )
+        // Wake up every (preamble - 2 x rx) symbols so that a listen window always falls entirely in a preamble
+        class_c_obj->low_power_sleep_ms = 0;
+        if( class_c_obj->low_power_preamble_symb > ( 2 * LR1MAC_CLASS_C_LOW_POWER_RX_SYMB ) )
+        {
+            uint32_t symb_us = smtc_real_get_symbol_duration_us( class_c_obj->lr1_mac->real,
+                                                                 RX_SESSION_PARAM_CURRENT->rx_data_rate );
+            uint32_t sleep_us =
+                ( class_c_obj->low_power_preamble_symb - ( 2 * LR1MAC_CLASS_C_LOW_POWER_RX_SYMB ) ) * symb_us;
+
+            class_c_obj->low_power_rx_ms = ( ( LR1MAC_CLASS_C_LOW_POWER_RX_SYMB * symb_us ) + 999 ) / 1000;
+            // Keep 1 ms margin for the radio wake-up
+            class_c_obj->low_power_sleep_ms = ( sleep_us > 2000 ) ? ( sleep_us / 1000 ) - 1 : 0;
+        }
+        if( class_c_obj->low_power_sleep_ms > 0 )
+        {
+            lora_param.pkt_params.preamble_len_in_symb = class_c_obj->low_power_preamble_symb;
+        }
+#endif
+
         rp_radio_params.pkt_type = RAL_PKT_TYPE_LORA;
         rp_radio_params.rx.lora  = lora_param;
     }
@@ -289,6 +333,12 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
     {
         rp_task.type                  = RP_TASK_TYPE_RX_LORA;
         rp_task.launch_task_callbacks = lr1_stack_mac_rx_lora_launch_callback_for_rp;
+#if defined( ADD_CLASS_C_LOW_POWER )
+        if( class_c_obj->low_power_sleep_ms > 0 )
+        {
+            rp_task.launch_task_callbacks = lr1mac_class_c_low_power_launch_callback_for_rp;
+        }
+#endif
     }
     else
     {
@@ -296,6 +346,25 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
         rp_task.launch_task_callbacks = lr1_stack_mac_rx_gfsk_launch_callback_for_rp;
     }
 
+#if defined( ADD_RP_RX_CONTINUOUS )
+    // The radio keeps receiving between downlinks, the task only ends when aborted (class A, multicast change, stop)
+    rp_task.rx_continuous = true;
+#if defined( ADD_CLASS_C_LOW_POWER )
+    if( class_c_obj->low_power_sleep_ms > 0 )
+    {
+        rp_task.rx_continuous = false;  // The radio duty cycle ends on the first packet
+    }
+#endif
+    if( rp_task.rx_continuous == true )
+    {
+        rp_radio_params.rx.timeout_in_ms = RAL_RX_TIMEOUT_CONTINUOUS_MODE;
+    }
+#endif
+
+#if defined( ADD_RX_BOOST_POLICY )
+    rp_radio_params.rx.rx_boosted = lr1_stack_mac_rx_boost_is_needed( class_c_obj->lr1_mac );
+#endif
+
     if( rp_task_enqueue( class_c_obj->rp, &rp_task, class_c_obj->lr1_mac->rx_down_data.rx_payload, 255,
                          &rp_radio_params ) != RP_HOOK_STATUS_OK )
     {
@@ -307,6 +376,38 @@ void lr1mac_class_c_launch( lr1mac_class_c_t* class_c_obj )
     }
 }
 
+#if defined( ADD_CLASS_C_LOW_POWER )
+static void lr1mac_class_c_low_power_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t*  rp          = ( radio_planner_t* ) rp_void;
+    uint8_t           id          = rp->radio_task_id;
+    lr1mac_class_c_t* class_c_obj = ( lr1mac_class_c_t* ) rp->hooks[id];
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_lora( rp->radio, &rp->radio_params[id].rx.lora ) == RAL_STATUS_OK );
+#if defined( ADD_RX_BOOST_POLICY )
+    lr1_stack_mac_rx_boost_apply( rp );
+#endif
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_HDR_ERROR |
+                                                         RAL_IRQ_RX_CRC_ERROR ) == RAL_STATUS_OK );
+    // Wait the exact expected time (ie target - tcxo startup delay)
+    rp_task_wait_start_time( rp, id );
+    // At this time only tcxo startup delay is remaining
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( false );
+
+    ral_status_t status = ral_set_rx_duty_cycle( &( rp->radio->ral ), class_c_obj->low_power_rx_ms,
+                                                 class_c_obj->low_power_sleep_ms );
+    if( status == RAL_STATUS_UNSUPPORTED_FEATURE )
+    {
+        // No hardware duty cycle on this radio: the longer preamble is still received continuously
+        status = ral_set_rx( &( rp->radio->ral ), rp->radio_params[id].rx.timeout_in_ms );
+    }
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( status == RAL_STATUS_OK );
+    rp_stats_set_rx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+}
+#endif
+
 static void lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj )
 {
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "%s\n", __func__ );
@@ -322,6 +423,12 @@ static void lr1mac_class_c_rp_callback( lr1mac_class_c_t* class_c_obj )
         SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "--> %d\n", rp_status );
     }
 
+#if defined( ADD_RP_RX_CONTINUOUS )
+    if( class_c_obj->rp->tasks[class_c_obj->class_c_id4rp].state == RP_TASK_STATE_RUNNING )
+    {
+        return;  // Continuous reception still on going
+    }
+#endif
     if( class_c_obj->started == true )
     {
         lr1mac_class_c_launch( class_c_obj );
@@ -393,7 +500,7 @@ void lr1mac_class_c_mac_rp_callback( lr1mac_class_c_t* class_c_obj )
                 class_c_obj->lr1_mac->rx_down_data.rx_metadata.rx_frequency_hz = RX_SESSION_PARAM_CURRENT->rx_frequency;
                 // take also multicast rx in count in window type
                 class_c_obj->lr1_mac->rx_down_data.rx_metadata.rx_window =
-                    RECEIVE_ON_RXC + ( uint8_t ) class_c_obj->rx_session_index;
+                    lr1mac_rx_session_window( RECEIVE_ON_RXC, class_c_obj->rx_session_index );
 
                 class_c_obj->push_callback( class_c_obj->push_context );
             }
@@ -489,6 +596,11 @@ smtc_multicast_config_rc_t lr1mac_class_c_multicast_start_session( lr1mac_class_
         // Abort current continuous reception (will be automatically restarted in rp abort callback)
         rp_task_abort( class_c_obj->rp, class_c_obj->class_c_id4rp );
     }
+    else
+    {
+        // Same RF parameters: the running reception also receives this session
+        lr1mac_class_c_update_lookup( class_c_obj );
+    }
 
     return SMTC_MC_RC_OK;
 }
@@ -534,7 +646,8 @@ smtc_multicast_config_rc_t lr1mac_class_c_multicast_stop_session( lr1mac_class_c
     }
     else
     {
-        // At least 1 multicast session is still active, do nothing
+        // At least 1 multicast session is still active, the running reception goes on without this session
+        lr1mac_class_c_update_lookup( class_c_obj );
     }
     return SMTC_MC_RC_OK;
 }
@@ -577,6 +690,58 @@ smtc_multicast_config_rc_t lr1mac_class_c_multicast_get_session_status( lr1mac_c
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static void lr1mac_class_c_update_lookup( lr1mac_class_c_t* class_c_obj )
+{
+    class_c_obj->lookup_count = 0;
+
+    // Insertion sort on DevAddr, there are at most LR1MAC_NUMBER_OF_RXC_SESSION entries
+    for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_RXC_SESSION; i++ )
+    {
+        if( class_c_obj->rx_session_param[i]->enabled == false )
+        {
+            continue;
+        }
+
+        uint32_t dev_addr = class_c_obj->rx_session_param[i]->dev_addr;
+        uint8_t  pos      = class_c_obj->lookup_count;
+        while( ( pos > 0 ) && ( class_c_obj->lookup_dev_addr[pos - 1] > dev_addr ) )
+        {
+            class_c_obj->lookup_dev_addr[pos]   = class_c_obj->lookup_dev_addr[pos - 1];
+            class_c_obj->lookup_rx_session[pos] = class_c_obj->lookup_rx_session[pos - 1];
+            pos--;
+        }
+        class_c_obj->lookup_dev_addr[pos]   = dev_addr;
+        class_c_obj->lookup_rx_session[pos] = i;
+        class_c_obj->lookup_count++;
+    }
+}
+
+static rx_session_type_t lr1mac_class_c_lookup_rx_session( lr1mac_class_c_t* class_c_obj, uint32_t dev_addr )
+{
+    uint8_t low  = 0;
+    uint8_t high = class_c_obj->lookup_count;
+
+    // Binary search, the first session with this DevAddr is kept as with the former linear search
+    while( low < high )
+    {
+        uint8_t mid = ( low + high ) / 2;
+        if( class_c_obj->lookup_dev_addr[mid] < dev_addr )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if( ( low < class_c_obj->lookup_count ) && ( class_c_obj->lookup_dev_addr[low] == dev_addr ) )
+    {
+        return class_c_obj->lookup_rx_session[low];
+    }
+    return RX_SESSION_COUNT;
+}
+
 static int lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c_obj )
 {
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "%s\n", __func__ );
@@ -600,15 +765,7 @@ static int lr1mac_class_c_mac_downlink_check_under_it( lr1mac_class_c_t* class_c
                                 ( class_c_obj->lr1_mac->rx_down_data.rx_payload[3] << 16 ) +
                                 ( class_c_obj->lr1_mac->rx_down_data.rx_payload[4] << 24 );
 
-        for( rx_session_type_t i = 0; i < LR1MAC_NUMBER_OF_RXC_SESSION; i++ )
-        {
-            if( ( dev_addr_tmp == class_c_obj->rx_session_param[i]->dev_addr ) &&
-                ( class_c_obj->rx_session_param[i]->enabled == true ) )
-            {
-                class_c_obj->rx_session_index = i;
-                break;
-            }
-        }
+        class_c_obj->rx_session_index = lr1mac_class_c_lookup_rx_session( class_c_obj, dev_addr_tmp );
 
         if( class_c_obj->rx_session_index >= LR1MAC_NUMBER_OF_RXC_SESSION )
         {
@@ -685,6 +842,21 @@ static rx_packet_type_t lr1mac_class_c_mac_rx_frame_decode( lr1mac_class_c_t* cl
         &( class_c_obj->lr1_mac->rx_down_data.rx_metadata.rx_fport_present ), &( class_c_obj->rx_fctrl ),
         class_c_obj->rx_fopts );
 
+#if defined( ADD_DL_DEDUP )
+    // Drop the copies of an accepted frame before any crypto
+    if( status == OKLORAWAN )
+    {
+        memcpy( ( uint8_t* ) &mic_in,
+                &class_c_obj->lr1_mac->rx_down_data
+                     .rx_payload[class_c_obj->lr1_mac->rx_down_data.rx_payload_size - MICSIZE],
+                MICSIZE );
+        if( lr1mac_dl_dedup_is_duplicate( RX_SESSION_PARAM_CURRENT->dev_addr, fcnt_dwn_tmp, mic_in ) == true )
+        {
+            status = ERRORLORAWAN;
+        }
+    }
+#endif
+
     if( status == OKLORAWAN )
     {
         status = lr1mac_fcnt_dwn_accept( fcnt_dwn_tmp, &fcnt_dwn_stack_tmp );
@@ -722,6 +894,13 @@ static rx_packet_type_t lr1mac_class_c_mac_rx_frame_decode( lr1mac_class_c_t* cl
         // class_c_obj->lr1_mac->rx_fpending_bit_current = ( class_c_obj->rx_fctrl >> 4 ) & 0x01;
         // class_c_obj->rx_metadata.rx_fpending_bit      = class_c_obj->lr1_mac->rx_fpending_bit_current;
 
+#if defined( ADD_DL_DEDUP )
+        lr1mac_dl_dedup_add( RX_SESSION_PARAM_CURRENT->dev_addr, fcnt_dwn_tmp, mic_in );
+#endif
+#if defined( ADD_RX_BOOST_POLICY )
+        lr1_stack_mac_rx_boost_add_downlink( class_c_obj->lr1_mac, RX_SESSION_PARAM_CURRENT->rx_data_rate );
+#endif
+
         RX_SESSION_PARAM_CURRENT->fcnt_dwn = fcnt_dwn_stack_tmp;
         class_c_obj->lr1_mac->fcnt_dwn     = class_c_obj->rx_session_param[RX_SESSION_UNICAST]->fcnt_dwn;
 
@@ -66,6 +66,12 @@ extern "C" {
 #define LR1MAC_RCX_MIN_DURATION_MS   20
 #define LR1MAC_NUMBER_OF_RXC_SESSION RX_SESSION_COUNT // Unicast + Multicast
 
+#if defined( ADD_CLASS_C_LOW_POWER )
+#ifndef LR1MAC_CLASS_C_LOW_POWER_RX_SYMB
+#define LR1MAC_CLASS_C_LOW_POWER_RX_SYMB 4  // Symbols listened at each wake-up, sleep lasts the rest of the preamble
+#endif
+#endif
+
 /* clang-format on */
 
 /*
@@ -93,6 +99,11 @@ typedef struct lr1mac_class_c_s
     lr1mac_rx_session_param_t  rx_session_param_unicast;
     lr1mac_rx_session_param_t* rx_session_param[LR1MAC_NUMBER_OF_RXC_SESSION];
 
+    // DevAddr of the enabled Rx sessions in ascending order, with the matching session, to resolve a downlink
+    uint32_t          lookup_dev_addr[LR1MAC_NUMBER_OF_RXC_SESSION];
+    rx_session_type_t lookup_rx_session[LR1MAC_NUMBER_OF_RXC_SESSION];
+    uint8_t           lookup_count;
+
     rx_packet_type_t valid_rx_packet;
 
     uint8_t tx_mtype;
@@ -102,6 +113,11 @@ typedef struct lr1mac_class_c_s
     uint8_t rx_fopts[15];
     uint8_t rx_fopts_length;
 
+#if defined( ADD_CLASS_C_LOW_POWER )
+    uint16_t low_power_preamble_symb;  // Preamble length agreed with the network, 0 for continuous reception
+    uint32_t low_power_rx_ms;          // Duty cycle listen time of the current reception
+    uint32_t low_power_sleep_ms;       // Duty cycle sleep time of the current reception
+#endif
 } lr1mac_class_c_t;
 
 /*
@@ -168,6 +184,28 @@ bool lr1mac_class_c_is_running( lr1mac_class_c_t* class_c_obj );
  */
 void lr1mac_class_c_mac_rp_callback( lr1mac_class_c_t* class_c_obj );
 
+#if defined( ADD_CLASS_C_LOW_POWER )
+/**
+ * @brief Set the preamble length of the duty-cycled class C reception
+ *
+ * @remark The network must send the class C downlinks with this preamble length. The radio listens
+ *         LR1MAC_CLASS_C_LOW_POWER_RX_SYMB symbols and sleeps for the rest of the preamble, so it always wakes up
+ *         during a preamble. The reception stays continuous when the preamble is too short for the radio to sleep.
+ *
+ * @param class_c_obj
+ * @param preamble_len_symb Preamble length in symbols, 0 to go back to continuous reception
+ */
+void lr1mac_class_c_set_low_power( lr1mac_class_c_t* class_c_obj, uint16_t preamble_len_symb );
+
+/**
+ * @brief Get the preamble length of the duty-cycled class C reception
+ *
+ * @param class_c_obj
+ * @return uint16_t Preamble length in symbols, 0 for continuous reception
+ */
+uint16_t lr1mac_class_c_get_low_power( lr1mac_class_c_t* class_c_obj );
+#endif
+
 #if defined( SMTC_MULTICAST )
 /**
  * @brief Start the class C multicast session
@@ -42,9 +42,19 @@
 #include "smtc_modem_hal_dbg_trace.h"
 #include "lr1mac_utilities.h"
 #include "smtc_modem_hal.h"
+#include "modem_core.h"
+#if defined( ADD_SMTC_MAC_JOURNAL )
+#include "mac_journal.h"
+#endif
+#if defined( ADD_SESSION_RESUME )
+#include "smtc_modem_crypto.h"
+#endif
 #include "smtc_real.h"
 #include "smtc_real_defs.h"
 #include "smtc_real_defs_str.h"
+#if defined( ADD_REGION_SNAPSHOT )
+#include "smtc_duty_cycle.h"
+#endif
 
 #include "lr1mac_config.h"
 
@@ -82,16 +92,94 @@ static const char* smtc_name_lr_fhss_cr[] = { "CR 5/6", "CR 2/3", "CR 1/2", "CR
 #define DISABLE_LORAWAN_RX_WINDOWS 0
 #endif
 
+#define LORAWAN_SESSION_NVM_CTX_VERSION ( 1 )
+
+/*
+ *-----------------------------------------------------------------------------------
+ *--- PRIVATE TYPES -----------------------------------------------------------------
+ */
+
+#if defined( ADD_SESSION_RESUME )
+/**
+ * @brief Session stored in CONTEXT_LORAWAN_SESSION to resume it after a reset without a new join
+ *
+ * The session keys are not stored, they are derived again in the secure element from the root keys and the nonces of
+ * the join, key_check tells whether the root keys and the EUIs are still the ones of the session.
+ */
+typedef struct lr1_mac_session_nvm_context_s
+{
+    uint8_t             ctx_version;
+    uint8_t             region;
+    uint16_t            dev_nonce;      // DevNonce of the join request
+    uint8_t             join_nonce[6];  // JoinNonce + NetID of the join accept
+    int8_t              tx_power;
+    uint8_t             tx_data_rate_adr;
+    uint32_t            dev_addr;
+    uint32_t            fcnt_up;  // First uplink frame counter to use after a reset, the previous ones may be used
+    uint32_t            fcnt_dwn;
+    uint32_t            key_check;
+    uint32_t            rx2_frequency;
+    uint32_t            max_duty_cycle_index;
+    uint8_t             rx1_dr_offset;
+    uint8_t             rx2_data_rate;
+    uint8_t             rx1_delay_s;
+    uint8_t             nb_trans;
+    uint8_t             max_erp_dbm;
+    smtc_real_session_t real;
+    uint32_t            crc;  // !! crc MUST be the last field of the structure !!
+} lr1_mac_session_nvm_context_t;
+#endif
+
+#if defined( ADD_REGION_SNAPSHOT )
+/**
+ * @brief Channel state of a region, kept in RAM when leaving the region and restored when switching back to it
+ */
+typedef struct lr1_mac_region_snapshot_s
+{
+    bool                     valid;
+    smtc_real_region_types_t region;
+    uint32_t                 timestamp_s;  // Time of the snapshot, the oldest one is replaced
+#if defined( ADD_FAST_JOIN )
+    uint8_t fast_join_channel;
+#endif
+    smtc_real_session_t real;  // Channel plan, channel masks and data rate distributions
+#if defined( REGION_EU_868 ) || defined( REGION_RU_864 )
+    smtc_dtc_band_t dtc_bands[SMTC_DTC_BANDS_MAX];  // Time on air of the last hour in the duty cycle bands
+    uint8_t         dtc_number_of_bands;
+#endif
+} lr1_mac_region_snapshot_t;
+#endif
+
 /*
  *-----------------------------------------------------------------------------------
  *--- PRIVATE VARIABLES -------------------------------------------------------------
  */
+
+#if defined( ADD_SESSION_RESUME )
+// Shared by the stacks, too large for the stack with the regions of many channels
+static lr1_mac_session_nvm_context_t lr1mac_session_nvm_ctx;
+#endif
+
+#if defined( ADD_REGION_SNAPSHOT )
+static lr1_mac_region_snapshot_t lr1mac_region_snapshots[NUMBER_OF_STACKS][LR1MAC_REGION_SNAPSHOT_NB];
+#endif
 /*
  *-----------------------------------------------------------------------------------
  *--- PRIVATE FUNCTIONS DECLARATION -------------------------------------------------
  */
 static void copy_user_payload( lr1_stack_mac_t* lr1_mac_obj, const uint8_t* data_in, const uint8_t size_in );
 static void lr1mac_mac_update( lr1_stack_mac_t* lr1_mac_obj );
+static void lr1mac_core_context_saved( void* context );
+#if defined( ADD_SESSION_RESUME )
+static uint32_t lr1mac_core_session_key_check( lr1_stack_mac_t* lr1_mac_obj );
+static void     lr1mac_core_session_save( lr1_stack_mac_t* lr1_mac_obj );
+static void     lr1mac_core_session_saved( void* context );
+static void     lr1mac_core_session_invalidate( lr1_stack_mac_t* lr1_mac_obj );
+#endif
+#if defined( ADD_REGION_SNAPSHOT )
+static void lr1mac_core_region_snapshot_save( lr1_stack_mac_t* lr1_mac_obj );
+static void lr1mac_core_region_snapshot_restore( lr1_stack_mac_t* lr1_mac_obj );
+#endif
 /*
  *-----------------------------------------------------------------------------------
  *--- PUBLIC FUNCTIONS DEFINITIONS --------------------------------------------------
@@ -118,6 +206,9 @@ void lr1mac_core_init( lr1_stack_mac_t* lr1_mac_obj, smtc_real_t* real, radio_pl
 
     lr1_stack_mac_init( lr1_mac_obj, activation_mode );
 
+#if defined( ADD_SMTC_MAC_JOURNAL )
+    mac_journal_init( );
+#endif
     status_lorawan_t status = lr1mac_core_context_load( lr1_mac_obj );
 
     if( status == OKLORAWAN )
@@ -195,6 +286,15 @@ lr1mac_states_t lr1mac_core_process( lr1_stack_mac_t* lr1_mac_obj )
         lr1mac_mac_update( lr1_mac_obj );
     }
 
+#if defined( ADD_SESSION_RESUME )
+    // Class B and C downlinks are accepted out of the class A windows, their frame counter is stored here
+    if( ( lr1_mac_obj->join_status == JOINED ) && ( lr1_mac_obj->activation_mode == ACTIVATION_MODE_OTAA ) &&
+        ( lr1_mac_obj->fcnt_dwn != lr1_mac_obj->session_fcnt_dwn ) )
+    {
+        lr1mac_core_session_save( lr1_mac_obj );
+    }
+#endif
+
     switch( lr1_mac_obj->lr1mac_state )
     {
     //**********************************************************************************
@@ -208,6 +308,9 @@ lr1mac_states_t lr1mac_core_process( lr1_stack_mac_t* lr1_mac_obj )
     case LWPSTATE_TX_WAIT:
         SMTC_MODEM_HAL_TRACE_PRINTF( " ." );
         lr1_mac_obj->lr1mac_state = LWPSTATE_SEND;  //@note the frame have already been prepare in Update Mac Layer
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+        lr1_mac_obj->nwk_ans_pending = false;
+#endif
 
         // Break is missing du to the fact that the send is immediatly enqueued
         // Intentional fallthrough
@@ -275,6 +378,13 @@ lr1mac_states_t lr1mac_core_process( lr1_stack_mac_t* lr1_mac_obj )
                 // save devnonce after the end of TX
                 lr1mac_core_context_save( lr1_mac_obj );
             }
+#if defined( ADD_SMTC_MAC_JOURNAL )
+            else if( lr1_mac_obj->join_status == JOINED )
+            {
+                // journal the first frame counter not used yet, a retransmission does not write anything
+                mac_journal_write( lr1_mac_obj->stack_id, MAC_JOURNAL_FCNT_UP, lr1_mac_obj->fcnt_up + 1 );
+            }
+#endif
 
             lr1_stack_mac_update_tx_done( lr1_mac_obj );
 
@@ -307,6 +417,9 @@ lr1mac_states_t lr1mac_core_process( lr1_stack_mac_t* lr1_mac_obj )
     //                                   STATE RX1
     //**********************************************************************************
     case LWPSTATE_RX1:
+        // RX2 is only enqueued in the radio planner once RX1 is over and its frame rejected: a valid RX1 downlink
+        // never leaves a RX2 task to abort, and a frame for another DevAddr is already turned into a RX1 timeout by
+        // lr1_stack_mac_downlink_check_under_it
         if( lr1_mac_obj->radio_process_state == RADIOSTATE_RX_FINISHED )
         {
             if( lr1_mac_obj->rp_planner_status == RP_STATUS_RX_PACKET )
@@ -479,8 +592,21 @@ status_lorawan_t lr1mac_core_join( lr1_stack_mac_t* lr1_mac_obj, uint32_t target
     if( lr1_mac_obj->activation_mode == ACTIVATION_MODE_ABP )
     {
         lr1_mac_obj->join_status = JOINED;
+#if defined( ADD_SMTC_MAC_JOURNAL )
+        // Resume the frame counter of the session instead of restarting from 0
+        uint32_t fcnt_up;
+        if( mac_journal_read( lr1_mac_obj->stack_id, MAC_JOURNAL_FCNT_UP, &fcnt_up ) == true )
+        {
+            lr1_mac_obj->fcnt_up = fcnt_up;
+        }
+#endif
         return OKLORAWAN;
     }
+    if( lr1_mac_obj->nvm_context_save_pending == true )
+    {
+        // The DevNonce of the previous join request must be in non volatile memory before a new one is used
+        modem_context_flush( );
+    }
     uint32_t current_timestamp       = smtc_modem_hal_get_time_in_s( );
     lr1_mac_obj->timestamp_failsafe  = current_timestamp;
     lr1_mac_obj->rtc_target_timer_ms = target_time_ms;
@@ -535,6 +661,13 @@ join_status_t lr1_mac_joined_status_get( lr1_stack_mac_t* lr1_mac_obj )
 /**************************************************/
 void lr1mac_core_join_status_clear( lr1_stack_mac_t* lr1_mac_obj )
 {
+#if defined( ADD_SESSION_RESUME )
+    // Also called at init, a session stored before the reset is only erased when leaving the network
+    if( lr1_mac_obj->join_status != NOT_JOINED )
+    {
+        lr1mac_core_session_invalidate( lr1_mac_obj );
+    }
+#endif
     lr1_mac_obj->join_status = NOT_JOINED;
     lr1mac_core_abort( lr1_mac_obj );
     smtc_real_init_join_snapshot_channel_mask( lr1_mac_obj->real );
@@ -689,6 +822,14 @@ status_lorawan_t lr1mac_core_payload_send( lr1_stack_mac_t* lr1_mac_obj, uint8_t
         lr1_mac_obj->app_payload_size = 0;
     }
 
+#if defined( ADD_SESSION_RESUME )
+    if( lr1_mac_obj->session_save_pending == true )
+    {
+        // The frame counter must be reserved in non volatile memory before it is used
+        modem_context_flush( );
+    }
+#endif
+
     lr1_stack_mac_tx_frame_build( lr1_mac_obj );
     lr1_stack_mac_tx_frame_encrypt( lr1_mac_obj );
 
@@ -697,6 +838,13 @@ status_lorawan_t lr1mac_core_payload_send( lr1_stack_mac_t* lr1_mac_obj, uint8_t
     lr1_mac_obj->rx_down_data.rx_metadata.rx_fport_present = false;
     lr1_mac_obj->nb_trans_cpt                              = lr1_mac_obj->nb_trans;
     lr1_mac_obj->lr1mac_state                              = LWPSTATE_SEND;
+#if defined( ADD_LINK_ADR )
+    // The network sets the number of transmissions with LinkADRReq in STATIC_ADR_MODE, the device in the other modes
+    if( ( packet_type == UNCONF_DATA_UP ) && ( lr1_mac_obj->adr_mode_select != STATIC_ADR_MODE ) )
+    {
+        lr1_mac_obj->nb_trans_cpt = smtc_link_adr_get_nb_trans( &lr1_mac_obj->link_adr, lr1_mac_obj->nb_trans );
+    }
+#endif
 
     return OKLORAWAN;
 }
@@ -709,7 +857,14 @@ status_lorawan_t lr1mac_core_dr_strategy_set( lr1_stack_mac_t* lr1_mac_obj, dr_s
 {
     status_lorawan_t status;
     dr_strategy_t    adr_mode_select_cpy = lr1_mac_obj->adr_mode_select;
-    lr1_mac_obj->adr_mode_select         = adr_mode_select;
+
+#if !defined( ADD_LINK_ADR )
+    if( adr_mode_select == LINK_QUALITY_DR_DISTRIBUTION )
+    {
+        return ERRORLORAWAN;
+    }
+#endif
+    lr1_mac_obj->adr_mode_select = adr_mode_select;
 
     if( adr_mode_select == STATIC_ADR_MODE )
     {
@@ -719,6 +874,12 @@ status_lorawan_t lr1mac_core_dr_strategy_set( lr1_stack_mac_t* lr1_mac_obj, dr_s
     {
         lr1_mac_obj->tx_power = smtc_real_get_default_max_eirp( lr1_mac_obj->real );
     }
+#if defined( ADD_LINK_ADR )
+    if( adr_mode_select == LINK_QUALITY_DR_DISTRIBUTION )
+    {
+        lr1_mac_obj->tx_data_rate_adr = smtc_link_adr_get_datarate( &lr1_mac_obj->link_adr, lr1_mac_obj->real );
+    }
+#endif
 
     smtc_real_set_dr_distribution( lr1_mac_obj->real, adr_mode_select, &lr1_mac_obj->nb_trans );
     status =
@@ -783,12 +944,25 @@ void lr1mac_core_context_save( lr1_stack_mac_t* lr1_mac_obj )
 {
     lr1_mac_nvm_context_t ctx = { 0 };
 
-    smtc_modem_hal_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
-                                    sizeof( ctx ) );
+    modem_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
+                           sizeof( ctx ) );
 
-    if( ( ctx.devnonce != lr1_mac_obj->dev_nonce ) ||
+    bool devnonce_changed = ( ctx.devnonce != lr1_mac_obj->dev_nonce );
+#if defined( ADD_SMTC_MAC_JOURNAL )
+    if( mac_journal_write( lr1_mac_obj->stack_id, MAC_JOURNAL_DEVNONCE, lr1_mac_obj->dev_nonce ) ==
+        MAC_JOURNAL_RC_OK )
+    {
+        // DevNonce is kept in the journal, the context is only rewritten when the other fields change
+        devnonce_changed = false;
+    }
+#endif
+
+    if( ( devnonce_changed == true ) ||
         ( memcmp( ctx.join_nonce, lr1_mac_obj->join_nonce, sizeof( ctx.join_nonce ) ) != 0 ) ||
         ( ctx.certification_enabled != lr1_mac_obj->is_lorawan_modem_certification_enabled ) ||
+#if defined( ADD_FAST_JOIN )
+        ( ctx.join_channel != ( uint8_t ) ( lr1_mac_obj->fast_join_channel + 1 ) ) ||
+#endif
         ( ctx.region != lr1_mac_obj->real->region_type ) )
     {
         ctx.ctx_version = LORAWAN_NVM_CTX_VERSION;
@@ -796,30 +970,40 @@ void lr1mac_core_context_save( lr1_stack_mac_t* lr1_mac_obj )
         memcpy( ctx.join_nonce, lr1_mac_obj->join_nonce, sizeof( ctx.join_nonce ) );
         ctx.certification_enabled = lr1_mac_obj->is_lorawan_modem_certification_enabled;
         ctx.region                = lr1_mac_obj->real->region_type;
+#if defined( ADD_FAST_JOIN )
+        ctx.join_channel = lr1_mac_obj->fast_join_channel + 1;
+#endif
         ctx.crc                   = lr1mac_utilities_crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
 
-        smtc_modem_hal_context_store( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
-                                      sizeof( ctx ) );
-
-        // dummy context reading to ensure context store is done before exiting the function
-        lr1_mac_nvm_context_t dummy_context = { 0 };
-        smtc_modem_hal_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ),
-                                        ( uint8_t* ) &dummy_context, sizeof( dummy_context ) );
+        // Saved right after the join request TX done, the write must not delay the RX windows
+        lr1_mac_obj->nvm_context_save_pending = true;
+        modem_context_store_async( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
+                                   sizeof( ctx ), lr1mac_core_context_saved, lr1_mac_obj );
     }
 }
 
 status_lorawan_t lr1mac_core_context_load( lr1_stack_mac_t* lr1_mac_obj )
 {
     lr1_mac_nvm_context_t ctx = { 0 };
-    smtc_modem_hal_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
-                                    sizeof( ctx ) );
+    modem_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
+                           sizeof( ctx ) );
 
     if( lr1mac_utilities_crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) ) == ctx.crc )
     {
         lr1_mac_obj->dev_nonce = ctx.devnonce;
+#if defined( ADD_SMTC_MAC_JOURNAL )
+        uint32_t devnonce;
+        if( mac_journal_read( lr1_mac_obj->stack_id, MAC_JOURNAL_DEVNONCE, &devnonce ) == true )
+        {
+            lr1_mac_obj->dev_nonce = ( uint16_t ) devnonce;
+        }
+#endif
         memcpy( lr1_mac_obj->join_nonce, ctx.join_nonce, sizeof( lr1_mac_obj->join_nonce ) );
         lr1_mac_obj->is_lorawan_modem_certification_enabled = ctx.certification_enabled;
         lr1_mac_obj->real->region_type                      = ctx.region;
+#if defined( ADD_FAST_JOIN )
+        lr1_mac_obj->fast_join_channel = ctx.join_channel - 1;
+#endif
 
         return OKLORAWAN;
     }
@@ -837,14 +1021,96 @@ void lr1mac_core_context_factory_reset( lr1_stack_mac_t* lr1_mac_obj )
     memset( ctx.join_nonce, 0xFF, sizeof( ctx.join_nonce ) );
     ctx.crc = lr1mac_utilities_crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
 
-    smtc_modem_hal_context_store( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
-                                  sizeof( ctx ) );
+    modem_context_store( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
+                         sizeof( ctx ) );
 
     // dummy context reading to ensure context store is done before exiting the function
     lr1_mac_nvm_context_t dummy_context = { 0 };
-    smtc_modem_hal_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ),
-                                    ( uint8_t* ) &dummy_context, sizeof( dummy_context ) );
+    modem_context_restore( CONTEXT_LORAWAN_STACK, lr1_mac_obj->stack_id * sizeof( ctx ),
+                           ( uint8_t* ) &dummy_context, sizeof( dummy_context ) );
+
+#if defined( ADD_SMTC_MAC_JOURNAL )
+    mac_journal_write( lr1_mac_obj->stack_id, MAC_JOURNAL_DEVNONCE, 0 );
+    mac_journal_write( lr1_mac_obj->stack_id, MAC_JOURNAL_FCNT_UP, 0 );
+#endif
+#if defined( ADD_SESSION_RESUME )
+    lr1mac_core_session_invalidate( lr1_mac_obj );
+#endif
+}
+
+#if defined( ADD_SESSION_RESUME )
+status_lorawan_t lr1mac_core_session_resume( lr1_stack_mac_t* lr1_mac_obj )
+{
+    lr1_mac_session_nvm_context_t* ctx = &lr1mac_session_nvm_ctx;
+
+    if( ( lr1_mac_obj->activation_mode != ACTIVATION_MODE_OTAA ) || ( lr1_mac_obj->join_status != NOT_JOINED ) ||
+        ( lr1_mac_obj->lr1mac_state != LWPSTATE_IDLE ) )
+    {
+        return ERRORLORAWAN;
+    }
+
+    modem_context_restore( CONTEXT_LORAWAN_SESSION, lr1_mac_obj->stack_id * sizeof( *ctx ), ( uint8_t* ) ctx,
+                           sizeof( *ctx ) );
+
+    if( ( ctx->ctx_version != LORAWAN_SESSION_NVM_CTX_VERSION ) ||
+        ( lr1mac_utilities_crc( ( uint8_t* ) ctx, sizeof( *ctx ) - sizeof( ctx->crc ) ) != ctx->crc ) ||
+        ( ctx->region != lr1_mac_obj->real->region_type ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "No session to resume in NVM\n" );
+        return ERRORLORAWAN;
+    }
+
+    // The session keys are derived again from the current root keys, then checked against the stored session
+    if( smtc_modem_crypto_derive_skeys( &ctx->join_nonce[0], &ctx->join_nonce[3], ctx->dev_nonce,
+                                        lr1_mac_obj->stack_id ) != SMTC_MODEM_CRYPTO_RC_SUCCESS )
+    {
+        return ERRORLORAWAN;
+    }
+    uint32_t dev_addr     = lr1_mac_obj->dev_addr;
+    lr1_mac_obj->dev_addr = ctx->dev_addr;
+    if( lr1mac_core_session_key_check( lr1_mac_obj ) != ctx->key_check )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "Stored session of other keys or EUIs, not resumed\n" );
+        lr1_mac_obj->dev_addr = dev_addr;
+        return ERRORLORAWAN;
+    }
+
+    lr1_stack_mac_session_init( lr1_mac_obj );
+    smtc_real_config_session( lr1_mac_obj->real );
+    smtc_real_set_session( lr1_mac_obj->real, &ctx->real );
+
+    lr1_mac_obj->fcnt_up = ctx->fcnt_up;
+#if defined( ADD_SMTC_MAC_JOURNAL )
+    uint32_t fcnt_up;
+    if( ( mac_journal_read( lr1_mac_obj->stack_id, MAC_JOURNAL_FCNT_UP, &fcnt_up ) == true ) &&
+        ( fcnt_up > lr1_mac_obj->fcnt_up ) )
+    {
+        lr1_mac_obj->fcnt_up = fcnt_up;
+    }
+#endif
+    lr1_mac_obj->fcnt_dwn             = ctx->fcnt_dwn;
+    lr1_mac_obj->tx_power             = ctx->tx_power;
+    lr1_mac_obj->tx_data_rate_adr     = ctx->tx_data_rate_adr;
+    lr1_mac_obj->rx2_frequency        = ctx->rx2_frequency;
+    lr1_mac_obj->max_duty_cycle_index = ctx->max_duty_cycle_index;
+    lr1_mac_obj->rx1_dr_offset        = ctx->rx1_dr_offset;
+    lr1_mac_obj->rx2_data_rate        = ctx->rx2_data_rate;
+    lr1_mac_obj->rx1_delay_s          = ctx->rx1_delay_s;
+    lr1_mac_obj->nb_trans             = ctx->nb_trans;
+    lr1_mac_obj->max_erp_dbm          = ctx->max_erp_dbm;
+    lr1_mac_obj->session_fcnt_up      = ctx->fcnt_up;
+    lr1_mac_obj->session_key_check    = ctx->key_check;
+    lr1_mac_obj->session_crc          = ctx->crc;
+    lr1_mac_obj->join_status          = JOINED;
+
+    // Reserve the next frame counters before the first uplink
+    lr1mac_core_session_save( lr1_mac_obj );
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Session resumed, DevAddr = %x, fcnt_up = %u\n", lr1_mac_obj->dev_addr,
+                                 lr1_mac_obj->fcnt_up );
+    return OKLORAWAN;
 }
+#endif
 
 /**************************************************/
 /*   LoraWan  lr1mac_core_next_max_payload_length_get  Method     */
@@ -902,8 +1168,33 @@ status_lorawan_t lr1mac_core_set_region( lr1_stack_mac_t* lr1_mac_obj, smtc_real
 {
     if( smtc_real_is_supported_region( region_type ) == SMTC_REAL_STATUS_OK )
     {
+#if defined( ADD_FAST_JOIN )
+        if( region_type != lr1_mac_obj->real->region_type )
+        {
+            lr1_mac_obj->fast_join_channel = SMTC_REAL_NO_JOIN_CHANNEL;
+        }
+#endif
+#if defined( ADD_SESSION_RESUME )
+        if( region_type != lr1_mac_obj->real->region_type )
+        {
+            lr1mac_core_session_invalidate( lr1_mac_obj );
+        }
+#endif
+#if defined( ADD_REGION_SNAPSHOT )
+        const bool region_changed = ( region_type != lr1_mac_obj->real->region_type );
+        if( region_changed == true )
+        {
+            lr1mac_core_region_snapshot_save( lr1_mac_obj );
+        }
+#endif
         lr1_stack_mac_region_init( lr1_mac_obj, region_type );
         lr1_stack_mac_region_config( lr1_mac_obj );
+#if defined( ADD_REGION_SNAPSHOT )
+        if( region_changed == true )
+        {
+            lr1mac_core_region_snapshot_restore( lr1_mac_obj );
+        }
+#endif
         lr1mac_core_context_save( lr1_mac_obj );
 
         return OKLORAWAN;
@@ -1185,12 +1476,25 @@ status_lorawan_t lr1mac_core_update_join_channel( lr1_stack_mac_t* lr1_mac_obj )
 
     smtc_real_get_next_tx_dr( lr1_mac_obj->real, lr1_mac_obj->join_status, &lr1_mac_obj->adr_mode_select,
                               &lr1_mac_obj->tx_data_rate, lr1_mac_obj->tx_data_rate_adr, &lr1_mac_obj->adr_enable );
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+    smtc_real_set_next_tx_toa_ms( lr1_mac_obj->real, lr1_stack_toa_get( lr1_mac_obj ) );
+#endif
+#if defined( ADD_FAST_JOIN )
+    // First join request on the sub-band and datarate of the last accepted join, then the regular sub-band cycle
+    if( ( lr1_mac_obj->retry_join_cpt == 0 ) && ( lr1_mac_obj->fast_join_channel != SMTC_REAL_NO_JOIN_CHANNEL ) )
+    {
+        smtc_real_set_fast_join_channel( lr1_mac_obj->real, lr1_mac_obj->fast_join_channel );
+    }
+#endif
     return ( smtc_real_get_join_next_channel(
         lr1_mac_obj->real, &( lr1_mac_obj->tx_data_rate ), &( lr1_mac_obj->tx_frequency ),
         &( lr1_mac_obj->rx1_frequency ), &( lr1_mac_obj->rx2_frequency ), &( lr1_mac_obj->nb_available_tx_channel ) ) );
 }
 status_lorawan_t lr1mac_core_update_next_tx_channel( lr1_stack_mac_t* lr1_mac_obj )
 {
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+    smtc_real_set_next_tx_toa_ms( lr1_mac_obj->real, lr1_stack_toa_get( lr1_mac_obj ) );
+#endif
     return ( smtc_real_get_next_channel( lr1_mac_obj->real, lr1_mac_obj->tx_data_rate, &( lr1_mac_obj->tx_frequency ),
                                          &( lr1_mac_obj->rx1_frequency ), &( lr1_mac_obj->nb_available_tx_channel ) ) );
 }
@@ -1203,10 +1507,66 @@ void lr1mac_core_set_time_of_nwk_ans( lr1_stack_mac_t* lr1_mac_obj, uint32_t tar
     lr1_mac_obj->rtc_target_timer_ms = target_time;
 }
 
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+status_lorawan_t lr1mac_core_nwk_ans_piggyback( lr1_stack_mac_t* lr1_mac_obj, uint8_t size_in )
+{
+    if( ( lr1_mac_obj->lr1mac_state != LWPSTATE_TX_WAIT ) || ( lr1_mac_obj->nwk_ans_pending == false ) ||
+        ( lr1_mac_obj->nwk_ans_size > sizeof( lr1_mac_obj->tx_fopts_current_data ) ) ||
+        ( smtc_real_is_payload_size_valid( lr1_mac_obj->real, lr1_mac_obj->tx_data_rate, size_in, UP_LINK,
+                                           lr1_mac_obj->nwk_ans_size ) != OKLORAWAN ) )
+    {
+        return ERRORLORAWAN;
+    }
+    // The answer frame was only built, its frame counter is used by the next uplink
+    lr1_mac_obj->tx_fopts_current_length = lr1_mac_obj->nwk_ans_size;
+    memcpy( lr1_mac_obj->tx_fopts_current_data, lr1_mac_obj->nwk_ans, lr1_mac_obj->nwk_ans_size );
+    lr1_mac_obj->nwk_ans_pending = false;
+    lr1_mac_obj->lr1mac_state    = LWPSTATE_IDLE;
+    SMTC_MODEM_HAL_TRACE_PRINTF( "MAC answers (%u bytes) sent in the FOpts of the next uplink\n",
+                                 lr1_mac_obj->nwk_ans_size );
+    return OKLORAWAN;
+}
+#endif
+
 void lr1mac_core_set_next_tx_at_time( lr1_stack_mac_t* lr1_mac_obj, bool is_send_at_time )
 {
     lr1_mac_obj->send_at_time = is_send_at_time;
 }
+
+#if defined( ADD_LINK_ADR )
+bool lr1mac_core_bulk_datarate_set( lr1_stack_mac_t* lr1_mac_obj, uint8_t size_in )
+{
+    uint8_t bulk_dr;
+
+    // The network chooses the datarate in STATIC_ADR_MODE
+    if( ( lr1_mac_obj->join_status != JOINED ) || ( lr1_mac_obj->adr_mode_select == STATIC_ADR_MODE ) ||
+        ( lr1_mac_obj->lr1mac_state != LWPSTATE_IDLE ) || ( lr1_mac_obj->bulk_dr_in_use == true ) ||
+        ( smtc_link_adr_get_bulk_datarate( &lr1_mac_obj->link_adr, lr1_mac_obj->real, &bulk_dr ) == false ) ||
+        ( smtc_real_is_payload_size_valid( lr1_mac_obj->real, bulk_dr, size_in, UP_LINK,
+                                           lr1_mac_obj->tx_fopts_current_length ) != OKLORAWAN ) )
+    {
+        return false;
+    }
+
+    lr1_mac_obj->bulk_fallback_dr    = lr1_mac_obj->tx_data_rate;
+    lr1_mac_obj->bulk_fallback_power = lr1_mac_obj->tx_power;
+    lr1_mac_obj->tx_data_rate        = bulk_dr;
+    lr1_mac_obj->tx_power            = lr1_mac_obj->max_erp_dbm;
+    lr1_mac_obj->bulk_dr_in_use      = true;
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Bulk uplink sent at DR%d\n", bulk_dr );
+    return true;
+}
+
+void lr1mac_core_bulk_datarate_restore( lr1_stack_mac_t* lr1_mac_obj )
+{
+    if( lr1_mac_obj->bulk_dr_in_use == true )
+    {
+        lr1_mac_obj->tx_data_rate   = lr1_mac_obj->bulk_fallback_dr;
+        lr1_mac_obj->tx_power       = lr1_mac_obj->bulk_fallback_power;
+        lr1_mac_obj->bulk_dr_in_use = false;
+    }
+}
+#endif
 void lr1mac_core_set_join_status( lr1_stack_mac_t* lr1_mac_obj, join_status_t join_status )
 {
     lr1_mac_obj->join_status = join_status;
@@ -1236,9 +1596,182 @@ void lr1mac_core_abort( lr1_stack_mac_t* lr1_mac_obj )
     lr1_mac_obj->rx_down_data.stack_id = lr1_mac_obj->stack_id;
     lr1_mac_obj->nb_trans_cpt          = 1;
     lr1_mac_obj->lr1mac_state          = LWPSTATE_IDLE;
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+    lr1_mac_obj->nwk_ans_pending = false;
+#endif
+#if defined( ADD_LINK_ADR )
+    lr1mac_core_bulk_datarate_restore( lr1_mac_obj );
+#endif
     rp_task_abort( lr1_mac_obj->rp, lr1_mac_obj->stack_id4rp );
 }
 
+static void lr1mac_core_context_saved( void* context )
+{
+    ( ( lr1_stack_mac_t* ) context )->nvm_context_save_pending = false;
+}
+
+#if defined( ADD_SESSION_RESUME )
+static uint32_t lr1mac_core_session_key_check( lr1_stack_mac_t* lr1_mac_obj )
+{
+    uint8_t  buffer[( SMTC_SE_EUI_SIZE * 2 ) + MICSIZE];
+    uint32_t mic = 0;
+
+    smtc_secure_element_get_deveui( &buffer[0], lr1_mac_obj->stack_id );
+    smtc_secure_element_get_joineui( &buffer[SMTC_SE_EUI_SIZE], lr1_mac_obj->stack_id );
+
+    // The MIC is appended to the EUIs
+    if( smtc_modem_crypto_compute_and_add_mic( buffer, SMTC_SE_EUI_SIZE * 2, SMTC_SE_NWK_S_ENC_KEY,
+                                               lr1_mac_obj->dev_addr, UP_LINK, 0,
+                                               lr1_mac_obj->stack_id ) == SMTC_MODEM_CRYPTO_RC_SUCCESS )
+    {
+        memcpy( &mic, &buffer[SMTC_SE_EUI_SIZE * 2], MICSIZE );
+    }
+    return mic;
+}
+
+static void lr1mac_core_session_save( lr1_stack_mac_t* lr1_mac_obj )
+{
+    lr1_mac_session_nvm_context_t* ctx = &lr1mac_session_nvm_ctx;
+
+    // Reserve the next frame counters once half of the reserved ones are used, the store has time to be written
+    if( ( lr1_mac_obj->fcnt_up + ( LR1MAC_SESSION_FCNT_UP_LAG / 2 ) ) >= lr1_mac_obj->session_fcnt_up )
+    {
+        lr1_mac_obj->session_fcnt_up = lr1_mac_obj->fcnt_up + LR1MAC_SESSION_FCNT_UP_LAG;
+    }
+    // The downlink frame counter is stored exactly, a reset must not accept a downlink again
+    lr1_mac_obj->session_fcnt_dwn = lr1_mac_obj->fcnt_dwn;
+
+    // Cleared first, the padding bytes are part of the crc
+    memset( ctx, 0, sizeof( *ctx ) );
+    ctx->ctx_version = LORAWAN_SESSION_NVM_CTX_VERSION;
+    ctx->region      = lr1_mac_obj->real->region_type;
+    ctx->dev_nonce   = lr1_mac_obj->dev_nonce;
+    memcpy( ctx->join_nonce, lr1_mac_obj->join_nonce, sizeof( ctx->join_nonce ) );
+    ctx->tx_power             = lr1_mac_obj->tx_power;
+    ctx->tx_data_rate_adr     = lr1_mac_obj->tx_data_rate_adr;
+    ctx->dev_addr             = lr1_mac_obj->dev_addr;
+    ctx->fcnt_up              = lr1_mac_obj->session_fcnt_up;
+    ctx->fcnt_dwn             = lr1_mac_obj->fcnt_dwn;
+    ctx->key_check            = lr1_mac_obj->session_key_check;
+    ctx->rx2_frequency        = lr1_mac_obj->rx2_frequency;
+    ctx->max_duty_cycle_index = lr1_mac_obj->max_duty_cycle_index;
+    ctx->rx1_dr_offset        = lr1_mac_obj->rx1_dr_offset;
+    ctx->rx2_data_rate        = lr1_mac_obj->rx2_data_rate;
+    ctx->rx1_delay_s          = lr1_mac_obj->rx1_delay_s;
+    ctx->nb_trans             = lr1_mac_obj->nb_trans;
+    ctx->max_erp_dbm          = lr1_mac_obj->max_erp_dbm;
+    smtc_real_get_session( lr1_mac_obj->real, &ctx->real );
+    ctx->crc = lr1mac_utilities_crc( ( uint8_t* ) ctx, sizeof( *ctx ) - sizeof( ctx->crc ) );
+
+    // Only written when the session changed: new reserved frame counters, downlink, or MAC command
+    if( ctx->crc != lr1_mac_obj->session_crc )
+    {
+        lr1_mac_obj->session_crc          = ctx->crc;
+        lr1_mac_obj->session_save_pending = true;
+        modem_context_store_async( CONTEXT_LORAWAN_SESSION, lr1_mac_obj->stack_id * sizeof( *ctx ), ( uint8_t* ) ctx,
+                                   sizeof( *ctx ), lr1mac_core_session_saved, lr1_mac_obj );
+    }
+}
+
+static void lr1mac_core_session_saved( void* context )
+{
+    ( ( lr1_stack_mac_t* ) context )->session_save_pending = false;
+}
+
+static void lr1mac_core_session_invalidate( lr1_stack_mac_t* lr1_mac_obj )
+{
+    lr1_mac_session_nvm_context_t* ctx = &lr1mac_session_nvm_ctx;
+
+    lr1_mac_obj->session_crc          = 0;
+    lr1_mac_obj->session_save_pending = false;
+
+    // Only a stored session is erased, to spare the non volatile memory
+    modem_context_restore( CONTEXT_LORAWAN_SESSION, lr1_mac_obj->stack_id * sizeof( *ctx ), ( uint8_t* ) ctx,
+                           sizeof( *ctx ) );
+    if( ctx->ctx_version == LORAWAN_SESSION_NVM_CTX_VERSION )
+    {
+        memset( ctx, 0, sizeof( *ctx ) );
+        modem_context_store( CONTEXT_LORAWAN_SESSION, lr1_mac_obj->stack_id * sizeof( *ctx ), ( uint8_t* ) ctx,
+                             sizeof( *ctx ) );
+    }
+}
+#endif
+
+#if defined( ADD_REGION_SNAPSHOT )
+static void lr1mac_core_region_snapshot_save( lr1_stack_mac_t* lr1_mac_obj )
+{
+    lr1_mac_region_snapshot_t* snapshots = lr1mac_region_snapshots[lr1_mac_obj->stack_id];
+    lr1_mac_region_snapshot_t* snapshot  = &snapshots[0];
+
+    // Replace the snapshot of the region if any, else a free one, else the oldest one
+    for( uint8_t i = 0; i < LR1MAC_REGION_SNAPSHOT_NB; i++ )
+    {
+        if( ( snapshots[i].valid == true ) && ( snapshots[i].region == lr1_mac_obj->real->region_type ) )
+        {
+            snapshot = &snapshots[i];
+            break;
+        }
+        if( ( snapshot->valid == true ) &&
+            ( ( snapshots[i].valid == false ) || ( snapshots[i].timestamp_s < snapshot->timestamp_s ) ) )
+        {
+            snapshot = &snapshots[i];
+        }
+    }
+
+    snapshot->valid       = true;
+    snapshot->region      = lr1_mac_obj->real->region_type;
+    snapshot->timestamp_s = smtc_modem_hal_get_time_in_s( );
+#if defined( ADD_FAST_JOIN )
+    snapshot->fast_join_channel = lr1_mac_obj->fast_join_channel;
+#endif
+    smtc_real_get_session( lr1_mac_obj->real, &snapshot->real );
+#if defined( REGION_EU_868 ) || defined( REGION_RU_864 )
+    // Only the regions configuring the duty cycle bands own their time on air history
+    snapshot->dtc_number_of_bands = 0;
+#if defined( REGION_EU_868 )
+    if( snapshot->region == SMTC_REAL_REGION_EU_868 )
+    {
+        snapshot->dtc_number_of_bands = smtc_duty_cycle_get_bands( snapshot->dtc_bands );
+    }
+#endif
+#if defined( REGION_RU_864 )
+    if( snapshot->region == SMTC_REAL_REGION_RU_864 )
+    {
+        snapshot->dtc_number_of_bands = smtc_duty_cycle_get_bands( snapshot->dtc_bands );
+    }
+#endif
+#endif
+}
+
+static void lr1mac_core_region_snapshot_restore( lr1_stack_mac_t* lr1_mac_obj )
+{
+    lr1_mac_region_snapshot_t* snapshots = lr1mac_region_snapshots[lr1_mac_obj->stack_id];
+
+    for( uint8_t i = 0; i < LR1MAC_REGION_SNAPSHOT_NB; i++ )
+    {
+        lr1_mac_region_snapshot_t* snapshot = &snapshots[i];
+
+        if( ( snapshot->valid == true ) && ( snapshot->region == lr1_mac_obj->real->region_type ) )
+        {
+            SMTC_MODEM_HAL_TRACE_PRINTF( "Restore the channel state of region %s\n",
+                                         smtc_real_region_list_str[snapshot->region] );
+#if defined( ADD_FAST_JOIN )
+            lr1_mac_obj->fast_join_channel = snapshot->fast_join_channel;
+#endif
+            smtc_real_set_session( lr1_mac_obj->real, &snapshot->real );
+#if defined( REGION_EU_868 ) || defined( REGION_RU_864 )
+            // The bands are configured again by the caller with the same limits, the time on air history is kept
+            if( snapshot->dtc_number_of_bands != 0 )
+            {
+                smtc_duty_cycle_set_bands( snapshot->dtc_bands, snapshot->dtc_number_of_bands );
+            }
+#endif
+            return;
+        }
+    }
+}
+#endif
+
 static void lr1mac_mac_update( lr1_stack_mac_t* lr1_mac_obj )
 {
     lr1_mac_obj->radio_process_state = RADIOSTATE_IDLE;
@@ -1261,7 +1794,15 @@ static void lr1mac_mac_update( lr1_stack_mac_t* lr1_mac_obj )
             lr1_mac_obj->tx_data_rate_adr = lr1_mac_obj->tx_data_rate;
             smtc_real_set_dr_distribution( lr1_mac_obj->real, lr1_mac_obj->adr_mode_select_tmp,
                                            &lr1_mac_obj->nb_trans );
+#if defined( ADD_FAST_JOIN )
+            lr1_mac_obj->fast_join_channel = smtc_real_get_join_channel( lr1_mac_obj->real );
+#endif
             lr1mac_core_context_save( lr1_mac_obj );
+#if defined( ADD_SESSION_RESUME )
+            // A new session starts, the frame counters are reserved again from 0 below
+            lr1_mac_obj->session_fcnt_up   = 0;
+            lr1_mac_obj->session_key_check = lr1mac_core_session_key_check( lr1_mac_obj );
+#endif
         }
         else
         {
@@ -1276,6 +1817,13 @@ static void lr1mac_mac_update( lr1_stack_mac_t* lr1_mac_obj )
 
     lr1_stack_mac_update( lr1_mac_obj );
 
+#if defined( ADD_SESSION_RESUME )
+    if( ( lr1_mac_obj->join_status == JOINED ) && ( lr1_mac_obj->activation_mode == ACTIVATION_MODE_OTAA ) )
+    {
+        lr1mac_core_session_save( lr1_mac_obj );
+    }
+#endif
+
     /// If those MAC commands are not acked, set as not requested ///
     if( lr1_mac_obj->link_check_user_req == USER_MAC_REQ_SENT )
     {
@@ -1319,6 +1867,9 @@ static void lr1mac_mac_update( lr1_stack_mac_t* lr1_mac_obj )
         }
         else
         {
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+            lr1_mac_obj->nwk_ans_pending = ( lr1_mac_obj->type_of_ans_to_send == NWKFRAME_TOSEND );
+#endif
             lr1_mac_obj->type_of_ans_to_send = NOFRAME_TOSEND;
             lr1_mac_obj->rtc_target_timer_ms =
                 smtc_modem_hal_get_time_in_ms( ) + smtc_modem_hal_get_random_nb_in_range( 1000, 3000 );
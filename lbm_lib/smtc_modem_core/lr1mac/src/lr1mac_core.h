@@ -91,6 +91,18 @@ status_lorawan_t lr1mac_core_join( lr1_stack_mac_t* lr1_mac_obj, uint32_t target
  */
 void lr1mac_core_join_status_clear( lr1_stack_mac_t* lr1_mac_obj );
 
+#if defined( ADD_SESSION_RESUME )
+/**
+ * @brief Resume the OTAA session stored before a reset instead of joining again
+ *
+ * @remark The session is stored after each uplink cycle and erased when leaving the network or changing the region
+ *
+ * @param lr1_mac_obj
+ * @return status_lorawan_t OKLORAWAN if the stack is joined with the stored session
+ */
+status_lorawan_t lr1mac_core_session_resume( lr1_stack_mac_t* lr1_mac_obj );
+#endif
+
 /**
  * @brief abort LoRaWAN task
  * @remark Tx, Rx will be aborted
@@ -654,6 +666,20 @@ uint32_t lr1mac_core_get_time_of_nwk_ans( lr1_stack_mac_t* lr1_mac_obj );
  * @param [in] uint32_t  target time of next transmission in ms
  */
 void lr1mac_core_set_time_of_nwk_ans( lr1_stack_mac_t* lr1_mac_obj, uint32_t target_time );
+
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+/**
+ * @brief Move the MAC answers of the frame waiting to be sent by the stack into the FOpts of the next uplink
+ *
+ * @remark The stand-alone answer frame is dropped and the stack goes back to idle, only if the waiting frame is not a
+ * retransmission, the answers fit in FOpts and the next uplink of size_in bytes still fits at the current datarate
+ *
+ * @param [in] lr1_mac_obj
+ * @param [in] size_in     Application payload size of the next uplink
+ * @return status_lorawan_t OKLORAWAN if the answers will be sent in the next uplink
+ */
+status_lorawan_t lr1mac_core_nwk_ans_piggyback( lr1_stack_mac_t* lr1_mac_obj, uint8_t size_in );
+#endif
 /**
  * @brief update the next transmission to start at time or asap;
  *
@@ -661,6 +687,24 @@ void lr1mac_core_set_time_of_nwk_ans( lr1_stack_mac_t* lr1_mac_obj, uint32_t tar
  * @param [in] bool  is_send_at_time :  true to transmit at time
  */
 void lr1mac_core_set_next_tx_at_time(  lr1_stack_mac_t* lr1_mac_obj, bool is_send_at_time );
+#if defined( ADD_LINK_ADR )
+/**
+ * @brief Move the next uplink to the FSK datarate of the bulk mode if the link allows it
+ * @remark Only out of STATIC_ADR_MODE, the uplink is sent at the maximum EIRP. The datarate of the ADR profile is used
+ * again by the following uplink.
+ *
+ * @param [in] lr1_mac_obj
+ * @param [in] size_in     Application payload size of the next uplink
+ * @return bool            true if the datarate was changed
+ */
+bool lr1mac_core_bulk_datarate_set( lr1_stack_mac_t* lr1_mac_obj, uint8_t size_in );
+/**
+ * @brief Go back to the datarate and the transmit power of the ADR profile if the bulk uplink is not sent
+ *
+ * @param [in] lr1_mac_obj
+ */
+void lr1mac_core_bulk_datarate_restore( lr1_stack_mac_t* lr1_mac_obj );
+#endif
 /**
  * @brief update the internal join_status;
  *
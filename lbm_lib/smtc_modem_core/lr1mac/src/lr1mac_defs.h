@@ -131,6 +131,28 @@ extern "C" {
 
 // #define MAX_FCNT_GAP 16384
 
+// Number of multicast groups, 4 by default (groups above #3 need the soft secure element)
+#if !defined( LR1MAC_MC_NUMBER_OF_SESSION )
+#define LR1MAC_MC_NUMBER_OF_SESSION                        (4)
+#elif ( LR1MAC_MC_NUMBER_OF_SESSION > 8 )
+#error "LR1MAC_MC_NUMBER_OF_SESSION MAX is 8"
+#endif
+
+// Uplink frame counters reserved by each store of the session context (LBM_SESSION_RESUME): a session resumed after a
+// reset skips at most this number of frame counters
+#if !defined( LR1MAC_SESSION_FCNT_UP_LAG )
+#define LR1MAC_SESSION_FCNT_UP_LAG                         (32)
+#elif ( LR1MAC_SESSION_FCNT_UP_LAG < 2 )
+#error "LR1MAC_SESSION_FCNT_UP_LAG MIN is 2"
+#endif
+
+// Regions of which the channel state is kept by each stack to switch back to them quickly (LBM_REGION_SNAPSHOT)
+#if !defined( LR1MAC_REGION_SNAPSHOT_NB )
+#define LR1MAC_REGION_SNAPSHOT_NB                          (2)
+#elif ( LR1MAC_REGION_SNAPSHOT_NB < 1 )
+#error "LR1MAC_REGION_SNAPSHOT_NB MIN is 1"
+#endif
+
 /* clang-format on */
 
 /*
@@ -306,6 +328,7 @@ typedef enum dr_strategy_e
     USER_DR_DISTRIBUTION,              // User distribution
     JOIN_DR_DISTRIBUTION,              // Dedicated for Join requests
     JOIN_DR_DISTRIBUTION_LONG_TERM,    // Dedicated for Join requests when join duty cycle = 1/10000
+    LINK_QUALITY_DR_DISTRIBUTION,      // Datarate chosen by the device from the measured link margin
     UNKNOWN_DR,
 } dr_strategy_t;
 
@@ -387,12 +410,11 @@ typedef enum rx_session_type_e
 {
     RX_SESSION_UNICAST,
 #if defined( SMTC_MULTICAST )
-    RX_SESSION_MULTICAST_G0,
-    RX_SESSION_MULTICAST_G1,
-    RX_SESSION_MULTICAST_G2,
-    RX_SESSION_MULTICAST_G3,
-#endif
+    RX_SESSION_MULTICAST_G0,  // Multicast group n is RX_SESSION_MULTICAST_G0 + n
+    RX_SESSION_COUNT = RX_SESSION_MULTICAST_G0 + LR1MAC_MC_NUMBER_OF_SESSION,
+#else
     RX_SESSION_COUNT,
+#endif
 } rx_session_type_t;
 
 typedef enum user_mac_req_status_e
@@ -438,6 +460,16 @@ typedef enum receive_win_s
 #if defined( ADD_RELAY_TX )
     RECEIVE_ON_RXR = 14,
 #endif
+#if defined( SMTC_MULTICAST ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
+    RECEIVE_ON_RXC_MC_GRP4 = 15,
+    RECEIVE_ON_RXC_MC_GRP5 = 16,
+    RECEIVE_ON_RXC_MC_GRP6 = 17,
+    RECEIVE_ON_RXC_MC_GRP7 = 18,
+    RECEIVE_ON_RXB_MC_GRP4 = 19,
+    RECEIVE_ON_RXB_MC_GRP5 = 20,
+    RECEIVE_ON_RXB_MC_GRP6 = 21,
+    RECEIVE_ON_RXB_MC_GRP7 = 22,
+#endif
 } receive_win_t;
 
 typedef struct lr1mac_down_metadata_s
@@ -461,6 +493,9 @@ typedef struct smtc_ping_slot_parameters_e
     uint16_t ping_period;  // Period of the end-device receiver wake-up expressed in number of slots:
     uint8_t  ping_number;  // Number of ping slot in a beacon window
     uint32_t ping_offset_time;
+#if defined( ADD_CLASS_B_PING_SLOT_SCHEDULE )
+    uint32_t ping_slot_freq_hz;  // Hopping frequency of the ping slots of the current beacon period
+#endif
 } smtc_ping_slot_parameters_t;
 
 typedef struct lr1mac_rx_session_param_s
@@ -494,7 +529,8 @@ typedef struct lr1_mac_nvm_context_s
     uint8_t  join_nonce[6];
     uint8_t  certification_enabled;
     uint8_t  region;
-    uint8_t  rfu[17];  // bytes reserved for future used
+    uint8_t  join_channel;  // channel of the last accepted join + 1, 0 if unknown (LBM_FAST_JOIN)
+    uint8_t  rfu[16];       // bytes reserved for future used
     uint32_t crc;      // !! crc MUST be the last field of the structure !!
 } lr1_mac_nvm_context_t;
 
@@ -42,23 +42,36 @@
 
 #include "lr1mac_utilities.h"
 #include "lr1mac_defs.h"
+#include "modem_crc.h"
 
 #include "smtc_modem_hal.h"
 #include "smtc_modem_hal_dbg_trace.h"
 
+#if defined( ADD_DL_DEDUP )
+typedef struct lr1mac_dl_dedup_entry_s
+{
+    uint32_t dev_addr;
+    uint32_t mic;
+    uint16_t fcnt_dwn;
+    bool     valid;
+} lr1mac_dl_dedup_entry_t;
+
+static lr1mac_dl_dedup_entry_t lr1mac_dl_dedup_window[LR1MAC_DL_DEDUP_WINDOW_SIZE];
+
+static uint8_t lr1mac_dl_dedup_index( uint32_t dev_addr, uint16_t fcnt_dwn, uint32_t mic )
+{
+    // The MIC already spreads the frames of one DevAddr, the FCnt is mixed in for the copies of empty frames
+    uint32_t hash = dev_addr ^ mic ^ ( ( uint32_t ) fcnt_dwn * 0x9E3779B1UL );
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return ( uint8_t ) ( hash % LR1MAC_DL_DEDUP_WINDOW_SIZE );
+}
+#endif
+
 uint32_t lr1mac_utilities_crc( uint8_t* buf, int len )
 {
-    uint32_t crc = 0xFFFFFFFA;
-    while( len-- > 0 )
-    {
-        crc = crc ^ *buf++;
-        for( int i = 0; i < 8; i++ )
-        {
-            uint32_t mask = -( crc & 1 );
-            crc           = ( crc >> 1 ) ^ ( 0xEDB88320 & mask );
-        }
-    }
-    return ~crc + 3;
+    // Seed and post-processing of the historical flash contexts
+    return ~modem_crc32_update( 0xFFFFFFFA, buf, ( len > 0 ) ? ( uint32_t ) len : 0 ) + 3;
 }
 
 uint32_t lr1mac_utilities_get_symb_time_us( const uint16_t nb_symb, const ral_lora_sf_t sf, const ral_lora_bw_t bw )
@@ -103,9 +116,54 @@ uint32_t lr1mac_utilities_get_symb_time_us( const uint16_t nb_symb, const ral_lo
     }
     /* clang-format on */
 
+    // The LoRaWAN bandwidths divide 1000 by a power of two: shift instead of dividing
+    switch( bw_khz )
+    {
+    case 125:
+        return ( uint32_t ) nb_symb << ( sf_val + 3 );
+    case 250:
+        return ( uint32_t ) nb_symb << ( sf_val + 2 );
+    case 500:
+        return ( uint32_t ) nb_symb << ( sf_val + 1 );
+    default:
+        break;
+    }
     return ( ( ( uint32_t ) nb_symb * 1000 ) << sf_val ) / bw_khz;
 }
 
+uint8_t lr1mac_utilities_get_active_channels( const uint8_t* channel_mask, const uint8_t* snapshot_mask,
+                                              const uint16_t* dr_bitfield, uint8_t datarate, uint8_t nb_channel,
+                                              uint8_t* active_channel_index )
+{
+    uint8_t  active_channel_nb = 0;
+    uint16_t dr_bit            = ( uint16_t ) ( 1 << datarate );
+
+    for( uint8_t bank = 0; ( bank * 8 ) < nb_channel; bank++ )
+    {
+        uint8_t candidates = channel_mask[bank];
+        if( snapshot_mask != NULL )
+        {
+            candidates &= snapshot_mask[bank];
+        }
+
+        // Walk the set bits only, a bank without enabled channel costs a single test
+        while( candidates != 0 )
+        {
+            uint8_t channel = ( bank * 8 ) + ( uint8_t ) __builtin_ctz( candidates );
+            candidates &= candidates - 1;
+            if( channel >= nb_channel )
+            {
+                break;
+            }
+            if( ( dr_bitfield[channel] & dr_bit ) != 0 )
+            {
+                active_channel_index[active_channel_nb++] = channel;
+            }
+        }
+    }
+    return active_channel_nb;
+}
+
 uint8_t SMTC_GET_BIT8( const uint8_t* array, uint8_t index )
 {
     return ( ( ( ( array )[( index ) / 8] ) >> ( ( index ) % 8 ) ) & 0x01 );
@@ -175,6 +233,20 @@ status_lorawan_t lr1mac_rx_payload_min_size_check( uint8_t rx_payload_size )
     return ( status );
 }
 
+receive_win_t lr1mac_rx_session_window( receive_win_t class_window, rx_session_type_t rx_session )
+{
+#if defined( SMTC_MULTICAST ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
+    // Groups 4 to 7 do not fit between RXC/RXB and the next window, they have their own range
+    if( rx_session >= ( RX_SESSION_MULTICAST_G0 + 4 ) )
+    {
+        receive_win_t first_window =
+            ( class_window == RECEIVE_ON_RXC ) ? RECEIVE_ON_RXC_MC_GRP4 : RECEIVE_ON_RXB_MC_GRP4;
+        return ( receive_win_t ) ( first_window + ( rx_session - ( RX_SESSION_MULTICAST_G0 + 4 ) ) );
+    }
+#endif
+    return ( receive_win_t ) ( class_window + rx_session );
+}
+
 status_lorawan_t lr1mac_rx_mhdr_extract( uint8_t* rx_payload, uint8_t* rx_ftype, uint8_t* rx_major, bool* tx_ack_bit )
 {
     status_lorawan_t status = OKLORAWAN;
@@ -258,6 +330,31 @@ status_lorawan_t lr1mac_fcnt_dwn_accept( uint16_t fcnt_dwn_tmp, uint32_t* fcnt_l
     return OKLORAWAN;
 }
 
+#if defined( ADD_DL_DEDUP )
+bool lr1mac_dl_dedup_is_duplicate( uint32_t dev_addr, uint16_t fcnt_dwn, uint32_t mic )
+{
+    const lr1mac_dl_dedup_entry_t* entry = &lr1mac_dl_dedup_window[lr1mac_dl_dedup_index( dev_addr, fcnt_dwn, mic )];
+
+    if( ( entry->valid == true ) && ( entry->dev_addr == dev_addr ) && ( entry->fcnt_dwn == fcnt_dwn ) &&
+        ( entry->mic == mic ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( " Duplicated downlink dropped, DevAddr 0x%x FCnt %u\n", dev_addr, fcnt_dwn );
+        return true;
+    }
+    return false;
+}
+
+void lr1mac_dl_dedup_add( uint32_t dev_addr, uint16_t fcnt_dwn, uint32_t mic )
+{
+    lr1mac_dl_dedup_entry_t* entry = &lr1mac_dl_dedup_window[lr1mac_dl_dedup_index( dev_addr, fcnt_dwn, mic )];
+
+    entry->dev_addr = dev_addr;
+    entry->fcnt_dwn = fcnt_dwn;
+    entry->mic      = mic;
+    entry->valid    = true;
+}
+#endif
+
 uint8_t lr1_stack_mac_cmd_ans_cut( uint8_t* nwk_ans, uint8_t nwk_ans_size_in, uint8_t max_allowed_size )
 {
     uint8_t* p_tmp = nwk_ans;
@@ -82,6 +82,15 @@ extern "C" {
 
 #define SIGN( N ) ( ( N < 0 ) ? ( -1 ) : ( 1 ) )
 
+#if defined( ADD_DL_DEDUP )
+/**
+ * @brief Number of entries of the window of recently accepted downlinks, shared by all the stacks and sessions
+ */
+#ifndef LR1MAC_DL_DEDUP_WINDOW_SIZE
+#define LR1MAC_DL_DEDUP_WINDOW_SIZE ( 16 )
+#endif
+#endif
+
 uint8_t SMTC_GET_BIT8( const uint8_t* array, uint8_t index );
 void    SMTC_SET_BIT8( uint8_t* array, uint8_t index );
 void    SMTC_CLR_BIT8( uint8_t* array, uint8_t index );
@@ -111,12 +120,39 @@ uint32_t lr1mac_utilities_crc( uint8_t* buf, int len );
  */
 uint32_t lr1mac_utilities_get_symb_time_us( const uint16_t nb_symb, const ral_lora_sf_t sf, const ral_lora_bw_t bw );
 
+/*!
+ * \brief List the channels enabled in the channel masks that allow a datarate
+ *
+ * \remark The masks are scanned byte per byte and only their set bits are tested against the datarate, the channels
+ *         are listed in increasing index order
+ *
+ * \param [IN]  channel_mask         Enabled channels bit mask
+ * \param [IN]  snapshot_mask        Optional second bit mask combined with channel_mask, NULL if not used
+ * \param [IN]  dr_bitfield          Datarate bit field of every channel
+ * \param [IN]  datarate             Datarate the channels must allow
+ * \param [IN]  nb_channel           Number of channels
+ * \param [OUT] active_channel_index Index of the active channels, at least nb_channel entries
+ * \param [OUT] return               Number of active channels
+ */
+uint8_t lr1mac_utilities_get_active_channels( const uint8_t* channel_mask, const uint8_t* snapshot_mask,
+                                              const uint16_t* dr_bitfield, uint8_t datarate, uint8_t nb_channel,
+                                              uint8_t* active_channel_index );
+
 /*!
  * \brief is valid Rx payload min size
  *
  */
 status_lorawan_t lr1mac_rx_payload_min_size_check( uint8_t rx_payload_size );
 
+/*!
+ * \brief Downlink window of a class B or class C rx session
+ *
+ * \param [in] class_window RECEIVE_ON_RXB or RECEIVE_ON_RXC
+ * \param [in] rx_session   Rx session that received the downlink
+ * \return receive_win_t
+ */
+receive_win_t lr1mac_rx_session_window( receive_win_t class_window, rx_session_type_t rx_session );
+
 /*!
  * \brief Extract MHDR
  *
@@ -136,6 +172,31 @@ int lr1mac_rx_fhdr_extract( uint8_t* rx_payload, uint8_t rx_payload_size, uint8_
  */
 status_lorawan_t lr1mac_fcnt_dwn_accept( uint16_t fcnt_dwn_tmp, uint32_t* fcnt_lorawan );
 
+#if defined( ADD_DL_DEDUP )
+/**
+ * @brief Check if a downlink is a copy of a recently accepted one, before its MIC is verified
+ *
+ * @remark A copy older than the last accepted frame passes the FCnt check as a 16 bits roll-over and would only be
+ * dropped by the MIC verification. The window is direct mapped: a frame evicted by a collision costs the MIC
+ * verification again, never a wrong drop
+ *
+ * @param [in] dev_addr  DevAddr of the frame
+ * @param [in] fcnt_dwn  16 bits FCnt of the frame
+ * @param [in] mic       MIC of the frame
+ * @return true if the frame is a copy of an accepted frame
+ */
+bool lr1mac_dl_dedup_is_duplicate( uint32_t dev_addr, uint16_t fcnt_dwn, uint32_t mic );
+
+/**
+ * @brief Record a downlink accepted after its MIC verification in the window of recently accepted downlinks
+ *
+ * @param [in] dev_addr  DevAddr of the frame
+ * @param [in] fcnt_dwn  16 bits FCnt of the frame
+ * @param [in] mic       MIC of the frame
+ */
+void lr1mac_dl_dedup_add( uint32_t dev_addr, uint16_t fcnt_dwn, uint32_t mic );
+#endif
+
 /**
  * @brief if the mac command answer is bigger than the allowed payload size, the payload is cut
  *
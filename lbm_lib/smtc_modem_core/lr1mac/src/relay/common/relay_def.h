@@ -49,6 +49,17 @@ extern "C" {
 
 #define RELAY_OVERHEAD_FORWARD ( 19 )  // 6 for metadata and 13 for LoRaWAN (1:MHDR/ 7:FHDR / 1:FPORT /4:MIC)
 
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+// Aggregated forward: FRMPayload is a sequence of [length][metadata (6 bytes) + uplink PHYPayload]
+#ifndef FPORT_RELAY_FWD_BATCH
+#define FPORT_RELAY_FWD_BATCH ( 227 )  // Must be agreed with the network server
+#endif
+#ifndef RELAY_FWD_BATCH_MAX_LATENCY_S
+#define RELAY_FWD_BATCH_MAX_LATENCY_S ( 30 )  // Longest wait of a queued uplink before the batch is sent
+#endif
+#define RELAY_FWD_BATCH_MIN_ENTRY ( 19 )  // 1 for length, 6 for metadata and 12 for the shortest LoRaWAN frame
+#endif
+
 #ifdef _cplusplus
 }
 #endif
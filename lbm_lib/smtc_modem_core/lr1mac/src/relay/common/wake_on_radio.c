@@ -71,6 +71,14 @@
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/**
+ * @brief Pack the WOR ACK fields, before encryption
+ *
+ * @param[in]   ack     WOR ACK infos
+ * @param[out]  buffer  Packed WOR ACK payload
+ */
+static void wor_encode_ack_payload( const wor_ack_infos_t* ack, uint8_t buffer[WOR_ACK_KEYSTREAM_LEN] );
+
 /**
  * @brief Decode/encode WOR payload
  *
@@ -430,22 +438,35 @@ void wor_decode_wor_enc_data( const uint8_t buffer_enc[4], wor_uplink_t* wor_ul,
 uint8_t wor_generate_ack( uint8_t* buffer, const wor_ack_infos_t* ack, const wor_ack_mic_info_t* mic_info,
                           const uint8_t* wor_s_int_key, const uint8_t wor_s_enc_key[16] )
 {
-    uint32_t tmp = 0;
-    tmp |= WOR_ACK_UPLINK_SET_TOFFSET( ack->t_offset );
-    tmp |= WOR_ACK_UPLINK_SET_CADP( ack->period );
-    tmp |= WOR_ACK_UPLINK_SET_XTAL( ack->relay_ppm );
-    tmp |= WOR_ACK_UPLINK_SET_GTW_DR( ack->dr_relay_gtw );
-    tmp |= WOR_ACK_UPLINK_SET_FWD( ack->relay_fwd );
-    tmp |= WOR_ACK_UPLINK_SET_CAD_RX( ack->cad_to_rx );
-
-    const uint8_t buffer_tmp[3] = {
-        [0] = ( uint8_t )( tmp ),
-        [1] = ( uint8_t )( tmp >> 8 ),
-        [2] = ( uint8_t )( tmp >> 16 ),
-    };
+    uint8_t buffer_tmp[WOR_ACK_KEYSTREAM_LEN];
 
+    wor_encode_ack_payload( ack, buffer_tmp );
     wor_aes_ack_uplink_enc( buffer_tmp, buffer + WOR_ACK_PAYLOAD_ENC_1, mic_info, wor_s_enc_key );
 
+    const uint32_t mic = wor_compute_mic_ack( mic_info, buffer + WOR_ACK_PAYLOAD_ENC_1, wor_s_int_key );
+
+    memcpy( buffer + WOR_ACK_MIC_1, &mic, 4 );
+    return WOR_ACK_LENGTH;
+}
+
+void wor_compute_ack_keystream( const wor_ack_mic_info_t* mic_info, const uint8_t wor_s_enc_key[16],
+                                uint8_t keystream[WOR_ACK_KEYSTREAM_LEN] )
+{
+    const uint8_t zero[WOR_ACK_KEYSTREAM_LEN] = { 0 };
+
+    wor_aes_ack_uplink_enc( zero, keystream, mic_info, wor_s_enc_key );
+}
+
+uint8_t wor_generate_ack_with_keystream( uint8_t* buffer, const wor_ack_infos_t* ack,
+                                         const wor_ack_mic_info_t* mic_info,
+                                         const uint8_t keystream[WOR_ACK_KEYSTREAM_LEN],
+                                         const uint8_t* wor_s_int_key )
+{
+    wor_encode_ack_payload( ack, buffer + WOR_ACK_PAYLOAD_ENC_1 );
+    for( uint8_t i = 0; i < WOR_ACK_KEYSTREAM_LEN; i++ )
+    {
+        buffer[WOR_ACK_PAYLOAD_ENC_1 + i] ^= keystream[i];
+    }
 
     const uint32_t mic = wor_compute_mic_ack( mic_info, buffer + WOR_ACK_PAYLOAD_ENC_1, wor_s_int_key );
 
@@ -457,6 +478,21 @@ uint8_t wor_generate_ack( uint8_t* buffer, const wor_ack_infos_t* ack, const wor
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static void wor_encode_ack_payload( const wor_ack_infos_t* ack, uint8_t buffer[WOR_ACK_KEYSTREAM_LEN] )
+{
+    uint32_t tmp = 0;
+    tmp |= WOR_ACK_UPLINK_SET_TOFFSET( ack->t_offset );
+    tmp |= WOR_ACK_UPLINK_SET_CADP( ack->period );
+    tmp |= WOR_ACK_UPLINK_SET_XTAL( ack->relay_ppm );
+    tmp |= WOR_ACK_UPLINK_SET_GTW_DR( ack->dr_relay_gtw );
+    tmp |= WOR_ACK_UPLINK_SET_FWD( ack->relay_fwd );
+    tmp |= WOR_ACK_UPLINK_SET_CAD_RX( ack->cad_to_rx );
+
+    buffer[0] = ( uint8_t ) ( tmp );
+    buffer[1] = ( uint8_t ) ( tmp >> 8 );
+    buffer[2] = ( uint8_t ) ( tmp >> 16 );
+}
+
 static void wor_aes_wor_uplink_enc( const uint8_t* buffer_in, uint8_t* buffer_out, const wor_uplink_t* wor_ul,
                                     const wor_rf_infos_t* wor_rf, const uint8_t wor_s_enc_key[16] )
 {
@@ -49,6 +49,7 @@ extern "C" {
  */
 #define MAX_WOR_CH ( 2 )
 #define CHANNEL_TABLE_SIZE ( 16 )
+#define WOR_ACK_KEYSTREAM_LEN ( 3 )
 
 /*
  * -----------------------------------------------------------------------------
@@ -326,6 +327,34 @@ void wor_decode_wor_enc_data( const uint8_t buffer_enc[4], wor_uplink_t* wor_ul,
  */
 uint8_t wor_generate_ack( uint8_t* buffer, const wor_ack_infos_t* ack, const wor_ack_mic_info_t* mic_info,
                           const uint8_t* wor_s_int_key, const uint8_t wor_s_enc_key[16] );
+
+/**
+ * @brief   Compute the keystream encrypting a WOR ACK payload
+ *
+ * @remark  The keystream only depends on the device, the WFCnt and the ACK channel, it can be computed before the WOR
+ *          is received
+ *
+ * @param[in]   mic_info        Info required to encrypt the ACK (WOR datarate and frequency are not used)
+ * @param[in]   wor_s_enc_key   WOR Session Encryption Key
+ * @param[out]  keystream       Keystream to XOR with the WOR ACK payload
+ */
+void wor_compute_ack_keystream( const wor_ack_mic_info_t* mic_info, const uint8_t wor_s_enc_key[16],
+                                uint8_t keystream[WOR_ACK_KEYSTREAM_LEN] );
+
+/**
+ * @brief   Generate WOR ACK payload to be send with a keystream computed by wor_compute_ack_keystream
+ *
+ * @param[out]  buffer          Buffer to fill with WOR frame
+ * @param[in]   ack             WOR ACK infos
+ * @param[in]   mic_info        Info required to compute MIC
+ * @param[in]   keystream       Keystream computed for the same device, WFCnt and ACK channel
+ * @param[in]   wor_s_int_key   WOR Session Integrity Key, NULL if already loaded in the secure element
+ * @return uint8_t              Length of ouput buffer
+ */
+uint8_t wor_generate_ack_with_keystream( uint8_t* buffer, const wor_ack_infos_t* ack,
+                                         const wor_ack_mic_info_t* mic_info,
+                                         const uint8_t keystream[WOR_ACK_KEYSTREAM_LEN],
+                                         const uint8_t* wor_s_int_key );
 #ifdef _cplusplus
 }
 #endif
@@ -61,6 +61,34 @@
 #define SIZE_TAB_JOIN_REQ_LIST ( 16 )
 #define MAX_UINT16 ( 0x0000FFFF )
 
+#if defined( ADD_RELAY_FWD_TABLE )
+#ifndef RELAY_FWD_TABLE_HASH_SIZE
+#define RELAY_FWD_TABLE_HASH_SIZE ( 32 )  // Power of 2, at least twice SIZE_TAB_DEV_ADDR_LIST
+#endif
+#if( ( RELAY_FWD_TABLE_HASH_SIZE & ( RELAY_FWD_TABLE_HASH_SIZE - 1 ) ) != 0 ) || \
+    ( RELAY_FWD_TABLE_HASH_SIZE <= SIZE_TAB_DEV_ADDR_LIST ) || ( RELAY_FWD_TABLE_HASH_SIZE > 255 )
+#error "RELAY_FWD_TABLE_HASH_SIZE must be a power of 2 larger than SIZE_TAB_DEV_ADDR_LIST and below 256"
+#endif
+#define RELAY_FWD_TABLE_EMPTY ( 0xFF )
+#define RELAY_FWD_TABLE_NVM_VERSION ( 1 )
+#endif
+
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+#ifndef RELAY_ADAPTIVE_CAD_MIN_PERIOD_S
+#define RELAY_ADAPTIVE_CAD_MIN_PERIOD_S ( 60 )  // Shorter WOR intervals are retransmissions of the same uplink
+#endif
+#ifndef RELAY_ADAPTIVE_CAD_MAX_PERIOD_S
+#define RELAY_ADAPTIVE_CAD_MAX_PERIOD_S ( 3600 )  // Longer uplink periods are not predicted
+#endif
+#ifndef RELAY_ADAPTIVE_CAD_GUARD_S
+#define RELAY_ADAPTIVE_CAD_GUARD_S ( 10 )  // Added to 1/8 of the period around an expected uplink
+#endif
+#ifndef RELAY_ADAPTIVE_CAD_MAX_MISSED
+#define RELAY_ADAPTIVE_CAD_MAX_MISSED ( 3 )  // Expected uplinks missed before a device is considered silent
+#endif
+#define RELAY_ADAPTIVE_CAD_QUIET_PERIOD_MS ( 1000 )  // WOR preamble of a device not synchronized with the relay
+#endif
+
 #define RELAY_FWD_UPLINK_SET_METADATA_WOR_CH( a ) ( ( uint32_t ) ( ( ( a ) & 0x0003 ) << 16 ) )
 #define RELAY_FWD_UPLINK_SET_METADATA_UPLINK_RSSI( a ) ( ( uint32_t ) ( ( ( a ) & 0x007F ) << 9 ) )
 #define RELAY_FWD_UPLINK_SET_METADATA_UPLINK_SNR( a ) ( ( uint32_t ) ( ( ( a ) & 0x001F ) << 4 ) )
@@ -125,6 +153,35 @@ typedef struct relay_fwd_join_list_s
     uint8_t len;  // Len of eui (len(JOIN EUI) + len(DEV EUI))
 } relay_fwd_join_list_t;
 
+#if defined( ADD_RELAY_FWD_TABLE )
+typedef struct relay_fwd_table_nvm_s
+{
+    uint8_t                 ctx_version;
+    relay_fwd_uplink_list_t device_list[SIZE_TAB_DEV_ADDR_LIST];
+    uint32_t                crc;  // !! crc MUST be the last field of the structure !!
+} relay_fwd_table_nvm_t;
+#endif
+
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+typedef struct relay_traffic_s
+{
+    uint32_t last_wor_ms;  // Reception time of the last WOR
+    uint32_t period_ms;    // Learned uplink period, valid when nb_wor is 2
+    uint8_t  nb_wor;       // 0: never heard, 1: period not known yet, 2: period learned
+} relay_traffic_t;
+#endif
+
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+typedef struct relay_ack_precompute_s
+{
+    bool     valid;
+    uint32_t wfcnt32;                  // WFCnt of the next WOR of the device
+    uint32_t ack_freq_hz[MAX_WOR_CH];  // ACK channel the keystreams are computed for
+    uint8_t  ack_dr[MAX_WOR_CH];
+    uint8_t  keystream[MAX_WOR_CH][WOR_ACK_KEYSTREAM_LEN];
+} relay_ack_precompute_t;
+#endif
+
 typedef struct relay_infos_s
 {
     lr1_stack_mac_t*           lr1mac;
@@ -153,6 +210,9 @@ typedef struct relay_infos_s
     uint16_t                      t_offset;
     wor_ack_cad_to_rx_t           cad_to_rx;
     wor_ack_ppm_error_t           error_ppm;
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+    bool cad_quiet;  // Only the default channel is checked, once per second
+#endif
 } relay_infos_t;
 
 /*
@@ -162,10 +222,23 @@ typedef struct relay_infos_s
 static relay_config_t          relay_config                                 = { 0 };
 static relay_fwd_config_t      relay_fwd_cnt[LIMIT__LAST_ELT]               = { 0 };
 static relay_fwd_join_list_t   device_list_join[SIZE_TAB_JOIN_REQ_LIST]     = { 0 };
+#if defined( ADD_RELAY_FWD_TABLE )
+// The trusted list is kept in its non volatile memory image, stored as is
+static relay_fwd_table_nvm_t          relay_fwd_table                                  = { 0 };
+static relay_fwd_uplink_list_t* const device_list_dev_addr                             = relay_fwd_table.device_list;
+static uint8_t                        relay_fwd_table_hash[RELAY_FWD_TABLE_HASH_SIZE] = { 0 };
+#else
 static relay_fwd_uplink_list_t device_list_dev_addr[SIZE_TAB_DEV_ADDR_LIST] = { 0 };
+#endif
 static relay_infos_t           relay_info                                   = { 0 };
 static relay_stats_t           relay_stat                                   = { 0 };
 static wor_infos_t             relay_wor_info                               = { 0 };
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+static relay_traffic_t relay_traffic[SIZE_TAB_DEV_ADDR_LIST] = { 0 };
+#endif
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+static relay_ack_precompute_t relay_ack_precompute[SIZE_TAB_DEV_ADDR_LIST] = { 0 };
+#endif
 
 /*
  *-----------------------------------------------------------------------------------
@@ -211,6 +284,16 @@ static void config_enqueue_next_cad( const relay_config_t* config, relay_infos_t
  */
 static void config_cad_to_rx_wor( const relay_config_t* config, relay_infos_t* info );
 
+#if defined( ADD_RELAY_RX_CAD_SWEEP )
+/**
+ * @brief Run the CAD of the next WOR channel in the running radio task
+ *
+ * @param[in]   config      Relay configuration
+ * @param[in]   info        Relay status
+ */
+static void config_cad_sweep_next_channel( const relay_config_t* config, relay_infos_t* info );
+#endif
+
 /**
  * @brief Program the reception of the LoRaWAN Uplink
  *
@@ -253,6 +336,70 @@ static int16_t relay_compute_rx_done_correction( uint8_t datarate, uint16_t payl
  */
 static bool is_mic_wor_valid( const wor_infos_t* wor, uint32_t mic_receive, uint8_t* device_idx );
 
+/**
+ * @brief Check the received MIC against one trusted device and update its WFCnt32 if it is valid
+ *
+ * @param[in]   wor         WOR infos
+ * @param[in]   mic_receive MIC received
+ * @param[in]   idx         Index in the trusted tables
+ * @return true     MIC is valid
+ * @return false    MIC is invalid or the device has another DevAddr
+ */
+static bool is_mic_wor_valid_for_device( const wor_infos_t* wor, uint32_t mic_receive, uint8_t idx );
+
+#if defined( ADD_RELAY_FWD_TABLE )
+/**
+ * @brief Get the first bucket of a DevAddr in the hash index of the trusted table
+ *
+ * @param[in]   dev_addr    DevAddr
+ * @return uint8_t  Bucket index
+ */
+static uint8_t relay_fwd_table_hash_bucket( uint32_t dev_addr );
+
+/**
+ * @brief Rebuild the hash index of the trusted table (open addressing, linear probing)
+ */
+static void relay_fwd_table_rebuild( void );
+
+/**
+ * @brief Store the trusted table in non volatile memory
+ */
+static void relay_fwd_table_save( void );
+
+/**
+ * @brief Restore the trusted table from non volatile memory, keep it cleared if the stored image is invalid
+ */
+static void relay_fwd_table_restore( void );
+#endif
+
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+/**
+ * @brief Learn the uplink period of a trusted device from the reception times of its WOR
+ *
+ * @param[in]   idx     Index in the trusted tables
+ * @param[in]   wor_ms  Reception time of the WOR
+ */
+static void relay_adaptive_cad_learn( uint8_t idx, uint32_t wor_ms );
+
+/**
+ * @brief Check if no trusted device is expected to send a WOR around a given time
+ *
+ * @param[in]   time_ms Time to check
+ * @return true     All trusted devices are either between two expected uplinks or silent
+ * @return false    A trusted device is expected or its period is still being learned
+ */
+static bool relay_adaptive_cad_is_quiet( uint32_t time_ms );
+#endif
+
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+/**
+ * @brief Compute the WOR ACK keystreams of a trusted device for its next WFCnt, on every WOR channel
+ *
+ * @param[in]   idx     Index in the trusted tables
+ */
+static void relay_ack_precompute_update( uint8_t idx );
+#endif
+
 /**
  * @brief Check if the relay is authorized to forward a new message
  *
@@ -341,6 +488,9 @@ bool relay_init( lr1_stack_mac_t* lr1mac, wor_ack_ppm_error_t error_ppm, wor_ack
     {
         device_list_dev_addr[i].in_use = false;
     }
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+    memset( relay_traffic, 0, sizeof( relay_traffic ) );
+#endif
 
     // Clean rules for join request forward
     device_list_join[0].action = RELAY_FILTER_FWD_TYPE_FORWARD;  // default is forward
@@ -349,6 +499,11 @@ bool relay_init( lr1_stack_mac_t* lr1mac, wor_ack_ppm_error_t error_ppm, wor_ack
         device_list_join[i].action = RELAY_FILTER_FWD_TYPE_CLEAR;
     }
 
+#if defined( ADD_RELAY_FWD_TABLE )
+    // Trusted devices added before a reset are still allowed
+    relay_fwd_table_restore( );
+#endif
+
     relay_info.lr1mac    = lr1mac;
     relay_info.radio     = lr1mac->rp->radio;
     relay_info.error_ppm = error_ppm;
@@ -671,6 +826,16 @@ bool relay_fwd_uplink_add_device( const uint8_t idx, const uint32_t dev_addr, co
     device->fwd_cfg.bucket_size     = bucket_factor * reload_rate;
     device->fwd_cfg.token_available = bucket_factor * reload_rate;
 
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+    relay_traffic[idx].nb_wor = 0;
+#endif
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+    relay_ack_precompute_update( idx );
+#endif
+#if defined( ADD_RELAY_FWD_TABLE )
+    relay_fwd_table_rebuild( );
+    relay_fwd_table_save( );
+#endif
     return true;
 }
 
@@ -679,6 +844,10 @@ bool relay_fwd_uplink_remove_device( const uint8_t idx )
     if( ( idx < SIZE_TAB_DEV_ADDR_LIST ) && ( device_list_dev_addr[idx].in_use == true ) )
     {
         device_list_dev_addr[idx].in_use = false;
+#if defined( ADD_RELAY_FWD_TABLE )
+        relay_fwd_table_rebuild( );
+        relay_fwd_table_save( );
+#endif
         return true;
     }
 
@@ -842,6 +1011,19 @@ static void manage_fsm( const uint32_t irq_timestamp_ms, const bool cad_success,
         relay_stat.nb_cad1 += 1;
         if( cad_success == false )
         {
+#if defined( ADD_RELAY_RX_CAD_SWEEP )
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+            if( ( ( relay_info.current_ch_idx + 1 ) < relay_config.nb_wor_channel ) &&
+                ( relay_info.cad_quiet == false ) )
+#else
+            if( ( relay_info.current_ch_idx + 1 ) < relay_config.nb_wor_channel )
+#endif
+            {
+                // The radio planner keeps the radio for the next channel of the sweep
+                config_cad_sweep_next_channel( &relay_config, &relay_info );
+                break;
+            }
+#endif
             // CAD has failed, program the next CAD
             config_enqueue_next_cad( &relay_config, &relay_info );
         }
@@ -965,6 +1147,9 @@ static void manage_fsm( const uint32_t irq_timestamp_ms, const bool cad_success,
 
             if( mic_is_valid == true )
             {
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+                relay_adaptive_cad_learn( relay_info.rx_msg_devaddr_idx, relay_info.rx_wor_timestamp_ms );
+#endif
                 // check duty cycle before to transmit wor_ack
                 smtc_duty_cycle_update( );
                 if( smtc_duty_cycle_is_channel_free(
@@ -1003,6 +1188,10 @@ static void manage_fsm( const uint32_t irq_timestamp_ms, const bool cad_success,
         relay_info.tx_ack_timestamp_ms = irq_timestamp_ms;
         config_enqueue_rx_msg( &relay_config, &relay_wor_info,
                                relay_info.tx_ack_timestamp_ms + DELAY_WORACK_TO_UPLINK_MS );
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+        // Out of the WOR to ACK critical path: the uplink is only expected in DELAY_WORACK_TO_UPLINK_MS
+        relay_ack_precompute_update( relay_info.rx_msg_devaddr_idx );
+#endif
         break;
 
     case CAD_STATE_WAIT_RX_DATA_COMPLETION:
@@ -1061,7 +1250,12 @@ static void config_enqueue_next_cad( const relay_config_t* config, relay_infos_t
         actual_ms += duty_cycle_ms;
     }
 
+#if defined( ADD_RELAY_RX_CAD_SWEEP )
+    // All channels are checked one after the other in a single radio task every CAD period
+    const uint32_t cad_period_ms = wor_convert_cad_period_in_ms( config->cad_period );
+#else
     const uint32_t cad_period_ms     = wor_convert_cad_period_in_ms( config->cad_period ) / config->nb_wor_channel;
+#endif
     uint32_t       next_cad_start_ms = info->last_cad_ms;
 
     while( ( ( int ) ( next_cad_start_ms - smtc_modem_hal_get_radio_tcxo_startup_delay_ms( ) - actual_ms ) <= 0 ) )
@@ -1069,9 +1263,39 @@ static void config_enqueue_next_cad( const relay_config_t* config, relay_infos_t
         next_cad_start_ms += cad_period_ms;
         info->current_ch_idx += 1;
     }
+
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+    const bool cad_quiet = relay_adaptive_cad_is_quiet( next_cad_start_ms );
+    if( cad_quiet != info->cad_quiet )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Relay CAD %s\n", ( cad_quiet == true ) ? "quiet" : "full" );
+        info->cad_quiet = cad_quiet;
+    }
+    if( cad_quiet == true )
+    {
+        // No trusted device is expected: only the default channel is checked, once per second. Devices that are not
+        // synchronized with the relay use a one second preamble on this channel, a synchronized device that is not
+        // heard falls back to it after missing its WOR ACK
+#if defined( ADD_RELAY_RX_CAD_SWEEP )
+        const uint8_t nb_slot_per_period = 1;
+#else
+        const uint8_t nb_slot_per_period = config->nb_wor_channel;
+#endif
+        while( ( ( next_cad_start_ms - info->last_cad_ms ) < RELAY_ADAPTIVE_CAD_QUIET_PERIOD_MS ) ||
+               ( ( info->current_ch_idx % nb_slot_per_period ) != 0 ) )
+        {
+            next_cad_start_ms += cad_period_ms;
+            info->current_ch_idx += 1;
+        }
+    }
+#endif
     // SMTC_MODEM_HAL_TRACE_PRINTF( "Next CAD at %d\n", next_cad_start_ms );
 
+#if defined( ADD_RELAY_RX_CAD_SWEEP )
+    info->current_ch_idx = 0;  // The sweep starts on the default channel
+#else
     info->current_ch_idx %= config->nb_wor_channel;
+#endif
     info->next_cad_ms = next_cad_start_ms;
     info->last_cad_ms = next_cad_start_ms;
 
@@ -1097,6 +1321,11 @@ static void config_enqueue_next_cad( const relay_config_t* config, relay_infos_t
         .duration_time_ms           = 20000,
         .start_time_ms              = info->next_cad_ms - smtc_modem_hal_get_radio_tcxo_startup_delay_ms( ),
         .launch_task_callbacks      = wor_ral_callback_start_cad,
+#if defined( ADD_RELAY_RX_CAD_SWEEP ) && defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+        .cad_sweep_hops             = ( info->cad_quiet == true ) ? 0 : config->nb_wor_channel - 1,
+#elif defined( ADD_RELAY_RX_CAD_SWEEP )
+        .cad_sweep_hops             = config->nb_wor_channel - 1,
+#endif
     };
 
     if( rp_task_enqueue( relay_info.lr1mac->rp, &rp_task_cad, info->buffer, 255, &rx_param ) == RP_HOOK_STATUS_OK )
@@ -1127,6 +1356,42 @@ static void config_cad_to_rx_wor( const relay_config_t* config, relay_infos_t* i
     info->state = CAD_STATE_WAIT_WOR_COMPLETION;
 }
 
+#if defined( ADD_RELAY_RX_CAD_SWEEP )
+static void config_cad_sweep_next_channel( const relay_config_t* config, relay_infos_t* info )
+{
+    const uint8_t prev_dr = config->channel_cfg[info->current_ch_idx].dr;
+
+    info->current_ch_idx += 1;
+
+    rp_radio_params_t             rx_param    = { 0 };
+    const relay_channel_config_t* channel_cfg = &config->channel_cfg[info->current_ch_idx];
+    wor_ral_init_rx_wor( relay_info.lr1mac->real, channel_cfg->dr, channel_cfg->freq_hz, config->cad_period,
+                         MAX( ( uint8_t ) WOR_JOINREQ_LENGTH, ( uint8_t ) WOR_UPLINK_LENGTH ), &rx_param );
+    wor_ral_init_cad( relay_info.lr1mac->real, channel_cfg->dr, config->cad_period, true,
+                      relay_info.wor_toa_ms[info->current_ch_idx], &rx_param.rx.cad );
+
+    if( channel_cfg->dr == prev_dr )
+    {
+        // The radio is still configured for this datarate, only the frequency changes
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rf_freq( &( relay_info.radio->ral ), channel_cfg->freq_hz ) ==
+                                         RAL_STATUS_OK );
+    }
+    else
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_lora( relay_info.radio, &rx_param.rx.lora ) == RAL_STATUS_OK );
+    }
+
+    // The WOR reception that may follow uses the parameters of this channel
+    relay_info.lr1mac->rp->radio_params[RP_HOOK_ID_RELAY_RX_CAD] = rx_param;
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_lora_cad_params( &( relay_info.radio->ral ), &rx_param.rx.cad ) ==
+                                     RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_lora_cad( &( relay_info.radio->ral ) ) == RAL_STATUS_OK );
+
+    info->state = CAD_STATE_WAIT_CAD_COMPLETION;
+}
+#endif
+
 static void config_enqueue_rx_msg( const relay_config_t* config, const wor_infos_t* wor,
                                    const uint32_t timestamp_lr1_ul )
 {
@@ -1227,9 +1492,26 @@ static void config_enqueue_ack( const relay_config_t* config, const wor_infos_t*
 
     };
 
-    info->buffer_length =
-        wor_generate_ack( info->buffer, &ack, &mic_info, device_list_dev_addr[devaddr_idx].wor_s_int_key,
-                          device_list_dev_addr[devaddr_idx].wor_s_enc_key );
+    bool ack_generated = false;
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+    const relay_ack_precompute_t* precompute = &relay_ack_precompute[devaddr_idx];
+    const uint8_t                 ch         = info->current_ch_idx;
+
+    if( ( precompute->valid == true ) && ( precompute->wfcnt32 == mic_info.wfcnt ) &&
+        ( precompute->ack_freq_hz[ch] == channel_cfg->ack_freq_hz ) && ( precompute->ack_dr[ch] == channel_cfg->dr ) )
+    {
+        // The integrity key of the device is still in the secure element since the MIC check of its WOR
+        info->buffer_length =
+            wor_generate_ack_with_keystream( info->buffer, &ack, &mic_info, precompute->keystream[ch], NULL );
+        ack_generated = true;
+    }
+#endif
+    if( ack_generated == false )
+    {
+        info->buffer_length =
+            wor_generate_ack( info->buffer, &ack, &mic_info, device_list_dev_addr[devaddr_idx].wor_s_int_key,
+                              device_list_dev_addr[devaddr_idx].wor_s_enc_key );
+    }
 
     rp_radio_params_t radio_params = { 0 };
     wor_ral_init_tx_ack( relay_info.lr1mac->real, channel_cfg->dr, channel_cfg->ack_freq_hz, info->buffer_length,
@@ -1262,39 +1544,223 @@ static void config_enqueue_ack( const relay_config_t* config, const wor_infos_t*
 
 static bool is_mic_wor_valid( const wor_infos_t* wor, uint32_t mic_receive, uint8_t* device_idx )
 {
+#if defined( ADD_RELAY_FWD_TABLE )
+    // Only the devices with the same DevAddr are on the probe sequence, it ends at the first empty bucket
+    const uint8_t bucket = relay_fwd_table_hash_bucket( wor->uplink.devaddr );
+
+    for( uint8_t probe = 0; probe < RELAY_FWD_TABLE_HASH_SIZE; probe++ )
+    {
+        const uint8_t i = relay_fwd_table_hash[( bucket + probe ) & ( RELAY_FWD_TABLE_HASH_SIZE - 1 )];
+
+        if( i == RELAY_FWD_TABLE_EMPTY )
+        {
+            break;
+        }
+        if( is_mic_wor_valid_for_device( wor, mic_receive, i ) == true )
+        {
+            *device_idx = i;
+            return true;
+        }
+    }
+#else
+    for( uint8_t i = 0; i < SIZE_TAB_DEV_ADDR_LIST; i++ )
+    {
+        if( is_mic_wor_valid_for_device( wor, mic_receive, i ) == true )
+        {
+            *device_idx = i;
+            return true;
+        }
+    }
+#endif
+
+    return false;
+}
+
+static bool is_mic_wor_valid_for_device( const wor_infos_t* wor, uint32_t mic_receive, uint8_t idx )
+{
+    relay_fwd_uplink_list_t* device = &device_list_dev_addr[idx];
+
+    if( ( device->in_use == false ) || ( device->dev_addr != wor->uplink.devaddr ) )
+    {
+        return false;
+    }
+
+    uint32_t fcnt = device->wfcnt32;
+    // Check if rollover on fcnt
+    if( wor->uplink.fcnt <= ( uint16_t ) ( fcnt & MAX_UINT16 ) )
+    {
+        fcnt += MAX_UINT16;
+    }
+    // Clear 16 LSB and update with receive value
+    fcnt &= ~( MAX_UINT16 );
+    fcnt += wor->uplink.fcnt;
+
+    const wor_mic_infos_t wor_mic_info = {
+        .dev_addr = device->dev_addr,
+        .wfcnt    = fcnt,
+    };
+
+    const uint32_t mic_calc = wor_compute_mic_wor( &wor_mic_info, wor->uplink.enc_data, device->wor_s_int_key );
+
+    if( mic_receive == mic_calc )
+    {
+        device->wfcnt32 = fcnt;
+        return true;
+    }
+    return false;
+}
+
+#if defined( ADD_RELAY_FWD_TABLE )
+static uint8_t relay_fwd_table_hash_bucket( uint32_t dev_addr )
+{
+    // Fibonacci hashing, the NwkID in the MSB and the NwkAddr in the LSB both spread over the buckets
+    return ( uint8_t ) ( ( uint32_t ) ( dev_addr * 0x9E3779B1UL ) >> 24 ) & ( RELAY_FWD_TABLE_HASH_SIZE - 1 );
+}
+
+static void relay_fwd_table_rebuild( void )
+{
+    memset( relay_fwd_table_hash, RELAY_FWD_TABLE_EMPTY, sizeof( relay_fwd_table_hash ) );
+
     for( uint8_t i = 0; i < SIZE_TAB_DEV_ADDR_LIST; i++ )
     {
-        if( ( device_list_dev_addr[i].in_use == true ) && ( device_list_dev_addr[i].dev_addr == wor->uplink.devaddr ) )
+        if( device_list_dev_addr[i].in_use == true )
         {
-            uint32_t fcnt = device_list_dev_addr[i].wfcnt32;
-            // Check if rollover on fcnt
-            if( wor->uplink.fcnt <= ( uint16_t ) ( fcnt & MAX_UINT16 ) )
+            uint8_t bucket = relay_fwd_table_hash_bucket( device_list_dev_addr[i].dev_addr );
+
+            // The index is larger than the trusted table, a free bucket is always found
+            while( relay_fwd_table_hash[bucket] != RELAY_FWD_TABLE_EMPTY )
             {
-                fcnt += MAX_UINT16;
+                bucket = ( bucket + 1 ) & ( RELAY_FWD_TABLE_HASH_SIZE - 1 );
             }
-            // Clear 16 LSB and update with receive value
-            fcnt &= ~( MAX_UINT16 );
-            fcnt += wor->uplink.fcnt;
+            relay_fwd_table_hash[bucket] = i;
+        }
+    }
+}
+
+static void relay_fwd_table_save( void )
+{
+    relay_fwd_table.ctx_version = RELAY_FWD_TABLE_NVM_VERSION;
+    relay_fwd_table.crc =
+        lr1mac_utilities_crc( ( uint8_t* ) &relay_fwd_table, sizeof( relay_fwd_table ) - sizeof( relay_fwd_table.crc ) );
+
+    modem_context_store( CONTEXT_RELAY_FWD_TABLE, 0, ( uint8_t* ) &relay_fwd_table, sizeof( relay_fwd_table ) );
+}
+
+static void relay_fwd_table_restore( void )
+{
+    // Restored in place, the image is too large for the stack
+    modem_context_restore( CONTEXT_RELAY_FWD_TABLE, 0, ( uint8_t* ) &relay_fwd_table, sizeof( relay_fwd_table ) );
+
+    if( ( relay_fwd_table.ctx_version != RELAY_FWD_TABLE_NVM_VERSION ) ||
+        ( lr1mac_utilities_crc( ( uint8_t* ) &relay_fwd_table,
+                                sizeof( relay_fwd_table ) - sizeof( relay_fwd_table.crc ) ) != relay_fwd_table.crc ) )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "No valid relay trusted table in NVM\n" );
+        memset( &relay_fwd_table, 0, sizeof( relay_fwd_table ) );
+    }
+    relay_fwd_table_rebuild( );
+}
+#endif
+
+#if defined( ADD_RELAY_RX_ADAPTIVE_CAD )
+static void relay_adaptive_cad_learn( uint8_t idx, uint32_t wor_ms )
+{
+    relay_traffic_t* traffic = &relay_traffic[idx];
+
+    if( traffic->nb_wor == 0 )
+    {
+        traffic->last_wor_ms = wor_ms;
+        traffic->nb_wor      = 1;
+        return;
+    }
+
+    const uint32_t interval_ms = wor_ms - traffic->last_wor_ms;
+    if( interval_ms < ( RELAY_ADAPTIVE_CAD_MIN_PERIOD_S * 1000 ) )
+    {
+        return;  // Retransmission of the same uplink
+    }
+    traffic->last_wor_ms = wor_ms;
+
+    if( interval_ms > ( RELAY_ADAPTIVE_CAD_MAX_PERIOD_S * 1000 ) )
+    {
+        traffic->nb_wor = 1;
+    }
+    else if( ( traffic->nb_wor == 1 ) || ( interval_ms < ( traffic->period_ms >> 1 ) ) )
+    {
+        // First period or the device sends more often than before
+        traffic->period_ms = interval_ms;
+        traffic->nb_wor    = 2;
+    }
+    else if( interval_ms <= ( traffic->period_ms + ( traffic->period_ms >> 1 ) ) )
+    {
+        traffic->period_ms = ( ( 3 * traffic->period_ms ) + interval_ms ) >> 2;
+    }
+    // A longer interval comes from missed uplinks, the period is kept
+}
 
-            const wor_mic_infos_t wor_mic_info = {
-                .dev_addr = device_list_dev_addr[i].dev_addr,
-                .wfcnt    = fcnt,
-            };
+static bool relay_adaptive_cad_is_quiet( uint32_t time_ms )
+{
+    for( uint8_t i = 0; i < SIZE_TAB_DEV_ADDR_LIST; i++ )
+    {
+        const relay_traffic_t* traffic = &relay_traffic[i];
 
-            const uint32_t mic_calc =
-                wor_compute_mic_wor( &wor_mic_info, wor->uplink.enc_data, device_list_dev_addr[i].wor_s_int_key );
+        if( ( device_list_dev_addr[i].in_use == false ) || ( traffic->nb_wor == 0 ) )
+        {
+            // A device never heard is not synchronized, its first WOR uses the default channel preamble
+            continue;
+        }
 
-            if( mic_receive == mic_calc )
+        const uint32_t elapsed_ms = time_ms - traffic->last_wor_ms;
+        if( traffic->nb_wor == 1 )
+        {
+            if( elapsed_ms < ( RELAY_ADAPTIVE_CAD_MAX_PERIOD_S * 1000 ) )
             {
-                *device_idx                     = i;
-                device_list_dev_addr[i].wfcnt32 = fcnt;
-                return true;
+                return false;
             }
+            continue;
+        }
+
+        const uint32_t guard_ms = ( traffic->period_ms >> 3 ) + ( RELAY_ADAPTIVE_CAD_GUARD_S * 1000 );
+        if( elapsed_ms > ( ( traffic->period_ms * ( RELAY_ADAPTIVE_CAD_MAX_MISSED + 1 ) ) + guard_ms ) )
+        {
+            continue;  // Silent device
+        }
+
+        const uint32_t phase_ms = elapsed_ms % traffic->period_ms;
+        if( ( phase_ms < guard_ms ) || ( ( traffic->period_ms - phase_ms ) < guard_ms ) )
+        {
+            return false;
         }
     }
+    return true;
+}
+#endif
 
-    return false;
+#if defined( ADD_RELAY_RX_ACK_PRECOMPUTE )
+static void relay_ack_precompute_update( uint8_t idx )
+{
+    const relay_fwd_uplink_list_t* device     = &device_list_dev_addr[idx];
+    relay_ack_precompute_t*        precompute = &relay_ack_precompute[idx];
+
+    // A device sends its next WOR with the next WFCnt, otherwise the ACK is fully computed on reception
+    precompute->wfcnt32 = device->wfcnt32 + 1;
+
+    for( uint8_t ch = 0; ch < MAX_WOR_CH; ch++ )
+    {
+        const wor_ack_mic_info_t mic_info = {
+            .dev_addr     = device->dev_addr,
+            .wfcnt        = precompute->wfcnt32,
+            .datarate     = relay_config.channel_cfg[ch].dr,
+            .frequency_hz = relay_config.channel_cfg[ch].ack_freq_hz,
+        };
+
+        precompute->ack_freq_hz[ch] = mic_info.frequency_hz;
+        precompute->ack_dr[ch]      = mic_info.datarate;
+        wor_compute_ack_keystream( &mic_info, device->wor_s_enc_key, precompute->keystream[ch] );
+    }
+    precompute->valid = true;
 }
+#endif
 
 static void fwd_rx_msg( const wor_infos_t* wor, const relay_config_t* config, const relay_infos_t* info )
 {
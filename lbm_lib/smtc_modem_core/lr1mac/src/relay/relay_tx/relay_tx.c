@@ -59,6 +59,15 @@
 #define DEFAULT_CAD_PERIOD ( WOR_CAD_PERIOD_1S )
 #define DEFAULT_ACTIVATION_MODE ( RELAY_TX_ACTIVATION_MODE_ED_CONTROLED )
 
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+#ifndef RELAY_TX_SYNC_JITTER_MS
+#define RELAY_TX_SYNC_JITTER_MS ( 2 )  // Error of one CAD time estimation (ms timestamps on both sides)
+#endif
+#ifndef RELAY_TX_SYNC_DRIFT_MARGIN_PPB
+#define RELAY_TX_SYNC_DRIFT_MARGIN_PPB ( 2000 )  // Drift change between two WOR ACK (temperature)
+#endif
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -106,11 +115,22 @@ typedef struct relay_tx_s
 
     bool               last_ack_valid;
     wor_ack_infos_t    last_ack;
+    uint8_t            ack_free_max;  // Uplinks sent without listening to the WOR ACK between two WOR ACK
+    uint8_t            ack_free_cnt;  // Uplinks sent without listening to the WOR ACK since the last one
     bool               need_key_derivation;
     relay_tx_config_t  relay_tx_config;
     wor_ack_mic_info_t ack_mic_info;
 
     uint32_t target_timer_lr1;
+
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+    // Drift of the relay CAD schedule in the end-device time base, measured between two WOR ACK
+    bool     ref_drift_valid;
+    int32_t  ref_drift_ppb;            // Positive when the relay CAD comes later than expected
+    uint32_t ref_drift_error_ppb;      // Error of the measured drift
+    uint32_t last_crystal_error_ppm;   // End-device crystal error used for the last WOR
+    bool     last_wor_drift_tracked;   // The last WOR preamble was computed from the measured drift
+#endif
 } relay_tx_t;
 
 /*
@@ -155,6 +175,23 @@ static void relay_tx_update_sync_status( uint8_t relay_stack_id, relay_tx_sync_s
  */
 static void relay_tx_print_conf( uint8_t relay_stack_id );
 
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+/**
+ * @brief Measure the drift of the relay CAD schedule from the previous and the new WOR ACK reference
+ *
+ * @param[in]   relay_stack_id  Stack identifier
+ * @param[in]   new_ref_ms      CAD time estimated from the new WOR ACK
+ */
+static void relay_tx_measure_drift( uint8_t relay_stack_id, uint32_t new_ref_ms );
+
+/**
+ * @brief Drop the measured drift after a WOR sent with the drift based preamble was not acknowledged
+ *
+ * @param[in]   relay_stack_id  Stack identifier
+ */
+static void relay_tx_drift_miss( uint8_t relay_stack_id );
+#endif
+
 /*
  *-----------------------------------------------------------------------------------
  *--- PUBLIC FUNCTIONS DEFINITIONS --------------------------------------------------
@@ -377,12 +414,32 @@ bool smtc_relay_tx_prepare_wor( uint8_t relay_stack_id, uint32_t target_time, co
     // -----------------------------------------------------------------
     // Estimate drift error
     uint32_t drift_error_ms = cad_period_ms;  // init drift with CAD period (max value)
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+    infos->last_crystal_error_ppm = lr1_infos->crystal_error_ppm;
+    infos->last_wor_drift_tracked = false;
+#endif
     // Don't compute drift error for at time message because it will have to use the max preamble
     if( infos->sync_status == RELAY_TX_SYNC_STATUS_SYNC )
     {
         drift_error_ms = ( lr1_infos->crystal_error_ppm + infos->relay_xtal_drift_ppm ) * 2;
         drift_error_ms *= ( target_time + cad_period_ms - ref_timestamp );
         drift_error_ms /= 1000000;
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+        if( infos->ref_drift_valid == true )
+        {
+            // The CAD time is corrected by the measured drift, the preamble only covers its error
+            const uint32_t tracked_error_ms =
+                ( uint32_t ) ( ( ( uint64_t ) infos->ref_drift_error_ppb * 2 *
+                                 ( target_time + cad_period_ms - ref_timestamp ) ) /
+                               1000000000 ) +
+                RELAY_TX_SYNC_JITTER_MS * 2;
+            if( tracked_error_ms < drift_error_ms )
+            {
+                drift_error_ms                = tracked_error_ms;
+                infos->last_wor_drift_tracked = true;
+            }
+        }
+#endif
 
         SMTC_MODEM_HAL_TRACE_PRINTF( "Drift error : %d ms\n", drift_error_ms );
 
@@ -459,7 +516,13 @@ bool smtc_relay_tx_prepare_wor( uint8_t relay_stack_id, uint32_t target_time, co
         find_n /= cad_period_ms;
         find_n += 2;  // +1 to get next integer and +1 to get some margin
 
-        const uint32_t t_next = find_n * cad_period_ms + ref_timestamp;
+        uint32_t t_next = find_n * cad_period_ms + ref_timestamp;
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+        if( infos->last_wor_drift_tracked == true )
+        {
+            t_next += ( int32_t ) ( ( ( int64_t ) infos->ref_drift_ppb * ( find_n * cad_period_ms ) ) / 1000000000 );
+        }
+#endif
 
         infos->last_timestamp_ms = t_next - ( drift_error_ms >> 1 );
 
@@ -575,6 +638,21 @@ void smtc_relay_tx_data_receive_on_rxr( uint8_t relay_stack_id )
     }
 }
 
+void smtc_relay_tx_set_ack_free_uplinks( uint8_t relay_stack_id, uint8_t nb_uplink )
+{
+    relay_tx_t* infos = &( relay_tx_declare[relay_stack_id] );
+
+    infos->ack_free_max = nb_uplink;
+    infos->ack_free_cnt = 0;
+}
+
+uint8_t smtc_relay_tx_get_ack_free_uplinks( uint8_t relay_stack_id )
+{
+    relay_tx_t* infos = &( relay_tx_declare[relay_stack_id] );
+
+    return infos->ack_free_max;
+}
+
 int32_t smtc_relay_tx_free_duty_cycle_ms_get( uint8_t relay_stack_id )
 {
     relay_tx_t* infos        = &( relay_tx_declare[relay_stack_id] );
@@ -648,7 +726,21 @@ static void relay_tx_callback_rp( uint8_t* stack_id )
         infos->miss_wor_ack_cnt += 1;
         infos->backoff_cnt += 1;
         // WOR has been send !
-        if( lorawan_api_isjoined( relay_stack_id ) == JOINED )
+        if( ( lorawan_api_isjoined( relay_stack_id ) == JOINED ) &&
+            ( infos->sync_status == RELAY_TX_SYNC_STATUS_SYNC ) && ( infos->last_ack_valid == true ) &&
+            ( infos->last_ack.relay_fwd == WOR_ACK_FORWARD_OK ) && ( infos->ack_free_cnt < infos->ack_free_max ) )
+        {
+            // The relay timing and forward status are known from the last WOR ACK: do not listen to this one, the
+            // relay opens its uplink window after sending it whether or not it is received. Not listening is not
+            // a missed WOR ACK
+            infos->ack_free_cnt += 1;
+            infos->miss_wor_ack_cnt -= 1;
+            infos->backoff_cnt -= 1;
+            has_to_send_data = true;
+            infos->target_timer_lr1 = infos->time_tx_done + infos->toa_ack[infos->last_ch_idx] +
+                                      DELAY_WOR_TO_WORACK_MS + DELAY_WORACK_TO_UPLINK_MS;
+        }
+        else if( lorawan_api_isjoined( relay_stack_id ) == JOINED )
         {
             wor_ack_rx_param_t wor_ack;
             memset( &wor_ack, 0, sizeof( wor_ack_rx_param_t ) );
@@ -706,6 +798,9 @@ static void relay_tx_callback_rp( uint8_t* stack_id )
 
         if( relay_tx_check_decode_ack( relay_stack_id, &ack ) != true )
         {
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+            relay_tx_drift_miss( relay_stack_id );
+#endif
             if( infos->backoff_cnt <= infos->relay_tx_config.backoff )
             {
                 cancel_lr1mac_process = true;
@@ -723,9 +818,27 @@ static void relay_tx_callback_rp( uint8_t* stack_id )
         {
             infos->miss_wor_ack_cnt = 0;
             infos->backoff_cnt      = 0;
+            infos->ack_free_cnt     = 0;
             infos->last_ack         = ack;
             infos->last_ack_valid   = true;
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+            // Measured only between two WOR ACK of the same CAD schedule: same period and channel, while synchronized
+            const bool same_schedule = ( infos->sync_status == RELAY_TX_SYNC_STATUS_SYNC ) &&
+                                       ( infos->ref_cad_period == ack.period ) &&
+                                       ( infos->ref_channel_idx == infos->last_ch_idx );
+#endif
             relay_tx_update_sync_status( relay_stack_id, RELAY_TX_SYNC_STATUS_SYNC );
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+            if( same_schedule == true )
+            {
+                relay_tx_measure_drift( relay_stack_id,
+                                        infos->last_timestamp_ms + infos->last_preamble_len_ms - ack.t_offset );
+            }
+            else
+            {
+                infos->ref_drift_valid = false;
+            }
+#endif
             infos->ref_cad_period       = ack.period;
             infos->ref_channel_idx      = infos->last_ch_idx;
             infos->ref_default_idx       = infos->last_default_idx;
@@ -758,6 +871,9 @@ static void relay_tx_callback_rp( uint8_t* stack_id )
         break;
     }
     case RP_STATUS_RX_TIMEOUT:
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+        relay_tx_drift_miss( relay_stack_id );
+#endif
         // manage if we want to continue even if we don't have received the WOR ACK
         if( infos->backoff_cnt <= infos->relay_tx_config.backoff )
         {
@@ -820,11 +936,64 @@ static void relay_tx_update_sync_status( uint8_t relay_stack_id, relay_tx_sync_s
     if( infos->sync_status != new_status )
     {
         infos->miss_wor_ack_cnt = 0;
+        infos->ack_free_cnt     = 0;
         infos->sync_status      = new_status;
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+        infos->ref_drift_valid = false;
+#endif
         increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_RELAY_TX_SYNC, new_status, relay_stack_id );
     }
 }
 
+#if defined( ADD_RELAY_TX_DRIFT_TRACKING )
+static void relay_tx_measure_drift( uint8_t relay_stack_id, uint32_t new_ref_ms )
+{
+    relay_tx_t*    infos         = &( relay_tx_declare[relay_stack_id] );
+    const uint32_t cad_period_ms = wor_convert_cad_period_in_ms( infos->ref_cad_period );
+    const uint32_t elapsed_ms    = new_ref_ms - infos->ref_timestamp_ms;
+
+    // The relay CAD expected at a whole number of periods after the previous reference
+    const uint32_t nb_period      = ( elapsed_ms + ( cad_period_ms >> 1 ) ) / cad_period_ms;
+    const int32_t  phase_error_ms = ( int32_t ) ( elapsed_ms - nb_period * cad_period_ms );
+
+    // A phase error beyond both crystal errors is a wrong estimation, not a drift
+    const uint32_t max_error_ms =
+        ( uint32_t ) ( ( ( uint64_t ) ( infos->last_crystal_error_ppm + infos->relay_xtal_drift_ppm ) * elapsed_ms ) /
+                       1000000 ) +
+        RELAY_TX_SYNC_JITTER_MS * 2;
+
+    const uint32_t abs_error_ms =
+        ( phase_error_ms < 0 ) ? ( uint32_t ) ( -phase_error_ms ) : ( uint32_t ) phase_error_ms;
+
+    if( ( nb_period == 0 ) || ( abs_error_ms > max_error_ms ) )
+    {
+        infos->ref_drift_valid = false;
+        return;
+    }
+
+    infos->ref_drift_ppb = ( int32_t ) ( ( ( int64_t ) phase_error_ms * 1000000000 ) / elapsed_ms );
+    infos->ref_drift_error_ppb =
+        ( uint32_t ) ( ( ( uint64_t ) RELAY_TX_SYNC_JITTER_MS * 2 * 1000000000 ) / elapsed_ms ) +
+        RELAY_TX_SYNC_DRIFT_MARGIN_PPB;
+    infos->ref_drift_valid = true;
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Relay drift : %d ppb (+/- %d ppb) over %d ms\n", infos->ref_drift_ppb,
+                                 infos->ref_drift_error_ppb, elapsed_ms );
+}
+
+static void relay_tx_drift_miss( uint8_t relay_stack_id )
+{
+    relay_tx_t* infos = &( relay_tx_declare[relay_stack_id] );
+
+    if( infos->last_wor_drift_tracked == true )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "WOR ACK missed with the drift based preamble -> crystal error preamble\n" );
+        infos->ref_drift_valid        = false;
+        infos->last_wor_drift_tracked = false;
+    }
+}
+#endif
+
 static void relay_tx_print_conf( uint8_t relay_stack_id )
 {
     relay_tx_t* infos = &( relay_tx_declare[relay_stack_id] );
@@ -220,6 +220,25 @@ uint32_t smtc_relay_tx_get_crystal_error( uint8_t relay_stack_id );
  */
 void smtc_relay_tx_data_receive_on_rxr( uint8_t relay_stack_id );
 
+/**
+ * @brief Set the number of uplinks sent on the last WOR ACK parameters without listening to the WOR ACK
+ *
+ * Only used while synchronised with a relay that accepts to forward, every (nb_uplink + 1)th WOR ACK is received to
+ * keep the synchronisation
+ *
+ * @param[in]   relay_stack_id  relay stack id
+ * @param[in]   nb_uplink       Number of uplinks between two received WOR ACK (0: always listen to the WOR ACK)
+ */
+void smtc_relay_tx_set_ack_free_uplinks( uint8_t relay_stack_id, uint8_t nb_uplink );
+
+/**
+ * @brief Get the number of uplinks sent without listening to the WOR ACK
+ *
+ * @param[in]   relay_stack_id  relay stack id
+ * @return uint8_t Number of uplinks between two received WOR ACK
+ */
+uint8_t smtc_relay_tx_get_ack_free_uplinks( uint8_t relay_stack_id );
+
 /**
  *  @brief return the relay duty cycle consumption in ms
  *
@@ -119,6 +119,37 @@ static inline uint8_t smtc_duty_cycle_compute_index( uint32_t timestamp_ms, uint
  */
 static inline uint32_t smtc_duty_cycle_time_diff( uint32_t rtc_ms, uint32_t timestamp_ms );
 
+/**
+ * @brief Erase one TOA slot of a band and remove it from the rolling sum
+ *
+ * @param band_ptr                  Band to update
+ * @param index                     Index of the slot to erase
+ */
+static inline void smtc_duty_cycle_erase_slot( smtc_dtc_band_t* band_ptr, uint8_t index );
+
+/**
+ * @brief Compute the RTC time at which a band that reached its max TOA has TOA available again
+ *
+ * @remark The oldest slots are removed one by one until the remaining consumed TOA is under the band limit, so the
+ *         result is the exact time and not only the expiry of the oldest non empty slot
+ *
+ * @param band_ptr                  Band requested
+ * @param rtc_time_now              Current RTC time in milliseconds
+ * @return uint32_t                 Return the RTC time in milliseconds
+ */
+static uint32_t smtc_duty_cycle_compute_band_free_time_ms( smtc_dtc_band_t* band_ptr, uint32_t rtc_time_now );
+
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+/**
+ * @brief Get the TOA available on the band of a channel
+ *
+ * @param available_toa_ms          TOA available on each band
+ * @param freq_hz                   Frequency of the channel
+ * @return int32_t                  Return the TOA available, INT32_MAX if the frequency is outside of all bands
+ */
+static int32_t smtc_duty_cycle_get_channel_available_toa_ms( const int32_t* available_toa_ms, uint32_t freq_hz );
+#endif
+
 /**
  * @brief Put band number in array if not already present
  *
@@ -163,6 +194,7 @@ void smtc_duty_cycle_config( uint8_t number_of_bands, uint8_t band_idx, uint16_t
     dtc_obj_ptr->bands[band_idx].duty_cycle_regulation = duty_cycle_regulation;
     dtc_obj_ptr->bands[band_idx].freq_min              = freq_min;
     dtc_obj_ptr->bands[band_idx].freq_max              = freq_max;
+    dtc_obj_ptr->bands[band_idx].free_time_valid       = false;
 }
 
 smtc_dtc_rc_t smtc_duty_cycle_enable_set( smtc_dtc_enablement_type_t enable )
@@ -230,6 +262,7 @@ void smtc_duty_cycle_sum( uint32_t freq_hz, uint32_t toa_ms )
     {
         // Erase band cumulated TOA
         memset( dtc_obj_ptr->bands[band].toa_sum_ms, 0, sizeof( dtc_obj_ptr->bands[band].toa_sum_ms ) );
+        dtc_obj_ptr->bands[band].toa_consumed = 0;
     }
     else
     {
@@ -250,14 +283,17 @@ void smtc_duty_cycle_sum( uint32_t freq_hz, uint32_t toa_ms )
                 {
                     i = 0;
                 }
-                dtc_obj_ptr->bands[band].toa_sum_ms[i] = 0;
+                smtc_duty_cycle_erase_slot( &dtc_obj_ptr->bands[band], i );
             }
         }
     }
-    // Save the new TOA
+    // Save the new TOA, the stored value is read back as the slot is 16 bits wide
+    dtc_obj_ptr->bands[band].toa_consumed -= dtc_obj_ptr->bands[band].toa_sum_ms[idx_new];
     dtc_obj_ptr->bands[band].toa_sum_ms[idx_new] = toa_ms;
-    dtc_obj_ptr->bands[band].toa_timestamp_ms    = rtc_time_now;
-    dtc_obj_ptr->bands[band].index_previous      = idx_new;
+    dtc_obj_ptr->bands[band].toa_consumed += dtc_obj_ptr->bands[band].toa_sum_ms[idx_new];
+    dtc_obj_ptr->bands[band].toa_timestamp_ms = rtc_time_now;
+    dtc_obj_ptr->bands[band].index_previous   = idx_new;
+    dtc_obj_ptr->bands[band].free_time_valid  = false;
 }
 
 void smtc_duty_cycle_update( void )
@@ -272,6 +308,14 @@ void smtc_duty_cycle_update( void )
     }
     uint32_t rtc_time_now = smtc_modem_hal_get_time_in_ms( );
 
+    // Slots only become obsolete on a SMTC_DTC_SECONDS_BY_UNIT boundary, nothing to erase twice in the same unit
+    if( smtc_duty_cycle_time_diff( rtc_time_now, dtc_obj_ptr->update_timestamp_ms ) <
+        ( SMTC_DTC_SECONDS_BY_UNIT * 1000UL ) )
+    {
+        return;
+    }
+    dtc_obj_ptr->update_timestamp_ms = rtc_time_now;
+
     for( uint8_t band = 0; band < dtc_obj_ptr->number_of_bands; band++ )
     {
         uint8_t idx_previous = dtc_obj_ptr->bands[band].index_previous;
@@ -284,6 +328,7 @@ void smtc_duty_cycle_update( void )
         {
             // Erase band cumulated TOA, it's been over 1h
             memset( dtc_obj_ptr->bands[band].toa_sum_ms, 0, sizeof( dtc_obj_ptr->bands[band].toa_sum_ms ) );
+            dtc_obj_ptr->bands[band].toa_consumed     = 0;
             dtc_obj_ptr->bands[band].toa_timestamp_ms = rtc_time_now;
             dtc_obj_ptr->bands[band].index_previous   = idx_new;
         }
@@ -302,7 +347,7 @@ void smtc_duty_cycle_update( void )
                 if( ( i != idx_new ) ||
                     ( ( i == idx_new ) && ( timestamp_diff >= ( SMTC_DTC_SECONDS_BY_UNIT * 1000 ) ) ) )
                 {
-                    dtc_obj_ptr->bands[band].toa_sum_ms[i] = 0;
+                    smtc_duty_cycle_erase_slot( &dtc_obj_ptr->bands[band], i );
                 }
             }
         }
@@ -469,50 +514,23 @@ int32_t smtc_duty_cycle_get_next_free_time_ms( uint8_t number_of_tx_freq, uint32
     }
     else
     {
-        // All bands reached the max available TOA, search for the next nearest TOA available slot
+        // All bands reached the max available TOA, search for the nearest time a band has TOA available again
         uint32_t next_available_slot_ms_tmp = ~0;
         uint32_t rtc_time_now               = smtc_modem_hal_get_time_in_ms( );
 
         for( uint8_t j = 0; j < tmp_band_dtc_full_index; j++ )
         {
-            uint8_t band = tmp_band_dtc_full[j];
-
-            uint8_t idx_previous = dtc_obj_ptr->bands[band].index_previous;
-            // compute index by delta to manage rtc_ms wrapping
-            uint32_t timestamp_diff =
-                smtc_duty_cycle_time_diff( rtc_time_now, dtc_obj_ptr->bands[band].toa_timestamp_ms );
-            uint8_t idx_new = smtc_duty_cycle_compute_index( timestamp_diff, idx_previous );
+            smtc_dtc_band_t* band_ptr = &dtc_obj_ptr->bands[tmp_band_dtc_full[j]];
 
-            // compute time between now and the end of this index
-            uint32_t next_available_slot_ms =
-                ( SMTC_DTC_SECONDS_BY_UNIT * 1000UL ) - ( rtc_time_now % ( SMTC_DTC_SECONDS_BY_UNIT * 1000UL ) );
-
-            uint8_t idx_empty_counter = 0;
-
-            uint8_t i = idx_new;
-            do
+            // The free time only moves when a TOA is added, keep it until the next smtc_duty_cycle_sum()
+            if( ( band_ptr->free_time_valid == false ) ||
+                ( ( int32_t ) ( band_ptr->free_time_ms - rtc_time_now ) <= 0 ) )
             {
-                i++;
-                if( i >= SMTC_DTC_TOA_BUFF_SIZE )
-                {
-                    i = 0;
-                }
-                if( dtc_obj_ptr->bands[band].toa_sum_ms[i] != 0 )
-                {
-                    break;
-                }
-                if( i != idx_previous )
-                {
-                    idx_empty_counter++;
-                }
-
-                if( idx_empty_counter > SMTC_DTC_TOA_BUFF_SIZE )
-                {
-                    SMTC_MODEM_HAL_PANIC( );
-                }
-            } while( i != idx_previous );
+                band_ptr->free_time_ms    = smtc_duty_cycle_compute_band_free_time_ms( band_ptr, rtc_time_now );
+                band_ptr->free_time_valid = true;
+            }
 
-            next_available_slot_ms += idx_empty_counter * SMTC_DTC_SECONDS_BY_UNIT * 1000UL;
+            uint32_t next_available_slot_ms = band_ptr->free_time_ms - rtc_time_now;
             if( next_available_slot_ms_tmp > next_available_slot_ms )
             {
                 next_available_slot_ms_tmp = next_available_slot_ms;
@@ -524,6 +542,81 @@ int32_t smtc_duty_cycle_get_next_free_time_ms( uint8_t number_of_tx_freq, uint32
     return ret;
 }
 
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+uint8_t smtc_duty_cycle_select_channels_for_toa( const uint32_t* tx_freq_list, uint8_t* channel_index,
+                                                 uint8_t number_of_channel, uint32_t toa_ms )
+{
+    if( dtc_obj_ptr == NULL )
+    {
+        return number_of_channel;
+    }
+    if( ( dtc_obj_ptr->enabled != SMTC_DTC_ENABLED ) || ( dtc_obj_ptr->number_of_bands == 0 ) || ( toa_ms == 0 ) )
+    {
+        return number_of_channel;
+    }
+
+    int32_t available_toa_ms[SMTC_DTC_BANDS_MAX];
+    for( uint8_t band = 0; band < dtc_obj_ptr->number_of_bands; band++ )
+    {
+        available_toa_ms[band] = smtc_duty_cycle_band_get_available_toa_ms( dtc_obj_ptr, band );
+    }
+
+    // First pass for the best budget among the candidates
+    int32_t max_toa_ms = INT32_MIN;
+    for( uint8_t i = 0; i < number_of_channel; i++ )
+    {
+        int32_t channel_toa_ms =
+            smtc_duty_cycle_get_channel_available_toa_ms( available_toa_ms, tx_freq_list[channel_index[i]] );
+        if( max_toa_ms < channel_toa_ms )
+        {
+            max_toa_ms = channel_toa_ms;
+        }
+    }
+
+    const int32_t threshold_ms = ( max_toa_ms >= ( int32_t ) toa_ms ) ? ( int32_t ) toa_ms : max_toa_ms;
+
+    uint8_t nb_kept = 0;
+    for( uint8_t i = 0; i < number_of_channel; i++ )
+    {
+        int32_t channel_toa_ms =
+            smtc_duty_cycle_get_channel_available_toa_ms( available_toa_ms, tx_freq_list[channel_index[i]] );
+        if( channel_toa_ms >= threshold_ms )
+        {
+            channel_index[nb_kept++] = channel_index[i];
+        }
+    }
+    return nb_kept;
+}
+#endif
+
+#if defined( ADD_REGION_SNAPSHOT )
+uint8_t smtc_duty_cycle_get_bands( smtc_dtc_band_t* bands )
+{
+    if( dtc_obj_ptr == NULL )
+    {
+        return 0;
+    }
+    memcpy( bands, dtc_obj_ptr->bands, sizeof( dtc_obj_ptr->bands ) );
+    return dtc_obj_ptr->number_of_bands;
+}
+
+void smtc_duty_cycle_set_bands( const smtc_dtc_band_t* bands, uint8_t number_of_bands )
+{
+    if( ( dtc_obj_ptr == NULL ) || ( number_of_bands > SMTC_DTC_BANDS_MAX ) )
+    {
+        return;
+    }
+    memcpy( dtc_obj_ptr->bands, bands, sizeof( dtc_obj_ptr->bands ) );
+    dtc_obj_ptr->number_of_bands = number_of_bands;
+    for( uint8_t band = 0; band < number_of_bands; band++ )
+    {
+        dtc_obj_ptr->bands[band].free_time_valid = false;
+    }
+    // The history may be older than one unit, force the next update to erase the obsolete slots
+    dtc_obj_ptr->update_timestamp_ms = smtc_modem_hal_get_time_in_ms( ) - ( SMTC_DTC_SECONDS_BY_UNIT * 1000UL );
+}
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -544,15 +637,43 @@ static bool smtc_duty_cycle_get_band( smtc_dtc_t* dtc_obj, uint32_t freq_hz, uin
 
 static uint32_t smtc_duty_cycle_get_band_consumed_time_ms( smtc_dtc_t* dtc_obj, uint8_t band )
 {
-    uint32_t toa_ms = 0;
-    for( uint8_t i = 0; i < SMTC_DTC_TOA_BUFF_SIZE; i++ )
+    // Convert to the resolution
+    return dtc_obj->bands[band].toa_consumed * smtc_dtc_resolution_ms;
+}
+
+static inline void smtc_duty_cycle_erase_slot( smtc_dtc_band_t* band_ptr, uint8_t index )
+{
+    band_ptr->toa_consumed -= band_ptr->toa_sum_ms[index];
+    band_ptr->toa_sum_ms[index] = 0;
+}
+
+static uint32_t smtc_duty_cycle_compute_band_free_time_ms( smtc_dtc_band_t* band_ptr, uint32_t rtc_time_now )
+{
+    const uint32_t unit_ms     = SMTC_DTC_SECONDS_BY_UNIT * 1000UL;
+    const uint32_t max_toa_ms  = SMTC_DTC_PERIOD_MS / band_ptr->duty_cycle_regulation;
+    uint32_t       consumed_ms = band_ptr->toa_consumed * smtc_dtc_resolution_ms;
+
+    // The slot following the current one is the oldest, it is erased at the end of the current unit
+    uint32_t free_time_ms = rtc_time_now + unit_ms - ( rtc_time_now % unit_ms );
+
+    uint32_t timestamp_diff = smtc_duty_cycle_time_diff( rtc_time_now, band_ptr->toa_timestamp_ms );
+    uint8_t  i              = smtc_duty_cycle_compute_index( timestamp_diff, band_ptr->index_previous );
+
+    for( uint8_t n = 0; n < SMTC_DTC_TOA_BUFF_SIZE; n++ )
     {
-        toa_ms += dtc_obj->bands[band].toa_sum_ms[i];
+        i++;
+        if( i >= SMTC_DTC_TOA_BUFF_SIZE )
+        {
+            i = 0;
+        }
+        consumed_ms -= band_ptr->toa_sum_ms[i] * smtc_dtc_resolution_ms;
+        if( consumed_ms < max_toa_ms )
+        {
+            break;
+        }
+        free_time_ms += unit_ms;
     }
-
-    // Convert to the resolution
-    toa_ms *= smtc_dtc_resolution_ms;
-    return toa_ms;
+    return free_time_ms;
 }
 
 static inline uint8_t smtc_duty_cycle_compute_index( uint32_t timestamp_ms, uint8_t idx_previous )
@@ -571,6 +692,18 @@ static inline uint32_t smtc_duty_cycle_time_diff( uint32_t rtc_ms, uint32_t time
     return ( rtc_ms - ( timestamp_ms - ( timestamp_ms % ( SMTC_DTC_SECONDS_BY_UNIT * 1000UL ) ) ) );
 }
 
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+static int32_t smtc_duty_cycle_get_channel_available_toa_ms( const int32_t* available_toa_ms, uint32_t freq_hz )
+{
+    uint8_t band;
+    if( smtc_duty_cycle_get_band( dtc_obj_ptr, freq_hz, &band ) == false )
+    {
+        return INT32_MAX;
+    }
+    return available_toa_ms[band];
+}
+#endif
+
 static void smtc_duty_cycle_put_band_in_array( smtc_dtc_t* dtc_obj, uint8_t* tmp_band, uint8_t band,
                                                uint8_t* tmp_band_index )
 {
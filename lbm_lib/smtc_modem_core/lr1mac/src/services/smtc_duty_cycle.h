@@ -102,12 +102,16 @@ typedef struct smtc_dtc_band_s
     uint32_t toa_timestamp_ms;       // last access to the array when adding the TOA or reset all TOA
     uint8_t  index_previous;
     uint16_t toa_sum_ms[SMTC_DTC_TOA_BUFF_SIZE];  // Store all TOA by step of SMTC_DTC_SECONDS_BY_UNIT
+    uint32_t toa_consumed;     // Rolling sum of toa_sum_ms, in smtc_dtc_resolution_ms units
+    uint32_t free_time_ms;     // RTC time at which the band has TOA available again, valid if free_time_valid
+    bool     free_time_valid;  // Cleared each time a TOA is added to the band
 } smtc_dtc_band_t;
 
 typedef struct smtc_dtc_s
 {
     smtc_dtc_enablement_type_t enabled;
     uint8_t                    number_of_bands;
+    uint32_t                   update_timestamp_ms;  // last time the obsolete TOA were erased
     smtc_dtc_band_t            bands[SMTC_DTC_BANDS_MAX];
 } smtc_dtc_t;
 
@@ -230,6 +234,42 @@ bool smtc_duty_cycle_is_band_free( smtc_dtc_t* dtc_obj, uint8_t band );
  * @return int32_t                  milliseconds, if > 0: the next slot availble, else the available time
  */
 int32_t smtc_duty_cycle_get_next_free_time_ms( uint8_t number_of_tx_freq, uint32_t* tx_freq_list );
+
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+/**
+ * @brief Keep only the channels whose band has enough duty cycle budget left to carry a frame
+ *
+ * @remark  smtc_duty_cycle_update() must be called before this function to have a right value
+ * @remark  If no band can carry the whole frame, the channels of the band with the most TOA available are kept, this
+ *          band is the one that will be blocked for the shortest time after the transmission
+ *
+ * @param [in]     tx_freq_list         Tx frequency of each channel, indexed by the values of channel_index
+ * @param [in,out] channel_index        Candidate channel indexes, the kept channels are moved at the beginning
+ * @param [in]     number_of_channel    Number of candidate channels
+ * @param [in]     toa_ms               Time On Air of the frame in milliseconds
+ * @return uint8_t                      Number of channels kept, equal to number_of_channel when nothing is filtered
+ */
+uint8_t smtc_duty_cycle_select_channels_for_toa( const uint32_t* tx_freq_list, uint8_t* channel_index,
+                                                 uint8_t number_of_channel, uint32_t toa_ms );
+#endif
+
+#if defined( ADD_REGION_SNAPSHOT )
+/**
+ * @brief Get the bands and their time on air history, to restore them when the region is used again
+ *
+ * @param [out] bands   SMTC_DTC_BANDS_MAX bands
+ * @return uint8_t      Number of configured bands, 0 when the duty cycle is not supported
+ */
+uint8_t smtc_duty_cycle_get_bands( smtc_dtc_band_t* bands );
+
+/**
+ * @brief Restore the bands and their time on air history, the obsolete time on air is erased at the next update
+ *
+ * @param [in] bands            Bands returned by smtc_duty_cycle_get_bands
+ * @param [in] number_of_bands  Number of bands returned by smtc_duty_cycle_get_bands
+ */
+void smtc_duty_cycle_set_bands( const smtc_dtc_band_t* bands, uint8_t number_of_bands );
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -39,10 +39,49 @@
 #include "stddef.h"
 #include "smtc_modem_hal.h"
 #include "lr1_stack_mac_layer.h"
+#include "modem_perf_counters.h"
 static smtc_lbt_t lbt_obj_declare[NUMBER_OF_STACKS];
 #define LBT_SNIFF_DURATION_MS_DEFAULT ( 5 )
 #define LBT_THRESHOLD_DBM_DEFAULT ( int16_t )( -80 )
 #define LBT_BW_HZ__DEFAULT ( 200000 )
+
+/**
+ * @brief Record the result of the last listen in the channel history
+ *
+ * @param lbt_obj pointer to lbt_obj itself
+ * @param is_busy true if the channel has been found busy
+ */
+static void smtc_lbt_update_channel_history( smtc_lbt_t* lbt_obj, bool is_busy )
+{
+    smtc_lbt_channel_history_t* entry = NULL;
+
+    for( uint8_t i = 0; i < LBT_CHANNEL_HISTORY_SIZE; i++ )
+    {
+        if( lbt_obj->channel_history[i].freq_hz == lbt_obj->listen_freq_hz )
+        {
+            entry = &lbt_obj->channel_history[i];
+            break;
+        }
+    }
+    if( is_busy == false )
+    {
+        if( entry != NULL )
+        {
+            entry->freq_hz = 0;
+        }
+        return;
+    }
+    if( entry == NULL )
+    {
+        // Replace the oldest recorded channel
+        entry                         = &lbt_obj->channel_history[lbt_obj->channel_history_next];
+        lbt_obj->channel_history_next = ( lbt_obj->channel_history_next + 1 ) % LBT_CHANNEL_HISTORY_SIZE;
+    }
+    entry->freq_hz      = lbt_obj->listen_freq_hz;
+    entry->busy_time_ms = smtc_modem_hal_get_time_in_ms( );
+    entry->busy_rssi    = lbt_obj->rssi_inst;
+}
+
 void smtc_lbt_init( smtc_lbt_t* lbt_obj, radio_planner_t* rp, uint8_t lbt_id_rp,
                     void ( *free_callback )( void* free_context ), void*   free_context,
                     void ( *busy_callback )( void* busy_context ), void*   busy_context,
@@ -68,6 +107,9 @@ void smtc_lbt_init( smtc_lbt_t* lbt_obj, radio_planner_t* rp, uint8_t lbt_id_rp,
     lbt_obj->listen_duration_ms = LBT_SNIFF_DURATION_MS_DEFAULT;
     lbt_obj->threshold          = LBT_THRESHOLD_DBM_DEFAULT;
     lbt_obj->bw_hz              = LBT_BW_HZ__DEFAULT;
+    lbt_obj->listen_freq_hz     = 0;
+    memset( lbt_obj->channel_history, 0, sizeof( lbt_obj->channel_history ) );
+    lbt_obj->channel_history_next = 0;
     rp_release_hook( rp, lbt_id_rp );
     rp_hook_init( rp, lbt_id_rp, ( void ( * )( void* ) )( smtc_lbt_rp_callback ), lbt_obj );
 }
@@ -147,7 +189,8 @@ void smtc_lbt_launch_callback_for_rp( void* rp_void )
 void smtc_lbt_listen_channel( smtc_lbt_t* lbt_obj, uint32_t freq, bool is_at_time, uint32_t target_time_ms,
                               uint32_t tx_duration_ms )
 {
-    lbt_obj->is_at_time = is_at_time;
+    lbt_obj->is_at_time     = is_at_time;
+    lbt_obj->listen_freq_hz = freq;
     if( ( lbt_obj->free_callback == NULL ) || ( lbt_obj->busy_callback == NULL ) ||
         ( lbt_obj->abort_callback == NULL ) )
     {
@@ -215,6 +258,12 @@ void smtc_lbt_rp_callback( smtc_lbt_t* lbt_obj )
     uint8_t     my_hook_id;
     rp_hook_get_id( lbt_obj->rp, lbt_obj, &my_hook_id );
     rp_get_status( lbt_obj->rp, my_hook_id, &tcurrent_ms, &( rp_status ) );
+    if( ( rp_status == RP_STATUS_LBT_FREE_CHANNEL ) || ( rp_status == RP_STATUS_LBT_BUSY_CHANNEL ) )
+    {
+        smtc_lbt_update_channel_history( lbt_obj, rp_status == RP_STATUS_LBT_BUSY_CHANNEL );
+        MODEM_PERF_COUNTER_ADD( MODEM_PERF_LBT_NB, 1 );
+        MODEM_PERF_COUNTER_ADD( MODEM_PERF_LBT_BUSY_NB, ( rp_status == RP_STATUS_LBT_BUSY_CHANNEL ) ? 1 : 0 );
+    }
     if( rp_status == RP_STATUS_LBT_FREE_CHANNEL )
     {
         lbt_obj->free_callback( lbt_obj->free_context );
@@ -237,6 +286,21 @@ void smtc_lbt_rp_callback( smtc_lbt_t* lbt_obj )
     }
 }
 
+bool smtc_lbt_is_channel_recently_busy( smtc_lbt_t* lbt_obj, uint32_t freq_hz )
+{
+    uint32_t now_ms = smtc_modem_hal_get_time_in_ms( );
+
+    for( uint8_t i = 0; i < LBT_CHANNEL_HISTORY_SIZE; i++ )
+    {
+        if( ( lbt_obj->channel_history[i].freq_hz == freq_hz ) &&
+            ( ( now_ms - lbt_obj->channel_history[i].busy_time_ms ) < LBT_CHANNEL_BUSY_HOLD_MS ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 smtc_lbt_t* smtc_lbt_get_obj( uint8_t stack_id )
 {
     if( stack_id < NUMBER_OF_STACKS )
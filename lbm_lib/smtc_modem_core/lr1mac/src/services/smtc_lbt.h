@@ -48,6 +48,28 @@ extern "C" {
  * ============================================================================
  */
 #define LAP_OF_TIME_TO_GET_A_RSSI_VALID 2  // duration to stabilize the radio after rx cmd in ms
+
+/**
+ * @brief Number of channels found busy which are remembered by the lbt object
+ */
+#ifndef LBT_CHANNEL_HISTORY_SIZE
+#define LBT_CHANNEL_HISTORY_SIZE ( 8 )
+#endif
+
+/**
+ * @brief Duration during which a channel found busy is reported as recently busy
+ */
+#ifndef LBT_CHANNEL_BUSY_HOLD_MS
+#define LBT_CHANNEL_BUSY_HOLD_MS ( 10000 )
+#endif
+
+typedef struct smtc_lbt_channel_history_s
+{
+    uint32_t freq_hz;       // 0 if the entry is not used
+    uint32_t busy_time_ms;  // time of the last busy listen on this channel
+    int16_t  busy_rssi;     // rssi which made the channel busy
+} smtc_lbt_channel_history_t;
+
 typedef struct smtc_lbt_s
 {
     radio_planner_t* rp;
@@ -61,11 +83,14 @@ typedef struct smtc_lbt_s
     void ( *busy_callback )( void* );
     void* busy_context;
     void ( *abort_callback )( void* );
-    void*    abort_context;
-    int16_t  rssi_inst;
-    int32_t  rssi_accu;
-    uint32_t rssi_nb_of_meas;
-    bool     enabled;
+    void*                      abort_context;
+    int16_t                    rssi_inst;
+    int32_t                    rssi_accu;
+    uint32_t                   rssi_nb_of_meas;
+    bool                       enabled;
+    uint32_t                   listen_freq_hz;
+    smtc_lbt_channel_history_t channel_history[LBT_CHANNEL_HISTORY_SIZE];
+    uint8_t                    channel_history_next;
     /* data */
 } smtc_lbt_t;
 
@@ -152,6 +177,15 @@ void smtc_lbt_rp_callback( smtc_lbt_t* lbt_obj );
  */
 void smtc_lbt_launch_callback_for_rp( void* rp_void );
 
+/**
+ * @brief Check if a channel has been found busy by a recent listen
+ *
+ * @param [in] lbt_obj pointer to lbt_obj itself
+ * @param [in] freq_hz channel frequency in hertz
+ * @return true if the channel has been found busy less than LBT_CHANNEL_BUSY_HOLD_MS ago
+ */
+bool smtc_lbt_is_channel_recently_busy( smtc_lbt_t* lbt_obj, uint32_t freq_hz );
+
 /**
  * @brief return the lbt obj pointer with stack id as parameter
  * task
@@ -0,0 +1,418 @@
+/*!
+ * \file      smtc_link_adr.c
+ *
+ * \brief     Device side datarate adaptation driven by the measured link margin
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_link_adr.h"
+#include "smtc_real.h"
+#include "lr1mac_utilities.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Get the LoRa demodulation floor of a spreading factor
+ *
+ * @remark -7.5 dB at SF7 and 2.5 dB lower for each step
+ *
+ * @param sf                        Spreading factor
+ * @return int16_t                  Return the floor in 0.5 dB steps
+ */
+static int16_t smtc_link_adr_get_floor_half_db( uint8_t sf );
+
+/**
+ * @brief Get the noise increase of a bandwidth compared to 125 kHz
+ *
+ * @param bw                        Bandwidth
+ * @return int16_t                  Return 10 * log10( bw / 125 kHz ) in 0.5 dB steps
+ */
+static int16_t smtc_link_adr_get_bw_offset_half_db( lr1mac_bandwidth_t bw );
+
+/**
+ * @brief Add a measurement to the history
+ *
+ * @param link_adr                  Link adaptation context
+ * @param snr_half_db               Link SNR in 0.5 dB steps, brought back to a 125 kHz bandwidth
+ */
+static void smtc_link_adr_add_measurement( smtc_link_adr_t* link_adr, int16_t snr_half_db );
+
+/**
+ * @brief Get the worst link measurement of the history
+ *
+ * @param link_adr                  Link adaptation context, with at least one measurement
+ * @return int16_t                  Return the worst SNR in 0.5 dB steps
+ */
+static int16_t smtc_link_adr_get_worst_snr_half_db( const smtc_link_adr_t* link_adr );
+
+/**
+ * @brief Get the SNR that keeps the margin above the demodulation floor of a LoRa datarate
+ *
+ * @param link_adr                  Link adaptation context
+ * @param sf                        Spreading factor
+ * @param bw                        Bandwidth
+ * @return int16_t                  Return the required SNR in 0.5 dB steps, brought back to a 125 kHz bandwidth
+ */
+static int16_t smtc_link_adr_get_required_half_db( const smtc_link_adr_t* link_adr, uint8_t sf,
+                                                   lr1mac_bandwidth_t bw );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_link_adr_init( smtc_link_adr_t* link_adr )
+{
+    link_adr->margin_db             = SMTC_LINK_ADR_DEFAULT_MARGIN_DB;
+    link_adr->power_control_enabled = false;
+    link_adr->delivery_target       = 0;
+    link_adr->bulk_enabled          = false;
+    smtc_link_adr_reset( link_adr );
+}
+
+void smtc_link_adr_reset( smtc_link_adr_t* link_adr )
+{
+    link_adr->snr_index          = 0;
+    link_adr->snr_count          = 0;
+    link_adr->backoff_dr         = 0;
+    link_adr->power_hold         = false;
+    link_adr->power_reduction_db = 0;
+    link_adr->probe_count        = 0;
+    link_adr->probe_lost         = 0;
+}
+
+void smtc_link_adr_set_power_control( smtc_link_adr_t* link_adr, bool enable )
+{
+    link_adr->power_control_enabled = enable;
+    link_adr->power_hold            = false;
+    link_adr->power_reduction_db    = 0;
+}
+
+void smtc_link_adr_set_bulk( smtc_link_adr_t* link_adr, bool enable )
+{
+    link_adr->bulk_enabled = enable;
+}
+
+bool smtc_link_adr_set_margin( smtc_link_adr_t* link_adr, uint8_t margin_db )
+{
+    if( margin_db > SMTC_LINK_ADR_MAX_MARGIN_DB )
+    {
+        return false;
+    }
+    link_adr->margin_db = margin_db;
+    return true;
+}
+
+bool smtc_link_adr_set_delivery_target( smtc_link_adr_t* link_adr, uint8_t target_percent )
+{
+    if( target_percent >= 100 )
+    {
+        return false;
+    }
+    link_adr->delivery_target = target_percent;
+    return true;
+}
+
+void smtc_link_adr_add_probe( smtc_link_adr_t* link_adr, bool answered )
+{
+    if( link_adr->probe_count >= SMTC_LINK_ADR_PROBE_WINDOW )
+    {
+        // Halve the statistics so that the older probes weigh less
+        link_adr->probe_count = ( link_adr->probe_count + 1 ) / 2;
+        link_adr->probe_lost  = ( link_adr->probe_lost + 1 ) / 2;
+    }
+    link_adr->probe_count++;
+    if( answered == false )
+    {
+        link_adr->probe_lost++;
+    }
+}
+
+uint8_t smtc_link_adr_get_nb_trans( const smtc_link_adr_t* link_adr, uint8_t max_nb_trans )
+{
+    if( ( link_adr->delivery_target == 0 ) || ( link_adr->probe_count < SMTC_LINK_ADR_PROBE_MIN ) )
+    {
+        return max_nb_trans;
+    }
+
+    // Probability in per mille that all the transmissions are lost
+    uint32_t loss_pm     = ( 1000 * ( uint32_t ) link_adr->probe_lost ) / link_adr->probe_count;
+    uint32_t residual_pm = loss_pm;
+    uint32_t allowed_pm  = 10 * ( 100 - ( uint32_t ) link_adr->delivery_target );
+    uint8_t  nb_trans    = 1;
+    while( ( residual_pm > allowed_pm ) && ( nb_trans < max_nb_trans ) )
+    {
+        residual_pm = ( residual_pm * loss_pm ) / 1000;
+        nb_trans++;
+    }
+    return nb_trans;
+}
+
+void smtc_link_adr_add_downlink( smtc_link_adr_t* link_adr, int8_t snr_db, lr1mac_bandwidth_t bw )
+{
+    smtc_link_adr_add_measurement( link_adr, ( 2 * ( int16_t ) snr_db ) + smtc_link_adr_get_bw_offset_half_db( bw ) );
+}
+
+void smtc_link_adr_add_link_check( smtc_link_adr_t* link_adr, uint8_t margin_db, uint8_t sf, lr1mac_bandwidth_t bw )
+{
+    // The margin is given above the floor of the uplink datarate, convert it back to a SNR
+    int16_t margin_half_db = ( margin_db > SMTC_LINK_ADR_MAX_MARGIN_DB ) ? ( 2 * SMTC_LINK_ADR_MAX_MARGIN_DB )
+                                                                         : ( 2 * ( int16_t ) margin_db );
+    // The uplink was sent below the maximum EIRP, the history describes the link at the maximum EIRP
+    margin_half_db += 2 * ( int16_t ) link_adr->power_reduction_db;
+    smtc_link_adr_add_measurement(
+        link_adr, margin_half_db + smtc_link_adr_get_floor_half_db( sf ) + smtc_link_adr_get_bw_offset_half_db( bw ) );
+}
+
+void smtc_link_adr_missed_ack( smtc_link_adr_t* link_adr )
+{
+    // Giving back transmit power costs less energy than a slower datarate
+    if( link_adr->power_reduction_db > 0 )
+    {
+        link_adr->power_reduction_db = ( link_adr->power_reduction_db > SMTC_LINK_ADR_POWER_STEP_DB )
+                                           ? ( link_adr->power_reduction_db - SMTC_LINK_ADR_POWER_STEP_DB )
+                                           : 0;
+        link_adr->power_hold = true;
+    }
+    else if( link_adr->backoff_dr < UINT8_MAX )
+    {
+        link_adr->backoff_dr++;
+    }
+}
+
+uint8_t smtc_link_adr_get_datarate( const smtc_link_adr_t* link_adr, smtc_real_t* real )
+{
+    uint16_t dr_mask = smtc_real_mask_tx_dr_channel_up_dwell_time_check( real );
+    uint8_t  min_dr  = smtc_real_get_min_tx_channel_dr( real );
+
+    if( link_adr->snr_count == 0 )
+    {
+        return min_dr;
+    }
+
+    int16_t worst_snr_half_db = smtc_link_adr_get_worst_snr_half_db( link_adr );
+
+    // Highest datarate index is not always the fastest (LR-FHSS, 250/500 kHz), compare the LoRa symbol durations
+    uint8_t  best_dr        = min_dr;
+    uint32_t best_symbol_us = UINT32_MAX;
+    for( uint8_t dr = 0; dr < 16; dr++ )
+    {
+        if( ( SMTC_GET_BIT16( &dr_mask, dr ) == 0 ) ||
+            ( smtc_real_get_modulation_type_from_datarate( real, dr ) != LORA ) )
+        {
+            continue;
+        }
+        uint8_t            sf;
+        lr1mac_bandwidth_t bw;
+        smtc_real_lora_dr_to_sf_bw( real, dr, &sf, &bw );
+
+        int16_t  required_half_db = smtc_link_adr_get_required_half_db( link_adr, sf, bw );
+        uint32_t symbol_us        = smtc_real_get_symbol_duration_us( real, dr );
+
+        if( ( worst_snr_half_db >= required_half_db ) && ( symbol_us < best_symbol_us ) )
+        {
+            best_symbol_us = symbol_us;
+            best_dr        = dr;
+        }
+    }
+
+    // Step down once for each acknowledgement lost since the last measurement
+    for( uint8_t i = 0; ( i < link_adr->backoff_dr ) && ( best_dr != min_dr ); i++ )
+    {
+        best_dr = smtc_real_decrement_dr_simulation( real, best_dr );
+    }
+    return best_dr;
+}
+
+bool smtc_link_adr_get_bulk_datarate( const smtc_link_adr_t* link_adr, smtc_real_t* real, uint8_t* datarate )
+{
+    // The history describes the link at the maximum EIRP, the bulk uplink is sent at the maximum EIRP
+    if( ( link_adr->bulk_enabled == false ) || ( link_adr->snr_count < SMTC_LINK_ADR_BULK_MIN_COUNT ) ||
+        ( link_adr->backoff_dr > 0 ) ||
+        ( smtc_link_adr_get_worst_snr_half_db( link_adr ) <
+          ( 2 * ( SMTC_LINK_ADR_FSK_FLOOR_DB + ( int16_t ) link_adr->margin_db ) ) ) )
+    {
+        return false;
+    }
+
+    uint16_t dr_mask = smtc_real_mask_tx_dr_channel_up_dwell_time_check( real );
+    for( uint8_t dr = 0; dr < 16; dr++ )
+    {
+        if( ( SMTC_GET_BIT16( &dr_mask, dr ) == 1 ) &&
+            ( smtc_real_get_modulation_type_from_datarate( real, dr ) == FSK ) )
+        {
+            *datarate = dr;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t smtc_link_adr_update_power_reduction( smtc_link_adr_t* link_adr, smtc_real_t* real, uint8_t datarate,
+                                              uint8_t max_reduction_db )
+{
+    if( link_adr->power_control_enabled == false )
+    {
+        return 0;
+    }
+
+    // Without measurement or for a non LoRa uplink the margin is unknown, keep the maximum EIRP
+    uint8_t target_db = 0;
+    if( ( link_adr->snr_count > 0 ) && ( smtc_real_get_modulation_type_from_datarate( real, datarate ) == LORA ) )
+    {
+        uint8_t            sf;
+        lr1mac_bandwidth_t bw;
+        smtc_real_lora_dr_to_sf_bw( real, datarate, &sf, &bw );
+
+        int16_t excess_half_db =
+            smtc_link_adr_get_worst_snr_half_db( link_adr ) - smtc_link_adr_get_required_half_db( link_adr, sf, bw );
+        if( excess_half_db > 0 )
+        {
+            int16_t steps = excess_half_db / ( 2 * SMTC_LINK_ADR_POWER_STEP_DB );
+            target_db     = ( steps * SMTC_LINK_ADR_POWER_STEP_DB > max_reduction_db )
+                                ? max_reduction_db
+                                : ( uint8_t ) ( steps * SMTC_LINK_ADR_POWER_STEP_DB );
+        }
+    }
+
+    if( target_db < link_adr->power_reduction_db )
+    {
+        link_adr->power_reduction_db = target_db;
+    }
+    else if( ( target_db > link_adr->power_reduction_db ) && ( link_adr->power_hold == false ) )
+    {
+        link_adr->power_reduction_db = ( target_db - link_adr->power_reduction_db > SMTC_LINK_ADR_POWER_STEP_DB )
+                                           ? ( link_adr->power_reduction_db + SMTC_LINK_ADR_POWER_STEP_DB )
+                                           : target_db;
+    }
+    return link_adr->power_reduction_db;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static int16_t smtc_link_adr_get_floor_half_db( uint8_t sf )
+{
+    return -( 15 + ( 5 * ( ( int16_t ) sf - 7 ) ) );
+}
+
+static int16_t smtc_link_adr_get_bw_offset_half_db( lr1mac_bandwidth_t bw )
+{
+    switch( bw )
+    {
+    case BW250:
+        return 6;
+    case BW500:
+        return 12;
+    case BW800:
+        return 16;
+    case BW1600:
+        return 22;
+    default:
+        return 0;
+    }
+}
+
+static void smtc_link_adr_add_measurement( smtc_link_adr_t* link_adr, int16_t snr_half_db )
+{
+    if( snr_half_db > INT8_MAX )
+    {
+        snr_half_db = INT8_MAX;
+    }
+    else if( snr_half_db < INT8_MIN )
+    {
+        snr_half_db = INT8_MIN;
+    }
+
+    link_adr->snr_half_db[link_adr->snr_index] = ( int8_t ) snr_half_db;
+    link_adr->snr_index                        = ( link_adr->snr_index + 1 ) % SMTC_LINK_ADR_HISTORY_SIZE;
+    if( link_adr->snr_count < SMTC_LINK_ADR_HISTORY_SIZE )
+    {
+        link_adr->snr_count++;
+    }
+    // A fresh measurement replaces the blind backoff
+    link_adr->backoff_dr = 0;
+    link_adr->power_hold = false;
+}
+
+static int16_t smtc_link_adr_get_worst_snr_half_db( const smtc_link_adr_t* link_adr )
+{
+    int16_t worst_snr_half_db = INT16_MAX;
+    for( uint8_t i = 0; i < link_adr->snr_count; i++ )
+    {
+        if( worst_snr_half_db > link_adr->snr_half_db[i] )
+        {
+            worst_snr_half_db = link_adr->snr_half_db[i];
+        }
+    }
+    return worst_snr_half_db;
+}
+
+static int16_t smtc_link_adr_get_required_half_db( const smtc_link_adr_t* link_adr, uint8_t sf,
+                                                   lr1mac_bandwidth_t bw )
+{
+    return smtc_link_adr_get_floor_half_db( sf ) + smtc_link_adr_get_bw_offset_half_db( bw ) +
+           ( 2 * ( int16_t ) link_adr->margin_db );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
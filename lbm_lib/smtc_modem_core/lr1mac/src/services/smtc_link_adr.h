@@ -0,0 +1,263 @@
+/*!
+ * \file      smtc_link_adr.h
+ *
+ * \brief     Device side datarate adaptation driven by the measured link margin
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __SMTC_LINK_ADR_H__
+#define __SMTC_LINK_ADR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_real_defs.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+/* clang-format off */
+#ifndef SMTC_LINK_ADR_HISTORY_SIZE
+#define SMTC_LINK_ADR_HISTORY_SIZE      ( 8 )   // Number of link measurements kept, the worst one is used
+#endif
+#ifndef SMTC_LINK_ADR_DEFAULT_MARGIN_DB
+#define SMTC_LINK_ADR_DEFAULT_MARGIN_DB ( 10 )  // Margin kept above the demodulation floor of the chosen datarate
+#endif
+#define SMTC_LINK_ADR_MAX_MARGIN_DB     ( 30 )
+#define SMTC_LINK_ADR_POWER_STEP_DB     ( 2 )   // Transmit power step of the power control
+#ifndef SMTC_LINK_ADR_PROBE_WINDOW
+#define SMTC_LINK_ADR_PROBE_WINDOW      ( 32 )  // Probes counted before the delivery statistics are halved
+#endif
+#define SMTC_LINK_ADR_PROBE_MIN         ( 4 )   // Probes needed before the number of transmissions is adapted
+#define SMTC_LINK_ADR_MAX_NB_TRANS      ( 15 )
+#ifndef SMTC_LINK_ADR_BULK_MIN_COUNT
+#define SMTC_LINK_ADR_BULK_MIN_COUNT    ( 3 )   // Measurements needed before a bulk uplink is sent with FSK
+#endif
+#define SMTC_LINK_ADR_FSK_FLOOR_DB      ( 12 )  // FSK floor as a 125 kHz SNR, about 20 dB above the SF7 one
+/* clang-format on */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+typedef struct smtc_link_adr_s
+{
+    int8_t  snr_half_db[SMTC_LINK_ADR_HISTORY_SIZE];  // Link SNR in 0.5 dB steps, brought back to a 125 kHz bandwidth
+    uint8_t snr_index;                                // Index of the next measurement to write
+    uint8_t snr_count;                                // Number of valid measurements
+    uint8_t margin_db;                                // Margin required above the demodulation floor
+    uint8_t backoff_dr;  // Datarate steps below the estimate, one more on each lost acknowledgement
+    bool    power_control_enabled;  // Lower the transmit power while the margin allows it
+    bool    power_hold;             // Power raised on a lost acknowledgement, not lowered until the next measurement
+    uint8_t power_reduction_db;     // Transmit power reduction below the maximum EIRP
+    uint8_t delivery_target;        // Frame delivery ratio in percent the transmissions aim at, 0 when disabled
+    uint8_t probe_count;            // Uplinks that expected an answer, halved each SMTC_LINK_ADR_PROBE_WINDOW
+    uint8_t probe_lost;             // Uplinks among them left without answer
+    bool    bulk_enabled;           // Send the bulk uplinks with FSK while the link margin allows it
+} smtc_link_adr_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Initialize the link measurements
+ *
+ * @param [out] link_adr    Link adaptation context
+ */
+void smtc_link_adr_init( smtc_link_adr_t* link_adr );
+
+/**
+ * @brief Forget the link measurements, the margin is kept
+ *
+ * @remark Called on a new session, the previous measurements do not describe the new network
+ *
+ * @param [in] link_adr     Link adaptation context
+ */
+void smtc_link_adr_reset( smtc_link_adr_t* link_adr );
+
+/**
+ * @brief Set the margin kept above the demodulation floor of the chosen datarate
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] margin_db    Margin in dB, up to SMTC_LINK_ADR_MAX_MARGIN_DB
+ * @return bool             false if the margin is out of range
+ */
+bool smtc_link_adr_set_margin( smtc_link_adr_t* link_adr, uint8_t margin_db );
+
+/**
+ * @brief Enable or disable the transmit power control
+ *
+ * @remark The power reduction restarts from the maximum EIRP in both cases
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] enable       true to lower the transmit power while the margin allows it
+ */
+void smtc_link_adr_set_power_control( smtc_link_adr_t* link_adr, bool enable );
+
+/**
+ * @brief Set the frame delivery ratio the number of transmissions of the unconfirmed uplinks aims at
+ *
+ * @param [in] link_adr         Link adaptation context
+ * @param [in] target_percent   Delivery ratio in percent, below 100, 0 to disable the adaptation
+ * @return bool                 false if the ratio is out of range
+ */
+bool smtc_link_adr_set_delivery_target( smtc_link_adr_t* link_adr, uint8_t target_percent );
+
+/**
+ * @brief Enable or disable the FSK datarate for the bulk uplinks
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] enable       true to send the bulk uplinks with FSK while the link margin allows it
+ */
+void smtc_link_adr_set_bulk( smtc_link_adr_t* link_adr, bool enable );
+
+/**
+ * @brief Add the outcome of an uplink transmission that expected an answer
+ *
+ * @remark Confirmed uplinks and LinkCheckReq are the probes. A lost answer may also be a lost downlink, the estimate is
+ * pessimistic.
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] answered     true if the acknowledgement or the LinkCheckAns was received
+ */
+void smtc_link_adr_add_probe( smtc_link_adr_t* link_adr, bool answered );
+
+/**
+ * @brief Get the lowest number of transmissions that reaches the delivery target
+ *
+ * @remark The transmissions are taken as independent: with a loss ratio q measured on the probes, n transmissions
+ * deliver a frame with a probability 1 - q^n. Without enough probes, or with the adaptation disabled, \p max_nb_trans
+ * is returned.
+ *
+ * @param [in] link_adr         Link adaptation context
+ * @param [in] max_nb_trans     Number of transmissions configured, never exceeded
+ * @return uint8_t              Number of transmissions of the next unconfirmed uplink
+ */
+uint8_t smtc_link_adr_get_nb_trans( const smtc_link_adr_t* link_adr, uint8_t max_nb_trans );
+
+/**
+ * @brief Add the SNR of a received LoRa downlink to the history
+ *
+ * @remark Any valid downlink also acknowledges the link, the lost acknowledgement backoff is cleared
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] snr_db       SNR of the downlink
+ * @param [in] bw           Bandwidth of the downlink
+ */
+void smtc_link_adr_add_downlink( smtc_link_adr_t* link_adr, int8_t snr_db, lr1mac_bandwidth_t bw );
+
+/**
+ * @brief Add the margin of a LinkCheckAns to the history
+ *
+ * @remark The margin is measured by the gateway on the uplink that carried the LinkCheckReq, it is brought back to the
+ * maximum EIRP with the power reduction in use
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] margin_db    Margin of the LinkCheckAns
+ * @param [in] sf           Spreading factor of the uplink
+ * @param [in] bw           Bandwidth of the uplink
+ */
+void smtc_link_adr_add_link_check( smtc_link_adr_t* link_adr, uint8_t margin_db, uint8_t sf, lr1mac_bandwidth_t bw );
+
+/**
+ * @brief Report an uplink that should have been answered and was not
+ *
+ * @remark With the power control, a reduced transmit power is raised by one step first, the datarate is stepped down
+ * once the power is back to its maximum
+ *
+ * @param [in] link_adr     Link adaptation context
+ */
+void smtc_link_adr_missed_ack( smtc_link_adr_t* link_adr );
+
+/**
+ * @brief Get the fastest LoRa datarate that keeps the margin on the worst link measurement
+ *
+ * @remark Without measurement, or if no datarate keeps the margin, the slowest allowed datarate is returned
+ *
+ * @param [in] link_adr     Link adaptation context
+ * @param [in] real         Regional parameters
+ * @return uint8_t          Datarate to use for the next uplinks
+ */
+uint8_t smtc_link_adr_get_datarate( const smtc_link_adr_t* link_adr, smtc_real_t* real );
+
+/**
+ * @brief Get the FSK datarate a bulk uplink can use
+ *
+ * @remark The FSK demodulation floor is taken SMTC_LINK_ADR_FSK_FLOOR_DB above the 125 kHz noise floor, the worst of at
+ * least SMTC_LINK_ADR_BULK_MIN_COUNT measurements must keep the margin above it at the maximum EIRP. A lost
+ * acknowledgement since the last measurement disables it.
+ *
+ * @param [in]  link_adr    Link adaptation context
+ * @param [in]  real        Regional parameters
+ * @param [out] datarate    FSK datarate allowed on the enabled channels
+ * @return bool             false if the bulk mode is disabled or if the link does not allow FSK
+ */
+bool smtc_link_adr_get_bulk_datarate( const smtc_link_adr_t* link_adr, smtc_real_t* real, uint8_t* datarate );
+
+/**
+ * @brief Update the transmit power reduction for the next uplink
+ *
+ * @remark The measured SNR in excess of the margin required by the datarate gives the reduction target. The reduction
+ * grows by one SMTC_LINK_ADR_POWER_STEP_DB step per call towards it, and drops to it at once when the margin is short.
+ * Called once per new uplink, never for a retransmission.
+ *
+ * @param [in] link_adr             Link adaptation context
+ * @param [in] real                 Regional parameters
+ * @param [in] datarate             Datarate of the next uplink
+ * @param [in] max_reduction_db     Reduction that brings the maximum EIRP to the lowest power of the region
+ * @return uint8_t                  Reduction to apply below the maximum EIRP, 0 if the power control is disabled
+ */
+uint8_t smtc_link_adr_update_power_reduction( smtc_link_adr_t* link_adr, smtc_real_t* real, uint8_t datarate,
+                                              uint8_t max_reduction_db );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_LINK_ADR_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -90,6 +90,11 @@
  */
 #define NB_CAD_SYMBOLS_IN_BO ( RAL_LORA_CAD_02_SYMB )
 
+/**
+ * @brief CAD_BT_BUSY_RATIO_WEIGHT Weight of the past CAD results in the busy ratio moving average
+ */
+#define CAD_BT_BUSY_RATIO_WEIGHT ( 8 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -111,6 +116,7 @@ static void     smtc_lora_cad_bt_rp_callback( smtc_lora_cad_bt_t* cad_obj );
 static void     smtc_lora_cad_bt_reset_to_difs_phase( smtc_lora_cad_bt_t* cad_obj );
 static void     smtc_lora_cad_bt_channel_is_free( smtc_lora_cad_bt_t* cad_obj );
 static uint32_t smtc_lora_cad_bt_get_symbol_duration_us( ral_lora_bw_t bw, ral_lora_sf_t sf );
+static void     smtc_lora_cad_bt_update_busy_history( smtc_lora_cad_bt_t* cad_obj, bool is_busy );
 
 /*
  * -----------------------------------------------------------------------------
@@ -237,7 +243,10 @@ void smtc_lora_cad_bt_listen_channel( smtc_lora_cad_bt_t* cad_obj, uint32_t freq
                 // the nb_bo is not recomputed when different not 0
                 if( cad_obj->nb_bo == 0 )
                 {
-                    cad_obj->nb_bo = smtc_modem_hal_get_random_nb_in_range( 1, cad_obj->nb_bo_max_conf );
+                    // Draw fewer back off on a quiet channel, up to nb_bo_max_conf when all recent CAD were positive
+                    uint8_t nb_bo_max =
+                        1 + ( ( cad_obj->nb_bo_max_conf - 1 ) * cad_obj->busy_ratio_percent + 50 ) / 100;
+                    cad_obj->nb_bo = smtc_modem_hal_get_random_nb_in_range( 1, nb_bo_max );
                     SMTC_MODEM_HAL_TRACE_PRINTF( "set nb_bo:%d, target_time %u\n", cad_obj->nb_bo, target_time_ms );
                 }
             }
@@ -285,6 +294,7 @@ void smtc_lora_cad_bt_listen_channel( smtc_lora_cad_bt_t* cad_obj, uint32_t freq
 
     lora_cad_param.ral_lora_cad_params.cad_det_peak_in_symb = cad_obj->detect_peak_offset + cad_det_peak;
 
+    cad_obj->listen_freq_hz        = freq_hz;
     lora_cad_param.rf_freq_in_hz   = freq_hz;
     lora_cad_param.invert_iq_is_on = invert_iq_is_on;
     lora_cad_param.sf              = sf;
@@ -333,6 +343,21 @@ void smtc_lora_cad_bt_listen_channel( smtc_lora_cad_bt_t* cad_obj, uint32_t freq
     }
 }
 
+bool smtc_lora_cad_bt_is_channel_recently_busy( smtc_lora_cad_bt_t* cad_obj, uint32_t freq_hz )
+{
+    uint32_t now_ms = smtc_modem_hal_get_time_in_ms( );
+
+    for( uint8_t i = 0; i < CAD_BT_CHANNEL_HISTORY_SIZE; i++ )
+    {
+        if( ( cad_obj->busy_freq_hz[i] == freq_hz ) &&
+            ( ( now_ms - cad_obj->busy_time_ms[i] ) < CAD_BT_CHANNEL_BUSY_HOLD_MS ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 smtc_lora_cad_bt_t* smtc_cad_get_obj( uint8_t stack_id )
 {
     if( stack_id < NUMBER_OF_STACKS )
@@ -382,6 +407,11 @@ static void smtc_lora_cad_bt_rp_callback( smtc_lora_cad_bt_t* cad_obj )
 
     cad_obj->is_cad_running = false;
 
+    if( ( rp_status == RP_STATUS_CAD_NEGATIVE ) || ( rp_status == RP_STATUS_CAD_POSITIVE ) )
+    {
+        smtc_lora_cad_bt_update_busy_history( cad_obj, rp_status == RP_STATUS_CAD_POSITIVE );
+    }
+
     if( rp_status == RP_STATUS_CAD_NEGATIVE )
     {
         // SMTC_MODEM_HAL_TRACE_PRINTF( "CAD_NEGATIF\n" );
@@ -457,6 +487,40 @@ static void smtc_lora_cad_bt_channel_is_free( smtc_lora_cad_bt_t* cad_obj )
     smtc_lora_cad_bt_reset_to_difs_phase( cad_obj );
 }
 
+static void smtc_lora_cad_bt_update_busy_history( smtc_lora_cad_bt_t* cad_obj, bool is_busy )
+{
+    uint8_t index = CAD_BT_CHANNEL_HISTORY_SIZE;
+
+    cad_obj->busy_ratio_percent =
+        ( ( cad_obj->busy_ratio_percent * ( CAD_BT_BUSY_RATIO_WEIGHT - 1 ) ) + ( ( is_busy == true ) ? 100 : 0 ) ) /
+        CAD_BT_BUSY_RATIO_WEIGHT;
+
+    for( uint8_t i = 0; i < CAD_BT_CHANNEL_HISTORY_SIZE; i++ )
+    {
+        if( cad_obj->busy_freq_hz[i] == cad_obj->listen_freq_hz )
+        {
+            index = i;
+            break;
+        }
+    }
+    if( is_busy == false )
+    {
+        if( index < CAD_BT_CHANNEL_HISTORY_SIZE )
+        {
+            cad_obj->busy_freq_hz[index] = 0;
+        }
+        return;
+    }
+    if( index == CAD_BT_CHANNEL_HISTORY_SIZE )
+    {
+        // Replace the oldest recorded channel
+        index                      = cad_obj->busy_history_next;
+        cad_obj->busy_history_next = ( cad_obj->busy_history_next + 1 ) % CAD_BT_CHANNEL_HISTORY_SIZE;
+    }
+    cad_obj->busy_freq_hz[index] = cad_obj->listen_freq_hz;
+    cad_obj->busy_time_ms[index] = smtc_modem_hal_get_time_in_ms( );
+}
+
 static uint32_t smtc_lora_cad_bt_get_symbol_duration_us( ral_lora_bw_t bw, ral_lora_sf_t sf )
 {
     uint32_t bw_temp = 125;  // temporary variable to store the bandwidth
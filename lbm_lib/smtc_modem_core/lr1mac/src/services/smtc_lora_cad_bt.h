@@ -57,6 +57,20 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Number of channels found busy which are remembered by the cad object
+ */
+#ifndef CAD_BT_CHANNEL_HISTORY_SIZE
+#define CAD_BT_CHANNEL_HISTORY_SIZE ( 4 )
+#endif
+
+/**
+ * @brief Duration during which a channel found busy is reported as recently busy
+ */
+#ifndef CAD_BT_CHANNEL_BUSY_HOLD_MS
+#define CAD_BT_CHANNEL_BUSY_HOLD_MS ( 10000 )
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -102,6 +116,13 @@ typedef struct smtc_lora_cad_bt_s
     uint8_t               max_ch_change_cnt;       // number of try to cad
     int8_t                detect_peak_offset;
 
+    /* channel access history */
+    uint8_t  busy_ratio_percent;                         // moving average of the positive CAD ratio
+    uint32_t listen_freq_hz;                             // frequency of the last CAD
+    uint32_t busy_freq_hz[CAD_BT_CHANNEL_HISTORY_SIZE];  // channels found busy, 0 if not used
+    uint32_t busy_time_ms[CAD_BT_CHANNEL_HISTORY_SIZE];  // time of the positive CAD
+    uint8_t  busy_history_next;                          // next history entry to be replaced
+
 } smtc_lora_cad_bt_t;
 
 /*
@@ -190,6 +211,15 @@ void smtc_lora_cad_bt_listen_channel( smtc_lora_cad_bt_t* cad_obj, uint32_t freq
                                       ral_lora_bw_t bandwidth, bool is_at_time, uint32_t target_time_ms,
                                       uint32_t tx_duration_ms, uint8_t nb_available_channel, bool invert_iq_is_on );
 
+/**
+ * @brief Check if a channel has been found busy by a recent CAD
+ *
+ * @param [in] cad_obj pointer to cad_obj itself
+ * @param [in] freq_hz channel frequency in hertz
+ * @return true if a CAD has been positive on this channel less than CAD_BT_CHANNEL_BUSY_HOLD_MS ago
+ */
+bool smtc_lora_cad_bt_is_channel_recently_busy( smtc_lora_cad_bt_t* cad_obj, uint32_t freq_hz );
+
 /**
  * @brief return the cad obj pointer with stack id as parameter
  * task
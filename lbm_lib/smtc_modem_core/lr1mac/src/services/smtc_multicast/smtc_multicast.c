@@ -103,6 +103,34 @@ static const smtc_multicast_key_t smtc_mc_skey_tab[LR1MAC_MC_NUMBER_OF_SESSION]
         .mc_ntw_skey = SMTC_SE_MC_NWK_S_KEY_3,
     },
 #endif
+#if LR1MAC_MC_NUMBER_OF_SESSION > 4
+    {
+        .mc_key      = SMTC_SE_MC_KEY_4,
+        .mc_app_skey = SMTC_SE_MC_APP_S_KEY_4,
+        .mc_ntw_skey = SMTC_SE_MC_NWK_S_KEY_4,
+    },
+#endif
+#if LR1MAC_MC_NUMBER_OF_SESSION > 5
+    {
+        .mc_key      = SMTC_SE_MC_KEY_5,
+        .mc_app_skey = SMTC_SE_MC_APP_S_KEY_5,
+        .mc_ntw_skey = SMTC_SE_MC_NWK_S_KEY_5,
+    },
+#endif
+#if LR1MAC_MC_NUMBER_OF_SESSION > 6
+    {
+        .mc_key      = SMTC_SE_MC_KEY_6,
+        .mc_app_skey = SMTC_SE_MC_APP_S_KEY_6,
+        .mc_ntw_skey = SMTC_SE_MC_NWK_S_KEY_6,
+    },
+#endif
+#if LR1MAC_MC_NUMBER_OF_SESSION > 7
+    {
+        .mc_key      = SMTC_SE_MC_KEY_7,
+        .mc_app_skey = SMTC_SE_MC_APP_S_KEY_7,
+        .mc_ntw_skey = SMTC_SE_MC_NWK_S_KEY_7,
+    },
+#endif
 };
 
 /*
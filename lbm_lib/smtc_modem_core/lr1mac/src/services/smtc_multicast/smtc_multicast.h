@@ -59,14 +59,6 @@ extern "C" {
  * -----------------------------------------------------------------------------
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
-#if !defined( LR1MAC_MC_NUMBER_OF_SESSION )
-#define LR1MAC_MC_NUMBER_OF_SESSION 4
-#else
-#if ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
-#error "LR1MAC_MC_NUMBER_OF_SESSION MAX is 4"
-#endif
-#endif
-
 #define LR1MAC_MC_NO_DATARATE 0xFF
 
 /*
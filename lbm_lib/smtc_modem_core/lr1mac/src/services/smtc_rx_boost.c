@@ -0,0 +1,133 @@
+/*!
+ * \file      smtc_rx_boost.c
+ *
+ * \brief     Choice of the boosted receiver gain from the margin of the last downlinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_rx_boost.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_rx_boost_reset( smtc_rx_boost_t* rx_boost )
+{
+    rx_boost->margin_index = 0;
+    rx_boost->margin_count = 0;
+    rx_boost->missed       = false;
+}
+
+void smtc_rx_boost_add_downlink( smtc_rx_boost_t* rx_boost, int16_t snr_db, uint8_t sf )
+{
+    // LoRa demodulation floor: -5 dB at SF6 then 2.5 dB lower per spreading factor, in 0.5 dB steps
+    int32_t floor_half_db = -10 - ( 5 * ( ( int32_t ) sf - 6 ) );
+    int32_t margin_db     = ( ( 2 * ( int32_t ) snr_db ) - floor_half_db ) / 2;
+
+    if( margin_db > INT8_MAX )
+    {
+        margin_db = INT8_MAX;
+    }
+    else if( margin_db < INT8_MIN )
+    {
+        margin_db = INT8_MIN;
+    }
+
+    rx_boost->margin_db[rx_boost->margin_index] = ( int8_t ) margin_db;
+    rx_boost->margin_index                      = ( rx_boost->margin_index + 1 ) % SMTC_RX_BOOST_HISTORY_SIZE;
+    if( rx_boost->margin_count < SMTC_RX_BOOST_HISTORY_SIZE )
+    {
+        rx_boost->margin_count++;
+    }
+    rx_boost->missed = false;
+}
+
+void smtc_rx_boost_missed_downlink( smtc_rx_boost_t* rx_boost )
+{
+    rx_boost->missed = true;
+}
+
+bool smtc_rx_boost_is_needed( const smtc_rx_boost_t* rx_boost )
+{
+    if( ( rx_boost->margin_count < SMTC_RX_BOOST_MIN_SAMPLES ) || ( rx_boost->missed == true ) )
+    {
+        return true;
+    }
+
+    for( uint8_t i = 0; i < rx_boost->margin_count; i++ )
+    {
+        if( rx_boost->margin_db[i] < SMTC_RX_BOOST_MARGIN_DB )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
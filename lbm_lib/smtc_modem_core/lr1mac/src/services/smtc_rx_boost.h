@@ -0,0 +1,130 @@
+/*!
+ * \file      smtc_rx_boost.h
+ *
+ * \brief     Choice of the boosted receiver gain from the margin of the last downlinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMTC_RX_BOOST_H__
+#define __SMTC_RX_BOOST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+/* clang-format off */
+#ifndef SMTC_RX_BOOST_HISTORY_SIZE
+#define SMTC_RX_BOOST_HISTORY_SIZE  ( 4 )  // Number of downlink margins kept, the smallest one is used
+#endif
+#ifndef SMTC_RX_BOOST_MIN_SAMPLES
+#define SMTC_RX_BOOST_MIN_SAMPLES   ( 2 )  // Margins needed before the power saving gain is used
+#endif
+#ifndef SMTC_RX_BOOST_MARGIN_DB
+#define SMTC_RX_BOOST_MARGIN_DB     ( 6 )  // Margin above the demodulation floor under which the gain is boosted,
+                                           // larger than the sensitivity loss of the power saving gain
+#endif
+/* clang-format on */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+typedef struct smtc_rx_boost_s
+{
+    int8_t  margin_db[SMTC_RX_BOOST_HISTORY_SIZE];  // Downlink SNR minus the demodulation floor of its spreading factor
+    uint8_t margin_index;                           // Index of the next margin to write
+    uint8_t margin_count;                           // Number of valid margins
+    bool    missed;                                 // An expected downlink was not received since the last margin
+} smtc_rx_boost_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Forget the downlink margins, the next windows use the boosted gain
+ *
+ * @param [out] rx_boost    Gain policy
+ */
+void smtc_rx_boost_reset( smtc_rx_boost_t* rx_boost );
+
+/**
+ * @brief Add the margin of a valid LoRa downlink
+ *
+ * @param [in] rx_boost     Gain policy
+ * @param [in] snr_db       SNR of the downlink
+ * @param [in] sf           Spreading factor of the downlink, 5 to 12
+ */
+void smtc_rx_boost_add_downlink( smtc_rx_boost_t* rx_boost, int16_t snr_db, uint8_t sf );
+
+/**
+ * @brief Report an expected downlink that was not received (confirmed uplink left without acknowledgement)
+ *
+ * @remark The gain stays boosted until the next valid downlink
+ *
+ * @param [in] rx_boost     Gain policy
+ */
+void smtc_rx_boost_missed_downlink( smtc_rx_boost_t* rx_boost );
+
+/**
+ * @brief Check if the next reception window shall use the boosted gain
+ *
+ * @param [in] rx_boost     Gain policy
+ * @return true until SMTC_RX_BOOST_MIN_SAMPLES margins are known, after a missed downlink, or when one of the last
+ *         margins is below SMTC_RX_BOOST_MARGIN_DB
+ */
+bool smtc_rx_boost_is_needed( const smtc_rx_boost_t* rx_boost );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_RX_BOOST_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,128 @@
+/*!
+ * \file      smtc_rx_drift.c
+ *
+ * \brief     RX1/RX2 window sizing from the measured arrival time of the downlinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_rx_drift.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void smtc_rx_drift_reset( smtc_rx_drift_t* rx_drift )
+{
+    rx_drift->offset_index = 0;
+    rx_drift->offset_count = 0;
+}
+
+void smtc_rx_drift_add_downlink( smtc_rx_drift_t* rx_drift, int32_t offset_ms )
+{
+    if( offset_ms > INT8_MAX )
+    {
+        offset_ms = INT8_MAX;
+    }
+    else if( offset_ms < -INT8_MAX )
+    {
+        offset_ms = -INT8_MAX;
+    }
+
+    rx_drift->offset_ms[rx_drift->offset_index] = ( int8_t ) offset_ms;
+    rx_drift->offset_index                      = ( rx_drift->offset_index + 1 ) % SMTC_RX_DRIFT_HISTORY_SIZE;
+    if( rx_drift->offset_count < SMTC_RX_DRIFT_HISTORY_SIZE )
+    {
+        rx_drift->offset_count++;
+    }
+}
+
+int32_t smtc_rx_drift_get_margin_ms( const smtc_rx_drift_t* rx_drift )
+{
+    if( rx_drift->offset_count < SMTC_RX_DRIFT_MIN_SAMPLES )
+    {
+        return SMTC_RX_DRIFT_NO_MARGIN;
+    }
+
+    int32_t worst_offset_ms = 0;
+    for( uint8_t i = 0; i < rx_drift->offset_count; i++ )
+    {
+        int32_t offset_ms = rx_drift->offset_ms[i];
+        if( offset_ms < 0 )
+        {
+            offset_ms = -offset_ms;
+        }
+        if( offset_ms > worst_offset_ms )
+        {
+            worst_offset_ms = offset_ms;
+        }
+    }
+    return worst_offset_ms + SMTC_RX_DRIFT_GUARD_MS;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
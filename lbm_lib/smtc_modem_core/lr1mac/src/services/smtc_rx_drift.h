@@ -0,0 +1,122 @@
+/*!
+ * \file      smtc_rx_drift.h
+ *
+ * \brief     RX1/RX2 window sizing from the measured arrival time of the downlinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __SMTC_RX_DRIFT_H__
+#define __SMTC_RX_DRIFT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+/* clang-format off */
+#ifndef SMTC_RX_DRIFT_HISTORY_SIZE
+#define SMTC_RX_DRIFT_HISTORY_SIZE  ( 8 )  // Number of arrival offsets kept, the largest one is used
+#endif
+#ifndef SMTC_RX_DRIFT_MIN_SAMPLES
+#define SMTC_RX_DRIFT_MIN_SAMPLES   ( 4 )  // Arrival offsets needed before the windows are narrowed
+#endif
+#ifndef SMTC_RX_DRIFT_GUARD_MS
+#define SMTC_RX_DRIFT_GUARD_MS      ( 2 )  // Added to the largest offset: 1 ms resolution of the Tx done and Rx done
+                                           // timestamps
+#endif
+#define SMTC_RX_DRIFT_NO_MARGIN     ( -1 )
+/* clang-format on */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+typedef struct smtc_rx_drift_s
+{
+    int8_t  offset_ms[SMTC_RX_DRIFT_HISTORY_SIZE];  // Downlink start minus its expected start
+    uint8_t offset_index;                           // Index of the next offset to write
+    uint8_t offset_count;                           // Number of valid offsets
+} smtc_rx_drift_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Forget the arrival offsets, the next windows use the full margin
+ *
+ * @remark Called at init, on a new session and when a confirmed uplink got no answer: a window that may have been too
+ * narrow must not stay narrow
+ *
+ * @param [out] rx_drift    Drift estimator
+ */
+void smtc_rx_drift_reset( smtc_rx_drift_t* rx_drift );
+
+/**
+ * @brief Add the arrival offset of a valid downlink received in RX1 or RX2
+ *
+ * @param [in] rx_drift     Drift estimator
+ * @param [in] offset_ms    Start of the downlink minus Tx done plus the receive delay
+ */
+void smtc_rx_drift_add_downlink( smtc_rx_drift_t* rx_drift, int32_t offset_ms );
+
+/**
+ * @brief Get the timing margin to keep on each side of the expected downlink start
+ *
+ * @param [in] rx_drift     Drift estimator
+ * @return int32_t          Largest arrival offset plus SMTC_RX_DRIFT_GUARD_MS, SMTC_RX_DRIFT_NO_MARGIN until
+ *                          SMTC_RX_DRIFT_MIN_SAMPLES offsets are known
+ */
+int32_t smtc_rx_drift_get_margin_ms( const smtc_rx_drift_t* rx_drift );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SMTC_RX_DRIFT_H__
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -202,11 +202,12 @@ void region_as_923_config( smtc_real_t* real )
     memset( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_AS923 );
 }
 
-status_lorawan_t region_as_923_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_as_923_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb )
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
-    return region_as_923_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency, active_channel_nb );
+    return region_as_923_get_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
+                                           active_channel_nb );
 }
 
 status_lorawan_t region_as_923_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
@@ -338,6 +339,21 @@ void region_as_923_fsk_dr_to_bitrate( uint8_t in_dr, uint8_t* out_bitrate )
     }
 }
 
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_as_923_ops = {
+    .config                            = region_as_923_config,
+    .get_next_channel                  = region_as_923_get_next_channel,
+    .get_join_next_channel             = region_as_923_get_join_next_channel,
+    .build_channel_mask                = region_as_923_build_channel_mask,
+    .get_modulation_type_from_datarate = region_as_923_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                  = region_as_923_lora_dr_to_sf_bw,
+    .fsk_dr_to_bitrate                 = region_as_923_fsk_dr_to_bitrate,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -61,6 +61,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Region operations used by smtc_real
+ */
+extern const smtc_real_region_ops_t region_au_915_ops;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -100,7 +105,7 @@ status_lorawan_t region_au_915_get_next_channel( smtc_real_t* real, uint8_t tx_d
  */
 status_lorawan_t region_au_915_get_join_next_channel( smtc_real_t* real, uint8_t* out_tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb );
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb );
 /**
  * \brief
  * \remark
@@ -122,6 +127,24 @@ void region_au_915_set_channel_mask( smtc_real_t* real );
  * \param [OUT] return
  */
 void region_au_915_init_join_snapshot_channel_mask( smtc_real_t* real );
+#if defined( ADD_FAST_JOIN )
+/**
+ * @brief Get the channel of the last join request
+ *
+ * @param [in] real Pointer to the regional object
+ * @return uint8_t channel index
+ */
+uint8_t region_au_915_get_join_channel( smtc_real_t* real );
+
+/**
+ * @brief Send the next join request on this channel, at the datarate of its sub-band, then go on with the sub-band
+ * cycle after it
+ *
+ * @param [in] real        Pointer to the regional object
+ * @param [in] channel_idx Channel index, ignored if not enabled
+ */
+void region_au_915_set_fast_join_channel( smtc_real_t* real, uint8_t channel_idx );
+#endif
 /**
  * \brief
  * \remark
@@ -150,8 +173,7 @@ void region_au_915_enable_all_channels_with_valid_freq( smtc_real_t* real );
  * \param [IN]  none
  * \param [OUT] return
  */
-status_lorawan_t region_au_915_is_acceptable_tx_dr( smtc_real_t* real, uint8_t dr, bool is_ch_mask_from_link_adr,
-                                                    bool uplink_dwell_time );
+status_lorawan_t region_au_915_is_acceptable_tx_dr( smtc_real_t* real, uint8_t dr, bool is_ch_mask_from_link_adr );
 
 /**
  * @brief Get the corresponding RF modulation from a Datarate
@@ -213,6 +235,14 @@ uint32_t region_au_915_get_rx_beacon_frequency_channel( smtc_real_t* real, uint3
  */
 uint32_t region_au_915_get_rx_ping_slot_frequency_channel( smtc_real_t* real, uint32_t gps_time_s, uint32_t dev_addr );
 
+/**
+ * @brief Get the number of ChMask blocks in a CFList
+ *
+ * @param real
+ * @return uint8_t
+ */
+uint8_t region_au_915_get_number_of_chmask_in_cflist( smtc_real_t* real );
+
 #ifdef __cplusplus
 }
 #endif
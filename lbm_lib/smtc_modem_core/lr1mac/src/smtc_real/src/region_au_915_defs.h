@@ -162,6 +162,9 @@ typedef struct region_au915_context_s
     uint8_t  custom_dr_distribution_init[NUMBER_OF_TX_DR_AU_915];
     uint8_t  first_ch_mask_received;
     uint8_t  tx_channel_idx;
+#if defined( ADD_FAST_JOIN )
+    uint8_t fast_join_channel_idx;  // Channel of the next join request, SMTC_REAL_NO_JOIN_CHANNEL once used
+#endif
 
     au_915_channels_bank_t snapshot_bank_tx_mask;
 
@@ -294,7 +294,7 @@ void region_cn_470_config_session( smtc_real_t* real )
 #endif
 }
 
-status_lorawan_t region_cn_470_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_cn_470_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
                                                       uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
@@ -307,7 +307,7 @@ status_lorawan_t region_cn_470_get_join_next_channel( smtc_real_t* real, uint8_t
         if( ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
             ( common_join_channel_cn_470[i][0] != 0 ) )
         {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 )
+            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], *tx_data_rate ) == 1 )
             {
                 active_channel_index[*active_channel_nb] = i;
                 ( *active_channel_nb )++;
@@ -344,20 +344,10 @@ status_lorawan_t region_cn_470_get_join_next_channel( smtc_real_t* real, uint8_t
 status_lorawan_t region_cn_470_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
                                                  uint32_t* out_rx1_frequency, uint8_t* active_channel_nb )
 {
-    *active_channel_nb = 0;
     uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_CN_470];
-
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-    {
-        if( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED )
-        {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 )
-            {
-                active_channel_index[*active_channel_nb] = i;
-                ( *active_channel_nb )++;
-            }
-        }
-    }
+    *active_channel_nb = lr1mac_utilities_get_active_channels( channel_index_enabled, NULL, dr_bitfield_tx_channel,
+                                                               tx_data_rate, real_const.const_number_of_tx_channel,
+                                                               active_channel_index );
 
     if( *active_channel_nb == 0 )
     {
@@ -739,6 +729,28 @@ uint32_t region_cn_470_get_rx_ping_slot_frequency_channel( smtc_real_t* real, ui
     return freq;
 }
 
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_cn_470_ops = {
+    .config                              = region_cn_470_config,
+    .get_next_channel                    = region_cn_470_get_next_channel,
+    .get_join_next_channel               = region_cn_470_get_join_next_channel,
+    .build_channel_mask                  = region_cn_470_build_channel_mask,
+    .get_modulation_type_from_datarate   = region_cn_470_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                    = region_cn_470_lora_dr_to_sf_bw,
+    .config_session                      = region_cn_470_config_session,
+    .get_number_of_chmask_in_cflist      = region_cn_470_get_number_of_chmask_in_cflist,
+    .enable_all_channels_with_valid_freq = region_cn_470_enable_all_channels_with_valid_freq,
+    .get_tx_frequency_channel            = region_cn_470_get_tx_frequency_channel,
+    .get_rx1_frequency_channel           = region_cn_470_get_rx1_frequency_channel,
+    .get_rx_beacon_frequency_channel     = region_cn_470_get_rx_beacon_frequency_channel,
+    .get_rx_ping_slot_frequency_channel  = region_cn_470_get_rx_ping_slot_frequency_channel,
+    .fsk_dr_to_bitrate                   = region_cn_470_fsk_dr_to_bitrate,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -182,9 +182,9 @@ void region_cn_470_rp_1_0_config( smtc_real_t* real )
 #endif
 }
 
-status_lorawan_t region_cn_470_rp_1_0_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_cn_470_rp_1_0_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                              uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                             uint8_t* active_channel_nb )
+                                                             uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
 #if defined( HYBRID_CN470_MONO_CHANNEL )
     uint8_t err           = true;
@@ -222,7 +222,7 @@ status_lorawan_t region_cn_470_rp_1_0_get_join_next_channel( smtc_real_t* real,
         for( uint8_t i = snapshot_bank_tx_mask * 8; i < ( ( snapshot_bank_tx_mask * 8 ) + 8 ); i++ )
         {
             if( ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
-                ( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 ) )
+                ( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], *tx_data_rate ) == 1 ) )
             {
                 active_channel_index[*active_channel_nb] = i;
                 ( *active_channel_nb )++;
@@ -283,20 +283,10 @@ status_lorawan_t region_cn_470_rp_1_0_get_next_channel( smtc_real_t* real, uint8
 
     return OKLORAWAN;
 #endif
-    *active_channel_nb = 0;
     uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_CN_470_RP_1_0];
-
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-    {
-        if( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED )
-        {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 )
-            {
-                active_channel_index[*active_channel_nb] = i;
-                ( *active_channel_nb )++;
-            }
-        }
-    }
+    *active_channel_nb = lr1mac_utilities_get_active_channels( channel_index_enabled, NULL, dr_bitfield_tx_channel,
+                                                               tx_data_rate, real_const.const_number_of_tx_channel,
+                                                               active_channel_index );
 
     if( *active_channel_nb == 0 )
     {
@@ -437,6 +427,26 @@ uint32_t region_cn_470_rp_1_0_get_rx_ping_slot_frequency_channel( smtc_real_t* r
     return ( PING_SLOT_FREQ_START_CN_470_RP_1_0 + ( ( index % 8 ) * PING_SLOT_STEP_CN_470_RP_1_0 ) );
 }
 
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_cn_470_rp_1_0_ops = {
+    .config                              = region_cn_470_rp_1_0_config,
+    .get_next_channel                    = region_cn_470_rp_1_0_get_next_channel,
+    .get_join_next_channel               = region_cn_470_rp_1_0_get_join_next_channel,
+    .build_channel_mask                  = region_cn_470_rp_1_0_build_channel_mask,
+    .get_modulation_type_from_datarate   = region_cn_470_rp_1_0_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                    = region_cn_470_rp_1_0_lora_dr_to_sf_bw,
+    .get_number_of_chmask_in_cflist      = region_cn_470_rp_1_0_get_number_of_chmask_in_cflist,
+    .enable_all_channels_with_valid_freq = region_cn_470_rp_1_0_enable_all_channels_with_valid_freq,
+    .get_tx_frequency_channel            = region_cn_470_rp_1_0_get_tx_frequency_channel,
+    .get_rx1_frequency_channel           = region_cn_470_rp_1_0_get_rx1_frequency_channel,
+    .get_rx_beacon_frequency_channel     = region_cn_470_rp_1_0_get_rx_beacon_frequency_channel,
+    .get_rx_ping_slot_frequency_channel  = region_cn_470_rp_1_0_get_rx_ping_slot_frequency_channel,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
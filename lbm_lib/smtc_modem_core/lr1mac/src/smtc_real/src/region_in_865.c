@@ -171,11 +171,12 @@ void region_in_865_config( smtc_real_t* real )
     memset( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_IN865 );
 }
 
-status_lorawan_t region_in_865_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_in_865_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb )
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
-    return region_in_865_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency, active_channel_nb );
+    return region_in_865_get_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
+                                           active_channel_nb );
 }
 
 status_lorawan_t region_in_865_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
@@ -308,6 +309,21 @@ void region_in_865_fsk_dr_to_bitrate( uint8_t in_dr, uint8_t* out_bitrate )
     }
 }
 
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_in_865_ops = {
+    .config                            = region_in_865_config,
+    .get_next_channel                  = region_in_865_get_next_channel,
+    .get_join_next_channel             = region_in_865_get_join_next_channel,
+    .build_channel_mask                = region_in_865_build_channel_mask,
+    .get_modulation_type_from_datarate = region_in_865_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                  = region_in_865_lora_dr_to_sf_bw,
+    .fsk_dr_to_bitrate                 = region_in_865_fsk_dr_to_bitrate,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
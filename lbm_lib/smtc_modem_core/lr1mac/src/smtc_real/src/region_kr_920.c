@@ -174,11 +174,12 @@ void region_kr_920_config( smtc_real_t* real )
     memset( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_KR920 );
 }
 
-status_lorawan_t region_kr_920_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_kr_920_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb )
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
-    return region_kr_920_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency, active_channel_nb );
+    return region_kr_920_get_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
+                                           active_channel_nb );
 }
 
 status_lorawan_t region_kr_920_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
@@ -306,6 +307,34 @@ void region_kr_920_lora_dr_to_sf_bw( uint8_t in_dr, uint8_t* out_sf, lr1mac_band
     }
 }
 
+int8_t region_kr_920_clamp_output_power_eirp( smtc_real_t* real, int8_t tx_power, uint32_t tx_frequency,
+                                              uint8_t datarate )
+{
+    if( tx_frequency < 922000000 )
+    {
+        return MIN( tx_power, 10 );  // if freq < 922MHz, Max output power is limited to 10 dBm
+    }
+    else
+    {
+        return MIN( tx_power, TX_POWER_EIRP_KR_920 );  // else Max output power is limited to 14 dBm
+    }
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_kr_920_ops = {
+    .config                            = region_kr_920_config,
+    .get_next_channel                  = region_kr_920_get_next_channel,
+    .get_join_next_channel             = region_kr_920_get_join_next_channel,
+    .build_channel_mask                = region_kr_920_build_channel_mask,
+    .get_modulation_type_from_datarate = region_kr_920_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                  = region_kr_920_lora_dr_to_sf_bw,
+    .clamp_output_power_eirp           = region_kr_920_clamp_output_power_eirp,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -61,6 +61,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Region operations used by smtc_real
+ */
+extern const smtc_real_region_ops_t region_kr_920_ops;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -94,9 +99,9 @@ status_lorawan_t region_kr_920_get_next_channel( smtc_real_t* real, uint8_t tx_d
  * \param [IN]  none
  * \param [OUT] return
  */
-status_lorawan_t region_kr_920_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_kr_920_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb );
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb );
 /**
  * \brief
  * \remark
@@ -136,6 +141,18 @@ modulation_type_t region_kr_920_get_modulation_type_from_datarate( uint8_t datar
  */
 void region_kr_920_lora_dr_to_sf_bw( uint8_t in_dr, uint8_t* out_sf, lr1mac_bandwidth_t* out_bw );
 
+/**
+ * @brief Clamp the output power EIRP to the limit of the frequency
+ *
+ * @param real
+ * @param tx_power
+ * @param tx_frequency
+ * @param datarate
+ * @return int8_t
+ */
+int8_t region_kr_920_clamp_output_power_eirp( smtc_real_t* real, int8_t tx_power, uint32_t tx_frequency,
+                                              uint8_t datarate );
+
 #ifdef __cplusplus
 }
 #endif
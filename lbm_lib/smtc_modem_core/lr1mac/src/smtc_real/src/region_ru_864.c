@@ -178,11 +178,12 @@ void region_ru_864_config( smtc_real_t* real )
     memset( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_RU864 );
 }
 
-status_lorawan_t region_ru_864_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_ru_864_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb )
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
-    return region_ru_864_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency, active_channel_nb );
+    return region_ru_864_get_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
+                                           active_channel_nb );
 }
 
 status_lorawan_t region_ru_864_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
@@ -210,7 +211,20 @@ status_lorawan_t region_ru_864_get_next_channel( smtc_real_t* real, uint8_t tx_d
         SMTC_MODEM_HAL_TRACE_WARNING( "NO CHANNELS AVAILABLE \n" );
         return ERRORLORAWAN;
     }
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+    // Draw only among the channels whose band can carry the frame without running out of duty cycle budget
+    uint8_t candidate_channel_nb = smtc_duty_cycle_select_channels_for_toa(
+        tx_frequency_channel, active_channel_index, *active_channel_nb, real_ctx.next_tx_toa_ms_ctx );
+    if( candidate_channel_nb < *active_channel_nb )
+    {
+        real_ctx.dtc_rerouted_uplinks_ctx++;
+        real_ctx.dtc_rerouted_toa_ms_ctx += real_ctx.next_tx_toa_ms_ctx;
+    }
+    uint8_t temp =
+        ( smtc_modem_hal_get_random_nb_in_range( 0, ( candidate_channel_nb - 1 ) ) ) % candidate_channel_nb;
+#else
     uint8_t temp = ( smtc_modem_hal_get_random_nb_in_range( 0, ( *active_channel_nb - 1 ) ) ) % *active_channel_nb;
+#endif
     uint8_t channel_idx = 0;
     channel_idx         = active_channel_index[temp];
     if( channel_idx >= real_const.const_number_of_tx_channel )
@@ -317,6 +331,21 @@ void region_ru_864_fsk_dr_to_bitrate( uint8_t in_dr, uint8_t* out_bitrate )
     }
 }
 
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_ru_864_ops = {
+    .config                            = region_ru_864_config,
+    .get_next_channel                  = region_ru_864_get_next_channel,
+    .get_join_next_channel             = region_ru_864_get_join_next_channel,
+    .build_channel_mask                = region_ru_864_build_channel_mask,
+    .get_modulation_type_from_datarate = region_ru_864_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                  = region_ru_864_lora_dr_to_sf_bw,
+    .fsk_dr_to_bitrate                 = region_ru_864_fsk_dr_to_bitrate,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
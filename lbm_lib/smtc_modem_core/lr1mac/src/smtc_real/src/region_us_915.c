@@ -63,6 +63,9 @@
 #define snapshot_channel_tx_mask real->region.us915.snapshot_channel_tx_mask
 #define snapshot_bank_tx_mask real->region.us915.snapshot_bank_tx_mask
 #define tx_channel_idx real->region.us915.tx_channel_idx
+#if defined( ADD_FAST_JOIN )
+#define fast_join_channel_idx real->region.us915.fast_join_channel_idx
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -165,6 +168,9 @@ void region_us_915_init( smtc_real_t* real )
     memset( &snapshot_channel_tx_mask[0], 0xFF, BANK_MAX_US915 );
 
     snapshot_bank_tx_mask = 0;
+#if defined( ADD_FAST_JOIN )
+    fast_join_channel_idx = SMTC_REAL_NO_JOIN_CHANNEL;
+#endif
 }
 
 void region_us_915_config( smtc_real_t* real )
@@ -255,10 +261,27 @@ status_lorawan_t region_us_915_is_acceptable_tx_dr( smtc_real_t* real, uint8_t d
 
 status_lorawan_t region_us_915_get_join_next_channel( smtc_real_t* real, uint8_t* out_tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb )
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
     us_915_channels_bank_t bank_tmp_cnt = 0;
     uint8_t                active_channel_index[NUMBER_OF_TX_CHANNEL_US_915];
+
+#if defined( ADD_FAST_JOIN )
+    if( fast_join_channel_idx != SMTC_REAL_NO_JOIN_CHANNEL )
+    {
+        tx_channel_idx        = fast_join_channel_idx;
+        fast_join_channel_idx = SMTC_REAL_NO_JOIN_CHANNEL;
+
+        // The sub-band cycle goes on with the bank following the one of the last accepted join
+        snapshot_bank_tx_mask = ( us_915_channels_bank_t ) ( ( tx_channel_idx / 8 ) + 1 );
+        *active_channel_nb    = 1;
+        *out_tx_data_rate     = ( tx_channel_idx >= ( BANK_8_500_US915 * 8 ) ) ? DR4 : DR0;
+        *out_tx_frequency     = region_us_915_get_tx_frequency_channel( real, tx_channel_idx );
+        *out_rx1_frequency    = region_us_915_get_rx1_frequency_channel( real, tx_channel_idx );
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Join on the channel %u of the last accepted join\n", tx_channel_idx );
+        return OKLORAWAN;
+    }
+#endif
     do
     {
         if( snapshot_bank_tx_mask > BANK_8_500_US915 )
@@ -386,18 +409,10 @@ status_lorawan_t region_us_915_get_next_channel( smtc_real_t* real, uint8_t tx_d
     }
 
     // Seach all active channels and put in array to be randomly select
-    *active_channel_nb = 0;
     uint8_t active_channel_index[NUMBER_OF_TX_CHANNEL_US_915];
-    for( uint8_t i = 0; i < NUMBER_OF_TX_CHANNEL_US_915; i++ )
-    {
-        if( ( SMTC_GET_BIT8( snapshot_channel_tx_mask, i ) == CHANNEL_ENABLED ) &&
-            ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
-            ( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], tx_data_rate ) == 1 ) )
-        {
-            active_channel_index[*active_channel_nb] = i;
-            ( *active_channel_nb )++;
-        }
-    }
+    *active_channel_nb =
+        lr1mac_utilities_get_active_channels( channel_index_enabled, snapshot_channel_tx_mask, dr_bitfield_tx_channel,
+                                              tx_data_rate, NUMBER_OF_TX_CHANNEL_US_915, active_channel_index );
     if( *active_channel_nb == 0 )
     {
         SMTC_MODEM_HAL_PANIC( "NO CHANNELS AVAILABLE\n" );
@@ -453,6 +468,22 @@ void region_us_915_init_join_snapshot_channel_mask( smtc_real_t* real )
     snapshot_bank_tx_mask = 0;
 }
 
+#if defined( ADD_FAST_JOIN )
+uint8_t region_us_915_get_join_channel( smtc_real_t* real )
+{
+    return tx_channel_idx;
+}
+
+void region_us_915_set_fast_join_channel( smtc_real_t* real, uint8_t channel_idx )
+{
+    if( ( channel_idx < NUMBER_OF_TX_CHANNEL_US_915 ) &&
+        ( SMTC_GET_BIT8( channel_index_enabled, channel_idx ) == CHANNEL_ENABLED ) )
+    {
+        fast_join_channel_idx = channel_idx;
+    }
+}
+#endif
+
 void region_us_915_init_after_join_snapshot_channel_mask( smtc_real_t* real, uint8_t tx_data_rate,
                                                           uint32_t tx_frequency )
 {
@@ -712,6 +743,68 @@ uint32_t region_us_915_get_rx_ping_slot_frequency_channel( smtc_real_t* real, ui
     return ( PING_SLOT_FREQ_START_US_915 + ( index * PING_SLOT_STEP_US_915 ) );
 }
 
+uint8_t region_us_915_get_number_of_chmask_in_cflist( smtc_real_t* real )
+{
+    return 5;
+}
+
+int8_t region_us_915_clamp_output_power_eirp( smtc_real_t* real, int8_t tx_power, uint32_t tx_frequency,
+                                              uint8_t datarate )
+{
+    if( datarate == DR4 )
+    {
+        return MIN( tx_power, 26 );
+    }
+
+    uint8_t channel_counter = 0;
+    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    {
+        if( ( SMTC_GET_BIT8( channel_index_enabled, i ) == CHANNEL_ENABLED ) &&
+            ( SMTC_GET_BIT16( &dr_bitfield_tx_channel[i], datarate ) == 1 ) )
+        {
+            channel_counter++;
+        }
+    }
+    // Frequency hopping on less than 50 channels limits the output power to 21 dBm
+    if( channel_counter < 50 )
+    {
+        return MIN( tx_power, 21 );
+    }
+    return tx_power;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_us_915_ops = {
+    .config                                = region_us_915_config,
+    .get_next_channel                      = region_us_915_get_next_channel,
+    .get_join_next_channel                 = region_us_915_get_join_next_channel,
+    .build_channel_mask                    = region_us_915_build_channel_mask,
+    .get_modulation_type_from_datarate     = region_us_915_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                      = region_us_915_lora_dr_to_sf_bw,
+    .mask_channel_used_for_tx              = region_us_915_mask_channel_used_for_tx,
+    .init_join_snapshot_channel_mask       = region_us_915_init_join_snapshot_channel_mask,
+    .init_after_join_snapshot_channel_mask = region_us_915_init_after_join_snapshot_channel_mask,
+#if defined( ADD_FAST_JOIN )
+    .get_join_channel                      = region_us_915_get_join_channel,
+    .set_fast_join_channel                 = region_us_915_set_fast_join_channel,
+#endif
+    .get_number_of_chmask_in_cflist        = region_us_915_get_number_of_chmask_in_cflist,
+    .set_channel_mask                      = region_us_915_set_channel_mask,
+    .enable_all_channels_with_valid_freq   = region_us_915_enable_all_channels_with_valid_freq,
+    .is_acceptable_tx_dr                   = region_us_915_is_acceptable_tx_dr,
+    .clamp_output_power_eirp               = region_us_915_clamp_output_power_eirp,
+    .get_tx_frequency_channel              = region_us_915_get_tx_frequency_channel,
+    .get_rx1_frequency_channel             = region_us_915_get_rx1_frequency_channel,
+    .get_rx_beacon_frequency_channel       = region_us_915_get_rx_beacon_frequency_channel,
+    .get_rx_ping_slot_frequency_channel    = region_us_915_get_rx_ping_slot_frequency_channel,
+    .lr_fhss_dr_to_cr_bw                   = region_us_915_lr_fhss_dr_to_cr_bw,
+    .lr_fhss_grid                          = LR_FHSS_V1_GRID_25391_HZ,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
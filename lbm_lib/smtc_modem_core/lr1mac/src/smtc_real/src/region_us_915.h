@@ -61,6 +61,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Region operations used by smtc_real
+ */
+extern const smtc_real_region_ops_t region_us_915_ops;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -100,7 +105,7 @@ status_lorawan_t region_us_915_get_next_channel( smtc_real_t* real, uint8_t tx_d
  */
 status_lorawan_t region_us_915_get_join_next_channel( smtc_real_t* real, uint8_t* out_tx_data_rate,
                                                       uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                      uint8_t* active_channel_nb );
+                                                      uint32_t* out_rx2_frequency, uint8_t* active_channel_nb );
 /**
  * \brief Mask the channel used, to be remove for the next selection
  * \remark
@@ -122,6 +127,24 @@ void region_us_915_set_channel_mask( smtc_real_t* real );
  * \param [OUT] return
  */
 void region_us_915_init_join_snapshot_channel_mask( smtc_real_t* real );
+#if defined( ADD_FAST_JOIN )
+/**
+ * @brief Get the channel of the last join request
+ *
+ * @param [in] real Pointer to the regional object
+ * @return uint8_t channel index
+ */
+uint8_t region_us_915_get_join_channel( smtc_real_t* real );
+
+/**
+ * @brief Send the next join request on this channel, at the datarate of its sub-band, then go on with the sub-band
+ * cycle after it
+ *
+ * @param [in] real        Pointer to the regional object
+ * @param [in] channel_idx Channel index, ignored if not enabled
+ */
+void region_us_915_set_fast_join_channel( smtc_real_t* real, uint8_t channel_idx );
+#endif
 /**
  * \brief
  * \remark
@@ -211,6 +234,27 @@ uint32_t region_us_915_get_rx_beacon_frequency_channel( smtc_real_t* real, uint3
  * @return uint32_t
  */
 uint32_t region_us_915_get_rx_ping_slot_frequency_channel( smtc_real_t* real, uint32_t gps_time_s, uint32_t dev_addr );
+
+/**
+ * @brief Get the number of ChMask blocks in a CFList
+ *
+ * @param real
+ * @return uint8_t
+ */
+uint8_t region_us_915_get_number_of_chmask_in_cflist( smtc_real_t* real );
+
+/**
+ * @brief Clamp the output power EIRP to the FCC limits of the datarate and enabled channels
+ *
+ * @param real
+ * @param tx_power
+ * @param tx_frequency
+ * @param datarate
+ * @return int8_t
+ */
+int8_t region_us_915_clamp_output_power_eirp( smtc_real_t* real, int8_t tx_power, uint32_t tx_frequency,
+                                              uint8_t datarate );
+
 #ifdef __cplusplus
 }
 #endif
@@ -179,11 +179,11 @@ void region_ww2g4_config( smtc_real_t* real )
     memset( &unwrapped_channel_mask[0], 0xFF, BANK_MAX_WW2G4 );
 }
 
-status_lorawan_t region_ww2g4_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_ww2g4_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                      uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                     uint8_t* active_channel_nb )
+                                                     uint32_t* out_rx2_frequency, uint8_t* active_channel_nb )
 {
-    return region_ww2g4_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency, active_channel_nb );
+    return region_ww2g4_get_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency, active_channel_nb );
 }
 
 status_lorawan_t region_ww2g4_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
@@ -310,6 +310,20 @@ void region_ww2g4_lora_dr_to_sf_bw( uint8_t in_dr, uint8_t* out_sf, lr1mac_bandw
     }
 }
 
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS DEFINITION ---------------------------------------------
+ */
+
+const smtc_real_region_ops_t region_ww2g4_ops = {
+    .config                            = region_ww2g4_config,
+    .get_next_channel                  = region_ww2g4_get_next_channel,
+    .get_join_next_channel             = region_ww2g4_get_join_next_channel,
+    .build_channel_mask                = region_ww2g4_build_channel_mask,
+    .get_modulation_type_from_datarate = region_ww2g4_get_modulation_type_from_datarate,
+    .lora_dr_to_sf_bw                  = region_ww2g4_lora_dr_to_sf_bw,
+};
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -61,6 +61,11 @@ extern "C" {
  * --- PUBLIC CONSTANTS --------------------------------------------------------
  */
 
+/**
+ * @brief Region operations used by smtc_real
+ */
+extern const smtc_real_region_ops_t region_ww2g4_ops;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -98,9 +103,9 @@ status_lorawan_t region_ww2g4_get_next_channel( smtc_real_t* real, uint8_t tx_da
  * \param [IN]  none
  * \param [OUT] return
  */
-status_lorawan_t region_ww2g4_get_join_next_channel( smtc_real_t* real, uint8_t tx_data_rate,
+status_lorawan_t region_ww2g4_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate,
                                                      uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
-                                                     uint8_t* active_channel_nb );
+                                                     uint32_t* out_rx2_frequency, uint8_t* active_channel_nb );
 /**
  * \brief
  * \remark
@@ -98,6 +98,55 @@
 #define custom_dr_distribution_init_ctx real_ctx.custom_dr_distribution_init_ctx
 #define uplink_dwell_time_ctx real_ctx.uplink_dwell_time_ctx
 #define downlink_dwell_time_ctx real_ctx.downlink_dwell_time_ctx
+#define tx_dr_mask_ctx real_ctx.tx_dr_mask_ctx
+#define tx_dr_mask_dwell_time_ctx real_ctx.tx_dr_mask_dwell_time_ctx
+#define tx_dr_mask_valid_ctx real_ctx.tx_dr_mask_valid_ctx
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/**
+ * @brief Rebuild the datarate masks of the enabled channels
+ *
+ * @remark The masks are kept until a channel, the channel mask or the uplink dwell time changes
+ *
+ * @param [in] real Pointer to the regional context
+ */
+static void smtc_real_update_tx_dr_mask( smtc_real_t* real )
+{
+    uint16_t dr_mask = 0;
+    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    {
+        if( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED )
+        {
+            dr_mask |= dr_bitfield_tx_channel_ctx[i];
+        }
+    }
+    tx_dr_mask_ctx = dr_mask;
+
+    if( uplink_dwell_time_ctx == true )
+    {
+        for( uint8_t i = 0; i < real_const.const_min_tx_dr_limit; i++ )
+        {
+            SMTC_PUT_BIT16( &dr_mask, i, false );
+        }
+    }
+    tx_dr_mask_dwell_time_ctx = dr_mask;
+    tx_dr_mask_valid_ctx      = true;
+}
+
+/**
+ * @brief Check if the region uses a fixed channel plan that the network cannot modify
+ *
+ * @param [in] real Pointer to the regional context
+ * @return true when the channels are computed by the region from their index
+ */
+static inline bool smtc_real_is_fixed_channel_plan( const smtc_real_t* real )
+{
+    return ( real->region_ops->get_tx_frequency_channel != NULL );
+}
 
 smtc_real_status_t smtc_real_is_supported_region( smtc_real_region_types_t region_type )
 {
@@ -128,31 +177,37 @@ void smtc_real_init( smtc_real_t* real, smtc_real_region_types_t region_type )
     {
 #if defined( REGION_WW2G4 )
     case SMTC_REAL_REGION_WW2G4: {
+        real->region_ops = &region_ww2g4_ops;
         region_ww2g4_init( real );
         break;
     }
 #endif
 #if defined( REGION_EU_868 )
     case SMTC_REAL_REGION_EU_868: {
+        real->region_ops = &region_eu_868_ops;
         region_eu_868_init( real );
         break;
     }
 #endif
 #if defined( REGION_AS_923 )
     case SMTC_REAL_REGION_AS_923: {
+        real->region_ops = &region_as_923_ops;
         region_as_923_init( real, 1 );
         break;
     }
     case SMTC_REAL_REGION_AS_923_GRP2: {
+        real->region_ops = &region_as_923_ops;
         region_as_923_init( real, 2 );
         break;
     }
     case SMTC_REAL_REGION_AS_923_GRP3: {
+        real->region_ops = &region_as_923_ops;
         region_as_923_init( real, 3 );
         break;
     }
 #if defined( RP2_103 )
     case SMTC_REAL_REGION_AS_923_GRP4: {
+        real->region_ops = &region_as_923_ops;
         region_as_923_init( real, 4 );
         break;
     }
@@ -160,42 +215,49 @@ void smtc_real_init( smtc_real_t* real, smtc_real_region_types_t region_type )
 #endif
 #if defined( REGION_US_915 )
     case SMTC_REAL_REGION_US_915: {
+        real->region_ops = &region_us_915_ops;
         region_us_915_init( real );
         break;
     }
 #endif
 #if defined( REGION_AU_915 )
     case SMTC_REAL_REGION_AU_915: {
+        real->region_ops = &region_au_915_ops;
         region_au_915_init( real );
         break;
     }
 #endif
 #if defined( REGION_CN_470 )
     case SMTC_REAL_REGION_CN_470: {
+        real->region_ops = &region_cn_470_ops;
         region_cn_470_init( real );
         break;
     }
 #endif
 #if defined( REGION_CN_470_RP_1_0 )
     case SMTC_REAL_REGION_CN_470_RP_1_0: {
+        real->region_ops = &region_cn_470_rp_1_0_ops;
         region_cn_470_rp_1_0_init( real );
         break;
     }
 #endif
 #if defined( REGION_IN_865 )
     case SMTC_REAL_REGION_IN_865: {
+        real->region_ops = &region_in_865_ops;
         region_in_865_init( real );
         break;
     }
 #endif
 #if defined( REGION_KR_920 )
     case SMTC_REAL_REGION_KR_920: {
+        real->region_ops = &region_kr_920_ops;
         region_kr_920_init( real );
         break;
     }
 #endif
 #if defined( REGION_RU_864 )
     case SMTC_REAL_REGION_RU_864: {
+        real->region_ops = &region_ru_864_ops;
         region_ru_864_init( real );
         break;
     }
@@ -210,139 +272,20 @@ void smtc_real_init( smtc_real_t* real, smtc_real_region_types_t region_type )
 
 void smtc_real_config( smtc_real_t* real )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        region_ww2g4_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        region_eu_868_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-    {
-        region_as_923_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        region_cn_470_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        region_cn_470_rp_1_0_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        region_in_865_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        region_kr_920_config( real );
-        break;
-    }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        region_ru_864_config( real );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
+    real->region_ops->config( real );
 
     uplink_dwell_time_ctx   = real_const.const_uplink_dwell_time;
     downlink_dwell_time_ctx = false;
+    tx_dr_mask_valid_ctx    = false;
 }
 
 void smtc_real_config_session( smtc_real_t* real )
 {
-    switch( real->region_type )
+    if( real->region_ops->config_session != NULL )
     {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_US_915 ) || \
-    defined( REGION_AU_915 ) || defined( REGION_IN_865 ) || defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-    {
-        // Not used for these regions
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        region_cn_470_config_session( real );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        // Not used for these regions
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
+        real->region_ops->config_session( real );
     }
+    tx_dr_mask_valid_ctx = false;
 }
 
 void smtc_real_set_join_dr_distribution( smtc_real_t* real, uint8_t* adr_custom )
@@ -405,7 +348,9 @@ status_lorawan_t smtc_real_get_next_tx_dr( smtc_real_t* real, join_status_t join
 {
     for( int j = 0; j < 224; j++ )  // return error after 224 trials
     {
-        if( ( *adr_mode_select == STATIC_ADR_MODE ) && ( join_status == JOINED ) )
+        // LINK_QUALITY_DR_DISTRIBUTION uses the datarate computed by the device in tx_data_rate_adr, without ADR bit
+        if( ( ( *adr_mode_select == STATIC_ADR_MODE ) || ( *adr_mode_select == LINK_QUALITY_DR_DISTRIBUTION ) ) &&
+            ( join_status == JOINED ) )
         {
             if( uplink_dwell_time_ctx == true )
             {
@@ -417,7 +362,7 @@ status_lorawan_t smtc_real_get_next_tx_dr( smtc_real_t* real, join_status_t join
             {
                 *tx_data_rate = tx_data_rate_adr;
             }
-            *adr_enable = 1;
+            *adr_enable = ( *adr_mode_select == STATIC_ADR_MODE ) ? 1 : 0;
         }
         else
         {
@@ -478,6 +423,8 @@ status_lorawan_t smtc_real_update_cflist( smtc_real_t* real, uint8_t* cf_list )
     status_lorawan_t status       = OKLORAWAN;
     cf_list_type_t   cf_list_type = cf_list[15];
 
+    tx_dr_mask_valid_ctx = false;
+
     if( smtc_real_cf_list_type_supported( real ) != cf_list_type )
     {
         SMTC_MODEM_HAL_TRACE_WARNING( "INVALID CFList type for this region (%d)\n", cf_list_type );
@@ -578,609 +525,159 @@ status_lorawan_t smtc_real_update_cflist( smtc_real_t* real, uint8_t* cf_list )
 
 uint8_t smtc_real_get_number_of_chmask_in_cflist( smtc_real_t* real )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
+    if( real->region_ops->get_number_of_chmask_in_cflist != NULL )
     {
-        return 0;
+        return real->region_ops->get_number_of_chmask_in_cflist( real );
     }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_US_915 ) || defined( REGION_AU_915 )
+    return 0;
+}
+
+status_lorawan_t smtc_real_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
+                                             uint32_t* out_rx1_frequency, uint8_t* out_nb_available_tx_channel )
+{
+    return real->region_ops->get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
+                                               out_nb_available_tx_channel );
+}
+
+status_lorawan_t smtc_real_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate, uint32_t* out_tx_frequency,
+                                                  uint32_t* out_rx1_frequency, uint32_t* out_rx2_frequency,
+                                                  uint8_t* out_nb_available_tx_channel )
+{
+    return real->region_ops->get_join_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
+                                                    out_rx2_frequency, out_nb_available_tx_channel );
+}
+
+void smtc_real_mask_channel_used_for_tx( smtc_real_t* real )
+{
+    // Mask the channel used, to be remove for the next selection
+    if( real->region_ops->mask_channel_used_for_tx != NULL )
     {
-        return 5;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_number_of_chmask_in_cflist( real );
+        real->region_ops->mask_channel_used_for_tx( real );
     }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_number_of_chmask_in_cflist( real );
+}
+
+uint8_t smtc_real_get_rx1_datarate_config( smtc_real_t* real, uint8_t tx_data_rate, uint8_t rx1_dr_offset )
+{
+    uint8_t max   = real_const.const_number_of_tx_dr * real_const.const_number_rx1_dr_offset;
+    uint8_t index = ( tx_data_rate * real_const.const_number_rx1_dr_offset ) + rx1_dr_offset;
+
+#if defined( REGION_AS_923 )
+    if( real->region_type == SMTC_REAL_REGION_AS_923 )
+    {
+        max *= ( downlink_dwell_time_ctx + 1 );
+        index += ( downlink_dwell_time_ctx * real_const.const_number_of_tx_dr * real_const.const_number_rx1_dr_offset );
     }
 #endif
-    default:
+
+    if( index >= max )
+    {
         SMTC_MODEM_HAL_PANIC( );
-        break;
     }
-    return ERRORLORAWAN;  // never reach => avoid warning
+    return real_const.const_datarate_offsets[index];
 }
 
-status_lorawan_t smtc_real_get_next_channel( smtc_real_t* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
-                                             uint32_t* out_rx1_frequency, uint8_t* out_nb_available_tx_channel )
+int8_t smtc_real_convert_power_cmd( smtc_real_t* real, uint8_t power_cmd, uint8_t max_erp_dbm )
 {
-    switch( real->region_type )
+    if( power_cmd > real_const.const_max_tx_power_idx )
     {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        return region_ww2g4_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                              out_nb_available_tx_channel );
+        SMTC_MODEM_HAL_TRACE_WARNING( "INVALID %d \n", power_cmd );
+        return max_erp_dbm;
     }
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        return region_eu_868_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
+    else
+    {
+        int8_t pwr_tmp = max_erp_dbm - ( 2 * power_cmd );
+        return ( pwr_tmp < 0 ) ? 0 : pwr_tmp;
     }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
+}
+
+int8_t smtc_real_get_min_tx_power( smtc_real_t* real, uint8_t max_erp_dbm )
+{
+    return smtc_real_convert_power_cmd( real, real_const.const_max_tx_power_idx, max_erp_dbm );
+}
+
+void smtc_real_set_channel_mask( smtc_real_t* real )
+{
+    tx_dr_mask_valid_ctx = false;
+    if( real->region_ops->set_channel_mask != NULL )
     {
-        return region_as_923_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
+        real->region_ops->set_channel_mask( real );
+        return;
     }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
+
+    // Copy all unwrapped channels in channel enable
+    memcpy( channel_index_enabled_ctx, unwrapped_channel_mask_ctx, real_const.const_number_of_channel_bank );
+
+#if MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON
+    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %d ", SMTC_GET_BIT8( channel_index_enabled_ctx, i ) );
     }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                      out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        return region_in_865_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        return region_kr_920_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        return region_ru_864_get_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                               out_nb_available_tx_channel );
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " \n" );
+#endif  // MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON
 }
 
-status_lorawan_t smtc_real_get_join_next_channel( smtc_real_t* real, uint8_t* tx_data_rate, uint32_t* out_tx_frequency,
-                                                  uint32_t* out_rx1_frequency, uint32_t* out_rx2_frequency,
-                                                  uint8_t* out_nb_available_tx_channel )
+void smtc_real_init_channel_mask( smtc_real_t* real )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        return region_ww2g4_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                   out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        return region_eu_868_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-    {
-        return region_as_923_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_join_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_join_next_channel( real, tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_rx2_frequency, out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                           out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        return region_in_865_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        return region_kr_920_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        return region_ru_864_get_join_next_channel( real, *tx_data_rate, out_tx_frequency, out_rx1_frequency,
-                                                    out_nb_available_tx_channel );
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
+    memset( unwrapped_channel_mask_ctx, 0xFF, real_const.const_number_of_channel_bank );
 }
 
-void smtc_real_mask_channel_used_for_tx( smtc_real_t* real )
+void smtc_real_init_join_snapshot_channel_mask( smtc_real_t* real )
 {
-    // Mask the channel used, to be remove for the next selection
-
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 ) || defined( REGION_CN_470 ) ||                            \
-    defined( REGION_CN_470_RP_1_0 )
+    if( real->region_ops->init_join_snapshot_channel_mask != NULL )
     {
-        // Not used for these regions
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-        region_us_915_mask_channel_used_for_tx( real );
-        break;
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-        region_au_915_mask_channel_used_for_tx( real );
-        break;
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
+        real->region_ops->init_join_snapshot_channel_mask( real );
     }
 }
 
-uint8_t smtc_real_get_rx1_datarate_config( smtc_real_t* real, uint8_t tx_data_rate, uint8_t rx1_dr_offset )
+void smtc_real_init_after_join_snapshot_channel_mask( smtc_real_t* real, uint8_t tx_data_rate, uint32_t tx_frequency )
 {
-    uint8_t max   = real_const.const_number_of_tx_dr * real_const.const_number_rx1_dr_offset;
-    uint8_t index = ( tx_data_rate * real_const.const_number_rx1_dr_offset ) + rx1_dr_offset;
-
-#if defined( REGION_AS_923 )
-    if( real->region_type == SMTC_REAL_REGION_AS_923 )
+    tx_dr_mask_valid_ctx = false;
+    if( real->region_ops->init_after_join_snapshot_channel_mask != NULL )
     {
-        max *= ( downlink_dwell_time_ctx + 1 );
-        index += ( downlink_dwell_time_ctx * real_const.const_number_of_tx_dr * real_const.const_number_rx1_dr_offset );
-    }
-#endif
-
-    if( index >= max )
-    {
-        SMTC_MODEM_HAL_PANIC( );
+        real->region_ops->init_after_join_snapshot_channel_mask( real, tx_data_rate, tx_frequency );
     }
-    return real_const.const_datarate_offsets[index];
 }
 
-int8_t smtc_real_convert_power_cmd( smtc_real_t* real, uint8_t power_cmd, uint8_t max_erp_dbm )
+status_channel_t smtc_real_build_channel_mask( smtc_real_t* real, uint8_t ch_mask_cntl, uint16_t ch_mask )
 {
-    if( power_cmd > real_const.const_max_tx_power_idx )
-    {
-        SMTC_MODEM_HAL_TRACE_WARNING( "INVALID %d \n", power_cmd );
-        return max_erp_dbm;
-    }
-    else
-    {
-        int8_t pwr_tmp = max_erp_dbm - ( 2 * power_cmd );
-        return ( pwr_tmp < 0 ) ? 0 : pwr_tmp;
-    }
+    return real->region_ops->build_channel_mask( real, ch_mask_cntl, ch_mask );
 }
 
-void smtc_real_set_channel_mask( smtc_real_t* real )
+uint8_t smtc_real_decrement_dr_simulation( smtc_real_t* real, uint8_t tx_data_rate_adr )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_CN_470 ) || \
-    defined( REGION_CN_470_RP_1_0 ) || defined( REGION_IN_865 ) || defined( REGION_KR_920 ) ||                     \
-    defined( REGION_RU_864 )
-        // Copy all unwrapped channels in channel enable
-        memcpy( channel_index_enabled_ctx, unwrapped_channel_mask_ctx, real_const.const_number_of_channel_bank );
+    bool    is_valid_dr          = false;
+    uint8_t data_rate_simulation = tx_data_rate_adr;
 
-#if MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON
-        for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    // while( ( data_rate_simulation > real_const.const_min_tx_dr ) && ( is_valid_dr == 0 ) )
+    while( data_rate_simulation > real_const.const_min_tx_dr )
+    {
+        uint8_t index = ( uplink_dwell_time_ctx * real_const.const_number_of_tx_dr ) + data_rate_simulation;
+        if( index > ( real_const.const_max_tx_dr * ( uplink_dwell_time_ctx + 1 ) ) )
         {
-            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %d ", SMTC_GET_BIT8( channel_index_enabled_ctx, i ) );
+            SMTC_MODEM_HAL_PANIC( );
         }
-        SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " \n" );
-#endif  // MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON
-        break;
-#endif
+        data_rate_simulation = real_const.const_datarate_backoff[index];
 
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_set_channel_mask( real );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_set_channel_mask( real );
-        break;
+        if( smtc_real_is_tx_dr_acceptable( real, data_rate_simulation, false ) == OKLORAWAN )
+        {
+            is_valid_dr = true;
+            break;
+        }
     }
-#endif
 
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
+    // no lower valid DR found
+    if( is_valid_dr == false )
+    {
+        return tx_data_rate_adr;
     }
-}
 
-void smtc_real_init_channel_mask( smtc_real_t* real )
-{
-    memset( unwrapped_channel_mask_ctx, 0xFF, real_const.const_number_of_channel_bank );
+    return data_rate_simulation;
 }
 
-void smtc_real_init_join_snapshot_channel_mask( smtc_real_t* real )
+void smtc_real_decrement_dr( smtc_real_t* real, dr_strategy_t adr_mode_select, uint8_t* tx_data_rate_adr,
+                             int8_t* tx_power, uint8_t* nb_trans )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_CN_470 ) || \
-    defined( REGION_CN_470_RP_1_0 ) || defined( REGION_IN_865 ) || defined( REGION_KR_920 ) ||                     \
-    defined( REGION_RU_864 )
-    {
-        // Not used for these regions
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_init_join_snapshot_channel_mask( real );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_init_join_snapshot_channel_mask( real );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-}
-
-void smtc_real_init_after_join_snapshot_channel_mask( smtc_real_t* real, uint8_t tx_data_rate, uint32_t tx_frequency )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_CN_470 ) || \
-    defined( REGION_CN_470_RP_1_0 ) || defined( REGION_IN_865 ) || defined( REGION_KR_920 ) ||                     \
-    defined( REGION_RU_864 )
-    {
-        // Not used for these regions
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_init_after_join_snapshot_channel_mask( real, tx_data_rate, tx_frequency );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_init_after_join_snapshot_channel_mask( real, tx_data_rate, tx_frequency );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-}
-
-status_channel_t smtc_real_build_channel_mask( smtc_real_t* real, uint8_t ch_mask_cntl, uint16_t ch_mask )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        return region_ww2g4_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        return region_eu_868_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-    {
-        return region_as_923_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        return region_in_865_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        return region_kr_920_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        return region_ru_864_build_channel_mask( real, ch_mask_cntl, ch_mask );
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERROR_CHANNEL;  // never reach => avoid warning
-}
-
-uint8_t smtc_real_decrement_dr_simulation( smtc_real_t* real, uint8_t tx_data_rate_adr )
-{
-    bool    is_valid_dr          = false;
-    uint8_t data_rate_simulation = tx_data_rate_adr;
-
-    // while( ( data_rate_simulation > real_const.const_min_tx_dr ) && ( is_valid_dr == 0 ) )
-    while( data_rate_simulation > real_const.const_min_tx_dr )
-    {
-        uint8_t index = ( uplink_dwell_time_ctx * real_const.const_number_of_tx_dr ) + data_rate_simulation;
-        if( index > ( real_const.const_max_tx_dr * ( uplink_dwell_time_ctx + 1 ) ) )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        data_rate_simulation = real_const.const_datarate_backoff[index];
-
-        if( smtc_real_is_tx_dr_acceptable( real, data_rate_simulation, false ) == OKLORAWAN )
-        {
-            is_valid_dr = true;
-            break;
-        }
-    }
-
-    // no lower valid DR found
-    if( is_valid_dr == false )
-    {
-        return tx_data_rate_adr;
-    }
-
-    return data_rate_simulation;
-}
-
-void smtc_real_decrement_dr( smtc_real_t* real, dr_strategy_t adr_mode_select, uint8_t* tx_data_rate_adr,
-                             int8_t* tx_power, uint8_t* nb_trans )
-{
-    if( adr_mode_select != STATIC_ADR_MODE )
+    if( adr_mode_select != STATIC_ADR_MODE )
     {
         return;
     }
@@ -1201,1273 +698,468 @@ void smtc_real_decrement_dr( smtc_real_t* real, dr_strategy_t adr_mode_select, u
         }
     }
 
-    //  nb_trans must set to 1 and all default channels re-enabled
-    *nb_trans = 1;
-    // reach this step only if tx_dr = MinDr => enable default channel
-    smtc_real_enable_all_channels_with_valid_freq( real );
-
-    // When all channels are available, lower datarate could be present in case where only DR6 and DR7 was present
-    // previously
-    *tx_data_rate_adr = smtc_real_decrement_dr_simulation( real, *tx_data_rate_adr );
-}
-
-void smtc_real_enable_all_channels_with_valid_freq( smtc_real_t* real )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-    {
-        for( uint8_t i = 0; i < real_const.const_number_of_boot_tx_channel; i++ )
-        {
-            SMTC_PUT_BIT8( channel_index_enabled_ctx, i, CHANNEL_ENABLED );
-            dr_bitfield_tx_channel_ctx[i] = real_const.const_default_tx_dr_bit_field;
-        }
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        region_cn_470_enable_all_channels_with_valid_freq( real );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        region_cn_470_rp_1_0_enable_all_channels_with_valid_freq( real );
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_enable_all_channels_with_valid_freq( real );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_enable_all_channels_with_valid_freq( real );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-}
-
-status_lorawan_t smtc_real_is_rx1_dr_offset_valid( smtc_real_t* real, uint8_t rx1_dr_offset )
-{
-    status_lorawan_t status = OKLORAWAN;
-    if( rx1_dr_offset >= real_const.const_number_rx1_dr_offset )
-    {
-        status = ERRORLORAWAN;
-        SMTC_MODEM_HAL_TRACE_WARNING( "RECEIVE AN INVALID RX1 DR OFFSET \n" );
-    }
-    return ( status );
-}
-
-status_lorawan_t smtc_real_is_rx_dr_valid( smtc_real_t* real, uint8_t dr )
-{
-    if( ( dr >= real_const.const_min_rx_dr ) && ( dr <= real_const.const_max_rx_dr ) )
-    {
-        if( SMTC_GET_BIT16( &real_const.const_dr_bitfield, dr ) == 1 )
-        {
-            return ( OKLORAWAN );
-        }
-    }
-    SMTC_MODEM_HAL_TRACE_WARNING( "Invalid Rx datarate %d\n", dr );
-
-    return ( ERRORLORAWAN );
-}
-
-status_lorawan_t smtc_real_is_tx_dr_valid( smtc_real_t* real, uint8_t dr )
-{
-    if( ( dr >= real_const.const_min_tx_dr ) && ( dr <= real_const.const_max_tx_dr ) )
-    {
-        if( SMTC_GET_BIT16( &real_const.const_dr_bitfield, dr ) == 1 )
-        {
-            return ( OKLORAWAN );
-        }
-    }
-    SMTC_MODEM_HAL_TRACE_WARNING( "Invalid Tx datarate %d\n", dr );
-
-    return ( ERRORLORAWAN );
-}
-
-status_lorawan_t smtc_real_is_tx_dr_acceptable( smtc_real_t* real, uint8_t dr, bool is_ch_mask_from_link_adr )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_CN_470 ) || \
-    defined( REGION_CN_470_RP_1_0 ) || defined( REGION_IN_865 ) || defined( REGION_KR_920 ) ||                     \
-    defined( REGION_RU_864 )
-    {
-        uint8_t* ch_mask_to_check =
-            ( is_ch_mask_from_link_adr == true ) ? unwrapped_channel_mask_ctx : channel_index_enabled_ctx;
-
-        if( uplink_dwell_time_ctx == true )
-        {
-            if( dr < real_const.const_min_tx_dr_limit )
-            {
-                return ERRORLORAWAN;
-            }
-        }
-
-        for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-        {
-            if( SMTC_GET_BIT8( ch_mask_to_check, i ) == CHANNEL_ENABLED )
-            {
-                SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "ch%d - dr field 0x%04x\n", i, dr_bitfield_tx_channel_ctx[i] );
-                if( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 )
-                {
-                    return ( OKLORAWAN );
-                }
-            }
-        }
-
-        SMTC_MODEM_HAL_TRACE_WARNING( "Not acceptable data rate\n" );
-        return ( ERRORLORAWAN );
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-        return region_us_915_is_acceptable_tx_dr( real, dr, is_ch_mask_from_link_adr );
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-        return region_au_915_is_acceptable_tx_dr( real, dr, is_ch_mask_from_link_adr, uplink_dwell_time_ctx );
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
-}
-
-status_lorawan_t smtc_real_is_nwk_received_tx_frequency_valid( smtc_real_t* real, uint32_t frequency )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-    {
-        status_lorawan_t status = OKLORAWAN;
-        if( frequency == 0 )
-        {
-            return ( status );
-        }
-        status = smtc_real_is_frequency_valid( real, frequency );
-        return ( status );
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_US_915 ) || defined( REGION_AU_915 )
-    {
-        return ( ERRORLORAWAN );
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
-}
-
-status_lorawan_t smtc_real_is_channel_index_valid( smtc_real_t* real, uint8_t channel_index )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-    {
-        status_lorawan_t status = OKLORAWAN;
-        if( ( channel_index < real_const.const_number_of_boot_tx_channel ) ||
-            ( channel_index >= real_const.const_number_of_tx_channel ) )
-        {
-            status = ERRORLORAWAN;
-            SMTC_MODEM_HAL_TRACE_WARNING( "RECEIVE AN INVALID Channel Index Cmd = %d\n", channel_index );
-        }
-        return ( status );
-    }
-#endif
-
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_US_915 ) || defined( REGION_AU_915 )
-    {
-        return ( ERRORLORAWAN );
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
-}
-
-status_lorawan_t smtc_real_is_payload_size_valid( smtc_real_t* real, uint8_t dr, uint8_t size,
-                                                  direction_frame_t direction_frame, uint8_t tx_fopts_current_length )
-{
-    bool dwell_time_enabled = ( direction_frame == UP_LINK ) ? uplink_dwell_time_ctx : downlink_dwell_time_ctx;
-    if( ( real_const.const_tx_param_setup_req_supported == false ) && ( dwell_time_enabled != 0 ) )
-    {
-        SMTC_MODEM_HAL_PANIC( );
-    }
-
-    uint8_t index = ( dwell_time_enabled * real_const.const_number_of_tx_dr ) + dr;
-
-#if defined( REGION_AU_915 )
-    if( real->region_type == SMTC_REAL_REGION_AU_915 )
-    {
-        // *2 because the array contains Tx and Rx datarate
-        index = ( dwell_time_enabled * real_const.const_number_of_tx_dr * 2 ) + dr;
-    }
-#endif
-
-    status_lorawan_t status = ( ( size + tx_fopts_current_length ) > ( real_const.const_max_payload_m[index] - 8 ) )
-                                  ? ERRORLORAWAN
-                                  : OKLORAWAN;
-    if( status == ERRORLORAWAN )
-    {
-        SMTC_MODEM_HAL_TRACE_PRINTF( "Invalid size (data:%d + FOpts:%d) > %d for dr: %d\n", size,
-                                     tx_fopts_current_length, ( real_const.const_max_payload_m[index] - 8 ), dr );
-    }
-    return ( status );
-}
-
-void smtc_real_set_tx_frequency_channel( smtc_real_t* real, uint32_t tx_freq, uint8_t channel_index )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-        if( channel_index >= real_const.const_number_of_tx_channel )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        else
-        {
-            tx_frequency_channel_ctx[channel_index] = tx_freq;
-        }
-        break;
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_US_915 ) || defined( REGION_AU_915 )
-    {
-        // Not supported
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-}
-
-status_lorawan_t smtc_real_set_rx1_frequency_channel( smtc_real_t* real, uint32_t rx_freq, uint8_t channel_index )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-        if( channel_index >= real_const.const_number_of_rx_channel )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        else
-        {
-            rx1_frequency_channel_ctx[channel_index] = rx_freq;
-        }
-        return OKLORAWAN;
-        break;
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_US_915 ) || defined( REGION_AU_915 )
-    {
-        // Not supported
-        return ERRORLORAWAN;
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
-}
-
-void smtc_real_set_channel_dr( smtc_real_t* real, uint8_t channel_index, uint8_t dr_min, uint8_t dr_max )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-        if( channel_index >= real_const.const_number_of_tx_channel )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        else
-        {
-            dr_bitfield_tx_channel_ctx[channel_index] = 0;
-            for( uint8_t i = dr_min; i <= dr_max; i++ )
-            {
-                uint8_t tmp_dr = SMTC_GET_BIT16( &real_const.const_dr_bitfield, i );
-                SMTC_PUT_BIT16( &dr_bitfield_tx_channel_ctx[channel_index], i, tmp_dr );
-            }
-        }
-        break;
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_US_915 ) || defined( REGION_AU_915 )
-    {
-        // Not supported
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-}
-
-void smtc_real_set_channel_enabled( smtc_real_t* real, uint8_t enable, uint8_t channel_index )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-        if( channel_index >= real_const.const_number_of_tx_channel )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        else
-        {
-            SMTC_PUT_BIT8( channel_index_enabled_ctx, channel_index, enable );
-        }
-        break;
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_US_915 ) || defined( REGION_AU_915 )
-    {
-        // Not supported
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-}
-
-uint32_t smtc_real_get_tx_channel_frequency( smtc_real_t* real, uint8_t channel_index )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-        if( channel_index >= real_const.const_number_of_tx_channel )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        return ( tx_frequency_channel_ctx[channel_index] );
-        break;
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_tx_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_tx_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_tx_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_tx_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
-}
-
-uint32_t smtc_real_get_rx1_channel_frequency( smtc_real_t* real, uint8_t channel_index )
-{
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_KR_920 ) || defined( REGION_RU_864 )
-        if( channel_index >= real_const.const_number_of_rx_channel )
-        {
-            SMTC_MODEM_HAL_PANIC( );
-        }
-        return ( rx1_frequency_channel_ctx[channel_index] );
-        break;
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_rx1_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_rx1_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_rx1_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_rx1_frequency_channel( real, channel_index );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return ERRORLORAWAN;  // never reach => avoid warning
-}
-
-uint8_t smtc_real_get_min_tx_channel_dr( smtc_real_t* real )
-{
-    uint8_t min_dr = real_const.const_max_tx_dr;  // start with the max dr and search a dr inferior
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-    {
-        if( ( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED ) )
-        {
-            for( uint8_t dr = real_const.const_min_tx_dr; dr <= real_const.const_max_tx_dr; dr++ )
-            {
-                if( ( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 ) && ( min_dr > dr ) )
-                {
-                    min_dr = dr;
-                }
-            }
-
-            if( min_dr == real_const.const_min_tx_dr )
-            {
-                break;  // DR found is the smallest
-            }
-        }
-    }
-
-    if( uplink_dwell_time_ctx == true )
-    {
-        min_dr = MAX( min_dr, real_const.const_min_tx_dr_limit );
-    }
-
-    return ( min_dr );
-}
-
-uint8_t smtc_real_get_max_tx_channel_dr( smtc_real_t* real )
-{
-    uint8_t max_dr = real_const.const_min_tx_dr;  // start with the min dr and search a dr superior
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
-    {
-        if( ( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED ) )
-        {
-            for( uint8_t dr = 0; dr <= real_const.const_max_tx_dr; dr++ )
-            {
-                if( ( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 ) && ( max_dr < dr ) )
-                {
-                    max_dr = dr;
-                }
-            }
-
-            if( max_dr == real_const.const_max_tx_dr )
-            {
-                break;  // DR found is the bigest
-            }
-        }
-    }
-
-    return ( max_dr );
+    //  nb_trans must set to 1 and all default channels re-enabled
+    *nb_trans = 1;
+    // reach this step only if tx_dr = MinDr => enable default channel
+    smtc_real_enable_all_channels_with_valid_freq( real );
+
+    // When all channels are available, lower datarate could be present in case where only DR6 and DR7 was present
+    // previously
+    *tx_data_rate_adr = smtc_real_decrement_dr_simulation( real, *tx_data_rate_adr );
 }
 
-uint16_t smtc_real_mask_tx_dr_channel( smtc_real_t* real )
+void smtc_real_enable_all_channels_with_valid_freq( smtc_real_t* real )
 {
-    uint16_t dr_mask = 0;
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    tx_dr_mask_valid_ctx = false;
+    if( real->region_ops->enable_all_channels_with_valid_freq != NULL )
     {
-        if( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED )
-        {
-            dr_mask |= dr_bitfield_tx_channel_ctx[i];
-        }
+        real->region_ops->enable_all_channels_with_valid_freq( real );
+        return;
     }
 
-    return dr_mask;
+    for( uint8_t i = 0; i < real_const.const_number_of_boot_tx_channel; i++ )
+    {
+        SMTC_PUT_BIT8( channel_index_enabled_ctx, i, CHANNEL_ENABLED );
+        dr_bitfield_tx_channel_ctx[i] = real_const.const_default_tx_dr_bit_field;
+    }
 }
 
-uint16_t smtc_real_mask_tx_dr_channel_up_dwell_time_check( smtc_real_t* real )
+status_lorawan_t smtc_real_is_rx1_dr_offset_valid( smtc_real_t* real, uint8_t rx1_dr_offset )
 {
-    uint16_t dr_mask = smtc_real_mask_tx_dr_channel( real );
-    if( uplink_dwell_time_ctx == true )
+    status_lorawan_t status = OKLORAWAN;
+    if( rx1_dr_offset >= real_const.const_number_rx1_dr_offset )
     {
-        for( uint8_t i = 0; i < real_const.const_min_tx_dr_limit; i++ )
-        {
-            SMTC_PUT_BIT16( &dr_mask, i, false );
-        }
+        status = ERRORLORAWAN;
+        SMTC_MODEM_HAL_TRACE_WARNING( "RECEIVE AN INVALID RX1 DR OFFSET \n" );
     }
-
-    return dr_mask;
+    return ( status );
 }
 
-uint8_t smtc_real_get_preamble_len( const smtc_real_t* real, uint8_t sf )
+status_lorawan_t smtc_real_is_rx_dr_valid( smtc_real_t* real, uint8_t dr )
 {
-    switch( real->region_type )
+    if( ( dr >= real_const.const_min_rx_dr ) && ( dr <= real_const.const_max_rx_dr ) )
     {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        if( ( sf == 5 ) || ( sf == 6 ) )
-        {
-            return 12;
-        }
-        else
+        if( SMTC_GET_BIT16( &real_const.const_dr_bitfield, dr ) == 1 )
         {
-            return 8;
+            return ( OKLORAWAN );
         }
-        break;
-    }
-#endif
-    default:
-        return 8;
-        break;
     }
+    SMTC_MODEM_HAL_TRACE_WARNING( "Invalid Rx datarate %d\n", dr );
+
+    return ( ERRORLORAWAN );
 }
 
-status_lorawan_t smtc_real_is_channel_mask_for_mobile_mode( const smtc_real_t* real )
+status_lorawan_t smtc_real_is_tx_dr_valid( smtc_real_t* real, uint8_t dr )
 {
-    status_lorawan_t status        = ERRORLORAWAN;
-    uint8_t          min_mobile_dr = real_const.const_min_tx_dr;
-    uint8_t          max_mobile_dr = real_const.const_max_tx_dr;
-
-    // search min datarate init
-    for( int i = 0; i < real_const.const_number_of_tx_dr; i++ )
+    if( ( dr >= real_const.const_min_tx_dr ) && ( dr <= real_const.const_max_tx_dr ) )
     {
-        if( dr_distribution_init_ctx[i] > 0 )
+        if( SMTC_GET_BIT16( &real_const.const_dr_bitfield, dr ) == 1 )
         {
-            min_mobile_dr = i;
-            break;
+            return ( OKLORAWAN );
         }
     }
-    if( uplink_dwell_time_ctx == true )
+    SMTC_MODEM_HAL_TRACE_WARNING( "Invalid Tx datarate %d\n", dr );
+
+    return ( ERRORLORAWAN );
+}
+
+status_lorawan_t smtc_real_is_tx_dr_acceptable( smtc_real_t* real, uint8_t dr, bool is_ch_mask_from_link_adr )
+{
+    if( real->region_ops->is_acceptable_tx_dr != NULL )
     {
-        min_mobile_dr = MAX( min_mobile_dr, real_const.const_min_tx_dr_limit );
+        return real->region_ops->is_acceptable_tx_dr( real, dr, is_ch_mask_from_link_adr );
     }
 
-    // search max datarate init
-    for( int i = real_const.const_number_of_tx_dr - 1; i <= 0; i-- )
+    uint8_t* ch_mask_to_check =
+        ( is_ch_mask_from_link_adr == true ) ? unwrapped_channel_mask_ctx : channel_index_enabled_ctx;
+
+    if( uplink_dwell_time_ctx == true )
     {
-        if( dr_distribution_init_ctx[i] > 0 )
+        if( dr < real_const.const_min_tx_dr_limit )
         {
-            max_mobile_dr = i;
-            break;
+            return ERRORLORAWAN;
         }
     }
 
-    for( int i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
     {
-        if( SMTC_GET_BIT8( unwrapped_channel_mask_ctx, i ) == CHANNEL_ENABLED )
+        if( SMTC_GET_BIT8( ch_mask_to_check, i ) == CHANNEL_ENABLED )
         {
-            for( uint8_t dr = real_const.const_min_tx_dr; dr <= real_const.const_max_tx_dr; dr++ )
+            SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "ch%d - dr field 0x%04x\n", i, dr_bitfield_tx_channel_ctx[i] );
+            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 )
             {
-                if( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 )
-                {
-                    if( ( dr >= min_mobile_dr ) && ( dr <= max_mobile_dr ) )
-                    {
-                        return ( OKLORAWAN );
-                    }
-                }
+                return ( OKLORAWAN );
             }
         }
     }
-    SMTC_MODEM_HAL_TRACE_WARNING( "Not acceptable data rate in mobile mode\n" );
-    return ( status );
+    SMTC_MODEM_HAL_TRACE_WARNING( "Not acceptable data rate\n" );
+    return ( ERRORLORAWAN );
 }
 
-modulation_type_t smtc_real_get_modulation_type_from_datarate( smtc_real_t* real, uint8_t datarate )
+status_lorawan_t smtc_real_is_nwk_received_tx_frequency_valid( smtc_real_t* real, uint32_t frequency )
 {
-    switch( real->region_type )
+    if( smtc_real_is_fixed_channel_plan( real ) == true )
     {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        return region_ww2g4_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        return region_eu_868_get_modulation_type_from_datarate( datarate );
-        break;
+        return ( ERRORLORAWAN );
     }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
+
+    status_lorawan_t status = OKLORAWAN;
+    if( frequency == 0 )
     {
-        return region_as_923_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        return region_in_865_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        return region_kr_920_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        return region_ru_864_get_modulation_type_from_datarate( datarate );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
+        return ( status );
     }
-    return 0;  // never reach => avoid warning
+    status = smtc_real_is_frequency_valid( real, frequency );
+    return ( status );
 }
-void smtc_real_lora_dr_to_sf_bw( smtc_real_t* real, uint8_t in_dr, uint8_t* out_sf, lr1mac_bandwidth_t* out_bw )
+
+status_lorawan_t smtc_real_is_channel_index_valid( smtc_real_t* real, uint8_t channel_index )
 {
-    switch( real->region_type )
+    if( smtc_real_is_fixed_channel_plan( real ) == true )
     {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4: {
-        region_ww2g4_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
-    }
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        region_eu_868_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+        return ( ERRORLORAWAN );
     }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
+
+    status_lorawan_t status = OKLORAWAN;
+    if( ( channel_index < real_const.const_number_of_boot_tx_channel ) ||
+        ( channel_index >= real_const.const_number_of_tx_channel ) )
     {
-        region_as_923_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+        status = ERRORLORAWAN;
+        SMTC_MODEM_HAL_TRACE_WARNING( "RECEIVE AN INVALID Channel Index Cmd = %d\n", channel_index );
     }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+    return ( status );
+}
+
+status_lorawan_t smtc_real_is_payload_size_valid( smtc_real_t* real, uint8_t dr, uint8_t size,
+                                                  direction_frame_t direction_frame, uint8_t tx_fopts_current_length )
+{
+    bool dwell_time_enabled = ( direction_frame == UP_LINK ) ? uplink_dwell_time_ctx : downlink_dwell_time_ctx;
+    if( ( real_const.const_tx_param_setup_req_supported == false ) && ( dwell_time_enabled != 0 ) )
+    {
+        SMTC_MODEM_HAL_PANIC( );
     }
-#endif
+
+    uint8_t index = ( dwell_time_enabled * real_const.const_number_of_tx_dr ) + dr;
+
 #if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+    if( real->region_type == SMTC_REAL_REGION_AU_915 )
+    {
+        // *2 because the array contains Tx and Rx datarate
+        index = ( dwell_time_enabled * real_const.const_number_of_tx_dr * 2 ) + dr;
     }
 #endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        region_cn_470_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+
+    status_lorawan_t status = ( ( size + tx_fopts_current_length ) > ( real_const.const_max_payload_m[index] - 8 ) )
+                                  ? ERRORLORAWAN
+                                  : OKLORAWAN;
+    if( status == ERRORLORAWAN )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Invalid size (data:%d + FOpts:%d) > %d for dr: %d\n", size,
+                                     tx_fopts_current_length, ( real_const.const_max_payload_m[index] - 8 ), dr );
     }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        region_cn_470_rp_1_0_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+    return ( status );
+}
+
+void smtc_real_set_tx_frequency_channel( smtc_real_t* real, uint32_t tx_freq, uint8_t channel_index )
+{
+    if( smtc_real_is_fixed_channel_plan( real ) == true )
+    {
+        // Not supported
+        return;
     }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        region_in_865_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+
+    if( channel_index >= real_const.const_number_of_tx_channel )
+    {
+        SMTC_MODEM_HAL_PANIC( );
     }
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        region_kr_920_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+    else
+    {
+        tx_frequency_channel_ctx[channel_index] = tx_freq;
     }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        region_ru_864_lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
-        break;
+}
+
+status_lorawan_t smtc_real_set_rx1_frequency_channel( smtc_real_t* real, uint32_t rx_freq, uint8_t channel_index )
+{
+    if( smtc_real_is_fixed_channel_plan( real ) == true )
+    {
+        // Not supported
+        return ERRORLORAWAN;
     }
-#endif
-    default:
+
+    if( channel_index >= real_const.const_number_of_rx_channel )
+    {
         SMTC_MODEM_HAL_PANIC( );
-        break;
     }
+    else
+    {
+        rx1_frequency_channel_ctx[channel_index] = rx_freq;
+    }
+    return OKLORAWAN;
 }
 
-void smtc_real_fsk_dr_to_bitrate( smtc_real_t* real, uint8_t in_dr, uint8_t* out_bitrate )
+void smtc_real_set_channel_dr( smtc_real_t* real, uint8_t channel_index, uint8_t dr_min, uint8_t dr_max )
 {
-    switch( real->region_type )
+    if( smtc_real_is_fixed_channel_plan( real ) == true )
     {
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        region_eu_868_fsk_dr_to_bitrate( in_dr, out_bitrate );
-        break;
+        // Not supported
+        return;
     }
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
+
+    if( channel_index >= real_const.const_number_of_tx_channel )
     {
-        region_as_923_fsk_dr_to_bitrate( in_dr, out_bitrate );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        region_cn_470_fsk_dr_to_bitrate( in_dr, out_bitrate );
-        break;
+        SMTC_MODEM_HAL_PANIC( );
     }
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865: {
-        region_in_865_fsk_dr_to_bitrate( in_dr, out_bitrate );
-        break;
+    else
+    {
+        tx_dr_mask_valid_ctx                      = false;
+        dr_bitfield_tx_channel_ctx[channel_index] = 0;
+        for( uint8_t i = dr_min; i <= dr_max; i++ )
+        {
+            uint8_t tmp_dr = SMTC_GET_BIT16( &real_const.const_dr_bitfield, i );
+            SMTC_PUT_BIT16( &dr_bitfield_tx_channel_ctx[channel_index], i, tmp_dr );
+        }
     }
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864: {
-        region_ru_864_fsk_dr_to_bitrate( in_dr, out_bitrate );
-        break;
+}
+
+void smtc_real_set_channel_enabled( smtc_real_t* real, uint8_t enable, uint8_t channel_index )
+{
+    if( smtc_real_is_fixed_channel_plan( real ) == true )
+    {
+        // Not supported
+        return;
     }
-#endif
-    default:
+
+    if( channel_index >= real_const.const_number_of_tx_channel )
+    {
         SMTC_MODEM_HAL_PANIC( );
-        break;
+    }
+    else
+    {
+        SMTC_PUT_BIT8( channel_index_enabled_ctx, channel_index, enable );
+        tx_dr_mask_valid_ctx = false;
     }
 }
 
-void smtc_real_lr_fhss_dr_to_cr_bw( smtc_real_t* real, uint8_t in_dr, lr_fhss_v1_cr_t* out_cr, lr_fhss_v1_bw_t* out_bw )
+uint32_t smtc_real_get_tx_channel_frequency( smtc_real_t* real, uint8_t channel_index )
 {
-    switch( real->region_type )
+    if( real->region_ops->get_tx_frequency_channel != NULL )
     {
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        region_eu_868_lr_fhss_dr_to_cr_bw( in_dr, out_cr, out_bw );
-        break;
+        return real->region_ops->get_tx_frequency_channel( real, channel_index );
     }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        region_us_915_lr_fhss_dr_to_cr_bw( in_dr, out_cr, out_bw );
-        break;
+
+    if( channel_index >= real_const.const_number_of_tx_channel )
+    {
+        SMTC_MODEM_HAL_PANIC( );
     }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        region_au_915_lr_fhss_dr_to_cr_bw( in_dr, out_cr, out_bw );
-        break;
+    return ( tx_frequency_channel_ctx[channel_index] );
+}
+
+uint32_t smtc_real_get_rx1_channel_frequency( smtc_real_t* real, uint8_t channel_index )
+{
+    if( real->region_ops->get_rx1_frequency_channel != NULL )
+    {
+        return real->region_ops->get_rx1_frequency_channel( real, channel_index );
     }
-#endif
-    default:
+
+    if( channel_index >= real_const.const_number_of_rx_channel )
+    {
         SMTC_MODEM_HAL_PANIC( );
-        break;
     }
+    return ( rx1_frequency_channel_ctx[channel_index] );
 }
 
-lr_fhss_hc_t smtc_real_lr_fhss_get_header_count( lr_fhss_v1_cr_t in_cr )
+uint8_t smtc_real_get_min_tx_channel_dr( smtc_real_t* real )
 {
-    if( in_cr == LR_FHSS_V1_CR_1_3 )
+    uint8_t min_dr = real_const.const_max_tx_dr;  // start with the max dr and search a dr inferior
+    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
     {
-        return LR_FHSS_HC_3;
+        if( ( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED ) )
+        {
+            for( uint8_t dr = real_const.const_min_tx_dr; dr <= real_const.const_max_tx_dr; dr++ )
+            {
+                if( ( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 ) && ( min_dr > dr ) )
+                {
+                    min_dr = dr;
+                }
+            }
+
+            if( min_dr == real_const.const_min_tx_dr )
+            {
+                break;  // DR found is the smallest
+            }
+        }
     }
-    else if( in_cr == LR_FHSS_V1_CR_2_3 )
+
+    if( uplink_dwell_time_ctx == true )
     {
-        return LR_FHSS_HC_2;
+        min_dr = MAX( min_dr, real_const.const_min_tx_dr_limit );
     }
 
-    SMTC_MODEM_HAL_PANIC( );
-    return 0;
+    return ( min_dr );
 }
 
-lr_fhss_v1_grid_t smtc_real_lr_fhss_get_grid( smtc_real_t* real )
+uint8_t smtc_real_get_max_tx_channel_dr( smtc_real_t* real )
 {
-    switch( real->region_type )
+    uint8_t max_dr = real_const.const_min_tx_dr;  // start with the min dr and search a dr superior
+    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
     {
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868: {
-        return LR_FHSS_V1_GRID_3906_HZ;
-        break;
+        if( ( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED ) )
+        {
+            for( uint8_t dr = 0; dr <= real_const.const_max_tx_dr; dr++ )
+            {
+                if( ( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 ) && ( max_dr < dr ) )
+                {
+                    max_dr = dr;
+                }
+            }
+
+            if( max_dr == real_const.const_max_tx_dr )
+            {
+                break;  // DR found is the bigest
+            }
+        }
     }
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_US_915 ) || defined( REGION_AU_915 )
+
+    return ( max_dr );
+}
+
+uint16_t smtc_real_mask_tx_dr_channel( smtc_real_t* real )
+{
+    if( tx_dr_mask_valid_ctx == false )
     {
-        return LR_FHSS_V1_GRID_25391_HZ;
-        break;
+        smtc_real_update_tx_dr_mask( real );
     }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
+    return tx_dr_mask_ctx;
+}
+
+uint16_t smtc_real_mask_tx_dr_channel_up_dwell_time_check( smtc_real_t* real )
+{
+    if( tx_dr_mask_valid_ctx == false )
+    {
+        smtc_real_update_tx_dr_mask( real );
+    }
+    return tx_dr_mask_dwell_time_ctx;
+}
+
+uint8_t smtc_real_get_preamble_len( const smtc_real_t* real, uint8_t sf )
+{
+#if defined( REGION_WW2G4 )
+    if( ( real->region_type == SMTC_REAL_REGION_WW2G4 ) && ( ( sf == 5 ) || ( sf == 6 ) ) )
+    {
+        return 12;
     }
-    return -1;  // never reach => avoid warning
+#endif
+    return 8;
 }
 
-uint8_t smtc_real_get_number_of_enabled_channels_for_a_datarate( smtc_real_t* real, uint8_t datarate )
+status_lorawan_t smtc_real_is_channel_mask_for_mobile_mode( const smtc_real_t* real )
 {
-    uint8_t channel_counter = 0;
+    status_lorawan_t status        = ERRORLORAWAN;
+    uint8_t          min_mobile_dr = real_const.const_min_tx_dr;
+    uint8_t          max_mobile_dr = real_const.const_max_tx_dr;
 
-    for( uint8_t i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    // search min datarate init
+    for( int i = 0; i < real_const.const_number_of_tx_dr; i++ )
     {
-        if( SMTC_GET_BIT8( channel_index_enabled_ctx, i ) == CHANNEL_ENABLED )
+        if( dr_distribution_init_ctx[i] > 0 )
+        {
+            min_mobile_dr = i;
+            break;
+        }
+    }
+    if( uplink_dwell_time_ctx == true )
+    {
+        min_mobile_dr = MAX( min_mobile_dr, real_const.const_min_tx_dr_limit );
+    }
+
+    // search max datarate init
+    for( int i = real_const.const_number_of_tx_dr - 1; i <= 0; i-- )
+    {
+        if( dr_distribution_init_ctx[i] > 0 )
+        {
+            max_mobile_dr = i;
+            break;
+        }
+    }
+
+    for( int i = 0; i < real_const.const_number_of_tx_channel; i++ )
+    {
+        if( SMTC_GET_BIT8( unwrapped_channel_mask_ctx, i ) == CHANNEL_ENABLED )
         {
-            if( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], datarate ) == 1 )
+            for( uint8_t dr = real_const.const_min_tx_dr; dr <= real_const.const_max_tx_dr; dr++ )
             {
-                channel_counter++;
+                if( SMTC_GET_BIT16( &dr_bitfield_tx_channel_ctx[i], dr ) == 1 )
+                {
+                    if( ( dr >= min_mobile_dr ) && ( dr <= max_mobile_dr ) )
+                    {
+                        return ( OKLORAWAN );
+                    }
+                }
             }
         }
     }
-    return channel_counter;
+    SMTC_MODEM_HAL_TRACE_WARNING( "Not acceptable data rate in mobile mode\n" );
+    return ( status );
 }
 
-int8_t smtc_real_clamp_output_power_eirp_vs_freq_and_dr( smtc_real_t* real, int8_t tx_power, uint32_t tx_frequency,
-                                                         uint8_t datarate )
+modulation_type_t smtc_real_get_modulation_type_from_datarate( smtc_real_t* real, uint8_t datarate )
 {
-    switch( real->region_type )
+    return real->region_ops->get_modulation_type_from_datarate( datarate );
+}
+void smtc_real_lora_dr_to_sf_bw( smtc_real_t* real, uint8_t in_dr, uint8_t* out_sf, lr1mac_bandwidth_t* out_bw )
+{
+    real->region_ops->lora_dr_to_sf_bw( in_dr, out_sf, out_bw );
+}
+
+void smtc_real_fsk_dr_to_bitrate( smtc_real_t* real, uint8_t in_dr, uint8_t* out_bitrate )
+{
+    if( real->region_ops->fsk_dr_to_bitrate == NULL )
     {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_AU_915 ) || \
-    defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 ) || defined( REGION_IN_865 ) ||                     \
-    defined( REGION_RU_864 )
+        SMTC_MODEM_HAL_PANIC( );
+    }
+    real->region_ops->fsk_dr_to_bitrate( in_dr, out_bitrate );
+}
+
+void smtc_real_lr_fhss_dr_to_cr_bw( smtc_real_t* real, uint8_t in_dr, lr_fhss_v1_cr_t* out_cr, lr_fhss_v1_bw_t* out_bw )
+{
+    if( real->region_ops->lr_fhss_dr_to_cr_bw == NULL )
     {
-        return tx_power;
-        break;
+        SMTC_MODEM_HAL_PANIC( );
     }
-#endif
+    real->region_ops->lr_fhss_dr_to_cr_bw( in_dr, out_cr, out_bw );
+}
 
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        if( datarate == DR4 )
-        {
-            return MIN( tx_power, 26 );
-        }
-        else if( smtc_real_get_number_of_enabled_channels_for_a_datarate( real, datarate ) < 50 )
-        {
-            return MIN( tx_power, 21 );
-        }
-        return tx_power;
-        break;
+lr_fhss_hc_t smtc_real_lr_fhss_get_header_count( lr_fhss_v1_cr_t in_cr )
+{
+    if( in_cr == LR_FHSS_V1_CR_1_3 )
+    {
+        return LR_FHSS_HC_3;
     }
-#endif
-
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920: {
-        if( tx_frequency < 922000000 )
-        {
-            return MIN( tx_power, 10 );  // if freq < 922MHz, Max output power is limited to 10 dBm
-        }
-        else
-        {
-            return MIN( tx_power, TX_POWER_EIRP_KR_920 );  // else Max output power is limited to 14 dBm
-        }
-        break;
+    else if( in_cr == LR_FHSS_V1_CR_2_3 )
+    {
+        return LR_FHSS_HC_2;
     }
-#endif
-    default:
+
+    SMTC_MODEM_HAL_PANIC( );
+    return 0;
+}
+
+lr_fhss_v1_grid_t smtc_real_lr_fhss_get_grid( smtc_real_t* real )
+{
+    if( real->region_ops->lr_fhss_dr_to_cr_bw == NULL )
+    {
         SMTC_MODEM_HAL_PANIC( );
-        break;
     }
-    return 0;  // never reach => avoid warning
+    return real->region_ops->lr_fhss_grid;
+}
+
+int8_t smtc_real_clamp_output_power_eirp_vs_freq_and_dr( smtc_real_t* real, int8_t tx_power, uint32_t tx_frequency,
+                                                         uint8_t datarate )
+{
+    if( real->region_ops->clamp_output_power_eirp != NULL )
+    {
+        return real->region_ops->clamp_output_power_eirp( real, tx_power, tx_frequency, datarate );
+    }
+    return tx_power;
 }
 
 bool smtc_real_get_current_enabled_frequency_list( smtc_real_t* real, uint8_t* number_of_freq, uint32_t* freq_list,
@@ -2489,6 +1181,56 @@ bool smtc_real_get_current_enabled_frequency_list( smtc_real_t* real, uint8_t* n
     return true;
 }
 
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+void smtc_real_set_next_tx_toa_ms( smtc_real_t* real, uint32_t toa_ms )
+{
+    real_ctx.next_tx_toa_ms_ctx = toa_ms;
+}
+
+void smtc_real_get_dtc_channel_stats( smtc_real_t* real, uint32_t* rerouted_uplinks, uint32_t* rerouted_toa_ms )
+{
+    *rerouted_uplinks = real_ctx.dtc_rerouted_uplinks_ctx;
+    *rerouted_toa_ms  = real_ctx.dtc_rerouted_toa_ms_ctx;
+}
+#endif
+
+#if defined( ADD_FAST_JOIN )
+uint8_t smtc_real_get_join_channel( smtc_real_t* real )
+{
+    if( real->region_ops->get_join_channel == NULL )
+    {
+        return SMTC_REAL_NO_JOIN_CHANNEL;
+    }
+    return real->region_ops->get_join_channel( real );
+}
+
+void smtc_real_set_fast_join_channel( smtc_real_t* real, uint8_t channel_idx )
+{
+    if( real->region_ops->set_fast_join_channel != NULL )
+    {
+        real->region_ops->set_fast_join_channel( real, channel_idx );
+    }
+}
+#endif
+
+#if defined( ADD_SESSION_RESUME ) || defined( ADD_REGION_SNAPSHOT )
+void smtc_real_get_session( smtc_real_t* real, smtc_real_session_t* session )
+{
+    session->uplink_dwell_time   = uplink_dwell_time_ctx;
+    session->downlink_dwell_time = downlink_dwell_time_ctx;
+    memcpy( &session->region, &real->region, sizeof( session->region ) );
+}
+
+void smtc_real_set_session( smtc_real_t* real, const smtc_real_session_t* session )
+{
+    // The channel plan pointers of real_ctx point into real->region, only the content is restored
+    memcpy( &real->region, &session->region, sizeof( real->region ) );
+    uplink_dwell_time_ctx   = session->uplink_dwell_time;
+    downlink_dwell_time_ctx = session->downlink_dwell_time;
+    tx_dr_mask_valid_ctx    = false;
+}
+#endif
+
 /*************************************************************************/
 /*                      Const init in region                             */
 /*************************************************************************/
@@ -2595,28 +1337,11 @@ uint8_t* smtc_real_get_gfsk_sync_word( smtc_real_t* real )
 
 uint8_t* smtc_real_get_lr_fhss_sync_word( smtc_real_t* real )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_EU_868 ) || defined( REGION_AU_915 ) || defined( REGION_US_915 )
+    if( real->region_ops->lr_fhss_dr_to_cr_bw == NULL )
     {
-        return ( uint8_t* ) real_const.const_sync_word_lr_fhss;
-        break;
-    }
-#endif
-    default:
         SMTC_MODEM_HAL_PANIC( );
-        break;
     }
-    return 0;  // never reach => avoid warning
+    return ( uint8_t* ) real_const.const_sync_word_lr_fhss;
 }
 
 bool smtc_real_is_dtc_supported( const smtc_real_t* real )
@@ -2691,194 +1416,25 @@ uint8_t smtc_real_get_beacon_dr( smtc_real_t* real )
 
 bool smtc_real_is_beacon_hopping( smtc_real_t* real )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_RU_864 ) || defined( SMTC_REAL_REGION_KR_920 )
-    {
-        return false;
-        break;
-    }
-#endif
-
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915:
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915:
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470:
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0:
-#endif
-#if defined( REGION_US_915 ) || defined( REGION_AU_915 ) || defined( REGION_CN_470 ) || defined( REGION_CN_470_RP_1_0 )
-    {
-        return true;
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return 0;  // never reach => avoid warning
+    return ( real->region_ops->get_rx_beacon_frequency_channel != NULL );
 }
 
 uint32_t smtc_real_get_beacon_frequency( smtc_real_t* real, uint32_t gps_time_s )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_RU_864 ) || defined( SMTC_REAL_REGION_KR_920 )
+    if( real->region_ops->get_rx_beacon_frequency_channel != NULL )
     {
-        return real_const.const_beacon_frequency;
-        break;
+        return real->region_ops->get_rx_beacon_frequency_channel( real, gps_time_s );
     }
-#endif
-
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_rx_beacon_frequency_channel( real, gps_time_s );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_rx_beacon_frequency_channel( real, gps_time_s );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_rx_beacon_frequency_channel( real, gps_time_s );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_rx_beacon_frequency_channel( real, gps_time_s );
-        break;
-    }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return 0;  // never reach => avoid warning
+    return real_const.const_beacon_frequency;
 }
 
 uint32_t smtc_real_get_ping_slot_frequency( smtc_real_t* real, uint32_t gps_time_s, uint32_t dev_addr )
 {
-    switch( real->region_type )
-    {
-#if defined( REGION_WW2G4 )
-    case SMTC_REAL_REGION_WW2G4:
-#endif
-#if defined( REGION_EU_868 )
-    case SMTC_REAL_REGION_EU_868:
-#endif
-#if defined( REGION_AS_923 )
-    case SMTC_REAL_REGION_AS_923:
-    case SMTC_REAL_REGION_AS_923_GRP2:
-    case SMTC_REAL_REGION_AS_923_GRP3:
-#if defined( RP2_103 )
-    case SMTC_REAL_REGION_AS_923_GRP4:
-#endif
-#endif
-#if defined( REGION_IN_865 )
-    case SMTC_REAL_REGION_IN_865:
-#endif
-#if defined( REGION_RU_864 )
-    case SMTC_REAL_REGION_RU_864:
-#endif
-#if defined( REGION_KR_920 )
-    case SMTC_REAL_REGION_KR_920:
-#endif
-#if defined( REGION_WW2G4 ) || defined( REGION_EU_868 ) || defined( REGION_AS_923 ) || defined( REGION_IN_865 ) || \
-    defined( REGION_RU_864 ) || defined( SMTC_REAL_REGION_KR_920 )
+    if( real->region_ops->get_rx_ping_slot_frequency_channel != NULL )
     {
-        return real_const.const_ping_slot_frequency;
-        break;
-    }
-#endif
-
-#if defined( REGION_US_915 )
-    case SMTC_REAL_REGION_US_915: {
-        return region_us_915_get_rx_ping_slot_frequency_channel( real, gps_time_s, dev_addr );
-        break;
-    }
-#endif
-#if defined( REGION_AU_915 )
-    case SMTC_REAL_REGION_AU_915: {
-        return region_au_915_get_rx_ping_slot_frequency_channel( real, gps_time_s, dev_addr );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470 )
-    case SMTC_REAL_REGION_CN_470: {
-        return region_cn_470_get_rx_ping_slot_frequency_channel( real, gps_time_s, dev_addr );
-        break;
-    }
-#endif
-#if defined( REGION_CN_470_RP_1_0 )
-    case SMTC_REAL_REGION_CN_470_RP_1_0: {
-        return region_cn_470_rp_1_0_get_rx_ping_slot_frequency_channel( real, gps_time_s, dev_addr );
-        break;
+        return real->region_ops->get_rx_ping_slot_frequency_channel( real, gps_time_s, dev_addr );
     }
-#endif
-    default:
-        SMTC_MODEM_HAL_PANIC( );
-        break;
-    }
-    return 0;  // never reach => avoid warning
+    return real_const.const_ping_slot_frequency;
 }
 
 uint8_t smtc_real_get_ping_slot_datarate( smtc_real_t* real )
@@ -2889,6 +1445,7 @@ uint8_t smtc_real_get_ping_slot_datarate( smtc_real_t* real )
 void smtc_real_set_uplink_dwell_time( smtc_real_t* real, bool dwell_time )
 {
     uplink_dwell_time_ctx = dwell_time;
+    tx_dr_mask_valid_ctx  = false;
 }
 
 void smtc_real_set_downlink_dwell_time( smtc_real_t* real, bool dwell_time )
@@ -2896,7 +1453,7 @@ void smtc_real_set_downlink_dwell_time( smtc_real_t* real, bool dwell_time )
     downlink_dwell_time_ctx = dwell_time;
 }
 
-uint32_t smtc_real_decode_freq_from_buf( smtc_real_t* real, uint8_t freq_buf[3] )
+uint32_t smtc_real_decode_freq_from_buf( smtc_real_t* real, const uint8_t freq_buf[3] )
 {
     uint32_t freq = ( freq_buf[0] ) + ( freq_buf[1] << 8 ) + ( freq_buf[2] << 16 );
     freq *= real_const.const_frequency_factor;
@@ -2936,32 +1493,27 @@ lr1mac_version_t smtc_real_get_regional_parameters_version( void )
 uint32_t smtc_real_get_symbol_duration_us( smtc_real_t* real, uint8_t datarate )
 {
     modulation_type_t modulation_type = smtc_real_get_modulation_type_from_datarate( real, datarate );
-    uint32_t          bw_temp         = 125;
     if( modulation_type == LORA )
     {
         uint8_t            sf;
         lr1mac_bandwidth_t bw;
         smtc_real_lora_dr_to_sf_bw( real, datarate, &sf, &bw );
-        // Use lr1mac_utilities_get_symb_time_us
+        // 2^sf * 1000 / bw_khz without division: 1000 / 125 = 8, 1000 / 250 = 4, 1000 / 500 = 2, 1000 / 800 = 5 / 4
         switch( bw )
         {
         case BW125:
-            bw_temp = 125;
-            break;
+            return ( uint32_t ) 1 << ( sf + 3 );
         case BW250:
-            bw_temp = 250;
-            break;
+            return ( uint32_t ) 1 << ( sf + 2 );
         case BW500:
-            bw_temp = 500;
-            break;
+            return ( uint32_t ) 1 << ( sf + 1 );
         case BW800:
-            bw_temp = 800;
-            break;
+            return ( ( uint32_t ) 5 << sf ) >> 2;
         default:
             SMTC_MODEM_HAL_PANIC( " invalid BW " );
             break;
         }
-        return ( ( ( uint32_t ) ( ( 1 << sf ) * 1000 ) / bw_temp ) );
+        return 0;
     }
     else
     {
@@ -2974,10 +1526,10 @@ uint32_t smtc_real_get_symbol_duration_us( smtc_real_t* real, uint8_t datarate )
 void smtc_real_get_rx_window_parameters( smtc_real_t* real, uint8_t datarate, uint32_t rx_delay_ms,
                                          uint16_t* rx_window_symb, uint32_t* rx_timeout_symb_in_ms,
                                          uint32_t* rx_timeout_preamble_locked_in_ms, uint8_t rx_done_incertitude,
-                                         uint32_t crystal_error )
+                                         uint32_t crystal_error, uint32_t min_rx_window_ms )
 {
     uint32_t          tsymbol_us              = smtc_real_get_symbol_duration_us( real, datarate );
-    uint32_t          min_rx_symb_duration_ms = MIN_RX_WINDOW_DURATION_MS + rx_done_incertitude;
+    uint32_t          min_rx_symb_duration_ms = min_rx_window_ms + rx_done_incertitude;
     modulation_type_t modulation_type         = smtc_real_get_modulation_type_from_datarate( real, datarate );
 
     if( modulation_type == FSK )
@@ -2998,14 +1550,16 @@ void smtc_real_get_rx_window_parameters( smtc_real_t* real, uint8_t datarate, ui
         *rx_window_symb = *rx_window_symb + 1;
     }
 
-    *rx_timeout_symb_in_ms = MAX( ( *rx_window_symb * tsymbol_us ) / 1000, MIN_RX_WINDOW_DURATION_MS );
+    *rx_timeout_symb_in_ms = MAX( ( *rx_window_symb * tsymbol_us ) / 1000, min_rx_window_ms );
 
     *rx_timeout_preamble_locked_in_ms = 3000;
 
 #if defined( SX128X )
     // rx timeout is used to simuate a symb timeout in sx128x (need to open preamb + sync +header)
+    // ceil( ( rx_window_symb + 16.25 ) * tsymbol_us ) computed in integer: 16.25 * t = 16 * t + t / 4 rounded up
     *rx_timeout_preamble_locked_in_ms =
-        MAX( ceilf( ( ( ( float ) *rx_window_symb + 16.25f ) * tsymbol_us ) ) / 1000, MIN_RX_WINDOW_DURATION_MS );
+        MAX( ( ( ( uint32_t ) *rx_window_symb + 16 ) * tsymbol_us + ( ( tsymbol_us + 3 ) >> 2 ) ) / 1000,
+             min_rx_window_ms );
     *rx_timeout_symb_in_ms = *rx_timeout_preamble_locked_in_ms;
 #endif
 }
@@ -3029,4 +1583,24 @@ void smtc_real_get_rx_start_time_offset_ms( smtc_real_t* real, uint8_t datarate,
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG(
         "rx_start_target -> datarate:%d, rx_window_symb:%u, rx_offset_ms:%d, board_delay_ms:%d\n", datarate,
         rx_window_symb, *rx_offset_ms, board_delay_ms );
+}
+
+void smtc_real_get_rx_start_time_offset_us( smtc_real_t* real, uint8_t datarate, int8_t board_delay_ms,
+                                            uint16_t rx_window_symb, int32_t* rx_offset_us )
+{
+    modulation_type_t modulation_type = smtc_real_get_modulation_type_from_datarate( real, datarate );
+    int32_t           tsymbol_us      = ( int32_t ) smtc_real_get_symbol_duration_us( real, datarate );
+
+    if( modulation_type == FSK )
+    {
+        *rx_offset_us = ( tsymbol_us * -1 * ( rx_window_symb / 2 ) ) - ( ( int32_t ) board_delay_ms * 1000 );
+    }
+    else
+    {
+        *rx_offset_us = ( tsymbol_us * ( 1 - ( ( ( int32_t ) rx_window_symb - MIN_RX_WINDOW_SYMB ) / 2 ) ) ) -
+                        ( ( int32_t ) board_delay_ms * 1000 );
+    }
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG(
+        "rx_start_target -> datarate:%d, rx_window_symb:%u, rx_offset_us:%d, board_delay_ms:%d\n", datarate,
+        rx_window_symb, *rx_offset_us, board_delay_ms );
 }
\ No newline at end of file
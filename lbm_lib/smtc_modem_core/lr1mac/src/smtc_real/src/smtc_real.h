@@ -207,6 +207,14 @@ uint8_t smtc_real_get_rx1_datarate_config( smtc_real_t* real, uint8_t tx_data_ra
  */
 int8_t smtc_real_convert_power_cmd( smtc_real_t* real, uint8_t power_cmd, uint8_t max_erp_dbm );
 
+/**
+ * \brief  Get the lowest transmit power a LinkADRReq can set in the region
+ * \remark Same conversion as smtc_real_convert_power_cmd with the highest TXPower index of the region
+ * \param [IN]  max_erp_dbm  Maximum EIRP in use
+ * \param [OUT] return       Lowest transmit power in dBm
+ */
+int8_t smtc_real_get_min_tx_power( smtc_real_t* real, uint8_t max_erp_dbm );
+
 /**
  * \brief
  * \remark
@@ -610,7 +618,7 @@ void smtc_real_set_downlink_dwell_time( smtc_real_t* real, bool dwell_time );
  * \param [IN]  none
  * \param [OUT] return
  */
-uint32_t smtc_real_decode_freq_from_buf( smtc_real_t* real, uint8_t freq_buf[3] );
+uint32_t smtc_real_decode_freq_from_buf( smtc_real_t* real, const uint8_t freq_buf[3] );
 
 /**
  * \brief
@@ -752,6 +760,62 @@ int8_t smtc_real_clamp_output_power_eirp_vs_freq_and_dr( smtc_real_t* real, int8
 bool smtc_real_get_current_enabled_frequency_list( smtc_real_t* real, uint8_t* number_of_freq, uint32_t* freq_list,
                                                    const uint8_t max_size );
 
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+/**
+ * @brief Set the time on air of the frame for which the next channel is selected
+ *
+ * @param [in] real     Pointer to the regional object
+ * @param [in] toa_ms   Time on air of the frame in milliseconds
+ */
+void smtc_real_set_next_tx_toa_ms( smtc_real_t* real, uint32_t toa_ms );
+
+/**
+ * @brief Get the airtime aware channel selection statistics
+ *
+ * @param [in]  real                Pointer to the regional object
+ * @param [out] rerouted_uplinks    Number of uplinks that left out a band without enough duty cycle budget
+ * @param [out] rerouted_toa_ms     Cumulated time on air of these uplinks in milliseconds
+ */
+void smtc_real_get_dtc_channel_stats( smtc_real_t* real, uint32_t* rerouted_uplinks, uint32_t* rerouted_toa_ms );
+#endif
+
+#if defined( ADD_FAST_JOIN )
+/**
+ * @brief Get the channel of the last join request
+ *
+ * @param [in] real Pointer to the regional object
+ * @return uint8_t channel index, SMTC_REAL_NO_JOIN_CHANNEL if the region does not remember join channels
+ */
+uint8_t smtc_real_get_join_channel( smtc_real_t* real );
+
+/**
+ * @brief Send the next join request on a channel of a previous accepted join, in regions with sub-bands (US915,
+ * AU915), the other regions ignore it
+ *
+ * @param [in] real        Pointer to the regional object
+ * @param [in] channel_idx Channel index returned by smtc_real_get_join_channel
+ */
+void smtc_real_set_fast_join_channel( smtc_real_t* real, uint8_t channel_idx );
+#endif
+
+#if defined( ADD_SESSION_RESUME ) || defined( ADD_REGION_SNAPSHOT )
+/**
+ * @brief Get the channel plan of the session, as updated by the join accept CFList and the MAC commands
+ *
+ * @param [in]  real    Pointer to the regional object
+ * @param [out] session Channel plan and dwell times
+ */
+void smtc_real_get_session( smtc_real_t* real, smtc_real_session_t* session );
+
+/**
+ * @brief Restore the channel plan of a session, the region must be the one of smtc_real_get_session
+ *
+ * @param [in] real    Pointer to the regional object
+ * @param [in] session Channel plan and dwell times
+ */
+void smtc_real_set_session( smtc_real_t* real, const smtc_real_session_t* session );
+#endif
+
 /**
  * @brief
  *
@@ -769,15 +833,22 @@ lr1mac_version_t smtc_real_get_regional_parameters_version( void );
 uint32_t smtc_real_get_symbol_duration_us( smtc_real_t* real, uint8_t datarate );
 
 /**
- * @brief
+ * @brief Compute the size of a receive window
  *
- * @param
- * @return
+ * @param [in]  real                             Regional parameters
+ * @param [in]  datarate                         Datarate of the window
+ * @param [in]  rx_delay_ms                      Time since the last timing reference, widened by the crystal error
+ * @param [out] rx_window_symb                   Window length in symbols
+ * @param [out] rx_timeout_symb_in_ms            Window length in ms
+ * @param [out] rx_timeout_preamble_locked_in_ms Reception timeout once the preamble is locked
+ * @param [in]  rx_done_incertitude              Timing uncertainty added to the shortest window in ms
+ * @param [in]  crystal_error                    Crystal error in ppm
+ * @param [in]  min_rx_window_ms                 Shortest window in ms, usually MIN_RX_WINDOW_DURATION_MS
  */
 void smtc_real_get_rx_window_parameters( smtc_real_t* real, uint8_t datarate, uint32_t rx_delay_ms,
                                          uint16_t* rx_window_symb, uint32_t* rx_timeout_symb_in_ms,
                                          uint32_t* rx_timeout_preamble_locked_in_ms, uint8_t rx_done_incertitude,
-                                         uint32_t crystal_error );
+                                         uint32_t crystal_error, uint32_t min_rx_window_ms );
 /**
  * @brief
  *
@@ -788,6 +859,18 @@ void smtc_real_get_rx_window_parameters( smtc_real_t* real, uint8_t datarate, ui
 void smtc_real_get_rx_start_time_offset_ms( smtc_real_t* real, uint8_t datarate, int8_t board_delay_ms,
                                             uint16_t rx_window_symb, int32_t* rx_offset_ms );
 
+/**
+ * @brief Same as smtc_real_get_rx_start_time_offset_ms but without truncating the symbol part to the millisecond
+ *
+ * @param [in]  real           Pointer to the regional object
+ * @param [in]  datarate       Rx datarate
+ * @param [in]  board_delay_ms Board, radio and tcxo delays
+ * @param [in]  rx_window_symb Rx window size in symbols
+ * @param [out] rx_offset_us   Offset to apply to the Rx window start time in us
+ */
+void smtc_real_get_rx_start_time_offset_us( smtc_real_t* real, uint8_t datarate, int8_t board_delay_ms,
+                                            uint16_t rx_window_symb, int32_t* rx_offset_us );
+
 #ifdef __cplusplus
 }
 #endif
@@ -46,6 +46,7 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include "ral_defs.h"
+#include "lr1mac_defs.h"
 
 #if defined( REGION_EU_868 )
 #include "region_eu_868_defs.h"
@@ -98,6 +99,7 @@ extern "C" {
 #endif
 
 #define SMTC_REAL_PING_SLOT_PERIODICITY_DEFAULT 7  // Default ping slot period (128s)
+#define SMTC_REAL_NO_JOIN_CHANNEL 0xFF              // No join channel known or requested
 
 /*
  * -----------------------------------------------------------------------------
@@ -236,6 +238,14 @@ typedef struct smtc_real_ctx_s
     uint8_t   sync_word_ctx;
     bool      uplink_dwell_time_ctx;
     bool      downlink_dwell_time_ctx;
+    uint16_t  tx_dr_mask_ctx;             // Datarates of the enabled channels
+    uint16_t  tx_dr_mask_dwell_time_ctx;  // Same mask without the datarates forbidden by the uplink dwell time
+    bool      tx_dr_mask_valid_ctx;       // Both masks match the current channel plan and dwell time
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+    uint32_t  next_tx_toa_ms_ctx;        // Time on air of the frame waiting for a channel
+    uint32_t  dtc_rerouted_uplinks_ctx;  // Uplinks that left out a band without enough duty cycle budget
+    uint32_t  dtc_rerouted_toa_ms_ctx;   // Cumulated time on air of these uplinks
+#endif
 } smtc_real_ctx_t;
 
 typedef struct smtc_real_const_s
@@ -294,11 +304,69 @@ typedef struct smtc_real_const_s
     bool            const_uplink_dwell_time;
 } smtc_real_const_t;
 
+struct smtc_real_s;
+
+/**
+ * @brief Region operations, one constant table per region
+ *
+ * The table is selected once by smtc_real_init, smtc_real then calls the region through it instead of switching on
+ * the region type. Mandatory hooks are set by every region, optional hooks are left NULL when the region has nothing
+ * to do or uses the common dynamic channel plan code of smtc_real.
+ */
+typedef struct smtc_real_region_ops_s
+{
+    // Mandatory hooks
+    void ( *config )( struct smtc_real_s* real );
+    status_lorawan_t ( *get_next_channel )( struct smtc_real_s* real, uint8_t tx_data_rate, uint32_t* out_tx_frequency,
+                                            uint32_t* out_rx1_frequency, uint8_t* out_nb_available_tx_channel );
+    status_lorawan_t ( *get_join_next_channel )( struct smtc_real_s* real, uint8_t* tx_data_rate,
+                                                 uint32_t* out_tx_frequency, uint32_t* out_rx1_frequency,
+                                                 uint32_t* out_rx2_frequency, uint8_t* out_nb_available_tx_channel );
+    status_channel_t ( *build_channel_mask )( struct smtc_real_s* real, uint8_t ch_mask_cntl, uint16_t ch_mask );
+    modulation_type_t ( *get_modulation_type_from_datarate )( uint8_t datarate );
+    void ( *lora_dr_to_sf_bw )( uint8_t in_dr, uint8_t* out_sf, lr1mac_bandwidth_t* out_bw );
+
+    // Optional hooks, nothing done when NULL
+    void ( *config_session )( struct smtc_real_s* real );
+    void ( *mask_channel_used_for_tx )( struct smtc_real_s* real );
+    void ( *init_join_snapshot_channel_mask )( struct smtc_real_s* real );
+    void ( *init_after_join_snapshot_channel_mask )( struct smtc_real_s* real, uint8_t tx_data_rate,
+                                                     uint32_t tx_frequency );
+#if defined( ADD_FAST_JOIN )
+    uint8_t ( *get_join_channel )( struct smtc_real_s* real );
+    void ( *set_fast_join_channel )( struct smtc_real_s* real, uint8_t channel_idx );
+#endif
+
+    // Optional hooks, common dynamic channel plan code used when NULL
+    uint8_t ( *get_number_of_chmask_in_cflist )( struct smtc_real_s* real );
+    void ( *set_channel_mask )( struct smtc_real_s* real );
+    void ( *enable_all_channels_with_valid_freq )( struct smtc_real_s* real );
+    status_lorawan_t ( *is_acceptable_tx_dr )( struct smtc_real_s* real, uint8_t dr, bool is_ch_mask_from_link_adr );
+    int8_t ( *clamp_output_power_eirp )( struct smtc_real_s* real, int8_t tx_power, uint32_t tx_frequency,
+                                         uint8_t datarate );
+
+    // Fixed channel plan hooks, set together: channels are computed from their index and cannot be changed by the
+    // network
+    uint32_t ( *get_tx_frequency_channel )( struct smtc_real_s* real, uint8_t index );
+    uint32_t ( *get_rx1_frequency_channel )( struct smtc_real_s* real, uint8_t index );
+
+    // Beacon and ping slot frequency hopping hooks, set together: constant frequencies used when NULL
+    uint32_t ( *get_rx_beacon_frequency_channel )( struct smtc_real_s* real, uint32_t gps_time_s );
+    uint32_t ( *get_rx_ping_slot_frequency_channel )( struct smtc_real_s* real, uint32_t gps_time_s,
+                                                      uint32_t dev_addr );
+
+    // Modulation hooks, NULL when the modulation is not supported by the region
+    void ( *fsk_dr_to_bitrate )( uint8_t in_dr, uint8_t* out_bitrate );
+    void ( *lr_fhss_dr_to_cr_bw )( uint8_t in_dr, lr_fhss_v1_cr_t* out_cr, lr_fhss_v1_bw_t* out_bw );
+    lr_fhss_v1_grid_t lr_fhss_grid;
+} smtc_real_region_ops_t;
+
 typedef struct smtc_real_s
 {
-    smtc_real_region_types_t region_type;
-    smtc_real_const_t        real_const;
-    smtc_real_ctx_t          real_ctx;
+    smtc_real_region_types_t      region_type;
+    const smtc_real_region_ops_t* region_ops;
+    smtc_real_const_t             real_const;
+    smtc_real_ctx_t               real_ctx;
 
     union smtc_real_region_u
     {
@@ -336,6 +404,19 @@ typedef struct smtc_real_s
 
 } smtc_real_t;
 
+#if defined( ADD_SESSION_RESUME ) || defined( ADD_REGION_SNAPSHOT )
+/**
+ * @brief Channel plan of a session, stored to resume the session after a reset (LBM_SESSION_RESUME) or
+ * restored when the region is used again (LBM_REGION_SNAPSHOT)
+ */
+typedef struct smtc_real_session_s
+{
+    bool                     uplink_dwell_time;
+    bool                     downlink_dwell_time;
+    union smtc_real_region_u region;
+} smtc_real_session_t;
+#endif
+
 #ifdef __cplusplus
 }
 #endif
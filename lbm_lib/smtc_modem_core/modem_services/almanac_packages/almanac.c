@@ -50,6 +50,9 @@
 #include "device_management_defs.h"
 #include "lr11xx_gnss.h"
 #include "radio_planner_hook_id_defs.h"
+#if defined( ADD_SMTC_RAM_POOL )
+#include "modem_ram_pool.h"
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE MACROS-----------------------------------------------------------
@@ -129,6 +132,7 @@ static almanac_t almanac_obj;
 static void rp_end_almanac_callback( void* status );
 static void rp_start_almanac_callback( void* context );
 static void request_access_to_rp_4_almanac_update( void );
+static uint8_t almanac_get_nb_stale_sv( void );
 void        add_almanac_task( uint32_t delays_s );
 /*
  * -----------------------------------------------------------------------------
@@ -153,10 +157,16 @@ void almanac_services_init( uint8_t* service_id, uint8_t task_id,
     almanac_obj.almanac_dw_buffer_size         = 0;
     almanac_obj.up_delay                       = 0;
     almanac_obj.up_count                       = 0;
+    almanac_obj.nb_stale_sv                    = ALMANAC_NB_STALE_SV_UNKNOWN;
     almanac_obj.get_almanac_status_from_lr11xx = false;
     almanac_obj.rp_hook_id                     = RP_HOOK_ID_DIRECT_RP_ACCESS_4_ALMANAC + CURRENT_STACK;
     rp_hook_init( modem_get_rp( ), almanac_obj.rp_hook_id, ( void ( * )( void* ) )( rp_end_almanac_callback ),
                   modem_get_rp( ) );
+
+#if ( NUMBER_OF_STACKS == 1 )
+    // the dm port of the stack, followed by cloud_dm_set_dm_port
+    modem_set_downlink_service_port( almanac_service_downlink_handler, DM_PORT );
+#endif
 }
 
 void almanac_service_on_launch( void* context )
@@ -164,6 +174,13 @@ void almanac_service_on_launch( void* context )
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "almanac_service_on_launch\n" );
 
     IS_SERVICE_ENABLED( );
+
+    // Periodic check: the cloud only has something to send if some satellites are outdated
+    if( ( almanac_obj.up_count == 0 ) && ( almanac_obj.nb_stale_sv == 0 ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Almanac up to date, status not sent\n" );
+        return;
+    }
     almanac_obj.almanac_status_from_lr11xx[1] = DM_INFO_ALMSTATUS;
 
     uint8_t dm_port;
@@ -229,6 +246,16 @@ uint8_t almanac_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_dat
 
 void start_almanac_service( uint8_t stack_id )
 {
+#if defined( ADD_SMTC_RAM_POOL )
+    if( almanac_obj.almanac_dw_buffer == NULL )
+    {
+        almanac_obj.almanac_dw_buffer = modem_ram_pool_alloc( MODEM_RAM_POOL_USER_ALMANAC, stack_id, ALMANAC_DW_SIZE );
+        if( almanac_obj.almanac_dw_buffer == NULL )
+        {
+            return;
+        }
+    }
+#endif
     almanac_obj.enabled  = true;
     almanac_obj.up_count = ALMANAC_UP_COUNT_INIT;
     request_access_to_rp_4_almanac_update( );
@@ -237,6 +264,11 @@ void start_almanac_service( uint8_t stack_id )
 void stop_almanac_service( uint8_t stack_id )
 {
     almanac_obj.enabled = false;
+#if defined( ADD_SMTC_RAM_POOL )
+    modem_ram_pool_release( MODEM_RAM_POOL_USER_ALMANAC, stack_id );
+    almanac_obj.almanac_dw_buffer      = NULL;
+    almanac_obj.almanac_dw_buffer_size = 0;
+#endif
 }
 
 /*
@@ -289,6 +321,10 @@ static void rp_start_almanac_callback( void* context )
     lr11xx_gnss_parse_context_status_buffer( almanac_obj.almanac_status_from_lr11xx, &context_status );
     SMTC_MODEM_HAL_TRACE_PRINTF( "=> Almanac CRC: 0x%08X\n", context_status.global_almanac_crc );
 
+    // Only needed on the periodic check, the status is always sent while an update is in progress
+    almanac_obj.nb_stale_sv =
+        ( almanac_obj.up_count == 0 ) ? almanac_get_nb_stale_sv( ) : ALMANAC_NB_STALE_SV_UNKNOWN;
+
     rp_task_abort( modem_get_rp( ), almanac_obj.rp_hook_id );
 }
 
@@ -314,4 +350,40 @@ static void request_access_to_rp_4_almanac_update( void )
     }
 }
 
+static uint8_t almanac_get_nb_stale_sv( void )
+{
+    lr11xx_gnss_time_t gps_time;
+    uint8_t            nb_stale_sv = 0;
+
+    if( ( lr11xx_gnss_read_time( modem_get_radio_ctx( ), &gps_time ) != LR11XX_STATUS_OK ) ||
+        ( gps_time.error_code != LR11XX_GNSS_READ_TIME_STATUS_NO_ERROR ) )
+    {
+        return ALMANAC_NB_STALE_SV_UNKNOWN;
+    }
+    uint16_t today = ( gps_time.gps_time_s / 86400 ) % ALMANAC_GPS_ROLLOVER_DAYS;
+
+    for( uint8_t sv_id = 0; sv_id < LR11XX_GNSS_FULL_UPDATE_N_ALMANACS; sv_id++ )
+    {
+        uint16_t almanac_date;
+
+        if( lr11xx_gnss_get_almanac_age_for_satellite( modem_get_radio_ctx( ), sv_id, &almanac_date ) !=
+            LR11XX_STATUS_OK )
+        {
+            return ALMANAC_NB_STALE_SV_UNKNOWN;
+        }
+        // Unused satellite slots have no almanac date
+        if( almanac_date == 0 )
+        {
+            continue;
+        }
+        uint16_t age_days = ( today + ALMANAC_GPS_ROLLOVER_DAYS - almanac_date ) % ALMANAC_GPS_ROLLOVER_DAYS;
+        if( age_days > ALMANAC_STALE_AGE_DAYS )
+        {
+            nb_stale_sv++;
+        }
+    }
+    SMTC_MODEM_HAL_TRACE_PRINTF( "=> Almanac outdated satellites: %d\n", nb_stale_sv );
+    return nb_stale_sv;
+}
+
 /* --- EOF ------------------------------------------------------------------ */
@@ -62,6 +62,17 @@ extern "C" {
 #define ALMANAC_1SECOND 1
 #define ALMANAC_UP_COUNT_INIT 3
 
+/**
+ * @brief Age in days above which the almanac of a satellite is considered outdated
+ *
+ * The periodic status uplink is skipped when no satellite almanac is older than this age
+ */
+#ifndef ALMANAC_STALE_AGE_DAYS
+#define ALMANAC_STALE_AGE_DAYS 30
+#endif
+#define ALMANAC_GPS_ROLLOVER_DAYS 7168  // 1024 weeks
+#define ALMANAC_NB_STALE_SV_UNKNOWN 0xFF
+
 #define SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH 9
 
 /*
@@ -82,12 +93,17 @@ typedef struct almanac_s
     uint8_t task_id;
     bool    enabled;
     bool    initialized;
+#if defined( ADD_SMTC_RAM_POOL )
+    uint8_t* almanac_dw_buffer;  // ALMANAC_DW_SIZE bytes taken from the modem ram pool while the service is started
+#else
     uint8_t almanac_dw_buffer[ALMANAC_DW_SIZE];
+#endif
     uint8_t almanac_dw_buffer_size;
     uint8_t almanac_status_from_lr11xx[SERVICE_LR11XX_GNSS_CONTEXT_STATUS_LENGTH];
     bool    get_almanac_status_from_lr11xx;
     uint8_t up_delay;
     uint8_t up_count;
+    uint8_t nb_stale_sv;
     uint8_t rp_hook_id;
 } almanac_t;
 
@@ -49,12 +49,14 @@
 #include "radio_planner.h"
 #include "radio_planner_hook_id_defs.h"
 #include "modem_tx_protocol_manager.h"
+#include "modem_async.h"
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE MACROS-----------------------------------------------------------
  */
 #define CURRENT_STACK ( task_id / NUMBER_OF_TASKS )
 #define NUMBER_MAX_OF_TX_BEACON_OBJ 1
+#define TX_BEACON_TIME_RETRY_DELAY_MS ( 10000 )
 
 /**
  * @brief Check is the index is valid before accessing the object
@@ -101,6 +103,9 @@ static lorawan_beacon_tx_example_t lorawan_beacon_tx_example_obj;
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+// Waits for the network time before starting the beacons
+static modem_async_t lorawan_beacon_tx_example_async;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -108,6 +113,7 @@ static lorawan_beacon_tx_example_t lorawan_beacon_tx_example_obj;
 static void start_user_beacon_callback( void* context );
 static void end_user_beacon_callback( void* status );
 static void start_user_beacon( void );
+static void lorawan_beacon_tx_example_run( modem_async_t* async );
 
 /*
  * -----------------------------------------------------------------------------
@@ -127,6 +133,8 @@ void lorawan_beacon_tx_example_service_init( uint8_t* service_id, uint8_t task_i
     *on_launch_callback                       = lorawan_beacon_tx_example_service_on_launch;
     *on_update_callback                       = lorawan_beacon_tx_example_service_on_update;
     *context_callback                         = ( void* ) service_id;
+    modem_async_init( &lorawan_beacon_tx_example_async, lorawan_beacon_tx_example_run, task_id, CURRENT_STACK,
+                      TASK_MEDIUM_HIGH_PRIORITY, NULL );
     rp_hook_init( modem_get_rp( ), RP_HOOK_ID_DIRECT_RP_ACCESS, ( void ( * )( void* ) )( end_user_beacon_callback ),
                   modem_get_rp( ) );
     //  lorawan_beacon_tx_example_add_task (CURRENT_STACK);
@@ -135,29 +143,13 @@ void lorawan_beacon_tx_example_service_init( uint8_t* service_id, uint8_t task_i
 void lorawan_beacon_tx_example_service_on_launch( void* context_callback )
 {
     IS_SERVICE_INITIALIZED( );
-    if( lorawan_api_is_time_valid( lorawan_beacon_tx_example_obj.stack_id ) == false )
-    {
-        uint8_t cid_buffer[]     = { DEVICE_TIME_REQ };
-        uint8_t cid_request_size = 1;  // request only ping slot if time is already valid
-
-        tx_protocol_manager_request( TX_PROTOCOL_TRANSMIT_CID, 0, false, cid_buffer, cid_request_size, 0,
-                                     smtc_modem_hal_get_time_in_ms( ), lorawan_beacon_tx_example_obj.stack_id );
-    }
+    modem_async_on_launch( &lorawan_beacon_tx_example_async );
 }
 
 void lorawan_beacon_tx_example_service_on_update( void* context_callback )
 {
     IS_SERVICE_INITIALIZED( );
-    if( ( lorawan_api_isjoined( lorawan_beacon_tx_example_obj.stack_id ) != JOINED ) ||
-        ( lorawan_api_is_time_valid( lorawan_beacon_tx_example_obj.stack_id ) == false ) )
-    {
-        lorawan_beacon_tx_example_add_task( lorawan_beacon_tx_example_obj.stack_id );
-    }
-    else
-    {
-        lorawan_beacon_tx_example_obj.enabled = true;
-        start_user_beacon( );
-    }
+    modem_async_on_update( &lorawan_beacon_tx_example_async );
 }
 
 uint8_t lorawan_beacon_tx_example_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
@@ -169,12 +161,7 @@ void lorawan_beacon_tx_example_add_task( uint8_t stack_id )
 {
     IS_VALID_STACK_ID( stack_id );
     IS_SERVICE_INITIALIZED( );
-    smodem_task task       = { 0 };
-    task.id                = lorawan_beacon_tx_example_obj.task_id;
-    task.stack_id          = lorawan_beacon_tx_example_obj.stack_id;
-    task.priority          = TASK_MEDIUM_HIGH_PRIORITY;
-    task.time_to_execute_s = smtc_modem_hal_get_time_in_s( ) + 10;
-    modem_supervisor_add_task( &task );
+    modem_async_start( &lorawan_beacon_tx_example_async );
     lorawan_beacon_tx_example_obj.enabled = true;
 }
 /*
@@ -222,8 +209,6 @@ static void start_user_beacon_callback( void* context )
     lora_param.mod_params.ldro = ral_compute_lora_ldro( lora_param.mod_params.sf, lora_param.mod_params.bw );
     lora_param.pkt_params.preamble_len_in_symb = 10;
 
-    smtc_modem_hal_start_radio_tcxo( );
-    smtc_modem_hal_set_ant_switch( true );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_lora( ( modem_get_rp( )->radio ), &lora_param ) == RAL_STATUS_OK );
     ral_set_dio_irq_params( &( modem_get_rp( )->radio->ral ), RAL_IRQ_TX_DONE );
     uint8_t payload[17];
@@ -237,7 +222,39 @@ static void start_user_beacon_callback( void* context )
     payload[6]            = ( computed_crc ) & 0x00FF;
     payload[7]            = ( computed_crc >> 8 ) & 0x00FF;
     ral_set_pkt_payload( &( modem_get_rp( )->radio->ral ), payload, 17 );
+#if defined( ADD_RP_TIMED_TX )
+    // The beacon leaves on the timer compare at the start time, not at the launch up to RP_MARGIN_DELAY before
+    rp_task_start_tx_at_start_time( modem_get_rp( ), RP_HOOK_ID_DIRECT_RP_ACCESS );
+#else
+    rp_task_wait_start_time( modem_get_rp( ), RP_HOOK_ID_DIRECT_RP_ACCESS );
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( true );
     ral_set_tx( &( modem_get_rp( )->radio->ral ) );
+#endif
+}
+
+static void lorawan_beacon_tx_example_run( modem_async_t* async )
+{
+    MODEM_ASYNC_BEGIN( async );
+    // The beacons are aligned on the GPS time, a DeviceTimeReq is sent until the network time is known
+    do
+    {
+        MODEM_ASYNC_AWAIT_TIME( async, TX_BEACON_TIME_RETRY_DELAY_MS );
+        if( lorawan_api_is_time_valid( lorawan_beacon_tx_example_obj.stack_id ) == false )
+        {
+            uint8_t cid_buffer[]     = { DEVICE_TIME_REQ };
+            uint8_t cid_request_size = 1;
+
+            tx_protocol_manager_request( TX_PROTOCOL_TRANSMIT_CID, 0, false, cid_buffer, cid_request_size, 0,
+                                         smtc_modem_hal_get_time_in_ms( ), lorawan_beacon_tx_example_obj.stack_id );
+        }
+        MODEM_ASYNC_AWAIT_TX_DONE( async );
+    } while( ( lorawan_api_isjoined( lorawan_beacon_tx_example_obj.stack_id ) != JOINED ) ||
+             ( lorawan_api_is_time_valid( lorawan_beacon_tx_example_obj.stack_id ) == false ) );
+
+    lorawan_beacon_tx_example_obj.enabled = true;
+    start_user_beacon( );
+    MODEM_ASYNC_END( async );
 }
 
 static void end_user_beacon_callback( void* status )
@@ -0,0 +1,525 @@
+/**
+ * @file      ble_bridge.c
+ *
+ * @brief     BLE to LoRaWAN bridge: batches BLE peer records into store and forward uplinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memcpy
+#include "ble_bridge.h"
+#include "modem_core.h"
+#include "modem_supervisor_light.h"
+#include "smtc_modem_hal.h"
+#include "smtc_modem_hal_dbg_trace.h"
+#include "lorawan_api.h"
+#include "store_and_forward_flash.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define CURRENT_STACK ( task_id / NUMBER_OF_TASKS )
+#define NUMBER_MAX_OF_BLE_BRIDGE_OBJ 1  // modify in case of multiple obj
+
+/**
+ * @brief Record tag flag set when the peer address follows the tag
+ */
+#define BLE_BRIDGE_TAG_NEW_PEER ( 0x80 )
+
+/**
+ * @brief Record size without peer address: tag, age and length bytes
+ */
+#define BLE_BRIDGE_RECORD_HEADER_SIZE ( 3 )
+
+/**
+ * @brief BLE address size in byte
+ */
+#define BLE_BRIDGE_PEER_ADDR_SIZE ( 6 )
+
+#if( BLE_BRIDGE_PEERS_PER_BATCH > 16 )
+#error "BLE_BRIDGE_PEERS_PER_BATCH must fit in the 4 bits of the record tag"
+#endif
+
+/**
+ * @brief Check is the index is valid before accessing BLE bridge object
+ *
+ */
+#define IS_VALID_OBJECT_ID( x )                                              \
+    do                                                                       \
+    {                                                                        \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_MAX_OF_BLE_BRIDGE_OBJ ); \
+    } while( 0 )
+
+/**
+ * @brief Check is the index is valid before accessing the object
+ *
+ */
+#define IS_VALID_STACK_ID( x )                                   \
+    do                                                           \
+    {                                                            \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_OF_STACKS ); \
+    } while( 0 )
+
+/**
+ * @brief Check is the service is initialized before accessing the object
+ *
+ */
+#define IS_SERVICE_INITIALIZED( x )                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        if( ble_bridge_obj[x].initialized == false )                                    \
+        {                                                                               \
+            SMTC_MODEM_HAL_TRACE_WARNING( "ble_bridge_obj service not initialized\n" ); \
+            return;                                                                     \
+        }                                                                               \
+    } while( 0 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief BLE bridge Object
+ *
+ * @struct ble_bridge_s
+ */
+typedef struct ble_bridge_s
+{
+    uint8_t stack_id;
+    uint8_t task_id;
+    bool    enabled;
+    bool    initialized;
+
+    uint8_t  fport;
+    uint32_t flush_delay_s;
+
+    uint8_t  batch[BLE_BRIDGE_BATCH_SIZE_MAX];
+    uint8_t  batch_len;
+    uint32_t batch_open_timestamp_s;
+    uint8_t  peers[BLE_BRIDGE_PEERS_PER_BATCH][BLE_BRIDGE_PEER_ADDR_SIZE];
+    uint8_t  nb_peers;
+} ble_bridge_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static ble_bridge_t ble_bridge_obj[NUMBER_MAX_OF_BLE_BRIDGE_OBJ];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * @brief   Enqueue task in supervisor
+ *
+ * @param [in] ctx                  BLE bridge object context
+ * @param [in] delay_to_execute_s   duration before the next execution of this task
+ */
+static void ble_bridge_add_task( ble_bridge_t* ctx, uint32_t delay_to_execute_s );
+
+/**
+ * @brief Callback called at task launch
+ *
+ * @param context_callback
+ */
+static void ble_bridge_service_on_launch( void* context );
+
+/**
+ * @brief Callback called at task completion
+ *
+ * @param context_callback
+ */
+static void ble_bridge_service_on_update( void* context );
+
+/**
+ * @brief Get the BLE bridge object from the stack id
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [out] service_id  Service identifier
+ * @return ble_bridge_t*    Object context, NULL if not found
+ */
+static ble_bridge_t* ble_bridge_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id );
+
+/**
+ * @brief Get the size the batch can grow to, based on the next uplink maximum payload
+ *
+ * @param [in] ctx      BLE bridge object context
+ * @return uint8_t      Batch size limit in byte
+ */
+static uint8_t ble_bridge_get_batch_capacity( ble_bridge_t* ctx );
+
+/**
+ * @brief Check if the store and forward fifo can take a new batch without reaching the low watermark
+ *
+ * @param [in] ctx  BLE bridge object context
+ * @return true if a batch can be stored
+ */
+static bool ble_bridge_fifo_has_room( ble_bridge_t* ctx );
+
+/**
+ * @brief Move the current batch to the store and forward fifo
+ *
+ * @param [in] ctx          BLE bridge object context
+ * @return ble_bridge_rc_t
+ */
+static ble_bridge_rc_t ble_bridge_store_batch( ble_bridge_t* ctx );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void ble_bridge_services_init( uint8_t* service_id, uint8_t task_id,
+                               uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                               void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                               void** context_callback )
+{
+    IS_VALID_OBJECT_ID( *service_id );
+
+    ble_bridge_t* ctx = &ble_bridge_obj[*service_id];
+    memset( ctx, 0, sizeof( ble_bridge_t ) );
+
+    *downlink_callback  = NULL;
+    *on_launch_callback = ble_bridge_service_on_launch;
+    *on_update_callback = ble_bridge_service_on_update;
+    *context_callback   = ( void* ) service_id;
+
+    ctx->task_id       = task_id;
+    ctx->stack_id      = CURRENT_STACK;
+    ctx->enabled       = false;
+    ctx->flush_delay_s = BLE_BRIDGE_FLUSH_DELAY_S;
+    ctx->initialized   = true;
+}
+
+ble_bridge_rc_t ble_bridge_set_state( uint8_t stack_id, bool enabled, uint8_t fport, uint32_t flush_delay_s )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t       service_id;
+    ble_bridge_t* ctx = ble_bridge_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->initialized == false ) )
+    {
+        return BLE_BRIDGE_RC_FAIL;
+    }
+
+    if( enabled == false )
+    {
+        if( ctx->enabled == true )
+        {
+            // Keep what was already received, the fifo low watermark leaves room for this last batch
+            ctx->enabled = false;
+            ble_bridge_store_batch( ctx );
+            ctx->batch_len = 0;
+            ctx->nb_peers  = 0;
+            modem_supervisor_remove_task( ctx->task_id );
+        }
+        return BLE_BRIDGE_RC_OK;
+    }
+
+    if( ( fport == 0 ) || ( fport >= 224 ) )
+    {
+        return BLE_BRIDGE_RC_INVALID;
+    }
+
+    if( store_and_forward_flash_get_state( stack_id ) == STORE_AND_FORWARD_DISABLE )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "BLE bridge needs store and forward enabled\n" );
+        return BLE_BRIDGE_RC_FAIL;
+    }
+
+    ctx->fport         = fport;
+    ctx->flush_delay_s = ( flush_delay_s != 0 ) ? flush_delay_s : BLE_BRIDGE_FLUSH_DELAY_S;
+    ctx->enabled       = true;
+    return BLE_BRIDGE_RC_OK;
+}
+
+ble_bridge_rc_t ble_bridge_add_record( uint8_t stack_id, const uint8_t* peer_addr, const uint8_t* data,
+                                       uint8_t data_length )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t       service_id;
+    ble_bridge_t* ctx = ble_bridge_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->enabled == false ) )
+    {
+        return BLE_BRIDGE_RC_FAIL;
+    }
+
+    if( ( peer_addr == NULL ) || ( ( data == NULL ) && ( data_length != 0 ) ) )
+    {
+        return BLE_BRIDGE_RC_INVALID;
+    }
+
+    // The record of a new peer in an empty batch shall fit in a store and forward slot
+    if( ( 1 + BLE_BRIDGE_PEER_ADDR_SIZE + BLE_BRIDGE_RECORD_HEADER_SIZE + data_length ) > BLE_BRIDGE_BATCH_SIZE_MAX )
+    {
+        return BLE_BRIDGE_RC_INVALID;
+    }
+
+    uint8_t peer_index = ctx->nb_peers;
+    for( uint8_t i = 0; i < ctx->nb_peers; i++ )
+    {
+        if( memcmp( ctx->peers[i], peer_addr, BLE_BRIDGE_PEER_ADDR_SIZE ) == 0 )
+        {
+            peer_index = i;
+            break;
+        }
+    }
+
+    uint8_t record_len = BLE_BRIDGE_RECORD_HEADER_SIZE + data_length;
+    if( peer_index == ctx->nb_peers )
+    {
+        record_len += BLE_BRIDGE_PEER_ADDR_SIZE;
+    }
+
+    // Close the batch when the record does not fit in the next uplink or the peer table is full
+    if( ( ctx->batch_len != 0 ) && ( ( ( ctx->batch_len + record_len ) > ble_bridge_get_batch_capacity( ctx ) ) ||
+                                     ( peer_index == BLE_BRIDGE_PEERS_PER_BATCH ) ) )
+    {
+        ble_bridge_rc_t rc = ble_bridge_store_batch( ctx );
+        if( rc != BLE_BRIDGE_RC_OK )
+        {
+            return rc;
+        }
+        ctx->batch_len = 0;
+        ctx->nb_peers  = 0;
+        peer_index     = 0;
+        record_len     = BLE_BRIDGE_PEER_ADDR_SIZE + BLE_BRIDGE_RECORD_HEADER_SIZE + data_length;
+    }
+
+    uint32_t now_s = smtc_modem_hal_get_time_in_s( );
+
+    if( ctx->batch_len == 0 )
+    {
+        ctx->batch[0]               = BLE_BRIDGE_BATCH_VERSION;
+        ctx->batch_len              = 1;
+        ctx->batch_open_timestamp_s = now_s;
+        ble_bridge_add_task( ctx, ctx->flush_delay_s );
+    }
+
+    uint32_t age_s = now_s - ctx->batch_open_timestamp_s;
+    uint8_t* p     = &ctx->batch[ctx->batch_len];
+
+    if( peer_index == ctx->nb_peers )
+    {
+        memcpy( ctx->peers[peer_index], peer_addr, BLE_BRIDGE_PEER_ADDR_SIZE );
+        ctx->nb_peers++;
+        *p++ = BLE_BRIDGE_TAG_NEW_PEER | peer_index;
+        memcpy( p, peer_addr, BLE_BRIDGE_PEER_ADDR_SIZE );
+        p += BLE_BRIDGE_PEER_ADDR_SIZE;
+    }
+    else
+    {
+        *p++ = peer_index;
+    }
+    *p++ = ( age_s > 0xFF ) ? 0xFF : ( uint8_t ) age_s;
+    *p++ = data_length;
+    if( data_length != 0 )
+    {
+        memcpy( p, data, data_length );
+    }
+    ctx->batch_len += record_len;
+
+    return BLE_BRIDGE_RC_OK;
+}
+
+ble_bridge_rc_t ble_bridge_flush( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t       service_id;
+    ble_bridge_t* ctx = ble_bridge_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->enabled == false ) )
+    {
+        return BLE_BRIDGE_RC_FAIL;
+    }
+
+    ble_bridge_rc_t rc = ble_bridge_store_batch( ctx );
+    if( rc == BLE_BRIDGE_RC_OK )
+    {
+        ctx->batch_len = 0;
+        ctx->nb_peers  = 0;
+        modem_supervisor_remove_task( ctx->task_id );
+    }
+    return rc;
+}
+
+bool ble_bridge_is_accepting( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t       service_id;
+    ble_bridge_t* ctx = ble_bridge_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->enabled == false ) )
+    {
+        return false;
+    }
+
+    return ble_bridge_fifo_has_room( ctx );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void ble_bridge_service_on_launch( void* service_id )
+{
+    uint8_t idx = *( ( uint8_t* ) service_id );
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s service_id %d \n", __func__, idx );
+
+    IS_SERVICE_INITIALIZED( idx );
+    ble_bridge_t* ctx = &ble_bridge_obj[idx];
+
+    if( ( ctx->enabled == false ) || ( ctx->batch_len == 0 ) )
+    {
+        return;
+    }
+
+    if( ble_bridge_store_batch( ctx ) == BLE_BRIDGE_RC_OK )
+    {
+        ctx->batch_len = 0;
+        ctx->nb_peers  = 0;
+    }
+}
+
+static void ble_bridge_service_on_update( void* service_id )
+{
+    uint8_t idx = *( ( uint8_t* ) service_id );
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s service_id %d \n", __func__, idx );
+
+    IS_SERVICE_INITIALIZED( idx );
+    ble_bridge_t* ctx = &ble_bridge_obj[idx];
+
+    // Fifo was full at launch, keep the batch and retry later
+    if( ( ctx->enabled == true ) && ( ctx->batch_len != 0 ) )
+    {
+        ble_bridge_add_task( ctx, ctx->flush_delay_s );
+    }
+}
+
+static ble_bridge_t* ble_bridge_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id )
+{
+    ble_bridge_t* ctx = NULL;
+    for( uint8_t i = 0; i < NUMBER_MAX_OF_BLE_BRIDGE_OBJ; i++ )
+    {
+        if( ble_bridge_obj[i].stack_id == stack_id )
+        {
+            ctx         = &ble_bridge_obj[i];
+            *service_id = i;
+            break;
+        }
+    }
+
+    return ctx;
+}
+
+static uint8_t ble_bridge_get_batch_capacity( ble_bridge_t* ctx )
+{
+    uint8_t max_payload = lorawan_api_next_max_payload_length_get( ctx->stack_id );
+
+    return ( max_payload < BLE_BRIDGE_BATCH_SIZE_MAX ) ? max_payload : BLE_BRIDGE_BATCH_SIZE_MAX;
+}
+
+static bool ble_bridge_fifo_has_room( ble_bridge_t* ctx )
+{
+    uint32_t capacity  = 0;
+    uint32_t free_slot = 0;
+
+    if( store_and_forward_flash_get_number_of_free_slot( ctx->stack_id, &capacity, &free_slot ) !=
+        STORE_AND_FORWARD_FLASH_RC_OK )
+    {
+        return false;
+    }
+
+    return free_slot > BLE_BRIDGE_FIFO_LOW_WATERMARK;
+}
+
+static ble_bridge_rc_t ble_bridge_store_batch( ble_bridge_t* ctx )
+{
+    // Only the version byte, nothing to send
+    if( ctx->batch_len <= 1 )
+    {
+        return BLE_BRIDGE_RC_OK;
+    }
+
+    if( ( ctx->enabled == true ) && ( ble_bridge_fifo_has_room( ctx ) == false ) )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "BLE bridge store and forward fifo full\n" );
+        return BLE_BRIDGE_RC_BUSY;
+    }
+
+    store_and_forward_flash_rc_t rc =
+        store_and_forward_flash_add_data( ctx->stack_id, ctx->fport, false, ctx->batch, ctx->batch_len );
+
+    if( rc != STORE_AND_FORWARD_FLASH_RC_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "BLE bridge batch not stored (%d)\n", rc );
+        return ( rc == STORE_AND_FORWARD_FLASH_RC_INVALID ) ? BLE_BRIDGE_RC_INVALID : BLE_BRIDGE_RC_FAIL;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "BLE bridge batch stored: %u bytes, %u peers\n", ctx->batch_len, ctx->nb_peers );
+    return BLE_BRIDGE_RC_OK;
+}
+
+static void ble_bridge_add_task( ble_bridge_t* ctx, uint32_t delay_to_execute_s )
+{
+    // If service not enabled -> exit
+    if( ctx->enabled == false )
+    {
+        return;
+    }
+    smodem_task task_dm       = { 0 };
+    task_dm.id                = ctx->task_id;
+    task_dm.stack_id          = ctx->stack_id;
+    task_dm.priority          = TASK_LOW_PRIORITY;
+    task_dm.time_to_execute_s = smtc_modem_hal_get_time_in_s( ) + delay_to_execute_s;
+
+    modem_supervisor_add_task( &task_dm );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,187 @@
+/**
+ * @file      ble_bridge.h
+ *
+ * @brief     BLE to LoRaWAN bridge: batches BLE peer records into store and forward uplinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BLE_BRIDGE_H
+#define BLE_BRIDGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include "lr1_stack_mac_layer.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/**
+ * @brief Version byte starting every batch
+ *
+ * Batch layout: version (1 byte) followed by records. A record is:
+ *  - tag (1 byte): bit 7 set when the peer appears for the first time in the batch, bits 0-3 peer index in the batch
+ *  - peer address (6 bytes, only when bit 7 of the tag is set)
+ *  - age (1 byte): seconds between the opening of the batch and the record, saturated to 255
+ *  - length (1 byte) followed by the record data
+ */
+#define BLE_BRIDGE_BATCH_VERSION ( 1 )
+
+/**
+ * @brief Maximum batch size, must not exceed the store and forward slot size
+ */
+#ifndef BLE_BRIDGE_BATCH_SIZE_MAX
+#define BLE_BRIDGE_BATCH_SIZE_MAX ( 51 )
+#endif
+
+/**
+ * @brief Maximum number of distinct peers in a batch (up to 16)
+ */
+#ifndef BLE_BRIDGE_PEERS_PER_BATCH
+#define BLE_BRIDGE_PEERS_PER_BATCH ( 8 )
+#endif
+
+/**
+ * @brief Default delay after which an incomplete batch is stored
+ */
+#ifndef BLE_BRIDGE_FLUSH_DELAY_S
+#define BLE_BRIDGE_FLUSH_DELAY_S ( 300 )
+#endif
+
+/**
+ * @brief Free store and forward slots kept before BLE records are refused
+ */
+#ifndef BLE_BRIDGE_FIFO_LOW_WATERMARK
+#define BLE_BRIDGE_FIFO_LOW_WATERMARK ( 2 )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Definition of return codes for BLE bridge functions
+ *
+ * @enum ble_bridge_rc_t
+ */
+typedef enum ble_bridge_rc_e
+{
+    BLE_BRIDGE_RC_OK,       //!< Function executed without error
+    BLE_BRIDGE_RC_INVALID,  //!< Invalid parameters
+    BLE_BRIDGE_RC_BUSY,     //!< Store and forward fifo full, retry later
+    BLE_BRIDGE_RC_FAIL,     //!< Fail to execute the function
+} ble_bridge_rc_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init a new BLE bridge services object
+ *
+ * @param service_id
+ * @param task_id
+ * @param downlink_callback
+ * @param on_launch_callback
+ * @param on_update_callback
+ * @param context_callback
+ */
+void ble_bridge_services_init( uint8_t* service_id, uint8_t task_id,
+                               uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                               void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                               void** context_callback );
+
+/**
+ * @brief Enable or disable the BLE bridge, disabling it stores the pending batch
+ *
+ * @param [in] stack_id      Stack identifier
+ * @param [in] enabled       Bridge state
+ * @param [in] fport         LoRaWAN FPort of the batch uplinks
+ * @param [in] flush_delay_s Delay after which an incomplete batch is stored, 0 for BLE_BRIDGE_FLUSH_DELAY_S
+ * @return ble_bridge_rc_t
+ */
+ble_bridge_rc_t ble_bridge_set_state( uint8_t stack_id, bool enabled, uint8_t fport, uint32_t flush_delay_s );
+
+/**
+ * @brief Add a record received from a BLE peer to the current batch
+ *
+ * @remark The batch is stored in the store and forward fifo when the record does not fit in the next uplink. When
+ * the fifo is almost full, BLE_BRIDGE_RC_BUSY is returned and the record is not added: the caller shall throttle
+ * the BLE peers until @ref ble_bridge_is_accepting returns true
+ *
+ * @param [in] stack_id    Stack identifier
+ * @param [in] peer_addr   BLE address of the peer (6 bytes)
+ * @param [in] data        Record data
+ * @param [in] data_length Record length
+ * @return ble_bridge_rc_t
+ */
+ble_bridge_rc_t ble_bridge_add_record( uint8_t stack_id, const uint8_t* peer_addr, const uint8_t* data,
+                                       uint8_t data_length );
+
+/**
+ * @brief Store the current batch in the store and forward fifo
+ *
+ * @param [in] stack_id Stack identifier
+ * @return ble_bridge_rc_t
+ */
+ble_bridge_rc_t ble_bridge_flush( uint8_t stack_id );
+
+/**
+ * @brief Check if the bridge can take more BLE records without overwriting stored data
+ *
+ * @param [in] stack_id Stack identifier
+ * @return true if records are accepted
+ */
+bool ble_bridge_is_accepting( uint8_t stack_id );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLE_BRIDGE_H
+
+/* --- EOF ------------------------------------------------------------------ */
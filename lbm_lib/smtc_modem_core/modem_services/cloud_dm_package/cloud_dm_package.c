@@ -49,6 +49,12 @@
 #include "modem_event_utilities.h"
 #include "device_management_defs.h"
 #include "cloud_dm_package.h"
+#if defined( ADD_SMTC_DM_PERF )
+#include "modem_perf_counters.h"
+#endif  // ADD_SMTC_DM_PERF
+#if defined( ADD_SMTC_DM_PERF ) && defined( ADD_SMTC_LATENCY_HISTOGRAM )
+#include "smtc_modem_dbg_latency.h"
+#endif
 
 #if defined( USE_LR11XX_CE )
 #include "lr11xx_system.h"
@@ -175,7 +181,9 @@ static const uint8_t dm_info_field_sz[DM_INFO_MAX] = {
     [DM_INFO_STREAMPAR] = 2,  //
     [DM_INFO_APPSTATUS] = 8,  //
     [DM_INFO_ALCSYNC]   = 0,  // (variable-length, not sent periodically)
-    [DM_INFO_ALMSTATUS] = 7
+    [DM_INFO_ALMSTATUS] = 7,  //
+    [DM_INFO_PERF]      = 9,  //
+    [DM_INFO_BATTERY]   = 4,  //
 };
 
 #define DEFAULT_DM_REPORTING_INTERVAL 0x81  // 1h
@@ -183,6 +191,25 @@ static const uint8_t dm_info_field_sz[DM_INFO_MAX] = {
 
 #define REQ_EVENT_DM_SET_CONF_BIT 0x01
 #define REQ_EVENT_MUTE_BIT 0x02
+
+#if defined( ADD_SMTC_DM_DELTA )
+#if defined( ADD_SMTC_DM_PERF )
+#define DM_DELTA_VALUE_SIZE_MAX 9  // biggest fixed size field kept for change detection
+#else
+#define DM_DELTA_VALUE_SIZE_MAX 8  // biggest fixed size field kept for change detection
+#endif
+#define DEFAULT_DM_DELTA_KEEPALIVE 24      // complete periodic report every 24 intervals (1 day with default interval)
+
+// Default change thresholds of the numeric fields, in the unit of the reported field
+static const uint16_t dm_delta_default_threshold[DM_INFO_MAX] = {
+    [DM_INFO_CHARGE]  = 10,  // mAh
+    [DM_INFO_VOLTAGE] = 5,   // 1/50 V
+    [DM_INFO_TEMP]    = 3,   // deg Celsius
+    [DM_INFO_SIGNAL]  = 6,   // RSSI dB
+    [DM_INFO_UPTIME]  = 23,  // h
+    [DM_INFO_RXTIME]  = 23,  // h
+};
+#endif  // ADD_SMTC_DM_DELTA
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -270,6 +297,24 @@ typedef struct cloud_dm_s
     uint8_t         dm_event_requested_bitfield;
     dm_info_field_t last_dm_set_conf_opcode_requested;
 
+#if defined( ADD_SMTC_DM_DELTA )
+    uint8_t  dm_delta_last_value[DM_INFO_MAX][DM_DELTA_VALUE_SIZE_MAX];  //!< last reported value of each field
+    uint16_t dm_delta_threshold[DM_INFO_MAX];  //!< change needed to report a numeric field again
+    uint32_t dm_delta_reported_bitfield;       //!< fields with a last reported value
+    uint32_t dm_info_bitfield_delta;           //!< fields of the periodic report being sent
+    uint8_t  dm_delta_keepalive;               //!< number of intervals between two complete reports
+    uint8_t  dm_delta_interval_count;          //!< intervals since the last complete report
+#endif  // ADD_SMTC_DM_DELTA
+
+#if defined( ADD_SMTC_DM_PERF )
+    uint32_t dm_perf_last[MODEM_PERF_NB_COUNTERS];  //!< performance counters at the last report
+    uint32_t dm_perf_read[MODEM_PERF_NB_COUNTERS];  //!< performance counters of the field being reported
+#if defined( ADD_SMTC_LATENCY_HISTOGRAM )
+    uint32_t dm_perf_latency_last[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS];  //!< uplink latency buckets at the last report
+    uint32_t dm_perf_latency_read[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS];  //!< uplink latency buckets being reported
+#endif
+#endif  // ADD_SMTC_DM_PERF
+
 } cloud_dm_t;
 
 static cloud_dm_t cloud_dm_obj[NUMBER_MAX_OF_CLOUD_DM_OBJ];
@@ -434,6 +479,60 @@ static bool dm_status_payload( cloud_dm_t* ctx, uint8_t stack_id, uint8_t* dm_up
  */
 static dm_cmd_length_valid_t check_dm_status_max_size( uint32_t info_requested, uint8_t max_size );
 
+/*!
+ * @brief   Write the current value of a DM status field
+ *
+ * @param [in]  ctx *                       Cloud DM context
+ * @param [in]  stack_id                    Stack identifier
+ * @param [in]  field                       Field to encode
+ * @param [out] value *                     Returned value, dm_info_field_sz[field] bytes
+ */
+static void dm_info_field_encode( cloud_dm_t* ctx, uint8_t stack_id, dm_info_field_t field, uint8_t* value );
+
+#if defined( ADD_SMTC_DM_DELTA )
+/*!
+ * @brief   Check if a field moved enough since it was last reported
+ *
+ * @param [in]  ctx *                       Cloud DM context
+ * @param [in]  field                       Field to check
+ * @param [in]  value *                     Current value of the field
+ * @retval bool                             Return true if the field must be reported
+ */
+static bool dm_delta_field_changed( cloud_dm_t* ctx, dm_info_field_t field, const uint8_t* value );
+
+/*!
+ * @brief   Get the fields of the next periodic report
+ *
+ * @remark  Only the periodic fields that changed are returned, except every dm_delta_keepalive intervals
+ *          where all of them are. The bitfield is kept while the report is split in several uplinks.
+ *
+ * @param [in]  ctx *                       Cloud DM context
+ * @param [in]  stack_id                    Stack identifier
+ * @retval uint32_t                         Fields to report, 0 if the interval can be skipped
+ */
+static uint32_t dm_delta_get_periodic_bitfield( cloud_dm_t* ctx, uint8_t stack_id );
+#endif  // ADD_SMTC_DM_DELTA
+
+#if defined( ADD_SMTC_DM_PERF )
+/*!
+ * @brief   Write the performance field, differences of the counters since the last report
+ *
+ * @remark  The counters read are kept in the context, dm_perf_commit() makes them the reference of the next report
+ *          once the field is in the uplink
+ *
+ * @param [in]  ctx *                       Cloud DM context
+ * @param [out] value *                     Returned value, dm_info_field_sz[DM_INFO_PERF] bytes
+ */
+static void dm_perf_encode( cloud_dm_t* ctx, uint8_t* value );
+
+/*!
+ * @brief   Take the counters of the last encoded performance field as reference of the next report
+ *
+ * @param [in]  ctx *                       Cloud DM context
+ */
+static void dm_perf_commit( cloud_dm_t* ctx );
+#endif  // ADD_SMTC_DM_PERF
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -468,6 +567,11 @@ void cloud_dm_services_init( uint8_t* service_id, uint8_t task_id,
     ctx->is_first_dm_after_join                = true;
     ctx->is_pending_dm_status_payload_periodic = false;
     ctx->is_pending_dm_status_payload_now      = false;
+
+#if defined( ADD_SMTC_DM_DELTA )
+    memcpy( ctx->dm_delta_threshold, dm_delta_default_threshold, sizeof( ctx->dm_delta_threshold ) );
+    ctx->dm_delta_keepalive = DEFAULT_DM_DELTA_KEEPALIVE;
+#endif  // ADD_SMTC_DM_DELTA
 }
 
 void cloud_dm_services_enable( uint8_t stack_id, bool enabled )
@@ -571,6 +675,10 @@ dm_rc_t cloud_dm_set_dm_port( uint8_t stack_id, uint8_t port )
     {
         if( ctx->dm_port != port )
         {
+#if ( NUMBER_OF_STACKS == 1 )
+            // services parsing the dm downlinks are dispatched on the dm port
+            modem_move_downlink_services_port( ctx->dm_port, port );
+#endif
             ctx->dm_port = port;
             // modem_store_context( );  // TODO do we still store context ?
         }
@@ -636,6 +744,12 @@ dm_rc_t cloud_dm_set_info_field( uint8_t stack_id, const uint8_t* requested_info
             ( requested_info_list[i] == DM_INFO_ALCSYNC ) || ( requested_info_list[i] == DM_INFO_DBGRSP ) ||
             ( requested_info_list[i] == DM_INFO_GNSSLOC ) || ( requested_info_list[i] == DM_INFO_WIFILOC ) ||
             ( requested_info_list[i] == DM_INFO_RFU_0 ) || ( requested_info_list[i] == DM_INFO_RFU_1 ) ||
+#if !defined( ADD_SMTC_DM_PERF )
+            ( requested_info_list[i] == DM_INFO_PERF ) ||
+#endif  // !ADD_SMTC_DM_PERF
+#if !defined( ADD_SMTC_BATTERY_ESTIMATOR )
+            ( requested_info_list[i] == DM_INFO_BATTERY ) ||
+#endif  // !ADD_SMTC_BATTERY_ESTIMATOR
             ( requested_info_list[i] >= DM_INFO_MAX ) )
         {
             ret = DM_ERROR;
@@ -682,6 +796,47 @@ dm_rc_t cloud_dm_set_info_field( uint8_t stack_id, const uint8_t* requested_info
     return ret;
 }
 
+#if defined( ADD_SMTC_DM_DELTA )
+dm_rc_t cloud_dm_set_info_threshold( uint8_t stack_id, dm_info_field_t field, uint16_t threshold )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t     service_id;
+    cloud_dm_t* ctx = cloud_dm_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx == NULL )
+    {
+        return DM_ERROR;
+    }
+
+    // Only numeric fields have a threshold, the others are reported on any change
+    if( ( field != DM_INFO_CHARGE ) && ( field != DM_INFO_VOLTAGE ) && ( field != DM_INFO_TEMP ) &&
+        ( field != DM_INFO_SIGNAL ) && ( field != DM_INFO_UPTIME ) && ( field != DM_INFO_RXTIME ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "DM info code 0x%02x has no threshold\n", field );
+        return DM_ERROR;
+    }
+
+    ctx->dm_delta_threshold[field] = threshold;
+    return DM_OK;
+}
+
+dm_rc_t cloud_dm_set_keepalive( uint8_t stack_id, uint8_t nb_of_intervals )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t     service_id;
+    cloud_dm_t* ctx = cloud_dm_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( nb_of_intervals == 0 ) )
+    {
+        return DM_ERROR;
+    }
+
+    ctx->dm_delta_keepalive      = nb_of_intervals;
+    ctx->dm_delta_interval_count = 0;
+    return DM_OK;
+}
+#endif  // ADD_SMTC_DM_DELTA
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -752,6 +907,9 @@ static void cloud_dm_service_on_launch( void* service_id )
             {
                 cloud_dm_obj[idx].is_first_dm_after_join  = false;
                 cloud_dm_obj[idx].dm_periodic_timestamp_s = rtc_s;
+#if defined( ADD_SMTC_DM_DELTA )
+                cloud_dm_obj[idx].dm_delta_interval_count = 0;
+#endif  // ADD_SMTC_DM_DELTA
             }
             SMTC_MODEM_HAL_TRACE_ARRAY( "join payload DM ", payload, payload_length );
         }
@@ -797,12 +955,23 @@ static void cloud_dm_service_on_launch( void* service_id )
                  ( ( int32_t ) ( rtc_s - cloud_dm_obj[idx].dm_periodic_timestamp_s -
                                  cloud_dm_get_dm_interval_second( &cloud_dm_obj[idx] ) ) >= 0 ) )
         {
-            SMTC_MODEM_HAL_TRACE_PRINTF( "DM send info periodic\n" );
             cloud_dm_obj[idx].dm_periodic_timestamp_s = rtc_s;
+            uint32_t info_bitfield_periodic           = cloud_dm_obj[idx].dm_info_bitfield_periodic;
+#if defined( ADD_SMTC_DM_DELTA )
+            info_bitfield_periodic = dm_delta_get_periodic_bitfield( &cloud_dm_obj[idx], stack_id );
+#endif  // ADD_SMTC_DM_DELTA
 
-            cloud_dm_obj[idx].is_pending_dm_status_payload_periodic = dm_status_payload(
-                &cloud_dm_obj[idx], stack_id, payload, &payload_length, max_payload,
-                cloud_dm_obj[idx].dm_info_bitfield_periodic, &cloud_dm_obj[idx].next_dm_opcode_periodic );
+            if( info_bitfield_periodic != 0 )
+            {
+                SMTC_MODEM_HAL_TRACE_PRINTF( "DM send info periodic\n" );
+                cloud_dm_obj[idx].is_pending_dm_status_payload_periodic =
+                    dm_status_payload( &cloud_dm_obj[idx], stack_id, payload, &payload_length, max_payload,
+                                       info_bitfield_periodic, &cloud_dm_obj[idx].next_dm_opcode_periodic );
+            }
+            else
+            {
+                SMTC_MODEM_HAL_TRACE_PRINTF( "DM periodic skipped, no field changed\n" );
+            }
         }
         // DL opportunities requested
         else if( cloud_dm_obj[idx].up_count != 0 )
@@ -1200,7 +1369,8 @@ static void dm_parse_cmd( cloud_dm_t* ctx, dm_cmd_msg_t* cmd_input )
     case DM_ALC_SYNC:
     case DM_FILE_DONE:
     case DM_STREAM:
-        // ALC sync, File upload and Stream are handled in another service
+    case DM_SOLV_UPDATE:
+        // ALC sync, File upload, Stream and GNSS solver update are handled in another service
         break;
     default:
         SMTC_MODEM_HAL_TRACE_WARNING( "DM unknown opcode 0x%x\n", cmd_input->request_code );
@@ -1222,6 +1392,7 @@ static dm_rc_t dm_reset( cloud_dm_t* ctx, dm_reset_code_t reset_code, uint16_t r
         case DM_RESET_APP_MCU:
         case DM_RESET_BOTH:
             // lorawan_api_context_save( );  // TODO save context
+            modem_context_flush( );
             smtc_modem_hal_reset_mcu( );
             break;
         default:
@@ -1399,143 +1570,27 @@ static bool dm_status_payload( cloud_dm_t* ctx, uint8_t stack_id, uint8_t* dm_up
         if( ( dm_info_bitfield & ( 1 << *dm_opcode ) ) )
         {
             *p_tmp++ = *dm_opcode;  // Add id Code in payload then the value(s)
-            switch( *dm_opcode )
-            {
-            case DM_INFO_STATUS:
-                *p_tmp = modem_get_status( stack_id );
-                break;
-            case DM_INFO_CHARGE: {
-                uint32_t charge;
-                smtc_modem_get_charge( &charge );
-                *p_tmp         = charge & 0xFF;
-                *( p_tmp + 1 ) = ( charge >> 8 ) & 0xFF;
-                break;
-            }
-            case DM_INFO_VOLTAGE:
-                *p_tmp = smtc_modem_hal_get_voltage_mv( ) / 20;
-                break;
-            case DM_INFO_TEMP:
-                *p_tmp = smtc_modem_hal_get_temperature( );
-                break;
-            case DM_INFO_SIGNAL: {
-                int16_t rssi = ctx->lorawan_last_rssi_get;
-                if( rssi >= -128 && rssi <= 63 )
-                {
-                    // strength of last downlink (RSSI [dBm]+64)
-                    *p_tmp = ( int8_t ) ( rssi + 64 );
-                }
-                else if( rssi > 63 )
-                {
-                    *p_tmp = 127;
-                }
-                else if( rssi < -128 )
-                {
-                    *p_tmp = -128;
-                }
-                // strength of last downlink (SNR [0.25 dB])
-                *( p_tmp + 1 ) = ctx->lorawan_last_snr_get << 2;
-                break;
-            }
-            case DM_INFO_UPTIME: {
-                // The uptime is the RTC start
-                uint32_t time  = smtc_modem_hal_get_time_in_s( ) / 3600;
-                *p_tmp         = time & 0xFF;
-                *( p_tmp + 1 ) = time >> 8;
-            }
-            break;
-            case DM_INFO_RXTIME: {
-                uint32_t time_h = 0;
-                uint32_t rtc_s  = smtc_modem_hal_get_time_in_s( );
-
-                if( rtc_s >= ctx->last_dl_timestamp_s )
-                {
-                    time_h = ( rtc_s - ctx->last_dl_timestamp_s ) / 3600;
-                }
-                else
-                {
-                    time_h = ( uint32_t ) ( ~0UL ) - ctx->last_dl_timestamp_s + rtc_s;
-                }
-
-                *p_tmp         = time_h & 0xFF;
-                *( p_tmp + 1 ) = time_h >> 8;
-            }
-            break;
-            case DM_INFO_FIRMWARE: {
-                memset( p_tmp, 0, 8 );  // fill with 0 as firmware info is only useful in embedded modem
-            }
-            break;
-            case DM_INFO_ADRMODE:
-                *p_tmp = lorawan_api_dr_strategy_get( stack_id );
-                break;
-            case DM_INFO_JOINEUI: {
-                uint8_t p_tmp_app_eui[8];
-                lorawan_api_get_joineui( p_tmp_app_eui, stack_id );
-                memcpy1_r( p_tmp, p_tmp_app_eui, 8 );
-                break;
-            }
-            case DM_INFO_INTERVAL:
-                *p_tmp = cloud_dm_get_dm_interval( stack_id );
-                break;
-            case DM_INFO_REGION:
-                *p_tmp = lorawan_api_get_region( stack_id );
-                break;
-            case DM_INFO_RFU_0:
-                // Nothing to do
-                break;
-            case DM_INFO_CRASHLOG:
-
-                break;
-            case DM_INFO_RSTCOUNT: {
-                uint32_t nb_reset = modem_get_reset_counter( );
-                *p_tmp            = nb_reset & 0xFF;
-                *( p_tmp + 1 )    = nb_reset >> 8;
-                break;
-            }
-            case DM_INFO_DEVEUI: {
-                uint8_t p_tmp_dev_eui[8];
-                lorawan_api_get_deveui( p_tmp_dev_eui, stack_id );
-                memcpy1_r( p_tmp, p_tmp_dev_eui, 8 );
-                break;
-            }
-            case DM_INFO_RFU_1:
-                // Nothing to do
-                break;
-            case DM_INFO_SESSION: {
-                uint16_t dev_nonce = lorawan_api_devnonce_get( stack_id );
-                *p_tmp             = dev_nonce & 0xFF;
-                *( p_tmp + 1 )     = dev_nonce >> 8;
-                break;
-            }
-            case DM_INFO_CHIPEUI: {
-                uint8_t p_tmp_chip_eui[8] = { 0 };
-#if defined( USE_LR11XX_CE )
-                lr11xx_system_read_uid( modem_get_radio_ctx( ), ( uint8_t* ) &p_tmp_chip_eui );
-#endif  // USE_LR11XX_CE
-                memcpy1_r( p_tmp, p_tmp_chip_eui, 8 );
-                break;
-            }
-#if defined( ADD_SMTC_STREAM )
-            case DM_INFO_STREAMPAR:
-                *p_tmp         = stream_get_port( stack_id );
-                *( p_tmp + 1 ) = stream_encrypted_mode( stack_id );
-                break;
-#endif  // ADD_SMTC_STREAM
-            case DM_INFO_APPSTATUS:
-                cloud_dm_get_modem_user_app_status( stack_id, p_tmp );
-                break;
-            case DM_INFO_ALMSTATUS:
-                // handled in dedicated almanac update service
-                break;
-            default:
-                SMTC_MODEM_HAL_TRACE_ERROR( "Construct DM payload report, unknown code 0x%02x\n", *dm_opcode );
-                break;
-            }
+            dm_info_field_encode( ctx, stack_id, ( dm_info_field_t ) *dm_opcode, p_tmp );
 
             p_tmp += dm_info_field_sz[*dm_opcode];
             // Check if last message can be enqueued
             if( ( p_tmp - dm_uplink_message ) <= max_size )
             {
                 p = p_tmp;
+#if defined( ADD_SMTC_DM_DELTA )
+                if( dm_info_field_sz[*dm_opcode] <= DM_DELTA_VALUE_SIZE_MAX )
+                {
+                    memcpy( ctx->dm_delta_last_value[*dm_opcode], p_tmp - dm_info_field_sz[*dm_opcode],
+                            dm_info_field_sz[*dm_opcode] );
+                    ctx->dm_delta_reported_bitfield |= ( 1 << *dm_opcode );
+                }
+#endif  // ADD_SMTC_DM_DELTA
+#if defined( ADD_SMTC_DM_PERF )
+                if( *dm_opcode == DM_INFO_PERF )
+                {
+                    dm_perf_commit( ctx );
+                }
+#endif  // ADD_SMTC_DM_PERF
             }
             else
             {
@@ -1567,4 +1622,301 @@ static dm_cmd_length_valid_t check_dm_status_max_size( uint32_t info_requested,
     return DM_CMD_LENGTH_VALID;
 }
 
+static void dm_info_field_encode( cloud_dm_t* ctx, uint8_t stack_id, dm_info_field_t field, uint8_t* value )
+{
+    switch( field )
+    {
+    case DM_INFO_STATUS:
+        *value = modem_get_status( stack_id );
+        break;
+    case DM_INFO_CHARGE: {
+        uint32_t charge;
+        smtc_modem_get_charge( &charge );
+        *value         = charge & 0xFF;
+        *( value + 1 ) = ( charge >> 8 ) & 0xFF;
+        break;
+    }
+    case DM_INFO_VOLTAGE:
+        *value = smtc_modem_hal_get_voltage_mv( ) / 20;
+        break;
+    case DM_INFO_TEMP:
+        *value = smtc_modem_hal_get_temperature( );
+        break;
+    case DM_INFO_SIGNAL: {
+        int16_t rssi = ctx->lorawan_last_rssi_get;
+        if( rssi >= -128 && rssi <= 63 )
+        {
+            // strength of last downlink (RSSI [dBm]+64)
+            *value = ( int8_t ) ( rssi + 64 );
+        }
+        else if( rssi > 63 )
+        {
+            *value = 127;
+        }
+        else if( rssi < -128 )
+        {
+            *value = -128;
+        }
+        // strength of last downlink (SNR [0.25 dB])
+        *( value + 1 ) = ctx->lorawan_last_snr_get << 2;
+        break;
+    }
+    case DM_INFO_UPTIME: {
+        // The uptime is the RTC start
+        uint32_t time  = smtc_modem_hal_get_time_in_s( ) / 3600;
+        *value         = time & 0xFF;
+        *( value + 1 ) = time >> 8;
+    }
+    break;
+    case DM_INFO_RXTIME: {
+        uint32_t time_h = 0;
+        uint32_t rtc_s  = smtc_modem_hal_get_time_in_s( );
+
+        if( rtc_s >= ctx->last_dl_timestamp_s )
+        {
+            time_h = ( rtc_s - ctx->last_dl_timestamp_s ) / 3600;
+        }
+        else
+        {
+            time_h = ( uint32_t ) ( ~0UL ) - ctx->last_dl_timestamp_s + rtc_s;
+        }
+
+        *value         = time_h & 0xFF;
+        *( value + 1 ) = time_h >> 8;
+    }
+    break;
+    case DM_INFO_FIRMWARE: {
+        memset( value, 0, 8 );  // fill with 0 as firmware info is only useful in embedded modem
+    }
+    break;
+    case DM_INFO_ADRMODE:
+        *value = lorawan_api_dr_strategy_get( stack_id );
+        break;
+    case DM_INFO_JOINEUI: {
+        uint8_t p_tmp_app_eui[8];
+        lorawan_api_get_joineui( p_tmp_app_eui, stack_id );
+        memcpy1_r( value, p_tmp_app_eui, 8 );
+        break;
+    }
+    case DM_INFO_INTERVAL:
+        *value = cloud_dm_get_dm_interval( stack_id );
+        break;
+    case DM_INFO_REGION:
+        *value = lorawan_api_get_region( stack_id );
+        break;
+    case DM_INFO_RFU_0:
+        // Nothing to do
+        break;
+    case DM_INFO_CRASHLOG:
+
+        break;
+    case DM_INFO_RSTCOUNT: {
+        uint32_t nb_reset = modem_get_reset_counter( );
+        *value            = nb_reset & 0xFF;
+        *( value + 1 )    = nb_reset >> 8;
+        break;
+    }
+    case DM_INFO_DEVEUI: {
+        uint8_t p_tmp_dev_eui[8];
+        lorawan_api_get_deveui( p_tmp_dev_eui, stack_id );
+        memcpy1_r( value, p_tmp_dev_eui, 8 );
+        break;
+    }
+    case DM_INFO_RFU_1:
+        // Nothing to do
+        break;
+    case DM_INFO_SESSION: {
+        uint16_t dev_nonce = lorawan_api_devnonce_get( stack_id );
+        *value             = dev_nonce & 0xFF;
+        *( value + 1 )     = dev_nonce >> 8;
+        break;
+    }
+    case DM_INFO_CHIPEUI: {
+        uint8_t p_tmp_chip_eui[8] = { 0 };
+#if defined( USE_LR11XX_CE )
+        lr11xx_system_read_uid( modem_get_radio_ctx( ), ( uint8_t* ) &p_tmp_chip_eui );
+#endif  // USE_LR11XX_CE
+        memcpy1_r( value, p_tmp_chip_eui, 8 );
+        break;
+    }
+#if defined( ADD_SMTC_STREAM )
+    case DM_INFO_STREAMPAR:
+        *value         = stream_get_port( stack_id, STREAM_DEFAULT_ID );
+        *( value + 1 ) = stream_encrypted_mode( stack_id, STREAM_DEFAULT_ID );
+        break;
+#endif  // ADD_SMTC_STREAM
+    case DM_INFO_APPSTATUS:
+        cloud_dm_get_modem_user_app_status( stack_id, value );
+        break;
+    case DM_INFO_ALMSTATUS:
+        // handled in dedicated almanac update service
+        break;
+#if defined( ADD_SMTC_DM_PERF )
+    case DM_INFO_PERF:
+        dm_perf_encode( ctx, value );
+        break;
+#endif  // ADD_SMTC_DM_PERF
+#if defined( ADD_SMTC_BATTERY_ESTIMATOR )
+    case DM_INFO_BATTERY: {
+        smtc_modem_battery_estimate_t estimate;
+        smtc_modem_get_battery_estimate( &estimate );
+        // Average current [uA] and remaining life [day], little endian, the life is 0xFFFF when unknown
+        uint32_t current_ua     = MIN( estimate.average_current_ua, UINT16_MAX );
+        uint32_t remaining_days = ( estimate.remaining_life_h == UINT32_MAX )
+                                      ? UINT16_MAX
+                                      : MIN( estimate.remaining_life_h / 24, UINT16_MAX - 1 );
+        value[0] = current_ua & 0xFF;
+        value[1] = current_ua >> 8;
+        value[2] = remaining_days & 0xFF;
+        value[3] = remaining_days >> 8;
+        break;
+    }
+#endif  // ADD_SMTC_BATTERY_ESTIMATOR
+    default:
+        SMTC_MODEM_HAL_TRACE_ERROR( "Construct DM payload report, unknown code 0x%02x\n", field );
+        break;
+    }
+}
+
+#if defined( ADD_SMTC_DM_DELTA )
+static bool dm_delta_field_changed( cloud_dm_t* ctx, dm_info_field_t field, const uint8_t* value )
+{
+    const uint8_t* last = ctx->dm_delta_last_value[field];
+    int32_t        diff;
+
+    // Never reported since the modem started
+    if( ( ctx->dm_delta_reported_bitfield & ( 1 << field ) ) == 0 )
+    {
+        return true;
+    }
+
+    switch( field )
+    {
+    case DM_INFO_CHARGE:
+    case DM_INFO_UPTIME:
+    case DM_INFO_RXTIME:
+        diff = ( int32_t ) ( value[0] | ( value[1] << 8 ) ) - ( int32_t ) ( last[0] | ( last[1] << 8 ) );
+        break;
+    case DM_INFO_VOLTAGE:
+        diff = ( int32_t ) value[0] - ( int32_t ) last[0];
+        break;
+    case DM_INFO_TEMP:
+    case DM_INFO_SIGNAL:
+        // Signed values, the SNR of the signal field is reported on any change of the RSSI only
+        diff = ( int32_t ) ( int8_t ) value[0] - ( int32_t ) ( int8_t ) last[0];
+        break;
+    default:
+        return ( memcmp( value, last, dm_info_field_sz[field] ) != 0 ) ? true : false;
+    }
+
+    if( diff < 0 )
+    {
+        diff = -diff;
+    }
+    return ( diff > ctx->dm_delta_threshold[field] ) ? true : false;
+}
+
+static uint32_t dm_delta_get_periodic_bitfield( cloud_dm_t* ctx, uint8_t stack_id )
+{
+    uint8_t  value[DM_DELTA_VALUE_SIZE_MAX];
+    uint32_t changed_bitfield = 0;
+
+    if( ctx->is_pending_dm_status_payload_periodic == true )
+    {
+        return ctx->dm_info_bitfield_delta;
+    }
+
+    ctx->dm_delta_interval_count++;
+    if( ctx->dm_delta_interval_count >= ctx->dm_delta_keepalive )
+    {
+        ctx->dm_delta_interval_count = 0;
+        ctx->dm_info_bitfield_delta  = ctx->dm_info_bitfield_periodic;
+        return ctx->dm_info_bitfield_delta;
+    }
+
+    for( uint8_t i = 0; i < DM_INFO_MAX; i++ )
+    {
+        if( ( ( ctx->dm_info_bitfield_periodic & ( 1 << i ) ) == 0 ) ||
+            ( dm_info_field_sz[i] > DM_DELTA_VALUE_SIZE_MAX ) )
+        {
+            continue;
+        }
+        memset( value, 0, sizeof( value ) );
+        dm_info_field_encode( ctx, stack_id, ( dm_info_field_t ) i, value );
+        if( dm_delta_field_changed( ctx, ( dm_info_field_t ) i, value ) == true )
+        {
+            changed_bitfield |= ( 1 << i );
+        }
+    }
+
+    ctx->dm_info_bitfield_delta = changed_bitfield;
+    return changed_bitfield;
+}
+#endif  // ADD_SMTC_DM_DELTA
+
+#if defined( ADD_SMTC_DM_PERF )
+static void dm_perf_encode( cloud_dm_t* ctx, uint8_t* value )
+{
+    uint32_t delta[MODEM_PERF_NB_COUNTERS];
+
+    for( uint8_t i = 0; i < MODEM_PERF_NB_COUNTERS; i++ )
+    {
+        ctx->dm_perf_read[i] = modem_perf_counters_get( ( modem_perf_counter_t ) i );
+        // Unsigned difference handles the wrap of the counters
+        delta[i] = ctx->dm_perf_read[i] - ctx->dm_perf_last[i];
+    }
+
+    // Duty-cycle blocked time [s], little endian
+    uint32_t blocked_s = MIN( delta[MODEM_PERF_DTC_BLOCKED_MS] / 1000, UINT16_MAX );
+    value[0]           = blocked_s & 0xFF;
+    value[1]           = blocked_s >> 8;
+
+    // Ratios in percent, 0xFF when there was nothing to measure
+    value[2] = ( delta[MODEM_PERF_LBT_NB] == 0 )
+                   ? 0xFF
+                   : ( uint8_t ) ( ( ( uint64_t ) delta[MODEM_PERF_LBT_BUSY_NB] * 100 ) / delta[MODEM_PERF_LBT_NB] );
+    value[4] = ( delta[MODEM_PERF_UPLINK_NB] == 0 )
+                   ? 0xFF
+                   : ( uint8_t ) MIN( ( ( uint64_t ) delta[MODEM_PERF_RX_WINDOW_HIT_NB] * 100 ) /
+                                          delta[MODEM_PERF_UPLINK_NB],
+                                      100 );
+
+    // Event counts, saturated
+    value[3] = MIN( delta[MODEM_PERF_RETRANSMISSION_NB], UINT8_MAX );
+    value[5] = MIN( delta[MODEM_PERF_RP_ABORTED_NB], UINT8_MAX );
+    value[6] = MIN( delta[MODEM_PERF_FLASH_ERASE_NB], UINT8_MAX );
+
+    // Uplink latency p50 and p99, as log2 bucket index of smtc_modem_dbg_latency.h, 0xFF when unknown
+    value[7] = 0xFF;
+    value[8] = 0xFF;
+#if defined( ADD_SMTC_LATENCY_HISTOGRAM )
+    uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS];
+
+    smtc_modem_dbg_latency_get_histogram( SMTC_LATENCY_UPLINK, ctx->dm_perf_latency_read );
+    for( uint8_t i = 0; i < SMTC_MODEM_DBG_LATENCY_NB_BUCKETS; i++ )
+    {
+        // A bucket below its last reported count has been cleared by the application in between
+        buckets[i] = ( ctx->dm_perf_latency_read[i] >= ctx->dm_perf_latency_last[i] )
+                         ? ctx->dm_perf_latency_read[i] - ctx->dm_perf_latency_last[i]
+                         : ctx->dm_perf_latency_read[i];
+    }
+    uint8_t p50 = smtc_modem_dbg_latency_get_bucket_percentile( buckets, 50 );
+    uint8_t p99 = smtc_modem_dbg_latency_get_bucket_percentile( buckets, 99 );
+    if( p50 < SMTC_MODEM_DBG_LATENCY_NB_BUCKETS )
+    {
+        value[7] = p50;
+        value[8] = p99;
+    }
+#endif  // ADD_SMTC_LATENCY_HISTOGRAM
+}
+
+static void dm_perf_commit( cloud_dm_t* ctx )
+{
+    memcpy( ctx->dm_perf_last, ctx->dm_perf_read, sizeof( ctx->dm_perf_last ) );
+#if defined( ADD_SMTC_LATENCY_HISTOGRAM )
+    memcpy( ctx->dm_perf_latency_last, ctx->dm_perf_latency_read, sizeof( ctx->dm_perf_latency_last ) );
+#endif  // ADD_SMTC_LATENCY_HISTOGRAM
+}
+#endif  // ADD_SMTC_DM_PERF
+
 /* --- EOF ------------------------------------------------------------------ */
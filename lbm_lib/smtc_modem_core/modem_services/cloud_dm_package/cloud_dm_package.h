@@ -189,6 +189,32 @@ void cloud_dm_set_modem_user_app_status( uint8_t stack_id, const uint8_t* app_st
  */
 void cloud_dm_get_modem_user_app_status( uint8_t stack_id, uint8_t* app_status );
 
+#if defined( ADD_SMTC_DM_DELTA )
+/*!
+ * @brief   Set the change needed to report a numeric DM field in the periodic DM status messages
+ * @remark  The field is reported once its value moved by more than threshold since it was last reported.
+ *          Only DM_INFO_CHARGE, DM_INFO_VOLTAGE, DM_INFO_TEMP, DM_INFO_SIGNAL (RSSI), DM_INFO_UPTIME and
+ *          DM_INFO_RXTIME have a threshold, the other fields are reported on any change.
+ *
+ * @param   [in]  stack_id              - Stack identifier
+ * @param   [in]  field                 - Numeric DM field
+ * @param   [in]  threshold             - Threshold in the unit of the reported field
+ * @retval dm_rc_t                      - Return DM_ERROR if the field has no threshold, else DM_OK
+ */
+dm_rc_t cloud_dm_set_info_threshold( uint8_t stack_id, dm_info_field_t field, uint16_t threshold );
+
+/*!
+ * @brief   Set the number of DM intervals between two complete periodic DM status messages
+ * @remark  In between, the periodic DM status messages only contain the fields that changed and are skipped
+ *          when none did.
+ *
+ * @param   [in]  stack_id              - Stack identifier
+ * @param   [in]  nb_of_intervals       - Number of intervals, 1 reports all the fields at every interval
+ * @retval dm_rc_t                      - Return DM_ERROR if nb_of_intervals is 0, else DM_OK
+ */
+dm_rc_t cloud_dm_set_keepalive( uint8_t stack_id, uint8_t nb_of_intervals );
+#endif  // ADD_SMTC_DM_DELTA
+
 #ifdef __cplusplus
 }
 #endif
@@ -161,6 +161,8 @@ typedef enum dm_info_field_e
     DM_INFO_DBGRSP    = 0x19,  //!< almanac dbg response
     DM_INFO_GNSSLOC   = 0x1A,  //!< GNSS scan NAV message
     DM_INFO_WIFILOC   = 0x1B,  //!< Wifi scan results message
+    DM_INFO_PERF      = 0x1C,  //!< performance counters since the last report (LBM_DM_PERF)
+    DM_INFO_BATTERY   = 0x1D,  //!< average current and remaining battery life (LBM_BATTERY_ESTIMATOR)
     DM_INFO_MAX                //!< number of elements
 } dm_info_field_t;
 
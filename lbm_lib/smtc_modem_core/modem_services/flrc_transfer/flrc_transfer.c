@@ -0,0 +1,959 @@
+/**
+ * @file      flrc_transfer.c
+ *
+ * @brief     Device to device bulk transfer over FLRC (SX128x only)
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memcpy
+#include "flrc_transfer.h"
+#include "modem_core.h"
+#include "modem_supervisor_light.h"
+#include "radio_planner.h"
+#include "ral.h"
+#include "ralf.h"
+#include "smtc_modem_hal.h"
+#include "smtc_modem_hal_dbg_trace.h"
+
+#if !defined( SX128X )
+#error "The FLRC transfer service needs a SX128x radio"
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define CURRENT_STACK ( task_id / NUMBER_OF_TASKS )
+#define NUMBER_MAX_OF_FLRC_TRANSFER_OBJ 1  // modify in case of multiple obj
+
+/**
+ * @brief Frame types
+ */
+#define FLRC_TRANSFER_FRAME_START ( 0x01 )
+#define FLRC_TRANSFER_FRAME_DATA ( 0x02 )
+#define FLRC_TRANSFER_FRAME_DATA_ACK_REQ ( 0x03 )
+#define FLRC_TRANSFER_FRAME_ACK ( 0x04 )
+#define FLRC_TRANSFER_FRAME_ABORT ( 0x05 )
+
+/**
+ * @brief START frame data size: transfer size, chunk size and window
+ */
+#define FLRC_TRANSFER_START_DATA_SIZE ( 6 )
+
+/**
+ * @brief FLRC payload limits of the SX128x
+ */
+#define FLRC_TRANSFER_FRAME_SIZE_MIN ( 6 )
+#define FLRC_TRANSFER_FRAME_SIZE_MAX ( 127 )
+
+#if( ( FLRC_TRANSFER_FRAME_HEADER_SIZE + FLRC_TRANSFER_CHUNK_SIZE ) > FLRC_TRANSFER_FRAME_SIZE_MAX )
+#error "FLRC_TRANSFER_CHUNK_SIZE does not fit in a FLRC frame"
+#endif
+
+/**
+ * @brief Largest transfer, the sequence number being on 16 bits
+ */
+#define FLRC_TRANSFER_SIZE_MAX ( ( uint32_t ) 0xFFFF * FLRC_TRANSFER_CHUNK_SIZE )
+
+/**
+ * @brief Radio settings shared by both devices
+ */
+#define FLRC_TRANSFER_PREAMBLE_LEN_IN_BITS ( 32 )
+#define FLRC_TRANSFER_CRC_SEED ( 0x00000000 )
+
+/**
+ * @brief Check is the index is valid before accessing FLRC transfer object
+ *
+ */
+#define IS_VALID_OBJECT_ID( x )                                                 \
+    do                                                                          \
+    {                                                                           \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_MAX_OF_FLRC_TRANSFER_OBJ ); \
+    } while( 0 )
+
+/**
+ * @brief Check is the service is initialized before accessing the object
+ *
+ */
+#define IS_SERVICE_INITIALIZED( x )                                                        \
+    do                                                                                     \
+    {                                                                                      \
+        if( flrc_transfer_obj[x].initialized == false )                                    \
+        {                                                                                  \
+            SMTC_MODEM_HAL_TRACE_WARNING( "flrc_transfer_obj service not initialized\n" ); \
+            return;                                                                        \
+        }                                                                                  \
+    } while( 0 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief Role of the device in the ongoing transfer
+ */
+typedef enum flrc_transfer_role_e
+{
+    FLRC_TRANSFER_ROLE_NONE,
+    FLRC_TRANSFER_ROLE_SENDER,
+    FLRC_TRANSFER_ROLE_RECEIVER,
+} flrc_transfer_role_t;
+
+/**
+ * @brief FLRC transfer Object
+ *
+ * @struct flrc_transfer_s
+ */
+typedef struct flrc_transfer_s
+{
+    uint8_t stack_id;
+    uint8_t task_id;
+    bool    initialized;
+
+    flrc_transfer_role_t      role;
+    flrc_transfer_config_t    config;
+    flrc_transfer_callbacks_t callbacks;
+    uint8_t                   sync_word[4];
+
+    uint8_t  session;     // 0 while the receiver waits for a START frame
+    uint32_t size;        // Transfer size in byte
+    uint8_t  chunk_size;  // Data bytes per DATA frame
+    uint16_t nb_chunks;
+
+    // Sender: first chunk not acknowledged, chunk of the frame being sent, windows sent again without progress
+    uint16_t seq_base;
+    uint16_t seq_next;
+    uint8_t  retries;
+    bool     started;   // The START frame is acknowledged
+    bool     wait_ack;  // The frame being sent asks for an ACK
+
+    // Receiver: next chunk expected, the done callback is called once the last ACK is sent
+    uint16_t seq_expected;
+    bool     complete;
+    bool     done_reported;
+    uint32_t listen_deadline_ms;
+
+    uint8_t tx_frame[FLRC_TRANSFER_FRAME_SIZE_MAX];
+    uint8_t rx_frame[FLRC_TRANSFER_FRAME_SIZE_MAX];
+} flrc_transfer_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static flrc_transfer_t flrc_transfer_obj[NUMBER_MAX_OF_FLRC_TRANSFER_OBJ];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Callback called at task launch
+ *
+ * @param context_callback
+ */
+static void flrc_transfer_service_on_launch( void* context );
+
+/**
+ * @brief Callback called at task completion
+ *
+ * @param context_callback
+ */
+static void flrc_transfer_service_on_update( void* context );
+
+/**
+ * @brief Radio planner launch callbacks of the FLRC tasks
+ *
+ * @param [in] rp_void Radio planner
+ */
+static void flrc_transfer_tx_launch_callback_for_rp( void* rp_void );
+static void flrc_transfer_rx_launch_callback_for_rp( void* rp_void );
+
+/**
+ * @brief Radio planner callback, called at the end of each FLRC task
+ *
+ * @param [in] context FLRC transfer object context
+ */
+static void flrc_transfer_rp_callback( void* context );
+
+/**
+ * @brief Validate the configuration and prepare the object for a new transfer
+ *
+ * @param [in] ctx       FLRC transfer object context
+ * @param [in] config    Radio configuration
+ * @param [in] callbacks Data accesses
+ * @return flrc_transfer_rc_t
+ */
+static flrc_transfer_rc_t flrc_transfer_prepare( flrc_transfer_t* ctx, const flrc_transfer_config_t* config,
+                                                 const flrc_transfer_callbacks_t* callbacks );
+
+/**
+ * @brief Fill the FLRC radio parameters from the configuration
+ *
+ * @param [in]  ctx         FLRC transfer object context
+ * @param [in]  pld_len     Payload length, the maximum length for a reception
+ * @param [out] flrc_params Radio parameters
+ */
+static void flrc_transfer_get_radio_params( flrc_transfer_t* ctx, uint8_t pld_len, ralf_params_flrc_t* flrc_params );
+
+/**
+ * @brief Enqueue the transmission of the frame built in tx_frame
+ *
+ * @param [in] ctx      FLRC transfer object context
+ * @param [in] len      Frame length
+ * @param [in] delay_ms Delay before the transmission, 0 for as soon as possible
+ */
+static void flrc_transfer_enqueue_tx( flrc_transfer_t* ctx, uint8_t len, uint32_t delay_ms );
+
+/**
+ * @brief Enqueue a reception in rx_frame
+ *
+ * @param [in] ctx        FLRC transfer object context
+ * @param [in] timeout_ms Reception timeout
+ */
+static void flrc_transfer_enqueue_rx( flrc_transfer_t* ctx, uint32_t timeout_ms );
+
+/**
+ * @brief Write the frame header in tx_frame
+ *
+ * @param [in] ctx  FLRC transfer object context
+ * @param [in] type Frame type
+ * @param [in] seq  Sequence number
+ */
+static void flrc_transfer_set_header( flrc_transfer_t* ctx, uint8_t type, uint16_t seq );
+
+/**
+ * @brief Sender: transmit the START frame or the next DATA frame of the window
+ *
+ * @param [in] ctx FLRC transfer object context
+ */
+static void flrc_transfer_send_next( flrc_transfer_t* ctx );
+
+/**
+ * @brief Sender: send the window again from the first chunk not acknowledged
+ *
+ * @param [in] ctx FLRC transfer object context
+ */
+static void flrc_transfer_send_retry( flrc_transfer_t* ctx );
+
+/**
+ * @brief Sender and receiver state machines, called with the status of the last radio task
+ *
+ * @param [in] ctx    FLRC transfer object context
+ * @param [in] status Radio planner status
+ */
+static void flrc_transfer_sender_update( flrc_transfer_t* ctx, rp_status_t status );
+static void flrc_transfer_receiver_update( flrc_transfer_t* ctx, rp_status_t status );
+
+/**
+ * @brief Receiver: handle a received frame
+ *
+ * @param [in] ctx FLRC transfer object context
+ * @param [in] len Frame length
+ */
+static void flrc_transfer_receiver_handle_frame( flrc_transfer_t* ctx, uint8_t len );
+
+/**
+ * @brief Receiver: send an ACK of the next expected chunk
+ *
+ * @param [in] ctx FLRC transfer object context
+ */
+static void flrc_transfer_send_ack( flrc_transfer_t* ctx );
+
+/**
+ * @brief End the transfer and report it to the application
+ *
+ * @param [in] ctx    FLRC transfer object context
+ * @param [in] status Transfer status
+ */
+static void flrc_transfer_finish( flrc_transfer_t* ctx, flrc_transfer_status_t status );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void flrc_transfer_services_init( uint8_t* service_id, uint8_t task_id,
+                                  uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                                  void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                                  void** context_callback )
+{
+    IS_VALID_OBJECT_ID( *service_id );
+
+    flrc_transfer_t* ctx = &flrc_transfer_obj[*service_id];
+    memset( ctx, 0, sizeof( flrc_transfer_t ) );
+
+    *downlink_callback  = NULL;
+    *on_launch_callback = flrc_transfer_service_on_launch;
+    *on_update_callback = flrc_transfer_service_on_update;
+    *context_callback   = ( void* ) service_id;
+
+    ctx->task_id     = task_id;
+    ctx->stack_id    = CURRENT_STACK;
+    ctx->role        = FLRC_TRANSFER_ROLE_NONE;
+    ctx->initialized = true;
+
+    rp_hook_init( modem_get_rp( ), RP_HOOK_ID_FLRC_TRANSFER, flrc_transfer_rp_callback, ( void* ) ctx );
+}
+
+flrc_transfer_rc_t flrc_transfer_send( const flrc_transfer_config_t* config, uint32_t size,
+                                       const flrc_transfer_callbacks_t* callbacks )
+{
+    flrc_transfer_t* ctx = &flrc_transfer_obj[0];
+
+    if( ( size == 0 ) || ( size > FLRC_TRANSFER_SIZE_MAX ) || ( callbacks == NULL ) || ( callbacks->read == NULL ) ||
+        ( config == NULL ) || ( config->window == 0 ) || ( config->window > FLRC_TRANSFER_WINDOW_MAX ) )
+    {
+        return FLRC_TRANSFER_RC_INVALID;
+    }
+
+    flrc_transfer_rc_t rc = flrc_transfer_prepare( ctx, config, callbacks );
+    if( rc != FLRC_TRANSFER_RC_OK )
+    {
+        return rc;
+    }
+
+    ctx->role       = FLRC_TRANSFER_ROLE_SENDER;
+    ctx->session    = ( uint8_t ) smtc_modem_hal_get_random_nb_in_range( 1, 0xFF );
+    ctx->size       = size;
+    ctx->chunk_size = FLRC_TRANSFER_CHUNK_SIZE;
+    ctx->nb_chunks  = ( uint16_t ) ( ( size + FLRC_TRANSFER_CHUNK_SIZE - 1 ) / FLRC_TRANSFER_CHUNK_SIZE );
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "FLRC transfer send %u bytes, session %u\n", size, ctx->session );
+    flrc_transfer_send_next( ctx );
+    return FLRC_TRANSFER_RC_OK;
+}
+
+flrc_transfer_rc_t flrc_transfer_receive( const flrc_transfer_config_t* config, uint32_t listen_timeout_ms,
+                                          const flrc_transfer_callbacks_t* callbacks )
+{
+    flrc_transfer_t* ctx = &flrc_transfer_obj[0];
+
+    if( ( listen_timeout_ms == 0 ) || ( callbacks == NULL ) || ( callbacks->write == NULL ) || ( config == NULL ) )
+    {
+        return FLRC_TRANSFER_RC_INVALID;
+    }
+
+    flrc_transfer_rc_t rc = flrc_transfer_prepare( ctx, config, callbacks );
+    if( rc != FLRC_TRANSFER_RC_OK )
+    {
+        return rc;
+    }
+
+    ctx->role               = FLRC_TRANSFER_ROLE_RECEIVER;
+    ctx->listen_deadline_ms = smtc_modem_hal_get_time_in_ms( ) + listen_timeout_ms;
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "FLRC transfer listen for %u ms\n", listen_timeout_ms );
+    flrc_transfer_enqueue_rx( ctx, listen_timeout_ms );
+    return FLRC_TRANSFER_RC_OK;
+}
+
+flrc_transfer_rc_t flrc_transfer_abort( void )
+{
+    flrc_transfer_t* ctx = &flrc_transfer_obj[0];
+
+    if( ctx->role == FLRC_TRANSFER_ROLE_NONE )
+    {
+        return FLRC_TRANSFER_RC_FAIL;
+    }
+
+    flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_ABORTED );
+    return FLRC_TRANSFER_RC_OK;
+}
+
+bool flrc_transfer_is_busy( void )
+{
+    return flrc_transfer_obj[0].role != FLRC_TRANSFER_ROLE_NONE;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void flrc_transfer_service_on_launch( void* service_id )
+{
+    uint8_t idx = *( ( uint8_t* ) service_id );
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s service_id %d \n", __func__, idx );
+
+    IS_SERVICE_INITIALIZED( idx );
+}
+
+static void flrc_transfer_service_on_update( void* service_id )
+{
+    uint8_t idx = *( ( uint8_t* ) service_id );
+    SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s service_id %d \n", __func__, idx );
+
+    IS_SERVICE_INITIALIZED( idx );
+}
+
+static void flrc_transfer_tx_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t* rp = ( radio_planner_t* ) rp_void;
+    uint8_t          id = rp->radio_task_id;
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_flrc( rp->radio, &rp->radio_params[id].tx.flrc ) == RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_TX_DONE ) == RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        ral_set_pkt_payload( &( rp->radio->ral ), rp->payload[id], rp->payload_buffer_size[id] ) == RAL_STATUS_OK );
+#if defined( ADD_RP_TIMED_TX )
+    // The radio is ready, the Tx command is sent by the radio trigger timer at the exact expected time
+    rp_task_start_tx_at_start_time( rp, id );
+#else
+    // Wait the exact expected time (ie target - tcxo startup delay)
+    rp_task_wait_start_time( rp, id );
+    // At this time only tcxo startup delay is remaining
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( true );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_tx( &( rp->radio->ral ) ) == RAL_STATUS_OK );
+    rp_stats_set_tx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+#endif
+}
+
+static void flrc_transfer_rx_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t* rp = ( radio_planner_t* ) rp_void;
+    uint8_t          id = rp->radio_task_id;
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ralf_setup_flrc( rp->radio, &rp->radio_params[id].rx.flrc ) == RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_CRC_ERROR ) ==
+        RAL_STATUS_OK );
+    // Wait the exact expected time (ie target - tcxo startup delay)
+    rp_task_wait_start_time( rp, id );
+    // At this time only tcxo startup delay is remaining
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( false );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rx( &( rp->radio->ral ), rp->radio_params[id].rx.timeout_in_ms ) ==
+                                     RAL_STATUS_OK );
+    rp_stats_set_rx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+}
+
+static void flrc_transfer_rp_callback( void* context )
+{
+    flrc_transfer_t* ctx = ( flrc_transfer_t* ) context;
+    uint32_t         irq_timestamp_ms;
+    rp_status_t      status;
+
+    rp_get_status( modem_get_rp( ), RP_HOOK_ID_FLRC_TRANSFER, &irq_timestamp_ms, &status );
+
+    if( ctx->role == FLRC_TRANSFER_ROLE_SENDER )
+    {
+        flrc_transfer_sender_update( ctx, status );
+    }
+    else if( ctx->role == FLRC_TRANSFER_ROLE_RECEIVER )
+    {
+        flrc_transfer_receiver_update( ctx, status );
+    }
+}
+
+static flrc_transfer_rc_t flrc_transfer_prepare( flrc_transfer_t* ctx, const flrc_transfer_config_t* config,
+                                                 const flrc_transfer_callbacks_t* callbacks )
+{
+    if( ( config->br_in_bps == 0 ) || ( config->br_in_bps > 1300000 ) )
+    {
+        return FLRC_TRANSFER_RC_INVALID;
+    }
+
+    if( ctx->initialized == false )
+    {
+        return FLRC_TRANSFER_RC_FAIL;
+    }
+
+    if( ( ctx->role != FLRC_TRANSFER_ROLE_NONE ) || ( modem_get_test_mode_status( ) == true ) )
+    {
+        return FLRC_TRANSFER_RC_BUSY;
+    }
+
+    ctx->config    = *config;
+    ctx->callbacks = *callbacks;
+
+    ctx->sync_word[0] = ( uint8_t ) ( config->link_id >> 24 );
+    ctx->sync_word[1] = ( uint8_t ) ( config->link_id >> 16 );
+    ctx->sync_word[2] = ( uint8_t ) ( config->link_id >> 8 );
+    ctx->sync_word[3] = ( uint8_t ) ( config->link_id );
+
+    ctx->session       = 0;
+    ctx->size          = 0;
+    ctx->chunk_size    = 0;
+    ctx->nb_chunks     = 0;
+    ctx->seq_base      = 0;
+    ctx->seq_next      = 0;
+    ctx->retries       = 0;
+    ctx->started       = false;
+    ctx->wait_ack      = false;
+    ctx->seq_expected  = 0;
+    ctx->complete      = false;
+    ctx->done_reported = false;
+
+    return FLRC_TRANSFER_RC_OK;
+}
+
+static void flrc_transfer_get_radio_params( flrc_transfer_t* ctx, uint8_t pld_len, ralf_params_flrc_t* flrc_params )
+{
+    memset( flrc_params, 0, sizeof( ralf_params_flrc_t ) );
+
+    // The driver picks the bit rate and bandwidth pair from the upper bounds
+    flrc_params->mod_params.br_in_bps    = ctx->config.br_in_bps;
+    flrc_params->mod_params.bw_dsb_in_hz = ( ctx->config.br_in_bps <= 325000 )   ? 300000
+                                           : ( ctx->config.br_in_bps <= 650000 ) ? 600000
+                                                                                 : 1200000;
+    flrc_params->mod_params.cr           = RAL_FLRC_CR_3_4;
+    flrc_params->mod_params.pulse_shape  = RAL_FLRC_PULSE_SHAPE_BT_05;
+
+    flrc_params->pkt_params.preamble_len_in_bits = FLRC_TRANSFER_PREAMBLE_LEN_IN_BITS;
+    flrc_params->pkt_params.sync_word_is_on      = true;
+    flrc_params->pkt_params.pld_is_fix           = false;
+    flrc_params->pkt_params.pld_len_in_bytes     = pld_len;
+    flrc_params->pkt_params.crc_type             = RAL_FLRC_CRC_2_BYTES;
+
+    flrc_params->sync_word         = ctx->sync_word;
+    flrc_params->rf_freq_in_hz     = ctx->config.rf_freq_in_hz;
+    flrc_params->crc_seed          = FLRC_TRANSFER_CRC_SEED;
+    flrc_params->output_pwr_in_dbm = ctx->config.output_pwr_in_dbm;
+}
+
+static void flrc_transfer_enqueue_tx( flrc_transfer_t* ctx, uint8_t len, uint32_t delay_ms )
+{
+    rp_radio_params_t radio_params = { 0 };
+    rp_task_t         rp_task      = { 0 };
+
+    if( len < FLRC_TRANSFER_FRAME_SIZE_MIN )
+    {
+        memset( &ctx->tx_frame[len], 0, FLRC_TRANSFER_FRAME_SIZE_MIN - len );
+        len = FLRC_TRANSFER_FRAME_SIZE_MIN;
+    }
+
+    radio_params.pkt_type = RAL_PKT_TYPE_FLRC;
+    flrc_transfer_get_radio_params( ctx, len, &radio_params.tx.flrc );
+
+    rp_task.hook_id               = RP_HOOK_ID_FLRC_TRANSFER;
+    rp_task.type                  = RP_TASK_TYPE_TX_FLRC;
+    rp_task.launch_task_callbacks = flrc_transfer_tx_launch_callback_for_rp;
+    rp_task.duration_time_ms =
+        ral_get_flrc_time_on_air_in_ms( &( modem_get_rp( )->radio->ral ), &radio_params.tx.flrc.pkt_params,
+                                        &radio_params.tx.flrc.mod_params ) +
+        1;
+    rp_task.state         = ( delay_ms == 0 ) ? RP_TASK_STATE_ASAP : RP_TASK_STATE_SCHEDULE;
+    rp_task.start_time_ms = smtc_modem_hal_get_time_in_ms( ) + delay_ms;
+
+    if( rp_task_enqueue( modem_get_rp( ), &rp_task, ctx->tx_frame, len, &radio_params ) != RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "FLRC transfer tx enqueue failed\n" );
+        flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_ABORTED );
+    }
+}
+
+static void flrc_transfer_enqueue_rx( flrc_transfer_t* ctx, uint32_t timeout_ms )
+{
+    rp_radio_params_t radio_params = { 0 };
+    rp_task_t         rp_task      = { 0 };
+
+    radio_params.pkt_type         = RAL_PKT_TYPE_FLRC;
+    radio_params.rx.timeout_in_ms = timeout_ms;
+    flrc_transfer_get_radio_params( ctx, FLRC_TRANSFER_FRAME_SIZE_MAX, &radio_params.rx.flrc );
+
+    rp_task.hook_id               = RP_HOOK_ID_FLRC_TRANSFER;
+    rp_task.type                  = RP_TASK_TYPE_RX_FLRC;
+    rp_task.launch_task_callbacks = flrc_transfer_rx_launch_callback_for_rp;
+    rp_task.duration_time_ms      = timeout_ms;
+    rp_task.state                 = RP_TASK_STATE_ASAP;
+    rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( );
+
+    if( rp_task_enqueue( modem_get_rp( ), &rp_task, ctx->rx_frame, FLRC_TRANSFER_FRAME_SIZE_MAX, &radio_params ) !=
+        RP_HOOK_STATUS_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "FLRC transfer rx enqueue failed\n" );
+        flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_ABORTED );
+    }
+}
+
+static void flrc_transfer_set_header( flrc_transfer_t* ctx, uint8_t type, uint16_t seq )
+{
+    ctx->tx_frame[0] = type;
+    ctx->tx_frame[1] = ctx->session;
+    ctx->tx_frame[2] = ( uint8_t ) ( seq );
+    ctx->tx_frame[3] = ( uint8_t ) ( seq >> 8 );
+}
+
+static void flrc_transfer_send_next( flrc_transfer_t* ctx )
+{
+    if( ctx->started == false )
+    {
+        uint8_t* p = &ctx->tx_frame[FLRC_TRANSFER_FRAME_HEADER_SIZE];
+
+        flrc_transfer_set_header( ctx, FLRC_TRANSFER_FRAME_START, 0 );
+        p[0] = ( uint8_t ) ( ctx->size );
+        p[1] = ( uint8_t ) ( ctx->size >> 8 );
+        p[2] = ( uint8_t ) ( ctx->size >> 16 );
+        p[3] = ( uint8_t ) ( ctx->size >> 24 );
+        p[4] = ctx->chunk_size;
+        p[5] = ctx->config.window;
+
+        ctx->wait_ack = true;
+        flrc_transfer_enqueue_tx( ctx, FLRC_TRANSFER_FRAME_HEADER_SIZE + FLRC_TRANSFER_START_DATA_SIZE, 0 );
+        return;
+    }
+
+    uint32_t offset    = ( uint32_t ) ctx->seq_next * ctx->chunk_size;
+    uint8_t  chunk_len = ( ( ctx->size - offset ) < ctx->chunk_size ) ? ( uint8_t ) ( ctx->size - offset )
+                                                                      : ctx->chunk_size;
+
+    ctx->wait_ack = ( ( ctx->seq_next + 1 ) == ctx->nb_chunks ) ||
+                    ( ( ctx->seq_next + 1 ) == ( ctx->seq_base + ctx->config.window ) );
+
+    if( ctx->callbacks.read( ctx->callbacks.context, offset, &ctx->tx_frame[FLRC_TRANSFER_FRAME_HEADER_SIZE],
+                             chunk_len ) != 0 )
+    {
+        flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_IO_ERROR );
+        return;
+    }
+
+    flrc_transfer_set_header(
+        ctx, ( ctx->wait_ack == true ) ? FLRC_TRANSFER_FRAME_DATA_ACK_REQ : FLRC_TRANSFER_FRAME_DATA, ctx->seq_next );
+    flrc_transfer_enqueue_tx( ctx, FLRC_TRANSFER_FRAME_HEADER_SIZE + chunk_len, 0 );
+}
+
+static void flrc_transfer_send_retry( flrc_transfer_t* ctx )
+{
+    ctx->retries++;
+    if( ctx->retries > FLRC_TRANSFER_MAX_RETRIES )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "FLRC transfer no answer from the receiver\n" );
+        flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_TIMEOUT );
+        return;
+    }
+    ctx->seq_next = ctx->seq_base;
+    flrc_transfer_send_next( ctx );
+}
+
+static void flrc_transfer_sender_update( flrc_transfer_t* ctx, rp_status_t status )
+{
+    radio_planner_t* rp = modem_get_rp( );
+
+    switch( status )
+    {
+    case RP_STATUS_TX_DONE:
+        if( ctx->wait_ack == true )
+        {
+            flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_ACK_TIMEOUT_MS );
+        }
+        else
+        {
+            ctx->seq_next++;
+            flrc_transfer_send_next( ctx );
+        }
+        break;
+
+    case RP_STATUS_RX_PACKET:
+    {
+        uint8_t  len  = rp->rx_payload_size[RP_HOOK_ID_FLRC_TRANSFER];
+        uint8_t  type = ctx->rx_frame[0];
+        uint16_t seq  = ( uint16_t ) ctx->rx_frame[2] | ( ( uint16_t ) ctx->rx_frame[3] << 8 );
+
+        if( ( len < FLRC_TRANSFER_FRAME_HEADER_SIZE ) || ( ctx->rx_frame[1] != ctx->session ) )
+        {
+            flrc_transfer_send_retry( ctx );
+        }
+        else if( type == FLRC_TRANSFER_FRAME_ABORT )
+        {
+            flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_ABORTED );
+        }
+        else if( ( type != FLRC_TRANSFER_FRAME_ACK ) || ( seq > ctx->nb_chunks ) )
+        {
+            flrc_transfer_send_retry( ctx );
+        }
+        else if( ctx->started == false )
+        {
+            // START acknowledged, the DATA frames can flow
+            ctx->started  = true;
+            ctx->retries  = 0;
+            ctx->seq_base = 0;
+            ctx->seq_next = 0;
+            flrc_transfer_send_next( ctx );
+        }
+        else if( seq == ctx->nb_chunks )
+        {
+            ctx->seq_base = seq;
+            flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_DONE );
+        }
+        else if( seq > ctx->seq_base )
+        {
+            ctx->seq_base = seq;
+            ctx->seq_next = seq;
+            ctx->retries  = 0;
+            flrc_transfer_send_next( ctx );
+        }
+        else
+        {
+            flrc_transfer_send_retry( ctx );
+        }
+        break;
+    }
+
+    case RP_STATUS_TASK_ABORTED:
+        // Preempted by a higher priority task, send the frame again
+        if( ctx->wait_ack == true )
+        {
+            flrc_transfer_send_retry( ctx );
+        }
+        else
+        {
+            flrc_transfer_send_next( ctx );
+        }
+        break;
+
+    default:
+        // No ACK or corrupted ACK
+        flrc_transfer_send_retry( ctx );
+        break;
+    }
+}
+
+static void flrc_transfer_receiver_update( flrc_transfer_t* ctx, rp_status_t status )
+{
+    radio_planner_t* rp = modem_get_rp( );
+
+    switch( status )
+    {
+    case RP_STATUS_RX_PACKET:
+        flrc_transfer_receiver_handle_frame( ctx, rp->rx_payload_size[RP_HOOK_ID_FLRC_TRANSFER] );
+        break;
+
+    case RP_STATUS_TX_DONE:
+        if( ( ctx->complete == true ) && ( ctx->done_reported == false ) )
+        {
+            // Keep answering until the sender stops, in case the last ACK is lost
+            ctx->done_reported = true;
+            if( ctx->callbacks.done != NULL )
+            {
+                ctx->callbacks.done( ctx->callbacks.context, FLRC_TRANSFER_STATUS_DONE, ctx->size );
+            }
+        }
+        flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+        break;
+
+    case RP_STATUS_RX_TIMEOUT:
+        if( ctx->done_reported == true )
+        {
+            ctx->role = FLRC_TRANSFER_ROLE_NONE;
+        }
+        else if( ctx->session == 0 )
+        {
+            int32_t remaining_ms = ( int32_t ) ( ctx->listen_deadline_ms - smtc_modem_hal_get_time_in_ms( ) );
+            if( remaining_ms > 0 )
+            {
+                flrc_transfer_enqueue_rx( ctx, ( uint32_t ) remaining_ms );
+            }
+            else
+            {
+                flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_TIMEOUT );
+            }
+        }
+        else
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "FLRC transfer no frame from the sender\n" );
+            flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_TIMEOUT );
+        }
+        break;
+
+    default:
+        // Corrupted frame or task preempted, listen again
+        flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+        break;
+    }
+}
+
+static void flrc_transfer_receiver_handle_frame( flrc_transfer_t* ctx, uint8_t len )
+{
+    uint8_t  type = ctx->rx_frame[0];
+    uint16_t seq  = ( uint16_t ) ctx->rx_frame[2] | ( ( uint16_t ) ctx->rx_frame[3] << 8 );
+    uint8_t* p    = &ctx->rx_frame[FLRC_TRANSFER_FRAME_HEADER_SIZE];
+
+    if( len < FLRC_TRANSFER_FRAME_HEADER_SIZE )
+    {
+        flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+        return;
+    }
+
+    if( ( type == FLRC_TRANSFER_FRAME_START ) && ( ctx->session == 0 ) &&
+        ( len >= ( FLRC_TRANSFER_FRAME_HEADER_SIZE + FLRC_TRANSFER_START_DATA_SIZE ) ) && ( ctx->rx_frame[1] != 0 ) )
+    {
+        uint32_t size = ( uint32_t ) p[0] | ( ( uint32_t ) p[1] << 8 ) | ( ( uint32_t ) p[2] << 16 ) |
+                        ( ( uint32_t ) p[3] << 24 );
+        uint8_t chunk_size = p[4];
+
+        if( ( size == 0 ) || ( chunk_size == 0 ) ||
+            ( chunk_size > ( FLRC_TRANSFER_FRAME_SIZE_MAX - FLRC_TRANSFER_FRAME_HEADER_SIZE ) ) ||
+            ( ( ( size + chunk_size - 1 ) / chunk_size ) > 0xFFFF ) )
+        {
+            flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+            return;
+        }
+
+        ctx->session      = ctx->rx_frame[1];
+        ctx->size         = size;
+        ctx->chunk_size   = chunk_size;
+        ctx->nb_chunks    = ( uint16_t ) ( ( size + chunk_size - 1 ) / chunk_size );
+        ctx->seq_expected = 0;
+        SMTC_MODEM_HAL_TRACE_PRINTF( "FLRC transfer receive %u bytes, session %u\n", size, ctx->session );
+        flrc_transfer_send_ack( ctx );
+        return;
+    }
+
+    // Frames of another session are ignored
+    if( ( ctx->session == 0 ) || ( ctx->rx_frame[1] != ctx->session ) )
+    {
+        flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+        return;
+    }
+
+    switch( type )
+    {
+    case FLRC_TRANSFER_FRAME_START:
+        // Our ACK of the START frame was lost
+        flrc_transfer_send_ack( ctx );
+        break;
+
+    case FLRC_TRANSFER_FRAME_DATA:
+    case FLRC_TRANSFER_FRAME_DATA_ACK_REQ:
+        // Go-Back-N: only the expected chunk is kept, the sender goes back to it after the ACK
+        if( ( seq == ctx->seq_expected ) && ( ctx->complete == false ) )
+        {
+            uint32_t offset    = ( uint32_t ) seq * ctx->chunk_size;
+            uint8_t  chunk_len = ( ( ctx->size - offset ) < ctx->chunk_size ) ? ( uint8_t ) ( ctx->size - offset )
+                                                                              : ctx->chunk_size;
+
+            // Short last chunks are padded to the FLRC minimum payload
+            if( ( len - FLRC_TRANSFER_FRAME_HEADER_SIZE ) >= chunk_len )
+            {
+                if( ctx->callbacks.write( ctx->callbacks.context, offset, p, chunk_len ) != 0 )
+                {
+                    flrc_transfer_set_header( ctx, FLRC_TRANSFER_FRAME_ABORT, seq );
+                    flrc_transfer_enqueue_tx( ctx, FLRC_TRANSFER_FRAME_HEADER_SIZE, FLRC_TRANSFER_TURNAROUND_MS );
+                    flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_IO_ERROR );
+                    return;
+                }
+                ctx->seq_expected++;
+                ctx->complete = ( ctx->seq_expected == ctx->nb_chunks );
+            }
+        }
+
+        if( type == FLRC_TRANSFER_FRAME_DATA_ACK_REQ )
+        {
+            flrc_transfer_send_ack( ctx );
+        }
+        else
+        {
+            flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+        }
+        break;
+
+    case FLRC_TRANSFER_FRAME_ABORT:
+        if( ctx->done_reported == true )
+        {
+            ctx->role = FLRC_TRANSFER_ROLE_NONE;
+        }
+        else
+        {
+            flrc_transfer_finish( ctx, FLRC_TRANSFER_STATUS_ABORTED );
+        }
+        break;
+
+    default:
+        flrc_transfer_enqueue_rx( ctx, FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS );
+        break;
+    }
+}
+
+static void flrc_transfer_send_ack( flrc_transfer_t* ctx )
+{
+    flrc_transfer_set_header( ctx, FLRC_TRANSFER_FRAME_ACK, ctx->seq_expected );
+    flrc_transfer_enqueue_tx( ctx, FLRC_TRANSFER_FRAME_HEADER_SIZE, FLRC_TRANSFER_TURNAROUND_MS );
+}
+
+static void flrc_transfer_finish( flrc_transfer_t* ctx, flrc_transfer_status_t status )
+{
+    flrc_transfer_role_t role = ctx->role;
+    uint32_t             size = 0;
+
+    if( role == FLRC_TRANSFER_ROLE_NONE )
+    {
+        return;
+    }
+
+    // Clear the role first: the radio planner callback of an aborted task is then ignored
+    ctx->role = FLRC_TRANSFER_ROLE_NONE;
+
+    if( role == FLRC_TRANSFER_ROLE_SENDER )
+    {
+        rp_task_abort( modem_get_rp( ), RP_HOOK_ID_FLRC_TRANSFER );
+        size = ( uint32_t ) ctx->seq_base * ctx->chunk_size;
+    }
+    else if( status != FLRC_TRANSFER_STATUS_IO_ERROR )
+    {
+        // The ABORT frame of a write failure is still to be sent
+        rp_task_abort( modem_get_rp( ), RP_HOOK_ID_FLRC_TRANSFER );
+        size = ( uint32_t ) ctx->seq_expected * ctx->chunk_size;
+    }
+    else
+    {
+        size = ( uint32_t ) ctx->seq_expected * ctx->chunk_size;
+    }
+
+    if( size > ctx->size )
+    {
+        size = ctx->size;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "FLRC transfer end, status %u, %u bytes\n", status, size );
+    if( ctx->callbacks.done != NULL )
+    {
+        ctx->callbacks.done( ctx->callbacks.context, status, size );
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
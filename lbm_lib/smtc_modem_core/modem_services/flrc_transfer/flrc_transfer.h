@@ -0,0 +1,235 @@
+/**
+ * @file      flrc_transfer.h
+ *
+ * @brief     Device to device bulk transfer over FLRC (SX128x only)
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FLRC_TRANSFER_H
+#define FLRC_TRANSFER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include "lr1_stack_mac_layer.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/**
+ * @brief Frame layout, all fields little endian: type (1) | session (1) | sequence number (2) | data
+ *
+ *  - START: data is the transfer size (4), the chunk size (1) and the window (1), answered by an ACK of 0
+ *  - DATA:  data is the chunk of the sequence number, DATA_ACK_REQ closes a window and asks for an ACK
+ *  - ACK:   the sequence number is the next chunk expected by the receiver, acknowledging all the previous ones
+ *  - ABORT: the peer gives up the session
+ */
+#define FLRC_TRANSFER_FRAME_HEADER_SIZE ( 4 )
+
+/**
+ * @brief Maximum data bytes in a DATA frame, the FLRC payload is limited to 127 bytes
+ */
+#ifndef FLRC_TRANSFER_CHUNK_SIZE
+#define FLRC_TRANSFER_CHUNK_SIZE ( 120 )
+#endif
+
+/**
+ * @brief Maximum number of DATA frames sent before waiting for an ACK
+ */
+#define FLRC_TRANSFER_WINDOW_MAX ( 32 )
+
+/**
+ * @brief Time the sender listens for an ACK, from the end of the last frame of the window
+ */
+#ifndef FLRC_TRANSFER_ACK_TIMEOUT_MS
+#define FLRC_TRANSFER_ACK_TIMEOUT_MS ( 50 )
+#endif
+
+/**
+ * @brief Delay between the frame asking for an ACK and the ACK, for the sender to switch to reception
+ */
+#ifndef FLRC_TRANSFER_TURNAROUND_MS
+#define FLRC_TRANSFER_TURNAROUND_MS ( 10 )
+#endif
+
+/**
+ * @brief Number of windows sent again without progress before the sender gives up
+ */
+#ifndef FLRC_TRANSFER_MAX_RETRIES
+#define FLRC_TRANSFER_MAX_RETRIES ( 8 )
+#endif
+
+/**
+ * @brief Time without frame after which the receiver gives up an ongoing transfer
+ */
+#ifndef FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS
+#define FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS ( 2000 )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Definition of return codes for FLRC transfer functions
+ *
+ * @enum flrc_transfer_rc_t
+ */
+typedef enum flrc_transfer_rc_e
+{
+    FLRC_TRANSFER_RC_OK,       //!< Function executed without error
+    FLRC_TRANSFER_RC_INVALID,  //!< Invalid parameters
+    FLRC_TRANSFER_RC_BUSY,     //!< A transfer is ongoing or the modem is in test mode
+    FLRC_TRANSFER_RC_FAIL,     //!< Fail to execute the function
+} flrc_transfer_rc_t;
+
+/**
+ * @brief Transfer completion status
+ *
+ * @enum flrc_transfer_status_t
+ */
+typedef enum flrc_transfer_status_e
+{
+    FLRC_TRANSFER_STATUS_DONE,      //!< All the data were acknowledged (sender) or received (receiver)
+    FLRC_TRANSFER_STATUS_TIMEOUT,   //!< The peer stopped answering
+    FLRC_TRANSFER_STATUS_ABORTED,   //!< Aborted locally or by the peer
+    FLRC_TRANSFER_STATUS_IO_ERROR,  //!< A read or write callback failed
+} flrc_transfer_status_t;
+
+/**
+ * @brief Radio configuration, identical on both devices
+ */
+typedef struct flrc_transfer_config_s
+{
+    uint32_t rf_freq_in_hz;      //!< 2.4 GHz band frequency
+    uint32_t br_in_bps;          //!< 260000, 325000, 520000, 650000, 1040000 or 1300000
+    int8_t   output_pwr_in_dbm;  //!< Transmit power
+    uint32_t link_id;            //!< Shared identifier of the two devices, used as FLRC sync word
+    uint8_t  window;             //!< DATA frames per ACK (sender only), 1 to FLRC_TRANSFER_WINDOW_MAX
+} flrc_transfer_config_t;
+
+/**
+ * @brief Application data accesses, read and write return 0 on success
+ *
+ * The callbacks are called from the modem engine context.
+ */
+typedef struct flrc_transfer_callbacks_s
+{
+    void* context;  //!< Passed back to the callbacks
+    int8_t ( *read )( void* context, uint32_t offset, uint8_t* data, uint8_t size );         //!< Sender data
+    int8_t ( *write )( void* context, uint32_t offset, const uint8_t* data, uint8_t size );  //!< Receiver data
+    void ( *done )( void* context, flrc_transfer_status_t status, uint32_t size );          //!< End of transfer
+} flrc_transfer_callbacks_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init the FLRC transfer services object
+ *
+ * @param service_id
+ * @param task_id
+ * @param downlink_callback
+ * @param on_launch_callback
+ * @param on_update_callback
+ * @param context_callback
+ */
+void flrc_transfer_services_init( uint8_t* service_id, uint8_t task_id,
+                                  uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                                  void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                                  void** context_callback );
+
+/**
+ * @brief Send data to a peer waiting in @ref flrc_transfer_receive
+ *
+ * @remark The radio planner shares the radio with the LoRaWAN stacks: a LoRaWAN task preempting the transfer costs a
+ * window retry. The done callback reports the end of the transfer
+ *
+ * @param [in] config     Radio configuration
+ * @param [in] size       Number of bytes to send, read through the read callback
+ * @param [in] callbacks  Data accesses, kept by the service until the done callback
+ * @return flrc_transfer_rc_t
+ */
+flrc_transfer_rc_t flrc_transfer_send( const flrc_transfer_config_t* config, uint32_t size,
+                                       const flrc_transfer_callbacks_t* callbacks );
+
+/**
+ * @brief Wait for a peer to start a transfer, and receive its data
+ *
+ * @remark After the done callback of a successful transfer, the service keeps answering the sender for
+ * FLRC_TRANSFER_RX_IDLE_TIMEOUT_MS in case the last ACK is lost, @ref flrc_transfer_is_busy returns true meanwhile
+ *
+ * @param [in] config             Radio configuration, the window is chosen by the sender
+ * @param [in] listen_timeout_ms  Time to wait for the START frame
+ * @param [in] callbacks          Data accesses, kept by the service until the done callback
+ * @return flrc_transfer_rc_t
+ */
+flrc_transfer_rc_t flrc_transfer_receive( const flrc_transfer_config_t* config, uint32_t listen_timeout_ms,
+                                          const flrc_transfer_callbacks_t* callbacks );
+
+/**
+ * @brief Abort the ongoing transfer, the done callback is called with FLRC_TRANSFER_STATUS_ABORTED
+ *
+ * @return flrc_transfer_rc_t FLRC_TRANSFER_RC_FAIL if no transfer is ongoing
+ */
+flrc_transfer_rc_t flrc_transfer_abort( void );
+
+/**
+ * @brief Check if a transfer is ongoing
+ *
+ * @return true if a transfer is ongoing
+ */
+bool flrc_transfer_is_busy( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FLRC_TRANSFER_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -136,6 +136,27 @@
 
 #define UPLOAD_SID 0
 
+// number of file bytes hashed per supervisor task while the upload is prepared (multiple of 64)
+#ifndef FILE_UPLOAD_HASH_SLICE_SIZE
+#define FILE_UPLOAD_HASH_SLICE_SIZE ( 1024 )
+#endif
+
+// largest fragment, the fragments are otherwise as long as the datarate allows
+#ifndef FILE_UPLOAD_FRAGMENT_SIZE_MAX
+#define FILE_UPLOAD_FRAGMENT_SIZE_MAX ( 242 )
+#endif
+
+// one fragment out of FILE_UPLOAD_PROBE_PERIOD is sent confirmed to estimate the uplink loss
+#ifndef FILE_UPLOAD_PROBE_PERIOD
+#define FILE_UPLOAD_PROBE_PERIOD ( 8 )
+#endif
+
+// weight of the last probe in the loss estimate is 1 / 2^FILE_UPLOAD_LOSS_SHIFT
+#define FILE_UPLOAD_LOSS_SHIFT ( 2 )
+
+// highest loss taken into account, in hundredths of percent: the chunk budget grows up to 8 times
+#define FILE_UPLOAD_LOSS_MAX ( 8750 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -150,6 +171,7 @@ typedef enum lfu_state_e
     LFU_NOT_INIT = 0,     //!< The file upload is not initialized
     LFU_INIT_AND_FILLED,  //!< The file upload is initialized and filled with data
     LFU_START_REQUESTED,  //!< A start was requested by user but the service is waiting to be launched by supervisor
+    LFU_PREPARING,        //!< The file is being hashed (and encrypted), one slice per supervisor task
     LFU_ON_GOING,         //!< The upload is in progress
     LFU_FINISHED,         //!< The upload process is finished
 } lfu_state_t;
@@ -167,17 +189,33 @@ typedef struct file_upload_s
     uint16_t  cct;                   // chunk count
     uint16_t  cntx;                  // chunk transmission count
     uint8_t   fntx;                  // frame transmission count
+    uint32_t  hash_offset;           // number of file bytes already hashed
+    bool      hash_encrypted;        // the file being hashed is the encrypted one
+    uint16_t  loss;                  // estimated uplink loss in hundredths of percent
+    uint8_t   probe_count;           // fragments sent since the last confirmed one
 
 } file_upload_t;
 
+/**
+ * @brief SHA-256 computed over several calls
+ */
+typedef struct file_upload_sha256_s
+{
+    uint32_t state[8];   // intermediate hash value
+    uint8_t  block[64];  // bytes of the block not complete yet
+    uint32_t len;        // number of bytes hashed so far
+} file_upload_sha256_t;
+
 typedef struct lfu_ctx_s
 {
-    uint8_t          stack_id;
-    uint8_t          task_id;
-    file_upload_t    lfu;
-    lfu_state_t      state;
-    status_lorawan_t send_status;
-    uint8_t          sctr;
+    uint8_t              stack_id;
+    uint8_t              task_id;
+    file_upload_t        lfu;
+    lfu_state_t          state;
+    status_lorawan_t     send_status;
+    uint8_t              sctr;
+    bool                 probe_pending;  // the last fragment was confirmed and its outcome is not known yet
+    file_upload_sha256_t sha256;
 } lfu_ctx_t;
 
 typedef struct lfu_service_ctx_s
@@ -204,6 +242,7 @@ static void       lfu_service_on_update( void* service_id );
 static uint8_t    lfu_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
 static lfu_ctx_t* lfu_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id );
 static void       lfu_add_task( lfu_ctx_t* ctx, uint32_t delay_in_s );
+static void       lfu_follow_acks( lfu_ctx_t* ctx, bool enable );
 
 // file upload management
 /**
@@ -220,8 +259,11 @@ file_upload_return_code_t file_upload_process_file_done_frame( file_upload_t* fi
 /**
  * @brief Once the file is attached to the current upload session, a preparation must be called before start
  *
+ * @remark Each call hashes FILE_UPLOAD_HASH_SLICE_SIZE bytes of the file, so that a large file does not hold the
+ * supervisor for the whole hash
+ *
  * @param [in] file_upload Pointer to File Upload context
- * @return file_upload_return_code_t
+ * @return file_upload_return_code_t FILE_UPLOAD_OK once the file is ready, FILE_UPLOAD_ERROR_BUSY while slices remain
  */
 file_upload_return_code_t file_upload_prepare_upload( lfu_ctx_t* ctx );
 
@@ -236,9 +278,19 @@ file_upload_return_code_t file_upload_prepare_upload( lfu_ctx_t* ctx );
  */
 int32_t file_upload_get_fragment( file_upload_t* file_upload, uint8_t* buf, int32_t len, uint32_t fcnt );
 
+/**
+ * @brief Update the uplink loss estimate with the outcome of a confirmed fragment
+ *
+ * @param [in] file_upload Pointer to File Upload context
+ * @param [in] lost        True if the fragment was not acknowledged
+ */
+void file_upload_update_loss( file_upload_t* file_upload, bool lost );
+
 /**
  * @brief Check if there are remaining file data that need to be sent
  *
+ * @remark The number of chunks sent is limited to twice the chunk count, increased by the estimated uplink loss
+ *
  * @param [in] file_upload Pointer to File Upload context
  * @return true
  * @return false
@@ -252,13 +304,30 @@ static void     function_xor( uint32_t* dst, uint32_t* src, int32_t nw );
 static void     gen_chunk( file_upload_t* file_upload, uint32_t* dst, uint32_t* src, uint32_t cct, uint32_t cid );
 
 /**
- * @brief Compute SHA256
+ * @brief Start a SHA256 computation
+ *
+ * @param [in] sha  SHA256 context
+ */
+static void sha256_init( file_upload_sha256_t* sha );
+
+/**
+ * @brief Add data to a SHA256 computation
+ *
+ * @remark Only the last call before sha256_final may use a length that is not a multiple of 4
  *
- * @param [in] hash Contains the computed hash
+ * @param [in] sha  SHA256 context
  * @param [in] msg  input buffer
  * @param [in] len  input buffer length
  */
-static void sha256( uint32_t* hash, const uint8_t* msg, uint32_t len );
+static void sha256_update( file_upload_sha256_t* sha, const uint8_t* msg, uint32_t len );
+
+/**
+ * @brief End a SHA256 computation
+ *
+ * @param [in] sha   SHA256 context
+ * @param [out] hash Contains the computed hash
+ */
+static void sha256_final( file_upload_sha256_t* sha, uint32_t* hash );
 
 /*
  * -----------------------------------------------------------------------------
@@ -290,6 +359,11 @@ void lfu_services_init( uint8_t* service_id, uint8_t task_id,
     memset( &ctx->lfu, 0, sizeof( file_upload_t ) );
 
     SMTC_MODEM_HAL_TRACE_WARNING( "%s\n", __func__ );
+
+#if ( NUMBER_OF_STACKS == 1 )
+    // the dm port of the stack, followed by cloud_dm_set_dm_port
+    modem_set_downlink_service_port( lfu_service_downlink_handler, DM_PORT );
+#endif
 }
 
 /*
@@ -334,6 +408,10 @@ file_upload_return_code_t file_upload_init( uint8_t stack_id, const uint8_t* fil
     ctx->lfu.cct                  = cct;
     ctx->lfu.cntx                 = 0;
     ctx->lfu.fntx                 = 0;
+    ctx->lfu.hash_offset          = 0;
+    ctx->lfu.hash_encrypted       = false;
+    ctx->lfu.loss                 = 0;
+    ctx->lfu.probe_count          = 0;
     ctx->lfu.header[0] =
         ( port ) + ( encryption << 8 ) + ( ( file_len & 0xFF ) << 16 ) + ( ( ( file_len & 0xFF00 ) >> 8 ) << 24 );
 
@@ -352,7 +430,7 @@ file_upload_return_code_t file_upload_start( uint8_t stack_id )
     lfu_ctx_t* ctx = lfu_get_ctx_from_stack_id( stack_id, &service_id );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
 
-    if( ctx->state == LFU_ON_GOING )
+    if( ( ctx->state == LFU_ON_GOING ) || ( ctx->state == LFU_PREPARING ) )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "FileUpload still in progress..\n" );
         return FILE_UPLOAD_ERROR_BUSY;
@@ -365,6 +443,7 @@ file_upload_return_code_t file_upload_start( uint8_t stack_id )
 
     // add the first upload task in scheduler
     lfu_add_task( ctx, smtc_modem_hal_get_random_nb_in_range( 200, 3000 ) / 1000 );
+    lfu_follow_acks( ctx, true );
 
     // Now update state to START_REQUESTED
     ctx->state = LFU_START_REQUESTED;
@@ -386,6 +465,7 @@ file_upload_return_code_t file_upload_reset( uint8_t stack_id )
 
     // remove on going task
     modem_supervisor_remove_task( ctx->task_id );
+    lfu_follow_acks( ctx, false );
 
     // Reset state
     ctx->state = LFU_NOT_INIT;
@@ -402,7 +482,10 @@ bool file_upload_get_status( uint8_t stack_id )
     {
         return false;
     }
-    return ( ( ctx->state == LFU_ON_GOING ) || ( ctx->state == LFU_START_REQUESTED ) ) ? true : false;
+    return ( ( ctx->state == LFU_ON_GOING ) || ( ctx->state == LFU_START_REQUESTED ) ||
+             ( ctx->state == LFU_PREPARING ) )
+               ? true
+               : false;
 }
 
 void file_upload_stop_service( uint8_t stack_id )
@@ -414,6 +497,7 @@ void file_upload_stop_service( uint8_t stack_id )
 
     // remove on going task
     modem_supervisor_remove_task( ctx->task_id );
+    lfu_follow_acks( ctx, false );
 
     // Reset state
     ctx->state = LFU_NOT_INIT;
@@ -434,30 +518,50 @@ static void lfu_service_on_launch( void* service_id )
     int32_t file_upload_chunk_size         = 0;
     uint8_t file_upload_chunk_payload[242] = { 0 };
 
-    if( lorawan_api_isjoined( lfu_ctx[idx].stack_id ) != JOINED )
-    {
-        SMTC_MODEM_HAL_TRACE_ERROR( "DEVICE NOT JOIN \n" );
-        return;
-    }
     if( lfu_ctx[idx].state == LFU_START_REQUESTED )
     {
         // first time task is handled, prepare the upload
-
-        file_upload_prepare_upload( &lfu_ctx[idx] );
+        lfu_ctx[idx].state = LFU_PREPARING;
+    }
+    if( lfu_ctx[idx].state == LFU_PREPARING )
+    {
+        if( file_upload_prepare_upload( &lfu_ctx[idx] ) != FILE_UPLOAD_OK )
+        {
+            // no uplink for this slice, the next one is queued by on_update
+            return;
+        }
         lfu_ctx[idx].state = LFU_ON_GOING;
     }
 
+    if( lorawan_api_isjoined( lfu_ctx[idx].stack_id ) != JOINED )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "DEVICE NOT JOIN \n" );
+        return;
+    }
+
     if( lfu_ctx[idx].state != LFU_ON_GOING )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "No File upload on going \n" );
         return;
     }
     uint32_t max_payload_size = lorawan_api_next_max_payload_length_get( lfu_ctx[idx].stack_id );
-    file_upload_chunk_size    = file_upload_get_fragment( &lfu_ctx[idx].lfu, file_upload_chunk_payload,
-                                                       ( max_payload_size > 100 ) ? 100 : max_payload_size,
-                                                          lorawan_api_fcnt_up_get( lfu_ctx[idx].stack_id ) );
+    file_upload_chunk_size    = file_upload_get_fragment(
+        &lfu_ctx[idx].lfu, file_upload_chunk_payload,
+        ( max_payload_size > FILE_UPLOAD_FRAGMENT_SIZE_MAX ) ? FILE_UPLOAD_FRAGMENT_SIZE_MAX : max_payload_size,
+        lorawan_api_fcnt_up_get( lfu_ctx[idx].stack_id ) );
+    lfu_ctx[idx].probe_pending = false;
     if( file_upload_chunk_size > 0 )
     {
+        lr1mac_layer_param_t packet_type = UNCONF_DATA_UP;
+
+        // the acknowledgement of a confirmed fragment tells whether the uplink went through
+        if( ++lfu_ctx[idx].lfu.probe_count >= FILE_UPLOAD_PROBE_PERIOD )
+        {
+            lfu_ctx[idx].lfu.probe_count = 0;
+            lfu_ctx[idx].probe_pending   = true;
+            packet_type                  = CONF_DATA_UP;
+        }
+
         uint8_t dm_port;
 #if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
         dm_port = cloud_dm_get_dm_port( lfu_ctx[idx].stack_id );
@@ -465,7 +569,7 @@ static void lfu_service_on_launch( void* service_id )
         dm_port = DM_PORT;
 #endif
         lfu_ctx[idx].send_status =
-            tx_protocol_manager_request (TX_PROTOCOL_TRANSMIT_LORA, dm_port, true, file_upload_chunk_payload, file_upload_chunk_size, UNCONF_DATA_UP,
+            tx_protocol_manager_request (TX_PROTOCOL_TRANSMIT_LORA_BULK, dm_port, true, file_upload_chunk_payload, file_upload_chunk_size, packet_type,
                                       smtc_modem_hal_get_time_in_ms( )  , lfu_ctx[idx].stack_id );
     }
     else
@@ -484,7 +588,12 @@ static void lfu_service_on_update( void* service_id )
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s service_id %d \n", __func__, idx );
     IS_VALID_OBJECT_ID( idx );
 
-    if( lfu_ctx[idx].state == LFU_ON_GOING )
+    if( lfu_ctx[idx].state == LFU_PREPARING )
+    {
+        // hash the next slice of the file as soon as possible
+        lfu_add_task( &lfu_ctx[idx], 0 );
+    }
+    else if( lfu_ctx[idx].state == LFU_ON_GOING )
     {
         if( ( file_upload_is_data_remaining( &lfu_ctx[idx].lfu ) == true ) )
         {
@@ -497,6 +606,7 @@ static void lfu_service_on_update( void* service_id )
             SMTC_MODEM_HAL_TRACE_WARNING( "File upload ended without server confirmation \n" );
             // Reset service state to uninit
             lfu_ctx[idx].state = LFU_NOT_INIT;
+            lfu_follow_acks( &lfu_ctx[idx], false );
             increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_UPLOAD_DONE, SMTC_MODEM_EVENT_UPLOAD_DONE_ABORTED,
                                               lfu_ctx[idx].stack_id );
         }
@@ -505,6 +615,7 @@ static void lfu_service_on_update( void* service_id )
     {
         // Reset service state to uninit
         lfu_ctx[idx].state = LFU_NOT_INIT;
+        lfu_follow_acks( &lfu_ctx[idx], false );
         // file upload is finished with server confirmation, notify user
         increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_UPLOAD_DONE, SMTC_MODEM_EVENT_UPLOAD_DONE_SUCCESSFUL,
                                           lfu_ctx[idx].stack_id );
@@ -528,13 +639,21 @@ static uint8_t lfu_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_
         return MODEM_DOWNLINK_UNCONSUMED;
     }
 
+    // outcome of a confirmed fragment, only the first reception window after it counts
+    if( ( ctx->probe_pending == true ) && ( modem_supervisor_get_task( )->next_task_id == ctx->task_id ) )
+    {
+        ctx->probe_pending = false;
+        file_upload_update_loss( &ctx->lfu, rx_down_data->rx_metadata.rx_ack_bit == false );
+    }
+
     uint8_t dm_port;
 #if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
     dm_port = cloud_dm_get_dm_port( stack_id );
 #else
     dm_port = DM_PORT;
 #endif
-    if( ( rx_down_data->rx_metadata.rx_fport_present == true ) && ( rx_down_data->rx_metadata.rx_fport == dm_port ) &&
+    if( ( rx_down_data->rx_metadata.rx_window != RECEIVE_NONE ) &&
+        ( rx_down_data->rx_metadata.rx_fport_present == true ) && ( rx_down_data->rx_metadata.rx_fport == dm_port ) &&
         ( rx_down_data->rx_payload_size > DM_DOWNLINK_HEADER_LENGTH ) &&
         ( ( dm_opcode_t ) rx_down_data->rx_payload[2] == DM_FILE_DONE ) )
     {
@@ -592,11 +711,56 @@ static void lfu_add_task( lfu_ctx_t* ctx, uint32_t delay_in_s )
     modem_supervisor_add_task( &lfu_task );
 }
 
+static void lfu_follow_acks( lfu_ctx_t* ctx, bool enable )
+{
+#if ( NUMBER_OF_STACKS == 1 )
+    uint8_t dm_port;
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+    dm_port = cloud_dm_get_dm_port( ctx->stack_id );
+#else
+    dm_port = DM_PORT;
+#endif
+    // acknowledgements come without fport, the handler has to see all downlinks during an upload
+    modem_set_downlink_service_port( lfu_service_downlink_handler,
+                                     ( enable == true ) ? MODEM_DOWNLINK_ANY_PORT : dm_port );
+#endif
+    if( enable == false )
+    {
+        ctx->probe_pending = false;
+    }
+}
+
 // LFU functionalities
 file_upload_return_code_t file_upload_prepare_upload( lfu_ctx_t* ctx )
 {
     uint32_t hash[8];
-    sha256( hash, ( unsigned char* ) ctx->lfu.file_buf, ctx->lfu.file_len );
+    uint32_t slice = ctx->lfu.file_len - ctx->lfu.hash_offset;
+
+    if( slice > FILE_UPLOAD_HASH_SLICE_SIZE )
+    {
+        slice = FILE_UPLOAD_HASH_SLICE_SIZE;
+    }
+    if( ctx->lfu.hash_offset == 0 )
+    {
+        sha256_init( &ctx->sha256 );
+    }
+    sha256_update( &ctx->sha256, ( const uint8_t* ) ctx->lfu.file_buf + ctx->lfu.hash_offset, slice );
+    ctx->lfu.hash_offset += slice;
+    if( ctx->lfu.hash_offset < ctx->lfu.file_len )
+    {
+        return FILE_UPLOAD_ERROR_BUSY;
+    }
+    sha256_final( &ctx->sha256, hash );
+
+    if( ctx->lfu.hash_encrypted == true )
+    {
+        // hash over plain data (first byte)
+        ctx->lfu.header[2] = ctx->lfu.header[1];
+        // hash over encrypted data (first byte)
+        ctx->lfu.header[1] = hash[0];
+        return FILE_UPLOAD_OK;
+    }
+
     ctx->lfu.header[1] = hash[0];
     ctx->lfu.header[2] = hash[1];
 
@@ -623,13 +787,10 @@ file_upload_return_code_t file_upload_prepare_upload( lfu_ctx_t* ctx )
             SMTC_MODEM_HAL_PANIC( "Encryption of lfu failed\n" );
         }
 
-        // compute hash over encrypted data
-        sha256( hash, ( unsigned char* ) ctx->lfu.file_buf, ctx->lfu.file_len );
-
-        // hash over plain data (first byte)
-        ctx->lfu.header[2] = ctx->lfu.header[1];
-        // hash over encrypted data (first byte)
-        ctx->lfu.header[1] = hash[0];
+        // compute hash over encrypted data, in the next slices
+        ctx->lfu.hash_offset    = 0;
+        ctx->lfu.hash_encrypted = true;
+        return FILE_UPLOAD_ERROR_BUSY;
     }
     return FILE_UPLOAD_OK;
 }
@@ -671,10 +832,24 @@ int32_t file_upload_get_fragment( file_upload_t* file_upload, uint8_t* buf, int3
     return n;
 }
 
+void file_upload_update_loss( file_upload_t* file_upload, bool lost )
+{
+    int32_t sample = ( lost == true ) ? 10000 : 0;
+
+    file_upload->loss += ( sample - ( int32_t ) file_upload->loss ) / ( 1 << FILE_UPLOAD_LOSS_SHIFT );
+    SMTC_MODEM_HAL_TRACE_PRINTF( "File upload %s, loss %d.%02d%%\n", ( lost == true ) ? "loss" : "ack",
+                                 file_upload->loss / 100, file_upload->loss % 100 );
+}
+
 bool file_upload_is_data_remaining( file_upload_t* file_upload )
 {
-    // limit number of chunks sent to twice the chunk count but send minimum three frames
-    return ( ( file_upload->fntx < 3 ) || ( file_upload->cntx < ( 2 * file_upload->cct ) ) );
+    uint32_t loss = ( file_upload->loss > FILE_UPLOAD_LOSS_MAX ) ? FILE_UPLOAD_LOSS_MAX : file_upload->loss;
+
+    // the server needs about the chunk count once received, the lost fragments are made up for
+    uint32_t budget = ( 2 * ( uint32_t ) file_upload->cct * 10000 ) / ( 10000 - loss );
+
+    // limit number of chunks sent to the budget but send minimum three frames
+    return ( ( file_upload->fntx < 3 ) || ( file_upload->cntx < budget ) );
 }
 
 file_upload_return_code_t file_upload_process_file_done_frame( file_upload_t* file_upload, const uint8_t* payload,
@@ -760,6 +935,7 @@ static void function_xor( uint32_t* dst, uint32_t* src, int32_t nw )
     }
 }
 
+#if !defined( ADD_SMTC_LFU_HW_HASH )
 static void sha256_do( uint32_t* state, const uint8_t* block )
 {
     static const uint32_t K[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
@@ -816,52 +992,84 @@ static void sha256_do( uint32_t* state, const uint8_t* block )
     state[6] += g;
     state[7] += h;
 }
+#endif
 
-static void sha256( uint32_t* hash, const uint8_t* msg, uint32_t len )
+static void sha256_init( file_upload_sha256_t* sha )
 {
-    uint32_t state[8] = {
+#if defined( ADD_SMTC_LFU_HW_HASH )
+    ( void ) sha;
+    smtc_modem_hal_sha256_start( );
+#else
+    static const uint32_t state[8] = {
         0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
     };
 
-    uint32_t bitlen = len << 3;
-    while( 1 )
+    memcpy( sha->state, state, sizeof( sha->state ) );
+    sha->len = 0;
+#endif
+}
+
+static void sha256_update( file_upload_sha256_t* sha, const uint8_t* msg, uint32_t len )
+{
+#if defined( ADD_SMTC_LFU_HW_HASH )
+    ( void ) sha;
+    smtc_modem_hal_sha256_update( msg, len );
+#else
+    uint32_t used = sha->len & 63;
+
+    sha->len += len;
+
+    // complete the block left by the previous call
+    if( used > 0 )
     {
-        if( len < 64 )
-        {
-            union
-            {
-                uint8_t  bytes[64];
-                uint32_t words[16];
-            } tmp;
-            memset( tmp.words, 0, sizeof( tmp ) );
-            memcpy( tmp.bytes, msg, len );
-            tmp.bytes[len] = 0x80;
-            if( len < 56 )
-            {
-            last:
-                tmp.words[15] = ENDIAN_n2b32( bitlen );
-                sha256_do( state, tmp.bytes );
-                int i;
-                for( i = 0; i < 8; i++ )
-                {
-                    hash[i] = ENDIAN_n2b32( state[i] );
-                }
-                break;
-            }
-            else
-            {
-                sha256_do( state, tmp.bytes );
-                memset( tmp.words, 0, sizeof( tmp ) );
-                goto last;
-            }
-        }
-        else
+        uint32_t fill = ( len < ( 64 - used ) ) ? len : ( 64 - used );
+
+        memcpy( &sha->block[used], msg, fill );
+        msg += fill;
+        len -= fill;
+        if( ( used + fill ) < 64 )
         {
-            sha256_do( state, msg );
-            msg += 64;
-            len -= 64;
+            return;
         }
+        sha256_do( sha->state, sha->block );
+    }
+    while( len >= 64 )
+    {
+        sha256_do( sha->state, msg );
+        msg += 64;
+        len -= 64;
+    }
+    memcpy( sha->block, msg, len );
+#endif
+}
+
+static void sha256_final( file_upload_sha256_t* sha, uint32_t* hash )
+{
+#if defined( ADD_SMTC_LFU_HW_HASH )
+    ( void ) sha;
+    smtc_modem_hal_sha256_finish( ( uint8_t* ) hash );
+#else
+    uint32_t used   = sha->len & 63;
+    uint32_t bitlen = sha->len << 3;
+
+    memset( &sha->block[used], 0, 64 - used );
+    sha->block[used] = 0x80;
+    if( used >= 56 )
+    {
+        sha256_do( sha->state, sha->block );
+        memset( sha->block, 0, 64 );
     }
+    sha->block[60] = bitlen >> 24;
+    sha->block[61] = bitlen >> 16;
+    sha->block[62] = bitlen >> 8;
+    sha->block[63] = bitlen;
+    sha256_do( sha->state, sha->block );
+
+    for( int i = 0; i < 8; i++ )
+    {
+        hash[i] = ENDIAN_n2b32( sha->state[i] );
+    }
+#endif
 }
 
 /* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,399 @@
+/**
+ * @file      payload_compression.c
+ *
+ * @brief     Schema driven delta compression of application uplinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memcpy
+#include "payload_compression.h"
+#include "modem_core.h"
+#include "modem_supervisor_light.h"
+#include "smtc_modem_hal.h"
+#include "smtc_modem_hal_dbg_trace.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define CURRENT_STACK ( task_id / NUMBER_OF_TASKS )
+#define NUMBER_MAX_OF_PAYLOAD_COMPRESSION_OBJ 1  // modify in case of multiple obj
+
+/**
+ * @brief Sequence number mask in the frame header
+ */
+#define PAYLOAD_COMPRESSION_SEQ_MASK ( 0x7F )
+
+/**
+ * @brief Check is the index is valid before accessing payload compression object
+ *
+ */
+#define IS_VALID_OBJECT_ID( x )                                                       \
+    do                                                                                \
+    {                                                                                 \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_MAX_OF_PAYLOAD_COMPRESSION_OBJ ); \
+    } while( 0 )
+
+/**
+ * @brief Check is the index is valid before accessing the object
+ *
+ */
+#define IS_VALID_STACK_ID( x )                                   \
+    do                                                           \
+    {                                                            \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_OF_STACKS ); \
+    } while( 0 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief Payload compression Object
+ *
+ * @struct payload_compression_s
+ */
+typedef struct payload_compression_s
+{
+    uint8_t stack_id;
+    uint8_t task_id;
+    bool    enabled;
+    bool    initialized;
+
+    uint8_t fport;
+    uint8_t field_sizes[PAYLOAD_COMPRESSION_FIELDS_MAX];
+    uint8_t nb_fields;
+    uint8_t record_len;
+    bool    big_endian;
+    uint8_t key_frame_period;
+
+    uint32_t previous[PAYLOAD_COMPRESSION_FIELDS_MAX];  // fields of the last record sent
+    bool     key_frame_pending;
+    uint8_t  frames_since_key_frame;
+    uint8_t  seq;
+} payload_compression_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static payload_compression_t payload_compression_obj[NUMBER_MAX_OF_PAYLOAD_COMPRESSION_OBJ];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Callback called at task launch, the service has no task
+ *
+ * @param context_callback
+ */
+static void payload_compression_service_on_launch( void* context );
+
+/**
+ * @brief Callback called at task completion, the service has no task
+ *
+ * @param context_callback
+ */
+static void payload_compression_service_on_update( void* context );
+
+/**
+ * @brief Callback to handle the key frame requests of the server
+ *
+ * @param rx_down_data
+ */
+static uint8_t payload_compression_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
+
+/**
+ * @brief Get the payload compression object from the stack id
+ *
+ * @param [in] stack_id             Stack identifier
+ * @param [out] service_id          Service identifier
+ * @return payload_compression_t*   Object context, NULL if not found
+ */
+static payload_compression_t* payload_compression_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id );
+
+/**
+ * @brief Read a field of a record
+ *
+ * @param [in] data         First byte of the field
+ * @param [in] size         Field size in byte
+ * @param [in] big_endian   Byte order of the field
+ * @return uint32_t         Field value
+ */
+static uint32_t payload_compression_read_field( const uint8_t* data, uint8_t size, bool big_endian );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void payload_compression_services_init( uint8_t* service_id, uint8_t task_id,
+                                        uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                                        void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                                        void** context_callback )
+{
+    IS_VALID_OBJECT_ID( *service_id );
+
+    payload_compression_t* ctx = &payload_compression_obj[*service_id];
+    memset( ctx, 0, sizeof( payload_compression_t ) );
+
+    *downlink_callback  = payload_compression_service_downlink_handler;
+    *on_launch_callback = payload_compression_service_on_launch;
+    *on_update_callback = payload_compression_service_on_update;
+    *context_callback   = ( void* ) service_id;
+
+    ctx->task_id     = task_id;
+    ctx->stack_id    = CURRENT_STACK;
+    ctx->enabled     = false;
+    ctx->initialized = true;
+}
+
+payload_compression_rc_t payload_compression_set_schema( uint8_t stack_id, uint8_t fport, const uint8_t* field_sizes,
+                                                         uint8_t nb_fields, bool big_endian,
+                                                         uint8_t key_frame_period )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t                service_id;
+    payload_compression_t* ctx = payload_compression_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->initialized == false ) )
+    {
+        return PAYLOAD_COMPRESSION_RC_FAIL;
+    }
+
+    if( nb_fields == 0 )
+    {
+        ctx->enabled = false;
+        return PAYLOAD_COMPRESSION_RC_OK;
+    }
+
+    if( ( fport == 0 ) || ( fport >= 224 ) || ( field_sizes == NULL ) ||
+        ( nb_fields > PAYLOAD_COMPRESSION_FIELDS_MAX ) )
+    {
+        return PAYLOAD_COMPRESSION_RC_INVALID;
+    }
+
+    uint8_t record_len = 0;
+    for( uint8_t i = 0; i < nb_fields; i++ )
+    {
+        if( ( field_sizes[i] == 0 ) || ( field_sizes[i] > PAYLOAD_COMPRESSION_FIELD_SIZE_MAX ) )
+        {
+            return PAYLOAD_COMPRESSION_RC_INVALID;
+        }
+        record_len += field_sizes[i];
+    }
+
+    memcpy( ctx->field_sizes, field_sizes, nb_fields );
+    ctx->fport             = fport;
+    ctx->nb_fields         = nb_fields;
+    ctx->record_len        = record_len;
+    ctx->big_endian        = big_endian;
+    ctx->key_frame_period  = key_frame_period;
+    ctx->key_frame_pending = true;
+    ctx->enabled           = true;
+    return PAYLOAD_COMPRESSION_RC_OK;
+}
+
+void payload_compression_request_key_frame( uint8_t stack_id )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t                service_id;
+    payload_compression_t* ctx = payload_compression_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx != NULL )
+    {
+        ctx->key_frame_pending = true;
+    }
+}
+
+payload_compression_rc_t payload_compression_encode( uint8_t stack_id, uint8_t fport, const uint8_t* record,
+                                                     uint8_t record_len, uint8_t* frame, uint8_t* frame_len )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t                service_id;
+    payload_compression_t* ctx = payload_compression_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->enabled == false ) || ( fport != ctx->fport ) )
+    {
+        return PAYLOAD_COMPRESSION_RC_FAIL;
+    }
+    if( ( record == NULL ) || ( record_len != ctx->record_len ) )
+    {
+        return PAYLOAD_COMPRESSION_RC_INVALID;
+    }
+
+    uint32_t values[PAYLOAD_COMPRESSION_FIELDS_MAX];
+    uint8_t  offset = 0;
+    for( uint8_t i = 0; i < ctx->nb_fields; i++ )
+    {
+        values[i] = payload_compression_read_field( &record[offset], ctx->field_sizes[i], ctx->big_endian );
+        offset += ctx->field_sizes[i];
+    }
+
+    ctx->seq = ( ctx->seq + 1 ) & PAYLOAD_COMPRESSION_SEQ_MASK;
+
+    if( ( ctx->key_frame_period != 0 ) && ( ctx->frames_since_key_frame >= ( ctx->key_frame_period - 1 ) ) )
+    {
+        ctx->key_frame_pending = true;
+    }
+
+    uint8_t len = 0;
+    if( ctx->key_frame_pending == false )
+    {
+        // Delta frame: change mask then the zigzag varint of each changed field
+        uint8_t mask_len = ( ctx->nb_fields + 7 ) / 8;
+        memset( &frame[1], 0, mask_len );
+        len = 1 + mask_len;
+        for( uint8_t i = 0; i < ctx->nb_fields; i++ )
+        {
+            uint8_t  shift = 32 - ( 8 * ctx->field_sizes[i] );
+            uint32_t diff  = ( values[i] - ctx->previous[i] ) << shift;
+            if( diff == 0 )
+            {
+                continue;
+            }
+            // Sign extend the difference modulo the field size before the zigzag
+            int32_t  delta  = ( int32_t ) diff >> shift;
+            uint32_t zigzag = ( ( uint32_t ) delta << 1 ) ^ ( uint32_t ) ( delta >> 31 );
+
+            frame[1 + ( i / 8 )] |= 1 << ( i % 8 );
+            do
+            {
+                frame[len] = zigzag & 0x7F;
+                zigzag >>= 7;
+                if( zigzag != 0 )
+                {
+                    frame[len] |= 0x80;
+                }
+                len++;
+            } while( zigzag != 0 );
+        }
+        frame[0] = ctx->seq;
+    }
+
+    // A delta frame longer than the record is replaced by a key frame
+    if( ( ctx->key_frame_pending == true ) || ( len >= ( 1 + record_len ) ) )
+    {
+        frame[0] = PAYLOAD_COMPRESSION_KEY_FRAME | ctx->seq;
+        memcpy( &frame[1], record, record_len );
+        len                         = 1 + record_len;
+        ctx->key_frame_pending      = false;
+        ctx->frames_since_key_frame = 0;
+    }
+    else
+    {
+        ctx->frames_since_key_frame++;
+    }
+
+    memcpy( ctx->previous, values, ctx->nb_fields * sizeof( uint32_t ) );
+    *frame_len = len;
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Payload compression %u -> %u bytes\n", record_len, len );
+    return PAYLOAD_COMPRESSION_RC_OK;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void payload_compression_service_on_launch( void* context )
+{
+}
+
+static void payload_compression_service_on_update( void* context )
+{
+}
+
+static uint8_t payload_compression_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
+{
+    uint8_t                service_id;
+    payload_compression_t* ctx = payload_compression_get_ctx_from_stack_id( rx_down_data->stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->enabled == false ) )
+    {
+        return MODEM_DOWNLINK_UNCONSUMED;
+    }
+
+    if( ( rx_down_data->rx_metadata.rx_fport_present == true ) &&
+        ( rx_down_data->rx_metadata.rx_fport == ctx->fport ) && ( rx_down_data->rx_payload_size == 1 ) &&
+        ( rx_down_data->rx_payload[0] == PAYLOAD_COMPRESSION_CMD_KEY_FRAME_REQ ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Payload compression key frame requested\n" );
+        ctx->key_frame_pending = true;
+        return MODEM_DOWNLINK_CONSUMED;
+    }
+
+    return MODEM_DOWNLINK_UNCONSUMED;
+}
+
+static payload_compression_t* payload_compression_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id )
+{
+    payload_compression_t* ctx = NULL;
+    for( uint8_t i = 0; i < NUMBER_MAX_OF_PAYLOAD_COMPRESSION_OBJ; i++ )
+    {
+        if( ( payload_compression_obj[i].initialized == true ) && ( payload_compression_obj[i].stack_id == stack_id ) )
+        {
+            ctx         = &payload_compression_obj[i];
+            *service_id = i;
+            break;
+        }
+    }
+    return ctx;
+}
+
+static uint32_t payload_compression_read_field( const uint8_t* data, uint8_t size, bool big_endian )
+{
+    uint32_t value = 0;
+    for( uint8_t i = 0; i < size; i++ )
+    {
+        value |= ( uint32_t ) data[( big_endian == true ) ? ( size - 1 - i ) : i] << ( 8 * i );
+    }
+    return value;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,183 @@
+/**
+ * @file      payload_compression.h
+ *
+ * @brief     Schema driven delta compression of application uplinks
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef PAYLOAD_COMPRESSION_H
+#define PAYLOAD_COMPRESSION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include "lr1_stack_mac_layer.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/**
+ * @brief Header flag set in a key frame, the other header bits are the sequence number (0 to 127)
+ *
+ * Frame layout: header (1 byte) followed by:
+ *  - key frame:   the uncompressed record
+ *  - delta frame: a change mask (1 bit per field, field 0 in bit 0 of the first byte) followed, for each changed field,
+ *                 by the difference with the previous record as a zigzag little endian base 128 varint
+ *
+ * Differences are computed modulo the field size, so signed and unsigned fields are encoded the same way. A delta frame
+ * refers to the record of the previous sequence number: the decoder waits for a key frame after a sequence gap.
+ */
+#define PAYLOAD_COMPRESSION_KEY_FRAME ( 0x80 )
+
+/**
+ * @brief Downlink command asking for a key frame, sent by the server on the compression FPort after a sequence gap
+ */
+#define PAYLOAD_COMPRESSION_CMD_KEY_FRAME_REQ ( 0x01 )
+
+/**
+ * @brief Maximum number of fields of a record
+ */
+#ifndef PAYLOAD_COMPRESSION_FIELDS_MAX
+#define PAYLOAD_COMPRESSION_FIELDS_MAX ( 16 )
+#endif
+
+/**
+ * @brief Maximum size of a field in byte
+ */
+#define PAYLOAD_COMPRESSION_FIELD_SIZE_MAX ( 4 )
+
+/**
+ * @brief Maximum size of a compressed frame: header, change mask and 5-byte varints
+ */
+#define PAYLOAD_COMPRESSION_FRAME_SIZE_MAX \
+    ( 1 + ( ( PAYLOAD_COMPRESSION_FIELDS_MAX + 7 ) / 8 ) + ( 5 * PAYLOAD_COMPRESSION_FIELDS_MAX ) )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Definition of return codes for payload compression functions
+ *
+ * @enum payload_compression_rc_t
+ */
+typedef enum payload_compression_rc_e
+{
+    PAYLOAD_COMPRESSION_RC_OK,       //!< Function executed without error
+    PAYLOAD_COMPRESSION_RC_INVALID,  //!< Invalid parameters
+    PAYLOAD_COMPRESSION_RC_FAIL,     //!< Fail to execute the function
+} payload_compression_rc_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init a new payload compression services object
+ *
+ * @param service_id
+ * @param task_id
+ * @param downlink_callback
+ * @param on_launch_callback
+ * @param on_update_callback
+ * @param context_callback
+ */
+void payload_compression_services_init( uint8_t* service_id, uint8_t task_id,
+                                        uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                                        void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                                        void** context_callback );
+
+/**
+ * @brief Compress the application uplinks of an FPort
+ *
+ * @remark Once set, every uplink requested on \p fport with @ref smtc_modem_request_uplink (or its variants giving a
+ * payload) shall be a record of the schema, and is sent compressed. The first frame is a key frame
+ *
+ * @param [in] stack_id         Stack identifier
+ * @param [in] fport            LoRaWAN FPort of the records
+ * @param [in] field_sizes      Size in byte of each field of the record (1, 2, 3 or 4)
+ * @param [in] nb_fields        Number of fields, 0 to stop the compression
+ * @param [in] big_endian       Byte order of the fields
+ * @param [in] key_frame_period A key frame every key_frame_period uplinks, 0 for key frames only on server request
+ * @return payload_compression_rc_t
+ */
+payload_compression_rc_t payload_compression_set_schema( uint8_t stack_id, uint8_t fport, const uint8_t* field_sizes,
+                                                         uint8_t nb_fields, bool big_endian,
+                                                         uint8_t key_frame_period );
+
+/**
+ * @brief Send the next record in a key frame
+ *
+ * @param [in] stack_id Stack identifier
+ */
+void payload_compression_request_key_frame( uint8_t stack_id );
+
+/**
+ * @brief Compress a record sent on the compression FPort
+ *
+ * @remark Called by the modem when an uplink is requested, the record becomes the reference of the next delta frame
+ *
+ * @param [in]  stack_id     Stack identifier
+ * @param [in]  fport        LoRaWAN FPort of the uplink
+ * @param [in]  record       Record of the schema
+ * @param [in]  record_len   Record length
+ * @param [out] frame        Compressed frame, of PAYLOAD_COMPRESSION_FRAME_SIZE_MAX bytes
+ * @param [out] frame_len    Compressed frame length
+ * @return PAYLOAD_COMPRESSION_RC_FAIL if \p fport is not compressed, PAYLOAD_COMPRESSION_RC_INVALID if \p record_len
+ * does not match the schema
+ */
+payload_compression_rc_t payload_compression_encode( uint8_t stack_id, uint8_t fport, const uint8_t* record,
+                                                     uint8_t record_len, uint8_t* frame, uint8_t* frame_len );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // PAYLOAD_COMPRESSION_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Reference decoder of the uplinks compressed by the LoRa Basics Modem payload compression service
+(LBM_PAYLOAD_COMPRESSION=yes)
+
+One decoder is kept per device, with the schema given to payload_compression_set_schema(). Frames are given in
+reception order, for example:
+
+    decoder = Decoder([2, 2, 1, 4], big_endian=True)
+    record = decoder.decode(frame)
+    if record is None and decoder.key_frame_needed:
+        # send the KEY_FRAME_REQ downlink on the compression FPort
+        ...
+
+The frame layout is described in payload_compression.h. Frames given in hexadecimal on the command line are decoded
+for a quick check:
+
+    payload_compression_decode.py --fields 2,2,1,4 --big-endian 81000a0014050000012c 02020a
+"""
+
+import argparse
+
+KEY_FRAME = 0x80
+SEQ_MASK = 0x7F
+KEY_FRAME_REQ = bytes([0x01])
+
+
+class Decoder:
+    """Decoder state of one device: the schema, the last record and its sequence number"""
+
+    def __init__(self, field_sizes, big_endian=False):
+        self.field_sizes = list(field_sizes)
+        self.big_endian = big_endian
+        self.values = None
+        self.seq = None
+        self.key_frame_needed = False
+
+    def record(self):
+        """Uncompressed record of the current values"""
+        byteorder = "big" if self.big_endian else "little"
+        return b"".join(value.to_bytes(size, byteorder) for value, size in zip(self.values, self.field_sizes))
+
+    def decode(self, frame):
+        """Decode a frame, returns the uncompressed record, or None until the next key frame after a loss"""
+        if len(frame) < 1:
+            raise ValueError("empty frame")
+        header = frame[0]
+        seq = header & SEQ_MASK
+
+        if header & KEY_FRAME:
+            record_len = sum(self.field_sizes)
+            if len(frame) != 1 + record_len:
+                raise ValueError("key frame of %d bytes, %d expected" % (len(frame), 1 + record_len))
+            byteorder = "big" if self.big_endian else "little"
+            self.values = []
+            offset = 1
+            for size in self.field_sizes:
+                self.values.append(int.from_bytes(frame[offset : offset + size], byteorder))
+                offset += size
+            self.seq = seq
+            self.key_frame_needed = False
+            return self.record()
+
+        # A delta frame refers to the record of the previous sequence number
+        if self.values is None or seq != ((self.seq + 1) & SEQ_MASK):
+            self.values = None
+            self.key_frame_needed = True
+            return None
+
+        mask_len = (len(self.field_sizes) + 7) // 8
+        mask = frame[1 : 1 + mask_len]
+        offset = 1 + mask_len
+        for index, size in enumerate(self.field_sizes):
+            if not mask[index // 8] & (1 << (index % 8)):
+                continue
+            zigzag = 0
+            shift = 0
+            while True:
+                byte = frame[offset]
+                offset += 1
+                zigzag |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            delta = (zigzag >> 1) ^ -(zigzag & 1)
+            self.values[index] = (self.values[index] + delta) % (1 << (8 * size))
+        self.seq = seq
+        return self.record()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode payload compression frames given in hexadecimal")
+    parser.add_argument("--fields", required=True, help="comma separated field sizes in byte")
+    parser.add_argument("--big-endian", action="store_true", help="fields are big endian")
+    parser.add_argument("frames", nargs="+", help="frames in hexadecimal, in reception order")
+    arguments = parser.parse_args()
+
+    decoder = Decoder([int(size) for size in arguments.fields.split(",")], arguments.big_endian)
+    for frame in arguments.frames:
+        record = decoder.decode(bytes.fromhex(frame))
+        if record is None:
+            print("%s: reference lost, key frame needed" % frame)
+        else:
+            print("%s: %s" % (frame, record.hex()))
+
+
+if __name__ == "__main__":
+    main()
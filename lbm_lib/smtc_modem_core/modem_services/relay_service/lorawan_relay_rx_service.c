@@ -109,6 +109,9 @@ typedef enum service_fwd_e
     SERVICE_FWD_FWD_UL,
     SERVICE_FWD_EMPTY_UL,
     SERVICE_FWD_DL,
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+    SERVICE_FWD_BATCH_UL,
+#endif
 } service_fwd_t;
 
 /**
@@ -124,9 +127,16 @@ typedef struct lorawan_relay_rx_s
     bool          initialized;
     uint8_t       buffer[255];
     uint8_t       buffer_len;
+    uint8_t       fport;
     uint32_t      time_to_tx;
     service_fwd_t service_state;
     bool          relay_running_flag_prev;
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+    uint8_t  batch_buffer[255];
+    uint8_t  batch_len;
+    uint8_t  batch_count;
+    uint32_t batch_first_s;  // Reception time of the oldest queued uplink
+#endif
 } lorawan_relay_rx_t;
 
 /*
@@ -160,6 +170,31 @@ static void lorawan_relay_rx_service_on_update( void* context );
  */
 static uint8_t lorawan_relay_rx_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
 
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+/**
+ * @brief Queue a forwarded uplink in the batch, send the batch when it is full
+ *
+ * @param [in] stack_id Stack ID to use
+ * @param [in] data     Metadata and uplink PHYPayload
+ * @param [in] data_len Length of data
+ * @param [in] time_tx  Timestamp to send the batch if this uplink fills it
+ */
+static void lorawan_relay_rx_service_batch_add( uint8_t stack_id, const uint8_t* data, uint8_t data_len,
+                                                uint32_t time_tx );
+
+/**
+ * @brief Move the batch to the send buffer
+ */
+static void lorawan_relay_rx_service_batch_take( void );
+
+/**
+ * @brief Add the task sending the batch when its oldest uplink reaches the maximum latency
+ *
+ * @param [in] stack_id Stack ID to use
+ */
+static void lorawan_relay_rx_service_batch_schedule( uint8_t stack_id );
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -211,6 +246,15 @@ void lorawan_relay_rx_fwd_uplink( uint8_t stack_id, const uint8_t* data, uint8_t
     IS_VALID_STACK_ID( stack_id );
     IS_SERVICE_INITIALIZED( );
 
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+    // Join requests are forwarded alone, the Join Accept has to be sent on the RxR window of the end-device
+    if( is_join == false )
+    {
+        lorawan_relay_rx_service_batch_add( stack_id, data, data_len, time_tx );
+        return;
+    }
+#endif
+
     // SMTC_MODEM_HAL_TRACE_PRINTF( "Relay RX service add fwd ul task %d\n", smtc_modem_hal_get_time_in_ms( ) );
     smodem_task task_relay = {
         .id                = relay_rx_obj.task_id,
@@ -223,6 +267,7 @@ void lorawan_relay_rx_fwd_uplink( uint8_t stack_id, const uint8_t* data, uint8_t
 
     memcpy( relay_rx_obj.buffer, data, data_len );
     relay_rx_obj.buffer_len    = data_len;
+    relay_rx_obj.fport         = FPORT_RELAY;
     relay_rx_obj.time_to_tx    = time_tx;
     relay_rx_obj.service_state = ( is_join == true ) ? SERVICE_FWD_FWD_JOIN : SERVICE_FWD_FWD_UL;
     relay_stop( true );
@@ -240,8 +285,8 @@ static void lorawan_relay_rx_service_on_launch( void* context )
 
     if( ( relay_rx_obj.service_state == SERVICE_FWD_FWD_JOIN ) || ( relay_rx_obj.service_state == SERVICE_FWD_FWD_UL ) )
     {
-        lorawan_api_payload_send( FPORT_RELAY, true, relay_rx_obj.buffer, relay_rx_obj.buffer_len, UNCONF_DATA_UP,
-                                  relay_rx_obj.time_to_tx, RELAY_STACK_ID );
+        lorawan_api_payload_send( relay_rx_obj.fport, true, relay_rx_obj.buffer, relay_rx_obj.buffer_len,
+                                  UNCONF_DATA_UP, relay_rx_obj.time_to_tx, RELAY_STACK_ID );
         // lorawan_api_payload_send_at_time( FPORT_RELAY, true, buffer, buffer_len, UNCONF_DATA_UP, time_to_tx,
         //                                   RELAY_STACK_ID );
     }
@@ -249,7 +294,25 @@ static void lorawan_relay_rx_service_on_launch( void* context )
     {
         lorawan_api_payload_send( 0, false, relay_rx_obj.buffer, 0, UNCONF_DATA_UP,
                                   smtc_modem_hal_get_time_in_ms( ) + 300, RELAY_STACK_ID );
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+        // Sent, a batch queued meanwhile can be scheduled at the update
+        relay_rx_obj.service_state = SERVICE_FWD_DONE;
+#endif
+    }
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+    else if( ( relay_rx_obj.service_state == SERVICE_FWD_BATCH_UL ) || ( relay_rx_obj.batch_count > 0 ) )
+    {
+        if( relay_rx_obj.service_state != SERVICE_FWD_BATCH_UL )
+        {
+            // Maximum latency reached, the relay CAD is stopped while the batch is sent
+            relay_stop( true );
+            lorawan_relay_rx_service_batch_take( );
+            relay_rx_obj.service_state = SERVICE_FWD_BATCH_UL;
+        }
+        lorawan_api_payload_send( relay_rx_obj.fport, true, relay_rx_obj.buffer, relay_rx_obj.buffer_len,
+                                  UNCONF_DATA_UP, smtc_modem_hal_get_time_in_ms( ), RELAY_STACK_ID );
     }
+#endif
     else
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( "Relay RX Launch No action\n" );
@@ -269,6 +332,19 @@ static void lorawan_relay_rx_service_on_update( void* context )
         relay_rx_obj.service_state = SERVICE_FWD_DONE;
         relay_start( );
     }
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+    else if( relay_rx_obj.service_state == SERVICE_FWD_BATCH_UL )
+    {
+        // No end-device waits for a downlink of a batch sent on latency
+        relay_rx_obj.service_state = SERVICE_FWD_DONE;
+        relay_start( );
+    }
+
+    if( ( relay_rx_obj.service_state == SERVICE_FWD_DONE ) && ( relay_rx_obj.batch_count > 0 ) )
+    {
+        lorawan_relay_rx_service_batch_schedule( relay_rx_obj.stack_id );
+    }
+#endif
 }
 
 static uint8_t lorawan_relay_rx_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
@@ -322,4 +398,100 @@ static uint8_t lorawan_relay_rx_service_downlink_handler( lr1_stack_mac_down_dat
     return MODEM_DOWNLINK_UNCONSUMED;
 }
 
+#if defined( ADD_RELAY_RX_FWD_BATCH )
+static void lorawan_relay_rx_service_batch_add( uint8_t stack_id, const uint8_t* data, uint8_t data_len,
+                                                uint32_t time_tx )
+{
+    uint32_t max_len = lorawan_api_next_max_payload_length_get( stack_id );
+    if( max_len > sizeof( relay_rx_obj.batch_buffer ) )
+    {
+        max_len = sizeof( relay_rx_obj.batch_buffer );
+    }
+
+    if( ( uint32_t ) ( relay_rx_obj.batch_len + 1 + data_len ) > max_len )
+    {
+        if( relay_rx_obj.batch_count > 0 )
+        {
+            // No room left at the current datarate, the queued uplinks go first and this one starts a new batch
+            SMTC_MODEM_HAL_TRACE_PRINTF( "Relay batch full (%d uplinks)\n", relay_rx_obj.batch_count );
+            lorawan_relay_rx_service_batch_take( );
+            relay_rx_obj.service_state = SERVICE_FWD_BATCH_UL;
+
+            relay_rx_obj.batch_buffer[0] = data_len;
+            memcpy( &relay_rx_obj.batch_buffer[1], data, data_len );
+            relay_rx_obj.batch_len     = 1 + data_len;
+            relay_rx_obj.batch_count   = 1;
+            relay_rx_obj.batch_first_s = smtc_modem_hal_get_time_in_s( );
+        }
+        else
+        {
+            // Too long to be aggregated, forwarded with the standard format
+            memcpy( relay_rx_obj.buffer, data, data_len );
+            relay_rx_obj.buffer_len    = data_len;
+            relay_rx_obj.fport         = FPORT_RELAY;
+            relay_rx_obj.time_to_tx    = time_tx;
+            relay_rx_obj.service_state = SERVICE_FWD_FWD_UL;
+        }
+    }
+    else
+    {
+        if( relay_rx_obj.batch_count == 0 )
+        {
+            relay_rx_obj.batch_first_s = smtc_modem_hal_get_time_in_s( );
+        }
+        relay_rx_obj.batch_buffer[relay_rx_obj.batch_len] = data_len;
+        memcpy( &relay_rx_obj.batch_buffer[relay_rx_obj.batch_len + 1], data, data_len );
+        relay_rx_obj.batch_len += 1 + data_len;
+        relay_rx_obj.batch_count += 1;
+
+        if( ( max_len - relay_rx_obj.batch_len ) >= RELAY_FWD_BATCH_MIN_ENTRY )
+        {
+            // Room for another uplink, the relay goes on listening
+            if( relay_rx_obj.batch_count == 1 )
+            {
+                lorawan_relay_rx_service_batch_schedule( stack_id );
+            }
+            relay_start( );
+            return;
+        }
+
+        // Full, sent right away so the last end-device still gets its downlink on RxR
+        lorawan_relay_rx_service_batch_take( );
+        relay_rx_obj.time_to_tx    = time_tx;
+        relay_rx_obj.service_state = SERVICE_FWD_FWD_UL;
+    }
+
+    smodem_task task_relay = {
+        .id                = relay_rx_obj.task_id,
+        .stack_id          = stack_id,
+        .priority          = TASK_HIGH_PRIORITY,
+        .time_to_execute_s = smtc_modem_hal_get_time_in_s( ),
+    };
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_supervisor_add_task( &task_relay ) == TASK_VALID );
+    relay_stop( true );
+}
+
+static void lorawan_relay_rx_service_batch_take( void )
+{
+    memcpy( relay_rx_obj.buffer, relay_rx_obj.batch_buffer, relay_rx_obj.batch_len );
+    relay_rx_obj.buffer_len  = relay_rx_obj.batch_len;
+    relay_rx_obj.fport       = FPORT_RELAY_FWD_BATCH;
+    relay_rx_obj.batch_len   = 0;
+    relay_rx_obj.batch_count = 0;
+}
+
+static void lorawan_relay_rx_service_batch_schedule( uint8_t stack_id )
+{
+    smodem_task task_relay = {
+        .id                = relay_rx_obj.task_id,
+        .stack_id          = stack_id,
+        .priority          = TASK_HIGH_PRIORITY,
+        .time_to_execute_s = relay_rx_obj.batch_first_s + RELAY_FWD_BATCH_MAX_LATENCY_S,
+    };
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_supervisor_add_task( &task_relay ) == TASK_VALID );
+}
+#endif
+
 /* --- EOF ------------------------------------------------------------------ */
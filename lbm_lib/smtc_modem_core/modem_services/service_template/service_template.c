@@ -46,6 +46,7 @@
 #include "smtc_modem_hal.h"
 #include "smtc_modem_hal_dbg_trace.h"
 #include "lorawan_api.h"
+#include "modem_async.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -103,11 +104,21 @@ static lorawan_template_t lorawan_template_obj;
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+// Service sequence, resumed by the supervisor events it awaits
+static modem_async_t lorawan_template_async;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+/**
+ * @brief Service sequence, the state kept across the awaits is stored in lorawan_template_obj
+ *
+ * @param async
+ */
+static void lorawan_template_run( modem_async_t* async );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -126,26 +137,31 @@ void lorawan_template_services_init( uint8_t* service_id, uint8_t task_id,
     lorawan_template_obj.stack_id    = CURRENT_STACK;
     lorawan_template_obj.enabled     = false;
     lorawan_template_obj.initialized = true;
+    modem_async_init( &lorawan_template_async, lorawan_template_run, task_id, CURRENT_STACK, TASK_LOW_PRIORITY,
+                      NULL );
 }
 
 void lorawan_template_service_on_launch( void* context )
 {
     IS_SERVICE_INITIALIZED( );
+    modem_async_on_launch( &lorawan_template_async );
 }
 
 void lorawan_template_service_on_update( void* context )
 {
     IS_SERVICE_INITIALIZED( );
+    modem_async_on_update( &lorawan_template_async );
 }
 
 uint8_t lorawan_template_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
 {
-    return MODEM_DOWNLINK_UNCONSUMED;
+    return modem_async_on_downlink( &lorawan_template_async, rx_down_data );
 }
 void lorawan_template_add_task( uint8_t stack_id )
 {
     IS_VALID_STACK_ID( stack_id );
     IS_SERVICE_INITIALIZED( );
+    modem_async_start( &lorawan_template_async );
 }
 
 /*
@@ -153,4 +169,16 @@ void lorawan_template_add_task( uint8_t stack_id )
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static void lorawan_template_run( modem_async_t* async )
+{
+    MODEM_ASYNC_BEGIN( async );
+    lorawan_template_obj.enabled = true;
+    // Wait for the task launch, an uplink is requested from there to tx_protocol_manager_request()
+    MODEM_ASYNC_AWAIT_TIME( async, 0 );
+    // Wait for the uplink to be sent and its receive windows closed
+    MODEM_ASYNC_AWAIT_TX_DONE( async );
+    lorawan_template_obj.enabled = false;
+    MODEM_ASYNC_END( async );
+}
+
 /* --- EOF ------------------------------------------------------------------ */
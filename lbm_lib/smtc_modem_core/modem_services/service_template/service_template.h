@@ -89,7 +89,7 @@ typedef struct lorawan_template_s
  *
  * @param service_id
  * @param task_id
- * @param downlink_callback
+ * @param downlink_callback  Downlink handler, set to NULL when the service does not parse downlinks
  * @param on_launch_callback
  * @param on_update_callback
  * @return bool
@@ -376,7 +376,7 @@ static void store_and_forward_service_on_launch( void* service_id )
 
     if( store_and_forward_obj[idx].sending_data_len > 0 )
     {
-        status_lorawan_t send_status = tx_protocol_manager_request (TX_PROTOCOL_TRANSMIT_LORA,
+        status_lorawan_t send_status = tx_protocol_manager_request (TX_PROTOCOL_TRANSMIT_LORA_BULK,
             store_and_forward_obj[idx].sending_metadata.fport, true, store_and_forward_obj[idx].sending_data,
             store_and_forward_obj[idx].sending_data_len,
             ( store_and_forward_obj[idx].sending_metadata.confirmed == true ) ? CONF_DATA_UP : UNCONF_DATA_UP, rtc_ms,
@@ -46,6 +46,7 @@
 #include "modem_supervisor_light.h"
 #include "lorawan_api.h"
 #include "store_and_forward_flash.h"
+#include "modem_perf_counters.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -60,12 +61,68 @@
 /**
  * @brief Version of data structure in FiFo
  */
-#define LOG_ENTRY_VERSION ( 1 )
+#define LOG_ENTRY_VERSION ( 4 )
 
 /**
  * @brief data length in byte in FiFo
  */
-#define DATA_SIZE_MAX ( 51 )  // ( SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH )
+#define DATA_SIZE_MAX ( SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH )
+
+/**
+ * @brief Size of an entry without data, entries are stored with their actual data length
+ */
+#define ENTRY_HEADER_SIZE ( offsetof( store_and_forward_flash_data_t, data ) )
+
+/**
+ * @brief Version byte starting every aggregated uplink
+ *
+ * Aggregated uplink layout: version (1 byte), age in seconds of the first entry at transmission (varint) followed by
+ * entries. An entry is:
+ *  - fport (1 byte)
+ *  - seconds elapsed since the previous entry was stored (varint, 0 for the first entry)
+ *  - length (1 byte) followed by the entry data
+ *
+ * Varints are little endian base 128: 7 bits per byte, bit 7 set when another byte follows
+ */
+#define AGGREGATION_VERSION ( 1 )
+
+/**
+ * @brief Maximum varint length of a 32-bit value
+ */
+#define AGGREGATION_VARINT_SIZE_MAX ( 5 )
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+/**
+ * @brief Version byte starting every FEC uplink
+ *
+ * FEC uplink layout: version (1 byte), block number (1 byte), index (1 byte) followed by:
+ *  - data uplink (index bit 7 cleared, bits 0-6 data index in the block): the unit
+ *  - parity uplink (index bit 7 set, bits 0-6 parity index): number of data uplinks in the block (1 byte) followed by
+ *    the xor of the units it covers, zero padded to the longest one
+ *
+ * A unit is the fport (1 byte) and the length (1 byte) of the payload that would have been sent without FEC, followed
+ * by this payload. Parity 0 covers all the units of the block, parity r > 0 covers the unit i when bit 0 of the
+ * (i + 1)th iteration of prbs23 seeded with ( block << 8 ) | r is set
+ */
+#define FEC_VERSION ( 1 )
+
+/**
+ * @brief Size of the FEC uplink header and of the unit header
+ */
+#define FEC_DATA_HEADER_SIZE ( 3 )
+#define FEC_PARITY_HEADER_SIZE ( 4 )
+#define FEC_UNIT_HEADER_SIZE ( 2 )
+
+/**
+ * @brief Index bit of the parity uplinks
+ */
+#define FEC_INDEX_PARITY ( 0x80 )
+
+/**
+ * @brief Value of fec_parity_next while the block is open
+ */
+#define FEC_BLOCK_OPEN ( 0xFF )
+#endif
 
 /**
  * @brief Acknowledgment requested every N send
@@ -135,19 +192,15 @@
  */
 
 /**
- * @brief  Data structure stored in NVM slot
+ * @brief  Data structure stored in NVM record, only the first ENTRY_HEADER_SIZE + data length bytes are stored
  */
 typedef struct store_and_forward_data_s
 {
-    uint8_t  data[DATA_SIZE_MAX];
-    uint8_t  data_len;
     uint8_t  fport;
     bool     confirmed;
-    uint16_t crc;  // !! crc MUST be the last field of the structure !!
-
-#if( ( ( DATA_SIZE_MAX + 5 ) % 8 ) != 0 )
-    uint8_t padding[( ( DATA_SIZE_MAX + 5 ) % 8 )];
-#endif
+    uint16_t crc;  // computed over the stored bytes with crc set to 0
+    uint32_t timestamp_s;
+    uint8_t  data[DATA_SIZE_MAX];
 } store_and_forward_flash_data_t;
 
 /**
@@ -161,12 +214,28 @@ typedef struct store_and_forward_flash_s
     uint8_t                         task_id;
     store_and_forward_flash_state_t enabled;
     bool                            initialized;
+    bool                            mounted;  // filesystem scanned, or formatted
 
     uint32_t sending_first_try_timestamp_s;
     uint32_t sending_try_cpt;
     bool     sending_with_ack;
     uint8_t  ack_period_count;
 
+    bool    aggregation_enabled;
+    uint8_t aggregation_fport;
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+    bool    fec_enabled;
+    uint8_t fec_fport;
+    uint8_t fec_nb_data;
+    uint8_t fec_nb_parity;
+    uint8_t fec_block;
+    uint8_t fec_index;        // data uplinks sent in the current block
+    uint8_t fec_parity_next;  // next parity uplink to send, FEC_BLOCK_OPEN while data are sent
+    // length of each parity, 0 if it covers no unit
+    uint8_t fec_parity_len[STORE_AND_FORWARD_FLASH_FEC_NB_PARITY_MAX];
+#endif
+
     struct circularfs fs;
 
 } store_and_forward_flash_t;
@@ -178,6 +247,11 @@ typedef struct store_and_forward_flash_s
 
 static store_and_forward_flash_t         store_and_forward_flash_obj[NUMBER_MAX_OF_STORE_AND_FORWARD_OBJ];
 static struct circularfs_flash_partition flash_obj;
+static uint8_t                           aggregation_frame[SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH];
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+static uint8_t fec_frame[SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH];
+static uint8_t fec_parity[STORE_AND_FORWARD_FLASH_FEC_NB_PARITY_MAX][SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH];
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -231,6 +305,13 @@ static store_and_forward_flash_t* store_and_forward_flash_get_ctx_from_stack_id(
  */
 static uint32_t store_and_forward_flash_compute_next_delay_s( store_and_forward_flash_t* ctx );
 
+/**
+ * @brief Scan the filesystem, or format it if no valid one is found, unless it is already done
+ *
+ * @param [in] ctx Store and forward object
+ */
+static void store_and_forward_flash_mount( store_and_forward_flash_t* ctx );
+
 /**
  * @brief Erase sector in flash
  *
@@ -272,6 +353,97 @@ static int32_t op_read( struct circularfs_flash_partition* flash, uint32_t addre
  */
 static uint32_t crc_store_and_fwd( const uint8_t* buf, int len );
 
+/**
+ * @brief Compute the crc of a stored entry
+ *
+ * @param [in] entry        entry, its crc field is ignored
+ * @param [in] entry_len    stored entry length
+ * @return [out] uint16_t   computed crc
+ */
+static uint16_t store_and_forward_flash_entry_crc( const store_and_forward_flash_data_t* entry, int32_t entry_len );
+
+/**
+ * @brief Fetch the next entry with a valid crc
+ *
+ * @param [in]  ctx         service context
+ * @param [in]  fetch       true to fetch the entry, false to only read it
+ * @param [out] entry       entry
+ * @param [out] data_len    entry data length
+ * @return true if an entry was read
+ */
+static bool store_and_forward_flash_read_entry( store_and_forward_flash_t* ctx, bool fetch,
+                                                store_and_forward_flash_data_t* entry, uint8_t* data_len );
+
+/**
+ * @brief Pack the first fetched entry and the next entries fitting in the uplink into an aggregated frame
+ *
+ * @param [in]  ctx         service context
+ * @param [in]  first       first entry, already fetched
+ * @param [in]  first_len   first entry data length
+ * @param [in]  max_len     maximum uplink payload length
+ * @param [out] frame       aggregated frame
+ * @param [out] confirmed   true if one of the entries is confirmed
+ * @return aggregated frame length, 0 if no other entry fits with the first one (nothing else is fetched)
+ */
+static uint8_t store_and_forward_flash_aggregate( store_and_forward_flash_t*            ctx,
+                                                  const store_and_forward_flash_data_t* first, uint8_t first_len,
+                                                  uint8_t max_len, uint8_t* frame, bool* confirmed );
+
+/**
+ * @brief Encode a varint
+ *
+ * @param [out] buffer  output buffer, NULL to only get the length
+ * @param [in]  value   value to encode
+ * @return encoded length
+ */
+static uint8_t store_and_forward_flash_put_varint( uint8_t* buffer, uint32_t value );
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+/**
+ * @brief Start a new FEC block, the parity of the previous one is dropped
+ *
+ * @param [in] ctx  service context
+ */
+static void store_and_forward_flash_fec_new_block( store_and_forward_flash_t* ctx );
+
+/**
+ * @brief Check if a parity uplink covers a data uplink
+ *
+ * @param [in] block    block number
+ * @param [in] parity   parity index
+ * @param [in] index    data index
+ * @return true if the unit of the data uplink is in the parity
+ */
+static bool store_and_forward_flash_fec_covers( uint8_t block, uint8_t parity, uint8_t index );
+
+/**
+ * @brief Build the FEC data uplink of a payload in fec_frame
+ *
+ * @param [in] ctx          service context
+ * @param [in] fport        FPort the payload would have been sent on
+ * @param [in] payload      payload
+ * @param [in] payload_len  payload length
+ * @return FEC uplink length
+ */
+static uint8_t store_and_forward_flash_fec_build_data( store_and_forward_flash_t* ctx, uint8_t fport,
+                                                       const uint8_t* payload, uint8_t payload_len );
+
+/**
+ * @brief Add the unit of the FEC data uplink sent from fec_frame to the parity, and close the block when full
+ *
+ * @param [in] ctx  service context
+ */
+static void store_and_forward_flash_fec_commit_data( store_and_forward_flash_t* ctx );
+
+/**
+ * @brief Send the next parity uplink of a closed block, the data of the block are deleted after the last one
+ *
+ * @param [in] ctx      service context
+ * @param [in] rtc_ms   current time
+ */
+static void store_and_forward_flash_fec_send_parity( store_and_forward_flash_t* ctx, uint32_t rtc_ms );
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -301,26 +473,27 @@ void store_and_forward_flash_services_init( uint8_t* service_id, uint8_t task_id
     ctx->stack_id    = CURRENT_STACK;
     ctx->enabled     = false;
     ctx->initialized = true;
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+    ctx->fec_parity_next = FEC_BLOCK_OPEN;
+#endif
 
     /* Always call circularfs_init first. */
-    circularfs_init( &ctx->fs, &flash_obj, LOG_ENTRY_VERSION, sizeof( store_and_forward_flash_data_t ) );
+    if( circularfs_init( &ctx->fs, &flash_obj, LOG_ENTRY_VERSION, sizeof( store_and_forward_flash_data_t ) ) != 0 )
+    {
+        // The partition does not fit in the filesystem (more than CIRCULARFS_SECTOR_COUNT_MAX pages): the service is
+        // left not initialized, it is never mounted and can not be enabled
+        SMTC_MODEM_HAL_TRACE_ERROR( "Store and fwd # %u pages not supported, service disabled\n",
+                                    flash_obj.sector_count );
+        ctx->initialized = false;
+        return;
+    }
     // SMTC_MODEM_HAL_TRACE_PRINTF( "# format filesystem...\n" );
     // circularfs_format( &ctx->fs );
 
+#if !defined( ADD_SMTC_FAST_BOOT )
     /* Scan and/or format before any data operations. */
-    SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # scanning for filesystem...\n" );
-    if( circularfs_scan( &ctx->fs ) == 0 )
-    {
-        SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # found existing filesystem, usage: %d/%d\n",
-                                     circularfs_count_estimate( &ctx->fs ), circularfs_capacity( &ctx->fs ) );
-    }
-    else
-    {
-        SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # no valid filesystem found, formatting.\n" );
-        circularfs_format( &ctx->fs, false );
-    }
-
-    circularfs_dump( &ctx->fs );
+    store_and_forward_flash_mount( ctx );
+#endif
 }
 
 store_and_forward_flash_rc_t store_and_forward_flash_set_state( uint8_t                         stack_id,
@@ -330,7 +503,7 @@ store_and_forward_flash_rc_t store_and_forward_flash_set_state( uint8_t
     uint8_t                    service_id;
     store_and_forward_flash_t* ctx = store_and_forward_flash_get_ctx_from_stack_id( stack_id, &service_id );
 
-    if( ctx == NULL )
+    if( ( ctx == NULL ) || ( ctx->initialized == false ) )
     {
         return STORE_AND_FORWARD_FLASH_RC_INVALID;
     }
@@ -346,6 +519,7 @@ store_and_forward_flash_rc_t store_and_forward_flash_set_state( uint8_t
 
         if( enabled == STORE_AND_FORWARD_ENABLE )
         {
+            store_and_forward_flash_mount( ctx );
             ctx->sending_first_try_timestamp_s = 0;
             ctx->sending_try_cpt               = 0;
             if( ( lorawan_api_isjoined( ctx->stack_id ) == JOINED ) && ( circularfs_count_estimate( &ctx->fs ) > 0 ) )
@@ -379,6 +553,8 @@ store_and_forward_flash_rc_t store_and_forward_flash_add_data( uint8_t stack_id,
         return STORE_AND_FORWARD_FLASH_RC_INVALID;
     }
 
+    store_and_forward_flash_mount( ctx );
+
     if( ( fport == 0 ) || ( fport >= 224 ) )
     {
         return STORE_AND_FORWARD_FLASH_RC_INVALID;
@@ -391,14 +567,15 @@ store_and_forward_flash_rc_t store_and_forward_flash_add_data( uint8_t stack_id,
     }
 #endif
 
-    store_and_forward_flash_data_t entry = { 0 };
+    store_and_forward_flash_data_t entry     = { 0 };
+    int32_t                        entry_len = ENTRY_HEADER_SIZE + payload_length;
     memcpy( entry.data, payload, payload_length );
-    entry.data_len  = payload_length;
-    entry.fport     = fport;
-    entry.confirmed = confirmed;
-    entry.crc       = crc_store_and_fwd( ( uint8_t* ) &entry, sizeof( entry ) - sizeof( entry.crc ) ) & 0xFFFF;
+    entry.fport       = fport;
+    entry.confirmed   = confirmed;
+    entry.timestamp_s = smtc_modem_hal_get_time_in_s( );
+    entry.crc         = store_and_forward_flash_entry_crc( &entry, entry_len );
 
-    if( circularfs_append( &ctx->fs, &entry ) != 0 )
+    if( circularfs_append( &ctx->fs, &entry, entry_len ) != 0 )
     {
         SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd fifo problem\n" );
         return STORE_AND_FORWARD_FLASH_RC_FAIL;
@@ -426,9 +603,54 @@ void store_and_forward_flash_clear_data( uint8_t stack_id )
     uint8_t                    service_id;
     store_and_forward_flash_t* ctx = store_and_forward_flash_get_ctx_from_stack_id( stack_id, &service_id );
 
+    if( ( ctx == NULL ) || ( ctx->initialized == false ) )
+    {
+        return;
+    }
+
     SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # format filesystem...\n" );
     circularfs_format( &ctx->fs, true );
+    ctx->mounted = true;
+}
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_PRE_ERASE )
+void store_and_forward_flash_pre_erase_on_idle( uint32_t sleep_time_ms )
+{
+    // A page erase must not delay a radio task: it waits for a gap in the radio planner timeline
+    if( ( sleep_time_ms < STORE_AND_FORWARD_FLASH_PRE_ERASE_IDLE_MS ) ||
+        ( rp_get_next_task_delay_ms( modem_get_rp( ) ) < STORE_AND_FORWARD_FLASH_PRE_ERASE_RADIO_GUARD_MS ) )
+    {
+        return;
+    }
+
+    // At most one page erase by idle period
+    for( uint8_t i = 0; i < NUMBER_MAX_OF_STORE_AND_FORWARD_OBJ; i++ )
+    {
+        if( ( store_and_forward_flash_obj[i].mounted == true ) &&
+            ( circularfs_pre_erase( &store_and_forward_flash_obj[i].fs ) != 0 ) )
+        {
+            return;
+        }
+    }
 }
+#endif
+
+#if defined( ADD_SMTC_FAST_BOOT )
+void store_and_forward_flash_mount_on_idle( uint32_t sleep_time_ms )
+{
+    // A sector found partially erased is erased by the scan, which must not delay a radio task
+    if( ( sleep_time_ms < STORE_AND_FORWARD_FLASH_MOUNT_IDLE_MS ) ||
+        ( rp_get_next_task_delay_ms( modem_get_rp( ) ) < STORE_AND_FORWARD_FLASH_MOUNT_RADIO_GUARD_MS ) )
+    {
+        return;
+    }
+
+    for( uint8_t i = 0; i < NUMBER_MAX_OF_STORE_AND_FORWARD_OBJ; i++ )
+    {
+        store_and_forward_flash_mount( &store_and_forward_flash_obj[i] );
+    }
+}
+#endif
 
 struct circularfs* store_and_forward_flash_get_fs_object( uint8_t stack_id )
 {
@@ -436,8 +658,9 @@ struct circularfs* store_and_forward_flash_get_fs_object( uint8_t stack_id )
     uint8_t                    service_id;
     store_and_forward_flash_t* ctx = store_and_forward_flash_get_ctx_from_stack_id( stack_id, &service_id );
 
-    if( ctx != NULL )
+    if( ( ctx != NULL ) && ( ctx->initialized == true ) )
     {
+        store_and_forward_flash_mount( ctx );
         return &ctx->fs;
     }
 
@@ -451,11 +674,12 @@ store_and_forward_flash_rc_t store_and_forward_flash_get_number_of_free_slot( ui
     uint8_t                    service_id;
     store_and_forward_flash_t* ctx = store_and_forward_flash_get_ctx_from_stack_id( stack_id, &service_id );
 
-    if( ctx == NULL )
+    if( ( ctx == NULL ) || ( ctx->initialized == false ) )
     {
         return STORE_AND_FORWARD_FLASH_RC_INVALID;
     }
 
+    store_and_forward_flash_mount( ctx );
     *capacity  = circularfs_capacity( &ctx->fs );
     *free_slot = circularfs_free_slot_estimate( &ctx->fs );
     return STORE_AND_FORWARD_FLASH_RC_OK;
@@ -471,6 +695,82 @@ store_and_forward_flash_state_t store_and_forward_flash_get_state( uint8_t stack
     return ctx->enabled;
 }
 
+store_and_forward_flash_rc_t store_and_forward_flash_set_aggregation( uint8_t stack_id, bool enabled, uint8_t fport )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t                    service_id;
+    store_and_forward_flash_t* ctx = store_and_forward_flash_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx == NULL )
+    {
+        return STORE_AND_FORWARD_FLASH_RC_INVALID;
+    }
+
+    if( enabled == true )
+    {
+        if( ( fport == 0 ) || ( fport >= 224 ) )
+        {
+            return STORE_AND_FORWARD_FLASH_RC_INVALID;
+        }
+
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+        if( fport == cloud_dm_get_dm_port( stack_id ) )
+        {
+            return STORE_AND_FORWARD_FLASH_RC_INVALID;
+        }
+#endif
+    }
+
+    ctx->aggregation_enabled = enabled;
+    ctx->aggregation_fport   = fport;
+    return STORE_AND_FORWARD_FLASH_RC_OK;
+}
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+store_and_forward_flash_rc_t store_and_forward_flash_set_fec( uint8_t stack_id, bool enabled, uint8_t fport,
+                                                              uint8_t nb_data, uint8_t nb_parity )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t                    service_id;
+    store_and_forward_flash_t* ctx = store_and_forward_flash_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx == NULL )
+    {
+        return STORE_AND_FORWARD_FLASH_RC_INVALID;
+    }
+
+    if( enabled == true )
+    {
+        if( ( fport == 0 ) || ( fport >= 224 ) || ( nb_data == 0 ) ||
+            ( nb_data > STORE_AND_FORWARD_FLASH_FEC_NB_DATA_MAX ) || ( nb_parity == 0 ) ||
+            ( nb_parity > STORE_AND_FORWARD_FLASH_FEC_NB_PARITY_MAX ) )
+        {
+            return STORE_AND_FORWARD_FLASH_RC_INVALID;
+        }
+
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+        if( fport == cloud_dm_get_dm_port( stack_id ) )
+        {
+            return STORE_AND_FORWARD_FLASH_RC_INVALID;
+        }
+#endif
+    }
+
+    // The data of an unfinished block are sent again in the new configuration
+    if( ( ctx->fec_enabled == true ) && ( ( ctx->fec_index != 0 ) || ( ctx->fec_parity_next != FEC_BLOCK_OPEN ) ) )
+    {
+        circularfs_rewind( &ctx->fs );
+    }
+
+    ctx->fec_enabled   = enabled;
+    ctx->fec_fport     = fport;
+    ctx->fec_nb_data   = nb_data;
+    ctx->fec_nb_parity = nb_parity;
+    store_and_forward_flash_fec_new_block( ctx );
+    return STORE_AND_FORWARD_FLASH_RC_OK;
+}
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
@@ -496,54 +796,100 @@ static void store_and_forward_flash_service_on_launch( void* service_id )
         return;
     }
 
-    bool     is_crc_ok    = false;
-    int32_t  fetch_status = -1;
-    uint32_t rtc_ms       = smtc_modem_hal_get_time_in_ms( );
+    bool     is_crc_ok = false;
+    uint32_t rtc_ms    = smtc_modem_hal_get_time_in_ms( );
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+    // The parity uplinks of a closed block are sent before the next data
+    if( ( store_and_forward_flash_obj[idx].fec_enabled == true ) &&
+        ( store_and_forward_flash_obj[idx].fec_parity_next != FEC_BLOCK_OPEN ) )
+    {
+        store_and_forward_flash_fec_send_parity( &store_and_forward_flash_obj[idx], rtc_ms );
+        return;
+    }
+#endif
 
     // TODO check payload len and adjust the datarate with custom profile
     // uint8_t max_payload = lorawan_api_next_max_payload_length_get( stack_id );
 
-    store_and_forward_flash_data_t entry = { 0 };
+    store_and_forward_flash_data_t entry    = { 0 };
+    uint8_t                        data_len = 0;
 
     // circularfs_dump( &store_and_forward_flash_obj[idx].fs );
 
-    // While there are available data and a wrong CRC get the next data
-    do
+    // Get the next data with a right CRC
+    is_crc_ok = store_and_forward_flash_read_entry( &store_and_forward_flash_obj[idx], true, &entry, &data_len );
+    if( is_crc_ok == true )
     {
-        fetch_status = circularfs_fetch( &store_and_forward_flash_obj[idx].fs, &entry );
-        if( fetch_status == 0 )
+        if( store_and_forward_flash_obj[idx].sending_try_cpt == 0 )
         {
-            if( ( crc_store_and_fwd( ( uint8_t* ) &entry, sizeof( entry ) - sizeof( entry.crc ) ) & 0xFFFF ) ==
-                entry.crc )
-            {
-                is_crc_ok = true;
-                if( store_and_forward_flash_obj[idx].sending_try_cpt == 0 )
-                {
-                    store_and_forward_flash_obj[idx].sending_first_try_timestamp_s = rtc_ms / 1000;
-                }
+            store_and_forward_flash_obj[idx].sending_first_try_timestamp_s = rtc_ms / 1000;
+        }
 
 #if( MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON )
-                int32_t capacity  = circularfs_capacity( &store_and_forward_flash_obj[idx].fs );
-                int32_t free_slot = circularfs_free_slot_estimate( &store_and_forward_flash_obj[idx].fs );
-                SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd get data, free: %d/%d \n", free_slot, capacity );
+        int32_t capacity  = circularfs_capacity( &store_and_forward_flash_obj[idx].fs );
+        int32_t free_slot = circularfs_free_slot_estimate( &store_and_forward_flash_obj[idx].fs );
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd get data, free: %d/%d \n", free_slot, capacity );
 #endif
-            }
-            else
+    }
+    else
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd no data !\n" );
+    }
+
+    if( ( data_len > 0 ) && ( is_crc_ok == true ) )
+    {
+        uint8_t  fport       = entry.fport;
+        uint8_t* payload     = entry.data;
+        uint8_t  payload_len = data_len;
+        bool     confirmed   = entry.confirmed;
+        bool     fec_data    = false;
+
+        uint32_t max_payload = lorawan_api_next_max_payload_length_get( stack_id );
+        if( max_payload > SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH )
+        {
+            max_payload = SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH;
+        }
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+        // Keep room for the FEC headers
+        if( store_and_forward_flash_obj[idx].fec_enabled == true )
+        {
+            max_payload = ( max_payload > ( FEC_DATA_HEADER_SIZE + FEC_UNIT_HEADER_SIZE ) )
+                              ? ( max_payload - FEC_DATA_HEADER_SIZE - FEC_UNIT_HEADER_SIZE )
+                              : 0;
+        }
+#endif
+
+        // Pack the next entries with this one when they fit in the next uplink
+        if( store_and_forward_flash_obj[idx].aggregation_enabled == true )
+        {
+            uint8_t frame_len = store_and_forward_flash_aggregate( &store_and_forward_flash_obj[idx], &entry, data_len,
+                                                                   max_payload, aggregation_frame, &confirmed );
+            if( frame_len > 0 )
             {
-                SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd corrupted data, bad CRC !\n" );
+                fport       = store_and_forward_flash_obj[idx].aggregation_fport;
+                payload     = aggregation_frame;
+                payload_len = frame_len;
             }
         }
-        else
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+        // The parity replaces the acknowledgment of the data sent in a FEC block
+        if( ( store_and_forward_flash_obj[idx].fec_enabled == true ) && ( payload_len <= max_payload ) )
         {
-            SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd no data !\n" );
+            payload_len = store_and_forward_flash_fec_build_data( &store_and_forward_flash_obj[idx], fport, payload,
+                                                                  payload_len );
+            payload     = fec_frame;
+            fport       = store_and_forward_flash_obj[idx].fec_fport;
+            confirmed   = false;
+            fec_data    = true;
         }
-    } while( ( fetch_status == 0 ) && ( is_crc_ok == false ) );
+#endif
 
-    if( ( entry.data_len > 0 ) && ( is_crc_ok == true ) )
-    {
-        store_and_forward_flash_obj[idx].sending_with_ack = entry.confirmed;
+        store_and_forward_flash_obj[idx].sending_with_ack = confirmed;
 
-        if( store_and_forward_flash_obj[idx].ack_period_count >= STORE_AND_FORWARD_ACK_PERIOD )
+        if( ( store_and_forward_flash_obj[idx].ack_period_count >= STORE_AND_FORWARD_ACK_PERIOD ) &&
+            ( fec_data == false ) )
         {
             store_and_forward_flash_obj[idx].sending_with_ack = true;
         }
@@ -574,7 +920,7 @@ static void store_and_forward_flash_service_on_launch( void* service_id )
 #endif
 
         status_lorawan_t send_status = tx_protocol_manager_request(
-            TX_PROTOCOL_TRANSMIT_LORA, entry.fport, true, entry.data, entry.data_len,
+            TX_PROTOCOL_TRANSMIT_LORA_BULK, fport, true, payload, payload_len,
             ( store_and_forward_flash_obj[idx].sending_with_ack == true ) ? CONF_DATA_UP : UNCONF_DATA_UP, rtc_ms,
             stack_id );
 
@@ -585,10 +931,24 @@ static void store_and_forward_flash_service_on_launch( void* service_id )
             {
                 store_and_forward_flash_obj[idx].ack_period_count++;
             }
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+            if( fec_data == true )
+            {
+                store_and_forward_flash_fec_commit_data( &store_and_forward_flash_obj[idx] );
+            }
+#endif
         }
         else
         {
             SMTC_MODEM_HAL_TRACE_WARNING( " %s service_id %d data not send 0x%x\n", __func__, idx, send_status );
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+            // The data of the block are fetched but not all sent: send them again in a new block
+            if( fec_data == true )
+            {
+                circularfs_rewind( &store_and_forward_flash_obj[idx].fs );
+                store_and_forward_flash_fec_new_block( &store_and_forward_flash_obj[idx] );
+            }
+#endif
         }
         SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd try (%u) to send \n",
                                      store_and_forward_flash_obj[idx].sending_try_cpt );
@@ -626,6 +986,23 @@ static void store_and_forward_flash_service_on_update( void* service_id )
 
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( "Store and fwd nb_of_data not read:%u\n", nb_of_data );
 
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+    // Close the block when the fifo is empty rather than waiting for more data to protect
+    if( store_and_forward_flash_obj[idx].fec_enabled == true )
+    {
+        if( ( store_and_forward_flash_obj[idx].fec_parity_next == FEC_BLOCK_OPEN ) &&
+            ( store_and_forward_flash_obj[idx].fec_index > 0 ) && ( nb_of_data == 0 ) )
+        {
+            store_and_forward_flash_obj[idx].fec_parity_next = 0;
+        }
+        if( store_and_forward_flash_obj[idx].fec_parity_next != FEC_BLOCK_OPEN )
+        {
+            store_and_forward_flash_add_task( &store_and_forward_flash_obj[idx], MODEM_TASK_DELAY_MS / 1000 );
+            return;
+        }
+    }
+#endif
+
     if( ( nb_of_data > 0 ) || store_and_forward_flash_obj[idx].sending_try_cpt != 0 )
     {
         uint32_t delay_tmp_s = store_and_forward_flash_compute_next_delay_s( &store_and_forward_flash_obj[idx] );
@@ -643,6 +1020,12 @@ static uint8_t store_and_forward_flash_service_downlink_handler( lr1_stack_mac_d
 
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s\n", __func__ );
 
+    if( ctx->mounted == false )
+    {
+        // Filesystem not scanned yet (ADD_SMTC_FAST_BOOT): the service was not used since the reset
+        return MODEM_DOWNLINK_UNCONSUMED;
+    }
+
     task_id_t current_task_id = modem_supervisor_get_task( )->next_task_id;
     // If a downlink is received outside the running service, the downlink is not an ack but there is network
     // coverage
@@ -683,6 +1066,13 @@ static uint8_t store_and_forward_flash_service_downlink_handler( lr1_stack_mac_d
                     SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd uplink not yet acked after %u tentative\n",
                                                  ctx->sending_try_cpt );
                     circularfs_rewind( &ctx->fs );
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+                    // The data of the open FEC block are fetched again
+                    if( ctx->fec_enabled == true )
+                    {
+                        store_and_forward_flash_fec_new_block( ctx );
+                    }
+#endif
                 }
             }
         }
@@ -707,6 +1097,29 @@ static store_and_forward_flash_t* store_and_forward_flash_get_ctx_from_stack_id(
     return ctx;
 }
 
+static void store_and_forward_flash_mount( store_and_forward_flash_t* ctx )
+{
+    if( ( ctx->initialized == false ) || ( ctx->mounted == true ) )
+    {
+        return;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # scanning for filesystem...\n" );
+    if( circularfs_scan( &ctx->fs ) == 0 )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # found existing filesystem, usage: %d/%d\n",
+                                     circularfs_count_estimate( &ctx->fs ), circularfs_capacity( &ctx->fs ) );
+    }
+    else
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd # no valid filesystem found, formatting.\n" );
+        circularfs_format( &ctx->fs, false );
+    }
+
+    circularfs_dump( &ctx->fs );
+    ctx->mounted = true;
+}
+
 static void store_and_forward_flash_add_task( store_and_forward_flash_t* ctx, uint32_t delay_to_execute_s )
 {
     // If service not enabled -> exit
@@ -743,6 +1156,7 @@ static int32_t op_sector_erase( struct circularfs_flash_partition* flash, uint32
 {
     ( void ) flash;
     smtc_modem_hal_context_flash_pages_erase( CONTEXT_STORE_AND_FORWARD, address, 1 );
+    MODEM_PERF_COUNTER_ADD( MODEM_PERF_FLASH_ERASE_NB, 1 );
     return 0;
 }
 
@@ -778,4 +1192,236 @@ static uint32_t crc_store_and_fwd( const uint8_t* buf, int len )
     }
     return ~crc;
 }
+
+static uint16_t store_and_forward_flash_entry_crc( const store_and_forward_flash_data_t* entry, int32_t entry_len )
+{
+    store_and_forward_flash_data_t tmp = *entry;
+    tmp.crc                            = 0;
+    return crc_store_and_fwd( ( const uint8_t* ) &tmp, entry_len ) & 0xFFFF;
+}
+
+static bool store_and_forward_flash_read_entry( store_and_forward_flash_t* ctx, bool fetch,
+                                                store_and_forward_flash_data_t* entry, uint8_t* data_len )
+{
+    int32_t entry_len = 0;
+
+    // While there are available data and a wrong CRC skip the data
+    while( circularfs_peek( &ctx->fs, entry, &entry_len ) == 0 )
+    {
+        if( ( entry_len > ( int32_t ) ENTRY_HEADER_SIZE ) &&
+            ( store_and_forward_flash_entry_crc( entry, entry_len ) == entry->crc ) )
+        {
+            *data_len = entry_len - ENTRY_HEADER_SIZE;
+            if( fetch == true )
+            {
+                circularfs_fetch( &ctx->fs, entry, &entry_len );
+            }
+            return true;
+        }
+
+        SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd corrupted data, bad CRC !\n" );
+        circularfs_fetch( &ctx->fs, entry, &entry_len );
+    }
+    return false;
+}
+
+static uint8_t store_and_forward_flash_aggregate( store_and_forward_flash_t*            ctx,
+                                                  const store_and_forward_flash_data_t* first, uint8_t first_len,
+                                                  uint8_t max_len, uint8_t* frame, bool* confirmed )
+{
+    uint32_t now_s = smtc_modem_hal_get_time_in_s( );
+    // Entries stored before a reset may be in the future of the current time base
+    uint32_t age_s = ( now_s > first->timestamp_s ) ? ( now_s - first->timestamp_s ) : 0;
+
+    // The first entry has a zero delta (1 byte varint)
+    if( ( 1 + store_and_forward_flash_put_varint( NULL, age_s ) + 3 + first_len ) > max_len )
+    {
+        return 0;
+    }
+
+    uint8_t frame_len  = 0;
+    frame[frame_len++] = AGGREGATION_VERSION;
+    frame_len += store_and_forward_flash_put_varint( &frame[frame_len], age_s );
+    frame[frame_len++] = first->fport;
+    frame_len += store_and_forward_flash_put_varint( &frame[frame_len], 0 );
+    frame[frame_len++] = first_len;
+    memcpy( &frame[frame_len], first->data, first_len );
+    frame_len += first_len;
+
+    store_and_forward_flash_data_t next;
+    uint8_t                        next_len          = 0;
+    uint32_t                       previous_s        = first->timestamp_s;
+    uint8_t                        nb_of_entries     = 1;
+    bool                           entries_confirmed = first->confirmed;
+
+    while( store_and_forward_flash_read_entry( ctx, false, &next, &next_len ) == true )
+    {
+        uint32_t delta_s    = ( next.timestamp_s > previous_s ) ? ( next.timestamp_s - previous_s ) : 0;
+        uint16_t entry_size = 2 + store_and_forward_flash_put_varint( NULL, delta_s ) + next_len;
+        if( ( frame_len + entry_size ) > max_len )
+        {
+            break;
+        }
+
+        store_and_forward_flash_read_entry( ctx, true, &next, &next_len );
+        frame[frame_len++] = next.fport;
+        frame_len += store_and_forward_flash_put_varint( &frame[frame_len], delta_s );
+        frame[frame_len++] = next_len;
+        memcpy( &frame[frame_len], next.data, next_len );
+        frame_len += next_len;
+
+        previous_s = next.timestamp_s;
+        entries_confirmed |= next.confirmed;
+        nb_of_entries++;
+    }
+
+    if( nb_of_entries < 2 )
+    {
+        return 0;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd aggregate %u entries in %u bytes\n", nb_of_entries, frame_len );
+    *confirmed = entries_confirmed;
+    return frame_len;
+}
+
+static uint8_t store_and_forward_flash_put_varint( uint8_t* buffer, uint32_t value )
+{
+    uint8_t len = 0;
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if( value != 0 )
+        {
+            byte |= 0x80;
+        }
+        if( buffer != NULL )
+        {
+            buffer[len] = byte;
+        }
+        len++;
+    } while( value != 0 );
+    return len;
+}
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+static void store_and_forward_flash_fec_new_block( store_and_forward_flash_t* ctx )
+{
+    ctx->fec_block++;
+    ctx->fec_index       = 0;
+    ctx->fec_parity_next = FEC_BLOCK_OPEN;
+    memset( ctx->fec_parity_len, 0, sizeof( ctx->fec_parity_len ) );
+    memset( fec_parity, 0, sizeof( fec_parity ) );
+}
+
+static bool store_and_forward_flash_fec_covers( uint8_t block, uint8_t parity, uint8_t index )
+{
+    if( parity == 0 )
+    {
+        return true;
+    }
+
+    // Same generator as the ROSE parity, seeded by the block and the parity number
+    uint32_t x = ( ( uint32_t ) block << 8 ) | parity;
+    for( uint16_t i = 0; i <= index; i++ )
+    {
+        uint32_t b0 = x & 1;
+        uint32_t b1 = ( x & 0x20 ) >> 5;
+        x           = ( x >> 1 ) + ( ( b0 ^ b1 ) << 22 );
+    }
+    return ( x & 1 ) != 0;
+}
+
+static uint8_t store_and_forward_flash_fec_build_data( store_and_forward_flash_t* ctx, uint8_t fport,
+                                                       const uint8_t* payload, uint8_t payload_len )
+{
+    fec_frame[0] = FEC_VERSION;
+    fec_frame[1] = ctx->fec_block;
+    fec_frame[2] = ctx->fec_index;
+    fec_frame[3] = fport;
+    fec_frame[4] = payload_len;
+    memcpy( &fec_frame[FEC_DATA_HEADER_SIZE + FEC_UNIT_HEADER_SIZE], payload, payload_len );
+    return FEC_DATA_HEADER_SIZE + FEC_UNIT_HEADER_SIZE + payload_len;
+}
+
+static void store_and_forward_flash_fec_commit_data( store_and_forward_flash_t* ctx )
+{
+    const uint8_t* unit     = &fec_frame[FEC_DATA_HEADER_SIZE];
+    uint8_t        unit_len = FEC_UNIT_HEADER_SIZE + unit[1];
+
+    for( uint8_t r = 0; r < ctx->fec_nb_parity; r++ )
+    {
+        if( store_and_forward_flash_fec_covers( ctx->fec_block, r, ctx->fec_index ) == true )
+        {
+            for( uint8_t i = 0; i < unit_len; i++ )
+            {
+                fec_parity[r][i] ^= unit[i];
+            }
+            if( ctx->fec_parity_len[r] < unit_len )
+            {
+                ctx->fec_parity_len[r] = unit_len;
+            }
+        }
+    }
+
+    ctx->fec_index++;
+    if( ctx->fec_index >= ctx->fec_nb_data )
+    {
+        ctx->fec_parity_next = 0;
+    }
+}
+
+static void store_and_forward_flash_fec_send_parity( store_and_forward_flash_t* ctx, uint32_t rtc_ms )
+{
+    uint32_t max_payload = lorawan_api_next_max_payload_length_get( ctx->stack_id );
+    if( max_payload > SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH )
+    {
+        max_payload = SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH;
+    }
+
+    while( ctx->fec_parity_next < ctx->fec_nb_parity )
+    {
+        uint8_t r   = ctx->fec_parity_next;
+        uint8_t len = ctx->fec_parity_len[r];
+
+        // A parity uplink that covers no data or that does not fit in the next uplink is dropped
+        if( ( len == 0 ) || ( ( uint32_t ) ( FEC_PARITY_HEADER_SIZE + len ) > max_payload ) )
+        {
+            if( len != 0 )
+            {
+                SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd parity %u of block %u too long\n", r, ctx->fec_block );
+            }
+            ctx->fec_parity_next++;
+            continue;
+        }
+
+        fec_frame[0] = FEC_VERSION;
+        fec_frame[1] = ctx->fec_block;
+        fec_frame[2] = FEC_INDEX_PARITY | r;
+        fec_frame[3] = ctx->fec_index;
+        memcpy( &fec_frame[FEC_PARITY_HEADER_SIZE], fec_parity[r], len );
+
+        ctx->sending_with_ack        = false;
+        status_lorawan_t send_status = tx_protocol_manager_request( TX_PROTOCOL_TRANSMIT_LORA_BULK, ctx->fec_fport,
+                                                                    true, fec_frame, FEC_PARITY_HEADER_SIZE + len,
+                                                                    UNCONF_DATA_UP, rtc_ms, ctx->stack_id );
+        if( send_status == OKLORAWAN )
+        {
+            SMTC_MODEM_HAL_TRACE_PRINTF( "Store and fwd parity %u of block %u sent\n", r, ctx->fec_block );
+            ctx->sending_try_cpt++;
+            ctx->fec_parity_next++;
+        }
+        else
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "Store and fwd parity not send 0x%x\n", send_status );
+        }
+        return;
+    }
+
+    // All the parity of the block is sent, its data are no longer needed
+    circularfs_discard( &ctx->fs );
+    store_and_forward_flash_fec_new_block( ctx );
+}
+#endif
 /* --- EOF ------------------------------------------------------------------ */
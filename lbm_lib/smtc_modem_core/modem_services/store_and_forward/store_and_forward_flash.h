@@ -50,6 +50,53 @@ extern "C" {
  * --- PUBLIC MACROS -----------------------------------------------------------
  */
 
+#if defined( ADD_SMTC_STORE_AND_FORWARD_PRE_ERASE )
+/**
+ * @brief The next flash page is erased ahead when the engine goes to sleep for at least this delay
+ */
+#ifndef STORE_AND_FORWARD_FLASH_PRE_ERASE_IDLE_MS
+#define STORE_AND_FORWARD_FLASH_PRE_ERASE_IDLE_MS ( 500 )
+#endif
+
+/**
+ * @brief The next flash page is only erased when no radio task starts within this delay (covers a flash page erase)
+ */
+#ifndef STORE_AND_FORWARD_FLASH_PRE_ERASE_RADIO_GUARD_MS
+#define STORE_AND_FORWARD_FLASH_PRE_ERASE_RADIO_GUARD_MS ( 50 )
+#endif
+#endif
+
+#if defined( ADD_SMTC_FAST_BOOT )
+/**
+ * @brief The filesystem left unscanned at init is scanned when the engine goes to sleep for at least this delay
+ */
+#ifndef STORE_AND_FORWARD_FLASH_MOUNT_IDLE_MS
+#define STORE_AND_FORWARD_FLASH_MOUNT_IDLE_MS ( 100 )
+#endif
+
+/**
+ * @brief The filesystem is only scanned when no radio task starts within this delay (covers the erase of a sector
+ * found partially erased)
+ */
+#ifndef STORE_AND_FORWARD_FLASH_MOUNT_RADIO_GUARD_MS
+#define STORE_AND_FORWARD_FLASH_MOUNT_RADIO_GUARD_MS ( 50 )
+#endif
+#endif
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+/**
+ * @brief Maximum number of data uplinks in a FEC block
+ */
+#define STORE_AND_FORWARD_FLASH_FEC_NB_DATA_MAX ( 64 )
+
+/**
+ * @brief Maximum number of parity uplinks of a FEC block, each one costs a maximum size uplink buffer in RAM
+ */
+#ifndef STORE_AND_FORWARD_FLASH_FEC_NB_PARITY_MAX
+#define STORE_AND_FORWARD_FLASH_FEC_NB_PARITY_MAX ( 4 )
+#endif
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC CONSTANTS --------------------------------------------------------
@@ -121,6 +168,40 @@ store_and_forward_flash_rc_t store_and_forward_flash_set_state( uint8_t
  */
 store_and_forward_flash_state_t store_and_forward_flash_get_state( uint8_t stack_id );
 
+/**
+ * @brief Enable or disable the aggregation of the stored data
+ *
+ * @remark When enabled, the entries following the oldest one are packed with it as long as they fit in the next
+ * uplink payload, and sent on @p fport. Each entry keeps its FPort and the time elapsed since the previous entry.
+ * The entries of an aggregated uplink are acknowledged together. A single entry is sent unchanged on its own FPort.
+ *
+ * @param [in] stack_id Stack identifier
+ * @param [in] enabled  Aggregation state
+ * @param [in] fport    LoRaWAN FPort of the aggregated uplinks
+ * @return store_and_forward_flash_rc_t
+ */
+store_and_forward_flash_rc_t store_and_forward_flash_set_aggregation( uint8_t stack_id, bool enabled, uint8_t fport );
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+/**
+ * @brief Enable or disable the forward error correction of the stored data
+ *
+ * @remark When enabled, the stored data are sent unconfirmed on @p fport in blocks of @p nb_data uplinks followed by
+ * up to @p nb_parity parity uplinks, then deleted without acknowledgment. The application server rebuilds up to
+ * @p nb_parity lost uplinks of a block. A block is closed early when the fifo is empty. A data too large for the
+ * FEC header at the current datarate is sent unchanged with the acknowledgment rules.
+ *
+ * @param [in] stack_id  Stack identifier
+ * @param [in] enabled   FEC state
+ * @param [in] fport     LoRaWAN FPort of the FEC uplinks
+ * @param [in] nb_data   Data uplinks per block, 1 to STORE_AND_FORWARD_FLASH_FEC_NB_DATA_MAX
+ * @param [in] nb_parity Parity uplinks per block, 1 to STORE_AND_FORWARD_FLASH_FEC_NB_PARITY_MAX
+ * @return store_and_forward_flash_rc_t
+ */
+store_and_forward_flash_rc_t store_and_forward_flash_set_fec( uint8_t stack_id, bool enabled, uint8_t fport,
+                                                              uint8_t nb_data, uint8_t nb_parity );
+#endif
+
 /**
  * @brief Add data to the NVM FiFo
  *
@@ -160,6 +241,27 @@ store_and_forward_flash_rc_t store_and_forward_flash_get_number_of_free_slot( ui
  */
 struct circularfs* store_and_forward_flash_get_fs_object( uint8_t stack_id );
 
+#if defined( ADD_SMTC_STORE_AND_FORWARD_PRE_ERASE )
+/**
+ * @brief Erase the flash page that the next append changing page would erase, if the modem stays idle long enough
+ * and no radio task is close
+ *
+ * @param [in] sleep_time_ms Time until the next engine run
+ */
+void store_and_forward_flash_pre_erase_on_idle( uint32_t sleep_time_ms );
+#endif
+
+#if defined( ADD_SMTC_FAST_BOOT )
+/**
+ * @brief Scan the filesystem left unscanned at init, if the modem stays idle long enough and no radio task is close
+ *
+ * @remark The filesystem is otherwise scanned the first time the service is used
+ *
+ * @param [in] sleep_time_ms Time until the next engine run
+ */
+void store_and_forward_flash_mount_on_idle( uint32_t sleep_time_ms );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
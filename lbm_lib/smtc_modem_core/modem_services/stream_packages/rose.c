@@ -291,7 +291,14 @@ void ROSE_cipher( rose_t* ROSE, uint32_t soff, uint8_t* data, uint8_t len )
 
 int ROSE_init( rose_t* ROSE, uint16_t windowLen, uint16_t minfree, uint8_t redundancyRate, uint8_t unitsz )
 {
+#if defined( ADD_SMTC_RAM_POOL )
+    uint8_t* fifo = ROSE->fifo;
     memset( ROSE, 0, sizeof( rose_t ) );
+    ROSE->fifo = fifo;
+    memset( fifo, 0, ROSE_FIFO_SIZE );
+#else
+    memset( ROSE, 0, sizeof( rose_t ) );
+#endif
 
     if( ( unitsz != 1 && unitsz != 2 && unitsz != 4 && unitsz != 8 ) || ROSE_FIFO_SIZE % unitsz != 0 )
     {
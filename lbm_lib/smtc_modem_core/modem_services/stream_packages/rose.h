@@ -104,7 +104,11 @@ typedef struct rose_s
     uint16_t unsent;    // start of unsent systematic data
     uint16_t fill;      // start of free buffer space
     uint8_t  unitsz;
-    uint8_t  fifo[ROSE_FIFO_SIZE];
+#if defined( ADD_SMTC_RAM_POOL )
+    uint8_t* fifo;  // ROSE_FIFO_SIZE bytes taken from the modem ram pool by the stream service
+#else
+    uint8_t fifo[ROSE_FIFO_SIZE];
+#endif
 } rose_t;
 
 // minfree in bytes
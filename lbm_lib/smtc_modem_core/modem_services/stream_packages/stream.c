@@ -45,10 +45,19 @@
 #include "smtc_modem_hal_dbg_trace.h"
 #include "lorawan_api.h"
 #include "modem_event_utilities.h"
+#include "modem_perf_counters.h"
 #include "device_management_defs.h"
 
 #include "rose.h"
+#include "rose_defs.h"
 #include "stream.h"
+#if defined( ADD_SMTC_RAM_POOL )
+#include "modem_ram_pool.h"
+#endif
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+#include "circularfs.h"
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -57,7 +66,49 @@
 #define CURRENT_STACK ( task_id / NUMBER_OF_TASKS )
 #define NUMBER_MAX_OF_STREAM_OBJ 1  // modify in case of multiple obj
 
-#define MODEM_TASK_DELAY_MS ( smtc_modem_hal_get_random_nb_in_range( 200, 3000 ) )
+/**
+ * @brief Delay before sending the next fragment, the supervisor holds the task while the duty cycle forbids it
+ */
+#define MODEM_TASK_DELAY_MS ( 0 )
+
+/**
+ * @brief LoRaWAN overhead of an uplink (MHDR, FHDR without FOpts, FPort and MIC) charged with each fragment
+ */
+#define STREAM_LORAWAN_OVERHEAD ( 13 )
+
+/**
+ * @brief Fixed point scale of the virtual airtime, so that a heavy weight still advances the stream virtual time
+ */
+#define STREAM_VTIME_SCALE ( 256 )
+
+/**
+ * @brief One fragment out of STREAM_AUTO_RR_PROBE_PERIOD is sent confirmed when the redundancy is automatic
+ */
+#ifndef STREAM_AUTO_RR_PROBE_PERIOD
+#define STREAM_AUTO_RR_PROBE_PERIOD ( 8 )
+#endif
+
+/**
+ * @brief Loss estimate before the first acknowledgement, in hundredths of percent
+ */
+#define STREAM_AUTO_RR_INITIAL_LOSS ( 1000 )
+
+/**
+ * @brief Weight of the last probe in the loss estimate is 1 / 2^STREAM_AUTO_RR_LOSS_SHIFT
+ */
+#define STREAM_AUTO_RR_LOSS_SHIFT ( 2 )
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+/**
+ * @brief Version of the spill filesystem, records are the raw data given to stream_add_data
+ */
+#define STREAM_SPILL_VERSION ( 1 )
+
+/**
+ * @brief Maximum length of a stream record (ROSE refuses 0xFF bytes and more)
+ */
+#define STREAM_SPILL_RECORD_SIZE_MAX ( 254 )
+#endif
 
 /**
  * @brief Check is the index is valid before accessing object
@@ -79,6 +130,16 @@
         SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_OF_STACKS ); \
     } while( 0 )
 
+/**
+ * @brief Check is the stream index is valid before accessing the stream
+ *
+ */
+#define IS_VALID_STREAM_ID( x )                                   \
+    do                                                            \
+    {                                                             \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_OF_STREAMS ); \
+    } while( 0 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -89,18 +150,39 @@
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
+typedef struct stream_obj_s
+{
+    rose_t   ROSE;
+    bool     is_stream_init;
+    uint8_t  port;
+    bool     follow_dm_port;
+    bool     encryption;
+    uint8_t  priority;        //!<  0 is the highest
+    uint8_t  weight;          //!<  airtime share among the streams of the same priority
+    uint32_t vtime;           //!<  airtime charged to the stream divided by its weight
+    bool     rr_auto;         //!<  redundancy rate follows the estimated uplink loss
+    uint8_t  rr_min;          //!<  redundancy rate on a loss free link
+    uint8_t  rr_max;          //!<  highest automatic redundancy rate
+    uint8_t  rr_probe_count;  //!<  fragments sent since the last confirmed one
+    uint16_t rr_loss;         //!<  estimated uplink loss in hundredths of percent
+#if defined( ADD_SMTC_STREAM_SPILL )
+    bool              is_spill_available;  //!<  spill partition reserved and usable
+    bool              is_spill_mounted;    //!<  spill partition scanned, or formatted
+    uint32_t          spill_pending;       //!<  bytes of the spilled records, length byte included as in ROSE
+    struct circularfs spill_fs;            //!<  unsent records that did not fit in the ROSE fifo, oldest first
+#endif
+} stream_obj_t;
+
 typedef struct stream_s
 {
     uint8_t stack_id;
     uint8_t task_id;
 
     status_lorawan_t send_status;
-    rose_t           ROSE;
-    bool             is_stream_init;
-    uint8_t          port;
-    bool             follow_dm_port;
-    bool             encryption;
     bool             is_data_streaming;  //!<  stream task is on going
+    uint8_t          sending_stream;     //!<  stream of the last fragment
+    bool             rr_probe_pending;   //!<  the last fragment was confirmed and its outcome is not known yet
+    stream_obj_t     streams[NUMBER_OF_STREAMS];
 } stream_ctx_t;
 
 typedef struct stream_service_ctx_s
@@ -116,6 +198,10 @@ typedef struct stream_service_ctx_s
 static stream_service_ctx_t stream_service_ctx;
 #define stream_ctx stream_service_ctx.stream_ctx
 
+#if defined( ADD_SMTC_STREAM_SPILL )
+static struct circularfs_flash_partition stream_spill_flash[NUMBER_OF_STREAMS];
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -130,20 +216,57 @@ static stream_service_ctx_t stream_service_ctx;
  */
 static stream_ctx_t* stream_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id );
 
+/**
+ * @brief Get a stream of a stack
+ *
+ * @param [in]  stack_id    Stack identifier
+ * @param [in]  stream_id   Stream identifier
+ * @return stream_obj_t*    stream
+ */
+static stream_obj_t* stream_get_obj( uint8_t stack_id, uint8_t stream_id );
+
 /*!
  * @brief   Enqueue task in supervisor
  *
- * @param [in] ctx                  stream object context
+ * @param [in] ctx                  stream service context
  */
 static void stream_add_task( stream_ctx_t* ctx );
 
 /*!
  * @brief   Indicates if data is pending for uplink
  *
- * @param [in] ROSE*                Pointer to Stream context
+ * @param [in] obj                  stream
+ * @retval bool                     True if data is pending in the ROSE fifo or in the spill
+ */
+static bool stream_data_pending( stream_obj_t* obj );
+
+/*!
+ * @brief   Indicates if one of the streams of a stack has data pending for uplink
+ *
+ * @param [in] ctx                  stream service context
  * @retval bool                     True if data is pending
  */
-static bool stream_data_pending( rose_t* ROSE );
+static bool stream_data_pending_any( stream_ctx_t* ctx );
+
+/*!
+ * @brief   Choose the stream sending the next fragment
+ *
+ * @remark  Highest priority first, then the lowest virtual airtime among the streams of that priority
+ *
+ * @param [in] ctx                  stream service context
+ * @retval uint8_t                  Stream identifier, NUMBER_OF_STREAMS if no stream has pending data
+ */
+static uint8_t stream_select( stream_ctx_t* ctx );
+
+/*!
+ * @brief   Bring the virtual airtime of a stream getting data again to the one of the active streams
+ *
+ * @remark  An idle stream does not build up credit to send a burst at the expense of the others
+ *
+ * @param [in] ctx                  stream service context
+ * @param [in] obj                  stream becoming active
+ */
+static void stream_vtime_catch_up( stream_ctx_t* ctx, stream_obj_t* obj );
 
 /*!
  * @brief   Get a new stream fragment to uplink
@@ -164,14 +287,57 @@ static stream_return_code_t stream_get_fragment( rose_t* ROSE, uint8_t* buf, uin
 /*!
  * @brief   Process a downlink stream command SCMD.
  *
- * @param [in] ctx                  stream object context
+ * @param [in] ctx                  stream service context
+ * @param [in] stream_id            stream following the DM port
  * @param [in] payload              Pointer to a buffer containing the command
  * @param [in] len                  Length of the command
  *
  * @retval stream_return_code_t     STREAM_OK if successful,
  *                                  STREAM_UNKNOWN_SCMD if the command is not correct
  */
-static stream_return_code_t stream_process_dn_frame( stream_ctx_t* ctx, const uint8_t* payload, uint8_t len );
+static stream_return_code_t stream_process_dn_frame( stream_ctx_t* ctx, uint8_t stream_id, const uint8_t* payload,
+                                                     uint8_t len );
+
+/*!
+ * @brief   Update the uplink loss estimate with one observation and retune the redundancy rate
+ *
+ * @param [in] obj                  stream
+ * @param [in] lost                 True if the observed uplink was lost
+ */
+static void stream_auto_rr_update( stream_obj_t* obj, bool lost );
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+/*!
+ * @brief   Scan the spill partition of the stream the first time it is used
+ *
+ * @param [in] obj                  stream
+ * @return true if the spill partition is usable
+ */
+static bool stream_spill_mount( stream_obj_t* obj );
+
+/*!
+ * @brief   Move the oldest spilled records into the ROSE fifo, as long as they fit
+ *
+ * @param [in] obj                  stream
+ */
+static void stream_spill_refill( stream_obj_t* obj );
+
+/*!
+ * @brief   Drop all spilled records
+ *
+ * @param [in] obj                  stream
+ */
+static void stream_spill_clear( stream_obj_t* obj );
+
+/*!
+ * @brief   Circularfs flash operations on CONTEXT_STREAM_SPILL
+ */
+static int32_t stream_spill_op_sector_erase( struct circularfs_flash_partition* flash, uint32_t address );
+static int32_t stream_spill_op_program( struct circularfs_flash_partition* flash, uint32_t address, const void* data,
+                                        uint32_t size );
+static int32_t stream_spill_op_read( struct circularfs_flash_partition* flash, uint32_t address, void* data,
+                                     uint32_t size );
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -184,6 +350,9 @@ void stream_services_init( uint8_t* service_id, uint8_t task_id,
                            void** context_callback )
 {
     stream_ctx_t* ctx = &stream_ctx[*service_id];
+#if defined( ADD_SMTC_RAM_POOL )
+    modem_ram_pool_release( MODEM_RAM_POOL_USER_STREAM, CURRENT_STACK );
+#endif
     memset( ctx, 0, sizeof( stream_ctx_t ) );
 
     IS_VALID_OBJECT_ID( *service_id );
@@ -193,9 +362,51 @@ void stream_services_init( uint8_t* service_id, uint8_t task_id,
     *context_callback   = ( void* ) service_id;
     ctx->task_id        = task_id;
     ctx->stack_id       = CURRENT_STACK;
-    ctx->ROSE.stack_id  = CURRENT_STACK;
-    ctx->port           = DM_PORT;
+
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        ctx->streams[i].ROSE.stack_id = CURRENT_STACK;
+        ctx->streams[i].port          = DM_PORT;
+        ctx->streams[i].weight        = 1;
+    }
     SMTC_MODEM_HAL_TRACE_WARNING( "%s\n", __func__ );
+
+#if ( NUMBER_OF_STACKS == 1 )
+    // the dm port of the stack, followed by cloud_dm_set_dm_port
+    modem_set_downlink_service_port( stream_service_downlink_handler, DM_PORT );
+#endif
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+    // the reserved pages are shared equally between the streams
+    uint16_t pages_per_stream = smtc_modem_hal_stream_spill_get_number_of_pages( ) / NUMBER_OF_STREAMS;
+
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        stream_obj_t* obj = &ctx->streams[i];
+
+        stream_spill_flash[i].sector_size   = smtc_modem_hal_flash_get_page_size( );
+        stream_spill_flash[i].sector_offset = i * pages_per_stream;
+        stream_spill_flash[i].sector_count  = pages_per_stream;
+        stream_spill_flash[i].sector_erase  = stream_spill_op_sector_erase;
+        stream_spill_flash[i].program       = stream_spill_op_program;
+        stream_spill_flash[i].read          = stream_spill_op_read;
+
+        // circularfs needs a free sector in front of the write head
+        if( ( pages_per_stream >= 2 ) &&
+            ( circularfs_init( &obj->spill_fs, &stream_spill_flash[i], STREAM_SPILL_VERSION,
+                               STREAM_SPILL_RECORD_SIZE_MAX ) == 0 ) )
+        {
+            obj->is_spill_available = true;
+#if !defined( ADD_SMTC_FAST_BOOT )
+            stream_spill_mount( obj );
+#endif
+        }
+        else
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "Stream %d spill disabled\n", i );
+        }
+    }
+#endif
 }
 
 void stream_service_on_launch( void* service_id )
@@ -205,51 +416,76 @@ void stream_service_on_launch( void* service_id )
 
     IS_VALID_OBJECT_ID( idx );
 
+    stream_ctx_t*        ctx                 = &stream_ctx[idx];
     uint8_t              stream_payload[242] = { 0 };
     uint8_t              fragment_size;
     uint32_t             frame_cnt;
     stream_return_code_t stream_rc;
     uint8_t              tx_buff_offset = 0;
 
-    if( lorawan_api_isjoined( stream_ctx[idx].stack_id ) != JOINED )
+    if( lorawan_api_isjoined( ctx->stack_id ) != JOINED )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "DEVICE NOT JOINED \n" );
         return;
     }
-    if( stream_ctx[idx].is_stream_init == false )
+
+    uint8_t stream_id = stream_select( ctx );
+    if( stream_id == NUMBER_OF_STREAMS )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "Streaming not initialized \n" );
+        ctx->is_data_streaming = false;
         return;
     }
+    stream_obj_t* obj = &ctx->streams[stream_id];
 
     // check first if stream runs on dm port and if yes add dm code
-    if( stream_ctx[idx].follow_dm_port == true )
+    if( obj->follow_dm_port == true )
     {
 #if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
-        stream_ctx[idx].port = cloud_dm_get_dm_port( stream_ctx[idx].stack_id );
+        obj->port = cloud_dm_get_dm_port( ctx->stack_id );
 #endif
         stream_payload[tx_buff_offset] = DM_INFO_STREAM;
         tx_buff_offset++;
     }
 
+#if defined( ADD_SMTC_STREAM_SPILL )
+    // the previous fragments freed some room in the fifo
+    stream_spill_refill( obj );
+#endif
+
     // XXX Check if a streaming session is already active
-    fragment_size = lorawan_api_next_max_payload_length_get( stream_ctx[idx].stack_id ) - tx_buff_offset;
-    frame_cnt     = lorawan_api_fcnt_up_get( stream_ctx[idx].stack_id );
-    stream_rc =
-        stream_get_fragment( &stream_ctx[idx].ROSE, &stream_payload[tx_buff_offset], frame_cnt, &fragment_size );
+    fragment_size = lorawan_api_next_max_payload_length_get( ctx->stack_id ) - tx_buff_offset;
+    frame_cnt     = lorawan_api_fcnt_up_get( ctx->stack_id );
+    stream_rc     = stream_get_fragment( &obj->ROSE, &stream_payload[tx_buff_offset], frame_cnt, &fragment_size );
 
     // TODO Is this enough to ensure we send everything?
     if( ( stream_rc == STREAM_OK ) && ( fragment_size > 0 ) )
     {
-        stream_ctx[idx].send_status = tx_protocol_manager_request (TX_PROTOCOL_TRANSMIT_LORA,
-            stream_ctx[idx].port, true, stream_payload, fragment_size + tx_buff_offset, UNCONF_DATA_UP,
-            smtc_modem_hal_get_time_in_ms( )  , stream_ctx[idx].stack_id );
+        lr1mac_layer_param_t packet_type = UNCONF_DATA_UP;
+
+        // the acknowledgement of a confirmed fragment tells whether the uplink went through
+        ctx->sending_stream   = stream_id;
+        ctx->rr_probe_pending = false;
+        if( ( obj->rr_auto == true ) && ( ++obj->rr_probe_count >= STREAM_AUTO_RR_PROBE_PERIOD ) )
+        {
+            obj->rr_probe_count   = 0;
+            ctx->rr_probe_pending = true;
+            packet_type           = CONF_DATA_UP;
+        }
+
+        // at a given datarate the airtime grows with the frame length
+        obj->vtime += ( ( uint32_t ) fragment_size + tx_buff_offset + STREAM_LORAWAN_OVERHEAD ) * STREAM_VTIME_SCALE /
+                      obj->weight;
+
+        ctx->send_status = tx_protocol_manager_request (TX_PROTOCOL_TRANSMIT_LORA_BULK,
+            obj->port, true, stream_payload, fragment_size + tx_buff_offset, packet_type,
+            smtc_modem_hal_get_time_in_ms( )  , ctx->stack_id );
     }
     else
     {
         // TODO
         // Insufficient data or streaming done
-        stream_ctx[idx].is_data_streaming = false;
+        ctx->is_data_streaming = false;
         SMTC_MODEM_HAL_TRACE_WARNING( "Stream get fragment FAILED\n" );
     }
 }
@@ -260,7 +496,7 @@ void stream_service_on_update( void* service_id )
     SMTC_MODEM_HAL_TRACE_PRINTF_DEBUG( " %s service_id %d \n", __func__, idx );
     IS_VALID_OBJECT_ID( idx );
 
-    if( stream_data_pending( &stream_ctx[idx].ROSE ) )
+    if( stream_data_pending_any( &stream_ctx[idx] ) )
     {
         stream_add_task( &stream_ctx[idx] );
     }
@@ -275,22 +511,37 @@ void stream_service_on_update( void* service_id )
 
 uint8_t stream_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
 {
-    uint8_t stack_id = rx_down_data->stack_id;
+    uint8_t       stack_id = rx_down_data->stack_id;
+    uint8_t       service_id;
+    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
 
-    if( rx_down_data->rx_metadata.rx_window == RECEIVE_NONE )
+    if( ctx == NULL )
     {
         return MODEM_DOWNLINK_UNCONSUMED;
     }
 
-    uint8_t       service_id;
-    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
+    // outcome of a confirmed fragment, only the first reception window after it counts
+    if( ( ctx->rr_probe_pending == true ) && ( modem_supervisor_get_task( )->next_task_id == ctx->task_id ) )
+    {
+        ctx->rr_probe_pending = false;
+        stream_auto_rr_update( &ctx->streams[ctx->sending_stream], rx_down_data->rx_metadata.rx_ack_bit == false );
+    }
 
-    if( ctx == NULL )
+    if( rx_down_data->rx_metadata.rx_window == RECEIVE_NONE )
     {
         return MODEM_DOWNLINK_UNCONSUMED;
     }
 
-    if( ctx->is_stream_init == false )
+    // stream commands come on the dm port, for the stream sent on it
+    uint8_t stream_id;
+    for( stream_id = 0; stream_id < NUMBER_OF_STREAMS; stream_id++ )
+    {
+        if( ( ctx->streams[stream_id].is_stream_init == true ) && ( ctx->streams[stream_id].follow_dm_port == true ) )
+        {
+            break;
+        }
+    }
+    if( stream_id == NUMBER_OF_STREAMS )
     {
         return MODEM_DOWNLINK_UNCONSUMED;
     }
@@ -308,7 +559,7 @@ uint8_t stream_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( "%s\n", __func__ );
 
-        if( stream_process_dn_frame( ctx, &rx_down_data->rx_payload[3],
+        if( stream_process_dn_frame( ctx, stream_id, &rx_down_data->rx_payload[3],
                                      rx_down_data->rx_payload_size - DM_DOWNLINK_HEADER_LENGTH ) != STREAM_OK )
         {
             SMTC_MODEM_HAL_TRACE_ERROR( "bad DM Stream downlink\n" );
@@ -320,67 +571,115 @@ uint8_t stream_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data
     return MODEM_DOWNLINK_UNCONSUMED;
 }
 
-stream_return_code_t stream_init( uint8_t stack_id, uint8_t f_port, bool encryption, uint8_t redundancy_ratio_percent )
+stream_return_code_t stream_init( uint8_t stack_id, uint8_t stream_id, uint8_t f_port, bool encryption,
+                                  uint8_t redundancy_ratio_percent )
 {
     IS_VALID_STACK_ID( stack_id );
     uint8_t       service_id;
     stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
+    stream_obj_t* obj = stream_get_obj( stack_id, stream_id );
+
+    if( f_port == 0 )
+    {
+        f_port = cloud_dm_get_dm_port( ctx->stack_id );
+    }
+
+    // the server tells the streams apart with their port
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        if( ( i != stream_id ) && ( ctx->streams[i].is_stream_init == true ) && ( ctx->streams[i].port == f_port ) )
+        {
+            return STREAM_BUSY;
+        }
+    }
 
-    // First reset stream service
-    memset( &ctx->ROSE, 0, sizeof( rose_t ) );
+    // First reset stream service, the fifo is kept until the service is stopped
+#if defined( ADD_SMTC_RAM_POOL )
+    uint8_t* fifo = obj->ROSE.fifo;
+    if( fifo == NULL )
+    {
+        fifo = modem_ram_pool_alloc( MODEM_RAM_POOL_USER_STREAM, ctx->stack_id, ROSE_FIFO_SIZE );
+        if( fifo == NULL )
+        {
+            return STREAM_FAIL;
+        }
+    }
+#endif
+    memset( &obj->ROSE, 0, sizeof( rose_t ) );
+    obj->ROSE.stack_id = ctx->stack_id;
+#if defined( ADD_SMTC_RAM_POOL )
+    obj->ROSE.fifo = fifo;
+#endif
+#if defined( ADD_SMTC_STREAM_SPILL )
+    stream_spill_clear( obj );
+#endif
 
     // prepare stream module
-    if( ROSE_init( &ctx->ROSE, ROSE_DEFAULT_WL, ROSE_DEFAULT_MINFREE, redundancy_ratio_percent, 1 ) != ROSE_OK )
+    if( ROSE_init( &obj->ROSE, ROSE_DEFAULT_WL, ROSE_DEFAULT_MINFREE, redundancy_ratio_percent, 1 ) != ROSE_OK )
     {
         return STREAM_FAIL;
     }
 
     if( encryption == true )
     {
-        ROSE_enable_encryption( &ctx->ROSE );
+        ROSE_enable_encryption( &obj->ROSE );
     }
 
-    if( f_port == 0 )
+    if( f_port == cloud_dm_get_dm_port( ctx->stack_id ) )
     {
-        f_port = cloud_dm_get_dm_port( ctx->stack_id );
+        obj->follow_dm_port = true;
+    }
+    else
+    {
+        obj->follow_dm_port = false;
     }
 
-    if( f_port == cloud_dm_get_dm_port( ctx->stack_id ) )
+    // the automatic redundancy starts again from the rate given by the application
+    obj->rr_probe_count = 0;
+    obj->rr_loss        = STREAM_AUTO_RR_INITIAL_LOSS;
+    if( ctx->sending_stream == stream_id )
     {
-        ctx->follow_dm_port = true;
+        ctx->rr_probe_pending = false;
     }
-    else
+
+    obj->port           = f_port;
+    obj->encryption     = encryption;
+    obj->is_stream_init = true;
+
+    // Remove previous ongoing stream task to avoid event generation, unless another stream has data to send
+    if( stream_data_pending_any( ctx ) == false )
     {
-        ctx->follow_dm_port = false;
+        modem_supervisor_remove_task( ctx->task_id );
     }
 
-    ctx->port           = f_port;
-    ctx->encryption     = encryption;
-    ctx->is_stream_init = true;
+    return STREAM_OK;
+}
 
-    // Remove previous ongoing stream task to avoid event generation
-    modem_supervisor_remove_task( ctx->task_id );
+stream_return_code_t stream_set_priority( uint8_t stack_id, uint8_t stream_id, uint8_t priority, uint8_t weight )
+{
+    IS_VALID_STACK_ID( stack_id );
+    stream_obj_t* obj = stream_get_obj( stack_id, stream_id );
+
+    if( weight == 0 )
+    {
+        return STREAM_FAIL;
+    }
 
+    obj->priority = priority;
+    obj->weight   = weight;
     return STREAM_OK;
 }
 
-bool stream_encrypted_mode( uint8_t stack_id )
+bool stream_encrypted_mode( uint8_t stack_id, uint8_t stream_id )
 {
     IS_VALID_STACK_ID( stack_id );
-    uint8_t       service_id;
-    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
-    return ctx->encryption;
+    return stream_get_obj( stack_id, stream_id )->encryption;
 }
 
-bool stream_get_init_status( uint8_t stack_id )
+bool stream_get_init_status( uint8_t stack_id, uint8_t stream_id )
 {
     IS_VALID_STACK_ID( stack_id );
-    uint8_t       service_id;
-    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
-    return ctx->is_stream_init;
+    return stream_get_obj( stack_id, stream_id )->is_stream_init;
 }
 
 bool stream_get_status( uint8_t stack_id )
@@ -393,14 +692,13 @@ bool stream_get_status( uint8_t stack_id )
 }
 
 // (only allowed when joined)
-stream_return_code_t stream_add_data( uint8_t stack_id, const uint8_t* data, uint8_t len )
+stream_return_code_t stream_add_data( uint8_t stack_id, uint8_t stream_id, const uint8_t* data, uint8_t len )
 {
     IS_VALID_STACK_ID( stack_id );
     uint8_t       service_id;
     stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
+    stream_obj_t* obj = stream_get_obj( stack_id, stream_id );
 
-    // for now only one stream supported
     int err = 0;
 
     if( data == NULL )
@@ -413,15 +711,48 @@ stream_return_code_t stream_add_data( uint8_t stack_id, const uint8_t* data, uin
         return STREAM_BADSIZE;
     }
 
-    // check data record length
-    err = ROSE_addRecord( &ctx->ROSE, &data[0], len );
+    if( stream_data_pending( obj ) == false )
+    {
+        stream_vtime_catch_up( ctx, obj );
+    }
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+    if( len > STREAM_SPILL_RECORD_SIZE_MAX )
+    {
+        return STREAM_BADSIZE;
+    }
+
+    // records wait behind the spilled ones to keep the stream order
+    if( ( stream_spill_mount( obj ) == true ) && ( circularfs_count_estimate( &obj->spill_fs ) > 0 ) )
+    {
+        stream_spill_refill( obj );
+        err = ( circularfs_count_estimate( &obj->spill_fs ) > 0 ) ? ROSE_OVERRUN
+                                                                  : ROSE_addRecord( &obj->ROSE, &data[0], len );
+    }
+    else
+#endif
+    {
+        // check data record length
+        err = ROSE_addRecord( &obj->ROSE, &data[0], len );
+    }
     if( err == ROSE_BAD_DATALEN )
     {
         return STREAM_BADSIZE;
     }
     if( err == ROSE_OVERRUN )
     {
+#if defined( ADD_SMTC_STREAM_SPILL )
+        // never let circularfs overwrite the oldest spilled records
+        if( ( stream_spill_mount( obj ) == false ) || ( circularfs_free_slot_estimate( &obj->spill_fs ) <= 0 ) ||
+            ( circularfs_append( &obj->spill_fs, &data[0], len ) != 0 ) )
+        {
+            return STREAM_BUSY;
+        }
+        obj->spill_pending += len + 1;
+        err = ROSE_OK;
+#else
         return STREAM_BUSY;
+#endif
     }
     if( err != ROSE_OK )
     {
@@ -436,48 +767,101 @@ stream_return_code_t stream_add_data( uint8_t stack_id, const uint8_t* data, uin
     return STREAM_OK;
 }
 
-void stream_status( uint8_t stack_id, uint16_t* pending, uint16_t* free )
+void stream_status( uint8_t stack_id, uint8_t stream_id, uint16_t* pending, uint16_t* free )
 {
     IS_VALID_STACK_ID( stack_id );
-    uint8_t       service_id;
-    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
+    stream_obj_t* obj = stream_get_obj( stack_id, stream_id );
+
+#if defined( ADD_SMTC_RAM_POOL )
+    // No fifo before the stream is initialized
+    if( obj->ROSE.fifo == NULL )
+    {
+        if( pending != NULL )
+        {
+            *pending = 0;
+        }
+        if( free != NULL )
+        {
+            *free = 0;
+        }
+        return;
+    }
+#endif
+    uint32_t pending_bytes = ROSE_getPending( &obj->ROSE );
+    uint32_t free_bytes    = ROSE_getFree( &obj->ROSE );
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+    if( stream_spill_mount( obj ) == true )
+    {
+        pending_bytes += obj->spill_pending;
+        free_bytes +=
+            ( uint32_t ) circularfs_free_slot_estimate( &obj->spill_fs ) * ( STREAM_SPILL_RECORD_SIZE_MAX + 1 );
+    }
+#endif
 
     if( pending != NULL )
     {
-        *pending = ROSE_getPending( &ctx->ROSE );
+        *pending = ( pending_bytes > UINT16_MAX ) ? UINT16_MAX : pending_bytes;
     }
     if( free != NULL )
     {
-        *free = ROSE_getFree( &ctx->ROSE );
+        *free = ( free_bytes > UINT16_MAX ) ? UINT16_MAX : free_bytes;
     }
 }
 
-uint8_t stream_get_port( uint8_t stack_id )
+uint8_t stream_get_port( uint8_t stack_id, uint8_t stream_id )
 {
     IS_VALID_STACK_ID( stack_id );
-    uint8_t       service_id;
-    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
-    return ( ctx->port );
+    return stream_get_obj( stack_id, stream_id )->port;
 }
 
-uint8_t stream_get_rr( uint8_t stack_id )
+uint8_t stream_get_rr( uint8_t stack_id, uint8_t stream_id )
 {
     IS_VALID_STACK_ID( stack_id );
-    uint8_t       service_id;
-    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
-    return ( ctx->ROSE.rr );
+    return stream_get_obj( stack_id, stream_id )->ROSE.rr;
+}
+
+void stream_set_rr( uint8_t stack_id, uint8_t stream_id, uint8_t stream_rr )
+{
+    IS_VALID_STACK_ID( stack_id );
+    stream_get_obj( stack_id, stream_id )->ROSE.rr = stream_rr;
 }
 
-void stream_set_rr( uint8_t stack_id, uint8_t stream_rr )
+stream_return_code_t stream_set_rr_auto( uint8_t stack_id, uint8_t stream_id, bool enable, uint8_t rr_min,
+                                         uint8_t rr_max )
 {
     IS_VALID_STACK_ID( stack_id );
     uint8_t       service_id;
     stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
-    ctx->ROSE.rr = stream_rr;
+    stream_obj_t* obj = stream_get_obj( stack_id, stream_id );
+
+    if( ( enable == true ) && ( rr_min > rr_max ) )
+    {
+        return STREAM_FAIL;
+    }
+
+    obj->rr_auto        = enable;
+    obj->rr_min         = rr_min;
+    obj->rr_max         = rr_max;
+    obj->rr_probe_count = 0;
+    obj->rr_loss        = STREAM_AUTO_RR_INITIAL_LOSS;
+    if( ctx->sending_stream == stream_id )
+    {
+        ctx->rr_probe_pending = false;
+    }
+
+#if ( NUMBER_OF_STACKS == 1 )
+    // acknowledgements come without fport, the handler has to see all downlinks while a stream is in automatic mode
+    bool any_rr_auto = false;
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        any_rr_auto |= ctx->streams[i].rr_auto;
+    }
+    modem_set_downlink_service_port( stream_service_downlink_handler,
+                                     ( any_rr_auto == true ) ? MODEM_DOWNLINK_ANY_PORT
+                                                             : cloud_dm_get_dm_port( ctx->stack_id ) );
+#endif
+    return STREAM_OK;
 }
 
 void stream_service_stop( uint8_t stack_id )
@@ -487,12 +871,26 @@ void stream_service_stop( uint8_t stack_id )
     stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
 
-    // Reset Rose buff
-    memset( &ctx->ROSE, 0, sizeof( rose_t ) );
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        stream_obj_t* obj = &ctx->streams[i];
+
+        // Reset Rose buff
+        memset( &obj->ROSE, 0, sizeof( rose_t ) );
+        obj->ROSE.stack_id = ctx->stack_id;
+#if defined( ADD_SMTC_STREAM_SPILL )
+        stream_spill_clear( obj );
+#endif
+        // Reset service state to NOT_INIT
+        obj->is_stream_init = false;
+    }
+#if defined( ADD_SMTC_RAM_POOL )
+    // The memset above dropped the fifos, give them back
+    modem_ram_pool_release( MODEM_RAM_POOL_USER_STREAM, ctx->stack_id );
+#endif
     // Remove previous ongoing stream task to avoid event generation
     modem_supervisor_remove_task( ctx->task_id );
-    // Reset service state to NOT_INIT
-    ctx->is_stream_init = false;
+    ctx->rr_probe_pending = false;
     // Reset is_data_streaming status
     ctx->is_data_streaming = false;
 }
@@ -517,20 +915,86 @@ static stream_ctx_t* stream_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* se
     return ctx;
 }
 
+static stream_obj_t* stream_get_obj( uint8_t stack_id, uint8_t stream_id )
+{
+    uint8_t       service_id;
+    stream_ctx_t* ctx = stream_get_ctx_from_stack_id( stack_id, &service_id );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ctx != NULL );
+    IS_VALID_STREAM_ID( stream_id );
+    return &ctx->streams[stream_id];
+}
+
 static void stream_add_task( stream_ctx_t* ctx )
 {
-    smodem_task stream_task       = { 0 };
-    stream_task.id                = ctx->task_id;
-    stream_task.stack_id          = ctx->stack_id;
-    stream_task.priority          = TASK_MEDIUM_HIGH_PRIORITY;
-    stream_task.time_to_execute_s = smtc_modem_hal_get_time_in_s( ) + ( MODEM_TASK_DELAY_MS / 1000 );
+    smodem_task stream_task = { 0 };
+    stream_task.id          = ctx->task_id;
+    stream_task.stack_id    = ctx->stack_id;
+    stream_task.priority    = TASK_MEDIUM_HIGH_PRIORITY;
 
-    modem_supervisor_add_task( &stream_task );
+    modem_supervisor_add_task_in_ms( &stream_task, MODEM_TASK_DELAY_MS );
 }
 
-static bool stream_data_pending( rose_t* ROSE )
+static bool stream_data_pending( stream_obj_t* obj )
 {
-    return ROSE_getStatus( ROSE ) == ROSE_PENDTX;
+    if( obj->is_stream_init == false )
+    {
+        return false;
+    }
+#if defined( ADD_SMTC_STREAM_SPILL )
+    if( ( stream_spill_mount( obj ) == true ) && ( circularfs_count_estimate( &obj->spill_fs ) > 0 ) )
+    {
+        return true;
+    }
+#endif
+    return ROSE_getStatus( &obj->ROSE ) == ROSE_PENDTX;
+}
+
+static bool stream_data_pending_any( stream_ctx_t* ctx )
+{
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        if( stream_data_pending( &ctx->streams[i] ) == true )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint8_t stream_select( stream_ctx_t* ctx )
+{
+    uint8_t selected = NUMBER_OF_STREAMS;
+
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        stream_obj_t* obj = &ctx->streams[i];
+
+        if( stream_data_pending( obj ) == false )
+        {
+            continue;
+        }
+        if( ( selected == NUMBER_OF_STREAMS ) || ( obj->priority < ctx->streams[selected].priority ) ||
+            ( ( obj->priority == ctx->streams[selected].priority ) &&
+              ( ( int32_t ) ( obj->vtime - ctx->streams[selected].vtime ) < 0 ) ) )
+        {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+static void stream_vtime_catch_up( stream_ctx_t* ctx, stream_obj_t* obj )
+{
+    for( uint8_t i = 0; i < NUMBER_OF_STREAMS; i++ )
+    {
+        stream_obj_t* active = &ctx->streams[i];
+
+        if( ( active != obj ) && ( active->priority == obj->priority ) && ( stream_data_pending( active ) == true ) &&
+            ( ( int32_t ) ( active->vtime - obj->vtime ) > 0 ) )
+        {
+            obj->vtime = active->vtime;
+        }
+    }
 }
 
 static stream_return_code_t stream_get_fragment( rose_t* ROSE, uint8_t* buf, uint32_t frag_ctn, uint8_t* len )
@@ -566,20 +1030,144 @@ static stream_return_code_t stream_get_fragment( rose_t* ROSE, uint8_t* buf, uin
     return STREAM_OK;
 }
 
-static stream_return_code_t stream_process_dn_frame( stream_ctx_t* ctx, const uint8_t* payload, uint8_t len )
+static stream_return_code_t stream_process_dn_frame( stream_ctx_t* ctx, uint8_t stream_id, const uint8_t* payload,
+                                                     uint8_t len )
 {
-    int rc;
+    stream_obj_t* obj = &ctx->streams[stream_id];
+    int           rc;
     if( payload == NULL )
     {
         return STREAM_FAIL;
     }
 
-    rc = ROSE_processDnFrame( &ctx->ROSE, payload, len );
+    rc = ROSE_processDnFrame( &obj->ROSE, payload, len );
     if( rc == ROSE_NOTFORME )
     {
         return STREAM_UNKNOWN_SCMD;
     }
+
+    if( obj->rr_auto == true )
+    {
+        if( ( payload[SCMD_FLAGS_OFF] & SCMD_FLAGS_UPDRR ) != 0 )
+        {
+            // the server counts the missing fragments, its rate wins over the estimate
+            SMTC_MODEM_HAL_TRACE_INFO( "Stream rr set by server to %d, automatic rr stopped\n", obj->ROSE.rr );
+            stream_set_rr_auto( ctx->stack_id, stream_id, false, obj->rr_min, obj->rr_max );
+        }
+        else if( ( payload[SCMD_FLAGS_OFF] & SCMD_FLAGS_SINFO ) != 0 )
+        {
+            // the server lost the stream context, some fragments did not make it
+            stream_auto_rr_update( obj, true );
+        }
+    }
     return STREAM_OK;
 }
 
+static void stream_auto_rr_update( stream_obj_t* obj, bool lost )
+{
+    int32_t sample = ( lost == true ) ? 10000 : 0;
+
+    obj->rr_loss += ( sample - ( int32_t ) obj->rr_loss ) / ( 1 << STREAM_AUTO_RR_LOSS_SHIFT );
+
+    // ROSE recovers a loss p with somewhat more than p / (1 - p) redundancy, take twice as a margin
+    uint32_t rr = obj->rr_max;
+    if( obj->rr_loss < 9900 )
+    {
+        rr = obj->rr_min + ( 200 * ( uint32_t ) obj->rr_loss ) / ( 10000 - obj->rr_loss );
+    }
+    if( rr > obj->rr_max )
+    {
+        rr = obj->rr_max;
+    }
+
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Stream %s, loss %d.%02d%%, rr %d\n", ( lost == true ) ? "loss" : "ack",
+                                 obj->rr_loss / 100, obj->rr_loss % 100, rr );
+    obj->ROSE.rr = rr;
+}
+
+#if defined( ADD_SMTC_STREAM_SPILL )
+static bool stream_spill_mount( stream_obj_t* obj )
+{
+    if( ( obj->is_spill_available == true ) && ( obj->is_spill_mounted == false ) )
+    {
+        if( circularfs_scan( &obj->spill_fs ) != 0 )
+        {
+            circularfs_format( &obj->spill_fs, false );
+        }
+        obj->is_spill_mounted = true;
+    }
+    return obj->is_spill_available;
+}
+
+static void stream_spill_refill( stream_obj_t* obj )
+{
+    uint8_t record[STREAM_SPILL_RECORD_SIZE_MAX];
+    int32_t record_len = 0;
+    bool    refilled   = false;
+
+    if( stream_spill_mount( obj ) == false )
+    {
+        return;
+    }
+
+    // records are added to ROSE only now, they are encrypted with the stream offset they get in the fifo
+    while( circularfs_peek( &obj->spill_fs, record, &record_len ) == 0 )
+    {
+        int err = ROSE_addRecord( &obj->ROSE, record, record_len );
+        if( err == ROSE_OVERRUN )
+        {
+            break;
+        }
+        if( err != ROSE_OK )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "Stream spill record dropped\n" );
+        }
+        circularfs_fetch( &obj->spill_fs, record, &record_len );
+        obj->spill_pending =
+            ( obj->spill_pending > ( uint32_t ) record_len + 1 ) ? ( obj->spill_pending - record_len - 1 ) : 0;
+        refilled = true;
+    }
+
+    if( refilled == true )
+    {
+        circularfs_discard( &obj->spill_fs );
+    }
+}
+
+static void stream_spill_clear( stream_obj_t* obj )
+{
+    obj->spill_pending = 0;
+
+    // an empty partition is not erased again
+    if( ( stream_spill_mount( obj ) == true ) && ( circularfs_count_estimate( &obj->spill_fs ) > 0 ) )
+    {
+        circularfs_format( &obj->spill_fs, false );
+    }
+}
+
+static int32_t stream_spill_op_sector_erase( struct circularfs_flash_partition* flash, uint32_t address )
+{
+    ( void ) flash;
+    smtc_modem_hal_context_flash_pages_erase( CONTEXT_STREAM_SPILL, address, 1 );
+    MODEM_PERF_COUNTER_ADD( MODEM_PERF_FLASH_ERASE_NB, 1 );
+    return 0;
+}
+
+static int32_t stream_spill_op_program( struct circularfs_flash_partition* flash, uint32_t address, const void* data,
+                                        uint32_t size )
+{
+    ( void ) flash;
+    smtc_modem_hal_context_store( CONTEXT_STREAM_SPILL, address, data, size );
+    return size;
+}
+
+static int32_t stream_spill_op_read( struct circularfs_flash_partition* flash, uint32_t address, void* data,
+                                     uint32_t size )
+{
+    ( void ) flash;
+    smtc_modem_hal_context_restore( CONTEXT_STREAM_SPILL, address, data, size );
+    return size;
+}
+#endif
+
 /* --- EOF ------------------------------------------------------------------ */
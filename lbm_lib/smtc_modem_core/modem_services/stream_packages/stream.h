@@ -55,6 +55,18 @@ extern "C" {
 #define STREAM_UPLINK_HEADER 0x14
 #define STREAM_DOWNLINK_HEADER 0x08
 
+/**
+ * @brief Number of streams of each stack, each one has its own ROSE buffer
+ */
+#ifndef NUMBER_OF_STREAMS
+#define NUMBER_OF_STREAMS ( 1 )
+#endif
+
+/**
+ * @brief Stream used by the single stream modem API and reported in the DM status
+ */
+#define STREAM_DEFAULT_ID ( 0 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -108,34 +120,60 @@ uint8_t stream_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data
 /*!
  * @brief   Initialize a new streaming session
  *
+ * @remark  Two streams of a stack can not share the same FPort, the server tells them apart with the FPort
+ *
+ * @param [in] stack_id                 Stack identifier
+ * @param [in] stream_id                Stream identifier, in [0, NUMBER_OF_STREAMS - 1]
+ * @param [in] f_port                   FPort of the stream, 0 for the DM FPort
+ * @param [in] encryption               Encrypt the records with the AppSKey
+ * @param [in] redundancy_ratio_percent Redundancy ratio
+ * @retval stream_return_code_t         STREAM_OK if successful,
+ *                                      STREAM_BUSY if another stream of the stack uses \p f_port,
+ *                                      STREAM_FAIL otherwise
+ */
+stream_return_code_t stream_init( uint8_t stack_id, uint8_t stream_id, uint8_t f_port, bool encryption,
+                                  uint8_t redundancy_ratio_percent );
+
+/*!
+ * @brief   Set the scheduling parameters of a stream
+ *
+ * @remark  The stream with pending data and the lowest priority value sends the next fragment. Streams of the same
+ * priority share the airtime in proportion of their weight. Streams start with priority 0 and weight 1
+ *
  * @param [in] stack_id             Stack identifier
- * @retval stream_return_code_t     STREAM_OK or STREAM_FAIL
+ * @param [in] stream_id            Stream identifier
+ * @param [in] priority             Priority, 0 is the highest
+ * @param [in] weight               Airtime weight among the streams of the same priority, from 1 to 255
+ * @retval stream_return_code_t     STREAM_OK if successful,
+ *                                  STREAM_FAIL if \p weight is 0
  */
-stream_return_code_t stream_init( uint8_t stack_id, uint8_t f_port, bool encryption, uint8_t redundancy_ratio_percent );
+stream_return_code_t stream_set_priority( uint8_t stack_id, uint8_t stream_id, uint8_t priority, uint8_t weight );
 
 /**
  * @brief Check if the encryption is enabled
  *
  * @param [in] stack_id             Stack identifier
+ * @param [in] stream_id            Stream identifier
  * @return true
  * @return false
  */
-bool stream_encrypted_mode( uint8_t stack_id );
+bool stream_encrypted_mode( uint8_t stack_id, uint8_t stream_id );
 
 /**
  * @brief Get the initialization status of the stream
  *
  * @param [in] stack_id Stack identifier
+ * @param [in] stream_id Stream identifier
  * @return true Stream has been initialized
  * @return false Otherwize
  */
-bool stream_get_init_status( uint8_t stack_id );
+bool stream_get_init_status( uint8_t stack_id, uint8_t stream_id );
 
 /**
  * @brief Get the current active status of stream service
  *
  * @param [in] stack_id Stack identifier
- * @return true if there is a data in stream buffer or ongoing upload
+ * @return true if there is a data in one of the stream buffers or ongoing upload
  * @return false otherwize
  */
 bool stream_get_status( uint8_t stack_id );
@@ -144,6 +182,7 @@ bool stream_get_status( uint8_t stack_id );
  * @brief   Add new data to be sent by the streaming session
  *
  * @param [in] stack_id             Stack identifier
+ * @param [in] stream_id            Stream identifier
  * @param [in] data                 Pointer to a buffer containing the new data
  * @param [in] len                  Length of the buffer
  *
@@ -154,12 +193,13 @@ bool stream_get_status( uint8_t stack_id );
  *                                      can not contain the additional data,
  *                                  STREAM_OVERRUN if the underlying ROSE buffer has overrun
  */
-stream_return_code_t stream_add_data( uint8_t stack_id, const uint8_t* data, uint8_t len );
+stream_return_code_t stream_add_data( uint8_t stack_id, uint8_t stream_id, const uint8_t* data, uint8_t len );
 
 /*!
  * @brief   Get current status of the stream contents
  *
  * @param [in]  stack_id            Stack identifier
+ * @param [in]  stream_id           Stream identifier
  * @param [out] pending             Pointer to store the amount of pending bytes to uplink
  * @param [out] free                Pointer to store the smount of free space in the underlying buffer
  *
@@ -167,34 +207,55 @@ stream_return_code_t stream_add_data( uint8_t stack_id, const uint8_t* data, uin
  *
  * @retval void
  */
-void stream_status( uint8_t stack_id, uint16_t* pending, uint16_t* free );
+void stream_status( uint8_t stack_id, uint8_t stream_id, uint16_t* pending, uint16_t* free );
 
 /*!
  * @brief    get the stream port
- * @param   [in]  void
+ * @param   [in]  stack_id            Stack identifier
+ * @param   [in]  stream_id           Stream identifier
  * @retval  [out] port
  */
-uint8_t stream_get_port( uint8_t stack_id );
+uint8_t stream_get_port( uint8_t stack_id, uint8_t stream_id );
 
 /**
  * @brief get stream redundancy
  *
  * @param [in] stack_id            Stack identifier
+ * @param [in] stream_id           Stream identifier
  * @retval stream_rr stream redundancy
  */
-uint8_t stream_get_rr( uint8_t stack_id );
+uint8_t stream_get_rr( uint8_t stack_id, uint8_t stream_id );
 
 /**
  * @brief set stream redundancy
  *
  * @param [in] stack_id            Stack identifier
+ * @param [in] stream_id           Stream identifier
  * @param [in] stream_rr           stream redundancy
  * @retval void
  */
-void stream_set_rr( uint8_t stack_id, uint8_t stream_rr );
+void stream_set_rr( uint8_t stack_id, uint8_t stream_id, uint8_t stream_rr );
+
+/**
+ * @brief Enable or disable the automatic stream redundancy
+ *
+ * @remark When enabled, one fragment every STREAM_AUTO_RR_PROBE_PERIOD is sent confirmed and the redundancy rate
+ * follows the uplink loss estimated from the acknowledgements, within [rr_min, rr_max]. A redundancy rate set by the
+ * server through a stream downlink disables the automatic mode
+ *
+ * @param [in] stack_id            Stack identifier
+ * @param [in] stream_id           Stream identifier
+ * @param [in] enable              Enable the automatic redundancy
+ * @param [in] rr_min              Lowest redundancy rate in percent, used on a loss free link
+ * @param [in] rr_max              Highest redundancy rate in percent
+ * @retval stream_return_code_t    STREAM_OK if successful,
+ *                                 STREAM_FAIL if rr_min is greater than rr_max
+ */
+stream_return_code_t stream_set_rr_auto( uint8_t stack_id, uint8_t stream_id, bool enable, uint8_t rr_min,
+                                         uint8_t rr_max );
 
 /**
- * @brief Stop properly stream service
+ * @brief Stop properly all the streams of a stack
  *
  * @param [in] stack_id Stack identifier
  */
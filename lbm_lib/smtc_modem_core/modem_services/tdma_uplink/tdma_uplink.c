@@ -0,0 +1,361 @@
+/**
+ * @file      tdma_uplink.c
+ *
+ * @brief     Time slotted application uplinks from the network time
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // memset
+#include "tdma_uplink.h"
+#include "lorawan_api.h"
+#include "modem_core.h"
+#include "modem_supervisor_light.h"
+#include "smtc_modem_hal.h"
+#include "smtc_modem_hal_dbg_trace.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#define CURRENT_STACK ( task_id / NUMBER_OF_TASKS )
+#define NUMBER_MAX_OF_TDMA_UPLINK_OBJ 1  // modify in case of multiple obj
+
+/**
+ * @brief Check is the index is valid before accessing TDMA uplink object
+ *
+ */
+#define IS_VALID_OBJECT_ID( x )                                               \
+    do                                                                        \
+    {                                                                         \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_MAX_OF_TDMA_UPLINK_OBJ ); \
+    } while( 0 )
+
+/**
+ * @brief Check is the index is valid before accessing the object
+ *
+ */
+#define IS_VALID_STACK_ID( x )                                   \
+    do                                                           \
+    {                                                            \
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( x < NUMBER_OF_STACKS ); \
+    } while( 0 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief TDMA uplink Object
+ *
+ * @struct tdma_uplink_s
+ */
+typedef struct tdma_uplink_s
+{
+    uint8_t stack_id;
+    uint8_t task_id;
+    bool    initialized;
+
+    uint32_t frame_ms;  // 0 when the slotting is disabled
+    uint16_t slot_ms;
+    uint16_t slot_index;
+    uint8_t  config_fport;
+} tdma_uplink_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static tdma_uplink_t tdma_uplink_obj[NUMBER_MAX_OF_TDMA_UPLINK_OBJ];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Callback called at task launch, the service has no task
+ *
+ * @param context_callback
+ */
+static void tdma_uplink_service_on_launch( void* context );
+
+/**
+ * @brief Callback called at task completion, the service has no task
+ *
+ * @param context_callback
+ */
+static void tdma_uplink_service_on_update( void* context );
+
+/**
+ * @brief Callback to handle the slot configuration downlinks
+ *
+ * @param rx_down_data
+ */
+static uint8_t tdma_uplink_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data );
+
+/**
+ * @brief Get the TDMA uplink object from the stack id
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [out] service_id  Service identifier
+ * @return tdma_uplink_t*   Object context, NULL if not found
+ */
+static tdma_uplink_t* tdma_uplink_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id );
+
+/**
+ * @brief Get the GPS time of a modem hal time, from the class B beacons when locked or from the DeviceTimeAns
+ *
+ * @param [in]  stack_id     Stack identifier
+ * @param [in]  rtc_ms       Modem hal time to convert
+ * @param [out] gps_ms       GPS time in ms
+ * @param [out] age_s        Time elapsed since the last time synchronization
+ * @return true if the network time is valid
+ */
+static bool tdma_uplink_get_gps_time_ms( uint8_t stack_id, uint32_t rtc_ms, uint64_t* gps_ms, uint32_t* age_s );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void tdma_uplink_services_init( uint8_t* service_id, uint8_t task_id,
+                                uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                                void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                                void** context_callback )
+{
+    IS_VALID_OBJECT_ID( *service_id );
+
+    tdma_uplink_t* ctx = &tdma_uplink_obj[*service_id];
+    memset( ctx, 0, sizeof( tdma_uplink_t ) );
+
+    *downlink_callback  = tdma_uplink_service_downlink_handler;
+    *on_launch_callback = tdma_uplink_service_on_launch;
+    *on_update_callback = tdma_uplink_service_on_update;
+    *context_callback   = ( void* ) service_id;
+
+    ctx->task_id     = task_id;
+    ctx->stack_id    = CURRENT_STACK;
+    ctx->initialized = true;
+}
+
+tdma_uplink_rc_t tdma_uplink_set_slots( uint8_t stack_id, uint32_t frame_ms, uint16_t slot_ms, uint16_t slot_index )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t        service_id;
+    tdma_uplink_t* ctx = tdma_uplink_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx == NULL )
+    {
+        return TDMA_UPLINK_RC_FAIL;
+    }
+
+    if( frame_ms == 0 )
+    {
+        ctx->frame_ms = 0;
+        return TDMA_UPLINK_RC_OK;
+    }
+
+    if( ( slot_ms == 0 ) || ( ( frame_ms % slot_ms ) != 0 ) ||
+        ( ( slot_index != TDMA_UPLINK_SLOT_FROM_DEVADDR ) && ( slot_index >= ( frame_ms / slot_ms ) ) ) )
+    {
+        return TDMA_UPLINK_RC_INVALID;
+    }
+
+    ctx->frame_ms   = frame_ms;
+    ctx->slot_ms    = slot_ms;
+    ctx->slot_index = slot_index;
+    return TDMA_UPLINK_RC_OK;
+}
+
+tdma_uplink_rc_t tdma_uplink_set_config_fport( uint8_t stack_id, uint8_t fport )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t        service_id;
+    tdma_uplink_t* ctx = tdma_uplink_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ctx == NULL )
+    {
+        return TDMA_UPLINK_RC_FAIL;
+    }
+    if( fport >= 224 )
+    {
+        return TDMA_UPLINK_RC_INVALID;
+    }
+    ctx->config_fport = fport;
+    return TDMA_UPLINK_RC_OK;
+}
+
+bool tdma_uplink_get_next_slot( uint8_t stack_id, uint32_t* target_time_ms )
+{
+    IS_VALID_STACK_ID( stack_id );
+    uint8_t        service_id;
+    tdma_uplink_t* ctx = tdma_uplink_get_ctx_from_stack_id( stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->frame_ms == 0 ) )
+    {
+        return false;
+    }
+
+    uint32_t earliest_ms = smtc_modem_hal_get_time_in_ms( ) + TDMA_UPLINK_MIN_LEAD_MS;
+    uint64_t gps_ms;
+    uint32_t age_s;
+    if( tdma_uplink_get_gps_time_ms( stack_id, earliest_ms, &gps_ms, &age_s ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TDMA uplink without network time, sent right away\n" );
+        return false;
+    }
+
+    // The local clock drifts from the network time since the last synchronization
+    uint32_t guard_ms = TDMA_UPLINK_TIME_ERROR_MS +
+                        ( uint32_t ) ( ( ( uint64_t ) age_s * lorawan_api_get_crystal_error( stack_id ) ) / 1000 );
+    if( ( 2 * guard_ms ) >= ctx->slot_ms )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TDMA uplink guard time %u ms exceeds the slot, sent right away\n", guard_ms );
+        return false;
+    }
+
+    uint32_t slot_index = ctx->slot_index;
+    if( slot_index == TDMA_UPLINK_SLOT_FROM_DEVADDR )
+    {
+        slot_index = lorawan_api_devaddr_get( stack_id ) % ( ctx->frame_ms / ctx->slot_ms );
+    }
+
+    uint32_t in_frame_ms = ( uint32_t ) ( gps_ms % ctx->frame_ms );
+    uint32_t start_ms    = ( slot_index * ctx->slot_ms ) + guard_ms;
+    uint32_t delay_ms    = ( start_ms >= in_frame_ms ) ? ( start_ms - in_frame_ms )
+                                                       : ( ( ctx->frame_ms - in_frame_ms ) + start_ms );
+
+    *target_time_ms = earliest_ms + delay_ms;
+    SMTC_MODEM_HAL_TRACE_PRINTF( "TDMA uplink in slot %u in %u ms, guard %u ms\n", slot_index,
+                                 *target_time_ms - smtc_modem_hal_get_time_in_ms( ), guard_ms );
+    return true;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void tdma_uplink_service_on_launch( void* context )
+{
+}
+
+static void tdma_uplink_service_on_update( void* context )
+{
+}
+
+static uint8_t tdma_uplink_service_downlink_handler( lr1_stack_mac_down_data_t* rx_down_data )
+{
+    uint8_t        service_id;
+    tdma_uplink_t* ctx = tdma_uplink_get_ctx_from_stack_id( rx_down_data->stack_id, &service_id );
+
+    if( ( ctx == NULL ) || ( ctx->config_fport == 0 ) )
+    {
+        return MODEM_DOWNLINK_UNCONSUMED;
+    }
+
+    if( ( rx_down_data->rx_metadata.rx_fport_present == true ) &&
+        ( rx_down_data->rx_metadata.rx_fport == ctx->config_fport ) &&
+        ( rx_down_data->rx_payload_size == TDMA_UPLINK_CMD_SET_SLOTS_SIZE ) &&
+        ( rx_down_data->rx_payload[0] == TDMA_UPLINK_CMD_SET_SLOTS ) )
+    {
+        const uint8_t* payload  = rx_down_data->rx_payload;
+        uint32_t       frame_ms = ( uint32_t ) payload[1] | ( ( uint32_t ) payload[2] << 8 ) |
+                            ( ( uint32_t ) payload[3] << 16 ) | ( ( uint32_t ) payload[4] << 24 );
+        uint16_t slot_ms    = ( uint16_t ) ( payload[5] | ( payload[6] << 8 ) );
+        uint16_t slot_index = ( uint16_t ) ( payload[7] | ( payload[8] << 8 ) );
+
+        if( tdma_uplink_set_slots( rx_down_data->stack_id, frame_ms, slot_ms, slot_index ) != TDMA_UPLINK_RC_OK )
+        {
+            SMTC_MODEM_HAL_TRACE_WARNING( "TDMA uplink invalid slots %u/%u/%u\n", frame_ms, slot_ms, slot_index );
+        }
+        return MODEM_DOWNLINK_CONSUMED;
+    }
+
+    return MODEM_DOWNLINK_UNCONSUMED;
+}
+
+static tdma_uplink_t* tdma_uplink_get_ctx_from_stack_id( uint8_t stack_id, uint8_t* service_id )
+{
+    tdma_uplink_t* ctx = NULL;
+    for( uint8_t i = 0; i < NUMBER_MAX_OF_TDMA_UPLINK_OBJ; i++ )
+    {
+        if( ( tdma_uplink_obj[i].initialized == true ) && ( tdma_uplink_obj[i].stack_id == stack_id ) )
+        {
+            ctx         = &tdma_uplink_obj[i];
+            *service_id = i;
+            break;
+        }
+    }
+    return ctx;
+}
+
+static bool tdma_uplink_get_gps_time_ms( uint8_t stack_id, uint32_t rtc_ms, uint64_t* gps_ms, uint32_t* age_s )
+{
+    uint32_t seconds_since_epoch;
+    uint32_t fractional_second;
+
+#if defined( ADD_CLASS_B )
+    uint32_t age_ms;
+    if( lorawan_api_beacon_get_gps_time( rtc_ms, &seconds_since_epoch, &fractional_second, &age_ms, stack_id ) ==
+        true )
+    {
+        *gps_ms = ( ( uint64_t ) seconds_since_epoch * 1000 ) + fractional_second;
+        *age_s  = age_ms / 1000;
+        return true;
+    }
+#endif
+    if( lorawan_api_convert_rtc_to_gps_epoch_time( rtc_ms, &seconds_since_epoch, &fractional_second, stack_id ) ==
+        true )
+    {
+        *gps_ms = ( ( uint64_t ) seconds_since_epoch * 1000 ) + fractional_second;
+        *age_s  = smtc_modem_hal_get_time_in_s( ) - lorawan_api_get_timestamp_last_device_time_ans_s( stack_id );
+        return true;
+    }
+    return false;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,169 @@
+/**
+ * @file      tdma_uplink.h
+ *
+ * @brief     Time slotted application uplinks from the network time
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TDMA_UPLINK_H
+#define TDMA_UPLINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include "lr1_stack_mac_layer.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/**
+ * @brief Slot index derived from the DevAddr: DevAddr modulo the number of slots of the frame
+ */
+#define TDMA_UPLINK_SLOT_FROM_DEVADDR ( 0xFFFF )
+
+/**
+ * @brief Downlink command setting the slots, sent by the server on the configuration FPort
+ *
+ * Payload, little endian: command (1) | frame duration in ms (4) | slot duration in ms (2) | slot index (2), a frame
+ * duration of 0 disables the slotting
+ */
+#define TDMA_UPLINK_CMD_SET_SLOTS ( 0x01 )
+#define TDMA_UPLINK_CMD_SET_SLOTS_SIZE ( 9 )
+
+/**
+ * @brief Error of the network time when just synchronized, in ms on each side of the slot
+ */
+#ifndef TDMA_UPLINK_TIME_ERROR_MS
+#define TDMA_UPLINK_TIME_ERROR_MS ( 20 )
+#endif
+
+/**
+ * @brief Shortest delay between the uplink request and the start of the slot
+ */
+#ifndef TDMA_UPLINK_MIN_LEAD_MS
+#define TDMA_UPLINK_MIN_LEAD_MS ( 200 )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Definition of return codes for TDMA uplink functions
+ *
+ * @enum tdma_uplink_rc_t
+ */
+typedef enum tdma_uplink_rc_e
+{
+    TDMA_UPLINK_RC_OK,       //!< Function executed without error
+    TDMA_UPLINK_RC_INVALID,  //!< Invalid parameters
+    TDMA_UPLINK_RC_FAIL,     //!< Fail to execute the function
+} tdma_uplink_rc_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init the TDMA uplink services object
+ *
+ * @param service_id
+ * @param task_id
+ * @param downlink_callback
+ * @param on_launch_callback
+ * @param on_update_callback
+ * @param context_callback
+ */
+void tdma_uplink_services_init( uint8_t* service_id, uint8_t task_id,
+                                uint8_t ( **downlink_callback )( lr1_stack_mac_down_data_t* ),
+                                void ( **on_launch_callback )( void* ), void ( **on_update_callback )( void* ),
+                                void** context_callback );
+
+/**
+ * @brief Set the uplink slots: the GPS time is cut in frames of frame_ms, each cut in slots of slot_ms, the device
+ *        sends its application uplinks in the slot of slot_index of the next frame
+ *
+ * @remark The uplink starts after a guard time from the start of the slot: TDMA_UPLINK_TIME_ERROR_MS plus the crystal
+ * error (smtc_modem_set_crystal_error_ppm()) over the age of the network time. The slot shall hold the uplink time on
+ * air and the guard time on both sides. The network time comes from the class B beacons when locked, from the
+ * DeviceTimeAns otherwise
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [in] frame_ms     Frame duration in ms, 0 to send the uplinks as soon as requested
+ * @param [in] slot_ms      Slot duration in ms, frame_ms shall be a multiple of it
+ * @param [in] slot_index   Slot of the device in the frame, or TDMA_UPLINK_SLOT_FROM_DEVADDR
+ * @return tdma_uplink_rc_t
+ */
+tdma_uplink_rc_t tdma_uplink_set_slots( uint8_t stack_id, uint32_t frame_ms, uint16_t slot_ms, uint16_t slot_index );
+
+/**
+ * @brief Set the FPort of the TDMA_UPLINK_CMD_SET_SLOTS downlinks
+ *
+ * @param [in] stack_id     Stack identifier
+ * @param [in] fport        Configuration FPort, 0 to ignore the downlinks
+ * @return tdma_uplink_rc_t
+ */
+tdma_uplink_rc_t tdma_uplink_set_config_fport( uint8_t stack_id, uint8_t fport );
+
+/**
+ * @brief Get the start time of the next slot of the device
+ *
+ * @param [in]  stack_id        Stack identifier
+ * @param [out] target_time_ms  Uplink start time in modem hal time, guard time included
+ * @return true if the uplink shall be sent at target_time_ms, false if the slotting is disabled or the network time
+ * is not valid or too old for the guard time to fit in the slot
+ */
+bool tdma_uplink_get_next_slot( uint8_t stack_id, uint32_t* target_time_ms );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDMA_UPLINK_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -52,6 +52,7 @@
 #include "smtc_duty_cycle.h"
 #include "modem_event_utilities.h"
 #include "modem_tx_protocol_manager.h"
+#include "modem_perf_counters.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -62,6 +63,21 @@
 #define LR1MAC_PERIOD_RETRANS_MS 1000
 #define MODEM_MAX_ALARM_S 0x7FFFFFFF
 #define SUPERVISOR_PERIOD_FAILSAFE_S 120
+#define SUPERVISOR_NB_TASKS ( NUMBER_OF_TASKS * NUMBER_OF_STACKS )
+#define SUPERVISOR_NOT_QUEUED 0xFF
+
+/*!
+ * Task dates are kept in ms on 32 bits: delays are clamped to keep all the dates comparable, a clamped task is put
+ * back at its date in second when the clamped date is reached
+ */
+#define SUPERVISOR_MAX_DELAY_MS 0x3FFFFFFF
+
+#if defined( ADD_STACK_FAIRNESS )
+/*!
+ * Airtime quotas are counted over fixed windows, the window of a stack restarts when it is over
+ */
+#define SUPERVISOR_STACK_QUOTA_WINDOW_S 3600
+#endif
 
 /*
  *-----------------------------------------------------------------------------------
@@ -113,6 +129,30 @@ struct
     void ( *supervisor_on_update_func[NUMBER_OF_TASKS] )( void* );
 
     bool is_duty_cycle_constraint_enabled[NUMBER_OF_STACKS];
+
+    // min-heap of the queued tasks sorted by execution date in ms
+    uint32_t time_to_execute_ms[SUPERVISOR_NB_TASKS];
+    bool     is_time_clamped[SUPERVISOR_NB_TASKS];
+    uint8_t  nb_time_clamped;
+    uint8_t  task_heap[SUPERVISOR_NB_TASKS];
+    uint8_t  task_heap_position[SUPERVISOR_NB_TASKS];
+    uint8_t  task_heap_size;
+
+    void ( *engine_wakeup_callback )( void );
+    bool is_engine_running;
+
+#if defined( ADD_STACK_FAIRNESS )
+    uint32_t stack_quota_ms[NUMBER_OF_STACKS];
+    uint32_t stack_quota_window_start_s[NUMBER_OF_STACKS];
+    uint32_t stack_quota_window_airtime_ms[NUMBER_OF_STACKS];
+    bool     is_stack_quota_reached[NUMBER_OF_STACKS];
+    uint32_t stack_quota_deferrals[NUMBER_OF_STACKS];
+#endif
+
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+    bool    is_nwk_ans_deferred;
+    uint8_t nwk_ans_deferred_stack_id;
+#endif
 } modem_supervisor_context;
 
 /* clang-format off */
@@ -124,6 +164,29 @@ struct
 
 #define is_duty_cycle_constraint_enabled modem_supervisor_context.is_duty_cycle_constraint_enabled
 
+#define time_to_execute_ms modem_supervisor_context.time_to_execute_ms
+#define is_time_clamped modem_supervisor_context.is_time_clamped
+#define nb_time_clamped modem_supervisor_context.nb_time_clamped
+#define task_heap modem_supervisor_context.task_heap
+#define task_heap_position modem_supervisor_context.task_heap_position
+#define task_heap_size modem_supervisor_context.task_heap_size
+
+#define engine_wakeup_callback modem_supervisor_context.engine_wakeup_callback
+#define is_engine_running modem_supervisor_context.is_engine_running
+
+#if defined( ADD_STACK_FAIRNESS )
+#define stack_quota_ms modem_supervisor_context.stack_quota_ms
+#define stack_quota_window_start_s modem_supervisor_context.stack_quota_window_start_s
+#define stack_quota_window_airtime_ms modem_supervisor_context.stack_quota_window_airtime_ms
+#define is_stack_quota_reached modem_supervisor_context.is_stack_quota_reached
+#define stack_quota_deferrals modem_supervisor_context.stack_quota_deferrals
+#endif
+
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+#define is_nwk_ans_deferred modem_supervisor_context.is_nwk_ans_deferred
+#define nwk_ans_deferred_stack_id modem_supervisor_context.nwk_ans_deferred_stack_id
+#endif
+
 /* clang-format on */
 
 /*
@@ -131,9 +194,31 @@ struct
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
-static uint32_t supervisor_check_user_alarm( void );
-static uint32_t supervisor_run_lorawan_engine( uint8_t stack_id );
-static uint32_t supervisor_find_next_task( void );
+static uint32_t     supervisor_check_user_alarm( void );
+static uint32_t     supervisor_run_lorawan_engine( uint8_t stack_id );
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+static bool supervisor_is_send_task_ready( uint8_t stack_id );
+#endif
+static uint32_t     supervisor_find_next_task( void );
+static task_valid_t supervisor_add_task( smodem_task* task );
+
+static void supervisor_set_task_time( uint8_t task_index, int32_t delay_ms, bool is_clamped );
+static void supervisor_set_task_time_from_s( uint8_t task_index, uint32_t time_to_execute_s );
+static void supervisor_refresh_clamped_tasks( uint32_t now_ms );
+static void supervisor_task_finish( uint8_t task_index );
+static bool supervisor_is_task_eligible( uint8_t task_index, const uint8_t* available_stack );
+static bool supervisor_is_task_served_before( uint8_t task_index_a, int32_t time_a, uint8_t task_index_b,
+                                              int32_t time_b );
+#if defined( ADD_STACK_FAIRNESS )
+static int32_t supervisor_check_stack_quota( uint8_t stack_id, uint32_t now_s );
+#endif
+
+static bool supervisor_heap_is_before( uint8_t task_index_a, uint8_t task_index_b );
+static void supervisor_heap_swap( uint8_t position_a, uint8_t position_b );
+static void supervisor_heap_sift_up( uint8_t position );
+static void supervisor_heap_sift_down( uint8_t position );
+static void supervisor_heap_insert( uint8_t task_index );
+static void supervisor_heap_remove( uint8_t task_index );
 
 static void supervisor_idle_task_on_launch( void* context );
 static void supervisor_idle_task_on_update( void* context );
@@ -153,8 +238,16 @@ void modem_supervisor_init( void )
         task_manager.modem_task[i].id             = ( task_id_t ) i;
         task_manager.modem_task[i].stack_id       = 0;
         task_manager.modem_task[i].updated_locked = false;
+
+        time_to_execute_ms[i] = 0;
+        is_time_clamped[i]    = false;
+        task_heap_position[i] = SUPERVISOR_NOT_QUEUED;
     }
     task_manager.next_task_id = IDLE_TASK;
+    nb_time_clamped           = 0;
+    task_heap_size            = 0;
+    engine_wakeup_callback    = NULL;
+    is_engine_running         = false;
 
     for( uint8_t i = 0; i < NUMBER_OF_TASKS; i++ )
     {
@@ -167,6 +260,13 @@ void modem_supervisor_init( void )
     {
         task_manager.modem_mute_with_priority[i] = TASK_LOW_PRIORITY;
         is_duty_cycle_constraint_enabled[i]      = false;
+#if defined( ADD_STACK_FAIRNESS )
+        stack_quota_ms[i]                = 0;
+        stack_quota_window_start_s[i]    = smtc_modem_hal_get_time_in_s( );
+        stack_quota_window_airtime_ms[i] = 0;
+        is_stack_quota_reached[i]        = false;
+        stack_quota_deferrals[i]         = 0;
+#endif
     }
 
     modem_supervisor_init_callback( IDLE_TASK, supervisor_idle_task_on_launch, supervisor_idle_task_on_update,
@@ -219,7 +319,7 @@ task_valid_t modem_supervisor_remove_task( uint16_t id )
 {
     if( id < NUMBER_OF_TASKS * NUMBER_OF_STACKS )
     {
-        task_manager.modem_task[id].priority     = TASK_FINISH;
+        supervisor_task_finish( id );
         task_manager.modem_task[id].task_enabled = false;
         return TASK_VALID;
     }
@@ -229,24 +329,29 @@ task_valid_t modem_supervisor_remove_task( uint16_t id )
 
 task_valid_t modem_supervisor_add_task( smodem_task* task )
 {
-    // the modem supervisor always accept a new task.
-    // in case of a previous task is already enqueue , the new task remove the old one.
-    // as soon as a task has been elected by the modem supervisor , the task is managed by the stack itself and a new
-    // task could be added inside the modem supervisor.
+    task_valid_t status = supervisor_add_task( task );
 
-    if( task->id < NUMBER_OF_TASKS * NUMBER_OF_STACKS )
+    if( status == TASK_VALID )
     {
-        uint8_t task_index                                    = task->id;
-        task_manager.modem_task[task_index].time_to_execute_s = task->time_to_execute_s;
-        task_manager.modem_task[task_index].priority          = task->priority;
-        task_manager.modem_task[task_index].stack_id          = task->stack_id;
-        task_manager.modem_task[task_index].task_context      = task->task_context;
-        task_manager.modem_task[task_index].task_enabled      = true;
-        task_manager.modem_task[task_index].updated_locked    = task->updated_locked;
-        return TASK_VALID;
+        modem_supervisor_notify_engine_wakeup( );
     }
-    SMTC_MODEM_HAL_TRACE_ERROR( "modem_supervisor_add_task id = %d unknown\n", task->id );
-    return TASK_NOT_VALID;
+    return status;
+}
+
+task_valid_t modem_supervisor_add_task_in_ms( smodem_task* task, uint32_t delay_ms )
+{
+    task->time_to_execute_s = smtc_modem_hal_get_time_in_s( ) + ( delay_ms / 1000 );
+
+    if( supervisor_add_task( task ) != TASK_VALID )
+    {
+        return TASK_NOT_VALID;
+    }
+    if( delay_ms <= SUPERVISOR_MAX_DELAY_MS )
+    {
+        supervisor_set_task_time( task->id, ( int32_t ) delay_ms, false );
+    }
+    modem_supervisor_notify_engine_wakeup( );
+    return TASK_VALID;
 }
 
 stask_manager* modem_supervisor_get_task( void )
@@ -254,6 +359,24 @@ stask_manager* modem_supervisor_get_task( void )
     return ( &task_manager );
 }
 
+void modem_supervisor_set_engine_wakeup_callback( void ( *wakeup_callback )( void ) )
+{
+    engine_wakeup_callback = wakeup_callback;
+}
+
+void modem_supervisor_set_engine_running( bool is_running )
+{
+    is_engine_running = is_running;
+}
+
+void modem_supervisor_notify_engine_wakeup( void )
+{
+    if( ( is_engine_running == false ) && ( engine_wakeup_callback != NULL ) )
+    {
+        engine_wakeup_callback( );
+    }
+}
+
 // backoff_mobile_static( ); @todo//
 // todo check_class_b_to_generate_event( );
 
@@ -300,8 +423,19 @@ uint32_t modem_supervisor_engine( void )
     {
         task_manager.modem_task[task_manager.next_task_id].launched_timestamp = smtc_modem_hal_get_time_in_s( );
         supervisor_on_launch_func[CURRENT_TASK_ID]( supervisor_context_callback[CURRENT_TASK_ID] );
-        task_manager.modem_task[task_manager.next_task_id].priority = TASK_FINISH;
+        supervisor_task_finish( task_manager.next_task_id );
     }
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+    if( is_nwk_ans_deferred == true )
+    {
+        is_nwk_ans_deferred = false;
+        if( lorawan_api_state_get( nwk_ans_deferred_stack_id ) == LWPSTATE_TX_WAIT )
+        {
+            tx_protocol_manager_lr1mac_stand_alone_tx( );
+            sleep_time = MIN( sleep_time, LR1MAC_PERIOD_RETRANS_MS );
+        }
+    }
+#endif
     uint32_t alarm                 = modem_get_user_alarm( );
     int32_t  user_alarm_in_seconds = MODEM_MAX_ALARM_S / 1000;
     if( alarm != 0 )
@@ -324,6 +458,10 @@ bool modem_supervisor_get_modem_is_suspended( uint8_t stack_id )
 void modem_supervisor_set_modem_is_suspended( bool suspend, uint8_t stack_id )
 {
     task_manager.modem_is_suspended[stack_id] = suspend;
+    if( suspend == false )
+    {
+        modem_supervisor_notify_engine_wakeup( );
+    }
 }
 
 task_priority_t modem_supervisor_get_modem_mute_with_priority_parameter( uint8_t stack_id )
@@ -336,8 +474,42 @@ void modem_supervisor_set_modem_mute_with_priority_parameter( task_priority_t pr
     if( priority_level < TASK_FINISH )
     {
         task_manager.modem_mute_with_priority[stack_id] = priority_level;
+        modem_supervisor_notify_engine_wakeup( );
+    }
+}
+
+#if defined( ADD_STACK_FAIRNESS )
+bool modem_supervisor_set_stack_weight( uint8_t stack_id, uint8_t weight )
+{
+    return rp_set_stack_weight( modem_get_rp( ), stack_id, weight ) == RP_HOOK_STATUS_OK;
+}
+
+bool modem_supervisor_set_stack_airtime_quota( uint8_t stack_id, uint32_t quota_ms )
+{
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return false;
+    }
+    // A new quota starts a new window
+    stack_quota_ms[stack_id]                = quota_ms;
+    stack_quota_window_start_s[stack_id]    = smtc_modem_hal_get_time_in_s( );
+    stack_quota_window_airtime_ms[stack_id] = rp_get_stack_airtime_ms( modem_get_rp( ), stack_id );
+    is_stack_quota_reached[stack_id]        = false;
+    modem_supervisor_notify_engine_wakeup( );
+    return true;
+}
+
+bool modem_supervisor_get_stack_airtime_stats( uint8_t stack_id, uint32_t* airtime_ms, uint32_t* quota_deferrals )
+{
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return false;
     }
+    *airtime_ms      = rp_get_stack_airtime_ms( modem_get_rp( ), stack_id );
+    *quota_deferrals = stack_quota_deferrals[stack_id];
+    return true;
 }
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -372,6 +544,18 @@ static uint32_t supervisor_run_lorawan_engine( uint8_t stack_id )
 
     if( lorawan_state == LWPSTATE_TX_WAIT )
     {
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+        // MAC answers waiting while an application uplink is ready: launch the uplink first, the TPM moves the
+        // answers in its FOpts, modem_supervisor_engine sends them on their own otherwise
+        if( ( lorawan_api_stack_mac_get( stack_id )->nwk_ans_pending == true ) &&
+            ( task_manager.modem_task[task_manager.next_task_id].updated_locked == false ) &&
+            ( supervisor_is_send_task_ready( stack_id ) == true ) )
+        {
+            is_nwk_ans_deferred       = true;
+            nwk_ans_deferred_stack_id = stack_id;
+            return 0;
+        }
+#endif
         tx_protocol_manager_lr1mac_stand_alone_tx( );
         sleep_time = ( LR1MAC_PERIOD_RETRANS_MS );
     }
@@ -383,11 +567,27 @@ static uint32_t supervisor_run_lorawan_engine( uint8_t stack_id )
     return sleep_time;
 }
 
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+static bool supervisor_is_send_task_ready( uint8_t stack_id )
+{
+    uint8_t task_index = SEND_TASK + ( NUMBER_OF_TASKS * stack_id );
+
+    return ( task_manager.modem_task[task_index].priority != TASK_FINISH ) &&
+           ( task_manager.modem_task[task_index].priority <= task_manager.modem_mute_with_priority[stack_id] ) &&
+           ( task_manager.modem_is_suspended[stack_id] == false ) &&
+           ( ( int32_t ) ( time_to_execute_ms[task_index] - smtc_modem_hal_get_time_in_ms( ) ) <= 0 );
+}
+#endif
+
 static uint32_t supervisor_find_next_task( void )
 {
     // Find stacks that can continue to send uplink frame in regard of duty-cycle regulation
     int32_t dtc_ms                            = MODEM_MAX_TIME;
     uint8_t available_stack[NUMBER_OF_STACKS] = { 0 };
+#if defined( ADD_STACK_FAIRNESS )
+    int32_t  quota_ms = MODEM_MAX_TIME * 1000;
+    uint32_t now_s    = smtc_modem_hal_get_time_in_s( );
+#endif
 
     for( uint8_t i = 0; i < NUMBER_OF_STACKS; i++ )
     {
@@ -408,6 +608,7 @@ static uint32_t supervisor_find_next_task( void )
             {
                 is_duty_cycle_constraint_enabled[i] = true;
                 increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE, 1, i );
+                MODEM_PERF_DTC_BLOCKED( i, true );
             }
         }
         // Generate event for duty-cycle free
@@ -417,82 +618,364 @@ static uint32_t supervisor_find_next_task( void )
             {
                 is_duty_cycle_constraint_enabled[i] = false;
                 increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE, 0, i );
+                MODEM_PERF_DTC_BLOCKED( i, false );
             }
         }
+
+#if defined( ADD_STACK_FAIRNESS )
+        // A stack over its airtime quota waits for its next window like a duty-cycle constraint, without the event
+        int32_t quota_ms_tmp = supervisor_check_stack_quota( i, now_s );
+        if( quota_ms_tmp > 0 )
+        {
+            available_stack[i] = 0;
+            quota_ms           = MIN( quota_ms, quota_ms_tmp );
+        }
+#endif
     }
 
+    uint32_t now_ms = smtc_modem_hal_get_time_in_ms( );
+    supervisor_refresh_clamped_tasks( now_ms );
+
+    // Walk the heap from its root, the subtree of a task in the future only holds tasks in the future
+    uint8_t         heap_stack[SUPERVISOR_NB_TASKS];
+    uint8_t         heap_stack_size    = 0;
+    uint8_t         next_task_index    = SUPERVISOR_NOT_QUEUED;
     task_priority_t next_task_priority = TASK_FINISH;
-    int32_t         next_task_time     = MODEM_MAX_TIME;
+    int32_t         next_task_time     = 0;
 
-    // Find the highest priority task in the past
-    for( uint8_t stack_id = 0; stack_id < NUMBER_OF_STACKS; stack_id++ )
+    // Find the highest priority task in the past, the earliest one or the one of the least served stack in case of
+    // equal priority
+    if( task_heap_size > 0 )
     {
-        for( task_id_t k = 0; k < NUMBER_OF_TASKS; k++ )
+        heap_stack[heap_stack_size++] = 0;
+    }
+    while( heap_stack_size > 0 )
+    {
+        uint8_t position           = heap_stack[--heap_stack_size];
+        uint8_t i                  = task_heap[position];
+        int32_t next_task_time_tmp = ( int32_t ) ( time_to_execute_ms[i] - now_ms );
+
+        if( next_task_time_tmp > 0 )
         {
-            uint8_t i = ( stack_id * NUMBER_OF_TASKS ) + k;
-            if( ( task_manager.modem_task[i].priority != TASK_FINISH ) &&
-                ( task_manager.modem_task[i].priority <= task_manager.modem_mute_with_priority[stack_id] ) &&
-                ( task_manager.modem_is_suspended[stack_id] == false ) )
-            {
-                int32_t next_task_time_tmp =
-                    ( int32_t ) ( task_manager.modem_task[i].time_to_execute_s - smtc_modem_hal_get_time_in_s( ) );
-
-                if( ( next_task_time_tmp <= 0 ) && ( task_manager.modem_task[i].priority <= next_task_priority ) &&
-                    ( next_task_time_tmp <= next_task_time ) &&
-                    ( ( available_stack[stack_id] == 1 ) ||
-                      ( ( available_stack[stack_id] == 0 ) &&
-                        ( task_manager.modem_task[i].priority == TASK_BYPASS_DUTY_CYCLE ) ) ) )
-                {
-                    next_task_priority        = task_manager.modem_task[i].priority;
-                    next_task_time            = next_task_time_tmp;
-                    task_manager.next_task_id = ( task_id_t ) i;
-                }
-            }
+            continue;
+        }
+        if( ( supervisor_is_task_eligible( i, available_stack ) == true ) &&
+            ( ( task_manager.modem_task[i].priority < next_task_priority ) ||
+              ( ( task_manager.modem_task[i].priority == next_task_priority ) &&
+                ( supervisor_is_task_served_before( i, next_task_time_tmp, next_task_index, next_task_time ) ==
+                  true ) ) ) )
+        {
+            next_task_priority = task_manager.modem_task[i].priority;
+            next_task_time     = next_task_time_tmp;
+            next_task_index    = i;
+        }
+        for( uint8_t child = ( 2 * position ) + 1; ( child <= ( 2 * position ) + 2 ) && ( child < task_heap_size );
+             child++ )
+        {
+            heap_stack[heap_stack_size++] = child;
         }
     }
 
-    // No task in the past was found, select the least in the future for wake up
-    if( next_task_priority == TASK_FINISH )
+    if( next_task_index != SUPERVISOR_NOT_QUEUED )
+    {
+        task_manager.next_task_id = ( task_id_t ) next_task_index;
+        return 0;
+    }
+
+    // No task in the past was found, select the least in the future for wake up: subtrees that can't hold an earlier
+    // task than the current one are skipped
+    next_task_time = MODEM_MAX_TIME * 1000;
+    if( task_heap_size > 0 )
+    {
+        heap_stack[heap_stack_size++] = 0;
+    }
+    while( heap_stack_size > 0 )
     {
-        for( uint8_t stack_id = 0; stack_id < NUMBER_OF_STACKS; stack_id++ )
+        uint8_t position           = heap_stack[--heap_stack_size];
+        uint8_t i                  = task_heap[position];
+        int32_t next_task_time_tmp = ( int32_t ) ( time_to_execute_ms[i] - now_ms );
+
+        if( next_task_time_tmp >= next_task_time )
         {
-            for( task_id_t k = 0; k < NUMBER_OF_TASKS; k++ )
-            {
-                uint8_t i = ( stack_id * NUMBER_OF_TASKS ) + k;
-                if( ( task_manager.modem_task[i].priority != TASK_FINISH ) &&
-                    ( task_manager.modem_task[i].priority <= task_manager.modem_mute_with_priority[stack_id] ) &&
-                    ( task_manager.modem_is_suspended[stack_id] == false ) )
-                {
-                    int32_t next_task_time_tmp =
-                        ( int32_t ) ( task_manager.modem_task[i].time_to_execute_s - smtc_modem_hal_get_time_in_s( ) );
-                    if( ( next_task_time_tmp < next_task_time ) &&
-                        ( ( available_stack[stack_id] == 1 ) ||
-                          ( ( available_stack[stack_id] == 0 ) &&
-                            ( task_manager.modem_task[i].priority == TASK_BYPASS_DUTY_CYCLE ) ) ) )
-                    {
-                        next_task_time            = next_task_time_tmp;
-                        task_manager.next_task_id = ( task_id_t ) i;
-                    }
-                }
-            }
+            continue;
+        }
+        if( ( next_task_time_tmp > 0 ) && ( supervisor_is_task_eligible( i, available_stack ) == true ) )
+        {
+            next_task_time = next_task_time_tmp;
+            continue;
         }
+        for( uint8_t child = ( 2 * position ) + 1; ( child <= ( 2 * position ) + 2 ) && ( child < task_heap_size );
+             child++ )
+        {
+            heap_stack[heap_stack_size++] = child;
+        }
+    }
+
+    task_manager.next_task_id = IDLE_TASK;
+#if defined( ADD_STACK_FAIRNESS )
+    // Wake up at the end of the quota window to run the tasks held back
+    if( quota_ms < next_task_time )
+    {
+        next_task_time = quota_ms;
     }
-    if( ( dtc_ms > 0 ) && ( next_task_time == MODEM_MAX_TIME ) )
+#endif
+    if( ( dtc_ms > 0 ) && ( next_task_time == ( MODEM_MAX_TIME * 1000 ) ) )
     {
         SMTC_MODEM_HAL_TRACE_WARNING_DEBUG( "Duty Cycle, remaining time: %dms\n", dtc_ms );
-        task_manager.next_task_id = IDLE_TASK;
         return ( dtc_ms );
     }
 
-    if( next_task_time > 0 )
+    return ( uint32_t ) next_task_time;
+}
+
+static task_valid_t supervisor_add_task( smodem_task* task )
+{
+    // the modem supervisor always accept a new task.
+    // in case of a previous task is already enqueue , the new task remove the old one.
+    // as soon as a task has been elected by the modem supervisor , the task is managed by the stack itself and a new
+    // task could be added inside the modem supervisor.
+
+    if( task->id < NUMBER_OF_TASKS * NUMBER_OF_STACKS )
     {
-        task_manager.next_task_id = IDLE_TASK;
-        return ( next_task_time * 1000 );
+        uint8_t task_index                                    = task->id;
+        task_manager.modem_task[task_index].time_to_execute_s = task->time_to_execute_s;
+        task_manager.modem_task[task_index].priority          = task->priority;
+        task_manager.modem_task[task_index].stack_id          = task->stack_id;
+        task_manager.modem_task[task_index].task_context      = task->task_context;
+        task_manager.modem_task[task_index].task_enabled      = true;
+        task_manager.modem_task[task_index].updated_locked    = task->updated_locked;
+        supervisor_set_task_time_from_s( task_index, task->time_to_execute_s );
+        return TASK_VALID;
+    }
+    SMTC_MODEM_HAL_TRACE_ERROR( "modem_supervisor_add_task id = %d unknown\n", task->id );
+    return TASK_NOT_VALID;
+}
+
+static void supervisor_set_task_time( uint8_t task_index, int32_t delay_ms, bool is_clamped )
+{
+    if( ( is_clamped == true ) && ( is_time_clamped[task_index] == false ) )
+    {
+        nb_time_clamped++;
+    }
+    else if( ( is_clamped == false ) && ( is_time_clamped[task_index] == true ) )
+    {
+        nb_time_clamped--;
+    }
+    is_time_clamped[task_index] = is_clamped;
+    time_to_execute_ms[task_index] = smtc_modem_hal_get_time_in_ms( ) + ( uint32_t ) delay_ms;
+
+    // An already queued task is moved at its new date
+    supervisor_heap_remove( task_index );
+    supervisor_heap_insert( task_index );
+}
+
+static void supervisor_set_task_time_from_s( uint8_t task_index, uint32_t time_to_execute_s )
+{
+    int32_t delay_s = ( int32_t ) ( time_to_execute_s - smtc_modem_hal_get_time_in_s( ) );
+
+    if( delay_s > ( SUPERVISOR_MAX_DELAY_MS / 1000 ) )
+    {
+        supervisor_set_task_time( task_index, SUPERVISOR_MAX_DELAY_MS, true );
+    }
+    else if( delay_s < -( SUPERVISOR_MAX_DELAY_MS / 1000 ) )
+    {
+        supervisor_set_task_time( task_index, -SUPERVISOR_MAX_DELAY_MS, false );
     }
     else
     {
+        supervisor_set_task_time( task_index, delay_s * 1000, false );
+    }
+}
+
+static void supervisor_refresh_clamped_tasks( uint32_t now_ms )
+{
+    if( nb_time_clamped == 0 )
+    {
+        return;
+    }
+    for( uint8_t i = 0; i < SUPERVISOR_NB_TASKS; i++ )
+    {
+        if( ( is_time_clamped[i] == true ) && ( task_heap_position[i] != SUPERVISOR_NOT_QUEUED ) &&
+            ( ( int32_t ) ( time_to_execute_ms[i] - now_ms ) <= 0 ) )
+        {
+            supervisor_set_task_time_from_s( i, task_manager.modem_task[i].time_to_execute_s );
+        }
+    }
+}
+
+static void supervisor_task_finish( uint8_t task_index )
+{
+    task_manager.modem_task[task_index].priority = TASK_FINISH;
+    supervisor_heap_remove( task_index );
+    if( is_time_clamped[task_index] == true )
+    {
+        is_time_clamped[task_index] = false;
+        nb_time_clamped--;
+    }
+}
+
+static bool supervisor_is_task_eligible( uint8_t task_index, const uint8_t* available_stack )
+{
+    uint8_t stack_id = task_index / NUMBER_OF_TASKS;
+
+    return ( task_manager.modem_task[task_index].priority <= task_manager.modem_mute_with_priority[stack_id] ) &&
+           ( task_manager.modem_is_suspended[stack_id] == false ) &&
+           ( ( available_stack[stack_id] == 1 ) ||
+             ( task_manager.modem_task[task_index].priority == TASK_BYPASS_DUTY_CYCLE ) );
+}
+
+static bool supervisor_is_task_served_before( uint8_t task_index_a, int32_t time_a, uint8_t task_index_b,
+                                              int32_t time_b )
+{
+    if( task_index_b == SUPERVISOR_NOT_QUEUED )
+    {
+        return true;
+    }
+#if defined( ADD_STACK_FAIRNESS )
+    uint8_t stack_id_a = task_index_a / NUMBER_OF_TASKS;
+    uint8_t stack_id_b = task_index_b / NUMBER_OF_TASKS;
+
+    if( stack_id_a != stack_id_b )
+    {
+        if( rp_is_stack_served_before( modem_get_rp( ), stack_id_a, stack_id_b ) == true )
+        {
+            return true;
+        }
+        if( rp_is_stack_served_before( modem_get_rp( ), stack_id_b, stack_id_a ) == true )
+        {
+            return false;
+        }
+    }
+#endif
+    return time_a < time_b;
+}
+
+#if defined( ADD_STACK_FAIRNESS )
+/**
+ * @brief Restart the quota window of a stack when it is over and check the airtime used in the window
+ *
+ * @param [in] stack_id stack identifier
+ * @param [in] now_s    current time in s
+ * @return int32_t time in ms until the end of the window if the stack is over its quota, 0 otherwise
+ */
+static int32_t supervisor_check_stack_quota( uint8_t stack_id, uint32_t now_s )
+{
+    if( stack_quota_ms[stack_id] == 0 )
+    {
+        return 0;
+    }
+
+    uint32_t airtime_ms = rp_get_stack_airtime_ms( modem_get_rp( ), stack_id );
+    uint32_t elapsed_s  = now_s - stack_quota_window_start_s[stack_id];
+
+    if( elapsed_s >= SUPERVISOR_STACK_QUOTA_WINDOW_S )
+    {
+        stack_quota_window_start_s[stack_id]    = now_s;
+        stack_quota_window_airtime_ms[stack_id] = airtime_ms;
+        elapsed_s                               = 0;
+    }
+
+    if( ( airtime_ms - stack_quota_window_airtime_ms[stack_id] ) < stack_quota_ms[stack_id] )
+    {
+        is_stack_quota_reached[stack_id] = false;
         return 0;
     }
+
+    if( is_stack_quota_reached[stack_id] == false )
+    {
+        is_stack_quota_reached[stack_id] = true;
+        stack_quota_deferrals[stack_id]++;
+        SMTC_MODEM_HAL_TRACE_WARNING( "Stack %d airtime quota reached\n", stack_id );
+    }
+    return ( int32_t ) ( SUPERVISOR_STACK_QUOTA_WINDOW_S - elapsed_s ) * 1000;
+}
+#endif
+
+static bool supervisor_heap_is_before( uint8_t task_index_a, uint8_t task_index_b )
+{
+    return ( int32_t ) ( time_to_execute_ms[task_index_a] - time_to_execute_ms[task_index_b] ) < 0;
+}
+
+static void supervisor_heap_swap( uint8_t position_a, uint8_t position_b )
+{
+    uint8_t task_index_a = task_heap[position_a];
+
+    task_heap[position_a]                     = task_heap[position_b];
+    task_heap[position_b]                     = task_index_a;
+    task_heap_position[task_heap[position_a]] = position_a;
+    task_heap_position[task_heap[position_b]] = position_b;
+}
+
+static void supervisor_heap_sift_up( uint8_t position )
+{
+    while( position > 0 )
+    {
+        uint8_t parent = ( position - 1 ) / 2;
+        if( supervisor_heap_is_before( task_heap[position], task_heap[parent] ) == false )
+        {
+            break;
+        }
+        supervisor_heap_swap( position, parent );
+        position = parent;
+    }
+}
+
+static void supervisor_heap_sift_down( uint8_t position )
+{
+    while( true )
+    {
+        uint8_t first   = position;
+        uint8_t child_l = ( 2 * position ) + 1;
+        uint8_t child_r = ( 2 * position ) + 2;
+
+        if( ( child_l < task_heap_size ) && ( supervisor_heap_is_before( task_heap[child_l], task_heap[first] ) ) )
+        {
+            first = child_l;
+        }
+        if( ( child_r < task_heap_size ) && ( supervisor_heap_is_before( task_heap[child_r], task_heap[first] ) ) )
+        {
+            first = child_r;
+        }
+        if( first == position )
+        {
+            break;
+        }
+        supervisor_heap_swap( position, first );
+        position = first;
+    }
+}
+
+static void supervisor_heap_insert( uint8_t task_index )
+{
+    if( task_heap_position[task_index] != SUPERVISOR_NOT_QUEUED )
+    {
+        return;
+    }
+    task_heap[task_heap_size]      = task_index;
+    task_heap_position[task_index] = task_heap_size;
+    task_heap_size++;
+    supervisor_heap_sift_up( task_heap_position[task_index] );
+}
+
+static void supervisor_heap_remove( uint8_t task_index )
+{
+    uint8_t position = task_heap_position[task_index];
+
+    if( position == SUPERVISOR_NOT_QUEUED )
+    {
+        return;
+    }
+    task_heap_size--;
+    if( position != task_heap_size )
+    {
+        uint8_t moved_task_index = task_heap[task_heap_size];
+
+        supervisor_heap_swap( position, task_heap_size );
+        // The task moved from the bottom can go either way
+        supervisor_heap_sift_up( position );
+        supervisor_heap_sift_down( task_heap_position[moved_task_index] );
+    }
+    task_heap_position[task_index] = SUPERVISOR_NOT_QUEUED;
 }
 
 static void supervisor_idle_task_on_launch( void* context )
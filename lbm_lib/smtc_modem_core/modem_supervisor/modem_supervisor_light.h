@@ -179,6 +179,16 @@ task_valid_t modem_supervisor_remove_task( uint16_t id );
  * \retval task_valid_t
  */
 task_valid_t modem_supervisor_add_task( smodem_task* task );
+
+/*!
+ * \brief   Add a task in supervisor to be executed in delay_ms
+ * \remark  Same as modem_supervisor_add_task() with a millisecond resolution, time_to_execute_s is set by the
+ *          supervisor
+ * \param task*  smodem_task
+ * \param [in]  delay_ms   - Delay before the execution of the task in ms
+ * \retval task_valid_t
+ */
+task_valid_t modem_supervisor_add_task_in_ms( smodem_task* task, uint32_t delay_ms );
 /*!
  * \brief   Add a launch/update callback in supervisor for a given task_id
  * \remark
@@ -196,6 +206,25 @@ void modem_supervisor_init_callback( const task_id_t task_id, void ( *callback_o
  */
 stask_manager* modem_supervisor_get_task( void );
 
+/**
+ * @brief Set the callback notifying that the engine has to be run before the delay it last returned
+ *
+ * @param wakeup_callback
+ */
+void modem_supervisor_set_engine_wakeup_callback( void ( *wakeup_callback )( void ) );
+
+/**
+ * @brief Inform the supervisor that the engine is running: no wakeup is notified meanwhile
+ *
+ * @param is_running
+ */
+void modem_supervisor_set_engine_running( bool is_running );
+
+/**
+ * @brief Call the engine wakeup callback, if any and if the engine is not running
+ */
+void modem_supervisor_notify_engine_wakeup( void );
+
 /**
  * @brief Get the suspend modem status of a stack_id
  *
@@ -231,6 +260,37 @@ task_priority_t modem_supervisor_get_modem_mute_with_priority_parameter( uint8_t
  */
 void modem_supervisor_set_modem_mute_with_priority_parameter( task_priority_t priority_level, uint8_t stack_id );
 
+#if defined( ADD_STACK_FAIRNESS )
+/**
+ * @brief Set the share of the radio time given to a stack when tasks of several stacks are ready together
+ *
+ * @param [in] stack_id stack identifier
+ * @param [in] weight   relative share, from 1 (default) to 255
+ * @return true if the weight was applied
+ */
+bool modem_supervisor_set_stack_weight( uint8_t stack_id, uint8_t weight );
+
+/**
+ * @brief Limit the radio time a stack can use in each quota window, the tasks of the stack that do not bypass the
+ *        duty-cycle wait for the next window once the quota is used
+ *
+ * @param [in] stack_id stack identifier
+ * @param [in] quota_ms radio time allowed per window in ms, 0 to remove the quota
+ * @return true if the quota was applied
+ */
+bool modem_supervisor_set_stack_airtime_quota( uint8_t stack_id, uint32_t quota_ms );
+
+/**
+ * @brief Get the radio time used by a stack and the number of quota windows in which it was held back
+ *
+ * @param [in]  stack_id        stack identifier
+ * @param [out] airtime_ms      radio time used since init in ms
+ * @param [out] quota_deferrals number of windows in which the quota was reached
+ * @return true if the stack exists
+ */
+bool modem_supervisor_get_stack_airtime_stats( uint8_t stack_id, uint32_t* airtime_ms, uint32_t* quota_deferrals );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
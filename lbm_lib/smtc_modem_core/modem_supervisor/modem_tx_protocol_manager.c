@@ -96,6 +96,25 @@ typedef enum tx_protocol_manager_state
 #define SLEEP_UNTIL_RADIO_INTERRUPT_MS 10000
 #define READY_FOR_LR1MAC_TX 0
 #define MAX_TRIAL_RELAY 5
+// Requests received while the TPM or the stack is busy
+#ifndef TPM_QUEUE_LENGTH
+#define TPM_QUEUE_LENGTH 5
+#endif
+// Bytes shared by the queued payloads the requesters asked to copy
+#ifndef TPM_QUEUE_POOL_SIZE
+#define TPM_QUEUE_POOL_SIZE 242
+#endif
+// Delay before the first queued request is tried again when no channel is available
+#define TPM_QUEUE_RETRY_MS 1000
+#if defined( ADD_SMTC_SERVICE_STATS )
+// Uplink sources accounted per stack, the last entry gathers the sources left out of the table
+#ifndef TPM_SERVICE_STATS_NB_SOURCES
+#define TPM_SERVICE_STATS_NB_SOURCES 8
+#endif
+#if( TPM_SERVICE_STATS_NB_SOURCES < 2 )
+#error "TPM_SERVICE_STATS_NB_SOURCES shall be at least 2"
+#endif
+#endif
 /*
  *-----------------------------------------------------------------------------------
  * --- PRIVATE MACROS ----------------------------------------------------------------
@@ -136,44 +155,94 @@ typedef enum tx_protocol_manager_state
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
-#define NB_REQUEST_ACCEPTED 5
+typedef enum tpm_queue_priority
+{
+    TPM_QUEUE_PRIORITY_DATA,  //!< Application and services uplinks
+    TPM_QUEUE_PRIORITY_JOIN,  //!< Join request
+    TPM_QUEUE_PRIORITY_MAC,   //!< MAC commands and uplinks at time
+} tpm_queue_priority_t;
+
+typedef struct tpm_queue_entry
+{
+    tx_protocol_manager_tx_type_t     request_type;
+    tpm_queue_priority_t              priority;
+    uint8_t                           fport;
+    bool                              fport_enabled;
+    const uint8_t*                    data;           //!< Requester buffer, when the payload is not in the pool
+    uint16_t                          pool_offset;    //!< Payload offset in the pool, when data_in_pool is true
+    bool                              data_in_pool;
+    uint8_t                           data_len;
+    smtc_modem_uplink_fill_callback_t fill_callback;  //!< Writes the payload when the frame is built, if not NULL
+    void*                             fill_context;
+    lr1mac_layer_param_t              packet_type;
+    uint32_t                          target_time_ms;
+    uint8_t                           stack_id;
+    uint32_t                          queued_time_s;
+} tpm_queue_entry_t;
+
+#if defined( ADD_SMTC_SERVICE_STATS )
+typedef struct tpm_service_stats
+{
+    smtc_modem_service_stats_source_t source;
+    uint8_t                           fport;
+    uint32_t                          uplink_count;
+    uint32_t                          tx_time_ms;
+    uint32_t                          rx_time_ms;
+    uint64_t                          tx_charge_ua_ms;
+    uint64_t                          rx_charge_ua_ms;
+} tpm_service_stats_t;
+
+// Radio planner counters of the stack hooks at the last attribution
+typedef struct tpm_service_stats_snapshot
+{
+    uint32_t tx_time_ms;
+    uint32_t rx_time_ms;
+    uint64_t tx_charge_ua_ms;
+    uint64_t rx_charge_ua_ms;
+} tpm_service_stats_snapshot_t;
+#endif
+
 static struct
 {
     tx_protocol_manager_tx_type_t current_tpm_request_type;
     tx_protocol_manager_state_t   current_tpm_state;
 
-    tx_protocol_manager_state_t tpm_list_of_state_to_execute[MAX_LIST_LENGTH];
-    bool                        current_tpm_transaction_is_a_retransmit;
-    radio_planner_t*            current_tpm_rp_target;
-    uint8_t                     current_tpm_fport;
-    bool                        current_tpm_fport_enabled;
-    uint8_t                     current_tpm_data[242];
-    uint8_t                     current_tpm_data_len;
-    lr1mac_layer_param_t        current_tpm_packet_type;
-    uint32_t                    current_tpm_target_time_ms;
-    uint32_t                    current_tpm_add_delay_ms;
-    bool                        current_tpm_transmit_at_time;
-    uint32_t                    current_tpm_target_transmit_at_time;
-    uint8_t                     current_tpm_stack_id;
-    uint32_t                    current_tpm_cpt_lbt_max_trial;
-    uint8_t                     current_tpm_cpt_relay_max_trial;
-    uint32_t                    current_tpm_target_time_csma_before_wor_ms;
-    uint32_t                    current_tpm_target_time_lbt_before_wor_ms;
-    bool                        current_tpm_transmit_is_aborted;
-    uint32_t                    current_tpm_failsafe_time_init;
-
-    tx_protocol_manager_tx_type_t next_tpm_request_type[NB_REQUEST_ACCEPTED];
-    tx_protocol_manager_state_t   next_tpm_state[NB_REQUEST_ACCEPTED];
-    uint8_t                       next_tpm_fport[NB_REQUEST_ACCEPTED];
-    bool                          next_tpm_fport_enabled[NB_REQUEST_ACCEPTED];
-    uint8_t*                      next_tpm_data[NB_REQUEST_ACCEPTED];
-    uint8_t                       next_tpm_data_len[NB_REQUEST_ACCEPTED];
-    lr1mac_layer_param_t          next_tpm_packet_type[NB_REQUEST_ACCEPTED];
-    uint32_t                      next_tpm_target_time_ms[NB_REQUEST_ACCEPTED];
-    uint8_t                       next_tpm_stack_id[NB_REQUEST_ACCEPTED];
-    bool                          next_tpm_stand_alone_stack_request[NB_REQUEST_ACCEPTED];
-    uint8_t                       next_tpm_pending_request;
-
+    tx_protocol_manager_state_t       tpm_list_of_state_to_execute[MAX_LIST_LENGTH];
+    bool                              current_tpm_transaction_is_a_retransmit;
+    radio_planner_t*                  current_tpm_rp_target;
+    uint8_t                           current_tpm_fport;
+    bool                              current_tpm_fport_enabled;
+    const uint8_t*                    current_tpm_data;
+    uint8_t                           current_tpm_data_buffer[242];
+    uint8_t                           current_tpm_data_len;
+    smtc_modem_uplink_fill_callback_t current_tpm_fill_callback;
+    void*                             current_tpm_fill_context;
+    lr1mac_layer_param_t              current_tpm_packet_type;
+    uint32_t                          current_tpm_target_time_ms;
+    uint32_t                          current_tpm_add_delay_ms;
+    bool                              current_tpm_transmit_at_time;
+    uint32_t                          current_tpm_target_transmit_at_time;
+    uint8_t                           current_tpm_stack_id;
+    uint32_t                          current_tpm_cpt_lbt_max_trial;
+    uint8_t                           current_tpm_cpt_relay_max_trial;
+    uint32_t                          current_tpm_target_time_csma_before_wor_ms;
+    uint32_t                          current_tpm_target_time_lbt_before_wor_ms;
+    bool                              current_tpm_transmit_is_aborted;
+    uint32_t                          current_tpm_failsafe_time_init;
+
+    // Entries in arrival order, the first one of the highest priority is sent first
+    tpm_queue_entry_t tpm_queue[TPM_QUEUE_LENGTH];
+    uint8_t           tpm_queue_nb_entries;
+    uint8_t           tpm_queue_pool[TPM_QUEUE_POOL_SIZE];
+    uint16_t          tpm_queue_pool_used;
+    uint32_t          tpm_queue_retry_time_ms;
+
+#if defined( ADD_SMTC_SERVICE_STATS )
+    tpm_service_stats_t          tpm_service_stats[NUMBER_OF_STACKS][TPM_SERVICE_STATS_NB_SOURCES];
+    uint8_t                      tpm_service_stats_nb[NUMBER_OF_STACKS];
+    uint8_t                      tpm_service_stats_current[NUMBER_OF_STACKS];  //!< Source of the last uplink
+    tpm_service_stats_snapshot_t tpm_service_stats_snapshot[NUMBER_OF_STACKS];
+#endif
 } modem_tpm_context;
 
 #define current_tpm_request_type modem_tpm_context.current_tpm_request_type
@@ -183,7 +252,10 @@ static struct
 #define current_tpm_fport modem_tpm_context.current_tpm_fport
 #define current_tpm_fport_enabled modem_tpm_context.current_tpm_fport_enabled
 #define current_tpm_data modem_tpm_context.current_tpm_data
+#define current_tpm_data_buffer modem_tpm_context.current_tpm_data_buffer
 #define current_tpm_data_len modem_tpm_context.current_tpm_data_len
+#define current_tpm_fill_callback modem_tpm_context.current_tpm_fill_callback
+#define current_tpm_fill_context modem_tpm_context.current_tpm_fill_context
 #define current_tpm_packet_type modem_tpm_context.current_tpm_packet_type
 #define current_tpm_target_time_ms modem_tpm_context.current_tpm_target_time_ms
 #define current_tpm_transmit_at_time modem_tpm_context.current_tpm_transmit_at_time
@@ -197,17 +269,17 @@ static struct
 #define current_tpm_failsafe_time_init modem_tpm_context.current_tpm_failsafe_time_init
 #define current_tpm_add_delay_ms modem_tpm_context.current_tpm_add_delay_ms
 #define current_tpm_target_transmit_at_time modem_tpm_context.current_tpm_target_transmit_at_time
-#define next_tpm_request_type modem_tpm_context.next_tpm_request_type
-#define next_tpm_state modem_tpm_context.next_tpm_state
-#define next_tpm_fport modem_tpm_context.next_tpm_fport
-#define next_tpm_fport_enabled modem_tpm_context.next_tpm_fport_enabled
-#define next_tpm_data modem_tpm_context.next_tpm_data
-#define next_tpm_data_len modem_tpm_context.next_tpm_data_len
-#define next_tpm_packet_type modem_tpm_context.next_tpm_packet_type
-#define next_tpm_target_time_ms modem_tpm_context.next_tpm_target_time_ms
-#define next_tpm_stack_id modem_tpm_context.next_tpm_stack_id
-#define next_tpm_stand_alone_stack_request modem_tpm_context.next_tpm_stand_alone_stack_request
-#define next_tpm_pending_request modem_tpm_context.next_tpm_pending_request
+#define tpm_queue modem_tpm_context.tpm_queue
+#define tpm_queue_nb_entries modem_tpm_context.tpm_queue_nb_entries
+#define tpm_queue_pool modem_tpm_context.tpm_queue_pool
+#define tpm_queue_pool_used modem_tpm_context.tpm_queue_pool_used
+#define tpm_queue_retry_time_ms modem_tpm_context.tpm_queue_retry_time_ms
+#if defined( ADD_SMTC_SERVICE_STATS )
+#define tpm_service_stats modem_tpm_context.tpm_service_stats
+#define tpm_service_stats_nb modem_tpm_context.tpm_service_stats_nb
+#define tpm_service_stats_current modem_tpm_context.tpm_service_stats_current
+#define tpm_service_stats_snapshot modem_tpm_context.tpm_service_stats_snapshot
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -246,9 +318,27 @@ static void             modem_tpm_radio_abort_relay_tx( void* context );
 static status_lorawan_t modem_tx_protocol_manager_engine( void );
 static void             tpm_debug_print( void );
 static status_lorawan_t tpm_get_next_channel( void );
+static bool             tpm_is_channel_recently_busy( uint32_t freq_hz );
 static void             tpm_abort( void );
 static void             update_tpm_target_time( void );
 static uint32_t         update_add_delay_ms( void );
+static status_lorawan_t tpm_request( tx_protocol_manager_tx_type_t request_type, uint8_t fport, bool fport_enabled,
+                                     const uint8_t* data, uint8_t data_len,
+                                     smtc_modem_uplink_fill_callback_t fill_callback, void* fill_context,
+                                     lr1mac_layer_param_t packet_type, uint32_t target_time_ms, uint8_t stack_id,
+                                     bool copy_data, bool add_random_delay );
+static status_lorawan_t tpm_queue_push( tx_protocol_manager_tx_type_t request_type, uint8_t fport, bool fport_enabled,
+                                        const uint8_t* data, uint8_t data_len,
+                                        smtc_modem_uplink_fill_callback_t fill_callback, void* fill_context,
+                                        lr1mac_layer_param_t packet_type, uint32_t target_time_ms, uint8_t stack_id,
+                                        bool copy_data );
+static uint8_t          tpm_queue_get_next( void );
+static void             tpm_queue_remove( uint8_t index );
+static void             tpm_queue_dispatch( void );
+#if defined( ADD_SMTC_SERVICE_STATS )
+static void tpm_service_stats_update( uint8_t stack_id );
+static void tpm_service_stats_start_uplink( uint8_t stack_id );
+#endif
 static status_lorawan_t ( *launch_tpm_func[TPM_NUMBER_OF_STATE] )( void ) = {
     [TPM_STATE_TX_LORA]     = &manage_tx_lora_state,
     [TPM_STATE_NWK_TX_LORA] = &manage_tx_nwk_lora_state,
@@ -313,9 +403,25 @@ void modem_tx_protocol_manager_init( radio_planner_t* rp )
                             ( void ( * )( void* ) ) modem_tpm_radio_free_relay_tx, NULL, NULL, NULL,
                             ( void ( * )( void* ) ) modem_tpm_radio_abort_relay_tx, NULL );
 
+#endif
+#if defined( ADD_STACK_FAIRNESS )
+        rp_hook_set_stack_id( current_tpm_rp_target, RP_HOOK_ID_LBT + i, i );
+#if defined( ADD_CSMA )
+        rp_hook_set_stack_id( current_tpm_rp_target, RP_HOOK_ID_CAD + i, i );
+#endif
+#if defined( ADD_RELAY_TX )
+        rp_hook_set_stack_id( current_tpm_rp_target, RP_HOOK_ID_RELAY_TX + i, i );
+#endif
 #endif
     }
     reset_tpm_list( );
+#if defined( ADD_SMTC_SERVICE_STATS )
+    for( uint8_t i = 0; i < NUMBER_OF_STACKS; i++ )
+    {
+        tpm_service_stats_update( i );
+        tpm_service_stats_current[i] = TPM_SERVICE_STATS_NB_SOURCES;
+    }
+#endif
 }
 
 /**
@@ -352,22 +458,10 @@ uint32_t tx_protocol_manager_is_busy( void )
             time_to_sleep = 0;
         }
     }
-    if( ( tpm_list_of_state_to_execute[0] == TPM_STATE_IDLE ) && ( next_tpm_pending_request > 0 ) &&
-        ( next_tpm_pending_request <= NB_REQUEST_ACCEPTED ) )
+    if( ( tpm_list_of_state_to_execute[0] == TPM_STATE_IDLE ) && ( tpm_queue_nb_entries > 0 ) &&
+        ( ( int32_t ) ( smtc_modem_hal_get_time_in_ms( ) - tpm_queue_retry_time_ms ) >= 0 ) )
     {
-        next_tpm_pending_request--;
-        if( next_tpm_stand_alone_stack_request[next_tpm_pending_request] == false )
-        {
-            tx_protocol_manager_request(
-                next_tpm_request_type[next_tpm_pending_request], next_tpm_fport[next_tpm_pending_request],
-                next_tpm_fport_enabled[next_tpm_pending_request], next_tpm_data[next_tpm_pending_request],
-                next_tpm_data_len[next_tpm_pending_request], next_tpm_packet_type[next_tpm_pending_request],
-                next_tpm_target_time_ms[next_tpm_pending_request], next_tpm_stack_id[next_tpm_pending_request] );
-        }
-        else
-        {
-            tx_protocol_manager_lr1mac_stand_alone_tx( );
-        }
+        tpm_queue_dispatch( );
         time_to_sleep = 0;
     }
 
@@ -391,65 +485,47 @@ status_lorawan_t tx_protocol_manager_request( tx_protocol_manager_tx_type_t requ
                                               lr1mac_layer_param_t packet_type, uint32_t target_time_ms,
                                               uint8_t stack_id )
 {
-    status_lorawan_t status = ERRORLORAWAN;
-    if( next_tpm_pending_request >= NB_REQUEST_ACCEPTED )
+    return tpm_request( request_type, fport, fport_enabled, data, data_len, NULL, NULL, packet_type, target_time_ms,
+                        stack_id, true, true );
+}
+
+status_lorawan_t tx_protocol_manager_request_no_copy( tx_protocol_manager_tx_type_t request_type, uint8_t fport,
+                                                      bool fport_enabled, const uint8_t* data, uint8_t data_len,
+                                                      lr1mac_layer_param_t packet_type, uint32_t target_time_ms,
+                                                      uint8_t stack_id )
+{
+    return tpm_request( request_type, fport, fport_enabled, data, data_len, NULL, NULL, packet_type, target_time_ms,
+                        stack_id, false, true );
+}
+
+status_lorawan_t tx_protocol_manager_request_fill( tx_protocol_manager_tx_type_t request_type, uint8_t fport,
+                                                   bool fport_enabled, smtc_modem_uplink_fill_callback_t fill_callback,
+                                                   void* fill_context, lr1mac_layer_param_t packet_type,
+                                                   uint32_t target_time_ms, uint8_t stack_id )
+{
+    return tpm_request( request_type, fport, fport_enabled, NULL, 0, fill_callback, fill_context, packet_type,
+                        target_time_ms, stack_id, false, true );
+}
+
+bool tx_protocol_manager_is_data_in_use( const uint8_t* data )
+{
+    if( data == NULL )
     {
-        return ERRORLORAWAN;
+        return false;
     }
-    if( tpm_list_of_state_to_execute[0] != TPM_STATE_IDLE )
+    // The data is handed to lr1mac (and copied in the frame buffer) when the TPM list goes back to idle
+    if( ( tpm_list_of_state_to_execute[0] != TPM_STATE_IDLE ) && ( current_tpm_data == data ) )
     {
-        next_tpm_request_type[next_tpm_pending_request]              = request_type;
-        next_tpm_fport[next_tpm_pending_request]                     = fport;
-        next_tpm_target_time_ms[next_tpm_pending_request]            = target_time_ms;
-        next_tpm_fport_enabled[next_tpm_pending_request]             = fport_enabled;
-        next_tpm_data[next_tpm_pending_request]                      = ( uint8_t* ) data;
-        next_tpm_data_len[next_tpm_pending_request]                  = data_len;
-        next_tpm_packet_type[next_tpm_pending_request]               = packet_type;
-        next_tpm_stack_id[next_tpm_pending_request]                  = stack_id;
-        next_tpm_stand_alone_stack_request[next_tpm_pending_request] = false;
-        next_tpm_pending_request++;
-        return OKLORAWAN;
+        return true;
     }
-
-    current_tpm_failsafe_time_init          = smtc_modem_hal_get_time_in_s( );
-    current_tpm_transaction_is_a_retransmit = false;
-    current_tpm_transmit_is_aborted         = false;
-    current_tpm_cpt_relay_max_trial         = 0;
-    current_tpm_cpt_lbt_max_trial           = 0;
-    current_tpm_add_delay_ms                = 0;
-    current_tpm_target_transmit_at_time     = 0;
-    if( request_type != TX_PROTOCOL_NONE )
+    for( uint8_t i = 0; i < tpm_queue_nb_entries; i++ )
     {
-        current_tpm_request_type     = request_type;
-        current_tpm_fport            = fport;
-        current_tpm_transmit_at_time = false;
-        current_tpm_fport_enabled    = fport_enabled;
-        memcpy( &current_tpm_data[0], data, data_len );
-        current_tpm_data_len    = data_len;
-        current_tpm_packet_type = packet_type;
-        current_tpm_stack_id    = stack_id;
-        compute_tpm_list( );
-
-        if( request_type == TX_PROTOCOL_TRANSMIT_LORA_AT_TIME )
-        {
-            current_tpm_target_transmit_at_time = target_time_ms;
-            current_tpm_target_time_ms          = target_time_ms - update_add_delay_ms( );
-            if( ( ( int32_t ) ( smtc_modem_hal_get_time_in_ms( ) - current_tpm_target_time_ms ) > 0 ) )
-            {
-                return ERRORLORAWAN;
-            }
-        }
-        else
+        if( ( tpm_queue[i].data_in_pool == false ) && ( tpm_queue[i].data == data ) )
         {
-            current_tpm_target_time_ms = target_time_ms + MODEM_TASK_DELAY_MS;
+            return true;
         }
-        if( tpm_get_next_channel( ) != OKLORAWAN )
-        {
-            return ERRORLORAWAN;
-        }
-        status = modem_tx_protocol_manager_engine( );
     }
-    return status;
+    return false;
 }
 
 /**
@@ -463,13 +539,9 @@ status_lorawan_t tx_protocol_manager_request( tx_protocol_manager_tx_type_t requ
  */
 void tx_protocol_manager_lr1mac_stand_alone_tx( void )
 {
-    if( next_tpm_pending_request >= NB_REQUEST_ACCEPTED )
-    {
-        return;
-    }
+    // The stack stays in LWPSTATE_TX_WAIT and the supervisor calls again once the TPM is idle
     if( tpm_list_of_state_to_execute[0] != TPM_STATE_IDLE )
     {
-        next_tpm_stand_alone_stack_request[next_tpm_pending_request] = true;
         return;
     }
     current_tpm_transaction_is_a_retransmit = true;
@@ -507,12 +579,390 @@ bool tx_protocol_manager_tx_is_aborted( void )
 void tx_protocol_manager_abort( void )
 {
     tpm_abort( );
+    tpm_queue_nb_entries = 0;
+    tpm_queue_pool_used  = 0;
+}
+
+#if defined( ADD_SMTC_SERVICE_STATS )
+uint8_t tx_protocol_manager_get_service_stats( uint8_t stack_id, smtc_modem_service_stats_t* stats,
+                                               uint8_t stats_max_nb )
+{
+    tpm_service_stats_update( stack_id );
+
+    uint8_t nb = 0;
+    for( ; ( nb < tpm_service_stats_nb[stack_id] ) && ( nb < stats_max_nb ); nb++ )
+    {
+        const tpm_service_stats_t* entry = &tpm_service_stats[stack_id][nb];
+
+        stats[nb].source        = entry->source;
+        stats[nb].fport         = entry->fport;
+        stats[nb].uplink_count  = entry->uplink_count;
+        stats[nb].tx_time_ms    = entry->tx_time_ms;
+        stats[nb].tx_charge_uas = rp_stats_saturate_u32( entry->tx_charge_ua_ms / 1000 );
+        stats[nb].rx_time_ms    = entry->rx_time_ms;
+        stats[nb].rx_charge_uas = rp_stats_saturate_u32( entry->rx_charge_ua_ms / 1000 );
+    }
+    return nb;
+}
+
+void tx_protocol_manager_reset_service_stats( uint8_t stack_id )
+{
+    tpm_service_stats_update( stack_id );
+    memset( tpm_service_stats[stack_id], 0, sizeof( tpm_service_stats[stack_id] ) );
+    tpm_service_stats_nb[stack_id]      = 0;
+    tpm_service_stats_current[stack_id] = TPM_SERVICE_STATS_NB_SOURCES;
 }
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+/**
+ * @brief Common part of tx_protocol_manager_request and tx_protocol_manager_request_no_copy
+ *
+ * @param copy_data true to copy data in the TPM buffer, false to keep a reference on the requester buffer until the
+ * payload is handed to lr1mac
+ * @param add_random_delay false for a queued request, which already waited for the previous transaction
+ */
+static status_lorawan_t tpm_request( tx_protocol_manager_tx_type_t request_type, uint8_t fport, bool fport_enabled,
+                                     const uint8_t* data, uint8_t data_len,
+                                     smtc_modem_uplink_fill_callback_t fill_callback, void* fill_context,
+                                     lr1mac_layer_param_t packet_type, uint32_t target_time_ms, uint8_t stack_id,
+                                     bool copy_data, bool add_random_delay )
+{
+    status_lorawan_t status = ERRORLORAWAN;
+#if defined( ADD_NWK_ANS_PIGGYBACK )
+    // Uplink composer: MAC answers waiting in the stack leave in the FOpts of this uplink instead of their own frame
+    if( ( tpm_list_of_state_to_execute[0] == TPM_STATE_IDLE ) &&
+        ( ( request_type == TX_PROTOCOL_TRANSMIT_LORA ) || ( request_type == TX_PROTOCOL_TRANSMIT_LORA_BULK ) ) &&
+        ( ( fport_enabled == false ) || ( fport != PORTNWK ) ) &&
+        ( lorawan_api_state_get( stack_id ) == LWPSTATE_TX_WAIT ) )
+    {
+        lorawan_api_nwk_ans_piggyback( stack_id, ( fport_enabled == true ) ? data_len : 0 );
+    }
+#endif
+    if( ( tpm_list_of_state_to_execute[0] != TPM_STATE_IDLE ) ||
+        ( ( request_type != TX_PROTOCOL_TRANSMIT_TEST_MODE ) &&
+          ( lorawan_api_state_get( stack_id ) != LWPSTATE_IDLE ) ) )
+    {
+        return tpm_queue_push( request_type, fport, fport_enabled, data, data_len, fill_callback, fill_context,
+                               packet_type, target_time_ms, stack_id, copy_data );
+    }
+
+    current_tpm_failsafe_time_init          = smtc_modem_hal_get_time_in_s( );
+    current_tpm_transaction_is_a_retransmit = false;
+    current_tpm_transmit_is_aborted         = false;
+    current_tpm_cpt_relay_max_trial         = 0;
+    current_tpm_cpt_lbt_max_trial           = 0;
+    current_tpm_add_delay_ms                = 0;
+    current_tpm_target_transmit_at_time     = 0;
+    if( request_type != TX_PROTOCOL_NONE )
+    {
+        current_tpm_request_type     = request_type;
+        current_tpm_fport            = fport;
+        current_tpm_transmit_at_time = false;
+        current_tpm_fport_enabled    = fport_enabled;
+        if( copy_data == true )
+        {
+            memcpy( &current_tpm_data_buffer[0], data, data_len );
+            current_tpm_data = current_tpm_data_buffer;
+        }
+        else
+        {
+            current_tpm_data = data;
+        }
+        current_tpm_data_len      = data_len;
+        current_tpm_fill_callback = fill_callback;
+        current_tpm_fill_context  = fill_context;
+        current_tpm_packet_type   = packet_type;
+        current_tpm_stack_id    = stack_id;
+        compute_tpm_list( );
+
+        if( request_type == TX_PROTOCOL_TRANSMIT_LORA_AT_TIME )
+        {
+            current_tpm_target_transmit_at_time = target_time_ms;
+            current_tpm_target_time_ms          = target_time_ms - update_add_delay_ms( );
+            if( ( ( int32_t ) ( smtc_modem_hal_get_time_in_ms( ) - current_tpm_target_time_ms ) > 0 ) )
+            {
+                reset_tpm_list( );
+                return ERRORLORAWAN;
+            }
+        }
+        else
+        {
+            current_tpm_target_time_ms = target_time_ms + ( ( add_random_delay == true ) ? MODEM_TASK_DELAY_MS : 0 );
+        }
+        status_lorawan_t channel_status = ERRORLORAWAN;
+#if defined( ADD_LINK_ADR )
+        if( ( request_type == TX_PROTOCOL_TRANSMIT_LORA_BULK ) &&
+            ( lorawan_api_bulk_datarate_set( ( fport_enabled == true ) ? data_len : 0, stack_id ) == true ) )
+        {
+            channel_status = tpm_get_next_channel( );
+            if( channel_status != OKLORAWAN )
+            {
+                // No FSK channel out of its duty cycle, the uplink is sent with the datarate of the ADR profile
+                lorawan_api_bulk_datarate_restore( stack_id );
+            }
+        }
+#endif
+        if( ( channel_status != OKLORAWAN ) && ( tpm_get_next_channel( ) != OKLORAWAN ) )
+        {
+            reset_tpm_list( );
+            return ERRORLORAWAN;
+        }
+        status = modem_tx_protocol_manager_engine( );
+    }
+    return status;
+}
+
+/**
+ * @brief Queue a request received while the TPM or the stack is busy
+ * @remark A copied payload is stored in the pool shared by the queued requests, the request is refused if the queue
+ * or the pool is full
+ *
+ * @param return OKLORAWAN if queued
+ */
+static status_lorawan_t tpm_queue_push( tx_protocol_manager_tx_type_t request_type, uint8_t fport, bool fport_enabled,
+                                        const uint8_t* data, uint8_t data_len,
+                                        smtc_modem_uplink_fill_callback_t fill_callback, void* fill_context,
+                                        lr1mac_layer_param_t packet_type, uint32_t target_time_ms, uint8_t stack_id,
+                                        bool copy_data )
+{
+    if( ( tpm_queue_nb_entries >= TPM_QUEUE_LENGTH ) ||
+        ( ( copy_data == true ) && ( ( tpm_queue_pool_used + data_len ) > TPM_QUEUE_POOL_SIZE ) ) )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TPM queue full, request 0x%x refused\n", request_type );
+        return ERRORLORAWAN;
+    }
+
+    tpm_queue_entry_t* entry = &tpm_queue[tpm_queue_nb_entries];
+
+    entry->request_type   = request_type;
+    entry->fport          = fport;
+    entry->fport_enabled  = fport_enabled;
+    entry->data_len       = data_len;
+    entry->packet_type    = packet_type;
+    entry->target_time_ms = target_time_ms;
+    entry->stack_id       = stack_id;
+    entry->queued_time_s  = smtc_modem_hal_get_time_in_s( );
+    entry->data_in_pool   = copy_data;
+    entry->data           = data;
+    entry->fill_callback  = fill_callback;
+    entry->fill_context   = fill_context;
+    if( copy_data == true )
+    {
+        memcpy( &tpm_queue_pool[tpm_queue_pool_used], data, data_len );
+        entry->pool_offset = tpm_queue_pool_used;
+        tpm_queue_pool_used += data_len;
+    }
+
+    switch( request_type )
+    {
+    case TX_PROTOCOL_TRANSMIT_CID:
+    case TX_PROTOCOL_TRANSMIT_LORA_AT_TIME:
+    case TX_PROTOCOL_TRANSMIT_TEST_MODE:
+    case TX_PROTOCOL_TRANSMIT_LORA_CERTIFICATION:
+        entry->priority = TPM_QUEUE_PRIORITY_MAC;
+        break;
+    case TX_PROTOCOL_JOIN_LORA:
+        entry->priority = TPM_QUEUE_PRIORITY_JOIN;
+        break;
+    default:
+        entry->priority = TPM_QUEUE_PRIORITY_DATA;
+        break;
+    }
+    tpm_queue_nb_entries++;
+    return OKLORAWAN;
+}
+
+/**
+ * @brief Get the queued request to send first: the oldest one of the highest priority
+ *
+ * @param return index in the queue
+ */
+static uint8_t tpm_queue_get_next( void )
+{
+    uint8_t next = 0;
+    for( uint8_t i = 1; i < tpm_queue_nb_entries; i++ )
+    {
+        if( tpm_queue[i].priority > tpm_queue[next].priority )
+        {
+            next = i;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Remove a request from the queue and release its payload from the pool
+ */
+static void tpm_queue_remove( uint8_t index )
+{
+    tpm_queue_entry_t* entry = &tpm_queue[index];
+
+    if( entry->data_in_pool == true )
+    {
+        uint16_t end = entry->pool_offset + entry->data_len;
+
+        memmove( &tpm_queue_pool[entry->pool_offset], &tpm_queue_pool[end], tpm_queue_pool_used - end );
+        tpm_queue_pool_used -= entry->data_len;
+        for( uint8_t i = 0; i < tpm_queue_nb_entries; i++ )
+        {
+            if( ( tpm_queue[i].data_in_pool == true ) && ( tpm_queue[i].pool_offset >= end ) )
+            {
+                tpm_queue[i].pool_offset -= entry->data_len;
+            }
+        }
+    }
+    tpm_queue_nb_entries--;
+    memmove( &tpm_queue[index], &tpm_queue[index + 1], ( tpm_queue_nb_entries - index ) * sizeof( tpm_queue_entry_t ) );
+}
+
+/**
+ * @brief Start the next queued request, called when the TPM is idle
+ * @remark The request is started as soon as its stack is idle, without the random delay of a new request. If no channel
+ * is available, typically because of the duty cycle, it is tried again every TPM_QUEUE_RETRY_MS for FAILSAFE_TPM_S.
+ */
+static void tpm_queue_dispatch( void )
+{
+    uint8_t            index = tpm_queue_get_next( );
+    tpm_queue_entry_t* entry = &tpm_queue[index];
+
+    if( ( entry->request_type != TX_PROTOCOL_TRANSMIT_TEST_MODE ) &&
+        ( lorawan_api_state_get( entry->stack_id ) != LWPSTATE_IDLE ) )
+    {
+        return;
+    }
+
+    uint32_t now_ms         = smtc_modem_hal_get_time_in_ms( );
+    uint32_t target_time_ms = entry->target_time_ms;
+    if( ( entry->request_type != TX_PROTOCOL_TRANSMIT_LORA_AT_TIME ) &&
+        ( ( int32_t ) ( target_time_ms - now_ms ) < 0 ) )
+    {
+        target_time_ms = now_ms;
+    }
+
+    // A payload of the pool is copied in the TPM buffer before its slot is released
+    status_lorawan_t status = tpm_request(
+        entry->request_type, entry->fport, entry->fport_enabled,
+        ( entry->data_in_pool == true ) ? &tpm_queue_pool[entry->pool_offset] : entry->data, entry->data_len,
+        entry->fill_callback, entry->fill_context, entry->packet_type, target_time_ms, entry->stack_id,
+        entry->data_in_pool, false );
+
+    if( ( status != OKLORAWAN ) && ( entry->request_type != TX_PROTOCOL_TRANSMIT_LORA_AT_TIME ) &&
+        ( ( int32_t ) ( smtc_modem_hal_get_time_in_s( ) - entry->queued_time_s ) < FAILSAFE_TPM_S ) )
+    {
+        tpm_queue_retry_time_ms = now_ms + TPM_QUEUE_RETRY_MS;
+        return;
+    }
+    if( status != OKLORAWAN )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TPM queued request 0x%x dropped\n", entry->request_type );
+    }
+    tpm_queue_remove( index );
+}
+
+#if defined( ADD_SMTC_SERVICE_STATS )
+/**
+ * @brief Attribute the radio time and charge of the stack hooks since the last call to the source of the last uplink
+ * @remark The radio planner counters restart from 0 on smtc_modem_reset_charge, a counter lower than its snapshot is
+ * then counted from 0
+ */
+static void tpm_service_stats_update( uint8_t stack_id )
+{
+    const rp_stats_t*             rp_stats = &current_tpm_rp_target->stats;
+    tpm_service_stats_snapshot_t* snapshot = &tpm_service_stats_snapshot[stack_id];
+    tpm_service_stats_snapshot_t  now      = { 0 };
+    const uint8_t                 hook_ids[] = {
+        RP_HOOK_ID_LR1MAC_STACK + stack_id, RP_HOOK_ID_LBT + stack_id,
+#if defined( ADD_CSMA )
+        RP_HOOK_ID_CAD + stack_id,
+#endif
+#if defined( ADD_RELAY_TX )
+        RP_HOOK_ID_RELAY_TX + stack_id,
+#endif
+    };
+
+    for( uint8_t i = 0; i < ( sizeof( hook_ids ) / sizeof( hook_ids[0] ) ); i++ )
+    {
+        now.tx_time_ms += rp_stats->tx_consumption_ms[hook_ids[i]];
+        now.rx_time_ms += rp_stats->rx_consumption_ms[hook_ids[i]];
+        now.tx_charge_ua_ms += rp_stats->tx_consumption_ua_ms[hook_ids[i]];
+        now.rx_charge_ua_ms += rp_stats->rx_consumption_ua_ms[hook_ids[i]];
+    }
+
+    if( tpm_service_stats_current[stack_id] < TPM_SERVICE_STATS_NB_SOURCES )
+    {
+        tpm_service_stats_t* entry = &tpm_service_stats[stack_id][tpm_service_stats_current[stack_id]];
+
+        entry->tx_time_ms += ( now.tx_time_ms >= snapshot->tx_time_ms ) ? ( now.tx_time_ms - snapshot->tx_time_ms )
+                                                                        : now.tx_time_ms;
+        entry->rx_time_ms += ( now.rx_time_ms >= snapshot->rx_time_ms ) ? ( now.rx_time_ms - snapshot->rx_time_ms )
+                                                                        : now.rx_time_ms;
+        entry->tx_charge_ua_ms += ( now.tx_charge_ua_ms >= snapshot->tx_charge_ua_ms )
+                                      ? ( now.tx_charge_ua_ms - snapshot->tx_charge_ua_ms )
+                                      : now.tx_charge_ua_ms;
+        entry->rx_charge_ua_ms += ( now.rx_charge_ua_ms >= snapshot->rx_charge_ua_ms )
+                                      ? ( now.rx_charge_ua_ms - snapshot->rx_charge_ua_ms )
+                                      : now.rx_charge_ua_ms;
+    }
+    *snapshot = now;
+}
+
+/**
+ * @brief Make the source of the uplink launched by the TPM the one the stack radio time is attributed to
+ * @remark The retransmissions and the network answers sent by the stack on its own stay attributed to the uplink they
+ * follow
+ */
+static void tpm_service_stats_start_uplink( uint8_t stack_id )
+{
+    smtc_modem_service_stats_source_t source = SMTC_MODEM_SERVICE_STATS_SOURCE_FPORT;
+    uint8_t                           fport  = current_tpm_fport;
+
+    if( current_tpm_request_type == TX_PROTOCOL_JOIN_LORA )
+    {
+        source = SMTC_MODEM_SERVICE_STATS_SOURCE_JOIN;
+        fport  = 0;
+    }
+    else if( ( current_tpm_request_type == TX_PROTOCOL_TRANSMIT_CID ) || ( current_tpm_fport_enabled == false ) )
+    {
+        source = SMTC_MODEM_SERVICE_STATS_SOURCE_MAC;
+        fport  = 0;
+    }
+
+    tpm_service_stats_update( stack_id );
+
+    tpm_service_stats_t* stats = tpm_service_stats[stack_id];
+    uint8_t              index = 0;
+    while( ( index < tpm_service_stats_nb[stack_id] ) &&
+           ( ( stats[index].source != source ) || ( stats[index].fport != fport ) ) )
+    {
+        index++;
+    }
+    if( index == tpm_service_stats_nb[stack_id] )
+    {
+        if( index == ( TPM_SERVICE_STATS_NB_SOURCES - 1 ) )
+        {
+            source = SMTC_MODEM_SERVICE_STATS_SOURCE_OTHER;
+            fport  = 0;
+        }
+        if( index < TPM_SERVICE_STATS_NB_SOURCES )
+        {
+            stats[index].source = source;
+            stats[index].fport  = fport;
+            tpm_service_stats_nb[stack_id]++;
+        }
+        else
+        {
+            index = TPM_SERVICE_STATS_NB_SOURCES - 1;
+        }
+    }
+    stats[index].uplink_count++;
+    tpm_service_stats_current[stack_id] = index;
+}
+#endif
+
 /**
  * @brief this function is called by supervisor_run_lorawan_engine when a retransmission or a nwk frame is on going
  * in the LoRaWAN stack
@@ -608,7 +1058,26 @@ static status_lorawan_t manage_tx_lora_state( void )
 
         break;
     case TX_PROTOCOL_TRANSMIT_LORA:
+    case TX_PROTOCOL_TRANSMIT_LORA_BULK:
     case TX_PROTOCOL_TRANSMIT_LORA_CERTIFICATION:
+        if( current_tpm_fill_callback != NULL )
+        {
+            // The requester writes the payload now, for the datarate of this uplink
+            uint32_t max_len = lorawan_api_next_max_payload_length_get( current_tpm_stack_id );
+            if( max_len > sizeof( current_tpm_data_buffer ) )
+            {
+                max_len = sizeof( current_tpm_data_buffer );
+            }
+            current_tpm_data_len      = current_tpm_fill_callback( current_tpm_stack_id, current_tpm_data_buffer,
+                                                                   ( uint8_t ) max_len, current_tpm_fill_context );
+            current_tpm_data          = current_tpm_data_buffer;
+            current_tpm_fill_callback = NULL;
+            if( current_tpm_data_len > max_len )
+            {
+                SMTC_MODEM_HAL_TRACE_ERROR( "TPM filled payload too long %u/%u\n", current_tpm_data_len, max_len );
+                break;
+            }
+        }
 
         status = lorawan_api_payload_send( current_tpm_fport, current_tpm_fport_enabled, current_tpm_data,
                                            current_tpm_data_len, current_tpm_packet_type, current_tpm_target_time_ms,
@@ -636,8 +1105,8 @@ static status_lorawan_t manage_tx_lora_state( void )
 
         SMTC_MODEM_HAL_TRACE_PRINTF( "TPM Launch TX_PROTOCOL_TRANSMIT_CID current_tpm_data_len = %d data = %d , %d \n",
                                      current_tpm_data_len, current_tpm_data[0], current_tpm_data[1] );
-        status = lorawan_api_send_stack_cid_req( &current_tpm_data[0], current_tpm_data_len, current_tpm_target_time_ms,
-                                                 current_tpm_stack_id );
+        status = lorawan_api_send_stack_cid_req( ( uint8_t* ) current_tpm_data, current_tpm_data_len,
+                                                 current_tpm_target_time_ms, current_tpm_stack_id );
         break;
     default:
         break;
@@ -650,6 +1119,12 @@ static status_lorawan_t manage_tx_lora_state( void )
     {
         tpm_abort( );
     }
+#if defined( ADD_SMTC_SERVICE_STATS )
+    else
+    {
+        tpm_service_stats_start_uplink( current_tpm_stack_id );
+    }
+#endif
     return status;
 }
 
@@ -669,6 +1144,8 @@ static status_lorawan_t manage_tx_lora_state( void )
 // In the case where the channel is always busy, TPM tries MAX_TRIAL_LBT times to relaunch the LBT service before
 // aborting the current Tx transaction.
 #define MAX_TRIAL_LBT ( ( current_tpm_request_type == TX_PROTOCOL_TRANSMIT_TEST_MODE ) ? 10000UL : 10UL )
+// Number of channel draws to find a channel which has not been found busy by a recent LBT or CSMA
+#define TPM_BUSY_CHANNEL_DRAW_MAX ( 4 )
 
 /**
  * @brief this function is called by the service LBT when the channel is "busy" meaning interferer block the next
@@ -1132,6 +1609,23 @@ static void modem_tpm_radio_abort_relay_tx( void* context )
 /****************************************************************/
 /******************Utilities functions***************************/
 /****************************************************************/
+static bool tpm_is_channel_recently_busy( uint32_t freq_hz )
+{
+    if( ( smtc_lbt_get_state( smtc_lbt_get_obj( current_tpm_stack_id ) ) == true ) &&
+        ( smtc_lbt_is_channel_recently_busy( smtc_lbt_get_obj( current_tpm_stack_id ), freq_hz ) == true ) )
+    {
+        return true;
+    }
+#if defined( ADD_CSMA )
+    if( ( smtc_lora_cad_bt_get_state( smtc_cad_get_obj( current_tpm_stack_id ) ) == true ) &&
+        ( smtc_lora_cad_bt_is_channel_recently_busy( smtc_cad_get_obj( current_tpm_stack_id ), freq_hz ) == true ) )
+    {
+        return true;
+    }
+#endif
+    return false;
+}
+
 static status_lorawan_t tpm_get_next_channel( void )
 {
 #if defined( ADD_RELAY_TX )
@@ -1155,7 +1649,18 @@ static status_lorawan_t tpm_get_next_channel( void )
     }
     else
     {
-        return ( lorawan_api_update_next_tx_channel( current_tpm_stack_id ) );
+        status_lorawan_t status = lorawan_api_update_next_tx_channel( current_tpm_stack_id );
+
+        // Prefer a channel which has not been found busy by a recent LBT or CSMA
+        lr1_stack_mac_t* lr1mac_obj = lorawan_api_stack_mac_get( current_tpm_stack_id );
+        for( uint8_t i = 1; ( i < TPM_BUSY_CHANNEL_DRAW_MAX ) && ( status == OKLORAWAN ) &&
+                            ( lr1mac_obj->nb_available_tx_channel > 1 ) &&
+                            ( tpm_is_channel_recently_busy( lr1mac_obj->tx_frequency ) == true );
+             i++ )
+        {
+            status = lorawan_api_update_next_tx_channel( current_tpm_stack_id );
+        }
+        return status;
     }
 }
 
@@ -1360,7 +1865,7 @@ static void tpm_abort( void )
     current_tpm_transmit_is_aborted = true;
     if( current_tpm_request_type == TX_PROTOCOL_TRANSMIT_TEST_MODE )
     {
-        test_mode_cb_tpm( current_tpm_data, current_tpm_data_len, true );
+        test_mode_cb_tpm( ( uint8_t* ) current_tpm_data, current_tpm_data_len, true );
     }
 
     lorawan_api_core_abort( current_tpm_stack_id );
@@ -1378,7 +1883,7 @@ static status_lorawan_t manage_idle_state( void )
 static status_lorawan_t manage_test_mode( void )
 {
     shift_left_tpm_list( );
-    return ( test_mode_cb_tpm( current_tpm_data, current_tpm_data_len, false ) );
+    return ( test_mode_cb_tpm( ( uint8_t* ) current_tpm_data, current_tpm_data_len, false ) );
 }
 static void update_tpm_target_time( void )
 {
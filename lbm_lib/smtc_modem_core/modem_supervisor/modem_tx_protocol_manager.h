@@ -45,6 +45,7 @@ extern "C" {
  */
 #include "radio_planner.h"
 #include "lr1_stack_mac_layer.h"
+#include "smtc_modem_api.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -65,6 +66,7 @@ typedef enum tx_protocol_manager_tx_type
     TX_PROTOCOL_TRANSMIT_LORA_AT_TIME       = 0x04,
     TX_PROTOCOL_TRANSMIT_TEST_MODE          = 0x05,
     TX_PROTOCOL_TRANSMIT_LORA_CERTIFICATION = 0x06,
+    TX_PROTOCOL_TRANSMIT_LORA_BULK          = 0x07,  //!< Uplink draining a backlog, sent with FSK if the link allows
 } tx_protocol_manager_tx_type_t;
 /*
  * -----------------------------------------------------------------------------
@@ -81,6 +83,9 @@ void modem_tx_protocol_manager_init( radio_planner_t* rp );
 /*!
  * @brief tx_protocol_manager_request function is called each time a LoRaWAN transmission will be processed
  * \remark  This function is called  by the modem's upper layer itself, it shouldn't be useful at the application layer
+ * \remark  A request received while the TPM or the stack is busy is queued, up to TPM_QUEUE_LENGTH requests. MAC
+ * commands and uplinks at time are sent first, then joins, then the other uplinks, each in arrival order, as soon as the
+ * stack is idle and a channel is available. The outcome is reported by the usual Tx done path.
  * @param request_type could be Join, Normal LoRaWAN, Or CID cmd
  * @param fport LoRaWAN fport
  * @param fport_enabled LoRaWAN fport enable
@@ -96,6 +101,50 @@ status_lorawan_t tx_protocol_manager_request( tx_protocol_manager_tx_type_t requ
                                               lr1mac_layer_param_t packet_type, uint32_t target_time_ms,
                                               uint8_t stack_id );
 
+/*!
+ * @brief Same as tx_protocol_manager_request without copying the payload in the TPM
+ * \remark  data must stay valid and unchanged until tx_protocol_manager_is_data_in_use returns false, it is copied in
+ * the LoRaWAN frame buffer once the pre processing (LBT, CSMA, relay) is done
+ * @param request_type could be Join, Normal LoRaWAN, Or CID cmd
+ * @param fport LoRaWAN fport
+ * @param fport_enabled LoRaWAN fport enable
+ * @param data LoRaWAN user payload
+ * @param data_len LoRaWAN user payload length
+ * @param packet_type LoRaWAN packet type (confirmed/unconfirmed)
+ * @param target_time_ms Target starting time of the LoRaWAN packet
+ * @param stack_id Stack id
+ * @return LoRaWAN status
+ */
+status_lorawan_t tx_protocol_manager_request_no_copy( tx_protocol_manager_tx_type_t request_type, uint8_t fport,
+                                                      bool fport_enabled, const uint8_t* data, uint8_t data_len,
+                                                      lr1mac_layer_param_t packet_type, uint32_t target_time_ms,
+                                                      uint8_t stack_id );
+
+/*!
+ * @brief Same as tx_protocol_manager_request with a payload written by a callback when the LoRaWAN frame is built
+ * \remark  The callback is called once the pre processing (LBT, CSMA, relay) is done, with the maximum payload length
+ * of the datarate of the uplink. It is not called if the transmission is aborted before
+ * @param request_type TX_PROTOCOL_TRANSMIT_LORA or TX_PROTOCOL_TRANSMIT_LORA_BULK
+ * @param fport LoRaWAN fport
+ * @param fport_enabled LoRaWAN fport enable
+ * @param fill_callback Callback writing the LoRaWAN user payload
+ * @param fill_context Context given to fill_callback
+ * @param packet_type LoRaWAN packet type (confirmed/unconfirmed)
+ * @param target_time_ms Target starting time of the LoRaWAN packet
+ * @param stack_id Stack id
+ * @return LoRaWAN status
+ */
+status_lorawan_t tx_protocol_manager_request_fill( tx_protocol_manager_tx_type_t request_type, uint8_t fport,
+                                                   bool fport_enabled, smtc_modem_uplink_fill_callback_t fill_callback,
+                                                   void* fill_context, lr1mac_layer_param_t packet_type,
+                                                   uint32_t target_time_ms, uint8_t stack_id );
+
+/*! @brief Indicate if a payload given to tx_protocol_manager_request_no_copy is still referenced by the TPM
+ * @param data payload buffer
+ * @return true if the TPM still reads data
+ */
+bool tx_protocol_manager_is_data_in_use( const uint8_t* data );
+
 /*! @brief tx_protocol_manager_is_busy indicate if tpm is in used in order to pre process LoRaWan transmission (could be
  * LBT, CSMA , or Relay pre process)
  * \remark  This function is called  by the modem's upper layer itself, it shouldn't be useful at the application layer
@@ -124,6 +173,23 @@ bool tx_protocol_manager_tx_is_aborted( void );
  * @return void
  */
 void tx_protocol_manager_abort( void );
+
+#if defined( ADD_SMTC_SERVICE_STATS )
+/*! @brief Get the radio time and charge attributed to each uplink source of a stack
+ * @param  stack_id      Stack id
+ * @param  stats         Filled with the sources in the order they were first used
+ * @param  stats_max_nb  Size of stats, in entries
+ * @return Number of entries written in stats
+ */
+uint8_t tx_protocol_manager_get_service_stats( uint8_t stack_id, smtc_modem_service_stats_t* stats,
+                                               uint8_t stats_max_nb );
+
+/*! @brief Clear the uplink sources of a stack
+ * @param  stack_id Stack id
+ * @return void
+ */
+void tx_protocol_manager_reset_service_stats( uint8_t stack_id );
+#endif
 #ifdef __cplusplus
 }
 #endif
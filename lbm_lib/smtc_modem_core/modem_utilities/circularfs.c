@@ -39,6 +39,8 @@
 
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
 
 #include "smtc_modem_hal_dbg_trace.h"
 #include "circularfs.h"
@@ -47,6 +49,10 @@
 #define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
 #endif
 
+/** A 16-bit value and its complement in a double word, an erased or partially programmed word does not decode. */
+#define WORD_ENCODE( value ) \
+    ( ( uint64_t ) ( ( ( uint32_t ) ( value ) & 0xFFFF ) | ( ( ~( uint32_t ) ( value ) & 0xFFFF ) << 16 ) ) )
+
 /**
  * @}
  * @defgroup sector status
@@ -72,6 +78,7 @@ typedef struct sector_header
     uint64_t status_in_used;
     uint64_t status_formating;
     uint64_t status_erasing;
+    uint64_t summary; /**< Valid records when the write head left the sector. */
 } sector_header_t;
 
 static int32_t _sector_address( struct circularfs* fs, int32_t sector_offset )
@@ -171,65 +178,126 @@ static int32_t _sector_free( struct circularfs* fs, int32_t sector, bool guard )
     fs->flash->program( fs->flash, sector_addr + offsetof( struct sector_header, version ), &fs->version,
                         sizeof( fs->version ) );
     _sector_set_status( fs, sector, SECTOR_FREE );
+    fs->sector_valid[sector] = 0;
     return 0;
 }
 
+/** Persist the valid record count of a sector the write head leaves. */
+static int32_t _sector_set_summary( struct circularfs* fs, int32_t sector )
+{
+    uint64_t summary = WORD_ENCODE( fs->sector_valid[sector] );
+    return fs->flash->program( fs->flash, _sector_address( fs, sector ) + offsetof( struct sector_header, summary ),
+                               &summary, sizeof( summary ) );
+}
+
+/** Read the valid record count of a closed sector, -1 if the sector was not closed. */
+static int32_t _sector_get_summary( struct circularfs* fs, int32_t sector )
+{
+    uint64_t summary = ~0ULL;
+    fs->flash->read( fs->flash, _sector_address( fs, sector ) + offsetof( struct sector_header, summary ), &summary,
+                     sizeof( summary ) );
+
+    int32_t count = ( int32_t ) ( summary & 0xFFFF );
+    return ( summary == WORD_ENCODE( count ) ) ? count : -1;
+}
+
+/** Invalidate the summary of a closed sector whose records are discarded out of order, the scan walks it again. */
+static int32_t _sector_clear_summary( struct circularfs* fs, int32_t sector )
+{
+    if( _sector_get_summary( fs, sector ) < 0 )
+    {
+        return 0;
+    }
+
+    /* Programmed to zero over the summary, which then never decodes. */
+    uint64_t summary = 0ULL;
+    return fs->flash->program( fs->flash, _sector_address( fs, sector ) + offsetof( struct sector_header, summary ),
+                               &summary, sizeof( summary ) );
+}
+
 /**
  * @}
- * @defgroup slot status
+ * @defgroup record status
  * @{
  */
 
-#define SLOT_ERASED 0xFFFFFFFF   /**< Default state after NOR flash erase. */
-#define SLOT_RESERVED 0xFFFFFF00 /**< Write started but not yet committed. */
-#define SLOT_VALID 0xFFFF0000    /**< Write committed, slot contains valid data. */
-#define SLOT_GARBAGE 0xFF000000  /**< Slot contents discarded and no longer valid. */
+#define RECORD_ERASED 0xFFFFFFFF   /**< Default state after NOR flash erase. */
+#define RECORD_RESERVED 0xFFFFFF00 /**< Length written, write started but not yet committed. */
+#define RECORD_VALID 0xFFFF0000    /**< Write committed, record contains valid data. */
+#define RECORD_GARBAGE 0xFF000000  /**< Record contents discarded and no longer valid. */
 // [F][F][F] erased
-// [0][F][F] reserved
-// [0][0][F] SLOT_VALID
-// [0][0][0] GARBAGE
+// [L][F][F] reserved
+// [L][0][F] RECORD_VALID
+// [L][0][0] GARBAGE
+
+/** Records are programmed by double words, as the status words. */
+#define RECORD_ALIGN( size ) ( ( ( size ) + 7 ) & ~7 )
 
-typedef struct slot_header
+/** The length word holds the object size in bits 0-15 and its complement in bits 16-31. */
+#define RECORD_LENGTH_ENCODE( size ) WORD_ENCODE( size )
+
+typedef struct record_header
 {
-    // uint64_t status[3];
-    uint64_t status_reserved;
+    uint64_t length;
     uint64_t status_valid;
     uint64_t status_garbage;
-} slot_header_t;
+} record_header_t;
+
+static int32_t _record_footprint( int32_t size )
+{
+    return sizeof( struct record_header ) + RECORD_ALIGN( size );
+}
 
-static int32_t _slot_address( struct circularfs* fs, struct circularfs_loc* loc )
+static int32_t _record_address( struct circularfs* fs, struct circularfs_loc* loc )
 {
-    return _sector_address( fs, loc->sector ) + sizeof( struct sector_header ) +
-           ( sizeof( struct slot_header ) + fs->object_size ) * loc->slot;
+    return _sector_address( fs, loc->sector ) + sizeof( struct sector_header ) + loc->offset;
 }
 
-static int32_t _slot_get_status( struct circularfs* fs, struct circularfs_loc* loc, uint32_t* status )
+/** Read the record header, returns -1 if the location holds no record or a corrupted length. */
+static int32_t _record_get_header( struct circularfs* fs, struct circularfs_loc* loc, record_header_t* header,
+                                   int32_t* size )
 {
-    slot_header_t status_tmp;
+    /* No room left for a record: end of the sector log. */
+    header->length = ~0ULL;
+    if( ( loc->offset + _record_footprint( 1 ) ) > fs->sector_data_size )
+    {
+        return -1;
+    }
+
+    fs->flash->read( fs->flash, _record_address( fs, loc ), header, sizeof( record_header_t ) );
+
+    *size = ( int32_t ) ( header->length & 0xFFFF );
+    if( ( header->length == ~0ULL ) || ( header->length != RECORD_LENGTH_ENCODE( *size ) ) || ( *size == 0 ) ||
+        ( *size > fs->object_size ) || ( ( loc->offset + _record_footprint( *size ) ) > fs->sector_data_size ) )
+    {
+        return -1;
+    }
+    return 0;
+}
 
-    int32_t ret =
-        fs->flash->read( fs->flash, _slot_address( fs, loc ) + offsetof( struct slot_header, status_reserved ),
-                         &status_tmp, sizeof( status_tmp ) );
+static int32_t _record_get_status( struct circularfs* fs, struct circularfs_loc* loc, uint32_t* status )
+{
+    record_header_t header;
+    int32_t         size;
 
-    if( ( status_tmp.status_reserved == ~0ULL ) && ( status_tmp.status_valid == ~0ULL ) &&
-        ( status_tmp.status_garbage == ~0ULL ) )
+    if( _record_get_header( fs, loc, &header, &size ) != 0 )
     {
-        *status = SLOT_ERASED;
+        *status = RECORD_ERASED;
+        return ( header.length == ~0ULL ) ? 0 : -1;
     }
-    else if( ( status_tmp.status_reserved == 0ULL ) && ( status_tmp.status_valid == ~0ULL ) &&
-             ( status_tmp.status_garbage == ~0ULL ) )
+
+    int32_t ret = 0;
+    if( ( header.status_valid == ~0ULL ) && ( header.status_garbage == ~0ULL ) )
     {
-        *status = SLOT_RESERVED;
+        *status = RECORD_RESERVED;
     }
-    else if( ( status_tmp.status_reserved == 0ULL ) && ( status_tmp.status_valid == 0ULL ) &&
-             ( status_tmp.status_garbage == ~0ULL ) )
+    else if( ( header.status_valid == 0ULL ) && ( header.status_garbage == ~0ULL ) )
     {
-        *status = SLOT_VALID;
+        *status = RECORD_VALID;
     }
-    else if( ( status_tmp.status_reserved == 0ULL ) && ( status_tmp.status_valid == 0ULL ) &&
-             ( status_tmp.status_garbage == 0ULL ) )
+    else if( ( header.status_valid == 0ULL ) && ( header.status_garbage == 0ULL ) )
     {
-        *status = SLOT_GARBAGE;
+        *status = RECORD_GARBAGE;
     }
     else
     {
@@ -238,23 +306,18 @@ static int32_t _slot_get_status( struct circularfs* fs, struct circularfs_loc* l
     return ret;
 }
 
-static int32_t _slot_set_status( struct circularfs* fs, struct circularfs_loc* loc, uint32_t status )
+static int32_t _record_set_status( struct circularfs* fs, struct circularfs_loc* loc, uint32_t status )
 {
     uint64_t status_tmp = 0ULL;
-    if( status == SLOT_RESERVED )
-    {
-        return fs->flash->program( fs->flash,
-                                   _slot_address( fs, loc ) + offsetof( struct slot_header, status_reserved ),
-                                   &status_tmp, sizeof( status_tmp ) );
-    }
-    else if( status == SLOT_VALID )
+    if( status == RECORD_VALID )
     {
-        return fs->flash->program( fs->flash, _slot_address( fs, loc ) + offsetof( struct slot_header, status_valid ),
+        return fs->flash->program( fs->flash, _record_address( fs, loc ) + offsetof( struct record_header, status_valid ),
                                    &status_tmp, sizeof( status_tmp ) );
     }
-    else if( status == SLOT_GARBAGE )
+    else if( status == RECORD_GARBAGE )
     {
-        return fs->flash->program( fs->flash, _slot_address( fs, loc ) + offsetof( struct slot_header, status_garbage ),
+        return fs->flash->program( fs->flash,
+                                   _record_address( fs, loc ) + offsetof( struct record_header, status_garbage ),
                                    &status_tmp, sizeof( status_tmp ) );
     }
     return -1;
@@ -268,13 +331,13 @@ static int32_t _slot_set_status( struct circularfs* fs, struct circularfs_loc* l
 
 static bool _loc_equal( struct circularfs_loc* a, struct circularfs_loc* b )
 {
-    return ( a->sector == b->sector ) && ( a->slot == b->slot );
+    return ( a->sector == b->sector ) && ( a->offset == b->offset );
 }
 
 /** Advance a location to the beginning of the next sector. */
 static void _loc_advance_sector( struct circularfs* fs, struct circularfs_loc* loc )
 {
-    loc->slot = 0;
+    loc->offset = 0;
     loc->sector++;
     if( loc->sector >= fs->flash->sector_count )
     {
@@ -282,16 +345,90 @@ static void _loc_advance_sector( struct circularfs* fs, struct circularfs_loc* l
     }
 }
 
-/** Advance a location to the next slot, advancing the sector too if needed. */
-static void _loc_advance_slot( struct circularfs* fs, struct circularfs_loc* loc )
+/**
+ * Advance a location to the next record, advancing the sector too if needed. A location without a valid length
+ * word is the end of the sector log.
+ */
+static void _loc_advance_record( struct circularfs* fs, struct circularfs_loc* loc )
 {
-    loc->slot++;
-    if( loc->slot >= fs->slots_per_sector )
+    record_header_t header;
+    int32_t         size;
+
+    if( _record_get_header( fs, loc, &header, &size ) != 0 )
+    {
+        _loc_advance_sector( fs, loc );
+        return;
+    }
+
+    loc->offset += _record_footprint( size );
+    if( ( loc->offset + _record_footprint( 1 ) ) > fs->sector_data_size )
     {
         _loc_advance_sector( fs, loc );
     }
 }
 
+/** Advance the write head to the next sector, closing the current one. */
+static void _loc_close_write_sector( struct circularfs* fs )
+{
+    _sector_set_summary( fs, fs->write.sector );
+    _loc_advance_sector( fs, &fs->write );
+}
+
+/** Free a sector holding old records, the valid ones are lost and the read and cursor heads leave the sector. */
+static void _sector_reclaim( struct circularfs* fs, int32_t sector )
+{
+    /* Its valid records are lost, they were fetched if the cursor is past the sector. */
+    int32_t lost = fs->sector_valid[sector];
+    if( fs->cursor.sector == sector )
+    {
+        fs->fetched = 0;
+    }
+    else if( fs->read.sector == sector )
+    {
+        fs->fetched -= lost;
+    }
+    fs->valid -= lost;
+
+    /* Move the read & cursor heads out of the way. */
+    if( fs->read.sector == sector )
+    {
+        _loc_advance_sector( fs, &fs->read );
+    }
+    if( fs->cursor.sector == sector )
+    {
+        _loc_advance_sector( fs, &fs->cursor );
+    }
+
+    _sector_free( fs, sector, true );
+}
+
+/** Count the valid records from a location to the end of its sector or to the write head. */
+static int32_t _sector_count_valid( struct circularfs* fs, struct circularfs_loc* from )
+{
+    int32_t count = 0;
+
+    /* Use a temporary loc for iteration. */
+    struct circularfs_loc loc = *from;
+    while( ( loc.sector == from->sector ) && !_loc_equal( &loc, &fs->write ) )
+    {
+        uint32_t status = 0;
+        _record_get_status( fs, &loc, &status );
+
+        if( status == RECORD_VALID )
+        {
+            count++;
+        }
+        else if( status == RECORD_ERASED )
+        {
+            break;
+        }
+
+        _loc_advance_record( fs, &loc );
+    }
+
+    return count;
+}
+
 /**
  * @}
  */
@@ -310,8 +447,21 @@ int32_t circularfs_init( struct circularfs* fs, struct circularfs_flash_partitio
     fs->object_size = object_size;
 
     /* Precalculate commonly used values. */
-    fs->slots_per_sector = ( fs->flash->sector_size - sizeof( struct sector_header ) ) /
-                           ( sizeof( struct slot_header ) + fs->object_size );
+    fs->sector_data_size   = fs->flash->sector_size - sizeof( struct sector_header );
+    fs->objects_per_sector = fs->sector_data_size / _record_footprint( fs->object_size );
+
+    if( ( fs->object_size <= 0 ) || ( fs->object_size > 0xFFFF ) || ( fs->objects_per_sector == 0 ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "circularfs_init: object size %d does not fit in a sector\r\n", object_size );
+        return -1;
+    }
+
+    if( fs->flash->sector_count > CIRCULARFS_SECTOR_COUNT_MAX )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( "circularfs_init: %d sectors, more than CIRCULARFS_SECTOR_COUNT_MAX\r\n",
+                                     fs->flash->sector_count );
+        return -1;
+    }
 
     return 0;
 }
@@ -335,11 +485,14 @@ int32_t circularfs_format( struct circularfs* fs, bool guard )
 
     /* Start reading & writing at the first sector. */
     fs->read.sector   = 0;
-    fs->read.slot     = 0;
+    fs->read.offset   = 0;
     fs->write.sector  = 0;
-    fs->write.slot    = 0;
+    fs->write.offset  = 0;
     fs->cursor.sector = 0;
-    fs->cursor.slot   = 0;
+    fs->cursor.offset = 0;
+
+    fs->valid   = 0;
+    fs->fetched = 0;
 
     return 0;
 }
@@ -358,15 +511,11 @@ int32_t circularfs_scan( struct circularfs* fs )
     /* If there's no IN_USE sector, we start at the first one. */
     bool used_seen = false;
 
+    memset( fs->sector_valid, 0, sizeof( fs->sector_valid ) );
+
     /* Iterate over sectors. */
     for( int32_t sector = 0; sector < fs->flash->sector_count; sector++ )
     {
-        // int32_t addr = _sector_address( fs, sector );
-
-        // /* Read sector header. */
-        // struct sector_header header;
-        // fs->flash->read( fs->flash, addr, &header, sizeof( header ) );
-
         uint32_t header_version;
         uint32_t header_status;
         _sector_get_version( fs, sector, &header_version );
@@ -445,126 +594,130 @@ int32_t circularfs_scan( struct circularfs* fs )
         write_sector = 0;
     }
 
-    /* Scan the write sector and skip all occupied slots at the beginning. */
+    /* Follow the length words of the write sector up to the first erased one. A corrupted length word closes the
+     * sector: writing resumes at the beginning of the next, FREE, sector. */
     fs->write.sector = write_sector;
-    fs->write.slot   = 0;
+    fs->write.offset = 0;
     while( fs->write.sector == write_sector )
     {
         uint32_t status;
-        _slot_get_status( fs, &fs->write, &status );
-        if( status == SLOT_ERASED )
+        if( ( _record_get_status( fs, &fs->write, &status ) == 0 ) && ( status == RECORD_ERASED ) &&
+            ( ( fs->write.offset + _record_footprint( 1 ) ) <= fs->sector_data_size ) )
         {
             break;
         }
 
-        _loc_advance_slot( fs, &fs->write );
+        _loc_advance_record( fs, &fs->write );
     }
-    /* If the sector was full, we're at the beginning of a FREE sector now. */
 
     /* Position the read head at the start of the first IN_USE sector, then skip
-     * over garbage/invalid slots until something of value is found or we reach
+     * over garbage/invalid records until something of value is found or we reach
      * the write head which means there's no data. */
     fs->read.sector = read_sector;
-    fs->read.slot   = 0;
+    fs->read.offset = 0;
     while( !_loc_equal( &fs->read, &fs->write ) )
     {
         uint32_t status;
-        _slot_get_status( fs, &fs->read, &status );
-        if( status == SLOT_VALID )
+        _record_get_status( fs, &fs->read, &status );
+        if( status == RECORD_VALID )
         {
             break;
         }
 
-        _loc_advance_slot( fs, &fs->read );
+        _loc_advance_record( fs, &fs->read );
     }
 
     /* Move the read cursor to the read head position. */
     fs->cursor = fs->read;
 
+    /* Rebuild the counters in a single pass: the sectors between the read and the write sectors give their summary,
+     * the read and write sectors (and a sector left without summary) are walked. There is no valid record before the
+     * read head. */
+    fs->valid   = 0;
+    fs->fetched = 0;
+    for( int32_t sector = fs->read.sector;; sector = ( sector + 1 ) % fs->flash->sector_count )
+    {
+        int32_t count = -1;
+        if( ( sector != fs->read.sector ) && ( sector != fs->write.sector ) )
+        {
+            count = _sector_get_summary( fs, sector );
+        }
+        if( count < 0 )
+        {
+            struct circularfs_loc loc = { sector, 0 };
+            count                     = _sector_count_valid( fs, &loc );
+        }
+
+        fs->sector_valid[sector] = count;
+        fs->valid += count;
+
+        if( sector == fs->write.sector )
+        {
+            break;
+        }
+    }
+
     return 0;
 }
 
 int32_t circularfs_capacity( struct circularfs* fs )
 {
-    return fs->slots_per_sector * ( fs->flash->sector_count - 1 );
+    return fs->objects_per_sector * ( fs->flash->sector_count - 1 );
 }
 
 int32_t circularfs_free_slot_estimate( struct circularfs* fs )
 {
-    uint32_t capacity       = circularfs_capacity( fs );
-    uint32_t count_estimate = circularfs_count_estimate( fs );
+    int32_t capacity    = circularfs_capacity( fs );
+    int32_t sector_diff = ( fs->write.sector - fs->read.sector + fs->flash->sector_count ) % fs->flash->sector_count;
 
-    uint32_t free_slot = capacity - count_estimate;
+    /* The space before the read head is only reclaimed when its sector is erased. */
+    int32_t used_size = sector_diff * fs->sector_data_size + fs->write.offset;
+    int32_t free_size = ( fs->flash->sector_count - 1 ) * fs->sector_data_size - used_size;
 
-    if( fs->read.slot != 0 )
+    int32_t free_slot = free_size / _record_footprint( fs->object_size );
+    if( free_slot < 0 )
     {
-        free_slot -= fs->read.slot;
+        free_slot = 0;
     }
-    return free_slot;
+    return MIN( free_slot, capacity );
 }
 
 int32_t circularfs_count_estimate( struct circularfs* fs )
 {
-    int32_t sector_diff = ( fs->write.sector - fs->read.sector + fs->flash->sector_count ) % fs->flash->sector_count;
-
-    return sector_diff * fs->slots_per_sector + fs->write.slot - fs->read.slot;
+    return fs->valid;
 }
 
 int32_t circularfs_count_estimate_from_last_fetch( struct circularfs* fs )
 {
-    int32_t sector_diff = ( fs->write.sector - fs->cursor.sector + fs->flash->sector_count ) % fs->flash->sector_count;
-
-    return sector_diff * fs->slots_per_sector + fs->write.slot - fs->cursor.slot;
+    return fs->valid - fs->fetched;
 }
 
 int32_t circularfs_count_exact( struct circularfs* fs )
 {
-    int32_t count = 0;
-
-    /* Use a temporary loc for iteration. */
-    struct circularfs_loc loc = fs->read;
-    while( !_loc_equal( &loc, &fs->write ) )
-    {
-        uint32_t status = 0;
-        _slot_get_status( fs, &loc, &status );
-
-        if( status == SLOT_VALID )
-        {
-            count++;
-        }
-
-        _loc_advance_slot( fs, &loc );
-    }
-
-    return count;
+    return fs->valid;
 }
 
 int32_t circularfs_count_exact_from_last_fetch( struct circularfs* fs )
 {
-    int32_t count = 0;
-
-    /* Use a temporary loc for iteration. */
-    struct circularfs_loc loc = fs->cursor;
-    while( !_loc_equal( &loc, &fs->write ) )
-    {
-        uint32_t status = 0;
-        _slot_get_status( fs, &loc, &status );
-
-        if( status == SLOT_VALID )
-        {
-            count++;
-        }
-
-        _loc_advance_slot( fs, &loc );
-    }
-
-    return count;
+    return fs->valid - fs->fetched;
 }
 
-int32_t circularfs_append( struct circularfs* fs, const void* object )
+int32_t circularfs_append( struct circularfs* fs, const void* object, int32_t size )
 {
     uint32_t status;
 
+    if( ( size <= 0 ) || ( size > fs->object_size ) )
+    {
+        return -1;
+    }
+
+    /* Close the write sector if the record does not fit in its remaining space. The next sector is FREE
+     * (invariant). */
+    if( ( fs->write.offset + _record_footprint( size ) ) > fs->sector_data_size )
+    {
+        _loc_close_write_sector( fs );
+    }
+
     /*
      * There are three sectors involved in appending a value:
      * - the sector where the append happens: it has to be writable
@@ -578,20 +731,8 @@ int32_t circularfs_append( struct circularfs* fs, const void* object )
     _sector_get_status( fs, next_sector, &status );
     if( status != SECTOR_FREE )
     {
-        /* Next sector must be freed. But first... */
-
-        /* Move the read & cursor heads out of the way. */
-        if( fs->read.sector == next_sector )
-        {
-            _loc_advance_sector( fs, &fs->read );
-        }
-        if( fs->cursor.sector == next_sector )
-        {
-            _loc_advance_sector( fs, &fs->cursor );
-        }
-
-        /* Free the next sector. */
-        _sector_free( fs, next_sector, true );
+        /* Next sector must be freed, unless circularfs_pre_erase already did it. */
+        _sector_reclaim( fs, next_sector );
     }
     ////////////
     ///////////////////////////////////////
@@ -609,40 +750,103 @@ int32_t circularfs_append( struct circularfs* fs, const void* object )
         return -1;
     }
 
-    /* Preallocate slot. */
-    _slot_set_status( fs, &fs->write, SLOT_RESERVED );
+    /* Preallocate record: the length word makes the record walkable even if the write is interrupted. */
+    uint64_t length = RECORD_LENGTH_ENCODE( size );
+    fs->flash->program( fs->flash, _record_address( fs, &fs->write ) + offsetof( struct record_header, length ),
+                        &length, sizeof( length ) );
 
-    /* Write object. */
-    fs->flash->program( fs->flash, _slot_address( fs, &fs->write ) + sizeof( struct slot_header ), object,
-                        fs->object_size );
+    /* Write object, the last double word is padded. */
+    int32_t object_addr  = _record_address( fs, &fs->write ) + sizeof( struct record_header );
+    int32_t aligned_size = size & ~7;
+    if( aligned_size > 0 )
+    {
+        fs->flash->program( fs->flash, object_addr, object, aligned_size );
+    }
+    if( aligned_size < size )
+    {
+        uint8_t tail[8];
+        memset( tail, 0xFF, sizeof( tail ) );
+        memcpy( tail, ( const uint8_t* ) object + aligned_size, size - aligned_size );
+        fs->flash->program( fs->flash, object_addr + aligned_size, tail, sizeof( tail ) );
+    }
 
     /* Commit write. */
-    _slot_set_status( fs, &fs->write, SLOT_VALID );
+    _record_set_status( fs, &fs->write, RECORD_VALID );
+    fs->sector_valid[fs->write.sector]++;
+    fs->valid++;
 
     /* Advance the write head. */
-    _loc_advance_slot( fs, &fs->write );
+    fs->write.offset += _record_footprint( size );
+    if( ( fs->write.offset + _record_footprint( 1 ) ) > fs->sector_data_size )
+    {
+        _loc_close_write_sector( fs );
+    }
 
     return 0;
 }
 
-int32_t circularfs_fetch( struct circularfs* fs, void* object )
+int32_t circularfs_pre_erase( struct circularfs* fs )
 {
-    /* Advance forward in search of a valid slot. */
-    while( !_loc_equal( &fs->cursor, &fs->write ) )
+    /* The sector after the write sector is FREE (invariant), the append entering it erases the following one. */
+    if( fs->flash->sector_count < 3 )
     {
-        uint32_t status = 0;
+        return 0;
+    }
+    int32_t sector = ( fs->write.sector + 2 ) % fs->flash->sector_count;
+
+    uint32_t status;
+    if( ( _sector_get_status( fs, sector, &status ) < 0 ) || ( status == SECTOR_FREE ) )
+    {
+        return 0;
+    }
+
+    /* Valid records are only given up when the write head is about to leave its sector: the append entering the
+     * next sector would erase them anyway. */
+    int32_t write_free_size = fs->sector_data_size - fs->write.offset;
+    if( ( fs->sector_valid[sector] > 0 ) &&
+        ( write_free_size >= ( CIRCULARFS_PRE_ERASE_OBJECTS * _record_footprint( fs->object_size ) ) ) )
+    {
+        return 0;
+    }
 
-        _slot_get_status( fs, &fs->cursor, &status );
+    /* The ERASING then FREE status words make the erase safe across a power loss, circularfs_scan frees a sector
+     * left ERASING. */
+    _sector_reclaim( fs, sector );
+    return 1;
+}
+
+int32_t circularfs_fetch( struct circularfs* fs, void* object, int32_t* size )
+{
+    if( circularfs_peek( fs, object, size ) != 0 )
+    {
+        return -1;
+    }
 
-        if( status == SLOT_VALID )
+    fs->fetched++;
+    _loc_advance_record( fs, &fs->cursor );
+    return 0;
+}
+
+int32_t circularfs_peek( struct circularfs* fs, void* object, int32_t* size )
+{
+    /* Advance forward in search of a valid record. */
+    while( !_loc_equal( &fs->cursor, &fs->write ) )
+    {
+        uint32_t        status = 0;
+        record_header_t header;
+        int32_t         object_size;
+
+        _record_get_status( fs, &fs->cursor, &status );
+        if( ( status == RECORD_VALID ) && ( _record_get_header( fs, &fs->cursor, &header, &object_size ) == 0 ) )
         {
-            fs->flash->read( fs->flash, _slot_address( fs, &fs->cursor ) + sizeof( struct slot_header ), object,
-                             fs->object_size );
-            _loc_advance_slot( fs, &fs->cursor );
+            fs->flash->read( fs->flash, _record_address( fs, &fs->cursor ) + sizeof( struct record_header ), object,
+                             object_size );
+            *size = object_size;
             return 0;
         }
 
-        _loc_advance_slot( fs, &fs->cursor );
+        /* Skip the records without data. */
+        _loc_advance_record( fs, &fs->cursor );
     }
 
     return -1;
@@ -652,10 +856,19 @@ int32_t circularfs_discard( struct circularfs* fs )
 {
     while( !_loc_equal( &fs->read, &fs->cursor ) )
     {
-        _slot_set_status( fs, &fs->read, SLOT_GARBAGE );
-        _loc_advance_slot( fs, &fs->read );
+        uint32_t status = 0;
+        _record_get_status( fs, &fs->read, &status );
+        if( status == RECORD_VALID )
+        {
+            _record_set_status( fs, &fs->read, RECORD_GARBAGE );
+            fs->sector_valid[fs->read.sector]--;
+        }
+        _loc_advance_record( fs, &fs->read );
     }
 
+    fs->valid -= fs->fetched;
+    fs->fetched = 0;
+
     return 0;
 }
 
@@ -671,21 +884,27 @@ int32_t circularfs_discard_item_x_from_head_position( struct circularfs* fs, uin
         if( ( ( item_x_bitfield >> count ) & 0x01 ) == 1 )
         {
             uint32_t status;
-            _slot_get_status( fs, &loc, &status );
+            _record_get_status( fs, &loc, &status );
 
             /* Search the next valid data */
-            while( ( !_loc_equal( &loc, &fs->cursor ) ) && ( status != SLOT_VALID ) )
+            while( ( !_loc_equal( &loc, &fs->cursor ) ) && ( status != RECORD_VALID ) )
             {
-                _loc_advance_slot( fs, &loc );
-                _slot_get_status( fs, &loc, &status );
+                _loc_advance_record( fs, &loc );
+                _record_get_status( fs, &loc, &status );
             }
-            if( status == SLOT_VALID )
+            /* The records from the cursor are not fetched, they are kept. */
+            if( _loc_equal( &loc, &fs->cursor ) )
             {
-                _slot_set_status( fs, &loc, SLOT_GARBAGE );
+                break;
             }
+            _record_set_status( fs, &loc, RECORD_GARBAGE );
+            _sector_clear_summary( fs, loc.sector );
+            fs->sector_valid[loc.sector]--;
+            fs->valid--;
+            fs->fetched--;
         }
 
-        _loc_advance_slot( fs, &loc );
+        _loc_advance_record( fs, &loc );
         count++;
     }
 
@@ -693,13 +912,13 @@ int32_t circularfs_discard_item_x_from_head_position( struct circularfs* fs, uin
     while( !_loc_equal( &fs->read, &fs->write ) )
     {
         uint32_t status;
-        _slot_get_status( fs, &fs->read, &status );
-        if( status == SLOT_VALID )
+        _record_get_status( fs, &fs->read, &status );
+        if( status == RECORD_VALID )
         {
             break;
         }
 
-        _loc_advance_slot( fs, &fs->read );
+        _loc_advance_record( fs, &fs->read );
     }
 
     return 0;
@@ -707,7 +926,8 @@ int32_t circularfs_discard_item_x_from_head_position( struct circularfs* fs, uin
 
 int32_t circularfs_rewind( struct circularfs* fs )
 {
-    fs->cursor = fs->read;
+    fs->cursor  = fs->read;
+    fs->fetched = 0;
     return 0;
 }
 
@@ -715,19 +935,14 @@ void circularfs_dump( struct circularfs* fs )
 {
 #if( MODEM_HAL_DBG_TRACE == MODEM_HAL_FEATURE_ON )
     const char* description;
-    char        slots_description[170];
+    char        records_description[170];
 
-    SMTC_MODEM_HAL_TRACE_PRINTF( "CIRCULARFS read: {%d,%d} cursor: {%d,%d} write: {%d,%d}\n", fs->read.sector,
-                                 fs->read.slot, fs->cursor.sector, fs->cursor.slot, fs->write.sector, fs->write.slot );
+    SMTC_MODEM_HAL_TRACE_PRINTF( "CIRCULARFS read: {%d,%d} cursor: {%d,%d} write: {%d,%d} valid: %d\n",
+                                 fs->read.sector, fs->read.offset, fs->cursor.sector, fs->cursor.offset,
+                                 fs->write.sector, fs->write.offset, fs->valid );
 
     for( int32_t sector = 0; sector < fs->flash->sector_count; sector++ )
     {
-        // int32_t addr = _sector_address( fs, sector );
-
-        /* Read sector header. */
-        // struct sector_header header;
-        // fs->flash->read( fs->flash, addr, &header, sizeof( header ) );
-
         uint32_t header_version = 0;
         uint32_t header_status  = 0xFF;
         _sector_get_version( fs, sector, &header_version );
@@ -755,43 +970,42 @@ void circularfs_dump( struct circularfs* fs )
             break;
         }
 
-        for( int32_t slot = 0; slot < fs->slots_per_sector; slot++ )
+        /* Follow the sector log up to the first erased length word. */
+        int32_t               record = 0;
+        struct circularfs_loc loc    = { sector, 0 };
+        while( ( loc.sector == sector ) && ( record < ( int32_t ) ( sizeof( records_description ) - 1 ) ) )
         {
-            if( slot < ( int32_t ) ( sizeof( slots_description ) - 1 ) )
+            uint32_t status = 0;
+            if( _record_get_status( fs, &loc, &status ) != 0 )
             {
-                struct circularfs_loc loc    = { sector, slot };
-                uint32_t              status = 0;
-                _slot_get_status( fs, &loc, &status );
-
-                switch( status )
-                {
-                case SLOT_ERASED:
-                    slots_description[slot] = 'E';
-                    break;
-                case SLOT_RESERVED:
-                    slots_description[slot] = 'R';
-                    break;
-                case SLOT_VALID:
-                    slots_description[slot] = 'V';
-                    break;
-                case SLOT_GARBAGE:
-                    slots_description[slot] = 'G';
-                    break;
-                default:
-                    slots_description[slot] = '?';
-                    break;
-                }
+                records_description[record++] = '?';
+                break;
+            }
+
+            switch( status )
+            {
+            case RECORD_RESERVED:
+                records_description[record++] = 'R';
+                break;
+            case RECORD_VALID:
+                records_description[record++] = 'V';
+                break;
+            case RECORD_GARBAGE:
+                records_description[record++] = 'G';
+                break;
+            default:
+                break;
             }
-            else
+            if( status == RECORD_ERASED )
             {
-                SMTC_MODEM_HAL_TRACE_WARNING( "%s: buffer trace too short\n", __func__ );
                 break;
             }
+            _loc_advance_record( fs, &loc );
         }
-        slots_description[MIN( fs->slots_per_sector, ( int32_t ) ( sizeof( slots_description ) - 1 ) )] = '\0';
+        records_description[record] = '\0';
 
         SMTC_MODEM_HAL_TRACE_PRINTF( "[%04d] [v=0x%08" PRIx32 "] [%-10s] %s\n", sector, header_version, description,
-                                     slots_description );
+                                     records_description );
     }
 #endif  // MODEM_HAL_DBG_TRACE
 }
@@ -52,6 +52,21 @@ extern "C" {
  * --- PUBLIC MACROS -----------------------------------------------------------
  */
 
+/**
+ * Maximum number of sectors of a partition, sizes the per-sector record counts.
+ */
+#ifndef CIRCULARFS_SECTOR_COUNT_MAX
+#define CIRCULARFS_SECTOR_COUNT_MAX 64
+#endif
+
+/**
+ * circularfs_pre_erase() gives up the valid records of the sector it erases once fewer than this number of
+ * maximum-size objects fit in the write sector.
+ */
+#ifndef CIRCULARFS_PRE_ERASE_OBJECTS
+#define CIRCULARFS_PRE_ERASE_OBJECTS 2
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC CONSTANTS --------------------------------------------------------
@@ -99,26 +114,37 @@ struct circularfs_flash_partition
 struct circularfs_loc
 {
     int32_t sector;
-    int32_t slot;
+    int32_t offset; /**< Byte offset of the record in the sector data area. */
 };
 
 /**
  * RingFS instance. Should be initialized with circularfs_init() before use.
  * Structure fields should not be accessed directly.
+ *
+ * Every sector holds a log of variable-length records: a length word, the
+ * valid and garbage status words, then the object padded to a double word.
+ * The log is walked from the sector start up to the first erased length word.
  * */
 struct circularfs
 {
     /* Constant values, set once at circularfs_init(). */
     struct circularfs_flash_partition* flash;
     uint32_t                           version;
-    int32_t                            object_size;
+    int32_t                            object_size; /**< Maximum object size. */
     /* Cached values. */
-    int32_t slots_per_sector;
+    int32_t sector_data_size;
+    int32_t objects_per_sector; /**< Maximum-size objects per sector. */
 
     /* Read/write pointers. Modified as needed. */
     struct circularfs_loc read;
     struct circularfs_loc write;
     struct circularfs_loc cursor;
+
+    /* Valid records from the read head to the write head, and between the read head and the cursor. */
+    int32_t valid;
+    int32_t fetched;
+    /* Valid records per sector, persisted in the sector header when the write head leaves the sector. */
+    uint16_t sector_valid[CIRCULARFS_SECTOR_COUNT_MAX];
 };
 
 /*
@@ -134,8 +160,9 @@ struct circularfs
  * @param flash Flash memory interface. Must be implemented externally.
  * @param version Object version. Should be incremented whenever the object's
  *                semantics or size change in a backwards-incompatible way.
- * @param object_size Size of one stored object, in bytes.
- * @returns Zero on success, -1 on failure.
+ * @param object_size Maximum size of one stored object, in bytes.
+ * @returns Zero on success, -1 on failure (a maximum-size object does not fit in a sector, or the partition has
+ *          more than CIRCULARFS_SECTOR_COUNT_MAX sectors).
  */
 int32_t circularfs_init( struct circularfs* fs, struct circularfs_flash_partition* flash, uint32_t version,
                          int32_t object_size );
@@ -150,7 +177,8 @@ int32_t circularfs_init( struct circularfs* fs, struct circularfs_flash_partitio
 int32_t circularfs_format( struct circularfs* fs, bool guard );
 
 /**
- * Scan the flash memory for a valid filesystem.
+ * Scan the flash memory for a valid filesystem and rebuild the object counts.
+ * Reads every sector header, and the records of the read and write sectors only.
  *
  * @param fs Initialized RingFS instance.
  * @returns Zero on success, -1 on failure.
@@ -158,13 +186,22 @@ int32_t circularfs_format( struct circularfs* fs, bool guard );
 int32_t circularfs_scan( struct circularfs* fs );
 
 /**
- * Calculate maximum RingFS capacity.
+ * Calculate maximum RingFS capacity, in maximum-size objects. Smaller objects
+ * take less space: only their length rounded up to a double word is stored.
  *
  * @param fs Initialized RingFS instance.
  * @returns Maximum capacity on success, -1 on failure.
  */
 int32_t circularfs_capacity( struct circularfs* fs );
 
+/**
+ * Calculate the free space before the oldest objects are overwritten, in
+ * maximum-size objects.
+ * Runs in O(1).
+ *
+ * @param fs Initialized RingFS instance.
+ * @returns Free slot count.
+ */
 int32_t circularfs_free_slot_estimate( struct circularfs* fs );
 
 /**
@@ -180,7 +217,7 @@ int32_t circularfs_count_estimate_from_last_fetch( struct circularfs* fs );
 
 /**
  * Calculate exact object count.
- * Runs in O(n).
+ * Runs in O(1).
  *
  * @param fs Initialized RingFS instance.
  * @returns Exact object count on success, -1 on failure.
@@ -194,18 +231,42 @@ int32_t circularfs_count_exact_from_last_fetch( struct circularfs* fs );
  *
  * @param fs Initialized RingFS instance.
  * @param object Object to be stored.
+ * @param size Object size, from 1 to the maximum object size.
  * @returns Zero on success, -1 on failure.
  */
-int32_t circularfs_append( struct circularfs* fs, const void* object );
+int32_t circularfs_append( struct circularfs* fs, const void* object, int32_t size );
+
+/**
+ * Erase ahead the sector that the next sector change of the write head would erase, so that the
+ * append changing sector only programs. Meant to be called in idle time, erases at most one sector.
+ * A sector holding valid records is only erased once fewer than CIRCULARFS_PRE_ERASE_OBJECTS
+ * maximum-size objects fit in the write sector.
+ *
+ * @param fs Initialized RingFS instance.
+ * @returns 1 if a sector was erased, 0 otherwise.
+ */
+int32_t circularfs_pre_erase( struct circularfs* fs );
 
 /**
  * Fetch next object from the ring, oldest-first. Advances read cursor.
  *
  * @param fs Initialized RingFS instance.
- * @param object Buffer to store retrieved object.
+ * @param object Buffer to store retrieved object, of the maximum object size.
+ * @param size Size of the retrieved object.
+ * @returns Zero on success, -1 on failure.
+ */
+int32_t circularfs_fetch( struct circularfs* fs, void* object, int32_t* size );
+
+/**
+ * Read next object from the ring, oldest-first, without fetching it. The read
+ * cursor only skips the invalid records in front of the object.
+ *
+ * @param fs Initialized RingFS instance.
+ * @param object Buffer to store retrieved object, of the maximum object size.
+ * @param size Size of the retrieved object.
  * @returns Zero on success, -1 on failure.
  */
-int32_t circularfs_fetch( struct circularfs* fs, void* object );
+int32_t circularfs_peek( struct circularfs* fs, void* object, int32_t* size );
 
 /**
  * Discard all fetched objects up to the read cursor.
@@ -215,6 +276,15 @@ int32_t circularfs_fetch( struct circularfs* fs, void* object );
  */
 int32_t circularfs_discard( struct circularfs* fs );
 
+/**
+ * Discard the fetched objects selected by a bitfield, bit x for the record x from the read head. The objects from the
+ * read cursor are not fetched and are kept. The summary of a closed sector modified this way is invalidated, the
+ * sector is walked again by the next scan.
+ *
+ * @param fs Initialized RingFS instance.
+ * @param item_x Bitfield of the records to discard.
+ * @returns Zero on success, -1 on failure.
+ */
 int32_t circularfs_discard_item_x_from_head_position( struct circularfs* fs, uint32_t item_x );
 
 /**
@@ -0,0 +1,326 @@
+/**
+ * @file      mac_journal.c
+ *
+ * @brief     Journal of frequently updated MAC counters spread over several flash pages
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include "mac_journal.h"
+#include "modem_core.h"
+#include "smtc_modem_hal.h"
+#include "smtc_modem_hal_dbg_trace.h"
+#include "modem_perf_counters.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/**
+ * @brief Index of a counter in the RAM copy
+ */
+#define MAC_JOURNAL_INDEX( stack_id, id ) ( ( ( stack_id ) * MAC_JOURNAL_ID_NUMBER ) + ( id ) )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/**
+ * @brief Magic word of an initialized page, "JRNL"
+ */
+#define MAC_JOURNAL_MAGIC ( 0x4C4E524A )
+
+/**
+ * @brief Number of counters of all stacks
+ */
+#define MAC_JOURNAL_ENTRIES ( NUMBER_OF_STACKS * MAC_JOURNAL_ID_NUMBER )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief Page header, programmed after the records copied in the page so an interrupted compaction is ignored
+ */
+typedef struct mac_journal_page_header_s
+{
+    uint32_t magic;
+    uint32_t sequence;  // incremented at each compaction, the page with the highest sequence is the active one
+} mac_journal_page_header_t;
+
+/**
+ * @brief Counter update, one flash double word. An erased record ends the page log
+ */
+typedef struct mac_journal_record_s
+{
+    uint8_t  stack_id;
+    uint8_t  id;
+    uint16_t check;  // low half of the crc of the other fields, detects a record torn by a reset
+    uint32_t value;
+} mac_journal_record_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static struct
+{
+    bool     initialized;
+    bool     enabled;
+    uint16_t nb_pages;
+    uint16_t page_size;
+    uint16_t page;          // active page
+    uint32_t sequence;      // sequence of the active page
+    uint32_t write_offset;  // offset of the next record in the active page
+    bool     known[MAC_JOURNAL_ENTRIES];
+    uint32_t values[MAC_JOURNAL_ENTRIES];
+} mac_journal;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Compute the check field of a record
+ *
+ * @param [in] record Record to check
+ * @return uint16_t Check value
+ */
+static uint16_t mac_journal_record_check( const mac_journal_record_t* record );
+
+/**
+ * @brief Program a record of a counter
+ *
+ * @param [in] offset Offset of the record in the journal pages
+ * @param [in] index  Index of the counter in the RAM copy
+ */
+static void mac_journal_program_record( uint32_t offset, uint8_t index );
+
+/**
+ * @brief Copy the last value of every counter in the next page and make it the active page
+ */
+static void mac_journal_compact( void );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+mac_journal_rc_t mac_journal_init( void )
+{
+    if( mac_journal.initialized == true )
+    {
+        return ( mac_journal.enabled == true ) ? MAC_JOURNAL_RC_OK : MAC_JOURNAL_RC_DISABLED;
+    }
+    mac_journal.initialized = true;
+    mac_journal.nb_pages    = smtc_modem_hal_mac_journal_get_number_of_pages( );
+
+    if( mac_journal.nb_pages < 2 )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "MAC journal disabled, %u page(s) reserved\n", mac_journal.nb_pages );
+        return MAC_JOURNAL_RC_DISABLED;
+    }
+    mac_journal.enabled   = true;
+    mac_journal.page_size = smtc_modem_hal_flash_get_page_size( );
+
+    // Find the active page
+    bool found = false;
+    for( uint16_t i = 0; i < mac_journal.nb_pages; i++ )
+    {
+        mac_journal_page_header_t header;
+        smtc_modem_hal_context_restore( CONTEXT_MAC_JOURNAL, ( uint32_t ) i * mac_journal.page_size,
+                                        ( uint8_t* ) &header, sizeof( header ) );
+        if( ( header.magic == MAC_JOURNAL_MAGIC ) &&
+            ( ( found == false ) || ( ( int32_t ) ( header.sequence - mac_journal.sequence ) > 0 ) ) )
+        {
+            found                = true;
+            mac_journal.page     = i;
+            mac_journal.sequence = header.sequence;
+        }
+    }
+
+    if( found == false )
+    {
+        // Empty journal: the first write initializes page 0
+        mac_journal.page         = mac_journal.nb_pages - 1;
+        mac_journal.sequence     = 0;
+        mac_journal.write_offset = mac_journal.page_size;
+        return MAC_JOURNAL_RC_OK;
+    }
+
+    // Replay the active page up to the first erased record
+    uint32_t page_offset     = ( uint32_t ) mac_journal.page * mac_journal.page_size;
+    mac_journal.write_offset = sizeof( mac_journal_page_header_t );
+    while( ( mac_journal.write_offset + sizeof( mac_journal_record_t ) ) <= mac_journal.page_size )
+    {
+        mac_journal_record_t record;
+        smtc_modem_hal_context_restore( CONTEXT_MAC_JOURNAL, page_offset + mac_journal.write_offset,
+                                        ( uint8_t* ) &record, sizeof( record ) );
+
+        if( ( record.stack_id == 0xFF ) && ( record.id == 0xFF ) && ( record.check == 0xFFFF ) &&
+            ( record.value == 0xFFFFFFFF ) )
+        {
+            break;
+        }
+        mac_journal.write_offset += sizeof( mac_journal_record_t );
+
+        if( ( record.stack_id < NUMBER_OF_STACKS ) && ( record.id < MAC_JOURNAL_ID_NUMBER ) &&
+            ( record.check == mac_journal_record_check( &record ) ) )
+        {
+            uint8_t index             = MAC_JOURNAL_INDEX( record.stack_id, record.id );
+            mac_journal.known[index]  = true;
+            mac_journal.values[index] = record.value;
+        }
+    }
+    SMTC_MODEM_HAL_TRACE_PRINTF( "MAC journal page %u, sequence %u, %u bytes used\n", mac_journal.page,
+                                 mac_journal.sequence, mac_journal.write_offset );
+    return MAC_JOURNAL_RC_OK;
+}
+
+mac_journal_rc_t mac_journal_write( uint8_t stack_id, mac_journal_id_t id, uint32_t value )
+{
+    if( ( stack_id >= NUMBER_OF_STACKS ) || ( id >= MAC_JOURNAL_ID_NUMBER ) )
+    {
+        return MAC_JOURNAL_RC_INVALID;
+    }
+    if( mac_journal.enabled == false )
+    {
+        return MAC_JOURNAL_RC_DISABLED;
+    }
+
+    uint8_t index = MAC_JOURNAL_INDEX( stack_id, id );
+    if( ( mac_journal.known[index] == true ) && ( mac_journal.values[index] == value ) )
+    {
+        return MAC_JOURNAL_RC_OK;
+    }
+    mac_journal.known[index]  = true;
+    mac_journal.values[index] = value;
+
+    if( ( mac_journal.write_offset + sizeof( mac_journal_record_t ) ) > mac_journal.page_size )
+    {
+        // The compaction writes the new value with the others
+        mac_journal_compact( );
+    }
+    else
+    {
+        mac_journal_program_record( ( ( uint32_t ) mac_journal.page * mac_journal.page_size ) + mac_journal.write_offset,
+                                    index );
+        mac_journal.write_offset += sizeof( mac_journal_record_t );
+    }
+    return MAC_JOURNAL_RC_OK;
+}
+
+bool mac_journal_read( uint8_t stack_id, mac_journal_id_t id, uint32_t* value )
+{
+    if( ( mac_journal.enabled == false ) || ( stack_id >= NUMBER_OF_STACKS ) || ( id >= MAC_JOURNAL_ID_NUMBER ) )
+    {
+        return false;
+    }
+
+    uint8_t index = MAC_JOURNAL_INDEX( stack_id, id );
+    if( mac_journal.known[index] == false )
+    {
+        return false;
+    }
+    *value = mac_journal.values[index];
+    return true;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint16_t mac_journal_record_check( const mac_journal_record_t* record )
+{
+    uint8_t buffer[6] = { record->stack_id,
+                          record->id,
+                          ( uint8_t ) ( record->value ),
+                          ( uint8_t ) ( record->value >> 8 ),
+                          ( uint8_t ) ( record->value >> 16 ),
+                          ( uint8_t ) ( record->value >> 24 ) };
+
+    return ( uint16_t ) crc( buffer, sizeof( buffer ) );
+}
+
+static void mac_journal_program_record( uint32_t offset, uint8_t index )
+{
+    mac_journal_record_t record = {
+        .stack_id = index / MAC_JOURNAL_ID_NUMBER,
+        .id       = index % MAC_JOURNAL_ID_NUMBER,
+        .value    = mac_journal.values[index],
+    };
+    record.check = mac_journal_record_check( &record );
+
+    smtc_modem_hal_context_store( CONTEXT_MAC_JOURNAL, offset, ( uint8_t* ) &record, sizeof( record ) );
+}
+
+static void mac_journal_compact( void )
+{
+    uint16_t next_page   = ( mac_journal.page + 1 ) % mac_journal.nb_pages;
+    uint32_t page_offset = ( uint32_t ) next_page * mac_journal.page_size;
+    uint32_t offset      = sizeof( mac_journal_page_header_t );
+
+    smtc_modem_hal_context_flash_pages_erase( CONTEXT_MAC_JOURNAL, page_offset, 1 );
+    MODEM_PERF_COUNTER_ADD( MODEM_PERF_FLASH_ERASE_NB, 1 );
+
+    for( uint8_t i = 0; i < MAC_JOURNAL_ENTRIES; i++ )
+    {
+        if( mac_journal.known[i] == true )
+        {
+            mac_journal_program_record( page_offset + offset, i );
+            offset += sizeof( mac_journal_record_t );
+        }
+    }
+
+    // The header makes the page active once all values are copied
+    mac_journal_page_header_t header = {
+        .magic    = MAC_JOURNAL_MAGIC,
+        .sequence = mac_journal.sequence + 1,
+    };
+    smtc_modem_hal_context_store( CONTEXT_MAC_JOURNAL, page_offset, ( uint8_t* ) &header, sizeof( header ) );
+
+    mac_journal.page         = next_page;
+    mac_journal.sequence     = header.sequence;
+    mac_journal.write_offset = offset;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,132 @@
+/**
+ * @file      mac_journal.h
+ *
+ * @brief     Journal of frequently updated MAC counters spread over several flash pages
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MAC_JOURNAL_H
+#define MAC_JOURNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Counters kept in the journal
+ *
+ * @enum mac_journal_id_t
+ */
+typedef enum mac_journal_id_e
+{
+    MAC_JOURNAL_DEVNONCE,  //!< DevNonce of the last join request
+    MAC_JOURNAL_FCNT_UP,   //!< First uplink frame counter not used yet
+    MAC_JOURNAL_ID_NUMBER,
+} mac_journal_id_t;
+
+/**
+ * @brief Definition of return codes for journal functions
+ *
+ * @enum mac_journal_rc_t
+ */
+typedef enum mac_journal_rc_e
+{
+    MAC_JOURNAL_RC_OK,        //!< Function executed without error
+    MAC_JOURNAL_RC_DISABLED,  //!< Less than 2 pages reserved for the journal
+    MAC_JOURNAL_RC_INVALID,   //!< Invalid parameters
+} mac_journal_rc_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Load the journal from flash
+ *
+ * @remark The pages are scanned once, later calls do nothing
+ *
+ * @return mac_journal_rc_t
+ */
+mac_journal_rc_t mac_journal_init( void );
+
+/**
+ * @brief Append a counter update to the journal
+ *
+ * @remark Writing the current value does nothing. When the page is full, the last value of every counter is copied in
+ * the next page, which is erased first
+ *
+ * @param [in] stack_id Stack identifier
+ * @param [in] id       Counter
+ * @param [in] value    New value
+ * @return mac_journal_rc_t
+ */
+mac_journal_rc_t mac_journal_write( uint8_t stack_id, mac_journal_id_t id, uint32_t value );
+
+/**
+ * @brief Get the last value of a counter
+ *
+ * @param [in]  stack_id Stack identifier
+ * @param [in]  id       Counter
+ * @param [out] value    Last value written
+ * @return true if the counter is in the journal
+ */
+bool mac_journal_read( uint8_t stack_id, mac_journal_id_t id, uint32_t* value );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MAC_JOURNAL_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,233 @@
+/*!
+ * \file      modem_async.c
+ *
+ * \brief     Stackless coroutines for the modem services, resumed by the supervisor events they await
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
+
+#include "modem_async.h"
+#include "modem_core.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Run the body until its next await, and queue the service task of the awaited time
+ *
+ * \param [in] async      Coroutine
+ * \param [in] downlink   Downlink resuming the body, NULL otherwise
+ * \param [in] is_launch  The body is resumed from the launch of the service task
+ */
+static void modem_async_resume( modem_async_t* async, lr1_stack_mac_down_data_t* downlink, bool is_launch );
+
+/*!
+ * \brief Queue the service task in the supervisor for the awaited time
+ *
+ * \param [in] async Coroutine
+ */
+static void modem_async_queue_task( modem_async_t* async );
+
+/*!
+ * \brief Remove the service task queued for the awaited time
+ *
+ * \param [in] async Coroutine
+ */
+static void modem_async_cancel_task( modem_async_t* async );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void modem_async_init( modem_async_t* async, void ( *body )( modem_async_t* async ), uint8_t task_id,
+                       uint8_t stack_id, task_priority_t priority, void* context )
+{
+    async->resume_line     = 0;
+    async->wait            = MODEM_ASYNC_WAIT_NONE;
+    async->is_task_pending = false;
+    async->is_task_queued  = false;
+    async->task_id         = task_id;
+    async->stack_id        = stack_id;
+    async->priority        = priority;
+    async->fport           = 0;
+    async->delay_ms        = 0;
+    async->downlink        = NULL;
+    async->context         = context;
+    async->body            = body;
+}
+
+void modem_async_start( modem_async_t* async )
+{
+    modem_async_stop( async );
+    modem_async_resume( async, NULL, false );
+}
+
+void modem_async_stop( modem_async_t* async )
+{
+    modem_async_cancel_task( async );
+    async->resume_line = 0;
+    async->wait        = MODEM_ASYNC_WAIT_NONE;
+}
+
+bool modem_async_is_running( const modem_async_t* async )
+{
+    return async->wait != MODEM_ASYNC_WAIT_NONE;
+}
+
+void modem_async_on_launch( modem_async_t* async )
+{
+    // The supervisor removes the launched task on return
+    async->is_task_queued = false;
+
+    if( ( async->wait == MODEM_ASYNC_WAIT_TIME ) || ( async->wait == MODEM_ASYNC_WAIT_DOWNLINK ) )
+    {
+        modem_async_resume( async, NULL, true );
+    }
+}
+
+void modem_async_on_update( modem_async_t* async )
+{
+    if( async->wait == MODEM_ASYNC_WAIT_TX_DONE )
+    {
+        modem_async_resume( async, NULL, false );
+    }
+    else if( async->is_task_pending == true )
+    {
+        modem_async_queue_task( async );
+    }
+}
+
+uint8_t modem_async_on_downlink( modem_async_t* async, lr1_stack_mac_down_data_t* rx_down_data )
+{
+    if( ( async->wait != MODEM_ASYNC_WAIT_DOWNLINK ) || ( rx_down_data->stack_id != async->stack_id ) ||
+        ( rx_down_data->rx_metadata.rx_fport_present == false ) ||
+        ( rx_down_data->rx_metadata.rx_fport != async->fport ) )
+    {
+        return MODEM_DOWNLINK_UNCONSUMED;
+    }
+
+    // The timeout is no longer needed
+    modem_async_cancel_task( async );
+    modem_async_resume( async, rx_down_data, false );
+    return MODEM_DOWNLINK_CONSUMED;
+}
+
+lr1_stack_mac_down_data_t* modem_async_get_downlink( const modem_async_t* async )
+{
+    return async->downlink;
+}
+
+void* modem_async_get_context( const modem_async_t* async )
+{
+    return async->context;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void modem_async_resume( modem_async_t* async, lr1_stack_mac_down_data_t* downlink, bool is_launch )
+{
+    async->is_task_pending = false;
+    async->downlink        = downlink;
+    async->body( async );
+    async->downlink = NULL;
+
+    if( ( async->wait == MODEM_ASYNC_WAIT_TIME ) || ( async->wait == MODEM_ASYNC_WAIT_DOWNLINK ) )
+    {
+        if( is_launch == true )
+        {
+            // A task added from its own launch would be finished by the supervisor on return, it is queued from the
+            // update of the launched task instead
+            async->is_task_pending = true;
+        }
+        else
+        {
+            modem_async_queue_task( async );
+        }
+    }
+}
+
+static void modem_async_queue_task( modem_async_t* async )
+{
+    smodem_task task = { 0 };
+
+    task.id       = async->task_id;
+    task.stack_id = async->stack_id;
+    task.priority = async->priority;
+
+    async->is_task_pending = false;
+    async->is_task_queued  = ( modem_supervisor_add_task_in_ms( &task, async->delay_ms ) == TASK_VALID );
+}
+
+static void modem_async_cancel_task( modem_async_t* async )
+{
+    async->is_task_pending = false;
+    if( async->is_task_queued == true )
+    {
+        modem_supervisor_remove_task( async->task_id );
+        async->is_task_queued = false;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
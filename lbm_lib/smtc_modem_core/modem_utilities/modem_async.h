@@ -0,0 +1,251 @@
+/*!
+ * \file      modem_async.h
+ *
+ * \brief     Stackless coroutines for the modem services, resumed by the supervisor events they await
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef MODEM_ASYNC_H
+#define MODEM_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include "lr1_stack_mac_layer.h"
+#include "modem_supervisor_light.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*!
+ * \brief Start of the coroutine body, to be the first statement of the function given to modem_async_init()
+ *
+ * \remark The body is resumed at the line of its last await: the local variables are not kept across an await, the
+ * state of the service stays in its object. An await can't be placed in a nested switch statement
+ */
+#define MODEM_ASYNC_BEGIN( async )          \
+    switch( ( async )->resume_line )        \
+    {                                       \
+    case 0:
+
+/*!
+ * \brief End of the coroutine body, to be the last statement of the function given to modem_async_init()
+ */
+#define MODEM_ASYNC_END( async )                   \
+    }                                              \
+    ( async )->resume_line = 0;                    \
+    ( async )->wait        = MODEM_ASYNC_WAIT_NONE
+
+/*!
+ * \brief Return from the body until the awaited event, the body is resumed after the macro
+ */
+#define MODEM_ASYNC_YIELD( async, wait_type )   \
+    do                                          \
+    {                                           \
+        ( async )->wait        = ( wait_type ); \
+        ( async )->resume_line = __LINE__;      \
+        return;                                 \
+    case __LINE__:;                             \
+    } while( 0 )
+
+/*!
+ * \brief Wait for time_ms, the body is resumed at the launch of the service task queued in the supervisor
+ *
+ * \remark A TX requested from there is sent by the stack when the body returns to the supervisor
+ */
+#define MODEM_ASYNC_AWAIT_TIME( async, time_ms )           \
+    do                                                     \
+    {                                                      \
+        ( async )->delay_ms = ( time_ms );                 \
+        MODEM_ASYNC_YIELD( async, MODEM_ASYNC_WAIT_TIME ); \
+    } while( 0 )
+
+/*!
+ * \brief Wait for the end of the service task launched by the last time await, the TX requested at its launch done
+ * and its receive windows closed, from the supervisor update of the task
+ */
+#define MODEM_ASYNC_AWAIT_TX_DONE( async ) MODEM_ASYNC_YIELD( async, MODEM_ASYNC_WAIT_TX_DONE )
+
+/*!
+ * \brief Wait for a downlink on fport, or for timeout_ms
+ *
+ * \remark The downlink is given by modem_async_get_downlink() and consumed by the service, NULL after a timeout
+ */
+#define MODEM_ASYNC_AWAIT_DOWNLINK( async, port, timeout_ms )  \
+    do                                                         \
+    {                                                          \
+        ( async )->fport    = ( port );                        \
+        ( async )->delay_ms = ( timeout_ms );                  \
+        MODEM_ASYNC_YIELD( async, MODEM_ASYNC_WAIT_DOWNLINK ); \
+    } while( 0 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * \brief Event awaited by a coroutine
+ */
+typedef enum modem_async_wait_e
+{
+    MODEM_ASYNC_WAIT_NONE,      //!< Not started or ended, resumed by modem_async_start()
+    MODEM_ASYNC_WAIT_TIME,      //!< Resumed at the launch of the service task
+    MODEM_ASYNC_WAIT_TX_DONE,   //!< Resumed at the update of the service task
+    MODEM_ASYNC_WAIT_DOWNLINK,  //!< Resumed by a downlink on the awaited port, or at the launch of the service task
+} modem_async_wait_t;
+
+/*!
+ * \brief Coroutine of a service, allocated in the service object and only accessed through the modem_async_* API
+ */
+typedef struct modem_async_s
+{
+    uint16_t                   resume_line;      //!< Line of the last await, 0 to start the body from the beginning
+    modem_async_wait_t         wait;             //!< Awaited event
+    bool                       is_task_pending;  //!< A time awaited from a task launch waits to be queued
+    bool                       is_task_queued;   //!< The service task is queued in the supervisor for the awaited time
+    uint8_t                    task_id;          //!< Supervisor task of the service
+    uint8_t                    stack_id;         //!< Stack of the service
+    task_priority_t            priority;         //!< Priority of the service task
+    uint8_t                    fport;            //!< Awaited downlink port
+    uint32_t                   delay_ms;         //!< Awaited time, or timeout of the awaited downlink
+    lr1_stack_mac_down_data_t* downlink;         //!< Downlink of the last resume, NULL if it was not a downlink
+    void*                      context;          //!< Service context, given back by modem_async_get_context()
+    void ( *body )( struct modem_async_s* async );  //!< Coroutine body
+} modem_async_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief Init a coroutine, to be called from the service init
+ *
+ * \param [out] async     Coroutine
+ * \param [in]  body      Coroutine body, starting with MODEM_ASYNC_BEGIN() and ending with MODEM_ASYNC_END()
+ * \param [in]  task_id   Supervisor task of the service
+ * \param [in]  stack_id  Stack of the service
+ * \param [in]  priority  Priority of the service task
+ * \param [in]  context   Service context
+ */
+void modem_async_init( modem_async_t* async, void ( *body )( modem_async_t* async ), uint8_t task_id,
+                       uint8_t stack_id, task_priority_t priority, void* context );
+
+/*!
+ * \brief Run the body from its beginning, the ongoing await is cancelled
+ *
+ * \param [in] async Coroutine
+ */
+void modem_async_start( modem_async_t* async );
+
+/*!
+ * \brief Cancel the ongoing await, the body is not resumed until the next modem_async_start()
+ *
+ * \param [in] async Coroutine
+ */
+void modem_async_stop( modem_async_t* async );
+
+/*!
+ * \brief Tell whether the body has started and not ended
+ *
+ * \param [in] async Coroutine
+ *
+ * \returns true while an event is awaited
+ */
+bool modem_async_is_running( const modem_async_t* async );
+
+/*!
+ * \brief Resume the body awaiting a time or the downlink timeout, to be called from the service on_launch callback
+ *
+ * \param [in] async Coroutine
+ */
+void modem_async_on_launch( modem_async_t* async );
+
+/*!
+ * \brief Resume the body awaiting the TX done, to be called from the service on_update callback
+ *
+ * \remark The time awaited from the launch of the task is queued here, once the supervisor has finished the task
+ *
+ * \param [in] async Coroutine
+ */
+void modem_async_on_update( modem_async_t* async );
+
+/*!
+ * \brief Resume the body awaiting a downlink on its port, to be called from the service downlink handler
+ *
+ * \param [in] async         Coroutine
+ * \param [in] rx_down_data  Downlink
+ *
+ * \returns MODEM_DOWNLINK_CONSUMED if the body was resumed, MODEM_DOWNLINK_UNCONSUMED otherwise
+ */
+uint8_t modem_async_on_downlink( modem_async_t* async, lr1_stack_mac_down_data_t* rx_down_data );
+
+/*!
+ * \brief Get the downlink that resumed the body
+ *
+ * \param [in] async Coroutine
+ *
+ * \returns The downlink, NULL if the body was not resumed by a downlink
+ */
+lr1_stack_mac_down_data_t* modem_async_get_downlink( const modem_async_t* async );
+
+/*!
+ * \brief Get the service context given to modem_async_init()
+ *
+ * \param [in] async Coroutine
+ *
+ * \returns Service context
+ */
+void* modem_async_get_context( const modem_async_t* async );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_ASYNC_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,139 @@
+/*!
+ * \file      modem_battery_estimator.c
+ *
+ * \brief     Battery life estimation from the radio charge measured by the radio planner
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "modem_battery_estimator.h"
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*!
+ * \brief Battery levels of the LoRaWAN DevStatusAns returned by smtc_modem_hal_get_battery_level()
+ */
+#define BATTERY_LEVEL_EXTERNAL_POWER 0
+#define BATTERY_LEVEL_MAX 254
+#define BATTERY_LEVEL_UNKNOWN 255
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint32_t battery_observation_start_s;
+static uint32_t battery_capacity_mah;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void modem_battery_estimator_init( void )
+{
+    battery_capacity_mah = 0;
+    modem_battery_estimator_restart( );
+}
+
+void modem_battery_estimator_restart( void )
+{
+    battery_observation_start_s = smtc_modem_hal_get_time_in_s( );
+}
+
+void modem_battery_estimator_set_capacity( uint32_t capacity_mah )
+{
+    battery_capacity_mah = capacity_mah;
+}
+
+void modem_battery_estimator_get( uint64_t radio_charge_ua_ms, smtc_modem_battery_estimate_t* estimate )
+{
+    estimate->observation_s    = smtc_modem_hal_get_time_in_s( ) - battery_observation_start_s;
+    estimate->sleep_current_ua = smtc_modem_hal_get_sleep_current_ua( );
+
+    // The radio charge is spread over the observation, the services and classes configured during it included
+    uint64_t radio_current_ua = 0;
+    if( estimate->observation_s > 0 )
+    {
+        radio_current_ua = radio_charge_ua_ms / ( ( uint64_t ) estimate->observation_s * 1000 );
+    }
+    estimate->radio_current_ua = ( radio_current_ua > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) radio_current_ua;
+
+    uint64_t average_current_ua = radio_current_ua + estimate->sleep_current_ua;
+    estimate->average_current_ua = ( average_current_ua > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) average_current_ua;
+
+    estimate->remaining_life_h = UINT32_MAX;
+    uint8_t battery_level      = smtc_modem_hal_get_battery_level( );
+    if( ( battery_capacity_mah == 0 ) || ( average_current_ua == 0 ) ||
+        ( battery_level == BATTERY_LEVEL_EXTERNAL_POWER ) || ( battery_level == BATTERY_LEVEL_UNKNOWN ) )
+    {
+        return;
+    }
+
+    uint64_t remaining_uah    = ( ( uint64_t ) battery_capacity_mah * 1000 * battery_level ) / BATTERY_LEVEL_MAX;
+    uint64_t remaining_life_h = remaining_uah / average_current_ua;
+
+    // UINT32_MAX is kept for the unknown life
+    estimate->remaining_life_h = ( uint32_t ) ( ( remaining_life_h < UINT32_MAX ) ? remaining_life_h : UINT32_MAX - 1 );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
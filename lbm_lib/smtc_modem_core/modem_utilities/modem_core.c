@@ -42,8 +42,12 @@
 
 #include "modem_core.h"
 #include "modem_event_utilities.h"
+#include "modem_crc.h"
 
 #include "smtc_modem_hal_dbg_trace.h"
+#include "smtc_modem_dbg_profile.h"
+#include "smtc_modem_dbg_latency.h"
+#include "modem_perf_counters.h"
 #include "smtc_real.h"
 #include "lorawan_api.h"
 #include "smtc_modem_api.h"
@@ -90,6 +94,8 @@
 #else
 #define NUMBER_OF_LORAWAN_MANAGEMENT_TASKS 4
 #endif
+#define NUMBER_OF_DOWNLINK_SERVICES ( NUMBER_OF_SERVICES + NUMBER_OF_LORAWAN_MANAGEMENT_TASKS )
+#define MODEM_DOWNLINK_NO_SERVICE 0xff
 
 /*
  * -----------------------------------------------------------------------------
@@ -117,8 +123,10 @@ struct
     uint32_t             user_alarm;
     fifo_ctrl_t          fifo_ctrl_obj;
     uint8_t              fifo_buffer[FIFO_LORAWAN_SIZE];
-    uint8_t ( *downlink_services_callback[NUMBER_OF_SERVICES + NUMBER_OF_LORAWAN_MANAGEMENT_TASKS] )(
-        lr1_stack_mac_down_data_t* rx_down_data );
+    uint8_t ( *downlink_services_callback[NUMBER_OF_DOWNLINK_SERVICES] )( lr1_stack_mac_down_data_t* rx_down_data );
+    uint16_t downlink_services_port[NUMBER_OF_DOWNLINK_SERVICES];
+    uint8_t  downlink_services_next[NUMBER_OF_DOWNLINK_SERVICES];  // next service dispatched on the same port
+    uint8_t  downlink_port_first_service[MODEM_DOWNLINK_ANY_PORT + 1];
     uint32_t modem_reset_counter;
 } modem_ctx_light;
 
@@ -130,13 +138,51 @@ struct
 #define fifo_ctrl_obj modem_ctx_light.fifo_ctrl_obj
 #define fifo_buffer modem_ctx_light.fifo_buffer
 #define downlink_services_callback modem_ctx_light.downlink_services_callback
+#define downlink_services_port modem_ctx_light.downlink_services_port
+#define downlink_services_next modem_ctx_light.downlink_services_next
+#define downlink_port_first_service modem_ctx_light.downlink_port_first_service
 #define modem_reset_counter modem_ctx_light.modem_reset_counter
 
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+/**
+ * @brief RAM shadow of a context area
+ */
+typedef struct modem_context_cache_line_s
+{
+    modem_context_type_t ctx_type;
+    uint32_t             offset;
+    uint16_t             size;
+    uint16_t             capacity;    // bytes reserved in the pool, a released line is reused by a smaller area
+    uint16_t             pool_index;  // first byte of the shadow in the pool
+    bool                 valid;
+    bool                 dirty;
+    void ( *callback )( void* context );  // completion of an asynchronous store, called once the shadow is written
+    void* callback_context;
+} modem_context_cache_line_t;
+
+static struct
+{
+    modem_context_cache_line_t lines[MODEM_CONTEXT_CACHE_LINES];
+    uint8_t                    nb_lines;
+    uint16_t                   pool_used;
+    uint8_t                    pool[MODEM_CONTEXT_CACHE_SIZE];
+    bool                       dirty;
+    uint32_t                   dirty_since_ms;
+} modem_context_cache;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 static void modem_downlink_callback( lr1_stack_mac_down_data_t* rx_down_data );
+static void modem_downlink_service_link( uint8_t index, uint16_t fport );
+static void modem_downlink_service_unlink( uint8_t index );
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+static modem_context_cache_line_t* modem_context_cache_get( const modem_context_type_t ctx_type, uint32_t offset,
+                                                            const uint32_t size, bool allocate );
+static void modem_context_cache_write_line( modem_context_cache_line_t* line );
+#endif
 // static void check_class_b_to_generate_event( void );
 
 /*
@@ -168,6 +214,14 @@ void modem_context_init_light( void ( *callback )( void ), radio_planner_t* rp )
         lorawan_api_set_region( region, stack_id );
     }
 
+    // Services are dispatched every downlink until they register their port
+    memset( downlink_port_first_service, MODEM_DOWNLINK_NO_SERVICE, sizeof( downlink_port_first_service ) );
+    for( uint8_t i = 0; i < NUMBER_OF_DOWNLINK_SERVICES; i++ )
+    {
+        downlink_services_port[i] = MODEM_DOWNLINK_ANY_PORT;
+        downlink_services_next[i] = MODEM_DOWNLINK_NO_SERVICE;
+    }
+
     uint8_t index_tmp = 0;
     lorawan_send_management_services_init( ( uint8_t* ) UNUSED_VALUE, UNUSED_VALUE,
                                            &downlink_services_callback[index_tmp++], &callback_on_launch_temp,
@@ -211,6 +265,16 @@ void modem_context_init_light( void ( *callback )( void ), radio_planner_t* rp )
         cpt_of_services_init++;
     }
 
+    // Services without downlink handler are dropped, the others not bound to a port get every downlink
+    for( uint8_t i = 0; i < NUMBER_OF_DOWNLINK_SERVICES; i++ )
+    {
+        if( ( downlink_services_callback[i] != NULL ) && ( downlink_services_port[i] == MODEM_DOWNLINK_ANY_PORT ) )
+        {
+            modem_downlink_service_unlink( i );
+            modem_downlink_service_link( i, MODEM_DOWNLINK_ANY_PORT );
+        }
+    }
+
     // save radio planner pointer for suspend/resume features
 
     is_modem_in_test_mode = false;
@@ -310,17 +374,7 @@ bool modem_resume_radio_access( void )
 
 uint32_t crc( const uint8_t* buf, int len )
 {
-    uint32_t crc = 0xFFFFFFFF;
-    while( len-- > 0 )
-    {
-        crc = crc ^ *buf++;
-        for( int i = 0; i < 8; i++ )
-        {
-            uint32_t mask = -( crc & 1 );
-            crc           = ( crc >> 1 ) ^ ( 0xEDB88320 & mask );
-        }
-    }
-    return ~crc;
+    return modem_crc32( buf, ( len > 0 ) ? ( uint32_t ) len : 0 );
 }
 
 int32_t modem_duty_cycle_get_status( uint8_t stack_id )
@@ -406,7 +460,7 @@ void modem_store_modem_context( void )
     modem_ctx_t ctx = { 0 };
 
     // Restore current saved context
-    smtc_modem_hal_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
 
     // Check if some values have changed
     if( ctx.reset_counter != modem_reset_counter )
@@ -414,25 +468,24 @@ void modem_store_modem_context( void )
         ctx.reset_counter = modem_reset_counter;
         ctx.crc           = crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
 
-        smtc_modem_hal_context_store( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
-        // dummy context reading to ensure context store is done before exiting the function
-        smtc_modem_hal_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        // Written outside radio critical windows, nothing waits for the completion
+        modem_context_store_async( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ), NULL, NULL );
     }
 }
 
 void modem_load_modem_context( void )
 {
     modem_ctx_t ctx = { 0 };
-    smtc_modem_hal_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
 
     if( crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) ) != ctx.crc )
     {
         memset( &ctx, 0, sizeof( ctx ) );
         ctx.crc = crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
 
-        smtc_modem_hal_context_store( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_store( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
         // dummy context reading to ensure context store is done before exiting the function
-        smtc_modem_hal_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_restore( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
     }
 
     modem_reset_counter = ctx.reset_counter;
@@ -441,7 +494,7 @@ void modem_load_modem_context( void )
 void modem_reset_modem_context( void )
 {
     modem_ctx_t ctx = { 0 };
-    smtc_modem_hal_context_store( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_store( CONTEXT_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
 }
 
 uint32_t modem_get_reset_counter( void )
@@ -449,11 +502,190 @@ uint32_t modem_get_reset_counter( void )
     return modem_reset_counter;
 }
 
+void modem_context_store( const modem_context_type_t ctx_type, uint32_t offset, const uint8_t* buffer,
+                          const uint32_t size )
+{
+    modem_context_store_async( ctx_type, offset, buffer, size, NULL, NULL );
+}
+
+void modem_context_store_async( const modem_context_type_t ctx_type, uint32_t offset, const uint8_t* buffer,
+                                const uint32_t size, void ( *callback )( void* context ), void* context )
+{
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+    modem_context_cache_line_t* line = modem_context_cache_get( ctx_type, offset, size, true );
+
+    if( line != NULL )
+    {
+        uint8_t* shadow = &modem_context_cache.pool[line->pool_index];
+
+        // One completion per area: a pending store with another callback is written first
+        if( ( callback != NULL ) && ( line->callback != NULL ) &&
+            ( ( line->callback != callback ) || ( line->callback_context != context ) ) )
+        {
+            modem_context_cache_write_line( line );
+        }
+
+        // A new shadow is dirty until its first write
+        if( ( line->dirty == true ) || ( memcmp( shadow, buffer, size ) != 0 ) )
+        {
+            memcpy( shadow, buffer, size );
+            line->dirty = true;
+            if( modem_context_cache.dirty == false )
+            {
+                modem_context_cache.dirty          = true;
+                modem_context_cache.dirty_since_ms = smtc_modem_hal_get_time_in_ms( );
+            }
+        }
+
+        if( callback != NULL )
+        {
+            if( line->dirty == true )
+            {
+                line->callback         = callback;
+                line->callback_context = context;
+            }
+            else
+            {
+                // Unchanged data, already in non volatile memory
+                callback( context );
+            }
+        }
+        return;
+    }
+#endif
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_CONTEXT_STORE );
+    smtc_modem_hal_context_store( ctx_type, offset, buffer, size );
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_CONTEXT_STORE );
+    if( callback != NULL )
+    {
+        callback( context );
+    }
+}
+
+void modem_context_restore( const modem_context_type_t ctx_type, uint32_t offset, uint8_t* buffer,
+                            const uint32_t size )
+{
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+    modem_context_cache_line_t* line = modem_context_cache_get( ctx_type, offset, size, false );
+
+    if( line != NULL )
+    {
+        memcpy( buffer, &modem_context_cache.pool[line->pool_index], size );
+        return;
+    }
+#endif
+    smtc_modem_hal_context_restore( ctx_type, offset, buffer, size );
+}
+
+void modem_context_flush( void )
+{
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+    if( modem_context_cache.dirty == false )
+    {
+        return;
+    }
+
+    for( uint8_t i = 0; i < modem_context_cache.nb_lines; i++ )
+    {
+        modem_context_cache_write_line( &modem_context_cache.lines[i] );
+    }
+    modem_context_cache.dirty = false;
+#endif
+}
+
+void modem_context_flush_on_idle( uint32_t sleep_time_ms )
+{
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+    if( modem_context_cache.dirty == false )
+    {
+        return;
+    }
+
+    // A page erase must not delay a radio task: the writes wait for a gap in the radio planner timeline
+    bool is_idle = ( sleep_time_ms >= MODEM_CONTEXT_FLUSH_IDLE_MS ) &&
+                   ( rp_get_next_task_delay_ms( modem_rp ) >= MODEM_CONTEXT_FLUSH_RADIO_GUARD_MS );
+
+    bool is_late = ( int32_t ) ( smtc_modem_hal_get_time_in_ms( ) - modem_context_cache.dirty_since_ms ) >=
+                   MODEM_CONTEXT_FLUSH_MAX_DELAY_MS;
+
+    if( ( is_idle == true ) || ( is_late == true ) )
+    {
+        modem_context_flush( );
+    }
+#endif
+}
+
+void modem_set_downlink_service_port( uint8_t ( *downlink_callback )( lr1_stack_mac_down_data_t* ), uint16_t fport )
+{
+    for( uint8_t i = 0; i < NUMBER_OF_DOWNLINK_SERVICES; i++ )
+    {
+        if( ( downlink_callback != NULL ) && ( downlink_services_callback[i] == downlink_callback ) )
+        {
+            modem_downlink_service_unlink( i );
+            modem_downlink_service_link( i, fport );
+            return;
+        }
+    }
+    SMTC_MODEM_HAL_TRACE_ERROR( "%s: unknown downlink service\n", __func__ );
+}
+
+void modem_move_downlink_services_port( uint8_t old_fport, uint8_t new_fport )
+{
+    if( old_fport == new_fport )
+    {
+        return;
+    }
+    while( downlink_port_first_service[old_fport] != MODEM_DOWNLINK_NO_SERVICE )
+    {
+        uint8_t index = downlink_port_first_service[old_fport];
+        modem_downlink_service_unlink( index );
+        modem_downlink_service_link( index, new_fport );
+    }
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+/**
+ * @brief Append a service at the end of the services dispatched on a port, the services keep their init order
+ *
+ * @param [in] index Index of the service in downlink_services_callback
+ * @param [in] fport Port of the service or MODEM_DOWNLINK_ANY_PORT
+ */
+static void modem_downlink_service_link( uint8_t index, uint16_t fport )
+{
+    uint8_t* next = &downlink_port_first_service[fport];
+    while( *next != MODEM_DOWNLINK_NO_SERVICE )
+    {
+        next = &downlink_services_next[*next];
+    }
+    *next                         = index;
+    downlink_services_next[index] = MODEM_DOWNLINK_NO_SERVICE;
+    downlink_services_port[index] = fport;
+}
+
+/**
+ * @brief Remove a service from the services dispatched on its port
+ *
+ * @param [in] index Index of the service in downlink_services_callback
+ */
+static void modem_downlink_service_unlink( uint8_t index )
+{
+    uint8_t* next = &downlink_port_first_service[downlink_services_port[index]];
+    while( *next != MODEM_DOWNLINK_NO_SERVICE )
+    {
+        if( *next == index )
+        {
+            *next = downlink_services_next[index];
+            break;
+        }
+        next = &downlink_services_next[*next];
+    }
+    downlink_services_next[index] = MODEM_DOWNLINK_NO_SERVICE;
+}
+
 void modem_downlink_callback( lr1_stack_mac_down_data_t* rx_down_data )
 {
     uint8_t                  downlink_used_by_services = 0;
@@ -480,15 +712,32 @@ void modem_downlink_callback( lr1_stack_mac_down_data_t* rx_down_data )
         metadata.rssi = ( int8_t ) ( rx_down_data->rx_metadata.rx_rssi + 64 );
     }
 
-    for( uint8_t i = 0; i < NUMBER_OF_SERVICES + NUMBER_OF_LORAWAN_MANAGEMENT_TASKS; i++ )
+    for( uint8_t i = downlink_port_first_service[MODEM_DOWNLINK_ANY_PORT]; i != MODEM_DOWNLINK_NO_SERVICE;
+         i = downlink_services_next[i] )
     {
         downlink_used_by_services += downlink_services_callback[i]( rx_down_data );
     }
 
+    // Port bound services only get the frames received on their port
+    if( ( rx_down_data->rx_metadata.rx_window != RECEIVE_NONE ) &&
+        ( rx_down_data->rx_metadata.rx_fport_present == true ) )
+    {
+        for( uint8_t i = downlink_port_first_service[rx_down_data->rx_metadata.rx_fport];
+             i != MODEM_DOWNLINK_NO_SERVICE; i = downlink_services_next[i] )
+        {
+            downlink_used_by_services += downlink_services_callback[i]( rx_down_data );
+        }
+    }
+
     if( rx_down_data->rx_metadata.rx_window == RECEIVE_NONE )
     {
         return;
     }
+    if( ( rx_down_data->rx_metadata.rx_window == RECEIVE_ON_RX1 ) ||
+        ( rx_down_data->rx_metadata.rx_window == RECEIVE_ON_RX2 ) )
+    {
+        MODEM_PERF_COUNTER_ADD( MODEM_PERF_RX_WINDOW_HIT_NB, 1 );
+    }
 
     // none services used the downlink data for itself then push it into the user fifo
     if( ( downlink_used_by_services == 0 ) && ( rx_down_data->rx_metadata.rx_fport != 0 ) )
@@ -501,10 +750,126 @@ void modem_downlink_callback( lr1_stack_mac_down_data_t* rx_down_data )
         }
         else
         {
-            increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_DOWNDATA, 0, rx_down_data->stack_id );
+            increment_asynchronous_msgnumber_with_data( SMTC_MODEM_EVENT_DOWNDATA, 0, rx_down_data->stack_id, 0,
+                                                        &metadata );
+            SMTC_MODEM_HAL_LATENCY_ADD( SMTC_LATENCY_DOWNLINK,
+                                        smtc_modem_hal_get_time_in_ms( ) - rx_down_data->rx_metadata.timestamp_ms );
             fifo_ctrl_print_stat( &fifo_ctrl_obj );
         }
     }
 }
 
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+/**
+ * @brief Get the shadow of a context area
+ *
+ * @remark Shadows overlapping the area without matching it exactly are written and released so the area can be
+ * accessed in non volatile memory. The first restore of an area loads its shadow
+ *
+ * @param [in] ctx_type Type of context
+ * @param [in] offset   Offset in the context
+ * @param [in] size     Size of the area
+ * @param [in] allocate Create a dirty shadow without loading it (area about to be overwritten)
+ * @return modem_context_cache_line_t* Shadow of the area, NULL if the area is not cached
+ */
+static modem_context_cache_line_t* modem_context_cache_get( const modem_context_type_t ctx_type, uint32_t offset,
+                                                            const uint32_t size, bool allocate )
+{
+    modem_context_cache_line_t* free_line = NULL;
+    bool                        overlap   = false;
+
+    // Bulk data areas have their own flash management
+    if( ( ctx_type == CONTEXT_FUOTA ) || ( ctx_type == CONTEXT_STORE_AND_FORWARD ) || ( size == 0 ) )
+    {
+        return NULL;
+    }
+
+    for( uint8_t i = 0; i < modem_context_cache.nb_lines; i++ )
+    {
+        modem_context_cache_line_t* line = &modem_context_cache.lines[i];
+
+        if( line->valid == false )
+        {
+            if( ( line->capacity >= size ) && ( ( free_line == NULL ) || ( line->capacity < free_line->capacity ) ) )
+            {
+                free_line = line;
+            }
+            continue;
+        }
+        if( ( line->ctx_type != ctx_type ) || ( offset >= ( line->offset + line->size ) ) ||
+            ( line->offset >= ( offset + size ) ) )
+        {
+            continue;
+        }
+        if( ( line->offset == offset ) && ( line->size == size ) )
+        {
+            return line;
+        }
+
+        // Partial overlap: the area is accessed in non volatile memory from now on, so valid shadows never overlap
+        modem_context_cache_write_line( line );
+        line->valid = false;
+        overlap     = true;
+    }
+
+    if( overlap == true )
+    {
+        return NULL;
+    }
+
+    if( free_line == NULL )
+    {
+        if( ( modem_context_cache.nb_lines >= MODEM_CONTEXT_CACHE_LINES ) ||
+            ( ( size + modem_context_cache.pool_used ) > MODEM_CONTEXT_CACHE_SIZE ) )
+        {
+            return NULL;
+        }
+        free_line             = &modem_context_cache.lines[modem_context_cache.nb_lines++];
+        free_line->capacity   = size;
+        free_line->pool_index = modem_context_cache.pool_used;
+        modem_context_cache.pool_used += size;
+    }
+
+    free_line->ctx_type = ctx_type;
+    free_line->offset   = offset;
+    free_line->size     = size;
+    free_line->valid    = true;
+    free_line->dirty    = allocate;
+    free_line->callback = NULL;
+    if( allocate == false )
+    {
+        smtc_modem_hal_context_restore( ctx_type, offset, &modem_context_cache.pool[free_line->pool_index], size );
+    }
+    return free_line;
+}
+
+/**
+ * @brief Write a shadow in non volatile memory if it is dirty
+ *
+ * @param [in] line Shadow to write
+ */
+static void modem_context_cache_write_line( modem_context_cache_line_t* line )
+{
+    if( ( line->valid == false ) || ( line->dirty == false ) )
+    {
+        return;
+    }
+
+    uint8_t* shadow = &modem_context_cache.pool[line->pool_index];
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_CONTEXT_STORE );
+    smtc_modem_hal_context_store( line->ctx_type, line->offset, shadow, line->size );
+    // context reading to ensure context store is done before going on, the shadow is refreshed with the stored data
+    smtc_modem_hal_context_restore( line->ctx_type, line->offset, shadow, line->size );
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_CONTEXT_STORE );
+    line->dirty = false;
+
+    if( line->callback != NULL )
+    {
+        void ( *callback )( void* context ) = line->callback;
+        line->callback                      = NULL;
+        callback( line->callback_context );
+    }
+}
+#endif
+
 /* --- EOF ------------------------------------------------------------------ */
@@ -50,6 +50,7 @@ extern "C" {
 #include "smtc_modem_api.h"
 #include "smtc_modem_hal.h"
 #include "lr1mac_defs.h"
+#include "lr1_stack_mac_layer.h"
 #include "radio_planner.h"
 
 /*
@@ -57,6 +58,43 @@ extern "C" {
  * --- PUBLIC MACROS -----------------------------------------------------------
  */
 
+#if defined( ADD_SMTC_CONTEXT_CACHE )
+/**
+ * @brief Size of the RAM pool holding the context shadows
+ */
+#ifndef MODEM_CONTEXT_CACHE_SIZE
+#define MODEM_CONTEXT_CACHE_SIZE ( 1024 )
+#endif
+
+/**
+ * @brief Maximum number of cached context areas
+ */
+#ifndef MODEM_CONTEXT_CACHE_LINES
+#define MODEM_CONTEXT_CACHE_LINES ( 8 )
+#endif
+
+/**
+ * @brief Dirty contexts are written when the engine goes to sleep for at least this delay
+ */
+#ifndef MODEM_CONTEXT_FLUSH_IDLE_MS
+#define MODEM_CONTEXT_FLUSH_IDLE_MS ( 500 )
+#endif
+
+/**
+ * @brief Dirty contexts are only written when no radio task starts within this delay (covers a flash page erase)
+ */
+#ifndef MODEM_CONTEXT_FLUSH_RADIO_GUARD_MS
+#define MODEM_CONTEXT_FLUSH_RADIO_GUARD_MS ( 50 )
+#endif
+
+/**
+ * @brief Dirty contexts are written at the next engine run after this delay, even without idle time
+ */
+#ifndef MODEM_CONTEXT_FLUSH_MAX_DELAY_MS
+#define MODEM_CONTEXT_FLUSH_MAX_DELAY_MS ( 30000 )
+#endif
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC CONSTANTS --------------------------------------------------------
@@ -64,6 +102,11 @@ extern "C" {
 
 #define MODEM_MAX_TIME 0x1FFFFF
 
+/**
+ * @brief Port of the services parsing every downlink (frames without fport, rx timeouts, acks...)
+ */
+#define MODEM_DOWNLINK_ANY_PORT ( 256 )
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -241,6 +284,82 @@ void modem_reset_modem_context( void );
  */
 uint32_t modem_get_reset_counter( void );
 
+/**
+ * @brief Store a context area in non volatile memory
+ *
+ * @remark With ADD_SMTC_CONTEXT_CACHE the area is copied in a RAM shadow and written later by
+ * @ref modem_context_flush, storing an unchanged area does not write anything. Areas that do not fit in the cache are
+ * written immediately
+ *
+ * @param [in] ctx_type Type of context
+ * @param [in] offset   Offset in the context
+ * @param [in] buffer   Data to store
+ * @param [in] size     Size of the data
+ */
+void modem_context_store( const modem_context_type_t ctx_type, uint32_t offset, const uint8_t* buffer,
+                          const uint32_t size );
+
+/**
+ * @brief Store a context area in non volatile memory without waiting for the write
+ *
+ * @remark With ADD_SMTC_CONTEXT_CACHE the callback is called once the area is written, by @ref modem_context_flush or
+ * when the modem is idle and no radio task is close. Otherwise, or if the area does not fit in the cache, the area is
+ * written and the callback called before returning
+ *
+ * @param [in] ctx_type Type of context
+ * @param [in] offset   Offset in the context
+ * @param [in] buffer   Data to store
+ * @param [in] size     Size of the data
+ * @param [in] callback Completion callback, can be NULL
+ * @param [in] context  Callback context
+ */
+void modem_context_store_async( const modem_context_type_t ctx_type, uint32_t offset, const uint8_t* buffer,
+                                const uint32_t size, void ( *callback )( void* context ), void* context );
+
+/**
+ * @brief Restore a context area, pending stores included
+ *
+ * @param [in]  ctx_type Type of context
+ * @param [in]  offset   Offset in the context
+ * @param [out] buffer   Restored data
+ * @param [in]  size     Size of the data
+ */
+void modem_context_restore( const modem_context_type_t ctx_type, uint32_t offset, uint8_t* buffer,
+                            const uint32_t size );
+
+/**
+ * @brief Write all pending context stores in non volatile memory
+ */
+void modem_context_flush( void );
+
+/**
+ * @brief Write pending context stores if the modem stays idle long enough and no radio task is close, or if they are
+ * pending for too long
+ *
+ * @param [in] sleep_time_ms Time until the next engine run
+ */
+void modem_context_flush_on_idle( uint32_t sleep_time_ms );
+
+/**
+ * @brief Dispatch to a service only the downlinks received on its fport
+ *
+ * @remark Services are offered every downlink until they call this function, and are never offered any downlink when
+ * their downlink callback is NULL. It can be called from the service init, once the downlink callback is set, and
+ * later to follow a port change
+ *
+ * @param [in] downlink_callback Downlink callback of the service
+ * @param [in] fport             Port of the service, MODEM_DOWNLINK_ANY_PORT to get every downlink back
+ */
+void modem_set_downlink_service_port( uint8_t ( *downlink_callback )( lr1_stack_mac_down_data_t* ), uint16_t fport );
+
+/**
+ * @brief Move all the services dispatched on a port to an other port
+ *
+ * @param [in] old_fport Current port of the services
+ * @param [in] new_fport New port of the services
+ */
+void modem_move_downlink_services_port( uint8_t old_fport, uint8_t new_fport );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,105 @@
+/*!
+ * \file      modem_crc.h
+ *
+ * \brief     CRC-32 of the modem contexts, keys and flash records
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MODEM_CRC_H
+#define MODEM_CRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * \brief Initial value of the standard CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320)
+ */
+#define MODEM_CRC32_INIT 0xFFFFFFFF
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief Update a running CRC-32 with a buffer, without the final inversion
+ *
+ * \remark The CRC is computed 4 bytes at a time from 4 tables of 256 entries (slicing-by-4, 4 KB of flash), or by the
+ * MCU CRC peripheral through smtc_modem_hal_crc32_update() when the modem is built with LBM_CRC_MCU_HW=yes. Any
+ * initial value can be used, so that the historical seeds of the modem contexts are kept.
+ *
+ * \param [in] crc    Running CRC, MODEM_CRC32_INIT for the standard CRC-32
+ * \param [in] buffer Data
+ * \param [in] length Data length in bytes
+ *
+ * \returns The updated CRC
+ */
+uint32_t modem_crc32_update( uint32_t crc, const uint8_t* buffer, uint32_t length );
+
+/*!
+ * \brief Compute the standard CRC-32 of a buffer
+ *
+ * \param [in] buffer Data
+ * \param [in] length Data length in bytes
+ *
+ * \returns ~modem_crc32_update( MODEM_CRC32_INIT, buffer, length )
+ */
+uint32_t modem_crc32( const uint8_t* buffer, uint32_t length );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_CRC_H
+
+/* --- EOF ------------------------------------------------------------------ */
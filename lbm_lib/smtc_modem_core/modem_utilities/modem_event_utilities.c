@@ -38,6 +38,7 @@
  */
 #include <stdint.h>   // C99 types
 #include <stdbool.h>  // bool type
+#include <string.h>   // for memset
 
 #include "modem_event_utilities.h"
 #include "smtc_modem_hal_dbg_trace.h"
@@ -53,6 +54,12 @@ struct
     uint8_t modem_event_status[MODEM_NUMBER_OF_EVENTS];
     uint8_t asynch_msg[MODEM_NUMBER_OF_EVENTS];
     void ( *app_callback )( void );
+#if defined( ADD_SMTC_EVENT_QUEUE )
+    modem_event_record_t queue[MODEM_EVENT_QUEUE_NB_EVENTS];
+    uint8_t              queue_read_index;
+    uint8_t              queue_count;
+    uint8_t              queue_dropped;
+#endif
 } modem_event_ctx;
 
 #define asynchronous_msgnumber modem_event_ctx.asynchronous_msgnumber
@@ -61,6 +68,10 @@ struct
 #define modem_event_status modem_event_ctx.modem_event_status
 #define asynch_msg modem_event_ctx.asynch_msg
 #define app_callback modem_event_ctx.app_callback
+#define event_queue modem_event_ctx.queue
+#define event_queue_read_index modem_event_ctx.queue_read_index
+#define event_queue_count modem_event_ctx.queue_count
+#define event_queue_dropped modem_event_ctx.queue_dropped
 
 /*
  * -----------------------------------------------------------------------------
@@ -88,6 +99,11 @@ void modem_event_init( void ( *callback )( void ) )
     }
     asynchronous_msgnumber = 0;
     app_callback           = callback;
+#if defined( ADD_SMTC_EVENT_QUEUE )
+    event_queue_read_index = 0;
+    event_queue_count      = 0;
+    event_queue_dropped    = 0;
+#endif
 }
 uint8_t get_modem_event_count( smtc_modem_event_type_t event_type )
 {
@@ -148,12 +164,58 @@ uint8_t get_asynchronous_msgnumber( void )
 }
 
 void increment_asynchronous_msgnumber( uint8_t event_type, uint8_t status, uint8_t stack_id )
+{
+    increment_asynchronous_msgnumber_with_data( event_type, status, stack_id, 0, NULL );
+}
+
+void increment_asynchronous_msgnumber_with_data( uint8_t event_type, uint8_t status, uint8_t stack_id, uint32_t fcnt,
+                                                 const smtc_modem_dl_metadata_t* dl_metadata )
 {
     // Next condition should never append because only one asynch msg by type of message
     if( asynchronous_msgnumber >= MODEM_NUMBER_OF_EVENTS )
     {
         return;
     }
+
+    // Checked before the event is queued and counted, the panic handler may return
+    if( event_type >= MODEM_NUMBER_OF_EVENTS )
+    {
+        SMTC_MODEM_HAL_PANIC( );
+        return;
+    }
+
+#if defined( ADD_SMTC_EVENT_QUEUE )
+    if( event_queue_count == MODEM_EVENT_QUEUE_NB_EVENTS )
+    {
+        // Drop the oldest event, the next one read reports it as missed
+        event_queue_read_index = ( event_queue_read_index + 1 ) % MODEM_EVENT_QUEUE_NB_EVENTS;
+        event_queue_count--;
+        if( event_queue_dropped < 255 )
+        {
+            event_queue_dropped++;
+        }
+    }
+    modem_event_record_t* record =
+        &event_queue[( event_queue_read_index + event_queue_count ) % MODEM_EVENT_QUEUE_NB_EVENTS];
+    record->event_type   = event_type;
+    record->stack_id     = stack_id;
+    record->status       = status;
+    record->dropped      = 0;
+    record->timestamp_ms = smtc_modem_hal_get_time_in_ms( );
+    record->fcnt         = fcnt;
+    if( dl_metadata != NULL )
+    {
+        record->dl_metadata = *dl_metadata;
+    }
+    else
+    {
+        memset( &record->dl_metadata, 0, sizeof( record->dl_metadata ) );
+    }
+    event_queue_count++;
+#else
+    ( void ) fcnt;
+    ( void ) dl_metadata;
+#endif
     uint8_t tmp;
     tmp = get_modem_event_count( event_type );
 
@@ -172,6 +234,55 @@ void increment_asynchronous_msgnumber( uint8_t event_type, uint8_t status, uint8
     }
 }
 
+void clear_asynchronous_msg( uint8_t event_type )
+{
+    if( ( event_type >= MODEM_NUMBER_OF_EVENTS ) || ( modem_event_count[event_type] == 0 ) )
+    {
+        return;
+    }
+    for( uint8_t i = 0; i < asynchronous_msgnumber; i++ )
+    {
+        if( asynch_msg[i] == event_type )
+        {
+            for( uint8_t j = i; j < ( asynchronous_msgnumber - 1 ); j++ )
+            {
+                asynch_msg[j] = asynch_msg[j + 1];
+            }
+            asynchronous_msgnumber--;
+            break;
+        }
+    }
+    set_modem_event_count_and_status( event_type, 0, 0 );
+}
+
+bool modem_event_queue_pop( modem_event_record_t* record )
+{
+#if defined( ADD_SMTC_EVENT_QUEUE )
+    if( event_queue_count == 0 )
+    {
+        return false;
+    }
+    *record                = event_queue[event_queue_read_index];
+    record->dropped        = event_queue_dropped;
+    event_queue_dropped    = 0;
+    event_queue_read_index = ( event_queue_read_index + 1 ) % MODEM_EVENT_QUEUE_NB_EVENTS;
+    event_queue_count--;
+    return true;
+#else
+    ( void ) record;
+    return false;
+#endif
+}
+
+uint8_t modem_event_queue_get_count( void )
+{
+#if defined( ADD_SMTC_EVENT_QUEUE )
+    return event_queue_count;
+#else
+    return 0;
+#endif
+}
+
 uint8_t get_last_msg_event( uint8_t* stack_id )
 {
     if( asynchronous_msgnumber > 0 )
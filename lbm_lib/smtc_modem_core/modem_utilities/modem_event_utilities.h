@@ -45,6 +45,24 @@ extern "C" {
 
 #define MODEM_NUMBER_OF_EVENTS SMTC_MODEM_EVENT_MAX  // number of possible events in modem
 
+#ifndef MODEM_EVENT_QUEUE_NB_EVENTS
+#define MODEM_EVENT_QUEUE_NB_EVENTS 16  // number of events kept in order by the event queue (LBM_EVENT_QUEUE=yes)
+#endif
+
+/*!
+ * \brief Event kept by the event queue with the data captured when it occurred
+ */
+typedef struct modem_event_record_s
+{
+    uint8_t                  event_type;
+    uint8_t                  stack_id;
+    uint8_t                  status;
+    uint8_t                  dropped;  //!< number of events dropped by the full queue before this one
+    uint32_t                 timestamp_ms;
+    uint32_t                 fcnt;
+    smtc_modem_dl_metadata_t dl_metadata;
+} modem_event_record_t;
+
 /*!
  * \brief init context of event
  *
@@ -101,6 +119,36 @@ void decrement_asynchronous_msgnumber( void );
  */
 void increment_asynchronous_msgnumber( uint8_t event_type, uint8_t status, uint8_t stack_id );
 
+/*!
+ * \brief increment the asynchronous message number, with the data kept by the event queue (LBM_EVENT_QUEUE=yes)
+ * \param [in] event_type  type of asynchronous message
+ * \param [in] status      status of asynchronous message
+ * \param [in] stack_id    stack of asynchronous message
+ * \param [in] fcnt        uplink frame counter for a tx done event, 0 otherwise
+ * \param [in] dl_metadata metadata of a downlink data event, NULL otherwise
+ */
+void increment_asynchronous_msgnumber_with_data( uint8_t event_type, uint8_t status, uint8_t stack_id, uint32_t fcnt,
+                                                 const smtc_modem_dl_metadata_t* dl_metadata );
+
+/*!
+ * \brief clear the pending asynchronous message of a type of event, already read from the event queue
+ * \param [in] event_type type of asynchronous message
+ */
+void clear_asynchronous_msg( uint8_t event_type );
+
+/*!
+ * \brief get the oldest event of the event queue (LBM_EVENT_QUEUE=yes)
+ * \param [out] record event read
+ * \return false if the event queue is empty
+ */
+bool modem_event_queue_pop( modem_event_record_t* record );
+
+/*!
+ * \brief get the number of events in the event queue (LBM_EVENT_QUEUE=yes)
+ * \return The number of events
+ */
+uint8_t modem_event_queue_get_count( void );
+
 /*!
  * \brief get asynchronous message number
  *
@@ -0,0 +1,170 @@
+/*!
+ * \file      modem_instance.c
+ *
+ * \brief     Several modems in one process, by swapping the whole modem state in and out of its static storage
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
+#include <string.h>   // for memcpy
+
+#include "modem_instance.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*!
+ * Bounds of the modem state and of its power up copy, placed by makefiles/multi_instance.ld. The variables of this
+ * file are left out of the state so that they are shared by all the instances.
+ */
+extern uint8_t __start_lbm_state_data[];
+extern uint8_t __stop_lbm_state_data[];
+extern uint8_t __start_lbm_state_bss[];
+extern uint8_t __stop_lbm_state_bss[];
+extern uint8_t __start_lbm_state_boot[];
+
+static void* modem_instance_current;
+static bool  modem_instance_boot_is_saved;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief   Keep the power up state on the first call, before any instance ran
+ */
+static void modem_instance_save_boot_state( void );
+
+/*!
+ * \brief   Copy the modem state to an instance storage
+ * \param   [out] instance      Instance storage
+ */
+static void modem_instance_save( uint8_t* instance );
+
+/*!
+ * \brief   Copy an instance storage to the modem state
+ * \param   [in] instance       Instance storage
+ */
+static void modem_instance_load( const uint8_t* instance );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+uint32_t modem_instance_get_size( void )
+{
+    return ( uint32_t ) ( ( __stop_lbm_state_data - __start_lbm_state_data ) +
+                          ( __stop_lbm_state_bss - __start_lbm_state_bss ) );
+}
+
+void modem_instance_init( void* instance )
+{
+    modem_instance_save_boot_state( );
+    memcpy( instance, __start_lbm_state_boot, modem_instance_get_size( ) );
+}
+
+void modem_instance_select( void* instance )
+{
+    if( instance == modem_instance_current )
+    {
+        return;
+    }
+
+    modem_instance_save_boot_state( );
+    if( modem_instance_current != NULL )
+    {
+        modem_instance_save( modem_instance_current );
+    }
+    modem_instance_load( instance );
+    modem_instance_current = instance;
+}
+
+void* modem_instance_get_current( void )
+{
+    return modem_instance_current;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void modem_instance_save_boot_state( void )
+{
+    if( modem_instance_boot_is_saved == false )
+    {
+        modem_instance_save( __start_lbm_state_boot );
+        modem_instance_boot_is_saved = true;
+    }
+}
+
+static void modem_instance_save( uint8_t* instance )
+{
+    const uint32_t data_size = ( uint32_t ) ( __stop_lbm_state_data - __start_lbm_state_data );
+
+    memcpy( instance, __start_lbm_state_data, data_size );
+    memcpy( instance + data_size, __start_lbm_state_bss, ( size_t ) ( __stop_lbm_state_bss - __start_lbm_state_bss ) );
+}
+
+static void modem_instance_load( const uint8_t* instance )
+{
+    const uint32_t data_size = ( uint32_t ) ( __stop_lbm_state_data - __start_lbm_state_data );
+
+    memcpy( __start_lbm_state_data, instance, data_size );
+    memcpy( __start_lbm_state_bss, instance + data_size, ( size_t ) ( __stop_lbm_state_bss - __start_lbm_state_bss ) );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
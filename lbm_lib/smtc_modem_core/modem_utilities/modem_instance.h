@@ -0,0 +1,103 @@
+/*!
+ * \file      modem_instance.h
+ *
+ * \brief     Several modems in one process, by swapping the whole modem state in and out of its static storage
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MODEM_INSTANCE_H
+#define MODEM_INSTANCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief   Get the size of the modem state, which is the size of an instance
+ * \remark  The state is every non constant static variable of the modem library, gathered at build time by
+ *          makefiles/multi_instance.ld in the lbm_state_data and lbm_state_bss sections
+ * \retval  uint32_t            Size in bytes
+ */
+uint32_t modem_instance_get_size( void );
+
+/*!
+ * \brief   Initialize an instance with the state the modem has at power up
+ * \param   [out] instance      Instance storage of modem_instance_get_size( ) bytes
+ */
+void modem_instance_init( void* instance );
+
+/*!
+ * \brief   Save the state of the running instance in its storage and load another instance
+ * \remark  The pointers held by the modem state stay valid: the instances all run at the addresses of the static
+ *          variables
+ * \param   [in] instance           Instance to run
+ */
+void modem_instance_select( void* instance );
+
+/*!
+ * \brief   Get the running instance
+ * \retval  void*               Running instance, NULL until the first modem_instance_select
+ */
+void* modem_instance_get_current( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_INSTANCE_H
+
+/* --- EOF ------------------------------------------------------------------ */
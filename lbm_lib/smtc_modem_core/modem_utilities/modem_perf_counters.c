@@ -0,0 +1,134 @@
+/*!
+ * \file      modem_perf_counters.c
+ *
+ * \brief     Modem wide performance counters reported in the device management messages
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "modem_perf_counters.h"
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static uint32_t perf_counters[MODEM_PERF_NB_COUNTERS];
+static uint32_t perf_dtc_blocked_since_ms[NUMBER_OF_STACKS];
+static bool     perf_dtc_blocked[NUMBER_OF_STACKS];
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void modem_perf_counters_add( modem_perf_counter_t counter, uint32_t value )
+{
+    if( counter < MODEM_PERF_NB_COUNTERS )
+    {
+        perf_counters[counter] += value;
+    }
+}
+
+void modem_perf_counters_set_dtc_blocked( uint8_t stack_id, bool blocked )
+{
+    if( ( stack_id >= NUMBER_OF_STACKS ) || ( perf_dtc_blocked[stack_id] == blocked ) )
+    {
+        return;
+    }
+
+    uint32_t now_ms = smtc_modem_hal_get_time_in_ms( );
+    if( blocked == true )
+    {
+        perf_dtc_blocked_since_ms[stack_id] = now_ms;
+    }
+    else
+    {
+        perf_counters[MODEM_PERF_DTC_BLOCKED_MS] += now_ms - perf_dtc_blocked_since_ms[stack_id];
+    }
+    perf_dtc_blocked[stack_id] = blocked;
+}
+
+uint32_t modem_perf_counters_get( modem_perf_counter_t counter )
+{
+    if( counter >= MODEM_PERF_NB_COUNTERS )
+    {
+        return 0;
+    }
+
+    uint32_t value = perf_counters[counter];
+    if( counter == MODEM_PERF_DTC_BLOCKED_MS )
+    {
+        uint32_t now_ms = smtc_modem_hal_get_time_in_ms( );
+        for( uint8_t i = 0; i < NUMBER_OF_STACKS; i++ )
+        {
+            if( perf_dtc_blocked[i] == true )
+            {
+                value += now_ms - perf_dtc_blocked_since_ms[i];
+            }
+        }
+    }
+    return value;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,130 @@
+/*!
+ * \file      modem_perf_counters.h
+ *
+ * \brief     Modem wide performance counters reported in the device management messages
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MODEM_PERF_COUNTERS_H
+#define MODEM_PERF_COUNTERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*!
+ * \brief Count an event, or tell that a stack is blocked by the duty-cycle. Both expand to nothing when the modem is
+ * built without LBM_DM_PERF
+ */
+#if defined( ADD_SMTC_DM_PERF )
+#define MODEM_PERF_COUNTER_ADD( counter, value ) modem_perf_counters_add( counter, value )
+#define MODEM_PERF_DTC_BLOCKED( stack_id, blocked ) modem_perf_counters_set_dtc_blocked( stack_id, blocked )
+#else
+#define MODEM_PERF_COUNTER_ADD( counter, value )
+#define MODEM_PERF_DTC_BLOCKED( stack_id, blocked )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * \brief Performance counters, summed over all the stacks. They wrap, their users compute differences.
+ */
+typedef enum modem_perf_counter_e
+{
+    MODEM_PERF_UPLINK_NB = 0,        //!< LoRaWAN uplink cycles, repetitions and join requests included
+    MODEM_PERF_RETRANSMISSION_NB,    //!< Uplink cycles followed by a repetition of the same frame
+    MODEM_PERF_RX_WINDOW_HIT_NB,     //!< Downlinks received in a RX1 or RX2 window
+    MODEM_PERF_LBT_NB,               //!< Listen before talk decisions
+    MODEM_PERF_LBT_BUSY_NB,          //!< Listen before talk decisions finding the channel busy
+    MODEM_PERF_RP_ABORTED_NB,        //!< Radio planner tasks aborted
+    MODEM_PERF_FLASH_ERASE_NB,       //!< Flash pages erased by the modem services and the MAC journal
+    MODEM_PERF_DTC_BLOCKED_MS,       //!< Time during which a stack was blocked by the duty-cycle
+    MODEM_PERF_NB_COUNTERS
+} modem_perf_counter_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief Add a value to a counter, use MODEM_PERF_COUNTER_ADD instead of calling it
+ *
+ * \param [in] counter Counter
+ * \param [in] value   Value to add
+ */
+void modem_perf_counters_add( modem_perf_counter_t counter, uint32_t value );
+
+/*!
+ * \brief Start or stop counting the duty-cycle blocked time of a stack, use MODEM_PERF_DTC_BLOCKED instead of
+ * calling it
+ *
+ * \param [in] stack_id Stack identifier
+ * \param [in] blocked  The stack can no longer transmit because of the duty-cycle
+ */
+void modem_perf_counters_set_dtc_blocked( uint8_t stack_id, bool blocked );
+
+/*!
+ * \brief Read a counter
+ *
+ * \param [in] counter Counter
+ *
+ * \returns The counter value, MODEM_PERF_DTC_BLOCKED_MS includes the blocked periods still running
+ */
+uint32_t modem_perf_counters_get( modem_perf_counter_t counter );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_PERF_COUNTERS_H
+
+/* --- EOF ------------------------------------------------------------------ */
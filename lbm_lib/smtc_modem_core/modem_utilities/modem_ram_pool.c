@@ -0,0 +1,254 @@
+/*!
+ * \file      modem_ram_pool.c
+ *
+ * \brief     Shared RAM pool of the modem services, each buffer lives as long as its service is started
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // for memset
+
+#include "modem_ram_pool.h"
+#include "smtc_modem_hal_dbg_trace.h"
+
+#if defined( ADD_SMTC_STREAM )
+#include "lr1_stack_mac_layer.h"
+#include "stream.h"
+#endif
+#if defined( ADD_ALMANAC )
+#include "almanac.h"
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*!
+ * Buffers are kept aligned on 4 bytes
+ */
+#define MODEM_RAM_POOL_ALIGN( x ) ( ( ( x ) + 3 ) & ~3 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+#if defined( ADD_SMTC_STREAM )
+#define MODEM_RAM_POOL_STREAM_SIZE ( MODEM_RAM_POOL_ALIGN( ROSE_FIFO_SIZE ) * NUMBER_OF_STREAMS * NUMBER_OF_STACKS )
+#else
+#define MODEM_RAM_POOL_STREAM_SIZE 0
+#endif
+
+#if defined( ADD_ALMANAC )
+#define MODEM_RAM_POOL_ALMANAC_SIZE MODEM_RAM_POOL_ALIGN( ALMANAC_DW_SIZE )
+#else
+#define MODEM_RAM_POOL_ALMANAC_SIZE 0
+#endif
+
+/*!
+ * Size of the pool in bytes, defaults to the buffers of all the built services. A smaller value saves RAM when the
+ * services are not all started at the same time, a start then fails while the pool is full.
+ */
+#ifndef MODEM_RAM_POOL_SIZE
+#define MODEM_RAM_POOL_SIZE ( MODEM_RAM_POOL_STREAM_SIZE + MODEM_RAM_POOL_ALMANAC_SIZE )
+#endif
+
+#if( MODEM_RAM_POOL_SIZE == 0 ) || ( MODEM_RAM_POOL_SIZE > UINT16_MAX )
+#error "MODEM_RAM_POOL_SIZE shall be in [1, 65535], is a service using the pool built?"
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct modem_ram_pool_buffer_s
+{
+    bool     in_use;
+    uint8_t  user;
+    uint8_t  stack_id;
+    uint16_t offset;  //!< First byte in the pool
+    uint16_t size;    //!< Aligned size
+} modem_ram_pool_buffer_t;
+
+typedef struct modem_ram_pool_s
+{
+    uint32_t                pool[MODEM_RAM_POOL_ALIGN( MODEM_RAM_POOL_SIZE ) / 4];  //!< uint32_t for the alignment
+    modem_ram_pool_buffer_t buffers[MODEM_RAM_POOL_NB_BUFFERS];
+    uint16_t                used;
+    uint16_t                peak;
+    uint16_t                user_used[MODEM_RAM_POOL_USER_NB];
+    uint16_t                user_peak[MODEM_RAM_POOL_USER_NB];
+} modem_ram_pool_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static modem_ram_pool_t modem_ram_pool;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief   Find the lowest free area of the pool large enough for a buffer
+ * \param   [in]  size          Aligned size in bytes
+ * \param   [out] offset        First byte of the area
+ * \retval  bool                false if no area is large enough
+ */
+static bool modem_ram_pool_find_room( uint16_t size, uint16_t* offset );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void* modem_ram_pool_alloc( modem_ram_pool_user_t user, uint8_t stack_id, uint16_t size )
+{
+    uint32_t aligned_size = MODEM_RAM_POOL_ALIGN( ( uint32_t ) size );
+    uint16_t offset;
+
+    if( ( user >= MODEM_RAM_POOL_USER_NB ) || ( size == 0 ) || ( aligned_size > MODEM_RAM_POOL_SIZE ) ||
+        ( modem_ram_pool_find_room( ( uint16_t ) aligned_size, &offset ) == false ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "ram pool: no room for %u bytes of user %u\n", size, user );
+        return NULL;
+    }
+
+    for( uint8_t i = 0; i < MODEM_RAM_POOL_NB_BUFFERS; i++ )
+    {
+        modem_ram_pool_buffer_t* buffer = &modem_ram_pool.buffers[i];
+        if( buffer->in_use == false )
+        {
+            buffer->in_use   = true;
+            buffer->user     = ( uint8_t ) user;
+            buffer->stack_id = stack_id;
+            buffer->offset   = offset;
+            buffer->size     = ( uint16_t ) aligned_size;
+
+            modem_ram_pool.used += buffer->size;
+            modem_ram_pool.user_used[user] += buffer->size;
+            if( modem_ram_pool.used > modem_ram_pool.peak )
+            {
+                modem_ram_pool.peak = modem_ram_pool.used;
+            }
+            if( modem_ram_pool.user_used[user] > modem_ram_pool.user_peak[user] )
+            {
+                modem_ram_pool.user_peak[user] = modem_ram_pool.user_used[user];
+            }
+
+            uint8_t* data = ( uint8_t* ) modem_ram_pool.pool + offset;
+            memset( data, 0, buffer->size );
+            return data;
+        }
+    }
+    SMTC_MODEM_HAL_TRACE_ERROR( "ram pool: no buffer left for user %u\n", user );
+    return NULL;
+}
+
+void modem_ram_pool_release( modem_ram_pool_user_t user, uint8_t stack_id )
+{
+    for( uint8_t i = 0; i < MODEM_RAM_POOL_NB_BUFFERS; i++ )
+    {
+        modem_ram_pool_buffer_t* buffer = &modem_ram_pool.buffers[i];
+        if( ( buffer->in_use == true ) && ( buffer->user == user ) && ( buffer->stack_id == stack_id ) )
+        {
+            buffer->in_use = false;
+            modem_ram_pool.used -= buffer->size;
+            modem_ram_pool.user_used[user] -= buffer->size;
+        }
+    }
+}
+
+uint16_t modem_ram_pool_get_user_peak( modem_ram_pool_user_t user )
+{
+    return ( user < MODEM_RAM_POOL_USER_NB ) ? modem_ram_pool.user_peak[user] : 0;
+}
+
+uint16_t modem_ram_pool_get_peak( void )
+{
+    return modem_ram_pool.peak;
+}
+
+void modem_ram_pool_print_report( void )
+{
+    SMTC_MODEM_HAL_TRACE_PRINTF( "ram pool: %u bytes, %u in use, peak %u\n", MODEM_RAM_POOL_SIZE, modem_ram_pool.used,
+                                 modem_ram_pool.peak );
+    for( uint8_t user = 0; user < MODEM_RAM_POOL_USER_NB; user++ )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( " - user %u: %u in use, peak %u\n", user, modem_ram_pool.user_used[user],
+                                     modem_ram_pool.user_peak[user] );
+    }
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static bool modem_ram_pool_find_room( uint16_t size, uint16_t* offset )
+{
+    uint32_t candidate = 0;
+    bool     moved     = true;
+
+    // Move the candidate after each buffer it overlaps until it overlaps none, it only goes forward
+    while( moved == true )
+    {
+        if( ( candidate + size ) > MODEM_RAM_POOL_SIZE )
+        {
+            return false;
+        }
+        moved = false;
+        for( uint8_t i = 0; i < MODEM_RAM_POOL_NB_BUFFERS; i++ )
+        {
+            const modem_ram_pool_buffer_t* buffer = &modem_ram_pool.buffers[i];
+            if( ( buffer->in_use == true ) && ( candidate < ( uint32_t ) ( buffer->offset + buffer->size ) ) &&
+                ( buffer->offset < ( candidate + size ) ) )
+            {
+                candidate = buffer->offset + buffer->size;
+                moved     = true;
+            }
+        }
+    }
+    *offset = ( uint16_t ) candidate;
+    return true;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,127 @@
+/*!
+ * \file      modem_ram_pool.h
+ *
+ * \brief     Shared RAM pool of the modem services, each buffer lives as long as its service is started
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MODEM_RAM_POOL_H
+#define MODEM_RAM_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * Number of buffers the pool can hold at the same time
+ */
+#ifndef MODEM_RAM_POOL_NB_BUFFERS
+#define MODEM_RAM_POOL_NB_BUFFERS 8
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * Services taking their buffers from the pool
+ */
+typedef enum modem_ram_pool_user_e
+{
+    MODEM_RAM_POOL_USER_STREAM,   //!< ROSE fifo of each stream, from stream_init to stream_service_stop
+    MODEM_RAM_POOL_USER_ALMANAC,  //!< Almanac downlink, from start_almanac_service to stop_almanac_service
+    MODEM_RAM_POOL_USER_NB,
+} modem_ram_pool_user_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief   Take a buffer from the pool
+ * \param   [in] user           Service owning the buffer
+ * \param   [in] stack_id       Stack identifier of the service
+ * \param   [in] size           Size in bytes
+ * \retval  void*               Buffer aligned on 4 bytes, NULL if the pool has no room left
+ */
+void* modem_ram_pool_alloc( modem_ram_pool_user_t user, uint8_t stack_id, uint16_t size );
+
+/*!
+ * \brief   Give back all the buffers of a service to the pool
+ * \param   [in] user           Service owning the buffers
+ * \param   [in] stack_id       Stack identifier of the service
+ */
+void modem_ram_pool_release( modem_ram_pool_user_t user, uint8_t stack_id );
+
+/*!
+ * \brief   Get the highest number of bytes a service held at the same time since boot
+ * \param   [in] user           Service
+ * \retval  uint16_t            Peak size in bytes
+ */
+uint16_t modem_ram_pool_get_user_peak( modem_ram_pool_user_t user );
+
+/*!
+ * \brief   Get the highest number of bytes taken from the pool at the same time since boot
+ * \remark  The pool can be sized to this value for the services configuration of the application
+ * \retval  uint16_t            Peak size in bytes
+ */
+uint16_t modem_ram_pool_get_peak( void );
+
+/*!
+ * \brief   Trace the pool size and the peak of each service
+ */
+void modem_ram_pool_print_report( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_RAM_POOL_H
+
+/* --- EOF ------------------------------------------------------------------ */
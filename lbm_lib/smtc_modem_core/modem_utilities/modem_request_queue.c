@@ -0,0 +1,153 @@
+/*!
+ * \file      modem_request_queue.c
+ *
+ * \brief     Single producer single consumer queue of uplink requests drained by the modem engine
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // for memcpy
+
+#include "modem_request_queue.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*!
+ * Keep the compiler from moving the slot accesses across the index update publishing or releasing the slot. Single
+ * core targets only need the compiler barrier, the producer and the consumer never write the same index.
+ */
+#define MODEM_REQUEST_QUEUE_BARRIER( ) __asm volatile( "" ::: "memory" )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef struct modem_request_queue_s
+{
+    modem_request_t   requests[MODEM_REQUEST_QUEUE_NB_REQUESTS];
+    volatile uint32_t write_count;  //!< Written by the producer only
+    volatile uint32_t read_count;   //!< Written by the engine only
+} modem_request_queue_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static modem_request_queue_t modem_request_queue;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void modem_request_queue_init( void )
+{
+    modem_request_queue.write_count = 0;
+    modem_request_queue.read_count  = 0;
+}
+
+bool modem_request_queue_push( uint8_t stack_id, uint8_t fport, bool send_fport, bool confirmed, const uint8_t* payload,
+                               uint8_t payload_length )
+{
+    uint32_t write_count = modem_request_queue.write_count;
+
+    if( ( write_count - modem_request_queue.read_count ) >= MODEM_REQUEST_QUEUE_NB_REQUESTS )
+    {
+        return false;
+    }
+
+    modem_request_t* slot = &modem_request_queue.requests[write_count % MODEM_REQUEST_QUEUE_NB_REQUESTS];
+    slot->stack_id        = stack_id;
+    slot->fport           = fport;
+    slot->send_fport      = send_fport;
+    slot->confirmed       = confirmed;
+    slot->payload_length  = payload_length;
+    if( payload_length > 0 )
+    {
+        memcpy( slot->payload, payload, payload_length );
+    }
+
+    // The request shall be written before being published to the engine
+    MODEM_REQUEST_QUEUE_BARRIER( );
+    modem_request_queue.write_count = write_count + 1;
+    return true;
+}
+
+const modem_request_t* modem_request_queue_peek( void )
+{
+    uint32_t read_count = modem_request_queue.read_count;
+
+    if( read_count == modem_request_queue.write_count )
+    {
+        return NULL;
+    }
+    MODEM_REQUEST_QUEUE_BARRIER( );
+    return &modem_request_queue.requests[read_count % MODEM_REQUEST_QUEUE_NB_REQUESTS];
+}
+
+void modem_request_queue_pop( void )
+{
+    // The request shall be consumed before the slot is released to the producer
+    MODEM_REQUEST_QUEUE_BARRIER( );
+    modem_request_queue.read_count = modem_request_queue.read_count + 1;
+}
+
+uint32_t modem_request_queue_get_push_count( void )
+{
+    return modem_request_queue.write_count;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,141 @@
+/*!
+ * \file      modem_request_queue.h
+ *
+ * \brief     Single producer single consumer queue of uplink requests drained by the modem engine
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MODEM_REQUEST_QUEUE_H
+#define MODEM_REQUEST_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "smtc_modem_api.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * Number of requests the queue can hold, shall be a power of two
+ */
+#ifndef MODEM_REQUEST_QUEUE_NB_REQUESTS
+#define MODEM_REQUEST_QUEUE_NB_REQUESTS 4
+#endif
+
+/*!
+ * Largest payload of a queued uplink, each slot reserves this size
+ */
+#ifndef MODEM_REQUEST_QUEUE_MAX_PAYLOAD_LENGTH
+#define MODEM_REQUEST_QUEUE_MAX_PAYLOAD_LENGTH SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * Queued uplink request
+ */
+typedef struct modem_request_s
+{
+    uint8_t stack_id;
+    uint8_t fport;
+    bool    send_fport;      //!< false for an empty uplink sent without FPort
+    bool    confirmed;
+    uint8_t payload_length;  //!< 0 for an empty uplink
+    uint8_t payload[MODEM_REQUEST_QUEUE_MAX_PAYLOAD_LENGTH];
+} modem_request_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief   Clear the queue
+ * \remark  Shall not be called while the producer can push
+ */
+void modem_request_queue_init( void );
+
+/*!
+ * \brief   Push a request, called by the single producer (one thread or one interrupt context)
+ * \remark  Bounded execution time: copies the payload in a free slot and publishes it, never waits on the engine
+ * \param   [in] stack_id       Stack identifier
+ * \param   [in] fport          LoRaWAN FPort
+ * \param   [in] send_fport     Send the FPort, only false for an empty uplink
+ * \param   [in] confirmed      Message type
+ * \param   [in] payload        Payload to copy, may be NULL when payload_length is 0
+ * \param   [in] payload_length Payload length, at most MODEM_REQUEST_QUEUE_MAX_PAYLOAD_LENGTH
+ * \retval  bool                false if the queue is full
+ */
+bool modem_request_queue_push( uint8_t stack_id, uint8_t fport, bool send_fport, bool confirmed, const uint8_t* payload,
+                               uint8_t payload_length );
+
+/*!
+ * \brief   Get the oldest request without removing it, called by the modem engine only
+ * \retval  modem_request_t*   Oldest request, NULL if the queue is empty
+ */
+const modem_request_t* modem_request_queue_peek( void );
+
+/*!
+ * \brief   Release the slot of the request returned by modem_request_queue_peek, called by the modem engine only
+ */
+void modem_request_queue_pop( void );
+
+/*!
+ * \brief   Get the number of requests pushed since init, used by the engine to detect a push during its pass
+ * \retval  uint32_t           Number of pushed requests, wraps around
+ */
+uint32_t modem_request_queue_get_push_count( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_REQUEST_QUEUE_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -99,6 +99,22 @@ extern "C" {
 #include "store_and_forward.h"
 #endif
 
+#if defined( ADD_SMTC_BLE_BRIDGE )
+#include "ble_bridge.h"
+#endif
+
+#if defined( ADD_SMTC_FLRC_TRANSFER )
+#include "flrc_transfer.h"
+#endif
+
+#if defined( ADD_SMTC_PAYLOAD_COMPRESSION )
+#include "payload_compression.h"
+#endif
+
+#if defined( ADD_SMTC_TDMA_UPLINK )
+#include "tdma_uplink.h"
+#endif
+
 typedef struct modem_service_config_s
 {
     uint8_t service_id;  // Start to 0 for new type of services, increment this number for multiple instantiation of the
@@ -158,6 +174,18 @@ static modem_service_config_t modem_service_config[] = {
     { .service_id = 0, .stack_id = 0, .callbacks_init_service = store_and_forward_flash_services_init },
 // { .service_id = 0, .stack_id = 0, .callbacks_init_service = store_and_forward_services_init },
 #endif
+#ifdef ADD_SMTC_BLE_BRIDGE
+    { .service_id = 0, .stack_id = 0, .callbacks_init_service = ble_bridge_services_init },
+#endif
+#ifdef ADD_SMTC_FLRC_TRANSFER
+    { .service_id = 0, .stack_id = 0, .callbacks_init_service = flrc_transfer_services_init },
+#endif
+#ifdef ADD_SMTC_PAYLOAD_COMPRESSION
+    { .service_id = 0, .stack_id = 0, .callbacks_init_service = payload_compression_services_init },
+#endif
+#ifdef ADD_SMTC_TDMA_UPLINK
+    { .service_id = 0, .stack_id = 0, .callbacks_init_service = tdma_uplink_services_init },
+#endif
 };
 
 #define NUMBER_OF_SERVICES ( sizeof modem_service_config / sizeof modem_service_config[0] )
@@ -0,0 +1,211 @@
+/*!
+ * \file      modem_timer.c
+ *
+ * \brief     Software timers sharing the modem HAL timer
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
+
+#include "modem_timer.h"
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*!
+ * \brief Running timers, sorted by expiration time
+ */
+static modem_timer_t* modem_timer_head = NULL;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*!
+ * \brief Remove a timer from the running list
+ *
+ * \param [in] timer Timer
+ *
+ * \returns true if the timer was the first of the list
+ */
+static bool modem_timer_remove( modem_timer_t* timer );
+
+/*!
+ * \brief Arm the HAL timer on the first running timer, or stop it when no timer is running
+ */
+static void modem_timer_arm( void );
+
+/*!
+ * \brief HAL timer callback, calls the callbacks of the expired timers
+ *
+ * \param [in] context Unused
+ */
+static void modem_timer_irq_callback( void* context );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void modem_timer_start( modem_timer_t* timer, uint32_t delay_ms, void ( *callback )( void* context ), void* context )
+{
+    smtc_modem_hal_disable_modem_irq( );
+
+    modem_timer_remove( timer );
+    timer->expiry_ms = smtc_modem_hal_get_time_in_ms( ) + delay_ms;
+    timer->callback  = callback;
+    timer->context   = context;
+    timer->running   = true;
+
+    // Insert after the timers expiring at the same time, so that they expire in their start order
+    modem_timer_t** link = &modem_timer_head;
+    while( ( *link != NULL ) && ( ( int32_t ) ( ( *link )->expiry_ms - timer->expiry_ms ) <= 0 ) )
+    {
+        link = &( ( *link )->next );
+    }
+    timer->next = *link;
+    *link       = timer;
+
+    if( modem_timer_head == timer )
+    {
+        modem_timer_arm( );
+    }
+
+    smtc_modem_hal_enable_modem_irq( );
+}
+
+void modem_timer_stop( modem_timer_t* timer )
+{
+    smtc_modem_hal_disable_modem_irq( );
+    if( modem_timer_remove( timer ) == true )
+    {
+        modem_timer_arm( );
+    }
+    smtc_modem_hal_enable_modem_irq( );
+}
+
+bool modem_timer_is_running( const modem_timer_t* timer )
+{
+    return timer->running;
+}
+
+uint32_t modem_timer_get_next_delay_ms( void )
+{
+    uint32_t delay_ms = UINT32_MAX;
+
+    smtc_modem_hal_disable_modem_irq( );
+    if( modem_timer_head != NULL )
+    {
+        const int32_t expiry_delay_ms = ( int32_t ) ( modem_timer_head->expiry_ms - smtc_modem_hal_get_time_in_ms( ) );
+        delay_ms                      = ( expiry_delay_ms > 0 ) ? ( uint32_t ) expiry_delay_ms : 0;
+    }
+    smtc_modem_hal_enable_modem_irq( );
+    return delay_ms;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static bool modem_timer_remove( modem_timer_t* timer )
+{
+    if( timer->running == false )
+    {
+        return false;
+    }
+    timer->running = false;
+
+    modem_timer_t** link = &modem_timer_head;
+    while( *link != NULL )
+    {
+        if( *link == timer )
+        {
+            *link       = timer->next;
+            timer->next = NULL;
+            return link == &modem_timer_head;
+        }
+        link = &( ( *link )->next );
+    }
+    return false;
+}
+
+static void modem_timer_arm( void )
+{
+    smtc_modem_hal_stop_timer( );
+    if( modem_timer_head != NULL )
+    {
+        int32_t delay_ms = ( int32_t ) ( modem_timer_head->expiry_ms - smtc_modem_hal_get_time_in_ms( ) );
+        smtc_modem_hal_start_timer( ( delay_ms > 0 ) ? ( uint32_t ) delay_ms : 0, modem_timer_irq_callback, NULL );
+    }
+}
+
+static void modem_timer_irq_callback( void* context )
+{
+    // A callback may start or stop timers, the list is read again after each one
+    while( ( modem_timer_head != NULL ) &&
+           ( ( int32_t ) ( smtc_modem_hal_get_time_in_ms( ) - modem_timer_head->expiry_ms ) >= 0 ) )
+    {
+        modem_timer_t* timer = modem_timer_head;
+        modem_timer_head     = timer->next;
+        timer->next          = NULL;
+        timer->running       = false;
+        timer->callback( timer->context );
+    }
+    modem_timer_arm( );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
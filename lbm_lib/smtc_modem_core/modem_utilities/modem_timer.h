@@ -0,0 +1,126 @@
+/*!
+ * \file      modem_timer.h
+ *
+ * \brief     Software timers sharing the modem HAL timer
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MODEM_TIMER_H
+#define MODEM_TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * \brief Software timer, allocated by its user and only accessed through the modem_timer_* functions
+ */
+typedef struct modem_timer_s
+{
+    struct modem_timer_s* next;       //!< Next running timer, by expiration time
+    uint32_t              expiry_ms;  //!< Expiration time, in smtc_modem_hal_get_time_in_ms() time base
+    bool                  running;    //!< The timer is in the running list
+    void*                 context;    //!< Passed back to the callback
+    void ( *callback )( void* context );  //!< Called from the HAL timer interrupt on expiration
+} modem_timer_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ * \brief Start a timer, or restart it if it is running
+ *
+ * \remark The running timers are kept sorted by expiration time and the HAL timer (smtc_modem_hal_start_timer) is
+ * armed on the earliest one, so that the radio planner and the other users of the modem share it without polling and
+ * the MCU sleeps until the earliest expiration. The HAL timer shall only be used through this module. The callbacks
+ * are called from the HAL timer interrupt, they can start and stop timers.
+ *
+ * \param [in] timer       Timer, shall stay allocated while it is running
+ * \param [in] delay_ms    Delay before the expiration, in milliseconds
+ * \param [in] callback    Function called on expiration
+ * \param [in] context     Passed back to the callback
+ */
+void modem_timer_start( modem_timer_t* timer, uint32_t delay_ms, void ( *callback )( void* context ), void* context );
+
+/*!
+ * \brief Stop a timer, nothing is done if it is not running
+ *
+ * \param [in] timer Timer
+ */
+void modem_timer_stop( modem_timer_t* timer );
+
+/*!
+ * \brief Tell whether a timer is running
+ *
+ * \param [in] timer Timer
+ *
+ * \returns true between modem_timer_start() and the expiration or modem_timer_stop()
+ */
+bool modem_timer_is_running( const modem_timer_t* timer );
+
+/*!
+ * \brief Get the delay before the first running timer expires
+ *
+ * \returns Delay in ms, 0 when the timer has already expired, UINT32_MAX when no timer is running
+ */
+uint32_t modem_timer_get_next_delay_ms( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODEM_TIMER_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -106,8 +106,6 @@
 #define LR11XX_GNSS_READ_ALMANAC_TEMPBUFFER_SIZE_BYTE ( 47 )
 #define LR11XX_GNSS_MAX_DETECTED_SV ( 32 )
 #define LR11XX_GNSS_DETECTED_SV_SINGLE_LENGTH ( 4 )
-#define LR11XX_GNSS_MAX_DETECTED_SV_BUFFER_LENGTH \
-    ( LR11XX_GNSS_MAX_DETECTED_SV * LR11XX_GNSS_DETECTED_SV_SINGLE_LENGTH )
 #define LR11XX_GNSS_READ_FIRMWARE_VERSION_RBUFFER_LENGTH ( 2 )
 #define LR11XX_GNSS_READ_TIME_RBUFFER_LENGTH ( 12 )
 #define LR11XX_GNSS_READ_WEEK_NUMBER_ROLLOVER_RBUFFER_LENGTH ( 2 )
@@ -612,7 +610,9 @@ lr11xx_status_t lr11xx_gnss_get_detected_satellites(
     const uint8_t max_satellites_to_fetch =
         ( LR11XX_GNSS_MAX_DETECTED_SV > nb_detected_satellites ) ? nb_detected_satellites : LR11XX_GNSS_MAX_DETECTED_SV;
     const uint16_t read_size = max_satellites_to_fetch * LR11XX_GNSS_DETECTED_SV_SINGLE_LENGTH;
-    uint8_t        result_buffer[LR11XX_GNSS_MAX_DETECTED_SV_BUFFER_LENGTH] = { 0 };
+    // The raw response is read straight into the output array, which is at least as large (one
+    // lr11xx_gnss_detected_satellite_t is not smaller than LR11XX_GNSS_DETECTED_SV_SINGLE_LENGTH bytes)
+    uint8_t* result_buffer = ( uint8_t* ) detected_satellite_id_snr_doppler;
 
     const uint8_t cbuffer[LR11XX_GNSS_GET_SV_SATELLITES_CMD_LENGTH] = {
         ( uint8_t )( LR11XX_GNSS_GET_SATELLITES_OC >> 8 ),
@@ -623,16 +623,20 @@ lr11xx_status_t lr11xx_gnss_get_detected_satellites(
         lr11xx_hal_read( context, cbuffer, LR11XX_GNSS_GET_SV_SATELLITES_CMD_LENGTH, result_buffer, read_size );
     if( hal_status == LR11XX_HAL_STATUS_OK )
     {
-        for( uint8_t index_satellite = 0; index_satellite < max_satellites_to_fetch; index_satellite++ )
+        // Decode from the last satellite so that a raw entry is never overwritten before being decoded
+        for( uint8_t index_satellite = max_satellites_to_fetch; index_satellite > 0; index_satellite-- )
         {
-            const uint16_t local_result_buffer_index = index_satellite * LR11XX_GNSS_DETECTED_SV_SINGLE_LENGTH;
+            const uint16_t local_result_buffer_index = ( index_satellite - 1 ) * LR11XX_GNSS_DETECTED_SV_SINGLE_LENGTH;
+            const uint8_t  satellite_id              = result_buffer[local_result_buffer_index];
+            const uint8_t  snr                       = result_buffer[local_result_buffer_index + 1];
+            const int16_t  doppler = ( int16_t )( ( result_buffer[local_result_buffer_index + 2] << 8 ) +
+                                                 ( result_buffer[local_result_buffer_index + 3] ) );
             lr11xx_gnss_detected_satellite_t* local_satellite_result =
-                &detected_satellite_id_snr_doppler[index_satellite];
+                &detected_satellite_id_snr_doppler[index_satellite - 1];
 
-            local_satellite_result->satellite_id = result_buffer[local_result_buffer_index];
-            local_satellite_result->cnr = result_buffer[local_result_buffer_index + 1] + LR11XX_GNSS_SNR_TO_CNR_OFFSET;
-            local_satellite_result->doppler = ( int16_t )( ( result_buffer[local_result_buffer_index + 2] << 8 ) +
-                                                           ( result_buffer[local_result_buffer_index + 3] ) );
+            local_satellite_result->satellite_id = satellite_id;
+            local_satellite_result->cnr          = snr + LR11XX_GNSS_SNR_TO_CNR_OFFSET;
+            local_satellite_result->doppler      = doppler;
         }
     }
     return ( lr11xx_status_t ) hal_status;
@@ -37,6 +37,7 @@
  * --- DEPENDENCIES ------------------------------------------------------------
  */
 #include <stddef.h>
+#include <string.h>
 #include "sx126x.h"
 #include "sx126x_hal.h"
 #include "sx126x_regs.h"
@@ -71,6 +72,20 @@
  */
 #define SX126X_PLL_STEP_SCALED ( SX126X_XTAL_FREQ >> ( 25 - SX126X_PLL_STEP_SHIFT_AMOUNT ) )
 
+#if defined( ADD_RAL_BATCH )
+/**
+ * @brief Size of the command batch buffer, each record takes its length on one byte plus the command and data bytes
+ */
+#ifndef SX126X_BATCH_BUFFER_SIZE
+#define SX126X_BATCH_BUFFER_SIZE 128
+#endif
+
+/**
+ * @brief Maximum length of a recorded command (command and data)
+ */
+#define SX126X_BATCH_RECORD_MAX_LENGTH 255
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE TYPES -----------------------------------------------------------
@@ -210,11 +225,28 @@ gfsk_bw_t gfsk_bw[] = {
     { 312000, SX126X_GFSK_BW_312000 }, { 373600, SX126X_GFSK_BW_373600 }, { 467000, SX126X_GFSK_BW_467000 },
 };
 
+#if defined( ADD_RAL_BATCH )
+/**
+ * @brief Command batch, the write commands are recorded as [length][command][data] records
+ */
+typedef struct sx126x_batch_s
+{
+    const void* context;
+    bool        is_active;
+    uint16_t    length;
+    uint8_t     buffer[SX126X_BATCH_BUFFER_SIZE];
+} sx126x_batch_t;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+#if defined( ADD_RAL_BATCH )
+static sx126x_batch_t sx126x_batch = { 0 };
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -239,6 +271,52 @@ static sx126x_status_t sx126x_tx_modulation_workaround( const void* context, sx1
 
 static inline uint32_t sx126x_get_gfsk_crc_len_in_bytes( sx126x_gfsk_crc_types_t crc_type );
 
+/**
+ * @brief Write a command, recorded in the command batch when it is active
+ *
+ * @param [in] context Chip implementation context.
+ * @param [in] command Pointer to the command buffer
+ * @param [in] command_length Command buffer size
+ * @param [in] data Pointer to the data buffer
+ * @param [in] data_length Data buffer size
+ *
+ * @returns Operation status
+ */
+static sx126x_hal_status_t sx126x_write( const void* context, const uint8_t* command, const uint16_t command_length,
+                                         const uint8_t* data, const uint16_t data_length );
+
+/**
+ * @brief Read, the commands recorded in the command batch are sent first
+ *
+ * @param [in] context Chip implementation context.
+ * @param [in] command Pointer to the command buffer
+ * @param [in] command_length Command buffer size
+ * @param [out] data Pointer to the data buffer
+ * @param [in] data_length Data buffer size
+ *
+ * @returns Operation status
+ */
+static sx126x_hal_status_t sx126x_read( const void* context, const uint8_t* command, const uint16_t command_length,
+                                        uint8_t* data, const uint16_t data_length );
+
+#if defined( ADD_RAL_BATCH )
+/**
+ * @brief Send the commands recorded in the command batch, the batch stays active
+ *
+ * @returns Operation status
+ */
+static sx126x_hal_status_t sx126x_batch_flush( void );
+
+/**
+ * @brief Check if a command changes the operating mode of the chip, these commands are never recorded
+ *
+ * @param [in] opcode Command opcode
+ *
+ * @returns True if the command is an operating mode command
+ */
+static bool sx126x_batch_is_mode_command( const uint8_t opcode );
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -251,7 +329,7 @@ sx126x_status_t sx126x_set_sleep( const void* context, const sx126x_sleep_cfgs_t
         ( uint8_t ) cfg,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_SLEEP, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_SLEEP, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_standby( const void* context, const sx126x_standby_cfg_t cfg )
@@ -261,7 +339,7 @@ sx126x_status_t sx126x_set_standby( const void* context, const sx126x_standby_cf
         ( uint8_t ) cfg,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_STANDBY, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_STANDBY, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_fs( const void* context )
@@ -270,7 +348,7 @@ sx126x_status_t sx126x_set_fs( const void* context )
         SX126X_SET_FS,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_FS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_FS, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_tx( const void* context, const uint32_t timeout_in_ms )
@@ -294,7 +372,7 @@ sx126x_status_t sx126x_set_tx_with_timeout_in_rtc_step( const void* context, con
         ( uint8_t )( timeout_in_rtc_step >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_TX, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_TX, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_rx( const void* context, const uint32_t timeout_in_ms )
@@ -318,7 +396,7 @@ sx126x_status_t sx126x_set_rx_with_timeout_in_rtc_step( const void* context, con
         ( uint8_t )( timeout_in_rtc_step >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_RX, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_RX, 0, 0 );
 }
 
 sx126x_status_t sx126x_stop_timer_on_preamble( const void* context, const bool enable )
@@ -328,7 +406,7 @@ sx126x_status_t sx126x_stop_timer_on_preamble( const void* context, const bool e
         ( enable == true ) ? 1 : 0,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_STOP_TIMER_ON_PREAMBLE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_STOP_TIMER_ON_PREAMBLE, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_rx_duty_cycle( const void* context, const uint32_t rx_time_in_ms,
@@ -354,7 +432,7 @@ sx126x_status_t sx126x_set_rx_duty_cycle_with_timings_in_rtc_step( const void*
         ( uint8_t )( sleep_time_in_rtc_step >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_RX_DUTY_CYCLE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_RX_DUTY_CYCLE, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_cad( const void* context )
@@ -363,7 +441,7 @@ sx126x_status_t sx126x_set_cad( const void* context )
         SX126X_SET_CAD,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_CAD, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_CAD, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_tx_cw( const void* context )
@@ -372,7 +450,7 @@ sx126x_status_t sx126x_set_tx_cw( const void* context )
         SX126X_SET_TX_CONTINUOUS_WAVE,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_TX_CONTINUOUS_WAVE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_TX_CONTINUOUS_WAVE, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_tx_infinite_preamble( const void* context )
@@ -381,7 +459,7 @@ sx126x_status_t sx126x_set_tx_infinite_preamble( const void* context )
         SX126X_SET_TX_INFINITE_PREAMBLE,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_TX_INFINITE_PREAMBLE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_TX_INFINITE_PREAMBLE, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_reg_mode( const void* context, const sx126x_reg_mod_t mode )
@@ -391,7 +469,7 @@ sx126x_status_t sx126x_set_reg_mode( const void* context, const sx126x_reg_mod_t
         ( uint8_t ) mode,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_REGULATOR_MODE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_REGULATOR_MODE, 0, 0 );
 }
 
 sx126x_status_t sx126x_cal( const void* context, const sx126x_cal_mask_t param )
@@ -401,7 +479,7 @@ sx126x_status_t sx126x_cal( const void* context, const sx126x_cal_mask_t param )
         ( uint8_t ) param,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_CALIBRATE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_CALIBRATE, 0, 0 );
 }
 
 sx126x_status_t sx126x_cal_img( const void* context, const uint8_t freq1, const uint8_t freq2 )
@@ -412,7 +490,7 @@ sx126x_status_t sx126x_cal_img( const void* context, const uint8_t freq1, const
         freq2,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_CALIBRATE_IMAGE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_CALIBRATE_IMAGE, 0, 0 );
 }
 
 sx126x_status_t sx126x_cal_img_in_mhz( const void* context, const uint16_t freq1_in_mhz, const uint16_t freq2_in_mhz )
@@ -433,7 +511,7 @@ sx126x_status_t sx126x_set_pa_cfg( const void* context, const sx126x_pa_cfg_para
         SX126X_SET_PA_CFG, params->pa_duty_cycle, params->hp_max, params->device_sel, params->pa_lut,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_PA_CFG, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_PA_CFG, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_rx_tx_fallback_mode( const void* context, const sx126x_fallback_modes_t fallback_mode )
@@ -443,7 +521,7 @@ sx126x_status_t sx126x_set_rx_tx_fallback_mode( const void* context, const sx126
         ( uint8_t ) fallback_mode,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_RX_TX_FALLBACK_MODE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_RX_TX_FALLBACK_MODE, 0, 0 );
 }
 
 //
@@ -459,7 +537,7 @@ sx126x_status_t sx126x_write_register( const void* context, const uint16_t addre
         ( uint8_t )( address >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_WRITE_REGISTER, buffer, size );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_WRITE_REGISTER, buffer, size );
 }
 
 sx126x_status_t sx126x_read_register( const void* context, const uint16_t address, uint8_t* buffer, const uint8_t size )
@@ -471,7 +549,7 @@ sx126x_status_t sx126x_read_register( const void* context, const uint16_t addres
         SX126X_NOP,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_READ_REGISTER, buffer, size );
+    return ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_READ_REGISTER, buffer, size );
 }
 
 sx126x_status_t sx126x_write_buffer( const void* context, const uint8_t offset, const uint8_t* buffer,
@@ -482,7 +560,7 @@ sx126x_status_t sx126x_write_buffer( const void* context, const uint8_t offset,
         offset,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_WRITE_BUFFER, buffer, size );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_WRITE_BUFFER, buffer, size );
 }
 
 sx126x_status_t sx126x_read_buffer( const void* context, const uint8_t offset, uint8_t* buffer, const uint8_t size )
@@ -493,7 +571,7 @@ sx126x_status_t sx126x_read_buffer( const void* context, const uint8_t offset, u
         SX126X_NOP,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_READ_BUFFER, buffer, size );
+    return ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_READ_BUFFER, buffer, size );
 }
 
 //
@@ -508,7 +586,7 @@ sx126x_status_t sx126x_set_dio_irq_params( const void* context, const uint16_t i
         ( uint8_t )( dio2_mask >> 0 ), ( uint8_t )( dio3_mask >> 8 ), ( uint8_t )( dio3_mask >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_DIO_IRQ_PARAMS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_DIO_IRQ_PARAMS, 0, 0 );
 }
 
 sx126x_status_t sx126x_get_irq_status( const void* context, sx126x_irq_mask_t* irq )
@@ -519,8 +597,8 @@ sx126x_status_t sx126x_get_irq_status( const void* context, sx126x_irq_mask_t* i
     };
     uint8_t irq_local[sizeof( sx126x_irq_mask_t )] = { 0x00 };
 
-    const sx126x_status_t status = ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_IRQ_STATUS,
-                                                                        irq_local, sizeof( sx126x_irq_mask_t ) );
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_IRQ_STATUS,
+                                                                    irq_local, sizeof( sx126x_irq_mask_t ) );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -538,7 +616,7 @@ sx126x_status_t sx126x_clear_irq_status( const void* context, const sx126x_irq_m
         ( uint8_t )( irq_mask >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_CLR_IRQ_STATUS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_CLR_IRQ_STATUS, 0, 0 );
 }
 
 sx126x_status_t sx126x_get_and_clear_irq_status( const void* context, sx126x_irq_mask_t* irq )
@@ -565,7 +643,7 @@ sx126x_status_t sx126x_set_dio2_as_rf_sw_ctrl( const void* context, const bool e
         ( enable == true ) ? 1 : 0,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_DIO2_AS_RF_SWITCH_CTRL, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_DIO2_AS_RF_SWITCH_CTRL, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_dio3_as_tcxo_ctrl( const void* context, const sx126x_tcxo_ctrl_voltages_t tcxo_voltage,
@@ -576,7 +654,7 @@ sx126x_status_t sx126x_set_dio3_as_tcxo_ctrl( const void* context, const sx126x_
         ( uint8_t )( timeout >> 8 ),  ( uint8_t )( timeout >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_DIO3_AS_TCXO_CTRL, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_DIO3_AS_TCXO_CTRL, 0, 0 );
 }
 
 //
@@ -597,7 +675,7 @@ sx126x_status_t sx126x_set_rf_freq_in_pll_steps( const void* context, const uint
         ( uint8_t )( freq >> 8 ), ( uint8_t )( freq >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_RF_FREQUENCY, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_RF_FREQUENCY, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_pkt_type( const void* context, const sx126x_pkt_type_t pkt_type )
@@ -607,7 +685,7 @@ sx126x_status_t sx126x_set_pkt_type( const void* context, const sx126x_pkt_type_
         ( uint8_t ) pkt_type,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_PKT_TYPE, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_PKT_TYPE, 0, 0 );
 }
 
 sx126x_status_t sx126x_get_pkt_type( const void* context, sx126x_pkt_type_t* pkt_type )
@@ -617,7 +695,7 @@ sx126x_status_t sx126x_get_pkt_type( const void* context, sx126x_pkt_type_t* pkt
         SX126X_NOP,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_PKT_TYPE, ( uint8_t* ) pkt_type, 1 );
+    return ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_PKT_TYPE, ( uint8_t* ) pkt_type, 1 );
 }
 
 sx126x_status_t sx126x_set_tx_params( const void* context, const int8_t pwr_in_dbm, const sx126x_ramp_time_t ramp_time )
@@ -628,7 +706,7 @@ sx126x_status_t sx126x_set_tx_params( const void* context, const int8_t pwr_in_d
         ( uint8_t ) ramp_time,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_TX_PARAMS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_TX_PARAMS, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_gfsk_mod_params( const void* context, const sx126x_mod_params_gfsk_t* params )
@@ -642,7 +720,7 @@ sx126x_status_t sx126x_set_gfsk_mod_params( const void* context, const sx126x_mo
     };
 
     sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_MODULATION_PARAMS_GFSK, 0, 0 );
+        ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_MODULATION_PARAMS_GFSK, 0, 0 );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -662,7 +740,7 @@ sx126x_status_t sx126x_set_bpsk_mod_params( const void* context, const sx126x_mo
         ( uint8_t )( bitrate >> 0 ),  ( uint8_t )( params->pulse_shape ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_MODULATION_PARAMS_BPSK, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_MODULATION_PARAMS_BPSK, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_lora_mod_params( const void* context, const sx126x_mod_params_lora_t* params )
@@ -673,7 +751,7 @@ sx126x_status_t sx126x_set_lora_mod_params( const void* context, const sx126x_mo
     };
 
     sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_MODULATION_PARAMS_LORA, 0, 0 );
+        ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_MODULATION_PARAMS_LORA, 0, 0 );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -700,7 +778,7 @@ sx126x_status_t sx126x_set_gfsk_pkt_params( const void* context, const sx126x_pk
         ( uint8_t )( params->dc_free ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_PKT_PARAMS_GFSK, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_PKT_PARAMS_GFSK, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_bpsk_pkt_params( const void* context, const sx126x_pkt_params_bpsk_t* params )
@@ -711,7 +789,7 @@ sx126x_status_t sx126x_set_bpsk_pkt_params( const void* context, const sx126x_pk
     };
 
     sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_PKT_PARAMS_BPSK, 0, 0 );
+        ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_PKT_PARAMS_BPSK, 0, 0 );
     if( status != SX126X_STATUS_OK )
     {
         return status;
@@ -739,7 +817,7 @@ sx126x_status_t sx126x_set_lora_pkt_params( const void* context, const sx126x_pk
     };
 
     sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_PKT_PARAMS_LORA, 0, 0 );
+        ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_PKT_PARAMS_LORA, 0, 0 );
 
     // WORKAROUND - Optimizing the Inverted IQ Operation, see datasheet DS_SX1261-2_V1.2 §15.4
     if( status == SX126X_STATUS_OK )
@@ -786,7 +864,7 @@ sx126x_status_t sx126x_set_cad_params( const void* context, const sx126x_cad_par
         ( uint8_t )( params->cad_timeout >> 0 ),
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_CAD_PARAMS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_CAD_PARAMS, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_buffer_base_address( const void* context, const uint8_t tx_base_address,
@@ -798,7 +876,7 @@ sx126x_status_t sx126x_set_buffer_base_address( const void* context, const uint8
         rx_base_address,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_BUFFER_BASE_ADDRESS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_BUFFER_BASE_ADDRESS, 0, 0 );
 }
 
 sx126x_status_t sx126x_set_lora_symb_nb_timeout( const void* context, const uint8_t nb_of_symbs )
@@ -821,7 +899,7 @@ sx126x_status_t sx126x_set_lora_symb_nb_timeout( const void* context, const uint
     };
 
     sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_SET_LORA_SYMB_NUM_TIMEOUT, 0, 0 );
+        ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_SET_LORA_SYMB_NUM_TIMEOUT, 0, 0 );
 
     if( ( status == SX126X_STATUS_OK ) && ( nb_of_symbs > 0 ) )
     {
@@ -844,7 +922,7 @@ sx126x_status_t sx126x_get_status( const void* context, sx126x_chip_status_t* ra
     uint8_t status_local = 0;
 
     const sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_STATUS, &status_local, 1 );
+        ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_STATUS, &status_local, 1 );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -865,7 +943,7 @@ sx126x_status_t sx126x_get_rx_buffer_status( const void* context, sx126x_rx_buff
     };
     uint8_t status_local[sizeof( sx126x_rx_buffer_status_t )] = { 0x00 };
 
-    const sx126x_status_t status = ( sx126x_status_t ) sx126x_hal_read(
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_read(
         context, buf, SX126X_SIZE_GET_RX_BUFFER_STATUS, status_local, sizeof( sx126x_rx_buffer_status_t ) );
 
     if( status == SX126X_STATUS_OK )
@@ -886,7 +964,7 @@ sx126x_status_t sx126x_get_gfsk_pkt_status( const void* context, sx126x_pkt_stat
     uint8_t pkt_status_local[3] = { 0x00 };
 
     const sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_PKT_STATUS, pkt_status_local, 3 );
+        ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_PKT_STATUS, pkt_status_local, 3 );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -918,7 +996,7 @@ sx126x_status_t sx126x_get_lora_pkt_status( const void* context, sx126x_pkt_stat
     };
     uint8_t pkt_status_local[sizeof( sx126x_pkt_status_lora_t )] = { 0x00 };
 
-    const sx126x_status_t status = ( sx126x_status_t ) sx126x_hal_read(
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_read(
         context, buf, SX126X_SIZE_GET_PKT_STATUS, pkt_status_local, sizeof( sx126x_pkt_status_lora_t ) );
 
     if( status == SX126X_STATUS_OK )
@@ -940,7 +1018,7 @@ sx126x_status_t sx126x_get_rssi_inst( const void* context, int16_t* rssi_in_dbm
     uint8_t rssi_local = 0x00;
 
     const sx126x_status_t status =
-        ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_RSSI_INST, &rssi_local, 1 );
+        ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_RSSI_INST, &rssi_local, 1 );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -958,7 +1036,7 @@ sx126x_status_t sx126x_get_gfsk_stats( const void* context, sx126x_stats_gfsk_t*
     };
     uint8_t stats_local[sizeof( sx126x_stats_gfsk_t )] = { 0 };
 
-    const sx126x_status_t status = ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_STATS,
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_STATS,
                                                                         stats_local, sizeof( sx126x_stats_gfsk_t ) );
 
     if( status == SX126X_STATUS_OK )
@@ -979,7 +1057,7 @@ sx126x_status_t sx126x_get_lora_stats( const void* context, sx126x_stats_lora_t*
     };
     uint8_t stats_local[sizeof( sx126x_stats_lora_t )] = { 0 };
 
-    const sx126x_status_t status = ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_STATS,
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_STATS,
                                                                         stats_local, sizeof( sx126x_stats_lora_t ) );
 
     if( status == SX126X_STATUS_OK )
@@ -997,7 +1075,7 @@ sx126x_status_t sx126x_reset_stats( const void* context )
         SX126X_RESET_STATS, SX126X_NOP, SX126X_NOP, SX126X_NOP, SX126X_NOP, SX126X_NOP, SX126X_NOP,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_RESET_STATS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_RESET_STATS, 0, 0 );
 }
 
 //
@@ -1014,6 +1092,36 @@ sx126x_status_t sx126x_wakeup( const void* context )
     return ( sx126x_status_t ) sx126x_hal_wakeup( context );
 }
 
+#if defined( ADD_RAL_BATCH )
+sx126x_status_t sx126x_batch_begin( const void* context )
+{
+    sx126x_status_t status = SX126X_STATUS_OK;
+
+    // A batch of another context is sent before recording the new one
+    if( sx126x_batch.is_active && ( sx126x_batch.context != context ) )
+    {
+        status = ( sx126x_status_t ) sx126x_batch_flush( );
+    }
+
+    sx126x_batch.context   = context;
+    sx126x_batch.is_active = true;
+    return status;
+}
+
+sx126x_status_t sx126x_batch_commit( const void* context )
+{
+    if( !sx126x_batch.is_active || ( sx126x_batch.context != context ) )
+    {
+        return SX126X_STATUS_OK;
+    }
+
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_batch_flush( );
+
+    sx126x_batch.is_active = false;
+    return status;
+}
+#endif
+
 sx126x_status_t sx126x_get_device_errors( const void* context, sx126x_errors_mask_t* errors )
 {
     const uint8_t buf[SX126X_SIZE_GET_DEVICE_ERRORS] = {
@@ -1022,8 +1130,8 @@ sx126x_status_t sx126x_get_device_errors( const void* context, sx126x_errors_mas
     };
     uint8_t errors_local[sizeof( sx126x_errors_mask_t )] = { 0x00 };
 
-    const sx126x_status_t status = ( sx126x_status_t ) sx126x_hal_read( context, buf, SX126X_SIZE_GET_DEVICE_ERRORS,
-                                                                        errors_local, sizeof( sx126x_errors_mask_t ) );
+    const sx126x_status_t status = ( sx126x_status_t ) sx126x_read( context, buf, SX126X_SIZE_GET_DEVICE_ERRORS,
+                                                                    errors_local, sizeof( sx126x_errors_mask_t ) );
 
     if( status == SX126X_STATUS_OK )
     {
@@ -1041,7 +1149,7 @@ sx126x_status_t sx126x_clear_device_errors( const void* context )
         SX126X_NOP,
     };
 
-    return ( sx126x_status_t ) sx126x_hal_write( context, buf, SX126X_SIZE_CLR_DEVICE_ERRORS, 0, 0 );
+    return ( sx126x_status_t ) sx126x_write( context, buf, SX126X_SIZE_CLR_DEVICE_ERRORS, 0, 0 );
 }
 
 sx126x_status_t sx126x_get_gfsk_bw_param( const uint32_t bw, uint8_t* param )
@@ -1521,6 +1629,101 @@ static sx126x_status_t sx126x_tx_modulation_workaround( const void* context, sx1
     return status;
 }
 
+static sx126x_hal_status_t sx126x_write( const void* context, const uint8_t* command, const uint16_t command_length,
+                                         const uint8_t* data, const uint16_t data_length )
+{
+#if defined( ADD_RAL_BATCH )
+    if( sx126x_batch.is_active && ( sx126x_batch.context == context ) )
+    {
+        const uint16_t record_length = command_length + data_length;
+
+        if( ( record_length <= SX126X_BATCH_RECORD_MAX_LENGTH ) &&
+            ( ( 1 + record_length ) <= SX126X_BATCH_BUFFER_SIZE ) && !sx126x_batch_is_mode_command( command[0] ) )
+        {
+            if( ( sx126x_batch.length + 1 + record_length ) > SX126X_BATCH_BUFFER_SIZE )
+            {
+                const sx126x_hal_status_t status = sx126x_batch_flush( );
+                if( status != SX126X_HAL_STATUS_OK )
+                {
+                    return status;
+                }
+            }
+
+            uint8_t* record = &sx126x_batch.buffer[sx126x_batch.length];
+
+            record[0] = ( uint8_t ) record_length;
+            memcpy( &record[1], command, command_length );
+            if( data_length > 0 )
+            {
+                memcpy( &record[1 + command_length], data, data_length );
+            }
+            sx126x_batch.length += 1 + record_length;
+            return SX126X_HAL_STATUS_OK;
+        }
+
+        // The command is not recorded, it is sent right after the recorded ones
+        const sx126x_hal_status_t status = sx126x_batch_flush( );
+        if( status != SX126X_HAL_STATUS_OK )
+        {
+            return status;
+        }
+    }
+#endif
+    return sx126x_hal_write( context, command, command_length, data, data_length );
+}
+
+static sx126x_hal_status_t sx126x_read( const void* context, const uint8_t* command, const uint16_t command_length,
+                                        uint8_t* data, const uint16_t data_length )
+{
+#if defined( ADD_RAL_BATCH )
+    if( sx126x_batch.is_active && ( sx126x_batch.context == context ) )
+    {
+        const sx126x_hal_status_t status = sx126x_batch_flush( );
+        if( status != SX126X_HAL_STATUS_OK )
+        {
+            return status;
+        }
+    }
+#endif
+    return sx126x_hal_read( context, command, command_length, data, data_length );
+}
+
+#if defined( ADD_RAL_BATCH )
+static sx126x_hal_status_t sx126x_batch_flush( void )
+{
+    if( sx126x_batch.length == 0 )
+    {
+        return SX126X_HAL_STATUS_OK;
+    }
+
+    const uint16_t length = sx126x_batch.length;
+
+    sx126x_batch.length = 0;
+    return sx126x_hal_write_batch( sx126x_batch.context, sx126x_batch.buffer, length );
+}
+
+static bool sx126x_batch_is_mode_command( const uint8_t opcode )
+{
+    switch( opcode )
+    {
+    case SX126X_SET_SLEEP:
+    case SX126X_SET_STANDBY:
+    case SX126X_SET_FS:
+    case SX126X_SET_TX:
+    case SX126X_SET_RX:
+    case SX126X_SET_RX_DUTY_CYCLE:
+    case SX126X_SET_CAD:
+    case SX126X_SET_TX_CONTINUOUS_WAVE:
+    case SX126X_SET_TX_INFINITE_PREAMBLE:
+    case SX126X_CALIBRATE:
+    case SX126X_CALIBRATE_IMAGE:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
+
 static inline uint32_t sx126x_get_gfsk_crc_len_in_bytes( sx126x_gfsk_crc_types_t crc_type )
 {
     switch( crc_type )
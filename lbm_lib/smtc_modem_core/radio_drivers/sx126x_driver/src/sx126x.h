@@ -1430,6 +1430,30 @@ sx126x_status_t sx126x_reset( const void* context );
  */
 sx126x_status_t sx126x_wakeup( const void* context );
 
+#if defined( ADD_RAL_BATCH )
+/**
+ * @brief Start recording the write commands in the command batch instead of sending them
+ *
+ * @remark The recorded commands are sent with a single call to @ref sx126x_hal_write_batch when the batch is
+ * committed, before any read command, before any operating mode command (sleep, standby, fs, tx, rx, cad,
+ * calibration) and when the buffer of @ref SX126X_BATCH_BUFFER_SIZE bytes is full.
+ *
+ * @param [in] context Chip implementation context
+ *
+ * @returns Operation status
+ */
+sx126x_status_t sx126x_batch_begin( const void* context );
+
+/**
+ * @brief Send the recorded commands and stop recording
+ *
+ * @param [in] context Chip implementation context
+ *
+ * @returns Operation status
+ */
+sx126x_status_t sx126x_batch_commit( const void* context );
+#endif
+
 /**
  * @brief Get the list of all active errors
  *
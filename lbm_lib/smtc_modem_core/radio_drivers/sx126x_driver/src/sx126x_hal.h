@@ -121,6 +121,22 @@ sx126x_hal_status_t sx126x_hal_read( const void* context, const uint8_t* command
  */
 sx126x_hal_status_t sx126x_hal_reset( const void* context );
 
+/**
+ * Radio data transfer - write a batch of commands
+ *
+ * @remark Shall be implemented by the user when the driver is built with ADD_RAL_BATCH
+ *
+ * The buffer is a sequence of records made of the record length on one byte followed by the command and data bytes.
+ * Each record is sent in its own transaction, as done by @ref sx126x_hal_write.
+ *
+ * @param [in] context          Radio implementation parameters
+ * @param [in] buffer           Pointer to the records to be transmitted
+ * @param [in] length           Size of the records to be transmitted
+ *
+ * @returns Operation status
+ */
+sx126x_hal_status_t sx126x_hal_write_batch( const void* context, const uint8_t* buffer, const uint16_t length );
+
 /**
  * Wake the radio up.
  *
@@ -60,7 +60,6 @@
 #define SX126X_LR_FHSS_ENABLE_HOPPING ( 1 )
 
 #define SX126X_LR_FHSS_HOP_TABLE_SIZE ( 16 )
-#define SX126X_LR_FHSS_HOP_ENTRY_SIZE ( 6 )
 
 #define SX126X_LR_FHSS_GRID_3906_HZ_PLL_STEPS ( 4096 )
 #define SX126X_LR_FHSS_GRID_25391_HZ_PLL_STEPS ( 26624 )
@@ -143,7 +142,18 @@ sx126x_status_t sx126x_lr_fhss_init( const void* context, const sx126x_lr_fhss_p
         SX126X_SET_MODULATION_PARAMS, 32, 0, 0, SX126X_GFSK_PULSE_SHAPE_BT_1, 0, 0, 0, 0,
     };
 
+#if defined( ADD_RAL_BATCH )
+    // The LR-FHSS parameters are written without the command batch, send the recorded commands first
+    sx126x_status_t status = sx126x_batch_commit( context );
+    if( status != SX126X_STATUS_OK )
+    {
+        return status;
+    }
+
+    status = sx126x_set_pkt_type( context, SX126X_PKT_TYPE_LR_FHSS );
+#else
     sx126x_status_t status = sx126x_set_pkt_type( context, SX126X_PKT_TYPE_LR_FHSS );
+#endif
     if( status != SX126X_STATUS_OK )
     {
         return status;
@@ -366,6 +376,65 @@ sx126x_status_t sx126x_lr_fhss_handle_hop( const void* context, const sx126x_lr_
     return SX126X_STATUS_OK;
 }
 
+sx126x_status_t sx126x_lr_fhss_build_hop_table( const sx126x_lr_fhss_params_t* params,
+                                                const sx126x_lr_fhss_state_t* state, sx126x_lr_fhss_hop_table_t* table )
+{
+    if( state->current_hop >= state->digest.nb_hops )
+    {
+        table->first_hop = state->current_hop;
+        table->next_hop  = state->current_hop;
+        table->nb_hops   = state->current_hop;
+        return SX126X_STATUS_OK;
+    }
+    if( ( state->digest.nb_hops - state->current_hop ) > SX126X_LR_FHSS_HOP_TABLE_MAX_HOPS )
+    {
+        return SX126X_STATUS_UNKNOWN_VALUE;
+    }
+
+    // Same sequence as sx126x_lr_fhss_handle_hop, computed on a copy of the state
+    sx126x_lr_fhss_state_t hop_state = *state;
+
+    table->first_hop = hop_state.current_hop;
+    table->next_hop  = hop_state.current_hop;
+    table->nb_hops   = hop_state.digest.nb_hops;
+
+    while( hop_state.current_hop < hop_state.digest.nb_hops )
+    {
+        uint8_t* entry = table->entries[hop_state.current_hop - table->first_hop];
+
+        entry[0] = ( uint8_t ) ( LR_FHSS_BLOCK_BITS >> 8 );
+        entry[1] = ( uint8_t ) LR_FHSS_BLOCK_BITS;
+        entry[2] = ( uint8_t ) ( hop_state.next_freq_in_pll_steps >> 24 );
+        entry[3] = ( uint8_t ) ( hop_state.next_freq_in_pll_steps >> 16 );
+        entry[4] = ( uint8_t ) ( hop_state.next_freq_in_pll_steps >> 8 );
+        entry[5] = ( uint8_t ) hop_state.next_freq_in_pll_steps;
+
+        hop_state.current_hop++;
+        hop_state.digest.nb_bits -= ( hop_state.digest.nb_bits > LR_FHSS_BLOCK_BITS ) ? LR_FHSS_BLOCK_BITS
+                                                                                      : hop_state.digest.nb_bits;
+        hop_state.next_freq_in_pll_steps = sx126x_lr_fhss_get_next_freq_in_pll_steps( params, &hop_state );
+    }
+    return SX126X_STATUS_OK;
+}
+
+sx126x_status_t sx126x_lr_fhss_handle_hop_from_table( const void* context, sx126x_lr_fhss_hop_table_t* table )
+{
+    if( table->next_hop < table->nb_hops )
+    {
+        sx126x_status_t status = sx126x_write_register(
+            context,
+            SX126X_LR_FHSS_REG_NUM_SYMBOLS_0 +
+                ( SX126X_LR_FHSS_HOP_ENTRY_SIZE * ( table->next_hop % SX126X_LR_FHSS_HOP_TABLE_SIZE ) ),
+            table->entries[table->next_hop - table->first_hop], SX126X_LR_FHSS_HOP_ENTRY_SIZE );
+        if( status != SX126X_STATUS_OK )
+        {
+            return status;
+        }
+        table->next_hop++;
+    }
+    return SX126X_STATUS_OK;
+}
+
 sx126x_status_t sx126x_lr_fhss_handle_tx_done( const void* context, const sx126x_lr_fhss_params_t* params,
                                                sx126x_lr_fhss_state_t* state )
 {
@@ -60,6 +60,18 @@
 #define SX126X_LR_FHSS_REG_NUM_SYMBOLS_0 ( 0x0388 )
 #define SX126X_LR_FHSS_REG_FREQ_0 ( 0x038A )
 
+/**
+ * @brief Size of an entry of the radio hop table: number of symbols (2 bytes) and frequency in PLL steps (4 bytes)
+ */
+#define SX126X_LR_FHSS_HOP_ENTRY_SIZE ( 6 )
+
+/**
+ * @brief Maximum number of hops, after the ones written with the hop sequence head, of a precomputed hop table
+ */
+#ifndef SX126X_LR_FHSS_HOP_TABLE_MAX_HOPS
+#define SX126X_LR_FHSS_HOP_TABLE_MAX_HOPS ( 128 )
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -89,6 +101,18 @@ typedef struct sx126x_lr_fhss_state_s
     uint8_t              current_hop;            /**< Index of the current hop */
 } sx126x_lr_fhss_state_t;
 
+/**
+ * @brief SX126X LR-FHSS precomputed hop table, holding the radio hop table entries of the hops not written with the
+ * hop sequence head
+ */
+typedef struct sx126x_lr_fhss_hop_table_s
+{
+    uint8_t entries[SX126X_LR_FHSS_HOP_TABLE_MAX_HOPS][SX126X_LR_FHSS_HOP_ENTRY_SIZE];  //!< Entries in register format
+    uint8_t first_hop;                                                                 //!< Index of the first entry hop
+    uint8_t next_hop;                                                                  //!< Index of the next hop to write
+    uint8_t nb_hops;                                                                   //!< Total number of hops
+} sx126x_lr_fhss_hop_table_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -205,6 +229,31 @@ sx126x_status_t sx126x_lr_fhss_build_frame( const void* context, const sx126x_lr
 sx126x_status_t sx126x_lr_fhss_handle_hop( const void* context, const sx126x_lr_fhss_params_t* params,
                                            sx126x_lr_fhss_state_t* state );
 
+/**
+ * @brief Precompute the radio hop table entries of the hops remaining after @ref sx126x_lr_fhss_build_frame
+ *
+ * @remark The hops are then handled with @ref sx126x_lr_fhss_handle_hop_from_table, which only writes the next
+ * precomputed entry to the radio. The state is not modified.
+ *
+ * @param [in]  params sx126x LR-FHSS parameter structure
+ * @param [in]  state  sx126x LR-FHSS state structure, as left by @ref sx126x_lr_fhss_build_frame
+ * @param [out] table  Precomputed hop table
+ *
+ * @returns Operation status, SX126X_STATUS_UNKNOWN_VALUE if the hops don't fit in the table
+ */
+sx126x_status_t sx126x_lr_fhss_build_hop_table( const sx126x_lr_fhss_params_t* params,
+                                                const sx126x_lr_fhss_state_t* state, sx126x_lr_fhss_hop_table_t* table );
+
+/**
+ * @brief Handle LR-FHSS hop from a precomputed hop table
+ *
+ * @param [in]     context Chip implementation context
+ * @param [in,out] table   Hop table built by @ref sx126x_lr_fhss_build_hop_table
+ *
+ * @returns Operation status
+ */
+sx126x_status_t sx126x_lr_fhss_handle_hop_from_table( const void* context, sx126x_lr_fhss_hop_table_t* table );
+
 /**
  * @brief Indicate to the radio that frequency hopping is no longer needed
  *
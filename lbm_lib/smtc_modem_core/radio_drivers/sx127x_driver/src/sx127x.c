@@ -297,6 +297,16 @@ static sx127x_status_t sx1276_fix_lora_rx_spurious_signal( sx127x_t* radio );
  */
 static sx127x_status_t sx127x_update_lora_iq_inverted_regs( sx127x_t* radio, bool is_tx_on );
 
+/**
+ * @brief Compute the LoRa packet status from the packet SNR and RSSI register values
+ *
+ * @param [in]  radio      Chip implementation context.
+ * @param [in]  reg_values SX127X_REG_LORA_PACKET_SNR_VALUE and SX127X_REG_LORA_PACKET_RSSI_VALUE register values
+ * @param [out] pkt_status Pointer to a structure to store the packet status
+ */
+static void sx127x_compute_lora_pkt_status( sx127x_t* radio, const uint8_t reg_values[2],
+                                            sx127x_lora_pkt_status_t* pkt_status );
+
 /**
  * @brief Callback function called when sx127x_hal_timer expires
  *
@@ -734,14 +744,11 @@ sx127x_status_t sx127x_write_buffer( sx127x_t* radio, const uint8_t offset, cons
         {
             return SX127X_STATUS_ERROR;
         }
-        // Initialize LoRa FIFO handling registers
-        uint8_t reg_value = 0;
+        // Initialize LoRa FIFO handling registers in a single burst
+        // 0: SX127X_REG_LORA_FIFO_ADDR_PTR, 1: SX127X_REG_LORA_FIFO_TX_BASE_ADDR
+        uint8_t reg_values[2] = { 0, 0 };
 
-        if( sx127x_write_register( radio, SX127X_REG_LORA_FIFO_TX_BASE_ADDR, &reg_value, 1 ) != SX127X_STATUS_OK )
-        {
-            return SX127X_STATUS_ERROR;
-        }
-        if( sx127x_write_register( radio, SX127X_REG_LORA_FIFO_ADDR_PTR, &reg_value, 1 ) != SX127X_STATUS_OK )
+        if( sx127x_write_register( radio, SX127X_REG_LORA_FIFO_ADDR_PTR, reg_values, 2 ) != SX127X_STATUS_OK )
         {
             return SX127X_STATUS_ERROR;
         }
@@ -1588,42 +1595,8 @@ sx127x_status_t sx127x_get_gfsk_pkt_status( sx127x_t* radio, sx127x_gfsk_pkt_sta
 
 sx127x_status_t sx127x_get_lora_pkt_status( sx127x_t* radio, sx127x_lora_pkt_status_t* pkt_status )
 {
-    // 0: SX127X_REG_LORA_PACKET_SNR_VALUE, 1: SX127X_REG_LORA_PACKET_RSSI_VALUE
-    uint8_t reg_values[2];
-
-    if( sx127x_read_register( radio, SX127X_REG_LORA_PACKET_SNR_VALUE, reg_values, 2 ) != SX127X_STATUS_OK )
-    {
-        return SX127X_STATUS_ERROR;
-    }
-    // Returns SNR value [dB] rounded to the nearest integer value
-    pkt_status->snr_pkt_in_db = ( ( ( int8_t ) reg_values[0] ) + 2 ) >> 2;
-
-    if( pkt_status->snr_pkt_in_db < 0 )
-    {
-        if( radio->rf_freq_in_hz > RF_FREQUENCY_MID_BAND_THRESHOLD )
-        {
-            pkt_status->rssi_pkt_in_dbm =
-                RSSI_OFFSET_HF + reg_values[1] + ( reg_values[1] >> 4 ) + pkt_status->snr_pkt_in_db;
-        }
-        else
-        {
-            pkt_status->rssi_pkt_in_dbm =
-                RSSI_OFFSET_LF + reg_values[1] + ( reg_values[1] >> 4 ) + pkt_status->snr_pkt_in_db;
-        }
-    }
-    else
-    {
-        if( radio->rf_freq_in_hz > RF_FREQUENCY_MID_BAND_THRESHOLD )
-        {
-            pkt_status->rssi_pkt_in_dbm = RSSI_OFFSET_HF + reg_values[1] + ( reg_values[1] >> 4 );
-        }
-        else
-        {
-            pkt_status->rssi_pkt_in_dbm = RSSI_OFFSET_LF + reg_values[1] + ( reg_values[1] >> 4 );
-        }
-    }
-    // Unsupported feature - copy rssi_pkt_in_dbm
-    pkt_status->signal_rssi_pkt_in_db = pkt_status->rssi_pkt_in_dbm;
+    // Read along with the IRQ flags when the packet was received
+    *pkt_status = radio->lora_rx_status;
     return SX127X_STATUS_OK;
 }
 
@@ -2398,6 +2371,41 @@ static sx127x_status_t sx127x_update_lora_iq_inverted_regs( sx127x_t* radio, boo
     return SX127X_STATUS_OK;
 }
 
+static void sx127x_compute_lora_pkt_status( sx127x_t* radio, const uint8_t reg_values[2],
+                                            sx127x_lora_pkt_status_t* pkt_status )
+{
+    // 0: SX127X_REG_LORA_PACKET_SNR_VALUE, 1: SX127X_REG_LORA_PACKET_RSSI_VALUE
+    // Returns SNR value [dB] rounded to the nearest integer value
+    pkt_status->snr_pkt_in_db = ( ( ( int8_t ) reg_values[0] ) + 2 ) >> 2;
+
+    if( pkt_status->snr_pkt_in_db < 0 )
+    {
+        if( radio->rf_freq_in_hz > RF_FREQUENCY_MID_BAND_THRESHOLD )
+        {
+            pkt_status->rssi_pkt_in_dbm =
+                RSSI_OFFSET_HF + reg_values[1] + ( reg_values[1] >> 4 ) + pkt_status->snr_pkt_in_db;
+        }
+        else
+        {
+            pkt_status->rssi_pkt_in_dbm =
+                RSSI_OFFSET_LF + reg_values[1] + ( reg_values[1] >> 4 ) + pkt_status->snr_pkt_in_db;
+        }
+    }
+    else
+    {
+        if( radio->rf_freq_in_hz > RF_FREQUENCY_MID_BAND_THRESHOLD )
+        {
+            pkt_status->rssi_pkt_in_dbm = RSSI_OFFSET_HF + reg_values[1] + ( reg_values[1] >> 4 );
+        }
+        else
+        {
+            pkt_status->rssi_pkt_in_dbm = RSSI_OFFSET_LF + reg_values[1] + ( reg_values[1] >> 4 );
+        }
+    }
+    // Unsupported feature - copy rssi_pkt_in_dbm
+    pkt_status->signal_rssi_pkt_in_db = pkt_status->rssi_pkt_in_dbm;
+}
+
 static sx127x_status_t sx127x_re_start_rx_chain( sx127x_t* radio )
 {
     uint8_t reg_value;
@@ -2574,24 +2582,31 @@ static void dio_0_irq_lora_handler( sx127x_t* radio )
         ( radio->op_mode_irq == SX127X_REG_COMMON_OP_MODE_MODE_LORA_RX_SINGLE ) )
     {
         // RxDone interrupt
-        if( sx127x_clear_lora_irq_status( radio, SX127X_REG_LORA_IRQ_FLAGS_RX_DONE ) != SX127X_STATUS_OK )
+        // Read the FIFO pointer, the IRQ flags, the payload length and the packet status in a single burst
+        uint8_t reg_values[SX127X_REG_LORA_PACKET_RSSI_VALUE - SX127X_REG_LORA_FIFO_RX_CURRENT_ADDR + 1];
+        if( sx127x_read_register( radio, SX127X_REG_LORA_FIFO_RX_CURRENT_ADDR, reg_values, sizeof( reg_values ) ) !=
+            SX127X_STATUS_OK )
         {
             return;
         }
 
-        uint8_t irq_flags;
-        if( sx127x_get_lora_irq_status( radio, &irq_flags ) != SX127X_STATUS_OK )
+        // Clear RxDone and PayloadCrcError, if raised, at once
+        const uint8_t irq_flags = reg_values[SX127X_REG_LORA_IRQ_FLAGS - SX127X_REG_LORA_FIFO_RX_CURRENT_ADDR] &
+                                  ( SX127X_REG_LORA_IRQ_FLAGS_RX_DONE | SX127X_REG_LORA_IRQ_FLAGS_PAYLOAD_CRC_ERROR );
+        const bool is_crc_error =
+            ( irq_flags & SX127X_REG_LORA_IRQ_FLAGS_PAYLOAD_CRC_ERROR ) == SX127X_REG_LORA_IRQ_FLAGS_PAYLOAD_CRC_ERROR;
+
+        if( sx127x_clear_lora_irq_status( radio, irq_flags | SX127X_REG_LORA_IRQ_FLAGS_RX_DONE ) != SX127X_STATUS_OK )
         {
             return;
         }
 
-        if( ( irq_flags & SX127X_REG_LORA_IRQ_FLAGS_PAYLOAD_CRC_ERROR ) == SX127X_REG_LORA_IRQ_FLAGS_PAYLOAD_CRC_ERROR )
-        {
-            if( sx127x_clear_lora_irq_status( radio, SX127X_REG_LORA_IRQ_FLAGS_PAYLOAD_CRC_ERROR ) != SX127X_STATUS_OK )
-            {
-                return;
-            }
+        sx127x_compute_lora_pkt_status(
+            radio, &reg_values[SX127X_REG_LORA_PACKET_SNR_VALUE - SX127X_REG_LORA_FIFO_RX_CURRENT_ADDR],
+            &radio->lora_rx_status );
 
+        if( is_crc_error == true )
+        {
             if( sx127x_hal_timer_stop( radio ) != SX127X_HAL_STATUS_OK )
             {
                 return;
@@ -2602,18 +2617,10 @@ static void dio_0_irq_lora_handler( sx127x_t* radio )
             return;
         }
 
-        if( sx127x_read_register( radio, SX127X_REG_LORA_RX_NB_BYTES, &radio->lora_pkt_params.pld_len_in_bytes, 1 ) !=
-            SX127X_STATUS_OK )
-        {
-            return;
-        }
+        radio->lora_pkt_params.pld_len_in_bytes =
+            reg_values[SX127X_REG_LORA_RX_NB_BYTES - SX127X_REG_LORA_FIFO_RX_CURRENT_ADDR];
 
-        uint8_t reg_value;
-        if( sx127x_read_register( radio, SX127X_REG_LORA_FIFO_RX_CURRENT_ADDR, &reg_value, 1 ) != SX127X_STATUS_OK )
-        {
-            return;
-        }
-        if( sx127x_write_register( radio, SX127X_REG_LORA_FIFO_ADDR_PTR, &reg_value, 1 ) != SX127X_STATUS_OK )
+        if( sx127x_write_register( radio, SX127X_REG_LORA_FIFO_ADDR_PTR, &reg_values[0], 1 ) != SX127X_STATUS_OK )
         {
             return;
         }
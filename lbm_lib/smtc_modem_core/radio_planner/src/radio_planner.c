@@ -42,6 +42,8 @@
 #include "radio_planner.h"
 #include "smtc_duty_cycle.h"
 #include "smtc_modem_hal_dbg_trace.h"
+#include "smtc_modem_dbg_profile.h"
+#include "modem_perf_counters.h"
 #include "smtc_modem_hal.h"
 
 #if defined( ADD_LBM_GEOLOCATION )
@@ -59,6 +61,34 @@
 #define TARGET_RADIO rp->radio_target_attached_to_this_hook[rp->radio_task_id]
 #define TARGET_RAL_FOR_HOOK_ID &( rp->radio_target_attached_to_this_hook[hook_id]->ral )
 
+#if defined( ADD_RP_TRACE )
+#define RP_TRACE_ADD( type, hook_id, data ) rp_trace_add( &rp->trace, type, hook_id, ( uint16_t ) ( data ) )
+#else
+#define RP_TRACE_ADD( type, hook_id, data )
+#endif
+
+// The planner is locked while the engine context runs in it, the radio irq fast path is only taken when unlocked
+#if defined( ADD_RP_IRQ_FAST_PATH )
+#define RP_LOCK( rp ) ( ( rp )->lock_depth++ )
+#define RP_UNLOCK( rp ) ( ( rp )->lock_depth-- )
+#else
+#define RP_LOCK( rp )
+#define RP_UNLOCK( rp )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+#if defined( ADD_RP_MULTI_RADIO )
+static struct
+{
+    radio_planner_t* planners[RP_MULTI_RADIO_NB_PLANNERS];
+    uint8_t          nb_planners;
+} rp_multi_radio;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -70,7 +100,7 @@
  * @param rp  pointer to the radioplanner object itself
  * @param task pointer to the task that function free
  */
-static void rp_task_free( const radio_planner_t* rp, rp_task_t* task );
+static void rp_task_free( radio_planner_t* rp, rp_task_t* task );
 
 /**
  * @brief rp_task_update_time update task time
@@ -97,11 +127,67 @@ static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
 static void rp_irq_get_status( radio_planner_t* rp, const uint8_t hook_id );
 
 /**
- * @brief rp_task_compute_ranking compute the ranking of the different tasks inside the radio planner
+ * @brief rp_task_ranking_insert insert (or move) an enqueued task in the ranking according to its priority
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id id of the targeted hook
+ */
+static void rp_task_ranking_insert( radio_planner_t* rp, const uint8_t hook_id );
+
+/*!
+ * \brief Check if a task is ranked before another one
+ * \param [in] rp                      Pointer to the radio planner object
+ * \param [in] hook_id_a               Hook of the first task
+ * \param [in] hook_id_b               Hook of the second task
+ * \retval bool                        true if the task of hook_id_a has the highest priority
+ */
+static bool rp_task_is_ranked_before( const radio_planner_t* rp, const uint8_t hook_id_a, const uint8_t hook_id_b );
+
+/**
+ * @brief rp_task_ranking_remove remove a freed task from the ranking
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id id of the targeted hook
+ */
+static void rp_task_ranking_remove( radio_planner_t* rp, const uint8_t hook_id );
+
+#if defined( ADD_STACK_FAIRNESS )
+/**
+ * @brief rp_task_ranking_sort rank again the enqueued tasks when the stack fairness changed, the tasks of a same
+ *        priority already ranked follow the radio time used by their stacks
+ *
+ * @param rp pointer to the radioplanner object itself
+ */
+static void rp_task_ranking_sort( radio_planner_t* rp );
+#endif
+
+/**
+ * @brief rp_task_next_active return the first hook id greater than or equal to hook_id holding an enqueued task
  *
  * @param rp pointer to the radioplanner object itself
+ * @param hook_id first hook id to check
+ * @return uint8_t hook id, RP_NB_HOOKS if there is no more enqueued task
  */
-static void rp_task_compute_ranking( radio_planner_t* rp );
+static uint8_t rp_task_next_active( const radio_planner_t* rp, uint8_t hook_id );
+
+#if defined( ADD_RP_US_TIMEBASE )
+/**
+ * @brief rp_task_calibrate_launch_latency update the launch latency of a task type with the last launch
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param type type of the launched task
+ */
+static void rp_task_calibrate_launch_latency( radio_planner_t* rp, const rp_task_types_t type );
+#endif
+
+#if defined( ADD_RP_TIMED_TX )
+/**
+ * @brief rp_timed_tx_trigger send the Tx command of the running task, called by the radio trigger timer
+ *
+ * @param obj pointer to the radioplanner object itself
+ */
+static void rp_timed_tx_trigger( void* obj );
+#endif
 
 /**
  * @brief rp_task_launch_current call  the launch callback of the new running task
@@ -130,14 +216,6 @@ static uint8_t rp_task_select_next( radio_planner_t* rp, const uint32_t now );
  */
 static rp_next_state_status_t rp_task_get_next( radio_planner_t* rp, uint32_t* duration, uint8_t* task_id,
                                                 const uint32_t now );
-/**
- * @brief rp_task_find_highest_priority utilities to classify priority task (value 0 is the highest priority)
- *
- * @param vector a vector of value to classify from the lowest to the highest
- * @param length size of the vector
- * @return uint8_t index of the vector to indicate the position inside the vector of the minimum value
- */
-static uint8_t rp_task_find_highest_priority( uint8_t* vector, uint8_t length );
 
 /**
  * @brief rp_get_pkt_payload get the receive payload
@@ -178,6 +256,63 @@ static void rp_task_call_aborted( radio_planner_t* rp );
  */
 static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_t hook_id, const uint32_t time );
 
+/**
+ * @brief rp_task_enqueue_process see rp_task_enqueue, called with the planner locked
+ */
+static rp_hook_status_t rp_task_enqueue_process( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
+                                                 uint16_t payload_buffer_size, const rp_radio_params_t* radio_params );
+
+/**
+ * @brief rp_task_enqueue_check check that a task can be stored in the planner, called with the planner locked
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param task the task to be enqueued
+ * @return rp_hook_status_t RP_HOOK_STATUS_OK if the task can be stored
+ */
+static rp_hook_status_t rp_task_enqueue_check( radio_planner_t* rp, const rp_task_t* task );
+
+/**
+ * @brief rp_task_store copy a valid task in the planner and rank it, the arbitration is left to the caller
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param task the task to be enqueued
+ * @param payload buffer holding the data to be Tx/Rx
+ * @param payload_buffer_size Tx: size to be transmitted, Rx: maximum payload to be received
+ * @param radio_params radio parameters of the task
+ */
+static void rp_task_store( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
+                           uint16_t payload_buffer_size, const rp_radio_params_t* radio_params );
+
+/**
+ * @brief rp_task_abort_process see rp_task_abort, called with the planner locked
+ */
+static rp_hook_status_t rp_task_abort_process( radio_planner_t* rp, const uint8_t hook_id );
+
+/**
+ * @brief rp_callback_process see rp_callback, called with the planner locked
+ */
+static void rp_callback_process( radio_planner_t* rp );
+
+#if defined( ADD_RP_IRQ_FAST_PATH )
+/**
+ * @brief rp_irq_fast_path read the radio irq status in the interrupt context when the running task has the fast path
+ *        and the engine context is not in the planner, then release the radio and arm the next task if the task ended
+ *
+ * @param rp pointer to the radioplanner object itself
+ */
+static void rp_irq_fast_path( radio_planner_t* rp );
+
+/**
+ * @brief rp_irq_fast_path_task_goes_on tell if the status read ends the running task, same cases as
+ *        rp_callback_process
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param id hook id of the running task
+ * @return true if the hook callback decides how the task goes on
+ */
+static bool rp_irq_fast_path_task_goes_on( const radio_planner_t* rp, const uint8_t id );
+#endif
+
 /**
  * @brief rp_timer_irq_callback timer callback
  *
@@ -185,6 +320,32 @@ static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_
  */
 static void rp_timer_irq_callback( void* obj );
 
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+/**
+ * @brief rp_sync_timer_irq_callback sync word timer callback
+ *
+ * @param obj pointer to the radioplanner object itself
+ */
+static void rp_sync_timer_irq_callback( void* obj );
+
+/**
+ * @brief rp_sync_timeout close the running FSK window whose preamble has not been followed by a sync word
+ *
+ * @param rp pointer to the radioplanner object itself
+ */
+static void rp_sync_timeout( radio_planner_t* rp );
+
+/**
+ * @brief rp_sync_irq_get_status handle the preamble and sync word interrupts of a FSK window
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id id of the targeted hook
+ * @param radio_irq radio interrupts
+ * @return true if the status of the hook has been set
+ */
+static bool rp_sync_irq_get_status( radio_planner_t* rp, const uint8_t hook_id, const ral_irq_t radio_irq );
+#endif
+
 /**
  * @brief rp_hook_callback call the callback associated to the id
  *
@@ -201,6 +362,76 @@ static void rp_hook_callback( radio_planner_t* rp, uint8_t id );
  */
 static void rp_task_print( const radio_planner_t* rp, const rp_task_t* task );
 
+/**
+ * @brief rp_release_radio_resources release the antenna switch and the TCXO at the end of a radio task
+ *
+ * @param rp pointer to the radioplanner object itself
+ */
+static void rp_release_radio_resources( radio_planner_t* rp );
+
+/**
+ * @brief rp_task_get_priority compute the priority of a task, the lower the value the higher the priority
+ *
+ * @param task the task to be enqueued
+ * @return uint8_t priority of the task
+ */
+static uint8_t rp_task_get_priority( const rp_task_t* task );
+
+#if defined( ADD_RP_ADMISSION_CONTROL )
+/**
+ * @brief rp_task_find_conflict look for an enqueued task of higher priority overlapping a task
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param task the task to be enqueued
+ * @param start_time_ms start time of the task to be checked
+ * @param conflict_end_ms end time of the conflicting task, margin included
+ * @return true if a conflicting task has been found
+ */
+static bool rp_task_find_conflict( const radio_planner_t* rp, const rp_task_t* task, const uint32_t start_time_ms,
+                                   uint32_t* conflict_end_ms );
+#endif
+
+#if defined( ADD_RP_WARM_STANDBY )
+/**
+ * @brief rp_warm_radio_update put the radio left awake by the last task to sleep, unless the next task on this radio
+ * starts within its wake up cost (wake up time and TCXO startup), in which case it is kept in standby
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param has_next_task true if rp->timer_value and rp->timer_hook_id hold the next task
+ */
+static void rp_warm_radio_update( radio_planner_t* rp, bool has_next_task );
+#endif
+
+#if defined( ADD_RP_TASK_CHAIN )
+/**
+ * @brief rp_task_chain_next enqueue the first task chained behind the task of a hook, if the hook has no task
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id hook whose task ended
+ */
+static void rp_task_chain_next( radio_planner_t* rp, const uint8_t hook_id );
+
+/**
+ * @brief rp_task_chain_drop drop the tasks chained behind the task of a hook
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id hook id
+ */
+static void rp_task_chain_drop( radio_planner_t* rp, const uint8_t hook_id );
+#endif
+
+#if defined( ADD_RP_MULTI_RADIO )
+/**
+ * @brief rp_multi_radio_is_resource_used check if another registered planner runs a task using a shared resource
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param resource RP_SHARED_RESOURCE_* to check
+ * @param end_time_ms expected end time of the task using the resource, can be NULL
+ * @return true if the resource is used by another radio
+ */
+static bool rp_multi_radio_is_resource_used( const radio_planner_t* rp, uint32_t resource, uint32_t* end_time_ms );
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -208,6 +439,10 @@ static void rp_task_print( const radio_planner_t* rp, const rp_task_t* task );
 
 void rp_init( radio_planner_t* rp, const ralf_t* radio )
 {
+    modem_timer_stop( &rp->alarm_timer );
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    modem_timer_stop( &rp->sync_timer );
+#endif
     memset( rp, 0, sizeof( radio_planner_t ) );
     rp->radio = radio;
 
@@ -227,9 +462,30 @@ void rp_init( radio_planner_t* rp, const ralf_t* radio )
     rp->priority_task.type  = RP_TASK_TYPE_NONE;
     rp->priority_task.state = RP_TASK_STATE_FINISHED;
     rp_stats_init( &rp->stats );
-    rp->next_state_status = RP_STATUS_NO_MORE_TASK_SCHEDULE;
-    rp->margin_delay      = RP_MARGIN_DELAY;
-    rp->disable_failsafe  = 0;
+#if defined( ADD_RP_TRACE )
+    rp_trace_init( &rp->trace );
+#endif
+    rp->next_state_status  = RP_STATUS_NO_MORE_TASK_SCHEDULE;
+    rp->margin_delay       = RP_MARGIN_DELAY;
+    rp->disable_failsafe   = 0;
+    rp->hook_callback_done = NULL;
+#if defined( ADD_RP_WARM_STANDBY )
+    rp->warm_radio      = NULL;
+    rp->warm_radio_kept = false;
+#endif
+#if defined( ADD_RP_US_TIMEBASE )
+    for( int32_t i = 0; i < RP_TASK_TYPE_NONE; i++ )
+    {
+        rp->launch_latency_us[i] = RP_LAUNCH_LATENCY_US;
+    }
+#endif
+#if defined( ADD_STACK_FAIRNESS )
+    memset( rp->hook_stack_id, RP_NO_STACK, sizeof( rp->hook_stack_id ) );
+    memset( rp->stack_weight, 1, sizeof( rp->stack_weight ) );
+#endif
+#if defined( ADD_RP_IRQ_FAST_PATH )
+    rp->irq_fast_path_ended_id = RP_NB_HOOKS;
+#endif
 }
 rp_hook_status_t rp_attach_new_radio( radio_planner_t* rp, const ralf_t* radio, const uint8_t hook_id )
 {
@@ -265,6 +521,11 @@ rp_hook_status_t rp_hook_init( radio_planner_t* rp, const uint8_t id, void ( *ca
     return RP_HOOK_STATUS_OK;
 }
 
+void rp_set_hook_callback_done( radio_planner_t* rp, void ( *callback )( void ) )
+{
+    rp->hook_callback_done = callback;
+}
+
 rp_hook_status_t rp_release_hook( radio_planner_t* rp, uint8_t id )
 {
     if( id >= RP_NB_HOOKS )
@@ -275,6 +536,9 @@ rp_hook_status_t rp_release_hook( radio_planner_t* rp, uint8_t id )
 
     rp->hook_callbacks[id]                   = NULL;
     rp->tasks[id].schedule_task_low_priority = false;
+#if defined( ADD_RP_TASK_CHAIN )
+    rp_task_chain_drop( rp, id );
+#endif
     return RP_HOOK_STATUS_OK;
 }
 
@@ -294,6 +558,30 @@ rp_hook_status_t rp_hook_get_id( const radio_planner_t* rp, const void* hook, ui
 
 rp_hook_status_t rp_task_enqueue( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
                                   uint16_t payload_buffer_size, const rp_radio_params_t* radio_params )
+{
+    RP_LOCK( rp );
+    rp_hook_status_t status = rp_task_enqueue_process( rp, task, payload, payload_buffer_size, radio_params );
+    RP_UNLOCK( rp );
+    return status;
+}
+
+static rp_hook_status_t rp_task_enqueue_process( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
+                                                 uint16_t payload_buffer_size, const rp_radio_params_t* radio_params )
+{
+    rp_hook_status_t status = rp_task_enqueue_check( rp, task );
+    if( status != RP_HOOK_STATUS_OK )
+    {
+        return status;
+    }
+    rp_task_store( rp, task, payload, payload_buffer_size, radio_params );
+    if( rp->radio_irq_flag == false )
+    {
+        rp_task_arbiter( rp, __func__ );
+    }
+    return RP_HOOK_STATUS_OK;
+}
+
+static rp_hook_status_t rp_task_enqueue_check( radio_planner_t* rp, const rp_task_t* task )
 {
     uint8_t hook_id = task->hook_id;
     if( hook_id >= RP_NB_HOOKS )
@@ -339,30 +627,83 @@ rp_hook_status_t rp_task_enqueue( radio_planner_t* rp, const rp_task_t* task, ui
     {
         SMTC_MODEM_HAL_TRACE_PRINTF( " RP: WARNING Task is already running\n" );
     }
-    rp->status[hook_id]              = RP_STATUS_TASK_INIT;
-    rp->tasks[hook_id]               = *task;
-    rp->radio_params[hook_id]        = *radio_params;
-    rp->payload[hook_id]             = payload;
-    rp->payload_buffer_size[hook_id] = payload_buffer_size;
-    if( rp->tasks[hook_id].schedule_task_low_priority == true )
+#if defined( ADD_RP_ADMISSION_CONTROL )
+    uint32_t conflict_end_ms;
+    if( ( task->state == RP_TASK_STATE_SCHEDULE ) && ( task->admission_check == true ) &&
+        ( rp_task_find_conflict( rp, task, task->start_time_ms, &conflict_end_ms ) == true ) )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( " RP: Task #%u enqueue refused. Task is in conflict until %u\n", hook_id,
+                                     conflict_end_ms );
+        return RP_TASK_STATUS_SCHEDULE_TASK_IN_CONFLICT;
+    }
+#endif
+    return RP_HOOK_STATUS_OK;
+}
+
+#if defined( ADD_RP_TASK_CHAIN )
+rp_hook_status_t rp_task_enqueue_chained( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
+                                          uint16_t payload_buffer_size, const rp_radio_params_t* radio_params )
+{
+    uint8_t hook_id = task->hook_id;
+    if( hook_id >= RP_NB_HOOKS )
+    {
+        SMTC_MODEM_HAL_PANIC( );
+        return RP_HOOK_STATUS_ID_ERROR;
+    }
+    if( ( task->launch_task_callbacks == NULL ) || ( rp->hook_callbacks[hook_id] == NULL ) ||
+        ( task->state > RP_TASK_STATE_ASAP ) )
     {
-        rp->tasks[hook_id].priority = ( RP_TASK_STATE_ASAP * RP_NB_HOOKS ) + hook_id;
+        SMTC_MODEM_HAL_PANIC( " task invalid\n" );
+        return RP_HOOK_STATUS_ID_ERROR;
+    }
+
+    RP_LOCK( rp );
+    rp_hook_status_t status = RP_HOOK_STATUS_OK;
+    if( ( rp->tasks[hook_id].state == RP_TASK_STATE_FINISHED ) && ( rp_task_get_chained_nb( rp, hook_id ) == 0 ) )
+    {
+        status = rp_task_enqueue_process( rp, task, payload, payload_buffer_size, radio_params );
+    }
+    else if( rp->chain_size >= RP_TASK_CHAIN_NB_TASKS )
+    {
+        SMTC_MODEM_HAL_TRACE_PRINTF( " RP: Task #%u chain impossible. No more room\n", hook_id );
+        status = RP_TASK_STATUS_NO_FREE_SLOT;
     }
     else
     {
-        rp->tasks[hook_id].priority = ( rp->tasks[hook_id].state * RP_NB_HOOKS ) + hook_id;
+        rp_chained_task_t* chained   = &rp->chain[rp->chain_size++];
+        chained->task                = *task;
+        chained->radio_params        = *radio_params;
+        chained->payload             = payload;
+        chained->payload_buffer_size = payload_buffer_size;
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "RP: Task #%u chained\n", hook_id );
     }
-    rp->tasks[hook_id].start_time_init_ms = rp->tasks[hook_id].start_time_ms;
-    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "RP: Task #%u enqueue with #%u priority\n", hook_id, rp->tasks[hook_id].priority );
-    rp_task_compute_ranking( rp );
-    if( rp->radio_irq_flag == false )
+    RP_UNLOCK( rp );
+    return status;
+}
+
+uint8_t rp_task_get_chained_nb( const radio_planner_t* rp, const uint8_t hook_id )
+{
+    uint8_t nb = 0;
+    for( uint8_t i = 0; i < rp->chain_size; i++ )
     {
-        rp_task_arbiter( rp, __func__ );
+        if( rp->chain[i].task.hook_id == hook_id )
+        {
+            nb++;
+        }
     }
-    return RP_HOOK_STATUS_OK;
+    return nb;
 }
+#endif
 
 rp_hook_status_t rp_task_abort( radio_planner_t* rp, const uint8_t hook_id )
+{
+    RP_LOCK( rp );
+    rp_hook_status_t status = rp_task_abort_process( rp, hook_id );
+    RP_UNLOCK( rp );
+    return status;
+}
+
+static rp_hook_status_t rp_task_abort_process( radio_planner_t* rp, const uint8_t hook_id )
 {
     SMTC_MODEM_HAL_RP_TRACE_PRINTF( "RP: rp_task_abort #%d\n", hook_id );
     if( hook_id >= RP_NB_HOOKS )
@@ -370,6 +711,10 @@ rp_hook_status_t rp_task_abort( radio_planner_t* rp, const uint8_t hook_id )
         SMTC_MODEM_HAL_PANIC( );
         return RP_HOOK_STATUS_ID_ERROR;
     }
+#if defined( ADD_RP_TASK_CHAIN )
+    // A running task ends as if it was done, the sequence shall not go on
+    rp_task_chain_drop( rp, hook_id );
+#endif
 
     if( rp->tasks[hook_id].state > RP_TASK_STATE_ABORTED )
     {
@@ -378,6 +723,10 @@ rp_hook_status_t rp_task_abort( radio_planner_t* rp, const uint8_t hook_id )
 
     if( rp->tasks[hook_id].state == RP_TASK_STATE_RUNNING )
     {
+#if defined( ADD_RP_TIMED_TX )
+        // A Tx command not sent yet shall not be sent after the abort
+        smtc_modem_hal_stop_radio_trigger_timer( );
+#endif
 #if defined( ADD_LBM_GEOLOCATION )
         if( ( hook_id == RP_HOOK_ID_DIRECT_RP_ACCESS_GNSS ) ||
             ( hook_id == RP_HOOK_ID_DIRECT_RP_ACCESS_GNSS_ALMANAC ) || ( hook_id == RP_HOOK_ID_DIRECT_RP_ACCESS_WIFI ) )
@@ -404,6 +753,93 @@ rp_hook_status_t rp_task_abort( radio_planner_t* rp, const uint8_t hook_id )
     return RP_HOOK_STATUS_OK;
 }
 
+void rp_task_wait_start_time( radio_planner_t* rp, const uint8_t hook_id )
+{
+#if defined( ADD_RAL_BATCH )
+    // Send the configuration recorded since the launch before waiting, only the timed command remains after the wait
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_batch_commit( TARGET_RAL_FOR_HOOK_ID ) != RAL_STATUS_ERROR );
+#endif
+#if defined( ADD_RP_US_TIMEBASE )
+    int32_t offset_us = rp->tasks[hook_id].start_time_us;
+
+    if( rp->tasks[hook_id].type < RP_TASK_TYPE_NONE )
+    {
+        offset_us -= rp->launch_latency_us[rp->tasks[hook_id].type];
+    }
+
+    // Split the target in a millisecond edge and a microsecond delay after this edge
+    int32_t  edge_offset_ms = ( offset_us >= 0 ) ? ( offset_us / 1000 ) : -( ( 999 - offset_us ) / 1000 );
+    uint32_t edge_ms        = rp->tasks[hook_id].start_time_ms + edge_offset_ms;
+    uint32_t delay_us       = ( uint32_t ) ( offset_us - ( edge_offset_ms * 1000 ) );
+
+    // If the edge is already reached the task is late, launch it right now
+    if( ( int32_t ) ( edge_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
+    {
+        // Waiting the edge aligns the microsecond timebase on the millisecond one
+        while( ( int32_t ) ( edge_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
+        {
+        }
+        uint32_t edge_us = smtc_modem_hal_get_time_in_us( );
+        while( ( smtc_modem_hal_get_time_in_us( ) - edge_us ) < delay_us )
+        {
+        }
+    }
+    rp->launch_timestamp_us    = smtc_modem_hal_get_time_in_us( );
+    rp->launch_timestamp_valid = true;
+#else
+    while( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
+    {
+    }
+#endif
+}
+
+#if defined( ADD_RP_TIMED_TX )
+void rp_task_start_tx_at_start_time( radio_planner_t* rp, const uint8_t hook_id )
+{
+#if defined( ADD_RAL_BATCH )
+    // The trigger only sends the Tx command, the whole configuration shall be in the radio before
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_batch_commit( TARGET_RAL_FOR_HOOK_ID ) != RAL_STATUS_ERROR );
+#endif
+    // Both timebases count the same clock: the microsecond time of a millisecond edge is this edge times 1000,
+    // modulo 2^32
+    uint32_t target_us = ( rp->tasks[hook_id].start_time_ms * 1000 ) + ( uint32_t ) rp->tasks[hook_id].start_time_us;
+
+    if( rp->tasks[hook_id].type < RP_TASK_TYPE_NONE )
+    {
+        target_us -= rp->launch_latency_us[rp->tasks[hook_id].type];
+    }
+
+    int32_t delay_us = ( int32_t ) ( target_us - smtc_modem_hal_get_time_in_us( ) );
+
+    if( delay_us > RP_TIMED_TX_MIN_DELAY_US )
+    {
+        smtc_modem_hal_start_radio_trigger_timer( ( uint32_t ) delay_us, rp_timed_tx_trigger, rp );
+    }
+    else
+    {
+        // Too close or late, the task is started right now
+        rp_timed_tx_trigger( rp );
+    }
+}
+
+static void rp_timed_tx_trigger( void* obj )
+{
+    radio_planner_t* rp = ( radio_planner_t* ) obj;
+
+    // The launch latency is calibrated on the trigger to Tx command path, not on the launch callback
+    rp->launch_timestamp_us    = smtc_modem_hal_get_time_in_us( );
+    rp->launch_timestamp_valid = true;
+
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( true );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_tx( TARGET_RAL ) == RAL_STATUS_OK );
+    rp_stats_set_tx_timestamp( &rp->stats, smtc_modem_hal_get_time_in_ms( ) );
+
+    rp_task_calibrate_launch_latency( rp, rp->tasks[rp->radio_task_id].type );
+    rp->launch_timestamp_valid = false;
+}
+#endif
+
 void rp_get_status( const radio_planner_t* rp, const uint8_t id, uint32_t* irq_timestamp_ms, rp_status_t* status )
 {
     if( id >= RP_NB_HOOKS )
@@ -431,17 +867,101 @@ rp_stats_t rp_get_stats( const radio_planner_t* rp )
     return rp->stats;
 }
 
-void rp_callback( radio_planner_t* rp )
+#if defined( ADD_RP_ADMISSION_CONTROL )
+rp_hook_status_t rp_get_free_slot( const radio_planner_t* rp, const rp_task_t* task, const uint32_t window_ms,
+                                   uint32_t* start_time_ms )
 {
-    if( ( rp->tasks[rp->radio_task_id].state == RP_TASK_STATE_RUNNING ) &&
-        ( rp->disable_failsafe != RP_DISABLE_FAILSAFE_KEY ) &&
-        ( ( int32_t ) ( rp->tasks[rp->radio_task_id].start_time_ms + 128000 - smtc_modem_hal_get_time_in_ms( ) ) < 0 ) )
+    uint32_t candidate_ms = task->start_time_ms;
+    uint32_t conflict_end_ms;
+
+    // Each conflicting task moves the candidate after its end, so the search ends within the number of enqueued tasks
+    for( uint8_t i = 0; i <= rp->rankings_size; i++ )
     {
-        SMTC_MODEM_HAL_PANIC( "RP_FAILSAFE - #%d\n", rp->radio_task_id );
+        if( rp_task_find_conflict( rp, task, candidate_ms, &conflict_end_ms ) == false )
+        {
+            *start_time_ms = candidate_ms;
+            return RP_HOOK_STATUS_OK;
+        }
+        candidate_ms = conflict_end_ms;
+        if( ( candidate_ms - task->start_time_ms ) > window_ms )
+        {
+            break;
+        }
     }
-    if( ( rp->radio_irq_flag == false ) && ( rp->timer_irq_flag == false ) )
-    {
-        return;
+    return RP_TASK_STATUS_NO_FREE_SLOT;
+}
+#endif
+
+uint32_t rp_get_next_task_delay_ms( const radio_planner_t* rp )
+{
+    uint32_t now      = smtc_modem_hal_get_time_in_ms( );
+    uint32_t delay_ms = UINT32_MAX;
+
+    for( uint8_t i = 0; i < RP_NB_HOOKS; i++ )
+    {
+        if( ( rp->tasks[i].state == RP_TASK_STATE_RUNNING ) || ( rp->tasks[i].state == RP_TASK_STATE_ASAP ) )
+        {
+            return 0;
+        }
+        if( rp->tasks[i].state == RP_TASK_STATE_SCHEDULE )
+        {
+            int32_t task_delay_ms = ( int32_t ) ( rp->tasks[i].start_time_ms - now );
+            if( task_delay_ms <= 0 )
+            {
+                return 0;
+            }
+            if( ( uint32_t ) task_delay_ms < delay_ms )
+            {
+                delay_ms = task_delay_ms;
+            }
+        }
+    }
+    return delay_ms;
+}
+
+void rp_callback( radio_planner_t* rp )
+{
+    RP_LOCK( rp );
+#if defined( ADD_RP_IRQ_FAST_PATH )
+    if( rp->irq_fast_path_ended_id != RP_NB_HOOKS )
+    {
+        // The task ended in the radio interrupt, the end of the irq processing of rp_callback_process is done here
+        const uint8_t hook_id      = rp->irq_fast_path_ended_id;
+        rp->irq_fast_path_ended_id = RP_NB_HOOKS;
+        rp_hook_callback( rp, hook_id );
+        rp_task_call_aborted( rp );
+        rp_task_arbiter( rp, __func__ );
+    }
+    else if( rp->aborted_call_pending == true )
+    {
+        rp_task_call_aborted( rp );
+    }
+#endif
+    rp_callback_process( rp );
+    RP_UNLOCK( rp );
+}
+
+static void rp_callback_process( radio_planner_t* rp )
+{
+    if( ( rp->tasks[rp->radio_task_id].state == RP_TASK_STATE_RUNNING ) &&
+        ( rp->disable_failsafe != RP_DISABLE_FAILSAFE_KEY ) &&
+#if defined( ADD_RP_RX_CONTINUOUS )
+        ( rp->tasks[rp->radio_task_id].rx_continuous == false ) &&
+#endif
+        ( ( int32_t ) ( rp->tasks[rp->radio_task_id].start_time_ms + 128000 - smtc_modem_hal_get_time_in_ms( ) ) < 0 ) )
+    {
+        SMTC_MODEM_HAL_PANIC( "RP_FAILSAFE - #%d\n", rp->radio_task_id );
+    }
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    if( rp->sync_timer_flag == true )
+    {
+        rp->sync_timer_flag = false;
+        rp_sync_timeout( rp );
+    }
+#endif
+    if( ( rp->radio_irq_flag == false ) && ( rp->timer_irq_flag == false ) )
+    {
+        return;
     }
     if( ( rp->radio_irq_flag == false ) && ( rp->timer_irq_flag == true ) )
     {
@@ -452,16 +972,35 @@ void rp_callback( radio_planner_t* rp )
     if( rp->radio_irq_flag == true )
     {
         rp->radio_irq_flag = false;
+#if defined( ADD_RP_IRQ_FAST_PATH )
+        // The status has been read by rp_irq_fast_path() when the task goes on, the radio irq is cleared already
+        const bool status_read        = rp->irq_fast_path_status_read;
+        rp->irq_fast_path_status_read = false;
+#else
+        const bool status_read = false;
+#endif
         if( rp->tasks[rp->radio_task_id].state < RP_TASK_STATE_ABORTED )
         {
             SMTC_MODEM_HAL_RP_TRACE_PRINTF( " RP: INFO - Radio IRQ received for hook #%u\n", rp->radio_task_id );
 
-            rp_irq_get_status( rp, rp->radio_task_id );
+            if( status_read == false )
+            {
+                SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_RP_IRQ_STATUS );
+                rp_irq_get_status( rp, rp->radio_task_id );
+                SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_RP_IRQ_STATUS );
+                RP_TRACE_ADD( RP_TRACE_EVENT_IRQ, rp->radio_task_id, rp->status[rp->radio_task_id] );
+            }
 
             if( rp->status[rp->radio_task_id] == RP_STATUS_LR_FHSS_HOP )
             {
                 return;
             }
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+            if( rp->status[rp->radio_task_id] == RP_STATUS_RX_ONGOING )
+            {
+                return;
+            }
+#endif
 
             // Compute statistics after LR-FHSS hopping interrupts to have the correct TOA and not only by hop
             rp_consumption_statistics_updated( rp, rp->radio_task_id, rp->irq_timestamp_ms[rp->radio_task_id] );
@@ -484,6 +1023,30 @@ void rp_callback( radio_planner_t* rp )
                 return;
             }
 
+            // No activity, the task goes on with a CAD on the next channel started by the hook
+            if( ( rp->status[rp->radio_task_id] == RP_STATUS_CAD_NEGATIVE ) &&
+                ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_CAD_TO_RX ) &&
+                ( rp->tasks[rp->radio_task_id].cad_sweep_hops > 0 ) )
+            {
+                rp->tasks[rp->radio_task_id].cad_sweep_hops--;
+                rp->radio = TARGET_RADIO;
+                rp_hook_callback( rp, rp->radio_task_id );
+                return;
+            }
+
+#if defined( ADD_RP_RX_CONTINUOUS )
+            // The radio is still receiving, the task goes on and its rx time is counted again from this packet
+            if( ( rp->tasks[rp->radio_task_id].rx_continuous == true ) &&
+                ( ( rp->status[rp->radio_task_id] == RP_STATUS_RX_PACKET ) ||
+                  ( rp->status[rp->radio_task_id] == RP_STATUS_RX_CRC_ERROR ) ) )
+            {
+                rp_stats_set_rx_timestamp( &rp->stats, rp->irq_timestamp_ms[rp->radio_task_id] );
+                rp->radio = TARGET_RADIO;
+                rp_hook_callback( rp, rp->radio_task_id );
+                return;
+            }
+#endif
+
             if( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_BLE_SCAN )
             {
                 if( ( rp->status[rp->radio_task_id] == RP_STATUS_RX_PACKET ) ||
@@ -498,9 +1061,22 @@ void rp_callback( radio_planner_t* rp )
             // Have to call rp_task_free before rp_hook_callback because the callback can enqueued a task and so call
             // the arbiter
             rp_task_free( rp, &rp->tasks[rp->radio_task_id] );
+#if defined( ADD_RP_WARM_STANDBY )
+            // The arbiter puts the radio to sleep once the next task is known
+            rp->warm_radio      = TARGET_RADIO;
+            rp->warm_radio_kept = false;
+#else
             SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_sleep( TARGET_RAL, true ) == RAL_STATUS_OK );
+#endif
             rp->radio = TARGET_RADIO;
+#if defined( ADD_RP_TASK_CHAIN )
+            const uint8_t hook_id = rp->radio_task_id;
+            rp_hook_callback( rp, hook_id );
+            // The next task of the sequence is ranked before the arbitration below, which then launches it
+            rp_task_chain_next( rp, hook_id );
+#else
             rp_hook_callback( rp, rp->radio_task_id );
+#endif
 
             rp_task_call_aborted( rp );
 
@@ -515,12 +1091,13 @@ void rp_callback( radio_planner_t* rp )
                 SMTC_MODEM_HAL_PANIC_ON_FAILURE(
                     ral_set_sleep( &( rp->radio_target_attached_to_this_hook[i]->ral ), true ) == RAL_STATUS_OK );
             }
+#if defined( ADD_RP_WARM_STANDBY )
+            rp->warm_radio = NULL;
+#endif
             SMTC_MODEM_HAL_TRACE_PRINTF( " radio planner it but no more task activated\n" );
         }
 
-        smtc_modem_hal_set_ant_switch( false );
-        // Shut Down the TCXO
-        smtc_modem_hal_stop_radio_tcxo( );
+        rp_release_radio_resources( rp );
     }
 }
 
@@ -531,11 +1108,121 @@ bool rp_get_irq_flag( void* obj )
     {
         return true;
     }
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    else if( rp->sync_timer_flag == true )
+    {
+        return true;
+    }
+#endif
+#if defined( ADD_RP_IRQ_FAST_PATH )
+    else if( ( rp->aborted_call_pending == true ) || ( rp->irq_fast_path_ended_id != RP_NB_HOOKS ) )
+    {
+        return true;
+    }
+#endif
     else
     {
         return false;
     }
 }
+#if defined( ADD_RP_MULTI_RADIO )
+rp_hook_status_t rp_multi_radio_register( radio_planner_t* rp, uint32_t shared_resources )
+{
+    for( uint8_t i = 0; i < rp_multi_radio.nb_planners; i++ )
+    {
+        if( rp_multi_radio.planners[i] == rp )
+        {
+            rp->shared_resources = shared_resources;
+            return RP_HOOK_STATUS_OK;
+        }
+    }
+    if( rp_multi_radio.nb_planners >= RP_MULTI_RADIO_NB_PLANNERS )
+    {
+        return RP_HOOK_STATUS_ID_ERROR;
+    }
+    rp->shared_resources       = shared_resources;
+    rp->multi_radio_registered = true;
+
+    rp_multi_radio.planners[rp_multi_radio.nb_planners++] = rp;
+    return RP_HOOK_STATUS_OK;
+}
+
+void rp_multi_radio_callback( void )
+{
+    for( uint8_t i = 0; i < rp_multi_radio.nb_planners; i++ )
+    {
+        rp_callback( rp_multi_radio.planners[i] );
+    }
+}
+
+bool rp_multi_radio_get_irq_flag( void )
+{
+    for( uint8_t i = 0; i < rp_multi_radio.nb_planners; i++ )
+    {
+        if( rp_get_irq_flag( rp_multi_radio.planners[i] ) == true )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+#if defined( ADD_STACK_FAIRNESS )
+rp_hook_status_t rp_hook_set_stack_id( radio_planner_t* rp, uint8_t hook_id, uint8_t stack_id )
+{
+    if( ( hook_id >= RP_NB_HOOKS ) || ( ( stack_id != RP_NO_STACK ) && ( stack_id >= NUMBER_OF_STACKS ) ) ||
+        ( ( stack_id != RP_NO_STACK ) && ( stack_id > hook_id ) ) )
+    {
+        return RP_HOOK_STATUS_ID_ERROR;
+    }
+    rp->hook_stack_id[hook_id] = stack_id;
+    return RP_HOOK_STATUS_OK;
+}
+
+rp_hook_status_t rp_set_stack_weight( radio_planner_t* rp, uint8_t stack_id, uint8_t weight )
+{
+    if( ( stack_id >= NUMBER_OF_STACKS ) || ( weight == 0 ) )
+    {
+        return RP_HOOK_STATUS_ID_ERROR;
+    }
+    rp->stack_weight[stack_id] = weight;
+    rp_task_ranking_sort( rp );
+    return RP_HOOK_STATUS_OK;
+}
+
+uint32_t rp_get_stack_airtime_ms( const radio_planner_t* rp, uint8_t stack_id )
+{
+    return ( stack_id < NUMBER_OF_STACKS ) ? rp->stack_airtime_ms[stack_id] : 0;
+}
+
+bool rp_is_stack_served_before( const radio_planner_t* rp, uint8_t stack_id_a, uint8_t stack_id_b )
+{
+    // airtime_a / weight_a < airtime_b / weight_b without division
+    return ( ( uint64_t ) rp->stack_airtime_ms[stack_id_a] * rp->stack_weight[stack_id_b] ) <
+           ( ( uint64_t ) rp->stack_airtime_ms[stack_id_b] * rp->stack_weight[stack_id_a] );
+}
+#endif
+
+#if defined( ADD_RP_IRQ_FAST_PATH )
+rp_hook_status_t rp_hook_set_irq_fast_path( radio_planner_t* rp, const uint8_t hook_id, bool enable )
+{
+    if( hook_id >= RP_NB_HOOKS )
+    {
+        return RP_HOOK_STATUS_ID_ERROR;
+    }
+    if( enable == true )
+    {
+        rp->irq_fast_path_hooks[hook_id / 32] |= ( uint32_t ) 1 << ( hook_id % 32 );
+    }
+    else
+    {
+        rp->irq_fast_path_hooks[hook_id / 32] &= ~( ( uint32_t ) 1 << ( hook_id % 32 ) );
+    }
+    return RP_HOOK_STATUS_OK;
+}
+#endif
+
 void rp_disable_failsafe( radio_planner_t* rp, bool disable )
 {
     if( disable == true )
@@ -552,10 +1239,21 @@ void rp_disable_failsafe( radio_planner_t* rp, bool disable )
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
-static void rp_task_free( const radio_planner_t* rp, rp_task_t* task )
+static void rp_task_free( radio_planner_t* rp, rp_task_t* task )
 {
+    rp_task_ranking_remove( rp, ( uint8_t ) ( task - rp->tasks ) );
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    if( ( uint8_t ) ( task - rp->tasks ) == rp->sync_timer_hook_id )
+    {
+        modem_timer_stop( &rp->sync_timer );
+        rp->sync_timer_flag = false;
+        rp->sync_timed_out  = false;
+    }
+#endif
+
     task->hook_id            = RP_NB_HOOKS;
     task->start_time_ms      = 0;
+    task->start_time_us      = 0;
     task->start_time_init_ms = 0;
     task->duration_time_ms   = 0;
     //   task->type               = RP_TASK_TYPE_NONE; doesn't clear for suspend feature
@@ -563,15 +1261,36 @@ static void rp_task_free( const radio_planner_t* rp, rp_task_t* task )
     task->schedule_task_low_priority = false;
 }
 
+static void rp_task_store( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
+                           uint16_t payload_buffer_size, const rp_radio_params_t* radio_params )
+{
+    uint8_t hook_id = task->hook_id;
+
+    rp->status[hook_id]              = RP_STATUS_TASK_INIT;
+    rp->tasks[hook_id]               = *task;
+    rp->radio_params[hook_id]        = *radio_params;
+    rp->payload[hook_id]             = payload;
+    rp->payload_buffer_size[hook_id] = payload_buffer_size;
+    // Keep the sub-millisecond part of the start time below 1 ms
+    rp->tasks[hook_id].start_time_ms += rp->tasks[hook_id].start_time_us / 1000;
+    rp->tasks[hook_id].start_time_us %= 1000;
+    rp->tasks[hook_id].priority = rp_task_get_priority( &rp->tasks[hook_id] );
+    rp->tasks[hook_id].start_time_init_ms = rp->tasks[hook_id].start_time_ms;
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "RP: Task #%u enqueue with #%u priority\n", hook_id, rp->tasks[hook_id].priority );
+    rp_task_ranking_insert( rp, hook_id );
+    RP_TRACE_ADD( RP_TRACE_EVENT_ENQUEUE, hook_id, ( rp->tasks[hook_id].type << 8 ) | rp->tasks[hook_id].state );
+}
+
 static void rp_task_update_time( radio_planner_t* rp, uint32_t now )
 {
-    for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
+    for( uint8_t i = rp_task_next_active( rp, 0 ); i < RP_NB_HOOKS; i = rp_task_next_active( rp, i + 1 ) )
     {
         if( rp->tasks[i].state == RP_TASK_STATE_ASAP )
         {
             if( ( int32_t ) ( now - rp->tasks[i].start_time_ms ) > 0 )
             {
                 rp->tasks[i].start_time_ms = now + RP_MCU_FAIRNESS_DELAY_MS;
+                rp->tasks[i].start_time_us = 0;
             }
 
             // An asap task is automatically switch in schedule task after RP_TASK_ASAP_TO_SCHEDULE_TRIG_TIME ms
@@ -580,11 +1299,12 @@ static void rp_task_update_time( radio_planner_t* rp, uint32_t now )
                 rp->tasks[i].state = RP_TASK_STATE_SCHEDULE;
                 // Schedule the task at (now + RP_TASK_RE_SCHEDULE_OFFSET_TIME) seconds
                 rp->tasks[i].start_time_ms = now + RP_TASK_RE_SCHEDULE_OFFSET_TIME;
+                rp->tasks[i].start_time_us = 0;
                 rp->tasks[i].priority      = ( rp->tasks[i].state * RP_NB_HOOKS ) + i;
                 SMTC_MODEM_HAL_TRACE_WARNING(
                     "RP: SWITCH TASK #%d FROM ASAP TO SCHEDULED (start_time_init_ms:%u, now:%u, diff:%d)\n", i,
                     rp->tasks[i].start_time_init_ms, now, ( int32_t ) ( now - rp->tasks[i].start_time_init_ms ) );
-                rp_task_compute_ranking( rp );
+                rp_task_ranking_insert( rp, i );
             }
         }
     }
@@ -593,7 +1313,8 @@ static void rp_task_update_time( radio_planner_t* rp, uint32_t now )
         ( ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_LORA ) ||
           ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_FSK ) ||
           ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_BLE ) ||
-          ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_BLE_SCAN ) ) )
+          ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_BLE_SCAN ) ||
+          ( rp->tasks[rp->radio_task_id].type == RP_TASK_TYPE_RX_FLRC ) ) )
     {
         rp->tasks[rp->radio_task_id].duration_time_ms =
             now + rp->margin_delay + 2 - rp->tasks[rp->radio_task_id].start_time_ms;
@@ -601,7 +1322,7 @@ static void rp_task_update_time( radio_planner_t* rp, uint32_t now )
         {
             rp->tasks[rp->radio_task_id].schedule_task_low_priority = false;
             rp->tasks[rp->radio_task_id].priority = ( RP_TASK_STATE_SCHEDULE * RP_NB_HOOKS ) + rp->radio_task_id;
-            rp_task_compute_ranking( rp );
+            rp_task_ranking_insert( rp, rp->radio_task_id );
         }
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( " RP: Extended duration of radio task #%u time to %lu ms\n", rp->radio_task_id,
                                         now );
@@ -610,6 +1331,7 @@ static void rp_task_update_time( radio_planner_t* rp, uint32_t now )
 
 static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
 {
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_RP_ARBITER );
     uint32_t now = smtc_modem_hal_get_time_in_ms( );
     // Update time for ASAP task to now. But, also extended duration in case of running task is a RX task
     rp_task_update_time( rp, now );
@@ -623,6 +1345,8 @@ static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
             "%u\n ",
             caller_func_name, rp->priority_task.hook_id, rp->timer_hook_id, delay, now,
             rp->priority_task.start_time_ms );
+        RP_TRACE_ADD( RP_TRACE_EVENT_ARBITER, rp->priority_task.hook_id,
+                      ( int16_t ) ( ( delay > INT16_MAX ) ? INT16_MAX : ( ( delay < INT16_MIN ) ? INT16_MIN : delay ) ) );
 
         // Case where the high priority task is in the past, error case
         if( delay < 0 )
@@ -650,6 +1374,9 @@ static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
                     rp->tasks[rp->radio_task_id].state = RP_TASK_STATE_ABORTED;
                     SMTC_MODEM_HAL_TRACE_PRINTF( "RP: Abort running #%u for priority #%u\n", rp->radio_task_id,
                                                  rp->priority_task.hook_id );
+#if defined( ADD_RP_TIMED_TX )
+                    smtc_modem_hal_stop_radio_trigger_timer( );
+#endif
 #if defined( ADD_LBM_GEOLOCATION )
                     if( ( rp->radio_task_id == RP_HOOK_ID_DIRECT_RP_ACCESS_GNSS ) ||
                         ( rp->radio_task_id == RP_HOOK_ID_DIRECT_RP_ACCESS_GNSS_ALMANAC ) ||
@@ -665,13 +1392,17 @@ static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
                                                      RAL_STATUS_OK );
                     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_clear_irq_status( TARGET_RAL, RAL_IRQ_ALL ) == RAL_STATUS_OK );
 
+#if defined( ADD_RP_WARM_STANDBY )
+                    // The priority task is launched right away, the radio is only put to sleep if it runs on another
+                    rp->warm_radio      = TARGET_RADIO;
+                    rp->warm_radio_kept = true;
+#else
                     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_sleep( TARGET_RAL, true ) == RAL_STATUS_OK );
+#endif
 
                     rp->radio_irq_flag = false;
 
-                    smtc_modem_hal_set_ant_switch( false );
-                    // Shut Down the TCXO
-                    smtc_modem_hal_stop_radio_tcxo( );
+                    rp_release_radio_resources( rp );
 
                     rp_consumption_statistics_updated( rp, rp->radio_task_id, smtc_modem_hal_get_time_in_ms( ) );
 
@@ -682,9 +1413,29 @@ static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
             }
             else
             {  // Radio is sleeping start priority task on radio
-                rp->radio_task_id                  = rp->priority_task.hook_id;
-                rp->tasks[rp->radio_task_id].state = RP_TASK_STATE_RUNNING;
-                rp_task_launch_current( rp );
+#if defined( ADD_RP_MULTI_RADIO )
+                uint32_t rf_path_free_time_ms = 0;
+                if( rp_multi_radio_is_resource_used( rp, RP_SHARED_RESOURCE_RF_PATH, &rf_path_free_time_ms ) == true )
+                {  // Another radio holds the RF path, no preemption across radios
+                    uint8_t id = rp->priority_task.hook_id;
+                    if( rp->tasks[id].state == RP_TASK_STATE_ASAP )
+                    {
+                        rp->tasks[id].start_time_ms = rf_path_free_time_ms + RP_MCU_FAIRNESS_DELAY_MS;
+                        rp->tasks[id].start_time_us = 0;
+                    }
+                    else
+                    {
+                        SMTC_MODEM_HAL_TRACE_WARNING( " RP: Aborted task with hook #%u - RF path used\n ", id );
+                        rp->tasks[id].state = RP_TASK_STATE_ABORTED;
+                    }
+                }
+                else
+#endif
+                {
+                    rp->radio_task_id                  = rp->priority_task.hook_id;
+                    rp->tasks[rp->radio_task_id].state = RP_TASK_STATE_RUNNING;
+                    rp_task_launch_current( rp );
+                }
             }
         }
         // Timer has expired on a not priority task => Have to abort this task
@@ -722,12 +1473,19 @@ static void rp_task_arbiter( radio_planner_t* rp, const char* caller_func_name )
                 rp->timer_irq_flag = true;
             }
         }
+#if defined( ADD_RP_WARM_STANDBY )
+        rp_warm_radio_update( rp, rp->next_state_status == RP_STATUS_HAVE_TO_SET_TIMER );
+#endif
     }
     else
     {  // No more tasks in the radio planner
         rp_task_call_aborted( rp );
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( " RP: No more active tasks\n" );
+#if defined( ADD_RP_WARM_STANDBY )
+        rp_warm_radio_update( rp, false );
+#endif
     }
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_RP_ARBITER );
 }
 
 static void rp_irq_get_status( radio_planner_t* rp, const uint8_t hook_id )
@@ -770,6 +1528,12 @@ static void rp_irq_get_status( radio_planner_t* rp, const uint8_t hook_id )
             rp->status[hook_id] = RP_STATUS_TASK_ABORTED;
         }
     }
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    else if( rp_sync_irq_get_status( rp, hook_id, radio_irq ) == true )
+    {
+        return;
+    }
+#endif
     else
     {
         // Do not modify the order of the next if / else if process
@@ -845,23 +1609,129 @@ static void rp_irq_get_status( radio_planner_t* rp, const uint8_t hook_id )
     }
 }
 
-static void rp_task_compute_ranking( radio_planner_t* rp )
+static void rp_task_ranking_insert( radio_planner_t* rp, const uint8_t hook_id )
 {
-    uint8_t rank;
-    uint8_t ranks_temp[RP_NB_HOOKS];
+    uint8_t position = 0;
 
-    for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
+    // Priority has changed or task is re-enqueued: move it
+    rp_task_ranking_remove( rp, hook_id );
+
+    // Priorities are unique (the hook id is part of it), value 0 is the highest priority
+    while( ( position < rp->rankings_size ) && ( rp_task_is_ranked_before( rp, rp->rankings[position], hook_id ) ) )
     {
-        ranks_temp[i] = rp->tasks[i].priority;
+        position++;
     }
-    for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
+    memmove( &rp->rankings[position + 1], &rp->rankings[position], rp->rankings_size - position );
+    rp->rankings[position] = hook_id;
+    rp->rankings_size++;
+    rp->active_hooks[hook_id / 32] |= ( uint32_t ) 1 << ( hook_id % 32 );
+}
+
+static bool rp_task_is_ranked_before( const radio_planner_t* rp, const uint8_t hook_id_a, const uint8_t hook_id_b )
+{
+#if defined( ADD_STACK_FAIRNESS )
+    uint8_t stack_id_a = rp->hook_stack_id[hook_id_a];
+    uint8_t stack_id_b = rp->hook_stack_id[hook_id_b];
+
+    // Ranked by state, then by role (first hook of the role), then by stack fairness, then by hook id
+    if( ( ( rp->tasks[hook_id_a].priority / RP_NB_HOOKS ) == ( rp->tasks[hook_id_b].priority / RP_NB_HOOKS ) ) &&
+        ( stack_id_a != RP_NO_STACK ) && ( stack_id_b != RP_NO_STACK ) && ( stack_id_a != stack_id_b ) &&
+        ( ( hook_id_a - stack_id_a ) == ( hook_id_b - stack_id_b ) ) )
     {
-        rank             = rp_task_find_highest_priority( &( ranks_temp[0] ), RP_NB_HOOKS );
-        ranks_temp[rank] = 0xFF;
-        rp->rankings[i]  = rank;
+        if( rp_is_stack_served_before( rp, stack_id_a, stack_id_b ) == true )
+        {
+            return true;
+        }
+        if( rp_is_stack_served_before( rp, stack_id_b, stack_id_a ) == true )
+        {
+            return false;
+        }
     }
+#endif
+    return rp->tasks[hook_id_a].priority < rp->tasks[hook_id_b].priority;
 }
 
+static void rp_task_ranking_remove( radio_planner_t* rp, const uint8_t hook_id )
+{
+    if( ( rp->active_hooks[hook_id / 32] & ( ( uint32_t ) 1 << ( hook_id % 32 ) ) ) == 0 )
+    {
+        return;
+    }
+    rp->active_hooks[hook_id / 32] &= ~( ( uint32_t ) 1 << ( hook_id % 32 ) );
+
+    for( uint8_t i = 0; i < rp->rankings_size; i++ )
+    {
+        if( rp->rankings[i] == hook_id )
+        {
+            rp->rankings_size--;
+            memmove( &rp->rankings[i], &rp->rankings[i + 1], rp->rankings_size - i );
+            return;
+        }
+    }
+}
+
+#if defined( ADD_STACK_FAIRNESS )
+static void rp_task_ranking_sort( radio_planner_t* rp )
+{
+    // Insertion sort: the ranking is short and still in order but for the tasks of the stacks served meanwhile
+    for( uint8_t i = 1; i < rp->rankings_size; i++ )
+    {
+        uint8_t hook_id  = rp->rankings[i];
+        uint8_t position = i;
+        while( ( position > 0 ) && ( rp_task_is_ranked_before( rp, hook_id, rp->rankings[position - 1] ) == true ) )
+        {
+            rp->rankings[position] = rp->rankings[position - 1];
+            position--;
+        }
+        rp->rankings[position] = hook_id;
+    }
+}
+#endif
+
+static uint8_t rp_task_next_active( const radio_planner_t* rp, uint8_t hook_id )
+{
+    while( hook_id < RP_NB_HOOKS )
+    {
+        uint32_t word = rp->active_hooks[hook_id / 32] >> ( hook_id % 32 );
+
+        if( word == 0 )
+        {
+            // No enqueued task up to the end of this word
+            hook_id = ( hook_id | 31 ) + 1;
+        }
+        else
+        {
+            while( ( word & 1 ) == 0 )
+            {
+                word >>= 1;
+                hook_id++;
+            }
+            return hook_id;
+        }
+    }
+    return RP_NB_HOOKS;
+}
+
+#if defined( ADD_RP_US_TIMEBASE )
+static void rp_task_calibrate_launch_latency( radio_planner_t* rp, const rp_task_types_t type )
+{
+    // Only launch callbacks waiting their start time with rp_task_wait_start_time() are calibrated
+    if( ( rp->launch_timestamp_valid == false ) || ( type >= RP_TASK_TYPE_NONE ) )
+    {
+        return;
+    }
+    uint32_t latency_us = smtc_modem_hal_get_time_in_us( ) - rp->launch_timestamp_us;
+
+    if( latency_us > RP_LAUNCH_LATENCY_MAX_US )
+    {
+        latency_us = RP_LAUNCH_LATENCY_MAX_US;
+    }
+    // Smooth the measure, an interrupt may have been served during the launch
+    rp->launch_latency_us[type] =
+        ( uint16_t ) ( ( ( 3 * ( uint32_t ) rp->launch_latency_us[type] ) + latency_us ) >> 2 );
+}
+#endif
+
 static void rp_task_launch_current( radio_planner_t* rp )
 {
     uint8_t id = rp->radio_task_id;
@@ -874,8 +1744,32 @@ static void rp_task_launch_current( radio_planner_t* rp )
     else
     {
         rp_task_print( rp, &rp->tasks[id] );
+        RP_TRACE_ADD( RP_TRACE_EVENT_LAUNCH, id, rp->tasks[id].type );
         rp->radio = TARGET_RADIO;
+#if defined( ADD_RAL_BATCH )
+        // The radio configuration done by the callback is sent in one burst, see rp_task_wait_start_time
+        const ral_t* launch_ral = &( rp->radio->ral );
+        ral_batch_begin( launch_ral );
+#endif
+#if defined( ADD_RP_US_TIMEBASE )
+        rp_task_types_t type       = rp->tasks[id].type;
+        rp->launch_timestamp_valid = false;
+        rp->tasks[id].launch_task_callbacks( ( void* ) rp );
+        rp_task_calibrate_launch_latency( rp, type );
+#else
         rp->tasks[id].launch_task_callbacks( ( void* ) rp );
+#endif
+#if defined( ADD_RAL_BATCH )
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_batch_commit( launch_ral ) != RAL_STATUS_ERROR );
+#endif
+#if defined( ADD_RAL_CFG_SHADOW )
+        // Geolocation scans, user and suspend tasks drive the radio without the RAL: its configuration is unknown
+        if( ( rp->tasks[id].type >= RP_TASK_TYPE_GNSS_SNIFF ) && ( rp->tasks[id].type != RP_TASK_TYPE_LBT ) &&
+            ( rp->tasks[id].type != RP_TASK_TYPE_TX_FLRC ) && ( rp->tasks[id].type != RP_TASK_TYPE_RX_FLRC ) )
+        {
+            ral_invalidate_cfg_shadow( &( rp->radio->ral ) );
+        }
+#endif
     }
 }
 
@@ -886,19 +1780,18 @@ static uint8_t rp_task_select_next( radio_planner_t* rp, const uint32_t now )
     uint32_t hook_duration_tmp    = 0;
     uint32_t time_tmp             = 0;
     uint8_t  rank                 = 0;
-    uint8_t  hook_id              = 0;
+    uint8_t  index                = 0;
 
-    for( hook_id = 0; hook_id < RP_NB_HOOKS; hook_id++ )
-    {  // Garbage collector
-        if( ( rp->tasks[hook_id].state == RP_TASK_STATE_SCHEDULE ) &&
-            ( ( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - now ) < 0 ) ) )
+    // The ranking only holds enqueued tasks, from the highest to the lowest priority. The garbage collector is run
+    // on each visited task: an aborted task is never selected, so this is the same as a dedicated pass.
+    for( index = 0; index < rp->rankings_size; index++ )
+    {
+        rank = rp->rankings[index];
+        if( ( rp->tasks[rank].state == RP_TASK_STATE_SCHEDULE ) &&
+            ( ( ( int32_t ) ( rp->tasks[rank].start_time_ms - now ) < 0 ) ) )
         {
-            rp->tasks[hook_id].state = RP_TASK_STATE_ABORTED;
+            rp->tasks[rank].state = RP_TASK_STATE_ABORTED;
         }
-    }
-    for( hook_id = 0; hook_id < RP_NB_HOOKS; hook_id++ )
-    {
-        rank = rp->rankings[hook_id];
         if( ( ( rp->tasks[rank].state < RP_TASK_STATE_RUNNING ) &&
               ( ( int32_t ) ( rp->tasks[rank].start_time_ms - now ) >= 0 ) ) ||
             ( rp->tasks[rank].state == RP_TASK_STATE_RUNNING ) )
@@ -909,14 +1802,19 @@ static uint8_t rp_task_select_next( radio_planner_t* rp, const uint32_t now )
             break;
         }
     }
-    if( hook_id == RP_NB_HOOKS )
+    if( index == rp->rankings_size )
     {
         return RP_NO_MORE_TASK;
     }
 
-    for( int32_t i = hook_id + 1; i < RP_NB_HOOKS; i++ )
+    for( uint8_t i = index + 1; i < rp->rankings_size; i++ )
     {
         rank = rp->rankings[i];
+        if( ( rp->tasks[rank].state == RP_TASK_STATE_SCHEDULE ) &&
+            ( ( ( int32_t ) ( rp->tasks[rank].start_time_ms - now ) < 0 ) ) )
+        {
+            rp->tasks[rank].state = RP_TASK_STATE_ABORTED;
+        }
         if( ( ( rp->tasks[rank].state < RP_TASK_STATE_RUNNING ) &&
               ( ( int32_t ) ( rp->tasks[rank].start_time_ms - now ) >= 0 ) ) ||
             ( rp->tasks[rank].state == RP_TASK_STATE_RUNNING ) )
@@ -935,6 +1833,7 @@ static uint8_t rp_task_select_next( radio_planner_t* rp, const uint32_t now )
                 if( rp->tasks[rank].state == RP_TASK_STATE_ASAP )
                 {
                     rp->tasks[rank].start_time_ms = hook_time_to_exe_tmp + hook_duration_tmp + RP_MCU_FAIRNESS_DELAY_MS;
+                    rp->tasks[rank].start_time_us = 0;
                 }
             }
         }
@@ -946,64 +1845,36 @@ static uint8_t rp_task_select_next( radio_planner_t* rp, const uint32_t now )
 static rp_next_state_status_t rp_task_get_next( radio_planner_t* rp, uint32_t* duration, uint8_t* task_id,
                                                 const uint32_t now )
 {
-    uint8_t  hook_id  = 0;
-    uint8_t  index    = 0;
+    uint8_t  index    = RP_NB_HOOKS;
     uint32_t time_tmp = now;
 
-    for( hook_id = 0; hook_id < RP_NB_HOOKS; hook_id++ )
-    {  // Garbage collector
+    // Single pass on enqueued tasks: garbage collector and earliest start time (lowest hook id on equality)
+    for( uint8_t hook_id = rp_task_next_active( rp, 0 ); hook_id < RP_NB_HOOKS;
+         hook_id         = rp_task_next_active( rp, hook_id + 1 ) )
+    {
         if( ( rp->tasks[hook_id].state == RP_TASK_STATE_SCHEDULE ) &&
-            ( ( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - time_tmp ) < 0 ) ) )
+            ( ( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - now ) < 0 ) ) )
         {
             rp->tasks[hook_id].state = RP_TASK_STATE_ABORTED;
         }
-    }
-    for( hook_id = 0; hook_id < RP_NB_HOOKS; hook_id++ )
-    {
         if( ( rp->tasks[hook_id].state < RP_TASK_STATE_RUNNING ) &&
-            ( ( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - time_tmp ) >= 0 ) ) )
+            ( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - now ) >= 0 ) &&
+            ( ( index == RP_NB_HOOKS ) || ( ( int32_t ) ( rp->tasks[hook_id].start_time_ms - time_tmp ) < 0 ) ) )
         {
             time_tmp = rp->tasks[hook_id].start_time_ms;
             index    = hook_id;
-            break;
         }
     }
-    if( hook_id == RP_NB_HOOKS )
+    if( index == RP_NB_HOOKS )
     {
         return RP_STATUS_NO_MORE_TASK_SCHEDULE;
     }
 
-    for( uint8_t i = hook_id; i < RP_NB_HOOKS; i++ )
-    {
-        if( ( rp->tasks[i].state < RP_TASK_STATE_RUNNING ) &&
-            ( ( int32_t ) ( rp->tasks[i].start_time_ms - time_tmp ) < 0 ) &&
-            ( ( int32_t ) ( rp->tasks[i].start_time_ms - now ) >= 0 ) )
-        {
-            time_tmp = rp->tasks[i].start_time_ms;
-            index    = i;
-        }
-    }
     *task_id  = index;
     *duration = time_tmp - now;
     return RP_STATUS_HAVE_TO_SET_TIMER;
 }
 
-static uint8_t rp_task_find_highest_priority( uint8_t* vector, uint8_t length )
-{
-    uint8_t priority_high = 0xFF;
-    uint8_t index         = 0;
-
-    for( int32_t i = 0; i < length; i++ )
-    {
-        if( vector[i] <= priority_high )
-        {
-            priority_high = vector[i];
-            index         = i;
-        }
-    }
-    return index;
-}
-
 rp_hook_status_t rp_get_pkt_payload( radio_planner_t* rp, const rp_task_t* task )
 {
     rp_hook_status_t status = RP_HOOK_STATUS_OK;
@@ -1014,9 +1885,21 @@ rp_hook_status_t rp_get_pkt_payload( radio_planner_t* rp, const rp_task_t* task
         return status;  // don't catch the payload in case of user task
     }
 
-    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_get_pkt_payload( &( rp->radio_target_attached_to_this_hook[id]->ral ),
-                                                          rp->payload_buffer_size[id], rp->payload[id],
-                                                          &rp->rx_payload_size[id] ) == RAL_STATUS_OK );
+#if defined( ADD_RP_RX_CONTINUOUS )
+    if( task->rx_continuous == true )
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+            ral_get_continuous_rx_pkt_payload( &( rp->radio_target_attached_to_this_hook[id]->ral ),
+                                               rp->payload_buffer_size[id], rp->payload[id],
+                                               &rp->rx_payload_size[id] ) == RAL_STATUS_OK );
+    }
+    else
+#endif
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_get_pkt_payload( &( rp->radio_target_attached_to_this_hook[id]->ral ),
+                                                              rp->payload_buffer_size[id], rp->payload[id],
+                                                              &rp->rx_payload_size[id] ) == RAL_STATUS_OK );
+    }
 
     if( ( task->type == RP_TASK_TYPE_RX_LORA ) || ( task->type == RP_TASK_TYPE_CAD_TO_RX ) )
     {
@@ -1046,6 +1929,15 @@ rp_hook_status_t rp_get_pkt_payload( radio_planner_t* rp, const rp_task_t* task
             ral_get_gfsk_rx_pkt_status( &( rp->radio_target_attached_to_this_hook[id]->ral ),
                                         &rp->radio_params[id].rx.gfsk_pkt_status ) == RAL_STATUS_OK );
     }
+    else if( task->type == RP_TASK_TYPE_RX_FLRC )
+    {
+        rp->radio_params[id].pkt_type = RAL_PKT_TYPE_FLRC;
+        status                        = RP_HOOK_STATUS_OK;
+
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+            ral_get_flrc_rx_pkt_status( &( rp->radio_target_attached_to_this_hook[id]->ral ),
+                                        &rp->radio_params[id].rx.flrc_pkt_status ) == RAL_STATUS_OK );
+    }
     else
     {
         status = RP_HOOK_STATUS_ID_ERROR;
@@ -1056,10 +1948,205 @@ rp_hook_status_t rp_get_pkt_payload( radio_planner_t* rp, const rp_task_t* task
 
 static void rp_set_alarm( radio_planner_t* rp, const uint32_t alarm_in_ms )
 {
-    smtc_modem_hal_stop_timer( );
-    smtc_modem_hal_start_timer( alarm_in_ms, rp_timer_irq_callback, rp );
+    // Each planner has its own timer, the radios of a multi radio setup do not cancel the alarms of each other
+    modem_timer_start( &rp->alarm_timer, alarm_in_ms, rp_timer_irq_callback, rp );
 }
 
+static uint8_t rp_task_get_priority( const rp_task_t* task )
+{
+    if( task->schedule_task_low_priority == true )
+    {
+        return ( RP_TASK_STATE_ASAP * RP_NB_HOOKS ) + task->hook_id;
+    }
+    return ( task->state * RP_NB_HOOKS ) + task->hook_id;
+}
+
+#if defined( ADD_RP_ADMISSION_CONTROL )
+static bool rp_task_find_conflict( const radio_planner_t* rp, const rp_task_t* task, const uint32_t start_time_ms,
+                                   uint32_t* conflict_end_ms )
+{
+    const uint8_t  priority    = rp_task_get_priority( task );
+    const uint32_t end_time_ms = start_time_ms + task->duration_time_ms + rp->margin_delay;
+
+    for( uint8_t index = 0; index < rp->rankings_size; index++ )
+    {
+        const rp_task_t* other = &rp->tasks[rp->rankings[index]];
+
+        // The tasks of lower priority can't win the arbitration
+        if( ( other->priority >= priority ) || ( other->hook_id == task->hook_id ) ||
+            ( ( other->state != RP_TASK_STATE_SCHEDULE ) && ( other->state != RP_TASK_STATE_RUNNING ) ) )
+        {
+            continue;
+        }
+
+        const uint32_t other_end_ms = other->start_time_ms + other->duration_time_ms + rp->margin_delay;
+        if( ( ( int32_t ) ( start_time_ms - other_end_ms ) < 0 ) &&
+            ( ( int32_t ) ( other->start_time_ms - end_time_ms ) < 0 ) )
+        {
+            *conflict_end_ms = other_end_ms;
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+static void rp_release_radio_resources( radio_planner_t* rp )
+{
+#if defined( ADD_RP_WARM_STANDBY )
+    if( rp->warm_radio != NULL )
+    {  // The TCXO is released when the radio is put to sleep
+        smtc_modem_hal_set_ant_switch( false );
+        return;
+    }
+#endif
+#if defined( ADD_RP_MULTI_RADIO )
+    if( rp_multi_radio_is_resource_used( rp, RP_SHARED_RESOURCE_RF_PATH, NULL ) == false )
+    {
+        smtc_modem_hal_set_ant_switch( false );
+    }
+    if( rp_multi_radio_is_resource_used( rp, RP_SHARED_RESOURCE_TCXO, NULL ) == false )
+    {
+        // Shut Down the TCXO
+        smtc_modem_hal_stop_radio_tcxo( );
+    }
+#else
+    smtc_modem_hal_set_ant_switch( false );
+    // Shut Down the TCXO
+    smtc_modem_hal_stop_radio_tcxo( );
+#endif
+}
+
+#if defined( ADD_RP_WARM_STANDBY )
+static void rp_warm_radio_update( radio_planner_t* rp, bool has_next_task )
+{
+    const ralf_t* radio = rp->warm_radio;
+
+    if( radio == NULL )
+    {
+        return;
+    }
+
+    if( ( rp->tasks[rp->radio_task_id].state == RP_TASK_STATE_RUNNING ) && ( TARGET_RADIO == radio ) )
+    {  // The next task has been launched on the radio still awake
+        rp->warm_radio = NULL;
+        rp->stats.radio_warm_reuse_nb++;
+        return;
+    }
+
+    const uint32_t wake_up_cost_ms = RP_RADIO_WAKE_UP_TIME_MS + smtc_modem_hal_get_radio_tcxo_startup_delay_ms( );
+    bool           keep_warm       = false;
+
+    if( ( has_next_task == true ) && ( rp->radio_target_attached_to_this_hook[rp->timer_hook_id] == radio ) )
+    {
+        keep_warm = ( rp->timer_value <= wake_up_cost_ms );
+    }
+#if defined( ADD_RP_MULTI_RADIO )
+    // The TCXO may be shared with another radio which would release it
+    keep_warm = keep_warm && ( rp->multi_radio_registered == false );
+#endif
+
+    if( keep_warm == true )
+    {  // Staying in standby until the next task costs less than waking up the radio and restarting the TCXO
+        if( rp->warm_radio_kept == false )
+        {
+            SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_standby( &( radio->ral ), RAL_STANDBY_CFG_XOSC ) ==
+                                             RAL_STATUS_OK );
+            rp->warm_radio_kept = true;
+            rp_stats_add_radio_sleep( &rp->stats, false );
+        }
+        return;
+    }
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_sleep( &( radio->ral ), true ) == RAL_STATUS_OK );
+    rp->warm_radio      = NULL;
+    rp->warm_radio_kept = false;
+    rp_release_radio_resources( rp );
+    rp_stats_add_radio_sleep( &rp->stats, true );
+}
+#endif
+
+#if defined( ADD_RP_TASK_CHAIN )
+static void rp_task_chain_next( radio_planner_t* rp, const uint8_t hook_id )
+{
+    if( rp->tasks[hook_id].state != RP_TASK_STATE_FINISHED )
+    {
+        // The callback enqueued a task on the hook, the sequence goes on after it
+        return;
+    }
+    for( uint8_t i = 0; i < rp->chain_size; i++ )
+    {
+        if( rp->chain[i].task.hook_id == hook_id )
+        {
+            rp_chained_task_t chained = rp->chain[i];
+            rp->chain_size--;
+            memmove( &rp->chain[i], &rp->chain[i + 1], ( rp->chain_size - i ) * sizeof( rp_chained_task_t ) );
+            if( chained.task.state == RP_TASK_STATE_ASAP )
+            {
+                chained.task.start_time_ms = smtc_modem_hal_get_time_in_ms( );
+                chained.task.start_time_us = 0;
+            }
+            // The chained task is checked as an enqueued one, a schedule task now in the past or in conflict is refused
+            const rp_hook_status_t status = rp_task_enqueue_check( rp, &chained.task );
+            if( status == RP_HOOK_STATUS_OK )
+            {
+                rp_task_store( rp, &chained.task, chained.payload, chained.payload_buffer_size,
+                               &chained.radio_params );
+                return;
+            }
+            // A refused task ends the sequence as an abort does: the hook is called back with the aborted status
+            SMTC_MODEM_HAL_TRACE_PRINTF( " RP: Task #%u chained refused (%d)\n", hook_id, status );
+            rp_task_chain_drop( rp, hook_id );
+            rp->status[hook_id] = RP_STATUS_TASK_ABORTED;
+            rp_hook_callback( rp, hook_id );
+            return;
+        }
+    }
+}
+
+static void rp_task_chain_drop( radio_planner_t* rp, const uint8_t hook_id )
+{
+    uint8_t kept = 0;
+    for( uint8_t i = 0; i < rp->chain_size; i++ )
+    {
+        if( rp->chain[i].task.hook_id != hook_id )
+        {
+            if( kept != i )
+            {
+                rp->chain[kept] = rp->chain[i];
+            }
+            kept++;
+        }
+    }
+    rp->chain_size = kept;
+}
+#endif
+
+#if defined( ADD_RP_MULTI_RADIO )
+static bool rp_multi_radio_is_resource_used( const radio_planner_t* rp, uint32_t resource, uint32_t* end_time_ms )
+{
+    if( ( rp->multi_radio_registered == false ) || ( ( rp->shared_resources & resource ) == 0 ) )
+    {
+        return false;
+    }
+    for( uint8_t i = 0; i < rp_multi_radio.nb_planners; i++ )
+    {
+        const radio_planner_t* other = rp_multi_radio.planners[i];
+        if( ( other != rp ) && ( ( other->shared_resources & resource ) != 0 ) &&
+            ( other->tasks[other->radio_task_id].state == RP_TASK_STATE_RUNNING ) )
+        {
+            if( end_time_ms != NULL )
+            {
+                *end_time_ms = other->tasks[other->radio_task_id].start_time_ms +
+                               other->tasks[other->radio_task_id].duration_time_ms;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
 static void rp_timer_irq( radio_planner_t* rp )
 {
     rp_task_arbiter( rp, __func__ );
@@ -1067,13 +2154,28 @@ static void rp_timer_irq( radio_planner_t* rp )
 
 static void rp_task_call_aborted( radio_planner_t* rp )
 {
-    for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
+#if defined( ADD_RP_IRQ_FAST_PATH )
+    // The hooks of the aborted tasks are not all ready for the interrupt context, they are called back by the engine
+    if( rp->irq_fast_path_running == true )
+    {
+        rp->aborted_call_pending = true;
+        return;
+    }
+    rp->aborted_call_pending = false;
+#endif
+    // Callbacks can enqueue or abort tasks: the next enqueued hook is read again after each of them
+    for( uint8_t i = rp_task_next_active( rp, 0 ); i < RP_NB_HOOKS; i = rp_task_next_active( rp, i + 1 ) )
     {
         if( rp->tasks[i].state == RP_TASK_STATE_ABORTED )
         {
             SMTC_MODEM_HAL_RP_TRACE_PRINTF( " RP: INFO - Aborted hook # %d callback\n", i );
+            RP_TRACE_ADD( RP_TRACE_EVENT_ABORT, i, rp->tasks[i].type );
             rp->stats.task_hook_aborted_nb[i]++;
+            MODEM_PERF_COUNTER_ADD( MODEM_PERF_RP_ABORTED_NB, 1 );
             rp_task_free( rp, &rp->tasks[i] );
+#if defined( ADD_RP_TASK_CHAIN )
+            rp_task_chain_drop( rp, i );
+#endif
             rp->status[i] = RP_STATUS_TASK_ABORTED;
             rp->radio     = rp->radio_target_attached_to_this_hook[i];
             rp_hook_callback( rp, i );
@@ -1120,6 +2222,12 @@ static void rp_task_print( const radio_planner_t* rp, const rp_task_t* task )
     case RP_TASK_TYPE_RX_BLE_SCAN:
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( " TASK_RX_BLE_SCAN " );
         break;
+    case RP_TASK_TYPE_TX_FLRC:
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( " TASK_TX_FLRC " );
+        break;
+    case RP_TASK_TYPE_RX_FLRC:
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( " TASK_RX_FLRC " );
+        break;
     case RP_TASK_TYPE_NONE:
     case RP_TASK_TYPE_GNSS_SNIFF:
     case RP_TASK_TYPE_WIFI_SNIFF:
@@ -1147,6 +2255,10 @@ static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_
     {
         bool enable_boost_mode = false;
         ral_cfg_rx_boosted( TARGET_RAL_FOR_HOOK_ID, enable_boost_mode );
+#if defined( ADD_RX_BOOST_POLICY )
+        // The power saving gain is restored above for the next tasks, the task is counted with its own gain
+        enable_boost_mode = rp->radio_params[hook_id].rx.rx_boosted;
+#endif
         ral_get_lora_rx_consumption_in_ua( TARGET_RAL_FOR_HOOK_ID, rp->radio_params[hook_id].rx.lora.mod_params.bw,
                                            enable_boost_mode, &micro_ampere_radio );
     }
@@ -1154,6 +2266,9 @@ static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_
     {
         bool enable_boost_mode = false;
         ral_cfg_rx_boosted( TARGET_RAL_FOR_HOOK_ID, enable_boost_mode );
+#if defined( ADD_RX_BOOST_POLICY )
+        enable_boost_mode = rp->radio_params[hook_id].rx.rx_boosted;
+#endif
         ral_get_gfsk_rx_consumption_in_ua(
             TARGET_RAL_FOR_HOOK_ID, rp->radio_params[hook_id].rx.gfsk.mod_params.br_in_bps,
             rp->radio_params[hook_id].rx.gfsk.mod_params.bw_dsb_in_hz, enable_boost_mode, &micro_ampere_radio );
@@ -1179,6 +2294,12 @@ static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_
 
         tx_freq_hz = rp->radio_params[hook_id].tx.lr_fhss.ral_lr_fhss_params.center_frequency_in_hz;
     }
+    else if( rp->tasks[hook_id].type == RP_TASK_TYPE_TX_FLRC )
+    {
+        ral_get_tx_consumption_in_ua( TARGET_RAL_FOR_HOOK_ID, rp->radio_params[hook_id].tx.flrc.output_pwr_in_dbm,
+                                      rp->radio_params[hook_id].tx.flrc.rf_freq_in_hz, &micro_ampere_radio );
+        tx_freq_hz = rp->radio_params[hook_id].tx.flrc.rf_freq_in_hz;
+    }
 
     if( ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_SNIFF ) ||
         ( rp->tasks[hook_id].type == RP_TASK_TYPE_GNSS_RSSI ) ||
@@ -1196,7 +2317,18 @@ static void rp_consumption_statistics_updated( radio_planner_t* rp, const uint8_
     else
     {
         uint32_t tx_timestamp_tmp = rp->stats.tx_timestamp;
+#if defined( ADD_STACK_FAIRNESS )
+        uint32_t hook_airtime_ms = rp->stats.tx_consumption_ms[hook_id] + rp->stats.rx_consumption_ms[hook_id];
+#endif
         rp_stats_update( &rp->stats, time, hook_id, micro_ampere_radio );
+#if defined( ADD_STACK_FAIRNESS )
+        if( rp->hook_stack_id[hook_id] != RP_NO_STACK )
+        {
+            rp->stack_airtime_ms[rp->hook_stack_id[hook_id]] +=
+                ( rp->stats.tx_consumption_ms[hook_id] + rp->stats.rx_consumption_ms[hook_id] ) - hook_airtime_ms;
+            rp_task_ranking_sort( rp );
+        }
+#endif
         if( tx_timestamp_tmp != 0 )
         {
             smtc_duty_cycle_sum( tx_freq_hz, rp->stats.tx_last_toa_ms[hook_id] );
@@ -1214,9 +2346,106 @@ void rp_radio_irq_callback( void* obj )
     radio_planner_t* rp                     = ( ( radio_planner_t* ) obj );
     rp->radio_irq_flag                      = true;
     rp->irq_timestamp_ms[rp->radio_task_id] = smtc_modem_hal_get_time_in_ms( );
+#if defined( ADD_RP_HW_TIMESTAMP )
+    // The edge captured in hardware removes the interrupt latency from the timestamp of the radio event
+    uint32_t elapsed_us;
+    if( smtc_modem_hal_get_radio_irq_elapsed_us( &elapsed_us ) == true )
+    {
+        rp->irq_timestamp_ms[rp->radio_task_id] -= elapsed_us / 1000;
+        rp->stats.irq_hw_timestamp_nb++;
+    }
+#endif
+#if defined( ADD_RP_IRQ_FAST_PATH )
+    rp_irq_fast_path( rp );
+#endif
     smtc_modem_hal_user_lbm_irq( );
 }
 
+#if defined( ADD_RP_IRQ_FAST_PATH )
+static void rp_irq_fast_path( radio_planner_t* rp )
+{
+    const uint8_t id = rp->radio_task_id;
+    // One irq at a time: the previous one is left to the engine first
+    if( ( rp->lock_depth != 0 ) || ( rp->irq_fast_path_status_read == true ) ||
+        ( rp->irq_fast_path_ended_id != RP_NB_HOOKS ) || ( rp->tasks[id].state != RP_TASK_STATE_RUNNING ) ||
+        ( ( rp->irq_fast_path_hooks[id / 32] & ( ( uint32_t ) 1 << ( id % 32 ) ) ) == 0 ) )
+    {
+        // Deferred to rp_callback in the engine context
+        return;
+    }
+    RP_LOCK( rp );
+    rp->irq_fast_path_running = true;
+
+    rp_irq_get_status( rp, id );
+    RP_TRACE_ADD( RP_TRACE_EVENT_IRQ, id, rp->status[id] );
+
+    if( ( rp->status[id] == RP_STATUS_LR_FHSS_HOP )
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+        || ( rp->status[id] == RP_STATUS_RX_ONGOING )
+#endif
+    )
+    {
+        // Fully processed by the status read
+        rp->radio_irq_flag = false;
+    }
+    else if( ( rp_irq_fast_path_task_goes_on( rp, id ) == true )
+#if defined( ADD_RP_TASK_CHAIN )
+             || ( rp_task_get_chained_nb( rp, id ) != 0 )
+#endif
+    )
+    {
+        // The engine calls the hook back with this status
+        rp->irq_fast_path_status_read = true;
+    }
+    else
+    {
+        // The task ended: same processing as rp_callback_process, the hook is called back by the next rp_callback
+        rp->radio_irq_flag = false;
+        rp_consumption_statistics_updated( rp, id, rp->irq_timestamp_ms[id] );
+        rp_task_free( rp, &rp->tasks[id] );
+#if defined( ADD_RP_WARM_STANDBY )
+        rp->warm_radio      = TARGET_RADIO;
+        rp->warm_radio_kept = false;
+#else
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_sleep( TARGET_RAL, true ) == RAL_STATUS_OK );
+#endif
+        rp->radio                  = TARGET_RADIO;
+        rp->irq_fast_path_ended_id = id;
+        // The aborted tasks are left to the engine by rp_task_call_aborted
+        rp_task_arbiter( rp, __func__ );
+        rp_release_radio_resources( rp );
+    }
+
+    rp->irq_fast_path_running = false;
+    RP_UNLOCK( rp );
+}
+
+static bool rp_irq_fast_path_task_goes_on( const radio_planner_t* rp, const uint8_t id )
+{
+    const rp_status_t     status = rp->status[id];
+    const rp_task_types_t type   = rp->tasks[id].type;
+
+    if( ( ( status == RP_STATUS_CAD_NEGATIVE ) && ( type == RP_TASK_TYPE_CAD_TO_TX ) ) ||
+        ( ( status == RP_STATUS_CAD_POSITIVE ) && ( type == RP_TASK_TYPE_CAD_TO_RX ) ) ||
+        ( ( status == RP_STATUS_CAD_NEGATIVE ) && ( type == RP_TASK_TYPE_CAD_TO_RX ) &&
+          ( rp->tasks[id].cad_sweep_hops > 0 ) ) )
+    {
+        return true;
+    }
+    if( ( status == RP_STATUS_RX_PACKET ) || ( status == RP_STATUS_RX_CRC_ERROR ) )
+    {
+#if defined( ADD_RP_RX_CONTINUOUS )
+        if( rp->tasks[id].rx_continuous == true )
+        {
+            return true;
+        }
+#endif
+        return ( type == RP_TASK_TYPE_RX_BLE_SCAN );
+    }
+    return false;
+}
+#endif
+
 static void rp_timer_irq_callback( void* obj )
 {
     radio_planner_t* rp = ( ( radio_planner_t* ) obj );
@@ -1224,6 +2453,74 @@ static void rp_timer_irq_callback( void* obj )
     smtc_modem_hal_user_lbm_irq( );
 }
 
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+static void rp_sync_timer_irq_callback( void* obj )
+{
+    radio_planner_t* rp = ( ( radio_planner_t* ) obj );
+    rp->sync_timer_flag = true;
+    smtc_modem_hal_user_lbm_irq( );
+}
+
+static void rp_sync_timeout( radio_planner_t* rp )
+{
+    uint8_t id = rp->radio_task_id;
+
+    if( ( id != rp->sync_timer_hook_id ) || ( rp->tasks[id].state != RP_TASK_STATE_RUNNING ) ||
+        ( rp->tasks[id].type != RP_TASK_TYPE_RX_FSK ) )
+    {
+        return;
+    }
+    // The rx timer has been stopped on the preamble: without sync word, the window is closed here as a rx timeout
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( " RP: INFO - No sync word after the preamble for hook #%u\n", id );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_standby( TARGET_RAL, RAL_STANDBY_CFG_RC ) == RAL_STATUS_OK );
+    rp->sync_timed_out       = true;
+    rp->irq_timestamp_ms[id] = smtc_modem_hal_get_time_in_ms( );
+    rp->radio_irq_flag       = true;
+}
+
+static bool rp_sync_irq_get_status( radio_planner_t* rp, const uint8_t hook_id, const ral_irq_t radio_irq )
+{
+    if( ( rp->tasks[hook_id].type != RP_TASK_TYPE_RX_FSK ) ||
+        ( rp->radio_params[hook_id].rx.sync_timeout_in_ms == 0 ) )
+    {
+        return false;
+    }
+
+    if( ( radio_irq & ( RAL_IRQ_RX_DONE | RAL_IRQ_RX_TIMEOUT | RAL_IRQ_RX_CRC_ERROR | RAL_IRQ_RX_HDR_ERROR ) ) != 0 )
+    {
+        // End of the window, the status is given by the usual process
+        modem_timer_stop( &rp->sync_timer );
+        rp->sync_timed_out = false;
+        return false;
+    }
+
+    rp->raw_radio_irq[hook_id] = radio_irq;
+    if( rp->sync_timed_out == true )
+    {
+        rp->sync_timed_out  = false;
+        rp->status[hook_id] = RP_STATUS_RX_TIMEOUT;
+    }
+    else if( ( radio_irq & RAL_IRQ_RX_HDR_OK ) == RAL_IRQ_RX_HDR_OK )
+    {
+        // Sync word found, the packet ends with a rx done or a crc error
+        modem_timer_stop( &rp->sync_timer );
+        rp->status[hook_id] = RP_STATUS_RX_ONGOING;
+    }
+    else if( ( radio_irq & RAL_IRQ_RX_PREAMBLE_DETECTED ) == RAL_IRQ_RX_PREAMBLE_DETECTED )
+    {
+        rp->sync_timer_hook_id = hook_id;
+        modem_timer_start( &rp->sync_timer, rp->radio_params[hook_id].rx.sync_timeout_in_ms,
+                           rp_sync_timer_irq_callback, rp );
+        rp->status[hook_id] = RP_STATUS_RX_ONGOING;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+#endif
+
 static void rp_hook_callback( radio_planner_t* rp, uint8_t id )
 {
     if( id >= RP_NB_HOOKS )
@@ -1237,6 +2534,10 @@ static void rp_hook_callback( radio_planner_t* rp, uint8_t id )
         return;
     }
     rp->hook_callbacks[id]( rp->hooks[id] );
+    if( rp->hook_callback_done != NULL )
+    {
+        rp->hook_callback_done( );
+    }
 }
 
 /* --- EOF ------------------------------------------------------------------ */
@@ -48,9 +48,11 @@ extern "C" {
 
 #include "radio_planner_types.h"
 #include "radio_planner_stats.h"
+#include "radio_planner_trace.h"
 #include "radio_planner_hook_id_defs.h"
 
 #include "ralf.h"
+#include "modem_timer.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -78,7 +80,9 @@ typedef struct radio_planner_s
     uint8_t*          payload[RP_NB_HOOKS];
     uint16_t          rx_payload_size[RP_NB_HOOKS];
     uint16_t          payload_buffer_size[RP_NB_HOOKS];
-    uint8_t           rankings[RP_NB_HOOKS];
+    uint8_t           rankings[RP_NB_HOOKS];  // enqueued tasks sorted by priority
+    uint8_t           rankings_size;
+    uint32_t          active_hooks[RP_ACTIVE_HOOKS_WORDS];  // bitmap of hooks holding an enqueued task
     void*             hooks[RP_NB_HOOKS];
     rp_status_t       status[RP_NB_HOOKS];
     ral_irq_t         raw_radio_irq[RP_NB_HOOKS];
@@ -89,14 +93,55 @@ typedef struct radio_planner_s
     uint8_t           radio_task_id;
     uint32_t          timer_value;
     uint8_t           timer_hook_id;
+    modem_timer_t     alarm_timer;
     bool              radio_irq_flag;
     bool              timer_irq_flag;
     uint32_t          disable_failsafe;
     void ( *hook_callbacks[RP_NB_HOOKS] )( void* );
+    void ( *hook_callback_done )( void );
     rp_next_state_status_t next_state_status;
     const ralf_t*          radio;
     const ralf_t*          radio_target_attached_to_this_hook[RP_NB_HOOKS];
     uint32_t               margin_delay;
+#if defined( ADD_RP_US_TIMEBASE )
+    uint16_t launch_latency_us[RP_TASK_TYPE_NONE];  // calibrated launch latency of each task type
+    uint32_t launch_timestamp_us;
+    bool     launch_timestamp_valid;
+#endif
+#if defined( ADD_RP_TRACE )
+    rp_trace_t trace;
+#endif
+#if defined( ADD_RP_MULTI_RADIO )
+    uint32_t shared_resources;  // RP_SHARED_RESOURCE_* mask of the resources shared with the other radios
+    bool     multi_radio_registered;
+#endif
+#if defined( ADD_RP_WARM_STANDBY )
+    const ralf_t* warm_radio;       // radio left awake at the end of its last task, to be put to sleep by the arbiter
+    bool          warm_radio_kept;  // warm_radio has been set in standby for the next task
+#endif
+#if defined( ADD_RP_IRQ_FAST_PATH )
+    uint32_t         irq_fast_path_hooks[RP_ACTIVE_HOOKS_WORDS];  // bitmap of the hooks handled in the radio irq
+    volatile uint8_t lock_depth;                 // number of nested planner calls of the engine context
+    bool             irq_fast_path_running;      // a radio irq is processed in the interrupt context
+    bool             irq_fast_path_status_read;  // status of the pending radio irq already read in the interrupt
+    uint8_t          irq_fast_path_ended_id;     // hook whose task ended in the interrupt, RP_NB_HOOKS if none
+    bool             aborted_call_pending;       // aborted hooks to be called back by the engine
+#endif
+#if defined( ADD_STACK_FAIRNESS )
+    uint8_t  hook_stack_id[RP_NB_HOOKS];         // stack owning the hook, RP_NO_STACK for shared services
+    uint8_t  stack_weight[NUMBER_OF_STACKS];     // share of the radio time of each stack
+    uint32_t stack_airtime_ms[NUMBER_OF_STACKS];  // radio time used by the hooks of each stack
+#endif
+#if defined( ADD_RP_TASK_CHAIN )
+    rp_chained_task_t chain[RP_TASK_CHAIN_NB_TASKS];  // tasks waiting for the end of the task of their hook
+    uint8_t           chain_size;
+#endif
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    modem_timer_t sync_timer;          // started on the preamble detection of a FSK window, stopped on its sync word
+    uint8_t       sync_timer_hook_id;  // hook of the window watched by sync_timer
+    bool          sync_timer_flag;     // sync_timer expired, handled by the engine
+    bool          sync_timed_out;      // the window has been closed by sync_timer
+#endif
 } radio_planner_t;
 
 /*
@@ -126,6 +171,14 @@ void rp_init( radio_planner_t* rp, const ralf_t* radio );
  */
 rp_hook_status_t rp_hook_init( radio_planner_t* rp, const uint8_t id, void ( *callback )( void* context ), void* hook );
 
+/**
+ * @brief rp_set_hook_callback_done set the function called each time a hook callback returns
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param callback function called after each hook callback, NULL to disable it
+ */
+void rp_set_hook_callback_done( radio_planner_t* rp, void ( *callback )( void ) );
+
 /*!
  *
  */
@@ -149,16 +202,95 @@ rp_hook_status_t rp_release_hook( radio_planner_t* rp, uint8_t id );
 rp_hook_status_t rp_task_enqueue( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
                                   uint16_t payload_buffer_size, const rp_radio_params_t* radio_params );
 
+#if defined( ADD_RP_TASK_CHAIN )
+/**
+ * @brief rp_task_enqueue_chained enqueue a task to be run after the task of its hook, so that a hook submits a
+ *        sequence (CAD sweep, successive scans, Rx then Tx) at once. When the task of the hook ends, the hook is
+ *        called back as usual and the next chained task of the hook is enqueued right after, the arbitration is then
+ *        run once for both: an asap chained task starts at the end of the callback if it wins it. Chained tasks of a
+ *        hook run in the order of the calls, each one after the end of the previous one.
+ * \remark The chained tasks of a hook are dropped when its task is aborted, by rp_task_abort or by the arbitration.
+ *         A task enqueued on the hook by its callback runs before the next chained task.
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param task task to chain, enqueued as with rp_task_enqueue if the hook has no task
+ * @param payload buffer holding the data to be Tx/Rx, shall be kept until the task ends
+ * @param payload_buffer_size Tx: size to be transmitted, Rx: maximum payload to be received
+ * @param radio_params radio parameters of the task, copied
+ * @return RP_HOOK_STATUS_OK, RP_TASK_STATUS_NO_FREE_SLOT if RP_TASK_CHAIN_NB_TASKS tasks are already chained, or
+ *         the status of rp_task_enqueue
+ */
+rp_hook_status_t rp_task_enqueue_chained( radio_planner_t* rp, const rp_task_t* task, uint8_t* payload,
+                                          uint16_t payload_buffer_size, const rp_radio_params_t* radio_params );
+
+/**
+ * @brief rp_task_get_chained_nb get the number of tasks chained behind the task of a hook
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id hook id
+ * @return uint8_t number of chained tasks
+ */
+uint8_t rp_task_get_chained_nb( const radio_planner_t* rp, const uint8_t hook_id );
+#endif
+
 /*!
  *
  */
 rp_hook_status_t rp_task_abort( radio_planner_t* rp, const uint8_t hook_id );
 
+/**
+ * @brief rp_task_wait_start_time busy-wait the start time of a task, to be called by the launch callbacks just before
+ *        the radio command. With the microsecond timebase, the sub-millisecond part of the start time and the
+ *        calibrated launch latency of the task type are taken in account.
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id id of the running task
+ */
+void rp_task_wait_start_time( radio_planner_t* rp, const uint8_t hook_id );
+
+#if defined( ADD_RP_TIMED_TX )
+/**
+ * @brief rp_task_start_tx_at_start_time arm the radio trigger timer on the start time of a Tx task, to be called by
+ *        the launch callbacks once the radio is fully configured instead of waiting the start time and sending the Tx
+ *        command. The tcxo start, the antenna switch and the Tx command are then done from the timer compare
+ *        interrupt, with the calibrated launch latency of the task type taken in account.
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id id of the running task
+ */
+void rp_task_start_tx_at_start_time( radio_planner_t* rp, const uint8_t hook_id );
+#endif
+
+#if defined( ADD_RP_ADMISSION_CONTROL )
+/**
+ * @brief rp_get_free_slot look ahead for the earliest start time at which a task would not overlap an enqueued task
+ *        it would lose the arbitration against (a scheduled or running task of higher priority). Asap tasks are
+ *        ignored as they are moved around the scheduled ones.
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param task task to be enqueued, its start_time_ms is the beginning of the search window
+ * @param window_ms maximum delay allowed from task->start_time_ms
+ * @param start_time_ms the earliest conflict-free start time
+ * @return RP_HOOK_STATUS_OK if a slot has been found, RP_TASK_STATUS_NO_FREE_SLOT otherwise
+ */
+rp_hook_status_t rp_get_free_slot( const radio_planner_t* rp, const rp_task_t* task, const uint32_t window_ms,
+                                   uint32_t* start_time_ms );
+#endif
+
 /*!
  *
  */
 rp_stats_t rp_get_stats( const radio_planner_t* rp );
 
+/**
+ * @brief Get the delay before the radio is used
+ *
+ * @param [in] rp Radio planner object
+ * @return 0 if a task is running or waiting to be launched as soon as possible, the delay until the next scheduled
+ * task otherwise, UINT32_MAX if no task is enqueued
+ */
+uint32_t rp_get_next_task_delay_ms( const radio_planner_t* rp );
+
 /*!
  *
  */
@@ -176,6 +308,95 @@ bool rp_get_irq_flag( void* obj );
  */
 rp_hook_status_t rp_attach_new_radio( radio_planner_t* rp, const ralf_t* radio, const uint8_t hook_id );
 
+#if defined( ADD_RP_MULTI_RADIO )
+/**
+ * @brief rp_multi_radio_register add a radio planner to the planners running in parallel, one per radio.
+ *        Each planner keeps its own timeline, the hardware timer is shared between them. A task can't start while a
+ *        planner sharing RP_SHARED_RESOURCE_RF_PATH runs a task (an asap task is postponed, a scheduled task aborted)
+ *        and RP_SHARED_RESOURCE_TCXO is only stopped once no planner sharing it runs a task.
+ * \remark The radio irq of each radio is attached to rp_radio_irq_callback with its own planner as context
+ *
+ * @param rp pointer to the radioplanner object itself, initialized with rp_init
+ * @param shared_resources RP_SHARED_RESOURCE_* mask of the resources shared with the other radios
+ * @return RP_HOOK_STATUS_OK, RP_HOOK_STATUS_ID_ERROR if RP_MULTI_RADIO_NB_PLANNERS planners are already registered
+ */
+rp_hook_status_t rp_multi_radio_register( radio_planner_t* rp, uint32_t shared_resources );
+
+/**
+ * @brief rp_multi_radio_callback run rp_callback on every registered planner, replaces rp_callback
+ */
+void rp_multi_radio_callback( void );
+
+/**
+ * @brief rp_multi_radio_get_irq_flag check if an irq is pending on any registered planner
+ *
+ * @return true if an irq is pending
+ */
+bool rp_multi_radio_get_irq_flag( void );
+#endif
+
+#if defined( ADD_STACK_FAIRNESS )
+/**
+ * @brief rp_hook_set_stack_id give the hook to a LoRaWAN stack. Between two tasks of the same state (scheduled, asap)
+ *        played by the same role in two stacks, the stack that used the least radio time for its weight wins instead
+ *        of the lowest hook id. The order is taken when a task is enqueued.
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id hook of a per stack role, the hooks of a role are consecutive from stack 0
+ * @param stack_id stack owning the hook, RP_NO_STACK to release it
+ * @return RP_HOOK_STATUS_OK, RP_HOOK_STATUS_ID_ERROR if the hook or the stack does not exist
+ */
+rp_hook_status_t rp_hook_set_stack_id( radio_planner_t* rp, uint8_t hook_id, uint8_t stack_id );
+
+/**
+ * @brief rp_set_stack_weight set the share of the radio time given to a stack
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param stack_id stack identifier
+ * @param weight relative share, from 1 (default) to 255
+ * @return RP_HOOK_STATUS_OK, RP_HOOK_STATUS_ID_ERROR if the stack does not exist or the weight is 0
+ */
+rp_hook_status_t rp_set_stack_weight( radio_planner_t* rp, uint8_t stack_id, uint8_t weight );
+
+/**
+ * @brief rp_get_stack_airtime_ms get the radio time used by the hooks of a stack since rp_init
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param stack_id stack identifier
+ * @return uint32_t radio time in ms (Tx and Rx)
+ */
+uint32_t rp_get_stack_airtime_ms( const radio_planner_t* rp, uint8_t stack_id );
+
+/**
+ * @brief rp_is_stack_served_before compare the radio time used by two stacks, each divided by its weight
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param stack_id_a first stack
+ * @param stack_id_b second stack
+ * @return true if stack_id_a used less radio time for its weight than stack_id_b
+ */
+bool rp_is_stack_served_before( const radio_planner_t* rp, uint8_t stack_id_a, uint8_t stack_id_b );
+#endif
+
+#if defined( ADD_RP_IRQ_FAST_PATH )
+/**
+ * @brief rp_hook_set_irq_fast_path handle the radio irq of the hook tasks in the radio interrupt context: the radio
+ *        status is read and, when the task ends, the radio is released and the next enqueued task armed from
+ *        rp_radio_irq_callback() instead of waiting for the next rp_callback() of the engine. The irq is deferred to
+ *        rp_callback() as before when the engine context is in the planner (enqueue, abort, callback) at that time.
+ *
+ * @remark The hook callbacks are never called in the interrupt context: the callback of the ended task, and those of
+ *         the tasks aborted by the arbitration, are called by the next rp_callback(). A task chained behind the ended
+ *         one (ADD_RP_TASK_CHAIN) follows its hook callback, the irq of such a task is deferred to the engine.
+ *
+ * @param rp pointer to the radioplanner object itself
+ * @param hook_id hook id
+ * @param enable true to handle the irq of the hook in the interrupt context
+ * @return RP_HOOK_STATUS_OK, RP_HOOK_STATUS_ID_ERROR if the hook does not exist
+ */
+rp_hook_status_t rp_hook_set_irq_fast_path( radio_planner_t* rp, const uint8_t hook_id, bool enable );
+#endif
+
 /**
  * @brief Disable failsafe check on radio planner tasks
  *
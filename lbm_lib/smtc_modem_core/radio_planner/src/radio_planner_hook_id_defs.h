@@ -110,10 +110,20 @@ enum RP_HOOK_ID_DEF
     RP_HOOK_ID_BLE_TX_BEACON,
 #endif
 
+#if defined( ADD_BLE_LL )
+    RP_HOOK_ID_BLE_LL_CONN_EVENT,
+    RP_HOOK_ID_BLE_LL_SCAN,
+    RP_HOOK_ID_BLE_LL_ADV,
+#endif
+
 #if defined( ADD_RELAY_RX )
     RP_HOOK_ID_RELAY_RX_CAD,
 #endif  // ADD_RELAY_RX
 
+#if defined( ADD_SMTC_FLRC_TRANSFER )
+    RP_HOOK_ID_FLRC_TRANSFER,
+#endif
+
 #if defined( ADD_RELAY_TX )
     RP_HOOK_ID_RELAY_TX,
 #if defined( ADD_CLASS_C )
@@ -78,20 +78,32 @@ typedef struct rp_stats_s
     uint32_t tx_consumption_ms[RP_NB_HOOKS];
     uint32_t rx_consumption_ms[RP_NB_HOOKS];
     uint32_t none_consumption_ms[RP_NB_HOOKS];
-    uint32_t tx_consumption_ma[RP_NB_HOOKS];
-    uint32_t rx_consumption_ma[RP_NB_HOOKS];
-    uint32_t none_consumption_ma[RP_NB_HOOKS];
+    uint64_t tx_consumption_ua_ms[RP_NB_HOOKS];  // charge in uA.ms, wraps after millions of years
+    uint64_t rx_consumption_ua_ms[RP_NB_HOOKS];
+    uint64_t none_consumption_ua_ms[RP_NB_HOOKS];
     uint32_t tx_total_consumption_ms;
     uint32_t rx_total_consumption_ms;
     uint32_t none_total_consumption_ms;
-    uint32_t tx_total_consumption_ma;
-    uint32_t rx_total_consumption_ma;
-    uint32_t none_total_consumption_ma;
+    uint64_t tx_total_consumption_ua_ms;
+    uint64_t rx_total_consumption_ua_ms;
+    uint64_t none_total_consumption_ua_ms;
     uint32_t tx_timestamp;
     uint32_t rx_timestamp;
     uint32_t none_timestamp;
     uint32_t task_hook_aborted_nb[RP_NB_HOOKS];
     uint32_t rp_error;
+#if defined( ADD_RX_DRIFT )
+    uint32_t rx_window_saved_ms[RP_NB_HOOKS];  // listen time removed from the windows closed on timeout
+    uint32_t rx_window_total_saved_ms;
+#endif
+#if defined( ADD_RP_WARM_STANDBY )
+    uint32_t radio_sleep_nb;         // radio put to sleep at the end of a task
+    uint32_t radio_warm_standby_nb;  // radio kept in standby for a next task closer than its wake up cost
+    uint32_t radio_warm_reuse_nb;    // task launched on a radio still awake from the previous task
+#endif
+#if defined( ADD_RP_HW_TIMESTAMP )
+    uint32_t irq_hw_timestamp_nb;  // radio irqs timestamped from the edge captured in hardware
+#endif
 } rp_stats_t;
 
 /*
@@ -107,13 +119,68 @@ static inline void rp_stats_init( rp_stats_t* rp_stats )
     memset( rp_stats, 0, sizeof( rp_stats_t ) );
 }
 
+/*!
+ * Saturate a 64-bit counter to 32 bits for the 32-bit interfaces
+ */
+static inline uint32_t rp_stats_saturate_u32( uint64_t value )
+{
+    return ( value > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) value;
+}
+
+/*!
+ *
+ */
+static inline uint64_t rp_stats_get_charge_ua_ms( rp_stats_t* rp_stats )
+{
+    return rp_stats->tx_total_consumption_ua_ms + rp_stats->rx_total_consumption_ua_ms +
+           rp_stats->none_total_consumption_ua_ms;
+}
+
+/*!
+ *
+ */
 static inline uint32_t rp_stats_get_charge_mah( rp_stats_t* rp_stats )
 {
-    return ( ( rp_stats->tx_total_consumption_ma + rp_stats->rx_total_consumption_ma +
-               rp_stats->none_total_consumption_ma ) /
-             3600000 );
+    // 1 mAh = 1000 uA * 3600000 ms
+    return rp_stats_saturate_u32( rp_stats_get_charge_ua_ms( rp_stats ) / 3600000000ULL );
+}
+
+/*!
+ *
+ */
+static inline uint32_t rp_stats_get_charge_uah( rp_stats_t* rp_stats )
+{
+    return rp_stats_saturate_u32( rp_stats_get_charge_ua_ms( rp_stats ) / 3600000ULL );
 }
 
+#if defined( ADD_RX_DRIFT )
+/*!
+ * Count the listen time saved by a receive window narrowed from the measured downlink arrival times
+ */
+static inline void rp_stats_add_rx_window_saving( rp_stats_t* rp_stats, uint8_t hook_id, uint32_t saved_ms )
+{
+    rp_stats->rx_window_saved_ms[hook_id] += saved_ms;
+    rp_stats->rx_window_total_saved_ms += saved_ms;
+}
+#endif
+
+#if defined( ADD_RP_WARM_STANDBY )
+/*!
+ * Count the power decision taken for a radio at the end of a task
+ */
+static inline void rp_stats_add_radio_sleep( rp_stats_t* rp_stats, bool is_sleep )
+{
+    if( is_sleep == true )
+    {
+        rp_stats->radio_sleep_nb++;
+    }
+    else
+    {
+        rp_stats->radio_warm_standby_nb++;
+    }
+}
+#endif
+
 /*!
  *
  */
@@ -144,7 +211,7 @@ static inline void rp_stats_set_none_timestamp( rp_stats_t* rp_stats, uint32_t t
 static inline void rp_stats_update( rp_stats_t* rp_stats, uint32_t timestamp, uint8_t hook_id, uint32_t micro_ampere )
 {
     uint32_t computed_time        = 0;
-    uint32_t computed_consumption = 0;
+    uint64_t computed_consumption = 0;
     if( rp_stats->tx_timestamp != 0 )
     {
         // wrapping is impossible with this time base
@@ -153,9 +220,9 @@ static inline void rp_stats_update( rp_stats_t* rp_stats, uint32_t timestamp, ui
         rp_stats->tx_consumption_ms[hook_id] += computed_time;
         rp_stats->tx_total_consumption_ms += computed_time;
 
-        computed_consumption = ( computed_time * micro_ampere );
-        rp_stats->tx_consumption_ma[hook_id] += ( computed_consumption / 1000 );
-        rp_stats->tx_total_consumption_ma += ( computed_consumption / 1000 );
+        computed_consumption = ( uint64_t ) computed_time * micro_ampere;
+        rp_stats->tx_consumption_ua_ms[hook_id] += computed_consumption;
+        rp_stats->tx_total_consumption_ua_ms += computed_consumption;
     }
     if( rp_stats->rx_timestamp != 0 )
     {
@@ -164,9 +231,9 @@ static inline void rp_stats_update( rp_stats_t* rp_stats, uint32_t timestamp, ui
         rp_stats->rx_consumption_ms[hook_id] += computed_time;
         rp_stats->rx_total_consumption_ms += computed_time;
 
-        computed_consumption = ( computed_time * micro_ampere );
-        rp_stats->rx_consumption_ma[hook_id] += ( computed_consumption / 1000 );
-        rp_stats->rx_total_consumption_ma += ( computed_consumption / 1000 );
+        computed_consumption = ( uint64_t ) computed_time * micro_ampere;
+        rp_stats->rx_consumption_ua_ms[hook_id] += computed_consumption;
+        rp_stats->rx_total_consumption_ua_ms += computed_consumption;
     }
     if( rp_stats->none_timestamp != 0 )
     {
@@ -174,9 +241,9 @@ static inline void rp_stats_update( rp_stats_t* rp_stats, uint32_t timestamp, ui
         rp_stats->none_consumption_ms[hook_id] += computed_time;
         rp_stats->none_total_consumption_ms += computed_time;
 
-        computed_consumption = ( computed_time * micro_ampere );
-        rp_stats->none_consumption_ma[hook_id] += ( computed_consumption / 1000 );
-        rp_stats->none_total_consumption_ma += ( computed_consumption / 1000 );
+        computed_consumption = ( uint64_t ) computed_time * micro_ampere;
+        rp_stats->none_consumption_ua_ms[hook_id] += computed_consumption;
+        rp_stats->none_total_consumption_ua_ms += computed_consumption;
     }
     rp_stats->tx_timestamp   = 0;
     rp_stats->rx_timestamp   = 0;
@@ -190,7 +257,7 @@ static inline void rp_stats_sniff_update( rp_stats_t* rp_stats, uint32_t timesta
                                           uint32_t time_proc, uint8_t hook_id, uint32_t ma_radio, uint32_t ma_proc )
 {
     uint32_t computed_time        = 0;
-    uint32_t computed_consumption = 0;
+    uint64_t computed_consumption = 0;
 
     computed_time = timestamp - rp_stats->none_timestamp;
     // SMTC_MODEM_HAL_TRACE_WARNING( "stat %d %d\n", time_radio/1000, time_proc/1000 );
@@ -198,9 +265,10 @@ static inline void rp_stats_sniff_update( rp_stats_t* rp_stats, uint32_t timesta
     rp_stats->none_consumption_ms[hook_id] += computed_time;
     rp_stats->none_total_consumption_ms += computed_time;
 
-    computed_consumption = ( time_radio / 1000 * ma_radio ) + ( time_proc / 1000 * ma_proc );
-    rp_stats->none_consumption_ma[hook_id] += ( computed_consumption / 1000 );
-    rp_stats->none_total_consumption_ma += ( computed_consumption / 1000 );
+    computed_consumption =
+        ( ( uint64_t ) ( time_radio / 1000 ) * ma_radio ) + ( ( uint64_t ) ( time_proc / 1000 ) * ma_proc );
+    rp_stats->none_consumption_ua_ms[hook_id] += computed_consumption;
+    rp_stats->none_total_consumption_ua_ms += computed_consumption;
 
     rp_stats->tx_timestamp   = 0;
     rp_stats->rx_timestamp   = 0;
@@ -219,30 +287,47 @@ static inline void rp_stats_print( rp_stats_t* rp_stats )
     for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
     {
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Tx consumption hook #%ld = %lu ms\n", i, rp_stats->tx_consumption_ms[i] );
-        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Tx consumption hook #%ld = %lu ua\n", i, rp_stats->tx_consumption_ma[i] );
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Tx consumption hook #%ld = %lu uAs\n", i,
+                                        rp_stats_saturate_u32( rp_stats->tx_consumption_ua_ms[i] / 1000 ) );
     }
     for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
     {
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx consumption hook #%ld = %lu ms\n", i, rp_stats->rx_consumption_ms[i] );
-        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx consumption hook #%ld = %lu ua\n", i, rp_stats->rx_consumption_ma[i] );
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx consumption hook #%ld = %lu uAs\n", i,
+                                        rp_stats_saturate_u32( rp_stats->rx_consumption_ua_ms[i] / 1000 ) );
     }
     for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
     {
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( "None consumption hook #%ld = %lu ms\n", i, rp_stats->none_consumption_ms[i] );
-        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "None consumption hook #%ld = %lu ua\n", i, rp_stats->none_consumption_ma[i] );
+        SMTC_MODEM_HAL_RP_TRACE_PRINTF( "None consumption hook #%ld = %lu uAs\n", i,
+                                        rp_stats_saturate_u32( rp_stats->none_consumption_ua_ms[i] / 1000 ) );
     }
     SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Tx total consumption     = %lu ms\n ", rp_stats->tx_total_consumption_ms );
-    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Tx total consumption     = %lu uA\n ", rp_stats->tx_total_consumption_ma );
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Tx total consumption     = %lu uAs\n ",
+                                    rp_stats_saturate_u32( rp_stats->tx_total_consumption_ua_ms / 1000 ) );
     SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx total consumption     = %lu ms\n ", rp_stats->rx_total_consumption_ms );
-    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx total consumption     = %lu uA\n ", rp_stats->rx_total_consumption_ma );
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx total consumption     = %lu uAs\n ",
+                                    rp_stats_saturate_u32( rp_stats->rx_total_consumption_ua_ms / 1000 ) );
     SMTC_MODEM_HAL_RP_TRACE_PRINTF( "None total consumption   = %lu ms\n ", rp_stats->none_total_consumption_ms );
-    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "None total consumption   = %lu uA\n ", rp_stats->none_total_consumption_ma );
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "None total consumption   = %lu uAs\n ",
+                                    rp_stats_saturate_u32( rp_stats->none_total_consumption_ua_ms / 1000 ) );
 
     for( int32_t i = 0; i < RP_NB_HOOKS; i++ )
     {
         SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Number of aborted tasks for hook #%ld = %lu \n", i,
                                         rp_stats->task_hook_aborted_nb[i] );
     }
+#if defined( ADD_RX_DRIFT )
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Rx window listen time saved = %lu ms\n", rp_stats->rx_window_total_saved_ms );
+#endif
+#if defined( ADD_RP_WARM_STANDBY )
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Radio sleeps = %lu, warm standbys = %lu, warm reuses = %lu\n",
+                                    rp_stats->radio_sleep_nb, rp_stats->radio_warm_standby_nb,
+                                    rp_stats->radio_warm_reuse_nb );
+#endif
+#if defined( ADD_RP_HW_TIMESTAMP )
+    SMTC_MODEM_HAL_RP_TRACE_PRINTF( "Radio irqs timestamped in hardware = %lu\n", rp_stats->irq_hw_timestamp_nb );
+#endif
     SMTC_MODEM_HAL_RP_TRACE_PRINTF( "RP: number of errors is %lu\n\n\n", rp_stats->rp_error );
 }
 #endif  // RP_STAT_PRINT_ENBALE
@@ -0,0 +1,190 @@
+/*!
+ * \file      radio_planner_trace.h
+ *
+ * \brief     Radio planner binary event trace
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RADIO_PLANNER_TRACE_H
+#define RADIO_PLANNER_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <string.h>   // for memset
+
+#include "smtc_modem_hal.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*!
+ * Number of events of the trace ring, shall be a power of 2
+ */
+#ifndef RP_TRACE_NB_EVENTS
+#define RP_TRACE_NB_EVENTS 32
+#endif
+
+#if( ( RP_TRACE_NB_EVENTS & ( RP_TRACE_NB_EVENTS - 1 ) ) != 0 )
+#error "RP_TRACE_NB_EVENTS shall be a power of 2"
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * Trace event types, the meaning of the data field depends on the event
+ */
+typedef enum rp_trace_event_type_e
+{
+    RP_TRACE_EVENT_ENQUEUE = 1,  // data: task type (msb) and task state (lsb)
+    RP_TRACE_EVENT_ARBITER = 2,  // hook: priority task, data: delay to its start time in ms (int16_t, saturated)
+    RP_TRACE_EVENT_LAUNCH  = 3,  // data: task type
+    RP_TRACE_EVENT_IRQ     = 4,  // data: radio planner status of the hook
+    RP_TRACE_EVENT_ABORT   = 5,  // data: task type
+} rp_trace_event_type_t;
+
+/*!
+ *
+ */
+typedef struct rp_trace_event_s
+{
+    uint32_t timestamp_us;
+    uint8_t  type;
+    uint8_t  hook_id;
+    uint16_t data;
+} rp_trace_event_t;
+
+/*!
+ * Single producer (radio planner) single consumer ring: the producer only writes write_count and lost_events, the
+ * consumer only writes read_count. When the ring is full new events are dropped and counted.
+ */
+typedef struct rp_trace_s
+{
+    rp_trace_event_t  events[RP_TRACE_NB_EVENTS];
+    volatile uint32_t write_count;
+    volatile uint32_t read_count;
+    volatile uint32_t lost_events;
+} rp_trace_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/*!
+ *
+ */
+static inline void rp_trace_init( rp_trace_t* rp_trace )
+{
+    memset( rp_trace, 0, sizeof( rp_trace_t ) );
+}
+
+/*!
+ * Timestamp of the events, in us. Without the microsecond timebase the resolution is the millisecond.
+ */
+static inline uint32_t rp_trace_get_timestamp_us( void )
+{
+#if defined( ADD_RP_US_TIMEBASE )
+    return smtc_modem_hal_get_time_in_us( );
+#else
+    return smtc_modem_hal_get_time_in_ms( ) * 1000;
+#endif
+}
+
+/*!
+ *
+ */
+static inline void rp_trace_add( rp_trace_t* rp_trace, const rp_trace_event_type_t type, const uint8_t hook_id,
+                                 const uint16_t data )
+{
+    uint32_t write_count = rp_trace->write_count;
+
+    if( ( write_count - rp_trace->read_count ) >= RP_TRACE_NB_EVENTS )
+    {
+        rp_trace->lost_events++;
+        return;
+    }
+
+    rp_trace_event_t* event = &rp_trace->events[write_count & ( RP_TRACE_NB_EVENTS - 1 )];
+
+    event->timestamp_us = rp_trace_get_timestamp_us( );
+    event->type         = ( uint8_t ) type;
+    event->hook_id      = hook_id;
+    event->data         = data;
+
+    // The event shall be written before being published to the consumer
+    __asm volatile( "" ::: "memory" );
+    rp_trace->write_count = write_count + 1;
+}
+
+/*!
+ * Pop the oldest event of the trace, return false if the trace is empty
+ */
+static inline bool rp_trace_read( rp_trace_t* rp_trace, rp_trace_event_t* event )
+{
+    uint32_t read_count = rp_trace->read_count;
+
+    if( read_count == rp_trace->write_count )
+    {
+        return false;
+    }
+    __asm volatile( "" ::: "memory" );
+    *event = rp_trace->events[read_count & ( RP_TRACE_NB_EVENTS - 1 )];
+
+    // The event shall be copied before the slot is released to the producer
+    __asm volatile( "" ::: "memory" );
+    rp_trace->read_count = read_count + 1;
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RADIO_PLANNER_TRACE_H
+
+/* --- EOF ------------------------------------------------------------------ */
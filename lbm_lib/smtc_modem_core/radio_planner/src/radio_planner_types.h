@@ -70,6 +70,16 @@ extern "C" {
 
 #define RP_NB_USER_HOOK                             3
 
+/*
+ * Number of 32-bit words of the enqueued tasks bitmap
+ */
+#define RP_ACTIVE_HOOKS_WORDS                       ( ( RP_NB_HOOKS + 31 ) / 32 )
+
+/*
+ * Hook not owned by a LoRaWAN stack, see rp_hook_set_stack_id
+ */
+#define RP_NO_STACK                                 0xFF
+
 
 
 /*!
@@ -89,6 +99,49 @@ extern "C" {
 #define RP_MARGIN_DELAY                             8
 #endif
 
+/*!
+ * Initial launch latency in us (end of the start time wait to end of the launch callback) used with the microsecond
+ * timebase, it is then calibrated at each launch for each task type
+ */
+#ifndef RP_LAUNCH_LATENCY_US
+#if defined( LR11XX )
+#define RP_LAUNCH_LATENCY_US                        300
+#elif defined( SX128X )
+#define RP_LAUNCH_LATENCY_US                        200
+#else
+#define RP_LAUNCH_LATENCY_US                        150
+#endif
+#endif
+
+/*!
+ * Maximum launch latency in us taken in account by the calibration
+ */
+#define RP_LAUNCH_LATENCY_MAX_US                    1000
+
+#if defined( ADD_RP_TIMED_TX )
+#if !defined( ADD_RP_US_TIMEBASE )
+#error "ADD_RP_TIMED_TX requires ADD_RP_US_TIMEBASE"
+#endif
+/*!
+ * Delay in us under which the timed Tx command is sent right away instead of arming the radio trigger timer
+ */
+#ifndef RP_TIMED_TX_MIN_DELAY_US
+#define RP_TIMED_TX_MIN_DELAY_US                    100
+#endif
+#endif
+
+/*!
+ * Time in ms for the radio to wake up from sleep, the TCXO startup excluded, used with the warm standby to keep the
+ * radio awake between two tasks closer than its wake up cost
+ */
+#ifndef RP_RADIO_WAKE_UP_TIME_MS
+#if defined( LR11XX )
+#define RP_RADIO_WAKE_UP_TIME_MS                    2
+#else
+#define RP_RADIO_WAKE_UP_TIME_MS                    1
+#endif
+#endif
+
 
 
 /*!
@@ -113,6 +166,21 @@ extern "C" {
  */
 #define RP_DISABLE_FAILSAFE_KEY                     0xF00D4BEE
 
+#ifndef RP_MULTI_RADIO_NB_PLANNERS
+#define RP_MULTI_RADIO_NB_PLANNERS                  2
+#endif
+
+// Resources shared by the radios of a multi radio board, see rp_multi_radio_register
+#define RP_SHARED_RESOURCE_TCXO                     ( 1UL << 0 )  // released when no radio uses it anymore
+#define RP_SHARED_RESOURCE_RF_PATH                  ( 1UL << 1 )  // antenna switch/RF path, one radio at a time
+
+/*!
+ * Number of tasks waiting behind the task of their hook, shared by all the hooks, see rp_task_enqueue_chained
+ */
+#ifndef RP_TASK_CHAIN_NB_TASKS
+#define RP_TASK_CHAIN_NB_TASKS                      4
+#endif
+
 /* clang-format on */
 
 /*
@@ -133,6 +201,7 @@ typedef struct rp_radio_params_s
             ralf_params_gfsk_t    gfsk;
             ralf_params_lora_t    lora;
             ralf_params_lr_fhss_t lr_fhss;
+            ralf_params_flrc_t    flrc;
         };
     } tx;
     struct
@@ -142,13 +211,23 @@ typedef struct rp_radio_params_s
             ralf_params_gfsk_t     gfsk;
             ralf_params_lora_t     lora;
             ralf_params_lora_cad_t lora_cad;
+            ralf_params_flrc_t     flrc;
         };
         uint32_t              timeout_in_ms;
+#if defined( ADD_RX_BOOST_POLICY )
+        bool rx_boosted;  // Receive with the boosted gain, applied by the launch callbacks that support it
+#endif
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+        // FSK only, 0 to keep the rx timer running until the sync word. Otherwise the launch callback stops the timer
+        // on the preamble and the planner closes the window if no sync word is found within this time
+        uint32_t sync_timeout_in_ms;
+#endif
         ral_lora_cad_params_t cad;
         union
         {
             ral_gfsk_rx_pkt_status_t gfsk_pkt_status;
             ral_lora_rx_pkt_status_t lora_pkt_status;
+            ral_flrc_rx_pkt_status_t flrc_pkt_status;
         };
     } rx;
     int16_t lbt_threshold;
@@ -177,6 +256,8 @@ typedef enum rp_task_types_e
     RP_TASK_TYPE_TX_BLE,
     RP_TASK_TYPE_RX_BLE,
     RP_TASK_TYPE_RX_BLE_SCAN,
+    RP_TASK_TYPE_TX_FLRC,
+    RP_TASK_TYPE_RX_FLRC,
     RP_TASK_TYPE_NONE,
 } rp_task_types_t;
 
@@ -210,6 +291,9 @@ typedef enum rp_status_e
     RP_STATUS_TASK_ABORTED,
     RP_STATUS_TASK_INIT,
     RP_STATUS_LR_FHSS_HOP,
+#if defined( ADD_FSK_RX_PREAMBLE_TIMEOUT )
+    RP_STATUS_RX_ONGOING,  // preamble or sync word detected, the reception goes on
+#endif
 } rp_status_t;
 
 typedef enum rp_next_state_status_e
@@ -231,12 +315,38 @@ typedef struct rp_task_s
     rp_task_states_t state;
     // absolute Ms
     uint32_t start_time_ms;
+    // sub-millisecond part of the start time (0 to 999 us), only used with the microsecond timebase
+    uint16_t start_time_us;
     // Have to keep the initial start time to be able to switch asap task to
     // schedule task after long period
     uint32_t start_time_init_ms;
     uint32_t duration_time_ms;
+    // CAD_TO_RX only: number of negative CADs after which the hook keeps the radio to run the next CAD itself
+    uint8_t cad_sweep_hops;
+#if defined( ADD_RP_ADMISSION_CONTROL )
+    // SCHEDULE only: refuse the task at enqueue time if it overlaps a task it would lose the arbitration against
+    bool admission_check;
+#endif
+#if defined( ADD_RP_RX_CONTINUOUS )
+    // RX_LORA and RX_FSK only: the radio is launched in continuous reception, the task keeps running after a packet or
+    // a crc error and the hook is called for each of them until the task is aborted
+    bool rx_continuous;
+#endif
 } rp_task_t;
 
+#if defined( ADD_RP_TASK_CHAIN )
+/*!
+ * Task enqueued by rp_task_enqueue_chained, with the parameters given to the enqueue
+ */
+typedef struct rp_chained_task_s
+{
+    rp_task_t         task;
+    rp_radio_params_t radio_params;
+    uint8_t*          payload;
+    uint16_t          payload_buffer_size;
+} rp_chained_task_t;
+#endif
+
 /*!
  *
  */
@@ -247,6 +357,8 @@ typedef enum rp_hook_status_e
     RP_TASK_STATUS_ALREADY_RUNNING,
     RP_TASK_STATUS_SCHEDULE_TASK_IN_PAST,
     RP_TASK_STATUS_TASK_TOO_FAR_IN_FUTURE,
+    RP_TASK_STATUS_SCHEDULE_TASK_IN_CONFLICT,
+    RP_TASK_STATUS_NO_FREE_SLOT,
 } rp_hook_status_t;
 
 /*!
@@ -46,7 +46,10 @@
 #include "lorawan_send_management.h"
 #include "lorawan_cid_request_management.h"
 #include "lorawan_class_b_management.h"
+#include "lorawan_dwn_ack_management.h"
 #include "smtc_modem_hal_dbg_trace.h"
+#include "smtc_modem_dbg_profile.h"
+#include "smtc_modem_dbg_latency.h"
 #include "modem_supervisor_light.h"
 #include "modem_core.h"
 #include "smtc_real_defs.h"
@@ -82,6 +85,8 @@
 #include "ralf_lr11xx.h"
 #elif defined( SX127X )
 #include "ralf_sx127x.h"
+#elif defined( VIRTUAL_RADIO )
+#include "ralf_virtual.h"
 #endif
 
 #if defined( ADD_SMTC_STREAM )
@@ -107,14 +112,42 @@
 #include "relay_rx_api.h"
 #endif
 
+#if defined( ADD_SMTC_PAYLOAD_COMPRESSION )
+#include "payload_compression.h"
+#endif
+
 #if defined( ADD_SMTC_STORE_AND_FORWARD )
 #include "store_and_forward_flash.h"
 #endif
 
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+#include "modem_request_queue.h"
+#endif
+
+#if defined( ADD_SMTC_LOW_POWER_HINT )
+#include "modem_timer.h"
+#endif
+
+#if defined( ADD_SMTC_SERVICE_STATS )
+#include "modem_tx_protocol_manager.h"
+#endif
+
+#if defined( ADD_SMTC_BATTERY_ESTIMATOR )
+#include "modem_battery_estimator.h"
+#endif
+
+#if defined( ADD_SMTC_MULTI_INSTANCE )
+#include "modem_instance.h"
+#endif
+
 #if defined( USE_LR11XX_CE ) && ( ADD_FUOTA == 2 )
 #include "aes.h"
 #endif  // USE_LR11XX_CE && ( ADD_FUOTA == 2 )
 
+#if defined( ADD_FUOTA ) && ( ADD_FUOTA == 2 ) && defined( FRAG_DECODER_DEFERRED )
+#include "lorawan_fragmentation_package.h"
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE MACROS-----------------------------------------------------------
@@ -141,6 +174,17 @@
         }                                 \
     } while( 0 )
 
+/**
+ * @brief Serialize the engine with the application threads calling the modem api (LBM_THREAD_SAFE=yes)
+ */
+#if defined( ADD_SMTC_THREAD_SAFE )
+#define MODEM_ENGINE_LOCK( ) smtc_modem_hal_lock_modem( )
+#define MODEM_ENGINE_UNLOCK( ) smtc_modem_hal_unlock_modem( )
+#else
+#define MODEM_ENGINE_LOCK( )
+#define MODEM_ENGINE_UNLOCK( )
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -196,6 +240,9 @@ ralf_t modem_radio = RALF_LR11XX_INSTANTIATE( NULL );
 #include "sx127x.h"
 static sx127x_t sx127x;
 ralf_t          modem_radio = RALF_SX127X_INSTANTIATE( &sx127x );
+#elif defined( VIRTUAL_RADIO )
+static ral_virtual_t virtual_radio;
+ralf_t               modem_radio = RALF_VIRTUAL_INSTANTIATE( &virtual_radio );
 #else
 #error "Please select radio board.."
 #endif
@@ -236,6 +283,14 @@ static void modem_store_key_context( void );
 static void modem_load_appkey_context( void );
 #endif
 
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+static void modem_drain_request_queue( void );
+#endif
+
+static void smtc_modem_event_fill_data( smtc_modem_event_t* event, uint8_t status );
+
+static smtc_modem_class_t smtc_modem_get_running_class( uint8_t stack_id );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -246,6 +301,13 @@ static void modem_load_appkey_context( void );
 void smtc_modem_init( void ( *callback_event )( void ) )
 {
     SMTC_MODEM_HAL_TRACE_INFO( "Modem Initialization\n" );
+#if defined( ADD_SMTC_PROFILE )
+    smtc_modem_dbg_profile_init( );
+#endif
+#if defined( ADD_SMTC_LATENCY_HISTOGRAM )
+    smtc_modem_dbg_latency_init( );
+#endif
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_MODEM_INIT );
 
     // init radio and put it in sleep mode
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_reset( &( modem_radio.ral ) ) == RAL_STATUS_OK );
@@ -254,6 +316,16 @@ void smtc_modem_init( void ( *callback_event )( void ) )
     smtc_modem_hal_set_ant_switch( false );
     // init radio planner and attach corresponding radio irq
     rp_init( &modem_radio_planner, &modem_radio );
+#if defined( ADD_SMTC_BATTERY_ESTIMATOR )
+    // The observation starts with the radio planner charge, cleared by rp_init
+    modem_battery_estimator_init( );
+#endif
+#if defined( ADD_RP_MULTI_RADIO )
+    // The application registers the planners of its other radios with the resources they share with this one
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        rp_multi_radio_register( &modem_radio_planner, RP_SHARED_RESOURCE_TCXO | RP_SHARED_RESOURCE_RF_PATH ) ==
+        RP_HOOK_STATUS_OK );
+#endif
 
     smtc_modem_hal_irq_config_radio_irq( rp_radio_irq_callback, &modem_radio_planner );
 
@@ -262,6 +334,10 @@ void smtc_modem_init( void ( *callback_event )( void ) )
 
     smtc_secure_element_init( );
     modem_supervisor_init( );
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+    modem_request_queue_init( );
+#endif
+    rp_set_hook_callback_done( &modem_radio_planner, modem_supervisor_notify_engine_wakeup );
     modem_context_init_light( callback_event, &modem_radio_planner );
     modem_tx_protocol_manager_init( &modem_radio_planner );
     // If lr11xx crypto engine is used for crypto
@@ -270,12 +346,63 @@ void smtc_modem_init( void ( *callback_event )( void ) )
 #endif
     // Event EVENT_RESET must be done at the end of init !!
     increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_RESET, 0, 0xFF );
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_MODEM_INIT );
 }
 
 uint32_t smtc_modem_run_engine( void )
 {
+    MODEM_ENGINE_LOCK( );
+    // The engine computes its next wake up on its own, no notification is needed while it runs
+    modem_supervisor_set_engine_running( true );
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+    const uint32_t request_push_count = modem_request_queue_get_push_count( );
+    modem_drain_request_queue( );
+#endif
+#if defined( ADD_RP_MULTI_RADIO )
+    rp_multi_radio_callback( );
+#else
     rp_callback( &modem_radio_planner );
-    return modem_supervisor_engine( );
+#endif
+    SMTC_MODEM_HAL_PROFILE_BEGIN( SMTC_PROFILE_SUPERVISOR_ENGINE );
+    uint32_t sleep_time_ms = modem_supervisor_engine( );
+    SMTC_MODEM_HAL_PROFILE_END( SMTC_PROFILE_SUPERVISOR_ENGINE );
+    modem_supervisor_set_engine_running( false );
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+    if( modem_request_queue_get_push_count( ) != request_push_count )
+    {
+        // A request pushed while the engine was running did not notify it, it is drained by an immediate new call
+        sleep_time_ms = 0;
+    }
+#endif
+    MODEM_ENGINE_UNLOCK( );
+
+    // Pending context stores are written together when the modem goes idle. The lock is released in between so that
+    // an application thread waiting for it is not held behind both the radio processing and the flash writes
+    MODEM_ENGINE_LOCK( );
+    modem_context_flush_on_idle( sleep_time_ms );
+#if defined( ADD_SMTC_STORE_AND_FORWARD_PRE_ERASE )
+    store_and_forward_flash_pre_erase_on_idle( sleep_time_ms );
+#endif
+#if defined( ADD_SMTC_STORE_AND_FORWARD ) && defined( ADD_SMTC_FAST_BOOT )
+    store_and_forward_flash_mount_on_idle( sleep_time_ms );
+#endif
+#if defined( ADD_FUOTA ) && ( ADD_FUOTA == 2 ) && defined( FRAG_DECODER_DEFERRED )
+    sleep_time_ms = lorawan_fragmentation_package_decode_on_idle( sleep_time_ms );
+#endif
+    MODEM_ENGINE_UNLOCK( );
+    return sleep_time_ms;
+}
+
+void smtc_modem_run_radio_planner( void )
+{
+    MODEM_ENGINE_LOCK( );
+    // A hook completed here notifies the engine through the radio planner hook done callback
+#if defined( ADD_RP_MULTI_RADIO )
+    rp_multi_radio_callback( );
+#else
+    rp_callback( &modem_radio_planner );
+#endif
+    MODEM_ENGINE_UNLOCK( );
 }
 
 void smtc_modem_set_radio_context( const void* radio_ctx )
@@ -283,6 +410,9 @@ void smtc_modem_set_radio_context( const void* radio_ctx )
 #if defined( SX1272 ) || defined( SX1276 )
     // update modem_radio context with provided one
     ( ( sx127x_t* ) modem_radio.ral.context )->hal_context = radio_ctx;
+#elif defined( VIRTUAL_RADIO )
+    // the simulated radio keeps the board context for its BSP
+    ( ( ral_virtual_t* ) modem_radio.ral.context )->hal_context = radio_ctx;
 #else
     // update modem_radio context with provided one
     modem_radio.ral.context = radio_ctx;
@@ -299,7 +429,74 @@ const void* smtc_modem_get_radio_context( void )
 
 bool smtc_modem_is_irq_flag_pending( void )
 {
+#if defined( ADD_RP_MULTI_RADIO )
+    return rp_multi_radio_get_irq_flag( );
+#else
     return rp_get_irq_flag( &modem_radio_planner );
+#endif
+}
+
+void smtc_modem_set_engine_wakeup_callback( void ( *wakeup_callback )( void ) )
+{
+    modem_supervisor_set_engine_wakeup_callback( wakeup_callback );
+}
+
+#if defined( ADD_SMTC_LOW_POWER_HINT )
+void smtc_modem_enter_low_power( uint32_t sleep_time_ms )
+{
+    const uint32_t          timer_delay_ms = modem_timer_get_next_delay_ms( );
+    const uint32_t          budget_ms      = ( timer_delay_ms < sleep_time_ms ) ? timer_delay_ms : sleep_time_ms;
+    smtc_modem_hal_wakeup_t wakeup         = SMTC_MODEM_HAL_WAKEUP_TIMER;
+
+    // A scheduled radio task is started by the radio planner alarm, already counted in the modem timers, a running
+    // one ends with a radio interrupt whose time is not known
+    if( rp_get_next_task_delay_ms( &modem_radio_planner ) == 0 )
+    {
+        wakeup = SMTC_MODEM_HAL_WAKEUP_RADIO_IRQ;
+    }
+    if( budget_ms == 0 )
+    {
+        return;
+    }
+    smtc_modem_hal_enter_low_power( ( budget_ms < ( UINT32_MAX / 1000 ) ) ? ( budget_ms * 1000 ) : UINT32_MAX,
+                                    wakeup );
+}
+#endif
+
+void smtc_modem_context_flush( void )
+{
+    modem_context_flush( );
+}
+
+uint32_t smtc_modem_instance_get_size( void )
+{
+#if defined( ADD_SMTC_MULTI_INSTANCE )
+    return modem_instance_get_size( );
+#else
+    return 0;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_instance_init( smtc_modem_instance_t* instance )
+{
+    RETURN_INVALID_IF_NULL( instance );
+#if defined( ADD_SMTC_MULTI_INSTANCE )
+    modem_instance_init( instance );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_instance_select( smtc_modem_instance_t* instance )
+{
+    RETURN_INVALID_IF_NULL( instance );
+#if defined( ADD_SMTC_MULTI_INSTANCE )
+    modem_instance_select( instance );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
 }
 
 /* ------------ Modem Generic Api ------------*/
@@ -625,7 +822,8 @@ smtc_modem_return_code_t smtc_modem_adr_set_profile(
         }
     }
     if( ( adr_profile == SMTC_MODEM_ADR_PROFILE_MOBILE_LONG_RANGE ) ||
-        ( adr_profile == SMTC_MODEM_ADR_PROFILE_MOBILE_LOW_POWER ) || ( adr_profile == SMTC_MODEM_ADR_PROFILE_CUSTOM ) )
+        ( adr_profile == SMTC_MODEM_ADR_PROFILE_MOBILE_LOW_POWER ) || ( adr_profile == SMTC_MODEM_ADR_PROFILE_CUSTOM ) ||
+        ( adr_profile == SMTC_MODEM_ADR_PROFILE_LINK_QUALITY ) )
     {
         // reset current adr mobile count
         lorawan_api_reset_no_rx_packet_in_mobile_mode_cnt( stack_id );
@@ -664,6 +862,12 @@ smtc_modem_return_code_t smtc_modem_adr_set_profile(
         status = lorawan_api_dr_strategy_set( USER_DR_DISTRIBUTION, stack_id );
         break;
     }
+#if defined( ADD_LINK_ADR )
+    case SMTC_MODEM_ADR_PROFILE_LINK_QUALITY:
+        // update profile in lorawan stack
+        status = lorawan_api_dr_strategy_set( LINK_QUALITY_DR_DISTRIBUTION, stack_id );
+        break;
+#endif
     default:
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "Unknown adr profile %d\n ", adr_profile );
@@ -711,6 +915,9 @@ smtc_modem_return_code_t smtc_modem_adr_get_profile( uint8_t stack_id, smtc_mode
     case USER_DR_DISTRIBUTION:
         *adr_profile = SMTC_MODEM_ADR_PROFILE_CUSTOM;
         break;
+    case LINK_QUALITY_DR_DISTRIBUTION:
+        *adr_profile = SMTC_MODEM_ADR_PROFILE_LINK_QUALITY;
+        break;
     default:
         return_code = SMTC_MODEM_RC_FAIL;
         break;
@@ -719,6 +926,68 @@ smtc_modem_return_code_t smtc_modem_adr_get_profile( uint8_t stack_id, smtc_mode
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_adr_set_link_margin( uint8_t stack_id, uint8_t margin_db )
+{
+#if defined( ADD_LINK_ADR )
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    if( lorawan_api_set_link_adr_margin( margin_db, stack_id ) != OKLORAWAN )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( margin_db );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_adr_set_tx_power_control( uint8_t stack_id, bool enable )
+{
+#if defined( ADD_LINK_ADR )
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    lorawan_api_set_link_adr_power_control( enable, stack_id );
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( enable );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_adr_set_delivery_target( uint8_t stack_id, uint8_t target_percent )
+{
+#if defined( ADD_LINK_ADR )
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    if( lorawan_api_set_link_adr_delivery_target( target_percent, stack_id ) != OKLORAWAN )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( target_percent );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_adr_set_bulk_transfer( uint8_t stack_id, bool enable )
+{
+#if defined( ADD_LINK_ADR )
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    lorawan_api_set_link_adr_bulk( enable, stack_id );
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( enable );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
 smtc_modem_return_code_t smtc_modem_get_available_datarates( uint8_t stack_id, uint16_t* available_datarates_mask )
 {
     RETURN_BUSY_IF_TEST_MODE( );
@@ -757,6 +1026,13 @@ smtc_modem_return_code_t smtc_modem_join_network( uint8_t stack_id )
         increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_JOINED, 0, stack_id );
         return_code = SMTC_MODEM_RC_OK;
     }
+#if defined( ADD_SESSION_RESUME )
+    else if( lorawan_api_session_resume( stack_id ) == OKLORAWAN )
+    {
+        // The session stored before the reset is still valid, joined without a join request
+        increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_JOINED, 0, stack_id );
+    }
+#endif
     else
     {
         // Launch OTAA task
@@ -776,6 +1052,97 @@ smtc_modem_return_code_t smtc_modem_request_uplink( uint8_t stack_id, uint8_t f_
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_request_uplink_buffer( uint8_t stack_id, uint8_t** payload,
+                                                           uint8_t* max_payload_length )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( payload );
+    RETURN_INVALID_IF_NULL( max_payload_length );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    if( lorawan_send_payload_buffer_is_in_use( stack_id ) == true )
+    {
+        return SMTC_MODEM_RC_BUSY;
+    }
+    *payload            = lorawan_send_get_payload_buffer( stack_id );
+    *max_payload_length = SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH;
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_commit_uplink_buffer( uint8_t stack_id, uint8_t f_port, bool confirmed,
+                                                          uint8_t payload_length )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    return smtc_modem_send_tx( stack_id, f_port, confirmed, lorawan_send_get_payload_buffer( stack_id ),
+                               payload_length, false );
+}
+
+smtc_modem_return_code_t smtc_modem_request_uplink_with_callback( uint8_t stack_id, uint8_t f_port, bool confirmed,
+                                                                  smtc_modem_uplink_fill_callback_t fill_callback,
+                                                                  void* context )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( fill_callback );
+
+    smtc_modem_return_code_t return_code = smtc_modem_send_tx( stack_id, f_port, confirmed, NULL, 0, false );
+    if( return_code == SMTC_MODEM_RC_OK )
+    {
+        lorawan_send_set_fill_callback( stack_id, fill_callback, context );
+    }
+    return return_code;
+}
+
+smtc_modem_return_code_t smtc_modem_queue_uplink( uint8_t stack_id, uint8_t f_port, bool confirmed,
+                                                  const uint8_t* payload, uint8_t payload_length )
+{
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    if( ( ( payload == NULL ) && ( payload_length > 0 ) ) ||
+        ( payload_length > MODEM_REQUEST_QUEUE_MAX_PAYLOAD_LENGTH ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( modem_request_queue_push( stack_id, f_port, true, confirmed, payload, payload_length ) == false )
+    {
+        return SMTC_MODEM_RC_BUSY;
+    }
+    modem_supervisor_notify_engine_wakeup( );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_queue_empty_uplink( uint8_t stack_id, bool send_fport, uint8_t f_port,
+                                                        bool confirmed )
+{
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    if( modem_request_queue_push( stack_id, f_port, send_fport, confirmed, NULL, 0 ) == false )
+    {
+        return SMTC_MODEM_RC_BUSY;
+    }
+    modem_supervisor_notify_engine_wakeup( );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
 smtc_modem_return_code_t smtc_modem_get_event( smtc_modem_event_t* event, uint8_t* event_pending_count )
 {
     RETURN_INVALID_IF_NULL( event );
@@ -797,103 +1164,8 @@ smtc_modem_return_code_t smtc_modem_get_event( smtc_modem_event_t* event, uint8_
 
         *event_pending_count = event_count - 1;
 
-        switch( event->event_type )
-        {
-        case SMTC_MODEM_EVENT_RESET:
-            event->event_data.reset.count = ( uint16_t ) modem_get_reset_counter( );
-            break;
-        case SMTC_MODEM_EVENT_TXDONE:
-            event->event_data.txdone.status =
-                ( smtc_modem_event_txdone_status_t ) get_modem_event_status( event->event_type );
-            break;
-
-        case SMTC_MODEM_EVENT_LINK_CHECK:
-            event->event_data.link_check.status =
-                ( smtc_modem_event_mac_request_status_t ) get_modem_event_status( event->event_type );
-            break;
-
-        case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
-            event->event_data.class_b_ping_slot_info.status =
-                ( smtc_modem_event_mac_request_status_t ) get_modem_event_status( event->event_type );
-            break;
-
-        case SMTC_MODEM_EVENT_CLASS_B_STATUS:
-            event->event_data.class_b_status.status =
-                ( smtc_modem_event_class_b_status_t ) get_modem_event_status( event->event_type );
-            break;
-
-        case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
-            event->event_data.lorawan_mac_time.status =
-                ( smtc_modem_event_mac_request_status_t ) get_modem_event_status( event->event_type );
-            break;
-        case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
-            event->event_data.fuota_status.successful =
-                ( get_modem_event_status( event->event_type ) == 0 ) ? true : false;
-            break;
+        smtc_modem_event_fill_data( event, get_modem_event_status( event->event_type ) );
 
-        case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
-            event->event_data.new_multicast_class_c.group_id = get_modem_event_status( event->event_type );
-            break;
-
-        case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
-            event->event_data.new_multicast_class_b.group_id = get_modem_event_status( event->event_type );
-            break;
-
-#if defined( ENABLE_FUOTA_FMP )
-        case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
-            event->event_data.fmp.status = get_modem_event_status( event->event_type );
-            break;
-#endif
-
-#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
-        case SMTC_MODEM_EVENT_DM_SET_CONF:
-            event->event_data.setconf.opcode =
-                ( smtc_modem_event_setconf_opcode_t ) get_modem_event_status( event->event_type );
-            break;
-        case SMTC_MODEM_EVENT_MUTE:
-            event->event_data.mute.status =
-                ( smtc_modem_event_mute_status_t ) get_modem_event_status( event->event_type );
-            break;
-#endif
-#if defined( ADD_SMTC_LFU )
-        case SMTC_MODEM_EVENT_UPLOAD_DONE:
-            event->event_data.uploaddone.status = get_modem_event_status( event->event_type );
-            break;
-#endif  // ADD_SMTC_LFU
-
-#if defined( ADD_RELAY_TX )
-        case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
-        case SMTC_MODEM_EVENT_RELAY_TX_MODE:
-        case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
-            event->event_data.relay_tx.status = get_modem_event_status( event->event_type );
-            break;
-#endif
-
-#if defined( ADD_RELAY_RX )
-        case SMTC_MODEM_EVENT_RELAY_RX_RUNNING:
-            event->event_data.relay_rx.status = get_modem_event_status( event->event_type );
-            break;
-#endif
-
-        case SMTC_MODEM_EVENT_TEST_MODE:
-            event->event_data.test_mode_status.status = get_modem_event_status( event->event_type );
-            break;
-        case SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE:
-            event->event_data.regional_duty_cycle.status = get_modem_event_status( event->event_type );
-            break;
-        case SMTC_MODEM_EVENT_DOWNDATA:
-        case SMTC_MODEM_EVENT_ALARM:
-        case SMTC_MODEM_EVENT_JOINED:
-        case SMTC_MODEM_EVENT_JOINFAIL:
-        case SMTC_MODEM_EVENT_ALCSYNC_TIME:
-        case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
-        case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
-#if defined( ADD_SMTC_STREAM )
-        case SMTC_MODEM_EVENT_STREAM_DONE:
-#endif
-        default:
-            break;
-        }
         // Reset the status after get the value
         set_modem_event_count_and_status( event->event_type, 0, 0 );
         decrement_asynchronous_msgnumber( );
@@ -906,6 +1178,44 @@ smtc_modem_return_code_t smtc_modem_get_event( smtc_modem_event_t* event, uint8_
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_get_events( smtc_modem_event_record_t* events, uint8_t max_events,
+                                                uint8_t* nb_events, uint8_t* event_pending_count )
+{
+#if defined( ADD_SMTC_EVENT_QUEUE )
+    RETURN_INVALID_IF_NULL( events );
+    RETURN_INVALID_IF_NULL( nb_events );
+    RETURN_INVALID_IF_NULL( event_pending_count );
+    if( max_events == 0 )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    modem_event_record_t record;
+    *nb_events = 0;
+    while( ( *nb_events < max_events ) && ( modem_event_queue_pop( &record ) == true ) )
+    {
+        smtc_modem_event_record_t* event = &events[*nb_events];
+
+        memset( event, 0, sizeof( smtc_modem_event_record_t ) );
+        event->event.event_type    = ( smtc_modem_event_type_t ) record.event_type;
+        event->event.stack_id      = record.stack_id;
+        event->event.missed_events = record.dropped;
+        smtc_modem_event_fill_data( &event->event, record.status );
+        event->timestamp_ms = record.timestamp_ms;
+        event->fcnt         = record.fcnt;
+        event->dl_metadata  = record.dl_metadata;
+
+        // The occurrence is read, it shall not be returned again by smtc_modem_get_event
+        clear_asynchronous_msg( record.event_type );
+        ( *nb_events )++;
+    }
+    *event_pending_count = modem_event_queue_get_count( );
+    return ( *nb_events > 0 ) ? SMTC_MODEM_RC_OK : SMTC_MODEM_RC_NO_EVENT;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
 smtc_modem_return_code_t smtc_modem_get_downlink_data( uint8_t  buff[SMTC_MODEM_MAX_LORAWAN_PAYLOAD_LENGTH],
                                                        uint8_t* length, smtc_modem_dl_metadata_t* metadata,
                                                        uint8_t* remaining_data_nb )
@@ -953,6 +1263,98 @@ smtc_modem_return_code_t smtc_modem_get_status( uint8_t stack_id, smtc_modem_sta
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_get_status_snapshot( uint8_t stack_id, smtc_modem_status_snapshot_t* snapshot )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( snapshot );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    const smtc_modem_status_mask_t status_mask = modem_get_status( stack_id );
+    const bool                     is_joined   = ( status_mask & SMTC_MODEM_STATUS_JOINED ) != 0;
+
+    snapshot->status_mask       = status_mask;
+    snapshot->region            = ( smtc_modem_region_t ) lorawan_api_get_region( stack_id );
+    snapshot->lorawan_class     = ( is_joined == true ) ? smtc_modem_get_running_class( stack_id ) : SMTC_MODEM_CLASS_A;
+    snapshot->uplink_fcnt       = lorawan_api_fcnt_up_get( stack_id );
+    snapshot->next_datarate     = lorawan_api_next_dr_get( stack_id );
+    snapshot->next_tx_power_dbm = ( int8_t ) lorawan_api_next_power_get( stack_id );
+    snapshot->nb_trans          = lorawan_api_nb_trans_get( stack_id );
+    // Same conditions as smtc_modem_get_next_tx_max_payload
+    snapshot->next_tx_max_payload =
+        ( ( is_joined == true ) &&
+          ( ( status_mask & ( SMTC_MODEM_STATUS_MUTE | SMTC_MODEM_STATUS_SUSPEND ) ) == 0 ) )
+            ? lorawan_api_next_max_payload_length_get( stack_id )
+            : 0;
+    snapshot->duty_cycle_status_ms = -1 * modem_duty_cycle_get_status( stack_id );
+    snapshot->lost_connection_cnt  = lorawan_api_get_current_no_rx_packet_cnt( stack_id );
+    snapshot->charge_uah           = rp_stats_get_charge_uah( &modem_radio_planner.stats );
+    snapshot->event_pending_count  = get_asynchronous_msgnumber( );
+    snapshot->timestamp_s          = smtc_modem_hal_get_time_in_s( );
+
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_apply_config( uint8_t stack_id, const smtc_modem_config_t* config,
+                                                  uint16_t* applied_fields )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( config );
+    RETURN_INVALID_IF_NULL( applied_fields );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    *applied_fields = 0;
+    if( config->fields >= ( SMTC_MODEM_CONFIG_FPENDING_DRAIN << 1 ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    // The region comes first as it resets the regional parameters the other fields depend on
+    for( uint16_t field = SMTC_MODEM_CONFIG_REGION; field <= SMTC_MODEM_CONFIG_FPENDING_DRAIN; field <<= 1 )
+    {
+        smtc_modem_return_code_t rc = SMTC_MODEM_RC_OK;
+
+        if( ( config->fields & field ) == 0 )
+        {
+            continue;
+        }
+        switch( field )
+        {
+        case SMTC_MODEM_CONFIG_REGION:
+            rc = smtc_modem_set_region( stack_id, config->region );
+            break;
+        case SMTC_MODEM_CONFIG_ADR_PROFILE:
+            rc = smtc_modem_adr_set_profile( stack_id, config->adr_profile, config->adr_custom_data );
+            break;
+        case SMTC_MODEM_CONFIG_NB_TRANS:
+            rc = smtc_modem_set_nb_trans( stack_id, config->nb_trans );
+            break;
+        case SMTC_MODEM_CONFIG_ADR_ACK_LIMIT_DELAY:
+            rc = smtc_modem_set_adr_ack_limit_delay( stack_id, config->adr_ack_limit, config->adr_ack_delay );
+            break;
+        case SMTC_MODEM_CONFIG_CLASS:
+            rc = smtc_modem_set_class( stack_id, config->lorawan_class );
+            break;
+        case SMTC_MODEM_CONFIG_FPENDING_DRAIN:
+            rc = smtc_modem_set_fpending_drain( stack_id, config->fpending_drain );
+            break;
+        default:
+            break;
+        }
+        if( rc != SMTC_MODEM_RC_OK )
+        {
+            return rc;
+        }
+        *applied_fields |= field;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_get_modem_version( smtc_modem_version_t* firmware_version )
 {
     RETURN_BUSY_IF_TEST_MODE( );
@@ -1066,7 +1468,29 @@ smtc_modem_return_code_t smtc_modem_request_empty_uplink( uint8_t stack_id, bool
     {
         lorawan_send_add_task( stack_id, fport, send_fport, confirmed, NULL, 0, false, 0 );
     }
-    return return_code;
+    return return_code;
+}
+
+smtc_modem_return_code_t smtc_modem_set_fpending_drain( uint8_t stack_id, bool enable )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    lorawan_dwn_ack_set_fpending_drain( stack_id, enable );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_get_fpending_drain( uint8_t stack_id, bool* enabled )
+{
+    RETURN_INVALID_IF_NULL( enabled );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    *enabled = lorawan_dwn_ack_get_fpending_drain( stack_id );
+    return SMTC_MODEM_RC_OK;
 }
 
 smtc_modem_return_code_t smtc_modem_leave_network( uint8_t stack_id )
@@ -1302,6 +1726,60 @@ smtc_modem_return_code_t smtc_modem_get_duty_cycle_status( uint8_t stack_id, int
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_set_stack_weight( uint8_t stack_id, uint8_t weight )
+{
+#if defined( ADD_STACK_FAIRNESS )
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    if( modem_supervisor_set_stack_weight( stack_id, weight ) == false )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( weight );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_set_stack_airtime_quota( uint8_t stack_id, uint32_t quota_ms )
+{
+#if defined( ADD_STACK_FAIRNESS )
+    if( modem_supervisor_set_stack_airtime_quota( stack_id, quota_ms ) == false )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( quota_ms );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_get_stack_airtime_stats( uint8_t stack_id, uint32_t* airtime_ms,
+                                                             uint32_t* quota_deferrals )
+{
+#if defined( ADD_STACK_FAIRNESS )
+    RETURN_INVALID_IF_NULL( airtime_ms );
+    RETURN_INVALID_IF_NULL( quota_deferrals );
+
+    if( modem_supervisor_get_stack_airtime_stats( stack_id, airtime_ms, quota_deferrals ) == false )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    UNUSED( stack_id );
+    UNUSED( airtime_ms );
+    UNUSED( quota_deferrals );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
 smtc_modem_return_code_t smtc_modem_get_network_type( uint8_t stack_id, bool* network_type )
 {
     RETURN_BUSY_IF_TEST_MODE( );
@@ -1460,6 +1938,15 @@ smtc_modem_return_code_t smtc_modem_get_charge( uint32_t* charge_mah )
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_get_charge_uah( uint32_t* charge_uah )
+{
+    RETURN_INVALID_IF_NULL( charge_uah );
+
+    *charge_uah = rp_stats_get_charge_uah( &modem_radio_planner.stats );
+
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_get_rp_stats_to_array( uint8_t* stats_array, uint16_t* stats_array_length )
 {
     RETURN_INVALID_IF_NULL( stats_array );
@@ -1494,31 +1981,243 @@ smtc_modem_return_code_t smtc_modem_get_rp_stats_to_array( uint8_t* stats_array,
         stats_array[*stats_array_length + 18] = ( modem_radio_planner.stats.none_consumption_ms[i] >> 8 ) & 0xFF;
         stats_array[*stats_array_length + 19] = ( modem_radio_planner.stats.none_consumption_ms[i] & 0xFF );
 
-        stats_array[*stats_array_length + 20] = ( modem_radio_planner.stats.tx_consumption_ma[i] >> 24 ) & 0xFF;
-        stats_array[*stats_array_length + 21] = ( modem_radio_planner.stats.tx_consumption_ma[i] >> 16 ) & 0xFF;
-        stats_array[*stats_array_length + 22] = ( modem_radio_planner.stats.tx_consumption_ma[i] >> 8 ) & 0xFF;
-        stats_array[*stats_array_length + 23] = ( modem_radio_planner.stats.tx_consumption_ma[i] & 0xFF );
+        // Charges are exported in uA.s on 32 bits, saturated
+        uint32_t tx_consumption_uas   =
+            rp_stats_saturate_u32( modem_radio_planner.stats.tx_consumption_ua_ms[i] / 1000 );
+        uint32_t rx_consumption_uas   =
+            rp_stats_saturate_u32( modem_radio_planner.stats.rx_consumption_ua_ms[i] / 1000 );
+        uint32_t none_consumption_uas =
+            rp_stats_saturate_u32( modem_radio_planner.stats.none_consumption_ua_ms[i] / 1000 );
+
+        stats_array[*stats_array_length + 20] = ( tx_consumption_uas >> 24 ) & 0xFF;
+        stats_array[*stats_array_length + 21] = ( tx_consumption_uas >> 16 ) & 0xFF;
+        stats_array[*stats_array_length + 22] = ( tx_consumption_uas >> 8 ) & 0xFF;
+        stats_array[*stats_array_length + 23] = ( tx_consumption_uas & 0xFF );
+
+        stats_array[*stats_array_length + 24] = ( rx_consumption_uas >> 24 ) & 0xFF;
+        stats_array[*stats_array_length + 25] = ( rx_consumption_uas >> 16 ) & 0xFF;
+        stats_array[*stats_array_length + 26] = ( rx_consumption_uas >> 8 ) & 0xFF;
+        stats_array[*stats_array_length + 27] = ( rx_consumption_uas & 0xFF );
+
+        stats_array[*stats_array_length + 28] = ( none_consumption_uas >> 24 ) & 0xFF;
+        stats_array[*stats_array_length + 29] = ( none_consumption_uas >> 16 ) & 0xFF;
+        stats_array[*stats_array_length + 30] = ( none_consumption_uas >> 8 ) & 0xFF;
+        stats_array[*stats_array_length + 31] = ( none_consumption_uas & 0xFF );
 
-        stats_array[*stats_array_length + 24] = ( modem_radio_planner.stats.rx_consumption_ma[i] >> 24 ) & 0xFF;
-        stats_array[*stats_array_length + 25] = ( modem_radio_planner.stats.rx_consumption_ma[i] >> 16 ) & 0xFF;
-        stats_array[*stats_array_length + 26] = ( modem_radio_planner.stats.rx_consumption_ma[i] >> 8 ) & 0xFF;
-        stats_array[*stats_array_length + 27] = ( modem_radio_planner.stats.rx_consumption_ma[i] & 0xFF );
+        *stats_array_length += 32;
+    }
 
-        stats_array[*stats_array_length + 28] = ( modem_radio_planner.stats.none_consumption_ma[i] >> 24 ) & 0xFF;
-        stats_array[*stats_array_length + 29] = ( modem_radio_planner.stats.none_consumption_ma[i] >> 16 ) & 0xFF;
-        stats_array[*stats_array_length + 30] = ( modem_radio_planner.stats.none_consumption_ma[i] >> 8 ) & 0xFF;
-        stats_array[*stats_array_length + 31] = ( modem_radio_planner.stats.none_consumption_ma[i] & 0xFF );
+    return SMTC_MODEM_RC_OK;
+}
 
-        *stats_array_length += 32;
+smtc_modem_return_code_t smtc_modem_get_rp_trace_to_array( uint8_t* trace_array, uint16_t trace_array_max_length,
+                                                           uint16_t* trace_array_length )
+{
+#if defined( ADD_RP_TRACE )
+    RETURN_INVALID_IF_NULL( trace_array );
+    RETURN_INVALID_IF_NULL( trace_array_length );
+
+    if( trace_array_max_length < 4 )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    uint32_t lost_events = modem_radio_planner.trace.lost_events;
+
+    trace_array[0]      = ( lost_events >> 24 ) & 0xFF;
+    trace_array[1]      = ( lost_events >> 16 ) & 0xFF;
+    trace_array[2]      = ( lost_events >> 8 ) & 0xFF;
+    trace_array[3]      = ( lost_events & 0xFF );
+    *trace_array_length = 4;
+
+    rp_trace_event_t event;
+    while( ( ( *trace_array_length + 8 ) <= trace_array_max_length ) &&
+           ( rp_trace_read( &modem_radio_planner.trace, &event ) == true ) )
+    {
+        trace_array[*trace_array_length + 0] = ( event.timestamp_us >> 24 ) & 0xFF;
+        trace_array[*trace_array_length + 1] = ( event.timestamp_us >> 16 ) & 0xFF;
+        trace_array[*trace_array_length + 2] = ( event.timestamp_us >> 8 ) & 0xFF;
+        trace_array[*trace_array_length + 3] = ( event.timestamp_us & 0xFF );
+        trace_array[*trace_array_length + 4] = event.type;
+        trace_array[*trace_array_length + 5] = event.hook_id;
+        trace_array[*trace_array_length + 6] = ( event.data >> 8 ) & 0xFF;
+        trace_array[*trace_array_length + 7] = ( event.data & 0xFF );
+
+        *trace_array_length += 8;
+    }
+
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_get_profile_to_array( uint8_t* profile_array, uint16_t profile_array_max_length,
+                                                          uint16_t* profile_array_length, bool reset )
+{
+#if defined( ADD_SMTC_PROFILE )
+    RETURN_INVALID_IF_NULL( profile_array );
+    RETURN_INVALID_IF_NULL( profile_array_length );
+
+    if( profile_array_max_length < ( SMTC_PROFILE_NB_SECTIONS * 16 ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    *profile_array_length = 0;
+    for( uint8_t section = 0; section < SMTC_PROFILE_NB_SECTIONS; section++ )
+    {
+        smtc_modem_dbg_profile_stats_t stats;
+        smtc_modem_dbg_profile_get_stats( ( smtc_modem_dbg_profile_section_t ) section, &stats );
+
+        const uint32_t fields[4] = { stats.count, stats.min_us, stats.avg_us, stats.max_us };
+        for( uint8_t i = 0; i < 4; i++ )
+        {
+            profile_array[*profile_array_length + 0] = ( fields[i] >> 24 ) & 0xFF;
+            profile_array[*profile_array_length + 1] = ( fields[i] >> 16 ) & 0xFF;
+            profile_array[*profile_array_length + 2] = ( fields[i] >> 8 ) & 0xFF;
+            profile_array[*profile_array_length + 3] = ( fields[i] & 0xFF );
+            *profile_array_length += 4;
+        }
+    }
+
+    if( reset == true )
+    {
+        smtc_modem_dbg_profile_init( );
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_get_latency_histograms_to_array( uint8_t* latency_array,
+                                                                     uint16_t latency_array_max_length,
+                                                                     uint16_t* latency_array_length, bool reset )
+{
+#if defined( ADD_SMTC_LATENCY_HISTOGRAM )
+    RETURN_INVALID_IF_NULL( latency_array );
+    RETURN_INVALID_IF_NULL( latency_array_length );
+
+    if( latency_array_max_length < ( SMTC_LATENCY_NB_HISTOGRAMS * ( 12 + ( SMTC_MODEM_DBG_LATENCY_NB_BUCKETS * 2 ) ) ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    *latency_array_length = 0;
+    for( uint8_t latency = 0; latency < SMTC_LATENCY_NB_HISTOGRAMS; latency++ )
+    {
+        uint32_t buckets[SMTC_MODEM_DBG_LATENCY_NB_BUCKETS];
+        uint32_t count = smtc_modem_dbg_latency_get_histogram( ( smtc_modem_dbg_latency_t ) latency, buckets );
+
+        const uint32_t fields[3] = {
+            count, smtc_modem_dbg_latency_get_percentile_ms( ( smtc_modem_dbg_latency_t ) latency, 50 ),
+            smtc_modem_dbg_latency_get_percentile_ms( ( smtc_modem_dbg_latency_t ) latency, 99 )
+        };
+        for( uint8_t i = 0; i < 3; i++ )
+        {
+            latency_array[*latency_array_length + 0] = ( fields[i] >> 24 ) & 0xFF;
+            latency_array[*latency_array_length + 1] = ( fields[i] >> 16 ) & 0xFF;
+            latency_array[*latency_array_length + 2] = ( fields[i] >> 8 ) & 0xFF;
+            latency_array[*latency_array_length + 3] = ( fields[i] & 0xFF );
+            *latency_array_length += 4;
+        }
+        for( uint8_t bucket = 0; bucket < SMTC_MODEM_DBG_LATENCY_NB_BUCKETS; bucket++ )
+        {
+            uint16_t bucket_count = ( buckets[bucket] > UINT16_MAX ) ? UINT16_MAX : ( uint16_t ) buckets[bucket];
+
+            latency_array[*latency_array_length + 0] = ( bucket_count >> 8 ) & 0xFF;
+            latency_array[*latency_array_length + 1] = ( bucket_count & 0xFF );
+            *latency_array_length += 2;
+        }
+    }
+
+    if( reset == true )
+    {
+        smtc_modem_dbg_latency_init( );
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_get_dtc_channel_stats( uint8_t stack_id, uint32_t* rerouted_uplinks,
+                                                           uint32_t* rerouted_toa_ms )
+{
+#if defined( ADD_DTC_AIRTIME_CHANNEL )
+    RETURN_INVALID_IF_NULL( rerouted_uplinks );
+    RETURN_INVALID_IF_NULL( rerouted_toa_ms );
+
+    lorawan_api_get_dtc_channel_stats( rerouted_uplinks, rerouted_toa_ms, stack_id );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_get_service_stats( uint8_t stack_id, smtc_modem_service_stats_t* stats,
+                                                       uint8_t stats_max_nb, uint8_t* stats_nb )
+{
+#if defined( ADD_SMTC_SERVICE_STATS )
+    RETURN_INVALID_IF_NULL( stats );
+    RETURN_INVALID_IF_NULL( stats_nb );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    *stats_nb = tx_protocol_manager_get_service_stats( stack_id, stats, stats_max_nb );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_reset_service_stats( uint8_t stack_id )
+{
+#if defined( ADD_SMTC_SERVICE_STATS )
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
     }
 
+    tx_protocol_manager_reset_service_stats( stack_id );
     return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
 }
 
 smtc_modem_return_code_t smtc_modem_reset_charge( void )
 {
     rp_stats_init( &modem_radio_planner.stats );
+#if defined( ADD_SMTC_BATTERY_ESTIMATOR )
+    modem_battery_estimator_restart( );
+#endif
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_set_battery_capacity( uint32_t capacity_mah )
+{
+#if defined( ADD_SMTC_BATTERY_ESTIMATOR )
+    modem_battery_estimator_set_capacity( capacity_mah );
+    return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_get_battery_estimate( smtc_modem_battery_estimate_t* estimate )
+{
+#if defined( ADD_SMTC_BATTERY_ESTIMATOR )
+    RETURN_INVALID_IF_NULL( estimate );
+
+    modem_battery_estimator_get( rp_stats_get_charge_ua_ms( &modem_radio_planner.stats ), estimate );
     return SMTC_MODEM_RC_OK;
+#else
+    return SMTC_MODEM_RC_FAIL;
+#endif
 }
 
 /*
@@ -1578,6 +2277,17 @@ smtc_modem_return_code_t smtc_modem_trigger_alcsync_request( uint8_t stack_id )
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_set_alcsync_tolerance( uint8_t stack_id, uint32_t tolerance_ms )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    if( lorawan_alcsync_set_tolerance( stack_id, tolerance_ms ) != ALC_SYNC_OK )
+    {
+        return SMTC_MODEM_RC_FAIL;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
 #endif  // ADD_SMTC_ALC_SYNC
 
 smtc_modem_return_code_t smtc_modem_trig_lorawan_mac_request( uint8_t                               stack_id,
@@ -1647,23 +2357,7 @@ smtc_modem_return_code_t smtc_modem_get_class( uint8_t stack_id, smtc_modem_clas
         return SMTC_MODEM_RC_FAIL;
     }
 
-#ifdef ADD_CLASS_C
-    if( lorawan_api_class_c_is_running( stack_id ) )
-    {
-        *lorawan_class = SMTC_MODEM_CLASS_C;
-    }
-    else
-#endif  // ADD_CLASS_C
-#ifdef ADD_CLASS_B
-        if( lorawan_api_class_b_enabled_get( stack_id ) )
-    {
-        *lorawan_class = SMTC_MODEM_CLASS_B;
-    }
-    else
-#endif  // ADD_CLASS_B
-    {
-        *lorawan_class = SMTC_MODEM_CLASS_A;
-    }
+    *lorawan_class = smtc_modem_get_running_class( stack_id );
     return SMTC_MODEM_RC_OK;
 }
 
@@ -1715,6 +2409,34 @@ smtc_modem_return_code_t smtc_modem_set_class( uint8_t stack_id, smtc_modem_clas
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_class_c_set_low_power_preamble( uint8_t stack_id, uint16_t preamble_len_symb )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    if( lorawan_api_class_c_set_low_power( preamble_len_symb, stack_id ) == false )
+    {
+        return SMTC_MODEM_RC_FAIL;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_class_c_get_low_power_preamble( uint8_t stack_id, uint16_t* preamble_len_symb )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( preamble_len_symb );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+
+    *preamble_len_symb = lorawan_api_class_c_get_low_power( stack_id );
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_class_b_set_ping_slot_periodicity(
     uint8_t stack_id, smtc_modem_class_b_ping_slot_periodicity_t ping_slot_periodicity )
 {
@@ -1946,17 +2668,78 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_start_session(
     case LORAWAN_MC_RC_OK:
         modem_rc = SMTC_MODEM_RC_OK;
         break;
-    case LORAWAN_MC_RC_ERROR_PARAM:
-        // intentional fallthrough
-    case LORAWAN_MC_RC_ERROR_INCOMPATIBLE_SESSION:
-        // intentional fallthrough
+    case LORAWAN_MC_RC_ERROR_PARAM:
+        // intentional fallthrough
+    case LORAWAN_MC_RC_ERROR_INCOMPATIBLE_SESSION:
+        // intentional fallthrough
+    case LORAWAN_MC_RC_ERROR_BAD_ID:
+        modem_rc = SMTC_MODEM_RC_INVALID;
+        break;
+    case LORAWAN_MC_RC_ERROR_BUSY:
+        // intentional fallthrough
+    case LORAWAN_MC_RC_ERROR_CLASS_NOT_ENABLED:
+        // intentional fallthrough
+    default:
+        modem_rc = SMTC_MODEM_RC_FAIL;
+        break;
+    }
+    return modem_rc;
+#else   // SMTC_MULTICAST
+    return SMTC_MODEM_RC_FAIL;
+#endif  // SMTC_MULTICAST
+}
+
+smtc_modem_return_code_t smtc_modem_multicast_class_b_get_session_status(
+    uint8_t stack_id, smtc_modem_mc_grp_id_t mc_grp_id, bool* is_session_started, bool* is_session_waiting_for_beacon,
+    uint32_t* freq, uint8_t* dr, smtc_modem_class_b_ping_slot_periodicity_t* ping_slot_periodicity )
+
+{
+#if defined( SMTC_MULTICAST )
+    RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( is_session_started );
+    RETURN_INVALID_IF_NULL( is_session_waiting_for_beacon );
+    RETURN_INVALID_IF_NULL( freq );
+    RETURN_INVALID_IF_NULL( dr );
+    RETURN_INVALID_IF_NULL( ping_slot_periodicity );
+
+    smtc_modem_return_code_t modem_rc;
+    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_get_session_status(
+        mc_grp_id, is_session_started, is_session_waiting_for_beacon, freq, dr, ping_slot_periodicity, stack_id );
+
+    switch( rc )
+    {
+    case LORAWAN_MC_RC_OK:
+        modem_rc = SMTC_MODEM_RC_OK;
+        break;
+    case LORAWAN_MC_RC_ERROR_BAD_ID:
+        modem_rc = SMTC_MODEM_RC_INVALID;
+        break;
+    default:
+        modem_rc = SMTC_MODEM_RC_FAIL;
+        break;
+    }
+    return modem_rc;
+#else   // SMTC_MULTICAST
+    return SMTC_MODEM_RC_FAIL;
+#endif  // SMTC_MULTICAST
+}
+
+smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_session( uint8_t stack_id, smtc_modem_mc_grp_id_t mc_grp_id )
+{
+#if defined( SMTC_MULTICAST )
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    smtc_modem_return_code_t modem_rc;
+    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_stop_session( mc_grp_id, stack_id );
+
+    switch( rc )
+    {
+    case LORAWAN_MC_RC_OK:
+        modem_rc = SMTC_MODEM_RC_OK;
+        break;
     case LORAWAN_MC_RC_ERROR_BAD_ID:
         modem_rc = SMTC_MODEM_RC_INVALID;
         break;
-    case LORAWAN_MC_RC_ERROR_BUSY:
-        // intentional fallthrough
-    case LORAWAN_MC_RC_ERROR_CLASS_NOT_ENABLED:
-        // intentional fallthrough
     default:
         modem_rc = SMTC_MODEM_RC_FAIL;
         break;
@@ -1967,31 +2750,19 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_start_session(
 #endif  // SMTC_MULTICAST
 }
 
-smtc_modem_return_code_t smtc_modem_multicast_class_b_get_session_status(
-    uint8_t stack_id, smtc_modem_mc_grp_id_t mc_grp_id, bool* is_session_started, bool* is_session_waiting_for_beacon,
-    uint32_t* freq, uint8_t* dr, smtc_modem_class_b_ping_slot_periodicity_t* ping_slot_periodicity )
-
+smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_all_sessions( uint8_t stack_id )
 {
 #if defined( SMTC_MULTICAST )
     RETURN_BUSY_IF_TEST_MODE( );
-    RETURN_INVALID_IF_NULL( is_session_started );
-    RETURN_INVALID_IF_NULL( is_session_waiting_for_beacon );
-    RETURN_INVALID_IF_NULL( freq );
-    RETURN_INVALID_IF_NULL( dr );
-    RETURN_INVALID_IF_NULL( ping_slot_periodicity );
 
     smtc_modem_return_code_t modem_rc;
-    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_get_session_status(
-        mc_grp_id, is_session_started, is_session_waiting_for_beacon, freq, dr, ping_slot_periodicity, stack_id );
+    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_stop_all_sessions( stack_id );
 
     switch( rc )
     {
     case LORAWAN_MC_RC_OK:
         modem_rc = SMTC_MODEM_RC_OK;
         break;
-    case LORAWAN_MC_RC_ERROR_BAD_ID:
-        modem_rc = SMTC_MODEM_RC_INVALID;
-        break;
     default:
         modem_rc = SMTC_MODEM_RC_FAIL;
         break;
@@ -2002,19 +2773,23 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_get_session_status(
 #endif  // SMTC_MULTICAST
 }
 
-smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_session( uint8_t stack_id, smtc_modem_mc_grp_id_t mc_grp_id )
+smtc_modem_return_code_t smtc_modem_multicast_class_b_set_listen_ratio( uint8_t                stack_id,
+                                                                        smtc_modem_mc_grp_id_t mc_grp_id,
+                                                                        uint8_t                listen_ratio )
 {
 #if defined( SMTC_MULTICAST )
     RETURN_BUSY_IF_TEST_MODE( );
 
     smtc_modem_return_code_t modem_rc;
-    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_stop_session( mc_grp_id, stack_id );
+    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_set_listen_ratio( mc_grp_id, listen_ratio, stack_id );
 
     switch( rc )
     {
     case LORAWAN_MC_RC_OK:
         modem_rc = SMTC_MODEM_RC_OK;
         break;
+    case LORAWAN_MC_RC_ERROR_PARAM:
+        // intentional fallthrough
     case LORAWAN_MC_RC_ERROR_BAD_ID:
         modem_rc = SMTC_MODEM_RC_INVALID;
         break;
@@ -2028,19 +2803,25 @@ smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_session( uint8_t stac
 #endif  // SMTC_MULTICAST
 }
 
-smtc_modem_return_code_t smtc_modem_multicast_class_b_stop_all_sessions( uint8_t stack_id )
+smtc_modem_return_code_t smtc_modem_multicast_class_b_get_listen_ratio( uint8_t                stack_id,
+                                                                        smtc_modem_mc_grp_id_t mc_grp_id,
+                                                                        uint8_t*               listen_ratio )
 {
 #if defined( SMTC_MULTICAST )
     RETURN_BUSY_IF_TEST_MODE( );
+    RETURN_INVALID_IF_NULL( listen_ratio );
 
     smtc_modem_return_code_t modem_rc;
-    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_stop_all_sessions( stack_id );
+    lorawan_multicast_rc_t   rc = lorawan_api_multicast_b_get_listen_ratio( mc_grp_id, listen_ratio, stack_id );
 
     switch( rc )
     {
     case LORAWAN_MC_RC_OK:
         modem_rc = SMTC_MODEM_RC_OK;
         break;
+    case LORAWAN_MC_RC_ERROR_BAD_ID:
+        modem_rc = SMTC_MODEM_RC_INVALID;
+        break;
     default:
         modem_rc = SMTC_MODEM_RC_FAIL;
         break;
@@ -2149,6 +2930,34 @@ void smtc_modem_gnss_scan_aggregate( uint8_t stack_id, bool aggregate )
     mw_gnss_scan_aggregate( aggregate );
 }
 
+void smtc_modem_gnss_scan_adaptive( uint8_t stack_id, bool adaptive )
+{
+    UNUSED( stack_id );
+
+    mw_gnss_scan_adaptive( adaptive );
+}
+
+smtc_modem_return_code_t smtc_modem_gnss_set_solver_port( uint8_t stack_id, uint8_t port, uint16_t max_accuracy_m )
+{
+    if( port >= 224 )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "%s: port %d is forbidden \n", __func__, port );
+        return SMTC_MODEM_RC_INVALID;
+    }
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+    if( ( port != 0 ) && ( port == cloud_dm_get_dm_port( stack_id ) ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "%s port %d is reserved for DM cloud \n", __func__, port );
+        return SMTC_MODEM_RC_INVALID;
+    }
+#else
+    UNUSED( stack_id );
+#endif
+
+    mw_gnss_set_solver_port( port, max_accuracy_m );
+    return SMTC_MODEM_RC_OK;
+}
+
 smtc_modem_return_code_t smtc_modem_gnss_send_mode( uint8_t stack_id, smtc_modem_geolocation_send_mode_t send_mode )
 {
     UNUSED( stack_id );
@@ -2164,6 +2973,13 @@ smtc_modem_return_code_t smtc_modem_gnss_send_mode( uint8_t stack_id, smtc_modem
     }
 }
 
+void smtc_modem_gnss_set_payload_format( uint8_t stack_id, smtc_modem_gnss_payload_format_t format )
+{
+    UNUSED( stack_id );
+
+    mw_gnss_set_payload_format( format );
+}
+
 smtc_modem_return_code_t smtc_modem_almanac_demodulation_start( uint8_t stack_id )
 {
     UNUSED( stack_id );
@@ -2281,6 +3097,13 @@ void smtc_modem_wifi_set_payload_format( uint8_t stack_id, smtc_modem_wifi_paylo
     mw_wifi_set_payload_format( format );
 }
 
+void smtc_modem_wifi_set_unchanged_scan_filter( uint8_t stack_id, uint8_t rssi_hysteresis_db, uint8_t max_nb_skipped )
+{
+    UNUSED( stack_id );
+
+    mw_wifi_set_unchanged_scan_filter( rssi_hysteresis_db, max_nb_skipped );
+}
+
 #endif
 
 /*
@@ -2357,10 +3180,42 @@ smtc_modem_return_code_t smtc_modem_almanac_stop( uint8_t stack_id )
 smtc_modem_return_code_t smtc_modem_stream_init( uint8_t stack_id, uint8_t f_port,
                                                  smtc_modem_stream_cipher_mode_t cipher_mode,
                                                  uint8_t                         redundancy_ratio_percent )
+{
+    return smtc_modem_stream_multi_init( stack_id, STREAM_DEFAULT_ID, f_port, cipher_mode, redundancy_ratio_percent, 0,
+                                         1 );
+}
+
+smtc_modem_return_code_t smtc_modem_stream_add_data( uint8_t stack_id, const uint8_t* data, uint8_t len )
+{
+    return smtc_modem_stream_multi_add_data( stack_id, STREAM_DEFAULT_ID, data, len );
+}
+
+smtc_modem_return_code_t smtc_modem_stream_status( uint8_t stack_id, uint16_t* pending, uint16_t* free )
+{
+    return smtc_modem_stream_multi_status( stack_id, STREAM_DEFAULT_ID, pending, free );
+}
+
+smtc_modem_return_code_t smtc_modem_stream_set_auto_redundancy( uint8_t stack_id, bool enabled,
+                                                                uint8_t min_redundancy_ratio_percent,
+                                                                uint8_t max_redundancy_ratio_percent )
+{
+    return smtc_modem_stream_multi_set_auto_redundancy( stack_id, STREAM_DEFAULT_ID, enabled,
+                                                        min_redundancy_ratio_percent, max_redundancy_ratio_percent );
+}
+
+smtc_modem_return_code_t smtc_modem_stream_multi_init( uint8_t stack_id, uint8_t stream_id, uint8_t f_port,
+                                                       smtc_modem_stream_cipher_mode_t cipher_mode,
+                                                       uint8_t redundancy_ratio_percent, uint8_t priority,
+                                                       uint8_t weight )
 {
     RETURN_BUSY_IF_TEST_MODE( );
 
     // Check parameters validity
+    if( stream_id >= NUMBER_OF_STREAMS )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "STREAM_INIT stream_id invalid\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
     if( f_port >= 224 )
     {
         SMTC_MODEM_HAL_TRACE_ERROR( "STREAM_INIT f_port invalid\n" );
@@ -2371,6 +3226,11 @@ smtc_modem_return_code_t smtc_modem_stream_init( uint8_t stack_id, uint8_t f_por
         SMTC_MODEM_HAL_TRACE_ERROR( "STREAM_INIT encryption mode invalid\n" );
         return SMTC_MODEM_RC_INVALID;
     }
+    if( weight == 0 )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "STREAM_INIT weight invalid\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
 
     // If parameter f_port is set to 0 => use current dm port
     if( f_port == 0 )
@@ -2385,21 +3245,34 @@ smtc_modem_return_code_t smtc_modem_stream_init( uint8_t stack_id, uint8_t f_por
     }
 
     // initialize stream session
-    if( stream_init( stack_id, f_port, ( cipher_mode == SMTC_MODEM_STREAM_AES_WITH_APPSKEY ),
-                     redundancy_ratio_percent ) != STREAM_OK )
+    switch( stream_init( stack_id, stream_id, f_port, ( cipher_mode == SMTC_MODEM_STREAM_AES_WITH_APPSKEY ),
+                         redundancy_ratio_percent ) )
     {
+    case STREAM_OK:
+        break;
+    case STREAM_BUSY:
+        SMTC_MODEM_HAL_TRACE_ERROR( "STREAM_INIT f_port used by another stream\n" );
+        return SMTC_MODEM_RC_INVALID;
+    default:
         SMTC_MODEM_HAL_TRACE_ERROR( "STREAM_INIT FAILED\n" );
         return SMTC_MODEM_RC_FAIL;
     }
 
+    stream_set_priority( stack_id, stream_id, priority, weight );
     return SMTC_MODEM_RC_OK;
 }
 
-smtc_modem_return_code_t smtc_modem_stream_add_data( uint8_t stack_id, const uint8_t* data, uint8_t len )
+smtc_modem_return_code_t smtc_modem_stream_multi_add_data( uint8_t stack_id, uint8_t stream_id, const uint8_t* data,
+                                                           uint8_t len )
 {
     RETURN_BUSY_IF_TEST_MODE( );
     RETURN_INVALID_IF_NULL( data );
 
+    if( stream_id >= NUMBER_OF_STREAMS )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
     // Check if modem is joined, not suspended or muted
     smtc_modem_status_mask_t status_mask = modem_get_status( stack_id );
     if( ( ( status_mask & SMTC_MODEM_STATUS_JOINED ) != SMTC_MODEM_STATUS_JOINED ) ||
@@ -2410,8 +3283,14 @@ smtc_modem_return_code_t smtc_modem_stream_add_data( uint8_t stack_id, const uin
     }
 
     // No existing stream
-    if( stream_get_init_status( stack_id ) == false )
+    if( stream_get_init_status( stack_id, stream_id ) == false )
     {
+        // only the default stream is started implicitly, the others need their own port
+        if( stream_id != STREAM_DEFAULT_ID )
+        {
+            return SMTC_MODEM_RC_NOT_INIT;
+        }
+
         smtc_modem_return_code_t rc;
         // Start new unencrypted session with rr to 110% on dm port
 
@@ -2430,7 +3309,7 @@ smtc_modem_return_code_t smtc_modem_stream_add_data( uint8_t stack_id, const uin
         }
     }
 
-    stream_return_code_t stream_rc = stream_add_data( stack_id, data, len );
+    stream_return_code_t stream_rc = stream_add_data( stack_id, stream_id, data, len );
 
     switch( stream_rc )
     {
@@ -2451,18 +3330,48 @@ smtc_modem_return_code_t smtc_modem_stream_add_data( uint8_t stack_id, const uin
     return SMTC_MODEM_RC_OK;
 }
 
-smtc_modem_return_code_t smtc_modem_stream_status( uint8_t stack_id, uint16_t* pending, uint16_t* free )
+smtc_modem_return_code_t smtc_modem_stream_multi_status( uint8_t stack_id, uint8_t stream_id, uint16_t* pending,
+                                                         uint16_t* free )
 {
     RETURN_BUSY_IF_TEST_MODE( );
     RETURN_INVALID_IF_NULL( pending );
     RETURN_INVALID_IF_NULL( free );
 
-    if( stream_get_init_status( stack_id ) == false )
+    if( stream_id >= NUMBER_OF_STREAMS )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( stream_get_init_status( stack_id, stream_id ) == false )
+    {
+        return SMTC_MODEM_RC_NOT_INIT;
+    }
+
+    stream_status( stack_id, stream_id, pending, free );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_stream_multi_set_auto_redundancy( uint8_t stack_id, uint8_t stream_id,
+                                                                      bool    enabled,
+                                                                      uint8_t min_redundancy_ratio_percent,
+                                                                      uint8_t max_redundancy_ratio_percent )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+
+    if( stream_id >= NUMBER_OF_STREAMS )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( stream_get_init_status( stack_id, stream_id ) == false )
     {
         return SMTC_MODEM_RC_NOT_INIT;
     }
 
-    stream_status( stack_id, pending, free );
+    if( stream_set_rr_auto( stack_id, stream_id, enabled, min_redundancy_ratio_percent,
+                            max_redundancy_ratio_percent ) != STREAM_OK )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "STREAM auto redundancy bounds invalid\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
     return SMTC_MODEM_RC_OK;
 }
 #endif  // ADD_SMTC_STREAM
@@ -2639,6 +3548,39 @@ smtc_modem_return_code_t smtc_modem_dm_handle_alcsync( uint8_t stack_id, bool ha
     return SMTC_MODEM_RC_FAIL;
 #endif
 }
+
+smtc_modem_return_code_t smtc_modem_dm_set_info_threshold( uint8_t stack_id, smtc_modem_dm_field_t dm_field,
+                                                           uint16_t threshold )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+
+#if defined( ADD_SMTC_DM_DELTA )
+    if( cloud_dm_set_info_threshold( stack_id, ( dm_info_field_t ) dm_field, threshold ) != DM_OK )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    SMTC_MODEM_HAL_TRACE_ERROR( "smtc_modem_dm_set_info_threshold cannot be used if LBM_DM_DELTA is not built\n" );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
+smtc_modem_return_code_t smtc_modem_dm_set_keepalive( uint8_t stack_id, uint8_t nb_of_intervals )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+
+#if defined( ADD_SMTC_DM_DELTA )
+    if( cloud_dm_set_keepalive( stack_id, nb_of_intervals ) != DM_OK )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+    return SMTC_MODEM_RC_OK;
+#else
+    SMTC_MODEM_HAL_TRACE_ERROR( "smtc_modem_dm_set_keepalive cannot be used if LBM_DM_DELTA is not built\n" );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
 #endif  // ADD_SMTC_CLOUD_DEVICE_MANAGEMENT
 
 #if defined( ADD_SMTC_LFU )
@@ -2708,6 +3650,28 @@ smtc_modem_return_code_t smtc_modem_store_and_forward_get_state( uint8_t
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_store_and_forward_set_aggregation( uint8_t stack_id, bool enabled, uint8_t fport )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    return store_and_fw_rc_lut[store_and_forward_flash_set_aggregation( stack_id, enabled, fport )];
+}
+
+smtc_modem_return_code_t smtc_modem_store_and_forward_set_fec( uint8_t stack_id, bool enabled, uint8_t fport,
+                                                               uint8_t nb_data, uint8_t nb_parity )
+{
+#if defined( ADD_SMTC_STORE_AND_FORWARD_FEC )
+    RETURN_BUSY_IF_TEST_MODE( );
+    return store_and_fw_rc_lut[store_and_forward_flash_set_fec( stack_id, enabled, fport, nb_data, nb_parity )];
+#else
+    UNUSED( stack_id );
+    UNUSED( enabled );
+    UNUSED( fport );
+    UNUSED( nb_data );
+    UNUSED( nb_parity );
+    return SMTC_MODEM_RC_FAIL;
+#endif
+}
+
 smtc_modem_return_code_t smtc_modem_store_and_forward_flash_add_data( uint8_t stack_id, uint8_t fport, bool confirmed,
                                                                       const uint8_t* payload, uint8_t payload_length )
 {
@@ -2755,6 +3719,11 @@ static smtc_modem_return_code_t smtc_modem_send_tx( uint8_t stack_id, uint8_t f_
     {
         return_code = SMTC_MODEM_RC_INVALID;
     }
+    else if( lorawan_send_payload_buffer_is_in_use( stack_id ) == true )
+    {
+        // A payload committed in place is still read by the tx protocol manager
+        return_code = SMTC_MODEM_RC_BUSY;
+    }
 #if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
     else if( f_port == cloud_dm_get_dm_port( stack_id ) )
     {
@@ -2769,6 +3738,23 @@ static smtc_modem_return_code_t smtc_modem_send_tx( uint8_t stack_id, uint8_t f_
     }
     else
     {
+#if defined( ADD_SMTC_PAYLOAD_COMPRESSION )
+        // The records of the compression FPort are sent as key or delta frames
+        uint8_t                  frame[PAYLOAD_COMPRESSION_FRAME_SIZE_MAX];
+        uint8_t                  frame_len = 0;
+        payload_compression_rc_t compression_rc =
+            payload_compression_encode( stack_id, f_port, payload, payload_length, frame, &frame_len );
+        if( compression_rc == PAYLOAD_COMPRESSION_RC_INVALID )
+        {
+            SMTC_MODEM_HAL_TRACE_ERROR( "%s payload does not match the compression schema\n", __func__ );
+            return SMTC_MODEM_RC_INVALID;
+        }
+        if( compression_rc == PAYLOAD_COMPRESSION_RC_OK )
+        {
+            payload        = frame;
+            payload_length = frame_len;
+        }
+#endif
         SMTC_MODEM_HAL_TRACE_INFO( "add send task\n" );
         lorawan_send_add_task( stack_id, f_port, true, confirmed, payload, payload_length, emergency, 0 );
     }
@@ -2812,7 +3798,7 @@ static void modem_store_key_context( void )
     modem_key_ctx_t ctx = { 0 };
 
     // Restore current saved context
-    smtc_modem_hal_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
 
     // Check if some values have changed
     if( ( ctx.appkey_crc != modem_appkey_crc ) || ( ctx.appkey_crc_status != modem_appkey_status ) ||
@@ -2825,16 +3811,16 @@ static void modem_store_key_context( void )
         memcpy( ctx.data_block_int_key, modem_data_block_int_key, SMTC_MODEM_KEY_LENGTH );
         ctx.crc = crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
 
-        smtc_modem_hal_context_store( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_store( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
         // dummy context reading to ensure context store is done before exiting the function
-        smtc_modem_hal_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
     }
 }
 
 static void modem_load_appkey_context( void )
 {
     modem_key_ctx_t ctx;
-    smtc_modem_hal_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
 
     if( crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) ) == ctx.crc )
     {
@@ -2853,9 +3839,156 @@ static void modem_load_appkey_context( void )
         ctx.gen_appkey_crc_status = MODEM_KEY_CRC_STATUS_INVALID;
 
         ctx.crc = crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
-        smtc_modem_hal_context_store( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_store( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
         // dummy context reading to ensure context store is done before exiting the function
-        smtc_modem_hal_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_restore( CONTEXT_KEY_MODEM, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    }
+}
+#endif
+
+static smtc_modem_class_t smtc_modem_get_running_class( uint8_t stack_id )
+{
+    UNUSED( stack_id );
+#ifdef ADD_CLASS_C
+    if( lorawan_api_class_c_is_running( stack_id ) )
+    {
+        return SMTC_MODEM_CLASS_C;
+    }
+#endif  // ADD_CLASS_C
+#ifdef ADD_CLASS_B
+    if( lorawan_api_class_b_enabled_get( stack_id ) )
+    {
+        return SMTC_MODEM_CLASS_B;
+    }
+#endif  // ADD_CLASS_B
+    return SMTC_MODEM_CLASS_A;
+}
+
+static void smtc_modem_event_fill_data( smtc_modem_event_t* event, uint8_t status )
+{
+    switch( event->event_type )
+    {
+    case SMTC_MODEM_EVENT_RESET:
+        event->event_data.reset.count = ( uint16_t ) modem_get_reset_counter( );
+        break;
+    case SMTC_MODEM_EVENT_TXDONE:
+        event->event_data.txdone.status = ( smtc_modem_event_txdone_status_t ) status;
+        break;
+
+    case SMTC_MODEM_EVENT_LINK_CHECK:
+        event->event_data.link_check.status = ( smtc_modem_event_mac_request_status_t ) status;
+        break;
+
+    case SMTC_MODEM_EVENT_CLASS_B_PING_SLOT_INFO:
+        event->event_data.class_b_ping_slot_info.status = ( smtc_modem_event_mac_request_status_t ) status;
+        break;
+
+    case SMTC_MODEM_EVENT_CLASS_B_STATUS:
+        event->event_data.class_b_status.status = ( smtc_modem_event_class_b_status_t ) status;
+        break;
+
+    case SMTC_MODEM_EVENT_LORAWAN_MAC_TIME:
+        event->event_data.lorawan_mac_time.status = ( smtc_modem_event_mac_request_status_t ) status;
+        break;
+    case SMTC_MODEM_EVENT_LORAWAN_FUOTA_DONE:
+        event->event_data.fuota_status.successful = ( status == 0 ) ? true : false;
+        break;
+
+    case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_C:
+        event->event_data.new_multicast_class_c.group_id = status;
+        break;
+
+    case SMTC_MODEM_EVENT_NEW_MULTICAST_SESSION_CLASS_B:
+        event->event_data.new_multicast_class_b.group_id = status;
+        break;
+
+#if defined( ENABLE_FUOTA_FMP )
+    case SMTC_MODEM_EVENT_FIRMWARE_MANAGEMENT:
+        event->event_data.fmp.status = status;
+        break;
+#endif
+
+#if defined( ADD_SMTC_CLOUD_DEVICE_MANAGEMENT )
+    case SMTC_MODEM_EVENT_DM_SET_CONF:
+        event->event_data.setconf.opcode = ( smtc_modem_event_setconf_opcode_t ) status;
+        break;
+    case SMTC_MODEM_EVENT_MUTE:
+        event->event_data.mute.status = ( smtc_modem_event_mute_status_t ) status;
+        break;
+#endif
+#if defined( ADD_SMTC_LFU )
+    case SMTC_MODEM_EVENT_UPLOAD_DONE:
+        event->event_data.uploaddone.status = status;
+        break;
+#endif  // ADD_SMTC_LFU
+
+#if defined( ADD_RELAY_TX )
+    case SMTC_MODEM_EVENT_RELAY_TX_DYNAMIC:
+    case SMTC_MODEM_EVENT_RELAY_TX_MODE:
+    case SMTC_MODEM_EVENT_RELAY_TX_SYNC:
+        event->event_data.relay_tx.status = status;
+        break;
+#endif
+
+#if defined( ADD_RELAY_RX )
+    case SMTC_MODEM_EVENT_RELAY_RX_RUNNING:
+        event->event_data.relay_rx.status = status;
+        break;
+#endif
+
+    case SMTC_MODEM_EVENT_TEST_MODE:
+        event->event_data.test_mode_status.status = status;
+        break;
+    case SMTC_MODEM_EVENT_REGIONAL_DUTY_CYCLE:
+        event->event_data.regional_duty_cycle.status = status;
+        break;
+    case SMTC_MODEM_EVENT_DOWNDATA:
+    case SMTC_MODEM_EVENT_ALARM:
+    case SMTC_MODEM_EVENT_JOINED:
+    case SMTC_MODEM_EVENT_JOINFAIL:
+    case SMTC_MODEM_EVENT_ALCSYNC_TIME:
+    case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_C:
+    case SMTC_MODEM_EVENT_NO_MORE_MULTICAST_SESSION_CLASS_B:
+#if defined( ADD_SMTC_STREAM )
+    case SMTC_MODEM_EVENT_STREAM_DONE:
+#endif
+    default:
+        break;
+    }
+}
+
+#if defined( ADD_SMTC_REQUEST_QUEUE )
+static void modem_drain_request_queue( void )
+{
+    const modem_request_t* request;
+
+    while( ( request = modem_request_queue_peek( ) ) != NULL )
+    {
+        // A new send task would replace the pending one, queued requests wait for the previous uplink to be launched
+        if( ( lorawan_send_task_is_pending( request->stack_id ) == true ) ||
+            ( lorawan_send_payload_buffer_is_in_use( request->stack_id ) == true ) )
+        {
+            break;
+        }
+
+        smtc_modem_return_code_t rc;
+        if( request->payload_length > 0 )
+        {
+            rc = smtc_modem_request_uplink( request->stack_id, request->fport, request->confirmed, request->payload,
+                                            request->payload_length );
+        }
+        else
+        {
+            rc = smtc_modem_request_empty_uplink( request->stack_id, request->send_fport, request->fport,
+                                                  request->confirmed );
+        }
+        if( rc != SMTC_MODEM_RC_OK )
+        {
+            // A rejected request completes as an uplink that could not be sent
+            SMTC_MODEM_HAL_TRACE_WARNING( "queued uplink rejected (rc %d)\n", rc );
+            increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TXDONE, MODEM_TX_FAILED, request->stack_id );
+        }
+        modem_request_queue_pop( );
     }
 }
 #endif
@@ -2920,6 +4053,28 @@ smtc_modem_return_code_t smtc_modem_relay_tx_disable( uint8_t stack_id )
     return SMTC_MODEM_RC_OK;
 }
 
+smtc_modem_return_code_t smtc_modem_relay_tx_set_ack_free_uplinks( uint8_t stack_id, uint8_t nb_uplink )
+{
+    RETURN_BUSY_IF_TEST_MODE( );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    smtc_relay_tx_set_ack_free_uplinks( stack_id, nb_uplink );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_relay_tx_get_ack_free_uplinks( uint8_t stack_id, uint8_t* nb_uplink )
+{
+    RETURN_INVALID_IF_NULL( nb_uplink );
+    if( stack_id >= NUMBER_OF_STACKS )
+    {
+        return SMTC_MODEM_RC_INVALID_STACK_ID;
+    }
+    *nb_uplink = smtc_relay_tx_get_ack_free_uplinks( stack_id );
+    return SMTC_MODEM_RC_OK;
+}
+
 #endif
 
 /* --- EOF ------------------------------------------------------------------ */
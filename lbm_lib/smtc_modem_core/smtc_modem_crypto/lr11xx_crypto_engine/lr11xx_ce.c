@@ -45,12 +45,16 @@
 #include "modem_core.h"
 #include "lr11xx_system.h"
 #include "lr11xx_crypto_engine.h"
-#include "modem_core.h"
+#include "modem_crc.h"
 #include "smtc_modem_hal.h"
 #include "smtc_modem_hal_dbg_trace.h"
 
 #include <string.h>  //for memset
 
+#if defined( LR1MAC_MC_NUMBER_OF_SESSION ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
+#error "LR11xx crypto engine has key slots for 4 multicast groups, LR1MAC_MC_NUMBER_OF_SESSION MAX is 4"
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE MACROS-----------------------------------------------------------
@@ -109,6 +113,19 @@ typedef struct lr11xx_ce_context_nvm_s
     uint32_t         crc;
 } lr11xx_ce_context_nvm_t;
 
+/**
+ * @brief Streamed CMAC context: the LR11XX computes CMAC in one command, data is gathered until the final call
+ *
+ * @struct lr11xx_ce_cmac_stream_t
+ */
+typedef struct lr11xx_ce_cmac_stream_s
+{
+    bool                     started;
+    smtc_se_key_identifier_t key_id;
+    uint16_t                 size;
+    uint8_t                  buffer[CRYPTO_BUFFER_SIZE];
+} lr11xx_ce_cmac_stream_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -117,6 +134,8 @@ typedef struct lr11xx_ce_context_nvm_s
 static lr11xx_ce_data_t lr11xx_ce_data;
 static const void*      lr11xx_ctx;
 
+static lr11xx_ce_cmac_stream_t lr11xx_ce_cmac_stream;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -130,6 +149,48 @@ static const void*      lr11xx_ctx;
  */
 static lr11xx_crypto_keys_idx_t convert_key_id_from_se_to_lr11xx( smtc_se_key_identifier_t key_id );
 
+/**
+ * @brief Compute a CMAC with a single crypto engine command, the radio access shall already be suspended
+ *
+ * @param [in]  mic_bx_buffer   B0 block prepended to the buffer, NULL if none
+ * @param [in]  buffer          Data buffer
+ * @param [in]  size            Data buffer size
+ * @param [in]  key_id          Key identifier
+ * @param [out] cmac            Computed CMAC
+ * @return smtc_se_return_code_t
+ */
+static smtc_se_return_code_t lr11xx_ce_compute_aes_cmac( const uint8_t* mic_bx_buffer, const uint8_t* buffer,
+                                                         uint16_t size, smtc_se_key_identifier_t key_id,
+                                                         uint32_t* cmac );
+
+/**
+ * @brief Encrypt 16 bytes blocks with a single crypto engine command, the radio access shall already be suspended
+ *
+ * @param [in]  buffer      Data buffer
+ * @param [in]  size        Data buffer size, multiple of 16
+ * @param [in]  key_id      Key identifier
+ * @param [out] enc_buffer  Encrypted buffer
+ * @return smtc_se_return_code_t
+ */
+static smtc_se_return_code_t lr11xx_ce_aes_encrypt( const uint8_t* buffer, uint16_t size,
+                                                    smtc_se_key_identifier_t key_id, uint8_t* enc_buffer );
+
+/**
+ * @brief Encrypt in counter mode with one crypto engine command per 256 bytes, the radio access shall already be
+ * suspended
+ *
+ * @param [in]  buffer      Data buffer
+ * @param [in]  size        Data buffer size
+ * @param [in]  key_id      Key identifier
+ * @param [in]  ctr_block   Initial counter block
+ * @param [out] enc_buffer  Encrypted buffer, can be the same as buffer
+ * @return smtc_se_return_code_t
+ */
+static smtc_se_return_code_t lr11xx_ce_aes_ctr_encrypt( const uint8_t* buffer, uint16_t size,
+                                                        smtc_se_key_identifier_t key_id,
+                                                        const uint8_t            ctr_block[SMTC_SE_KEY_SIZE],
+                                                        uint8_t*                 enc_buffer );
+
 /**
  * @brief CRC function for lr11xx se context security
  *
@@ -225,7 +286,6 @@ smtc_se_return_code_t smtc_secure_element_compute_aes_cmac( const uint8_t* mic_b
                                                             uint32_t* cmac, uint8_t stack_id )
 {
     smtc_se_return_code_t status = SMTC_SE_RC_ERROR;
-    // uint8_t*              local_buffer = buffer;
 
     if( ( buffer == NULL ) || ( cmac == NULL ) )
     {
@@ -240,32 +300,85 @@ smtc_se_return_code_t smtc_secure_element_compute_aes_cmac( const uint8_t* mic_b
     // lr11xx crypto operation needed: suspend modem radio access to secure this direct access
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_suspend_radio_access( ) == true );
 
+    status = lr11xx_ce_compute_aes_cmac( mic_bx_buffer, buffer, size, key_id, cmac );
+
+    // lr11xx crypto operation done: resume modem radio access
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_resume_radio_access( ) == true );
+
+    return status;
+}
+
+smtc_se_return_code_t smtc_secure_element_cmac_stream_start( const uint8_t* mic_bx_buffer,
+                                                            smtc_se_key_identifier_t key_id, uint8_t stack_id )
+{
+    lr11xx_ce_cmac_stream.started = true;
+    lr11xx_ce_cmac_stream.key_id  = key_id;
+    lr11xx_ce_cmac_stream.size    = 0;
+
     if( mic_bx_buffer != NULL )
     {
-        uint8_t  mic_buff[CRYPTO_BUFFER_SIZE];
-        uint16_t cur_size = size + MIC_BLOCK_BX_SIZE;
+        memcpy( lr11xx_ce_cmac_stream.buffer, mic_bx_buffer, MIC_BLOCK_BX_SIZE );
+        lr11xx_ce_cmac_stream.size = MIC_BLOCK_BX_SIZE;
+    }
 
-        memset( mic_buff, 0, CRYPTO_BUFFER_SIZE );
+    return SMTC_SE_RC_SUCCESS;
+}
 
-        memcpy( mic_buff, mic_bx_buffer, MIC_BLOCK_BX_SIZE );
-        memcpy( ( mic_buff + MIC_BLOCK_BX_SIZE ), buffer, size );
-        // local_buffer = mic_buff;
-        SMTC_MODEM_HAL_PANIC_ON_FAILURE(
-            lr11xx_crypto_compute_aes_cmac( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
-                                            convert_key_id_from_se_to_lr11xx( key_id ), mic_buff, cur_size,
-                                            ( uint8_t* ) cmac ) == LR11XX_STATUS_OK );
+smtc_se_return_code_t smtc_secure_element_cmac_stream_update( const uint8_t* buffer, uint16_t size )
+{
+    if( ( buffer == NULL ) && ( size != 0 ) )
+    {
+        return SMTC_SE_RC_ERROR_NPE;
     }
-    else
+
+    if( lr11xx_ce_cmac_stream.started == false )
     {
-        SMTC_MODEM_HAL_PANIC_ON_FAILURE(
-            lr11xx_crypto_compute_aes_cmac( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
-                                            convert_key_id_from_se_to_lr11xx( key_id ), buffer, size,
-                                            ( uint8_t* ) cmac ) == LR11XX_STATUS_OK );
+        return SMTC_SE_RC_ERROR;
+    }
+
+    if( size > ( CRYPTO_BUFFER_SIZE - lr11xx_ce_cmac_stream.size ) )
+    {
+        lr11xx_ce_cmac_stream.started = false;
+        return SMTC_SE_RC_ERROR_BUF_SIZE;
+    }
+
+    if( size != 0 )
+    {
+        memcpy( &lr11xx_ce_cmac_stream.buffer[lr11xx_ce_cmac_stream.size], buffer, size );
+        lr11xx_ce_cmac_stream.size += size;
     }
 
+    return SMTC_SE_RC_SUCCESS;
+}
+
+smtc_se_return_code_t smtc_secure_element_cmac_stream_final( uint32_t* cmac )
+{
+    smtc_se_return_code_t status = SMTC_SE_RC_ERROR;
+
+    if( cmac == NULL )
+    {
+        return SMTC_SE_RC_ERROR_NPE;
+    }
+
+    if( lr11xx_ce_cmac_stream.started == false )
+    {
+        return SMTC_SE_RC_ERROR;
+    }
+
+    // lr11xx crypto operation needed: suspend modem radio access to secure this direct access
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_suspend_radio_access( ) == true );
+
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        lr11xx_crypto_compute_aes_cmac( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
+                                        convert_key_id_from_se_to_lr11xx( lr11xx_ce_cmac_stream.key_id ),
+                                        lr11xx_ce_cmac_stream.buffer, lr11xx_ce_cmac_stream.size,
+                                        ( uint8_t* ) cmac ) == LR11XX_STATUS_OK );
+
     // lr11xx crypto operation done: resume modem radio access
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_resume_radio_access( ) == true );
 
+    lr11xx_ce_cmac_stream.started = false;
+
     return status;
 }
 
@@ -307,17 +420,62 @@ smtc_se_return_code_t smtc_secure_element_aes_encrypt( const uint8_t* buffer, ui
     // lr11xx crypto operation needed: suspend modem radio access to secure this direct access
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_suspend_radio_access( ) == true );
 
-    if( key_id == SMTC_SE_SLOT_RAND_ZERO_KEY )
+    status = lr11xx_ce_aes_encrypt( buffer, size, key_id, enc_buffer );
+
+    // lr11xx crypto operation done: resume modem radio access
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_resume_radio_access( ) == true );
+
+    return status;
+}
+
+smtc_se_return_code_t smtc_secure_element_aes_ctr_encrypt( const uint8_t* buffer, uint16_t size,
+                                                           smtc_se_key_identifier_t key_id,
+                                                           const uint8_t ctr_block[SMTC_SE_KEY_SIZE],
+                                                           uint8_t* enc_buffer, uint8_t stack_id )
+{
+    smtc_se_return_code_t status = SMTC_SE_RC_ERROR;
+
+    if( ( buffer == NULL ) || ( enc_buffer == NULL ) || ( ctr_block == NULL ) )
     {
-        SMTC_MODEM_HAL_PANIC_ON_FAILURE( lr11xx_crypto_aes_encrypt( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
-                                                                    LR11XX_CRYPTO_KEYS_IDX_GP0, buffer, size,
-                                                                    enc_buffer ) == LR11XX_STATUS_OK );
+        return SMTC_SE_RC_ERROR_NPE;
     }
-    else
+
+    // lr11xx crypto operation needed: suspend modem radio access once for all the chunks
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_suspend_radio_access( ) == true );
+
+    status = lr11xx_ce_aes_ctr_encrypt( buffer, size, key_id, ctr_block, enc_buffer );
+
+    // lr11xx crypto operation done: resume modem radio access
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_resume_radio_access( ) == true );
+
+    return status;
+}
+
+smtc_se_return_code_t smtc_secure_element_aes_ctr_encrypt_and_cmac(
+    uint8_t* frame, uint16_t frame_size, uint16_t payload_offset, uint16_t payload_size,
+    smtc_se_key_identifier_t enc_key_id, const uint8_t ctr_block[SMTC_SE_KEY_SIZE], const uint8_t* mic_bx_buffer,
+    smtc_se_key_identifier_t mic_key_id, uint32_t* cmac, uint8_t stack_id )
+{
+    smtc_se_return_code_t status = SMTC_SE_RC_ERROR;
+
+    if( ( frame == NULL ) || ( ctr_block == NULL ) || ( cmac == NULL ) )
     {
-        SMTC_MODEM_HAL_PANIC_ON_FAILURE( lr11xx_crypto_aes_encrypt_01( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
-                                                                       convert_key_id_from_se_to_lr11xx( key_id ),
-                                                                       buffer, size, enc_buffer ) == LR11XX_STATUS_OK );
+        return SMTC_SE_RC_ERROR_NPE;
+    }
+
+    if( ( frame_size > CRYPTO_MAXMESSAGE_SIZE ) || ( ( payload_offset + payload_size ) > frame_size ) )
+    {
+        return SMTC_SE_RC_ERROR_BUF_SIZE;
+    }
+
+    // lr11xx crypto operation needed: suspend modem radio access once for the encryption and the CMAC commands
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( modem_suspend_radio_access( ) == true );
+
+    status = lr11xx_ce_aes_ctr_encrypt( &frame[payload_offset], payload_size, enc_key_id, ctr_block,
+                                        &frame[payload_offset] );
+    if( status == SMTC_SE_RC_SUCCESS )
+    {
+        status = lr11xx_ce_compute_aes_cmac( mic_bx_buffer, frame, frame_size, mic_key_id, cmac );
     }
 
     // lr11xx crypto operation done: resume modem radio access
@@ -570,7 +728,7 @@ smtc_se_return_code_t smtc_secure_element_store_context( uint8_t stack_id )
     // Note: Multistack is not suported in lr11xx crypto element
 
     lr11xx_ce_context_nvm_t ctx_old = { 0 };
-    smtc_modem_hal_context_restore( CONTEXT_SECURE_ELEMENT, 0, ( uint8_t* ) &ctx_old, sizeof( ctx_old ) );
+    modem_context_restore( CONTEXT_SECURE_ELEMENT, 0, ( uint8_t* ) &ctx_old, sizeof( ctx_old ) );
 
     lr11xx_ce_context_nvm_t ctx = {
         .data = lr11xx_ce_data,
@@ -580,7 +738,7 @@ smtc_se_return_code_t smtc_secure_element_store_context( uint8_t stack_id )
 
     if( ctx.crc != ctx_old.crc )
     {
-        smtc_modem_hal_context_store( CONTEXT_SECURE_ELEMENT, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+        modem_context_store( CONTEXT_SECURE_ELEMENT, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
         smtc_secure_element_restore_context( stack_id );
     }
     return SMTC_SE_RC_SUCCESS;
@@ -589,7 +747,7 @@ smtc_se_return_code_t smtc_secure_element_store_context( uint8_t stack_id )
 smtc_se_return_code_t smtc_secure_element_restore_context( uint8_t stack_id )
 {
     lr11xx_ce_context_nvm_t ctx;
-    smtc_modem_hal_context_restore( CONTEXT_SECURE_ELEMENT, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_restore( CONTEXT_SECURE_ELEMENT, 0, ( uint8_t* ) &ctx, sizeof( ctx ) );
     if( lr11xx_ce_crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) ) == ctx.crc )
     {
         lr11xx_ce_data = ctx.data;
@@ -609,6 +767,89 @@ smtc_se_return_code_t smtc_secure_element_restore_context( uint8_t stack_id )
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+static smtc_se_return_code_t lr11xx_ce_compute_aes_cmac( const uint8_t* mic_bx_buffer, const uint8_t* buffer,
+                                                         uint16_t size, smtc_se_key_identifier_t key_id,
+                                                         uint32_t* cmac )
+{
+    smtc_se_return_code_t status = SMTC_SE_RC_ERROR;
+
+    if( mic_bx_buffer != NULL )
+    {
+        uint8_t  mic_buff[CRYPTO_BUFFER_SIZE];
+        uint16_t cur_size = size + MIC_BLOCK_BX_SIZE;
+
+        memcpy( mic_buff, mic_bx_buffer, MIC_BLOCK_BX_SIZE );
+        memcpy( ( mic_buff + MIC_BLOCK_BX_SIZE ), buffer, size );
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+            lr11xx_crypto_compute_aes_cmac( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
+                                            convert_key_id_from_se_to_lr11xx( key_id ), mic_buff, cur_size,
+                                            ( uint8_t* ) cmac ) == LR11XX_STATUS_OK );
+    }
+    else
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+            lr11xx_crypto_compute_aes_cmac( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
+                                            convert_key_id_from_se_to_lr11xx( key_id ), buffer, size,
+                                            ( uint8_t* ) cmac ) == LR11XX_STATUS_OK );
+    }
+    return status;
+}
+
+static smtc_se_return_code_t lr11xx_ce_aes_encrypt( const uint8_t* buffer, uint16_t size,
+                                                    smtc_se_key_identifier_t key_id, uint8_t* enc_buffer )
+{
+    smtc_se_return_code_t status = SMTC_SE_RC_ERROR;
+
+    if( key_id == SMTC_SE_SLOT_RAND_ZERO_KEY )
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( lr11xx_crypto_aes_encrypt( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
+                                                                    LR11XX_CRYPTO_KEYS_IDX_GP0, buffer, size,
+                                                                    enc_buffer ) == LR11XX_STATUS_OK );
+    }
+    else
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( lr11xx_crypto_aes_encrypt_01( lr11xx_ctx, ( lr11xx_crypto_status_t* ) &status,
+                                                                       convert_key_id_from_se_to_lr11xx( key_id ),
+                                                                       buffer, size, enc_buffer ) == LR11XX_STATUS_OK );
+    }
+    return status;
+}
+
+static smtc_se_return_code_t lr11xx_ce_aes_ctr_encrypt( const uint8_t* buffer, uint16_t size,
+                                                        smtc_se_key_identifier_t key_id,
+                                                        const uint8_t            ctr_block[SMTC_SE_KEY_SIZE],
+                                                        uint8_t*                 enc_buffer )
+{
+    smtc_se_return_code_t status = SMTC_SE_RC_SUCCESS;
+    uint8_t               keystream[CRYPTO_MAXMESSAGE_SIZE];
+    uint16_t              ctr   = ( ( uint16_t ) ctr_block[14] << 8 ) | ctr_block[15];
+    uint16_t              index = 0;
+
+    while( ( index < size ) && ( status == SMTC_SE_RC_SUCCESS ) )
+    {
+        uint16_t chunk_size = ( ( size - index ) > CRYPTO_MAXMESSAGE_SIZE ) ? CRYPTO_MAXMESSAGE_SIZE : ( size - index );
+        uint16_t nb_block   = ( chunk_size + 15 ) >> 4;
+
+        // Build all the counter blocks of this chunk to get the keystream with a single crypto engine command
+        for( uint16_t i = 0; i < nb_block; i++ )
+        {
+            memcpy( &keystream[i << 4], ctr_block, 14 );
+            keystream[( i << 4 ) + 14] = ( uint8_t ) ( ctr >> 8 );
+            keystream[( i << 4 ) + 15] = ( uint8_t ) ctr;
+            ctr++;
+        }
+
+        status = lr11xx_ce_aes_encrypt( keystream, nb_block << 4, key_id, keystream );
+
+        for( uint16_t i = 0; i < chunk_size; i++ )
+        {
+            enc_buffer[index + i] = buffer[index + i] ^ keystream[i];
+        }
+        index += chunk_size;
+    }
+    return status;
+}
+
 static lr11xx_crypto_keys_idx_t convert_key_id_from_se_to_lr11xx( smtc_se_key_identifier_t key_id )
 {
     lr11xx_crypto_keys_idx_t id = LR11XX_CRYPTO_KEYS_IDX_GP1;
@@ -702,16 +943,6 @@ static lr11xx_crypto_keys_idx_t convert_key_id_from_se_to_lr11xx( smtc_se_key_id
 
 uint32_t lr11xx_ce_crc( const uint8_t* buf, int len )
 {
-    uint32_t crc = 0xFFFFFFFF;
-    while( len-- > 0 )
-    {
-        crc = crc ^ *buf++;
-        for( int i = 0; i < 8; i++ )
-        {
-            uint32_t mask = -( crc & 1 );
-            crc           = ( crc >> 1 ) ^ ( 0xEDB88320 & mask );
-        }
-    }
-    return ~crc;
+    return modem_crc32( buf, ( len > 0 ) ? ( uint32_t ) len : 0 );
 }
 /* --- EOF ------------------------------------------------------------------ */
@@ -159,6 +159,16 @@ static smtc_modem_crypto_return_code_t derive_session_key_1_0_x( smtc_se_key_ide
                                                                  const uint8_t* join_nonce, const uint8_t* net_id,
                                                                  uint16_t dev_nonce, uint8_t stack_id );
 
+/**
+ * @brief Prepares the first counter block A1 of the payload encryption
+ *
+ * @param [in] dir Frame direction [0: uplink, 1: downlink]
+ * @param [in] address Device or multicast address
+ * @param [in] frame_counter Frame counter
+ * @param [out] a1 A1 block (16 bytes)
+ */
+static void prepare_a1( uint8_t dir, uint32_t address, uint32_t frame_counter, uint8_t* a1 );
+
 /**
  * @brief Derives the Multicast Root Key (McRootKey) from the AppKey.
  *
@@ -199,43 +209,14 @@ smtc_modem_crypto_return_code_t smtc_modem_crypto_payload_encrypt( const uint8_t
         return SMTC_MODEM_CRYPTO_RC_ERROR_NPE;
     }
 
-    uint16_t buffer_idx = 0;
-    uint16_t ctr        = 1;
-    uint8_t  sBlock[16] = { 0 };
-    uint8_t  aBlock[16] = { 0 };
-    int16_t  local_size = size;
-
-    aBlock[0] = 0x01;
+    uint8_t aBlock[16];
 
-    aBlock[5] = dir;
+    prepare_a1( dir, address, frame_counter, aBlock );
 
-    aBlock[6] = address & 0xFF;
-    aBlock[7] = ( address >> 8 ) & 0xFF;
-    aBlock[8] = ( address >> 16 ) & 0xFF;
-    aBlock[9] = ( address >> 24 ) & 0xFF;
-
-    aBlock[10] = frame_counter & 0xFF;
-    aBlock[11] = ( frame_counter >> 8 ) & 0xFF;
-    aBlock[12] = ( frame_counter >> 16 ) & 0xFF;
-    aBlock[13] = ( frame_counter >> 24 ) & 0xFF;
-
-    while( local_size > 0 )
+    if( smtc_secure_element_aes_ctr_encrypt( buffer, size, key_id, aBlock, enc_buffer, stack_id ) !=
+        SMTC_SE_RC_SUCCESS )
     {
-        aBlock[15] = ctr & 0xFF;
-
-        ctr++;
-
-        if( smtc_secure_element_aes_encrypt( aBlock, 16, key_id, sBlock, stack_id ) != SMTC_SE_RC_SUCCESS )
-        {
-            return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
-        }
-
-        for( uint8_t i = 0; i < ( ( local_size > 16 ) ? 16 : local_size ); i++ )
-        {
-            enc_buffer[buffer_idx + i] = buffer[buffer_idx + i] ^ sBlock[i];
-        }
-        local_size -= 16;
-        buffer_idx += 16;
+        return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
     }
 
     return SMTC_MODEM_CRYPTO_RC_SUCCESS;
@@ -309,34 +290,70 @@ smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic( const uint8_t* buf
     {
         return SMTC_MODEM_CRYPTO_RC_ERROR_NPE;
     }
+
+    smtc_modem_crypto_return_code_t rc =
+        smtc_modem_crypto_verify_mic_start( size, key_id, devaddr, dir, fcnt, stack_id );
+
+    if( rc == SMTC_MODEM_CRYPTO_RC_SUCCESS )
+    {
+        rc = smtc_modem_crypto_verify_mic_update( buffer, size );
+    }
+    if( rc == SMTC_MODEM_CRYPTO_RC_SUCCESS )
+    {
+        rc = smtc_modem_crypto_verify_mic_final( expected_mic );
+    }
+    return rc;
+}
+
+smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic_start( uint16_t size, smtc_se_key_identifier_t key_id,
+                                                                    uint32_t devaddr, uint8_t dir, uint32_t fcnt,
+                                                                    uint8_t stack_id )
+{
     if( size > CRYPTO_MAXMESSAGE_SIZE )
     {
         return SMTC_MODEM_CRYPTO_RC_ERROR_BUF_SIZE;
     }
 
-    uint8_t mic_buff[CRYPTO_BUFFER_SIZE] = { 0 };
+    uint8_t mic_buff[MIC_BLOCK_BX_SIZE];
 
-    // Initialize the first Block
+    // Initialize the first Block, the frame itself is streamed after it
     prepare_b0( size, dir, devaddr, fcnt, mic_buff );
 
-    // Copy the given data to the mic computation buffer
-    memcpy( ( mic_buff + MIC_BLOCK_BX_SIZE ), buffer, size );
-
-    smtc_se_return_code_t rc = SMTC_SE_RC_ERROR;
-    rc = smtc_secure_element_verify_aes_cmac( mic_buff, ( size + MIC_BLOCK_BX_SIZE ), expected_mic, key_id, stack_id );
+    if( smtc_secure_element_cmac_stream_start( mic_buff, key_id, stack_id ) != SMTC_SE_RC_SUCCESS )
+    {
+        return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
+    }
+    return SMTC_MODEM_CRYPTO_RC_SUCCESS;
+}
 
-    if( rc == SMTC_SE_RC_SUCCESS )
+smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic_update( const uint8_t* buffer, uint16_t size )
+{
+    if( buffer == 0 )
     {
-        return SMTC_MODEM_CRYPTO_RC_SUCCESS;
+        return SMTC_MODEM_CRYPTO_RC_ERROR_NPE;
     }
-    else if( rc == SMTC_SE_RC_FAIL_CMAC )
+
+    if( smtc_secure_element_cmac_stream_update( buffer, size ) != SMTC_SE_RC_SUCCESS )
     {
-        return SMTC_MODEM_CRYPTO_RC_FAIL_MIC;
+        return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
     }
-    else
+    return SMTC_MODEM_CRYPTO_RC_SUCCESS;
+}
+
+smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic_final( uint32_t expected_mic )
+{
+    uint32_t computed_mic = 0;
+
+    if( smtc_secure_element_cmac_stream_final( &computed_mic ) != SMTC_SE_RC_SUCCESS )
     {
         return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
     }
+
+    if( computed_mic != expected_mic )
+    {
+        return SMTC_MODEM_CRYPTO_RC_FAIL_MIC;
+    }
+    return SMTC_MODEM_CRYPTO_RC_SUCCESS;
 }
 
 smtc_modem_crypto_return_code_t smtc_modem_crypto_compute_and_add_mic( uint8_t* buffer, uint16_t size,
@@ -351,6 +368,36 @@ smtc_modem_crypto_return_code_t smtc_modem_crypto_compute_and_add_mic( uint8_t*
     return rc;
 }
 
+smtc_modem_crypto_return_code_t smtc_modem_crypto_payload_encrypt_and_add_mic(
+    uint8_t* buffer, uint16_t size, uint16_t payload_offset, uint16_t payload_size, smtc_se_key_identifier_t enc_key_id,
+    smtc_se_key_identifier_t mic_key_id, uint32_t devaddr, uint8_t dir, uint32_t fcnt, uint8_t stack_id )
+{
+    if( buffer == 0 )
+    {
+        return SMTC_MODEM_CRYPTO_RC_ERROR_NPE;
+    }
+    if( size > CRYPTO_MAXMESSAGE_SIZE )
+    {
+        return SMTC_MODEM_CRYPTO_RC_ERROR_BUF_SIZE;
+    }
+
+    uint8_t  a_block[16];
+    uint8_t  mic_buff[MIC_BLOCK_BX_SIZE];
+    uint32_t computed_mic;
+
+    prepare_a1( dir, devaddr, fcnt, a_block );
+    prepare_b0( size, dir, devaddr, fcnt, mic_buff );
+
+    if( smtc_secure_element_aes_ctr_encrypt_and_cmac( buffer, size, payload_offset, payload_size, enc_key_id, a_block,
+                                                      mic_buff, mic_key_id, &computed_mic,
+                                                      stack_id ) != SMTC_SE_RC_SUCCESS )
+    {
+        return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
+    }
+    memcpy( &buffer[size], ( uint8_t* ) &computed_mic, 4 );
+    return SMTC_MODEM_CRYPTO_RC_SUCCESS;
+}
+
 smtc_modem_crypto_return_code_t smtc_modem_crypto_set_key( smtc_se_key_identifier_t key_id, const uint8_t* key,
                                                            uint8_t stack_id )
 {
@@ -479,33 +526,18 @@ smtc_modem_crypto_return_code_t smtc_modem_crypto_service_encrypt( const uint8_t
         return SMTC_MODEM_CRYPTO_RC_ERROR_NPE;
     }
 
-    uint16_t index       = 0;
-    uint16_t ctr         = 1;
-    uint8_t  s_block[16] = { 0 };
-    uint8_t  a_block[16] = { 0 };
-    int16_t  local_size  = len;
+    uint8_t a_block[16] = { 0 };
 
     // first copy the 14 bytes of nonce into a_block first 14 bytes
     memcpy( a_block, nonce, 14 );
 
-    while( local_size > 0 )
-    {
-        a_block[15] = ctr & 0xFF;
-        a_block[14] = ( ctr >> 8 ) & 0xFF;
-
-        ctr++;
+    // First block counter
+    a_block[15] = 0x01;
 
-        if( smtc_secure_element_aes_encrypt( a_block, 16, SMTC_SE_APP_S_KEY, s_block, stack_id ) != SMTC_SE_RC_SUCCESS )
-        {
-            return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
-        }
-
-        for( uint8_t i = 0; i < ( ( local_size > 16 ) ? 16 : local_size ); i++ )
-        {
-            enc_buff[index + i] = clear_buff[index + i] ^ s_block[i];
-        }
-        local_size -= 16;
-        index += 16;
+    if( smtc_secure_element_aes_ctr_encrypt( clear_buff, len, SMTC_SE_APP_S_KEY, a_block, enc_buff, stack_id ) !=
+        SMTC_SE_RC_SUCCESS )
+    {
+        return SMTC_MODEM_CRYPTO_RC_ERROR_SECURE_ELEMENT;
     }
 
     return SMTC_MODEM_CRYPTO_RC_SUCCESS;
@@ -574,6 +606,28 @@ static smtc_modem_crypto_return_code_t prepare_b0( uint16_t msg_len, uint8_t dir
     return SMTC_MODEM_CRYPTO_RC_SUCCESS;
 }
 
+static void prepare_a1( uint8_t dir, uint32_t address, uint32_t frame_counter, uint8_t* a1 )
+{
+    memset( a1, 0, 16 );
+
+    a1[0] = 0x01;
+
+    a1[5] = dir;
+
+    a1[6] = address & 0xFF;
+    a1[7] = ( address >> 8 ) & 0xFF;
+    a1[8] = ( address >> 16 ) & 0xFF;
+    a1[9] = ( address >> 24 ) & 0xFF;
+
+    a1[10] = frame_counter & 0xFF;
+    a1[11] = ( frame_counter >> 8 ) & 0xFF;
+    a1[12] = ( frame_counter >> 16 ) & 0xFF;
+    a1[13] = ( frame_counter >> 24 ) & 0xFF;
+
+    // First block counter
+    a1[15] = 0x01;
+}
+
 static smtc_modem_crypto_return_code_t derive_session_key_1_0_x( smtc_se_key_identifier_t key_id,
                                                                  const uint8_t* join_nonce, const uint8_t* net_id,
                                                                  uint16_t dev_nonce, uint8_t stack_id )
@@ -206,6 +206,41 @@ smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic( const uint8_t* buf
                                                               uint8_t dir, uint32_t fcnt, uint32_t expected_mic,
                                                               uint8_t stack_id );
 
+/**
+ * @brief Starts a streamed mic verification
+ *
+ * @remark The frame is then given in one or several chunks with @ref smtc_modem_crypto_verify_mic_update and checked
+ *         with @ref smtc_modem_crypto_verify_mic_final. Only one streamed verification can be ongoing at a time.
+ *
+ * @param [in] size Total size of the data covered by the integrity code
+ * @param [in] key_id Key identifier
+ * @param [in] devaddr Device address
+ * @param [in] dir Frame direction ( Uplink:0, Downlink:1 )
+ * @param [in] fcnt Frame counter
+ * @param [in] stack_id Stack identifier
+ * @return smtc_modem_crypto_return_code_t
+ */
+smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic_start( uint16_t size, smtc_se_key_identifier_t key_id,
+                                                                    uint32_t devaddr, uint8_t dir, uint32_t fcnt,
+                                                                    uint8_t stack_id );
+
+/**
+ * @brief Feeds a chunk of data to the ongoing streamed mic verification
+ *
+ * @param [in] buffer Data buffer
+ * @param [in] size Data buffer size
+ * @return smtc_modem_crypto_return_code_t
+ */
+smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic_update( const uint8_t* buffer, uint16_t size );
+
+/**
+ * @brief Ends the ongoing streamed mic verification
+ *
+ * @param [in] expected_mic Expected mic
+ * @return smtc_modem_crypto_return_code_t
+ */
+smtc_modem_crypto_return_code_t smtc_modem_crypto_verify_mic_final( uint32_t expected_mic );
+
 /**
  * @brief Compute and add mic to a buffer
  *
@@ -222,6 +257,27 @@ smtc_modem_crypto_return_code_t smtc_modem_crypto_compute_and_add_mic( uint8_t*
                                                                        uint32_t devaddr, uint8_t dir, uint32_t fcnt,
                                                                        uint8_t stack_id );
 
+/**
+ * @brief Encrypt the payload of an uplink frame and add the mic, with a single secure element access
+ *
+ * Same result as @ref smtc_modem_crypto_payload_encrypt on the payload followed by
+ * @ref smtc_modem_crypto_compute_and_add_mic on the frame.
+ *
+ * @param [in,out] buffer Frame buffer, the payload is encrypted in place and the mic is added after size bytes
+ * @param [in] size Frame size, mic excluded
+ * @param [in] payload_offset Offset of the payload in the frame
+ * @param [in] payload_size Payload size
+ * @param [in] enc_key_id Payload encryption key identifier
+ * @param [in] mic_key_id Mic key identifier
+ * @param [in] devaddr Device address
+ * @param [in] dir Frame direction [0: uplink, 1: downlink]
+ * @param [in] fcnt Frame counter
+ * @return smtc_modem_crypto_return_code_t
+ */
+smtc_modem_crypto_return_code_t smtc_modem_crypto_payload_encrypt_and_add_mic(
+    uint8_t* buffer, uint16_t size, uint16_t payload_offset, uint16_t payload_size, smtc_se_key_identifier_t enc_key_id,
+    smtc_se_key_identifier_t mic_key_id, uint32_t devaddr, uint8_t dir, uint32_t fcnt, uint8_t stack_id );
+
 /**
  * @brief Sets a key
  *
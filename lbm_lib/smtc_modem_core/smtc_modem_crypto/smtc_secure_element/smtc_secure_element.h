@@ -147,6 +147,18 @@ typedef enum smtc_se_key_identifier_e
     SMTC_SE_RELAY_WOR_S_ENC_KEY,                 //!< Relay WOR Encryption Session Key
     SMTC_SE_DATA_BLOCK_INT_KEY,                  //!< Fragmented data block Transport DataBlockIntKey
     SMTC_SE_SLOT_RAND_ZERO_KEY,                  //!< Zero key for slot randomization in class B
+    SMTC_SE_MC_KEY_4,                            //!< Multicast root key index 4
+    SMTC_SE_MC_APP_S_KEY_4,                      //!< Multicast Application session key index 4
+    SMTC_SE_MC_NWK_S_KEY_4,                      //!< Multicast Network session key index 4
+    SMTC_SE_MC_KEY_5,                            //!< Multicast root key index 5
+    SMTC_SE_MC_APP_S_KEY_5,                      //!< Multicast Application session key index 5
+    SMTC_SE_MC_NWK_S_KEY_5,                      //!< Multicast Network session key index 5
+    SMTC_SE_MC_KEY_6,                            //!< Multicast root key index 6
+    SMTC_SE_MC_APP_S_KEY_6,                      //!< Multicast Application session key index 6
+    SMTC_SE_MC_NWK_S_KEY_6,                      //!< Multicast Network session key index 6
+    SMTC_SE_MC_KEY_7,                            //!< Multicast root key index 7
+    SMTC_SE_MC_APP_S_KEY_7,                      //!< Multicast Application session key index 7
+    SMTC_SE_MC_NWK_S_KEY_7,                      //!< Multicast Network session key index 7
     SMTC_SE_NO_KEY,                              //!< No Key
 } smtc_se_key_identifier_t;
 
@@ -188,6 +200,36 @@ smtc_se_return_code_t smtc_secure_element_compute_aes_cmac( const uint8_t* mic_b
                                                             uint16_t size, smtc_se_key_identifier_t key_id,
                                                             uint32_t* cmac, uint8_t stack_id );
 
+/**
+ * @brief Starts a streamed CMAC computation using provided initial Bx block
+ *
+ * @remark Only one streamed computation can be ongoing at a time, a new start aborts the previous one
+ *
+ * @param [in] mic_bx_buffer Buffer containing the initial Bx block (can be NULL)
+ * @param [in] key_id Key identifier to determine the AES key to be used
+ * @param [in] stack_id The Stack Identifier
+ * @return Secure element return code as defined in @ref smtc_se_return_code_t
+ */
+smtc_se_return_code_t smtc_secure_element_cmac_stream_start( const uint8_t* mic_bx_buffer,
+                                                            smtc_se_key_identifier_t key_id, uint8_t stack_id );
+
+/**
+ * @brief Feeds data to the ongoing streamed CMAC computation
+ *
+ * @param [in] buffer Data buffer
+ * @param [in] size Data buffer size
+ * @return Secure element return code as defined in @ref smtc_se_return_code_t
+ */
+smtc_se_return_code_t smtc_secure_element_cmac_stream_update( const uint8_t* buffer, uint16_t size );
+
+/**
+ * @brief Ends the ongoing streamed CMAC computation
+ *
+ * @param [out] cmac Computed cmac
+ * @return Secure element return code as defined in @ref smtc_se_return_code_t
+ */
+smtc_se_return_code_t smtc_secure_element_cmac_stream_final( uint32_t* cmac );
+
 /**
  * @brief Verifies a CMAC (computes and compare with expected cmac)
  *
@@ -215,6 +257,47 @@ smtc_se_return_code_t smtc_secure_element_aes_encrypt( const uint8_t* buffer, ui
                                                        smtc_se_key_identifier_t key_id, uint8_t* enc_buffer,
                                                        uint8_t stack_id );
 
+/**
+ * @brief Encrypt/decrypt a buffer in counter mode, the whole keystream being generated in one call
+ *
+ * The counter is the 16-bit big endian value held in the last two bytes of ctr_block, it is incremented for each
+ * 16 bytes block of data. The last block of keystream is truncated to the remaining size.
+ *
+ * @param [in] buffer Data buffer
+ * @param [in] size Data buffer size
+ * @param [in] key_id Key identifier to determine the AES key to be used
+ * @param [in] ctr_block Initial counter block
+ * @param [out] enc_buffer Encrypted buffer (can be the same as buffer)
+ * @param [in] stack_id The Stack Identifier
+ * @return Secure element return code as defined in @ref smtc_se_return_code_t
+ */
+smtc_se_return_code_t smtc_secure_element_aes_ctr_encrypt( const uint8_t* buffer, uint16_t size,
+                                                           smtc_se_key_identifier_t key_id,
+                                                           const uint8_t ctr_block[SMTC_SE_KEY_SIZE],
+                                                           uint8_t* enc_buffer, uint8_t stack_id );
+
+/**
+ * @brief Encrypt a payload in counter mode inside a frame, then compute the CMAC of the whole frame
+ *
+ * A LoRaWAN uplink needs both operations in a row, a secure element chains them in one access instead of two.
+ *
+ * @param [in,out] frame Frame buffer, the payload is encrypted in place
+ * @param [in] frame_size Frame size
+ * @param [in] payload_offset Offset of the payload in the frame
+ * @param [in] payload_size Payload size
+ * @param [in] enc_key_id Key identifier of the payload encryption
+ * @param [in] ctr_block Initial counter block of the payload encryption
+ * @param [in] mic_bx_buffer B0 block prepended to the frame for the CMAC, NULL if none
+ * @param [in] mic_key_id Key identifier of the CMAC
+ * @param [out] cmac Computed cmac
+ * @param [in] stack_id The Stack Identifier
+ * @return Secure element return code as defined in @ref smtc_se_return_code_t
+ */
+smtc_se_return_code_t smtc_secure_element_aes_ctr_encrypt_and_cmac(
+    uint8_t* frame, uint16_t frame_size, uint16_t payload_offset, uint16_t payload_size,
+    smtc_se_key_identifier_t enc_key_id, const uint8_t ctr_block[SMTC_SE_KEY_SIZE], const uint8_t* mic_bx_buffer,
+    smtc_se_key_identifier_t mic_key_id, uint32_t* cmac, uint8_t stack_id );
+
 /**
  * @brief Derives and store a key
  *
@@ -628,6 +628,20 @@ return_type smtc_aes_cbc_encrypt( const uint8_t* in, uint8_t* out, int32_t n_blo
     return EXIT_SUCCESS;
 }
 
+/* Encrypt independent blocks of 16 bytes (ECB) */
+
+return_type smtc_aes_ecb_encrypt( const uint8_t* in, uint8_t* out, int32_t n_block, const aes_context ctx[1] )
+{
+    while( n_block-- )
+    {
+        if( smtc_aes_encrypt( in, out, ctx ) != EXIT_SUCCESS )
+            return EXIT_FAILURE;
+        in += N_BLOCK;
+        out += N_BLOCK;
+    }
+    return EXIT_SUCCESS;
+}
+
 #endif
 
 #if defined( AES_DEC_PREKEYED )
@@ -69,9 +69,22 @@ typedef uint8_t return_type;
 
 typedef uint8_t length_type;
 
+/*  When SMTC_AES_FAST is defined (CRYPTO=SOFT_FAST) the key schedule is
+    held as 32-bit words for the T-table implementation in aes_fast.c,
+    the size of the context is unchanged.
+    When SMTC_AES_MCU_HW is defined (CRYPTO=MCU_HW) the MCU peripheral
+    expands the key itself and the context only holds the AES-128 key.
+*/
+
 typedef struct
 {
+#if defined( SMTC_AES_FAST )
+    uint32_t ksch[( N_MAX_ROUNDS + 1 ) * N_COL];
+#elif defined( SMTC_AES_MCU_HW )
+    uint8_t ksch[N_BLOCK];
+#else
     uint8_t ksch[( N_MAX_ROUNDS + 1 ) * N_BLOCK];
+#endif
     uint8_t rnd;
 } aes_context;
 
@@ -94,6 +107,11 @@ return_type smtc_aes_encrypt( const uint8_t in[N_BLOCK], uint8_t out[N_BLOCK], c
 
 return_type smtc_aes_cbc_encrypt( const uint8_t* in, uint8_t* out, int32_t n_block, uint8_t iv[N_BLOCK],
                                   const aes_context ctx[1] );
+
+/*  Encrypts n_block independent blocks (ECB), lets a hardware backend
+    process them in a single transfer
+*/
+return_type smtc_aes_ecb_encrypt( const uint8_t* in, uint8_t* out, int32_t n_block, const aes_context ctx[1] );
 #endif
 
 #if defined( AES_DEC_PREKEYED )
@@ -0,0 +1,161 @@
+/**
+ * @file      aes_mcu_hw.c
+ *
+ * @brief     AES implementation offloaded to the MCU crypto peripheral through the modem HAL
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2025. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>  // C99 types
+#include <stdlib.h>  // EXIT_SUCCESS
+#include <string.h>  // memcpy
+
+#include "aes.h"
+#include "smtc_modem_hal.h"
+
+#if !defined( SMTC_AES_MCU_HW )
+#error "aes_mcu_hw.c requires SMTC_AES_MCU_HW to be defined (CRYPTO=MCU_HW)"
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/**
+ * @brief AES-128 is the only key size used by the modem and offered by all MCU peripherals
+ */
+#define AES_MCU_HW_KEY_SIZE 16
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+#if defined( AES_ENC_PREKEYED ) || defined( AES_DEC_PREKEYED )
+
+return_type smtc_aes_set_key( const uint8_t key[], length_type keylen, aes_context ctx[1] )
+{
+    if( keylen != AES_MCU_HW_KEY_SIZE )
+    {
+        ctx->rnd = 0;
+        return ( uint8_t ) -1;
+    }
+
+    // The peripheral runs the key expansion, keep the raw key only
+    memcpy( ctx->ksch, key, AES_MCU_HW_KEY_SIZE );
+    ctx->rnd = 10;
+    return 0;
+}
+
+#endif
+
+#if defined( AES_ENC_PREKEYED )
+
+return_type smtc_aes_encrypt( const uint8_t in[N_BLOCK], uint8_t out[N_BLOCK], const aes_context ctx[1] )
+{
+    return smtc_aes_ecb_encrypt( in, out, 1, ctx );
+}
+
+return_type smtc_aes_ecb_encrypt( const uint8_t* in, uint8_t* out, int32_t n_block, const aes_context ctx[1] )
+{
+    if( ctx->rnd == 0 )
+    {
+        return ( uint8_t ) -1;
+    }
+
+    if( n_block <= 0 )
+    {
+        return EXIT_SUCCESS;
+    }
+
+    // A failing crypto peripheral cannot be recovered by the stack
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        smtc_modem_hal_crypto_aes_ecb_encrypt( ctx->ksch, in, out, ( uint16_t ) n_block ) == true );
+
+    return EXIT_SUCCESS;
+}
+
+return_type smtc_aes_cbc_encrypt( const uint8_t* in, uint8_t* out, int32_t n_block, uint8_t iv[N_BLOCK],
+                                  const aes_context ctx[1] )
+{
+    // Chained blocks: one peripheral call per block
+    while( n_block-- )
+    {
+        for( uint8_t i = 0; i < N_BLOCK; i++ )
+        {
+            iv[i] ^= in[i];
+        }
+        if( smtc_aes_encrypt( iv, iv, ctx ) != EXIT_SUCCESS )
+        {
+            return EXIT_FAILURE;
+        }
+        for( uint8_t i = 0; i < N_BLOCK; i++ )
+        {
+            out[i] = iv[i];
+        }
+        in += N_BLOCK;
+        out += N_BLOCK;
+    }
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined( AES_DEC_PREKEYED ) || defined( AES_ENC_128_OTFK ) || defined( AES_DEC_128_OTFK ) || \
+    defined( AES_ENC_256_OTFK ) || defined( AES_DEC_256_OTFK )
+#error "aes_mcu_hw.c only implements AES_ENC_PREKEYED, use aes.c (CRYPTO=SOFT) for other modes"
+#endif
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -68,7 +68,7 @@ void AES_CMAC_Init( AES_CMAC_CTX* ctx )
 {
     memset( ctx->X, 0, sizeof ctx->X );
     ctx->M_n = 0;
-    memset( ctx->rijndael.ksch, '\0', 240 );
+    memset( ctx->rijndael.ksch, '\0', sizeof ctx->rijndael.ksch );
 }
 
 void AES_CMAC_SetKey( AES_CMAC_CTX* ctx, const uint8_t key[AES_CMAC_KEY_LENGTH] )
@@ -116,47 +116,68 @@ void AES_CMAC_Update( AES_CMAC_CTX* ctx, const uint8_t* data, uint32_t len )
 
 void AES_CMAC_Final( uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX* ctx )
 {
-    uint8_t K[16];
-    uint8_t in[16];
+    uint8_t K1[16];
+    uint8_t K2[16];
+
+    AES_CMAC_GenerateSubkeys( &ctx->rijndael, K1, K2 );
+    AES_CMAC_FinalWithSubkeys( digest, ctx, K1, K2 );
+
+    memset( K1, 0, sizeof K1 );
+    memset( K2, 0, sizeof K2 );
+}
+
+void AES_CMAC_SetKeySchedule( AES_CMAC_CTX* ctx, const aes_context* rijndael )
+{
+    memcpy( &ctx->rijndael, rijndael, sizeof( aes_context ) );
+}
+
+void AES_CMAC_GenerateSubkeys( const aes_context* rijndael, uint8_t k1[AES_CMAC_KEY_LENGTH],
+                               uint8_t k2[AES_CMAC_KEY_LENGTH] )
+{
     /* generate subkey K1 */
-    memset( K, '\0', 16 );
+    memset( k1, '\0', 16 );
 
-    smtc_aes_encrypt( K, K, &ctx->rijndael );
+    smtc_aes_encrypt( k1, k1, rijndael );
 
-    if( K[0] & 0x80 )
+    if( k1[0] & 0x80 )
     {
-        LSHIFT( K, K );
-        K[15] ^= 0x87;
+        LSHIFT( k1, k1 );
+        k1[15] ^= 0x87;
     }
     else
-        LSHIFT( K, K );
+        LSHIFT( k1, k1 );
+
+    /* generate subkey K2 */
+    if( k1[0] & 0x80 )
+    {
+        LSHIFT( k1, k2 );
+        k2[15] ^= 0x87;
+    }
+    else
+        LSHIFT( k1, k2 );
+}
+
+void AES_CMAC_FinalWithSubkeys( uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX* ctx,
+                                const uint8_t k1[AES_CMAC_KEY_LENGTH], const uint8_t k2[AES_CMAC_KEY_LENGTH] )
+{
+    uint8_t in[16];
 
     if( ctx->M_n == 16 )
     {
         /* last block was a complete block */
-        XOR( K, ctx->M_last );
+        XOR( k1, ctx->M_last );
     }
     else
     {
-        /* generate subkey K2 */
-        if( K[0] & 0x80 )
-        {
-            LSHIFT( K, K );
-            K[15] ^= 0x87;
-        }
-        else
-            LSHIFT( K, K );
-
         /* padding(M_last) */
         ctx->M_last[ctx->M_n] = 0x80;
         while( ++ctx->M_n < 16 )
             ctx->M_last[ctx->M_n] = 0;
 
-        XOR( K, ctx->M_last );
+        XOR( k2, ctx->M_last );
     }
     XOR( ctx->M_last, ctx->X );
 
     memcpy( in, &ctx->X[0], 16 );  // Otherwise it does not look good
     smtc_aes_encrypt( in, digest, &ctx->rijndael );
-    memset( K, 0, sizeof K );
 }
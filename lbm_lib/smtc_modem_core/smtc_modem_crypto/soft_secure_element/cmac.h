@@ -61,6 +61,14 @@ void     AES_CMAC_Update(AES_CMAC_CTX * ctx, const uint8_t * data, uint32_t len)
           //          __attribute__((__bounded__(__string__,2,3)));
 void     AES_CMAC_Final(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX  * ctx);
             //     __attribute__((__bounded__(__minbytes__,1,AES_CMAC_DIGEST_LENGTH)));
+
+/* Precomputed key schedule and subkeys variants: the caller keeps the expanded key and the K1/K2 subkeys of a key
+   which does not change often (session keys) and skips their computation on every CMAC */
+void     AES_CMAC_SetKeySchedule(AES_CMAC_CTX * ctx, const aes_context * rijndael);
+void     AES_CMAC_GenerateSubkeys(const aes_context * rijndael, uint8_t k1[AES_CMAC_KEY_LENGTH],
+                                  uint8_t k2[AES_CMAC_KEY_LENGTH]);
+void     AES_CMAC_FinalWithSubkeys(uint8_t digest[AES_CMAC_DIGEST_LENGTH], AES_CMAC_CTX * ctx,
+                                   const uint8_t k1[AES_CMAC_KEY_LENGTH], const uint8_t k2[AES_CMAC_KEY_LENGTH]);
 //__END_DECLS
 
 #ifdef __cplusplus
@@ -46,6 +46,8 @@
 #include "cmac.h"
 
 #include "smtc_modem_hal.h"
+#include "modem_core.h"
+#include "modem_crc.h"
 #include "smtc_modem_hal_dbg_trace.h"
 
 #include <string.h>  //for memset, memcpy
@@ -61,9 +63,13 @@
  */
 
 /*!
- * Number of keys supported in soft secure element
+ * Number of keys supported in soft secure element, multicast groups above #3 add their 3 keys
  */
+#if defined( LR1MAC_MC_NUMBER_OF_SESSION ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
+#define SOFT_SE_NUMBER_OF_KEYS ( 27 + ( 3 * ( LR1MAC_MC_NUMBER_OF_SESSION - 4 ) ) )
+#else
 #define SOFT_SE_NUMBER_OF_KEYS 27
+#endif
 
 /*!
  * JoinAccept frame maximum size
@@ -80,6 +86,54 @@
  */
 #define LORAMAC_MHDR_FIELD_SIZE 1
 
+/*!
+ * Number of expanded AES key schedules (and CMAC subkeys) kept in RAM
+ */
+#ifndef SOFT_SE_AES_CTX_CACHE_SIZE
+#define SOFT_SE_AES_CTX_CACHE_SIZE 4
+#endif
+
+/*!
+ * AES block size in bytes
+ */
+#define SOFT_SE_AES_BLOCK_SIZE 16
+
+/*!
+ * Number of CTR keystream blocks encrypted per AES call (a hardware backend handles them in one transfer)
+ */
+#ifndef SOFT_SE_AES_CTR_CHUNK_BLOCKS
+#define SOFT_SE_AES_CTR_CHUNK_BLOCKS 4
+#endif
+
+/*!
+ * Root key, application session key and network session key of a multicast group above #3 (Dynamically updated)
+ */
+#define SOFT_SE_MC_GROUP_KEY_LIST( n )                                 \
+    { .key_id = SMTC_SE_MC_KEY_##n, .key_value = { 0 } },              \
+        { .key_id = SMTC_SE_MC_APP_S_KEY_##n, .key_value = { 0 } },    \
+        { .key_id = SMTC_SE_MC_NWK_S_KEY_##n, .key_value = { 0 } },
+
+#if defined( LR1MAC_MC_NUMBER_OF_SESSION ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 4 )
+#define SOFT_SE_MC_GROUP_4_KEY_LIST SOFT_SE_MC_GROUP_KEY_LIST( 4 )
+#else
+#define SOFT_SE_MC_GROUP_4_KEY_LIST
+#endif
+#if defined( LR1MAC_MC_NUMBER_OF_SESSION ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 5 )
+#define SOFT_SE_MC_GROUP_5_KEY_LIST SOFT_SE_MC_GROUP_KEY_LIST( 5 )
+#else
+#define SOFT_SE_MC_GROUP_5_KEY_LIST
+#endif
+#if defined( LR1MAC_MC_NUMBER_OF_SESSION ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 6 )
+#define SOFT_SE_MC_GROUP_6_KEY_LIST SOFT_SE_MC_GROUP_KEY_LIST( 6 )
+#else
+#define SOFT_SE_MC_GROUP_6_KEY_LIST
+#endif
+#if defined( LR1MAC_MC_NUMBER_OF_SESSION ) && ( LR1MAC_MC_NUMBER_OF_SESSION > 7 )
+#define SOFT_SE_MC_GROUP_7_KEY_LIST SOFT_SE_MC_GROUP_KEY_LIST( 7 )
+#else
+#define SOFT_SE_MC_GROUP_7_KEY_LIST
+#endif
+
 #define SOFT_SE_KEY_LIST                                                                                             \
     {                                                                                                                \
         {                                                                                                            \
@@ -305,6 +359,8 @@
             .key_value = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
                            0x00 },                                                                                   \
         },                                                                                                           \
+        SOFT_SE_MC_GROUP_4_KEY_LIST SOFT_SE_MC_GROUP_5_KEY_LIST SOFT_SE_MC_GROUP_6_KEY_LIST                          \
+            SOFT_SE_MC_GROUP_7_KEY_LIST                                                                              \
     },
 
 /*
@@ -347,6 +403,35 @@ typedef struct soft_se_context_nvm_s
     uint32_t       crc;
 } soft_se_context_nvm_t;
 
+/**
+ * @brief Cache entry holding an expanded AES key schedule and, once computed, its CMAC subkeys
+ *
+ * @struct soft_se_aes_ctx_cache_t
+ */
+typedef struct soft_se_aes_ctx_cache_s
+{
+    bool                     valid;                            //!< Entry holds an up to date key schedule
+    bool                     cmac_subkeys_valid;               //!< CMAC K1/K2 subkeys have been computed
+    uint8_t                  stack_id;                         //!< Stack identifier of the cached key
+    smtc_se_key_identifier_t key_id;                           //!< Key identifier of the cached key
+    aes_context              aes_ctx;                          //!< Expanded key schedule
+    uint8_t                  cmac_k1[AES_CMAC_KEY_LENGTH];     //!< CMAC subkey K1
+    uint8_t                  cmac_k2[AES_CMAC_KEY_LENGTH];     //!< CMAC subkey K2
+} soft_se_aes_ctx_cache_t;
+
+/**
+ * @brief Context of the streamed CMAC computation
+ *
+ * @struct soft_se_cmac_stream_t
+ */
+typedef struct soft_se_cmac_stream_s
+{
+    bool         started;                       //!< A streamed computation is ongoing
+    AES_CMAC_CTX cmac_ctx;                      //!< CMAC context, holds its own copy of the key schedule
+    uint8_t      cmac_k1[AES_CMAC_KEY_LENGTH];  //!< CMAC subkey K1 of the streamed key
+    uint8_t      cmac_k2[AES_CMAC_KEY_LENGTH];  //!< CMAC subkey K2 of the streamed key
+} soft_se_cmac_stream_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -354,6 +439,11 @@ typedef struct soft_se_context_nvm_s
 
 static soft_se_data_t soft_se_data[NUMBER_OF_STACKS] = { 0 };
 
+static soft_se_aes_ctx_cache_t soft_se_aes_ctx_cache[SOFT_SE_AES_CTX_CACHE_SIZE];
+static uint8_t                 soft_se_aes_ctx_cache_next_victim = 0;
+
+static soft_se_cmac_stream_t soft_se_cmac_stream;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -373,6 +463,38 @@ static soft_se_data_t soft_se_data[NUMBER_OF_STACKS] = { 0 };
 static smtc_se_return_code_t get_key_by_id( smtc_se_key_identifier_t key_id, soft_se_key_t** key_item,
                                             uint8_t stack_id );
 
+/**
+ * @brief Gets the cache entry holding the expanded AES key schedule of a key, expanding it only on cache miss
+ *
+ * @param [in] key_id Key identifier
+ * @param [in] stack_id The Stack Identifier
+ * @param [out] entry Pointer on the cache entry
+ * @return smtc_se_return_code_t
+ */
+static smtc_se_return_code_t get_aes_ctx_cache_entry( smtc_se_key_identifier_t key_id, uint8_t stack_id,
+                                                      soft_se_aes_ctx_cache_t** entry );
+
+/**
+ * @brief Prepares a CMAC context with the cached key schedule and subkeys of a key
+ *
+ * @param [in] key_id Key identifier
+ * @param [in] stack_id The Stack Identifier
+ * @param [out] cmac_ctx CMAC context to initialize
+ * @param [out] k1 CMAC subkey K1
+ * @param [out] k2 CMAC subkey K2
+ * @return smtc_se_return_code_t
+ */
+static smtc_se_return_code_t cmac_start( smtc_se_key_identifier_t key_id, uint8_t stack_id, AES_CMAC_CTX* cmac_ctx,
+                                         const uint8_t** k1, const uint8_t** k2 );
+
+/**
+ * @brief Invalidates the cached key schedule of a key
+ *
+ * @param [in] key_id Key identifier, SMTC_SE_NO_KEY to invalidate all keys of the stack
+ * @param [in] stack_id The Stack Identifier
+ */
+static void invalidate_aes_ctx( smtc_se_key_identifier_t key_id, uint8_t stack_id );
+
 /**
  * @brief Computes a CMAC of a message using provided initial Bx block
  *
@@ -412,6 +534,7 @@ smtc_se_return_code_t smtc_secure_element_init( void )
     for( uint8_t stack_id = 0; stack_id < NUMBER_OF_STACKS; stack_id++ )
     {
         memcpy( ( uint8_t* ) &soft_se_data[stack_id], ( uint8_t* ) &local_data, sizeof( local_data ) );
+        invalidate_aes_ctx( SMTC_SE_NO_KEY, stack_id );
     }
     SMTC_MODEM_HAL_TRACE_INFO( "Use soft secure element for cryptographic functionalities\n" );
 
@@ -430,8 +553,21 @@ smtc_se_return_code_t smtc_secure_element_set_key( smtc_se_key_identifier_t key_
     {
         if( soft_se_data[stack_id].key_list[i].key_id == key_id )
         {
+            if( ( key_id == SMTC_SE_RELAY_WOR_S_INT_KEY ) || ( key_id == SMTC_SE_RELAY_WOR_S_ENC_KEY ) )
+            {
+                // The relay reloads these keys before every WOR operation, keep the expanded schedule while they
+                // do not change
+                if( memcmp( soft_se_data[stack_id].key_list[i].key_value, key, SMTC_SE_KEY_SIZE ) == 0 )
+                {
+                    return SMTC_SE_RC_SUCCESS;
+                }
+            }
+
+            invalidate_aes_ctx( key_id, stack_id );
+
             if( ( key_id == SMTC_SE_MC_KEY_0 ) || ( key_id == SMTC_SE_MC_KEY_1 ) || ( key_id == SMTC_SE_MC_KEY_2 ) ||
-                ( key_id == SMTC_SE_MC_KEY_3 ) )
+                ( key_id == SMTC_SE_MC_KEY_3 ) || ( key_id == SMTC_SE_MC_KEY_4 ) || ( key_id == SMTC_SE_MC_KEY_5 ) ||
+                ( key_id == SMTC_SE_MC_KEY_6 ) || ( key_id == SMTC_SE_MC_KEY_7 ) )
             {  // Decrypt the key if its a Mckey
                 smtc_se_return_code_t rc                = SMTC_SE_RC_ERROR;
                 uint8_t               decrypted_key[16] = { 0 };
@@ -464,6 +600,83 @@ smtc_se_return_code_t smtc_secure_element_compute_aes_cmac( const uint8_t* mic_b
     return compute_cmac( mic_bx_buffer, buffer, size, key_id, cmac, stack_id );
 }
 
+smtc_se_return_code_t smtc_secure_element_cmac_stream_start( const uint8_t* mic_bx_buffer,
+                                                            smtc_se_key_identifier_t key_id, uint8_t stack_id )
+{
+    const uint8_t* k1;
+    const uint8_t* k2;
+
+    soft_se_cmac_stream.started = false;
+
+    if( key_id >= SMTC_SE_SLOT_RAND_ZERO_KEY )
+    {
+        return SMTC_SE_RC_ERROR_INVALID_KEY_ID;
+    }
+
+    // The stream context owns a copy of the key schedule and subkeys, it is not affected by cache replacement
+    smtc_se_return_code_t rc = cmac_start( key_id, stack_id, &soft_se_cmac_stream.cmac_ctx, &k1, &k2 );
+
+    if( rc != SMTC_SE_RC_SUCCESS )
+    {
+        return rc;
+    }
+
+    memcpy( soft_se_cmac_stream.cmac_k1, k1, AES_CMAC_KEY_LENGTH );
+    memcpy( soft_se_cmac_stream.cmac_k2, k2, AES_CMAC_KEY_LENGTH );
+
+    if( mic_bx_buffer != NULL )
+    {
+        AES_CMAC_Update( &soft_se_cmac_stream.cmac_ctx, mic_bx_buffer, 16 );
+    }
+
+    soft_se_cmac_stream.started = true;
+    return SMTC_SE_RC_SUCCESS;
+}
+
+smtc_se_return_code_t smtc_secure_element_cmac_stream_update( const uint8_t* buffer, uint16_t size )
+{
+    if( ( buffer == NULL ) && ( size != 0 ) )
+    {
+        return SMTC_SE_RC_ERROR_NPE;
+    }
+
+    if( soft_se_cmac_stream.started == false )
+    {
+        return SMTC_SE_RC_ERROR;
+    }
+
+    if( size != 0 )
+    {
+        AES_CMAC_Update( &soft_se_cmac_stream.cmac_ctx, buffer, size );
+    }
+    return SMTC_SE_RC_SUCCESS;
+}
+
+smtc_se_return_code_t smtc_secure_element_cmac_stream_final( uint32_t* cmac )
+{
+    if( cmac == NULL )
+    {
+        return SMTC_SE_RC_ERROR_NPE;
+    }
+
+    if( soft_se_cmac_stream.started == false )
+    {
+        return SMTC_SE_RC_ERROR;
+    }
+
+    uint8_t local_cmac[16];
+
+    AES_CMAC_FinalWithSubkeys( local_cmac, &soft_se_cmac_stream.cmac_ctx, soft_se_cmac_stream.cmac_k1,
+                               soft_se_cmac_stream.cmac_k2 );
+    memset( &soft_se_cmac_stream, 0, sizeof( soft_se_cmac_stream_t ) );
+
+    // Bring into the required format
+    *cmac = ( uint32_t ) ( ( uint32_t ) local_cmac[3] << 24 | ( uint32_t ) local_cmac[2] << 16 |
+                           ( uint32_t ) local_cmac[1] << 8 | ( uint32_t ) local_cmac[0] );
+
+    return SMTC_SE_RC_SUCCESS;
+}
+
 smtc_se_return_code_t smtc_secure_element_verify_aes_cmac( uint8_t* buffer, uint16_t size, uint32_t expected_cmac,
                                                            smtc_se_key_identifier_t key_id, uint8_t stack_id )
 {
@@ -505,26 +718,95 @@ smtc_se_return_code_t smtc_secure_element_aes_encrypt( const uint8_t* buffer, ui
         return SMTC_SE_RC_ERROR_BUF_SIZE;
     }
 
-    aes_context aes_ctx;
-    memset( &aes_ctx, 0, sizeof( aes_context ) );
-
-    soft_se_key_t*        key_item;
-    smtc_se_return_code_t rc = get_key_by_id( key_id, &key_item, stack_id );
+    soft_se_aes_ctx_cache_t* entry;
+    smtc_se_return_code_t    rc = get_aes_ctx_cache_entry( key_id, stack_id, &entry );
 
     if( rc == SMTC_SE_RC_SUCCESS )
     {
-        smtc_aes_set_key( key_item->key_value, 16, &aes_ctx );
+        smtc_aes_ecb_encrypt( buffer, enc_buffer, size / SOFT_SE_AES_BLOCK_SIZE, &entry->aes_ctx );
+    }
+    return rc;
+}
+
+smtc_se_return_code_t smtc_secure_element_aes_ctr_encrypt( const uint8_t* buffer, uint16_t size,
+                                                           smtc_se_key_identifier_t key_id,
+                                                           const uint8_t ctr_block[SMTC_SE_KEY_SIZE],
+                                                           uint8_t* enc_buffer, uint8_t stack_id )
+{
+    if( ( buffer == NULL ) || ( enc_buffer == NULL ) || ( ctr_block == NULL ) )
+    {
+        return SMTC_SE_RC_ERROR_NPE;
+    }
+
+    soft_se_aes_ctx_cache_t* entry;
+    smtc_se_return_code_t    rc = get_aes_ctx_cache_entry( key_id, stack_id, &entry );
+
+    if( rc != SMTC_SE_RC_SUCCESS )
+    {
+        return rc;
+    }
+
+    uint8_t  s_blocks[SOFT_SE_AES_CTR_CHUNK_BLOCKS * SOFT_SE_AES_BLOCK_SIZE];
+    uint16_t ctr   = ( ( uint16_t ) ctr_block[14] << 8 ) | ctr_block[15];
+    uint16_t index = 0;
+
+    while( index < size )
+    {
+        uint16_t chunk_size = size - index;
+        uint8_t  nb_blocks  = 0;
 
-        uint8_t block = 0;
+        if( chunk_size > sizeof( s_blocks ) )
+        {
+            chunk_size = sizeof( s_blocks );
+        }
 
-        while( size != 0 )
+        // Build the counter blocks of the chunk and encrypt them in one call
+        for( uint16_t offset = 0; offset < chunk_size; offset += SOFT_SE_AES_BLOCK_SIZE )
         {
-            smtc_aes_encrypt( &buffer[block], &enc_buffer[block], &aes_ctx );
-            block = block + 16;
-            size  = size - 16;
+            uint8_t* a_block = &s_blocks[offset];
+
+            memcpy( a_block, ctr_block, SOFT_SE_AES_BLOCK_SIZE - 2 );
+            a_block[14] = ( uint8_t ) ( ctr >> 8 );
+            a_block[15] = ( uint8_t ) ctr;
+            ctr++;
+            nb_blocks++;
         }
+
+        smtc_aes_ecb_encrypt( s_blocks, s_blocks, nb_blocks, &entry->aes_ctx );
+
+        for( uint16_t i = 0; i < chunk_size; i++ )
+        {
+            enc_buffer[index + i] = buffer[index + i] ^ s_blocks[i];
+        }
+        index += chunk_size;
     }
-    return rc;
+
+    return SMTC_SE_RC_SUCCESS;
+}
+
+smtc_se_return_code_t smtc_secure_element_aes_ctr_encrypt_and_cmac(
+    uint8_t* frame, uint16_t frame_size, uint16_t payload_offset, uint16_t payload_size,
+    smtc_se_key_identifier_t enc_key_id, const uint8_t ctr_block[SMTC_SE_KEY_SIZE], const uint8_t* mic_bx_buffer,
+    smtc_se_key_identifier_t mic_key_id, uint32_t* cmac, uint8_t stack_id )
+{
+    if( ( frame == NULL ) || ( cmac == NULL ) )
+    {
+        return SMTC_SE_RC_ERROR_NPE;
+    }
+
+    if( ( payload_offset + payload_size ) > frame_size )
+    {
+        return SMTC_SE_RC_ERROR_BUF_SIZE;
+    }
+
+    // Both operations already run on the cached AES contexts, nothing to share between them
+    smtc_se_return_code_t rc = smtc_secure_element_aes_ctr_encrypt( &frame[payload_offset], payload_size, enc_key_id,
+                                                                    ctr_block, &frame[payload_offset], stack_id );
+    if( rc != SMTC_SE_RC_SUCCESS )
+    {
+        return rc;
+    }
+    return smtc_secure_element_compute_aes_cmac( mic_bx_buffer, frame, frame_size, mic_key_id, cmac, stack_id );
 }
 
 smtc_se_return_code_t smtc_secure_element_derive_and_store_key( uint8_t* input, smtc_se_key_identifier_t rootkey_id,
@@ -739,7 +1021,7 @@ smtc_se_return_code_t smtc_secure_element_store_context( uint8_t stack_id )
     ctx.crc = soft_ce_crc( ( uint8_t* ) &ctx, sizeof( ctx ) - sizeof( ctx.crc ) );
 
     // Store the current context related to stack_id
-    smtc_modem_hal_context_store( CONTEXT_SECURE_ELEMENT, stack_id * sizeof( ctx ), ( uint8_t* ) &ctx, sizeof( ctx ) );
+    modem_context_store( CONTEXT_SECURE_ELEMENT, stack_id * sizeof( ctx ), ( uint8_t* ) &ctx, sizeof( ctx ) );
     smtc_secure_element_restore_context( stack_id );
     return SMTC_SE_RC_SUCCESS;
 }
@@ -747,8 +1029,7 @@ smtc_se_return_code_t smtc_secure_element_store_context( uint8_t stack_id )
 smtc_se_return_code_t smtc_secure_element_restore_context( uint8_t stack_id )
 {
     soft_se_context_nvm_t ctx = { 0 };
-    smtc_modem_hal_context_restore( CONTEXT_SECURE_ELEMENT, stack_id * sizeof( ctx ), ( uint8_t* ) &ctx,
-                                    sizeof( ctx ) );
+    modem_context_restore( CONTEXT_SECURE_ELEMENT, stack_id * sizeof( ctx ), ( uint8_t* ) &ctx, sizeof( ctx ) );
 
     soft_se_data_t* data_ctx = &soft_se_data[stack_id];
 
@@ -756,6 +1037,7 @@ smtc_se_return_code_t smtc_secure_element_restore_context( uint8_t stack_id )
     {
         // Copy the context in soft_se_data tab
         memcpy( ( uint8_t* ) data_ctx, ( uint8_t* ) &ctx.data, ( sizeof( ctx.data ) ) );
+        invalidate_aes_ctx( SMTC_SE_NO_KEY, stack_id );
         return SMTC_SE_RC_SUCCESS;
     }
     else
@@ -768,6 +1050,7 @@ smtc_se_return_code_t smtc_secure_element_restore_context( uint8_t stack_id )
 
         // init soft secure element data euis and pin to 0 and key_list with empty lut
         memcpy( ( uint8_t* ) data_ctx, ( uint8_t* ) &local_data, sizeof( local_data ) );
+        invalidate_aes_ctx( SMTC_SE_NO_KEY, stack_id );
 
         return SMTC_SE_RC_ERROR;
     }
@@ -791,6 +1074,53 @@ static smtc_se_return_code_t get_key_by_id( smtc_se_key_identifier_t key_id, sof
     return SMTC_SE_RC_ERROR_INVALID_KEY_ID;
 }
 
+static smtc_se_return_code_t get_aes_ctx_cache_entry( smtc_se_key_identifier_t key_id, uint8_t stack_id,
+                                                      soft_se_aes_ctx_cache_t** entry )
+{
+    for( uint8_t i = 0; i < SOFT_SE_AES_CTX_CACHE_SIZE; i++ )
+    {
+        if( ( soft_se_aes_ctx_cache[i].valid == true ) && ( soft_se_aes_ctx_cache[i].key_id == key_id ) &&
+            ( soft_se_aes_ctx_cache[i].stack_id == stack_id ) )
+        {
+            *entry = &soft_se_aes_ctx_cache[i];
+            return SMTC_SE_RC_SUCCESS;
+        }
+    }
+
+    soft_se_key_t*        key_item;
+    smtc_se_return_code_t rc = get_key_by_id( key_id, &key_item, stack_id );
+
+    if( rc != SMTC_SE_RC_SUCCESS )
+    {
+        return rc;
+    }
+
+    // Cache miss: expand the key in the next entry (round robin replacement)
+    soft_se_aes_ctx_cache_t* victim   = &soft_se_aes_ctx_cache[soft_se_aes_ctx_cache_next_victim];
+    soft_se_aes_ctx_cache_next_victim = ( soft_se_aes_ctx_cache_next_victim + 1 ) % SOFT_SE_AES_CTX_CACHE_SIZE;
+
+    memset( victim, 0, sizeof( soft_se_aes_ctx_cache_t ) );
+    smtc_aes_set_key( key_item->key_value, SMTC_SE_KEY_SIZE, &victim->aes_ctx );
+    victim->key_id   = key_id;
+    victim->stack_id = stack_id;
+    victim->valid    = true;
+
+    *entry = victim;
+    return SMTC_SE_RC_SUCCESS;
+}
+
+static void invalidate_aes_ctx( smtc_se_key_identifier_t key_id, uint8_t stack_id )
+{
+    for( uint8_t i = 0; i < SOFT_SE_AES_CTX_CACHE_SIZE; i++ )
+    {
+        if( ( soft_se_aes_ctx_cache[i].stack_id == stack_id ) &&
+            ( ( key_id == SMTC_SE_NO_KEY ) || ( soft_se_aes_ctx_cache[i].key_id == key_id ) ) )
+        {
+            soft_se_aes_ctx_cache[i].valid = false;
+        }
+    }
+}
+
 static smtc_se_return_code_t compute_cmac( const uint8_t* mic_bx_buffer, const uint8_t* buffer, uint16_t size,
                                            smtc_se_key_identifier_t key_id, uint32_t* cmac, uint8_t stack_id )
 {
@@ -799,19 +1129,15 @@ static smtc_se_return_code_t compute_cmac( const uint8_t* mic_bx_buffer, const u
         return SMTC_SE_RC_ERROR_NPE;
     }
 
-    uint8_t      local_cmac[16];
-    AES_CMAC_CTX aes_cmac_ctx[1];
+    uint8_t        local_cmac[16];
+    AES_CMAC_CTX   aes_cmac_ctx[1];
+    const uint8_t* k1;
+    const uint8_t* k2;
 
-    AES_CMAC_Init( aes_cmac_ctx );
-
-    soft_se_key_t* key_item;
-
-    smtc_se_return_code_t rc = get_key_by_id( key_id, &key_item, stack_id );
+    smtc_se_return_code_t rc = cmac_start( key_id, stack_id, aes_cmac_ctx, &k1, &k2 );
 
     if( rc == SMTC_SE_RC_SUCCESS )
     {
-        AES_CMAC_SetKey( aes_cmac_ctx, key_item->key_value );
-
         if( mic_bx_buffer != NULL )
         {
             AES_CMAC_Update( aes_cmac_ctx, mic_bx_buffer, 16 );
@@ -819,7 +1145,7 @@ static smtc_se_return_code_t compute_cmac( const uint8_t* mic_bx_buffer, const u
 
         AES_CMAC_Update( aes_cmac_ctx, buffer, size );
 
-        AES_CMAC_Final( local_cmac, aes_cmac_ctx );
+        AES_CMAC_FinalWithSubkeys( local_cmac, aes_cmac_ctx, k1, k2 );
 
         // Bring into the required format
         *cmac = ( uint32_t ) ( ( uint32_t ) local_cmac[3] << 24 | ( uint32_t ) local_cmac[2] << 16 |
@@ -829,19 +1155,35 @@ static smtc_se_return_code_t compute_cmac( const uint8_t* mic_bx_buffer, const u
     return rc;
 }
 
-uint32_t soft_ce_crc( const uint8_t* buf, int len )
+static smtc_se_return_code_t cmac_start( smtc_se_key_identifier_t key_id, uint8_t stack_id, AES_CMAC_CTX* cmac_ctx,
+                                         const uint8_t** k1, const uint8_t** k2 )
 {
-    uint32_t crc = 0xFFFFFFFF;
-    while( len-- > 0 )
+    soft_se_aes_ctx_cache_t* entry;
+    smtc_se_return_code_t    rc = get_aes_ctx_cache_entry( key_id, stack_id, &entry );
+
+    if( rc != SMTC_SE_RC_SUCCESS )
     {
-        crc = crc ^ *buf++;
-        for( int i = 0; i < 8; i++ )
-        {
-            uint32_t mask = -( crc & 1 );
-            crc           = ( crc >> 1 ) ^ ( 0xEDB88320 & mask );
-        }
+        return rc;
+    }
+
+    // Subkeys only depend on the key: derive them once per cached key schedule
+    if( entry->cmac_subkeys_valid == false )
+    {
+        AES_CMAC_GenerateSubkeys( &entry->aes_ctx, entry->cmac_k1, entry->cmac_k2 );
+        entry->cmac_subkeys_valid = true;
     }
-    return ~crc;
+
+    AES_CMAC_Init( cmac_ctx );
+    AES_CMAC_SetKeySchedule( cmac_ctx, &entry->aes_ctx );
+    *k1 = entry->cmac_k1;
+    *k2 = entry->cmac_k2;
+
+    return SMTC_SE_RC_SUCCESS;
+}
+
+uint32_t soft_ce_crc( const uint8_t* buf, int len )
+{
+    return modem_crc32( buf, ( len > 0 ) ? ( uint32_t ) len : 0 );
 }
 
 /* --- EOF ------------------------------------------------------------------ */
@@ -69,6 +69,8 @@
 #include "lr11xx_hal.h"
 #elif defined( SX127X )
 #include "sx127x_hal.h"
+#elif defined( VIRTUAL_RADIO )
+// No direct access to the simulated radio
 #else
 #error "Please select radio board.."
 #endif
@@ -79,6 +81,22 @@
  */
 
 #define TEST_STACK_ID_0 0
+
+/**
+ * @brief Spectral survey RSSI range, one histogram bin per dB
+ */
+#define TEST_SURVEY_RSSI_MIN_DBM -128
+#define TEST_SURVEY_RSSI_MAX_DBM 0
+#define TEST_SURVEY_HISTOGRAM_SIZE ( TEST_SURVEY_RSSI_MAX_DBM - TEST_SURVEY_RSSI_MIN_DBM + 1 )
+
+/**
+ * @brief Packet error rate test timeline: gap after each packet, for the receiver to listen again, and after each
+ * configuration, half of it being used by the receiver to absorb the drift between both devices
+ */
+#define TEST_PER_PACKET_GAP_MS 30
+#define TEST_PER_CONFIG_GAP_MS 200
+#define TEST_PER_RX_MARGIN_MS ( TEST_PER_CONFIG_GAP_MS / 2 )
+#define TEST_PER_START_DELAY_MS 100
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -98,6 +116,58 @@ static const uint8_t sync_word_lr_fhss[] = { 0x2C, 0x0F, 0x79, 0x95 };
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
+/*!
+ * \typedef modem_test_survey_t
+ * \brief   Spectral survey state, the channels are measured one radio planner task each
+ */
+typedef struct modem_test_survey_s
+{
+    uint32_t                        frequencies_hz[SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS];  //!< Channels to measure
+    smtc_modem_test_survey_result_t results[SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS];         //!< Channel statistics
+    uint16_t                        histogram[TEST_SURVEY_HISTOGRAM_SIZE];  //!< RSSI of the channel being measured
+    uint32_t                        bw_hz;                                  //!< Measurement bandwidth
+    uint16_t                        dwell_ms;                               //!< Listening time per channel
+    uint8_t                         nb_channels;                            //!< Number of channels to measure
+    uint8_t                         channel_index;                          //!< Channel being measured
+    uint8_t                         percentile;                             //!< Percentile to report
+    bool                            ready;                                  //!< Survey finished or interrupted
+} modem_test_survey_t;
+
+/*!
+ * \typedef modem_test_per_stats_t
+ * \brief   Packet error rate test accumulators of a configuration
+ */
+typedef struct modem_test_per_stats_s
+{
+    uint16_t nb_received;
+    int16_t  rssi_min_dbm;
+    int16_t  rssi_max_dbm;
+    int32_t  rssi_sum;
+    int16_t  snr_min_db;
+    int16_t  snr_max_db;
+    int32_t  snr_sum;
+} modem_test_per_stats_t;
+
+/*!
+ * \typedef modem_test_per_t
+ * \brief   Packet error rate test state, one radio planner task per packet
+ */
+typedef struct modem_test_per_s
+{
+    smtc_modem_test_per_config_t configs[SMTC_MODEM_TEST_PER_MAX_CONFIGS];  //!< Sequence of configurations
+    modem_test_per_stats_t       stats[SMTC_MODEM_TEST_PER_MAX_CONFIGS];    //!< Receiver statistics
+    uint32_t                     frequency_hz;                              //!< Test frequency
+    uint32_t                     config_start_ms;  //!< Start of the current configuration on the transmitter timeline
+    uint16_t                     nb_packets;       //!< Packets per configuration
+    uint16_t                     packet_index;     //!< Transmitter next packet
+    uint8_t                      nb_configs;       //!< Number of configurations
+    uint8_t                      config_index;     //!< Current configuration
+    uint8_t                      payload_length;   //!< Packet length
+    bool                         is_transmitter;   //!< Transmitting or receiving device
+    bool                         is_synchronized;  //!< Receiver aligned on the transmitter timeline
+    bool                         ready;            //!< Test finished or interrupted
+} modem_test_per_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
@@ -107,6 +177,9 @@ modem_test_context_t modem_test_context;
 
 static rp_task_t         rp_task;
 static rp_radio_params_t rp_radio_params;
+
+static modem_test_survey_t modem_test_survey;
+static modem_test_per_t    modem_test_per;
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -139,6 +212,68 @@ void modem_test_rx_callback( modem_test_context_t* context );
  */
 void test_mode_cw_callback_for_rp( void* rp_void );
 
+/*!
+ * \brief   Enqueue the radio planner task measuring the current channel of the spectral survey
+ * \retval  True if the task is enqueued
+ */
+static bool modem_test_survey_enqueue_channel( void );
+
+/*!
+ * \brief   Callback for the spectral survey, moves to the next channel
+ * \retval [out]    context*                  - modem_test_context_t
+ */
+void modem_test_survey_callback( modem_test_context_t* context );
+
+/*!
+ * \brief   Callback sampling the RSSI of a spectral survey channel by Radio Planner
+ * \retval [in]    rp_void*                   - radio planner context
+ */
+void modem_test_survey_launch_callback_for_rp( void* rp_void );
+
+/*!
+ * \brief   Radio parameters of a packet error rate test configuration
+ * \param [in]     config_index              - Configuration index
+ * \param [out]    lora_param*               - LoRa parameters
+ */
+static void modem_test_per_get_lora_params( uint8_t config_index, ralf_params_lora_t* lora_param );
+
+/*!
+ * \brief   Time given to each packet of a packet error rate test configuration, time on air included
+ * \param [in]     config_index              - Configuration index
+ * \retval  Period in ms
+ */
+static uint32_t modem_test_per_get_period_ms( uint8_t config_index );
+
+/*!
+ * \brief   Enqueue the next packet of the transmitter at its place on the timeline
+ * \retval  True if the task is enqueued
+ */
+static bool modem_test_per_enqueue_tx( void );
+
+/*!
+ * \brief   Listen until the end of the current configuration, moving to the next ones if already over
+ * \retval  True if a reception is enqueued or the test is finished
+ */
+static bool modem_test_per_listen( void );
+
+/*!
+ * \brief   Account a packet received during the packet error rate test and realign on the transmitter timeline
+ * \retval [in]    context*                  - modem_test_context_t
+ */
+static void modem_test_per_receive( modem_test_context_t* context );
+
+/*!
+ * \brief   End the packet error rate test and raise the test mode event
+ * \param [in]     status                    - Test mode event status
+ */
+static void modem_test_per_end( smtc_modem_event_test_mode_status_t status );
+
+/*!
+ * \brief   Callback for the packet error rate test, moves to the next packet
+ * \retval [out]    context*                  - modem_test_context_t
+ */
+void modem_test_per_callback( modem_test_context_t* context );
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -478,6 +613,9 @@ smtc_modem_return_code_t smtc_modem_test_tx_cw( uint32_t frequency_hz, int8_t tx
     rp_task.duration_time_ms      = 2000;
     rp_task.type                  = RP_TASK_TYPE_TX_LORA;
     rp_task.launch_task_callbacks = test_mode_cw_callback_for_rp;
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = false;
+#endif
 
     // First disable failsafe check for radio planner as the task can be longer than failsafe value
     rp_disable_failsafe( modem_test_context.rp, true );
@@ -549,6 +687,9 @@ smtc_modem_return_code_t smtc_modem_test_rx_lora( uint32_t frequency_hz, ral_lor
     rp_task.launch_task_callbacks = lr1_stack_mac_rx_lora_launch_callback_for_rp;
     rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( ) + 20;
     rp_task.duration_time_ms      = 20;  // will be extended by the radio planner
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = true;
+#endif
     rp_disable_failsafe( modem_test_context.rp, true );
     rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
     rp_hook_init( modem_test_context.rp, modem_test_context.hook_id, ( void ( * )( void* ) )( modem_test_rx_callback ),
@@ -611,6 +752,9 @@ smtc_modem_return_code_t smtc_modem_test_rx_fsk_continuous( uint32_t frequency_h
     rp_task.launch_task_callbacks = lr1_stack_mac_rx_gfsk_launch_callback_for_rp;
     rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( ) + 20;
     rp_task.duration_time_ms      = 20;  // toa;
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = true;
+#endif
     rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
     rp_disable_failsafe( modem_test_context.rp, true );
     rp_hook_init( modem_test_context.rp, modem_test_context.hook_id, ( void ( * )( void* ) )( modem_test_rx_callback ),
@@ -698,6 +842,179 @@ smtc_modem_return_code_t smtc_modem_test_get_rssi( int8_t* rssi )
     return return_code;
 }
 
+smtc_modem_return_code_t smtc_modem_test_survey_start( const uint32_t* frequencies_hz, uint8_t nb_channels,
+                                                       uint16_t dwell_ms, uint32_t bw_hz, uint8_t percentile )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( frequencies_hz == NULL ) || ( nb_channels == 0 ) || ( nb_channels > SMTC_MODEM_TEST_SURVEY_MAX_CHANNELS ) ||
+        ( dwell_ms == 0 ) || ( dwell_ms > SMTC_MODEM_TEST_SURVEY_MAX_DWELL_MS ) || ( percentile == 0 ) ||
+        ( percentile > 99 ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid survey parameters\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( bw_hz < 125000 ) || ( bw_hz > 467000 ) )  // 467000 Maximum supported GFSK BW
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid bw %d\n", bw_hz );
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    memcpy( modem_test_survey.frequencies_hz, frequencies_hz, nb_channels * sizeof( uint32_t ) );
+    memset( modem_test_survey.results, 0, sizeof( modem_test_survey.results ) );
+    modem_test_survey.bw_hz         = bw_hz;
+    modem_test_survey.dwell_ms      = dwell_ms;
+    modem_test_survey.nb_channels   = nb_channels;
+    modem_test_survey.channel_index = 0;
+    modem_test_survey.percentile    = percentile;
+    modem_test_survey.ready         = false;
+
+    rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
+    rp_disable_failsafe( modem_test_context.rp, true );
+    rp_hook_init( modem_test_context.rp, modem_test_context.hook_id,
+                  ( void ( * )( void* ) )( modem_test_survey_callback ), &modem_test_context );
+
+    if( modem_test_survey_enqueue_channel( ) == false )
+    {
+        modem_test_survey.ready = true;
+        return SMTC_MODEM_RC_FAIL;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_test_survey_get_results( uint8_t                          first_channel,
+                                                             smtc_modem_test_survey_result_t* results,
+                                                             uint8_t max_results, uint8_t* nb_results )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( modem_test_survey.ready == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "SURVEY TEST RESULT NOT READY\n" );
+        return SMTC_MODEM_RC_BUSY;
+    }
+    if( first_channel >= modem_test_survey.nb_channels )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    *nb_results = modem_test_survey.nb_channels - first_channel;
+    if( *nb_results > max_results )
+    {
+        *nb_results = max_results;
+    }
+    memcpy( results, &modem_test_survey.results[first_channel],
+            *nb_results * sizeof( smtc_modem_test_survey_result_t ) );
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_test_per_start( bool is_transmitter, uint32_t frequency_hz,
+                                                    const smtc_modem_test_per_config_t* configs, uint8_t nb_configs,
+                                                    uint16_t nb_packets, uint8_t payload_length )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( ( configs == NULL ) || ( nb_configs == 0 ) || ( nb_configs > SMTC_MODEM_TEST_PER_MAX_CONFIGS ) ||
+        ( nb_packets == 0 ) || ( payload_length < SMTC_MODEM_TEST_PER_HEADER_SIZE ) )
+    {
+        SMTC_MODEM_HAL_TRACE_ERROR( "Invalid per test parameters\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    for( uint8_t i = 0; i < nb_configs; i++ )
+    {
+        if( ( configs[i].sf < RAL_LORA_SF5 ) || ( configs[i].sf > RAL_LORA_SF12 ) ||
+            ( configs[i].bw > RAL_LORA_BW_1600_KHZ ) )
+        {
+            SMTC_MODEM_HAL_TRACE_ERROR( "Invalid per test config %d\n", i );
+            return SMTC_MODEM_RC_INVALID;
+        }
+    }
+
+    memcpy( modem_test_per.configs, configs, nb_configs * sizeof( smtc_modem_test_per_config_t ) );
+    memset( modem_test_per.stats, 0, sizeof( modem_test_per.stats ) );
+    modem_test_per.frequency_hz    = frequency_hz;
+    modem_test_per.config_start_ms = smtc_modem_hal_get_time_in_ms( ) + TEST_PER_START_DELAY_MS;
+    modem_test_per.nb_packets      = nb_packets;
+    modem_test_per.packet_index    = 0;
+    modem_test_per.nb_configs      = nb_configs;
+    modem_test_per.config_index    = 0;
+    modem_test_per.payload_length  = payload_length;
+    modem_test_per.is_transmitter  = is_transmitter;
+    modem_test_per.is_synchronized = false;
+    modem_test_per.ready           = false;
+
+    rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
+    rp_disable_failsafe( modem_test_context.rp, true );
+    rp_hook_init( modem_test_context.rp, modem_test_context.hook_id, ( void ( * )( void* ) )( modem_test_per_callback ),
+                  &modem_test_context );
+
+    bool is_enqueued = ( is_transmitter == true ) ? modem_test_per_enqueue_tx( ) : modem_test_per_listen( );
+    if( is_enqueued == false )
+    {
+        modem_test_per.ready = true;
+        return SMTC_MODEM_RC_FAIL;
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
+smtc_modem_return_code_t smtc_modem_test_per_get_results( uint8_t first_config, smtc_modem_test_per_result_t* results,
+                                                          uint8_t max_results, uint8_t* nb_results )
+{
+    if( modem_get_test_mode_status( ) == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
+        return SMTC_MODEM_RC_INVALID;
+    }
+    if( modem_test_per.ready == false )
+    {
+        SMTC_MODEM_HAL_TRACE_WARNING( "PER TEST RESULT NOT READY\n" );
+        return SMTC_MODEM_RC_BUSY;
+    }
+    if( ( modem_test_per.is_transmitter == true ) || ( first_config >= modem_test_per.nb_configs ) )
+    {
+        return SMTC_MODEM_RC_INVALID;
+    }
+
+    *nb_results = modem_test_per.nb_configs - first_config;
+    if( *nb_results > max_results )
+    {
+        *nb_results = max_results;
+    }
+    for( uint8_t i = 0; i < *nb_results; i++ )
+    {
+        const modem_test_per_stats_t* stats  = &modem_test_per.stats[first_config + i];
+        smtc_modem_test_per_result_t* result = &results[i];
+
+        memset( result, 0, sizeof( smtc_modem_test_per_result_t ) );
+        result->nb_received = stats->nb_received;
+        if( stats->nb_received > 0 )
+        {
+            result->rssi_min_dbm = stats->rssi_min_dbm;
+            result->rssi_avg_dbm = ( int16_t ) ( stats->rssi_sum / stats->nb_received );
+            result->rssi_max_dbm = stats->rssi_max_dbm;
+            result->snr_min_db   = ( int8_t ) stats->snr_min_db;
+            result->snr_avg_db   = ( int8_t ) ( stats->snr_sum / stats->nb_received );
+            result->snr_max_db   = ( int8_t ) stats->snr_max_db;
+
+            // Payload bits over the time given to the configuration, the configuration gap aside
+            uint64_t received_bits = ( uint64_t ) stats->nb_received * modem_test_per.payload_length * 8;
+            uint64_t duration_ms =
+                ( uint64_t ) modem_test_per.nb_packets * modem_test_per_get_period_ms( first_config + i );
+            result->goodput_bps = ( uint32_t ) ( received_bits * 1000 / duration_ms );
+        }
+    }
+    return SMTC_MODEM_RC_OK;
+}
+
 void modem_test_set_rssi( int16_t rssi )
 {
     modem_test_context.rssi = rssi;
@@ -736,6 +1053,10 @@ smtc_modem_return_code_t smtc_modem_test_direct_radio_write( uint8_t* command, u
         SMTC_MODEM_HAL_TRACE_WARNING( "TEST FUNCTION CANNOT BE CALLED: NOT IN TEST MODE\n" );
         return SMTC_MODEM_RC_INVALID;
     }
+#if defined( ADD_RAL_CFG_SHADOW )
+    // The written command bypasses the RAL configuration shadow
+    ral_invalidate_cfg_shadow( &( modem_test_context.rp->radio->ral ) );
+#endif
 #if defined( SX128X )
     if( sx128x_hal_read( modem_test_context.rp->radio->ral.context, command, command_length, data, data_length ) !=
         SX128X_HAL_STATUS_OK )
@@ -956,16 +1277,28 @@ void modem_test_rx_callback( modem_test_context_t* context )
                 context->rp->radio_params[context->hook_id].rx.gfsk_pkt_status.rssi_avg_in_dbm;
         }
 
-        if( rp_task_enqueue( context->rp, &rp_task, context->tx_rx_payload, payload_length, &radio_params ) !=
-            RP_HOOK_STATUS_OK )
+#if defined( ADD_RP_RX_CONTINUOUS )
+        // A continuous reception is still on going
+        if( rp_task.rx_continuous == false )
+#endif
         {
-            SMTC_MODEM_HAL_PANIC( );
+            if( rp_task_enqueue( context->rp, &rp_task, context->tx_rx_payload, payload_length, &radio_params ) !=
+                RP_HOOK_STATUS_OK )
+            {
+                SMTC_MODEM_HAL_PANIC( );
+            }
         }
 
         context->total_rx_packets++;
         context->last_rx_payload_length = context->rp->rx_payload_size[context->hook_id];
         increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TEST_MODE, SMTC_MODEM_EVENT_TEST_MODE_RX_DONE, 0xFF );
     }
+#if defined( ADD_RP_RX_CONTINUOUS )
+    else if( ( rp_status == RP_STATUS_RX_CRC_ERROR ) && ( rp_task.rx_continuous == true ) )
+    {
+        // The radio is still receiving
+    }
+#endif
     else
     {  // RP_STATUS_RX_TIMEOUT or RP_STATUS_RX_ABORTED
 
@@ -983,10 +1316,365 @@ void test_mode_cw_callback_for_rp( void* rp_void )
     SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_tx_cw( &( rp->radio->ral ) ) == RAL_STATUS_OK );
 }
 
+void modem_test_survey_callback( modem_test_context_t* context )
+{
+    smtc_modem_hal_reload_wdog( );
+
+    if( context->rp->status[context->hook_id] != RP_STATUS_LBT_FREE_CHANNEL )
+    {
+        // Aborted by a nop: the results of the channels already measured stay available
+        modem_test_survey.ready = true;
+        increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TEST_MODE, SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED, 0xFF );
+        return;
+    }
+
+    modem_test_survey.channel_index++;
+    if( modem_test_survey.channel_index >= modem_test_survey.nb_channels )
+    {
+        modem_test_survey.ready = true;
+        increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TEST_MODE, SMTC_MODEM_EVENT_TEST_MODE_SURVEY_DONE, 0xFF );
+        SMTC_MODEM_HAL_TRACE_PRINTF( "Survey of %d channels done\n", modem_test_survey.nb_channels );
+        return;
+    }
+
+    if( modem_test_survey_enqueue_channel( ) == false )
+    {
+        modem_test_survey.ready = true;
+        increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TEST_MODE, SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED, 0xFF );
+    }
+}
+
+void modem_test_survey_launch_callback_for_rp( void* rp_void )
+{
+    radio_planner_t*                 rp         = ( radio_planner_t* ) rp_void;
+    uint8_t                          id         = rp->radio_task_id;
+    smtc_modem_test_survey_result_t* result     = &modem_test_survey.results[modem_test_survey.channel_index];
+    int32_t                          rssi_sum   = 0;
+    int16_t                          rssi_min   = TEST_SURVEY_RSSI_MAX_DBM;
+    int16_t                          rssi_max   = TEST_SURVEY_RSSI_MIN_DBM;
+    uint16_t                         nb_samples = 0;
+    int16_t                          rssi_tmp;
+
+    memset( modem_test_survey.histogram, 0, sizeof( modem_test_survey.histogram ) );
+
+    smtc_modem_hal_start_radio_tcxo( );
+    smtc_modem_hal_set_ant_switch( false );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_pkt_type( &( rp->radio->ral ), rp->radio_params[id].pkt_type ) ==
+                                     RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        ral_set_rf_freq( &( rp->radio->ral ), rp->radio_params[id].rx.gfsk.rf_freq_in_hz ) == RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE(
+        ral_set_gfsk_mod_params( &( rp->radio->ral ), &rp->radio_params[id].rx.gfsk.mod_params ) == RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_dio_irq_params( &( rp->radio->ral ), RAL_IRQ_NONE ) == RAL_STATUS_OK );
+    SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_set_rx( &( rp->radio->ral ), RAL_RX_TIMEOUT_CONTINUOUS_MODE ) ==
+                                     RAL_STATUS_OK );
+
+    uint32_t start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    while( ( int32_t ) ( start_time_ms + LAP_OF_TIME_TO_GET_A_RSSI_VALID - smtc_modem_hal_get_time_in_ms( ) ) > 0 )
+    {  // delay LAP_OF_TIME_TO_GET_A_RSSI_VALID ms
+    }
+    start_time_ms = smtc_modem_hal_get_time_in_ms( );
+    rp_stats_set_rx_timestamp( &rp->stats, start_time_ms );
+
+    // Sample back to back, the statistics are computed after the dwell time to keep the sampling rate
+    do
+    {
+        SMTC_MODEM_HAL_PANIC_ON_FAILURE( ral_get_rssi_inst( &( rp->radio->ral ), &rssi_tmp ) == RAL_STATUS_OK );
+        if( rssi_tmp < TEST_SURVEY_RSSI_MIN_DBM )
+        {
+            rssi_tmp = TEST_SURVEY_RSSI_MIN_DBM;
+        }
+        else if( rssi_tmp > TEST_SURVEY_RSSI_MAX_DBM )
+        {
+            rssi_tmp = TEST_SURVEY_RSSI_MAX_DBM;
+        }
+        modem_test_survey.histogram[rssi_tmp - TEST_SURVEY_RSSI_MIN_DBM]++;
+        nb_samples++;
+    } while( ( nb_samples < UINT16_MAX ) && ( ( int32_t ) ( start_time_ms + rp->radio_params[id].rx.timeout_in_ms -
+                                                             smtc_modem_hal_get_time_in_ms( ) ) > 0 ) );
+
+    uint32_t percentile_rank = ( ( uint32_t ) nb_samples * modem_test_survey.percentile + 99 ) / 100;
+    uint32_t nb_below        = 0;
+    result->nb_samples       = nb_samples;
+    for( uint16_t i = 0; i < TEST_SURVEY_HISTOGRAM_SIZE; i++ )
+    {
+        uint16_t count = modem_test_survey.histogram[i];
+        if( count == 0 )
+        {
+            continue;
+        }
+        int16_t rssi = ( int16_t ) i + TEST_SURVEY_RSSI_MIN_DBM;
+        if( rssi < rssi_min )
+        {
+            rssi_min = rssi;
+        }
+        rssi_max = rssi;
+        rssi_sum += ( int32_t ) rssi * count;
+        if( ( nb_below < percentile_rank ) && ( nb_below + count >= percentile_rank ) )
+        {
+            result->rssi_percentile_dbm = ( int8_t ) rssi;
+        }
+        nb_below += count;
+    }
+    result->rssi_min_dbm = ( int8_t ) rssi_min;
+    result->rssi_max_dbm = ( int8_t ) rssi_max;
+    result->rssi_avg_dbm = ( int8_t ) ( rssi_sum / ( int32_t ) nb_samples );
+
+    rp->status[id] = RP_STATUS_LBT_FREE_CHANNEL;
+    rp_radio_irq_callback( rp_void );
+    rp_callback( rp_void );
+}
+
+static bool modem_test_survey_enqueue_channel( void )
+{
+    rp_radio_params_t radio_params = { 0 };
+
+    radio_params.pkt_type                        = RAL_PKT_TYPE_GFSK;
+    radio_params.rx.gfsk.rf_freq_in_hz           = modem_test_survey.frequencies_hz[modem_test_survey.channel_index];
+    radio_params.rx.gfsk.pkt_params.dc_free      = RAL_GFSK_DC_FREE_WHITENING;
+    radio_params.rx.gfsk.mod_params.br_in_bps    = modem_test_survey.bw_hz >> 1;
+    radio_params.rx.gfsk.mod_params.fdev_in_hz   = modem_test_survey.bw_hz >> 2;
+    radio_params.rx.gfsk.mod_params.bw_dsb_in_hz = modem_test_survey.bw_hz;
+    radio_params.rx.gfsk.mod_params.pulse_shape  = RAL_GFSK_PULSE_SHAPE_BT_1;
+    radio_params.rx.timeout_in_ms                = modem_test_survey.dwell_ms;
+
+    // An rssi sampling task, as the lbt one: no radio irq is expected
+    rp_task.hook_id               = modem_test_context.hook_id;
+    rp_task.type                  = RP_TASK_TYPE_LBT;
+    rp_task.state                 = RP_TASK_STATE_ASAP;
+    rp_task.launch_task_callbacks = modem_test_survey_launch_callback_for_rp;
+    rp_task.start_time_ms         = smtc_modem_hal_get_time_in_ms( );
+    rp_task.duration_time_ms      = modem_test_survey.dwell_ms + LAP_OF_TIME_TO_GET_A_RSSI_VALID;
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = false;
+#endif
+
+    return rp_task_enqueue( modem_test_context.rp, &rp_task, NULL, 0, &radio_params ) == RP_HOOK_STATUS_OK;
+}
+
+void modem_test_per_callback( modem_test_context_t* context )
+{
+    smtc_modem_hal_reload_wdog( );
+    rp_status_t rp_status = context->rp->status[context->hook_id];
+
+    if( modem_test_per.is_transmitter == true )
+    {
+        if( rp_status != RP_STATUS_TX_DONE )
+        {
+            modem_test_per_end( SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED );
+            return;
+        }
+        modem_test_per.packet_index++;
+        if( modem_test_per.packet_index >= modem_test_per.nb_packets )
+        {
+            modem_test_per.config_start_ms +=
+                modem_test_per.nb_packets * modem_test_per_get_period_ms( modem_test_per.config_index ) +
+                TEST_PER_CONFIG_GAP_MS;
+            modem_test_per.packet_index = 0;
+            modem_test_per.config_index++;
+            if( modem_test_per.config_index >= modem_test_per.nb_configs )
+            {
+                modem_test_per_end( SMTC_MODEM_EVENT_TEST_MODE_PER_DONE );
+                return;
+            }
+        }
+        if( modem_test_per_enqueue_tx( ) == false )
+        {
+            modem_test_per_end( SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED );
+        }
+        return;
+    }
+
+    if( rp_status == RP_STATUS_RX_PACKET )
+    {
+        modem_test_per_receive( context );
+    }
+    else if( ( rp_status != RP_STATUS_RX_TIMEOUT ) && ( rp_status != RP_STATUS_RX_CRC_ERROR ) )
+    {
+        modem_test_per_end( SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED );
+        return;
+    }
+    if( modem_test_per_listen( ) == false )
+    {
+        modem_test_per_end( SMTC_MODEM_EVENT_TEST_MODE_RX_ABORTED );
+    }
+}
+
+static void modem_test_per_get_lora_params( uint8_t config_index, ralf_params_lora_t* lora_param )
+{
+    const smtc_modem_test_per_config_t* config = &modem_test_per.configs[config_index];
+
+    memset( lora_param, 0, sizeof( ralf_params_lora_t ) );
+    lora_param->rf_freq_in_hz                   = modem_test_per.frequency_hz;
+    lora_param->output_pwr_in_dbm               = config->tx_power_dbm;
+    lora_param->sync_word                       = SYNC_WORD_0x12;
+    lora_param->pkt_params.preamble_len_in_symb = 8;
+    lora_param->pkt_params.header_type          = RAL_LORA_PKT_EXPLICIT;
+    lora_param->pkt_params.pld_len_in_bytes     = modem_test_per.payload_length;
+    lora_param->pkt_params.crc_is_on            = true;
+    lora_param->pkt_params.invert_iq_is_on      = false;
+    lora_param->mod_params.sf                   = config->sf;
+    lora_param->mod_params.bw                   = config->bw;
+    lora_param->mod_params.cr                   = RAL_LORA_CR_4_5;
+    lora_param->mod_params.ldro = ral_compute_lora_ldro( lora_param->mod_params.sf, lora_param->mod_params.bw );
+}
+
+static uint32_t modem_test_per_get_period_ms( uint8_t config_index )
+{
+    ralf_params_lora_t lora_param;
+
+    modem_test_per_get_lora_params( config_index, &lora_param );
+    return ral_get_lora_time_on_air_in_ms( &( modem_test_context.rp->radio->ral ), &( lora_param.pkt_params ),
+                                           &( lora_param.mod_params ) ) +
+           TEST_PER_PACKET_GAP_MS;
+}
+
+static bool modem_test_per_enqueue_tx( void )
+{
+    rp_radio_params_t radio_params = { 0 };
+    uint8_t*          payload      = modem_test_context.tx_rx_payload;
+    uint32_t          period_ms    = modem_test_per_get_period_ms( modem_test_per.config_index );
+
+    payload[0] = 'P';
+    payload[1] = 'E';
+    payload[2] = modem_test_per.config_index;
+    payload[3] = ( uint8_t ) ( modem_test_per.packet_index >> 8 );
+    payload[4] = ( uint8_t ) modem_test_per.packet_index;
+    for( uint8_t i = SMTC_MODEM_TEST_PER_HEADER_SIZE; i < modem_test_per.payload_length; i++ )
+    {
+        payload[i] = smtc_modem_hal_get_random_nb_in_range( 0, 0xFF );
+    }
+
+    radio_params.pkt_type = RAL_PKT_TYPE_LORA;
+    modem_test_per_get_lora_params( modem_test_per.config_index, &radio_params.tx.lora );
+
+    // The packets are scheduled on the timeline the receiver follows, not as soon as possible
+    rp_task.hook_id               = modem_test_context.hook_id;
+    rp_task.type                  = RP_TASK_TYPE_TX_LORA;
+    rp_task.state                 = RP_TASK_STATE_SCHEDULE;
+    rp_task.launch_task_callbacks = lr1_stack_mac_tx_lora_launch_callback_for_rp;
+    rp_task.start_time_ms         = modem_test_per.config_start_ms + modem_test_per.packet_index * period_ms;
+    rp_task.duration_time_ms      = period_ms - TEST_PER_PACKET_GAP_MS;
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = false;
+#endif
+
+    return rp_task_enqueue( modem_test_context.rp, &rp_task, payload, modem_test_per.payload_length,
+                            &radio_params ) == RP_HOOK_STATUS_OK;
+}
+
+static bool modem_test_per_listen( void )
+{
+    rp_radio_params_t radio_params = { 0 };
+    uint32_t          now_ms       = smtc_modem_hal_get_time_in_ms( );
+
+    if( modem_test_per.is_synchronized == true )
+    {
+        uint32_t end_ms = modem_test_per.config_start_ms +
+                          modem_test_per.nb_packets * modem_test_per_get_period_ms( modem_test_per.config_index ) +
+                          TEST_PER_RX_MARGIN_MS;
+
+        while( ( int32_t ) ( end_ms - now_ms ) <= 0 )
+        {
+            // The current configuration is over, the next one starts after the configuration gap
+            modem_test_per.config_start_ms = end_ms - TEST_PER_RX_MARGIN_MS + TEST_PER_CONFIG_GAP_MS;
+            modem_test_per.config_index++;
+            if( modem_test_per.config_index >= modem_test_per.nb_configs )
+            {
+                modem_test_per_end( SMTC_MODEM_EVENT_TEST_MODE_PER_DONE );
+                return true;
+            }
+            end_ms = modem_test_per.config_start_ms +
+                     modem_test_per.nb_packets * modem_test_per_get_period_ms( modem_test_per.config_index ) +
+                     TEST_PER_RX_MARGIN_MS;
+        }
+        radio_params.rx.timeout_in_ms = end_ms - now_ms;
+    }
+    else
+    {
+        // Wait for the first packet of the first configuration
+        radio_params.rx.timeout_in_ms = RAL_RX_TIMEOUT_CONTINUOUS_MODE;
+    }
+
+    radio_params.pkt_type = RAL_PKT_TYPE_LORA;
+    modem_test_per_get_lora_params( modem_test_per.config_index, &radio_params.rx.lora );
+    radio_params.rx.lora.pkt_params.pld_len_in_bytes = 255;
+
+    rp_task.hook_id               = modem_test_context.hook_id;
+    rp_task.type                  = RP_TASK_TYPE_RX_LORA;
+    rp_task.state                 = RP_TASK_STATE_ASAP;
+    rp_task.launch_task_callbacks = lr1_stack_mac_rx_lora_launch_callback_for_rp;
+    rp_task.start_time_ms         = now_ms;
+    rp_task.duration_time_ms      = 20;  // will be extended by the radio planner
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = false;
+#endif
+
+    return rp_task_enqueue( modem_test_context.rp, &rp_task, modem_test_context.tx_rx_payload, 255, &radio_params ) ==
+           RP_HOOK_STATUS_OK;
+}
+
+static void modem_test_per_receive( modem_test_context_t* context )
+{
+    const uint8_t*                  payload    = context->tx_rx_payload;
+    const ral_lora_rx_pkt_status_t* pkt_status = &context->rp->radio_params[context->hook_id].rx.lora_pkt_status;
+    uint32_t                        irq_timestamp_ms;
+    rp_status_t                     rp_status;
+
+    if( ( context->rp->rx_payload_size[context->hook_id] != modem_test_per.payload_length ) || ( payload[0] != 'P' ) ||
+        ( payload[1] != 'E' ) || ( payload[2] != modem_test_per.config_index ) )
+    {
+        return;
+    }
+    uint16_t packet_index = ( ( uint16_t ) payload[3] << 8 ) | payload[4];
+    if( packet_index >= modem_test_per.nb_packets )
+    {
+        return;
+    }
+
+    // The packet ends a time on air after its place on the timeline
+    rp_get_status( context->rp, context->hook_id, &irq_timestamp_ms, &rp_status );
+    uint32_t period_ms = modem_test_per_get_period_ms( modem_test_per.config_index );
+    modem_test_per.config_start_ms =
+        irq_timestamp_ms - ( period_ms - TEST_PER_PACKET_GAP_MS ) - packet_index * period_ms;
+    modem_test_per.is_synchronized = true;
+
+    modem_test_per_stats_t* stats = &modem_test_per.stats[modem_test_per.config_index];
+    if( ( stats->nb_received == 0 ) || ( pkt_status->rssi_pkt_in_dbm < stats->rssi_min_dbm ) )
+    {
+        stats->rssi_min_dbm = pkt_status->rssi_pkt_in_dbm;
+    }
+    if( ( stats->nb_received == 0 ) || ( pkt_status->rssi_pkt_in_dbm > stats->rssi_max_dbm ) )
+    {
+        stats->rssi_max_dbm = pkt_status->rssi_pkt_in_dbm;
+    }
+    if( ( stats->nb_received == 0 ) || ( pkt_status->snr_pkt_in_db < stats->snr_min_db ) )
+    {
+        stats->snr_min_db = pkt_status->snr_pkt_in_db;
+    }
+    if( ( stats->nb_received == 0 ) || ( pkt_status->snr_pkt_in_db > stats->snr_max_db ) )
+    {
+        stats->snr_max_db = pkt_status->snr_pkt_in_db;
+    }
+    stats->rssi_sum += pkt_status->rssi_pkt_in_dbm;
+    stats->snr_sum += pkt_status->snr_pkt_in_db;
+    stats->nb_received++;
+}
+
+static void modem_test_per_end( smtc_modem_event_test_mode_status_t status )
+{
+    modem_test_per.ready = true;
+    increment_asynchronous_msgnumber( SMTC_MODEM_EVENT_TEST_MODE, status, 0xFF );
+    SMTC_MODEM_HAL_TRACE_PRINTF( "Per test ended after %d configs\n", modem_test_per.config_index );
+}
+
 static void modem_test_enqueue_task( uint8_t* payload, uint8_t payload_length )
 {
     rp_task.hook_id = modem_test_context.hook_id;
     rp_task.state   = RP_TASK_STATE_ASAP;
+#if defined( ADD_RP_RX_CONTINUOUS )
+    rp_task.rx_continuous = false;
+#endif
     rp_release_hook( modem_test_context.rp, modem_test_context.hook_id );
     rp_hook_init( modem_test_context.rp, modem_test_context.hook_id, ( void ( * )( void* ) )( modem_test_tx_callback ),
                   &modem_test_context );
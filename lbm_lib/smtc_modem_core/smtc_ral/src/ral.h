@@ -46,13 +46,58 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "ral_defs.h"
 #include "ral_drv.h"
+
+#if defined( RAL_STATIC_DRIVER )
+#if defined( SX128X )
+#include "ral_sx128x.h"
+#elif defined( SX126X )
+#include "ral_sx126x.h"
+#elif defined( LR11XX )
+#include "ral_lr11xx.h"
+#elif defined( SX127X )
+#include "ral_sx127x.h"
+#elif defined( VIRTUAL_RADIO )
+#include "ral_virtual.h"
+#else
+#error "RAL_STATIC_DRIVER needs the radio of the build (SX128X, SX126X, LR11XX, SX127X or VIRTUAL_RADIO)"
+#endif
+#endif
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC MACROS -----------------------------------------------------------
  */
 
+/**
+ * @brief Driver function called by the ral_* functions
+ *
+ * @remark With RAL_STATIC_DRIVER (LBM_RAL_STATIC=yes) the firmware has a single radio driver, the one of the build:
+ * the ral_* functions call it directly so that the compiler resolves the calls and the linker drops the unused driver
+ * functions, and the driver table of the ral_t instances is left empty. The RAL_STATIC_DRIVER_HAS_* macros tell the
+ * optional functions the driver implements.
+ */
+#if defined( RAL_STATIC_DRIVER )
+#if defined( SX128X )
+#define RAL_DRV_FUNC( radio, func ) ral_sx128x_##func
+#elif defined( SX126X )
+#define RAL_DRV_FUNC( radio, func ) ral_sx126x_##func
+#define RAL_STATIC_DRIVER_HAS_BATCH
+#define RAL_STATIC_DRIVER_HAS_CFG_SHADOW
+#define RAL_STATIC_DRIVER_HAS_CONTINUOUS_RX
+#elif defined( LR11XX )
+#define RAL_DRV_FUNC( radio, func ) ral_lr11xx_##func
+#define RAL_STATIC_DRIVER_HAS_CFG_SHADOW
+#elif defined( SX127X )
+#define RAL_DRV_FUNC( radio, func ) ral_sx127x_##func
+#elif defined( VIRTUAL_RADIO )
+#define RAL_DRV_FUNC( radio, func ) ral_virtual_##func
+#endif
+#else
+#define RAL_DRV_FUNC( radio, func ) ( radio )->driver.func
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC CONSTANTS --------------------------------------------------------
@@ -83,7 +128,7 @@ typedef struct ral_s
  */
 static inline bool ral_handles_part( const ral_t* radio, const char* part_number )
 {
-    return radio->driver.handles_part( part_number );
+    return RAL_DRV_FUNC( radio, handles_part )( part_number );
 }
 
 /**
@@ -97,7 +142,7 @@ static inline bool ral_handles_part( const ral_t* radio, const char* part_number
  */
 static inline ral_status_t ral_reset( const ral_t* radio )
 {
-    return radio->driver.reset( radio->context );
+    return RAL_DRV_FUNC( radio, reset )( radio->context );
 }
 
 /**
@@ -111,7 +156,7 @@ static inline ral_status_t ral_reset( const ral_t* radio )
  */
 static inline ral_status_t ral_init( const ral_t* radio )
 {
-    return radio->driver.init( radio->context );
+    return RAL_DRV_FUNC( radio, init )( radio->context );
 }
 
 /**
@@ -123,7 +168,7 @@ static inline ral_status_t ral_init( const ral_t* radio )
  */
 static inline ral_status_t ral_wakeup( const ral_t* radio )
 {
-    return radio->driver.wakeup( radio->context );
+    return RAL_DRV_FUNC( radio, wakeup )( radio->context );
 }
 
 /**
@@ -136,7 +181,7 @@ static inline ral_status_t ral_wakeup( const ral_t* radio )
  */
 static inline ral_status_t ral_set_sleep( const ral_t* radio, const bool retain_config )
 {
-    return radio->driver.set_sleep( radio->context, retain_config );
+    return RAL_DRV_FUNC( radio, set_sleep )( radio->context, retain_config );
 }
 
 /**
@@ -149,7 +194,7 @@ static inline ral_status_t ral_set_sleep( const ral_t* radio, const bool retain_
  */
 static inline ral_status_t ral_set_standby( const ral_t* radio, ral_standby_cfg_t standby_cfg )
 {
-    return radio->driver.set_standby( radio->context, standby_cfg );
+    return RAL_DRV_FUNC( radio, set_standby )( radio->context, standby_cfg );
 }
 
 /**
@@ -161,7 +206,7 @@ static inline ral_status_t ral_set_standby( const ral_t* radio, ral_standby_cfg_
  */
 static inline ral_status_t ral_set_fs( const ral_t* radio )
 {
-    return radio->driver.set_fs( radio->context );
+    return RAL_DRV_FUNC( radio, set_fs )( radio->context );
 }
 
 /**
@@ -173,7 +218,7 @@ static inline ral_status_t ral_set_fs( const ral_t* radio )
  */
 static inline ral_status_t ral_set_tx( const ral_t* radio )
 {
-    return radio->driver.set_tx( radio->context );
+    return RAL_DRV_FUNC( radio, set_tx )( radio->context );
 }
 
 /**
@@ -186,7 +231,7 @@ static inline ral_status_t ral_set_tx( const ral_t* radio )
  */
 static inline ral_status_t ral_set_rx( const ral_t* radio, const uint32_t timeout_in_ms )
 {
-    return radio->driver.set_rx( radio->context, timeout_in_ms );
+    return RAL_DRV_FUNC( radio, set_rx )( radio->context, timeout_in_ms );
 }
 
 /**
@@ -199,7 +244,7 @@ static inline ral_status_t ral_set_rx( const ral_t* radio, const uint32_t timeou
  */
 static inline ral_status_t ral_cfg_rx_boosted( const ral_t* radio, const bool enable_boost_mode )
 {
-    return radio->driver.cfg_rx_boosted( radio->context, enable_boost_mode );
+    return RAL_DRV_FUNC( radio, cfg_rx_boosted )( radio->context, enable_boost_mode );
 }
 
 /**
@@ -214,7 +259,7 @@ static inline ral_status_t ral_cfg_rx_boosted( const ral_t* radio, const bool en
  */
 static inline ral_status_t ral_set_rx_tx_fallback_mode( const ral_t* radio, const ral_fallback_modes_t fallback_mode )
 {
-    return radio->driver.set_rx_tx_fallback_mode( radio->context, fallback_mode );
+    return RAL_DRV_FUNC( radio, set_rx_tx_fallback_mode )( radio->context, fallback_mode );
 }
 
 /**
@@ -231,7 +276,7 @@ static inline ral_status_t ral_set_rx_tx_fallback_mode( const ral_t* radio, cons
  */
 static inline ral_status_t ral_stop_timer_on_preamble( const ral_t* radio, const bool enable )
 {
-    return radio->driver.stop_timer_on_preamble( radio->context, enable );
+    return RAL_DRV_FUNC( radio, stop_timer_on_preamble )( radio->context, enable );
 }
 
 /**
@@ -246,7 +291,7 @@ static inline ral_status_t ral_stop_timer_on_preamble( const ral_t* radio, const
 static inline ral_status_t ral_set_rx_duty_cycle( const ral_t* radio, const uint32_t rx_time_in_ms,
                                                   const uint32_t sleep_time_in_ms )
 {
-    return radio->driver.set_rx_duty_cycle( radio->context, rx_time_in_ms, sleep_time_in_ms );
+    return RAL_DRV_FUNC( radio, set_rx_duty_cycle )( radio->context, rx_time_in_ms, sleep_time_in_ms );
 }
 
 /**
@@ -260,7 +305,7 @@ static inline ral_status_t ral_set_rx_duty_cycle( const ral_t* radio, const uint
  */
 static inline ral_status_t ral_set_lora_cad( const ral_t* radio )
 {
-    return radio->driver.set_lora_cad( radio->context );
+    return RAL_DRV_FUNC( radio, set_lora_cad )( radio->context );
 }
 
 /**
@@ -274,7 +319,7 @@ static inline ral_status_t ral_set_lora_cad( const ral_t* radio )
  */
 static inline ral_status_t ral_set_tx_cw( const ral_t* radio )
 {
-    return radio->driver.set_tx_cw( radio->context );
+    return RAL_DRV_FUNC( radio, set_tx_cw )( radio->context );
 }
 
 /**
@@ -288,7 +333,7 @@ static inline ral_status_t ral_set_tx_cw( const ral_t* radio )
  */
 static inline ral_status_t ral_set_tx_infinite_preamble( const ral_t* radio )
 {
-    return radio->driver.set_tx_infinite_preamble( radio->context );
+    return RAL_DRV_FUNC( radio, set_tx_infinite_preamble )( radio->context );
 }
 
 /**
@@ -302,7 +347,47 @@ static inline ral_status_t ral_set_tx_infinite_preamble( const ral_t* radio )
  */
 static inline ral_status_t ral_cal_img( const ral_t* radio, const uint16_t freq1_in_mhz, const uint16_t freq2_in_mhz )
 {
-    return radio->driver.cal_img( radio->context, freq1_in_mhz, freq2_in_mhz );
+    return RAL_DRV_FUNC( radio, cal_img )( radio->context, freq1_in_mhz, freq2_in_mhz );
+}
+
+/**
+ * @brief Get the image calibration interval covering a frequency, in MHz
+ *
+ * @details The interval is the band recommended by the radio datasheets when the frequency belongs to one, so that
+ * channel changes inside a band keep the same calibration. Otherwise it is the 1 MHz around the frequency, which the
+ * radio rounds to its 4 MHz calibration step.
+ *
+ * @param [in]  freq_in_hz    Frequency, in Hz
+ * @param [out] freq1_in_mhz  Image calibration interval lower bound, in MHz
+ * @param [out] freq2_in_mhz  Image calibration interval upper bound, in MHz
+ *
+ * @returns False if no image calibration applies to the frequency (2.4 GHz)
+ */
+static inline bool ral_get_cal_img_interval_in_mhz( const uint32_t freq_in_hz, uint16_t* freq1_in_mhz,
+                                                    uint16_t* freq2_in_mhz )
+{
+    static const uint16_t bands_in_mhz[][2] = {
+        { 430, 440 }, { 470, 510 }, { 779, 787 }, { 863, 870 }, { 902, 928 },
+    };
+    const uint16_t freq_in_mhz = ( uint16_t ) ( freq_in_hz / 1000000 );
+
+    if( freq_in_hz >= 1000000000 )
+    {
+        return false;
+    }
+
+    *freq1_in_mhz = freq_in_mhz;
+    *freq2_in_mhz = freq_in_mhz + 1;
+    for( uint8_t i = 0; i < ( sizeof( bands_in_mhz ) / sizeof( bands_in_mhz[0] ) ); i++ )
+    {
+        if( ( freq_in_mhz >= bands_in_mhz[i][0] ) && ( freq_in_mhz < bands_in_mhz[i][1] ) )
+        {
+            *freq1_in_mhz = bands_in_mhz[i][0];
+            *freq2_in_mhz = bands_in_mhz[i][1];
+            break;
+        }
+    }
+    return true;
 }
 
 /**
@@ -319,7 +404,7 @@ static inline ral_status_t ral_cal_img( const ral_t* radio, const uint16_t freq1
 static inline ral_status_t ral_set_tx_cfg( const ral_t* radio, const int8_t output_pwr_in_dbm,
                                            const uint32_t rf_freq_in_hz )
 {
-    return radio->driver.set_tx_cfg( radio->context, output_pwr_in_dbm, rf_freq_in_hz );
+    return RAL_DRV_FUNC( radio, set_tx_cfg )( radio->context, output_pwr_in_dbm, rf_freq_in_hz );
 }
 
 /**
@@ -333,7 +418,7 @@ static inline ral_status_t ral_set_tx_cfg( const ral_t* radio, const int8_t outp
  */
 static inline ral_status_t ral_set_pkt_payload( const ral_t* radio, const uint8_t* buffer, const uint16_t size )
 {
-    return radio->driver.set_pkt_payload( radio->context, buffer, size );
+    return RAL_DRV_FUNC( radio, set_pkt_payload )( radio->context, buffer, size );
 }
 
 /**
@@ -349,7 +434,38 @@ static inline ral_status_t ral_set_pkt_payload( const ral_t* radio, const uint8_
 static inline ral_status_t ral_get_pkt_payload( const ral_t* radio, uint16_t max_size_in_bytes, uint8_t* buffer,
                                                 uint16_t* size_in_bytes )
 {
-    return radio->driver.get_pkt_payload( radio->context, max_size_in_bytes, buffer, size_in_bytes );
+    return RAL_DRV_FUNC( radio, get_pkt_payload )( radio->context, max_size_in_bytes, buffer, size_in_bytes );
+}
+
+/**
+ * @brief Get the last packet received while the radio stays in continuous reception
+ *
+ * @remark The Rx buffer base address is moved right after the packet before it is read, so that the next packet is
+ * written in another region of the circular radio buffer while this one is read. Drivers that cannot move the Rx
+ * buffer (not set in their driver structure) read the packet as @ref ral_get_pkt_payload does.
+ *
+ * @param [in] radio             Pointer to radio data structure
+ * @param [in] max_size_in_bytes  Size of the application buffer - in bytes
+ * @param [out] buffer           Pointer to the buffer to be filled with received data
+ * @param [out] size_in_bytes     Size of the received buffer - in bytes
+ *
+ * @returns Operation status
+ */
+static inline ral_status_t ral_get_continuous_rx_pkt_payload( const ral_t* radio, uint16_t max_size_in_bytes,
+                                                              uint8_t* buffer, uint16_t* size_in_bytes )
+{
+#if defined( RAL_STATIC_DRIVER ) && defined( RAL_STATIC_DRIVER_HAS_CONTINUOUS_RX )
+    return RAL_DRV_FUNC( radio, get_continuous_rx_pkt_payload )( radio->context, max_size_in_bytes, buffer,
+                                                                 size_in_bytes );
+#elif defined( RAL_STATIC_DRIVER )
+    return RAL_DRV_FUNC( radio, get_pkt_payload )( radio->context, max_size_in_bytes, buffer, size_in_bytes );
+#else
+    if( radio->driver.get_continuous_rx_pkt_payload == NULL )
+    {
+        return radio->driver.get_pkt_payload( radio->context, max_size_in_bytes, buffer, size_in_bytes );
+    }
+    return radio->driver.get_continuous_rx_pkt_payload( radio->context, max_size_in_bytes, buffer, size_in_bytes );
+#endif
 }
 
 /**
@@ -362,7 +478,7 @@ static inline ral_status_t ral_get_pkt_payload( const ral_t* radio, uint16_t max
  */
 static inline ral_status_t ral_get_irq_status( const ral_t* radio, ral_irq_t* irq )
 {
-    return radio->driver.get_irq_status( radio->context, irq );
+    return RAL_DRV_FUNC( radio, get_irq_status )( radio->context, irq );
 }
 
 /**
@@ -375,7 +491,7 @@ static inline ral_status_t ral_get_irq_status( const ral_t* radio, ral_irq_t* ir
  */
 static inline ral_status_t ral_clear_irq_status( const ral_t* radio, const ral_irq_t irq )
 {
-    return radio->driver.clear_irq_status( radio->context, irq );
+    return RAL_DRV_FUNC( radio, clear_irq_status )( radio->context, irq );
 }
 
 /**
@@ -388,7 +504,7 @@ static inline ral_status_t ral_clear_irq_status( const ral_t* radio, const ral_i
  */
 static inline ral_status_t ral_get_and_clear_irq_status( const ral_t* radio, ral_irq_t* irq )
 {
-    return radio->driver.get_and_clear_irq_status( radio->context, irq );
+    return RAL_DRV_FUNC( radio, get_and_clear_irq_status )( radio->context, irq );
 }
 
 /**
@@ -401,7 +517,7 @@ static inline ral_status_t ral_get_and_clear_irq_status( const ral_t* radio, ral
  */
 static inline ral_status_t ral_set_dio_irq_params( const ral_t* radio, const ral_irq_t irq )
 {
-    return radio->driver.set_dio_irq_params( radio->context, irq );
+    return RAL_DRV_FUNC( radio, set_dio_irq_params )( radio->context, irq );
 }
 
 /**
@@ -414,7 +530,7 @@ static inline ral_status_t ral_set_dio_irq_params( const ral_t* radio, const ral
  */
 static inline ral_status_t ral_set_rf_freq( const ral_t* radio, const uint32_t freq_in_hz )
 {
-    return radio->driver.set_rf_freq( radio->context, freq_in_hz );
+    return RAL_DRV_FUNC( radio, set_rf_freq )( radio->context, freq_in_hz );
 }
 
 /**
@@ -427,7 +543,7 @@ static inline ral_status_t ral_set_rf_freq( const ral_t* radio, const uint32_t f
  */
 static inline ral_status_t ral_set_pkt_type( const ral_t* radio, const ral_pkt_type_t pkt_type )
 {
-    return radio->driver.set_pkt_type( radio->context, pkt_type );
+    return RAL_DRV_FUNC( radio, set_pkt_type )( radio->context, pkt_type );
 }
 
 /**
@@ -440,7 +556,7 @@ static inline ral_status_t ral_set_pkt_type( const ral_t* radio, const ral_pkt_t
  */
 static inline ral_status_t ral_get_pkt_type( const ral_t* radio, ral_pkt_type_t* pkt_type )
 {
-    return radio->driver.get_pkt_type( radio->context, pkt_type );
+    return RAL_DRV_FUNC( radio, get_pkt_type )( radio->context, pkt_type );
 }
 
 /**
@@ -455,7 +571,7 @@ static inline ral_status_t ral_get_pkt_type( const ral_t* radio, ral_pkt_type_t*
  */
 static inline ral_status_t ral_set_gfsk_mod_params( const ral_t* radio, const ral_gfsk_mod_params_t* params )
 {
-    return radio->driver.set_gfsk_mod_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_gfsk_mod_params )( radio->context, params );
 }
 
 /**
@@ -470,7 +586,7 @@ static inline ral_status_t ral_set_gfsk_mod_params( const ral_t* radio, const ra
  */
 static inline ral_status_t ral_set_gfsk_pkt_params( const ral_t* radio, const ral_gfsk_pkt_params_t* params )
 {
-    return radio->driver.set_gfsk_pkt_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_gfsk_pkt_params )( radio->context, params );
 }
 
 /**
@@ -487,7 +603,12 @@ static inline ral_status_t ral_set_gfsk_pkt_params( const ral_t* radio, const ra
 static inline ral_status_t ral_set_gfsk_pkt_address( const ral_t* radio, const uint8_t node_address,
                                                      const uint8_t broadcast_address )
 {
+#if defined( RAL_STATIC_DRIVER )
+    // Not implemented by the radio drivers
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#else
     return radio->driver.set_gfsk_pkt_address( radio->context, node_address, broadcast_address );
+#endif
 }
 
 /**
@@ -502,7 +623,7 @@ static inline ral_status_t ral_set_gfsk_pkt_address( const ral_t* radio, const u
  */
 static inline ral_status_t ral_set_lora_mod_params( const ral_t* radio, const ral_lora_mod_params_t* params )
 {
-    return radio->driver.set_lora_mod_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_lora_mod_params )( radio->context, params );
 }
 
 /**
@@ -517,7 +638,7 @@ static inline ral_status_t ral_set_lora_mod_params( const ral_t* radio, const ra
  */
 static inline ral_status_t ral_set_lora_pkt_params( const ral_t* radio, const ral_lora_pkt_params_t* params )
 {
-    return radio->driver.set_lora_pkt_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_lora_pkt_params )( radio->context, params );
 }
 
 /**
@@ -532,7 +653,7 @@ static inline ral_status_t ral_set_lora_pkt_params( const ral_t* radio, const ra
  */
 static inline ral_status_t ral_set_lora_cad_params( const ral_t* radio, const ral_lora_cad_params_t* params )
 {
-    return radio->driver.set_lora_cad_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_lora_cad_params )( radio->context, params );
 }
 
 /**
@@ -546,7 +667,7 @@ static inline ral_status_t ral_set_lora_cad_params( const ral_t* radio, const ra
  */
 static inline ral_status_t ral_set_lora_symb_nb_timeout( const ral_t* radio, const uint16_t nb_of_symbs )
 {
-    return radio->driver.set_lora_symb_nb_timeout( radio->context, nb_of_symbs );
+    return RAL_DRV_FUNC( radio, set_lora_symb_nb_timeout )( radio->context, nb_of_symbs );
 }
 
 /**
@@ -561,7 +682,7 @@ static inline ral_status_t ral_set_lora_symb_nb_timeout( const ral_t* radio, con
  */
 static inline ral_status_t ral_set_flrc_mod_params( const ral_t* radio, const ral_flrc_mod_params_t* params )
 {
-    return radio->driver.set_flrc_mod_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_flrc_mod_params )( radio->context, params );
 }
 
 /**
@@ -576,7 +697,7 @@ static inline ral_status_t ral_set_flrc_mod_params( const ral_t* radio, const ra
  */
 static inline ral_status_t ral_set_flrc_pkt_params( const ral_t* radio, const ral_flrc_pkt_params_t* params )
 {
-    return radio->driver.set_flrc_pkt_params( radio->context, params );
+    return RAL_DRV_FUNC( radio, set_flrc_pkt_params )( radio->context, params );
 }
 
 /**
@@ -589,7 +710,7 @@ static inline ral_status_t ral_set_flrc_pkt_params( const ral_t* radio, const ra
  */
 static inline ral_status_t ral_get_gfsk_rx_pkt_status( const ral_t* radio, ral_gfsk_rx_pkt_status_t* rx_pkt_status )
 {
-    return radio->driver.get_gfsk_rx_pkt_status( radio->context, rx_pkt_status );
+    return RAL_DRV_FUNC( radio, get_gfsk_rx_pkt_status )( radio->context, rx_pkt_status );
 }
 
 /**
@@ -602,7 +723,7 @@ static inline ral_status_t ral_get_gfsk_rx_pkt_status( const ral_t* radio, ral_g
  */
 static inline ral_status_t ral_get_lora_rx_pkt_status( const ral_t* radio, ral_lora_rx_pkt_status_t* rx_pkt_status )
 {
-    return radio->driver.get_lora_rx_pkt_status( radio->context, rx_pkt_status );
+    return RAL_DRV_FUNC( radio, get_lora_rx_pkt_status )( radio->context, rx_pkt_status );
 }
 
 /**
@@ -615,7 +736,7 @@ static inline ral_status_t ral_get_lora_rx_pkt_status( const ral_t* radio, ral_l
  */
 static inline ral_status_t ral_get_flrc_rx_pkt_status( const ral_t* radio, ral_flrc_rx_pkt_status_t* rx_pkt_status )
 {
-    return radio->driver.get_flrc_rx_pkt_status( radio->context, rx_pkt_status );
+    return RAL_DRV_FUNC( radio, get_flrc_rx_pkt_status )( radio->context, rx_pkt_status );
 }
 
 /**
@@ -630,7 +751,7 @@ static inline ral_status_t ral_get_flrc_rx_pkt_status( const ral_t* radio, ral_f
  */
 static inline ral_status_t ral_get_rssi_inst( const ral_t* radio, int16_t* rssi_in_dbm )
 {
-    return radio->driver.get_rssi_inst( radio->context, rssi_in_dbm );
+    return RAL_DRV_FUNC( radio, get_rssi_inst )( radio->context, rssi_in_dbm );
 }
 
 /**
@@ -644,7 +765,7 @@ static inline ral_status_t ral_get_rssi_inst( const ral_t* radio, int16_t* rssi_
 static inline uint32_t ral_get_lora_time_on_air_in_ms( const ral_t* radio, const ral_lora_pkt_params_t* pkt_p,
                                                        const ral_lora_mod_params_t* mod_p )
 {
-    return radio->driver.get_lora_time_on_air_in_ms( pkt_p, mod_p );
+    return RAL_DRV_FUNC( radio, get_lora_time_on_air_in_ms )( pkt_p, mod_p );
 }
 
 /**
@@ -658,7 +779,7 @@ static inline uint32_t ral_get_lora_time_on_air_in_ms( const ral_t* radio, const
 static inline uint32_t ral_get_gfsk_time_on_air_in_ms( const ral_t* radio, const ral_gfsk_pkt_params_t* pkt_p,
                                                        const ral_gfsk_mod_params_t* mod_p )
 {
-    return radio->driver.get_gfsk_time_on_air_in_ms( pkt_p, mod_p );
+    return RAL_DRV_FUNC( radio, get_gfsk_time_on_air_in_ms )( pkt_p, mod_p );
 }
 
 /**
@@ -672,7 +793,7 @@ static inline uint32_t ral_get_gfsk_time_on_air_in_ms( const ral_t* radio, const
 static inline uint32_t ral_get_flrc_time_on_air_in_ms( const ral_t* radio, const ral_flrc_pkt_params_t* pkt_p,
                                                        const ral_flrc_mod_params_t* mod_p )
 {
-    return radio->driver.get_flrc_time_on_air_in_ms( pkt_p, mod_p );
+    return RAL_DRV_FUNC( radio, get_flrc_time_on_air_in_ms )( pkt_p, mod_p );
 }
 
 /**
@@ -687,7 +808,7 @@ static inline uint32_t ral_get_flrc_time_on_air_in_ms( const ral_t* radio, const
 static inline ral_status_t ral_set_gfsk_sync_word( const ral_t* radio, const uint8_t* sync_word,
                                                    const uint8_t sync_word_len )
 {
-    return radio->driver.set_gfsk_sync_word( radio->context, sync_word, sync_word_len );
+    return RAL_DRV_FUNC( radio, set_gfsk_sync_word )( radio->context, sync_word, sync_word_len );
 }
 
 /**
@@ -704,7 +825,7 @@ static inline ral_status_t ral_set_gfsk_sync_word( const ral_t* radio, const uin
  */
 static inline ral_status_t ral_set_lora_sync_word( const ral_t* radio, const uint8_t sync_word )
 {
-    return radio->driver.set_lora_sync_word( radio->context, sync_word );
+    return RAL_DRV_FUNC( radio, set_lora_sync_word )( radio->context, sync_word );
 }
 
 /**
@@ -719,7 +840,7 @@ static inline ral_status_t ral_set_lora_sync_word( const ral_t* radio, const uin
 static inline ral_status_t ral_set_flrc_sync_word( const ral_t* radio, const uint8_t* sync_word,
                                                    const uint8_t sync_word_len )
 {
-    return radio->driver.set_flrc_sync_word( radio->context, sync_word, sync_word_len );
+    return RAL_DRV_FUNC( radio, set_flrc_sync_word )( radio->context, sync_word, sync_word_len );
 }
 
 /**
@@ -733,7 +854,7 @@ static inline ral_status_t ral_set_flrc_sync_word( const ral_t* radio, const uin
  */
 static inline ral_status_t ral_set_gfsk_crc_params( const ral_t* radio, const uint32_t seed, const uint32_t polynomial )
 {
-    return radio->driver.set_gfsk_crc_params( radio->context, seed, polynomial );
+    return RAL_DRV_FUNC( radio, set_gfsk_crc_params )( radio->context, seed, polynomial );
 }
 
 /**
@@ -746,7 +867,7 @@ static inline ral_status_t ral_set_gfsk_crc_params( const ral_t* radio, const ui
  */
 static inline ral_status_t ral_set_flrc_crc_params( const ral_t* radio, const uint32_t seed )
 {
-    return radio->driver.set_flrc_crc_params( radio->context, seed );
+    return RAL_DRV_FUNC( radio, set_flrc_crc_params )( radio->context, seed );
 }
 
 /**
@@ -759,7 +880,7 @@ static inline ral_status_t ral_set_flrc_crc_params( const ral_t* radio, const ui
  */
 static inline ral_status_t ral_set_gfsk_whitening_seed( const ral_t* radio, const uint16_t seed )
 {
-    return radio->driver.set_gfsk_whitening_seed( radio->context, seed );
+    return RAL_DRV_FUNC( radio, set_gfsk_whitening_seed )( radio->context, seed );
 }
 
 /**
@@ -772,7 +893,7 @@ static inline ral_status_t ral_set_gfsk_whitening_seed( const ral_t* radio, cons
  */
 static inline ral_status_t ral_lr_fhss_init( const ral_t* radio, const ral_lr_fhss_params_t* lr_fhss_params )
 {
-    return radio->driver.lr_fhss_init( radio->context, lr_fhss_params );
+    return RAL_DRV_FUNC( radio, lr_fhss_init )( radio->context, lr_fhss_params );
 }
 
 /**
@@ -792,8 +913,8 @@ static inline ral_status_t ral_lr_fhss_build_frame( const ral_t* radio, const ra
                                                     uint16_t hop_sequence_id, const uint8_t* payload,
                                                     uint16_t payload_length )
 {
-    return radio->driver.lr_fhss_build_frame( radio->context, lr_fhss_params, memory_state_holder, hop_sequence_id,
-                                              payload, payload_length );
+    return RAL_DRV_FUNC( radio, lr_fhss_build_frame )( radio->context, lr_fhss_params, memory_state_holder,
+                                                       hop_sequence_id, payload, payload_length );
 }
 
 /**
@@ -808,7 +929,7 @@ static inline ral_status_t ral_lr_fhss_build_frame( const ral_t* radio, const ra
 static inline ral_status_t ral_lr_fhss_handle_hop( const ral_t* radio, const ral_lr_fhss_params_t* lr_fhss_params,
                                                    ral_lr_fhss_memory_state_t memory_state_holder )
 {
-    return radio->driver.lr_fhss_handle_hop( radio->context, lr_fhss_params, memory_state_holder );
+    return RAL_DRV_FUNC( radio, lr_fhss_handle_hop )( radio->context, lr_fhss_params, memory_state_holder );
 }
 
 /**
@@ -823,7 +944,7 @@ static inline ral_status_t ral_lr_fhss_handle_hop( const ral_t* radio, const ral
 static inline ral_status_t ral_lr_fhss_handle_tx_done( const ral_t* radio, const ral_lr_fhss_params_t* lr_fhss_params,
                                                        ral_lr_fhss_memory_state_t memory_state_holder )
 {
-    return radio->driver.lr_fhss_handle_tx_done( radio->context, lr_fhss_params, memory_state_holder );
+    return RAL_DRV_FUNC( radio, lr_fhss_handle_tx_done )( radio->context, lr_fhss_params, memory_state_holder );
 }
 
 /**
@@ -839,7 +960,8 @@ static inline ral_status_t ral_lr_fhss_get_time_on_air_in_ms( const ral_t*
                                                               const ral_lr_fhss_params_t* lr_fhss_params,
                                                               uint16_t payload_length, uint32_t* time_on_air )
 {
-    return radio->driver.lr_fhss_get_time_on_air_in_ms( radio->context, lr_fhss_params, payload_length, time_on_air );
+    return RAL_DRV_FUNC( radio, lr_fhss_get_time_on_air_in_ms )( radio->context, lr_fhss_params, payload_length,
+                                                                 time_on_air );
 }
 
 /**
@@ -855,7 +977,7 @@ static inline ral_status_t ral_lr_fhss_get_hop_sequence_count( const ral_t*
                                                                const ral_lr_fhss_params_t* lr_fhss_params,
                                                                unsigned int*               hop_sequence_count )
 {
-    return radio->driver.lr_fhss_get_hop_sequence_count( radio->context, lr_fhss_params, hop_sequence_count );
+    return RAL_DRV_FUNC( radio, lr_fhss_get_hop_sequence_count )( radio->context, lr_fhss_params, hop_sequence_count );
 }
 
 /**
@@ -871,7 +993,7 @@ static inline ral_status_t ral_lr_fhss_get_hop_sequence_count( const ral_t*
 static inline ral_status_t ral_lr_fhss_get_bit_delay_in_us( const ral_t* radio, const ral_lr_fhss_params_t* params,
                                                             uint16_t payload_length, uint16_t* delay )
 {
-    return radio->driver.lr_fhss_get_bit_delay_in_us( radio->context, params, payload_length, delay );
+    return RAL_DRV_FUNC( radio, lr_fhss_get_bit_delay_in_us )( radio->context, params, payload_length, delay );
 }
 
 /**
@@ -885,7 +1007,7 @@ static inline ral_status_t ral_lr_fhss_get_bit_delay_in_us( const ral_t* radio,
  */
 static inline ral_status_t ral_get_lora_rx_pkt_cr_crc( const ral_t* radio, ral_lora_cr_t* cr, bool* is_crc_present )
 {
-    return radio->driver.get_lora_rx_pkt_cr_crc( radio->context, cr, is_crc_present );
+    return RAL_DRV_FUNC( radio, get_lora_rx_pkt_cr_crc )( radio->context, cr, is_crc_present );
 }
 
 /**
@@ -901,8 +1023,8 @@ static inline ral_status_t ral_get_lora_rx_pkt_cr_crc( const ral_t* radio, ral_l
 static inline ral_status_t ral_get_tx_consumption_in_ua( const ral_t* radio, const int8_t output_pwr_in_dbm,
                                                          const uint32_t rf_freq_in_hz, uint32_t* pwr_consumption_in_ua )
 {
-    return radio->driver.get_tx_consumption_in_ua( radio->context, output_pwr_in_dbm, rf_freq_in_hz,
-                                                   pwr_consumption_in_ua );
+    return RAL_DRV_FUNC( radio, get_tx_consumption_in_ua )( radio->context, output_pwr_in_dbm, rf_freq_in_hz,
+                                                            pwr_consumption_in_ua );
 }
 
 /**
@@ -920,8 +1042,8 @@ static inline ral_status_t ral_get_gfsk_rx_consumption_in_ua( const ral_t* radio
                                                               const uint32_t bw_dsb_in_hz, const bool rx_boosted,
                                                               uint32_t* pwr_consumption_in_ua )
 {
-    return radio->driver.get_gfsk_rx_consumption_in_ua( radio->context, br_in_bps, bw_dsb_in_hz, rx_boosted,
-                                                        pwr_consumption_in_ua );
+    return RAL_DRV_FUNC( radio, get_gfsk_rx_consumption_in_ua )( radio->context, br_in_bps, bw_dsb_in_hz, rx_boosted,
+                                                                 pwr_consumption_in_ua );
 }
 
 /**
@@ -937,7 +1059,8 @@ static inline ral_status_t ral_get_gfsk_rx_consumption_in_ua( const ral_t* radio
 static inline ral_status_t ral_get_lora_rx_consumption_in_ua( const ral_t* radio, const ral_lora_bw_t bw,
                                                               const bool rx_boosted, uint32_t* pwr_consumption_in_ua )
 {
-    return radio->driver.get_lora_rx_consumption_in_ua( radio->context, bw, rx_boosted, pwr_consumption_in_ua );
+    return RAL_DRV_FUNC( radio, get_lora_rx_consumption_in_ua )( radio->context, bw, rx_boosted,
+                                                                 pwr_consumption_in_ua );
 }
 
 /**
@@ -963,7 +1086,7 @@ static inline ral_status_t ral_get_lora_rx_consumption_in_ua( const ral_t* radio
  */
 static inline ral_status_t ral_get_random_numbers( const ral_t* radio, uint32_t* numbers, unsigned int n )
 {
-    return radio->driver.get_random_numbers( radio->context, numbers, n );
+    return RAL_DRV_FUNC( radio, get_random_numbers )( radio->context, numbers, n );
 }
 
 /**
@@ -977,7 +1100,7 @@ static inline ral_status_t ral_get_random_numbers( const ral_t* radio, uint32_t*
  */
 static inline ral_status_t ral_handle_rx_done( const ral_t* radio )
 {
-    return radio->driver.handle_rx_done( radio->context );
+    return RAL_DRV_FUNC( radio, handle_rx_done )( radio->context );
 }
 
 /**
@@ -991,13 +1114,87 @@ static inline ral_status_t ral_handle_rx_done( const ral_t* radio )
  */
 static inline ral_status_t ral_handle_tx_done( const ral_t* radio )
 {
-    return radio->driver.handle_tx_done( radio->context );
+    return RAL_DRV_FUNC( radio, handle_tx_done )( radio->context );
 }
 
 static inline ral_status_t ral_get_lora_cad_det_peak( const ral_t* radio, ral_lora_sf_t sf, ral_lora_bw_t bw,
                                                       ral_lora_cad_symbs_t nb_symbol, uint8_t* cad_det_peak )
 {
-    return radio->driver.get_lora_cad_det_peak( radio->context, sf, bw, nb_symbol, cad_det_peak );
+    return RAL_DRV_FUNC( radio, get_lora_cad_det_peak )( radio->context, sf, bw, nb_symbol, cad_det_peak );
+}
+
+/**
+ * @brief Forget the configuration shadow of the radio, the next configuration writes are all sent
+ *
+ * @remark Without ADD_RAL_CFG_SHADOW the configuration is never shadowed. The RAL invalidates the shadow on reset,
+ * init and sleep without retention; this function shall be called after any radio access that bypasses the RAL
+ * (direct driver or HAL calls, geolocation scans, suspended radio communications).
+ *
+ * @param [in] radio    Pointer to radio data structure
+ *
+ * @returns Operation status
+ */
+static inline ral_status_t ral_invalidate_cfg_shadow( const ral_t* radio )
+{
+#if defined( RAL_STATIC_DRIVER ) && defined( RAL_STATIC_DRIVER_HAS_CFG_SHADOW )
+    return RAL_DRV_FUNC( radio, invalidate_cfg_shadow )( radio->context );
+#elif defined( RAL_STATIC_DRIVER )
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#else
+    if( radio->driver.invalidate_cfg_shadow == NULL )
+    {
+        return RAL_STATUS_UNSUPPORTED_FEATURE;
+    }
+    return radio->driver.invalidate_cfg_shadow( radio->context );
+#endif
+}
+
+/**
+ * @brief Start recording the configuration commands in a batch sent in one burst by @ref ral_batch_commit
+ *
+ * @remark Reads and operating mode commands (sleep, standby, tx, rx, cad, ...) send the recorded commands before
+ * being executed, they can be issued at any time. Drivers without a command batch (not set in their driver
+ * structure) return @ref RAL_STATUS_UNSUPPORTED_FEATURE and keep sending the commands one by one.
+ *
+ * @param [in] radio    Pointer to radio data structure
+ *
+ * @returns Operation status
+ */
+static inline ral_status_t ral_batch_begin( const ral_t* radio )
+{
+#if defined( RAL_STATIC_DRIVER ) && defined( RAL_STATIC_DRIVER_HAS_BATCH )
+    return RAL_DRV_FUNC( radio, batch_begin )( radio->context );
+#elif defined( RAL_STATIC_DRIVER )
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#else
+    if( radio->driver.batch_begin == NULL )
+    {
+        return RAL_STATUS_UNSUPPORTED_FEATURE;
+    }
+    return radio->driver.batch_begin( radio->context );
+#endif
+}
+
+/**
+ * @brief Send the commands recorded since @ref ral_batch_begin and stop recording
+ *
+ * @param [in] radio    Pointer to radio data structure
+ *
+ * @returns Operation status
+ */
+static inline ral_status_t ral_batch_commit( const ral_t* radio )
+{
+#if defined( RAL_STATIC_DRIVER ) && defined( RAL_STATIC_DRIVER_HAS_BATCH )
+    return RAL_DRV_FUNC( radio, batch_commit )( radio->context );
+#elif defined( RAL_STATIC_DRIVER )
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#else
+    if( radio->driver.batch_commit == NULL )
+    {
+        return RAL_STATUS_UNSUPPORTED_FEATURE;
+    }
+    return radio->driver.batch_commit( radio->context );
+#endif
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,174 @@
+/**
+ * @file      ral_cfg_shadow.h
+ *
+ * @brief     Radio abstraction layer shadow of the last applied radio configuration
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RAL_CFG_SHADOW_H
+#define RAL_CFG_SHADOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief Shadowed configuration items, used as a bitmask
+ */
+#define RAL_CFG_SHADOW_PKT_TYPE ( 1 << 0 )
+#define RAL_CFG_SHADOW_RF_FREQ ( 1 << 1 )
+#define RAL_CFG_SHADOW_LORA_MOD_PARAMS ( 1 << 2 )
+#define RAL_CFG_SHADOW_LORA_PKT_PARAMS ( 1 << 3 )
+#define RAL_CFG_SHADOW_LORA_SYNC_WORD ( 1 << 4 )
+#define RAL_CFG_SHADOW_TX_CFG ( 1 << 5 )
+#define RAL_CFG_SHADOW_CAL_IMG ( 1 << 6 )
+#define RAL_CFG_SHADOW_ALL ( 0xFF )
+
+/**
+ * @brief Items depending on the packet type, lost when it changes
+ */
+#define RAL_CFG_SHADOW_PKT_TYPE_DEPENDENT \
+    ( RAL_CFG_SHADOW_LORA_MOD_PARAMS | RAL_CFG_SHADOW_LORA_PKT_PARAMS | RAL_CFG_SHADOW_LORA_SYNC_WORD )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/**
+ * @brief Shadow state, embedded at the beginning of the shadow of each radio driver
+ *
+ * @remark A single radio context is shadowed, an access with another context resets the shadow
+ */
+typedef struct ral_cfg_shadow_s
+{
+    const void* context;
+    uint8_t     valid_items;
+} ral_cfg_shadow_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Check if a configuration item is already applied with the same value
+ *
+ * @remark Values are compared byte per byte, they shall be zero initialized before being filled
+ *
+ * @param [in] shadow   Shadow state
+ * @param [in] context  Radio context
+ * @param [in] item     Configuration item (RAL_CFG_SHADOW_*)
+ * @param [in] stored   Shadowed value
+ * @param [in] value    Value to apply
+ * @param [in] size     Size of the value
+ *
+ * @returns true if the write can be skipped
+ */
+static inline bool ral_cfg_shadow_match( const ral_cfg_shadow_t* shadow, const void* context, const uint8_t item,
+                                         const void* stored, const void* value, const size_t size )
+{
+    return ( shadow->context == context ) && ( ( shadow->valid_items & item ) != 0 ) &&
+           ( memcmp( stored, value, size ) == 0 );
+}
+
+/**
+ * @brief Store an applied configuration item, or invalidate it if it was not applied
+ *
+ * @param [in,out] shadow      Shadow state
+ * @param [in]     context     Radio context
+ * @param [in]     item        Configuration item (RAL_CFG_SHADOW_*)
+ * @param [out]    stored      Shadowed value
+ * @param [in]     value       Applied value
+ * @param [in]     size        Size of the value
+ * @param [in]     is_applied  Write status of the item
+ */
+static inline void ral_cfg_shadow_store( ral_cfg_shadow_t* shadow, const void* context, const uint8_t item,
+                                         void* stored, const void* value, const size_t size, const bool is_applied )
+{
+    if( shadow->context != context )
+    {
+        shadow->context     = context;
+        shadow->valid_items = 0;
+    }
+
+    if( is_applied == true )
+    {
+        memcpy( stored, value, size );
+        shadow->valid_items |= item;
+    }
+    else
+    {
+        shadow->valid_items &= ~item;
+    }
+}
+
+/**
+ * @brief Invalidate configuration items, the next writes of these items are always sent
+ *
+ * @param [in,out] shadow   Shadow state
+ * @param [in]     context  Radio context
+ * @param [in]     items    Configuration items (RAL_CFG_SHADOW_*)
+ */
+static inline void ral_cfg_shadow_invalidate( ral_cfg_shadow_t* shadow, const void* context, const uint8_t items )
+{
+    if( shadow->context == context )
+    {
+        shadow->valid_items &= ~items;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RAL_CFG_SHADOW_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -153,6 +153,11 @@ typedef ral_status_t ( *ral_handle_rx_done_f )( const void* radio );
 typedef ral_status_t ( *ral_handle_tx_done_f )( const void* radio );
 typedef ral_status_t ( *ral_get_lora_cad_det_peak_f )( const void* radio, ral_lora_sf_t sf, ral_lora_bw_t bw,
                                                        ral_lora_cad_symbs_t nb_symbol, uint8_t* cad_det_peak );
+typedef ral_status_t ( *ral_batch_begin_f )( const void* context );
+typedef ral_status_t ( *ral_batch_commit_f )( const void* context );
+typedef ral_status_t ( *ral_invalidate_cfg_shadow_f )( const void* context );
+typedef ral_status_t ( *ral_get_continuous_rx_pkt_payload_f )( const void* context, uint16_t max_size_in_bytes,
+                                                               uint8_t* buffer, uint16_t* size_in_bytes );
 typedef struct ral_drv_s
 {
     ral_handles_part_f                   handles_part;
@@ -219,6 +224,10 @@ typedef struct ral_drv_s
     ral_handle_rx_done_f                 handle_rx_done;
     ral_handle_tx_done_f                 handle_tx_done;
     ral_get_lora_cad_det_peak_f          get_lora_cad_det_peak;
+    ral_batch_begin_f                    batch_begin;
+    ral_batch_commit_f                   batch_commit;
+    ral_invalidate_cfg_shadow_f          invalidate_cfg_shadow;
+    ral_get_continuous_rx_pkt_payload_f  get_continuous_rx_pkt_payload;
 } ral_drv_t;
 
 /*
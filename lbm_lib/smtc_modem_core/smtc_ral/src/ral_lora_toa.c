@@ -0,0 +1,178 @@
+/**
+ * @file      ral_lora_toa.c
+ *
+ * @brief     LoRa time-on-air computed from precomputed symbol tables
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ral_lora_toa.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/**
+ * @brief Number of spreading factors in the tables (SF5 to SF12)
+ */
+#define RAL_LORA_TOA_NB_SF 8
+
+/**
+ * @brief Number of bandwidths in the tables (125, 250 and 500 kHz)
+ */
+#define RAL_LORA_TOA_NB_BW 3
+
+/**
+ * @brief Shift of the bits per symbol reciprocals, exact for any payload of up to 255 bytes
+ */
+#define RAL_LORA_TOA_BITS_RECIPROCAL_SHIFT 20
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/**
+ * @brief Preamble/header costs and payload coding of a spreading factor
+ */
+typedef struct ral_lora_toa_sf_s
+{
+    int8_t   pld_bits_offset;     //!< Payload bits offset of the header symbols
+    uint8_t  nb_cst_symbs;        //!< Sync word, SFD and header block symbols
+    uint8_t  bits_per_block[2];   //!< Payload bits per block of cr + 4 symbols, without/with ldro
+    uint16_t bits_reciprocal[2];  //!< ceil( 2^20 / bits_per_block ), 0 if not supported
+} ral_lora_toa_sf_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static const ral_lora_toa_sf_t ral_lora_toa_sf_table[RAL_LORA_TOA_NB_SF] = {
+    { .pld_bits_offset = -20, .nb_cst_symbs = 14, .bits_per_block = { 20, 0 }, .bits_reciprocal = { 52429, 0 } },
+    { .pld_bits_offset = -24, .nb_cst_symbs = 14, .bits_per_block = { 24, 0 }, .bits_reciprocal = { 43691, 0 } },
+    { .pld_bits_offset = -20, .nb_cst_symbs = 12, .bits_per_block = { 28, 20 }, .bits_reciprocal = { 37450, 52429 } },
+    { .pld_bits_offset = -24, .nb_cst_symbs = 12, .bits_per_block = { 32, 24 }, .bits_reciprocal = { 32768, 43691 } },
+    { .pld_bits_offset = -28, .nb_cst_symbs = 12, .bits_per_block = { 36, 28 }, .bits_reciprocal = { 29128, 37450 } },
+    { .pld_bits_offset = -32, .nb_cst_symbs = 12, .bits_per_block = { 40, 32 }, .bits_reciprocal = { 26215, 32768 } },
+    { .pld_bits_offset = -36, .nb_cst_symbs = 12, .bits_per_block = { 44, 36 }, .bits_reciprocal = { 23832, 29128 } },
+    { .pld_bits_offset = -40, .nb_cst_symbs = 12, .bits_per_block = { 48, 40 }, .bits_reciprocal = { 21846, 26215 } },
+};
+
+/**
+ * @brief Quarter of symbol durations in us, per bandwidth and spreading factor
+ */
+static const uint16_t ral_lora_toa_quarter_symb_in_us[RAL_LORA_TOA_NB_BW][RAL_LORA_TOA_NB_SF] = {
+    { 64, 128, 256, 512, 1024, 2048, 4096, 8192 },  // 125 kHz
+    { 32, 64, 128, 256, 512, 1024, 2048, 4096 },    // 250 kHz
+    { 16, 32, 64, 128, 256, 512, 1024, 2048 },      // 500 kHz
+};
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+bool ral_lora_toa_get_in_us( const ral_lora_pkt_params_t* pkt_p, const ral_lora_mod_params_t* mod_p,
+                             uint32_t* toa_in_us )
+{
+    uint8_t bw_index;
+
+    switch( mod_p->bw )
+    {
+    case RAL_LORA_BW_125_KHZ:
+        bw_index = 0;
+        break;
+    case RAL_LORA_BW_250_KHZ:
+        bw_index = 1;
+        break;
+    case RAL_LORA_BW_500_KHZ:
+        bw_index = 2;
+        break;
+    default:
+        return false;
+    }
+
+    if( ( mod_p->sf < RAL_LORA_SF5 ) || ( mod_p->sf > RAL_LORA_SF12 ) || ( mod_p->cr < RAL_LORA_CR_4_5 ) ||
+        ( mod_p->cr > RAL_LORA_CR_4_8 ) )
+    {
+        return false;
+    }
+
+    const uint8_t            sf_index = mod_p->sf - RAL_LORA_SF5;
+    const ral_lora_toa_sf_t* sf_p     = &ral_lora_toa_sf_table[sf_index];
+    const uint8_t            ldro     = ( mod_p->ldro != 0 ) ? 1 : 0;
+
+    if( sf_p->bits_reciprocal[ldro] == 0 )
+    {
+        return false;
+    }
+
+    const int32_t pld_bits = ( ( int32_t ) pkt_p->pld_len_in_bytes << 3 ) + ( pkt_p->crc_is_on ? 16 : 0 ) +
+                             ( ( pkt_p->header_type == RAL_LORA_PKT_EXPLICIT ) ? 20 : 0 ) + sf_p->pld_bits_offset;
+    uint32_t nb_pld_blocks = 0;
+
+    if( pld_bits > 0 )
+    {
+        // Integral ceil( pld_bits / bits_per_block )
+        nb_pld_blocks = ( ( ( uint32_t ) pld_bits + sf_p->bits_per_block[ldro] - 1 ) * sf_p->bits_reciprocal[ldro] ) >>
+                        RAL_LORA_TOA_BITS_RECIPROCAL_SHIFT;
+    }
+
+    const uint32_t nb_symbs = ( nb_pld_blocks * ( mod_p->cr + 4 ) ) + pkt_p->preamble_len_in_symb + sf_p->nb_cst_symbs;
+
+    // The preamble is followed by 4.25 symbols of sync word and SFD
+    *toa_in_us = ( ( 4 * nb_symbs ) + 1 ) * ral_lora_toa_quarter_symb_in_us[bw_index][sf_index];
+    return true;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,113 @@
+/**
+ * @file      ral_lora_toa.h
+ *
+ * @brief     LoRa time-on-air computed from precomputed symbol tables
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RAL_LORA_TOA_H
+#define RAL_LORA_TOA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ral_defs.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/**
+ * @brief ceil( 2^38 / 1000 ), exact integral division by 1000 of any 32-bit value
+ */
+#define RAL_LORA_TOA_MS_RECIPROCAL 0x10624DD3ULL
+#define RAL_LORA_TOA_MS_RECIPROCAL_SHIFT 38
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Get the time on air in us for LoRa transmission without division
+ *
+ * The symbol durations and the preamble/header costs of the LoRaWAN regional bandwidths (125, 250 and 500 kHz) are
+ * precomputed. The symbol duration being an integral number of us for these bandwidths, the result is exact.
+ *
+ * @param [in]  pkt_p      Pointer to a structure holding the LoRa packet parameters
+ * @param [in]  mod_p      Pointer to a structure holding the LoRa modulation parameters
+ * @param [out] toa_in_us  Time-on-air value in us for LoRa transmission
+ *
+ * @returns True if the parameters are covered by the tables, false if the radio driver shall compute the time on air
+ * (other bandwidths, long interleaved coding rates, low data rate optimization with SF5/SF6)
+ */
+bool ral_lora_toa_get_in_us( const ral_lora_pkt_params_t* pkt_p, const ral_lora_mod_params_t* mod_p,
+                             uint32_t* toa_in_us );
+
+/**
+ * @brief Convert a time on air from us to ms, rounded up like the radio driver formulas
+ *
+ * @param [in] toa_in_us  Time-on-air value in us
+ *
+ * @returns Time-on-air value in ms
+ */
+static inline uint32_t ral_lora_toa_convert_us_to_ms( const uint32_t toa_in_us )
+{
+    // Integral ceil( toa_in_us / 1000 ), toa_in_us is lower than 2^32 - 999 for any packet covered by the tables
+    return ( uint32_t ) ( ( ( uint64_t ) ( toa_in_us + 999 ) * RAL_LORA_TOA_MS_RECIPROCAL ) >>
+                          RAL_LORA_TOA_MS_RECIPROCAL_SHIFT );
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RAL_LORA_TOA_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -46,6 +46,8 @@
 #include "lr11xx_lr_fhss.h"
 #include "ral_lr11xx.h"
 #include "ral_lr11xx_bsp.h"
+#include "ral_cfg_shadow.h"
+#include "ral_lora_toa.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -62,11 +64,34 @@
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
+#if defined( ADD_RAL_CFG_SHADOW )
+/**
+ * @brief Last configuration applied to the radio
+ *
+ * @remark The whole configuration is retained in sleep with retention
+ */
+typedef struct ral_lr11xx_cfg_shadow_s
+{
+    ral_cfg_shadow_t                      state;
+    lr11xx_radio_pkt_type_t               pkt_type;
+    uint32_t                              rf_freq_in_hz;
+    lr11xx_radio_mod_params_lora_t        lora_mod_params;
+    lr11xx_radio_pkt_params_lora_t        lora_pkt_params;
+    uint8_t                               lora_sync_word;
+    ral_lr11xx_bsp_tx_cfg_output_params_t tx_cfg;
+    uint16_t                              cal_img_in_mhz[2];
+} ral_lr11xx_cfg_shadow_t;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+#if defined( ADD_RAL_CFG_SHADOW )
+static ral_lr11xx_cfg_shadow_t ral_lr11xx_cfg_shadow = { 0 };
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -166,6 +191,9 @@ bool ral_lr11xx_handles_part( const char* part_number )
 
 ral_status_t ral_lr11xx_reset( const void* context )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
     return ( ral_status_t ) lr11xx_system_reset( context );
 }
 
@@ -180,6 +208,10 @@ ral_status_t ral_lr11xx_init( const void* context )
     uint32_t                            startup_time_in_tick = 0;
     bool                                rx_boost_is_activated;
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
+
     ral_lr11xx_bsp_get_crc_state( context, &crc_is_activated );
     if( crc_is_activated == true )
     {
@@ -260,6 +292,13 @@ ral_status_t ral_lr11xx_set_sleep( const void* context, const bool retain_config
         }
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( retain_config == false )
+    {
+        ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+    }
+#endif
+
     return ( ral_status_t ) lr11xx_system_set_sleep( context, radio_sleep_cfg, 0 );
 }
 
@@ -381,20 +420,50 @@ ral_status_t ral_lr11xx_set_tx_infinite_preamble( const void* context )
 
 ral_status_t ral_lr11xx_cal_img( const void* context, const uint16_t freq1_in_mhz, const uint16_t freq2_in_mhz )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    const uint16_t cal_img_in_mhz[2] = { freq1_in_mhz, freq2_in_mhz };
+
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_CAL_IMG,
+                              ral_lr11xx_cfg_shadow.cal_img_in_mhz, cal_img_in_mhz, sizeof( cal_img_in_mhz ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_CAL_IMG );
+
+    const ral_status_t status =
+        ( ral_status_t ) lr11xx_system_calibrate_image_in_mhz( context, freq1_in_mhz, freq2_in_mhz );
+
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_CAL_IMG,
+                          ral_lr11xx_cfg_shadow.cal_img_in_mhz, cal_img_in_mhz, sizeof( cal_img_in_mhz ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) lr11xx_system_calibrate_image_in_mhz( context, freq1_in_mhz, freq2_in_mhz );
+#endif
 }
 
 ral_status_t ral_lr11xx_set_tx_cfg( const void* context, const int8_t output_pwr_in_dbm, const uint32_t rf_freq_in_hz )
 {
-    ral_status_t                               status = RAL_STATUS_ERROR;
-    ral_lr11xx_bsp_tx_cfg_output_params_t      tx_cfg_output_params;
-    const ral_lr11xx_bsp_tx_cfg_input_params_t tx_cfg_input_params = {
+    ral_status_t                               status               = RAL_STATUS_ERROR;
+    ral_lr11xx_bsp_tx_cfg_output_params_t      tx_cfg_output_params = { 0 };
+    const ral_lr11xx_bsp_tx_cfg_input_params_t tx_cfg_input_params  = {
         .freq_in_hz               = rf_freq_in_hz,
         .system_output_pwr_in_dbm = output_pwr_in_dbm,
     };
 
     ral_lr11xx_bsp_get_tx_cfg( context, &tx_cfg_input_params, &tx_cfg_output_params );
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_TX_CFG,
+                              &ral_lr11xx_cfg_shadow.tx_cfg, &tx_cfg_output_params,
+                              sizeof( tx_cfg_output_params ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+    // Invalidated until the whole configuration is applied
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_TX_CFG );
+#endif
+
     status = ( ral_status_t ) lr11xx_radio_set_pa_cfg( context, &tx_cfg_output_params.pa_cfg );
     if( status != RAL_STATUS_OK )
     {
@@ -408,6 +477,11 @@ ral_status_t ral_lr11xx_set_tx_cfg( const void* context, const int8_t output_pwr
         return status;
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_TX_CFG, &ral_lr11xx_cfg_shadow.tx_cfg,
+                          &tx_cfg_output_params, sizeof( tx_cfg_output_params ), true );
+#endif
+
     return status;
 }
 
@@ -500,6 +574,16 @@ ral_status_t ral_lr11xx_set_rf_freq( const void* context, const uint32_t freq_in
     ral_status_t                          status = RAL_STATUS_ERROR;
     lr11xx_radio_rssi_calibration_table_t rssi_calibration_table;
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    // The rssi calibration table only depends on the frequency
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_RF_FREQ,
+                              &ral_lr11xx_cfg_shadow.rf_freq_in_hz, &freq_in_hz, sizeof( freq_in_hz ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_RF_FREQ );
+#endif
+
     status = ( ral_status_t ) lr11xx_radio_set_rf_freq( context, freq_in_hz );
     if( status != RAL_STATUS_OK )
     {
@@ -514,6 +598,11 @@ ral_status_t ral_lr11xx_set_rf_freq( const void* context, const uint32_t freq_in
         return status;
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_RF_FREQ,
+                          &ral_lr11xx_cfg_shadow.rf_freq_in_hz, &freq_in_hz, sizeof( freq_in_hz ), true );
+#endif
+
     return status;
 }
 
@@ -539,7 +628,25 @@ ral_status_t ral_lr11xx_set_pkt_type( const void* context, const ral_pkt_type_t
     }
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_PKT_TYPE,
+                              &ral_lr11xx_cfg_shadow.pkt_type, &radio_pkt_type, sizeof( radio_pkt_type ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    // The modulation, packet parameters and sync word shall be applied again after a packet type change
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_PKT_TYPE_DEPENDENT );
+
+    const ral_status_t status = ( ral_status_t ) lr11xx_radio_set_pkt_type( context, radio_pkt_type );
+
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_PKT_TYPE,
+                          &ral_lr11xx_cfg_shadow.pkt_type, &radio_pkt_type, sizeof( radio_pkt_type ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) lr11xx_radio_set_pkt_type( context, radio_pkt_type );
+#endif
 }
 
 ral_status_t ral_lr11xx_get_pkt_type( const void* context, ral_pkt_type_t* pkt_type )
@@ -608,8 +715,8 @@ ral_status_t ral_lr11xx_set_gfsk_pkt_address( const void* context, const uint8_t
 
 ral_status_t ral_lr11xx_set_lora_mod_params( const void* context, const ral_lora_mod_params_t* ral_mod_params )
 {
-    ral_status_t                   status = RAL_STATUS_ERROR;
-    lr11xx_radio_mod_params_lora_t radio_mod_params;
+    ral_status_t                   status           = RAL_STATUS_ERROR;
+    lr11xx_radio_mod_params_lora_t radio_mod_params = { 0 };
 
     status = ral_lr11xx_convert_lora_mod_params_from_ral( ral_mod_params, &radio_mod_params );
     if( status != RAL_STATUS_OK )
@@ -617,7 +724,23 @@ ral_status_t ral_lr11xx_set_lora_mod_params( const void* context, const ral_lora
         return status;
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_MOD_PARAMS,
+                              &ral_lr11xx_cfg_shadow.lora_mod_params, &radio_mod_params,
+                              sizeof( radio_mod_params ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    status = ( ral_status_t ) lr11xx_radio_set_lora_mod_params( context, &radio_mod_params );
+
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_MOD_PARAMS,
+                          &ral_lr11xx_cfg_shadow.lora_mod_params, &radio_mod_params, sizeof( radio_mod_params ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) lr11xx_radio_set_lora_mod_params( context, &radio_mod_params );
+#endif
 }
 
 ral_status_t ral_lr11xx_set_lora_pkt_params( const void* context, const ral_lora_pkt_params_t* ral_pkt_params )
@@ -631,7 +754,23 @@ ral_status_t ral_lr11xx_set_lora_pkt_params( const void* context, const ral_lora
         return status;
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_PKT_PARAMS,
+                              &ral_lr11xx_cfg_shadow.lora_pkt_params, &radio_pkt_params,
+                              sizeof( radio_pkt_params ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    status = ( ral_status_t ) lr11xx_radio_set_lora_pkt_params( context, &radio_pkt_params );
+
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_PKT_PARAMS,
+                          &ral_lr11xx_cfg_shadow.lora_pkt_params, &radio_pkt_params, sizeof( radio_pkt_params ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) lr11xx_radio_set_lora_pkt_params( context, &radio_pkt_params );
+#endif
 }
 
 ral_status_t ral_lr11xx_set_lora_cad_params( const void* context, const ral_lora_cad_params_t* ral_lora_cad_params )
@@ -724,6 +863,19 @@ ral_status_t ral_lr11xx_get_rssi_inst( const void* context, int16_t* rssi_in_dbm
 
 uint32_t ral_lr11xx_get_lora_time_on_air_in_ms( const ral_lora_pkt_params_t* pkt_p, const ral_lora_mod_params_t* mod_p )
 {
+#if defined( ADD_RAL_LORA_TOA_TABLE )
+    uint32_t toa_in_us = 0;
+
+    if( ral_lora_toa_get_in_us( pkt_p, mod_p, &toa_in_us ) == true )
+    {
+        // The lr11xx driver formula removes one period of the bandwidth (8, 4 or 2 us) from the time on air
+        const uint32_t bw_period_in_us =
+            ( mod_p->bw == RAL_LORA_BW_125_KHZ ) ? 8 : ( ( mod_p->bw == RAL_LORA_BW_250_KHZ ) ? 4 : 2 );
+
+        return ral_lora_toa_convert_us_to_ms( toa_in_us - bw_period_in_us );
+    }
+#endif
+
     lr11xx_radio_mod_params_lora_t radio_mod_params;
     lr11xx_radio_pkt_params_lora_t radio_pkt_params;
 
@@ -763,7 +915,22 @@ ral_status_t ral_lr11xx_set_gfsk_sync_word( const void* context, const uint8_t*
 
 ral_status_t ral_lr11xx_set_lora_sync_word( const void* context, const uint8_t sync_word )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_SYNC_WORD,
+                              &ral_lr11xx_cfg_shadow.lora_sync_word, &sync_word, sizeof( sync_word ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    const ral_status_t status = ( ral_status_t ) lr11xx_radio_set_lora_sync_word( context, sync_word );
+
+    ral_cfg_shadow_store( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_SYNC_WORD,
+                          &ral_lr11xx_cfg_shadow.lora_sync_word, &sync_word, sizeof( sync_word ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) lr11xx_radio_set_lora_sync_word( context, sync_word );
+#endif
 }
 
 ral_status_t ral_lr11xx_set_flrc_sync_word( const void* context, const uint8_t* sync_word, const uint8_t sync_word_len )
@@ -789,6 +956,10 @@ ral_status_t ral_lr11xx_set_gfsk_whitening_seed( const void* context, const uint
 ral_status_t ral_lr11xx_lr_fhss_init( const void* context, const ral_lr_fhss_params_t* lr_fhss_params )
 {
     ( void ) lr_fhss_params;  // Unused parameter
+#if defined( ADD_RAL_CFG_SHADOW )
+    // LR-FHSS sets its own packet type and modulation parameters then hops over frequencies
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
     return ( ral_status_t ) lr11xx_lr_fhss_init( context );
 }
 
@@ -801,6 +972,10 @@ ral_status_t ral_lr11xx_lr_fhss_build_frame( const void* context, const ral_lr_f
     lr11xx_lr_fhss_params_t lr11xx_params;
     ral_lr11xx_convert_lr_fhss_params_from_ral( lr_fhss_params, &lr11xx_params );
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
+
     lr11xx_status_t status = lr11xx_radio_set_rf_freq( context, lr_fhss_params->center_frequency_in_hz );
     if( status != LR11XX_STATUS_OK )
     {
@@ -1052,6 +1227,16 @@ ral_status_t ral_lr11xx_get_lora_cad_det_peak( const void* context, ral_lora_sf_
     return RAL_STATUS_OK;
 }
 
+ral_status_t ral_lr11xx_invalidate_cfg_shadow( const void* context )
+{
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_lr11xx_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+    return RAL_STATUS_OK;
+#else
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#endif
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
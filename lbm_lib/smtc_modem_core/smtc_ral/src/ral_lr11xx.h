@@ -93,13 +93,21 @@ extern "C" {
         .get_gfsk_rx_consumption_in_ua  = ral_lr11xx_get_gfsk_rx_consumption_in_ua,                                   \
         .get_lora_rx_consumption_in_ua  = ral_lr11xx_get_lora_rx_consumption_in_ua,                                   \
         .get_random_numbers = ral_lr11xx_get_random_numbers, .handle_rx_done = ral_lr11xx_handle_rx_done,             \
-        .handle_tx_done = ral_lr11xx_handle_tx_done, .get_lora_cad_det_peak = ral_lr11xx_get_lora_cad_det_peak        \
+        .handle_tx_done = ral_lr11xx_handle_tx_done, .get_lora_cad_det_peak = ral_lr11xx_get_lora_cad_det_peak,       \
+        .invalidate_cfg_shadow = ral_lr11xx_invalidate_cfg_shadow                                                     \
     }
 
+#if defined( RAL_STATIC_DRIVER )
+#define RAL_LR11XX_INSTANTIATE( ctx ) \
+    {                                 \
+        .context = ctx,               \
+    }
+#else
 #define RAL_LR11XX_INSTANTIATE( ctx )                         \
     {                                                         \
         .context = ctx, .driver = RAL_LR11XX_DRV_INSTANTIATE, \
     }
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -453,6 +461,12 @@ ral_status_t ral_lr11xx_handle_tx_done( const void* context );
  */
 ral_status_t ral_lr11xx_get_lora_cad_det_peak( const void* context, ral_lora_sf_t sf, ral_lora_bw_t bw,
                                                ral_lora_cad_symbs_t nb_symbol, uint8_t* cad_det_peak );
+
+/**
+ * @see ral_invalidate_cfg_shadow
+ */
+ral_status_t ral_lr11xx_invalidate_cfg_shadow( const void* context );
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,8 @@
 #include "sx126x_lr_fhss.h"
 #include "ral_sx126x.h"
 #include "ral_sx126x_bsp.h"
+#include "ral_cfg_shadow.h"
+#include "ral_lora_toa.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -60,11 +62,50 @@
  * --- PRIVATE TYPES -----------------------------------------------------------
  */
 
+#if defined( ADD_RAL_CFG_SHADOW )
+/**
+ * @brief Tx configuration applied by ral_sx126x_set_tx_cfg
+ */
+typedef struct ral_sx126x_tx_cfg_s
+{
+    ral_sx126x_bsp_tx_cfg_output_params_t output_params;
+    uint8_t                               ocp_in_step_of_2_5_ma;
+} ral_sx126x_tx_cfg_t;
+
+/**
+ * @brief Last configuration applied to the radio
+ *
+ * @remark Commands configuration is retained in warm sleep, register based items (sync word, tx clamp and ocp) are
+ * invalidated on any sleep
+ */
+typedef struct ral_sx126x_cfg_shadow_s
+{
+    ral_cfg_shadow_t         state;
+    sx126x_pkt_type_t        pkt_type;
+    uint32_t                 rf_freq_in_hz;
+    sx126x_mod_params_lora_t lora_mod_params;
+    sx126x_pkt_params_lora_t lora_pkt_params;
+    uint8_t                  lora_sync_word;
+    ral_sx126x_tx_cfg_t      tx_cfg;
+    uint16_t                 cal_img_in_mhz[2];
+} ral_sx126x_cfg_shadow_t;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE VARIABLES -------------------------------------------------------
  */
 
+#if defined( ADD_RAL_CFG_SHADOW )
+static ral_sx126x_cfg_shadow_t ral_sx126x_cfg_shadow = { 0 };
+#endif
+
+#if defined( ADD_LR_FHSS_HOP_TABLE )
+// Hops of the LR-FHSS frame being sent, precomputed when the frame is built
+static sx126x_lr_fhss_hop_table_t ral_sx126x_lr_fhss_hop_table;
+static bool                       ral_sx126x_lr_fhss_hop_table_valid = false;
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
@@ -186,6 +227,9 @@ bool ral_sx126x_handles_part( const char* part_number )
 
 ral_status_t ral_sx126x_reset( const void* context )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
     return ( ral_status_t ) sx126x_reset( context );
 }
 
@@ -199,6 +243,10 @@ ral_status_t ral_sx126x_init( const void* context )
     uint32_t                    startup_time_in_tick = 0;
     bool                        rx_boost_is_activated;
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
+
     status = ( ral_status_t ) sx126x_init_retention_list( context );
     if( status != RAL_STATUS_OK )
     {
@@ -255,6 +303,12 @@ ral_status_t ral_sx126x_set_sleep( const void* context, const bool retain_config
     const sx126x_sleep_cfgs_t radio_sleep_cfg =
         ( retain_config == true ) ? SX126X_SLEEP_CFG_WARM_START : SX126X_SLEEP_CFG_COLD_START;
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context,
+                               ( retain_config == true ) ? ( RAL_CFG_SHADOW_LORA_SYNC_WORD | RAL_CFG_SHADOW_TX_CFG )
+                                                         : RAL_CFG_SHADOW_ALL );
+#endif
+
     return ( ral_status_t ) sx126x_set_sleep( context, radio_sleep_cfg );
 }
 
@@ -409,20 +463,56 @@ ral_status_t ral_sx126x_set_tx_infinite_preamble( const void* context )
 
 ral_status_t ral_sx126x_cal_img( const void* context, const uint16_t freq1_in_mhz, const uint16_t freq2_in_mhz )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    const uint16_t cal_img_in_mhz[2] = { freq1_in_mhz, freq2_in_mhz };
+
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_CAL_IMG,
+                              ral_sx126x_cfg_shadow.cal_img_in_mhz, cal_img_in_mhz, sizeof( cal_img_in_mhz ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_CAL_IMG );
+
+    const ral_status_t status = ( ral_status_t ) sx126x_cal_img_in_mhz( context, freq1_in_mhz, freq2_in_mhz );
+
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_CAL_IMG,
+                          ral_sx126x_cfg_shadow.cal_img_in_mhz, cal_img_in_mhz, sizeof( cal_img_in_mhz ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) sx126x_cal_img_in_mhz( context, freq1_in_mhz, freq2_in_mhz );
+#endif
 }
 
 ral_status_t ral_sx126x_set_tx_cfg( const void* context, const int8_t output_pwr_in_dbm, const uint32_t rf_freq_in_hz )
 {
-    ral_status_t                               status = RAL_STATUS_ERROR;
-    ral_sx126x_bsp_tx_cfg_output_params_t      tx_cfg_output_params;
-    const ral_sx126x_bsp_tx_cfg_input_params_t tx_cfg_input_params = {
+    ral_status_t                               status               = RAL_STATUS_ERROR;
+    ral_sx126x_bsp_tx_cfg_output_params_t      tx_cfg_output_params = { 0 };
+    const ral_sx126x_bsp_tx_cfg_input_params_t tx_cfg_input_params  = {
         .freq_in_hz               = rf_freq_in_hz,
         .system_output_pwr_in_dbm = output_pwr_in_dbm,
     };
 
     ral_sx126x_bsp_get_tx_cfg( context, &tx_cfg_input_params, &tx_cfg_output_params );
 
+    uint8_t ocp_in_step_of_2_5_ma = ( tx_cfg_output_params.pa_cfg.device_sel == 0x00 ) ? 0x38 : 0x18;
+
+    ral_sx126x_bsp_get_ocp_value( context, &ocp_in_step_of_2_5_ma );
+
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_sx126x_tx_cfg_t tx_cfg = { 0 };
+
+    memcpy( &tx_cfg.output_params, &tx_cfg_output_params, sizeof( tx_cfg_output_params ) );
+    tx_cfg.ocp_in_step_of_2_5_ma = ocp_in_step_of_2_5_ma;
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_TX_CFG,
+                              &ral_sx126x_cfg_shadow.tx_cfg, &tx_cfg, sizeof( tx_cfg ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+    // Invalidated until the whole configuration is applied
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_TX_CFG );
+#endif
+
     if( tx_cfg_output_params.pa_cfg.device_sel == 0x00 )
     {
         status = ( ral_status_t ) sx126x_cfg_tx_clamp( context );
@@ -438,10 +528,6 @@ ral_status_t ral_sx126x_set_tx_cfg( const void* context, const int8_t output_pwr
         return status;
     }
 
-    uint8_t ocp_in_step_of_2_5_ma = ( tx_cfg_output_params.pa_cfg.device_sel == 0x00 ) ? 0x38 : 0x18;
-
-    ral_sx126x_bsp_get_ocp_value( context, &ocp_in_step_of_2_5_ma );
-
     if( ( ( tx_cfg_output_params.pa_cfg.device_sel == 0x00 ) && ( ocp_in_step_of_2_5_ma != 0x38 ) ) ||
         ( ( tx_cfg_output_params.pa_cfg.device_sel == 0x01 ) && ( ocp_in_step_of_2_5_ma != 0x18 ) ) )
     {
@@ -455,6 +541,11 @@ ral_status_t ral_sx126x_set_tx_cfg( const void* context, const int8_t output_pwr
     status = ( ral_status_t ) sx126x_set_tx_params( context, tx_cfg_output_params.chip_output_pwr_in_dbm_configured,
                                                     tx_cfg_output_params.pa_ramp_time );
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_TX_CFG, &ral_sx126x_cfg_shadow.tx_cfg,
+                          &tx_cfg, sizeof( tx_cfg ), status == RAL_STATUS_OK );
+#endif
+
     return status;
 }
 
@@ -503,6 +594,46 @@ ral_status_t ral_sx126x_get_pkt_payload( const void* context, uint16_t max_size_
     return status;
 }
 
+ral_status_t ral_sx126x_get_continuous_rx_pkt_payload( const void* context, uint16_t max_size_in_bytes,
+                                                       uint8_t* buffer, uint16_t* size_in_bytes )
+{
+    ral_status_t              status = RAL_STATUS_ERROR;
+    sx126x_rx_buffer_status_t radio_rx_buffer_status;
+
+    status = ( ral_status_t ) sx126x_get_rx_buffer_status( context, &radio_rx_buffer_status );
+    if( status != RAL_STATUS_OK )
+    {
+        return status;
+    }
+
+    // The next packet is written after this one in the 256 bytes circular buffer, it only overwrites this one once
+    // more than 256 - length bytes are received
+    status = ( ral_status_t ) sx126x_set_buffer_base_address(
+        context, 0x00,
+        ( uint8_t ) ( radio_rx_buffer_status.buffer_start_pointer + radio_rx_buffer_status.pld_len_in_bytes ) );
+    if( status != RAL_STATUS_OK )
+    {
+        return status;
+    }
+
+    if( size_in_bytes != 0 )
+    {
+        *size_in_bytes = radio_rx_buffer_status.pld_len_in_bytes;
+    }
+
+    if( radio_rx_buffer_status.pld_len_in_bytes <= max_size_in_bytes )
+    {
+        status = ( ral_status_t ) sx126x_read_buffer( context, radio_rx_buffer_status.buffer_start_pointer, buffer,
+                                                      radio_rx_buffer_status.pld_len_in_bytes );
+    }
+    else
+    {
+        status = RAL_STATUS_ERROR;
+    }
+
+    return status;
+}
+
 ral_status_t ral_sx126x_get_irq_status( const void* context, ral_irq_t* irq )
 {
     ral_status_t      status          = RAL_STATUS_ERROR;
@@ -555,7 +686,22 @@ ral_status_t ral_sx126x_set_dio_irq_params( const void* context, const ral_irq_t
 
 ral_status_t ral_sx126x_set_rf_freq( const void* context, const uint32_t freq_in_hz )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_RF_FREQ,
+                              &ral_sx126x_cfg_shadow.rf_freq_in_hz, &freq_in_hz, sizeof( freq_in_hz ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    const ral_status_t status = ( ral_status_t ) sx126x_set_rf_freq( context, freq_in_hz );
+
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_RF_FREQ,
+                          &ral_sx126x_cfg_shadow.rf_freq_in_hz, &freq_in_hz, sizeof( freq_in_hz ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) sx126x_set_rf_freq( context, freq_in_hz );
+#endif
 }
 
 ral_status_t ral_sx126x_set_pkt_type( const void* context, const ral_pkt_type_t pkt_type )
@@ -580,7 +726,25 @@ ral_status_t ral_sx126x_set_pkt_type( const void* context, const ral_pkt_type_t
     }
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_PKT_TYPE,
+                              &ral_sx126x_cfg_shadow.pkt_type, &radio_pkt_type, sizeof( radio_pkt_type ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    // The modulation, packet parameters and sync word shall be applied again after a packet type change
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_PKT_TYPE_DEPENDENT );
+
+    const ral_status_t status = ( ral_status_t ) sx126x_set_pkt_type( context, radio_pkt_type );
+
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_PKT_TYPE,
+                          &ral_sx126x_cfg_shadow.pkt_type, &radio_pkt_type, sizeof( radio_pkt_type ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) sx126x_set_pkt_type( context, radio_pkt_type );
+#endif
 }
 
 ral_status_t ral_sx126x_get_pkt_type( const void* context, ral_pkt_type_t* pkt_type )
@@ -649,8 +813,8 @@ ral_status_t ral_sx126x_set_gfsk_pkt_address( const void* context, const uint8_t
 
 ral_status_t ral_sx126x_set_lora_mod_params( const void* context, const ral_lora_mod_params_t* params )
 {
-    ral_status_t             status = RAL_STATUS_ERROR;
-    sx126x_mod_params_lora_t radio_mod_params;
+    ral_status_t             status           = RAL_STATUS_ERROR;
+    sx126x_mod_params_lora_t radio_mod_params = { 0 };
 
     status = ral_sx126x_convert_lora_mod_params_from_ral( params, &radio_mod_params );
     if( status != RAL_STATUS_OK )
@@ -658,7 +822,23 @@ ral_status_t ral_sx126x_set_lora_mod_params( const void* context, const ral_lora
         return status;
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_MOD_PARAMS,
+                              &ral_sx126x_cfg_shadow.lora_mod_params, &radio_mod_params,
+                              sizeof( radio_mod_params ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    status = ( ral_status_t ) sx126x_set_lora_mod_params( context, &radio_mod_params );
+
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_MOD_PARAMS,
+                          &ral_sx126x_cfg_shadow.lora_mod_params, &radio_mod_params, sizeof( radio_mod_params ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) sx126x_set_lora_mod_params( context, &radio_mod_params );
+#endif
 }
 
 ral_status_t ral_sx126x_set_lora_pkt_params( const void* context, const ral_lora_pkt_params_t* params )
@@ -672,7 +852,23 @@ ral_status_t ral_sx126x_set_lora_pkt_params( const void* context, const ral_lora
         return status;
     }
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_PKT_PARAMS,
+                              &ral_sx126x_cfg_shadow.lora_pkt_params, &radio_pkt_params,
+                              sizeof( radio_pkt_params ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    status = ( ral_status_t ) sx126x_set_lora_pkt_params( context, &radio_pkt_params );
+
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_PKT_PARAMS,
+                          &ral_sx126x_cfg_shadow.lora_pkt_params, &radio_pkt_params, sizeof( radio_pkt_params ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) sx126x_set_lora_pkt_params( context, &radio_pkt_params );
+#endif
 }
 
 ral_status_t ral_sx126x_set_lora_cad_params( const void* context, const ral_lora_cad_params_t* params )
@@ -767,6 +963,15 @@ ral_status_t ral_sx126x_get_rssi_inst( const void* context, int16_t* rssi_in_dbm
 
 uint32_t ral_sx126x_get_lora_time_on_air_in_ms( const ral_lora_pkt_params_t* pkt_p, const ral_lora_mod_params_t* mod_p )
 {
+#if defined( ADD_RAL_LORA_TOA_TABLE )
+    uint32_t toa_in_us = 0;
+
+    if( ral_lora_toa_get_in_us( pkt_p, mod_p, &toa_in_us ) == true )
+    {
+        return ral_lora_toa_convert_us_to_ms( toa_in_us );
+    }
+#endif
+
     sx126x_mod_params_lora_t radio_mod_params;
     sx126x_pkt_params_lora_t radio_pkt_params;
 
@@ -799,7 +1004,22 @@ ral_status_t ral_sx126x_set_gfsk_sync_word( const void* context, const uint8_t*
 
 ral_status_t ral_sx126x_set_lora_sync_word( const void* context, const uint8_t sync_word )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    if( ral_cfg_shadow_match( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_SYNC_WORD,
+                              &ral_sx126x_cfg_shadow.lora_sync_word, &sync_word, sizeof( sync_word ) ) == true )
+    {
+        return RAL_STATUS_OK;
+    }
+
+    const ral_status_t status = ( ral_status_t ) sx126x_set_lora_sync_word( context, sync_word );
+
+    ral_cfg_shadow_store( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_LORA_SYNC_WORD,
+                          &ral_sx126x_cfg_shadow.lora_sync_word, &sync_word, sizeof( sync_word ),
+                          status == RAL_STATUS_OK );
+    return status;
+#else
     return ( ral_status_t ) sx126x_set_lora_sync_word( context, sync_word );
+#endif
 }
 
 ral_status_t ral_sx126x_set_flrc_sync_word( const void* context, const uint8_t* sync_word, const uint8_t sync_word_len )
@@ -841,6 +1061,11 @@ ral_status_t ral_sx126x_lr_fhss_init( const void* context, const ral_lr_fhss_par
     sx126x_lr_fhss_params_t sx126x_params;
     ral_sx126x_convert_lr_fhss_params_from_ral( lr_fhss_params, &sx126x_params );
 
+#if defined( ADD_RAL_CFG_SHADOW )
+    // LR-FHSS sets its own packet type, modulation and packet parameters then hops over frequencies
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
+
     return ( ral_status_t ) sx126x_lr_fhss_init( context, &sx126x_params );
 }
 
@@ -851,13 +1076,41 @@ ral_status_t ral_sx126x_lr_fhss_build_frame( const void* context, const ral_lr_f
     sx126x_lr_fhss_params_t sx126x_params;
     ral_sx126x_convert_lr_fhss_params_from_ral( lr_fhss_params, &sx126x_params );
 
+#if defined( ADD_LR_FHSS_HOP_TABLE )
+    ral_sx126x_lr_fhss_hop_table_valid = false;
+
+    sx126x_status_t status = sx126x_lr_fhss_build_frame(
+        context, &sx126x_params, ( sx126x_lr_fhss_state_t* ) state, hop_sequence_id, payload, payload_length, NULL );
+    if( status != SX126X_STATUS_OK )
+    {
+        return ( ral_status_t ) status;
+    }
+
+    // Falls back to computing the hops on the fly if the frame has more hops than the table holds
+    ral_sx126x_lr_fhss_hop_table_valid =
+        ( sx126x_lr_fhss_build_hop_table( &sx126x_params, ( const sx126x_lr_fhss_state_t* ) state,
+                                          &ral_sx126x_lr_fhss_hop_table ) == SX126X_STATUS_OK );
+    return RAL_STATUS_OK;
+#else
     return ( ral_status_t ) sx126x_lr_fhss_build_frame( context, &sx126x_params, ( sx126x_lr_fhss_state_t* ) state,
                                                         hop_sequence_id, payload, payload_length, NULL );
+#endif
 }
 
 ral_status_t ral_sx126x_lr_fhss_handle_hop( const void* context, const ral_lr_fhss_params_t* lr_fhss_params,
                                             ral_lr_fhss_memory_state_t state )
 {
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+#endif
+
+#if defined( ADD_LR_FHSS_HOP_TABLE )
+    if( ral_sx126x_lr_fhss_hop_table_valid == true )
+    {
+        return ( ral_status_t ) sx126x_lr_fhss_handle_hop_from_table( context, &ral_sx126x_lr_fhss_hop_table );
+    }
+#endif
+
     sx126x_lr_fhss_params_t sx126x_params;
     ral_sx126x_convert_lr_fhss_params_from_ral( lr_fhss_params, &sx126x_params );
 
@@ -870,6 +1123,10 @@ ral_status_t ral_sx126x_lr_fhss_handle_tx_done( const void* context, const ral_l
     sx126x_lr_fhss_params_t sx126x_params;
     ral_sx126x_convert_lr_fhss_params_from_ral( lr_fhss_params, &sx126x_params );
 
+#if defined( ADD_LR_FHSS_HOP_TABLE )
+    ral_sx126x_lr_fhss_hop_table_valid = false;
+#endif
+
     return ( ral_status_t ) sx126x_lr_fhss_handle_tx_done( context, &sx126x_params, ( sx126x_lr_fhss_state_t* ) state );
 }
 
@@ -1077,6 +1334,34 @@ ral_status_t ral_sx126x_get_lora_cad_det_peak( const void* context, ral_lora_sf_
     return RAL_STATUS_OK;
 }
 
+ral_status_t ral_sx126x_invalidate_cfg_shadow( const void* context )
+{
+#if defined( ADD_RAL_CFG_SHADOW )
+    ral_cfg_shadow_invalidate( &ral_sx126x_cfg_shadow.state, context, RAL_CFG_SHADOW_ALL );
+    return RAL_STATUS_OK;
+#else
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#endif
+}
+
+ral_status_t ral_sx126x_batch_begin( const void* context )
+{
+#if defined( ADD_RAL_BATCH )
+    return ( ral_status_t ) sx126x_batch_begin( context );
+#else
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#endif
+}
+
+ral_status_t ral_sx126x_batch_commit( const void* context )
+{
+#if defined( ADD_RAL_BATCH )
+    return ( ral_status_t ) sx126x_batch_commit( context );
+#else
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+#endif
+}
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
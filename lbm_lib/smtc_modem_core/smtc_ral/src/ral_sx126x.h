@@ -93,13 +93,23 @@ extern "C" {
         .get_gfsk_rx_consumption_in_ua  = ral_sx126x_get_gfsk_rx_consumption_in_ua,                                   \
         .get_lora_rx_consumption_in_ua  = ral_sx126x_get_lora_rx_consumption_in_ua,                                   \
         .get_random_numbers = ral_sx126x_get_random_numbers, .handle_rx_done = ral_sx126x_handle_rx_done,             \
-        .handle_tx_done = ral_sx126x_handle_tx_done, .get_lora_cad_det_peak = ral_sx126x_get_lora_cad_det_peak        \
+        .handle_tx_done = ral_sx126x_handle_tx_done, .get_lora_cad_det_peak = ral_sx126x_get_lora_cad_det_peak,       \
+        .batch_begin = ral_sx126x_batch_begin, .batch_commit = ral_sx126x_batch_commit,                               \
+        .invalidate_cfg_shadow         = ral_sx126x_invalidate_cfg_shadow,                                            \
+        .get_continuous_rx_pkt_payload = ral_sx126x_get_continuous_rx_pkt_payload                                     \
     }
 
+#if defined( RAL_STATIC_DRIVER )
+#define RAL_SX126X_INSTANTIATE( ctx ) \
+    {                                 \
+        .context = ctx,               \
+    }
+#else
 #define RAL_SX126X_INSTANTIATE( ctx )                         \
     {                                                         \
         .context = ctx, .driver = RAL_SX126X_DRV_INSTANTIATE, \
     }
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -238,6 +248,12 @@ ral_status_t ral_sx126x_set_pkt_payload( const void* context, const uint8_t* buf
 ral_status_t ral_sx126x_get_pkt_payload( const void* context, uint16_t max_size_in_bytes, uint8_t* buffer,
                                          uint16_t* size_in_bytes );
 
+/**
+ * @see ral_get_continuous_rx_pkt_payload
+ */
+ral_status_t ral_sx126x_get_continuous_rx_pkt_payload( const void* context, uint16_t max_size_in_bytes,
+                                                       uint8_t* buffer, uint16_t* size_in_bytes );
+
 /**
  * @see ral_get_irq_status
  */
@@ -478,6 +494,21 @@ ral_status_t ral_sx126x_handle_tx_done( const void* context );
 ral_status_t ral_sx126x_get_lora_cad_det_peak( const void* context, ral_lora_sf_t sf, ral_lora_bw_t bw,
                                                ral_lora_cad_symbs_t nb_symbol, uint8_t* cad_det_peak );
 
+/**
+ * @see ral_invalidate_cfg_shadow
+ */
+ral_status_t ral_sx126x_invalidate_cfg_shadow( const void* context );
+
+/**
+ * @see ral_batch_begin
+ */
+ral_status_t ral_sx126x_batch_begin( const void* context );
+
+/**
+ * @see ral_batch_commit
+ */
+ral_status_t ral_sx126x_batch_commit( const void* context );
+
 #ifdef __cplusplus
 }
 #endif
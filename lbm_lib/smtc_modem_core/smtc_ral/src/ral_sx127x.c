@@ -43,6 +43,7 @@
 #include "sx127x.h"
 #include "ral_sx127x.h"
 #include "ral_sx127x_bsp.h"
+#include "ral_lora_toa.h"
 
 /*
  * -----------------------------------------------------------------------------
@@ -553,6 +554,15 @@ ral_status_t ral_sx127x_get_rssi_inst( const void* context, int16_t* rssi_in_dbm
 
 uint32_t ral_sx127x_get_lora_time_on_air_in_ms( const ral_lora_pkt_params_t* pkt_p, const ral_lora_mod_params_t* mod_p )
 {
+#if defined( ADD_RAL_LORA_TOA_TABLE )
+    uint32_t toa_in_us = 0;
+
+    if( ral_lora_toa_get_in_us( pkt_p, mod_p, &toa_in_us ) == true )
+    {
+        return ral_lora_toa_convert_us_to_ms( toa_in_us );
+    }
+#endif
+
     sx127x_lora_mod_params_t radio_mod_params = { 0 };
     sx127x_lora_pkt_params_t radio_pkt_params = { 0 };
 
@@ -96,10 +96,17 @@ extern "C" {
         .handle_tx_done = ral_sx128x_handle_tx_done, .get_lora_cad_det_peak = ral_sx128x_get_lora_cad_det_peak        \
     }
 
+#if defined( RAL_STATIC_DRIVER )
+#define RAL_SX128X_INSTANTIATE( ctx ) \
+    {                                 \
+        .context = ctx,               \
+    }
+#else
 #define RAL_SX128X_INSTANTIATE( ctx )                         \
     {                                                         \
         .context = ctx, .driver = RAL_SX128X_DRV_INSTANTIATE, \
     }
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -0,0 +1,919 @@
+/**
+ * @file      ral_virtual.c
+ *
+ * @brief     Radio abstraction layer implementation of a simulated radio, for host builds
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ral_virtual.h"
+#include "ral_virtual_bsp.h"
+#include "ral_lora_toa.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+/**
+ * @brief RSSI measured on a free channel
+ */
+#define RAL_VIRTUAL_NOISE_FLOOR_IN_DBM ( -120 )
+
+/**
+ * @brief Consumptions of a SX1262 with DC-DC, used for the modem energy statistics
+ */
+#define RAL_VIRTUAL_TX_LP_CONSUMPTION_IN_UA 45000   // up to 14 dBm
+#define RAL_VIRTUAL_TX_HP_CONSUMPTION_IN_UA 118000  // up to 22 dBm
+#define RAL_VIRTUAL_RX_CONSUMPTION_IN_UA 4600
+#define RAL_VIRTUAL_RX_BOOSTED_CONSUMPTION_IN_UA 5300
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Get the bandwidth in Hz of a LoRa bandwidth enumerate
+ *
+ * @param [in] bw  LoRa bandwidth
+ *
+ * @returns Bandwidth in Hz
+ */
+static uint32_t ral_virtual_get_lora_bw_in_hz( ral_lora_bw_t bw );
+
+/**
+ * @brief Get the duration of a LoRa symbol
+ *
+ * @param [in] mod_p  LoRa modulation parameters
+ *
+ * @returns Symbol duration in us
+ */
+static uint32_t ral_virtual_get_lora_symb_time_in_us( const ral_lora_mod_params_t* mod_p );
+
+/**
+ * @brief Get the time on air of a LoRa frame, with the tables of @ref ral_lora_toa_get_in_us when they cover the
+ * parameters
+ *
+ * @param [in] pkt_p  LoRa packet parameters
+ * @param [in] mod_p  LoRa modulation parameters
+ *
+ * @returns Time on air in us
+ */
+static uint32_t ral_virtual_get_lora_toa_in_us( const ral_lora_pkt_params_t* pkt_p,
+                                                const ral_lora_mod_params_t* mod_p );
+
+/**
+ * @brief Get the time on air of a GFSK frame
+ *
+ * @param [in] pkt_p  GFSK packet parameters
+ * @param [in] mod_p  GFSK modulation parameters
+ *
+ * @returns Time on air in us
+ */
+static uint32_t ral_virtual_get_gfsk_toa_in_us( const ral_gfsk_pkt_params_t* pkt_p,
+                                                const ral_gfsk_mod_params_t* mod_p );
+
+/**
+ * @brief Get the time on air of a frame sent with the current radio configuration
+ *
+ * @param [in] radio  Virtual radio context
+ * @param [in] size   Frame size
+ *
+ * @returns Time on air in us
+ */
+static uint32_t ral_virtual_get_toa_in_us( const ral_virtual_t* radio, uint16_t size );
+
+/**
+ * @brief Enter a mode and schedule its end
+ *
+ * @param [in] radio        Virtual radio context
+ * @param [in] mode         New mode
+ * @param [in] irq          Interrupts raised at the end of the operation
+ * @param [in] duration_us  Duration of the operation, 0 for an operation without end
+ */
+static void ral_virtual_start_operation( ral_virtual_t* radio, ral_virtual_mode_t mode, ral_irq_t irq,
+                                         uint32_t duration_us );
+
+/**
+ * @brief Abort the current operation
+ *
+ * @param [in] radio  Virtual radio context
+ * @param [in] mode   New mode
+ */
+static void ral_virtual_stop_operation( ral_virtual_t* radio, ral_virtual_mode_t mode );
+
+/**
+ * @brief Draw a random number, xorshift32
+ *
+ * @param [in] radio  Virtual radio context
+ *
+ * @returns Random number
+ */
+static uint32_t ral_virtual_rand( ral_virtual_t* radio );
+
+/**
+ * @brief Describe the frame being sent, with the radio settings
+ *
+ * @param [in]  radio  Virtual radio context
+ * @param [out] frame  Sent frame
+ */
+static void ral_virtual_get_tx_frame( const ral_virtual_t* radio, ral_virtual_frame_t* frame );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+bool ral_virtual_on_irq_timer( const void* context )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    switch( radio->mode )
+    {
+    case RAL_VIRTUAL_MODE_TX:
+    {
+        ral_virtual_frame_t frame;
+
+        ral_virtual_get_tx_frame( radio, &frame );
+        radio->nb_tx++;
+        radio->tx_time_in_us += frame.toa_in_us;
+        ral_virtual_bsp_on_tx_done( context, &frame );
+        break;
+    }
+    case RAL_VIRTUAL_MODE_RX:
+        if( ( radio->irq_pending & RAL_IRQ_RX_DONE ) != 0 )
+        {
+            memcpy( radio->buffer, radio->rx_frame.payload, radio->rx_frame.size );
+            radio->buffer_size      = radio->rx_frame.size;
+            radio->last_rssi_in_dbm = radio->rx_frame.rssi_in_dbm;
+            radio->last_snr_in_db   = radio->rx_frame.snr_in_db;
+            radio->rx_frame_pending = false;
+            radio->nb_rx_done++;
+        }
+        else
+        {
+            radio->nb_rx_timeout++;
+        }
+        break;
+    case RAL_VIRTUAL_MODE_CAD:
+        radio->nb_cad++;
+        break;
+    default:
+        // Operation already aborted
+        return false;
+    }
+
+    radio->mode = RAL_VIRTUAL_MODE_STANDBY;
+    radio->irq_status |= radio->irq_pending;
+
+    const bool irq_is_enabled = ( radio->irq_pending & radio->irq_mask ) != 0;
+    radio->irq_pending        = RAL_IRQ_NONE;
+    return irq_is_enabled;
+}
+
+ral_status_t ral_virtual_push_rx_frame( const void* context, ral_pkt_type_t pkt_type, const uint8_t* payload,
+                                        uint16_t size, int16_t rssi_in_dbm, int16_t snr_in_db )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    if( size > RAL_VIRTUAL_MAX_PAYLOAD_SIZE )
+    {
+        return RAL_STATUS_ERROR;
+    }
+
+    radio->rx_frame.pkt_type    = pkt_type;
+    radio->rx_frame.rssi_in_dbm = rssi_in_dbm;
+    radio->rx_frame.snr_in_db   = snr_in_db;
+    radio->rx_frame.size        = size;
+    memcpy( radio->rx_frame.payload, payload, size );
+    radio->rx_frame_pending = true;
+    return RAL_STATUS_OK;
+}
+
+bool ral_virtual_handles_part( const char* part_number )
+{
+    return strcmp( "virtual", part_number ) == 0;
+}
+
+ral_status_t ral_virtual_reset( const void* context )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    ral_virtual_stop_operation( radio, RAL_VIRTUAL_MODE_STANDBY );
+    radio->irq_mask    = RAL_IRQ_NONE;
+    radio->irq_status  = RAL_IRQ_NONE;
+    radio->buffer_size = 0;
+    if( radio->random_state == 0 )
+    {
+        radio->random_state = 0x2545F491;
+    }
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_init( const void* context )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_wakeup( const void* context )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    if( radio->mode == RAL_VIRTUAL_MODE_SLEEP )
+    {
+        radio->mode = RAL_VIRTUAL_MODE_STANDBY;
+    }
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_sleep( const void* context, const bool retain_config )
+{
+    ral_virtual_stop_operation( ( ral_virtual_t* ) context, RAL_VIRTUAL_MODE_SLEEP );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_standby( const void* context, ral_standby_cfg_t standby_cfg )
+{
+    ral_virtual_stop_operation( ( ral_virtual_t* ) context, RAL_VIRTUAL_MODE_STANDBY );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_fs( const void* context )
+{
+    ral_virtual_stop_operation( ( ral_virtual_t* ) context, RAL_VIRTUAL_MODE_FS );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_tx( const void* context )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    if( ( radio->pkt_type != RAL_PKT_TYPE_LORA ) && ( radio->pkt_type != RAL_PKT_TYPE_GFSK ) )
+    {
+        return RAL_STATUS_UNSUPPORTED_FEATURE;
+    }
+
+    ral_virtual_frame_t frame;
+
+    ral_virtual_get_tx_frame( radio, &frame );
+    ral_virtual_start_operation( radio, RAL_VIRTUAL_MODE_TX, RAL_IRQ_TX_DONE, frame.toa_in_us );
+    ral_virtual_bsp_on_tx_start( context, &frame );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_rx( const void* context, const uint32_t timeout_in_ms )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    if( ( radio->rx_frame_pending == true ) && ( radio->rx_frame.pkt_type == radio->pkt_type ) )
+    {
+        // The frame starts at the opening of the window
+        ral_virtual_start_operation( radio, RAL_VIRTUAL_MODE_RX, RAL_IRQ_RX_DONE,
+                                     ral_virtual_get_toa_in_us( radio, radio->rx_frame.size ) );
+        return RAL_STATUS_OK;
+    }
+
+    uint32_t timeout_in_us = 0;
+
+    if( ( radio->pkt_type == RAL_PKT_TYPE_LORA ) && ( radio->lora_symb_nb_timeout != 0 ) )
+    {
+        timeout_in_us = radio->lora_symb_nb_timeout * ral_virtual_get_lora_symb_time_in_us( &radio->lora_mod_params );
+    }
+    if( ( timeout_in_ms != 0 ) && ( timeout_in_ms != RAL_RX_TIMEOUT_CONTINUOUS_MODE ) &&
+        ( ( timeout_in_us == 0 ) || ( ( timeout_in_ms * 1000 ) < timeout_in_us ) ) )
+    {
+        timeout_in_us = timeout_in_ms * 1000;
+    }
+
+    ral_virtual_start_operation( radio, RAL_VIRTUAL_MODE_RX, RAL_IRQ_RX_TIMEOUT, timeout_in_us );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_cfg_rx_boosted( const void* context, const bool enable_boost_mode )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_rx_tx_fallback_mode( const void* context, const ral_fallback_modes_t ral_fallback_mode )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_stop_timer_on_preamble( const void* context, const bool enable )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_rx_duty_cycle( const void* context, const uint32_t rx_time_in_ms,
+                                            const uint32_t sleep_time_in_ms )
+{
+    // Listen continuously, a pending frame is received at once
+    return ral_virtual_set_rx( context, RAL_RX_TIMEOUT_CONTINUOUS_MODE );
+}
+
+ral_status_t ral_virtual_set_lora_cad( const void* context )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+    ral_irq_t      irq   = RAL_IRQ_CAD_DONE;
+
+    if( ( radio->rx_frame_pending == true ) && ( radio->rx_frame.pkt_type == RAL_PKT_TYPE_LORA ) )
+    {
+        irq |= RAL_IRQ_CAD_OK;
+    }
+
+    ral_virtual_start_operation( radio, RAL_VIRTUAL_MODE_CAD, irq,
+                                 ( 1 << radio->lora_cad_params.cad_symb_nb ) *
+                                     ral_virtual_get_lora_symb_time_in_us( &radio->lora_mod_params ) );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_tx_cw( const void* context )
+{
+    ral_virtual_start_operation( ( ral_virtual_t* ) context, RAL_VIRTUAL_MODE_TX, RAL_IRQ_NONE, 0 );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_tx_infinite_preamble( const void* context )
+{
+    ral_virtual_start_operation( ( ral_virtual_t* ) context, RAL_VIRTUAL_MODE_TX, RAL_IRQ_NONE, 0 );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_cal_img( const void* context, const uint16_t freq1_in_mhz, const uint16_t freq2_in_mhz )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_tx_cfg( const void* context, const int8_t output_pwr_in_dbm,
+                                     const uint32_t rf_freq_in_hz )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    radio->output_pwr_in_dbm = output_pwr_in_dbm;
+    radio->rf_freq_in_hz     = rf_freq_in_hz;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_pkt_payload( const void* context, const uint8_t* buffer, const uint16_t size )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    if( size > RAL_VIRTUAL_MAX_PAYLOAD_SIZE )
+    {
+        return RAL_STATUS_ERROR;
+    }
+
+    memcpy( radio->buffer, buffer, size );
+    radio->buffer_size = size;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_pkt_payload( const void* context, uint16_t max_size_in_bytes, uint8_t* buffer,
+                                          uint16_t* size_in_bytes )
+{
+    const ral_virtual_t* radio = ( const ral_virtual_t* ) context;
+
+    if( size_in_bytes != NULL )
+    {
+        *size_in_bytes = radio->buffer_size;
+    }
+    if( radio->buffer_size > max_size_in_bytes )
+    {
+        return RAL_STATUS_ERROR;
+    }
+
+    memcpy( buffer, radio->buffer, radio->buffer_size );
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_irq_status( const void* context, ral_irq_t* irq )
+{
+    *irq = ( ( const ral_virtual_t* ) context )->irq_status;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_clear_irq_status( const void* context, const ral_irq_t irq )
+{
+    ( ( ral_virtual_t* ) context )->irq_status &= ~irq;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_and_clear_irq_status( const void* context, ral_irq_t* irq )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    if( irq != NULL )
+    {
+        *irq = radio->irq_status;
+    }
+    radio->irq_status = RAL_IRQ_NONE;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_dio_irq_params( const void* context, const ral_irq_t irq )
+{
+    ( ( ral_virtual_t* ) context )->irq_mask = irq;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_rf_freq( const void* context, const uint32_t freq_in_hz )
+{
+    ( ( ral_virtual_t* ) context )->rf_freq_in_hz = freq_in_hz;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_pkt_type( const void* context, const ral_pkt_type_t pkt_type )
+{
+    if( ( pkt_type != RAL_PKT_TYPE_LORA ) && ( pkt_type != RAL_PKT_TYPE_GFSK ) )
+    {
+        return RAL_STATUS_UNSUPPORTED_FEATURE;
+    }
+
+    ( ( ral_virtual_t* ) context )->pkt_type = pkt_type;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_pkt_type( const void* context, ral_pkt_type_t* pkt_type )
+{
+    *pkt_type = ( ( const ral_virtual_t* ) context )->pkt_type;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_gfsk_mod_params( const void* context, const ral_gfsk_mod_params_t* params )
+{
+    ( ( ral_virtual_t* ) context )->gfsk_mod_params = *params;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_gfsk_pkt_params( const void* context, const ral_gfsk_pkt_params_t* params )
+{
+    ( ( ral_virtual_t* ) context )->gfsk_pkt_params = *params;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_gfsk_pkt_address( const void* context, const uint8_t node_address,
+                                               const uint8_t braodcast_address )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_lora_mod_params( const void* context, const ral_lora_mod_params_t* params )
+{
+    ( ( ral_virtual_t* ) context )->lora_mod_params = *params;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_lora_pkt_params( const void* context, const ral_lora_pkt_params_t* params )
+{
+    ( ( ral_virtual_t* ) context )->lora_pkt_params = *params;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_lora_cad_params( const void* context, const ral_lora_cad_params_t* params )
+{
+    ( ( ral_virtual_t* ) context )->lora_cad_params = *params;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_lora_symb_nb_timeout( const void* context, const uint16_t nb_of_symbs )
+{
+    ( ( ral_virtual_t* ) context )->lora_symb_nb_timeout = nb_of_symbs;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_flrc_mod_params( const void* context, const ral_flrc_mod_params_t* params )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_set_flrc_pkt_params( const void* context, const ral_flrc_pkt_params_t* params )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_get_gfsk_rx_pkt_status( const void* context, ral_gfsk_rx_pkt_status_t* rx_pkt_status )
+{
+    const ral_virtual_t* radio = ( const ral_virtual_t* ) context;
+
+    rx_pkt_status->rx_status        = RAL_RX_STATUS_PKT_RECEIVED;
+    rx_pkt_status->rssi_sync_in_dbm = radio->last_rssi_in_dbm;
+    rx_pkt_status->rssi_avg_in_dbm  = radio->last_rssi_in_dbm;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_lora_rx_pkt_status( const void* context, ral_lora_rx_pkt_status_t* rx_pkt_status )
+{
+    const ral_virtual_t* radio = ( const ral_virtual_t* ) context;
+
+    rx_pkt_status->rssi_pkt_in_dbm        = radio->last_rssi_in_dbm;
+    rx_pkt_status->snr_pkt_in_db          = radio->last_snr_in_db;
+    rx_pkt_status->signal_rssi_pkt_in_dbm = radio->last_rssi_in_dbm;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_flrc_rx_pkt_status( const void* context, ral_flrc_rx_pkt_status_t* rx_pkt_status )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_get_rssi_inst( const void* context, int16_t* rssi_in_dbm )
+{
+    *rssi_in_dbm = RAL_VIRTUAL_NOISE_FLOOR_IN_DBM;
+    return RAL_STATUS_OK;
+}
+
+uint32_t ral_virtual_get_lora_time_on_air_in_ms( const ral_lora_pkt_params_t* pkt_p,
+                                                 const ral_lora_mod_params_t* mod_p )
+{
+    return ral_lora_toa_convert_us_to_ms( ral_virtual_get_lora_toa_in_us( pkt_p, mod_p ) );
+}
+
+uint32_t ral_virtual_get_gfsk_time_on_air_in_ms( const ral_gfsk_pkt_params_t* pkt_p,
+                                                 const ral_gfsk_mod_params_t* mod_p )
+{
+    return ( ral_virtual_get_gfsk_toa_in_us( pkt_p, mod_p ) + 999 ) / 1000;
+}
+
+uint32_t ral_virtual_get_flrc_time_on_air_in_ms( const ral_flrc_pkt_params_t* pkt_p,
+                                                 const ral_flrc_mod_params_t* mod_p )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_set_gfsk_sync_word( const void* context, const uint8_t* sync_word,
+                                             const uint8_t sync_word_len )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_lora_sync_word( const void* context, const uint8_t sync_word )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_flrc_sync_word( const void* context, const uint8_t* sync_word,
+                                             const uint8_t sync_word_len )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_set_gfsk_crc_params( const void* context, const uint32_t seed, const uint32_t polynomial )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_set_flrc_crc_params( const void* context, const uint32_t seed )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_set_gfsk_whitening_seed( const void* context, const uint16_t seed )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_lr_fhss_init( const void* context, const ral_lr_fhss_params_t* lr_fhss_params )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_lr_fhss_build_frame( const void* context, const ral_lr_fhss_params_t* lr_fhss_params,
+                                              ral_lr_fhss_memory_state_t state, uint16_t hop_sequence_id,
+                                              const uint8_t* payload, uint16_t payload_length )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_lr_fhss_handle_hop( const void* context, const ral_lr_fhss_params_t* lr_fhss_params,
+                                             ral_lr_fhss_memory_state_t state )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_lr_fhss_handle_tx_done( const void* context, const ral_lr_fhss_params_t* lr_fhss_params,
+                                                 ral_lr_fhss_memory_state_t state )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_lr_fhss_get_time_on_air_in_ms( const void* context, const ral_lr_fhss_params_t* lr_fhss_params,
+                                                        uint16_t payload_length, uint32_t* time_on_air )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_lr_fhss_get_hop_sequence_count( const void*                 context,
+                                                         const ral_lr_fhss_params_t* lr_fhss_params,
+                                                         unsigned int*               hop_sequence_count )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_lr_fhss_get_bit_delay_in_us( const void* context, const ral_lr_fhss_params_t* params,
+                                                      uint16_t payload_length, uint16_t* delay )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_virtual_get_lora_rx_pkt_cr_crc( const void* context, ral_lora_cr_t* cr, bool* is_crc_present )
+{
+    const ral_virtual_t* radio = ( const ral_virtual_t* ) context;
+
+    *cr             = radio->lora_mod_params.cr;
+    *is_crc_present = radio->lora_pkt_params.crc_is_on;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_tx_consumption_in_ua( const void* context, const int8_t output_pwr_in_dbm,
+                                                   const uint32_t rf_freq_in_hz, uint32_t* pwr_consumption_in_ua )
+{
+    *pwr_consumption_in_ua =
+        ( output_pwr_in_dbm <= 14 ) ? RAL_VIRTUAL_TX_LP_CONSUMPTION_IN_UA : RAL_VIRTUAL_TX_HP_CONSUMPTION_IN_UA;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_gfsk_rx_consumption_in_ua( const void* context, const uint32_t br_in_bps,
+                                                        const uint32_t bw_dsb_in_hz, const bool rx_boosted,
+                                                        uint32_t* pwr_consumption_in_ua )
+{
+    *pwr_consumption_in_ua =
+        ( rx_boosted == true ) ? RAL_VIRTUAL_RX_BOOSTED_CONSUMPTION_IN_UA : RAL_VIRTUAL_RX_CONSUMPTION_IN_UA;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_lora_rx_consumption_in_ua( const void* context, const ral_lora_bw_t bw,
+                                                        const bool rx_boosted, uint32_t* pwr_consumption_in_ua )
+{
+    *pwr_consumption_in_ua =
+        ( rx_boosted == true ) ? RAL_VIRTUAL_RX_BOOSTED_CONSUMPTION_IN_UA : RAL_VIRTUAL_RX_CONSUMPTION_IN_UA;
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_random_numbers( const void* context, uint32_t* numbers, unsigned int n )
+{
+    ral_virtual_t* radio = ( ral_virtual_t* ) context;
+
+    for( unsigned int i = 0; i < n; i++ )
+    {
+        numbers[i] = ral_virtual_rand( radio );
+    }
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_handle_rx_done( const void* context )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_handle_tx_done( const void* context )
+{
+    return RAL_STATUS_OK;
+}
+
+ral_status_t ral_virtual_get_lora_cad_det_peak( const void* context, ral_lora_sf_t sf, ral_lora_bw_t bw,
+                                                ral_lora_cad_symbs_t nb_symbol, uint8_t* cad_det_peak )
+{
+    *cad_det_peak = ( uint8_t ) sf + 13;
+    return RAL_STATUS_OK;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static uint32_t ral_virtual_get_lora_bw_in_hz( ral_lora_bw_t bw )
+{
+    switch( bw )
+    {
+    case RAL_LORA_BW_007_KHZ:
+        return 7810;
+    case RAL_LORA_BW_010_KHZ:
+        return 10420;
+    case RAL_LORA_BW_015_KHZ:
+        return 15630;
+    case RAL_LORA_BW_020_KHZ:
+        return 20830;
+    case RAL_LORA_BW_031_KHZ:
+        return 31250;
+    case RAL_LORA_BW_041_KHZ:
+        return 41670;
+    case RAL_LORA_BW_062_KHZ:
+        return 62500;
+    case RAL_LORA_BW_200_KHZ:
+        return 203125;
+    case RAL_LORA_BW_250_KHZ:
+        return 250000;
+    case RAL_LORA_BW_400_KHZ:
+        return 406250;
+    case RAL_LORA_BW_500_KHZ:
+        return 500000;
+    case RAL_LORA_BW_800_KHZ:
+        return 812500;
+    case RAL_LORA_BW_1600_KHZ:
+        return 1625000;
+    case RAL_LORA_BW_125_KHZ:
+    default:
+        return 125000;
+    }
+}
+
+static uint32_t ral_virtual_get_lora_symb_time_in_us( const ral_lora_mod_params_t* mod_p )
+{
+    return ( uint32_t ) ( ( ( uint64_t ) 1000000 << mod_p->sf ) / ral_virtual_get_lora_bw_in_hz( mod_p->bw ) );
+}
+
+static uint32_t ral_virtual_get_lora_toa_in_us( const ral_lora_pkt_params_t* pkt_p,
+                                                const ral_lora_mod_params_t* mod_p )
+{
+    uint32_t toa_in_us = 0;
+
+    if( ral_lora_toa_get_in_us( pkt_p, mod_p, &toa_in_us ) == true )
+    {
+        return toa_in_us;
+    }
+
+    // Generic formula of the LoRa modem datasheets, in quarters of symbol
+    const int32_t sf = mod_p->sf;
+    const int32_t cr = ( mod_p->cr == RAL_LORA_CR_LI_4_8 )  ? 4
+                       : ( mod_p->cr > RAL_LORA_CR_4_8 ) ? ( mod_p->cr - RAL_LORA_CR_4_8 )
+                                                          : mod_p->cr;
+    const int32_t de           = ( mod_p->ldro != 0 ) ? 1 : 0;
+    const int32_t payload_bits = ( 8 * pkt_p->pld_len_in_bytes ) - ( 4 * sf ) + 28 +
+                                 ( ( pkt_p->crc_is_on == true ) ? 16 : 0 ) -
+                                 ( ( pkt_p->header_type == RAL_LORA_PKT_IMPLICIT ) ? 20 : 0 );
+    const int32_t bits_per_block = 4 * ( sf - ( 2 * de ) );
+    int32_t       nb_blocks      = 0;
+
+    if( payload_bits > 0 )
+    {
+        nb_blocks = ( payload_bits + bits_per_block - 1 ) / bits_per_block;
+    }
+
+    uint32_t nb_quarter_symbs = ( 4 * pkt_p->preamble_len_in_symb ) + 17 + ( 4 * ( 8 + ( nb_blocks * ( cr + 4 ) ) ) );
+    if( sf < RAL_LORA_SF7 )
+    {
+        nb_quarter_symbs += 8;
+    }
+
+    return ( uint32_t ) ( ( ( ( uint64_t ) nb_quarter_symbs * 1000000 ) << sf ) /
+                          ( 4 * ( uint64_t ) ral_virtual_get_lora_bw_in_hz( mod_p->bw ) ) );
+}
+
+static uint32_t ral_virtual_get_gfsk_toa_in_us( const ral_gfsk_pkt_params_t* pkt_p,
+                                                const ral_gfsk_mod_params_t* mod_p )
+{
+    uint32_t nb_bytes = pkt_p->pld_len_in_bytes;
+
+    if( pkt_p->header_type != RAL_GFSK_PKT_FIX_LEN )
+    {
+        nb_bytes += 1;
+    }
+    switch( pkt_p->crc_type )
+    {
+    case RAL_GFSK_CRC_1_BYTE:
+    case RAL_GFSK_CRC_1_BYTE_INV:
+        nb_bytes += 1;
+        break;
+    case RAL_GFSK_CRC_2_BYTES:
+    case RAL_GFSK_CRC_2_BYTES_INV:
+        nb_bytes += 2;
+        break;
+    case RAL_GFSK_CRC_3_BYTES:
+        nb_bytes += 3;
+        break;
+    default:
+        break;
+    }
+
+    const uint32_t nb_bits = pkt_p->preamble_len_in_bits + pkt_p->sync_word_len_in_bits + ( 8 * nb_bytes );
+
+    if( mod_p->br_in_bps == 0 )
+    {
+        return 0;
+    }
+    return ( uint32_t ) ( ( ( uint64_t ) nb_bits * 1000000 + mod_p->br_in_bps - 1 ) / mod_p->br_in_bps );
+}
+
+static uint32_t ral_virtual_get_toa_in_us( const ral_virtual_t* radio, uint16_t size )
+{
+    if( radio->pkt_type == RAL_PKT_TYPE_GFSK )
+    {
+        ral_gfsk_pkt_params_t pkt_params = radio->gfsk_pkt_params;
+
+        pkt_params.pld_len_in_bytes = size;
+        return ral_virtual_get_gfsk_toa_in_us( &pkt_params, &radio->gfsk_mod_params );
+    }
+    else
+    {
+        ral_lora_pkt_params_t pkt_params = radio->lora_pkt_params;
+
+        pkt_params.pld_len_in_bytes = ( uint8_t ) size;
+        return ral_virtual_get_lora_toa_in_us( &pkt_params, &radio->lora_mod_params );
+    }
+}
+
+static void ral_virtual_start_operation( ral_virtual_t* radio, ral_virtual_mode_t mode, ral_irq_t irq,
+                                         uint32_t duration_us )
+{
+    radio->mode        = mode;
+    radio->irq_pending = irq;
+
+    if( duration_us != 0 )
+    {
+        ral_virtual_bsp_start_irq_timer( radio, duration_us );
+    }
+    else
+    {
+        ral_virtual_bsp_stop_irq_timer( radio );
+    }
+}
+
+static void ral_virtual_stop_operation( ral_virtual_t* radio, ral_virtual_mode_t mode )
+{
+    if( radio->irq_pending != RAL_IRQ_NONE )
+    {
+        ral_virtual_bsp_stop_irq_timer( radio );
+    }
+    radio->mode        = mode;
+    radio->irq_pending = RAL_IRQ_NONE;
+}
+
+static uint32_t ral_virtual_rand( ral_virtual_t* radio )
+{
+    uint32_t x = radio->random_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    radio->random_state = x;
+    return x;
+}
+
+static void ral_virtual_get_tx_frame( const ral_virtual_t* radio, ral_virtual_frame_t* frame )
+{
+    frame->pkt_type          = radio->pkt_type;
+    frame->rf_freq_in_hz     = radio->rf_freq_in_hz;
+    frame->output_pwr_in_dbm = radio->output_pwr_in_dbm;
+    frame->sf                = radio->lora_mod_params.sf;
+    frame->bw                = radio->lora_mod_params.bw;
+    frame->invert_iq_is_on   = radio->lora_pkt_params.invert_iq_is_on;
+    frame->br_in_bps         = radio->gfsk_mod_params.br_in_bps;
+    frame->toa_in_us         = ral_virtual_get_toa_in_us( radio, radio->buffer_size );
+    frame->rssi_in_dbm       = 0;
+    frame->snr_in_db         = 0;
+    frame->size              = radio->buffer_size;
+    memcpy( frame->payload, radio->buffer, radio->buffer_size );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
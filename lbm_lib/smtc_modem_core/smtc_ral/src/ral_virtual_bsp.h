@@ -0,0 +1,111 @@
+/**
+ * @file      ral_virtual_bsp.h
+ *
+ * @brief     Board support of the simulated radio: operation timer and simulated air interface
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2024. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RAL_VIRTUAL_BSP_H
+#define RAL_VIRTUAL_BSP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include "ral_defs.h"
+#include "ral_virtual.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC CONSTANTS --------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Schedule the end of the current radio operation, replacing the one already scheduled
+ *
+ * @remark Once the delay is elapsed, the BSP calls @ref ral_virtual_on_irq_timer from the context of the radio
+ * interrupt and triggers the radio interrupt of the modem if it returns true.
+ *
+ * @param [in] context      Virtual radio context
+ * @param [in] delay_in_us  Delay from now
+ */
+void ral_virtual_bsp_start_irq_timer( const void* context, uint32_t delay_in_us );
+
+/**
+ * @brief Cancel the scheduled end of operation, the radio was set to another mode
+ *
+ * @param [in] context  Virtual radio context
+ */
+void ral_virtual_bsp_stop_irq_timer( const void* context );
+
+/**
+ * @brief Tell the simulated network that a frame starts on air, to model the frames it overlaps
+ *
+ * @param [in] context  Virtual radio context
+ * @param [in] frame    Frame being sent, called when its transmission starts
+ */
+void ral_virtual_bsp_on_tx_start( const void* context, const ral_virtual_frame_t* frame );
+
+/**
+ * @brief Hand a sent frame to the simulated network
+ *
+ * @param [in] context  Virtual radio context
+ * @param [in] frame    Sent frame, called when its transmission ends
+ */
+void ral_virtual_bsp_on_tx_done( const void* context, const ral_virtual_frame_t* frame );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RAL_VIRTUAL_BSP_H
+
+/* --- EOF ------------------------------------------------------------------ */
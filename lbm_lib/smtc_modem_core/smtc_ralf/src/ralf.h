@@ -71,6 +71,31 @@ typedef struct ralf_s
     ralf_drv_t ralf_drv;
 } ralf_t;
 
+/**
+ * @brief Driver function called by the ralf_* functions, see RAL_DRV_FUNC
+ */
+#if defined( RAL_STATIC_DRIVER )
+#if defined( SX128X )
+#define RALF_DRV_FUNC( radio, func ) ralf_sx128x_##func
+#elif defined( SX126X )
+#define RALF_DRV_FUNC( radio, func ) ralf_sx126x_##func
+#elif defined( LR11XX )
+#define RALF_DRV_FUNC( radio, func ) ralf_lr11xx_##func
+#elif defined( SX127X )
+#define RALF_DRV_FUNC( radio, func ) ralf_sx127x_##func
+#elif defined( VIRTUAL_RADIO )
+#define RALF_DRV_FUNC( radio, func ) ralf_virtual_##func
+#endif
+
+// Declared here as the driver headers include this file
+ral_status_t RALF_DRV_FUNC( radio, setup_gfsk )( const ralf_t* radio, const ralf_params_gfsk_t* params );
+ral_status_t RALF_DRV_FUNC( radio, setup_lora )( const ralf_t* radio, const ralf_params_lora_t* params );
+ral_status_t RALF_DRV_FUNC( radio, setup_flrc )( const ralf_t* radio, const ralf_params_flrc_t* params );
+ral_status_t RALF_DRV_FUNC( radio, setup_lora_cad )( const ralf_t* radio, const ralf_params_lora_cad_t* params );
+#else
+#define RALF_DRV_FUNC( radio, func ) ( radio )->ralf_drv.func
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -88,7 +113,7 @@ typedef struct ralf_s
  */
 static inline ral_status_t ralf_setup_gfsk( const ralf_t* radio, const ralf_params_gfsk_t* params )
 {
-    return radio->ralf_drv.setup_gfsk( radio, params );
+    return RALF_DRV_FUNC( radio, setup_gfsk )( radio, params );
 }
 
 /**
@@ -101,7 +126,7 @@ static inline ral_status_t ralf_setup_gfsk( const ralf_t* radio, const ralf_para
  */
 static inline ral_status_t ralf_setup_lora( const ralf_t* radio, const ralf_params_lora_t* params )
 {
-    return radio->ralf_drv.setup_lora( radio, params );
+    return RALF_DRV_FUNC( radio, setup_lora )( radio, params );
 }
 
 /**
@@ -114,7 +139,7 @@ static inline ral_status_t ralf_setup_lora( const ralf_t* radio, const ralf_para
  */
 static inline ral_status_t ralf_setup_flrc( const ralf_t* radio, const ralf_params_flrc_t* params )
 {
-    return radio->ralf_drv.setup_flrc( radio, params );
+    return RALF_DRV_FUNC( radio, setup_flrc )( radio, params );
 }
 
 /**
@@ -127,7 +152,7 @@ static inline ral_status_t ralf_setup_flrc( const ralf_t* radio, const ralf_para
  */
 static inline ral_status_t ralf_setup_lora_cad( const ralf_t* radio, const ralf_params_lora_cad_t* params )
 {
-    return radio->ralf_drv.setup_lora_cad( radio, params );
+    return RALF_DRV_FUNC( radio, setup_lora_cad )( radio, params );
 }
 
 /**
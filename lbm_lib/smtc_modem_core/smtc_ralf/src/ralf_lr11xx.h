@@ -60,10 +60,17 @@ extern "C" {
         .setup_flrc = ralf_lr11xx_setup_flrc, .setup_lora_cad = ralf_lr11xx_setup_lora_cad, \
     }
 
+#if defined( RAL_STATIC_DRIVER )
+#define RALF_LR11XX_INSTANTIATE( ctx )        \
+    {                                         \
+        .ral = RAL_LR11XX_INSTANTIATE( ctx ), \
+    }
+#else
 #define RALF_LR11XX_INSTANTIATE( ctx )                                                 \
     {                                                                                  \
         .ral = RAL_LR11XX_INSTANTIATE( ctx ), .ralf_drv = RALF_DRV_LR11XX_INSTANTIATE, \
     }
+#endif
 
 /*
  * -----------------------------------------------------------------------------
@@ -45,6 +45,10 @@
  * --- PRIVATE MACROS-----------------------------------------------------------
  */
 
+#if defined( ADD_RAL_CAL_IMG ) && !defined( ADD_RAL_CFG_SHADOW )
+#error "ADD_RAL_CAL_IMG relies on ADD_RAL_CFG_SHADOW to skip the calibration of an already calibrated band"
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PRIVATE CONSTANTS -------------------------------------------------------
@@ -65,6 +69,18 @@
  * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
  */
 
+#if defined( ADD_RAL_CAL_IMG )
+/**
+ * @brief Calibrate the image rejection of the band of a frequency, skipped by the RAL if the band is already calibrated
+ *
+ * @param [in] radio       Pointer to radio data structure
+ * @param [in] freq_in_hz  Frequency about to be used, in Hz
+ *
+ * @returns Operation status
+ */
+static ral_status_t ralf_sx126x_cal_img( const ralf_t* radio, const uint32_t freq_in_hz );
+#endif
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
@@ -82,6 +98,13 @@ ral_status_t ralf_sx126x_setup_gfsk( const ralf_t* radio, const ralf_params_gfsk
     {
         return status;
     }
+#if defined( ADD_RAL_CAL_IMG )
+    status = ralf_sx126x_cal_img( radio, params->rf_freq_in_hz );
+    if( status != RAL_STATUS_OK )
+    {
+        return status;
+    }
+#endif
     status = ral_set_rf_freq( &radio->ral, params->rf_freq_in_hz );
     if( status != RAL_STATUS_OK )
     {
@@ -146,6 +169,13 @@ ral_status_t ralf_sx126x_setup_lora( const ralf_t* radio, const ralf_params_lora
     {
         return status;
     }
+#if defined( ADD_RAL_CAL_IMG )
+    status = ralf_sx126x_cal_img( radio, params->rf_freq_in_hz );
+    if( status != RAL_STATUS_OK )
+    {
+        return status;
+    }
+#endif
     status = ral_set_rf_freq( &radio->ral, params->rf_freq_in_hz );
     if( status != RAL_STATUS_OK )
     {
@@ -195,6 +225,13 @@ ral_status_t ralf_sx126x_setup_lora_cad( const ralf_t* radio, const ralf_params_
     {
         return status;
     }
+#if defined( ADD_RAL_CAL_IMG )
+    status = ralf_sx126x_cal_img( radio, params->rf_freq_in_hz );
+    if( status != RAL_STATUS_OK )
+    {
+        return status;
+    }
+#endif
     status = ral_set_rf_freq( &radio->ral, params->rf_freq_in_hz );
     if( status != RAL_STATUS_OK )
     {
@@ -223,4 +260,18 @@ ral_status_t ralf_sx126x_setup_lora_cad( const ralf_t* radio, const ralf_params_
  * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
  */
 
+#if defined( ADD_RAL_CAL_IMG )
+static ral_status_t ralf_sx126x_cal_img( const ralf_t* radio, const uint32_t freq_in_hz )
+{
+    uint16_t freq1_in_mhz = 0;
+    uint16_t freq2_in_mhz = 0;
+
+    if( ral_get_cal_img_interval_in_mhz( freq_in_hz, &freq1_in_mhz, &freq2_in_mhz ) == false )
+    {
+        return RAL_STATUS_OK;
+    }
+    return ral_cal_img( &radio->ral, freq1_in_mhz, freq2_in_mhz );
+}
+#endif
+
 /* --- EOF ------------------------------------------------------------------ */
@@ -61,10 +61,17 @@ extern "C" {
         .setup_flrc = ralf_sx126x_setup_flrc, .setup_lora_cad = ralf_sx126x_setup_lora_cad, \
     }
 
+#if defined( RAL_STATIC_DRIVER )
+#define RALF_SX126X_INSTANTIATE( ctx )        \
+    {                                         \
+        .ral = RAL_SX126X_INSTANTIATE( ctx ), \
+    }
+#else
 #define RALF_SX126X_INSTANTIATE( ctx )                                                 \
     {                                                                                  \
         .ral = RAL_SX126X_INSTANTIATE( ctx ), .ralf_drv = RALF_DRV_SX126X_INSTANTIATE, \
     }
+#endif
 
 /*
  * -----------------------------------------------------------------------------
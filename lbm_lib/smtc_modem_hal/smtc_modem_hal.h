@@ -105,8 +105,21 @@ typedef enum
     CONTEXT_FUOTA,
     CONTEXT_SECURE_ELEMENT,
     CONTEXT_STORE_AND_FORWARD,
+    CONTEXT_MAC_JOURNAL,
+    CONTEXT_RELAY_FWD_TABLE,
+    CONTEXT_STREAM_SPILL,
+    CONTEXT_LORAWAN_SESSION,
 } modem_context_type_t;
 
+/**
+ * @brief Next modem wake-up source, given to @ref smtc_modem_hal_enter_low_power
+ */
+typedef enum smtc_modem_hal_wakeup_e
+{
+    SMTC_MODEM_HAL_WAKEUP_TIMER,      //!< No radio interrupt is expected before the modem timer ends the budget
+    SMTC_MODEM_HAL_WAKEUP_RADIO_IRQ,  //!< A radio task is running, its interrupt can come at any time in the budget
+} smtc_modem_hal_wakeup_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -152,6 +165,18 @@ uint32_t smtc_modem_hal_get_time_in_s( void );
  */
 uint32_t smtc_modem_hal_get_time_in_ms( void );
 
+/**
+ * @brief Returns the current time in microseconds
+ *
+ * @remark Only used by the radio planner when the microsecond timebase is enabled (LBM_RP_US_TIMEBASE=yes), to
+ *         launch radio tasks below the millisecond. It shall run from the same clock as
+ *         @ref smtc_modem_hal_get_time_in_ms, its resolution is the one of this clock. It is busy-polled during
+ *         less than 1 ms by the radio planner, it shall be callable from the radio and timer interrupt contexts.
+ *
+ * @return uint32_t Current time in microseconds (wraps every 71 minutes)
+ */
+uint32_t smtc_modem_hal_get_time_in_us( void );
+
 /**
  * @brief set an offset into the rtc counter
  *
@@ -166,6 +191,8 @@ void smtc_modem_hal_set_offset_to_test_wrapping( const uint32_t offset_to_test_w
 /**
  * @brief Starts the provided timer objet for the given time
  *
+ * @remark Only called by modem_timer.c, which arms it on the earliest of the modem software timers
+ *
  * @param [in] milliseconds Number of milliseconds (timer value)
  * @param [in] callback     Callback that will be called in case of timer irq
  * @param [in] context      Context that will be passed on callback argument
@@ -177,6 +204,26 @@ void smtc_modem_hal_start_timer( const uint32_t milliseconds, void ( *callback )
  */
 void smtc_modem_hal_stop_timer( void );
 
+/**
+ * @brief Starts the one shot hardware timer sending the timed radio commands
+ *
+ * @remark Only used when the modem is built with LBM_RP_TIMED_TX=yes. The radio is configured in advance and the
+ * callback sends the final Tx command from the timer compare interrupt, so that the start of a scheduled transmission
+ * does not depend on the modem engine latency. The callback accesses the radio: the timer interrupt shall not
+ * preempt a radio transfer of the modem engine, it may share the priority of the radio irq
+ *
+ * @param [in] delay_us     Delay before the callback in microseconds, less than RP_MARGIN_DELAY milliseconds
+ * @param [in] callback     Callback that will be called in case of timer irq
+ * @param [in] context      Context that will be passed on callback argument
+ */
+void smtc_modem_hal_start_radio_trigger_timer( const uint32_t delay_us, void ( *callback )( void* context ),
+                                               void* context );
+
+/**
+ * @brief Stop the radio trigger timer, its callback shall not be called after this function returns
+ */
+void smtc_modem_hal_stop_radio_trigger_timer( void );
+
 /* ------------ IRQ management ------------*/
 
 /**
@@ -219,7 +266,7 @@ void smtc_modem_hal_context_store( const modem_context_type_t ctx_type, uint32_t
 
 /**
  * @brief Erase a chosen number of flash pages of a context
- * @remark This function is only used with CONTEXT_STORE_AND_FORWARD
+ * @remark This function is only used with CONTEXT_STORE_AND_FORWARD, CONTEXT_MAC_JOURNAL and CONTEXT_STREAM_SPILL
  *
  * @param [in] ctx_type   Type of modem context that need to be erased
  * @param [in] offset     Memory offset after ctx_type address
@@ -254,6 +301,37 @@ void smtc_modem_hal_on_panic( uint8_t* func, uint32_t line, const char* fmt, ...
  */
 uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint32_t val_2 );
 
+/* ------------ Crypto management ------------*/
+
+/**
+ * @brief Encrypts consecutive 16-byte blocks with the MCU AES peripheral (AES-128, ECB mode)
+ *
+ * @remark Only used when the modem is built with CRYPTO=MCU_HW. Blocks are independent so the implementation can
+ * process them in a single DMA transfer, and an RTOS implementation can yield while the peripheral is busy.
+ *
+ * @param [in] key AES-128 key
+ * @param [in] input Blocks to encrypt
+ * @param [out] output Encrypted blocks (can be the same buffer as input)
+ * @param [in] nb_blocks Number of 16-byte blocks
+ * @return bool True if the blocks have been encrypted
+ */
+bool smtc_modem_hal_crypto_aes_ecb_encrypt( const uint8_t key[16], const uint8_t* input, uint8_t* output,
+                                            uint16_t nb_blocks );
+
+/**
+ * @brief Updates a running CRC-32 with the MCU CRC peripheral
+ *
+ * @remark Only used when the modem is built with LBM_CRC_MCU_HW=yes. The CRC is the reflected CRC-32 of IEEE 802.3
+ * (polynomial 0xEDB88320, bytes processed least significant bit first): \p crc is the running value from any initial
+ * value, and neither the input nor the result are inverted.
+ *
+ * @param [in] crc Running CRC
+ * @param [in] buffer Data
+ * @param [in] length Data length in bytes
+ * @return uint32_t The updated CRC
+ */
+uint32_t smtc_modem_hal_crc32_update( uint32_t crc, const uint8_t* buffer, uint32_t length );
+
 /* ------------ Radio env management ------------*/
 
 /**
@@ -265,6 +343,20 @@ uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint
  */
 void smtc_modem_hal_irq_config_radio_irq( void ( *callback )( void* context ), void* context );
 
+/**
+ * @brief Get the time elapsed since the edge of the radio irq line, captured in hardware
+ *
+ * @remark Only used when the modem is built with LBM_RP_HW_TIMESTAMP=yes, called by the radio irq callback. The edge
+ * is captured by a timer input capture on the radio irq pin, or an event routed to a timer capture, so that the
+ * timestamp of the radio events does not depend on the interrupt latency. A capture is only returned once. When no
+ * edge was captured since the last call, for example when the capture timer is stopped in a low power mode, the
+ * function returns false and the time at which the irq is serviced is used
+ *
+ * @param [out] elapsed_us Time elapsed since the captured edge in microseconds
+ * @return true if the edge of the current radio irq has been captured
+ */
+bool smtc_modem_hal_get_radio_irq_elapsed_us( uint32_t* elapsed_us );
+
 /**
  * @brief Start radio tcxo
  *
@@ -310,6 +402,17 @@ void smtc_modem_hal_set_ant_switch( bool is_tx_on );
  */
 uint8_t smtc_modem_hal_get_battery_level( void );
 
+/**
+ * @brief Return the current drawn by the board while the MCU and the radio sleep
+ *
+ * @remark Only used when the modem is built with LBM_BATTERY_ESTIMATOR=yes. The radio charge is measured by the modem,
+ * this current is the floor added to it by the battery life estimation: MCU in its low power mode with the RTC
+ * running, radio in sleep, sensors and regulators of the board
+ *
+ * @return uint32_t Sleep current in uA
+ */
+uint32_t smtc_modem_hal_get_sleep_current_ua( void );
+
 /**
  * @brief Return board wake up delay in ms
  *
@@ -365,6 +468,14 @@ uint8_t smtc_modem_hal_get_fw_delete_status_for_fuota( uint32_t fw_to_delete_ver
  */
 uint32_t smtc_modem_hal_get_next_fw_version_for_fuota( void );
 
+/**
+ * @brief Only use if LBM_FUOTA_MAPPED_AREA is enabled
+ *
+ * @return const uint8_t* the address where the CPU reads the start of the CONTEXT_FUOTA area, NULL if the area is not
+ * memory mapped
+ */
+const uint8_t* smtc_modem_hal_get_fuota_area_mapped_address( void );
+
 /* ------------ Needed for Device Management  ------------*/
 
 /**
@@ -438,6 +549,52 @@ uint16_t smtc_modem_hal_store_and_forward_get_number_of_pages( void );
  */
 uint16_t smtc_modem_hal_flash_get_page_size( void );
 
+/* ------------ Needed for MAC journal  ------------*/
+
+/**
+ * @brief The number of reserved pages in flash for the journal of MAC counters (DevNonce, uplink frame counter)
+ * @remark The journal is disabled with less than 2 pages. Records are programmed 8 bytes at a time, 8 bytes aligned,
+ * without erasing the page (CONTEXT_MAC_JOURNAL). Pages are erased with @ref smtc_modem_hal_context_flash_pages_erase
+ *
+ * @return uint16_t
+ */
+uint16_t smtc_modem_hal_mac_journal_get_number_of_pages( void );
+
+/* ------------ Needed for Stream spill  ------------*/
+
+/**
+ * @brief The number of reserved pages in flash for the stream records that do not fit in the RAM stream buffer
+ * @remark The spill is disabled with less than 2 pages. Records are programmed without erasing the page
+ * (CONTEXT_STREAM_SPILL), pages are erased with @ref smtc_modem_hal_context_flash_pages_erase
+ *
+ * @return uint16_t
+ */
+uint16_t smtc_modem_hal_stream_spill_get_number_of_pages( void );
+
+/* ------------ Needed for LFU hardware hash  ------------*/
+
+/**
+ * @brief Start a SHA-256 computation on the hash accelerator
+ */
+void smtc_modem_hal_sha256_start( void );
+
+/**
+ * @brief Add data to the SHA-256 computation
+ * @remark Only the last call before @ref smtc_modem_hal_sha256_finish is done with a length that is not a multiple of
+ * 4. Other tasks of the modem run between two calls
+ *
+ * @param [in] data Data to hash
+ * @param [in] len  Number of bytes of \p data
+ */
+void smtc_modem_hal_sha256_update( const uint8_t* data, uint32_t len );
+
+/**
+ * @brief End the SHA-256 computation
+ *
+ * @param [out] digest The 32 bytes of the hash
+ */
+void smtc_modem_hal_sha256_finish( uint8_t* digest );
+
 /* ------------ For Real Time OS compatibility  ------------*/
 
 /**
@@ -447,6 +604,40 @@ uint16_t smtc_modem_hal_flash_get_page_size( void );
  */
 void smtc_modem_hal_user_lbm_irq( void );
 
+/**
+ * @brief Take the modem lock
+ *
+ * @remark Only used when the modem is built with LBM_THREAD_SAFE=yes. The lock is a recursive mutex, preferably with
+ * priority inheritance. smtc_modem_run_engine() takes it while the radio planner and the supervisor run and while
+ * pending contexts are written, and releases it in between. Application threads take the same lock around the
+ * smtc_modem_* calls, except the read-only getters that can be called without it: smtc_modem_get_status(),
+ * smtc_modem_get_modem_version() and smtc_modem_lorawan_get_lost_connection_counter().
+ */
+void smtc_modem_hal_lock_modem( void );
+
+/**
+ * @brief Release the modem lock taken by @ref smtc_modem_hal_lock_modem
+ *
+ * @remark Only used when the modem is built with LBM_THREAD_SAFE=yes
+ */
+void smtc_modem_hal_unlock_modem( void );
+
+/**
+ * @brief Put the MCU in the low power mode suited to the next modem wake-up, until an interrupt or the budget end
+ *
+ * @remark Only used when the modem is built with LBM_LOW_POWER_HINT=yes, called by smtc_modem_enter_low_power() with
+ * the interrupts masked as the sleep of the application main loop. A mode whose wake-up latency, peripherals
+ * re-init included, does not fit in the budget shall not be used. With SMTC_MODEM_HAL_WAKEUP_RADIO_IRQ the radio
+ * interrupt is timestamped by its handler (RX windows, class B beacon, network time), a mode keeping the core clock
+ * ready is preferred. The TCXO startup is already part of the radio planner margin and does not need to be counted.
+ * Wake-up sources that the modem does not know of (host UART, buttons) stay enabled by the implementation. A mode
+ * losing the RAM content (Standby, Shutdown) cannot be used
+ *
+ * @param [in] budget_us Time before the modem has to run, UINT32_MAX when no modem wake-up is scheduled
+ * @param [in] wakeup    Next expected modem wake-up source
+ */
+void smtc_modem_hal_enter_low_power( uint32_t budget_us, smtc_modem_hal_wakeup_t wakeup );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,83 @@
+/*!
+ * \file      lbm_zephyr.h
+ *
+ * \brief     LoRa Basics Modem Zephyr port: engine driven by a dedicated work queue
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef LBM_ZEPHYR_H
+#define LBM_ZEPHYR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Init the modem and start the work queue running its engine
+ *
+ * @remark The radio is the node behind the lora0 devicetree alias. The engine runs each time a modem interruption is
+ * raised and when the sleep time it returned has elapsed, nothing has to be polled by the application. The event
+ * callback is called from the work queue thread.
+ *
+ * @param [in] event_callback Callback called by the modem when an event is available, see smtc_modem_init()
+ *
+ * @return int 0 on success, a negative errno if the radio devices are not ready
+ */
+int lbm_zephyr_init( void ( *event_callback )( void ) );
+
+/**
+ * @brief Run the engine as soon as possible
+ *
+ * @remark To be called by the application after a smtc_modem_* call that starts a new modem task (join, uplink,
+ * ...), the engine would otherwise only see it at the end of its current sleep time. Callable from any thread or
+ * interrupt.
+ */
+void lbm_zephyr_wakeup( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LBM_ZEPHYR_H
+
+/* --- EOF ------------------------------------------------------------------ */
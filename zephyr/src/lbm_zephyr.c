@@ -0,0 +1,156 @@
+/*!
+ * \file      lbm_zephyr.c
+ *
+ * \brief     LoRa Basics Modem Zephyr port: engine driven by a dedicated work queue
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include <zephyr/kernel.h>
+
+#include "lbm_zephyr.h"
+#include "lbm_zephyr_port.h"
+
+#include "smtc_modem_api.h"
+#include "smtc_modem_utilities.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+K_THREAD_STACK_DEFINE( lbm_workq_stack, CONFIG_LORA_BASICS_MODEM_WORKQ_STACK_SIZE );
+
+static struct k_work_q         lbm_workq;
+static struct k_work_delayable lbm_engine_work;
+static volatile bool           lbm_engine_started = false;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC VARIABLES --------------------------------------------------------
+ */
+
+const lbm_zephyr_radio_t lbm_zephyr_radio = {
+    .spi   = SPI_DT_SPEC_GET( LBM_ZEPHYR_RADIO_NODE, SPI_WORD_SET( 8 ) | SPI_TRANSFER_MSB, 0 ),
+    .reset = GPIO_DT_SPEC_GET( LBM_ZEPHYR_RADIO_NODE, reset_gpios ),
+    .busy  = GPIO_DT_SPEC_GET( LBM_ZEPHYR_RADIO_NODE, busy_gpios ),
+    .dio1  = GPIO_DT_SPEC_GET( LBM_ZEPHYR_RADIO_NODE, dio1_gpios ),
+};
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Run the modem engine and schedule the next run after the sleep time it returned
+ *
+ * @param [in] work Engine work item
+ */
+static void lbm_engine_work_handler( struct k_work* work );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+int lbm_zephyr_init( void ( *event_callback )( void ) )
+{
+    if( ( spi_is_ready_dt( &lbm_zephyr_radio.spi ) == false ) ||
+        ( gpio_is_ready_dt( &lbm_zephyr_radio.reset ) == false ) ||
+        ( gpio_is_ready_dt( &lbm_zephyr_radio.busy ) == false ) ||
+        ( gpio_is_ready_dt( &lbm_zephyr_radio.dio1 ) == false ) )
+    {
+        return -ENODEV;
+    }
+
+    gpio_pin_configure_dt( &lbm_zephyr_radio.reset, GPIO_OUTPUT_INACTIVE );
+    gpio_pin_configure_dt( &lbm_zephyr_radio.busy, GPIO_INPUT );
+    gpio_pin_configure_dt( &lbm_zephyr_radio.dio1, GPIO_INPUT );
+
+    const int err = smtc_modem_hal_zephyr_init( );
+    if( err != 0 )
+    {
+        return err;
+    }
+
+    k_work_queue_init( &lbm_workq );
+    k_work_init_delayable( &lbm_engine_work, lbm_engine_work_handler );
+
+    smtc_modem_set_radio_context( &lbm_zephyr_radio );
+    smtc_modem_init( event_callback );
+
+    k_work_queue_start( &lbm_workq, lbm_workq_stack, K_THREAD_STACK_SIZEOF( lbm_workq_stack ),
+                        CONFIG_LORA_BASICS_MODEM_WORKQ_PRIORITY, NULL );
+    k_thread_name_set( &lbm_workq.thread, "lbm_engine" );
+
+    // modem interruptions raised during the init are caught by this first run
+    lbm_engine_started = true;
+    k_work_schedule_for_queue( &lbm_workq, &lbm_engine_work, K_NO_WAIT );
+
+    return 0;
+}
+
+void lbm_zephyr_wakeup( void )
+{
+    if( lbm_engine_started == true )
+    {
+        k_work_reschedule_for_queue( &lbm_workq, &lbm_engine_work, K_NO_WAIT );
+    }
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void lbm_engine_work_handler( struct k_work* work )
+{
+    uint32_t sleep_time_ms = smtc_modem_run_engine( );
+
+    if( smtc_modem_is_irq_flag_pending( ) == true )
+    {
+        sleep_time_ms = 0;
+    }
+
+    // An interruption raised during the run has already queued the work again, scheduling does not delay it. The
+    // work queue thread then blocks and the kernel sleeps in tickless idle until the next timeout or interruption
+    k_work_schedule_for_queue( &lbm_workq, &lbm_engine_work, K_MSEC( sleep_time_ms ) );
+}
+
+/* --- EOF ------------------------------------------------------------------ */
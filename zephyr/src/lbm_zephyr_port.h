@@ -0,0 +1,102 @@
+/*!
+ * \file      lbm_zephyr_port.h
+ *
+ * \brief     Definitions shared by the sources of the LoRa Basics Modem Zephyr port
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef LBM_ZEPHYR_PORT_H
+#define LBM_ZEPHYR_PORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/spi.h>
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC MACROS -----------------------------------------------------------
+ */
+
+/*!
+ * Radio node, described with the semtech,sx1261 or semtech,sx1262 binding of Zephyr
+ */
+#define LBM_ZEPHYR_RADIO_NODE DT_ALIAS( lora0 )
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC TYPES ------------------------------------------------------------
+ */
+
+/*!
+ * Radio context given to the modem with smtc_modem_set_radio_context(), it is the context of the sx126x hal functions
+ */
+typedef struct lbm_zephyr_radio_s
+{
+    struct spi_dt_spec  spi;
+    struct gpio_dt_spec reset;
+    struct gpio_dt_spec busy;
+    struct gpio_dt_spec dio1;
+} lbm_zephyr_radio_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC VARIABLES --------------------------------------------------------
+ */
+
+extern const lbm_zephyr_radio_t lbm_zephyr_radio;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
+ */
+
+/**
+ * @brief Mount the context storage, to be done before the modem restores its contexts
+ *
+ * @return int 0 on success, a negative errno otherwise
+ */
+int smtc_modem_hal_zephyr_init( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LBM_ZEPHYR_PORT_H
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,168 @@
+/*!
+ * \file      ral_sx126x_bsp_zephyr.c
+ *
+ * \brief     Implements the BSP (BoardSpecificPackage) HAL functions for sx126x from the Zephyr devicetree
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include "ral_sx126x_bsp.h"
+#include "sx126x.h"
+#include "lbm_zephyr_port.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+void ral_sx126x_bsp_get_reg_mode( const void* context, sx126x_reg_mod_t* reg_mode )
+{
+    *reg_mode = SX126X_REG_MODE_DCDC;
+}
+
+void ral_sx126x_bsp_get_rf_switch_cfg( const void* context, bool* dio2_is_set_as_rf_switch )
+{
+    *dio2_is_set_as_rf_switch = DT_PROP( LBM_ZEPHYR_RADIO_NODE, dio2_tx_enable );
+}
+
+void ral_sx126x_bsp_get_tx_cfg( const void* context, const ral_sx126x_bsp_tx_cfg_input_params_t* input_params,
+                                ral_sx126x_bsp_tx_cfg_output_params_t* output_params )
+{
+    int16_t power = input_params->system_output_pwr_in_dbm;
+
+    output_params->pa_ramp_time  = SX126X_RAMP_40_US;
+    output_params->pa_cfg.pa_lut = 0x01;  // reserved value, same for sx1261 sx1262 and sx1268
+
+#if defined( SX1262 )
+    // Clamp power if needed
+    if( power > 22 )
+    {
+        power = 22;
+    }
+    if( power < -9 )
+    {
+        power = -9;
+    }
+    output_params->pa_cfg.device_sel                 = 0x00;  // select SX1262/SX1268 device
+    output_params->pa_cfg.hp_max                     = 0x07;  // to achieve 22dBm
+    output_params->pa_cfg.pa_duty_cycle              = 0x04;
+    output_params->chip_output_pwr_in_dbm_configured = ( int8_t ) power;
+    output_params->chip_output_pwr_in_dbm_expected   = ( int8_t ) power;
+#else
+    // Clamp power if needed
+    if( power > 15 )
+    {
+        power = 15;
+    }
+    if( power < -17 )
+    {
+        power = -17;
+    }
+    output_params->pa_cfg.device_sel    = 0x01;  // select SX1261 device
+    output_params->pa_cfg.hp_max        = 0x00;  // not used on sx1261
+    output_params->pa_cfg.pa_duty_cycle = ( power == 15 ) ? 0x06 : 0x04;
+    // 15 dBm is reached with a 14 dBm setting and a higher duty cycle
+    output_params->chip_output_pwr_in_dbm_configured = ( power == 15 ) ? 14 : ( int8_t ) power;
+    output_params->chip_output_pwr_in_dbm_expected   = ( int8_t ) power;
+#endif
+}
+
+void ral_sx126x_bsp_get_xosc_cfg( const void* context, ral_xosc_cfg_t* xosc_cfg,
+                                  sx126x_tcxo_ctrl_voltages_t* supply_voltage, uint32_t* startup_time_in_tick )
+{
+#if DT_NODE_HAS_PROP( LBM_ZEPHYR_RADIO_NODE, dio3_tcxo_voltage )
+    // dio3-tcxo-voltage uses the SetDIO3AsTCXOCtrl encoding
+    *xosc_cfg             = RAL_XOSC_CFG_TCXO_RADIO_CTRL;
+    *supply_voltage       = ( sx126x_tcxo_ctrl_voltages_t ) DT_PROP( LBM_ZEPHYR_RADIO_NODE, dio3_tcxo_voltage );
+    *startup_time_in_tick = sx126x_convert_timeout_in_ms_to_rtc_step(
+        DT_PROP_OR( LBM_ZEPHYR_RADIO_NODE, tcxo_power_startup_delay_ms, 5 ) );
+#else
+    *xosc_cfg = RAL_XOSC_CFG_XTAL;
+#endif
+}
+
+void ral_sx126x_bsp_get_trim_cap( const void* context, uint8_t* trimming_cap_xta, uint8_t* trimming_cap_xtb )
+{
+    // Do nothing, let the driver choose the default values
+}
+
+void ral_sx126x_bsp_get_rx_boost_cfg( const void* context, bool* rx_boost_is_activated )
+{
+    *rx_boost_is_activated = false;
+}
+
+void ral_sx126x_bsp_get_ocp_value( const void* context, uint8_t* ocp_in_step_of_2_5_ma )
+{
+    // Do nothing, let the driver choose the default values
+}
+
+void ral_sx126x_bsp_get_lora_cad_det_peak( const void* context, ral_lora_sf_t sf, ral_lora_bw_t bw,
+                                           ral_lora_cad_symbs_t nb_symbol, uint8_t* in_out_cad_det_peak )
+{
+    // The DetPeak value set in the sx126x Radio Abstraction Layer is too close to the sensitivity for BW500 and SF>=9
+    if( ( bw >= RAL_LORA_BW_500_KHZ ) && ( sf >= RAL_LORA_SF9 ) )
+    {
+        *in_out_cad_det_peak += 11;
+    }
+}
+
+ral_status_t ral_sx126x_bsp_get_instantaneous_tx_power_consumption(
+    const void* context, const ral_sx126x_bsp_tx_cfg_output_params_t* tx_cfg_output_params,
+    sx126x_reg_mod_t radio_reg_mode, uint32_t* pwr_consumption_in_ua )
+{
+    // Board dependent, the radio planner consumption statistics stay at 0
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_sx126x_bsp_get_instantaneous_gfsk_rx_power_consumption( const void*      context,
+                                                                         sx126x_reg_mod_t radio_reg_mode,
+                                                                         bool             rx_boosted,
+                                                                         uint32_t*        pwr_consumption_in_ua )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+ral_status_t ral_sx126x_bsp_get_instantaneous_lora_rx_power_consumption( const void*      context,
+                                                                         sx126x_reg_mod_t radio_reg_mode,
+                                                                         bool             rx_boosted,
+                                                                         uint32_t*        pwr_consumption_in_ua )
+{
+    return RAL_STATUS_UNSUPPORTED_FEATURE;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
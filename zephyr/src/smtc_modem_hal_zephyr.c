@@ -0,0 +1,474 @@
+/*!
+ * \file      smtc_modem_hal_zephyr.c
+ *
+ * \brief     Modem Hardware Abstraction Layer API implementation for Zephyr
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/fs/nvs.h>
+#include <zephyr/random/random.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/reboot.h>
+
+#include "lbm_zephyr.h"
+#include "lbm_zephyr_port.h"
+
+#include "smtc_modem_hal.h"
+#include "smtc_modem_hal_dbg_trace.h"
+
+// for variadic args
+#include <stdio.h>
+#include <stdarg.h>
+
+// for memcpy
+#include <string.h>
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE MACROS-----------------------------------------------------------
+ */
+
+#ifndef MIN
+#define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
+#endif
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+// The contexts are NVS entries in the storage partition, the id is the context type and the stack index
+#define LBM_NVS_PARTITION storage_partition
+#define LBM_NVS_ID( ctx_type, index ) ( ( uint16_t ) ( ( ( ctx_type ) << 4 ) | ( ( index ) & 0x0F ) ) )
+
+// The store and forward records are written as in the bare metal flash implementations, in a dedicated partition
+#define LBM_SF_PARTITION lbm_sf_partition
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Call the timer callback given by the modem, from the system clock interrupt
+ */
+static void lbm_timer_expiry( struct k_timer* timer );
+
+/**
+ * @brief Call the radio irq callback given by the modem on dio1 rising edge
+ */
+static void radio_dio_irq_handler( const struct device* port, struct gpio_callback* cb, gpio_port_pins_t pins );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+static struct nvs_fs        lbm_nvs;
+static struct gpio_callback radio_dio_irq;
+static uint32_t             lbm_time_offset_ms;
+static unsigned int         lbm_irq_key;
+
+static void ( *lbm_timer_callback )( void* context );
+static void* lbm_timer_context;
+static void ( *radio_dio_callback )( void* context );
+static void* radio_dio_context;
+
+K_TIMER_DEFINE( lbm_timer, lbm_timer_expiry, NULL );
+K_MUTEX_DEFINE( lbm_modem_mutex );
+
+static __noinit uint8_t          crashlog_buff_noinit[CRASH_LOG_SIZE];
+static __noinit volatile uint8_t crashlog_length_noinit;
+static __noinit volatile bool    crashlog_available_noinit;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+int smtc_modem_hal_zephyr_init( void )
+{
+    struct flash_pages_info info;
+
+    lbm_nvs.flash_device = FIXED_PARTITION_DEVICE( LBM_NVS_PARTITION );
+    lbm_nvs.offset       = FIXED_PARTITION_OFFSET( LBM_NVS_PARTITION );
+    if( device_is_ready( lbm_nvs.flash_device ) == false )
+    {
+        return -ENODEV;
+    }
+
+    const int err = flash_get_page_info_by_offs( lbm_nvs.flash_device, lbm_nvs.offset, &info );
+    if( err != 0 )
+    {
+        return err;
+    }
+    lbm_nvs.sector_size  = info.size;
+    lbm_nvs.sector_count = FIXED_PARTITION_SIZE( LBM_NVS_PARTITION ) / info.size;
+
+    return nvs_mount( &lbm_nvs );
+}
+
+/* ------------ Reset management ------------*/
+
+void smtc_modem_hal_reset_mcu( void )
+{
+    sys_reboot( SYS_REBOOT_COLD );
+}
+
+/* ------------ Watchdog management ------------*/
+
+void smtc_modem_hal_reload_wdog( void )
+{
+    // The watchdog belongs to the application, with the task watchdog each thread feeds its own channel
+}
+
+/* ------------ Time management ------------*/
+
+uint32_t smtc_modem_hal_get_time_in_s( void )
+{
+    return ( uint32_t ) ( ( k_uptime_get( ) + lbm_time_offset_ms ) / 1000 );
+}
+
+uint32_t smtc_modem_hal_get_time_in_ms( void )
+{
+    return ( uint32_t ) k_uptime_get( ) + lbm_time_offset_ms;
+}
+
+uint32_t smtc_modem_hal_get_time_in_us( void )
+{
+    return ( uint32_t ) k_ticks_to_us_floor64( k_uptime_ticks( ) ) + ( lbm_time_offset_ms * 1000 );
+}
+
+void smtc_modem_hal_set_offset_to_test_wrapping( const uint32_t offset_to_test_wrapping )
+{
+    lbm_time_offset_ms = offset_to_test_wrapping;
+}
+
+/* ------------ Timer management ------------*/
+
+void smtc_modem_hal_start_timer( const uint32_t milliseconds, void ( *callback )( void* context ), void* context )
+{
+    lbm_timer_callback = callback;
+    lbm_timer_context  = context;
+    k_timer_start( &lbm_timer, K_MSEC( milliseconds ), K_NO_WAIT );
+}
+
+void smtc_modem_hal_stop_timer( void )
+{
+    k_timer_stop( &lbm_timer );
+}
+
+/* ------------ IRQ management ------------*/
+
+void smtc_modem_hal_disable_modem_irq( void )
+{
+    // The timer expiry runs in the system clock interrupt, it cannot be masked alone
+    lbm_irq_key = irq_lock( );
+}
+
+void smtc_modem_hal_enable_modem_irq( void )
+{
+    irq_unlock( lbm_irq_key );
+}
+
+/* ------------ Context saving management ------------*/
+
+void smtc_modem_hal_context_restore( const modem_context_type_t ctx_type, uint32_t offset, uint8_t* buffer,
+                                     const uint32_t size )
+{
+    switch( ctx_type )
+    {
+    case CONTEXT_MODEM:
+    case CONTEXT_KEY_MODEM:
+    case CONTEXT_LORAWAN_STACK:
+    case CONTEXT_SECURE_ELEMENT:
+    case CONTEXT_RELAY_FWD_TABLE:
+    case CONTEXT_LORAWAN_SESSION:
+        // Offset is only used by multistack, as stack_id * size
+        if( nvs_read( &lbm_nvs, LBM_NVS_ID( ctx_type, offset / size ), buffer, size ) != ( ssize_t ) size )
+        {
+            // Never written, read as erased flash so that the context crc fails
+            memset( buffer, 0xFF, size );
+        }
+        break;
+#if defined( ADD_SMTC_STORE_AND_FORWARD )
+    case CONTEXT_STORE_AND_FORWARD:
+        flash_area_read( FIXED_PARTITION_ID( LBM_SF_PARTITION ), offset, buffer, size );
+        break;
+#endif
+    default:
+        SMTC_MODEM_HAL_PANIC( "context %d not supported\n", ctx_type );
+        break;
+    }
+}
+
+void smtc_modem_hal_context_store( const modem_context_type_t ctx_type, uint32_t offset, const uint8_t* buffer,
+                                   const uint32_t size )
+{
+    switch( ctx_type )
+    {
+    case CONTEXT_MODEM:
+    case CONTEXT_KEY_MODEM:
+    case CONTEXT_LORAWAN_STACK:
+    case CONTEXT_SECURE_ELEMENT:
+    case CONTEXT_RELAY_FWD_TABLE:
+    case CONTEXT_LORAWAN_SESSION:
+        // NVS does not write an entry identical to the stored one
+        if( nvs_write( &lbm_nvs, LBM_NVS_ID( ctx_type, offset / size ), buffer, size ) < 0 )
+        {
+            SMTC_MODEM_HAL_PANIC( "context %d not stored\n", ctx_type );
+        }
+        break;
+#if defined( ADD_SMTC_STORE_AND_FORWARD )
+    case CONTEXT_STORE_AND_FORWARD:
+        flash_area_write( FIXED_PARTITION_ID( LBM_SF_PARTITION ), offset, buffer, size );
+        break;
+#endif
+    default:
+        SMTC_MODEM_HAL_PANIC( "context %d not supported\n", ctx_type );
+        break;
+    }
+}
+
+void smtc_modem_hal_context_flash_pages_erase( const modem_context_type_t ctx_type, uint32_t offset, uint8_t nb_page )
+{
+    switch( ctx_type )
+    {
+#if defined( ADD_SMTC_STORE_AND_FORWARD )
+    case CONTEXT_STORE_AND_FORWARD:
+        flash_area_erase( FIXED_PARTITION_ID( LBM_SF_PARTITION ), offset,
+                          ( uint32_t ) nb_page * smtc_modem_hal_flash_get_page_size( ) );
+        break;
+#endif
+    default:
+        SMTC_MODEM_HAL_PANIC( "context %d not supported\n", ctx_type );
+        break;
+    }
+}
+
+/* ------------ crashlog management ------------*/
+
+void smtc_modem_hal_crashlog_store( const uint8_t* crash_string, uint8_t crash_string_length )
+{
+    crashlog_length_noinit = MIN( crash_string_length, CRASH_LOG_SIZE );
+    memcpy( crashlog_buff_noinit, crash_string, crashlog_length_noinit );
+    crashlog_available_noinit = true;
+}
+
+void smtc_modem_hal_crashlog_restore( uint8_t* crash_string, uint8_t* crash_string_length )
+{
+    *crash_string_length = ( crashlog_length_noinit > CRASH_LOG_SIZE ) ? CRASH_LOG_SIZE : crashlog_length_noinit;
+    memcpy( crash_string, crashlog_buff_noinit, *crash_string_length );
+}
+
+void smtc_modem_hal_crashlog_set_status( bool available )
+{
+    crashlog_available_noinit = available;
+}
+
+bool smtc_modem_hal_crashlog_get_status( void )
+{
+    return crashlog_available_noinit;
+}
+
+/* ------------ assert management ------------*/
+
+void smtc_modem_hal_on_panic( uint8_t* func, uint32_t line, const char* fmt, ... )
+{
+    uint8_t out_buff[255] = { 0 };
+    int     out_len       = snprintf( ( char* ) out_buff, sizeof( out_buff ), "%s:%u ", func, line );
+
+    va_list args;
+    va_start( args, fmt );
+    out_len += vsnprintf( ( char* ) &out_buff[out_len], sizeof( out_buff ) - out_len, fmt, args );
+    va_end( args );
+
+    smtc_modem_hal_crashlog_store( out_buff, MIN( out_len, ( int ) sizeof( out_buff ) - 1 ) );
+
+    printk( "Modem panic: %s\n", out_buff );
+    smtc_modem_hal_reset_mcu( );
+}
+
+/* ------------ Random management ------------*/
+
+uint32_t smtc_modem_hal_get_random_nb_in_range( const uint32_t val_1, const uint32_t val_2 )
+{
+    if( val_1 <= val_2 )
+    {
+        return ( uint32_t ) ( ( sys_rand32_get( ) % ( val_2 - val_1 + 1 ) ) + val_1 );
+    }
+    else
+    {
+        return ( uint32_t ) ( ( sys_rand32_get( ) % ( val_1 - val_2 + 1 ) ) + val_2 );
+    }
+}
+
+/* ------------ Radio env management ------------*/
+
+void smtc_modem_hal_irq_config_radio_irq( void ( *callback )( void* context ), void* context )
+{
+    radio_dio_callback = callback;
+    radio_dio_context  = context;
+
+    gpio_init_callback( &radio_dio_irq, radio_dio_irq_handler, BIT( lbm_zephyr_radio.dio1.pin ) );
+    gpio_add_callback_dt( &lbm_zephyr_radio.dio1, &radio_dio_irq );
+    gpio_pin_interrupt_configure_dt( &lbm_zephyr_radio.dio1, GPIO_INT_EDGE_TO_ACTIVE );
+}
+
+void smtc_modem_hal_start_radio_tcxo( void )
+{
+    // The tcxo is supplied by dio3 of the radio when dio3-tcxo-voltage is set
+}
+
+void smtc_modem_hal_stop_radio_tcxo( void )
+{
+    // The tcxo is supplied by dio3 of the radio when dio3-tcxo-voltage is set
+}
+
+uint32_t smtc_modem_hal_get_radio_tcxo_startup_delay_ms( void )
+{
+    return DT_PROP_OR( LBM_ZEPHYR_RADIO_NODE, tcxo_power_startup_delay_ms, 0 );
+}
+
+void smtc_modem_hal_set_ant_switch( bool is_tx_on )
+{
+    // The rf switch is driven by dio2 of the radio when dio2-tx-enable is set
+}
+
+/* ------------ Environment management ------------*/
+
+uint8_t smtc_modem_hal_get_battery_level( void )
+{
+    // Please implement according to used board
+    // According to LoRaWan 1.0.4 spec:
+    // 0: The end-device is connected to an external power source.
+    // 1..254: Battery level, where 1 is the minimum and 254 is the maximum.
+    // 255: The end-device was not able to measure the battery level.
+    return 255;
+}
+
+int8_t smtc_modem_hal_get_board_delay_ms( void )
+{
+    return 1;
+}
+
+/* ------------ Trace management ------------*/
+
+void smtc_modem_hal_print_trace( const char* fmt, ... )
+{
+    va_list args;
+    va_start( args, fmt );
+    vprintk( fmt, args );
+    va_end( args );
+}
+
+/* ------------ Needed for Cloud  ------------*/
+
+int8_t smtc_modem_hal_get_temperature( void )
+{
+    // Please implement according to used board
+    return 25;
+}
+
+uint16_t smtc_modem_hal_get_voltage_mv( void )
+{
+    return 3300;
+}
+
+/* ------------ Needed for Store and Forward service  ------------*/
+
+#if defined( ADD_SMTC_STORE_AND_FORWARD )
+uint16_t smtc_modem_hal_store_and_forward_get_number_of_pages( void )
+{
+    return FIXED_PARTITION_SIZE( LBM_SF_PARTITION ) / smtc_modem_hal_flash_get_page_size( );
+}
+
+uint16_t smtc_modem_hal_flash_get_page_size( void )
+{
+    struct flash_pages_info info;
+
+    flash_get_page_info_by_offs( FIXED_PARTITION_DEVICE( LBM_SF_PARTITION ), FIXED_PARTITION_OFFSET( LBM_SF_PARTITION ),
+                                 &info );
+    return ( uint16_t ) info.size;
+}
+#endif
+
+/* ------------ For Real Time OS compatibility  ------------*/
+
+void smtc_modem_hal_user_lbm_irq( void )
+{
+    lbm_zephyr_wakeup( );
+}
+
+void smtc_modem_hal_lock_modem( void )
+{
+    // k_mutex is recursive and inherits the priority of the waiting threads
+    k_mutex_lock( &lbm_modem_mutex, K_FOREVER );
+}
+
+void smtc_modem_hal_unlock_modem( void )
+{
+    k_mutex_unlock( &lbm_modem_mutex );
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void lbm_timer_expiry( struct k_timer* timer )
+{
+    if( lbm_timer_callback != NULL )
+    {
+        lbm_timer_callback( lbm_timer_context );
+    }
+}
+
+static void radio_dio_irq_handler( const struct device* port, struct gpio_callback* cb, gpio_port_pins_t pins )
+{
+    if( radio_dio_callback != NULL )
+    {
+        radio_dio_callback( radio_dio_context );
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
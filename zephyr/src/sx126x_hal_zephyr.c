@@ -0,0 +1,215 @@
+/*!
+ * \file      sx126x_hal_zephyr.c
+ *
+ * \brief     Implements the sx126x radio HAL functions with the Zephyr SPI and GPIO drivers
+ *
+ *
+ * The Clear BSD License
+ * Copyright Semtech Corporation 2021. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Semtech corporation nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+ * NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SEMTECH CORPORATION BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- DEPENDENCIES ------------------------------------------------------------
+ */
+
+#include <stdint.h>   // C99 types
+#include <stdbool.h>  // bool type
+#include <stddef.h>   // NULL
+
+#include <zephyr/kernel.h>
+
+#include "sx126x_hal.h"
+#include "lbm_zephyr_port.h"
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE CONSTANTS -------------------------------------------------------
+ */
+
+// Busy is polled during this time, then the thread sleeps between two tests (calibration, image rejection, ...)
+#define SX126X_HAL_BUSY_POLLING_TIME_US 1000
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE TYPES -----------------------------------------------------------
+ */
+
+typedef enum
+{
+    RADIO_SLEEP,
+    RADIO_AWAKE
+} radio_sleep_mode_t;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE VARIABLES -------------------------------------------------------
+ */
+
+// This variable will hold the current sleep status of the radio
+static radio_sleep_mode_t radio_mode = RADIO_AWAKE;
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DECLARATION -------------------------------------------
+ */
+
+/**
+ * @brief Wait until radio busy pin returns to 0
+ */
+static void sx126x_hal_wait_on_busy( const lbm_zephyr_radio_t* radio );
+
+/**
+ * @brief Check if device is ready to receive spi transaction, wakes it up if it is in sleep mode
+ */
+static void sx126x_hal_check_device_ready( const lbm_zephyr_radio_t* radio );
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PUBLIC FUNCTIONS DEFINITION ---------------------------------------------
+ */
+
+sx126x_hal_status_t sx126x_hal_write( const void* context, const uint8_t* command, const uint16_t command_length,
+                                      const uint8_t* data, const uint16_t data_length )
+{
+    const lbm_zephyr_radio_t* radio = ( const lbm_zephyr_radio_t* ) context;
+
+    sx126x_hal_check_device_ready( radio );
+
+    // Chip select stays asserted over both buffers. The SPI driver uses DMA when the devicetree enables it, the
+    // engine thread sleeps until the transfer is done
+    const struct spi_buf tx_bufs[] = {
+        { .buf = ( uint8_t* ) command, .len = command_length },
+        { .buf = ( uint8_t* ) data, .len = data_length },
+    };
+    const struct spi_buf_set tx = { .buffers = tx_bufs, .count = ( data_length > 0 ) ? 2 : 1 };
+
+    if( spi_write_dt( &radio->spi, &tx ) != 0 )
+    {
+        return SX126X_HAL_STATUS_ERROR;
+    }
+
+    // 0x84 - SX126x_SET_SLEEP opcode. In sleep mode the radio busy line is stuck to 1 => do not test it
+    if( command[0] == 0x84 )
+    {
+        radio_mode = RADIO_SLEEP;
+    }
+    else
+    {
+        sx126x_hal_check_device_ready( radio );
+    }
+
+    return SX126X_HAL_STATUS_OK;
+}
+
+sx126x_hal_status_t sx126x_hal_read( const void* context, const uint8_t* command, const uint16_t command_length,
+                                     uint8_t* data, const uint16_t data_length )
+{
+    const lbm_zephyr_radio_t* radio = ( const lbm_zephyr_radio_t* ) context;
+
+    sx126x_hal_check_device_ready( radio );
+
+    // The driver sends SX126X_NOP (0x00) once the tx buffers are exhausted
+    const struct spi_buf     tx_buf    = { .buf = ( uint8_t* ) command, .len = command_length };
+    const struct spi_buf_set tx        = { .buffers = &tx_buf, .count = 1 };
+    const struct spi_buf     rx_bufs[] = {
+        { .buf = NULL, .len = command_length },
+        { .buf = data, .len = data_length },
+    };
+    const struct spi_buf_set rx = { .buffers = rx_bufs, .count = 2 };
+
+    if( spi_transceive_dt( &radio->spi, &tx, &rx ) != 0 )
+    {
+        return SX126X_HAL_STATUS_ERROR;
+    }
+
+    return SX126X_HAL_STATUS_OK;
+}
+
+sx126x_hal_status_t sx126x_hal_reset( const void* context )
+{
+    const lbm_zephyr_radio_t* radio = ( const lbm_zephyr_radio_t* ) context;
+
+    // reset-gpios carries the polarity, 1 is the asserted level
+    gpio_pin_set_dt( &radio->reset, 1 );
+    k_msleep( 5 );
+    gpio_pin_set_dt( &radio->reset, 0 );
+    k_msleep( 5 );
+    radio_mode = RADIO_AWAKE;
+    return SX126X_HAL_STATUS_OK;
+}
+
+sx126x_hal_status_t sx126x_hal_wakeup( const void* context )
+{
+    sx126x_hal_check_device_ready( ( const lbm_zephyr_radio_t* ) context );
+    return SX126X_HAL_STATUS_OK;
+}
+
+/*
+ * -----------------------------------------------------------------------------
+ * --- PRIVATE FUNCTIONS DEFINITION --------------------------------------------
+ */
+
+static void sx126x_hal_wait_on_busy( const lbm_zephyr_radio_t* radio )
+{
+    uint32_t waited_us = 0;
+
+    while( gpio_pin_get_dt( &radio->busy ) == 1 )
+    {
+        if( waited_us < SX126X_HAL_BUSY_POLLING_TIME_US )
+        {
+            k_busy_wait( 10 );
+            waited_us += 10;
+        }
+        else
+        {
+            k_msleep( 1 );
+        }
+    }
+}
+
+static void sx126x_hal_check_device_ready( const lbm_zephyr_radio_t* radio )
+{
+    if( radio_mode != RADIO_SLEEP )
+    {
+        sx126x_hal_wait_on_busy( radio );
+    }
+    else
+    {
+        // Busy is HIGH in sleep mode, the falling edge of the chip select of a GetStatus command wakes the device up
+        const uint8_t            get_status[] = { 0xC0, SX126X_NOP };
+        const struct spi_buf     tx_buf       = { .buf = ( uint8_t* ) get_status, .len = sizeof( get_status ) };
+        const struct spi_buf_set tx           = { .buffers = &tx_buf, .count = 1 };
+
+        spi_write_dt( &radio->spi, &tx );
+        sx126x_hal_wait_on_busy( radio );
+        radio_mode = RADIO_AWAKE;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */